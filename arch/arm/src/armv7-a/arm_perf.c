@@ -22,8 +22,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <string.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/perf.h>
 
 #include "arm_internal.h"
 #include "sctlr.h"
@@ -34,6 +38,29 @@
 
 static unsigned long g_cpu_freq;
 
+#ifdef CONFIG_SCHED_PERF_EVENTS
+/* The common architectural events counted by the event counters, counter
+ * n counting g_perf_pmu[n].
+ */
+
+static const struct
+{
+  uint8_t type;
+  uint8_t event;
+} g_perf_pmu[] =
+{
+  { 0x08, PERF_EVENT_INSTRUCTIONS  },  /* Instruction executed */
+  { 0x04, PERF_EVENT_CACHE_REFS    },  /* Level 1 data cache access */
+  { 0x03, PERF_EVENT_CACHE_MISSES  },  /* Level 1 data cache refill */
+  { 0x10, PERF_EVENT_BRANCH_MISSES },  /* Mispredicted branch */
+};
+
+/* The values of the counters at the previous up_perf_event_read() */
+
+static uint32_t g_perf_ccnt[CONFIG_SMP_NCPUS];
+static uint32_t g_perf_last[CONFIG_SMP_NCPUS][nitems(g_perf_pmu)];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,11 +87,30 @@ static unsigned long g_cpu_freq;
 
 void up_perf_init(void *arg)
 {
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  int i;
+#endif
+
   g_cpu_freq = (unsigned long)(uintptr_t)arg;
 
   cp15_pmu_uer(PMUER_UME);
   cp15_pmu_pmcr(PMCR_E);
   cp15_pmu_cesr(PMCESR_CCES);
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  /* Program the event counters of this CPU */
+
+  for (i = 0; i < nitems(g_perf_pmu); i++)
+    {
+      if ((up_perf_event_supported() &
+           PERF_EVENT_BIT(g_perf_pmu[i].event)) != 0)
+        {
+          cp15_pmu_wrecsr(i);
+          cp15_pmu_wretsr(g_perf_pmu[i].type);
+          cp15_pmu_cesr(1 << i);
+        }
+    }
+#endif
 }
 
 unsigned long up_perf_getfreq(void)
@@ -85,3 +131,47 @@ void up_perf_convert(unsigned long elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * g_cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * (uint64_t)left / g_cpu_freq;
 }
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+uint32_t up_perf_event_supported(void)
+{
+  uint32_t events = PERF_EVENT_BIT(PERF_EVENT_CYCLES);
+  unsigned int ncounters;
+  int i;
+
+  /* Not all cores implement as many event counters as there are events */
+
+  ncounters = (cp15_pmu_rdpmcr() & PMCR_N_MASK) >> PMCR_N_SHIFT;
+  for (i = 0; i < nitems(g_perf_pmu) && i < ncounters; i++)
+    {
+      events |= PERF_EVENT_BIT(g_perf_pmu[i].event);
+    }
+
+  return events;
+}
+
+void up_perf_event_read(uint32_t *delta)
+{
+  int cpu = up_cpu_index();
+  uint32_t supported = up_perf_event_supported();
+  uint32_t count;
+  int i;
+
+  memset(delta, 0, PERF_EVENT_MAX * sizeof(uint32_t));
+
+  count = cp15_pmu_rdccr();
+  delta[PERF_EVENT_CYCLES] = count - g_perf_ccnt[cpu];
+  g_perf_ccnt[cpu] = count;
+
+  for (i = 0; i < nitems(g_perf_pmu); i++)
+    {
+      if ((supported & PERF_EVENT_BIT(g_perf_pmu[i].event)) != 0)
+        {
+          cp15_pmu_wrecsr(i);
+          count = cp15_pmu_rdecr();
+          delta[g_perf_pmu[i].event] = count - g_perf_last[cpu][i];
+          g_perf_last[cpu][i] = count;
+        }
+    }
+}
+#endif
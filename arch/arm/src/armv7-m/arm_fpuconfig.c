@@ -52,12 +52,34 @@
  *     extension, or
  *   - the CONTROL.FPCA bit is set to 1
  *
+ *  With CONFIG_ARMV7M_LAZYFPU, FPCCR.ASPEN and FPCCR.LSPEN are both set
+ *  so that only the contexts that have used the FPU carry an FP frame.
+ *
  ****************************************************************************/
 
 void arm_fpuconfig(void)
 {
   uint32_t regval;
 
+#ifdef CONFIG_ARMV7M_LAZYFPU
+  /* Clear CONTROL.FPCA.  The processor sets it again on the first FP
+   * instruction executed by a context.
+   */
+
+  regval = getcontrol();
+  regval &= ~CONTROL_FPCA;
+  setcontrol(regval);
+
+  /* Enable the automatic FP state preservation so that the extended frame
+   * is used only by contexts with CONTROL.FPCA set, and the lazy state
+   * preservation so that the volatile FP registers are only written to
+   * that frame if the exception handler itself uses the FPU.
+   */
+
+  regval = getreg32(NVIC_FPCCR);
+  regval |= NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN;
+  putreg32(regval, NVIC_FPCCR);
+#else
   /* Set CONTROL.FPCA so that we always get the extended context frame
    * with the volatile FP registers stacked above the basic context.
    */
@@ -74,6 +96,7 @@ void arm_fpuconfig(void)
   regval = getreg32(NVIC_FPCCR);
   regval &= ~(NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN);
   putreg32(regval, NVIC_FPCCR);
+#endif
 
   /* Enable full access to CP10 and CP11 */
 
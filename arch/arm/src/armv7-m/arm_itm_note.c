@@ -0,0 +1,165 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_itm_note.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/note/note_driver.h>
+
+#include "nvic.h"
+#include "itm.h"
+#include "arm_internal.h"
+#include "itm_note.h"
+
+#ifdef CONFIG_ARMV7M_ITMNOTE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ARMV7M_ITMNOTE_PORT
+#  define CONFIG_ARMV7M_ITMNOTE_PORT 1
+#endif
+
+#define ITM_NOTE_PORT ITM_PORT(CONFIG_ARMV7M_ITMNOTE_PORT)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void itm_note_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t notelen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_itm_note_ops =
+{
+  itm_note_add
+};
+
+static struct note_driver_s g_itm_note_driver =
+{
+  &g_itm_note_ops
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: itm_note_add
+ *
+ * Description:
+ *   Write a note as is to the stimulus port, a word at a time.  The first
+ *   byte of each note is its length, which lets the host split the stream.
+ *   The interrupts are disabled so that the notes of interrupt handlers
+ *   can't be interleaved with the note being written.
+ *
+ ****************************************************************************/
+
+static void itm_note_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t notelen)
+{
+  FAR const uint8_t *buf = note;
+  irqstate_t flags;
+  uint32_t word;
+
+  UNUSED(drv);
+
+  /* Nothing to do if the probe has not enabled the ITM or the port */
+
+  if ((getreg32(ITM_TCR) & ITM_TCR_ITMENA_MASK) == 0 ||
+      (getreg32(ITM_TER) & (1 << CONFIG_ARMV7M_ITMNOTE_PORT)) == 0)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+
+  for (; notelen >= sizeof(word); buf += sizeof(word),
+       notelen -= sizeof(word))
+    {
+      memcpy(&word, buf, sizeof(word));
+      while (getreg32(ITM_NOTE_PORT) == 0);
+      putreg32(word, ITM_NOTE_PORT);
+    }
+
+  if (notelen >= 2)
+    {
+      while (getreg32(ITM_NOTE_PORT) == 0);
+      putreg16(buf[0] | (buf[1] << 8), ITM_NOTE_PORT);
+      buf     += 2;
+      notelen -= 2;
+    }
+
+  if (notelen > 0)
+    {
+      while (getreg32(ITM_NOTE_PORT) == 0);
+      putreg8(buf[0], ITM_NOTE_PORT);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: itm_note_initialize
+ *
+ * Description:
+ *   Enable the stimulus port and the ITM local timestamps, which the probe
+ *   adds to the packets, and register the note driver.
+ *
+ ****************************************************************************/
+
+int itm_note_initialize(void)
+{
+  uint32_t regval;
+
+  /* Enable trace in core debug */
+
+  regval  = getreg32(NVIC_DEMCR);
+  regval |= NVIC_DEMCR_TRCENA;
+  putreg32(regval, NVIC_DEMCR);
+
+  putreg32(0xc5acce55, ITM_LAR);
+
+  regval  = getreg32(ITM_TCR);
+  regval |= ITM_TCR_ITMENA_MASK | ITM_TCR_TSENA_MASK;
+  putreg32(regval, ITM_TCR);
+
+  regval  = getreg32(ITM_TER);
+  regval |= 1 << CONFIG_ARMV7M_ITMNOTE_PORT;
+  putreg32(regval, ITM_TER);
+
+  return note_driver_register(&g_itm_note_driver);
+}
+
+#endif /* CONFIG_ARMV7M_ITMNOTE */
@@ -0,0 +1,89 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_lazyfpu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "exc_return.h"
+#include "arm_internal.h"
+
+#ifdef CONFIG_ARMV7M_LAZYFPU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_lazyfpu_switch
+ *
+ * Description:
+ *   Called by up_switch_context() for the task that is being switched out.
+ *   With the lazy FP state preservation, the hardware stacks the FP context
+ *   only for a thread that has CONTROL.FPCA set, i.e. that has executed an
+ *   FP instruction.  Record whether the task owns an FP context and count
+ *   the switches that did not need to save one.
+ *
+ * Input Parameters:
+ *   rtcb - The task that is being switched out
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_switch(struct tcb_s *rtcb)
+{
+  bool fpused;
+
+  if (CURRENT_REGS)
+    {
+      /* In an interrupt handler, the exception frame of the interrupted
+       * task tells which frame type the hardware has stacked.
+       */
+
+      fpused = (CURRENT_REGS[REG_EXC_RETURN] & EXC_RETURN_STD_CONTEXT) == 0;
+    }
+  else
+    {
+      /* In thread mode, the frame stacked by the coming SVCall follows
+       * CONTROL.FPCA of the calling task.
+       */
+
+      fpused = (getcontrol() & CONTROL_FPCA) != 0;
+    }
+
+  if (fpused)
+    {
+      rtcb->flags |= TCB_FLAG_FPU_USED;
+    }
+  else
+    {
+      rtcb->flags &= ~TCB_FLAG_FPU_USED;
+      rtcb->fpuskips++;
+    }
+}
+
+#endif /* CONFIG_ARMV7M_LAZYFPU */
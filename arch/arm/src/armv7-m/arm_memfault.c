@@ -98,6 +98,19 @@ int arm_memfault(int irq, void *context, void *arg)
       mfalert("\tFloating-point lazy state preservation error\n");
     }
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Stacking on an overflowed stack hits the guard too, without a valid
+   * fault address.
+   */
+
+  if ((cfsr & NVIC_CFAULTS_MSTKERR) != 0 ||
+      ((cfsr & NVIC_CFAULTS_MMARVALID) != 0 &&
+       arm_stackguard_fault(getreg32(NVIC_MEMMANAGE_ADDR))))
+    {
+      _alert("Stack overflow\n");
+    }
+#endif
+
   up_irq_save();
   PANIC_WITH_REGS("panic", context);
   return OK; /* Won't get here */
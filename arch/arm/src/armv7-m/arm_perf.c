@@ -22,8 +22,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <string.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/perf.h>
 
 #include "arm_internal.h"
 #include "dwt.h"
@@ -36,6 +40,28 @@
 
 static unsigned long g_cpu_freq;
 
+#ifdef CONFIG_SCHED_PERF_EVENTS
+/* The 8-bit profiling counters of the DWT, and the events they count */
+
+static const struct
+{
+  uint32_t reg;
+  uint8_t event;
+} g_perf_dwt[] =
+{
+  { DWT_CPICNT,   PERF_EVENT_STALLS    },
+  { DWT_EXCCNT,   PERF_EVENT_EXCEPTION },
+  { DWT_SLEEPCNT, PERF_EVENT_SLEEP     },
+  { DWT_LSUCNT,   PERF_EVENT_LSU       },
+  { DWT_FOLDCNT,  PERF_EVENT_FOLDED    },
+};
+
+/* The values of the counters at the previous up_perf_event_read() */
+
+static uint32_t g_perf_cyccnt;
+static uint8_t g_perf_last[nitems(g_perf_dwt)];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -54,6 +80,19 @@ void up_perf_init(void *arg)
 
   putreg32(0xc5acce55, ITM_LAR);
   modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_MASK);
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  /* Start the profiling counters, unless the DWT has none */
+
+  if ((getreg32(DWT_CTRL) & DWT_CTRL_NOPRFCNT_MASK) == 0)
+    {
+      modifyreg32(DWT_CTRL, 0, DWT_CTRL_CPIEVTENA_MASK |
+                               DWT_CTRL_EXCEVTENA_MASK |
+                               DWT_CTRL_SLEEPEVTENA_MASK |
+                               DWT_CTRL_LSUEVTENA_MASK |
+                               DWT_CTRL_FOLDEVTENA_MASK);
+    }
+#endif
 }
 
 unsigned long up_perf_getfreq(void)
@@ -74,3 +113,62 @@ void up_perf_convert(unsigned long elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * g_cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * (uint64_t)left / g_cpu_freq;
 }
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+uint32_t up_perf_event_supported(void)
+{
+  uint32_t events = PERF_EVENT_BIT(PERF_EVENT_CYCLES);
+
+  if ((getreg32(DWT_CTRL) & DWT_CTRL_NOPRFCNT_MASK) == 0)
+    {
+      events |= PERF_EVENT_BIT(PERF_EVENT_INSTRUCTIONS) |
+                PERF_EVENT_BIT(PERF_EVENT_STALLS) |
+                PERF_EVENT_BIT(PERF_EVENT_EXCEPTION) |
+                PERF_EVENT_BIT(PERF_EVENT_SLEEP) |
+                PERF_EVENT_BIT(PERF_EVENT_LSU) |
+                PERF_EVENT_BIT(PERF_EVENT_FOLDED);
+    }
+
+  return events;
+}
+
+void up_perf_event_read(uint32_t *delta)
+{
+  uint32_t cyccnt = getreg32(DWT_CYCCNT);
+  uint8_t count;
+  int i;
+
+  memset(delta, 0, PERF_EVENT_MAX * sizeof(uint32_t));
+
+  delta[PERF_EVENT_CYCLES] = cyccnt - g_perf_cyccnt;
+  g_perf_cyccnt = cyccnt;
+
+  if ((getreg32(DWT_CTRL) & DWT_CTRL_NOPRFCNT_MASK) != 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < nitems(g_perf_dwt); i++)
+    {
+      count = (uint8_t)getreg32(g_perf_dwt[i].reg);
+      delta[g_perf_dwt[i].event] = (uint8_t)(count - g_perf_last[i]);
+      g_perf_last[i] = count;
+    }
+
+  /* The DWT has no instruction counter, but every cycle is an instruction
+   * unless counted as extra by a profiling counter, and a folded
+   * instruction takes no cycle.
+   */
+
+  delta[PERF_EVENT_INSTRUCTIONS] = delta[PERF_EVENT_CYCLES] -
+                                   delta[PERF_EVENT_STALLS] -
+                                   delta[PERF_EVENT_EXCEPTION] -
+                                   delta[PERF_EVENT_SLEEP] -
+                                   delta[PERF_EVENT_LSU] +
+                                   delta[PERF_EVENT_FOLDED];
+  if ((int32_t)delta[PERF_EVENT_INSTRUCTIONS] < 0)
+    {
+      delta[PERF_EVENT_INSTRUCTIONS] = 0;
+    }
+}
+#endif
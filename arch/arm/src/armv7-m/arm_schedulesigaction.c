@@ -161,7 +161,9 @@ void up_schedule_sigaction(struct tcb_s *tcb, sig_deliver_t sigdeliver)
               CURRENT_REGS[REG_XPSR]       = ARMV7M_XPSR_T;
 #ifdef CONFIG_BUILD_PROTECTED
               CURRENT_REGS[REG_LR]         = EXC_RETURN_PRIVTHR;
-              CURRENT_REGS[REG_EXC_RETURN] = EXC_RETURN_PRIVTHR;
+              CURRENT_REGS[REG_EXC_RETURN] =
+                EXC_RETURN_MODE(CURRENT_REGS[REG_EXC_RETURN],
+                                EXC_RETURN_PRIVTHR);
 #endif
             }
         }
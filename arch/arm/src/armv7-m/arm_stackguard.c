@@ -0,0 +1,115 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_stackguard.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+#include "mpu.h"
+#include "arm_internal.h"
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MPU region of the guard, allocated at the first context switch so
+ * that it has a higher number and priority than the regions of the board.
+ */
+
+static int g_stackguard_region = -1;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_stackguard_switch
+ *
+ * Description:
+ *   Called by up_switch_context() for the task that is being switched in.
+ *   Move the MPU guard region to the bottom of its stack:  a stack overflow
+ *   then faults on the first access below the stack, instead of silently
+ *   corrupting the memory below it.  The guard takes effect at the return
+ *   from the exception that switches the context.
+ *
+ * Input Parameters:
+ *   tcb - The task that is being switched in
+ *
+ ****************************************************************************/
+
+void arm_stackguard_switch(struct tcb_s *tcb)
+{
+  uint32_t region;
+
+  if (g_stackguard_region < 0)
+    {
+      g_stackguard_region = mpu_allocregion();
+    }
+
+  region = g_stackguard_region;
+  putreg32(region, MPU_RNR);
+
+  /* A thread may run on a stack too small to spare a guard */
+
+  if (tcb->stack_base_ptr == NULL ||
+      tcb->adj_stack_size < 4 * STACKGUARD_SIZE)
+    {
+      putreg32(0, MPU_RASR);
+      return;
+    }
+
+  putreg32(STACKGUARD_BASE(tcb) | region | MPU_RBAR_VALID, MPU_RBAR);
+  putreg32(MPU_RASR_ENABLE                                | /* Enable region */
+           MPU_RASR_SIZE_LOG2(5)                          | /* 32 bytes      */
+           MPU_RASR_AP_NONO                               | /* No access     */
+           MPU_RASR_XN,                                     /* No execution  */
+           MPU_RASR);
+}
+
+/****************************************************************************
+ * Name: arm_stackguard_fault
+ *
+ * Description:
+ *   Return true if a memory management fault address is in the guard of
+ *   the running task.
+ *
+ ****************************************************************************/
+
+bool arm_stackguard_fault(uintptr_t addr)
+{
+  struct tcb_s *tcb = running_task();
+  uintptr_t base = STACKGUARD_BASE(tcb);
+
+  return g_stackguard_region >= 0 && tcb->stack_base_ptr != NULL &&
+         addr >= base && addr < base + STACKGUARD_SIZE;
+}
+
+#endif /* CONFIG_ARMV7M_STACKGUARD */
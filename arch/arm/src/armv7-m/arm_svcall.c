@@ -235,7 +235,9 @@ int arm_svcall(int irq, void *context, void *arg)
            */
 
           regs[REG_PC]         = rtcb->xcp.syscall[index].sysreturn;
-          regs[REG_EXC_RETURN] = rtcb->xcp.syscall[index].excreturn;
+          regs[REG_EXC_RETURN] =
+            EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                            rtcb->xcp.syscall[index].excreturn);
           rtcb->xcp.nsyscalls  = index;
 
           /* The return value must be in R0-R1.  dispatch_syscall()
@@ -275,7 +277,8 @@ int arm_svcall(int irq, void *context, void *arg)
            */
 
           regs[REG_PC]         = (uint32_t)USERSPACE->task_startup & ~1;
-          regs[REG_EXC_RETURN] = EXC_RETURN_UNPRIVTHR;
+          regs[REG_EXC_RETURN] = EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                                                 EXC_RETURN_UNPRIVTHR);
 
           /* Change the parameter ordering to match the expectation of struct
            * userpace_s task_startup:
@@ -308,7 +311,8 @@ int arm_svcall(int irq, void *context, void *arg)
            */
 
           regs[REG_PC]         = (uint32_t)regs[REG_R1] & ~1;  /* startup */
-          regs[REG_EXC_RETURN] = EXC_RETURN_UNPRIVTHR;
+          regs[REG_EXC_RETURN] = EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                                                 EXC_RETURN_UNPRIVTHR);
 
           /* Change the parameter ordering to match the expectation of the
            * user space pthread_startup:
@@ -349,7 +353,8 @@ int arm_svcall(int irq, void *context, void *arg)
            */
 
           regs[REG_PC]         = (uint32_t)USERSPACE->signal_handler & ~1;
-          regs[REG_EXC_RETURN] = EXC_RETURN_UNPRIVTHR;
+          regs[REG_EXC_RETURN] = EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                                                 EXC_RETURN_UNPRIVTHR);
 
           /* Change the parameter ordering to match the expectation of struct
            * userpace_s signal_handler.
@@ -382,7 +387,8 @@ int arm_svcall(int irq, void *context, void *arg)
           DEBUGASSERT(rtcb->xcp.sigreturn != 0);
 
           regs[REG_PC]         = rtcb->xcp.sigreturn & ~1;
-          regs[REG_EXC_RETURN] = EXC_RETURN_PRIVTHR;
+          regs[REG_EXC_RETURN] = EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                                                 EXC_RETURN_PRIVTHR);
           rtcb->xcp.sigreturn  = 0;
         }
         break;
@@ -416,7 +422,8 @@ int arm_svcall(int irq, void *context, void *arg)
           rtcb->xcp.nsyscalls  = index + 1;
 
           regs[REG_PC]         = (uint32_t)dispatch_syscall & ~1;
-          regs[REG_EXC_RETURN] = EXC_RETURN_PRIVTHR;
+          regs[REG_EXC_RETURN] = EXC_RETURN_MODE(regs[REG_EXC_RETURN],
+                                                 EXC_RETURN_PRIVTHR);
 
           /* Offset R0 to account for the reserved values */
 
@@ -79,9 +79,12 @@
 
 /* EXC_RETURN_PRIVTHR: Return to privileged thread mode. Exception return
  * gets state from the main stack. Execution uses MSP after return.
+ *
+ * With CONFIG_ARMV7M_LAZYFPU, a new context starts without an FP context
+ * and gets one only when it executes its first FP instruction.
  */
 
-#ifdef CONFIG_ARCH_FPU
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_LAZYFPU)
 #  define EXC_RETURN_PRIVTHR     (EXC_RETURN_BASE | EXC_RETURN_THREAD_MODE)
 #else
 #  define EXC_RETURN_PRIVTHR     (EXC_RETURN_BASE | EXC_RETURN_STD_CONTEXT | \
@@ -92,7 +95,7 @@
  * gets state from the process stack. Execution uses PSP after return.
  */
 
-#ifdef CONFIG_ARCH_FPU
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_LAZYFPU)
 #  define EXC_RETURN_UNPRIVTHR   (EXC_RETURN_BASE | EXC_RETURN_THREAD_MODE | \
                                   EXC_RETURN_PROCESS_STACK)
 #else
@@ -100,6 +103,19 @@
                                   EXC_RETURN_THREAD_MODE | EXC_RETURN_PROCESS_STACK)
 #endif
 
+/* EXC_RETURN_MODE: Select a new return mode for an exception frame that is
+ * already on the stack.  With CONFIG_ARMV7M_LAZYFPU the frame may or may
+ * not include the FP context, so its EXC_RETURN_STD_CONTEXT bit must be
+ * preserved.
+ */
+
+#ifdef CONFIG_ARMV7M_LAZYFPU
+#  define EXC_RETURN_MODE(excret, mode) \
+     (((mode) & ~EXC_RETURN_STD_CONTEXT) | ((excret) & EXC_RETURN_STD_CONTEXT))
+#else
+#  define EXC_RETURN_MODE(excret, mode) (mode)
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
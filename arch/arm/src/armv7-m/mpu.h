@@ -380,6 +380,28 @@ void mpu_configure_region(uintptr_t base, size_t size,
                                                /* Instruction access */); \
     } while (0)
 
+/****************************************************************************
+ * Name: mpu_priv_noncache
+ *
+ * Description:
+ *   Configure a region as privileged normal memory that is not cached, for
+ *   the memory shared with DMA devices (see dma_coherent_initialize())
+ *
+ ****************************************************************************/
+
+#define mpu_priv_noncache(base, size) \
+  do \
+    { \
+      /* The configure the region */ \
+      mpu_configure_region(base, size, \
+                           MPU_RASR_TEX_NOR  | /* Normal             */ \
+                                               /* Not Cacheable      */ \
+                                               /* Not Bufferable     */ \
+                           MPU_RASR_S        | /* Shareable          */ \
+                           MPU_RASR_AP_RWNO    /* P:RW   U:None      */ \
+                                               /* Instruction access */); \
+    } while (0)
+
 /****************************************************************************
  * Name: mpu_user_extsram
  *
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <sched.h>
@@ -43,6 +44,24 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arm_tcbstack_base
+ *
+ * Description:
+ *   Return the lowest address of the stack of a thread that can be read,
+ *   above the MPU guard of the running thread.
+ *
+ ****************************************************************************/
+
+static inline uintptr_t arm_tcbstack_base(struct tcb_s *tcb)
+{
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  return STACKGUARD_BASE(tcb) + STACKGUARD_SIZE;
+#else
+  return (uintptr_t)tcb->stack_base_ptr;
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -200,6 +219,7 @@ void arm_stack_color(void *stackbase, size_t nbytes)
 
 size_t up_check_tcbstack(struct tcb_s *tcb)
 {
+  uintptr_t base = arm_tcbstack_base(tcb);
   size_t size;
 
 #ifdef CONFIG_ARCH_ADDRENV
@@ -211,7 +231,8 @@ size_t up_check_tcbstack(struct tcb_s *tcb)
     }
 #endif
 
-  size = arm_stack_check(tcb->stack_base_ptr, tcb->adj_stack_size);
+  size = arm_stack_check((void *)base, (uintptr_t)tcb->stack_base_ptr +
+                         tcb->adj_stack_size - base);
 
 #ifdef CONFIG_ARCH_ADDRENV
   if (tcb->addrenv_own != NULL)
@@ -223,6 +244,72 @@ size_t up_check_tcbstack(struct tcb_s *tcb)
   return size;
 }
 
+/****************************************************************************
+ * Name: up_check_tcbstack_mark
+ *
+ * Description:
+ *   Refine a known stack use of a thread:  scan the coloring down from the
+ *   mark, until CONFIG_SCHED_STACK_WATERMARK_WINDOW bytes in a row were
+ *   never written.  Only the stack beyond the mark is read.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB of the thread
+ *   mark - The stack use known so far, in bytes
+ *
+ * Returned Value:
+ *   The stack use found, no less than mark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+size_t up_check_tcbstack_mark(struct tcb_s *tcb, size_t mark)
+{
+  uintptr_t start;
+  uintptr_t end;
+  uint32_t *ptr;
+  size_t clean = 0;
+
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct addrenv_s *oldenv;
+
+  if (tcb->addrenv_own != NULL)
+    {
+      addrenv_select(tcb->addrenv_own, &oldenv);
+    }
+#endif
+
+  start = STACK_ALIGN_UP(arm_tcbstack_base(tcb));
+  end   = STACK_ALIGN_DOWN((uintptr_t)tcb->stack_base_ptr +
+                           tcb->adj_stack_size);
+
+  /* Walk down the push-down stack from the first word below the mark */
+
+  for (ptr = (uint32_t *)(end - (MIN(mark, end - start) & ~3));
+       (uintptr_t)ptr > start &&
+       clean < CONFIG_SCHED_STACK_WATERMARK_WINDOW; )
+    {
+      if (*--ptr == STACK_COLOR)
+        {
+          clean += 4;
+        }
+      else
+        {
+          mark  = end - (uintptr_t)ptr;
+          clean = 0;
+        }
+    }
+
+#ifdef CONFIG_ARCH_ADDRENV
+  if (tcb->addrenv_own != NULL)
+    {
+      addrenv_restore(oldenv);
+    }
+#endif
+
+  return mark;
+}
+#endif
+
 #if CONFIG_ARCH_INTERRUPTSTACK > 3
 size_t up_check_intstack(void)
 {
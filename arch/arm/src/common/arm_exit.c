@@ -136,6 +136,7 @@ void up_exit(int status)
    */
 
   nxsched_resume_scheduler(tcb);
+  arm_stackguard_switch(tcb);
 
   /* Then switch contexts */
 
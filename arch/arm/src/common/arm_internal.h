@@ -127,6 +127,17 @@
 #define INTSTACK_COLOR 0xdeadbeef
 #define HEAP_COLOR     'h'
 
+/* The MPU guards the bottom of the stack of the running thread, the lowest
+ * aligned 32 bytes above the stack base.
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define STACKGUARD_SIZE 32
+#  define STACKGUARD_BASE(tcb) \
+     (((uintptr_t)(tcb)->stack_base_ptr + STACKGUARD_SIZE - 1) & \
+      ~(uintptr_t)(STACKGUARD_SIZE - 1))
+#endif
+
 #define getreg8(a)     (*(volatile uint8_t *)(a))
 #define putreg8(v,a)   (*(volatile uint8_t *)(a) = (v))
 #define getreg16(a)    (*(volatile uint16_t *)(a))
@@ -452,6 +463,21 @@ void arm_fpuconfig(void);
 #  define arm_fpuconfig()
 #endif
 
+#ifdef CONFIG_ARCH_LAZYFPU
+void arm_lazyfpu_switch(struct tcb_s *rtcb);
+#else
+#  define arm_lazyfpu_switch(rtcb)
+#endif
+
+/* MPU stack guard **********************************************************/
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+void arm_stackguard_switch(struct tcb_s *tcb);
+bool arm_stackguard_fault(uintptr_t addr);
+#else
+#  define arm_stackguard_switch(tcb)
+#endif
+
 /* Low level serial output **************************************************/
 
 void arm_lowputc(char ch);
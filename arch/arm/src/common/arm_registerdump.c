@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/arch.h>
@@ -48,6 +49,13 @@
 uintptr_t up_getusrsp(void *regs)
 {
   uint32_t *ptr = regs;
+
+  if (ptr == NULL)
+    {
+      ptr = (uint32_t *)CURRENT_REGS;
+      DEBUGASSERT(ptr != NULL);
+    }
+
   return ptr[REG_SP];
 }
 
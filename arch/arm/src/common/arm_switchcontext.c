@@ -59,6 +59,10 @@ void up_switch_context(struct tcb_s *tcb, struct tcb_s *rtcb)
 
   nxsched_suspend_scheduler(rtcb);
 
+  /* Account for the FPU context of the task being switched out */
+
+  arm_lazyfpu_switch(rtcb);
+
   /* Are we in an interrupt handler? */
 
   if (CURRENT_REGS)
@@ -72,6 +76,7 @@ void up_switch_context(struct tcb_s *tcb, struct tcb_s *rtcb)
       /* Update scheduler parameters */
 
       nxsched_resume_scheduler(tcb);
+      arm_stackguard_switch(tcb);
 
       /* Then switch contexts.  Any necessary address environment
        * changes will be made when the interrupt returns.
@@ -87,6 +92,7 @@ void up_switch_context(struct tcb_s *tcb, struct tcb_s *rtcb)
       /* Update scheduler parameters */
 
       nxsched_resume_scheduler(tcb);
+      arm_stackguard_switch(tcb);
 
       /* Switch context to the context of the task at the head of the
        * ready to run list.
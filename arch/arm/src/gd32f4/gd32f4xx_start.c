@@ -161,21 +161,20 @@ static inline void gd32_fpuconfig(void)
 {
   uint32_t regval;
 
-  /* Clear CONTROL.FPCA so that we do not get the extended context frame
-   * with the volatile FP registers stacked in the saved context.
+  /* Clear CONTROL.FPCA.  The processor sets it again on the first FP
+   * instruction executed by a context.
    */
 
   regval = getcontrol();
   regval &= ~CONTROL_FPCA;
   setcontrol(regval);
 
-  /* Ensure that FPCCR.LSPEN is disabled, so that we don't have to contend
-   * with the lazy FP context save behaviour.  Clear FPCCR.ASPEN since we
-   * are going to keep CONTROL.FPCA off for all contexts.
+  /* Enable the automatic and lazy FP state preservation so that only the
+   * contexts that use the FPU get the extended context frame.
    */
 
   regval = getreg32(NVIC_FPCCR);
-  regval &= ~(NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN);
+  regval |= NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN;
   putreg32(regval, NVIC_FPCCR);
 
   /* Enable full access to CP10 and CP11 */
@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <sys/types.h>
+#include <sys/param.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -364,6 +365,15 @@
 #  undef ADC_HAVE_CB
 #endif
 
+/* Streaming mode of the upper half with a cyclic DMA */
+
+#if defined(CONFIG_ADC_STREAM) && defined(ADC_HAVE_DMA) && \
+    !defined(CONFIG_STM32_ADC_NOIRQ)
+#  define ADC_HAVE_STREAM
+#else
+#  undef ADC_HAVE_STREAM
+#endif
+
 /* ADC software trigger configuration */
 
 #define ANIOC_TRIGGER_REGULAR  (1 << 0)
@@ -455,6 +465,10 @@ struct stm32_dev_s
 
   uint16_t r_dmabuffer[CONFIG_STM32_ADC_MAX_SAMPLES];
 #endif
+#ifdef ADC_HAVE_STREAM
+  uint8_t *s_buffer;         /* Stream buffer, NULL if not streaming */
+  size_t   s_half;           /* Bytes in each half of the stream buffer */
+#endif
 
   /* List of selected ADC channels to sample */
 
@@ -575,6 +589,11 @@ static int  adc_timinit(struct stm32_dev_s *priv);
 static void adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr,
                                 void *arg);
 #endif
+#ifdef ADC_HAVE_STREAM
+static void adc_dmastreamcallback(DMA_HANDLE handle, uint8_t isr,
+                                  void *arg);
+static int  adc_stream(struct adc_dev_s *dev, void *buffer, size_t size);
+#endif
 
 static void adc_reg_startconv(struct stm32_dev_s *priv, bool enable);
 #ifdef ADC_HAVE_INJECTED
@@ -648,6 +667,9 @@ static const struct adc_ops_s g_adcops =
   .ao_shutdown    = adc_shutdown,
   .ao_rxint       = adc_rxint,
   .ao_ioctl       = adc_ioctl,
+#ifdef ADC_HAVE_STREAM
+  .ao_stream      = adc_stream,
+#endif
 };
 
 /* Publicly visible ADC lower-half operations */
@@ -2243,6 +2265,46 @@ static void adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr,
 }
 #endif
 
+/****************************************************************************
+ * Name: adc_dmastreamcallback
+ *
+ * Description:
+ *   Callback for DMA in streaming mode.  Called from the half and complete
+ *   interrupts of the cyclic transfer into the stream buffer, each of them
+ *   ending one of its halves.
+ *
+ ****************************************************************************/
+
+#ifdef ADC_HAVE_STREAM
+static void adc_dmastreamcallback(DMA_HANDLE handle, uint8_t isr,
+                                  void *arg)
+{
+  struct adc_dev_s   *dev  = (struct adc_dev_s *)arg;
+  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+
+  if (priv->cb == NULL || priv->cb->au_block == NULL ||
+      priv->s_buffer == NULL)
+    {
+      return;
+    }
+
+  if ((isr & DMA_STATUS_HTIF) != 0)
+    {
+      priv->cb->au_block(dev, priv->s_buffer, priv->s_half);
+    }
+
+  if ((isr & DMA_STATUS_TCIF) != 0)
+    {
+      priv->cb->au_block(dev, priv->s_buffer + priv->s_half, priv->s_half);
+
+      /* Keep the DMA requests going in one shot mode */
+
+      adc_modifyreg(priv, STM32_ADC_DMAREG_OFFSET, ADC_DMAREG_DMA, 0);
+      adc_modifyreg(priv, STM32_ADC_DMAREG_OFFSET, 0, ADC_DMAREG_DMA);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: adc_bind
  *
@@ -2665,6 +2727,70 @@ static void adc_dma_start(struct adc_dev_s *dev)
 }
 #endif /* ADC_HAVE_DMA */
 
+/****************************************************************************
+ * Name: adc_stream
+ *
+ * Description:
+ *   Convert into the stream buffer with a cyclic DMA, delivering each of
+ *   its halves to the upper half, or go back to delivering every sample if
+ *   buffer is NULL.  The buffer holds the 16-bit conversions of the
+ *   regular channels in turn, and each half a whole number of sequences.
+ *
+ ****************************************************************************/
+
+#ifdef ADC_HAVE_STREAM
+static int adc_stream(struct adc_dev_s *dev, void *buffer, size_t size)
+{
+  struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+  size_t seqlen;
+  size_t count;
+
+  if (!priv->hasdma || priv->dma == NULL || priv->rnchannels == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  stm32_dmastop(priv->dma);
+
+  if (buffer == NULL)
+    {
+      priv->s_buffer = NULL;
+      priv->current  = 0;
+
+      stm32_dmasetup(priv->dma,
+                     priv->base + STM32_ADC_DR_OFFSET,
+                     (uint32_t)priv->r_dmabuffer,
+                     priv->rnchannels,
+                     ADC_DMA_CONTROL_WORD);
+
+      stm32_dmastart(priv->dma, adc_dmaconvcallback, dev, false);
+      return OK;
+    }
+
+  /* Both halves hold whole sequences, within the 16-bit DMA counter */
+
+  seqlen = 2 * priv->rnchannels;
+  count  = MIN(size / sizeof(uint16_t), 0xffff);
+  count -= count % seqlen;
+  if (count == 0)
+    {
+      return -EINVAL;
+    }
+
+  priv->s_buffer = buffer;
+  priv->s_half   = count / 2 * sizeof(uint16_t);
+
+  stm32_dmasetup(priv->dma,
+                 priv->base + STM32_ADC_DR_OFFSET,
+                 (uint32_t)buffer,
+                 count,
+                 ADC_DMA_CONTROL_WORD);
+
+  stm32_dmastart(priv->dma, adc_dmastreamcallback, dev, true);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_configure
  ****************************************************************************/
@@ -0,0 +1,465 @@
+/****************************************************************************
+ * arch/arm/src/stm32/stm32_dmadev.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+/* stm32_dma.h and nuttx/dma/dma.h both name their callback type
+ * dma_callback_t.
+ */
+
+#define dma_callback_t stm32_dma_callback_t
+#include "stm32_dma.h"
+#undef dma_callback_t
+
+#include <nuttx/dma/dma.h>
+
+#include "stm32_dmadev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_STM32_HAVE_IP_DMA_V1)
+#  define DMADEV_M2M          (DMA_CCR_MEM2MEM | DMA_CCR_PINC | DMA_CCR_MINC)
+#  define DMADEV_M2P          (DMA_CCR_DIR | DMA_CCR_MINC)
+#  define DMADEV_P2M          (DMA_CCR_MINC)
+#  define DMADEV_CIRC         DMA_CCR_CIRC
+#  define DMADEV_PL_SHIFT     DMA_CCR_PL_SHIFT
+#  define DMADEV_PSIZE_SHIFT  DMA_CCR_PSIZE_SHIFT
+#  define DMADEV_MSIZE_SHIFT  DMA_CCR_MSIZE_SHIFT
+#else
+#  define DMADEV_M2M          (DMA_SCR_DIR_M2M | DMA_SCR_PINC | DMA_SCR_MINC)
+#  define DMADEV_M2P          (DMA_SCR_DIR_M2P | DMA_SCR_MINC)
+#  define DMADEV_P2M          (DMA_SCR_DIR_P2M | DMA_SCR_MINC)
+#  define DMADEV_CIRC         DMA_SCR_CIRC
+#  define DMADEV_PL_SHIFT     DMA_SCR_PL_SHIFT
+#  define DMADEV_PSIZE_SHIFT  DMA_SCR_PSIZE_SHIFT
+#  define DMADEV_MSIZE_SHIFT  DMA_SCR_MSIZE_SHIFT
+#endif
+
+/* A transfer counts at most 65535 items of 1, 2 or 4 bytes */
+
+#define DMADEV_MAXITEMS       0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stm32_dmadev_chan_s
+{
+  struct dma_chan_s chan;          /* Must be first, see struct dma_chan_s */
+  DMA_HANDLE     handle;           /* From stm32_dmachannel() */
+  dma_callback_t callback;         /* Of the running transfer */
+  FAR void      *arg;
+  size_t         len;              /* Bytes reported per callback */
+  uint8_t        width;            /* Bytes per item of the transfer */
+  bool           cyclic;           /* true: Started by start_cyclic */
+  struct dma_config_s cfg;         /* From the last config */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int    stm32_dmadev_config(FAR struct dma_chan_s *chan,
+                                  FAR const struct dma_config_s *cfg);
+static int    stm32_dmadev_start(FAR struct dma_chan_s *chan,
+                                 dma_callback_t callback, FAR void *arg,
+                                 uintptr_t dst, uintptr_t src, size_t len);
+static int    stm32_dmadev_start_cyclic(FAR struct dma_chan_s *chan,
+                                        dma_callback_t callback,
+                                        FAR void *arg, uintptr_t dst,
+                                        uintptr_t src, size_t len,
+                                        size_t period_len);
+static int    stm32_dmadev_stop(FAR struct dma_chan_s *chan);
+static int    stm32_dmadev_pause(FAR struct dma_chan_s *chan);
+static int    stm32_dmadev_resume(FAR struct dma_chan_s *chan);
+static size_t stm32_dmadev_residual(FAR struct dma_chan_s *chan);
+
+static FAR struct dma_chan_s *
+stm32_dmadev_get_chan(FAR struct dma_dev_s *dev, unsigned int ident);
+static void   stm32_dmadev_put_chan(FAR struct dma_dev_s *dev,
+                                    FAR struct dma_chan_s *chan);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dma_ops_s g_stm32_dmadev_ops =
+{
+  stm32_dmadev_config,          /* config */
+  stm32_dmadev_start,           /* start */
+  stm32_dmadev_start_cyclic,    /* start_cyclic */
+#ifdef CONFIG_DMA_LINK
+  NULL,                         /* start_link */
+#endif
+  stm32_dmadev_stop,            /* stop */
+  stm32_dmadev_pause,           /* pause */
+  stm32_dmadev_resume,          /* resume */
+  stm32_dmadev_residual,        /* residual */
+};
+
+static struct dma_dev_s g_stm32_dmadev =
+{
+  stm32_dmadev_get_chan,        /* get_chan */
+  stm32_dmadev_put_chan,        /* put_chan */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_dmadev_size
+ *
+ * Description:
+ *   Return the PSIZE/MSIZE encoding of a width of 1, 2 or 4 bytes.
+ *
+ ****************************************************************************/
+
+static uint32_t stm32_dmadev_size(unsigned int width)
+{
+  return width == 4 ? 2 : width == 2 ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_callback
+ *
+ * Description:
+ *   Translate the completion status of stm32_dma.c into the length or
+ *   error code passed to the client.
+ *
+ ****************************************************************************/
+
+static void stm32_dmadev_callback(DMA_HANDLE handle, uint8_t status,
+                                  FAR void *arg)
+{
+  FAR struct stm32_dmadev_chan_s *priv = arg;
+
+  if ((status & DMA_STATUS_ERROR) != 0)
+    {
+      priv->callback(&priv->chan, priv->arg, -EIO);
+    }
+  else if (priv->cyclic || (status & DMA_STATUS_TCIF) != 0)
+    {
+      priv->callback(&priv->chan, priv->arg, priv->len);
+    }
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_setup
+ *
+ * Description:
+ *   Program the channel for one transfer of len bytes.
+ *
+ ****************************************************************************/
+
+static int stm32_dmadev_setup(FAR struct stm32_dmadev_chan_s *priv,
+                              uintptr_t dst, uintptr_t src, size_t len,
+                              uint32_t ccr)
+{
+  unsigned int width;
+  uintptr_t paddr;
+  uintptr_t maddr;
+
+  /* The peripheral address is the source of memory to memory transfers,
+   * also on the F1 where the direction bit is clear for those.
+   */
+
+  switch (priv->cfg.direction)
+    {
+      case DMA_MEM_TO_MEM:
+        width = priv->cfg.src_width;
+        if (width == 0)
+          {
+            width = ((dst | src | len) & 3) == 0 ? 4 :
+                    ((dst | src | len) & 1) == 0 ? 2 : 1;
+          }
+
+        paddr = src;
+        maddr = dst;
+        ccr  |= DMADEV_M2M;
+        break;
+
+      case DMA_MEM_TO_DEV:
+        width = priv->cfg.dst_width;
+        paddr = dst;
+        maddr = src;
+        ccr  |= DMADEV_M2P;
+        break;
+
+      case DMA_DEV_TO_MEM:
+        width = priv->cfg.src_width;
+        paddr = src;
+        maddr = dst;
+        ccr  |= DMADEV_P2M;
+        break;
+
+      default:
+        return -ENOSYS;
+    }
+
+  if (width == 0)
+    {
+      width = 1;
+    }
+
+  if ((width != 1 && width != 2 && width != 4) || (len % width) != 0 ||
+      len / width > DMADEV_MAXITEMS)
+    {
+      return -EINVAL;
+    }
+
+  ccr |= stm32_dmadev_size(width) << DMADEV_PSIZE_SHIFT;
+  ccr |= stm32_dmadev_size(width) << DMADEV_MSIZE_SHIFT;
+  ccr |= (uint32_t)MIN(priv->cfg.priority, 3) << DMADEV_PL_SHIFT;
+
+#ifdef CONFIG_STM32_DMACAPABLE
+  if (!stm32_dmacapable(maddr, len / width, ccr))
+    {
+      return -EFAULT;
+    }
+#endif
+
+  priv->width = width;
+  stm32_dmasetup(priv->handle, paddr, maddr, len / width, ccr);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_config
+ ****************************************************************************/
+
+static int stm32_dmadev_config(FAR struct dma_chan_s *chan,
+                               FAR const struct dma_config_s *cfg)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+
+  /* Zero keeps the current value */
+
+  if (cfg->direction != 0)
+    {
+      priv->cfg.direction = cfg->direction;
+    }
+
+  if (cfg->priority != 0)
+    {
+      priv->cfg.priority = cfg->priority;
+    }
+
+  if (cfg->dst_width != 0)
+    {
+      priv->cfg.dst_width = cfg->dst_width;
+    }
+
+  if (cfg->src_width != 0)
+    {
+      priv->cfg.src_width = cfg->src_width;
+    }
+
+  return priv->cfg.direction == DMA_DEV_TO_DEV ? -ENOSYS : OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_start
+ ****************************************************************************/
+
+static int stm32_dmadev_start(FAR struct dma_chan_s *chan,
+                              dma_callback_t callback, FAR void *arg,
+                              uintptr_t dst, uintptr_t src, size_t len)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+  int ret;
+
+  ret = stm32_dmadev_setup(priv, dst, src, len, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv->callback = callback;
+  priv->arg      = arg;
+  priv->len      = len;
+  priv->cyclic   = false;
+
+  stm32_dmastart(priv->handle, stm32_dmadev_callback, priv, false);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_start_cyclic
+ *
+ * Description:
+ *   The controller interrupts at the half and the end of its buffer, so
+ *   the buffer holds one or two periods.
+ *
+ ****************************************************************************/
+
+static int stm32_dmadev_start_cyclic(FAR struct dma_chan_s *chan,
+                                     dma_callback_t callback,
+                                     FAR void *arg, uintptr_t dst,
+                                     uintptr_t src, size_t len,
+                                     size_t period_len)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+  int ret;
+
+  if ((period_len != len && period_len * 2 != len) ||
+      priv->cfg.direction == DMA_MEM_TO_MEM)
+    {
+      return -EINVAL;
+    }
+
+  ret = stm32_dmadev_setup(priv, dst, src, len, DMADEV_CIRC);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv->callback = callback;
+  priv->arg      = arg;
+  priv->len      = period_len;
+  priv->cyclic   = true;
+
+  stm32_dmastart(priv->handle, stm32_dmadev_callback, priv,
+                 period_len != len);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_stop
+ ****************************************************************************/
+
+static int stm32_dmadev_stop(FAR struct dma_chan_s *chan)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+
+  stm32_dmastop(priv->handle);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_pause
+ ****************************************************************************/
+
+static int stm32_dmadev_pause(FAR struct dma_chan_s *chan)
+{
+  /* Disabling a stream ends its transfer, it can't be resumed */
+
+  return -ENOSYS;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_resume
+ ****************************************************************************/
+
+static int stm32_dmadev_resume(FAR struct dma_chan_s *chan)
+{
+  return -ENOSYS;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_residual
+ ****************************************************************************/
+
+static size_t stm32_dmadev_residual(FAR struct dma_chan_s *chan)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+
+  return stm32_dmaresidual(priv->handle) * priv->width;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_get_chan
+ ****************************************************************************/
+
+static FAR struct dma_chan_s *
+stm32_dmadev_get_chan(FAR struct dma_dev_s *dev, unsigned int ident)
+{
+  FAR struct stm32_dmadev_chan_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct stm32_dmadev_chan_s));
+  if (priv == NULL)
+    {
+      return NULL;
+    }
+
+  priv->chan.ops = &g_stm32_dmadev_ops;
+  priv->handle   = stm32_dmachannel(ident);
+  if (priv->handle == NULL)
+    {
+      kmm_free(priv);
+      return NULL;
+    }
+
+  return &priv->chan;
+}
+
+/****************************************************************************
+ * Name: stm32_dmadev_put_chan
+ ****************************************************************************/
+
+static void stm32_dmadev_put_chan(FAR struct dma_dev_s *dev,
+                                  FAR struct dma_chan_s *chan)
+{
+  FAR struct stm32_dmadev_chan_s *priv =
+    (FAR struct stm32_dmadev_chan_s *)chan;
+
+  stm32_dmafree(priv->handle);
+  kmm_free(priv);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_dmadev_initialize
+ *
+ * Description:
+ *   Return the DMA controller as a struct dma_dev_s of nuttx/dma/dma.h.
+ *   The ident of DMA_GET_CHAN() is the argument of stm32_dmachannel(),
+ *   i.e. a DMACHAN_* (F1) or DMAMAP_* (F4) value, and memory to memory
+ *   transfers need a DMA2 stream on the F4.
+ *
+ ****************************************************************************/
+
+FAR struct dma_dev_s *stm32_dmadev_initialize(void)
+{
+  return &g_stm32_dmadev;
+}
@@ -0,0 +1,65 @@
+/****************************************************************************
+ * arch/arm/src/stm32/stm32_dmadev.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_STM32_STM32_DMADEV_H
+#define __ARCH_ARM_SRC_STM32_STM32_DMADEV_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: stm32_dmadev_initialize
+ *
+ * Description:
+ *   Return the DMA controller as a struct dma_dev_s of nuttx/dma/dma.h.
+ *   The ident of DMA_GET_CHAN() is the argument of stm32_dmachannel(),
+ *   i.e. a DMACHAN_* (F1) or DMAMAP_* (F4) value, and memory to memory
+ *   transfers need a DMA2 stream on the F4.
+ *
+ ****************************************************************************/
+
+struct dma_dev_s;
+FAR struct dma_dev_s *stm32_dmadev_initialize(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __ARCH_ARM_SRC_STM32_STM32_DMADEV_H */
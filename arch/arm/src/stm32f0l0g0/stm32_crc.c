@@ -0,0 +1,125 @@
+/****************************************************************************
+ * arch/arm/src/stm32f0l0g0/stm32_crc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/spinlock.h>
+
+#include "arm_internal.h"
+#include "hardware/stm32_crc.h"
+
+#ifdef CONFIG_STM32F0L0G0_CRC32
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC-32 polynomial, in the normal bit order of the unit */
+
+#define CRC32_POLY  0x04c11db7
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_crc_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_crc_bitrev
+ ****************************************************************************/
+
+static inline uint32_t stm32_crc_bitrev(uint32_t value)
+{
+  uint32_t result = 0;
+  int i;
+
+  for (i = 0; i < 32; i++)
+    {
+      result = (result << 1) | (value & 1);
+      value >>= 1;
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   Replaces the software crc32part() of the C library.  The unit computes
+ *   the CRC in the normal bit order:  reversing the input bytes and the
+ *   output gives the reflected CRC-32 of the software version, and the
+ *   running value is loaded bit-reversed as the initial value.
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  irqstate_t flags;
+
+  if (len == 0)
+    {
+      return crc32val;
+    }
+
+  flags = spin_lock_irqsave(&g_crc_lock);
+
+  putreg32(CRC_CR_POLYSIZE_32 | CRC_CR_REVIN_BYTE | CRC_CR_REVOUT,
+           STM32_CRC_CR);
+  putreg32(CRC32_POLY, STM32_CRC_POL);
+  putreg32(stm32_crc_bitrev(crc32val), STM32_CRC_INIT);
+  modifyreg32(STM32_CRC_CR, 0, CRC_CR_RESET);
+
+  /* A word written to DR is processed from its most significant byte:
+   * four bytes go in with one access when assembled big endian.
+   */
+
+  for (; len >= 4; len -= 4, src += 4)
+    {
+      putreg32((uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 |
+               (uint32_t)src[2] << 8 | src[3], STM32_CRC_DR);
+    }
+
+  while (len-- > 0)
+    {
+      putreg8(*src++, STM32_CRC_DR);
+    }
+
+  crc32val = getreg32(STM32_CRC_DR);
+  spin_unlock_irqrestore(&g_crc_lock, flags);
+  return crc32val;
+}
+
+#endif /* CONFIG_STM32F0L0G0_CRC32 */
@@ -52,6 +52,7 @@
 #endif
 
 #include <nuttx/cache.h>
+#include <nuttx/dma/dma_map.h>
 #include "arm_internal.h"
 #include "barriers.h"
 
@@ -1111,8 +1112,7 @@ static int stm32_transmit(struct stm32_ethmac_s *priv)
 
   /* Flush the contents of the TX buffer into physical memory */
 
-  up_clean_dcache((uintptr_t)priv->dev.d_buf,
-                  (uintptr_t)priv->dev.d_buf + priv->dev.d_len);
+  dma_map_single(priv->dev.d_buf, priv->dev.d_len, DMA_TO_DEVICE);
 
   /* Is the size to be sent greater than the size of the Ethernet buffer? */
 
@@ -1791,9 +1791,9 @@ static int stm32_recvframe(struct stm32_ethmac_s *priv)
                        * physical memory.
                        */
 
-                      up_invalidate_dcache((uintptr_t)dev->d_buf,
-                                           (uintptr_t)dev->d_buf +
-                                           MIN(dev->d_len, ALIGNED_BUFSIZE));
+                      dma_unmap_single((uintptr_t)dev->d_buf,
+                                       MIN(dev->d_len, ALIGNED_BUFSIZE),
+                                       DMA_FROM_DEVICE);
 
                       ninfo("rxhead: %p d_buf: %p d_len: %d\n",
                             priv->rxhead, dev->d_buf, dev->d_len);
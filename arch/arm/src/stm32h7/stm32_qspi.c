@@ -333,6 +333,14 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static void *qspi_alloc(struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(struct qspi_dev_s *dev, void *buffer);
+static int      qspi_memmap(struct qspi_dev_s *dev,
+                  const struct qspi_meminfo_s *meminfo, void **base);
+
+/* Memory mapped mode */
+
+static void     qspi_enter_memmap(struct stm32h7_qspidev_s *priv,
+                  const struct qspi_meminfo_s *meminfo, uint32_t lpto);
+static void     qspi_exit_memmap(struct stm32h7_qspidev_s *priv);
 
 /* Initialization */
 
@@ -354,6 +362,7 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+  .memmap            = qspi_memmap,
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2539,6 +2548,134 @@ static int qspi_hw_initialize(struct stm32h7_qspidev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: qspi_enter_memmap
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode, with the bus locked.
+ *
+ ****************************************************************************/
+
+static void qspi_enter_memmap(struct stm32h7_qspidev_s *priv,
+                              const struct qspi_meminfo_s *meminfo,
+                              uint32_t lpto)
+{
+  uint32_t regval;
+  struct qspi_xctnspec_s xctn;
+
+  if (priv->memmap)
+    {
+      return;
+    }
+
+  /* Abort anything in-progress */
+
+  qspi_abort(priv);
+
+  /* Wait till BUSY flag reset */
+
+  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
+
+  /* if we want the 'low-power timeout counter' */
+
+  if (lpto > 0)
+    {
+      /* Set the Low Power Timeout value (automatically de-assert
+       * CS if memory is not accessed for a while)
+       */
+
+      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
+
+      /* Clear Timeout interrupt */
+
+      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
+
+#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
+      /* Enable Timeout interrupt */
+
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+#endif
+    }
+  else
+    {
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval &= ~QSPI_CR_TCEN;
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+    }
+
+  /* create a transaction object */
+
+  qspi_setupxctnfrommem(&xctn, meminfo);
+
+#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
+  priv->xctn = NULL;
+#endif
+
+  /* set it into the ccr */
+
+  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  /* we should be in memory mapped mode now */
+
+  qspi_dumpregs(priv, "After memory mapped:");
+}
+
+/****************************************************************************
+ * Name: qspi_exit_memmap
+ *
+ * Description:
+ *   Take the QSPI device out of memory mapped mode, with the bus locked.
+ *
+ ****************************************************************************/
+
+static void qspi_exit_memmap(struct stm32h7_qspidev_s *priv)
+{
+  /* A simple abort is sufficient */
+
+  qspi_abort(priv);
+  priv->memmap = false;
+}
+
+/****************************************************************************
+ * Name: qspi_memmap
+ *
+ * Description:
+ *   Enter or leave the memory mapped mode.  The low-power timeout is not
+ *   used, so that the mapping stays usable at any time.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - The read command, or NULL to leave the memory mapped mode
+ *   base    - The location to return the mapped address, or NULL
+ *
+ * Returned Value:
+ *   OK
+ *
+ ****************************************************************************/
+
+static int qspi_memmap(struct qspi_dev_s *dev,
+                       const struct qspi_meminfo_s *meminfo, void **base)
+{
+  struct stm32h7_qspidev_s *priv = (struct stm32h7_qspidev_s *)dev;
+
+  if (meminfo == NULL)
+    {
+      qspi_exit_memmap(priv);
+      return OK;
+    }
+
+  qspi_enter_memmap(priv, meminfo, 0);
+  if (base != NULL)
+    {
+      *base = (void *)STM32_FMC_BANK4;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2703,75 +2840,11 @@ void stm32h7_qspi_enter_memorymapped(struct qspi_dev_s *dev,
                                      uint32_t lpto)
 {
   struct stm32h7_qspidev_s *priv = (struct stm32h7_qspidev_s *)dev;
-  uint32_t regval;
-  struct qspi_xctnspec_s xctn;
 
   /* lock during this mode change */
 
   qspi_lock(dev, true);
-
-  if (priv->memmap)
-    {
-      qspi_lock(dev, false);
-      return;
-    }
-
-  /* Abort anything in-progress */
-
-  qspi_abort(priv);
-
-  /* Wait till BUSY flag reset */
-
-  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
-
-  /* if we want the 'low-power timeout counter' */
-
-  if (lpto > 0)
-    {
-      /* Set the Low Power Timeout value (automatically de-assert
-       * CS if memory is not accessed for a while)
-       */
-
-      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
-
-      /* Clear Timeout interrupt */
-
-      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
-
-#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
-      /* Enable Timeout interrupt */
-
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-#endif
-    }
-  else
-    {
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval &= ~QSPI_CR_TCEN;
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-    }
-
-  /* create a transaction object */
-
-  qspi_setupxctnfrommem(&xctn, meminfo);
-
-#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
-  priv->xctn = NULL;
-#endif
-
-  /* set it into the ccr */
-
-  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
-  priv->memmap = true;
-
-  /* we should be in memory mapped mode now */
-
-  qspi_dumpregs(priv, "After memory mapped:");
-
-  /* finished this mode change */
-
+  qspi_enter_memmap(priv, meminfo, lpto);
   qspi_lock(dev, false);
 }
 
@@ -2794,12 +2867,7 @@ void stm32h7_qspi_exit_memorymapped(struct qspi_dev_s *dev)
   struct stm32h7_qspidev_s *priv = (struct stm32h7_qspidev_s *)dev;
 
   qspi_lock(dev, true);
-
-  /* A simple abort is sufficient */
-
-  qspi_abort(priv);
-  priv->memmap = false;
-
+  qspi_exit_memmap(priv);
   qspi_lock(dev, false);
 }
 
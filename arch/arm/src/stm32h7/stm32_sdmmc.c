@@ -43,6 +43,7 @@
 #include <nuttx/mmcsd.h>
 #include <nuttx/irq.h>
 #include <nuttx/cache.h>
+#include <nuttx/dma/dma_map.h>
 
 #include <arch/board/board.h>
 
@@ -1337,15 +1338,18 @@ static void stm32_recvdma(struct stm32_dev_s *priv)
        * we receive them one-by-one
        */
 
-      /* Copy the received data to client buffer */
+      /* Copy the received data to client buffer, dropping first any line
+       * fetched while the block was received.
+       */
 
+      dma_unmap_single((uintptr_t)priv->sdmmc_rxbuffer, priv->blocksize,
+                       DMA_FROM_DEVICE);
       memcpy(priv->buffer, priv->sdmmc_rxbuffer, priv->blocksize);
 
-      /* Invalidate the cache before receiving next block */
+      /* Hand the buffer back to the DMA for the next block */
 
-      up_invalidate_dcache((uintptr_t)priv->sdmmc_rxbuffer,
-                           (uintptr_t)priv->sdmmc_rxbuffer +
-                           priv->blocksize);
+      dma_map_single(priv->sdmmc_rxbuffer, priv->blocksize,
+                     DMA_FROM_DEVICE);
 
       /* Update how much there is left to receive */
 
@@ -1355,6 +1359,8 @@ static void stm32_recvdma(struct stm32_dev_s *priv)
     {
       /* In an aligned case, we have always received all blocks */
 
+      dma_unmap_single((uintptr_t)priv->buffer, priv->receivecnt,
+                       DMA_FROM_DEVICE);
       priv->remaining = 0;
     }
 
@@ -3151,16 +3157,14 @@ static int stm32_dmarecvsetup(struct sdio_dev_s *dev,
        * buffer instead.
        */
 
-      up_invalidate_dcache((uintptr_t)priv->sdmmc_rxbuffer,
-                           (uintptr_t)priv->sdmmc_rxbuffer +
-                           priv->blocksize);
+      dma_map_single(priv->sdmmc_rxbuffer, priv->blocksize,
+                     DMA_FROM_DEVICE);
 
       priv->unaligned_rx = true;
     }
   else
     {
-      up_invalidate_dcache((uintptr_t)buffer,
-                           (uintptr_t)buffer + buflen);
+      dma_map_single(buffer, buflen, DMA_FROM_DEVICE);
 
       priv->unaligned_rx = false;
     }
@@ -3266,7 +3270,7 @@ static int stm32_dmasendsetup(struct sdio_dev_s *dev,
   if ((uintptr_t)buffer < DTCM_START ||
       (uintptr_t)buffer + buflen > DTCM_END)
     {
-      up_clean_dcache((uintptr_t)buffer, (uintptr_t)buffer + buflen);
+      dma_map_single(buffer, buflen, DMA_TO_DEVICE);
     }
 #endif
 
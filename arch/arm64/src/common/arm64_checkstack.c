@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <sched.h>
@@ -201,6 +202,56 @@ size_t up_check_tcbstack(struct tcb_s *tcb)
   return arm64_stack_check(tcb->stack_base_ptr, tcb->adj_stack_size);
 }
 
+/****************************************************************************
+ * Name: up_check_tcbstack_mark
+ *
+ * Description:
+ *   Refine a known stack use of a thread:  scan the coloring down from the
+ *   mark, until CONFIG_SCHED_STACK_WATERMARK_WINDOW bytes in a row were
+ *   never written.  Only the stack beyond the mark is read.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB of the thread
+ *   mark - The stack use known so far, in bytes
+ *
+ * Returned Value:
+ *   The stack use found, no less than mark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+size_t up_check_tcbstack_mark(struct tcb_s *tcb, size_t mark)
+{
+  uintptr_t start;
+  uintptr_t end;
+  uint32_t *ptr;
+  size_t clean = 0;
+
+  start = STACK_ALIGN_UP((uintptr_t)tcb->stack_base_ptr);
+  end   = STACK_ALIGN_DOWN((uintptr_t)tcb->stack_base_ptr +
+                           tcb->adj_stack_size);
+
+  /* Walk down the push-down stack from the first word below the mark */
+
+  for (ptr = (uint32_t *)(end - (MIN(mark, end - start) & ~3));
+       (uintptr_t)ptr > start &&
+       clean < CONFIG_SCHED_STACK_WATERMARK_WINDOW; )
+    {
+      if (*--ptr == STACK_COLOR)
+        {
+          clean += 4;
+        }
+      else
+        {
+          mark  = end - (uintptr_t)ptr;
+          clean = 0;
+        }
+    }
+
+  return mark;
+}
+#endif
+
 #if CONFIG_ARCH_INTERRUPTSTACK > 7
 size_t up_check_intstack(void)
 {
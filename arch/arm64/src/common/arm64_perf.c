@@ -22,21 +22,68 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/perf.h>
 
 #include "arm64_pmu.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+/* The common architectural events counted by the event counters, counter
+ * n counting g_perf_pmu[n].
+ */
+
+static const struct
+{
+  uint8_t type;
+  uint8_t event;
+} g_perf_pmu[] =
+{
+  { 0x08, PERF_EVENT_INSTRUCTIONS  },  /* INST_RETIRED */
+  { 0x04, PERF_EVENT_CACHE_REFS    },  /* L1D_CACHE */
+  { 0x03, PERF_EVENT_CACHE_MISSES  },  /* L1D_CACHE_REFILL */
+  { 0x10, PERF_EVENT_BRANCH_MISSES },  /* BR_MIS_PRED */
+};
+
+/* The values of the counters at the previous up_perf_event_read() */
+
+static uint64_t g_perf_ccnt[CONFIG_SMP_NCPUS];
+static uint32_t g_perf_last[CONFIG_SMP_NCPUS][nitems(g_perf_pmu)];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 void up_perf_init(void *arg)
 {
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  int i;
+#endif
+
   pmu_ccntr_ccfiltr_config(PMCCFILTR_EL0_NSH);
   pmu_cntr_control_config(PMCR_EL0_C | PMCR_EL0_E);
   pmu_cntr_trap_control(PMUSERENR_EL0_EN);
   pmu_cntr_irq_disable(PMINTENCLR_EL1_C);
   pmu_cntr_enable(PMCNTENSET_EL0_C);
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  /* Program the event counters of this CPU */
+
+  for (i = 0; i < nitems(g_perf_pmu) && i < pmu_get_ncntrs(); i++)
+    {
+      pmu_cntr_select(i);
+      pmu_cntr_evtype_config(g_perf_pmu[i].type);
+      pmu_cntr_enable(1ul << i);
+    }
+#endif
 }
 
 unsigned long up_perf_getfreq(void)
@@ -58,3 +105,40 @@ void up_perf_convert(unsigned long elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * left / cpu_freq;
 }
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+uint32_t up_perf_event_supported(void)
+{
+  uint32_t events = PERF_EVENT_BIT(PERF_EVENT_CYCLES);
+  int i;
+
+  for (i = 0; i < nitems(g_perf_pmu) && i < pmu_get_ncntrs(); i++)
+    {
+      events |= PERF_EVENT_BIT(g_perf_pmu[i].event);
+    }
+
+  return events;
+}
+
+void up_perf_event_read(uint32_t *delta)
+{
+  int cpu = up_cpu_index();
+  uint64_t ccnt;
+  uint32_t count;
+  int i;
+
+  memset(delta, 0, PERF_EVENT_MAX * sizeof(uint32_t));
+
+  ccnt = pmu_get_ccntr();
+  delta[PERF_EVENT_CYCLES] = (uint32_t)(ccnt - g_perf_ccnt[cpu]);
+  g_perf_ccnt[cpu] = ccnt;
+
+  for (i = 0; i < nitems(g_perf_pmu) && i < pmu_get_ncntrs(); i++)
+    {
+      pmu_cntr_select(i);
+      count = (uint32_t)pmu_get_evcntr();
+      delta[g_perf_pmu[i].event] = count - g_perf_last[cpu][i];
+      g_perf_last[cpu][i] = count;
+    }
+}
+#endif
@@ -54,6 +54,8 @@
 
 /* PMCR_EL0 */
 
+#define PMCR_EL0_N_SHIFT         (11)         /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
 #define PMCR_EL0_LC              (1ul << 6)   /* Long cycle counter enable */
 #define PMCR_EL0_DP              (1ul << 5)   /* Disable cycle counter when event counting is prohibited */
 #define PMCR_EL0_X               (1ul << 4)   /* Enable export of events */
@@ -105,6 +107,52 @@ static inline uint64_t pmu_get_ccntr(void)
   return read_sysreg(pmccntr_el0);
 }
 
+/****************************************************************************
+ * Name: pmu_get_evcntr
+ *
+ * Description:
+ *   Read the event counter selected by pmu_cntr_select().
+ *
+ * Return Value:
+ *   Event count.
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_get_evcntr(void)
+{
+  return read_sysreg(pmxevcntr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_evtype_config
+ *
+ * Description:
+ *   Set the event counted by the event counter selected by
+ *   pmu_cntr_select().
+ *
+ * Parameters:
+ *   type - The event number, and the filtering flags.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_evtype_config(uint64_t type)
+{
+  write_sysreg(type, pmxevtyper_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_get_ncntrs
+ *
+ * Description:
+ *   Return the number of event counters implemented.
+ *
+ ****************************************************************************/
+
+static inline unsigned int pmu_get_ncntrs(void)
+{
+  return (read_sysreg(pmcr_el0) & PMCR_EL0_N_MASK) >> PMCR_EL0_N_SHIFT;
+}
+
 /****************************************************************************
  * Name: pmu_ccntr_ccfiltr_config
  *
@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/arch.h>
@@ -50,6 +51,13 @@
 uintptr_t up_getusrsp(void *regs)
 {
   struct regs_context *ptr = regs;
+
+  if (ptr == NULL)
+    {
+      ptr = (struct regs_context *)CURRENT_REGS;
+      DEBUGASSERT(ptr != NULL);
+    }
+
   return ptr->regs[REG_X13];
 }
 
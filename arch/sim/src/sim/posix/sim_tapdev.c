@@ -64,6 +64,7 @@
 #include <sys/uio.h>
 #include <sys/socket.h>
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -195,9 +196,11 @@ void sim_tapdev_init(int devidx, void *priv,
   int ret;
   int sockfd;
 
-  /* Open the tap device */
+  /* Open the tap device.  Reads don't block, so that a frame is received
+   * with a single read() rather than a select() first.
+   */
 
-  tapdevfd = open(DEVTAP, O_RDWR, 0644);
+  tapdevfd = open(DEVTAP, O_RDWR | O_NONBLOCK, 0644);
   if (tapdevfd < 0)
     {
       syslog(LOG_ERR, "TAPDEV: open failed: %d\n", -tapdevfd);
@@ -312,7 +315,7 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
 {
   int ret;
 
-  if (!sim_tapdev_avail(devidx))
+  if (gtapdevfd[devidx] < 0)
     {
       return 0;
     }
@@ -320,7 +323,11 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
   ret = read(gtapdevfd[devidx], buf, buflen);
   if (ret < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
+      if (errno != EAGAIN)
+        {
+          syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+        }
+
       return 0;
     }
 
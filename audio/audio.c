@@ -42,6 +42,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 
 #include <arch/irq.h>
 
@@ -76,6 +77,16 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  FAR uint8_t      *ring;             /* Samples of all the periods */
+  FAR struct ap_buffer_s *periods;    /* One buffer per period */
+  apb_samp_t        periodbytes;      /* Size of a period */
+  uint16_t          nperiods;         /* Number of periods */
+  volatile uint32_t hwpos;            /* Periods given back */
+  uint32_t          applpos;          /* Periods committed */
+  volatile uint32_t xruns;            /* Times the lower half ran dry */
+  sem_t             periodsem;        /* Wakes up AUDIOIOC_RINGWAIT */
+#endif
 };
 
 /****************************************************************************
@@ -93,6 +104,10 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_RING
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -108,6 +123,9 @@ static void     audio_callback(FAR void *priv,
                                FAR struct ap_buffer_s *apb,
                                uint16_t status);
 #endif /* CONFIG_AUDIO_MULTI_SESSION */
+#ifdef CONFIG_AUDIO_RING
+static void     audio_ringfree(FAR struct audio_upperhalf_s *upper);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -121,6 +139,9 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_RING
+  audio_mmap,  /* mmap */
+#endif
 };
 
 /****************************************************************************
@@ -225,6 +246,9 @@ static int audio_close(FAR struct file *filep)
 
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+#ifdef CONFIG_AUDIO_RING
+      audio_ringfree(upper);
+#endif
     }
 
   ret = OK;
@@ -337,6 +361,255 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+#ifdef CONFIG_AUDIO_RING
+/****************************************************************************
+ * Name: audio_ringfree
+ *
+ * Description:
+ *   Free the ring of periods.  None of them may be with the lower half.
+ *
+ ****************************************************************************/
+
+static void audio_ringfree(FAR struct audio_upperhalf_s *upper)
+{
+  int i;
+
+  if (upper->periods != NULL)
+    {
+      for (i = 0; i < upper->nperiods; i++)
+        {
+          nxmutex_destroy(&upper->periods[i].lock);
+        }
+
+      kmm_free(upper->periods);
+      kumm_free(upper->ring);
+      upper->periods  = NULL;
+      upper->ring     = NULL;
+      upper->nperiods = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ringsetup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command
+ *
+ ****************************************************************************/
+
+static int audio_ringsetup(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_ring_s *ring)
+{
+  FAR struct ap_buffer_s *apb;
+  int i;
+
+  if (upper->started || upper->applpos != upper->hwpos)
+    {
+      return -EBUSY;
+    }
+
+  audio_ringfree(upper);
+  if (ring->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (ring->periodbytes == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The samples are in user memory, for the application to access */
+
+  upper->ring = kumm_zalloc((size_t)ring->periodbytes * ring->nperiods);
+  upper->periods = kmm_zalloc(sizeof(struct ap_buffer_s) * ring->nperiods);
+  if (upper->ring == NULL || upper->periods == NULL)
+    {
+      kumm_free(upper->ring);
+      kmm_free(upper->periods);
+      upper->ring    = NULL;
+      upper->periods = NULL;
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < ring->nperiods; i++)
+    {
+      apb             = &upper->periods[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = ring->periodbytes;
+      apb->samp       = upper->ring + i * ring->periodbytes;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session    = ring->session;
+#endif
+      nxmutex_init(&apb->lock);
+    }
+
+  upper->periodbytes = ring->periodbytes;
+  upper->nperiods    = ring->nperiods;
+  upper->hwpos       = 0;
+  upper->applpos     = 0;
+  upper->xruns       = 0;
+  ring->buffer       = upper->ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ringcommit
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGCOMMIT ioctl command: enqueue the next periods
+ *   of the ring, in order.
+ *
+ ****************************************************************************/
+
+static int audio_ringcommit(FAR struct audio_upperhalf_s *upper,
+                            unsigned int count)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct ap_buffer_s *apb;
+  int ret = OK;
+
+  if (upper->ring == NULL ||
+      count > upper->nperiods - (upper->applpos - upper->hwpos))
+    {
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+
+  while (count-- > 0)
+    {
+      apb          = &upper->periods[upper->applpos % upper->nperiods];
+      apb->nbytes  = apb->nmaxbytes;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      upper->applpos++;
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          upper->applpos--;
+          break;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ringwait
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGWAIT ioctl command.  This is done without
+ *   holding the lock of the device, so that commits are not held off.
+ *
+ ****************************************************************************/
+
+static int audio_ringwait(FAR struct audio_upperhalf_s *upper, int oflags,
+                          FAR struct audio_ringpos_s *pos)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (upper->ring == NULL)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  /* Wait while every period is with the lower half */
+
+  while ((oflags & O_NONBLOCK) == 0 &&
+         upper->applpos - upper->hwpos >= upper->nperiods)
+    {
+      ret = nxsem_wait(&upper->periodsem);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      if (upper->ring == NULL)
+        {
+          ret = -EINVAL;
+          goto out;
+        }
+    }
+
+  pos->hwpos   = upper->hwpos;
+  pos->applpos = upper->applpos;
+  pos->xruns   = upper->xruns;
+  pos->hwbytes = 0;
+
+  if (upper->applpos != upper->hwpos)
+    {
+      apb = &upper->periods[upper->hwpos % upper->nperiods];
+      pos->hwbytes = apb->curbyte;
+    }
+
+out:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ringperiod
+ *
+ * Description:
+ *   A period was given back by the lower half.  The periods come back in
+ *   the order they were committed.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ringperiod(FAR struct audio_upperhalf_s *upper)
+{
+  int semcount;
+
+  upper->hwpos++;
+  if (upper->started && upper->hwpos == upper->applpos)
+    {
+      /* Nothing more was committed in time */
+
+      upper->xruns++;
+    }
+
+  if (nxsem_get_value(&upper->periodsem, &semcount) == OK && semcount < 0)
+    {
+      nxsem_post(&upper->periodsem);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the ring of periods.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  size_t size = (size_t)upper->periodbytes * upper->nperiods;
+
+  if (upper->ring == NULL || map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > size)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = upper->ring + map->offset;
+  return OK;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /****************************************************************************
  * Name: audio_ioctl
  *
@@ -358,6 +631,16 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   audinfo("cmd: %d arg: %ld\n", cmd, arg);
 
+#ifdef CONFIG_AUDIO_RING
+  /* AUDIOIOC_RINGWAIT blocks, it must not hold the device */
+
+  if (cmd == AUDIOIOC_RINGWAIT)
+    {
+      return audio_ringwait(upper, filep->f_oflags,
+                            (FAR struct audio_ringpos_s *)arg);
+    }
+#endif
+
   /* Get exclusive access to the device structures */
 
   ret = nxmutex_lock(&upper->lock);
@@ -646,6 +929,55 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSETUP - Allocate or free the ring of periods
+       *
+       *   ioctl argument:  pointer to an audio_ring_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          audinfo("AUDIOIOC_RINGSETUP\n");
+
+          ret = audio_ringsetup(upper, (FAR struct audio_ring_s *)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGCOMMIT - Enqueue the next periods of the ring
+       *
+       *   ioctl argument:  number of periods
+       */
+
+      case AUDIOIOC_RINGCOMMIT:
+        {
+          audinfo("AUDIOIOC_RINGCOMMIT\n");
+
+          ret = audio_ringcommit(upper, (unsigned int)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGRECOVER - Clear the xrun count
+       *
+       *   ioctl argument:  none
+       */
+
+      case AUDIOIOC_RINGRECOVER:
+        {
+          audinfo("AUDIOIOC_RINGRECOVER\n");
+
+          if (upper->ring == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              upper->xruns = 0;
+              ret = upper->nperiods - (upper->applpos - upper->hwpos);
+            }
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be
        * platform-specific ioctl commands
        */
@@ -708,6 +1040,17 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RING
+  /* The periods of the ring are reported through AUDIOIOC_RINGWAIT */
+
+  if (upper->periods != NULL && apb >= upper->periods &&
+      apb < upper->periods + upper->nperiods)
+    {
+      audio_ringperiod(upper);
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
@@ -944,6 +1287,9 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev)
 
   nxmutex_init(&upper->lock);
   upper->dev = dev;
+#ifdef CONFIG_AUDIO_RING
+  nxsem_init(&upper->periodsem, 0, 0);
+#endif
 
 #ifdef CONFIG_AUDIO_CUSTOM_DEV_PATH
 
@@ -0,0 +1,971 @@
+/****************************************************************************
+ * audio/audio_mix.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mix.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MIX_CHANNELS    2      /* The output is stereo */
+#define MIX_FRAMEBYTES  (MIX_CHANNELS * sizeof(int16_t))
+#define MIX_NPHASES     32     /* Phases of the resampling filter */
+#define MIX_PHASESHIFT  11     /* Q16 position to phase: 16 - log2(32) */
+#define MIX_NTAPS       8      /* Taps of each phase */
+#define MIX_ONE         0x10000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mix_s;
+
+/* One of the devices registered by audio_mix_initialize() */
+
+struct audio_mix_stream_s
+{
+  /* This is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct audio_mix_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mix_s *mix;
+  struct dq_queue_s pending;     /* Buffers enqueued by the upper half */
+  uint32_t          pos;         /* Position past hist, in Q16 frames */
+  uint32_t          step;        /* Input frames per output frame, Q16 */
+  int16_t           volume;      /* Gain, Q15 */
+  uint8_t           channels;    /* 1 or 2 */
+  uint8_t           head;        /* Oldest frame of hist */
+  bool              reserved;
+  bool              running;
+  bool              paused;
+
+  /* The last MIX_NTAPS input frames, twice so that the filter reads them
+   * in order from hist[ch][head] without wrapping.
+   */
+
+  int16_t           hist[MIX_CHANNELS][2 * MIX_NTAPS];
+};
+
+/* This structure describes the internal state of the mixer */
+
+struct audio_mix_s
+{
+  FAR struct audio_lowerhalf_s *lower;  /* The output device */
+  FAR struct audio_mix_stream_s *streams;
+  int               nstreams;
+  mutex_t           lock;        /* Streams and the output device */
+  struct work_s     work;        /* Mixes the buffers given back */
+  struct dq_queue_s done;        /* Buffers given back by the device */
+  struct dq_queue_s idle;        /* Buffers not given to the device */
+  int               nidle;
+  bool              running;     /* The output device is started */
+  int32_t           acc[CONFIG_AUDIO_MIX_FRAMES * MIX_CHANNELS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mix_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                             FAR struct audio_caps_s *caps);
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR const struct audio_caps_s *caps);
+static int audio_mix_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mix_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                   FAR struct ap_buffer_s *apb);
+static int audio_mix_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                  FAR struct ap_buffer_s *apb);
+static int audio_mix_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                           unsigned long arg);
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev);
+
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb,
+                               uint16_t status);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mix_ops =
+{
+  audio_mix_getcaps,        /* getcaps        */
+  audio_mix_configure,      /* configure      */
+  audio_mix_shutdown,       /* shutdown       */
+  audio_mix_start,          /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mix_stop,           /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mix_pause,          /* pause          */
+  audio_mix_resume,         /* resume         */
+#endif
+  NULL,                     /* allocbuffer    */
+  NULL,                     /* freebuffer     */
+  audio_mix_enqueuebuffer,  /* enqueue_buffer */
+  audio_mix_cancelbuffer,   /* cancel_buffer  */
+  audio_mix_ioctl,          /* ioctl          */
+  NULL,                     /* read           */
+  NULL,                     /* write          */
+  audio_mix_reserve,        /* reserve        */
+  audio_mix_release         /* release        */
+};
+
+/* The resampling filter in Q15: a windowed sinc (Kaiser, beta 6) cut off
+ * at 0.9 of the input Nyquist frequency, in MIX_NPHASES phases of
+ * MIX_NTAPS taps.  Phase p interpolates at p / MIX_NPHASES of the way
+ * between the fourth and the fifth frame of the history.  The taps of
+ * each phase add up to 1.0.
+ */
+
+static const int16_t g_audio_mix_filter[MIX_NPHASES][MIX_NTAPS] =
+{
+  {    459,  -1478,   2704,  29435,   2704,  -1478,    459,    -37 },
+  {    405,  -1242,   1879,  29396,   3578,  -1719,    515,    -44 },
+  {    351,  -1013,   1104,  29271,   4497,  -1962,    571,    -51 },
+  {    300,   -792,    379,  29063,   5457,  -2207,    626,    -58 },
+  {    250,   -581,   -292,  28768,   6457,  -2449,    680,    -65 },
+  {    203,   -381,   -908,  28392,   7490,  -2687,    732,    -73 },
+  {    160,   -193,  -1470,  27934,   8554,  -2918,    781,    -80 },
+  {    119,    -19,  -1977,  27401,   9644,  -3139,    826,    -87 },
+  {     82,    142,  -2428,  26790,  10754,  -3346,    867,    -93 },
+  {     48,    289,  -2824,  26108,  11881,  -3537,    901,    -98 },
+  {     18,    420,  -3166,  25361,  13017,  -3709,    929,   -102 },
+  {     -8,    537,  -3454,  24549,  14159,  -3859,    949,   -105 },
+  {    -32,    639,  -3691,  23681,  15299,  -3983,    961,   -106 },
+  {    -51,    726,  -3878,  22759,  16433,  -4078,    963,   -106 },
+  {    -68,    798,  -4018,  21793,  17554,  -4142,    954,   -103 },
+  {    -81,    857,  -4111,  20781,  18656,  -4170,    934,    -98 },
+  {    -91,    902,  -4161,  19734,  19734,  -4161,    902,    -91 },
+  {    -98,    934,  -4170,  18656,  20781,  -4111,    857,    -81 },
+  {   -103,    954,  -4142,  17554,  21793,  -4018,    798,    -68 },
+  {   -106,    963,  -4078,  16433,  22759,  -3878,    726,    -51 },
+  {   -106,    961,  -3983,  15299,  23681,  -3691,    639,    -32 },
+  {   -105,    949,  -3859,  14159,  24549,  -3454,    537,     -8 },
+  {   -102,    929,  -3709,  13017,  25361,  -3166,    420,     18 },
+  {    -98,    901,  -3537,  11881,  26108,  -2824,    289,     48 },
+  {    -93,    867,  -3346,  10754,  26790,  -2428,    142,     82 },
+  {    -87,    826,  -3139,   9644,  27401,  -1977,    -19,    119 },
+  {    -80,    781,  -2918,   8554,  27934,  -1470,   -193,    160 },
+  {    -73,    732,  -2687,   7490,  28392,   -908,   -381,    203 },
+  {    -65,    680,  -2449,   6457,  28768,   -292,   -581,    250 },
+  {    -58,    626,  -2207,   5457,  29063,    379,   -792,    300 },
+  {    -51,    571,  -1962,   4497,  29271,   1104,  -1013,    351 },
+  {    -44,    515,  -1719,   3578,  29396,   1879,  -1242,    405 },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mix_sat16
+ ****************************************************************************/
+
+static inline int16_t audio_mix_sat16(int32_t value)
+{
+  /* Written so that the compiler can use a saturating instruction (SSAT
+   * on ARMv6 and later) where there is one.
+   */
+
+  if (value > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (value < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (int16_t)value;
+}
+
+/****************************************************************************
+ * Name: audio_mix_giveback
+ *
+ * Description:
+ *   Return a buffer to the upper half of the stream.
+ *
+ ****************************************************************************/
+
+static void audio_mix_giveback(FAR struct audio_mix_stream_s *stream,
+                               FAR struct ap_buffer_s *apb)
+{
+  bool final = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+  apb_free(apb);
+  stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                       apb, OK);
+
+  if (final)
+    {
+      stream->running = false;
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                           NULL, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mix_pull
+ *
+ * Description:
+ *   Take the next input frame of a stream, as stereo.
+ *
+ * Returned Value:
+ *   False if the stream has no more input.
+ *
+ ****************************************************************************/
+
+static bool audio_mix_pull(FAR struct audio_mix_stream_s *stream,
+                           FAR int16_t *frame)
+{
+  size_t framebytes = stream->channels * sizeof(int16_t);
+  FAR struct ap_buffer_s *apb;
+  FAR const int16_t *samp;
+
+  for (; ; )
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pending);
+      if (apb == NULL || !stream->running)
+        {
+          return false;
+        }
+
+      if (apb->curbyte + framebytes <= apb->nbytes)
+        {
+          break;
+        }
+
+      dq_remfirst(&stream->pending);
+      audio_mix_giveback(stream, apb);
+    }
+
+  samp = (FAR const int16_t *)(apb->samp + apb->curbyte);
+  apb->curbyte += framebytes;
+
+  frame[0] = samp[0];
+  frame[1] = stream->channels > 1 ? samp[1] : samp[0];
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mix_frame
+ *
+ * Description:
+ *   Produce the next output frame of a stream, resampled to the output
+ *   rate with the polyphase filter.
+ *
+ ****************************************************************************/
+
+static bool audio_mix_frame(FAR struct audio_mix_stream_s *stream,
+                            FAR int16_t *frame)
+{
+  FAR const int16_t *coef;
+  FAR const int16_t *hist;
+  int16_t input[MIX_CHANNELS];
+  int32_t sum;
+  int ch;
+  int i;
+
+  if (stream->step == MIX_ONE)
+    {
+      return audio_mix_pull(stream, frame);
+    }
+
+  while (stream->pos >= MIX_ONE)
+    {
+      if (!audio_mix_pull(stream, input))
+        {
+          return false;
+        }
+
+      for (ch = 0; ch < MIX_CHANNELS; ch++)
+        {
+          stream->hist[ch][stream->head] = input[ch];
+          stream->hist[ch][stream->head + MIX_NTAPS] = input[ch];
+        }
+
+      stream->head = (stream->head + 1) % MIX_NTAPS;
+      stream->pos -= MIX_ONE;
+    }
+
+  coef = g_audio_mix_filter[stream->pos >> MIX_PHASESHIFT];
+  for (ch = 0; ch < MIX_CHANNELS; ch++)
+    {
+      hist = &stream->hist[ch][stream->head];
+      sum  = 0;
+
+      for (i = 0; i < MIX_NTAPS; i++)
+        {
+          sum += (int32_t)hist[i] * coef[i];
+        }
+
+      frame[ch] = audio_mix_sat16(sum >> 15);
+    }
+
+  stream->pos += stream->step;
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mix_fill
+ *
+ * Description:
+ *   Mix the streams that are playing into an output buffer.  The samples
+ *   are added up at full precision and saturated once.
+ *
+ * Returned Value:
+ *   False if no stream is playing.
+ *
+ ****************************************************************************/
+
+static bool audio_mix_fill(FAR struct audio_mix_s *mix,
+                           FAR struct ap_buffer_s *apb)
+{
+  FAR int16_t *out = (FAR int16_t *)apb->samp;
+  FAR struct audio_mix_stream_s *stream;
+  int16_t frame[MIX_CHANNELS];
+  bool active = false;
+  int i;
+  int j;
+
+  memset(mix->acc, 0, sizeof(mix->acc));
+
+  for (i = 0; i < mix->nstreams; i++)
+    {
+      stream = &mix->streams[i];
+      if (!stream->running)
+        {
+          continue;
+        }
+
+      active = true;
+      if (stream->paused)
+        {
+          continue;
+        }
+
+      for (j = 0; j < CONFIG_AUDIO_MIX_FRAMES; j++)
+        {
+          if (!audio_mix_frame(stream, frame))
+            {
+              break;
+            }
+
+          mix->acc[2 * j]     += ((int32_t)frame[0] * stream->volume) >> 15;
+          mix->acc[2 * j + 1] += ((int32_t)frame[1] * stream->volume) >> 15;
+        }
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_MIX_FRAMES * MIX_CHANNELS; i++)
+    {
+      out[i] = audio_mix_sat16(mix->acc[i]);
+    }
+
+  apb->nbytes  = CONFIG_AUDIO_MIX_FRAMES * MIX_FRAMEBYTES;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+  return active;
+}
+
+/****************************************************************************
+ * Name: audio_mix_kick
+ *
+ * Description:
+ *   Give the idle buffers to the output device, started if it was not.
+ *   Called with the lock held.
+ *
+ ****************************************************************************/
+
+static int audio_mix_kick(FAR struct audio_mix_s *mix)
+{
+  FAR struct audio_lowerhalf_s *lower = mix->lower;
+  FAR struct ap_buffer_s *apb;
+  struct audio_caps_s caps;
+  int ret;
+
+  if (!mix->running)
+    {
+      if (lower->ops->reserve != NULL)
+        {
+          ret = lower->ops->reserve(lower);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      memset(&caps, 0, sizeof(caps));
+      caps.ac_len            = sizeof(caps);
+      caps.ac_type           = AUDIO_TYPE_OUTPUT;
+      caps.ac_channels       = MIX_CHANNELS;
+      caps.ac_controls.hw[0] = CONFIG_AUDIO_MIX_SAMPLERATE;
+      caps.ac_controls.b[2]  = 16;
+
+      ret = lower->ops->configure(lower, &caps);
+      if (ret < 0)
+        {
+          goto errout_with_reserve;
+        }
+    }
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&mix->idle)) != NULL)
+    {
+      mix->nidle--;
+      audio_mix_fill(mix, apb);
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          dq_addfirst(&apb->dq_entry, &mix->idle);
+          mix->nidle++;
+          break;
+        }
+    }
+
+  if (!mix->running)
+    {
+      ret = lower->ops->start(lower);
+      if (ret < 0)
+        {
+          goto errout_with_reserve;
+        }
+
+      mix->running = true;
+    }
+
+  return OK;
+
+errout_with_reserve:
+  if (lower->ops->release != NULL)
+    {
+      lower->ops->release(lower);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mix_worker
+ *
+ * Description:
+ *   Mix into the buffers given back by the output device and give them to
+ *   it again.  When no stream plays any more the buffers are kept, and the
+ *   device is stopped once it has given all of them back.
+ *
+ ****************************************************************************/
+
+static void audio_mix_worker(FAR void *arg)
+{
+  FAR struct audio_mix_s *mix = arg;
+  FAR struct audio_lowerhalf_s *lower = mix->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  nxmutex_lock(&mix->lock);
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mix->done);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (!mix->running || !audio_mix_fill(mix, apb) ||
+          lower->ops->enqueuebuffer(lower, apb) < 0)
+        {
+          dq_addlast(&apb->dq_entry, &mix->idle);
+          mix->nidle++;
+        }
+    }
+
+  if (mix->running && mix->nidle == CONFIG_AUDIO_MIX_NBUFFERS)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+      lower->ops->stop(lower);
+#endif
+      if (lower->ops->release != NULL)
+        {
+          lower->ops->release(lower);
+        }
+
+      mix->running = false;
+    }
+
+  nxmutex_unlock(&mix->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mix_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mix_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                             FAR struct audio_caps_s *caps)
+{
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = MIX_CHANNELS;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = MIX_CHANNELS;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            /* Any rate up to the output rate; these are the usual ones */
+
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_8K |
+                                      AUDIO_SAMP_RATE_11K |
+                                      AUDIO_SAMP_RATE_16K |
+                                      AUDIO_SAMP_RATE_22K |
+                                      AUDIO_SAMP_RATE_32K |
+                                      AUDIO_SAMP_RATE_44K |
+                                      AUDIO_SAMP_RATE_48K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        caps->ac_subtype  = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mix_configure
+ *
+ * Description:
+ *   Configure the format and the volume of a stream.
+ *
+ ****************************************************************************/
+
+static int audio_mix_configure(FAR struct audio_lowerhalf_s *dev,
+                               FAR const struct audio_caps_s *caps)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+  uint32_t rate;
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            if (caps->ac_controls.hw[0] > 1000)
+              {
+                return -EDOM;
+              }
+
+            stream->volume = caps->ac_controls.hw[0] * INT16_MAX / 1000;
+          }
+        break;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        rate = caps->ac_controls.hw[0];
+        if (caps->ac_channels < 1 || caps->ac_channels > MIX_CHANNELS ||
+            caps->ac_controls.b[2] != 16 || rate == 0 ||
+            rate > CONFIG_AUDIO_MIX_SAMPLERATE)
+          {
+            return -EINVAL;
+          }
+
+        nxmutex_lock(&stream->mix->lock);
+        stream->channels = caps->ac_channels;
+        stream->step     = (uint32_t)(((uint64_t)rate << 16) /
+                                      CONFIG_AUDIO_MIX_SAMPLERATE);
+        stream->pos      = 0;
+        stream->head     = 0;
+        memset(stream->hist, 0, sizeof(stream->hist));
+        nxmutex_unlock(&stream->mix->lock);
+        break;
+
+      default:
+        break;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_shutdown
+ ****************************************************************************/
+
+static int audio_mix_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_start
+ *
+ * Description:
+ *   Start mixing a stream, and the output device if it is stopped.
+ *
+ ****************************************************************************/
+
+static int audio_mix_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+  FAR struct audio_mix_s *mix = stream->mix;
+  int ret;
+
+  nxmutex_lock(&mix->lock);
+
+  stream->running = true;
+  stream->paused  = false;
+
+  ret = audio_mix_kick(mix);
+  if (ret < 0)
+    {
+      stream->running = false;
+    }
+
+  nxmutex_unlock(&mix->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mix_stop
+ *
+ * Description:
+ *   Stop a stream and give back the buffers it still has.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mix_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+  FAR struct ap_buffer_s *apb;
+  bool running;
+
+  nxmutex_lock(&stream->mix->lock);
+
+  running = stream->running;
+  stream->running = false;
+
+  while ((apb = (FAR struct ap_buffer_s *)
+                dq_remfirst(&stream->pending)) != NULL)
+    {
+      apb->flags &= ~AUDIO_APB_FINAL;
+      audio_mix_giveback(stream, apb);
+    }
+
+  if (running)
+    {
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                           NULL, OK);
+    }
+
+  nxmutex_unlock(&stream->mix->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mix_pause
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mix_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_resume
+ ****************************************************************************/
+
+static int audio_mix_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+
+  stream->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mix_enqueuebuffer
+ ****************************************************************************/
+
+static int audio_mix_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                   FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+
+  apb_reference(apb);
+  apb->curbyte = 0;
+
+  nxmutex_lock(&stream->mix->lock);
+  dq_addlast(&apb->dq_entry, &stream->pending);
+  nxmutex_unlock(&stream->mix->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_cancelbuffer
+ ****************************************************************************/
+
+static int audio_mix_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                  FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_ioctl
+ ****************************************************************************/
+
+static int audio_mix_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                           unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mix_reserve
+ ****************************************************************************/
+
+static int audio_mix_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+  int ret = OK;
+
+  nxmutex_lock(&stream->mix->lock);
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+    }
+
+  nxmutex_unlock(&stream->mix->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mix_release
+ ****************************************************************************/
+
+static int audio_mix_release(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mix_stream_s *stream =
+    (FAR struct audio_mix_stream_s *)dev;
+
+  stream->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mix_callback
+ *
+ * Description:
+ *   Callback of the output device.  The buffers given back are mixed again
+ *   on the low priority work queue.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_mix_callback(FAR void *arg, uint16_t reason,
+                               FAR struct ap_buffer_s *apb,
+                               uint16_t status)
+{
+  FAR struct audio_mix_s *mix = arg;
+  irqstate_t flags;
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE && apb != NULL)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &mix->done);
+      leave_critical_section(flags);
+
+      if (work_available(&mix->work))
+        {
+          work_queue(LPWORK, &mix->work, audio_mix_worker, mix, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mix_initialize
+ *
+ * Description:
+ *   Register nstreams audio devices that all play through one output
+ *   device.  See include/nuttx/audio/audio_mix.h.
+ *
+ ****************************************************************************/
+
+int audio_mix_initialize(FAR const char *name,
+                         FAR struct audio_lowerhalf_s *lower,
+                         int nstreams)
+{
+  FAR struct audio_mix_stream_s *stream;
+  FAR struct audio_mix_s *mix;
+  FAR struct ap_buffer_s *apb;
+  struct audio_buf_desc_s bufdesc;
+  char devname[32];
+  int ret;
+  int i;
+
+  if (lower == NULL || nstreams <= 0)
+    {
+      return -EINVAL;
+    }
+
+  mix = kmm_zalloc(sizeof(struct audio_mix_s));
+  if (mix == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mix->streams = kmm_calloc(nstreams, sizeof(struct audio_mix_stream_s));
+  if (mix->streams == NULL)
+    {
+      kmm_free(mix);
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mix->lock);
+  mix->lower    = lower;
+  mix->nstreams = nstreams;
+  lower->upper  = audio_mix_callback;
+  lower->priv   = mix;
+
+  /* The output buffers, allocated as the upper half would */
+
+  for (i = 0; i < CONFIG_AUDIO_MIX_NBUFFERS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.numbytes  = CONFIG_AUDIO_MIX_FRAMES * MIX_FRAMEBYTES;
+      bufdesc.u.pbuffer = &apb;
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      dq_addlast(&apb->dq_entry, &mix->idle);
+      mix->nidle++;
+    }
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mix->streams[i];
+      stream->export.ops = &g_audio_mix_ops;
+      stream->mix        = mix;
+      stream->channels   = MIX_CHANNELS;
+      stream->step       = MIX_ONE;
+      stream->volume     = INT16_MAX;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
@@ -86,6 +86,13 @@ struct pcm_decode_s
   uint8_t  nchannels;              /* Mono=1, Stereo=2 */
   bool     streaming;              /* Streaming PCM data chunk */
 
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+  /* Start deferred until enough buffers are queued */
+
+  uint8_t  nqueued;                /* Buffers queued, up to the depth */
+  bool     startpending;           /* start() waits for the buffers */
+#endif
+
 #ifndef CONFIG_AUDIO_EXCLUDE_FFORWARD
   /* Fast forward support */
 
@@ -119,6 +126,10 @@ static void pcm_subsample_configure(FAR struct pcm_decode_s *priv,
 static void pcm_subsample(FAR struct pcm_decode_s *priv,
               FAR struct ap_buffer_s *apb);
 #endif
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+static int  pcm_prebuffer(FAR struct pcm_decode_s *priv,
+              FAR struct ap_buffer_s *apb);
+#endif
 
 /* struct audio_lowerhalf_s methods *****************************************/
 
@@ -528,14 +539,16 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
     }
 
   /* Yes.. we will need to subsample the newly received buffer in-place by
-   * copying from the upper end of the buffer to the lower end.
+   * copying from the upper end of the buffer to the lower end.  The data
+   * stays after curbyte, so that there is no copy to the start of the
+   * buffer after a header.
    */
 
   src  = &apb->samp[apb->curbyte];
-  dest = apb->samp;
+  dest = &apb->samp[apb->curbyte];
 
   srcsize  = apb->nbytes - apb->curbyte;
-  destsize = apb->nmaxbytes;
+  destsize = apb->nmaxbytes - apb->curbyte;
 
   /* This is the number of bytes that we need to skip between samples */
 
@@ -560,31 +573,13 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
           return;
         }
 
-      /* We do at least have enough to complete the sample.  If this data
-       * does not resides at the correct position at the from of the audio
-       * buffer, then we will need to copy it.
+      /* We do at least have enough to complete the sample.  It is already
+       * in place, just increment the buffer pointers around the data.
        */
 
       copysize = priv->align - priv->npartial;
-      if (apb->curbyte > 0)
-        {
-          /* We have to copy down */
-
-          for (i = 0; i < copysize; i++)
-            {
-              *dest++ = *src++;
-            }
-        }
-      else
-        {
-          /* If the data is already position at the beginning of the audio
-           * buffer, then just increment the buffer pointers around the
-           * data.
-           */
-
-          src  += copysize;
-          dest += copysize;
-        }
+      src  += copysize;
+      dest += copysize;
 
       /* Update the number of bytes in the working buffer and reset the
        * skip value
@@ -658,10 +653,47 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
         }
     }
 
-  /* Update the size and offset data in the audio buffer */
+  /* Update the size of the data in the audio buffer */
+
+  apb->nbytes = apb->nmaxbytes - destsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: pcm_prebuffer
+ *
+ * Description:
+ *   Count a buffer queued to the lower half, and start the lower half if
+ *   start() was deferred and enough buffers are now queued.
+ *
+ ****************************************************************************/
+
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+static int pcm_prebuffer(FAR struct pcm_decode_s *priv,
+                         FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  if (priv->nqueued < CONFIG_AUDIO_PCM_PREBUFFER)
+    {
+      priv->nqueued++;
+    }
+
+  if (priv->startpending &&
+      (priv->nqueued >= CONFIG_AUDIO_PCM_PREBUFFER ||
+       (apb->flags & AUDIO_APB_FINAL) != 0))
+    {
+      audinfo("Start lower after %d buffers\n", priv->nqueued);
+
+      priv->startpending = false;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      return lower->ops->start(lower, priv->session);
+#else
+      return lower->ops->start(lower);
+#endif
+    }
 
-  apb->curbyte = 0;
-  apb->nbytes  = apb->nmaxbytes - destsize;
+  return OK;
 }
 #endif
 
@@ -835,6 +867,18 @@ static int pcm_start(FAR struct audio_lowerhalf_s *dev)
   lower = priv->lower;
   DEBUGASSERT(lower && lower->ops->start);
 
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+  /* Wait for more buffers, unless the last one has already been queued */
+
+  if (priv->nqueued < CONFIG_AUDIO_PCM_PREBUFFER &&
+      (priv->streaming || priv->nqueued == 0))
+    {
+      audinfo("Defer start, %d buffers queued\n", priv->nqueued);
+      priv->startpending = true;
+      return OK;
+    }
+#endif
+
   audinfo("Defer to lower start\n");
 #ifdef CONFIG_AUDIO_MULTI_SESSION
   return lower->ops->start(lower, session);
@@ -867,6 +911,10 @@ static int pcm_stop(FAR struct audio_lowerhalf_s *dev)
   /* We are no longer streaming */
 
   priv->streaming = false;
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+  priv->nqueued = 0;
+  priv->startpending = false;
+#endif
 
   /* Defer the operation to the lower device driver */
 
@@ -1069,7 +1117,15 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
       audinfo("Pass to lower enqueuebuffer: apb=%p curbyte=%d nbytes=%d\n",
               apb, apb->curbyte, apb->nbytes);
 
-      return lower->ops->enqueuebuffer(lower, apb);
+      ret = lower->ops->enqueuebuffer(lower, apb);
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+      if (ret == OK)
+        {
+          ret = pcm_prebuffer(priv, apb);
+        }
+#endif
+
+      return ret;
     }
 
   /* No.. then this must be the first buffer that we have seen (since we
@@ -1143,7 +1199,12 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
            */
 
           priv->streaming = ((apb->flags & AUDIO_APB_FINAL) == 0);
+#if CONFIG_AUDIO_PCM_PREBUFFER > 0
+          priv->nqueued = 0;
+          return pcm_prebuffer(priv, apb);
+#else
           return OK;
+#endif
         }
 
       /* The normal protocol for streaming errors is as follows:
@@ -139,7 +139,7 @@ int exec_module(FAR struct binary_s *binp,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)nxsched_alloc_tcb(TCB_FLAG_TTYPE_TASK);
   if (!tcb)
     {
       return -ENOMEM;
@@ -316,7 +316,7 @@ errout_with_envp:
 errout_with_args:
   binfmt_freeargv(argv);
 errout_with_tcb:
-  kmm_free(tcb);
+  nxsched_free_tcb((FAR struct tcb_s *)tcb, TCB_FLAG_TTYPE_TASK);
   return ret;
 }
 
@@ -117,6 +117,59 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
 
 int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_cache_restore
+ *
+ * Description:
+ *   Copy the image bound by an earlier load of the same file over the
+ *   sections just loaded, if the file, the exported symbols, and the
+ *   allocated addresses are all the same as then.
+ *
+ * Returned Value:
+ *   0 (OK) if the image was restored and needs no binding; -ENOENT
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_CACHE
+int elf_cache_restore(FAR struct elf_loadinfo_s *loadinfo,
+                      FAR const struct symtab_s *exports, int nexports);
+
+/****************************************************************************
+ * Name: elf_cache_save
+ *
+ * Description:
+ *   Remember the image just bound, for elf_cache_restore().
+ *
+ ****************************************************************************/
+
+void elf_cache_save(FAR struct elf_loadinfo_s *loadinfo,
+                    FAR const struct symtab_s *exports, int nexports);
+#endif
+
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Read the symbol table and its string table into memory, so that
+ *   elf_readsym() and elf_symvalue() don't have to read the file.  Nothing
+ *   is done if CONFIG_ELF_LOADSYMTAB is not set or there is not enough
+ *   memory.
+ *
+ ****************************************************************************/
+
+void elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the tables read by elf_loadsymtab(), if any.
+ *
+ ****************************************************************************/
+
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_readsym
  *
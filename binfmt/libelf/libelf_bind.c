@@ -565,6 +565,19 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   int ret;
   int i;
 
+#ifdef CONFIG_ELF_CACHE
+  /* Reuse the image bound by an earlier load of the same file if it was
+   * bound at the same addresses.
+   */
+
+  if (elf_cache_restore(loadinfo, exports, nexports) == OK)
+    {
+      up_coherent_dcache(loadinfo->textalloc, loadinfo->textsize);
+      up_coherent_dcache(loadinfo->dataalloc, loadinfo->datasize);
+      return OK;
+    }
+#endif
+
   /* Find the symbol and string tables */
 
   ret = elf_findsymtab(loadinfo);
@@ -584,6 +597,12 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+  /* Read the symbol and string tables in one go when there is memory for
+   * them: the relocations below look up most symbols at least once.
+   */
+
+  elf_loadsymtab(loadinfo);
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -670,6 +689,15 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   up_coherent_dcache(loadinfo->textalloc, loadinfo->textsize);
   up_coherent_dcache(loadinfo->dataalloc, loadinfo->datasize);
 
+#endif
+
+  elf_freesymtab(loadinfo);
+
+#ifdef CONFIG_ELF_CACHE
+  if (ret == OK)
+    {
+      elf_cache_save(loadinfo, exports, nexports);
+    }
 #endif
 
   return ret;
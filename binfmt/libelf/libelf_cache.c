@@ -0,0 +1,249 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A bound image of a file, valid only at the addresses it was bound at */
+
+struct elf_cache_s
+{
+  FAR char                  *filename;  /* Key: file path */
+  struct timespec            mtime;     /* Key: modification time */
+  off_t                      filelen;   /* Key: file size */
+  FAR const struct symtab_s *exports;   /* Key: symbols bound against */
+  int                        nexports;
+  uintptr_t                  textalloc; /* Addresses of the bound image */
+  uintptr_t                  dataalloc;
+  size_t                     textsize;
+  size_t                     datasize;
+  FAR uint8_t               *image;     /* .text followed by .data/.bss */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_elf_cachelock = NXMUTEX_INITIALIZER;
+static struct elf_cache_s g_elf_cache[CONFIG_ELF_CACHE_ENTRIES];
+static unsigned int g_elf_cachenext;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_find
+ *
+ * Description:
+ *   Return the entry of the file described by loadinfo, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct elf_cache_s *
+elf_cache_find(FAR const struct elf_loadinfo_s *loadinfo)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_ELF_CACHE_ENTRIES; i++)
+    {
+      FAR struct elf_cache_s *entry = &g_elf_cache[i];
+
+      if (entry->filename != NULL &&
+          strcmp(entry->filename, loadinfo->filename) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: elf_cache_release
+ ****************************************************************************/
+
+static void elf_cache_release(FAR struct elf_cache_s *entry)
+{
+  kmm_free(entry->filename);
+  kmm_free(entry->image);
+  memset(entry, 0, sizeof(*entry));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_restore
+ *
+ * Description:
+ *   Copy the image bound by an earlier load of the same file over the
+ *   sections just loaded, if the file, the exported symbols, and the
+ *   allocated addresses are all the same as then.
+ *
+ * Returned Value:
+ *   0 (OK) if the image was restored and needs no binding; -ENOENT
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+int elf_cache_restore(FAR struct elf_loadinfo_s *loadinfo,
+                      FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct elf_cache_s *entry;
+  int ret = -ENOENT;
+
+  if (loadinfo->filename == NULL)
+    {
+      return ret;
+    }
+
+  nxmutex_lock(&g_elf_cachelock);
+
+  entry = elf_cache_find(loadinfo);
+  if (entry != NULL)
+    {
+      if (entry->mtime.tv_sec != loadinfo->mtime.tv_sec ||
+          entry->mtime.tv_nsec != loadinfo->mtime.tv_nsec ||
+          entry->filelen != loadinfo->filelen)
+        {
+          /* The file changed, the image is of no use any more */
+
+          elf_cache_release(entry);
+        }
+      else if (entry->exports == exports && entry->nexports == nexports &&
+               entry->textalloc == loadinfo->textalloc &&
+               entry->dataalloc == loadinfo->dataalloc &&
+               entry->textsize == loadinfo->textsize &&
+               entry->datasize == loadinfo->datasize)
+        {
+          memcpy((FAR void *)loadinfo->textalloc, entry->image,
+                 entry->textsize);
+          memcpy((FAR void *)loadinfo->dataalloc,
+                 entry->image + entry->textsize, entry->datasize);
+          ret = OK;
+        }
+    }
+
+  nxmutex_unlock(&g_elf_cachelock);
+
+  if (ret == OK)
+    {
+      binfo("%s: bound image restored from the cache\n",
+            loadinfo->filename);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_cache_save
+ *
+ * Description:
+ *   Remember the image just bound, before the program gets to modify its
+ *   data.  Images whose constructor or destructor tables live outside of
+ *   the data allocation are not remembered, nor images for which there is
+ *   not enough memory.
+ *
+ ****************************************************************************/
+
+void elf_cache_save(FAR struct elf_loadinfo_s *loadinfo,
+                    FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct elf_cache_s *entry;
+  FAR uint8_t *image;
+  FAR char *filename;
+  size_t namelen;
+
+  if (loadinfo->filename == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  if (loadinfo->ctoralloc != NULL || loadinfo->dtoralloc != NULL)
+    {
+      return;
+    }
+#endif
+
+  image    = kmm_malloc(loadinfo->textsize + loadinfo->datasize);
+  namelen  = strlen(loadinfo->filename) + 1;
+  filename = kmm_malloc(namelen);
+  if (image == NULL || filename == NULL)
+    {
+      kmm_free(image);
+      kmm_free(filename);
+      return;
+    }
+
+  memcpy(filename, loadinfo->filename, namelen);
+  memcpy(image, (FAR const void *)loadinfo->textalloc, loadinfo->textsize);
+  memcpy(image + loadinfo->textsize, (FAR const void *)loadinfo->dataalloc,
+         loadinfo->datasize);
+
+  nxmutex_lock(&g_elf_cachelock);
+
+  /* Replace the image of the same file, or else the oldest one */
+
+  entry = elf_cache_find(loadinfo);
+  if (entry == NULL)
+    {
+      entry = &g_elf_cache[g_elf_cachenext];
+      g_elf_cachenext = (g_elf_cachenext + 1) % CONFIG_ELF_CACHE_ENTRIES;
+    }
+
+  elf_cache_release(entry);
+
+  entry->filename  = filename;
+  entry->mtime     = loadinfo->mtime;
+  entry->filelen   = loadinfo->filelen;
+  entry->exports   = exports;
+  entry->nexports  = nexports;
+  entry->textalloc = loadinfo->textalloc;
+  entry->dataalloc = loadinfo->dataalloc;
+  entry->textsize  = loadinfo->textsize;
+  entry->datasize  = loadinfo->datasize;
+  entry->image     = image;
+
+  nxmutex_unlock(&g_elf_cachelock);
+}
+
+#endif /* CONFIG_ELF_CACHE */
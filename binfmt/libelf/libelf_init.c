@@ -105,6 +105,9 @@ static inline int elf_filelen(FAR struct elf_loadinfo_s *loadinfo,
   /* Return the size of the file in the loadinfo structure */
 
   loadinfo->filelen = buf.st_size;
+#ifdef CONFIG_ELF_CACHE
+  loadinfo->mtime   = buf.st_mtim;
+#endif
   return OK;
 }
 
@@ -134,6 +137,9 @@ int elf_init(FAR const char *filename, FAR struct elf_loadinfo_s *loadinfo)
   /* Clear the load info structure */
 
   memset(loadinfo, 0, sizeof(struct elf_loadinfo_s));
+#ifdef CONFIG_ELF_CACHE
+  loadinfo->filename = filename;
+#endif
 
   /* Get the length of the file. */
 
@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -82,6 +83,38 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  if (loadinfo->strtab != NULL)
+    {
+      FAR Elf_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+      FAR const char *name = loadinfo->strtab + sym->st_name;
+      FAR const char *end;
+
+      if (sym->st_name >= strtab->sh_size ||
+          (end = memchr(name, '\0', strtab->sh_size - sym->st_name)) ==
+          NULL)
+        {
+          berr("Bad symbol name offset: %" PRIu32 "\n",
+               (uint32_t)sym->st_name);
+          return -EINVAL;
+        }
+
+      readlen = end - name + 1;
+      while (readlen > loadinfo->buflen)
+        {
+          ret = elf_reallocbuffer(loadinfo, CONFIG_ELF_BUFFERINCR);
+          if (ret < 0)
+            {
+              berr("elf_reallocbuffer failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      memcpy(loadinfo->iobuffer, name, readlen);
+      return OK;
+    }
+#endif
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -183,6 +216,83 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Read the symbol table and its string table into memory, so that
+ *   elf_readsym() and elf_symvalue() don't have to read the file.  Nothing
+ *   is done if CONFIG_ELF_LOADSYMTAB is not set or there is not enough
+ *   memory.
+ *
+ ****************************************************************************/
+
+void elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+#ifdef CONFIG_ELF_LOADSYMTAB
+  FAR Elf_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+  if (loadinfo->symtab != NULL || symtab->sh_size == 0 ||
+      strtab->sh_size == 0)
+    {
+      return;
+    }
+
+  loadinfo->symtab = kmm_malloc(symtab->sh_size);
+  loadinfo->strtab = kmm_malloc(strtab->sh_size);
+  if (loadinfo->symtab == NULL || loadinfo->strtab == NULL)
+    {
+      binfo("No memory for the symbol tables, reading them lazily\n");
+      goto errout;
+    }
+
+  ret = elf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                 symtab->sh_size, symtab->sh_offset);
+  if (ret >= 0)
+    {
+      ret = elf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                     strtab->sh_size, strtab->sh_offset);
+    }
+
+  if (ret >= 0)
+    {
+      return;
+    }
+
+  berr("Failed to read the symbol tables: %d\n", ret);
+
+errout:
+  elf_freesymtab(loadinfo);
+#endif
+}
+
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the tables read by elf_loadsymtab(), if any.
+ *
+ ****************************************************************************/
+
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+#ifdef CONFIG_ELF_LOADSYMTAB
+  if (loadinfo->symtab != NULL)
+    {
+      kmm_free(loadinfo->symtab);
+      loadinfo->symtab = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      kmm_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: elf_readsym
  *
@@ -208,12 +318,20 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf_Sym)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  if (loadinfo->symtab != NULL)
+    {
+      memcpy(sym, &loadinfo->symtab[index], sizeof(Elf_Sym));
+      return OK;
+    }
+#endif
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf_Sym) * index;
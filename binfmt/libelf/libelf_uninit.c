@@ -107,5 +107,7 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  elf_freesymtab(loadinfo);
+
   return OK;
 }
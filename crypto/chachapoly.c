@@ -72,6 +72,14 @@ void chacha20_crypt(caddr_t key, FAR uint8_t *data)
                        CHACHA20_BLOCK_LEN);
 }
 
+void chacha20_crypt_multi(caddr_t key, FAR const uint8_t *src,
+                          FAR uint8_t *dst, size_t len)
+{
+  FAR struct chacha20_ctx *ctx = (FAR struct chacha20_ctx *)key;
+
+  chacha_encrypt_bytes((FAR chacha_ctx *)ctx->block, src, dst, len);
+}
+
 void chacha20_poly1305_init(FAR void *xctx)
 {
   FAR CHACHA20_POLY1305_CTX *ctx = xctx;
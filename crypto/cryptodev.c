@@ -202,6 +202,7 @@ static int cryptof_ioctl(FAR struct file *filep,
   FAR struct csession *cse;
   FAR struct session_op *sop;
   FAR struct crypt_op *cop;
+  FAR struct crypt_mop *mop;
   FAR const struct enc_xform *txform = NULL;
   FAR const struct auth_hash *thash = NULL;
   uint64_t sid;
@@ -379,6 +380,34 @@ bail:
           }
 
         error = cryptodev_op(cse, cop);
+        break;
+      case CIOCCRYPTM:
+        mop = (FAR struct crypt_mop *)arg;
+        cse = NULL;
+
+        for (mop->done = 0; mop->done < mop->count; mop->done++)
+          {
+            cop = &mop->reqs[mop->done];
+
+            /* Batches usually stay on one session */
+
+            if (cse == NULL || cse->ses != cop->ses)
+              {
+                cse = csefind(fcr, cop->ses);
+                if (cse == NULL)
+                  {
+                    error = -EINVAL;
+                    break;
+                  }
+              }
+
+            error = cryptodev_op(cse, cop);
+            if (error < 0)
+              {
+                break;
+              }
+          }
+
         break;
       case CIOCKEY:
         error = cryptodev_key((FAR struct crypt_kop *)arg);
@@ -720,6 +749,15 @@ fail:
 static int cryptof_poll(FAR struct file *filep,
                         struct pollfd *fds, bool setup)
 {
+  /* The operations complete before their ioctl returns, so the
+   * descriptor is always ready.
+   */
+
+  if (setup)
+    {
+      poll_notify(&fds, 1, POLLIN | POLLOUT);
+    }
+
   return 0;
 }
 
@@ -117,6 +117,31 @@ int swcr_encdec(FAR struct cryptop *crp, FAR struct cryptodesc *crd,
   if (exf->reinit)
     {
       exf->reinit((caddr_t)sw->sw_kschedule, iv);
+
+      /* Process the whole buffer at once, without the copies through
+       * blk, if the xform can do it.
+       */
+
+      if (exf->encrypt_multi != NULL)
+        {
+          if (crd->crd_flags & CRD_F_ENCRYPT)
+            {
+              exf->encrypt_multi((caddr_t)sw->sw_kschedule,
+                                 (FAR uint8_t *)buf + crd->crd_skip,
+                                 (FAR uint8_t *)crp->crp_dst,
+                                 crd->crd_len);
+            }
+          else
+            {
+              exf->decrypt_multi((caddr_t)sw->sw_kschedule,
+                                 (FAR uint8_t *)buf + crd->crd_skip,
+                                 (FAR uint8_t *)crp->crp_dst,
+                                 crd->crd_len);
+            }
+
+          crp->crp_dst += crd->crd_len;
+          return 0;
+        }
     }
 
   i = crd->crd_len;
@@ -411,29 +436,53 @@ int swcr_authenc(FAR struct cryptop *crp)
       exf->reinit((caddr_t)swe->sw_kschedule, iv);
     }
 
-  /* Do encryption/decryption with MAC */
+  /* Do encryption/decryption with MAC.  If the xform can process the
+   * whole buffer at once, so does the MAC:  the update methods pad only
+   * the end of the data they are given, so this is the same as feeding
+   * them block by block.
+   */
 
-  for (i = 0; i < crde->crd_len; i += blksz)
+  if (exf->encrypt_multi != NULL && crde->crd_len <= UINT16_MAX)
     {
-      len = MIN(crde->crd_len - i, blksz);
-      if (len < blksz)
-        {
-          bzero(blk, blksz);
-        }
-
-      bcopy(buf + i, blk, len);
       if (crde->crd_flags & CRD_F_ENCRYPT)
         {
-          exf->encrypt((caddr_t)swe->sw_kschedule, blk);
-          axf->update(&ctx, blk, len);
+          exf->encrypt_multi((caddr_t)swe->sw_kschedule,
+                             (FAR uint8_t *)buf,
+                             (FAR uint8_t *)crp->crp_dst, crde->crd_len);
+          axf->update(&ctx, (FAR uint8_t *)crp->crp_dst, crde->crd_len);
         }
       else
         {
-          axf->update(&ctx, blk, len);
-          exf->decrypt((caddr_t)swe->sw_kschedule, blk);
+          axf->update(&ctx, (FAR uint8_t *)buf, crde->crd_len);
+          exf->decrypt_multi((caddr_t)swe->sw_kschedule,
+                             (FAR uint8_t *)buf,
+                             (FAR uint8_t *)crp->crp_dst, crde->crd_len);
         }
+    }
+  else
+    {
+      for (i = 0; i < crde->crd_len; i += blksz)
+        {
+          len = MIN(crde->crd_len - i, blksz);
+          if (len < blksz)
+            {
+              bzero(blk, blksz);
+            }
 
-      bcopy(blk, crp->crp_dst + i, len);
+          bcopy(buf + i, blk, len);
+          if (crde->crd_flags & CRD_F_ENCRYPT)
+            {
+              exf->encrypt((caddr_t)swe->sw_kschedule, blk);
+              axf->update(&ctx, blk, len);
+            }
+          else
+            {
+              axf->update(&ctx, blk, len);
+              exf->decrypt((caddr_t)swe->sw_kschedule, blk);
+            }
+
+          bcopy(blk, crp->crp_dst + i, len);
+        }
     }
 
   /* Do any required special finalization */
@@ -34,6 +34,66 @@
 #include <crypto/aes.h>
 #include <crypto/gmac.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Carry-less 32 x 32 bit multiplication.  The operands are split in four
+ * sets of bits spaced four positions apart, so the carries of the integer
+ * multiplications only land in the holes between them and are masked
+ * away.  Unlike a bit by bit loop this takes the same time for every
+ * value.
+ */
+
+static uint64_t ghash_bmul32(uint32_t x, uint32_t y)
+{
+  uint32_t x0 = x & 0x11111111;
+  uint32_t x1 = x & 0x22222222;
+  uint32_t x2 = x & 0x44444444;
+  uint32_t x3 = x & 0x88888888;
+  uint32_t y0 = y & 0x11111111;
+  uint32_t y1 = y & 0x22222222;
+  uint32_t y2 = y & 0x44444444;
+  uint32_t y3 = y & 0x88888888;
+  uint64_t z0;
+  uint64_t z1;
+  uint64_t z2;
+  uint64_t z3;
+
+  z0 = ((uint64_t)x0 * y0) ^ ((uint64_t)x1 * y3) ^
+       ((uint64_t)x2 * y2) ^ ((uint64_t)x3 * y1);
+  z1 = ((uint64_t)x0 * y1) ^ ((uint64_t)x1 * y0) ^
+       ((uint64_t)x2 * y3) ^ ((uint64_t)x3 * y2);
+  z2 = ((uint64_t)x0 * y2) ^ ((uint64_t)x1 * y1) ^
+       ((uint64_t)x2 * y0) ^ ((uint64_t)x3 * y3);
+  z3 = ((uint64_t)x0 * y3) ^ ((uint64_t)x1 * y2) ^
+       ((uint64_t)x2 * y1) ^ ((uint64_t)x3 * y0);
+
+  return (z0 & 0x1111111111111111ull) | (z1 & 0x2222222222222222ull) |
+         (z2 & 0x4444444444444444ull) | (z3 & 0x8888888888888888ull);
+}
+
+/* Carry-less 64 x 64 bit multiplication, by Karatsuba */
+
+static void ghash_bmul64(FAR uint64_t *hi, FAR uint64_t *lo,
+                         uint64_t x, uint64_t y)
+{
+  uint32_t x0 = (uint32_t)x;
+  uint32_t x1 = (uint32_t)(x >> 32);
+  uint32_t y0 = (uint32_t)y;
+  uint32_t y1 = (uint32_t)(y >> 32);
+  uint64_t z0;
+  uint64_t z1;
+  uint64_t z2;
+
+  z0 = ghash_bmul32(x0, y0);
+  z2 = ghash_bmul32(x1, y1);
+  z1 = ghash_bmul32(x0 ^ x1, y0 ^ y1) ^ z0 ^ z2;
+
+  *lo = z0 ^ (z1 << 32);
+  *hi = z2 ^ (z1 >> 32);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,45 +111,53 @@ CODE void (*ghash_update)(FAR GHASH_CTX *,
 
 void ghash_gfmul(FAR uint32_t *X, FAR uint32_t *Y, FAR uint32_t *product)
 {
-  uint32_t v[4];
-  uint32_t z[4] =
-  {
-    0, 0, 0, 0
-  };
-
-  FAR uint8_t *x = (FAR uint8_t *)X;
-  uint32_t mask;
-  int i;
-
-  v[0] = betoh32(Y[0]);
-  v[1] = betoh32(Y[1]);
-  v[2] = betoh32(Y[2]);
-  v[3] = betoh32(Y[3]);
-
-  for (i = 0; i < GMAC_BLOCK_LEN * 8; i++)
-    {
-      /* update Z */
-
-      mask = !!(x[i >> 3] & (1 << (~i & 7)));
-      mask = ~(mask - 1);
-      z[0] ^= v[0] & mask;
-      z[1] ^= v[1] & mask;
-      z[2] ^= v[2] & mask;
-      z[3] ^= v[3] & mask;
-
-      /* update V */
-
-      mask = ~((v[3] & 1) - 1);
-      v[3] = (v[2] << 31) | (v[3] >> 1);
-      v[2] = (v[1] << 31) | (v[2] >> 1);
-      v[1] = (v[0] << 31) | (v[1] >> 1);
-      v[0] = (v[0] >> 1) ^ (0xe1000000 & mask);
-    }
-
-  product[0] = htobe32(z[0]);
-  product[1] = htobe32(z[1]);
-  product[2] = htobe32(z[2]);
-  product[3] = htobe32(z[3]);
+  uint64_t x0;
+  uint64_t x1;
+  uint64_t y0;
+  uint64_t y1;
+  uint64_t z0;
+  uint64_t z1;
+  uint64_t z2;
+  uint64_t z3;
+  uint64_t m0;
+  uint64_t m1;
+
+  x1 = ((uint64_t)betoh32(X[0]) << 32) | betoh32(X[1]);
+  x0 = ((uint64_t)betoh32(X[2]) << 32) | betoh32(X[3]);
+  y1 = ((uint64_t)betoh32(Y[0]) << 32) | betoh32(Y[1]);
+  y0 = ((uint64_t)betoh32(Y[2]) << 32) | betoh32(Y[3]);
+
+  /* The bits are reflected: the first bit of the block is the constant
+   * term.  Karatsuba gives the 255 bit product of the two big endian
+   * values, and a shift by one aligns it on 256 bits.
+   */
+
+  ghash_bmul64(&z1, &z0, x0, y0);
+  ghash_bmul64(&z3, &z2, x1, y1);
+  ghash_bmul64(&m1, &m0, x0 ^ x1, y0 ^ y1);
+  m0 ^= z0 ^ z2;
+  m1 ^= z1 ^ z3;
+  z1 ^= m0;
+  z2 ^= m1;
+
+  z3 = (z3 << 1) | (z2 >> 63);
+  z2 = (z2 << 1) | (z1 >> 63);
+  z1 = (z1 << 1) | (z0 >> 63);
+  z0 <<= 1;
+
+  /* Reduce modulo x^128 + x^7 + x^2 + x + 1.  The bits shifted out
+   * of the low half are folded in first.
+   */
+
+  z1 ^= (z0 << 63) ^ (z0 << 62) ^ (z0 << 57);
+  z3 ^= z1 ^ (z1 >> 1) ^ (z1 >> 2) ^ (z1 >> 7);
+  z2 ^= z0 ^ (z0 >> 1) ^ (z0 >> 2) ^ (z0 >> 7) ^
+        (z1 << 63) ^ (z1 << 62) ^ (z1 << 57);
+
+  product[0] = htobe32((uint32_t)(z3 >> 32));
+  product[1] = htobe32((uint32_t)z3);
+  product[2] = htobe32((uint32_t)(z2 >> 32));
+  product[3] = htobe32((uint32_t)z2);
 }
 
 void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
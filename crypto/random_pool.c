@@ -45,6 +45,12 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+/* Requests smaller than this are served from a buffer of output, so that
+ * arc4random() does not run a BLAKE2s compression per call.
+ */
+
+#define RNG_BUFSIZE  (2 * BLAKE2S_OUTBYTES)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -71,6 +77,8 @@ struct rng_s
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
+  uint8_t out_buf[RNG_BUFSIZE]; /* The unread output is at its end */
+  size_t out_avail;
 };
 
 enum
@@ -303,11 +311,44 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.inner_length = BLAKE2S_OUTBYTES;
   g_rng.blake2xs.param.node_depth = 0;
 
+  /* Drop the output buffered from the previous root */
+
+  explicit_bzero(g_rng.out_buf, sizeof(g_rng.out_buf));
+  g_rng.out_avail = 0;
+
   g_rng.output_initialized = true;
 }
 
+static void rng_generate(FAR uint8_t *bytes, size_t nbytes)
+{
+  /* Output phase for BLAKE2Xs. */
+
+  for (; nbytes > 0; ++g_rng.blake2xs.out_node_offset)
+    {
+      size_t block_size = MIN(nbytes, BLAKE2S_OUTBYTES);
+
+      /* Initialize state */
+
+      g_rng.blake2xs.param.digest_length = block_size;
+      blake2_store32(g_rng.blake2xs.param.node_offset,
+                     g_rng.blake2xs.out_node_offset);
+      blake2s_init_param(&g_rng.blake2xs.ctx, &g_rng.blake2xs.param);
+
+      /* Process state and output random bytes */
+
+      blake2s_update(&g_rng.blake2xs.ctx, g_rng.blake2xs.out_root,
+                     sizeof(g_rng.blake2xs.out_root));
+      blake2s_final(&g_rng.blake2xs.ctx, bytes, block_size);
+
+      bytes += block_size;
+      nbytes -= block_size;
+    }
+}
+
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
 {
+  FAR uint8_t *src;
+
   if (!g_rng.output_initialized)
     {
       if (g_rng.rd_newentr < MIN_SEED_NEW_ENTROPY_WORDS)
@@ -333,28 +374,26 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
       rng_reseed();
     }
 
-  /* Output phase for BLAKE2Xs. */
-
-  for (; nbytes > 0; ++g_rng.blake2xs.out_node_offset)
+  if (nbytes >= RNG_BUFSIZE)
     {
-      size_t block_size = MIN(nbytes, BLAKE2S_OUTBYTES);
-
-      /* Initialize state */
-
-      g_rng.blake2xs.param.digest_length = block_size;
-      blake2_store32(g_rng.blake2xs.param.node_offset,
-                     g_rng.blake2xs.out_node_offset);
-      blake2s_init_param(&g_rng.blake2xs.ctx, &g_rng.blake2xs.param);
-
-      /* Process state and output random bytes */
+      rng_generate(bytes, nbytes);
+      return;
+    }
 
-      blake2s_update(&g_rng.blake2xs.ctx, g_rng.blake2xs.out_root,
-                     sizeof(g_rng.blake2xs.out_root));
-      blake2s_final(&g_rng.blake2xs.ctx, bytes, block_size);
+  /* Small request: take it from the buffer, refilled as needed, and wipe
+   * what was handed out.
+   */
 
-      bytes += block_size;
-      nbytes -= block_size;
+  if (g_rng.out_avail < nbytes)
+    {
+      rng_generate(g_rng.out_buf, RNG_BUFSIZE);
+      g_rng.out_avail = RNG_BUFSIZE;
     }
+
+  src = &g_rng.out_buf[RNG_BUFSIZE - g_rng.out_avail];
+  memcpy(bytes, src, nbytes);
+  explicit_bzero(src, nbytes);
+  g_rng.out_avail -= nbytes;
 }
 
 /****************************************************************************
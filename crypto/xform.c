@@ -105,6 +105,8 @@ void null_decrypt(caddr_t, FAR uint8_t *);
 void aes_xts_decrypt(caddr_t, FAR uint8_t *);
 
 void aes_ctr_crypt(caddr_t, FAR uint8_t *);
+void aes_ctr_crypt_multi(caddr_t, FAR const uint8_t *, FAR uint8_t *,
+                         size_t);
 
 void aes_ctr_reinit(caddr_t, FAR uint8_t *);
 void aes_xts_reinit(caddr_t, FAR uint8_t *);
@@ -187,7 +189,9 @@ const struct enc_xform enc_xform_aes_ctr =
   aes_ctr_crypt,
   aes_ctr_crypt,
   aes_ctr_setkey,
-  aes_ctr_reinit
+  aes_ctr_reinit,
+  aes_ctr_crypt_multi,
+  aes_ctr_crypt_multi
 };
 
 const struct enc_xform enc_xform_aes_gcm =
@@ -198,7 +202,9 @@ const struct enc_xform enc_xform_aes_gcm =
   aes_ctr_crypt,
   aes_ctr_crypt,
   aes_ctr_setkey,
-  aes_gcm_reinit
+  aes_gcm_reinit,
+  aes_ctr_crypt_multi,
+  aes_ctr_crypt_multi
 };
 
 const struct enc_xform enc_xform_aes_gmac =
@@ -230,7 +236,9 @@ const struct enc_xform enc_xform_chacha20_poly1305 =
   chacha20_crypt,
   chacha20_crypt,
   chacha20_setkey,
-  chacha20_reinit
+  chacha20_reinit,
+  chacha20_crypt_multi,
+  chacha20_crypt_multi
 };
 
 const struct enc_xform enc_xform_null =
@@ -471,6 +479,47 @@ void aes_ctr_crypt(caddr_t key, FAR uint8_t *data)
   explicit_bzero(keystream, sizeof(keystream));
 }
 
+void aes_ctr_crypt_multi(caddr_t key, FAR const uint8_t *src,
+                         FAR uint8_t *dst, size_t len)
+{
+  FAR struct aes_ctr_ctx *ctx;
+  uint8_t keystream[AESCTR_BLOCKSIZE];
+  size_t n;
+  int i;
+
+  ctx = (FAR struct aes_ctr_ctx *)key;
+
+  while (len > 0)
+    {
+      /* increment counter */
+
+      for (i = AESCTR_BLOCKSIZE - 1;
+            i >= AESCTR_NONCESIZE + AESCTR_IVSIZE; i--)
+        {
+          if (++ctx->ac_block[i])   /* continue on overflow */
+            {
+              break;
+            }
+        }
+
+      aes_encrypt(&ctx->ac_key, ctx->ac_block, keystream);
+
+      /* The last block may be partial */
+
+      n = MIN(len, AESCTR_BLOCKSIZE);
+      for (i = 0; i < n; i++)
+        {
+          dst[i] = src[i] ^ keystream[i];
+        }
+
+      src += n;
+      dst += n;
+      len -= n;
+    }
+
+  explicit_bzero(keystream, sizeof(keystream));
+}
+
 int aes_ctr_setkey(FAR void *sched, FAR uint8_t *key, int len)
 {
   FAR struct aes_ctr_ctx *ctx;
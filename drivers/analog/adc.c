@@ -36,6 +36,8 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
@@ -59,6 +61,16 @@ static int     adc_poll(FAR struct file *filep, struct pollfd *fds,
                         bool setup);
 static int     adc_reset_fifo(FAR struct adc_dev_s *dev);
 static int     adc_samples_on_read(FAR struct adc_dev_s *dev);
+#ifdef CONFIG_ADC_STREAM
+static int     adc_mmap(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *map);
+static void    adc_block(FAR struct adc_dev_s *dev, FAR const void *data,
+                         size_t len);
+static int     adc_stream_start(FAR struct adc_dev_s *dev);
+static void    adc_stream_stop(FAR struct adc_dev_s *dev);
+static int     adc_stream_wait(FAR struct file *filep,
+                               FAR struct adc_stream_block_s *block);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -72,7 +84,11 @@ static const struct file_operations g_adc_fops =
   NULL,         /* write */
   NULL,         /* seek */
   adc_ioctl,    /* ioctl */
+#ifdef CONFIG_ADC_STREAM
+  adc_mmap,     /* mmap */
+#else
   NULL,         /* mmap */
+#endif
   NULL,         /* truncate */
   adc_poll      /* poll */
 };
@@ -80,7 +96,10 @@ static const struct file_operations g_adc_fops =
 static const struct adc_callback_s g_adc_callback =
 {
   adc_receive,    /* au_receive */
-  adc_reset       /* au_reset */
+  adc_reset,      /* au_reset */
+#ifdef CONFIG_ADC_STREAM
+  adc_block,      /* au_block */
+#endif
 };
 
 /****************************************************************************
@@ -197,6 +216,10 @@ static int adc_close(FAR struct file *filep)
 
           dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_STREAM
+          adc_stream_stop(dev);
+#endif
+
           /* Free the IRQ and disable the ADC device */
 
           flags = enter_critical_section();    /* Disable interrupts */
@@ -425,6 +448,37 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_ADC_STREAM
+      case ANIOC_STREAM_START:
+        {
+          ret = nxmutex_lock(&dev->ad_closelock);
+          if (ret >= 0)
+            {
+              ret = adc_stream_start(dev);
+              nxmutex_unlock(&dev->ad_closelock);
+            }
+        }
+        break;
+
+      case ANIOC_STREAM_STOP:
+        {
+          ret = nxmutex_lock(&dev->ad_closelock);
+          if (ret >= 0)
+            {
+              adc_stream_stop(dev);
+              nxmutex_unlock(&dev->ad_closelock);
+            }
+        }
+        break;
+
+      case ANIOC_STREAM_WAIT:
+        {
+          ret = adc_stream_wait(filep,
+                                (FAR struct adc_stream_block_s *)arg);
+        }
+        break;
+#endif
+
       default:
         {
           /* Those IOCTLs might be used in arch specific section */
@@ -574,7 +628,11 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (dev->ad_recv.af_head != dev->ad_recv.af_tail
+#ifdef CONFIG_ADC_STREAM
+          || dev->ad_shead != dev->ad_stail
+#endif
+          )
         {
           poll_notify(dev->fds, CONFIG_ADC_NPOLLWAITERS, POLLIN);
         }
@@ -644,6 +702,216 @@ static int adc_samples_on_read(FAR struct adc_dev_s *dev)
   return ret;
 }
 
+#ifdef CONFIG_ADC_STREAM
+/****************************************************************************
+ * Name: adc_mmap
+ *
+ * Description:
+ *   Map the stream buffer.  It exists from ANIOC_STREAM_START to
+ *   ANIOC_STREAM_STOP.
+ *
+ ****************************************************************************/
+
+static int adc_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+
+  if (dev->ad_sbuffer == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (map->offset >= 0 && map->offset < CONFIG_ADC_STREAM_BUFSIZE &&
+      map->length && map->offset + map->length <= CONFIG_ADC_STREAM_BUFSIZE)
+    {
+      map->vaddr = (FAR char *)dev->ad_sbuffer + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: adc_block
+ *
+ * Description:
+ *   Record a block completed by the lower half.  Only the last one can be
+ *   read:  the lower half is already rewriting the blocks before it, so if
+ *   they were not returned yet they are counted as overruns.
+ *
+ ****************************************************************************/
+
+static void adc_block(FAR struct adc_dev_s *dev, FAR const void *data,
+                      size_t len)
+{
+  FAR struct adc_stream_block_s *block = &dev->ad_sblock;
+
+  if (dev->ad_sbuffer == NULL)
+    {
+      return;
+    }
+
+  block->sb_offset = (FAR const uint8_t *)data - dev->ad_sbuffer;
+  block->sb_len    = len;
+  clock_systime_timespec(&block->sb_time);
+
+  if (dev->ad_shead != dev->ad_stail)
+    {
+      dev->ad_soverrun += dev->ad_shead - dev->ad_stail;
+    }
+
+  dev->ad_stail = dev->ad_shead++;
+
+  adc_notify(dev);
+}
+
+/****************************************************************************
+ * Name: adc_stream_start
+ *
+ * Description:
+ *   Allocate the stream buffer and hand it to the lower half.  Called with
+ *   ad_closelock held.
+ *
+ ****************************************************************************/
+
+static int adc_stream_start(FAR struct adc_dev_s *dev)
+{
+  FAR uint8_t *buffer;
+  irqstate_t   flags;
+  int          ret;
+
+  if (dev->ad_ops->ao_stream == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  if (dev->ad_sbuffer != NULL)
+    {
+      return -EBUSY;
+    }
+
+  buffer = kmm_malloc(CONFIG_ADC_STREAM_BUFSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags = enter_critical_section();
+
+  dev->ad_sbuffer  = buffer;
+  dev->ad_shead    = 0;
+  dev->ad_stail    = 0;
+  dev->ad_soverrun = 0;
+
+  ret = dev->ad_ops->ao_stream(dev, buffer, CONFIG_ADC_STREAM_BUFSIZE);
+  if (ret < 0)
+    {
+      dev->ad_sbuffer = NULL;
+    }
+
+  leave_critical_section(flags);
+
+  if (ret < 0)
+    {
+      aerr("ERROR: Failed to start streaming: %d\n", ret);
+      kmm_free(buffer);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_stream_stop
+ *
+ * Description:
+ *   Stop streaming, if started, and wake up the readers.  Called with
+ *   ad_closelock held.
+ *
+ ****************************************************************************/
+
+static void adc_stream_stop(FAR struct adc_dev_s *dev)
+{
+  FAR uint8_t *buffer;
+  irqstate_t   flags;
+  int          i;
+
+  flags = enter_critical_section();
+
+  buffer = dev->ad_sbuffer;
+  if (buffer != NULL)
+    {
+      dev->ad_ops->ao_stream(dev, NULL, 0);
+      dev->ad_sbuffer = NULL;
+
+      for (i = 0; i < dev->ad_nrxwaiters; i++)
+        {
+          nxsem_post(&dev->ad_recv.af_sem);
+        }
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(buffer);
+}
+
+/****************************************************************************
+ * Name: adc_stream_wait
+ *
+ * Description:
+ *   Wait for a block newer than the last one returned.
+ *
+ ****************************************************************************/
+
+static int adc_stream_wait(FAR struct file *filep,
+                           FAR struct adc_stream_block_s *block)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+  irqstate_t            flags;
+  int                   ret   = OK;
+
+  if (block == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  while (dev->ad_shead == dev->ad_stail)
+    {
+      if (dev->ad_sbuffer == NULL)
+        {
+          ret = -EPIPE;
+          goto return_with_irqdisabled;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto return_with_irqdisabled;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          goto return_with_irqdisabled;
+        }
+    }
+
+  *block            = dev->ad_sblock;
+  block->sb_seqno   = dev->ad_stail;
+  block->sb_overrun = dev->ad_soverrun;
+  dev->ad_stail     = dev->ad_shead;
+
+return_with_irqdisabled:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_ADC_STREAM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
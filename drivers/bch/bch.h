@@ -33,6 +33,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -40,22 +41,39 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#if CONFIG_BCH_READAHEAD >= CONFIG_BCH_CACHE_NSECTORS
+#  error CONFIG_BCH_READAHEAD must be smaller than CONFIG_BCH_CACHE_NSECTORS
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One entry of the sector cache */
+
+struct bch_sector_s
+{
+  size_t sector;           /* The sector in the buffer or (size_t)-1 */
+  uint32_t lru;            /* Time of the last access (LRU clock) */
+  bool dirty;              /* true: Data has been written to the buffer */
+  FAR uint8_t *buffer;     /* One sector buffer */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  uint32_t lruclock;       /* Incremented on every cache access */
+  size_t rdoffset;         /* Offset following the last bchlib_read() */
+  FAR struct bch_sector_s *cur;   /* The entry of the last sector accessed */
+  FAR uint8_t *buffer;            /* The sector buffers of all entries */
+  struct bch_sector_s cache[CONFIG_BCH_CACHE_NSECTORS];
+  struct bch_cachestats_s stats;  /* Cache statistics */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -82,7 +100,10 @@ EXTERN const struct file_operations g_bch_fops;
  ****************************************************************************/
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool invalidate);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_readahead(FAR struct bchlib_s *bch, size_t sector);
 
 #undef EXTERN
 #if defined(__cplusplus)
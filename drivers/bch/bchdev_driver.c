@@ -428,6 +428,30 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* Return the statistics of the sector cache */
+
+      case BIOC_CACHESTATS:
+        {
+          FAR struct bch_cachestats_s *stats =
+            (FAR struct bch_cachestats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          memcpy(stats, &bch->stats, sizeof(*stats));
+          nxmutex_unlock(&bch->lock);
+        }
+        break;
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -59,10 +60,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch,
+                      FAR struct bch_sector_s *entry, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)entry->buffer;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -70,7 +72,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        entry->sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -89,105 +91,322 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bch_flushentry
+ *
+ * Description:
+ *   Write one cache entry back to the media if it is dirty
+ *
  ****************************************************************************/
 
+static int bch_flushentry(FAR struct bchlib_s *bch,
+                          FAR struct bch_sector_s *entry)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+
+  if (!entry->dirty)
+    {
+      return OK;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  bch_cypher(bch, entry, CYPHER_ENCRYPT);
+#endif
+
+  /* Write the sector to the media */
+
+  ret = inode->u.i_bops->write(inode, entry->buffer, entry->sector, 1);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
+   */
+
+  bch_cypher(bch, entry, CYPHER_DECRYPT);
+#endif
+
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  /* The sector is now in sync with the media */
+
+  entry->dirty = false;
+  bch->stats.writebacks++;
+  return OK;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_findentry
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Return the cache entry holding the sector or NULL
  *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ ****************************************************************************/
+
+static FAR struct bch_sector_s *bch_findentry(FAR struct bchlib_s *bch,
+                                              size_t sector)
+{
+  int i;
+
+  if (bch->cur != NULL && bch->cur->sector == sector)
+    {
+      return bch->cur;
+    }
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return &bch->cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bch_victim
+ *
+ * Description:
+ *   Select 'count' consecutive cache entries to be replaced:  that run of
+ *   entries whose most recently used member is the oldest.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static FAR struct bch_sector_s *bch_victim(FAR struct bchlib_s *bch,
+                                           int count)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bch_sector_s *victim = NULL;
+  uint32_t best = 0;
+  int i;
+  int j;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+  for (i = 0; i + count <= CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      uint32_t minage = UINT32_MAX;
+
+      /* The age of a run is the age of its youngest entry.  Entries that
+       * hold no sector are the oldest possible.
+       */
+
+      for (j = i; j < i + count; j++)
+        {
+          if (bch->cache[j].sector != (size_t)-1 &&
+              bch->lruclock - bch->cache[j].lru < minage)
+            {
+              minage = bch->lruclock - bch->cache[j].lru;
+            }
+        }
 
-  if (bch->dirty)
+      if (victim == NULL || minage > best)
+        {
+          victim = &bch->cache[i];
+          best   = minage;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bch_loadsector
+ *
+ * Description:
+ *   Make the sector the current cache entry, reading it and up to 'ahead'
+ *   following sectors that are not cached yet from the media on a miss.
+ *
+ ****************************************************************************/
+
+static int bch_loadsector(FAR struct bchlib_s *bch, size_t sector,
+                          int ahead)
+{
+  FAR struct inode *inode = bch->inode;
+  FAR struct bch_sector_s *entry;
+  ssize_t ret;
+  int count;
+  int i;
+
+  entry = bch_findentry(bch, sector);
+  if (entry != NULL)
     {
-      inode = bch->inode;
+      bch->stats.hits++;
+      goto out;
+    }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  bch->stats.misses++;
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
-#endif
+  /* Extend the transfer over the following sectors, but never read a
+   * sector that is already cached somewhere else.
+   */
+
+  for (count = 1; count <= ahead && sector + count < bch->nsectors;
+       count++)
+    {
+      if (bch_findentry(bch, sector + count) != NULL)
+        {
+          break;
+        }
+    }
 
-      /* Write the sector to the media */
+  /* Write back and release the entries to be replaced */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+  entry = bch_victim(bch, count);
+  for (i = 0; i < count; i++)
+    {
+      ret = bch_flushentry(bch, &entry[i]);
       if (ret < 0)
         {
-          ferr("Write failed: %zd\n", ret);
+          ferr("Flush failed: %zd\n", ret);
           return (int)ret;
         }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+      entry[i].sector = (size_t)-1;
+    }
 
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  /* The buffers of consecutive entries are contiguous, so all sectors can
+   * be read with a single transfer.
+   */
 
-      /* The sector is now in sync with the media */
+  ret = inode->u.i_bops->read(inode, entry->buffer, sector, count);
+  if (ret < 0)
+    {
+      ferr("Read failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      bch->dirty = false;
+  for (i = 0; i < count; i++)
+    {
+      entry[i].sector = sector + i;
+      entry[i].lru    = bch->lruclock;
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, &entry[i], CYPHER_DECRYPT);
+#endif
     }
 
-  return (int)ret;
+  bch->stats.readahead += count - 1;
+
+out:
+  entry->lru = ++bch->lruclock;
+  bch->cur   = entry;
+  return OK;
 }
 
 /****************************************************************************
- * Name: bchlib_readsector
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of all sector buffers (if dirty)
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  return bchlib_flushrange(bch, 0, bch->nsectors, false);
+}
 
-  if (bch->sector != sector)
-    {
-      inode = bch->inode;
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush the cached sectors in the range [sector, sector + nsectors) (if
+ *   dirty) and optionally drop them from the cache.  Sectors are written
+ *   back in ascending order.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
-      ret = bchlib_flushsector(bch);
-      if (ret < 0)
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool invalidate)
+{
+  FAR struct bch_sector_s *entry;
+  int ret;
+  int i;
+
+  /* Write back the dirty entries in the range lowest sector first */
+
+  do
+    {
+      entry = NULL;
+      for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
         {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
-        }
+          FAR struct bch_sector_s *tmp = &bch->cache[i];
 
-      bch->sector = (size_t)-1;
+          if (tmp->dirty && tmp->sector - sector < nsectors &&
+              (entry == NULL || tmp->sector < entry->sector))
+            {
+              entry = tmp;
+            }
+        }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+      if (entry != NULL)
         {
-          ferr("Read failed: %zd\n", ret);
-          return (int)ret;
+          ret = bch_flushentry(bch, entry);
+          if (ret < 0)
+            {
+              return ret;
+            }
         }
+    }
+  while (entry != NULL);
 
-      bch->sector = sector;
-#if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  if (invalidate)
+    {
+      for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+        {
+          if (bch->cache[i].sector - sector < nsectors)
+            {
+              bch->cache[i].sector = (size_t)-1;
+            }
+        }
     }
 
-  return (int)ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_readsector
+ *
+ * Description:
+ *   Make the sector available in the cache and current (bch->cur), reading
+ *   it from the media if necessary.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  return bch_loadsector(bch, sector, 0);
+}
+
+/****************************************************************************
+ * Name: bchlib_readahead
+ *
+ * Description:
+ *   Like bchlib_readsector() but a cache miss also reads up to
+ *   CONFIG_BCH_READAHEAD following sectors.  Used for sequential reads.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_readahead(FAR struct bchlib_s *bch, size_t sector)
+{
+  return bch_loadsector(bch, sector, CONFIG_BCH_READAHEAD);
 }
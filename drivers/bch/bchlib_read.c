@@ -73,6 +73,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
+  bool     sequential;
   int      ret;
 
   /* Get rid of this special case right away */
@@ -94,6 +95,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
       return 0;
     }
 
+  /* Reads that continue where the previous one stopped are sequential
+   * and make the cache read ahead.
+   */
+
+  sequential    = offset == bch->rdoffset;
+  bch->rdoffset = SIZE_MAX;
+
   /* Read the initial partial sector */
 
   bytesread = 0;
@@ -101,7 +109,8 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = sequential ? bchlib_readahead(bch, sector) :
+                         bchlib_readsector(bch, sector);
       if (ret < 0)
         {
           return ret;
@@ -118,7 +127,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &bch->cur->buffer[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -126,6 +135,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
 
       if (sector >= bch->nsectors)
         {
+          bch->rdoffset = offset + nbytes;
           return nbytes;
         }
 
@@ -146,6 +156,15 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Cached sectors may be newer than the media */
+
+      ret = bchlib_flushrange(bch, sector, nsectors, false);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
@@ -162,6 +181,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
 
       if (sector >= bch->nsectors)
         {
+          bch->rdoffset = offset + bytesread;
           return bytesread;
         }
 
@@ -175,7 +195,8 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = sequential ? bchlib_readahead(bch, sector) :
+                         bchlib_readsector(bch, sector);
       if (ret < 0)
         {
           return ret;
@@ -183,12 +204,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, bch->cur->buffer, len);
 
       /* Adjust counts */
 
       bytesread += len;
     }
 
+  bch->rdoffset = offset + bytesread;
   return bytesread;
 }
@@ -58,6 +58,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -108,15 +109,18 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
+  bch->rdoffset = SIZE_MAX;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate the sector I/O buffers of the cache in one piece, so that the
+   * buffers of consecutive entries are contiguous.
+   */
 
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                             bch->sectsize * CONFIG_BCH_CACHE_NSECTORS);
 #else
-  bch->buffer = kmm_malloc(bch->sectsize);
+  bch->buffer = kmm_malloc(bch->sectsize * CONFIG_BCH_CACHE_NSECTORS);
 #endif
   if (!bch->buffer)
     {
@@ -125,6 +129,12 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       goto errout_with_bch;
     }
 
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+      bch->cache[i].buffer = bch->buffer + i * bch->sectsize;
+    }
+
   *handle = bch;
   return OK;
 
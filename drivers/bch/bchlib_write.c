@@ -102,8 +102,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&bch->cur->buffer[sectoffset], buffer, nbytes);
+      bch->cur->dirty = true;
 
       /* Adjust pointers and counts */
 
@@ -131,9 +131,16 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* Flush the dirty sectors to keep the sector sequence and drop the
+       * cached copies of the sectors about to be overwritten.
+       */
 
       ret = bchlib_flushsector(bch);
+      if (ret >= 0)
+        {
+          ret = bchlib_flushrange(bch, sector, nsectors, true);
+        }
+
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -179,8 +186,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(bch->cur->buffer, buffer, len);
+      bch->cur->dirty = true;
 
       /* Adjust counts */
 
@@ -0,0 +1,816 @@
+/****************************************************************************
+ * drivers/benchmark/latency.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A cyclictest-like measure of the scheduling latency:  one high priority
+ * thread per CPU sleeps until an absolute time, periodically, and
+ * measures how late it wakes up,  optionally while lower priority threads
+ * load the heap, the network stack and a file system.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/benchmark/latency.h>
+
+#ifdef CONFIG_HRTIMER
+#  include <nuttx/timers/hrtimer.h>
+#else
+#  include <nuttx/wdog.h>
+#endif
+
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_NET
+#  include <sys/socket.h>
+#  include <sys/time.h>
+#  include <netinet/in.h>
+#  include <arpa/inet.h>
+#  include <nuttx/net/net.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LATENCY_NBUCKETS     CONFIG_BENCHMARK_LATENCY_NBUCKETS
+
+/* The load threads */
+
+#define LATENCY_NLOADS       3
+
+/* The header lines, then "<usec> <count>..." per bucket */
+
+#define LATENCY_REPORTLEN    (128 + 160 * CONFIG_SMP_NCPUS + \
+                              (LATENCY_NBUCKETS + 1) * \
+                              (16 + 11 * CONFIG_SMP_NCPUS))
+
+/* The heap churn load */
+
+#define LATENCY_HEAP_SLOTS   32
+#define LATENCY_HEAP_MAXSIZE 4096
+
+/* The network and file loads */
+
+#define LATENCY_BLOCKSIZE    512
+#define LATENCY_FILEBLOCKS   16
+#define LATENCY_NET_PORT     5471
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct latency_s;
+
+/* The measures of one CPU, by its measuring thread */
+
+struct latency_cpu_s
+{
+  FAR struct latency_s *lat;
+  sem_t         sem;                   /* Posted by the timer */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s timer;
+  uint64_t      next;                  /* Next wakeup, hrtimer nsec */
+#else
+  struct wdog_s wdog;
+  clock_t       next;                  /* Next wakeup, ticks */
+#endif
+  unsigned long fired;                 /* up_perf_gettime() of the timer */
+  uint8_t       index;                 /* The CPU */
+
+  uint32_t      samples;
+  uint32_t      overruns;              /* Wakeups too late for the next */
+  uint32_t      overflow;              /* Samples beyond the histogram */
+  uint64_t      min;                   /* Latencies, nsec */
+  uint64_t      max;
+  uint64_t      total;
+  uint64_t      wakeup;                /* Worst timer to thread time, nsec */
+  uint32_t      hist[LATENCY_NBUCKETS];
+};
+
+struct latency_s
+{
+  mutex_t       lock;                  /* One run at a time */
+  struct latency_param_s param;
+  volatile bool loading;               /* The load threads run while set */
+  sem_t         done;                  /* Posted by each exiting thread */
+
+  FAR char     *report;                /* The report of the last run */
+  size_t        reportlen;
+
+  struct latency_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static int     latency_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_latency_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  latency_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  latency_ioctl,  /* ioctl */
+};
+
+static struct latency_s g_latency =
+{
+  .lock  = NXMUTEX_INITIALIZER,
+  .done  = SEM_INITIALIZER(0),
+  .param =
+  {
+    CONFIG_BENCHMARK_LATENCY_INTERVAL,
+    CONFIG_BENCHMARK_LATENCY_LOOPS,
+    0
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_HEAP
+    | LATENCY_LOAD_HEAP
+#endif
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_NET
+    | LATENCY_LOAD_NET
+#endif
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_FILE
+    | LATENCY_LOAD_FILE
+#endif
+    ,
+    CONFIG_BENCHMARK_LATENCY_PRIORITY
+  },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_now
+ *
+ * Description:
+ *   Return the time of the clock of the wakeups, in nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t latency_now(void)
+{
+#ifdef CONFIG_HRTIMER
+  return hrtimer_now();
+#else
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+#endif
+}
+
+/****************************************************************************
+ * Name: latency_expire
+ ****************************************************************************/
+
+static void latency_expire(wdparm_t arg)
+{
+  FAR struct latency_cpu_s *cpu = (FAR struct latency_cpu_s *)arg;
+
+  cpu->fired = up_perf_gettime();
+  nxsem_post(&cpu->sem);
+}
+
+/****************************************************************************
+ * Name: latency_arm
+ *
+ * Description:
+ *   Arm the timer for the next period and return the expected wakeup time
+ *   in nanoseconds.  A period already passed is skipped as an overrun.
+ *
+ ****************************************************************************/
+
+static uint64_t latency_arm(FAR struct latency_cpu_s *cpu)
+{
+#ifdef CONFIG_HRTIMER
+  uint64_t period = (uint64_t)cpu->lat->param.interval * NSEC_PER_USEC;
+  uint64_t now = hrtimer_now();
+
+  cpu->next += period;
+  if (cpu->next <= now)
+    {
+      cpu->overruns++;
+      cpu->next = now + period;
+    }
+
+  hrtimer_start_abs(&cpu->timer, cpu->next, latency_expire,
+                    (wdparm_t)cpu);
+  return cpu->next;
+#else
+  clock_t period = MAX(USEC2TICK(cpu->lat->param.interval), 1);
+  clock_t now = clock_systime_ticks();
+
+  cpu->next += period;
+  if ((sclock_t)(cpu->next - now) <= 0)
+    {
+      cpu->overruns++;
+      cpu->next = now + period;
+    }
+
+  wd_start(&cpu->wdog, cpu->next - now, latency_expire, (wdparm_t)cpu);
+  return (uint64_t)cpu->next * NSEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Name: latency_thread
+ *
+ * Description:
+ *   The measuring thread of one CPU.
+ *
+ ****************************************************************************/
+
+static int latency_thread(int argc, FAR char *argv[])
+{
+  FAR struct latency_cpu_s *cpu;
+  struct timespec ts;
+  unsigned long fired;
+  uint64_t expected;
+  uint64_t late;
+  uint64_t wakeup;
+  uint32_t i;
+
+  DEBUGASSERT(argc == 2);
+  cpu = (FAR struct latency_cpu_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+#ifdef CONFIG_SMP
+  /* Move to the CPU measured */
+
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu->index, &cpuset);
+  nxsched_set_affinity(nxsched_gettid(), sizeof(cpuset), &cpuset);
+#endif
+
+#ifdef CONFIG_HRTIMER
+  cpu->next = hrtimer_now();
+#else
+  cpu->next = clock_systime_ticks();
+#endif
+
+  for (i = 0; i < cpu->lat->param.loops; i++)
+    {
+      expected = latency_arm(cpu);
+      nxsem_wait_uninterruptible(&cpu->sem);
+
+      late  = latency_now();
+      fired = up_perf_gettime() - cpu->fired;
+      late  = late > expected ? late - expected : 0;
+
+      up_perf_convert(fired, &ts);
+      wakeup = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+      cpu->samples++;
+      cpu->total += late;
+      cpu->min    = MIN(cpu->min, late);
+      cpu->max    = MAX(cpu->max, late);
+      cpu->wakeup = MAX(cpu->wakeup, wakeup);
+
+      if (late / NSEC_PER_USEC < LATENCY_NBUCKETS)
+        {
+          cpu->hist[late / NSEC_PER_USEC]++;
+        }
+      else
+        {
+          cpu->overflow++;
+        }
+    }
+
+  nxsem_post(&cpu->lat->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: latency_heap
+ *
+ * Description:
+ *   Load the heap with allocations and frees of random sizes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_HEAP
+static int latency_heap(int argc, FAR char *argv[])
+{
+  FAR void *slots[LATENCY_HEAP_SLOTS];
+  uint32_t seed = 1;
+  int i;
+
+  memset(slots, 0, sizeof(slots));
+
+  while (g_latency.loading)
+    {
+      seed = seed * 1103515245 + 12345;
+      i    = (seed >> 16) % LATENCY_HEAP_SLOTS;
+
+      if (slots[i] != NULL)
+        {
+          kmm_free(slots[i]);
+          slots[i] = NULL;
+        }
+      else
+        {
+          slots[i] = kmm_malloc(1 + (seed >> 8) % LATENCY_HEAP_MAXSIZE);
+        }
+    }
+
+  for (i = 0; i < LATENCY_HEAP_SLOTS; i++)
+    {
+      kmm_free(slots[i]);
+    }
+
+  nxsem_post(&g_latency.done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: latency_net
+ *
+ * Description:
+ *   Load the network stack with UDP datagrams sent to itself through the
+ *   loopback device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_NET
+static int latency_net(int argc, FAR char *argv[])
+{
+  struct sockaddr_in addr;
+  struct socket sock;
+  struct timeval tv;
+  FAR char *buffer;
+  int ret;
+
+  buffer = kmm_zalloc(LATENCY_BLOCKSIZE);
+  if (buffer == NULL)
+    {
+      goto out;
+    }
+
+  ret = psock_socket(AF_INET, SOCK_DGRAM, 0, &sock);
+  if (ret < 0)
+    {
+      goto out_with_buffer;
+    }
+
+  /* Do not wait forever for a datagram dropped by the stack */
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = 100000;
+  psock_setsockopt(&sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = HTONS(LATENCY_NET_PORT);
+  addr.sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+
+  ret = psock_bind(&sock, (FAR struct sockaddr *)&addr, sizeof(addr));
+  if (ret < 0)
+    {
+      goto out_with_sock;
+    }
+
+  while (g_latency.loading)
+    {
+      psock_sendto(&sock, buffer, LATENCY_BLOCKSIZE, 0,
+                   (FAR struct sockaddr *)&addr, sizeof(addr));
+      psock_recvfrom(&sock, buffer, LATENCY_BLOCKSIZE, 0, NULL, NULL);
+    }
+
+out_with_sock:
+  psock_close(&sock);
+out_with_buffer:
+  kmm_free(buffer);
+out:
+  nxsem_post(&g_latency.done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: latency_file
+ *
+ * Description:
+ *   Load a file system with writes, syncs and reads of a file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_FILE
+static int latency_file(int argc, FAR char *argv[])
+{
+  struct file file;
+  FAR char *buffer;
+  int ret;
+  int i;
+
+  buffer = kmm_zalloc(LATENCY_BLOCKSIZE);
+  if (buffer == NULL)
+    {
+      goto out;
+    }
+
+  ret = file_open(&file, CONFIG_BENCHMARK_LATENCY_LOAD_PATH,
+                  O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (ret < 0)
+    {
+      goto out_with_buffer;
+    }
+
+  while (g_latency.loading && ret >= 0)
+    {
+      file_seek(&file, 0, SEEK_SET);
+      for (i = 0; i < LATENCY_FILEBLOCKS && ret >= 0; i++)
+        {
+          memset(buffer, i, LATENCY_BLOCKSIZE);
+          ret = file_write(&file, buffer, LATENCY_BLOCKSIZE);
+        }
+
+      file_fsync(&file);
+      file_seek(&file, 0, SEEK_SET);
+
+      for (i = 0; i < LATENCY_FILEBLOCKS && ret >= 0; i++)
+        {
+          ret = file_read(&file, buffer, LATENCY_BLOCKSIZE);
+        }
+    }
+
+  file_close(&file);
+  nx_unlink(CONFIG_BENCHMARK_LATENCY_LOAD_PATH);
+out_with_buffer:
+  kmm_free(buffer);
+out:
+  nxsem_post(&g_latency.done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: latency_load
+ *
+ * Description:
+ *   Start the load threads selected, return their number.
+ *
+ ****************************************************************************/
+
+static int latency_load(FAR struct latency_s *lat)
+{
+  static const struct
+  {
+    uint32_t       mask;
+    FAR const char *name;
+    main_t         entry;
+  }
+  loads[LATENCY_NLOADS] =
+  {
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_HEAP
+    { LATENCY_LOAD_HEAP, "latency_heap", latency_heap },
+#else
+    { 0, NULL, NULL },
+#endif
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_NET
+    { LATENCY_LOAD_NET, "latency_net", latency_net },
+#else
+    { 0, NULL, NULL },
+#endif
+#ifdef CONFIG_BENCHMARK_LATENCY_LOAD_FILE
+    { LATENCY_LOAD_FILE, "latency_file", latency_file },
+#else
+    { 0, NULL, NULL },
+#endif
+  };
+
+  int nloads = 0;
+  int i;
+
+  lat->loading = true;
+
+  for (i = 0; i < LATENCY_NLOADS; i++)
+    {
+      if ((lat->param.load & loads[i].mask) != 0 &&
+          kthread_create(loads[i].name,
+                         CONFIG_BENCHMARK_LATENCY_LOAD_PRIORITY,
+                         CONFIG_BENCHMARK_LATENCY_STACKSIZE,
+                         loads[i].entry, NULL) > 0)
+        {
+          nloads++;
+        }
+    }
+
+  return nloads;
+}
+
+/****************************************************************************
+ * Name: latency_report
+ *
+ * Description:
+ *   Format the report of a run.
+ *
+ ****************************************************************************/
+
+static void latency_report(FAR struct latency_s *lat)
+{
+  FAR struct latency_cpu_s *cpu;
+  FAR char *report = lat->report;
+  size_t len = LATENCY_REPORTLEN;
+  size_t pos;
+  int last = -1;
+  int i;
+  int j;
+
+  pos = snprintf(report, len,
+                 "# interval %" PRIu32 " loops %" PRIu32
+                 " priority %u load 0x%" PRIx32 "\n",
+                 lat->param.interval, lat->param.loops,
+                 lat->param.priority, lat->param.load);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      cpu = &lat->cpu[i];
+      pos += snprintf(report + pos, len - pos,
+                      "# cpu %d samples %" PRIu32 " min %" PRIu64
+                      " avg %" PRIu64 " max %" PRIu64 " overruns %"
+                      PRIu32 "\n#   wakeup %" PRIu64 "\n", i, cpu->samples,
+                      cpu->samples > 0 ? cpu->min : 0,
+                      cpu->samples > 0 ? cpu->total / cpu->samples : 0,
+                      cpu->max, cpu->overruns, cpu->wakeup);
+
+      for (j = LATENCY_NBUCKETS - 1; j > last; j--)
+        {
+          if (cpu->hist[j] != 0)
+            {
+              last = j;
+              break;
+            }
+        }
+    }
+
+  /* The buckets up to the last used one */
+
+  for (j = 0; j <= last; j++)
+    {
+      pos += snprintf(report + pos, len - pos, "%d", j);
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          pos += snprintf(report + pos, len - pos, " %" PRIu32,
+                          lat->cpu[i].hist[j]);
+        }
+
+      pos += snprintf(report + pos, len - pos, "\n");
+    }
+
+  pos += snprintf(report + pos, len - pos, "# overflow");
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      pos += snprintf(report + pos, len - pos, " %" PRIu32,
+                      lat->cpu[i].overflow);
+    }
+
+  pos += snprintf(report + pos, len - pos, "\n");
+  lat->reportlen = MIN(pos, len - 1);
+}
+
+/****************************************************************************
+ * Name: latency_run
+ ****************************************************************************/
+
+static int latency_run(FAR struct latency_s *lat)
+{
+  FAR struct latency_cpu_s *cpu;
+  char arg[2 + 2 * sizeof(uintptr_t) + 1];
+  FAR char *argv[2];
+  int nthreads = 0;
+  int nloads;
+  int ret = OK;
+  int i;
+
+  if (lat->report == NULL)
+    {
+      lat->report = kmm_malloc(LATENCY_REPORTLEN);
+      if (lat->report == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  lat->reportlen = 0;
+
+  /* The loads run first, so the wakeups are measured under load */
+
+  nloads = latency_load(lat);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      cpu = &lat->cpu[i];
+      memset(&cpu->samples, 0,
+             sizeof(*cpu) - offsetof(struct latency_cpu_s, samples));
+
+      cpu->lat   = lat;
+      cpu->index = i;
+      cpu->min   = UINT64_MAX;
+      nxsem_init(&cpu->sem, 0, 0);
+#ifdef CONFIG_HRTIMER
+      hrtimer_initialize(&cpu->timer);
+#endif
+
+      snprintf(arg, sizeof(arg), "%p", cpu);
+      argv[0] = arg;
+      argv[1] = NULL;
+
+      ret = kthread_create("latency", lat->param.priority,
+                           CONFIG_BENCHMARK_LATENCY_STACKSIZE,
+                           latency_thread, argv);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nthreads++;
+    }
+
+  /* Wait for the measures, then for the loads to stop */
+
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_wait_uninterruptible(&lat->done);
+    }
+
+  lat->loading = false;
+  for (i = 0; i < nloads; i++)
+    {
+      nxsem_wait_uninterruptible(&lat->done);
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      nxsem_destroy(&lat->cpu[i].sem);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  latency_report(lat);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: latency_read
+ ****************************************************************************/
+
+static ssize_t latency_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct latency_s *lat = filep->f_inode->i_private;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&lat->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Reading from the start runs the benchmark */
+
+  if (filep->f_pos == 0)
+    {
+      ret = latency_run(lat);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  ret = 0;
+  if (filep->f_pos < lat->reportlen)
+    {
+      ret = MIN(buflen, lat->reportlen - filep->f_pos);
+      memcpy(buffer, lat->report + filep->f_pos, ret);
+      filep->f_pos += ret;
+    }
+
+out:
+  nxmutex_unlock(&lat->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: latency_ioctl
+ ****************************************************************************/
+
+static int latency_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct latency_s *lat = filep->f_inode->i_private;
+  FAR struct latency_param_s *param =
+    (FAR struct latency_param_s *)(uintptr_t)arg;
+  int ret;
+
+  if (param == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&lat->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case LATENCYIOC_GETPARAM:
+        *param = lat->param;
+        break;
+
+      case LATENCYIOC_SETPARAM:
+        if (param->interval == 0 || param->loops == 0 ||
+            param->priority < SCHED_PRIORITY_MIN ||
+            param->priority > SCHED_PRIORITY_MAX)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        lat->param = *param;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&lat->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_register
+ *
+ * Description:
+ *   Register the scheduling latency benchmark as /dev/latency.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int latency_register(void)
+{
+  return register_driver("/dev/latency", &g_latency_fops, 0444,
+                         &g_latency);
+}
@@ -0,0 +1,1356 @@
+/****************************************************************************
+ * drivers/benchmark/microbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Micro-benchmarks of the kernel primitives:  each one is sampled "loops"
+ * times with up_perf_gettime() and reported as its minimum, average and
+ * maximum cost.  The benchmark thread and its helpers all run on the
+ * first CPU, so the context switches are measured without interprocessor
+ * interrupts.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/benchmark/microbench.h>
+
+#ifndef CONFIG_DISABLE_MQUEUE
+#  include <nuttx/mqueue.h>
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+#  include <sys/socket.h>
+#  include <nuttx/net/net.h>
+#endif
+
+#if defined(CONFIG_BENCHMARK_MICRO_UART) && defined(CONFIG_SERIAL_TERMIOS)
+#  include <termios.h>
+#endif
+
+#ifdef CONFIG_BENCHMARK_MICRO_BLOCK
+#  include <sys/mount.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+#  define MICROBENCH_HAVE_PIPE
+#endif
+
+#if defined(CONFIG_MM_TLSF_MANAGER)
+#  define MICROBENCH_HEAP     "tlsf"
+#elif defined(CONFIG_MM_CUSTOMIZE_MANAGER)
+#  define MICROBENCH_HEAP     "custom"
+#else
+#  define MICROBENCH_HEAP     "default"
+#endif
+
+#define MICROBENCH_MSGSIZE    16
+#define MICROBENCH_POOLBLOCK  64
+#define MICROBENCH_LINELEN    80
+
+/* The arg of the block device benchmarks is the bytes of one read, a
+ * multiple of the sector size, or'ed with this bit for random offsets.
+ */
+
+#define MICROBENCH_BLK_RANDOM 1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct microbench_stat_s
+{
+  uint32_t      samples;
+  unsigned long min;
+  unsigned long max;
+  uint64_t      total;
+};
+
+struct microbench_s;
+
+/* A benchmark measures one or two costs, stat[0] and stat[1] */
+
+typedef CODE int (*microbench_t)(FAR struct microbench_s *mb,
+                                 uintptr_t arg,
+                                 FAR struct microbench_stat_s *stat);
+
+struct microbench_entry_s
+{
+  FAR const char *name[2];
+  microbench_t    bench;
+  uintptr_t       arg;
+};
+
+struct microbench_s
+{
+  mutex_t       lock;                  /* One run at a time */
+  struct microbench_param_s param;
+  sem_t         done;                  /* Posted by the exiting threads */
+
+  FAR char     *report;                /* The report of the last run */
+  size_t        reportlen;
+
+  /* Shared with the helper threads of one benchmark */
+
+  sem_t         ping;
+  sem_t         pong;
+  mutex_t       mutex;
+  volatile bool stop;
+  volatile unsigned long stamp;
+  FAR struct microbench_stat_s *stat;
+#ifdef MICROBENCH_HAVE_PIPE
+  FAR struct file *pipe[4];            /* To the helper, from the helper */
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct socket *sock;             /* The end of the helper */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     microbench_null(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+static int     microbench_ctxsw(FAR struct microbench_s *mb, uintptr_t arg,
+                                FAR struct microbench_stat_s *stat);
+static int     microbench_wake(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+static int     microbench_mutex(FAR struct microbench_s *mb, uintptr_t arg,
+                                FAR struct microbench_stat_s *stat);
+static int     microbench_contend(FAR struct microbench_s *mb,
+                                  uintptr_t arg,
+                                  FAR struct microbench_stat_s *stat);
+#ifndef CONFIG_DISABLE_MQUEUE
+static int     microbench_mq(FAR struct microbench_s *mb, uintptr_t arg,
+                             FAR struct microbench_stat_s *stat);
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+static int     microbench_work(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+#endif
+static int     microbench_wdog(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+static int     microbench_malloc(FAR struct microbench_s *mb, uintptr_t arg,
+                                 FAR struct microbench_stat_s *stat);
+static int     microbench_mempool(FAR struct microbench_s *mb,
+                                  uintptr_t arg,
+                                  FAR struct microbench_stat_s *stat);
+#ifdef CONFIG_MM_IOB
+static int     microbench_iob(FAR struct microbench_s *mb, uintptr_t arg,
+                              FAR struct microbench_stat_s *stat);
+#endif
+#ifdef MICROBENCH_HAVE_PIPE
+static int     microbench_pipe(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+static int     microbench_local(FAR struct microbench_s *mb, uintptr_t arg,
+                                FAR struct microbench_stat_s *stat);
+#endif
+#ifdef CONFIG_BENCHMARK_MICRO_UART
+static int     microbench_uart(FAR struct microbench_s *mb, uintptr_t arg,
+                               FAR struct microbench_stat_s *stat);
+#endif
+#ifdef CONFIG_BENCHMARK_MICRO_BLOCK
+static int     microbench_blk(FAR struct microbench_s *mb, uintptr_t arg,
+                              FAR struct microbench_stat_s *stat);
+#endif
+
+static ssize_t microbench_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     microbench_ioctl(FAR struct file *filep, int cmd,
+                                unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct microbench_entry_s g_microbench_entries[] =
+{
+  { { "null", NULL }, microbench_null, 0 },
+  { { "ctxsw", NULL }, microbench_ctxsw, 0 },
+  { { "sem_post_wake", NULL }, microbench_wake, 0 },
+  { { "mutex_lock", "mutex_unlock" }, microbench_mutex, 0 },
+  { { "mutex_lock_contended", NULL }, microbench_contend, 0 },
+#ifndef CONFIG_DISABLE_MQUEUE
+  { { "mq_send", "mq_receive" }, microbench_mq, 0 },
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+  { { "work_queue_dispatch", NULL }, microbench_work, 0 },
+#endif
+  { { "wd_start", "wd_cancel" }, microbench_wdog, 0 },
+  { { "kmm_malloc_16", "kmm_free_16" }, microbench_malloc, 16 },
+  { { "kmm_malloc_64", "kmm_free_64" }, microbench_malloc, 64 },
+  { { "kmm_malloc_256", "kmm_free_256" }, microbench_malloc, 256 },
+  { { "kmm_malloc_1024", "kmm_free_1024" }, microbench_malloc, 1024 },
+  { { "kmm_malloc_4096", "kmm_free_4096" }, microbench_malloc, 4096 },
+  { { "mempool_alloc", "mempool_free" }, microbench_mempool, 0 },
+#ifdef CONFIG_MM_IOB
+  { { "iob_alloc", "iob_free" }, microbench_iob, 0 },
+#endif
+#ifdef MICROBENCH_HAVE_PIPE
+  { { "pipe_roundtrip", NULL }, microbench_pipe, 0 },
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+  { { "local_roundtrip", NULL }, microbench_local, 0 },
+#endif
+#ifdef CONFIG_BENCHMARK_MICRO_UART
+  { { "uart_write_1", NULL }, microbench_uart, 1 },
+  { { "uart_write_256", NULL }, microbench_uart, 256 },
+#endif
+#ifdef CONFIG_BENCHMARK_MICRO_BLOCK
+  { { "blk_read_seq_4k", NULL }, microbench_blk, 4096 },
+  { { "blk_read_rand_4k", NULL }, microbench_blk,
+    4096 | MICROBENCH_BLK_RANDOM },
+  { { "blk_read_seq_64k", NULL }, microbench_blk, 65536 },
+#endif
+};
+
+static const struct file_operations g_microbench_fops =
+{
+  NULL,              /* open */
+  NULL,              /* close */
+  microbench_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* seek */
+  microbench_ioctl,  /* ioctl */
+};
+
+static struct microbench_s g_microbench =
+{
+  .lock  = NXMUTEX_INITIALIZER,
+  .done  = SEM_INITIALIZER(0),
+  .param =
+  {
+    CONFIG_BENCHMARK_MICRO_LOOPS,
+    CONFIG_BENCHMARK_MICRO_PRIORITY
+  },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: microbench_sample
+ ****************************************************************************/
+
+static void microbench_sample(FAR struct microbench_stat_s *stat,
+                              unsigned long start)
+{
+  unsigned long elapsed = up_perf_gettime() - start;
+
+  stat->samples++;
+  stat->total += elapsed;
+  stat->min    = MIN(stat->min, elapsed);
+  stat->max    = MAX(stat->max, elapsed);
+}
+
+/****************************************************************************
+ * Name: microbench_pin
+ *
+ * Description:
+ *   Move the calling thread to the first CPU.
+ *
+ ****************************************************************************/
+
+static void microbench_pin(void)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(0, &cpuset);
+  nxsched_set_affinity(nxsched_gettid(), sizeof(cpuset), &cpuset);
+#endif
+}
+
+/****************************************************************************
+ * Name: microbench_spawn and microbench_join
+ *
+ * Description:
+ *   Start a helper thread at a priority relative to the benchmark thread,
+ *   and wait for it to exit once told to stop.
+ *
+ ****************************************************************************/
+
+static int microbench_spawn(FAR struct microbench_s *mb, int delta,
+                            main_t entry)
+{
+  int ret;
+
+  mb->stop = false;
+  ret = kthread_create("microbench_helper", mb->param.priority + delta,
+                       CONFIG_BENCHMARK_MICRO_STACKSIZE, entry, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Let the helper move to the first CPU and block */
+
+  nxsig_usleep(USEC_PER_TICK);
+  return OK;
+}
+
+static void microbench_join(FAR struct microbench_s *mb)
+{
+  mb->stop = true;
+  nxsem_post(&mb->ping);
+  nxsem_wait_uninterruptible(&mb->done);
+}
+
+/****************************************************************************
+ * Name: microbench_null
+ *
+ * Description:
+ *   The cost of the measure itself.
+ *
+ ****************************************************************************/
+
+static int microbench_null(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+  uint32_t i;
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      microbench_sample(&stat[0], up_perf_gettime());
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_ctxsw
+ *
+ * Description:
+ *   A helper at the same priority answers each semaphore post with its
+ *   own, every sample is two context switches.
+ *
+ ****************************************************************************/
+
+static int microbench_pong(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+
+  microbench_pin();
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&mb->ping);
+      if (mb->stop)
+        {
+          break;
+        }
+
+      nxsem_post(&mb->pong);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+static int microbench_ctxsw(FAR struct microbench_s *mb, uintptr_t arg,
+                            FAR struct microbench_stat_s *stat)
+{
+  unsigned long start;
+  uint32_t i;
+  int ret;
+
+  ret = microbench_spawn(mb, 0, microbench_pong);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      nxsem_post(&mb->ping);
+      nxsem_wait_uninterruptible(&mb->pong);
+      microbench_sample(&stat[0], start);
+    }
+
+  microbench_join(mb);
+
+  /* Report the cost of one switch */
+
+  stat[0].total /= 2;
+  stat[0].min   /= 2;
+  stat[0].max   /= 2;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_wake
+ *
+ * Description:
+ *   The time from nxsem_post() to a higher priority waiter running.
+ *
+ ****************************************************************************/
+
+static int microbench_waiter(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+
+  microbench_pin();
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&mb->ping);
+      if (mb->stop)
+        {
+          break;
+        }
+
+      microbench_sample(mb->stat, mb->stamp);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+static int microbench_wake(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+  uint32_t i;
+  int ret;
+
+  mb->stat = &stat[0];
+  ret = microbench_spawn(mb, 1, microbench_waiter);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      mb->stamp = up_perf_gettime();
+      nxsem_post(&mb->ping);
+    }
+
+  microbench_join(mb);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_mutex
+ ****************************************************************************/
+
+static int microbench_mutex(FAR struct microbench_s *mb, uintptr_t arg,
+                            FAR struct microbench_stat_s *stat)
+{
+  unsigned long start;
+  uint32_t i;
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      nxmutex_lock(&mb->mutex);
+      microbench_sample(&stat[0], start);
+
+      start = up_perf_gettime();
+      nxmutex_unlock(&mb->mutex);
+      microbench_sample(&stat[1], start);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_contend
+ *
+ * Description:
+ *   Lock a mutex held by a lower priority helper:  the helper inherits the
+ *   priority, releases the mutex and hands it over.
+ *
+ ****************************************************************************/
+
+static int microbench_holder(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+
+  microbench_pin();
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&mb->ping);
+      if (mb->stop)
+        {
+          break;
+        }
+
+      nxmutex_lock(&mb->mutex);
+      nxsem_post(&mb->pong);
+      nxmutex_unlock(&mb->mutex);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+static int microbench_contend(FAR struct microbench_s *mb, uintptr_t arg,
+                              FAR struct microbench_stat_s *stat)
+{
+  unsigned long start;
+  uint32_t i;
+  int ret;
+
+  ret = microbench_spawn(mb, -1, microbench_holder);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      nxsem_post(&mb->ping);
+      nxsem_wait_uninterruptible(&mb->pong);
+
+      start = up_perf_gettime();
+      nxmutex_lock(&mb->mutex);
+      microbench_sample(&stat[0], start);
+      nxmutex_unlock(&mb->mutex);
+    }
+
+  microbench_join(mb);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_mq
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static int microbench_mq(FAR struct microbench_s *mb, uintptr_t arg,
+                         FAR struct microbench_stat_s *stat)
+{
+  char msg[MICROBENCH_MSGSIZE];
+  struct mq_attr attr;
+  unsigned long start;
+  unsigned int prio;
+  struct file mq;
+  uint32_t i;
+  int ret;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = MICROBENCH_MSGSIZE;
+
+  ret = file_mq_open(&mq, "microbench", O_RDWR | O_CREAT, 0666, &attr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(msg, 0, sizeof(msg));
+
+  for (i = 0; i < mb->param.loops && ret >= 0; i++)
+    {
+      start = up_perf_gettime();
+      ret = file_mq_send(&mq, msg, sizeof(msg), 0);
+      microbench_sample(&stat[0], start);
+
+      if (ret >= 0)
+        {
+          start = up_perf_gettime();
+          ret = file_mq_receive(&mq, msg, sizeof(msg), &prio);
+          microbench_sample(&stat[1], start);
+        }
+    }
+
+  file_mq_close(&mq);
+  file_mq_unlink("microbench");
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_work
+ *
+ * Description:
+ *   The time from work_queue() to the worker running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void microbench_worker(FAR void *arg)
+{
+  FAR struct microbench_s *mb = arg;
+
+  microbench_sample(mb->stat, mb->stamp);
+  nxsem_post(&mb->pong);
+}
+
+static int microbench_work(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+  struct work_s work;
+  uint32_t i;
+  int ret = OK;
+
+  memset(&work, 0, sizeof(work));
+  mb->stat = &stat[0];
+
+  for (i = 0; i < mb->param.loops && ret >= 0; i++)
+    {
+      mb->stamp = up_perf_gettime();
+      ret = work_queue(HPWORK, &work, microbench_worker, mb, 0);
+      if (ret >= 0)
+        {
+          nxsem_wait_uninterruptible(&mb->pong);
+        }
+    }
+
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_wdog
+ ****************************************************************************/
+
+static void microbench_expire(wdparm_t arg)
+{
+}
+
+static int microbench_wdog(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+  struct wdog_s wdog;
+  unsigned long start;
+  uint32_t i;
+
+  memset(&wdog, 0, sizeof(wdog));
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      wd_start(&wdog, SEC2TICK(10), microbench_expire, 0);
+      microbench_sample(&stat[0], start);
+
+      start = up_perf_gettime();
+      wd_cancel(&wdog);
+      microbench_sample(&stat[1], start);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_malloc
+ ****************************************************************************/
+
+static int microbench_malloc(FAR struct microbench_s *mb, uintptr_t arg,
+                             FAR struct microbench_stat_s *stat)
+{
+  unsigned long start;
+  FAR void *mem;
+  uint32_t i;
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      mem = kmm_malloc(arg);
+      microbench_sample(&stat[0], start);
+
+      if (mem == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      start = up_perf_gettime();
+      kmm_free(mem);
+      microbench_sample(&stat[1], start);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: microbench_mempool
+ ****************************************************************************/
+
+static FAR void *microbench_pool_alloc(FAR struct mempool_s *pool,
+                                       size_t size)
+{
+  return kmm_malloc(size);
+}
+
+static void microbench_pool_free(FAR struct mempool_s *pool,
+                                 FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+static int microbench_mempool(FAR struct microbench_s *mb, uintptr_t arg,
+                              FAR struct microbench_stat_s *stat)
+{
+  struct mempool_s pool;
+  unsigned long start;
+  FAR void *blk;
+  uint32_t i;
+  int ret;
+
+  memset(&pool, 0, sizeof(pool));
+  pool.blocksize   = MICROBENCH_POOLBLOCK;
+  pool.initialsize = 16 * MICROBENCH_POOLBLOCK;
+  pool.alloc       = microbench_pool_alloc;
+  pool.free        = microbench_pool_free;
+
+  ret = mempool_init(&pool, "microbench");
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      blk = mempool_alloc(&pool);
+      microbench_sample(&stat[0], start);
+
+      if (blk == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      start = up_perf_gettime();
+      mempool_free(&pool, blk);
+      microbench_sample(&stat[1], start);
+    }
+
+  mempool_deinit(&pool);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: microbench_iob
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+static int microbench_iob(FAR struct microbench_s *mb, uintptr_t arg,
+                          FAR struct microbench_stat_s *stat)
+{
+  FAR struct iob_s *iob;
+  unsigned long start;
+  uint32_t i;
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      iob = iob_tryalloc(false);
+      microbench_sample(&stat[0], start);
+
+      if (iob == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      start = up_perf_gettime();
+      iob_free(iob);
+      microbench_sample(&stat[1], start);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_pipe
+ *
+ * Description:
+ *   A byte written to a helper at the same priority and read back through
+ *   a second pipe.
+ *
+ ****************************************************************************/
+
+#ifdef MICROBENCH_HAVE_PIPE
+static int microbench_pipe_echo(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+  char byte;
+
+  microbench_pin();
+
+  while (file_read(mb->pipe[0], &byte, 1) == 1 && !mb->stop)
+    {
+      file_write(mb->pipe[3], &byte, 1);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+static int microbench_pipe(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+  struct file files[4];
+  unsigned long start;
+  char byte = 0;
+  uint32_t i;
+  int ret;
+
+  for (i = 0; i < 4; i++)
+    {
+      mb->pipe[i] = &files[i];
+    }
+
+  ret = file_pipe(&mb->pipe[0], 1, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_pipe(&mb->pipe[2], 1, 0);
+  if (ret < 0)
+    {
+      goto out_with_pipe;
+    }
+
+  ret = microbench_spawn(mb, 0, microbench_pipe_echo);
+  if (ret < 0)
+    {
+      goto out_with_pipes;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      file_write(mb->pipe[1], &byte, 1);
+      file_read(mb->pipe[2], &byte, 1);
+      microbench_sample(&stat[0], start);
+    }
+
+  /* The helper is blocked in file_read() */
+
+  mb->stop = true;
+  file_write(mb->pipe[1], &byte, 1);
+  nxsem_wait_uninterruptible(&mb->done);
+
+out_with_pipes:
+  file_close(mb->pipe[2]);
+  file_close(mb->pipe[3]);
+out_with_pipe:
+  file_close(mb->pipe[0]);
+  file_close(mb->pipe[1]);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_local
+ *
+ * Description:
+ *   A byte sent to a helper at the same priority and received back through
+ *   a local stream socket pair.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+static int microbench_local_echo(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+  char byte;
+
+  microbench_pin();
+
+  while (psock_recv(mb->sock, &byte, 1, 0) == 1 && !mb->stop)
+    {
+      psock_send(mb->sock, &byte, 1, 0);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+static int microbench_local(FAR struct microbench_s *mb, uintptr_t arg,
+                            FAR struct microbench_stat_s *stat)
+{
+  struct socket socks[2];
+  FAR struct socket *psocks[2];
+  unsigned long start;
+  char byte = 0;
+  uint32_t i;
+  int ret;
+
+  memset(socks, 0, sizeof(socks));
+  psocks[0] = &socks[0];
+  psocks[1] = &socks[1];
+
+  ret = psock_socketpair(AF_LOCAL, SOCK_STREAM, 0, psocks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mb->sock = psocks[1];
+  ret = microbench_spawn(mb, 0, microbench_local_echo);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      psock_send(psocks[0], &byte, 1, 0);
+      psock_recv(psocks[0], &byte, 1, 0);
+      microbench_sample(&stat[0], start);
+    }
+
+  /* The helper is blocked in psock_recv() */
+
+  mb->stop = true;
+  psock_send(psocks[0], &byte, 1, 0);
+  nxsem_wait_uninterruptible(&mb->done);
+
+out:
+  psock_close(psocks[0]);
+  psock_close(psocks[1]);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_uart
+ *
+ * Description:
+ *   A write of arg bytes of binary data, without output processing, to the
+ *   serial port.  Once its TX buffer is full, this is the time the port
+ *   takes to send them, so the bytes per nsec give its throughput.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_MICRO_UART
+static int microbench_uart(FAR struct microbench_s *mb, uintptr_t arg,
+                           FAR struct microbench_stat_s *stat)
+{
+#ifdef CONFIG_SERIAL_TERMIOS
+  struct termios saved;
+  struct termios raw;
+#endif
+  struct file file;
+  unsigned long start;
+  FAR char *data;
+  uint32_t i;
+  int ret;
+
+  data = kmm_malloc(arg);
+  if (data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(data, 0x55, arg);
+  ret = file_open(&file, CONFIG_BENCHMARK_MICRO_UART_PATH, O_WRONLY);
+  if (ret < 0)
+    {
+      goto out_with_data;
+    }
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  ret = file_ioctl(&file, TCGETS, (unsigned long)(uintptr_t)&saved);
+  if (ret >= 0)
+    {
+      raw = saved;
+      raw.c_oflag &= ~OPOST;
+      file_ioctl(&file, TCSETS, (unsigned long)(uintptr_t)&raw);
+    }
+#endif
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      start = up_perf_gettime();
+      ret = file_write(&file, data, arg);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      microbench_sample(&stat[0], start);
+    }
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  file_ioctl(&file, TCSETS, (unsigned long)(uintptr_t)&saved);
+#endif
+
+  file_close(&file);
+out_with_data:
+  kmm_free(data);
+  return ret < 0 ? ret : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_blk
+ *
+ * Description:
+ *   A read straight from the block device, bypassing any cache, of the
+ *   sectors following the previous one or at a pseudo-random sector.  The
+ *   IOPS are 10^9 / avg and the throughput the bytes per nsec.  Only reads
+ *   are measured, so a card with a file system on it can be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_MICRO_BLOCK
+static int microbench_blk(FAR struct microbench_s *mb, uintptr_t arg,
+                          FAR struct microbench_stat_s *stat)
+{
+  FAR struct inode *inode;
+  struct geometry geo;
+  unsigned long start;
+  FAR uint8_t *data;
+  blkcnt_t nsectors;
+  blkcnt_t sector = 0;
+  uint32_t seed = 1;
+  size_t size = arg & ~MICROBENCH_BLK_RANDOM;
+  uint32_t i;
+  ssize_t nread;
+  int ret;
+
+  ret = open_blockdriver(CONFIG_BENCHMARK_MICRO_BLOCK_PATH, MS_RDONLY,
+                         &inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto out_with_inode;
+    }
+
+  nsectors = size / geo.geo_sectorsize;
+  if (!geo.geo_available || nsectors == 0 ||
+      nsectors > geo.geo_nsectors)
+    {
+      ret = -ENODEV;
+      goto out_with_inode;
+    }
+
+  data = kmm_malloc(size);
+  if (data == NULL)
+    {
+      ret = -ENOMEM;
+      goto out_with_inode;
+    }
+
+  for (i = 0; i < mb->param.loops; i++)
+    {
+      if ((arg & MICROBENCH_BLK_RANDOM) != 0)
+        {
+          seed   = seed * 1103515245 + 12345;
+          sector = ((blkcnt_t)seed % (geo.geo_nsectors / nsectors)) *
+                   nsectors;
+        }
+      else if (sector + nsectors > geo.geo_nsectors)
+        {
+          sector = 0;
+        }
+
+      start = up_perf_gettime();
+      nread = inode->u.i_bops->read(inode, data, sector, nsectors);
+      if (nread < 0)
+        {
+          ret = nread;
+          break;
+        }
+
+      microbench_sample(&stat[0], start);
+      sector += nsectors;
+    }
+
+  kmm_free(data);
+out_with_inode:
+  close_blockdriver(inode);
+  return ret < 0 ? ret : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: microbench_report
+ *
+ * Description:
+ *   Append the lines of one benchmark to the report.
+ *
+ ****************************************************************************/
+
+static void microbench_report(FAR struct microbench_s *mb,
+                              FAR const struct microbench_entry_s *entry,
+                              FAR struct microbench_stat_s *stat, int ret)
+{
+  FAR char *line;
+  size_t len;
+  int i;
+
+  for (i = 0; i < 2 && entry->name[i] != NULL; i++)
+    {
+      line = mb->report + mb->reportlen;
+      len  = MICROBENCH_LINELEN;
+
+      if (ret < 0)
+        {
+          snprintf(line, len, "# %s error %d\n", entry->name[i], -ret);
+        }
+      else
+        {
+          snprintf(line, len, "%s %" PRIu32 " %lu %" PRIu64 " %lu\n",
+                   entry->name[i], stat[i].samples,
+                   stat[i].samples > 0 ? stat[i].min : 0,
+                   stat[i].samples > 0 ?
+                   stat[i].total / stat[i].samples : 0,
+                   stat[i].max);
+        }
+
+      mb->reportlen += strlen(line);
+    }
+}
+
+/****************************************************************************
+ * Name: microbench_thread
+ *
+ * Description:
+ *   The benchmark thread, on the first CPU.
+ *
+ ****************************************************************************/
+
+static int microbench_thread(int argc, FAR char *argv[])
+{
+  FAR struct microbench_s *mb = &g_microbench;
+  struct microbench_stat_s stat[2];
+  int ret;
+  int i;
+
+  microbench_pin();
+
+  mb->reportlen = snprintf(mb->report, MICROBENCH_LINELEN,
+                           "# freq %lu loops %" PRIu32 " priority %u"
+                           " heap %s\n", up_perf_getfreq(),
+                           mb->param.loops, mb->param.priority,
+                           MICROBENCH_HEAP);
+
+  for (i = 0; i < nitems(g_microbench_entries); i++)
+    {
+      memset(stat, 0, sizeof(stat));
+      stat[0].min = ULONG_MAX;
+      stat[1].min = ULONG_MAX;
+
+      ret = g_microbench_entries[i].bench(mb, g_microbench_entries[i].arg,
+                                          stat);
+      microbench_report(mb, &g_microbench_entries[i], stat, ret);
+    }
+
+  nxsem_post(&mb->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: microbench_run
+ ****************************************************************************/
+
+static int microbench_run(FAR struct microbench_s *mb)
+{
+  int ret;
+
+  if (mb->report == NULL)
+    {
+      mb->report = kmm_malloc(MICROBENCH_LINELEN *
+                              (2 * nitems(g_microbench_entries) + 1));
+      if (mb->report == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  mb->reportlen = 0;
+
+  nxsem_init(&mb->ping, 0, 0);
+  nxsem_init(&mb->pong, 0, 0);
+  nxmutex_init(&mb->mutex);
+
+  ret = kthread_create("microbench", mb->param.priority,
+                       CONFIG_BENCHMARK_MICRO_STACKSIZE,
+                       microbench_thread, NULL);
+  if (ret > 0)
+    {
+      nxsem_wait_uninterruptible(&mb->done);
+      ret = OK;
+    }
+
+  nxmutex_destroy(&mb->mutex);
+  nxsem_destroy(&mb->pong);
+  nxsem_destroy(&mb->ping);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: microbench_read
+ ****************************************************************************/
+
+static ssize_t microbench_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct microbench_s *mb = filep->f_inode->i_private;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&mb->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Reading from the start runs the benchmarks */
+
+  if (filep->f_pos == 0)
+    {
+      ret = microbench_run(mb);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  ret = 0;
+  if (filep->f_pos < mb->reportlen)
+    {
+      ret = MIN(buflen, mb->reportlen - filep->f_pos);
+      memcpy(buffer, mb->report + filep->f_pos, ret);
+      filep->f_pos += ret;
+    }
+
+out:
+  nxmutex_unlock(&mb->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: microbench_ioctl
+ ****************************************************************************/
+
+static int microbench_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct microbench_s *mb = filep->f_inode->i_private;
+  FAR struct microbench_param_s *param =
+    (FAR struct microbench_param_s *)(uintptr_t)arg;
+  int ret;
+
+  if (param == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&mb->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case MICROBENCHIOC_GETPARAM:
+        *param = mb->param;
+        break;
+
+      case MICROBENCHIOC_SETPARAM:
+
+        /* The helpers run one priority above and below */
+
+        if (param->loops == 0 ||
+            param->priority <= SCHED_PRIORITY_MIN ||
+            param->priority >= SCHED_PRIORITY_MAX)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        mb->param = *param;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&mb->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: microbench_register
+ *
+ * Description:
+ *   Register the kernel micro-benchmarks as /dev/microbench.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int microbench_register(void)
+{
+  return register_driver("/dev/microbench", &g_microbench_fops, 0444,
+                         &g_microbench);
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * drivers/dma/dma_coherent.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/dma/dma_map.h>
+
+#ifdef CONFIG_DMA_COHERENT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The heap in the region given to dma_coherent_initialize() */
+
+static FAR struct mm_heap_s *g_dma_coherent_heap;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_coherent_initialize
+ *
+ * Description:
+ *   Give dma_alloc_coherent() a region of memory that the CPU does not
+ *   cache.
+ *
+ ****************************************************************************/
+
+int dma_coherent_initialize(FAR void *start, size_t size)
+{
+  if (g_dma_coherent_heap != NULL)
+    {
+      return -EBUSY;
+    }
+
+  g_dma_coherent_heap = mm_initialize("dma", start, size);
+  return g_dma_coherent_heap != NULL ? OK : -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: dma_alloc_coherent
+ *
+ * Description:
+ *   Allocate memory that needs no cache maintenance for DMA.  With a data
+ *   cache that is only memory from dma_coherent_initialize().
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc_coherent(size_t size)
+{
+  size_t align = up_get_dcache_linesize();
+
+  if (g_dma_coherent_heap != NULL)
+    {
+      return mm_memalign(g_dma_coherent_heap,
+                         align > sizeof(uintptr_t) ?
+                         align : sizeof(uintptr_t), size);
+    }
+
+  return align == 0 ? kmm_malloc(size) : NULL;
+}
+
+/****************************************************************************
+ * Name: dma_free_coherent
+ ****************************************************************************/
+
+void dma_free_coherent(FAR void *mem)
+{
+  if (g_dma_coherent_heap != NULL &&
+      mm_heapmember(g_dma_coherent_heap, mem))
+    {
+      mm_free(g_dma_coherent_heap, mem);
+    }
+  else
+    {
+      kmm_free(mem);
+    }
+}
+
+#endif /* CONFIG_DMA_COHERENT */
@@ -0,0 +1,210 @@
+/****************************************************************************
+ * drivers/dma/dma_memcpy.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/dma/dma.h>
+
+#ifdef CONFIG_DMA_MEMCPY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dma_memcpy_s
+{
+  mutex_t lock;                     /* One copy at a time */
+  sem_t   done;                     /* Posted by the callback */
+  FAR struct dma_chan_s *chan;      /* The registered channel */
+  ssize_t result;                   /* Reported by the callback */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dma_memcpy_s g_dma_memcpy =
+{
+  NXMUTEX_INITIALIZER,
+  SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_callback
+ ****************************************************************************/
+
+static void dma_memcpy_callback(FAR struct dma_chan_s *chan,
+                                FAR void *arg, ssize_t len)
+{
+  FAR struct dma_memcpy_s *priv = arg;
+
+  priv->result = len;
+  nxsem_post(&priv->done);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ *
+ * Description:
+ *   Configure a channel for memory to memory transfers and hand it to
+ *   dma_memcpy(), usually at board bring-up.  The channel stays in use
+ *   until NULL is registered instead.
+ *
+ * Input Parameters:
+ *   chan - A channel from DMA_GET_CHAN(), or NULL
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the channel can't do memory
+ *   to memory transfers.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_chan_s *chan)
+{
+  struct dma_config_s cfg;
+  int ret = OK;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.direction = DMA_MEM_TO_MEM;
+
+  nxmutex_lock(&g_dma_memcpy.lock);
+
+  if (chan != NULL)
+    {
+      ret = DMA_CONFIG(chan, &cfg);
+    }
+
+  if (ret >= 0)
+    {
+      g_dma_memcpy.chan = chan;
+    }
+
+  nxmutex_unlock(&g_dma_memcpy.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Same as memcpy(), but copies of at least CONFIG_DMA_MEMCPY_THRESHOLD
+ *   bytes are made by the registered channel while the caller waits.  The
+ *   cache lines only partly covered by dst are copied by the CPU during
+ *   the transfer.  From interrupt handlers, the idle task, or while the
+ *   channel is busy the copy falls back to memcpy().
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len)
+{
+  FAR struct dma_memcpy_s *priv = &g_dma_memcpy;
+  size_t linesize;
+  uintptr_t start;
+  uintptr_t end;
+  size_t head;
+  int ret;
+
+  if (len < CONFIG_DMA_MEMCPY_THRESHOLD || priv->chan == NULL ||
+      up_interrupt_context() || sched_idletask() ||
+      nxmutex_trylock(&priv->lock) < 0)
+    {
+      return memcpy(dst, src, len);
+    }
+
+  /* Only the whole cache lines of dst go to the DMA:  invalidating the
+   * others would discard what the CPU writes next to dst meanwhile.
+   */
+
+  start    = (uintptr_t)dst;
+  end      = start + len;
+  linesize = up_get_dcache_linesize();
+  if (linesize > 0)
+    {
+      start = (start + linesize - 1) & ~(linesize - 1);
+      end   = end & ~(linesize - 1);
+    }
+
+  if (priv->chan == NULL || end <= start)
+    {
+      nxmutex_unlock(&priv->lock);
+      return memcpy(dst, src, len);
+    }
+
+  head = start - (uintptr_t)dst;
+  up_clean_dcache((uintptr_t)src + head, (uintptr_t)src + head +
+                  (end - start));
+  up_invalidate_dcache(start, end);
+
+  ret = DMA_START(priv->chan, dma_memcpy_callback, priv, start,
+                  (uintptr_t)src + head, end - start);
+  if (ret < 0)
+    {
+      dmaerr("ERROR: DMA_START failed: %d\n", ret);
+      nxmutex_unlock(&priv->lock);
+      return memcpy(dst, src, len);
+    }
+
+  /* Copy the partial lines at both ends while the DMA runs */
+
+  memcpy(dst, src, head);
+  memcpy((FAR uint8_t *)end, (FAR const uint8_t *)src + (end -
+         (uintptr_t)dst), (uintptr_t)dst + len - end);
+
+  nxsem_wait_uninterruptible(&priv->done);
+
+  /* Drop the lines the CPU may have fetched speculatively during the
+   * transfer.
+   */
+
+  up_invalidate_dcache(start, end);
+
+  if (priv->result < 0)
+    {
+      dmaerr("ERROR: DMA transfer failed: %zd\n", priv->result);
+      memcpy((FAR void *)start, (FAR const uint8_t *)src + head,
+             end - start);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return dst;
+}
+
+#endif /* CONFIG_DMA_MEMCPY */
@@ -22,15 +22,19 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/benchmark/latency.h>
+#include <nuttx/benchmark/microbench.h>
 #include <nuttx/clk/clk_provider.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/drivers/profile.h>
 #include <nuttx/drivers/rpmsgdev.h>
 #include <nuttx/drivers/rpmsgblk.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/fs/smart.h>
 #include <nuttx/fs/loopmtd.h>
 #include <nuttx/input/uinput.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/net/loopback.h>
 #include <nuttx/net/tun.h>
@@ -83,6 +87,18 @@ void drivers_initialize(void)
   devzero_register();   /* Standard /dev/zero */
 #endif
 
+#if defined(CONFIG_DEV_PROFILE) && !defined(CONFIG_DEV_PROFILE_TIMER)
+  profile_register();   /* Sampling profiler /dev/profile */
+#endif
+
+#if defined(CONFIG_BENCHMARK_LATENCY)
+  latency_register();   /* Scheduling latency benchmark /dev/latency */
+#endif
+
+#if defined(CONFIG_BENCHMARK_MICRO)
+  microbench_register(); /* Kernel micro-benchmarks /dev/microbench */
+#endif
+
 #if defined(CONFIG_DEV_LOOP)
   loop_register();      /* Standard /dev/loop */
 #endif
@@ -91,6 +107,10 @@ void drivers_initialize(void)
   note_initialize();    /* Non-standard /dev/note */
 #endif
 
+#if defined(CONFIG_MM_PRESSURE_DEV)
+  mm_pressure_register(); /* Non-standard /dev/mempressure */
+#endif
+
 #if defined(CONFIG_CLK_RPMSG)
   clk_rpmsg_server_initialize();
 #endif
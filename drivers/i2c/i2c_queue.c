@@ -0,0 +1,438 @@
+/****************************************************************************
+ * drivers/i2c/i2c_queue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct i2c_queue_s
+{
+  FAR struct i2c_queue_s *flink;   /* Next queue in g_i2c_queues */
+  FAR struct i2c_master_s *dev;    /* The bus served by this queue */
+  int       crefs;                 /* i2c_queue_initialize() references */
+  mutex_t   lock;                  /* Protects pending */
+  sem_t     sem;                   /* Posted for each queued transfer */
+  sem_t     exit;                  /* Posted by the exiting thread */
+  sq_queue_t pending;              /* In the order they were queued */
+  bool      stop;                  /* true: The thread shall exit */
+#if CONFIG_I2C_QUEUE_NMSGS > 0
+  struct i2c_msg_s msgv[CONFIG_I2C_QUEUE_NMSGS]; /* A combined transfer */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_i2c_queuelock = NXMUTEX_INITIALIZER;
+static FAR struct i2c_queue_s *g_i2c_queues;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_address
+ *
+ * Description:
+ *   Return the address of all the messages of a transfer, or -1 if they
+ *   are not all to the same one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_I2C_QUEUE_NMSGS > 0
+static int i2c_queue_address(FAR struct i2c_request_s *req)
+{
+  int i;
+
+  for (i = 1; i < req->msgc; i++)
+    {
+      if (req->msgv[i].addr != req->msgv[0].addr)
+        {
+          return -1;
+        }
+    }
+
+  return req->msgv[0].addr;
+}
+#endif
+
+/****************************************************************************
+ * Name: i2c_queue_next
+ *
+ * Description:
+ *   Remove the oldest transfer and, with CONFIG_I2C_QUEUE_NMSGS, the ones
+ *   to the same address that follow it, as long as their messages fit in
+ *   one combined transfer.
+ *
+ * Returned Value:
+ *   The number of transfers moved to batch.
+ *
+ ****************************************************************************/
+
+static int i2c_queue_next(FAR struct i2c_queue_s *queue,
+                          FAR sq_queue_t *batch)
+{
+  FAR struct i2c_request_s *req;
+  int nreqs = 0;
+#if CONFIG_I2C_QUEUE_NMSGS > 0
+  int nmsgs = 0;
+  int addr = -1;
+#endif
+
+  nxmutex_lock(&queue->lock);
+
+  while ((req = (FAR struct i2c_request_s *)
+                sq_peek(&queue->pending)) != NULL)
+    {
+#if CONFIG_I2C_QUEUE_NMSGS > 0
+      if (nreqs > 0 &&
+          (addr < 0 || i2c_queue_address(req) != addr ||
+           nmsgs + req->msgc > CONFIG_I2C_QUEUE_NMSGS))
+        {
+          break;
+        }
+
+      if (nreqs == 0)
+        {
+          addr = i2c_queue_address(req);
+        }
+
+      nmsgs += req->msgc;
+#endif
+
+      sq_remfirst(&queue->pending);
+      sq_addlast(&req->node, batch);
+      nreqs++;
+
+#if CONFIG_I2C_QUEUE_NMSGS == 0
+      break;
+#endif
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return nreqs;
+}
+
+/****************************************************************************
+ * Name: i2c_queue_thread
+ *
+ * Description:
+ *   Perform the queued transfers with I2C_TRANSFER() of the lower half.
+ *
+ ****************************************************************************/
+
+static int i2c_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct i2c_queue_s *queue =
+    (FAR struct i2c_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct i2c_request_s *req;
+  sq_queue_t batch;
+  int nreqs;
+  int ret;
+
+  sq_init(&batch);
+
+  while (nxsem_wait_uninterruptible(&queue->sem) == OK && !queue->stop)
+    {
+      nreqs = i2c_queue_next(queue, &batch);
+      if (nreqs == 0)
+        {
+          /* Already served by a combined transfer */
+
+          continue;
+        }
+
+      req = (FAR struct i2c_request_s *)sq_peek(&batch);
+
+#if CONFIG_I2C_QUEUE_NMSGS > 0
+      if (nreqs > 1)
+        {
+          FAR sq_entry_t *node;
+          int nmsgs = 0;
+
+          sq_for_every(&batch, node)
+            {
+              req = (FAR struct i2c_request_s *)node;
+              memcpy(&queue->msgv[nmsgs], req->msgv,
+                     req->msgc * sizeof(struct i2c_msg_s));
+              nmsgs += req->msgc;
+            }
+
+          ret = I2C_TRANSFER(queue->dev, queue->msgv, nmsgs);
+        }
+      else
+#endif
+        {
+          ret = I2C_TRANSFER(queue->dev, req->msgv, req->msgc);
+        }
+
+      while ((req = (FAR struct i2c_request_s *)sq_remfirst(&batch)) !=
+             NULL)
+        {
+          req->complete(req, ret);
+        }
+    }
+
+  nxsem_post(&queue->exit);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Return the transfer queue of an I2C bus, starting its thread the first
+ *   time.  Every driver on the bus gets the same queue, which is released
+ *   by i2c_queue_uninitialize().  The thread performs the transfers with
+ *   I2C_TRANSFER(), so any lower half can be used.
+ *
+ * Input Parameters:
+ *   dev - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(dev != NULL);
+
+  nxmutex_lock(&g_i2c_queuelock);
+
+  for (queue = g_i2c_queues; queue != NULL; queue = queue->flink)
+    {
+      if (queue->dev == dev)
+        {
+          queue->crefs++;
+          goto out;
+        }
+    }
+
+  queue = kmm_zalloc(sizeof(struct i2c_queue_s));
+  if (queue == NULL)
+    {
+      goto out;
+    }
+
+  queue->dev   = dev;
+  queue->crefs = 1;
+  nxmutex_init(&queue->lock);
+  nxsem_init(&queue->sem, 0, 0);
+  nxsem_init(&queue->exit, 0, 0);
+  sq_init(&queue->pending);
+
+  snprintf(arg1, sizeof(arg1), "%p", queue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("i2c_queue", CONFIG_I2C_QUEUE_PRIORITY,
+                       CONFIG_I2C_QUEUE_STACKSIZE, i2c_queue_thread, argv);
+  if (ret < 0)
+    {
+      i2cerr("ERROR: Failed to start the queue thread: %d\n", ret);
+      nxsem_destroy(&queue->exit);
+      nxsem_destroy(&queue->sem);
+      nxmutex_destroy(&queue->lock);
+      kmm_free(queue);
+      queue = NULL;
+      goto out;
+    }
+
+  queue->flink = g_i2c_queues;
+  g_i2c_queues = queue;
+
+out:
+  nxmutex_unlock(&g_i2c_queuelock);
+  return queue;
+}
+
+/****************************************************************************
+ * Name: i2c_queue_uninitialize
+ *
+ * Description:
+ *   Release a reference to the queue.  With the last one the thread stops
+ *   and the transfers still queued complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *
+ ****************************************************************************/
+
+void i2c_queue_uninitialize(FAR struct i2c_queue_s *queue)
+{
+  FAR struct i2c_queue_s **prev;
+  FAR struct i2c_request_s *req;
+
+  DEBUGASSERT(queue != NULL && queue->crefs > 0);
+
+  nxmutex_lock(&g_i2c_queuelock);
+  if (--queue->crefs > 0)
+    {
+      nxmutex_unlock(&g_i2c_queuelock);
+      return;
+    }
+
+  prev = &g_i2c_queues;
+  while (*prev != queue)
+    {
+      prev = &(*prev)->flink;
+    }
+
+  *prev = queue->flink;
+  nxmutex_unlock(&g_i2c_queuelock);
+
+  /* Stop the thread once it is done with its current transfer */
+
+  queue->stop = true;
+  nxsem_post(&queue->sem);
+  nxsem_wait_uninterruptible(&queue->exit);
+
+  while ((req = (FAR struct i2c_request_s *)
+                sq_remfirst(&queue->pending)) != NULL)
+    {
+      req->complete(req, -ECANCELED);
+    }
+
+  nxsem_destroy(&queue->exit);
+  nxsem_destroy(&queue->sem);
+  nxmutex_destroy(&queue->lock);
+  kmm_free(queue);
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return without waiting for it.  Transfers
+ *   are performed in the order they are queued.  Back to back transfers
+ *   to the same address are combined into one I2C_TRANSFER(), and then
+ *   all of them complete with its result.  The request and its messages
+ *   must stay valid until the complete callback is called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - Describes the messages and the callback
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_request_s *req)
+{
+  DEBUGASSERT(queue != NULL && req != NULL && req->complete != NULL);
+
+  if (req->msgv == NULL || req->msgc <= 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&queue->lock);
+  sq_addlast(&req->node, &queue->pending);
+  nxmutex_unlock(&queue->lock);
+
+  return nxsem_post(&queue->sem);
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a transfer that has not started yet.  Its complete callback is
+ *   not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request passed to i2c_transfer_async()
+ *
+ * Returned Value:
+ *   0: the transfer was removed, -EBUSY: it has started or is done
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_queue_s *queue,
+                        FAR struct i2c_request_s *req)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *node;
+  int ret = -EBUSY;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  nxmutex_lock(&queue->lock);
+
+  sq_for_every(&queue->pending, node)
+    {
+      if (node == &req->node)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&queue->pending);
+            }
+          else
+            {
+              sq_remafter(prev, &queue->pending);
+            }
+
+          ret = OK;
+          break;
+        }
+
+      prev = node;
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_QUEUE */
@@ -51,6 +51,10 @@ struct touch_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+  size_t             lastsize; /* Size of the newest sample queued */
+  bool               lastmove; /* The newest sample has only moves */
+  int                wakeup;  /* Move samples queued before a wakeup */
+  int                npending; /* Move samples queued since the wakeup */
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -99,6 +103,109 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: touch_ismove
+ *
+ * Description:
+ *   Return true if the sample only reports the movement of contacts, with
+ *   no contact established or lost.
+ *
+ ****************************************************************************/
+
+static bool touch_ismove(FAR const struct touch_sample_s *sample)
+{
+  int i;
+
+  for (i = 0; i < sample->npoints; i++)
+    {
+      if ((sample->point[i].flags & (TOUCH_DOWN | TOUCH_UP)) != 0 ||
+          (sample->point[i].flags & TOUCH_MOVE) == 0)
+        {
+          return false;
+        }
+    }
+
+  return sample->npoints > 0;
+}
+
+/****************************************************************************
+ * Name: touch_nextsize
+ *
+ * Description:
+ *   Return the size of the oldest sample in the buffer, or 0 if the buffer
+ *   does not start on a whole sample.
+ *
+ ****************************************************************************/
+
+static size_t touch_nextsize(FAR struct touch_openpriv_s *openpriv,
+                             uint8_t maxpoint)
+{
+  size_t size;
+  int npoints;
+
+  if (circbuf_peek(&openpriv->circbuf, &npoints, sizeof(npoints)) !=
+      sizeof(npoints) || npoints <= 0 || npoints > maxpoint)
+    {
+      return 0;
+    }
+
+  size = SIZEOF_TOUCH_SAMPLE_S(npoints);
+  return size <= circbuf_used(&openpriv->circbuf) ? size : 0;
+}
+
+/****************************************************************************
+ * Name: touch_queue
+ *
+ * Description:
+ *   Queue a sample for a reader.  When there is no room for it, a sample
+ *   that only moves the contacts replaces the newest one if that one only
+ *   moves them too; otherwise the oldest samples are dropped as a whole.
+ *   Either way the reader keeps every contact going down or up.
+ *
+ * Returned Value:
+ *   True if the sample was merged into the newest one.
+ *
+ ****************************************************************************/
+
+static bool touch_queue(FAR struct touch_openpriv_s *openpriv,
+                        FAR const struct touch_sample_s *sample,
+                        uint8_t maxpoint)
+{
+  FAR struct circbuf_s *circbuf = &openpriv->circbuf;
+  size_t size = SIZEOF_TOUCH_SAMPLE_S(sample->npoints);
+  bool move = touch_ismove(sample);
+  bool merged = false;
+  size_t dropsize;
+
+  if (circbuf_space(circbuf) < size && move && openpriv->lastmove &&
+      openpriv->lastsize == size && circbuf_used(circbuf) >= size)
+    {
+      /* The newest sample is still unread, write over it */
+
+      circbuf->head -= size;
+      merged = true;
+    }
+  else
+    {
+      while (circbuf_space(circbuf) < size)
+        {
+          dropsize = touch_nextsize(openpriv, maxpoint);
+          if (dropsize == 0)
+            {
+              circbuf_reset(circbuf);
+              break;
+            }
+
+          circbuf_skip(circbuf, dropsize);
+        }
+    }
+
+  circbuf_write(circbuf, sample, size);
+  openpriv->lastsize = size;
+  openpriv->lastmove = move;
+  return merged;
+}
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -135,6 +242,7 @@ static int touch_open(FAR struct file *filep)
 
   nxsem_init(&openpriv->waitsem, 0, 0);
   nxmutex_init(&openpriv->lock);
+  openpriv->wakeup = 1;
   list_add_tail(&upper->head, &openpriv->node);
 
   /* Save the buffer node pointer so that it can be used directly
@@ -200,6 +308,9 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
                           size_t len)
 {
   FAR struct touch_openpriv_s *openpriv = filep->f_priv;
+  FAR struct inode *inode             = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  size_t size;
   int ret;
 
   if (!buffer || !len)
@@ -237,7 +348,28 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = circbuf_read(&openpriv->circbuf, buffer, len);
+  /* Return as many whole samples as fit, so that a reader woken up for a
+   * batch gets it at once.  A buffer smaller than the next sample gets
+   * part of it, as it always did.
+   */
+
+  ret = 0;
+  while ((size = touch_nextsize(openpriv, upper->lower->maxpoint)) > 0 &&
+         ret + size <= len)
+    {
+      ret += circbuf_read(&openpriv->circbuf, buffer + ret, size);
+    }
+
+  if (ret == 0)
+    {
+      ret = circbuf_read(&openpriv->circbuf, buffer, len);
+    }
+
+  if (circbuf_is_empty(&openpriv->circbuf))
+    {
+      openpriv->npending = 0;
+      openpriv->lastmove = false;
+    }
 
 out:
   nxmutex_unlock(&openpriv->lock);
@@ -253,8 +385,27 @@ static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct inode             *inode = filep->f_inode;
   FAR struct touch_upperhalf_s *upper = inode->i_private;
   FAR struct touch_lowerhalf_s *lower = upper->lower;
+  FAR struct touch_openpriv_s  *openpriv = filep->f_priv;
   int ret;
 
+  if (cmd == TSIOC_SETWAKEUP)
+    {
+      if ((int)arg < 1)
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&openpriv->lock);
+      if (ret >= 0)
+        {
+          openpriv->wakeup   = (int)arg;
+          openpriv->npending = 0;
+          nxmutex_unlock(&openpriv->lock);
+        }
+
+      return ret;
+    }
+
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
@@ -333,6 +484,7 @@ void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample)
 {
   FAR struct touch_upperhalf_s *upper = priv;
   FAR struct touch_openpriv_s  *openpriv;
+  bool wakeup;
   int semcount;
 
   if (nxmutex_lock(&upper->lock) < 0)
@@ -342,8 +494,32 @@ void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct touch_openpriv_s, node)
     {
-      circbuf_overwrite(&openpriv->circbuf, sample,
-                        SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+      /* Contacts going down or up wake the reader at once, moves once
+       * enough of them are queued.
+       */
+
+      nxmutex_lock(&openpriv->lock);
+      if (touch_queue(openpriv, sample, upper->lower->maxpoint))
+        {
+          wakeup = false;
+        }
+      else if (!openpriv->lastmove ||
+               ++openpriv->npending >= openpriv->wakeup)
+        {
+          openpriv->npending = 0;
+          wakeup = true;
+        }
+      else
+        {
+          wakeup = false;
+        }
+
+      nxmutex_unlock(&openpriv->lock);
+
+      if (!wakeup)
+        {
+          continue;
+        }
 
       nxsem_get_value(&openpriv->waitsem, &semcount);
       if (semcount < 1)
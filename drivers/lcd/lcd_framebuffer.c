@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -33,6 +34,7 @@
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/lcd/lcd.h>
+#include <nuttx/mutex.h>
 #include <nuttx/video/fb.h>
 
 #ifdef CONFIG_LCD_FRAMEBUFFER
@@ -45,6 +47,26 @@
 
 #define VIDEO_PLANE 0
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+#  define LCDFB_TILE CONFIG_LCD_FRAMEBUFFER_TILESIZE
+
+#  if (LCDFB_TILE & 7) != 0
+#    error CONFIG_LCD_FRAMEBUFFER_TILESIZE must be a multiple of 8
+#  endif
+
+/* Access to the bit of tile (tx, ty) in the dirty map */
+
+#  define LCDFB_BIT(p,tx,ty)   ((ty) * (p)->xtiles + (tx))
+#  define LCDFB_ISDIRTY(p,tx,ty) \
+     (((p)->dirty[LCDFB_BIT(p,tx,ty) >> 3] & \
+       (1 << (LCDFB_BIT(p,tx,ty) & 7))) != 0)
+#  define LCDFB_SETDIRTY(p,tx,ty) \
+     ((p)->dirty[LCDFB_BIT(p,tx,ty) >> 3] |= 1 << (LCDFB_BIT(p,tx,ty) & 7))
+#  define LCDFB_CLRDIRTY(p,tx,ty) \
+     ((p)->dirty[LCDFB_BIT(p,tx,ty) >> 3] &= \
+      ~(1 << (LCDFB_BIT(p,tx,ty) & 7)))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +85,14 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  FAR uint8_t *shadow;              /* What the LCD displays */
+  FAR uint8_t *dirty;               /* One bit per tile to send */
+  fb_coord_t xtiles;                /* Number of tile columns */
+  fb_coord_t ytiles;                /* Number of tile rows */
+  bool resync;                      /* The LCD content is unknown */
+  mutex_t lock;                     /* Protects the shadow and the map */
+#endif
 };
 
 /****************************************************************************
@@ -151,6 +181,242 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: lcdfb_putarea
+ *
+ * Description:
+ *   Send a rectangle of the framebuffer to the LCD.
+ *
+ ****************************************************************************/
+
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+                         fb_coord_t startx, fb_coord_t endx,
+                         fb_coord_t starty, fb_coord_t endy)
+{
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  FAR uint8_t *run;
+  fb_coord_t width;
+  fb_coord_t row;
+  int ret;
+
+  /* Get the starting position in the framebuffer */
+
+  run  = priv->fbmem + starty * priv->stride;
+  run += (startx * pinfo->bpp + 7) >> 3;
+
+  if (pinfo->putarea != NULL)
+    {
+      /* Each Driver's callback function putarea may be optimized by checking
+       * if it is a full screen/full row mode or not.
+       * In case of full screen/row mode the memory layout of drivers memory
+       * and data provided to putarea function may be (or not, it depends of
+       * display and driver implementation) identical.
+       * Identical memory layout let us to use:
+       * - memcopy (if there is shadow buffer in driver implementation)
+       * - apply DMA channel to transfer data to driver memory.
+       */
+
+      ret = pinfo->putarea(pinfo->dev, starty, endy, startx, endx,
+                           run, priv->stride);
+      if (ret < 0)
+        {
+          lcderr("Failed to update area");
+          return ret;
+        }
+    }
+  else
+    {
+      width = endx - startx + 1;
+
+      for (row = starty; row <= endy; row++)
+        {
+          ret = pinfo->putrun(pinfo->dev, row, startx, run, width);
+          if (ret < 0)
+            {
+              lcderr("Failed to update row");
+              return ret;
+            }
+
+          run += priv->stride;
+        }
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+/****************************************************************************
+ * Name: lcdfb_tilechanged
+ *
+ * Description:
+ *   Compare a tile of the framebuffer with what the LCD displays, and bring
+ *   the copy of the LCD content up to date.
+ *
+ * Returned Value:
+ *   true if the tile needs to be sent to the LCD.
+ *
+ ****************************************************************************/
+
+static bool lcdfb_tilechanged(FAR struct lcdfb_dev_s *priv,
+                              fb_coord_t tx, fb_coord_t ty)
+{
+  fb_coord_t startx = tx * LCDFB_TILE;
+  fb_coord_t endx = MIN(startx + LCDFB_TILE, priv->xres);
+  fb_coord_t starty = ty * LCDFB_TILE;
+  fb_coord_t endy = MIN(starty + LCDFB_TILE, priv->yres);
+  size_t offset = (startx * priv->pinfo.bpp) >> 3;
+  size_t len = ((endx - startx) * priv->pinfo.bpp + 7) >> 3;
+  bool changed = false;
+  fb_coord_t row;
+
+  for (row = starty; row < endy; row++)
+    {
+      size_t pos = row * priv->stride + offset;
+
+      if (priv->resync ||
+          memcmp(priv->fbmem + pos, priv->shadow + pos, len) != 0)
+        {
+          memcpy(priv->shadow + pos, priv->fbmem + pos, len);
+          changed = true;
+        }
+    }
+
+  return changed;
+}
+
+/****************************************************************************
+ * Name: lcdfb_spandirty
+ *
+ * Description:
+ *   Return true if the tiles startx to endx of tile row ty are all dirty.
+ *
+ ****************************************************************************/
+
+static bool lcdfb_spandirty(FAR struct lcdfb_dev_s *priv, fb_coord_t startx,
+                            fb_coord_t endx, fb_coord_t ty)
+{
+  fb_coord_t tx;
+
+  for (tx = startx; tx <= endx; tx++)
+    {
+      if (!LCDFB_ISDIRTY(priv, tx, ty))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: lcdfb_putdirty
+ *
+ * Description:
+ *   Send the tiles of an area that changed since they were last sent.
+ *
+ ****************************************************************************/
+
+static int lcdfb_putdirty(FAR struct lcdfb_dev_s *priv,
+                          fb_coord_t startx, fb_coord_t endx,
+                          fb_coord_t starty, fb_coord_t endy)
+{
+  fb_coord_t tx0;
+  fb_coord_t tx1;
+  fb_coord_t ty0;
+  fb_coord_t ty1;
+  fb_coord_t rx;
+  fb_coord_t ry;
+  fb_coord_t tx;
+  fb_coord_t ty;
+  fb_coord_t x;
+  fb_coord_t y;
+  int ret = OK;
+
+  nxmutex_lock(&priv->lock);
+
+  /* After a failure, nothing is known of what the LCD displays */
+
+  if (priv->resync)
+    {
+      startx = 0;
+      endx   = priv->xres - 1;
+      starty = 0;
+      endy   = priv->yres - 1;
+    }
+
+  tx0 = startx / LCDFB_TILE;
+  tx1 = endx / LCDFB_TILE;
+  ty0 = starty / LCDFB_TILE;
+  ty1 = endy / LCDFB_TILE;
+
+  for (ty = ty0; ty <= ty1; ty++)
+    {
+      for (tx = tx0; tx <= tx1; tx++)
+        {
+          if (lcdfb_tilechanged(priv, tx, ty))
+            {
+              LCDFB_SETDIRTY(priv, tx, ty);
+            }
+        }
+    }
+
+  priv->resync = false;
+
+  /* Merge the dirty tiles into rectangles: extend each one to the right as
+   * far as the tiles are dirty, then down as far as the whole span is.
+   */
+
+  for (ty = ty0; ty <= ty1; ty++)
+    {
+      for (tx = tx0; tx <= tx1; tx++)
+        {
+          if (!LCDFB_ISDIRTY(priv, tx, ty))
+            {
+              continue;
+            }
+
+          rx = tx;
+          while (rx < tx1 && LCDFB_ISDIRTY(priv, rx + 1, ty))
+            {
+              rx++;
+            }
+
+          ry = ty;
+          while (ry < ty1 && lcdfb_spandirty(priv, tx, rx, ry + 1))
+            {
+              ry++;
+            }
+
+          for (y = ty; y <= ry; y++)
+            {
+              for (x = tx; x <= rx; x++)
+                {
+                  LCDFB_CLRDIRTY(priv, x, y);
+                }
+            }
+
+          ret = lcdfb_putarea(priv, tx * LCDFB_TILE,
+                              MIN((rx + 1) * LCDFB_TILE, priv->xres) - 1,
+                              ty * LCDFB_TILE,
+                              MIN((ry + 1) * LCDFB_TILE, priv->yres) - 1);
+          if (ret < 0)
+            {
+              memset(priv->dirty, 0,
+                     (priv->xtiles * priv->ytiles + 7) >> 3);
+              priv->resync = true;
+              goto out;
+            }
+
+          tx = rx;
+        }
+    }
+
+out:
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: lcdfb_updateearea
  *
@@ -164,11 +430,8 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
 {
   FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
-  FAR uint8_t *run = priv->fbmem;
-  fb_coord_t row;
   fb_coord_t startx = 0;
   fb_coord_t endx = priv->xres - 1;
-  fb_coord_t width = priv->xres;
   fb_coord_t starty = 0;
   fb_coord_t endy = priv->yres - 1;
   int ret;
@@ -211,48 +474,16 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
           unsigned int pixperbyte = 8 / pinfo->bpp;
           startx &= ~(pixperbyte - 1);
         }
-
-      /* Get the starting position in the framebuffer */
-
-      run  = priv->fbmem + starty * priv->stride;
-      run += (startx * pinfo->bpp + 7) >> 3;
     }
 
-  if (pinfo->putarea != NULL)
-    {
-      /* Each Driver's callback function putarea may be optimized by checking
-       * if it is a full screen/full row mode or not.
-       * In case of full screen/row mode the memory layout of drivers memory
-       * and data provided to putarea function may be (or not, it depends of
-       * display and driver implementation) identical.
-       * Identical memory layout let us to use:
-       * - memcopy (if there is shadow buffer in driver implementation)
-       * - apply DMA channel to transfer data to driver memory.
-       */
-
-      ret = pinfo->putarea(pinfo->dev, starty, endy, startx, endx,
-                           run, priv->stride);
-      if (ret < 0)
-        {
-          lcderr("Failed to update area");
-          return ret;
-        }
-    }
-  else
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  ret = lcdfb_putdirty(priv, startx, endx, starty, endy);
+#else
+  ret = lcdfb_putarea(priv, startx, endx, starty, endy);
+#endif
+  if (ret < 0)
     {
-      width = endx - startx + 1;
-
-      for (row = starty; row <= endy; row++)
-        {
-          ret = pinfo->putrun(pinfo->dev, row, startx, run, width);
-          if (ret < 0)
-            {
-              lcderr("Failed to update row");
-              return ret;
-            }
-
-          run += priv->stride;
-        }
+      return ret;
     }
 
   if (pinfo->redraw != NULL)
@@ -616,6 +847,31 @@ int up_fbinitialize(int display)
       goto errout_with_lcd;
     }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+  /* Allocate the copy of the LCD content and the map of the tiles to send.
+   * The copy needs no clearing: the first update sends every tile.
+   */
+
+  priv->xtiles = (priv->xres + LCDFB_TILE - 1) / LCDFB_TILE;
+  priv->ytiles = (priv->yres + LCDFB_TILE - 1) / LCDFB_TILE;
+  priv->resync = true;
+
+  priv->shadow = (FAR uint8_t *)kmm_malloc(priv->fblen);
+  priv->dirty  = (FAR uint8_t *)
+    kmm_zalloc((priv->xtiles * priv->ytiles + 7) >> 3);
+  if (priv->shadow == NULL || priv->dirty == NULL)
+    {
+      lcderr("ERROR: Failed to allocate the dirty tracking memory\n");
+      kmm_free(priv->shadow);
+      kmm_free(priv->dirty);
+      kmm_free(priv->fbmem);
+      ret = -ENOMEM;
+      goto errout_with_lcd;
+    }
+
+  nxmutex_init(&priv->lock);
+#endif
+
   /* Add the state structure to the list of framebuffer interfaces */
 
   priv->flink = g_lcdfb;
@@ -738,6 +994,14 @@ void up_fbuninitialize(int display)
 
           kmm_free(priv->fbmem);
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DIRTY
+          /* Free the dirty tracking memory */
+
+          kmm_free(priv->shadow);
+          kmm_free(priv->dirty);
+          nxmutex_destroy(&priv->lock);
+#endif
+
           /* Free the state structure allocation */
 
           kmm_free(priv);
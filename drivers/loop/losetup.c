@@ -43,6 +43,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/mutex.h>
 
@@ -64,6 +65,7 @@ struct loop_struct_s
   uint16_t     sectsize;     /* The size of one sector */
   uint8_t      opencnt;      /* Count of open references to the loop device */
   bool         writeenabled; /* true: can write to device */
+  bool         mapped;       /* true: the data is directly accessible */
   struct file  devfile;      /* File struct of char device/file */
 };
 
@@ -80,6 +82,8 @@ static ssize_t loop_write(FAR struct inode *inode,
                           blkcnt_t start_sector, unsigned int nsectors);
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -92,6 +96,7 @@ static const struct block_operations g_bops =
   loop_read,     /* read */
   loop_write,    /* write */
   loop_geometry, /* geometry */
+  loop_ioctl,    /* ioctl */
 };
 
 /****************************************************************************
@@ -172,6 +177,39 @@ static int loop_close(FAR struct inode *inode)
   return ret;
 }
 
+/****************************************************************************
+ * Name: loop_mapping
+ *
+ * Description:
+ *   Return the address at which the data of the loop device is directly
+ *   accessible in memory:  that of the backing file if its file system
+ *   maps it (e.g. TMPFS or ROMFS on XIP media), or that of the backing
+ *   block driver if it supports BIOC_XIPBASE (e.g. a RAM disk).
+ *
+ ****************************************************************************/
+
+static int loop_mapping(FAR struct loop_struct_s *dev, FAR void **mapped)
+{
+  FAR uint8_t *base = NULL;
+  int ret;
+
+  ret = file_mmap_direct(&dev->devfile, dev->offset,
+                         (size_t)dev->nsectors * dev->sectsize, mapped);
+  if (ret != -ENOTTY)
+    {
+      return ret;
+    }
+
+  ret = file_ioctl(&dev->devfile, BIOC_XIPBASE, (unsigned long)&base);
+  if (ret < 0 || base == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  *mapped = base + dev->offset;
+  return OK;
+}
+
 /****************************************************************************
  * Name: loop_read
  *
@@ -196,6 +234,24 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
+  /* Copy the sectors straight from memory if the backing file is mapped.
+   * The mapping is looked up each time, as a memory-backed file may move
+   * when it is resized.
+   */
+
+  if (dev->mapped)
+    {
+      FAR void *mapped;
+
+      if (loop_mapping(dev, &mapped) >= 0)
+        {
+          memcpy(buffer, (FAR uint8_t *)mapped +
+                 start_sector * dev->sectsize,
+                 nsectors * dev->sectsize);
+          return nsectors;
+        }
+    }
+
   /* Calculate the offset to read the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -302,6 +358,31 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Return the memory address of the loop device data, so that ROMFS or
+ *   CROMFS images can be used in place.
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  if (cmd == BIOC_XIPBASE && ppv != NULL)
+    {
+      return dev->mapped ? loop_mapping(dev, ppv) : -ENOTTY;
+    }
+
+  return -ENOTTY;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -392,6 +473,17 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+  /* Use the data in place if it is memory-backed.  Not when writable:  a
+   * block driver backing the file may buffer the written sectors.
+   */
+
+  if (!dev->writeenabled)
+    {
+      FAR void *mapped;
+
+      dev->mapped = loop_mapping(dev, &mapped) >= 0;
+    }
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
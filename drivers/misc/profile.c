@@ -0,0 +1,560 @@
+/****************************************************************************
+ * drivers/misc/profile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/profile.h>
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+#  include <nuttx/timers/timer.h>
+#else
+#  include <nuttx/wdog.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_BACKTRACE) && CONFIG_DEV_PROFILE_DEPTH > 1
+#  define PROFILE_DEPTH     CONFIG_DEV_PROFILE_DEPTH
+#else
+#  define PROFILE_DEPTH     1
+#endif
+
+/* The number of frames of the interrupt handler that precede the
+ * interrupted context in a backtrace taken from the interrupt.
+ */
+
+#define PROFILE_IRQFRAMES   8
+
+/* "<cpu> <pid>" and " 0x<address>" per frame */
+
+#define PROFILE_LINELEN     (24 + (3 + 2 * sizeof(uintptr_t)) * PROFILE_DEPTH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct profile_sample_s
+{
+  pid_t     pid;                      /* The interrupted thread */
+  uint8_t   depth;                    /* The number of addresses */
+  uintptr_t pc[PROFILE_DEPTH];        /* Innermost first */
+};
+
+/* The samples of one CPU, taken by the CPU itself */
+
+struct profile_cpu_s
+{
+  unsigned int  head;                 /* The next sample to write */
+  unsigned int  tail;                 /* The next sample to read */
+  unsigned long lost;                 /* Samples lost since the last read */
+  struct profile_sample_s samples[CONFIG_DEV_PROFILE_NSAMPLES];
+};
+
+struct profile_s
+{
+#ifdef CONFIG_DEV_PROFILE_TIMER
+  FAR struct timer_lowerhalf_s *lower;
+#else
+  struct wdog_s     wdog;
+  clock_t           ticks;            /* The sample interval */
+#endif
+  volatile bool     running;
+  spinlock_t        lock;             /* Protects the sample buffers */
+  mutex_t           mutex;            /* Serializes start/stop and reads */
+
+  /* The line being read */
+
+  char              line[PROFILE_LINELEN];
+  size_t            linepos;
+  size_t            linelen;
+
+  struct profile_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+static int     profile_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_profile_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  profile_read,   /* read */
+  profile_write,  /* write */
+  NULL,           /* seek */
+  profile_ioctl,  /* ioctl */
+};
+
+static struct profile_s g_profile =
+{
+  .mutex = NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_backtrace
+ *
+ * Description:
+ *   Return the backtrace of the interrupted context, starting at 'pc'.
+ *
+ ****************************************************************************/
+
+#if PROFILE_DEPTH > 1
+static int profile_backtrace(uintptr_t pc, FAR uintptr_t *buffer)
+{
+  FAR void *frames[PROFILE_DEPTH + PROFILE_IRQFRAMES];
+  int nframes;
+  int depth;
+  int i;
+
+  buffer[0] = pc;
+  nframes = up_backtrace(NULL, frames, nitems(frames), 0);
+
+  /* The backtrace starts in this interrupt handler, skip the frames up to
+   * the interrupted one.  Keep the interrupted address alone if it is not
+   * found, the unwinder may not cross the exception frame.
+   */
+
+  for (i = 0; i < nframes && (uintptr_t)frames[i] != pc; i++);
+
+  for (depth = 1, i++; i < nframes && depth < PROFILE_DEPTH; i++)
+    {
+      buffer[depth++] = (uintptr_t)frames[i];
+    }
+
+  return depth;
+}
+#endif
+
+/****************************************************************************
+ * Name: profile_sample
+ *
+ * Description:
+ *   Record the context interrupted on this CPU.
+ *
+ ****************************************************************************/
+
+static void profile_sample(FAR struct profile_s *prof)
+{
+  FAR struct profile_cpu_s *pcpu;
+  uintptr_t pc[PROFILE_DEPTH];
+  irqstate_t flags;
+  unsigned int next;
+  int depth = 1;
+
+  pc[0] = up_getusrpc(NULL);
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+  nxsched_stack_sample(nxsched_self(), up_getusrsp(NULL));
+#endif
+#if PROFILE_DEPTH > 1
+  depth = profile_backtrace(pc[0], pc);
+#endif
+
+  flags = spin_lock_irqsave_wo_note(&prof->lock);
+
+  pcpu = &prof->cpu[up_cpu_index()];
+  next = pcpu->head + 1;
+  if (next >= CONFIG_DEV_PROFILE_NSAMPLES)
+    {
+      next = 0;
+    }
+
+  if (next == pcpu->tail)
+    {
+      pcpu->lost++;
+    }
+  else
+    {
+      pcpu->samples[pcpu->head].pid   = nxsched_self()->pid;
+      pcpu->samples[pcpu->head].depth = depth;
+      memcpy(pcpu->samples[pcpu->head].pc, pc, depth * sizeof(uintptr_t));
+      pcpu->head = next;
+    }
+
+  spin_unlock_irqrestore_wo_note(&prof->lock, flags);
+}
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+/****************************************************************************
+ * Name: profile_timer
+ ****************************************************************************/
+
+static bool profile_timer(FAR uint32_t *next_interval, FAR void *arg)
+{
+  FAR struct profile_s *prof = arg;
+
+  profile_sample(prof);
+  return prof->running;
+}
+#else
+/****************************************************************************
+ * Name: profile_wdog
+ ****************************************************************************/
+
+static void profile_wdog(wdparm_t arg)
+{
+  FAR struct profile_s *prof = (FAR struct profile_s *)arg;
+
+  profile_sample(prof);
+  if (prof->running)
+    {
+      wd_start(&prof->wdog, prof->ticks, profile_wdog, arg);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: profile_start
+ ****************************************************************************/
+
+static int profile_start(FAR struct profile_s *prof, uint32_t interval)
+{
+  int ret = OK;
+
+  if (prof->running)
+    {
+      return -EBUSY;
+    }
+
+  if (interval == 0)
+    {
+      interval = CONFIG_DEV_PROFILE_INTERVAL;
+    }
+
+  prof->running = true;
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+  prof->lower->ops->setcallback(prof->lower, profile_timer, prof);
+  ret = prof->lower->ops->settimeout(prof->lower, interval);
+  if (ret >= 0)
+    {
+      ret = prof->lower->ops->start(prof->lower);
+    }
+#else
+  prof->ticks = MAX(USEC2TICK(interval), 1);
+  ret = wd_start(&prof->wdog, prof->ticks, profile_wdog,
+                 (wdparm_t)prof);
+#endif
+
+  if (ret < 0)
+    {
+      prof->running = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: profile_stop
+ ****************************************************************************/
+
+static int profile_stop(FAR struct profile_s *prof)
+{
+  if (!prof->running)
+    {
+      return OK;
+    }
+
+  prof->running = false;
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+  prof->lower->ops->stop(prof->lower);
+  prof->lower->ops->setcallback(prof->lower, NULL, NULL);
+  return OK;
+#else
+  return wd_cancel(&prof->wdog);
+#endif
+}
+
+/****************************************************************************
+ * Name: profile_reset
+ ****************************************************************************/
+
+static void profile_reset(FAR struct profile_s *prof)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave_wo_note(&prof->lock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      prof->cpu[cpu].tail = prof->cpu[cpu].head;
+      prof->cpu[cpu].lost = 0;
+    }
+
+  spin_unlock_irqrestore_wo_note(&prof->lock, flags);
+
+  prof->linepos = 0;
+  prof->linelen = 0;
+}
+
+/****************************************************************************
+ * Name: profile_format
+ *
+ * Description:
+ *   Remove the oldest sample of a CPU from its buffer and format it into
+ *   the line to be read.
+ *
+ * Returned Value:
+ *   True if a line was formatted, false if there are no more samples.
+ *
+ ****************************************************************************/
+
+static bool profile_format(FAR struct profile_s *prof)
+{
+  FAR struct profile_cpu_s *pcpu;
+  struct profile_sample_s sample;
+  unsigned long lost = 0;
+  irqstate_t flags;
+  size_t len;
+  int cpu;
+  int i;
+
+  flags = spin_lock_irqsave_wo_note(&prof->lock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      pcpu = &prof->cpu[cpu];
+
+      /* Report the lost samples before the samples that follow them */
+
+      if (pcpu->lost != 0)
+        {
+          lost = pcpu->lost;
+          pcpu->lost = 0;
+          break;
+        }
+
+      if (pcpu->tail != pcpu->head)
+        {
+          sample = pcpu->samples[pcpu->tail];
+          if (++pcpu->tail >= CONFIG_DEV_PROFILE_NSAMPLES)
+            {
+              pcpu->tail = 0;
+            }
+
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&prof->lock, flags);
+
+  if (cpu >= CONFIG_SMP_NCPUS)
+    {
+      return false;
+    }
+
+  if (lost != 0)
+    {
+      len = snprintf(prof->line, sizeof(prof->line), "# %d lost %lu\n",
+                     cpu, lost);
+    }
+  else
+    {
+      len = snprintf(prof->line, sizeof(prof->line), "%d %d",
+                     cpu, (int)sample.pid);
+      for (i = 0; i < sample.depth; i++)
+        {
+          len += snprintf(prof->line + len, sizeof(prof->line) - len,
+                          " 0x%" PRIxPTR, sample.pc[i]);
+        }
+
+      prof->line[len++] = '\n';
+    }
+
+  prof->linepos = 0;
+  prof->linelen = len;
+  return true;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct profile_s *prof = filep->f_inode->i_private;
+  size_t nread = 0;
+  size_t ncopy;
+  int ret;
+
+  ret = nxmutex_lock(&prof->mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nread < buflen)
+    {
+      if (prof->linepos >= prof->linelen && !profile_format(prof))
+        {
+          break;
+        }
+
+      ncopy = MIN(buflen - nread, prof->linelen - prof->linepos);
+      memcpy(buffer + nread, prof->line + prof->linepos, ncopy);
+      prof->linepos += ncopy;
+      nread         += ncopy;
+    }
+
+  nxmutex_unlock(&prof->mutex);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: profile_write
+ *
+ * Description:
+ *   "1" starts sampling at the default interval, "0" stops it.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct profile_s *prof = filep->f_inode->i_private;
+  int ret;
+
+  if (buflen == 0 || (buffer[0] != '0' && buffer[0] != '1'))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&prof->mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (buffer[0] == '1')
+    {
+      ret = prof->running ? OK : profile_start(prof, 0);
+    }
+  else
+    {
+      ret = profile_stop(prof);
+    }
+
+  nxmutex_unlock(&prof->mutex);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: profile_ioctl
+ ****************************************************************************/
+
+static int profile_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct profile_s *prof = filep->f_inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&prof->mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case PROFIOC_START:
+        ret = profile_start(prof, (uint32_t)arg);
+        break;
+
+      case PROFIOC_STOP:
+        ret = profile_stop(prof);
+        break;
+
+      case PROFIOC_RESET:
+        profile_reset(prof);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&prof->mutex);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_register
+ *
+ * Description:
+ *   Register the sampling profiler as /dev/profile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+int profile_register(FAR struct timer_lowerhalf_s *lower)
+#else
+int profile_register(void)
+#endif
+{
+  FAR struct profile_s *prof = &g_profile;
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+  DEBUGASSERT(lower != NULL && lower->ops->setcallback != NULL);
+  prof->lower = lower;
+#endif
+
+  return register_driver("/dev/profile", &g_profile_fops, 0666, prof);
+}
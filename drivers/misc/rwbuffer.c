@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
@@ -62,6 +63,9 @@
 
 static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                          size_t nblocks, FAR uint8_t *rdbuffer);
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -124,6 +128,49 @@ static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_wrwait
+ *
+ * Description:
+ *   Wait for the end of the flush in progress in the background, if any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRDOUBLE
+static void rwb_wrwait(FAR struct rwbuffer_s *rwb)
+{
+  nxsem_wait_uninterruptible(&rwb->flsem);
+  nxsem_post(&rwb->flsem);
+}
+#else
+#  define rwb_wrwait(rwb)
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrpad
+ *
+ * Description:
+ *   Complete the write buffer up to a multiple of wralignblocks with the
+ *   blocks that follow it on the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrpad(FAR struct rwbuffer_s *rwb)
+{
+  size_t padblocks;
+
+  padblocks = rwb->wrnblocks % rwb->wralignblocks;
+  if (padblocks)
+    {
+      padblocks = rwb->wralignblocks - padblocks;
+      rwb_read_(rwb, rwb->wrblockstart + rwb->wrnblocks, padblocks,
+                &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
+      rwb->wrnblocks += padblocks;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_wrflush
  *
@@ -137,21 +184,16 @@ static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
 {
   int ret;
 
+  /* The buffer being flushed holds older data, it must land first */
+
+  rwb_wrwait(rwb);
+
   if (rwb->wrnblocks > 0)
     {
-      size_t padblocks;
-
       finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
             (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
 
-      padblocks = rwb->wrnblocks % rwb->wralignblocks;
-      if (padblocks)
-        {
-          padblocks = rwb->wralignblocks - padblocks;
-          rwb_read_(rwb, rwb->wrblockstart + rwb->wrnblocks, padblocks,
-                    &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-          rwb->wrnblocks += padblocks;
-        }
+      rwb_wrpad(rwb);
 
       /* Flush cache.  On success, the flush method will return the number
        * of blocks written.  Anything other than the number requested is
@@ -170,6 +212,76 @@ static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_flworker
+ *
+ * Description:
+ *   Flush the second buffer on the low priority worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRDOUBLE
+static void rwb_flworker(FAR void *arg)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+  int ret;
+
+  ret = rwb->wrflush(rwb->dev, rwb->flbuffer, rwb->flblockstart,
+                     rwb->flnblocks);
+  if (ret != rwb->flnblocks)
+    {
+      ferr("ERROR: Error flushing write buffer: %d\n", ret);
+    }
+
+  rwb->flnblocks = 0;
+  nxsem_post(&rwb->flsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrswap
+ *
+ * Description:
+ *   Hand the write buffer to the worker to be flushed in the background and
+ *   continue with the other buffer, waiting for its own flush to finish
+ *   first.
+ *
+ * Assumptions:
+ *   The caller holds the wrlock mutex.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRDOUBLE
+static void rwb_wrswap(FAR struct rwbuffer_s *rwb)
+{
+  FAR uint8_t *buffer;
+
+  if (rwb->wrnblocks == 0)
+    {
+      return;
+    }
+
+  nxsem_wait_uninterruptible(&rwb->flsem);
+  rwb_wrpad(rwb);
+
+  finfo("Swapping: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+        (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+
+  buffer            = rwb->flbuffer;
+  rwb->flbuffer     = rwb->wrbuffer;
+  rwb->flblockstart = rwb->wrblockstart;
+  rwb->flnblocks    = rwb->wrnblocks;
+  rwb->wrbuffer     = buffer;
+
+  rwb_resetwrbuffer(rwb);
+
+  if (work_queue(LPWORK, &rwb->flwork, rwb_flworker, rwb, 0) < 0)
+    {
+      rwb_flworker(rwb);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_wrtimeout
  ****************************************************************************/
@@ -189,7 +301,28 @@ static void rwb_wrtimeout(FAR void *arg)
    * worker thread.
    */
 
+#ifdef CONFIG_DRVR_WRDOUBLE
+  /* Don't block the worker that has to complete the flush in progress.
+   * A writer holding the lock restarts the timeout when it is done.
+   */
+
+  if (nxmutex_trylock(&rwb->wrlock) < 0)
+    {
+      return;
+    }
+
+  if (nxsem_trywait(&rwb->flsem) < 0)
+    {
+      rwb_wrstarttimeout(rwb);
+      rwb_unlock(&rwb->wrlock);
+      return;
+    }
+
+  nxsem_post(&rwb->flsem);
+#else
   rwb_lock(&rwb->wrlock);
+#endif
+
   rwb_wrflush(rwb);
   rwb_unlock(&rwb->wrlock);
 }
@@ -207,7 +340,27 @@ static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
    * provides the clock tick of the system (frequency in Hz).
    */
 
-  int ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
+  clock_t ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
+#ifdef CONFIG_DRVR_WRADAPTIVE
+  clock_t now = clock_systime_ticks();
+  clock_t gap = now - rwb->wrlast;
+
+  /* Average the gaps within a burst only:  a gap longer than the delay
+   * means that the buffer was flushed by the timeout in between.
+   */
+
+  rwb->wrlast = now;
+  if (gap < ticks)
+    {
+      rwb->wrgap = (3 * rwb->wrgap + gap) / 4;
+    }
+
+  if (4 * rwb->wrgap + 1 < ticks)
+    {
+      ticks = 4 * rwb->wrgap + 1;
+    }
+#endif
+
   work_queue(LPWORK, &rwb->work, rwb_wrtimeout, rwb, ticks);
 #endif
 }
@@ -356,7 +509,10 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
   if (nblocks > rwb->wrmaxblocks)
     {
-      ssize_t ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+      ssize_t ret;
+
+      rwb_wrwait(rwb);
+      ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
       if (ret < 0)
         {
           return ret;
@@ -366,7 +522,11 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
     {
       /* Flush the write buffer */
 
+#ifdef CONFIG_DRVR_WRDOUBLE
+      rwb_wrswap(rwb);
+#else
       rwb_wrflush(rwb);
+#endif
 
       /* Buffer the data in the write buffer */
 
@@ -638,19 +798,20 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 #endif
 
 /****************************************************************************
- * Name: rwb_invalidate_readahead
+ * Name: rwb_rhinvalidate
  *
  * Description:
  *   Invalidate a region of the read-ahead buffer
  *
+ * Assumptions:
+ *   The caller holds the rhlock mutex.
+ *
  ****************************************************************************/
 
-#if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+#ifdef CONFIG_DRVR_READAHEAD
+static void rwb_rhinvalidate(FAR struct rwbuffer_s *rwb,
                              off_t startblock, size_t blockcount)
 {
-  int ret = OK;
-
   if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
     {
       off_t rhbend;
@@ -659,12 +820,6 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
       finfo("startblock=%" PRIdOFF " blockcount=%zu\n",
             startblock, blockcount);
 
-      ret = rwb_lock(&rwb->rhlock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
       /* Now there are five cases:
        *
        * 1. We invalidate nothing
@@ -675,7 +830,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 
       if (rhbend <= startblock || rwb->rhblockstart >= invend)
         {
-          ret = OK;
+          /* Nothing to do */;
         }
 
       /* 2. We invalidate the entire read-ahead buffer. */
@@ -683,7 +838,6 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
       else if (rwb->rhblockstart >= startblock && rhbend <= invend)
         {
           rwb->rhnblocks = 0;
-          ret = OK;
         }
 
       /* We are going to invalidate a subset of the read-ahead buffer.
@@ -699,7 +853,6 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
            */
 
           rwb->rhnblocks = startblock - rwb->rhblockstart;
-          ret = OK;
         }
 
       /* 3. We invalidate a portion at the end of the read-ahead buffer */
@@ -707,7 +860,6 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
       else if (rhbend > startblock && rhbend <= invend)
         {
           rwb->rhnblocks -= rhbend - startblock;
-          ret = OK;
         }
 
       /* 4. We invalidate a portion at the begin of the read-ahead buffer */
@@ -719,6 +871,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
           size_t nkeep;
 
           DEBUGASSERT(rwb->rhblockstart >= startblock && rhbend > invend);
+
           /* Copy the data from the uninvalidated region to the beginning
            * of the read buffer.
            *
@@ -748,7 +901,33 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
           rwb->rhblockstart = invend;
           rwb->rhnblocks    = nkeep;
         }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_invalidate_readahead
+ *
+ * Description:
+ *   Invalidate a region of the read-ahead buffer
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
+int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+                             off_t startblock, size_t blockcount)
+{
+  int ret = OK;
 
+  if (rwb->rhmaxblocks > 0)
+    {
+      ret = rwb_lock(&rwb->rhlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      rwb_rhinvalidate(rwb, startblock, blockcount);
       rwb_unlock(&rwb->rhlock);
     }
 
@@ -818,6 +997,30 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
           return -ENOMEM;
         }
 
+#ifdef CONFIG_DRVR_WRDOUBLE
+      /* Allocate the buffer flushed in the background */
+
+      rwb->flbuffer = kmm_malloc(allocsize);
+      if (!rwb->flbuffer)
+        {
+          ferr("Write buffer kmm_malloc(%" PRIu32 ") failed\n", allocsize);
+          kmm_free(rwb->wrbuffer);
+          rwb->wrbuffer = NULL;
+          nxmutex_destroy(&rwb->wrlock);
+          return -ENOMEM;
+        }
+
+      nxsem_init(&rwb->flsem, 0, 1);
+      rwb->flnblocks = 0;
+#endif
+
+#ifdef CONFIG_DRVR_WRADAPTIVE
+      /* Start with the full delay */
+
+      rwb->wrlast = clock_systime_ticks();
+      rwb->wrgap  = MSEC2TICK(CONFIG_DRVR_WRDELAY) / 4;
+#endif
+
       finfo("Write buffer size: %" PRIu32 " bytes\n", allocsize);
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
@@ -853,6 +1056,10 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
           if (rwb->wrbuffer != NULL)
             {
               kmm_free(rwb->wrbuffer);
+#ifdef CONFIG_DRVR_WRDOUBLE
+              kmm_free(rwb->flbuffer);
+              nxsem_destroy(&rwb->flsem);
+#endif
             }
 #endif
 
@@ -881,6 +1088,10 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
       if (rwb->wrbuffer)
         {
           kmm_free(rwb->wrbuffer);
+#ifdef CONFIG_DRVR_WRDOUBLE
+          kmm_free(rwb->flbuffer);
+          nxsem_destroy(&rwb->flsem);
+#endif
         }
     }
 #endif
@@ -1001,6 +1212,9 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_WRITEBUFFER
   /* If the new read data overlaps any part of the write buffer, we
    * directly copy write buffer to read buffer. This boost performance.
+   *
+   * The write buffer stays locked until the end of the read, so that a
+   * write can't land between the media and the read-ahead buffer.
    */
 
   if (rwb->wrmaxblocks > 0)
@@ -1011,6 +1225,12 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
           return ret;
         }
 
+      /* The blocks being flushed in the background aren't on the media
+       * yet.
+       */
+
+      rwb_wrwait(rwb);
+
       /* If the write buffer overlaps the block(s) requested */
 
       if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock,
@@ -1050,12 +1270,18 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
           rdbuffer   += rdblocks * rwb->blocksize;
           readblocks += rdblocks;
         }
+    }
+#endif
+
+  ret = rwb_read_(rwb, startblock, nblocks, rdbuffer);
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrmaxblocks > 0)
+    {
       rwb_unlock(&rwb->wrlock);
     }
 #endif
 
-  ret = rwb_read_(rwb, startblock, nblocks, rdbuffer);
   if (ret < 0)
     {
       return ret;
@@ -1073,43 +1299,6 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 {
   int ret = OK;
 
-#ifdef CONFIG_DRVR_READAHEAD
-  if (rwb->rhmaxblocks > 0)
-    {
-      /* If the new write data overlaps any part of the read buffer, then
-       * flush the data from the read buffer.  We could attempt some more
-       * exotic handling -- but this simple logic is well-suited for simple
-       * streaming applications.
-       */
-
-      ret = nxmutex_lock(&rwb->rhlock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock,
-                      nblocks))
-        {
-#ifdef CONFIG_DRVR_INVALIDATE
-          /* Just invalidate the read buffer startblock + nblocks data */
-
-          ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
-              rwb_unlock(&rwb->rhlock);
-              return ret;
-            }
-#else
-          rwb_resetrhbuffer(rwb);
-#endif
-        }
-
-      rwb_unlock(&rwb->rhlock);
-    }
-#endif
-
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
@@ -1121,13 +1310,12 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
           return ret;
         }
 
-      ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
-      rwb_unlock(&rwb->wrlock);
-
       /* On success, return the number of blocks that we were requested to
        * write.  This is for compatibility with the normal return of a block
        * driver write method
        */
+
+      ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
     }
   else
 #endif /* CONFIG_DRVR_WRITEBUFFER */
@@ -1139,6 +1327,37 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
       ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
     }
 
+#ifdef CONFIG_DRVR_READAHEAD
+  if (rwb->rhmaxblocks > 0)
+    {
+      int rhret;
+
+      /* Drop the old copies of the blocks from the read-ahead buffer once
+       * the new data is in place, so that a reload racing with the write
+       * can't leave them behind.  Readers can't see the window in between:
+       * with a write buffer, they hold its lock for the whole read.
+       */
+
+      rhret = nxmutex_lock(&rwb->rhlock);
+      if (rhret < 0)
+        {
+          ret = rhret;
+        }
+      else
+        {
+          rwb_rhinvalidate(rwb, startblock, nblocks);
+          rwb_unlock(&rwb->rhlock);
+        }
+    }
+#endif
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_unlock(&rwb->wrlock);
+    }
+#endif
+
   return ret;
 }
 
@@ -93,6 +93,10 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* CMD23 carries the block count in bits 15:0 of its argument */
+
+#define MMCSD_CMD23_MAXBLOCKS   0xffff
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 /****************************************************************************
@@ -116,6 +120,9 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+#ifdef CONFIG_MMCSD_CMD23
+  uint8_t cmd23:1;                 /* true: card supports CMD23 (SCR or CSD) */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -176,6 +183,10 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_MMCSD_CMD23
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                                   size_t nblocks);
+#endif
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                                  uint32_t blocklen);
@@ -992,6 +1003,16 @@ static void mmcsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
   priv->buswidth     = (scr[0] >> 8) & 15;
 #endif
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* CMD_SUPPORT 33:32, bit 33 is set if the card supports CMD23 */
+
+#ifdef CONFIG_ENDIAN_BIG
+  priv->cmd23        = (scr[0] >> 1) & 1;
+#else
+  priv->cmd23        = (scr[0] >> 25) & 1;
+#endif
+#endif
+
 #ifdef CONFIG_DEBUG_FS_INFO
 #ifdef CONFIG_ENDIAN_BIG
   /* Card SCR is big-endian order / CPU also big-endian
@@ -1322,6 +1343,36 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send SET_BLOCK_COUNT so that the card ends the following CMD18 or CMD25
+ *   by itself after nblocks, without a STOP_TRANSMISSION.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_CMD23
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               size_t nblocks)
+{
+  int ret;
+
+  DEBUGASSERT(nblocks <= MMCSD_CMD23_MAXBLOCKS);
+
+  /* Send CMD23, SET_BLOCK_COUNT, and verify good R1 return status */
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD23, nblocks);
+  ret = mmcsd_recv_r1(priv, MMCSD_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1598,6 +1649,20 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       SDIO_RECVSETUP(priv->dev, buffer, nbytes);
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* Pre-define the number of blocks, this saves the CMD12 at the end */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+#endif
+
   /* Send CMD18, READ_MULT_BLOCK: Read a block of the size selected by
    * the mmcsd_setblocklen() and verify that good R1 status is returned
    */
@@ -1620,6 +1685,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* The card is back in the transfer state after the last block */
+
+  if (priv->cmd23)
+    {
+      return nblocks;
+    }
+#endif
+
   /* Send STOP_TRANSMISSION */
 
   ret = mmcsd_stoptransmission(priv);
@@ -1888,6 +1962,23 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* Pre-define the number of blocks, the card then knows as much as from
+   * ACMD23 and goes back to the transfer state by itself after the last
+   * block.
+   */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+  else
+#endif
+
   /* If this is an SD card, then send ACMD23 (SET_WR_BLK_ERASE_COUNT) just
    * before sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of
    * write blocks to be pre-erased and might make the following multiple
@@ -1994,9 +2085,23 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+#ifdef CONFIG_MMCSD_CMD23
+  /* With a pre-defined block count the card ends the transfer by itself,
+   * unless it failed part way.
+   */
+
+  if (priv->cmd23 && evret == OK)
+    {
+      ret = OK;
+    }
+  else
+#endif
+    {
+      /* Send STOP_TRANSMISSION */
+
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -2136,6 +2241,13 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
               nread = MMCSD_MULTIBLOCK_LIMIT;
             }
 
+#ifdef CONFIG_MMCSD_CMD23
+          if (priv->cmd23 && nread > MMCSD_CMD23_MAXBLOCKS)
+            {
+              nread = MMCSD_CMD23_MAXBLOCKS;
+            }
+#endif
+
           if (nread == 1)
             {
               nread = mmcsd_readsingle(priv, buffer, sector);
@@ -2214,6 +2326,13 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
               nwrite = MMCSD_MULTIBLOCK_LIMIT;
             }
 
+#ifdef CONFIG_MMCSD_CMD23
+          if (priv->cmd23 && nwrite > MMCSD_CMD23_MAXBLOCKS)
+            {
+              nwrite = MMCSD_CMD23_MAXBLOCKS;
+            }
+#endif
+
           if (nwrite == 1)
             {
               nwrite = mmcsd_writesingle(priv, buffer, sector);
@@ -2765,6 +2884,14 @@ static int mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv)
 
   mmcsd_decode_csd(priv, csd);
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* SET_BLOCK_COUNT is part of the MMC spec since version 3.1, the CSD
+   * SPEC_VERS 125:122 is 3 from there on.
+   */
+
+  priv->cmd23 = ((csd[0] >> 26) & 0x0f) >= 3;
+#endif
+
   if ((priv->caps & SDIO_CAPS_4BIT_ONLY) != 0)
     {
       /* Select width (4-bit) bus operation (if the card supports it) */
@@ -3963,6 +4090,9 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
+#ifdef CONFIG_MMCSD_CMD23
+  priv->cmd23        = false;
+#endif
 
   /* Go back to the default 1-bit data bus. */
 
@@ -43,6 +43,8 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#include "ftl_log.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -74,6 +76,9 @@ struct ftl_struct_s
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
   FAR uint8_t          *eblock;   /* One, in-memory erase block */
+#ifdef CONFIG_FTL_LOG
+  FAR struct ftl_log_s *log;      /* Log structured mode, if not NULL */
+#endif
 };
 
 /****************************************************************************
@@ -156,10 +161,23 @@ static int ftl_close(FAR struct inode *inode)
   rwb_flush(&dev->rwb);
 #endif
 
+#ifdef CONFIG_FTL_LOG
+  if (dev->log != NULL)
+    {
+      ftl_log_flush(dev->log);
+    }
+#endif
+
   if (--dev->refs == 0 && dev->unlinked)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOG
+      if (dev->log != NULL)
+        {
+          ftl_log_uninitialize(dev->log);
+        }
 #endif
       if (dev->eblock)
         {
@@ -185,6 +203,13 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_LOG
+  if (dev->log != NULL)
+    {
+      return ftl_log_read(dev->log, buffer, startblock, nblocks);
+    }
+#endif
+
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -254,6 +279,13 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_LOG
+  if (dev->log != NULL)
+    {
+      return ftl_log_write(dev->log, buffer, startblock, nblocks);
+    }
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -477,6 +509,12 @@ static int ftl_geometry(FAR struct inode *inode,
       geometry->geo_writeenabled  = true;
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
       geometry->geo_sectorsize    = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOG
+      if (dev->log != NULL)
+        {
+          geometry->geo_nsectors  = ftl_log_nsectors(dev->log);
+        }
+#endif
 
       strlcpy(geometry->geo_model, dev->geo.model,
               sizeof(geometry->geo_model));
@@ -516,6 +554,17 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
     }
 
+#ifdef CONFIG_FTL_LOG
+  /* The layout of the MTD belongs to the log:  don't let it be changed or
+   * accessed directly.
+   */
+
+  if (dev->log != NULL)
+    {
+      return cmd == BIOC_FLUSH ? ftl_log_flush(dev->log) : -ENOTTY;
+    }
+#endif
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -550,6 +599,12 @@ static int ftl_unlink(FAR struct inode *inode)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOG
+      if (dev->log != NULL)
+        {
+          ftl_log_uninitialize(dev->log);
+        }
 #endif
       if (dev->eblock)
         {
@@ -568,7 +623,7 @@ static int ftl_unlink(FAR struct inode *inode)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: ftl_initialize_by_path
+ * Name: ftl_initialize_by_path_mode
  *
  * Description:
  *   Initialize to provide a block driver wrapper around an MTD interface
@@ -576,10 +631,12 @@ static int ftl_unlink(FAR struct inode *inode)
  * Input Parameters:
  *   path - The block device path.
  *   mtd  - The MTD device that supports the FLASH interface.
+ *   mode - FTL_MODE_ERASE or FTL_MODE_LOG.
  *
  ****************************************************************************/
 
-int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
+int ftl_initialize_by_path_mode(FAR const char *path,
+                                FAR struct mtd_dev_s *mtd, int mode)
 {
   struct ftl_struct_s *dev;
   int ret = -ENOMEM;
@@ -591,7 +648,16 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       return -EINVAL;
     }
 
-  finfo("path=\"%s\"\n", path);
+#ifdef CONFIG_FTL_LOG
+  if (mode != FTL_MODE_ERASE && mode != FTL_MODE_LOG)
+#else
+  if (mode != FTL_MODE_ERASE)
+#endif
+    {
+      return -EINVAL;
+    }
+
+  finfo("path=\"%s\" mode=%d\n", path, mode);
 
   /* Allocate a FTL device structure */
 
@@ -621,11 +687,30 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_LOG
+      if (mode == FTL_MODE_LOG)
+        {
+          ret = ftl_log_initialize(mtd, &dev->geo, &dev->log);
+          if (ret < 0)
+            {
+              ferr("ERROR: ftl_log_initialize failed: %d\n", ret);
+              kmm_free(dev);
+              return ret;
+            }
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize     = dev->geo.blocksize;
       dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+#ifdef CONFIG_FTL_LOG
+      if (dev->log != NULL)
+        {
+          dev->rwb.nblocks   = ftl_log_nsectors(dev->log);
+        }
+#endif
       dev->rwb.dev           = (FAR void *)dev;
       dev->rwb.wrflush       = ftl_flush;
       dev->rwb.rhreload      = ftl_reload;
@@ -633,6 +718,14 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 #if defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks   = dev->blkper;
       dev->rwb.wralignblocks = dev->blkper;
+#ifdef CONFIG_FTL_LOG
+      if (dev->log != NULL)
+        {
+          /* The log has no alignment to keep */
+
+          dev->rwb.wralignblocks = 1;
+        }
+#endif
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
@@ -643,6 +736,12 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_LOG
+          if (dev->log != NULL)
+            {
+              ftl_log_uninitialize(dev->log);
+            }
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -656,6 +755,12 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOG
+          if (dev->log != NULL)
+            {
+              ftl_log_uninitialize(dev->log);
+            }
 #endif
           kmm_free(dev);
         }
@@ -665,7 +770,24 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 }
 
 /****************************************************************************
- * Name: ftl_initialize
+ * Name: ftl_initialize_by_path
+ *
+ * Description:
+ *   Initialize to provide a block driver wrapper around an MTD interface
+ *
+ * Input Parameters:
+ *   path - The block device path.
+ *   mtd  - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
+{
+  return ftl_initialize_by_path_mode(path, mtd, FTL_MODE_ERASE);
+}
+
+/****************************************************************************
+ * Name: ftl_initialize_mode
  *
  * Description:
  *   Initialize to provide a block driver wrapper around an MTD interface
@@ -674,10 +796,11 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
  *   minor - The minor device number.  The MTD block device will be
  *           registered as as /dev/mtdblockN where N is the minor number.
  *   mtd   - The MTD device that supports the FLASH interface.
+ *   mode  - FTL_MODE_ERASE or FTL_MODE_LOG.
  *
  ****************************************************************************/
 
-int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+int ftl_initialize_mode(int minor, FAR struct mtd_dev_s *mtd, int mode)
 {
   char path[DEV_NAME_MAX];
 
@@ -693,5 +816,23 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
   /* Do the real work by ftl_initialize_by_path */
 
   snprintf(path, DEV_NAME_MAX, "/dev/mtdblock%d", minor);
-  return ftl_initialize_by_path(path, mtd);
+  return ftl_initialize_by_path_mode(path, mtd, mode);
+}
+
+/****************************************************************************
+ * Name: ftl_initialize
+ *
+ * Description:
+ *   Initialize to provide a block driver wrapper around an MTD interface
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *           registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd   - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+  return ftl_initialize_mode(minor, mtd, FTL_MODE_ERASE);
 }
@@ -0,0 +1,1540 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The log structured mode of the FTL never rewrites a page in place.  The
+ * sectors are appended to the open erase block, the head, and a table in
+ * RAM maps each logical sector to its latest physical page.
+ *
+ * Each erase block starts with a header page, giving the order in which
+ * the blocks were opened, and is sealed, once full or on a flush, by a
+ * summary in its last pages listing the logical sector of each of its
+ * pages.  A block that is not sealed is discarded on mount.
+ *
+ * A checkpoint saves the whole table and the erase counts in blocks of
+ * their own.  Mounting loads the latest complete checkpoint and replays
+ * the summaries of the blocks written after it, or of all the blocks if
+ * there is no checkpoint.
+ *
+ * The garbage collection, on the low priority work queue or when a write
+ * runs out of space, copies the valid pages of a block to the head.  That
+ * block is only erased once the head holding the copies is sealed: until
+ * then a power loss would lose them.  Free blocks are allocated by the
+ * lowest erase count, and the block of the lowest erase count is collected
+ * when it is too far below the highest to bring its cold data in use.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mtd/mtd.h>
+
+#include "ftl_log.h"
+
+#ifdef CONFIG_FTL_LOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTL_LOG_MAGIC        0x4c544623 /* "#FTL" in little endian */
+#define FTL_LOG_SUMMAGIC     0x4d555323 /* "#SUM" in little endian */
+
+#define FTL_LOG_UNMAPPED     UINT32_MAX
+#define FTL_LOG_NONE         UINT32_MAX
+
+/* Block types in the header */
+
+#define FTL_LOG_TYPE_DATA    1
+#define FTL_LOG_TYPE_CKPT    2
+
+/* Block states */
+
+#define FTL_LOG_FREE         0   /* Erased */
+#define FTL_LOG_OPEN         1   /* The head of the log */
+#define FTL_LOG_DATA         2   /* A sealed data block */
+#define FTL_LOG_CKPT         3   /* Part of the current checkpoint */
+#define FTL_LOG_OLDCKPT      4   /* Part of the checkpoint being replaced */
+#define FTL_LOG_DIRTY        5   /* To be erased */
+#define FTL_LOG_BAD          6   /* Failed to erase */
+
+/* Data blocks held by the garbage collection, on top of the checkpoints */
+
+#define FTL_LOG_GCBLOCKS     2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The first page of each erase block */
+
+begin_packed_struct struct ftl_log_header_s
+{
+  uint32_t magic;                  /* FTL_LOG_MAGIC */
+  uint32_t seq;                    /* Order the blocks were opened in */
+  uint32_t erasecnt;               /* Times the block was erased */
+  uint32_t nsectors;               /* Checkpoints: the size of the table */
+  uint8_t  type;                   /* FTL_LOG_TYPE_* */
+  uint8_t  part;                   /* Checkpoints: the part it holds */
+  uint8_t  nparts;                 /* Checkpoints: the number of parts */
+  uint8_t  reserved;
+  uint32_t crc;                    /* Of the fields above */
+} end_packed_struct;
+
+/* The start of the last pages of a sealed erase block.  In data blocks it
+ * is followed by the logical sector of each page, in checkpoints crc is
+ * that of their content.
+ */
+
+begin_packed_struct struct ftl_log_summary_s
+{
+  uint32_t magic;                  /* FTL_LOG_SUMMAGIC */
+  uint32_t seq;                    /* The same as in the header */
+  uint32_t crc;                    /* Of the sectors or of the content */
+} end_packed_struct;
+
+struct ftl_log_block_s
+{
+  uint32_t seq;                    /* From the header */
+  uint16_t valid;                  /* Pages currently mapped */
+  uint8_t  state;                  /* FTL_LOG_* */
+  uint8_t  part;                   /* Checkpoints: the part it holds */
+};
+
+struct ftl_log_s
+{
+  FAR struct mtd_dev_s *mtd;       /* Contained MTD interface */
+  mutex_t   lock;                  /* Protects everything below */
+  struct work_s work;              /* Background garbage collection */
+  bool      stop;                  /* Don't queue the work again */
+  uint8_t   erased;                /* Erased state of the flash */
+  uint16_t  blkper;                /* Pages per erase block */
+  uint16_t  ndata;                 /* Data pages per erase block */
+  uint16_t  nsum;                  /* Summary pages per erase block */
+  uint16_t  ncp;                   /* Erase blocks per checkpoint */
+  uint32_t  blocksize;             /* Page size */
+  uint32_t  nblocks;               /* Number of erase blocks */
+  uint32_t  nsectors;              /* Number of logical sectors */
+  uint32_t  reserve;               /* Free blocks kept from writes */
+  uint32_t  nfree;                 /* Number of free blocks */
+  uint32_t  seq;                   /* Next sequence number */
+  uint32_t  nsealed;               /* Blocks sealed since the checkpoint */
+  uint32_t  head;                  /* The open block, or FTL_LOG_NONE */
+  uint16_t  headpage;              /* Next page to write in the head */
+  FAR uint32_t *l2p;               /* Logical sector to physical page */
+  FAR uint32_t *erasecnt;          /* Erase count of each block */
+  FAR struct ftl_log_block_s *blocks;
+  FAR uint8_t *headsum;            /* Summary of the head */
+  FAR uint8_t *scratch;            /* Summaries read back */
+  FAR uint8_t *page;               /* One page */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void ftl_log_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_ppage
+ ****************************************************************************/
+
+static inline off_t ftl_log_ppage(FAR struct ftl_log_s *log,
+                                  uint32_t block, uint32_t page)
+{
+  return (off_t)block * log->blkper + page;
+}
+
+/****************************************************************************
+ * Name: ftl_log_sectors
+ *
+ * Description:
+ *   Return the table of logical sectors following a summary.
+ *
+ ****************************************************************************/
+
+static inline FAR uint32_t *ftl_log_sectors(FAR uint8_t *summary)
+{
+  return (FAR uint32_t *)(summary + sizeof(struct ftl_log_summary_s));
+}
+
+/****************************************************************************
+ * Name: ftl_log_erase
+ ****************************************************************************/
+
+static int ftl_log_erase(FAR struct ftl_log_s *log, uint32_t block)
+{
+  int ret;
+
+  ret = MTD_ERASE(log->mtd, block, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block %" PRIu32 " failed: %d\n", block, ret);
+      log->blocks[block].state = FTL_LOG_BAD;
+      return ret;
+    }
+
+  log->erasecnt[block]++;
+  log->blocks[block].state = FTL_LOG_FREE;
+  log->blocks[block].valid = 0;
+  log->nfree++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reclaim
+ *
+ * Description:
+ *   Erase the dirty blocks, unless the head holds copies of their data that
+ *   are not sealed yet.
+ *
+ ****************************************************************************/
+
+static void ftl_log_reclaim(FAR struct ftl_log_s *log)
+{
+  uint32_t block;
+
+  if (log->head != FTL_LOG_NONE && log->headpage > 1)
+    {
+      return;
+    }
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_DIRTY)
+        {
+          ftl_log_erase(log, block);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_hasdirty
+ ****************************************************************************/
+
+static bool ftl_log_hasdirty(FAR struct ftl_log_s *log)
+{
+  uint32_t block;
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_DIRTY)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: ftl_log_alloc
+ *
+ * Description:
+ *   Take the free block of the lowest erase count, as long as more than
+ *   reserve blocks are free.
+ *
+ ****************************************************************************/
+
+static int ftl_log_alloc(FAR struct ftl_log_s *log, uint32_t reserve,
+                         FAR uint32_t *block)
+{
+  uint32_t best = FTL_LOG_NONE;
+  uint32_t i;
+
+  if (log->nfree <= reserve)
+    {
+      return -ENOSPC;
+    }
+
+  for (i = 0; i < log->nblocks; i++)
+    {
+      if (log->blocks[i].state == FTL_LOG_FREE &&
+          (best == FTL_LOG_NONE || log->erasecnt[i] < log->erasecnt[best]))
+        {
+          best = i;
+        }
+    }
+
+  DEBUGASSERT(best != FTL_LOG_NONE);
+
+  log->nfree--;
+  log->blocks[best].state = FTL_LOG_DIRTY;
+  log->blocks[best].valid = 0;
+  *block = best;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_writeheader
+ ****************************************************************************/
+
+static int ftl_log_writeheader(FAR struct ftl_log_s *log, uint32_t block,
+                               uint8_t type, uint8_t part)
+{
+  FAR struct ftl_log_header_s *header =
+    (FAR struct ftl_log_header_s *)log->page;
+  ssize_t nxfrd;
+
+  memset(log->page, log->erased, log->blocksize);
+
+  header->magic    = FTL_LOG_MAGIC;
+  header->seq      = log->seq;
+  header->erasecnt = log->erasecnt[block];
+  header->nsectors = log->nsectors;
+  header->type     = type;
+  header->part     = part;
+  header->nparts   = log->ncp;
+  header->reserved = 0;
+  header->crc      = crc32((FAR const uint8_t *)header,
+                           offsetof(struct ftl_log_header_s, crc));
+
+  log->blocks[block].seq  = log->seq++;
+  log->blocks[block].part = part;
+
+  nxfrd = MTD_BWRITE(log->mtd, ftl_log_ppage(log, block, 0), 1, log->page);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write header of block %" PRIu32 " failed: %zd\n",
+           block, nxfrd);
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_open
+ *
+ * Description:
+ *   Start a new head.
+ *
+ ****************************************************************************/
+
+static int ftl_log_open(FAR struct ftl_log_s *log, uint32_t reserve)
+{
+  uint32_t block;
+  int ret;
+
+  ret = ftl_log_alloc(log, reserve, &block);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = ftl_log_writeheader(log, block, FTL_LOG_TYPE_DATA, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(log->headsum, log->erased, log->nsum * log->blocksize);
+  memset(ftl_log_sectors(log->headsum), 0xff, log->ndata * sizeof(uint32_t));
+
+  log->blocks[block].state = FTL_LOG_OPEN;
+  log->head                = block;
+  log->headpage            = 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_seal
+ *
+ * Description:
+ *   Write the summary of the head, if it holds any sector, and erase the
+ *   blocks whose data it holds.
+ *
+ ****************************************************************************/
+
+static int ftl_log_seal(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->headsum;
+  uint32_t head = log->head;
+  ssize_t nxfrd;
+  int ret = OK;
+
+  if (head == FTL_LOG_NONE || log->headpage == 1)
+    {
+      return OK;
+    }
+
+  summary->magic = FTL_LOG_SUMMAGIC;
+  summary->seq   = log->blocks[head].seq;
+  summary->crc   = crc32((FAR const uint8_t *)ftl_log_sectors(log->headsum),
+                         log->ndata * sizeof(uint32_t));
+
+  nxfrd = MTD_BWRITE(log->mtd,
+                     ftl_log_ppage(log, head, log->blkper - log->nsum),
+                     log->nsum, log->headsum);
+  if (nxfrd != log->nsum)
+    {
+      ferr("ERROR: Write summary of block %" PRIu32 " failed: %zd\n",
+           head, nxfrd);
+      ret = -EIO;
+    }
+
+  log->blocks[head].state = FTL_LOG_DATA;
+  log->head = FTL_LOG_NONE;
+  log->nsealed++;
+
+  ftl_log_reclaim(log);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_append
+ *
+ * Description:
+ *   Write consecutive sectors at the head, as many as fit in it, opening a
+ *   new head first if needed.
+ *
+ * Returned Value:
+ *   The number of sectors written; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_append(FAR struct ftl_log_s *log, uint32_t sector,
+                              FAR const uint8_t *buffer, size_t nsectors,
+                              uint32_t reserve)
+{
+  FAR uint32_t *sectors;
+  uint32_t head;
+  uint32_t old;
+  ssize_t nxfrd;
+  size_t count;
+  size_t i;
+  int ret;
+
+  if (log->head == FTL_LOG_NONE)
+    {
+      ret = ftl_log_open(log, reserve);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  head  = log->head;
+  count = MIN(nsectors, (size_t)(log->blkper - log->nsum - log->headpage));
+
+  nxfrd = MTD_BWRITE(log->mtd, ftl_log_ppage(log, head, log->headpage),
+                     count, buffer);
+  if (nxfrd != count)
+    {
+      ferr("ERROR: Write %zu pages in block %" PRIu32 " failed: %zd\n",
+           count, head, nxfrd);
+
+      /* Don't write over what may have been programmed */
+
+      log->headpage = log->blkper - log->nsum;
+      ftl_log_seal(log);
+      return -EIO;
+    }
+
+  sectors = ftl_log_sectors(log->headsum);
+  for (i = 0; i < count; i++)
+    {
+      old = log->l2p[sector + i];
+      if (old != FTL_LOG_UNMAPPED)
+        {
+          log->blocks[old / log->blkper].valid--;
+        }
+
+      log->l2p[sector + i] = ftl_log_ppage(log, head, log->headpage + i);
+      sectors[log->headpage - 1 + i] = sector + i;
+    }
+
+  log->blocks[head].valid += count;
+  log->headpage           += count;
+
+  if (log->headpage >= log->blkper - log->nsum)
+    {
+      ret = ftl_log_seal(log);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: ftl_log_force
+ *
+ * Description:
+ *   Seal the head early so that the dirty blocks can be erased.
+ *
+ ****************************************************************************/
+
+static int ftl_log_force(FAR struct ftl_log_s *log)
+{
+  uint32_t nfree = log->nfree;
+
+  if (!ftl_log_hasdirty(log))
+    {
+      return -ENOSPC;
+    }
+
+  ftl_log_seal(log);
+  ftl_log_reclaim(log);
+
+  return log->nfree > nfree ? OK : -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: ftl_log_collect
+ *
+ * Description:
+ *   Collect one block:  the data block with the fewest valid pages or, if
+ *   wear is true, the one with the lowest erase count.  Its valid pages are
+ *   copied to the head and it is erased once that is sealed.
+ *
+ ****************************************************************************/
+
+static int ftl_log_collect(FAR struct ftl_log_s *log, bool wear)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->scratch;
+  FAR uint32_t *sectors = ftl_log_sectors(log->scratch);
+  uint32_t victim = FTL_LOG_NONE;
+  uint32_t block;
+  uint32_t phys;
+  ssize_t nxfrd;
+  int i;
+
+  /* Dirty blocks left by a mount or by earlier collections come first */
+
+  if ((log->head == FTL_LOG_NONE || log->headpage == 1) &&
+      ftl_log_hasdirty(log))
+    {
+      ftl_log_reclaim(log);
+      return OK;
+    }
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state != FTL_LOG_DATA)
+        {
+          continue;
+        }
+
+      if (victim == FTL_LOG_NONE ||
+          (wear && log->erasecnt[block] < log->erasecnt[victim]) ||
+          (!wear && log->blocks[block].valid < log->blocks[victim].valid))
+        {
+          victim = block;
+        }
+    }
+
+  if (victim == FTL_LOG_NONE ||
+      (!wear && log->blocks[victim].valid >= log->ndata))
+    {
+      return ftl_log_force(log);
+    }
+
+  nxfrd = MTD_BREAD(log->mtd,
+                    ftl_log_ppage(log, victim, log->blkper - log->nsum),
+                    log->nsum, log->scratch);
+  if (nxfrd != log->nsum || summary->magic != FTL_LOG_SUMMAGIC)
+    {
+      ferr("ERROR: Read summary of block %" PRIu32 " failed: %zd\n",
+           victim, nxfrd);
+      return -EIO;
+    }
+
+  finfo("Collect block %" PRIu32 " with %u valid pages\n",
+        victim, log->blocks[victim].valid);
+
+  for (i = 0; i < log->ndata && log->blocks[victim].valid > 0; i++)
+    {
+      phys = ftl_log_ppage(log, victim, i + 1);
+      if (sectors[i] >= log->nsectors || log->l2p[sectors[i]] != phys)
+        {
+          continue;
+        }
+
+      nxfrd = MTD_BREAD(log->mtd, phys, 1, log->page);
+      if (nxfrd != 1)
+        {
+          ferr("ERROR: Read page %" PRIu32 " failed: %zd\n", phys, nxfrd);
+          return -EIO;
+        }
+
+      nxfrd = ftl_log_append(log, sectors[i], log->page, 1, log->ncp);
+      if (nxfrd == -ENOSPC && ftl_log_force(log) == OK)
+        {
+          nxfrd = ftl_log_append(log, sectors[i], log->page, 1, log->ncp);
+        }
+
+      if (nxfrd < 0)
+        {
+          return nxfrd;
+        }
+    }
+
+  log->blocks[victim].state = FTL_LOG_DIRTY;
+  ftl_log_reclaim(log);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_stream
+ *
+ * Description:
+ *   Copy between a page and the checkpoint content:  the table followed by
+ *   the erase counts.  Loaded erase counts never lower the ones read from
+ *   the block headers.
+ *
+ ****************************************************************************/
+
+static void ftl_log_stream(FAR struct ftl_log_s *log, size_t pos,
+                           FAR uint8_t *buffer, bool save)
+{
+  size_t l2plen = log->nsectors * sizeof(uint32_t);
+  size_t total  = l2plen + log->nblocks * sizeof(uint32_t);
+  size_t len    = log->blocksize;
+  size_t n;
+  uint32_t value;
+
+  if (pos < l2plen)
+    {
+      n = MIN(len, l2plen - pos);
+      if (save)
+        {
+          memcpy(buffer, (FAR uint8_t *)log->l2p + pos, n);
+        }
+      else
+        {
+          memcpy((FAR uint8_t *)log->l2p + pos, buffer, n);
+        }
+
+      pos    += n;
+      buffer += n;
+      len    -= n;
+    }
+
+  for (; len >= sizeof(uint32_t) && pos < total;
+       pos += sizeof(uint32_t), buffer += sizeof(uint32_t),
+       len -= sizeof(uint32_t))
+    {
+      n = (pos - l2plen) / sizeof(uint32_t);
+      if (save)
+        {
+          memcpy(buffer, &log->erasecnt[n], sizeof(uint32_t));
+        }
+      else
+        {
+          memcpy(&value, buffer, sizeof(uint32_t));
+          log->erasecnt[n] = MAX(log->erasecnt[n], value);
+        }
+    }
+
+  if (save)
+    {
+      memset(buffer, log->erased, len);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_cppages
+ *
+ * Description:
+ *   Return the number of content pages in a part of the checkpoint.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_log_cppages(FAR struct ftl_log_s *log, uint8_t part)
+{
+  size_t total = (log->nsectors + log->nblocks) * sizeof(uint32_t);
+  size_t start = (size_t)part * (log->blkper - 2) * log->blocksize;
+
+  return MIN((total - start + log->blocksize - 1) / log->blocksize,
+             (size_t)(log->blkper - 2));
+}
+
+/****************************************************************************
+ * Name: ftl_log_checkpoint
+ *
+ * Description:
+ *   Seal the head and save the table and the erase counts in new blocks,
+ *   then erase the previous checkpoint.
+ *
+ ****************************************************************************/
+
+static int ftl_log_checkpoint(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->scratch;
+  uint32_t newstate = FTL_LOG_DIRTY;
+  uint32_t oldstate = FTL_LOG_CKPT;
+  uint32_t block;
+  uint32_t npages;
+  uint32_t crc;
+  uint32_t i;
+  ssize_t nxfrd;
+  size_t pos;
+  int part;
+  int ret;
+
+  ret = ftl_log_seal(log);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* A head holding just its header would be opened before the checkpoint,
+   * and not be replayed after it.
+   */
+
+  if (log->head != FTL_LOG_NONE)
+    {
+      log->blocks[log->head].state = FTL_LOG_DIRTY;
+      log->head = FTL_LOG_NONE;
+    }
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_CKPT)
+        {
+          log->blocks[block].state = FTL_LOG_OLDCKPT;
+        }
+    }
+
+  for (part = 0; part < log->ncp; part++)
+    {
+      ret = ftl_log_alloc(log, 0, &block);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      ret = ftl_log_writeheader(log, block, FTL_LOG_TYPE_CKPT, part);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      log->blocks[block].state = FTL_LOG_CKPT;
+
+      pos    = (size_t)part * (log->blkper - 2) * log->blocksize;
+      npages = ftl_log_cppages(log, part);
+      crc    = 0;
+
+      for (i = 1; i <= npages; i++, pos += log->blocksize)
+        {
+          ftl_log_stream(log, pos, log->page, true);
+          crc = crc32part(log->page, log->blocksize, crc);
+
+          nxfrd = MTD_BWRITE(log->mtd, ftl_log_ppage(log, block, i), 1,
+                             log->page);
+          if (nxfrd != 1)
+            {
+              ret = -EIO;
+              goto out;
+            }
+        }
+
+      memset(log->scratch, log->erased, log->blocksize);
+      summary->magic = FTL_LOG_SUMMAGIC;
+      summary->seq   = log->blocks[block].seq;
+      summary->crc   = crc;
+
+      nxfrd = MTD_BWRITE(log->mtd,
+                         ftl_log_ppage(log, block, log->blkper - 1), 1,
+                         log->scratch);
+      if (nxfrd != 1)
+        {
+          ret = -EIO;
+          goto out;
+        }
+    }
+
+  /* The new checkpoint is complete */
+
+  newstate     = FTL_LOG_CKPT;
+  oldstate     = FTL_LOG_DIRTY;
+  log->nsealed = 0;
+
+out:
+  if (ret < 0)
+    {
+      ferr("ERROR: Checkpoint failed: %d\n", ret);
+    }
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_CKPT)
+        {
+          log->blocks[block].state = newstate;
+        }
+      else if (log->blocks[block].state == FTL_LOG_OLDCKPT)
+        {
+          log->blocks[block].state = oldstate;
+        }
+    }
+
+  ftl_log_reclaim(log);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_unlevel
+ *
+ * Description:
+ *   Return true if the lowest erase count of the data blocks is too far
+ *   below the highest one.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_unlevel(FAR struct ftl_log_s *log)
+{
+  uint32_t mincnt = UINT32_MAX;
+  uint32_t maxcnt = 0;
+  uint32_t block;
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_DATA)
+        {
+          mincnt = MIN(mincnt, log->erasecnt[block]);
+        }
+
+      if (log->blocks[block].state != FTL_LOG_BAD)
+        {
+          maxcnt = MAX(maxcnt, log->erasecnt[block]);
+        }
+    }
+
+  return mincnt != UINT32_MAX &&
+         maxcnt - mincnt > CONFIG_FTL_LOG_WEAR_THRESHOLD;
+}
+
+/****************************************************************************
+ * Name: ftl_log_lowfree
+ ****************************************************************************/
+
+static bool ftl_log_lowfree(FAR struct ftl_log_s *log)
+{
+  return log->nfree < log->reserve + CONFIG_FTL_LOG_GC_FREE;
+}
+
+/****************************************************************************
+ * Name: ftl_log_kick
+ *
+ * Description:
+ *   Queue the background work if there are too few free blocks or if the
+ *   erase counts are too far apart.
+ *
+ ****************************************************************************/
+
+static void ftl_log_kick(FAR struct ftl_log_s *log)
+{
+  if (!log->stop && work_available(&log->work) &&
+      (ftl_log_lowfree(log) || ftl_log_unlevel(log)))
+    {
+      work_queue(LPWORK, &log->work, ftl_log_worker, log, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_worker
+ *
+ * Description:
+ *   Collect one block per run, so that writes are held up for one block
+ *   copy at most, and queue the next run while there is work left.
+ *
+ ****************************************************************************/
+
+static void ftl_log_worker(FAR void *arg)
+{
+  FAR struct ftl_log_s *log = arg;
+  int ret = -ENOSPC;
+
+  nxmutex_lock(&log->lock);
+
+  if (log->stop)
+    {
+      /* Being uninitialized */
+    }
+  else if (ftl_log_lowfree(log))
+    {
+      ret = ftl_log_collect(log, false);
+    }
+  else if (ftl_log_unlevel(log))
+    {
+      ret = ftl_log_collect(log, true);
+    }
+
+  if (ret >= 0)
+    {
+      ftl_log_kick(log);
+    }
+
+  nxmutex_unlock(&log->lock);
+}
+
+/****************************************************************************
+ * Name: ftl_log_validhdr
+ ****************************************************************************/
+
+static bool ftl_log_validhdr(FAR const struct ftl_log_header_s *header)
+{
+  return header->magic == FTL_LOG_MAGIC &&
+         header->crc == crc32((FAR const uint8_t *)header,
+                              offsetof(struct ftl_log_header_s, crc));
+}
+
+/****************************************************************************
+ * Name: ftl_log_isblank
+ ****************************************************************************/
+
+static bool ftl_log_isblank(FAR struct ftl_log_s *log,
+                            FAR const uint8_t *buffer)
+{
+  uint32_t i;
+
+  for (i = 0; i < log->blocksize; i++)
+    {
+      if (buffer[i] != log->erased)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_log_scan
+ *
+ * Description:
+ *   Read the header and the summary of a block to find its state.
+ *
+ ****************************************************************************/
+
+static void ftl_log_scan(FAR struct ftl_log_s *log, uint32_t block)
+{
+  FAR struct ftl_log_header_s *header =
+    (FAR struct ftl_log_header_s *)log->page;
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->scratch;
+  FAR struct ftl_log_block_s *blk = &log->blocks[block];
+  ssize_t nxfrd;
+
+  blk->state = FTL_LOG_DIRTY;
+
+  nxfrd = MTD_BREAD(log->mtd, ftl_log_ppage(log, block, 0), 1, log->page);
+  if (nxfrd != 1)
+    {
+      return;
+    }
+
+  if (!ftl_log_validhdr(header))
+    {
+      if (ftl_log_isblank(log, log->page))
+        {
+          blk->state = FTL_LOG_FREE;
+          log->nfree++;
+        }
+
+      return;
+    }
+
+  log->erasecnt[block] = header->erasecnt;
+  log->seq             = MAX(log->seq, header->seq + 1);
+  blk->seq             = header->seq;
+  blk->part            = header->part;
+
+  if (header->type == FTL_LOG_TYPE_DATA)
+    {
+      nxfrd = MTD_BREAD(log->mtd,
+                        ftl_log_ppage(log, block, log->blkper - log->nsum),
+                        log->nsum, log->scratch);
+      if (nxfrd == log->nsum && summary->magic == FTL_LOG_SUMMAGIC &&
+          summary->seq == blk->seq &&
+          summary->crc == crc32((FAR const uint8_t *)
+                                ftl_log_sectors(log->scratch),
+                                log->ndata * sizeof(uint32_t)))
+        {
+          blk->state = FTL_LOG_DATA;
+        }
+    }
+  else if (header->type == FTL_LOG_TYPE_CKPT &&
+           header->nparts == log->ncp && header->part < log->ncp &&
+           header->nsectors == log->nsectors)
+    {
+      nxfrd = MTD_BREAD(log->mtd,
+                        ftl_log_ppage(log, block, log->blkper - 1), 1,
+                        log->scratch);
+      if (nxfrd == 1 && summary->magic == FTL_LOG_SUMMAGIC &&
+          summary->seq == blk->seq)
+        {
+          blk->state = FTL_LOG_CKPT;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_findpart
+ ****************************************************************************/
+
+static uint32_t ftl_log_findpart(FAR struct ftl_log_s *log, uint32_t seq,
+                                 uint8_t part)
+{
+  uint32_t block;
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state == FTL_LOG_CKPT &&
+          log->blocks[block].seq == seq && log->blocks[block].part == part)
+        {
+          return block;
+        }
+    }
+
+  return FTL_LOG_NONE;
+}
+
+/****************************************************************************
+ * Name: ftl_log_loadckpt
+ *
+ * Description:
+ *   Load the latest complete checkpoint and mark the others dirty.
+ *
+ * Returned Value:
+ *   The sequence number of its first part, or FTL_LOG_NONE.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_log_loadckpt(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->scratch;
+  uint32_t base = FTL_LOG_NONE;
+  uint32_t block;
+  uint32_t npages;
+  uint32_t crc;
+  uint32_t i;
+  ssize_t nxfrd;
+  size_t pos;
+  int part;
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      FAR struct ftl_log_block_s *blk = &log->blocks[block];
+
+      if (blk->state != FTL_LOG_CKPT || blk->part != 0 ||
+          (base != FTL_LOG_NONE && blk->seq <= base))
+        {
+          continue;
+        }
+
+      for (part = 1; part < log->ncp; part++)
+        {
+          if (ftl_log_findpart(log, blk->seq + part, part) == FTL_LOG_NONE)
+            {
+              break;
+            }
+        }
+
+      if (part == log->ncp)
+        {
+          base = blk->seq;
+        }
+    }
+
+  for (part = 0; base != FTL_LOG_NONE && part < log->ncp; part++)
+    {
+      block  = ftl_log_findpart(log, base + part, part);
+      pos    = (size_t)part * (log->blkper - 2) * log->blocksize;
+      npages = ftl_log_cppages(log, part);
+      crc    = 0;
+
+      for (i = 1; i <= npages; i++, pos += log->blocksize)
+        {
+          nxfrd = MTD_BREAD(log->mtd, ftl_log_ppage(log, block, i), 1,
+                            log->page);
+          if (nxfrd != 1)
+            {
+              break;
+            }
+
+          crc = crc32part(log->page, log->blocksize, crc);
+          ftl_log_stream(log, pos, log->page, false);
+        }
+
+      nxfrd = MTD_BREAD(log->mtd, ftl_log_ppage(log, block, log->blkper - 1),
+                        1, log->scratch);
+      if (i <= npages || nxfrd != 1 || summary->crc != crc)
+        {
+          ferr("ERROR: Checkpoint %" PRIu32 " is corrupt\n", base);
+          memset(log->l2p, 0xff, log->nsectors * sizeof(uint32_t));
+          base = FTL_LOG_NONE;
+        }
+    }
+
+  /* Keep only the blocks of the checkpoint loaded */
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      FAR struct ftl_log_block_s *blk = &log->blocks[block];
+
+      if (blk->state == FTL_LOG_CKPT &&
+          (base == FTL_LOG_NONE || blk->seq < base ||
+           blk->seq >= base + log->ncp))
+        {
+          blk->state = FTL_LOG_DIRTY;
+        }
+    }
+
+  return base;
+}
+
+/****************************************************************************
+ * Name: ftl_log_replay
+ *
+ * Description:
+ *   Apply the summaries of the data blocks opened after the checkpoint, in
+ *   the order they were opened.
+ *
+ ****************************************************************************/
+
+static int ftl_log_replay(FAR struct ftl_log_s *log, uint32_t base)
+{
+  FAR uint32_t *sectors = ftl_log_sectors(log->scratch);
+  FAR uint32_t *order;
+  uint32_t norder = 0;
+  uint32_t block;
+  uint32_t i;
+  uint32_t j;
+  ssize_t nxfrd;
+
+  order = kmm_malloc(log->nblocks * sizeof(uint32_t));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Insertion sort of the blocks to replay by sequence number */
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      if (log->blocks[block].state != FTL_LOG_DATA ||
+          (base != FTL_LOG_NONE && log->blocks[block].seq < base))
+        {
+          continue;
+        }
+
+      for (j = norder; j > 0 &&
+           log->blocks[order[j - 1]].seq > log->blocks[block].seq; j--)
+        {
+          order[j] = order[j - 1];
+        }
+
+      order[j] = block;
+      norder++;
+    }
+
+  for (j = 0; j < norder; j++)
+    {
+      block = order[j];
+      nxfrd = MTD_BREAD(log->mtd,
+                        ftl_log_ppage(log, block, log->blkper - log->nsum),
+                        log->nsum, log->scratch);
+      if (nxfrd != log->nsum)
+        {
+          continue;
+        }
+
+      for (i = 0; i < log->ndata; i++)
+        {
+          if (sectors[i] < log->nsectors)
+            {
+              log->l2p[sectors[i]] = ftl_log_ppage(log, block, i + 1);
+            }
+        }
+    }
+
+  log->nsealed = base == FTL_LOG_NONE ? CONFIG_FTL_LOG_CHECKPOINT : norder;
+
+  kmm_free(order);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ ****************************************************************************/
+
+static int ftl_log_mount(FAR struct ftl_log_s *log)
+{
+  uint32_t block;
+  uint32_t base;
+  uint32_t page;
+  uint32_t i;
+  int ret;
+
+  memset(log->l2p, 0xff, log->nsectors * sizeof(uint32_t));
+
+  for (block = 0; block < log->nblocks; block++)
+    {
+      ftl_log_scan(log, block);
+    }
+
+  base = ftl_log_loadckpt(log);
+  ret  = ftl_log_replay(log, base);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Count the valid pages, dropping what points out of the data blocks */
+
+  for (i = 0; i < log->nsectors; i++)
+    {
+      if (log->l2p[i] == FTL_LOG_UNMAPPED)
+        {
+          continue;
+        }
+
+      block = log->l2p[i] / log->blkper;
+      page  = log->l2p[i] % log->blkper;
+      if (block >= log->nblocks ||
+          log->blocks[block].state != FTL_LOG_DATA ||
+          page < 1 || page > log->ndata)
+        {
+          log->l2p[i] = FTL_LOG_UNMAPPED;
+          continue;
+        }
+
+      log->blocks[block].valid++;
+    }
+
+  finfo("Mounted %" PRIu32 " sectors, %" PRIu32 " free blocks, "
+        "checkpoint %" PRIu32 "\n", log->nsectors, log->nfree, base);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ ****************************************************************************/
+
+int ftl_log_initialize(FAR struct mtd_dev_s *mtd,
+                       FAR const struct mtd_geometry_s *geo,
+                       FAR struct ftl_log_s **logp)
+{
+  FAR struct ftl_log_s *log;
+  uint32_t overhead = 0;
+  size_t cpsize;
+  int ret;
+
+  log = kmm_zalloc(sizeof(struct ftl_log_s));
+  if (log == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  log->mtd       = mtd;
+  log->blocksize = geo->blocksize;
+  log->nblocks   = geo->neraseblocks;
+  log->blkper    = geo->erasesize / geo->blocksize;
+  log->head      = FTL_LOG_NONE;
+
+  if (MTD_IOCTL(mtd, MTDIOC_ERASESTATE,
+                (unsigned long)((uintptr_t)&log->erased)) < 0)
+    {
+      log->erased = 0xff;
+    }
+
+  /* The summary takes the last pages of each block, as many as are needed
+   * for the sector of each of the others but the header.
+   */
+
+  for (log->nsum = 1; log->nsum < log->blkper; log->nsum++)
+    {
+      log->ndata = log->blkper - 1 - log->nsum;
+      if (sizeof(struct ftl_log_summary_s) + log->ndata * sizeof(uint32_t) <=
+          log->nsum * log->blocksize)
+        {
+          break;
+        }
+    }
+
+  /* Grow the checkpoint until it holds the table, which shrinks with it */
+
+  for (log->ncp = 1; log->blkper > 2 && log->ncp < UINT8_MAX; log->ncp++)
+    {
+      overhead = 2 * log->ncp + FTL_LOG_GCBLOCKS + CONFIG_FTL_LOG_SPARE;
+      if (log->nblocks <= overhead || log->ndata == 0)
+        {
+          break;
+        }
+
+      log->nsectors = (log->nblocks - overhead) * log->ndata;
+      cpsize        = (log->nsectors + log->nblocks) * sizeof(uint32_t);
+      if (cpsize <= (size_t)log->ncp * (log->blkper - 2) * log->blocksize)
+        {
+          break;
+        }
+    }
+
+  if (log->blkper <= 2 || log->ndata == 0 || log->nblocks <= overhead ||
+      log->ncp >= UINT8_MAX)
+    {
+      ferr("ERROR: Geometry not supported\n");
+      kmm_free(log);
+      return -EINVAL;
+    }
+
+  log->reserve = log->ncp + FTL_LOG_GCBLOCKS;
+
+  log->l2p      = kmm_malloc(log->nsectors * sizeof(uint32_t));
+  log->erasecnt = kmm_zalloc(log->nblocks * sizeof(uint32_t));
+  log->blocks   = kmm_zalloc(log->nblocks * sizeof(struct ftl_log_block_s));
+  log->headsum  = kmm_malloc(log->nsum * log->blocksize);
+  log->scratch  = kmm_malloc(log->nsum * log->blocksize);
+  log->page     = kmm_malloc(log->blocksize);
+
+  if (log->l2p == NULL || log->erasecnt == NULL || log->blocks == NULL ||
+      log->headsum == NULL || log->scratch == NULL || log->page == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  nxmutex_init(&log->lock);
+
+  ret = ftl_log_mount(log);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&log->lock);
+      goto errout;
+    }
+
+  ftl_log_kick(log);
+
+  *logp = log;
+  return OK;
+
+errout:
+  kmm_free(log->page);
+  kmm_free(log->scratch);
+  kmm_free(log->headsum);
+  kmm_free(log->blocks);
+  kmm_free(log->erasecnt);
+  kmm_free(log->l2p);
+  kmm_free(log);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_uninitialize
+ ****************************************************************************/
+
+void ftl_log_uninitialize(FAR struct ftl_log_s *log)
+{
+  nxmutex_lock(&log->lock);
+  log->stop = true;
+  nxmutex_unlock(&log->lock);
+
+  work_cancel(LPWORK, &log->work);
+
+  nxmutex_lock(&log->lock);
+  if (log->nsealed > 0 ||
+      (log->head != FTL_LOG_NONE && log->headpage > 1))
+    {
+      ftl_log_checkpoint(log);
+    }
+
+  nxmutex_unlock(&log->lock);
+  nxmutex_destroy(&log->lock);
+
+  kmm_free(log->page);
+  kmm_free(log->scratch);
+  kmm_free(log->headsum);
+  kmm_free(log->blocks);
+  kmm_free(log->erasecnt);
+  kmm_free(log->l2p);
+  kmm_free(log);
+}
+
+/****************************************************************************
+ * Name: ftl_log_nsectors
+ ****************************************************************************/
+
+blkcnt_t ftl_log_nsectors(FAR struct ftl_log_s *log)
+{
+  return log->nsectors;
+}
+
+/****************************************************************************
+ * Name: ftl_log_read
+ ****************************************************************************/
+
+ssize_t ftl_log_read(FAR struct ftl_log_s *log, FAR uint8_t *buffer,
+                     off_t startblock, size_t nblocks)
+{
+  uint32_t sector;
+  uint32_t phys;
+  size_t remaining;
+  size_t count;
+  ssize_t nxfrd;
+
+  if (startblock < 0 || startblock + nblocks > log->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&log->lock);
+
+  for (sector = startblock, remaining = nblocks; remaining > 0;
+       sector += count, remaining -= count,
+       buffer += count * log->blocksize)
+    {
+      /* Read the sectors that follow each other on the flash at once */
+
+      phys = log->l2p[sector];
+      for (count = 1; count < remaining; count++)
+        {
+          if (phys == FTL_LOG_UNMAPPED ?
+              log->l2p[sector + count] != FTL_LOG_UNMAPPED :
+              log->l2p[sector + count] != phys + count)
+            {
+              break;
+            }
+        }
+
+      if (phys == FTL_LOG_UNMAPPED)
+        {
+          memset(buffer, log->erased, count * log->blocksize);
+          continue;
+        }
+
+      nxfrd = MTD_BREAD(log->mtd, phys, count, buffer);
+      if (nxfrd != count)
+        {
+          ferr("ERROR: Read %zu pages at %" PRIu32 " failed: %zd\n",
+               count, phys, nxfrd);
+          nxmutex_unlock(&log->lock);
+          return -EIO;
+        }
+    }
+
+  nxmutex_unlock(&log->lock);
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ ****************************************************************************/
+
+ssize_t ftl_log_write(FAR struct ftl_log_s *log, FAR const uint8_t *buffer,
+                      off_t startblock, size_t nblocks)
+{
+  uint32_t sector;
+  size_t remaining;
+  ssize_t nxfrd;
+
+  if (startblock < 0 || startblock + nblocks > log->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&log->lock);
+
+  for (sector = startblock, remaining = nblocks; remaining > 0; )
+    {
+      nxfrd = ftl_log_append(log, sector, buffer, remaining, log->reserve);
+      if (nxfrd == -ENOSPC)
+        {
+          /* Out of free blocks: collect in the foreground */
+
+          nxfrd = ftl_log_collect(log, false);
+          if (nxfrd >= 0)
+            {
+              continue;
+            }
+        }
+
+      if (nxfrd < 0)
+        {
+          nxmutex_unlock(&log->lock);
+          return nxfrd;
+        }
+
+      sector    += nxfrd;
+      remaining -= nxfrd;
+      buffer    += nxfrd * log->blocksize;
+    }
+
+  ftl_log_kick(log);
+  nxmutex_unlock(&log->lock);
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_log_flush
+ ****************************************************************************/
+
+int ftl_log_flush(FAR struct ftl_log_s *log)
+{
+  int ret;
+
+  nxmutex_lock(&log->lock);
+
+  ret = ftl_log_seal(log);
+  if (ret >= 0 && log->nsealed >= CONFIG_FTL_LOG_CHECKPOINT)
+    {
+      ret = ftl_log_checkpoint(log);
+    }
+
+  ftl_log_kick(log);
+  nxmutex_unlock(&log->lock);
+  return ret;
+}
+
+#endif /* CONFIG_FTL_LOG */
@@ -0,0 +1,122 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_MTD_FTL_LOG_H
+#define __DRIVERS_MTD_FTL_LOG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/mtd/mtd.h>
+
+#ifdef CONFIG_FTL_LOG
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct ftl_log_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Mount the log structured translation layer of an MTD device, from its
+ *   last checkpoint and the blocks written after it.  The blocks that don't
+ *   belong to it are erased as the space is needed.
+ *
+ * Input Parameters:
+ *   mtd - The MTD device
+ *   geo - Its geometry
+ *   log - The location to return the new instance
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ftl_log_initialize(FAR struct mtd_dev_s *mtd,
+                       FAR const struct mtd_geometry_s *geo,
+                       FAR struct ftl_log_s **log);
+
+/****************************************************************************
+ * Name: ftl_log_uninitialize
+ *
+ * Description:
+ *   Write a checkpoint if needed and free the instance.
+ *
+ ****************************************************************************/
+
+void ftl_log_uninitialize(FAR struct ftl_log_s *log);
+
+/****************************************************************************
+ * Name: ftl_log_nsectors
+ *
+ * Description:
+ *   Return the number of logical sectors, of the size of the MTD blocks.
+ *
+ ****************************************************************************/
+
+blkcnt_t ftl_log_nsectors(FAR struct ftl_log_s *log);
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:
+ *   Read logical sectors.  Sectors never written read as erased.
+ *
+ ****************************************************************************/
+
+ssize_t ftl_log_read(FAR struct ftl_log_s *log, FAR uint8_t *buffer,
+                     off_t startblock, size_t nblocks);
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description:
+ *   Write logical sectors at the head of the log.
+ *
+ ****************************************************************************/
+
+ssize_t ftl_log_write(FAR struct ftl_log_s *log, FAR const uint8_t *buffer,
+                      off_t startblock, size_t nblocks);
+
+/****************************************************************************
+ * Name: ftl_log_flush
+ *
+ * Description:
+ *   Make the sectors written so far survive a power loss, and write a
+ *   checkpoint if enough blocks were written since the last one.
+ *
+ ****************************************************************************/
+
+int ftl_log_flush(FAR struct ftl_log_s *log);
+
+#endif /* CONFIG_FTL_LOG */
+#endif /* __DRIVERS_MTD_FTL_LOG_H */
@@ -0,0 +1,608 @@
+/****************************************************************************
+ * drivers/mtd/mtd_bgerase.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* MTD driver that contains another MTD driver and erases in the background.
+ *
+ * An erase only marks the erase blocks as pending and returns.  They are
+ * erased one at a time from the low priority work queue, with some time
+ * in between so that the other accesses can run while the part is busy.
+ * Meanwhile, reads of a pending block return the erased state without
+ * touching the FLASH, and the first write to it erases it first.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+#ifdef CONFIG_MTD_BGERASE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BGERASE_DELAY      MSEC2TICK(CONFIG_MTD_BGERASE_INTERVAL)
+
+#define BGERASE_ISSET(p,b) (((p)->pending[(b) >> 3] & (1 << ((b) & 7))) != 0)
+#define BGERASE_SET(p,b)   do { (p)->pending[(b) >> 3] |= 1 << ((b) & 7); } \
+                           while (0)
+#define BGERASE_CLR(p,b)   do { (p)->pending[(b) >> 3] &= ~(1 << ((b) & 7)); } \
+                           while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This type represents the state of the MTD device.
+ * The struct mtd_dev_s must appear at the beginning of the definition so
+ * that you can freely cast between pointers to struct mtd_dev_s and struct
+ * mtd_bgerase_s.
+ */
+
+struct mtd_bgerase_s
+{
+  struct mtd_dev_s       mtd;         /* Our exported MTD interface */
+  FAR struct mtd_dev_s  *dev;         /* Saved lower level MTD interface */
+  mutex_t                lock;        /* Serializes the accesses */
+  struct work_s          work;        /* Background erase work */
+  uint32_t               blkpererase; /* Blocks per erase block */
+  uint32_t               erasesize;   /* Size of an erase block */
+  uint32_t               neraseblocks; /* Number of erase blocks */
+  uint32_t               npending;    /* Number of pending erase blocks */
+  uint32_t               next;        /* Next erase block to look at */
+  uint8_t                erasestate;  /* The value of erased bytes */
+  FAR uint8_t           *pending;     /* One bit per erase block */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* MTD driver methods */
+
+static int mtd_bgerase_erase(FAR struct mtd_dev_s *dev, off_t startblock,
+                             size_t nblocks);
+static ssize_t mtd_bgerase_bread(FAR struct mtd_dev_s *dev,
+                                 off_t startblock, size_t nblocks,
+                                 FAR uint8_t *buf);
+static ssize_t mtd_bgerase_bwrite(FAR struct mtd_dev_s *dev,
+                                  off_t startblock, size_t nblocks,
+                                  FAR const uint8_t *buf);
+static ssize_t mtd_bgerase_read(FAR struct mtd_dev_s *dev, off_t offset,
+                                size_t nbytes, FAR uint8_t *buffer);
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_bgerase_write(FAR struct mtd_dev_s *dev, off_t offset,
+                                 size_t nbytes, FAR const uint8_t *buffer);
+#endif
+static int mtd_bgerase_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_bgerase_now
+ *
+ * Description:
+ *   Erase a pending erase block in the foreground.  It is no longer
+ *   pending, even if the erase failed.
+ *
+ ****************************************************************************/
+
+static int mtd_bgerase_now(FAR struct mtd_bgerase_s *priv, uint32_t block)
+{
+  int ret;
+
+  BGERASE_CLR(priv, block);
+  priv->npending--;
+
+  ret = MTD_ERASE(priv->dev, block, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase of block %" PRIu32 " failed: %d\n", block, ret);
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_range
+ *
+ * Description:
+ *   Erase the pending erase blocks that a write is about to touch.  The
+ *   range is in units of erasesize / per bytes.
+ *
+ ****************************************************************************/
+
+static int mtd_bgerase_range(FAR struct mtd_bgerase_s *priv, off_t pos,
+                             size_t count, uint32_t per)
+{
+  uint32_t block;
+  uint32_t last;
+  int ret;
+
+  if (priv->npending == 0 || count == 0)
+    {
+      return OK;
+    }
+
+  last = (pos + count - 1) / per;
+  for (block = pos / per; block <= last; block++)
+    {
+      if (block < priv->neraseblocks && BGERASE_ISSET(priv, block))
+        {
+          ret = mtd_bgerase_now(priv, block);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_run
+ *
+ * Description:
+ *   Return how many units from pos on are in erase blocks that are all
+ *   pending or all not pending, and which of the two it is.
+ *
+ ****************************************************************************/
+
+static size_t mtd_bgerase_run(FAR struct mtd_bgerase_s *priv, off_t pos,
+                              size_t count, uint32_t per,
+                              FAR bool *pending)
+{
+  uint32_t block = pos / per;
+  size_t n = per - pos % per;
+
+  *pending = block < priv->neraseblocks && BGERASE_ISSET(priv, block);
+  while (n < count && ++block < priv->neraseblocks &&
+         BGERASE_ISSET(priv, block) == *pending)
+    {
+      n += per;
+    }
+
+  return MIN(n, count);
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_worker
+ *
+ * Description:
+ *   Erase the next pending erase block and schedule the following one.
+ *
+ ****************************************************************************/
+
+static void mtd_bgerase_worker(FAR void *arg)
+{
+  FAR struct mtd_bgerase_s *priv = arg;
+  uint32_t i;
+
+  nxmutex_lock(&priv->lock);
+
+  for (i = 0; i < priv->neraseblocks && priv->npending > 0; i++)
+    {
+      uint32_t block = priv->next;
+
+      if (++priv->next >= priv->neraseblocks)
+        {
+          priv->next = 0;
+        }
+
+      if (BGERASE_ISSET(priv, block))
+        {
+          mtd_bgerase_now(priv, block);
+          break;
+        }
+    }
+
+  if (priv->npending > 0)
+    {
+      work_queue(LPWORK, &priv->work, mtd_bgerase_worker, priv,
+                 BGERASE_DELAY);
+    }
+
+  nxmutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_flush
+ *
+ * Description:
+ *   Perform all the pending erases now.
+ *
+ ****************************************************************************/
+
+static int mtd_bgerase_flush(FAR struct mtd_bgerase_s *priv)
+{
+  uint32_t block;
+  int ret = OK;
+
+  for (block = 0; block < priv->neraseblocks && priv->npending > 0;
+       block++)
+    {
+      if (BGERASE_ISSET(priv, block))
+        {
+          int err = mtd_bgerase_now(priv, block);
+          if (err < 0)
+            {
+              ret = err;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_erase
+ ****************************************************************************/
+
+static int mtd_bgerase_erase(FAR struct mtd_dev_s *dev, off_t startblock,
+                             size_t nblocks)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  uint32_t block;
+  int ret;
+
+  if (startblock < 0 || startblock + nblocks > priv->neraseblocks)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (block = startblock; block < startblock + nblocks; block++)
+    {
+      if (!BGERASE_ISSET(priv, block))
+        {
+          BGERASE_SET(priv, block);
+          priv->npending++;
+        }
+    }
+
+  if (priv->npending > 0 && work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, mtd_bgerase_worker, priv,
+                 BGERASE_DELAY);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return (int)nblocks;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_bread
+ ****************************************************************************/
+
+static ssize_t mtd_bgerase_bread(FAR struct mtd_dev_s *dev,
+                                 off_t startblock, size_t nblocks,
+                                 FAR uint8_t *buf)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  size_t blocksize = priv->erasesize / priv->blkpererase;
+  size_t remaining = nblocks;
+  ssize_t ret;
+  bool pending;
+  size_t n;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      n = mtd_bgerase_run(priv, startblock, remaining, priv->blkpererase,
+                          &pending);
+      if (pending)
+        {
+          memset(buf, priv->erasestate, n * blocksize);
+        }
+      else
+        {
+          ret = MTD_BREAD(priv->dev, startblock, n, buf);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      startblock += n;
+      buf        += n * blocksize;
+      remaining  -= n;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret < 0 ? ret : (ssize_t)nblocks;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_bwrite
+ ****************************************************************************/
+
+static ssize_t mtd_bgerase_bwrite(FAR struct mtd_dev_s *dev,
+                                  off_t startblock, size_t nblocks,
+                                  FAR const uint8_t *buf)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = mtd_bgerase_range(priv, startblock, nblocks, priv->blkpererase);
+  if (ret >= 0)
+    {
+      ret = MTD_BWRITE(priv->dev, startblock, nblocks, buf);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_read
+ ****************************************************************************/
+
+static ssize_t mtd_bgerase_read(FAR struct mtd_dev_s *dev, off_t offset,
+                                size_t nbytes, FAR uint8_t *buffer)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  size_t remaining = nbytes;
+  ssize_t ret;
+  bool pending;
+  size_t n;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      n = mtd_bgerase_run(priv, offset, remaining, priv->erasesize,
+                          &pending);
+      if (pending)
+        {
+          memset(buffer, priv->erasestate, n);
+        }
+      else
+        {
+          ret = MTD_READ(priv->dev, offset, n, buffer);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      offset    += n;
+      buffer    += n;
+      remaining -= n;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret < 0 ? ret : (ssize_t)nbytes;
+}
+
+/****************************************************************************
+ * Name: mtd_bgerase_write
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_bgerase_write(FAR struct mtd_dev_s *dev, off_t offset,
+                                 size_t nbytes, FAR const uint8_t *buffer)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = mtd_bgerase_range(priv, offset, nbytes, priv->erasesize);
+  if (ret >= 0)
+    {
+      ret = MTD_WRITE(priv->dev, offset, nbytes, buffer);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mtd_bgerase_ioctl
+ ****************************************************************************/
+
+static int mtd_bgerase_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                             unsigned long arg)
+{
+  FAR struct mtd_bgerase_s *priv = (FAR struct mtd_bgerase_s *)dev;
+  int ret;
+
+  if (cmd == MTDIOC_ERASESECTORS)
+    {
+      FAR struct mtd_erase_s *erase = (FAR struct mtd_erase_s *)arg;
+
+      return mtd_bgerase_erase(dev, erase->startblock, erase->nblocks);
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+
+        /* The pending erases are done before the lower half flushes */
+
+        ret = mtd_bgerase_flush(priv);
+        if (ret >= 0)
+          {
+            ret = MTD_IOCTL(priv->dev, cmd, arg);
+            if (ret == -ENOTTY)
+              {
+                ret = OK;
+              }
+          }
+        break;
+
+      case MTDIOC_BULKERASE:
+
+        /* Nothing left to erase afterwards */
+
+        memset(priv->pending, 0, (priv->neraseblocks + 7) / 8);
+        priv->npending = 0;
+        ret = MTD_IOCTL(priv->dev, cmd, arg);
+        break;
+
+      default:
+        ret = MTD_IOCTL(priv->dev, cmd, arg);
+        break;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_bgerase_initialize
+ *
+ * Description:
+ *   Create an MTD device that contains another one and performs its erases
+ *   in the background.  See mtd.h.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_dev_s *mtd_bgerase_initialize(FAR struct mtd_dev_s *mtd)
+{
+  FAR struct mtd_bgerase_s *priv;
+  struct mtd_geometry_s geo;
+  int ret;
+
+  finfo("mtd: %p\n", mtd);
+  DEBUGASSERT(mtd && mtd->ioctl);
+
+  /* Get the device geometry */
+
+  ret = mtd->ioctl(mtd, MTDIOC_GEOMETRY, (unsigned long)((uintptr_t)&geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTDIOC_GEOMETRY ioctl failed: %d\n", ret);
+      return NULL;
+    }
+
+  priv = (FAR struct mtd_bgerase_s *)
+          kmm_zalloc(sizeof(struct mtd_bgerase_s) +
+                     (geo.neraseblocks + 7) / 8);
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate mtd_bgerase\n");
+      return NULL;
+    }
+
+  priv->erasestate = 0xff;
+  ret = mtd->ioctl(mtd, MTDIOC_ERASESTATE,
+                   (unsigned long)((uintptr_t)&priv->erasestate));
+  if (ret < 0 && ret != -ENOTTY)
+    {
+      ferr("ERROR: MTDIOC_ERASESTATE ioctl failed: %d\n", ret);
+      kmm_free(priv);
+      return NULL;
+    }
+
+  /* Initialize the allocated structure. (unsupported methods/fields
+   * were already nullified by kmm_zalloc).
+   */
+
+  priv->mtd.erase    = mtd_bgerase_erase;
+  priv->mtd.bread    = mtd_bgerase_bread;
+  priv->mtd.bwrite   = mtd_bgerase_bwrite;
+  if (mtd->read != NULL)
+    {
+      priv->mtd.read = mtd_bgerase_read;
+    }
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (mtd->write != NULL)
+    {
+      priv->mtd.write = mtd_bgerase_write;
+    }
+#endif
+
+  priv->mtd.ioctl    = mtd_bgerase_ioctl;
+  priv->mtd.name     = "bgerase";
+
+  priv->dev          = mtd;
+  priv->blkpererase  = geo.erasesize / geo.blocksize;
+  priv->erasesize    = geo.erasesize;
+  priv->neraseblocks = geo.neraseblocks;
+  priv->pending      = (FAR uint8_t *)(priv + 1);
+  DEBUGASSERT(priv->blkpererase * geo.blocksize == geo.erasesize);
+
+  nxmutex_init(&priv->lock);
+
+  /* Return the implementation-specific state structure as the MTD device */
+
+  return &priv->mtd;
+}
+
+#endif /* CONFIG_MTD_BGERASE */
@@ -81,10 +81,26 @@
 
 #define NVS_SPECIAL_ATE_ID              0xffffffff
 
+/* The index starts with this many slots and doubles when it is 3/4 full.
+ * A slot with an id of 0 is free, hash ids are never 0.
+ */
+
+#define NVS_INDEX_MINSLOTS              16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* Index of the live ates:  hash id -> ate address */
+
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+struct nvs_slot
+{
+  uint32_t id;                         /* Hash id, 0 if free */
+  uint32_t addr;                       /* Address of the ate */
+};
+#endif
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -98,6 +114,11 @@ struct nvs_fs
   uint32_t              data_wra;      /* Next data write address */
   uint32_t              step_addr;     /* For traverse */
   mutex_t               nvs_lock;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  FAR struct nvs_slot   *index;        /* NULL: Walk the ates instead */
+  uint32_t              nslots;        /* Size of index, a power of 2 */
+  uint32_t              nused;         /* Slots in use */
+#endif
 };
 
 /* Allocation Table Entry */
@@ -835,6 +856,376 @@ static int nvs_expire_ate(FAR struct nvs_fs *fs, uint32_t addr)
                        &expired, sizeof(expired));
 }
 
+/****************************************************************************
+ * Name: nvs_index_free
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+static void nvs_index_free(FAR struct nvs_fs *fs)
+{
+  kmm_free(fs->index);
+  fs->index = NULL;
+  fs->nslots = 0;
+  fs->nused = 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_put
+ *
+ * Description:
+ *   Store an ate address in the first free slot of its probe sequence.
+ *   There must be a free slot.
+ *
+ ****************************************************************************/
+
+static void nvs_index_put(FAR struct nvs_fs *fs, uint32_t id, uint32_t addr)
+{
+  uint32_t mask = fs->nslots - 1;
+  uint32_t i = id & mask;
+
+  while (fs->index[i].id != 0)
+    {
+      i = (i + 1) & mask;
+    }
+
+  fs->index[i].id = id;
+  fs->index[i].addr = addr;
+  fs->nused++;
+}
+
+/****************************************************************************
+ * Name: nvs_index_insert
+ *
+ * Description:
+ *   Add the address of a new live ate, growing the index if needed.  If
+ *   it can't grow the index is dropped and the lookups walk the flash.
+ *
+ ****************************************************************************/
+
+static void nvs_index_insert(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr)
+{
+  FAR struct nvs_slot *old;
+  uint32_t nslots;
+  uint32_t i;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  if ((fs->nused + 1) * 4 > fs->nslots * 3)
+    {
+      old = fs->index;
+      nslots = fs->nslots;
+
+      fs->index = kmm_zalloc(2 * nslots * sizeof(struct nvs_slot));
+      if (fs->index == NULL)
+        {
+          ferr("ERROR: Failed to grow the index, %" PRIu32 " slots\n",
+               2 * nslots);
+          fs->index = old;
+          nvs_index_free(fs);
+          return;
+        }
+
+      fs->nslots = 2 * nslots;
+      fs->nused = 0;
+      for (i = 0; i < nslots; i++)
+        {
+          if (old[i].id != 0)
+            {
+              nvs_index_put(fs, old[i].id, old[i].addr);
+            }
+        }
+
+      kmm_free(old);
+    }
+
+  nvs_index_put(fs, id, addr);
+}
+
+/****************************************************************************
+ * Name: nvs_index_slot
+ *
+ * Description:
+ *   Return the slot of an ate address, or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int nvs_index_slot(FAR struct nvs_fs *fs, uint32_t id, uint32_t addr)
+{
+  uint32_t mask = fs->nslots - 1;
+  uint32_t i = id & mask;
+
+  while (fs->index[i].id != 0)
+    {
+      if (fs->index[i].id == id && fs->index[i].addr == addr)
+        {
+          return i;
+        }
+
+      i = (i + 1) & mask;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_index_update
+ *
+ * Description:
+ *   Move a live ate:  it was overwritten by a new entry or copied by gc.
+ *
+ ****************************************************************************/
+
+static void nvs_index_update(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr, uint32_t new_addr)
+{
+  int i;
+
+  if (fs->index != NULL)
+    {
+      i = nvs_index_slot(fs, id, addr);
+      if (i >= 0)
+        {
+          fs->index[i].addr = new_addr;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_remove
+ *
+ * Description:
+ *   Forget a deleted ate.  The slots that follow it in the same probe run
+ *   are moved back, so that no lookup ever stops early.
+ *
+ ****************************************************************************/
+
+static void nvs_index_remove(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr)
+{
+  uint32_t mask;
+  uint32_t home;
+  uint32_t i;
+  uint32_t j;
+  int slot;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  slot = nvs_index_slot(fs, id, addr);
+  if (slot < 0)
+    {
+      return;
+    }
+
+  mask = fs->nslots - 1;
+  i = slot;
+  j = slot;
+  while (1)
+    {
+      j = (j + 1) & mask;
+      if (fs->index[j].id == 0)
+        {
+          break;
+        }
+
+      /* Leave the slot alone if its home is cyclically within (i, j] */
+
+      home = fs->index[j].id & mask;
+      if (i <= j ? (home <= i || home > j) : (home <= i && home > j))
+        {
+          fs->index[i] = fs->index[j];
+          i = j;
+        }
+    }
+
+  fs->index[i].id = 0;
+  fs->nused--;
+}
+
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Index all the live ates, with a single walk through the flash.  The
+ *   startup leaves at most one live ate per key.
+ *
+ ****************************************************************************/
+
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  struct nvs_ate wlk_ate;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  int rc;
+
+  nvs_index_free(fs);
+
+  fs->index = kmm_zalloc(NVS_INDEX_MINSLOTS * sizeof(struct nvs_slot));
+  if (fs->index == NULL)
+    {
+      ferr("ERROR: No memory for the index\n");
+      return OK;
+    }
+
+  fs->nslots = NVS_INDEX_MINSLOTS;
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      if (rc)
+        {
+          nvs_index_free(fs);
+          return rc;
+        }
+
+      if (nvs_ate_valid(fs, &wlk_ate) &&
+          wlk_ate.id != NVS_SPECIAL_ATE_ID &&
+          wlk_ate.expired == fs->erasestate)
+        {
+          nvs_index_insert(fs, wlk_ate.id, rd_addr);
+        }
+    }
+  while (wlk_addr != fs->ate_wra && fs->index != NULL);
+
+  finfo("%" PRIu32 " items indexed in %" PRIu32 " slots\n",
+        fs->nused, fs->nslots);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nvs_index_find
+ *
+ * Description:
+ *   Look a key up in the index.  As different keys can have the same hash
+ *   id, the key stored with each candidate ate is compared.
+ *
+ ****************************************************************************/
+
+static int nvs_index_find(FAR struct nvs_fs *fs, uint32_t hash_id,
+                          FAR const uint8_t *key, size_t key_size,
+                          FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
+{
+  uint32_t mask = fs->nslots - 1;
+  uint32_t i = hash_id & mask;
+  uint32_t addr;
+  int rc;
+
+  for (; fs->index[i].id != 0; i = (i + 1) & mask)
+    {
+      if (fs->index[i].id != hash_id)
+        {
+          continue;
+        }
+
+      addr = fs->index[i].addr;
+      rc = nvs_flash_ate_rd(fs, addr, ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (ate->key_len == key_size &&
+          !nvs_flash_block_cmp(fs, (addr & ADDR_BLOCK_MASK) + ate->offset,
+                               key, key_size))
+        {
+          *ate_addr = addr;
+          return OK;
+        }
+
+      fwarn("hash conflict\n");
+    }
+
+  return -ENOENT;
+}
+#else
+#  define nvs_index_free(fs)
+#  define nvs_index_insert(fs, id, addr) UNUSED(addr)
+#  define nvs_index_update(fs, id, addr, new_addr) UNUSED(new_addr)
+#  define nvs_index_remove(fs, id, addr)
+#  define nvs_index_build(fs) OK
+#endif
+
+/****************************************************************************
+ * Name: nvs_find_entry
+ *
+ * Description:
+ *   Find the live ate of a key, with the index or by walking through the
+ *   allocation entry list from the newest entry.
+ *
+ * Input Parameters:
+ *   fs       - Pointer to file system.
+ *   hash_id  - Hash id of the key.
+ *   key      - Key of the entry.
+ *   key_size - Size of key.
+ *   ate      - Location to return the ate.
+ *   ate_addr - Location to return the address of the ate.
+ *
+ * Returned Value:
+ *   0 on success, -ENOENT if the key doesn't exist or is deleted, other
+ *   -ERRNO codes on flash errors.
+ *
+ ****************************************************************************/
+
+static int nvs_find_entry(FAR struct nvs_fs *fs, uint32_t hash_id,
+                          FAR const uint8_t *key, size_t key_size,
+                          FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
+{
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  int rc;
+
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  if (fs->index != NULL)
+    {
+      return nvs_index_find(fs, hash_id, key, key_size, ate, ate_addr);
+    }
+#endif
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, ate);
+      if (rc)
+        {
+          ferr("Walk to previous ate failed, rc=%d\n", rc);
+          return rc;
+        }
+
+      if ((ate->id == hash_id) && (nvs_ate_valid(fs, ate)))
+        {
+          if ((ate->key_len == key_size)
+              && (!nvs_flash_block_cmp(fs,
+              (rd_addr & ADDR_BLOCK_MASK) + ate->offset, key, key_size)))
+            {
+              /* It is old or deleted, return -ENOENT */
+
+              if (ate->expired != fs->erasestate)
+                {
+                  return -ENOENT;
+                }
+
+              *ate_addr = rd_addr;
+              return OK;
+            }
+          else
+            {
+              fwarn("hash conflict\n");
+            }
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Name: nvs_gc
  *
@@ -855,6 +1246,7 @@ static int nvs_gc(FAR struct nvs_fs *fs)
   uint32_t gc_prev_addr;
   uint32_t data_addr;
   uint32_t stop_addr;
+  uint32_t new_addr;
 
   finfo("gc: before gc, ate_wra %" PRIx32 "\n", fs->ate_wra);
 
@@ -938,11 +1330,14 @@ static int nvs_gc(FAR struct nvs_fs *fs)
               return rc;
             }
 
+          new_addr = fs->ate_wra;
           rc = nvs_flash_ate_wrt(fs, &gc_ate);
           if (rc)
             {
               return rc;
             }
+
+          nvs_index_update(fs, gc_ate.id, gc_prev_addr, new_addr);
         }
     }
   while (gc_prev_addr != stop_addr);
@@ -991,6 +1386,10 @@ static int nvs_startup(FAR struct nvs_fs *fs)
   fs->ate_wra = 0;
   fs->data_wra = 0;
 
+  /* The index is built once the rest of the startup is done */
+
+  nvs_index_free(fs);
+
   /* Get the device geometry. (Casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
    * from the size of a pointer).
@@ -1326,6 +1725,11 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
+    }
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->geo.neraseblocks, fs->geo.erasesize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1364,54 +1768,19 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
                 FAR uint32_t *ate_addr)
 {
   int rc;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
   struct nvs_ate wlk_ate;
   uint32_t hash_id;
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
-  wlk_addr = fs->ate_wra;
-  rd_addr = wlk_addr;
-
-  do
+  rc = nvs_find_entry(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          ferr("Walk to previous ate failed, rc=%d\n", rc);
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && (!nvs_flash_block_cmp(fs,
-              (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset, key, key_size)))
-            {
-              /* It is old or deleted, return -ENOENT */
-
-              if (wlk_ate.expired != fs->erasestate)
-                {
-                  return -ENOENT;
-                }
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          return -ENOENT;
-        }
+      return rc;
     }
-  while (true);
 
+  rd_addr = hist_addr;
   if (data)
     {
       rd_addr &= ADDR_BLOCK_MASK;
@@ -1433,6 +1802,53 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
   return wlk_ate.len;
 }
 
+/****************************************************************************
+ * Name: nvs_make_space
+ *
+ * Description:
+ *   Close blocks and gc the following ones until there is room for
+ *   required_space bytes of data and ates in the current block.
+ *
+ * Returned Value:
+ *   The number of blocks gc'ed, or -ERRNO code.
+ *
+ ****************************************************************************/
+
+static int nvs_make_space(FAR struct nvs_fs *fs, size_t required_space)
+{
+  int gc_count = 0;
+  int rc;
+
+  while (fs->ate_wra < fs->data_wra + required_space)
+    {
+      if (gc_count == fs->geo.neraseblocks)
+        {
+          /* Gc'ed all blocks, no extra space will be created
+           * by extra gc.
+           */
+
+          return -ENOSPC;
+        }
+
+      rc = nvs_block_close(fs);
+      if (rc)
+        {
+          return rc;
+        }
+
+      rc = nvs_gc(fs);
+      if (rc)
+        {
+          return rc;
+        }
+
+      gc_count++;
+      finfo("Gc count=%d\n", gc_count);
+    }
+
+  return gc_count;
+}
+
 /****************************************************************************
  * Name: nvs_write
  *
@@ -1453,17 +1869,14 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
                          FAR struct config_data_s *pdata)
 {
   int rc;
-  int gc_count;
   size_t data_size;
   size_t key_size;
   struct nvs_ate wlk_ate;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
-  uint16_t required_space = 0;
-  bool prev_found = false;
+  uint32_t new_addr;
+  bool prev_found;
   uint32_t hash_id;
-  uint16_t block_to_write_befor_gc;
 
 #ifdef CONFIG_MTD_CONFIG_NAMED
   FAR const uint8_t *key;
@@ -1500,198 +1913,111 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
 
-  /* Find latest entry with same id. */
+  /* Find the live entry with the same key. */
 
-  wlk_addr = fs->ate_wra;
+  rc = nvs_find_entry(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc < 0 && rc != -ENOENT)
+    {
+      return rc;
+    }
 
-  while (1)
+  prev_found = (rc == 0);
+
+  if (pdata->len == 0)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          return rc;
-        }
+      /* Skip delete entry for non-existing or already deleted entry. */
 
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
+      if (!prev_found)
         {
-          if ((wlk_ate.key_len == key_size)
-              && !nvs_flash_block_cmp(fs,
-                                      (rd_addr & ADDR_BLOCK_MASK) +
-                                      wlk_ate.offset, key, key_size))
-            {
-              prev_found = true;
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
+          return 0;
         }
 
-      if (wlk_addr == fs->ate_wra)
+      rc = nvs_expire_ate(fs, hist_addr);
+      if (rc < 0)
         {
-          break;
+          ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
+          return rc;
         }
-    }
 
-  if (prev_found)
-    {
-      finfo("Previous found\n");
-
-      /* Previous entry found. */
-
-      rd_addr &= ADDR_BLOCK_MASK;
-
-      if (pdata->len == 0)
-        {
-          /* If prev ate is expired, it is deleted. */
-
-          if (wlk_ate.expired != fs->erasestate)
-            {
-              /* Skip delete entry as it is already the
-               * last one.
-               */
-
-              return 0;
-            }
-          else
-            {
-              rc = nvs_expire_ate(fs, hist_addr);
-              if (rc < 0)
-                {
-                  ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
-                  return rc;
-                }
-
-              /* Delete now requires no extra space, so skip write and gc. */
+      nvs_index_remove(fs, hash_id, hist_addr);
 
-              finfo("nvs_delete success\n");
-              return 0;
-            }
-        }
-      else if (pdata->len == wlk_ate.len &&
-               wlk_ate.expired == fs->erasestate)
-        {
-          /* Do not try to compare if lengths are not equal
-           * or prev one is deleted.
-           * Compare the data and if equal return 0.
-           */
+      /* Delete now requires no extra space, so skip write and gc. */
 
-          rd_addr += wlk_ate.offset + wlk_ate.key_len;
-          rc = nvs_flash_block_cmp(fs, rd_addr, pdata->configdata,
-                                   pdata->len);
-          if (rc <= 0)
-            {
-              return rc;
-            }
-        }
+      finfo("nvs_delete success\n");
+      return 0;
     }
-  else
+
+  if (prev_found && pdata->len == wlk_ate.len)
     {
-      /* Skip delete entry for non-existing entry. */
+      /* Do not try to compare if lengths are not equal.
+       * Compare the data and if equal return 0.
+       */
 
-      if (pdata->len == 0)
+      rd_addr = hist_addr & ADDR_BLOCK_MASK;
+      rd_addr += wlk_ate.offset + wlk_ate.key_len;
+      rc = nvs_flash_block_cmp(fs, rd_addr, pdata->configdata,
+                               pdata->len);
+      if (rc <= 0)
         {
-          return 0;
+          return rc;
         }
     }
 
   /* Leave space for gc_done ate */
 
-  required_space = data_size + sizeof(struct nvs_ate);
-  gc_count = 0;
-  block_to_write_befor_gc = fs->ate_wra >> ADDR_BLOCK_SHIFT;
-  while (1)
+  rc = nvs_make_space(fs, data_size + sizeof(struct nvs_ate));
+  if (rc < 0)
     {
-      if (gc_count == fs->geo.neraseblocks)
-        {
-          /* Gc'ed all blocks, no extra space will be created
-           * by extra gc.
-           */
+      return rc;
+    }
 
-          return -ENOSPC;
-        }
+  if (prev_found && rc > 0)
+    {
+      /* Gc may have moved the previous entry, search for it again */
 
-      if (fs->ate_wra >= fs->data_wra + required_space)
+      rc = nvs_find_entry(fs, hash_id, key, key_size, &wlk_ate,
+                          &hist_addr);
+      finfo("relocate for prev entry, %" PRIx32 ", rc %d\n",
+            hist_addr, rc);
+      if (rc < 0)
         {
-          /* Nvs is changed after gc, we will look for the old ate.
-           */
-
-          if (prev_found && wlk_ate.expired == fs->erasestate)
-            {
-              finfo("prev entry exists, search for it\n");
-
-              /* If gc touched second latest ate, search for it again */
-
-              if (gc_count >= fs->geo.neraseblocks - 1 -
-                  (block_to_write_befor_gc + fs->geo.neraseblocks -
-                  (hist_addr >> ADDR_BLOCK_SHIFT))
-                  % fs->geo.neraseblocks)
-                {
-                  rc = nvs_read_entry(fs, key, key_size, NULL, 0,
-                                     &hist_addr);
-                  finfo("relocate for prev entry, %" PRIx32 ", "
-                        "rc %d\n",
-                        hist_addr, rc);
-                  if (rc < 0)
-                    {
-                      ferr("read prev entry failed\n");
-                      return rc;
-                    }
-                }
-            }
-
-          finfo("Write entry, ate_wra=0x%" PRIx32 ", "
-                "data_wra=0x%" PRIx32 "\n",
-                fs->ate_wra, fs->data_wra);
-          rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
-                                   pdata->configdata, pdata->len);
-          if (rc)
-            {
-              fwarn("Write entry failed\n");
-              return rc;
-            }
-
-          finfo("Write entry success\n");
-
-          /* Expiring the old ate if exists.
-           * After this operation, only the latest ate is valid.
-           * Expire the old one only if it is not deleted before(Or it is
-           * already expired)
-           */
+          ferr("read prev entry failed\n");
+          return rc;
+        }
+    }
 
-          if (prev_found && wlk_ate.expired == fs->erasestate)
-            {
-              rc = nvs_expire_ate(fs, hist_addr);
-              finfo("expir prev entry, %" PRIx32 ", rc %d\n",
-                    hist_addr, rc);
-              if (rc < 0)
-                {
-                  ferr("expire ate failed, addr %" PRIx32 "\n",
-                       hist_addr);
-                  return rc;
-                }
-            }
+  finfo("Write entry, ate_wra=0x%" PRIx32 ", data_wra=0x%" PRIx32 "\n",
+        fs->ate_wra, fs->data_wra);
+  new_addr = fs->ate_wra;
+  rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
+                           pdata->configdata, pdata->len);
+  if (rc)
+    {
+      fwarn("Write entry failed\n");
+      return rc;
+    }
 
-          break;
-        }
+  finfo("Write entry success\n");
 
-      rc = nvs_block_close(fs);
-      if (rc)
-        {
-          return rc;
-        }
+  /* Expiring the old ate if exists.
+   * After this operation, only the latest ate is valid.
+   */
 
-      rc = nvs_gc(fs);
-      if (rc)
+  if (prev_found)
+    {
+      rc = nvs_expire_ate(fs, hist_addr);
+      finfo("expir prev entry, %" PRIx32 ", rc %d\n", hist_addr, rc);
+      if (rc < 0)
         {
+          ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
           return rc;
         }
 
-      gc_count++;
-      finfo("Gc count=%d\n", gc_count);
+      nvs_index_update(fs, hash_id, hist_addr, new_addr);
+    }
+  else
+    {
+      nvs_index_insert(fs, hash_id, new_addr);
     }
 
   finfo("nvs_write success\n");
@@ -1723,6 +2049,90 @@ static int nvs_delete(FAR struct nvs_fs *fs, FAR struct config_data_s *pdata)
   return nvs_write(fs, pdata);
 }
 
+/****************************************************************************
+ * Name: nvs_write_batch
+ *
+ * Description:
+ *   Write or delete several entries.  The space of as many entries as fit
+ *   in one block is made at once, so that they are appended to the same
+ *   block with at most one round of gc before them, instead of possibly
+ *   one per entry.
+ *
+ * Input Parameters:
+ *   fs    - Pointer to file system.
+ *   batch - The entries, written in order.
+ *
+ * Returned Value:
+ *   0 on success, -ERRNO errno code if error.  The entries before the
+ *   failing one are written.
+ *
+ ****************************************************************************/
+
+static int nvs_write_batch(FAR struct nvs_fs *fs,
+                           FAR struct config_batch_s *batch)
+{
+  FAR struct config_data_s *pdata;
+  size_t required_space;
+  size_t space;
+  size_t first;
+  size_t i;
+  int rc;
+
+  if (batch == NULL || (batch->count > 0 && batch->data == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (first = 0; first < batch->count; first = i)
+    {
+      required_space = 0;
+      for (i = first; i < batch->count; i++)
+        {
+          pdata = &batch->data[i];
+          if (pdata->len == 0)
+            {
+              continue;
+            }
+
+#ifdef CONFIG_MTD_CONFIG_NAMED
+          space = strlen(pdata->name) + 1;
+#else
+          space = sizeof(pdata->id) + sizeof(pdata->instance);
+#endif
+          space += pdata->len + sizeof(struct nvs_ate);
+          if (i > first && required_space + space >
+              fs->geo.erasesize - 2 * sizeof(struct nvs_ate))
+            {
+              break;
+            }
+
+          required_space += space;
+        }
+
+      /* A single entry too large for a block is refused by nvs_write() */
+
+      if (required_space <= fs->geo.erasesize - 2 * sizeof(struct nvs_ate))
+        {
+          rc = nvs_make_space(fs, required_space);
+          if (rc < 0)
+            {
+              return rc;
+            }
+        }
+
+      for (; first < i; first++)
+        {
+          rc = nvs_write(fs, &batch->data[first]);
+          if (rc < 0)
+            {
+              return rc;
+            }
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: nvs_read
  *
@@ -1949,6 +2359,13 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
         ret = nvs_delete(fs, pdata);
         break;
 
+      case CFGDIOC_SETCONFIGS:
+
+        /* Write several nvs items. */
+
+        ret = nvs_write_batch(fs, (FAR struct config_batch_s *)arg);
+        break;
+
       case CFGDIOC_FIRSTCONFIG:
 
         /* Get the first item. */
@@ -2021,6 +2438,10 @@ int mtdconfig_register(FAR struct mtd_dev_s *mtd)
   /* Initialize the mtdnvs device structure */
 
   fs->mtd = mtd;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  fs->index = NULL;
+#endif
+
   ret = nxmutex_init(&fs->nvs_lock);
   if (ret < 0)
     {
@@ -2045,6 +2466,7 @@ int mtdconfig_register(FAR struct mtd_dev_s *mtd)
   return ret;
 
 mutex_err:
+  nvs_index_free(fs);
   nxmutex_destroy(&fs->nvs_lock);
 
 errout:
@@ -2076,6 +2498,7 @@ int mtdconfig_unregister(void)
 
   inode = file.f_inode;
   fs = (FAR struct nvs_fs *)inode->i_private;
+  nvs_index_free(fs);
   nxmutex_destroy(&fs->nvs_lock);
   kmm_free(fs);
   file_close(&file);
@@ -65,6 +65,14 @@
 
 #define NAND_BLOCKSTATUS_BAD 0xba
 
+/* Whether the pages of a device go through the software ECC */
+
+#ifdef CONFIG_MTD_NAND_SWECC
+#  define NAND_HAVE_SWECC(r) ((r)->ecctype == NANDECC_SWECC)
+#else
+#  define NAND_HAVE_SWECC(r) false
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -90,6 +98,12 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                               unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                                unsigned int page, FAR const void *data);
+static int      nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                               unsigned int page, unsigned int npages,
+                               FAR uint8_t *data);
+static int      nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                                unsigned int page, unsigned int npages,
+                                FAR const uint8_t *data);
 
 /* MTD driver methods */
 
@@ -519,6 +533,124 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages of one block, with a single
+ *   multi-page read of the lower half when it supports them.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read, all within the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; -EUCLEAN if bit errors were corrected; a
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize = nandmodel_getpagesize(&raw->model);
+  bool fixedecc = false;
+  int ret;
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  if (npages > 1 && raw->readpages != NULL && !NAND_HAVE_SWECC(raw))
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_READPAGES(raw, block, page, npages, data);
+    }
+#endif
+
+  for (; npages > 0; npages--)
+    {
+      ret = nand_readpage(nand, block, page++, data);
+      if (ret == -EUCLEAN)
+        {
+          fixedecc = true;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+
+      data += pagesize;
+    }
+
+  return fixedecc ? -EUCLEAN : OK;
+}
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages of one block, with a single
+ *   multi-page program of the lower half when it supports them.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write, all within the block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize = nandmodel_getpagesize(&raw->model);
+  int ret;
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  if (npages > 1 && raw->writepages != NULL && !NAND_HAVE_SWECC(raw))
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_WRITEPAGES(raw, block, page, npages, data);
+    }
+#endif
+
+  for (; npages > 0; npages--)
+    {
+      ret = nand_writepage(nand, block, page++, data);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      data += pagesize;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -578,6 +710,7 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
   unsigned int page;
   uint16_t pagesize;
   size_t remaining;
+  size_t count;
   off_t maxblock;
   off_t block;
   int ret;
@@ -607,9 +740,9 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
 
   nxmutex_lock(&nand->lock);
 
-  /* Then read every page from NAND */
+  /* Then read every page from NAND, one block at a time */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -622,34 +755,31 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      /* Read the pages wanted from this block */
+
+      count = pagesperblock - page;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
 
-      ret = nand_readpage(nand, block, page, buffer);
+      ret = nand_readpages(nand, block, page, count, buffer);
       if (ret == -EUCLEAN)
         {
           fixedecc = true;
         }
       else if (ret < 0)
         {
-          ferr("ERROR: nand_readpage failed block=%" PRIdOFF
+          ferr("ERROR: nand_readpages failed block=%" PRIdOFF
                " page=%d: %d\n", block, page, ret);
           goto errout_with_lock;
         }
 
-      /* Increment the page number.  If we exceed the number of
-       * pages per block, then reset the page number and bump up
-       * the block number.
-       */
+      /* Continue with the first page of the next block */
 
-      if (++page >= pagesperblock)
-        {
-          page = 0;
-          block++;
-        }
-
-      /* Increment the buffer point by the size of one page */
-
-      buffer += pagesize;
+      page    = 0;
+      block++;
+      buffer += count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -678,6 +808,7 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
   unsigned int page;
   uint16_t pagesize;
   size_t remaining;
+  size_t count;
   off_t maxblock;
   off_t block;
   int ret;
@@ -707,9 +838,9 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
 
   nxmutex_lock(&nand->lock);
 
-  /* Then write every page into NAND */
+  /* Then write every page into NAND, one block at a time */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -722,30 +853,27 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      /* Write the pages given for this block */
 
-      ret = nand_writepage(nand, block, page, buffer);
-      if (ret < 0)
+      count = pagesperblock - page;
+      if (count > remaining)
         {
-          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
-               (long)block, page, ret);
-          goto errout_with_lock;
+          count = remaining;
         }
 
-      /* Increment the page number.  If we exceed the number of
-       * pages per block, then reset the page number and bump up
-       * the block number.
-       */
-
-      if (++page >= pagesperblock)
+      ret = nand_writepages(nand, block, page, count, buffer);
+      if (ret < 0)
         {
-          page = 0;
-          block++;
+          ferr("ERROR: nand_writepages failed block=%ld page=%d: %d\n",
+               (long)block, page, ret);
+          goto errout_with_lock;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Continue with the first page of the next block */
 
-      buffer += pagesize;
+      page    = 0;
+      block++;
+      buffer += count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -276,6 +276,7 @@ struct n25qxxx_dev_s
   uint8_t                pageshift;   /* Log2 of page size */
   FAR uint8_t           *cmdbuf;      /* Allocated command buffer */
   FAR uint8_t           *readbuf;     /* Allocated status read buffer */
+  FAR uint8_t           *xipbase;     /* Mapped address, NULL if not mapped */
 
 #ifdef CONFIG_N25QXXX_SECTOR512
   uint8_t                flags;       /* Buffered sector flags */
@@ -290,8 +291,9 @@ struct n25qxxx_dev_s
 
 /* Locking */
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi);
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi);
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv);
+static int  n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv);
 
 /* Low-level message helpers */
 
@@ -377,8 +379,10 @@ static int  n25qxxx_ioctl(FAR struct mtd_dev_s *dev,
  * Name: n25qxxx_lock
  ****************************************************************************/
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv)
 {
+  FAR struct qspi_dev_s *qspi = priv->qspi;
+
   /* On QuadSPI buses where there are multiple devices, it will be necessary
    * to lock QuadSPI to have exclusive access to the buses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -390,6 +394,13 @@ static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
 
   QSPI_LOCK(qspi, true);
 
+  /* Commands can't be sent while the FLASH is memory mapped */
+
+  if (priv->xipbase != NULL)
+    {
+      QSPI_MEMMAP(qspi, NULL, NULL);
+    }
+
   /* After locking the QuadSPI bus, the we also need call the setfrequency,
    * setbits, and setmode methods to make sure that the QuadSPI is properly
    * configured for the device. If the QuadSPI bus is being shared, then it
@@ -405,9 +416,47 @@ static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
  * Name: n25qxxx_unlock
  ****************************************************************************/
 
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv)
 {
-  QSPI_LOCK(qspi, false);
+  /* Map the FLASH again for the XIP readers */
+
+  if (priv->xipbase != NULL)
+    {
+      n25qxxx_memmap(priv);
+    }
+
+  QSPI_LOCK(priv->qspi, false);
+}
+
+/****************************************************************************
+ * Name: n25qxxx_memmap
+ *
+ * Description:
+ *   Put the controller in memory mapped mode with the same read command as
+ *   n25qxxx_read_byte().  The bus must be locked.
+ *
+ ****************************************************************************/
+
+static int n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base = NULL;
+  int ret;
+
+  memset(&meminfo, 0, sizeof(meminfo));
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
+  meminfo.cmd     = N25QXXX_FAST_READ_QUADIO;
+
+  ret = QSPI_MEMMAP(priv->qspi, &meminfo, &base);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv->xipbase = base;
+  return OK;
 }
 
 /****************************************************************************
@@ -587,7 +636,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   /* Read the JEDEC ID */
 
@@ -595,7 +644,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 
   /* Unlock the bus */
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   finfo("Manufacturer: %02x Device Type %02x, Capacity: %02x\n",
         priv->cmdbuf[0], priv->cmdbuf[1], priv->cmdbuf[2]);
@@ -1216,7 +1265,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev,
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1240,7 +1289,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev,
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return (int)nblocks;
 }
@@ -1296,7 +1345,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
 #if defined(CONFIG_N25QXXX_SECTOR512)
   ret = n25qxxx_write_cache(priv, buffer, startblock, nblocks);
@@ -1314,7 +1363,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return ret < 0 ? ret : nblocks;
 }
@@ -1333,11 +1382,23 @@ static ssize_t n25qxxx_read(FAR struct mtd_dev_s *dev,
 
   finfo("offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
+  /* Once mapped, read the FLASH directly */
+
+  QSPI_LOCK(priv->qspi, true);
+  if (priv->xipbase != NULL)
+    {
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      QSPI_LOCK(priv->qspi, false);
+      return (ssize_t)nbytes;
+    }
+
+  QSPI_LOCK(priv->qspi, false);
+
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
   ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   if (ret < 0)
     {
@@ -1429,9 +1490,9 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev,
         {
           /* Erase the entire device */
 
-          n25qxxx_lock(priv->qspi);
+          n25qxxx_lock(priv);
           ret = n25qxxx_erase_chip(priv);
-          n25qxxx_unlock(priv->qspi);
+          n25qxxx_unlock(priv);
         }
         break;
 
@@ -1464,6 +1525,37 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev,
         }
         break;
 
+      case BIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)arg;
+
+          /* Map the FLASH on first use.  It stays mapped, the program and
+           * erase operations leave the mode only while they run.
+           */
+
+          QSPI_LOCK(priv->qspi, true);
+          ret = OK;
+          if (priv->xipbase == NULL)
+            {
+              ret = n25qxxx_memmap(priv);
+            }
+
+          if (ret >= 0 && ppv != NULL)
+            {
+              *ppv = priv->xipbase;
+            }
+
+          QSPI_LOCK(priv->qspi, false);
+
+          /* Without the support the callers fall back to plain reads */
+
+          if (ret == -ENOSYS)
+            {
+              ret = -ENOTTY;
+            }
+        }
+        break;
+
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
         break;
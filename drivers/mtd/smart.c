@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/crc8.h>
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
@@ -142,6 +143,22 @@
 #define SMART_WEARFLAGS_FORCE_REORG         0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED        0x02
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Checkpoint state values.  A checkpoint goes from clean to stale by only
+ * programming bits, so no erase is needed to invalidate it.
+ */
+
+#  define SMART_CP_CLEAN        (CONFIG_SMARTFS_ERASEDSTATE ^ 0x80)
+#  define SMART_CP_STALE        (CONFIG_SMARTFS_ERASEDSTATE ^ 0xff)
+
+/* The checkpoint payload is the sector map followed by the release and
+ * free counts, which share one allocation in smart_setsectorsize().
+ */
+
+#  define SMART_CP_PAYLOAD(d)   ((d)->totalsectors * sizeof(uint16_t) + \
+                                 ((d)->neraseblocks << 1))
+#endif
+
 #define SET_BITMAP(m, n) do { (m)[(n) / 8] |= 1 << ((n) % 8); } while (0)
 #define CLR_BITMAP(m, n) do { (m)[(n) / 8] &= ~(1 << ((n) % 8)); } while (0)
 #define ISSET_BITMAP(m, n) ((m)[(n) / 8] & (1 << ((n) % 8)))
@@ -230,6 +247,35 @@ struct smart_cache_s
  * increase the wear of the device 2x.
  */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Header of the checkpoint, stored in the first MTD block of the reserved
+ * area.  The CRC covers the fields from seq up to crc and the payload.
+ */
+
+struct smart_checkpoint_s
+{
+  uint8_t               magic[4];         /* SMART_CP_MAGIC */
+  uint8_t               state;            /* SMART_CP_CLEAN or _STALE */
+  uint8_t               reserved[3];
+  uint32_t              seq;              /* Incremented by each checkpoint */
+  uint16_t              sectorsize;       /* Sector size of the volume */
+  uint16_t              totalsectors;     /* Number of logical sectors */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Number of released sectors */
+  uint16_t              lastallocblock;   /* Last block allocated from */
+  uint8_t               formatversion;    /* Format version on the device */
+  uint8_t               namesize;         /* Length of filenames */
+  uint8_t               reserved2[2];
+  uint32_t              crc;              /* CRC-32 */
+};
+
+static const uint8_t g_smart_cp_magic[4] =
+{
+  'S', 'M', 'C', 'P'
+};
+#endif
+
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 struct smart_allocsector_s
 {
@@ -290,6 +336,12 @@ struct smart_struct_s
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint32_t              cpblock;          /* First checkpoint erase block */
+  uint32_t              cpseq;            /* Last checkpoint sequence */
+  bool                  cpclean;          /* Checkpoint matches RAM */
+#endif
+  uint32_t              scantime;         /* Sector map build time, ms */
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
@@ -450,6 +502,12 @@ static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
 static int     smart_fsck(FAR struct smart_struct_s *dev);
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int     smart_checkpoint_load(FAR struct smart_struct_s *dev);
+static int     smart_checkpoint_save(FAR struct smart_struct_s *dev);
+static int     smart_checkpoint_invalidate(FAR struct smart_struct_s *dev);
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -512,6 +570,15 @@ static int smart_open(FAR struct inode *inode)
 static int smart_close(FAR struct inode *inode)
 {
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Persist the sector map so that the next initialization does not need
+   * to scan the device.
+   */
+
+  smart_checkpoint_save((FAR struct smart_struct_s *)inode->i_private);
+#endif
+
   return OK;
 }
 
@@ -946,6 +1013,14 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  ret = smart_checkpoint_invalidate(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* I think maybe we need to lock on a mutex here */
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
@@ -2609,6 +2684,294 @@ err_out:
   return ret;
 }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+
+/****************************************************************************
+ * Name: smart_checkpoint_crc
+ *
+ * Description:  Calculate the CRC of a checkpoint header and of the sector
+ *               map and counts of the device.
+ *
+ ****************************************************************************/
+
+static uint32_t smart_checkpoint_crc(FAR struct smart_struct_s *dev,
+                                     FAR const struct smart_checkpoint_s *cp)
+{
+  uint32_t crc;
+
+  crc = crc32((FAR const uint8_t *)&cp->seq,
+              offsetof(struct smart_checkpoint_s, crc) -
+              offsetof(struct smart_checkpoint_s, seq));
+  return crc32part((FAR const uint8_t *)dev->smap, SMART_CP_PAYLOAD(dev),
+                   crc);
+}
+
+/****************************************************************************
+ * Name: smart_checkpoint_fits
+ *
+ * Description:  Return true if the checkpoint of the current volume fits in
+ *               the reserved area.
+ *
+ ****************************************************************************/
+
+static bool smart_checkpoint_fits(FAR struct smart_struct_s *dev)
+{
+  return dev->geo.blocksize >= sizeof(struct smart_checkpoint_s) &&
+         dev->geo.blocksize + SMART_CP_PAYLOAD(dev) <=
+         (size_t)dev->geo.erasesize * CONFIG_MTD_SMART_CHECKPOINT_BLOCKS;
+}
+
+/****************************************************************************
+ * Name: smart_checkpoint_load
+ *
+ * Description:  Restore the sector map and counts from the checkpoint area
+ *               instead of scanning the device.  Fails if the checkpoint is
+ *               missing, stale, torn or does not match the geometry.
+ *
+ ****************************************************************************/
+
+static int smart_checkpoint_load(FAR struct smart_struct_s *dev)
+{
+  struct smart_checkpoint_s cp;
+  off_t base;
+  size_t payload;
+  size_t nblocks;
+  size_t tail;
+  ssize_t nread;
+  int ret;
+
+  base = dev->cpblock * (dev->geo.erasesize / dev->geo.blocksize);
+  if (dev->geo.blocksize < sizeof(cp))
+    {
+      return -ENOSYS;
+    }
+
+  nread = MTD_BREAD(dev->mtd, base, 1, (FAR uint8_t *)dev->rwbuffer);
+  if (nread != 1)
+    {
+      return nread < 0 ? nread : -EIO;
+    }
+
+  memcpy(&cp, dev->rwbuffer, sizeof(cp));
+  if (memcmp(cp.magic, g_smart_cp_magic, sizeof(cp.magic)) != 0 ||
+      cp.state != SMART_CP_CLEAN)
+    {
+      return -ENOENT;
+    }
+
+  /* Set up the volume geometry recorded in the checkpoint */
+
+  ret = smart_setsectorsize(dev, cp.sectorsize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (cp.totalsectors != dev->totalsectors ||
+      cp.neraseblocks != dev->neraseblocks ||
+      !smart_checkpoint_fits(dev))
+    {
+      return -EINVAL;
+    }
+
+  /* Read the sector map and counts */
+
+  payload = SMART_CP_PAYLOAD(dev);
+  nblocks = payload / dev->geo.blocksize;
+  tail    = payload % dev->geo.blocksize;
+
+  if (nblocks > 0)
+    {
+      nread = MTD_BREAD(dev->mtd, base + 1, nblocks,
+                        (FAR uint8_t *)dev->smap);
+      if (nread != nblocks)
+        {
+          return nread < 0 ? nread : -EIO;
+        }
+    }
+
+  if (tail > 0)
+    {
+      nread = MTD_BREAD(dev->mtd, base + 1 + nblocks, 1,
+                        (FAR uint8_t *)dev->rwbuffer);
+      if (nread != 1)
+        {
+          return nread < 0 ? nread : -EIO;
+        }
+
+      memcpy((FAR uint8_t *)dev->smap + nblocks * dev->geo.blocksize,
+             dev->rwbuffer, tail);
+    }
+
+  if (smart_checkpoint_crc(dev, &cp) != cp.crc)
+    {
+      ferr("ERROR: Checkpoint %" PRIu32 " has a bad CRC\n", cp.seq);
+      return -EIO;
+    }
+
+  dev->formatstatus   = SMART_FMT_STAT_FORMATTED;
+  dev->formatversion  = cp.formatversion;
+  dev->namesize       = cp.namesize;
+  dev->freesectors    = cp.freesectors;
+  dev->releasesectors = cp.releasesectors;
+  dev->lastallocblock = cp.lastallocblock;
+  dev->cpseq          = cp.seq;
+  dev->cpclean        = true;
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  /* Read the wear leveling status bits */
+
+  smart_read_wearstatus(dev);
+#endif
+
+  finfo("Loaded checkpoint %" PRIu32 "\n", cp.seq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_checkpoint_save
+ *
+ * Description:  Write the sector map and counts to the checkpoint area.
+ *               The header goes last, so a torn checkpoint is never valid.
+ *
+ ****************************************************************************/
+
+static int smart_checkpoint_save(FAR struct smart_struct_s *dev)
+{
+  struct smart_checkpoint_s cp;
+  off_t base;
+  size_t payload;
+  size_t nblocks;
+  size_t tail;
+  ssize_t ret;
+
+  /* Nothing to do if the checkpoint is current.  Sectors that are only
+   * allocated in RAM would be lost by a restart anyway, so wait until
+   * they are written.
+   */
+
+  if (dev->cpclean || dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  if (dev->allocsector != NULL)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  if (!smart_checkpoint_fits(dev))
+    {
+      fwarn("WARNING: Checkpoint does not fit\n");
+      return -ENOSPC;
+    }
+
+  ret = MTD_ERASE(dev->mtd, dev->cpblock,
+                  CONFIG_MTD_SMART_CHECKPOINT_BLOCKS);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  base    = dev->cpblock * (dev->geo.erasesize / dev->geo.blocksize);
+  payload = SMART_CP_PAYLOAD(dev);
+  nblocks = payload / dev->geo.blocksize;
+  tail    = payload % dev->geo.blocksize;
+
+  if (nblocks > 0)
+    {
+      ret = MTD_BWRITE(dev->mtd, base + 1, nblocks,
+                       (FAR const uint8_t *)dev->smap);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  if (tail > 0)
+    {
+      memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+      memcpy(dev->rwbuffer,
+             (FAR const uint8_t *)dev->smap + nblocks * dev->geo.blocksize,
+             tail);
+      ret = MTD_BWRITE(dev->mtd, base + 1 + nblocks, 1,
+                       (FAR const uint8_t *)dev->rwbuffer);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Now commit the checkpoint by writing its header */
+
+  memset(&cp, 0, sizeof(cp));
+  memcpy(cp.magic, g_smart_cp_magic, sizeof(cp.magic));
+  cp.state          = SMART_CP_CLEAN;
+  cp.seq            = dev->cpseq + 1;
+  cp.sectorsize     = dev->sectorsize;
+  cp.totalsectors   = dev->totalsectors;
+  cp.neraseblocks   = dev->neraseblocks;
+  cp.freesectors    = dev->freesectors;
+  cp.releasesectors = dev->releasesectors;
+  cp.lastallocblock = dev->lastallocblock;
+  cp.formatversion  = dev->formatversion;
+  cp.namesize       = dev->namesize;
+  cp.crc            = smart_checkpoint_crc(dev, &cp);
+
+  memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  memcpy(dev->rwbuffer, &cp, sizeof(cp));
+  ret = MTD_BWRITE(dev->mtd, base, 1, (FAR const uint8_t *)dev->rwbuffer);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  dev->cpseq   = cp.seq;
+  dev->cpclean = true;
+  finfo("Wrote checkpoint %" PRIu32 "\n", cp.seq);
+  return OK;
+
+errout:
+  ferr("ERROR: Error %zd writing the checkpoint\n", -ret);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: smart_checkpoint_invalidate
+ *
+ * Description:  Mark the checkpoint on the device as stale before the
+ *               first modification of the volume after it was loaded or
+ *               written.
+ *
+ ****************************************************************************/
+
+static int smart_checkpoint_invalidate(FAR struct smart_struct_s *dev)
+{
+  uint8_t state = SMART_CP_STALE;
+  ssize_t ret;
+
+  if (!dev->cpclean)
+    {
+      return OK;
+    }
+
+  ret = smart_bytewrite(dev, dev->cpblock * dev->geo.erasesize +
+                        offsetof(struct smart_checkpoint_s, state),
+                        1, &state);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %zd invalidating the checkpoint\n", -ret);
+      return ret;
+    }
+
+  dev->cpclean = false;
+  return OK;
+}
+
+#endif /* CONFIG_MTD_SMART_CHECKPOINT */
+
 /****************************************************************************
  * Name: smart_getformat
  *
@@ -5491,6 +5854,20 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint becomes stale with the first change of the volume */
+
+  if (cmd == BIOC_LLFORMAT || cmd == BIOC_ALLOCSECT ||
+      cmd == BIOC_FREESECT || cmd == BIOC_WRITESECT)
+    {
+      ret = smart_checkpoint_invalidate(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5577,6 +5954,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       procfs_data->unusedsectors  = dev->unusedsectors;
       procfs_data->blockerases    = dev->blockerases;
       procfs_data->sectorsperblk  = dev->sectorsperblk;
+      procfs_data->scantime       = dev->scantime;
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
       procfs_data->formatsector   = dev->smap[0];
@@ -6148,6 +6526,7 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
   FAR struct smart_struct_s *dev;
   int ret = -ENOMEM;
   uint32_t totalsectors;
+  clock_t start;
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   FAR struct smart_multiroot_device_s *rootdirdev = NULL;
 #endif
@@ -6186,6 +6565,22 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Hide the checkpoint area at the end of the device from the
+       * volume.
+       */
+
+      if (dev->geo.neraseblocks <= CONFIG_MTD_SMART_CHECKPOINT_BLOCKS)
+        {
+          ferr("ERROR: Device too small for the checkpoint\n");
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      dev->geo.neraseblocks -= CONFIG_MTD_SMART_CHECKPOINT_BLOCKS;
+      dev->cpblock           = dev->geo.neraseblocks;
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -6232,15 +6627,31 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       dev->minor = minor;
 #endif
 
-      /* Do a scan of the device */
+      /* Restore the sector map from the checkpoint if there is a valid
+       * one, otherwise do a scan of the device.
+       */
 
+      start = clock_systime_ticks();
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      ret = smart_checkpoint_load(dev);
+      if (ret < 0)
+        {
+          finfo("No checkpoint (%d), scanning the device\n", ret);
+          ret = smart_scan(dev);
+        }
+#else
       ret = smart_scan(dev);
+#endif
+
       if (ret < 0)
         {
           ferr("ERROR: smart_scan failed: %d\n", -ret);
           goto errout;
         }
 
+      dev->scantime = TICK2MSEC(clock_systime_ticks() - start);
+      finfo("Mount scan took %" PRIu32 " ms\n", dev->scantime);
+
       /* Create a MTD block device name */
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -74,6 +75,7 @@
 #define W25_WREN                   0x06    /* Write enable                   */
 #define W25_WRDI                   0x04    /* Write Disable                  */
 #define W25_RDSR                   0x05    /* Read status register           */
+#define W25_RDSR2                  0x35    /* Read status register 2 (W25Q)  */
 #define W25_WRSR                   0x01    /* Write Status Register          */
 #define W25_RDDATA                 0x03    /* Read data bytes                */
 #define W25_FRD                    0x0b    /* Higher speed read              */
@@ -82,6 +84,8 @@
 #define W25_BE                     0xd8    /* Block Erase (64KB)             */
 #define W25_SE                     0x20    /* Sector erase (4KB)             */
 #define W25_CE                     0xc7    /* Chip erase                     */
+#define W25_EPS                    0x75    /* Erase/program suspend (W25Q)   */
+#define W25_EPR                    0x7a    /* Erase/program resume (W25Q)    */
 #define W25_PD                     0xb9    /* Power down                     */
 #define W25_PURDID                 0xab    /* Release PD, Device ID          */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device     */
@@ -170,6 +174,8 @@
                                              /* Bit 6: Reserved */
 #define W25_SR_SRP                 (1 << 7)  /* Bit 7: Status register write protect */
 
+#define W25_SR2_SUS                (1 << 7)  /* Bit 7: Erase/program suspended (W25Q) */
+
 #define W25_DUMMY                  0xa5
 
 /* Chip Geometries **********************************************************/
@@ -224,6 +230,11 @@ struct w25_dev_s
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool                  suspend;     /* The part can suspend erases (W25Q) */
+  off_t                 eraseaddr;   /* Address of the last sector erased */
+  clock_t               resumed;     /* Time of the last erase resume */
+#endif
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -245,6 +256,12 @@ static inline int w25_readid(FAR struct w25_dev_s *priv);
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
 static uint8_t w25_waitwritecomplete(FAR struct w25_dev_s *priv);
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv, uint8_t cmd);
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes);
+static void w25_eraseresume(FAR struct w25_dev_s *priv);
+#endif
 static inline void w25_wren(FAR struct w25_dev_s *priv);
 static inline void w25_wrdi(FAR struct w25_dev_s *priv);
 static bool w25_is_erased(struct w25_dev_s *priv,
@@ -396,6 +413,13 @@ static inline int w25_readid(struct w25_dev_s *priv)
        memory == W25Q_JEDEC_MEMORY_TYPE_B ||
        memory == W25Q_JEDEC_MEMORY_TYPE_C))
     {
+#ifdef CONFIG_W25_ERASE_SUSPEND
+      /* Only the W25Q parts can suspend an erase */
+
+      priv->suspend = (manufacturer == W25_JEDEC_WINBOND &&
+                       memory != W25X_JEDEC_MEMORY_TYPE);
+#endif
+
       /* Okay.. is it a FLASH capacity that we understand? If so, save
        * the FLASH capacity.
        */
@@ -560,6 +584,88 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
   return status;
 }
 
+/****************************************************************************
+ * Name: w25_rdsr
+ ****************************************************************************/
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv, uint8_t cmd)
+{
+  uint8_t status;
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, cmd);
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  return status;
+}
+
+/****************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   Suspend the sector erase in progress, if any, so that a read outside
+ *   of that sector doesn't have to wait for it.  Once resumed, an erase
+ *   runs for at least a tick before it is suspended again, so that it
+ *   still completes under a stream of reads.
+ *
+ * Returned Value:
+ *   true if the erase is suspended and w25_eraseresume() must be called
+ *   after the read.
+ *
+ ****************************************************************************/
+
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes)
+{
+  uint8_t status;
+
+  if (!priv->suspend || priv->prev_instr != W25_SE ||
+      clock_systime_ticks() == priv->resumed ||
+      (address < priv->eraseaddr + W25_SECTOR_SIZE &&
+       address + nbytes > priv->eraseaddr))
+    {
+      return false;
+    }
+
+  if ((w25_rdsr(priv, W25_RDSR) & W25_SR_BUSY) == 0)
+    {
+      return false;
+    }
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPS);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The part is idle within tSUS (20 us).  If the erase completed in the
+   * meantime, there is nothing to resume.
+   */
+
+  do
+    {
+      status = w25_rdsr(priv, W25_RDSR);
+    }
+  while ((status & W25_SR_BUSY) != 0);
+
+  return (w25_rdsr(priv, W25_RDSR2) & W25_SR2_SUS) != 0;
+}
+
+/****************************************************************************
+ * Name: w25_eraseresume
+ ****************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_EPR);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  priv->prev_instr = W25_SE;
+  priv->resumed    = clock_systime_ticks();
+}
+#endif
+
 /****************************************************************************
  * Name:  w25_wren
  ****************************************************************************/
@@ -682,6 +788,9 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   SPI_SEND(priv->spi, W25_SE);
   priv->prev_instr = W25_SE;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  priv->eraseaddr  = address;
+#endif
 
   /* Send the sector address high byte first. Only the most significant bits
    * (those corresponding to the sector) have any meaning.
@@ -736,17 +845,29 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
   uint8_t status;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool suspended;
+#endif
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  /* Read during a sector erase, unless it is the sector being erased */
+
+  suspended = w25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+      UNUSED(status);
 
-  /* Make sure that writing is disabled */
+      /* Make sure that writing is disabled */
 
-  w25_wrdi(priv);
+      w25_wrdi(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -781,6 +902,13 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  if (suspended)
+    {
+      w25_eraseresume(priv);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -26,6 +26,7 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -36,6 +37,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -46,6 +48,11 @@
 #define NETDEV_TX_CONTINUE 1 /* Return value for devif_poll */
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
+#define NETDEV_QUEUE_NAME_FMT  "netdev-%s-%d"
+
+#ifndef CONFIG_NETDEV_RX_BUDGET
+#  define CONFIG_NETDEV_RX_BUDGET 0
+#endif
 
 #ifdef CONFIG_NETDEV_HPWORK_THREAD
 #  define NETDEV_WORK HPWORK
@@ -57,11 +64,13 @@
  * Private Types
  ****************************************************************************/
 
-/* This structure describes the state of the upper half driver */
+/* This structure describes the poll state of one RX/TX queue pair */
 
-struct netdev_upperhalf_s
+struct netdev_upperhalf_s;
+struct netdev_upper_queue_s
 {
-  FAR struct netdev_lowerhalf_s *lower;
+  FAR struct netdev_upperhalf_s *upper;
+  int index;
 
   /* Deferring poll work to work queue or thread */
 
@@ -74,6 +83,23 @@ struct netdev_upperhalf_s
 #endif
 };
 
+/* This structure describes the state of the upper half driver */
+
+struct netdev_upperhalf_s
+{
+  FAR struct netdev_lowerhalf_s *lower;
+
+  int nqueues;                  /* Number of queues in use */
+  struct netdev_upper_queue_s queue[CONFIG_NETDEV_MAX_QUEUES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void netdev_upper_queue_work(FAR struct netdev_upperhalf_s *upper,
+                                    int index);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -194,6 +220,7 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   /* Allocate the upper-half data structure */
 
   FAR struct netdev_upperhalf_s *upper;
+  int i;
 
   DEBUGASSERT(dev != NULL && dev->netdev.d_private == NULL);
 
@@ -204,12 +231,106 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
       return NULL;
     }
 
-  upper->lower = dev;
+  upper->lower   = dev;
+  upper->nqueues = 1;
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (dev->nqueues > 1)
+    {
+      upper->nqueues = MIN(dev->nqueues, CONFIG_NETDEV_MAX_QUEUES);
+    }
+#endif
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      upper->queue[i].upper = upper;
+      upper->queue[i].index = i;
+#ifdef CONFIG_NETDEV_WORK_THREAD
+      nxsem_init(&upper->queue[i].sem, 0, 0);
+      nxsem_init(&upper->queue[i].sem_exit, 0, 0);
+#endif
+    }
+
   dev->netdev.d_private = upper;
 
   return upper;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_features
+ *
+ * Description:
+ *   Check the offloads advertised by the lower half and drop those that
+ *   cannot be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void netdev_upper_features(FAR struct net_driver_s *dev)
+{
+  uint32_t txcsum = NETDEV_FEATURE_TXCSUM_IPv4 | NETDEV_FEATURE_TXCSUM_IPv6;
+
+  /* TSO packets span I/O buffer chains and need the checksum offload */
+
+  if ((dev->d_features & NETDEV_FEATURE_TSO) != 0 &&
+      ((dev->d_features & NETDEV_FEATURE_SG) == 0 ||
+       (dev->d_features & txcsum) == 0 ||
+       dev->d_tsomax <= NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev)))
+    {
+      nwarn("WARNING: %s: TSO needs SG, TX checksum and d_tsomax\n",
+            dev->d_ifname);
+      dev->d_features &= ~NETDEV_FEATURE_TSO;
+    }
+
+  ninfo("%s: features %08" PRIx32 " tsomax %u\n",
+        dev->d_ifname, dev->d_features, dev->d_tsomax);
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_transmit/receive
+ *
+ * Description:
+ *   Relay a packet to the lower half, on the TX queue selected by the flow
+ *   of the packet, or take a packet from the given RX queue.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct netdev_upperhalf_s *upper,
+                                 FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (upper->nqueues > 1 && lower->ops->transmit_queue != NULL)
+    {
+      int queue = netpkt_flowhash(lower, pkt) % upper->nqueues;
+
+      return lower->ops->transmit_queue(lower, queue, pkt);
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+static FAR netpkt_t *netdev_upper_receive(FAR struct netdev_upperhalf_s *upper,
+                                          int queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (upper->nqueues > 1 && lower->ops->receive_queue != NULL)
+    {
+      return lower->ops->receive_queue(lower, queue);
+    }
+#endif
+
+  return queue == 0 ? lower->ops->receive(lower) : NULL;
+}
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -254,7 +375,6 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
   int                            ret;
 
@@ -269,7 +389,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 #endif
 
   pkt = netpkt_get(dev, NETPKT_TX);
-  ret = lower->ops->transmit(lower, pkt);
+  ret = netdev_upper_transmit(upper, pkt);
 
   if (ret != OK)
     {
@@ -313,32 +433,85 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
     }
 }
 
+/****************************************************************************
+ * Function: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Give the TCP segments coalesced by GRO to the IP stack, leaving the
+ *   packet currently in d_iob untouched.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static void netdev_upper_gro_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  uint16_t len = dev->d_len;
+
+  dev->d_iob = NULL;
+  if (netdev_gro_flush(dev))
+    {
+      ipv4_input(dev);
+      if (dev->d_len > 0)
+        {
+          netdev_upper_txpoll(dev);
+        }
+
+      netdev_iob_release(dev);
+    }
+
+  dev->d_iob = iob;
+  dev->d_len = len;
+}
+#endif
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Try to receive packets from one RX queue of the device and pass
+ *   packets into IP stack and send packets which is from IP stack if
+ *   necessary.  At most CONFIG_NETDEV_RX_BUDGET packets are taken.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The index of the RX queue
+ *
+ * Returned Value:
+ *   True if the queue is empty; false if the budget was exhausted.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int queue)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR struct eth_hdr_s          *eth_hdr;
   FAR netpkt_t                  *pkt;
+  int                            count;
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  for (count = 0;
+       CONFIG_NETDEV_RX_BUDGET == 0 || count < CONFIG_NETDEV_RX_BUDGET;
+       count++)
     {
+      pkt = netdev_upper_receive(upper, queue);
+      if (pkt == NULL)
+        {
+#ifdef CONFIG_NETDEV_GRO
+          netdev_upper_gro_flush(dev);
+#endif
+          return true;
+        }
+
       NETDEV_RXPACKETS(dev);
 
       if (!IFF_IS_UP(dev->d_flags))
@@ -352,6 +525,15 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 
       netpkt_put(dev, pkt, NETPKT_RX);
 
+      if (netdev_iob_charge(dev) < 0)
+        {
+          /* The device exceeded its RX I/O buffer quota, drop frame */
+
+          NETDEV_RXDROPPED(dev);
+          netdev_iob_release(dev);
+          continue;
+        }
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -383,6 +565,20 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
         }
 
+#ifdef CONFIG_NETDEV_GRO
+      /* Hold back in-order TCP segments of one flow to give them to the
+       * IP stack as one packet.  Any other packet first flushes them.
+       */
+
+      if (eth_hdr->type == HTONS(ETHTYPE_IP) && netdev_gro_receive(dev))
+        {
+          NETDEV_RXIPV4(dev);
+          continue;
+        }
+
+      netdev_upper_gro_flush(dev);
+#endif
+
       /* We only accept IP packets of the configured type and ARP packets */
 
 #ifdef CONFIG_NET_IPv4
@@ -439,29 +635,52 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           netdev_upper_txpoll(dev);
         }
     }
+
+#ifdef CONFIG_NETDEV_GRO
+  netdev_upper_gro_flush(dev);
+#endif
+
+  return false;
 }
 
 /****************************************************************************
- * Name: netdev_upper_txavail_work
+ * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll of one queue on a dedicated thread or the
+ *   worker thread.
  *
  * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ *   arg - Reference to the upper half queue structure (cast to void *)
  *
  ****************************************************************************/
 
 static void netdev_upper_work(FAR void *arg)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_upper_queue_s *queue = arg;
+  FAR struct netdev_upperhalf_s   *upper = queue->upper;
+  FAR struct netdev_lowerhalf_s   *lower = upper->lower;
+  bool                             empty;
 
   /* RX may release quota and driver buffer, so do RX first. */
 
   net_lock();
-  netdev_upper_rxpoll_work(upper);
+  empty = netdev_upper_rxpoll_work(upper, queue->index);
   netdev_upper_txavail_work(upper);
   net_unlock();
+
+  if (!empty)
+    {
+      /* The budget is exhausted.  Keep the RX interrupt off and poll
+       * again after the network lock had a chance to change hands.
+       */
+
+      netdev_upper_queue_work(upper, queue->index);
+    }
+  else if (lower->ops->rxintr != NULL)
+    {
+      lower->ops->rxintr(lower, queue->index, true);
+    }
 }
 
 /****************************************************************************
@@ -475,16 +694,17 @@ static void netdev_upper_work(FAR void *arg)
 #ifdef CONFIG_NETDEV_WORK_THREAD
 static int netdev_upper_loop(int argc, FAR char *argv[])
 {
-  FAR struct netdev_upperhalf_s *upper =
-    (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct netdev_upper_queue_s *queue =
+    (FAR struct netdev_upper_queue_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 16));
 
-  while (nxsem_wait(&upper->sem) == OK && upper->tid != INVALID_PROCESS_ID)
+  while (nxsem_wait(&queue->sem) == OK && queue->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_work(queue);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
-  nxsem_post(&upper->sem_exit);
+  nxsem_post(&queue->sem_exit);
   return 0;
 }
 #endif
@@ -493,29 +713,31 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  * Name: netdev_upper_queue_work
  *
  * Description:
- *   Called when there is any work to do.
+ *   Called when there is any work to do on a queue.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   upper - Reference to the upper half driver structure
+ *   index - The index of the queue
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+static void netdev_upper_queue_work(FAR struct netdev_upperhalf_s *upper,
+                                    int index)
 {
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_upper_queue_s *queue = &upper->queue[index];
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
   int semcount;
-  if (nxsem_get_value(&upper->sem, &semcount) == OK && semcount <= 0)
+  if (nxsem_get_value(&queue->sem, &semcount) == OK && semcount <= 0)
     {
-      nxsem_post(&upper->sem);
+      nxsem_post(&queue->sem);
     }
 #else
-  if (work_available(&upper->work))
+  if (work_available(&queue->work))
     {
       /* Schedule to serialize the poll on the worker thread. */
 
-      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
+      work_queue(NETDEV_WORK, &queue->work, netdev_upper_work, queue, 0);
     }
 #endif
 }
@@ -533,7 +755,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev)
 {
-  netdev_upper_queue_work(dev);
+  netdev_upper_queue_work(dev->d_private, 0);
   return OK;
 }
 
@@ -550,26 +772,57 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  /* Try to bring up a dedicated thread for work. */
+  int i;
 
-  if (upper->tid <= 0)
+  /* Try to bring up a dedicated thread for the work of each queue. */
+
+  for (i = 0; i < upper->nqueues; i++)
     {
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
       FAR char *argv[2];
       char      arg1[32];
       char      name[32];
 
-      snprintf(arg1, sizeof(arg1), "%p", upper);
-      snprintf(name, sizeof(name), NETDEV_THREAD_NAME_FMT, dev->d_ifname);
+      if (queue->tid > 0)
+        {
+          continue;
+        }
+
+      snprintf(arg1, sizeof(arg1), "%p", queue);
+      if (upper->nqueues > 1)
+        {
+          snprintf(name, sizeof(name), NETDEV_QUEUE_NAME_FMT,
+                   dev->d_ifname, i);
+        }
+      else
+        {
+          snprintf(name, sizeof(name), NETDEV_THREAD_NAME_FMT,
+                   dev->d_ifname);
+        }
+
       argv[0] = arg1;
       argv[1] = NULL;
 
-      upper->tid = kthread_create(name, CONFIG_NETDEV_WORK_THREAD_PRIORITY,
+      queue->tid = kthread_create(name, CONFIG_NETDEV_WORK_THREAD_PRIORITY,
                                   CONFIG_DEFAULT_TASK_STACKSIZE,
                                   netdev_upper_loop, argv);
-      if (upper->tid < 0)
+      if (queue->tid < 0)
+        {
+          return queue->tid;
+        }
+
+#ifdef CONFIG_SMP
+      /* Spread the queues over the CPUs */
+
+      if (upper->nqueues > 1)
         {
-          return upper->tid;
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(i % CONFIG_SMP_NCPUS, &cpuset);
+          nxsched_set_affinity(queue->tid, sizeof(cpuset), &cpuset);
         }
+#endif
     }
 #endif
 
@@ -586,7 +839,12 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
 #ifndef CONFIG_NETDEV_WORK_THREAD
-  work_cancel(NETDEV_WORK, &upper->work);
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      work_cancel(NETDEV_WORK, &upper->queue[i].work);
+    }
 #endif
 
   if (upper->lower->ops->ifdown)
@@ -699,9 +957,13 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       dev->netdev.d_private = NULL;
     }
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
-  nxsem_init(&upper->sem, 0, 0);
-  nxsem_init(&upper->sem_exit, 0, 0);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  else
+    {
+      /* The link layer header size is known after the registration */
+
+      netdev_upper_features(&dev->netdev);
+    }
 #endif
 
   return ret;
@@ -724,6 +986,9 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper;
+#ifdef CONFIG_NETDEV_WORK_THREAD
+  int i;
+#endif
   int ret;
 
   if (dev == NULL || dev->netdev.d_private == NULL)
@@ -739,17 +1004,22 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
     }
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  if (upper->tid > 0)
+  for (i = 0; i < upper->nqueues; i++)
     {
-      /* Try to tear down the dedicated thread for work. */
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
 
-      upper->tid = INVALID_PROCESS_ID;
-      nxsem_post(&upper->sem);
-      nxsem_wait(&upper->sem_exit);
-    }
+      if (queue->tid > 0)
+        {
+          /* Try to tear down the dedicated thread for work. */
+
+          queue->tid = INVALID_PROCESS_ID;
+          nxsem_post(&queue->sem);
+          nxsem_wait(&queue->sem_exit);
+        }
 
-  nxsem_destroy(&upper->sem);
-  nxsem_destroy(&upper->sem_exit);
+      nxsem_destroy(&queue->sem);
+      nxsem_destroy(&queue->sem_exit);
+    }
 #endif
 
   kmm_free(upper);
@@ -811,7 +1081,7 @@ int netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
-  netdev_upper_queue_work(&dev->netdev);
+  netdev_lower_rxready_queue(dev, 0);
 }
 
 /****************************************************************************
@@ -827,8 +1097,59 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 {
+  netdev_lower_txdone_queue(dev, 0);
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   a queue.  The RX interrupt of the queue is disabled until the queue
+ *   has been polled empty.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(queue >= 0 && queue < upper->nqueues);
+
+  if (dev->ops->rxintr != NULL)
+    {
+      dev->ops->rxintr(dev, queue, false);
+    }
+
+  netdev_upper_queue_work(upper, queue);
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on a queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(queue >= 0 && queue < upper->nqueues);
+
   NETDEV_TXDONE(&dev->netdev);
-  netdev_upper_queue_work(&dev->netdev);
+  netdev_upper_queue_work(upper, queue);
 }
 
 /****************************************************************************
@@ -1068,3 +1389,148 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt)
 {
   return pkt->io_flink != NULL;
 }
+
+/****************************************************************************
+ * Name: netpkt_flowhash
+ *
+ * Description:
+ *   Return a hash of the flow of a packet.  The hash is symmetric, so both
+ *   directions of a connection map to the same queue.  Packets that are
+ *   not IP, or whose headers are not in the head of the chain, hash to 0.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+uint32_t netpkt_flowhash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  FAR const uint8_t *ip = IOB_DATA(pkt);
+  FAR const uint8_t *ports = NULL;
+  FAR const uint8_t *addr;
+  unsigned int addrlen;
+  unsigned int i;
+  uint32_t hash = 0;
+  uint8_t proto;
+
+  UNUSED(dev);
+
+  if (pkt->io_len < 1)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      unsigned int hdrlen = (ip[0] & IPv4_HLMASK) << 2;
+
+      if (pkt->io_len < IPv4_HDRLEN)
+        {
+          return 0;
+        }
+
+      proto   = ip[9];
+      addr    = &ip[12];
+      addrlen = 2 * sizeof(in_addr_t);
+
+      /* Only the first fragment carries the ports */
+
+      if ((ip[6] & 0x3f) == 0 && ip[7] == 0)
+        {
+          ports = &ip[hdrlen];
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      if (pkt->io_len < IPv6_HDRLEN)
+        {
+          return 0;
+        }
+
+      proto   = ip[6];
+      addr    = &ip[8];
+      addrlen = 2 * sizeof(net_ipv6addr_t);
+      ports   = &ip[IPv6_HDRLEN];
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  /* XOR the source and destination so that the hash is symmetric */
+
+  for (i = 0; i < addrlen / 2; i += 4)
+    {
+      hash ^= ((uint32_t)(addr[i] ^ addr[i + addrlen / 2]) << 24) |
+              ((uint32_t)(addr[i + 1] ^ addr[i + 1 + addrlen / 2]) << 16) |
+              ((uint32_t)(addr[i + 2] ^ addr[i + 2 + addrlen / 2]) << 8) |
+              (uint32_t)(addr[i + 3] ^ addr[i + 3 + addrlen / 2]);
+    }
+
+  hash ^= proto;
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) && ports != NULL &&
+      ports + 4 <= ip + pkt->io_len)
+    {
+      hash ^= ((uint32_t)(ports[0] ^ ports[2]) << 16) |
+              ((uint32_t)(ports[1] ^ ports[3]) << 8);
+    }
+
+  /* Mix the bits (the finalizer of MurmurHash3) */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: netpkt_get_offload
+ *
+ * Description:
+ *   Get the offload requests of a TX netpkt.
+ *
+ * Input Parameters:
+ *   dev     - The lower half device driver structure
+ *   pkt     - The net packet
+ *   offload - Location to return the offload requests
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+void netpkt_get_offload(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt,
+                        FAR struct netpkt_offload_s *offload)
+{
+  unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+
+  memset(offload, 0, sizeof(*offload));
+
+  offload->flags = pkt->io_offload;
+  if ((offload->flags & NETDEV_OFFLOAD_CSUM) != 0)
+    {
+      offload->csumstart = pkt->io_csumstart + llhdrlen;
+      offload->csumoff   = pkt->io_csumoff;
+    }
+
+  if ((offload->flags & NETDEV_OFFLOAD_TSO) != 0)
+    {
+      FAR const struct tcp_hdr_s *tcp =
+        (FAR const struct tcp_hdr_s *)(IOB_DATA(pkt) + pkt->io_csumstart);
+
+      /* The TCP header is in the head of the chain, checked by the stack */
+
+      offload->hdrlen  = offload->csumstart + ((tcp->tcpoffset >> 4) << 2);
+      offload->gsosize = pkt->io_gsosize;
+    }
+}
+#endif
@@ -26,6 +26,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
@@ -36,6 +37,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/signal.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/telnet.h>
@@ -56,6 +58,10 @@
 #  define CONFIG_TELNET_TXBUFFER_SIZE 256
 #endif
 
+#ifndef CONFIG_TELNET_TXDELAY
+#  define CONFIG_TELNET_TXDELAY 0
+#endif
+
 #ifndef CONFIG_TELNET_MAXLCLIENTS
 #  define CONFIG_TELNET_MAXLCLIENTS 8
 #endif
@@ -118,6 +124,12 @@ struct telnet_dev_s
   uint8_t           td_minor;     /* Minor device number */
   uint16_t          td_offset;    /* Offset to the valid, pending bytes in the rxbuffer */
   uint16_t          td_pending;   /* Number of valid, pending bytes in the rxbuffer */
+  uint16_t          td_txpending; /* Number of bytes waiting in the txbuffer */
+#if CONFIG_TELNET_TXDELAY > 0
+  bool              td_txqueued;  /* td_txwork is queued or running */
+  mutex_t           td_txlock;    /* Serializes the txbuffer with td_txwork */
+  struct work_s     td_txwork;    /* Sends the txbuffer after the delay */
+#endif
 #ifdef CONFIG_TELNET_SUPPORT_NAWS
   uint16_t          td_rows;      /* Number of NAWS rows */
   uint16_t          td_cols;      /* Number of NAWS cols */
@@ -144,13 +156,20 @@ static inline void telnet_dumpbuffer(FAR const char *msg,
 #else
 #  define telnet_dumpbuffer(msg,buffer,nbytes)
 #endif
+#if CONFIG_TELNET_TXDELAY > 0
+static void    telnet_txsync(FAR struct telnet_dev_s *priv);
+#else
+#  define telnet_txsync(priv)
+#endif
 static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
                  FAR char *dest, int *nread);
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 int *nwritten);
+static int     telnet_flush(FAR struct telnet_dev_s *priv);
+#if CONFIG_TELNET_TXDELAY > 0
+static void    telnet_txworker(FAR void *arg);
+#endif
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
 
@@ -332,14 +351,38 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                               FAR const char *src, size_t srclen,
                               FAR char *dest, size_t destlen)
 {
+  FAR const char *iac;
+  size_t run;
   int nread;
   uint8_t ch;
 
   ninfo("srclen: %zd destlen: %zd\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  for (nread = 0; srclen > 0 && nread < destlen; )
     {
+      /* Outside of a command, copy everything up to the next IAC at once */
+
+      if (priv->td_state == STATE_NORMAL)
+        {
+          iac = memchr(src, TELNET_IAC, srclen);
+          run = iac != NULL ? iac - src : srclen;
+          if (run > destlen - nread)
+            {
+              run = destlen - nread;
+            }
+
+          if (run > 0)
+            {
+              memcpy(&dest[nread], src, run);
+              nread  += run;
+              src    += run;
+              srclen -= run;
+              continue;
+            }
+        }
+
       ch = *src++;
+      srclen--;
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -535,48 +578,72 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
 }
 
 /****************************************************************************
- * Name: telnet_putchar
+ * Name: telnet_flush
  *
  * Description:
- *   Put another character from the user buffer to the TX buffer.
+ *   Send whatever is waiting in the TX buffer.
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           int *nread)
+static int telnet_flush(FAR struct telnet_dev_s *priv)
 {
-  register int index;
-  bool ret = false;
+  ssize_t ret;
 
-  /* Ignore carriage returns (we will put these in automatically as
-   * necessary).
-   */
-
-  if (ch != TELNET_CR)
+  if (priv->td_txpending == 0)
     {
-      /* Add all other characters to the destination buffer */
+      return OK;
+    }
 
-      index = *nread;
-      priv->td_txbuffer[index++] = ch;
+  ret = psock_send(&priv->td_psock, priv->td_txbuffer, priv->td_txpending,
+                   0);
 
-      /* Check for line feeds */
+  /* Whatever happened, the data is not sent again */
 
-      if (ch == TELNET_NL)
-        {
-          /* Now add the carriage return */
+  priv->td_txpending = 0;
+  if (ret < 0)
+    {
+      nerr("ERROR: psock_send failed: %zd\n", ret);
+      return ret;
+    }
 
-          priv->td_txbuffer[index++] = TELNET_CR;
+  return OK;
+}
 
-          /* End of line */
+#if CONFIG_TELNET_TXDELAY > 0
+/****************************************************************************
+ * Name: telnet_txworker
+ *
+ * Description:
+ *   Send the output left pending by telnet_write() when its delay expires.
+ *
+ ****************************************************************************/
 
-          ret = true;
-        }
+static void telnet_txworker(FAR void *arg)
+{
+  FAR struct telnet_dev_s *priv = arg;
 
-      *nread = index;
-    }
+  nxmutex_lock(&priv->td_txlock);
+  telnet_flush(priv);
+  priv->td_txqueued = false;
+  nxmutex_unlock(&priv->td_txlock);
+}
 
-  return ret;
+/****************************************************************************
+ * Name: telnet_txsync
+ *
+ * Description:
+ *   Send the output left pending by telnet_write() now, so that a prompt is
+ *   not held back while waiting for the answer.
+ *
+ ****************************************************************************/
+
+static void telnet_txsync(FAR struct telnet_dev_s *priv)
+{
+  nxmutex_lock(&priv->td_txlock);
+  telnet_flush(priv);
+  nxmutex_unlock(&priv->td_txlock);
 }
+#endif
 
 /****************************************************************************
  * Name: telnet_sendopt
@@ -732,6 +799,25 @@ static int telnet_close(FAR struct file *filep)
             }
         }
 
+#if CONFIG_TELNET_TXDELAY > 0
+      /* Send the pending output, and wait for td_txwork if it is already
+       * running, before the instance goes away.
+       */
+
+      nxmutex_lock(&priv->td_txlock);
+      telnet_flush(priv);
+      while (priv->td_txqueued &&
+             work_cancel(LPWORK, &priv->td_txwork) < 0)
+        {
+          nxmutex_unlock(&priv->td_txlock);
+          nxsig_usleep(1000);
+          nxmutex_lock(&priv->td_txlock);
+        }
+
+      nxmutex_unlock(&priv->td_txlock);
+      nxmutex_destroy(&priv->td_txlock);
+#endif
+
       /* Close the socket */
 
       psock_close(&priv->td_psock);
@@ -768,6 +854,7 @@ static ssize_t telnet_read(FAR struct file *filep, FAR char *buffer,
 
       if (priv->td_pending == 0)
         {
+          telnet_txsync(priv);
           nread = psock_recv(&priv->td_psock,
                              priv->td_rxbuffer,
                              CONFIG_TELNET_RXBUFFER_SIZE,
@@ -815,60 +902,94 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
-  ssize_t ret = 0;
-  ssize_t nsent;
-  int ncopied;
-  char ch;
-  bool eol;
+  ssize_t nsent = 0;
+  size_t room;
+  size_t run;
+  int ret = OK;
 
   ninfo("len: %zd\n", len);
 
-  /* Process each character from the user buffer */
-
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+#if CONFIG_TELNET_TXDELAY > 0
+  ret = nxmutex_lock(&priv->td_txlock);
+  if (ret < 0)
     {
-      /* Get the next character from the user buffer */
-
-      ch = *src++;
-
-      /* Add the character to the TX buffer */
-
-      eol = telnet_putchar(priv, ch, &ncopied);
+      return ret;
+    }
+#endif
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n")?
+  while (nsent < len)
+    {
+      /* Is the buffer too full to hold the next largest character sequence
+       * ("\n\r")?  Then send the data now.
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
+      room = CONFIG_TELNET_TXBUFFER_SIZE - priv->td_txpending;
+      if (room < 2)
         {
-          /* Yes... send the data now */
-
-          ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+          ret = telnet_flush(priv);
           if (ret < 0)
             {
-              nerr("ERROR: psock_send failed '%s': %zd\n",
-                   priv->td_txbuffer, ret);
               goto out;
             }
 
-          /* Reset the index to the beginning of the TX buffer. */
+          room = CONFIG_TELNET_TXBUFFER_SIZE;
+        }
 
-          ncopied = 0;
+      /* Copy the characters up to the next end of line at once */
+
+      for (run = 0; run < len - nsent && run < room; run++)
+        {
+          if (src[run] == TELNET_CR || src[run] == TELNET_NL)
+            {
+              break;
+            }
+        }
+
+      memcpy(&priv->td_txbuffer[priv->td_txpending], src, run);
+      priv->td_txpending += run;
+      src   += run;
+      nsent += run;
+
+      if (nsent < len && run < room)
+        {
+          /* Ignore carriage returns and add one after each line feed,
+           * unless that has to wait for the buffer to be sent.
+           */
+
+          if (*src == TELNET_CR)
+            {
+              src++;
+              nsent++;
+            }
+          else if (room - run >= 2)
+            {
+              priv->td_txbuffer[priv->td_txpending++] = TELNET_NL;
+              priv->td_txbuffer[priv->td_txpending++] = TELNET_CR;
+              src++;
+              nsent++;
+            }
         }
     }
 
-  /* Send anything remaining in the TX buffer */
+  /* Send anything remaining in the TX buffer, or leave it for a while in
+   * case more output follows.
+   */
 
-  if (ncopied > 0)
+#if CONFIG_TELNET_TXDELAY > 0
+  if (priv->td_txpending > 0 && !priv->td_txqueued)
     {
-      ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+      priv->td_txqueued = true;
+      ret = work_queue(LPWORK, &priv->td_txwork, telnet_txworker, priv,
+                       MSEC2TICK(CONFIG_TELNET_TXDELAY));
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %zd\n",
-               priv->td_txbuffer, ret);
-          goto out;
+          priv->td_txqueued = false;
+          ret = telnet_flush(priv);
         }
     }
+#else
+  ret = telnet_flush(priv);
+#endif
 
   /* Notice that we don't actually return the number of bytes sent, but
    * rather, the number of bytes that the caller asked us to send.  We may
@@ -877,6 +998,9 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
    */
 
 out:
+#if CONFIG_TELNET_TXDELAY > 0
+  nxmutex_unlock(&priv->td_txlock);
+#endif
   return nsent ? nsent : ret;
 }
 
@@ -917,6 +1041,10 @@ static int telnet_session(FAR struct telnet_session_s *session)
   priv->td_minor     = 0;
   priv->td_pending   = 0;
   priv->td_offset    = 0;
+  priv->td_txpending = 0;
+#if CONFIG_TELNET_TXDELAY > 0
+  nxmutex_init(&priv->td_txlock);
+#endif
 #ifdef HAVE_SIGNALS
   priv->td_pid       = INVALID_PROCESS_ID;
 #endif
@@ -1160,6 +1288,11 @@ static int telnet_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
   DEBUGASSERT(fds != NULL);
 
+  if (setup)
+    {
+      telnet_txsync(priv);
+    }
+
   /* Test if we have cached data waiting to be read */
 
   if (priv->td_pending > 0)
@@ -38,6 +38,7 @@
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notelog_driver.h>
+#include <nuttx/note/notestream_driver.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 
@@ -169,6 +170,9 @@ FAR static struct note_driver_s *
 #endif
 #ifdef CONFIG_DRIVERS_NOTELOG
   &g_notelog_driver,
+#endif
+#ifdef CONFIG_DRIVERS_NOTESTREAM
+  &g_notestream_driver,
 #endif
   NULL
 };
@@ -179,6 +183,16 @@ static struct note_taskname_s g_note_taskname;
 
 static spinlock_t g_note_lock;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+/* The last perf count and the number of wraps of the count, per CPU */
+
+static struct
+{
+  unsigned long last;
+  time_t wraps;
+} g_note_perf[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -226,14 +240,38 @@ static void note_common(FAR struct tcb_s *tcb,
                         FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
-#ifdef CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT
+#if defined(CONFIG_DRIVERS_NOTERAM_RAWTIME)
+  unsigned long count;
+  irqstate_t flags;
+  int cpu;
+#elif defined(CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT)
   struct timespec perftime;
 #endif
   struct timespec ts;
+
+#if defined(CONFIG_DRIVERS_NOTERAM_RAWTIME)
+  /* Keep the raw count, the wraps in the seconds.  The note RAM driver
+   * converts it when the note is read.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+  count = up_perf_gettime();
+  if (count < g_note_perf[cpu].last)
+    {
+      g_note_perf[cpu].wraps++;
+    }
+
+  g_note_perf[cpu].last = count;
+  ts.tv_sec  = g_note_perf[cpu].wraps;
+  ts.tv_nsec = (long)count;
+  up_irq_restore(flags);
+#else
   clock_systime_timespec(&ts);
-#ifdef CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT
+#  ifdef CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT
   up_perf_convert(up_perf_gettime(), &perftime);
   ts.tv_nsec = perftime.tv_nsec;
+#  endif
 #endif
 
   /* Save all of the common fields */
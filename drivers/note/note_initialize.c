@@ -26,6 +26,7 @@
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
 #include <nuttx/note/notesnap_driver.h>
+#include <nuttx/note/notestream_driver.h>
 #include <nuttx/segger/sysview.h>
 
 /****************************************************************************
@@ -83,5 +84,13 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM
+  ret = notestream_register();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return ret;
 }
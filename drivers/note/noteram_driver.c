@@ -25,12 +25,17 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <sched.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -38,16 +43,34 @@
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/fs/fs.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With CONFIG_DRIVERS_NOTERAM_PERCPU each CPU writes its own buffer, so the
+ * lock of a buffer is only shared by its CPU and the reader.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NBUFFERS CONFIG_SMP_NCPUS
+#  define noteram_this()   (&g_noteram_info[up_cpu_index()])
+#else
+#  define NOTERAM_NBUFFERS 1
+#  define noteram_this()   (&g_noteram_info[0])
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct noteram_info_s
 {
-  unsigned int ni_overwrite;
+  bool ni_overflow;                /* Stopped recording, the buffer is full */
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
+  unsigned long ni_overrun;        /* Number of unread notes lost */
+  spinlock_t ni_lock;
   uint8_t ni_buffer[CONFIG_DRIVERS_NOTERAM_BUFSIZE];
 };
 
@@ -76,22 +99,24 @@ static const struct file_operations g_noteram_fops =
   noteram_ioctl, /* ioctl */
 };
 
-static struct noteram_info_s g_noteram_info =
-{
+/* The overwrite mode is shared by all buffers, NOTERAM_MODE_OVERWRITE_DISABLE
+ * or NOTERAM_MODE_OVERWRITE_ENABLE.  The overflow state is kept per buffer.
+ */
+
+static unsigned int g_noteram_overwrite =
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
-  NOTERAM_MODE_OVERWRITE_DISABLE
+  NOTERAM_MODE_OVERWRITE_DISABLE;
 #else
-  NOTERAM_MODE_OVERWRITE_ENABLE
+  NOTERAM_MODE_OVERWRITE_ENABLE;
 #endif
-};
+
+static struct noteram_info_s g_noteram_info[NOTERAM_NBUFFERS];
 
 static const struct note_driver_ops_s g_noteram_ops =
 {
   noteram_add
 };
 
-static spinlock_t g_noteram_lock;
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -105,6 +130,94 @@ struct note_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: noteram_getle
+ *
+ * Description:
+ *   Get an unsigned value stored in the little endian layout of the notes.
+ *
+ ****************************************************************************/
+
+static uint64_t noteram_getle(FAR const uint8_t *src, size_t len)
+{
+  uint64_t value = 0;
+
+  while (len-- > 0)
+    {
+      value = (value << 8) | src[len];
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: noteram_putle
+ *
+ * Description:
+ *   Store an unsigned value in the little endian layout of the notes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+static void noteram_putle(FAR uint8_t *dst, uint64_t value, size_t len)
+{
+  while (len-- > 0)
+    {
+      *dst++ = (uint8_t)value;
+      value >>= 8;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: noteram_timestamp
+ *
+ * Description:
+ *   Return the time stamp of a note as a value that orders the notes: the
+ *   nanoseconds since boot, or the extended perf count if the notes carry
+ *   the raw count.
+ *
+ ****************************************************************************/
+
+static uint64_t noteram_timestamp(FAR const struct note_common_s *note)
+{
+  uint64_t sec  = noteram_getle(note->nc_systime_sec,
+                                sizeof(note->nc_systime_sec));
+  uint64_t nsec = noteram_getle(note->nc_systime_nsec,
+                                sizeof(note->nc_systime_nsec));
+
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+  /* The seconds hold the wraps of the counter in the nanoseconds.  The
+   * shift is split in two, it is as wide as the counter.
+   */
+
+  return (sec << (4 * sizeof(long)) << (4 * sizeof(long))) | nsec;
+#else
+  return sec * NSEC_PER_SEC + nsec;
+#endif
+}
+
+/****************************************************************************
+ * Name: noteram_convert
+ *
+ * Description:
+ *   Convert the raw perf count of a note read into the time since boot.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+static void noteram_convert(FAR struct note_common_s *note)
+{
+  uint64_t count = noteram_timestamp(note);
+  uint64_t freq = up_perf_getfreq();
+
+  noteram_putle(note->nc_systime_sec, count / freq,
+                sizeof(note->nc_systime_sec));
+  noteram_putle(note->nc_systime_nsec, count % freq * NSEC_PER_SEC / freq,
+                sizeof(note->nc_systime_nsec));
+}
+#endif
+
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -112,22 +225,19 @@ struct note_driver_s g_noteram_driver =
  *   Clear all contents of the circular buffer.
  *
  * Input Parameters:
- *   None.
+ *   ni - The buffer to clear.
  *
  * Returned Value:
  *   None.
  *
  ****************************************************************************/
 
-static void noteram_buffer_clear(void)
+static void noteram_buffer_clear(FAR struct noteram_info_s *ni)
 {
-  g_noteram_info.ni_tail = g_noteram_info.ni_head;
-  g_noteram_info.ni_read = g_noteram_info.ni_head;
-
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
-    {
-      g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
-    }
+  ni->ni_tail     = ni->ni_head;
+  ni->ni_read     = ni->ni_head;
+  ni->ni_overflow = false;
+  ni->ni_overrun  = 0;
 }
 
 /****************************************************************************
@@ -164,17 +274,17 @@ static inline unsigned int noteram_next(unsigned int ndx,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(void)
+static unsigned int noteram_length(FAR struct noteram_info_s *ni)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int tail = g_noteram_info.ni_tail;
+  unsigned int head = ni->ni_head;
+  unsigned int tail = ni->ni_tail;
 
   if (tail > head)
     {
@@ -191,17 +301,17 @@ static unsigned int noteram_length(void)
  *   Length of unread data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of unread data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(void)
+static unsigned int noteram_unread_length(FAR struct noteram_info_s *ni)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int read = g_noteram_info.ni_read;
+  unsigned int head = ni->ni_head;
+  unsigned int read = ni->ni_read;
 
   if (read > head)
     {
@@ -218,43 +328,44 @@ static unsigned int noteram_unread_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The lock of the buffer is held.
  *
  ****************************************************************************/
 
-static void noteram_remove(void)
+static void noteram_remove(FAR struct noteram_info_s *ni)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_noteram_info.ni_tail;
+  tail = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_DRIVERS_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  length = g_noteram_info.ni_buffer[tail];
-  DEBUGASSERT(length <= noteram_length());
+  length = ni->ni_buffer[tail];
+  DEBUGASSERT(length <= noteram_length(ni));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  if (g_noteram_info.ni_read == g_noteram_info.ni_tail)
+  if (ni->ni_read == ni->ni_tail)
     {
-      /* The read index also needs increment. */
+      /* The note was not read yet, the read index also needs increment. */
 
-      g_noteram_info.ni_read = noteram_next(tail, length);
+      ni->ni_read = noteram_next(tail, length);
+      ni->ni_overrun++;
     }
 
-  g_noteram_info.ni_tail = noteram_next(tail, length);
+  ni->ni_tail = noteram_next(tail, length);
 }
 
 /****************************************************************************
@@ -264,6 +375,7 @@ static void noteram_remove(void)
  *   Get the next note from the read index of the circular buffer.
  *
  * Input Parameters:
+ *   ni     - The circular buffer
  *   buffer - Location to return the next note
  *   buflen - The length of the user provided buffer.
  *
@@ -274,7 +386,8 @@ static void noteram_remove(void)
  *
  ****************************************************************************/
 
-static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
+static ssize_t noteram_get(FAR struct noteram_info_s *ni,
+                           FAR uint8_t *buffer, size_t buflen)
 {
   FAR struct note_common_s *note;
   unsigned int remaining;
@@ -286,7 +399,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length();
+  circlen = noteram_unread_length(ni);
   if (circlen <= 0)
     {
       return 0;
@@ -294,12 +407,12 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
 
   /* Get the read index of the circular buffer */
 
-  read    = g_noteram_info.ni_read;
+  read    = ni->ni_read;
   DEBUGASSERT(read < CONFIG_DRIVERS_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the read index */
 
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
+  note    = (FAR struct note_common_s *)&ni->ni_buffer[read];
   notelen = note->nc_length;
   DEBUGASSERT(notelen <= circlen);
 
@@ -309,7 +422,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Skip the large note so that we do not get constipated. */
 
-      g_noteram_info.ni_read = noteram_next(read, notelen);
+      ni->ni_read = noteram_next(read, notelen);
 
       /* and return an error */
 
@@ -323,7 +436,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Copy the next byte at the read index */
 
-      *buffer++ = g_noteram_info.ni_buffer[read];
+      *buffer++ = ni->ni_buffer[read];
 
       /* Adjust indices and counts */
 
@@ -331,7 +444,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
       remaining--;
     }
 
-  g_noteram_info.ni_read = read;
+  ni->ni_read = read;
 
   return notelen;
 }
@@ -341,10 +454,11 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
  *
  * Description:
  *   Return the size of the next note at the read index of the circular
- *   buffer.
+ *   buffer, and optionally its time stamp.
  *
  * Input Parameters:
- *   None.
+ *   ni        - The circular buffer
+ *   timestamp - Location to return the time stamp of the note, or NULL
  *
  * Returned Value:
  *   Zero is returned if the circular buffer is empty.  Otherwise, the size
@@ -352,16 +466,18 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
  *
  ****************************************************************************/
 
-static ssize_t noteram_size(void)
+static ssize_t noteram_size(FAR struct noteram_info_s *ni,
+                            FAR uint64_t *timestamp)
 {
-  FAR struct note_common_s *note;
+  struct note_common_s note;
+  FAR uint8_t *dst;
   unsigned int read;
-  ssize_t notelen;
   size_t circlen;
+  size_t i;
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length();
+  circlen = noteram_unread_length(ni);
   if (circlen <= 0)
     {
       return 0;
@@ -369,16 +485,83 @@ static ssize_t noteram_size(void)
 
   /* Get the read index of the circular buffer */
 
-  read = g_noteram_info.ni_read;
+  read = ni->ni_read;
   DEBUGASSERT(read < CONFIG_DRIVERS_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the read index */
 
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  note.nc_length = ni->ni_buffer[read];
+  DEBUGASSERT(note.nc_length <= circlen);
 
-  return notelen;
+  if (timestamp != NULL)
+    {
+      /* The common part of the note may wrap around the buffer */
+
+      dst = (FAR uint8_t *)&note;
+      for (i = 0; i < sizeof(note); i++)
+        {
+          dst[i] = ni->ni_buffer[read];
+          read   = noteram_next(read, 1);
+        }
+
+      *timestamp = noteram_timestamp(&note);
+    }
+
+  return note.nc_length;
+}
+
+/****************************************************************************
+ * Name: noteram_oldest
+ *
+ * Description:
+ *   Find the buffer holding the oldest unread note, so that the notes of
+ *   all CPUs are read in the order of their time stamps.
+ *
+ * Input Parameters:
+ *   notelen - Location to return the size of the oldest note
+ *
+ * Returned Value:
+ *   The buffer holding the oldest note; NULL if all buffers are empty.
+ *
+ ****************************************************************************/
+
+static FAR struct noteram_info_s *noteram_oldest(FAR ssize_t *notelen)
+{
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_info_s *oldest = NULL;
+  FAR struct noteram_info_s *ni;
+  uint64_t timestamp;
+  uint64_t first = 0;
+  irqstate_t flags;
+  ssize_t len;
+  int cpu;
+
+  for (cpu = 0; cpu < NOTERAM_NBUFFERS; cpu++)
+    {
+      ni    = &g_noteram_info[cpu];
+      flags = spin_lock_irqsave_wo_note(&ni->ni_lock);
+      len   = noteram_size(ni, &timestamp);
+      spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+
+      if (len > 0 && (oldest == NULL || timestamp < first))
+        {
+          oldest   = ni;
+          first    = timestamp;
+          *notelen = len;
+        }
+    }
+
+  return oldest;
+#else
+  FAR struct noteram_info_s *ni = &g_noteram_info[0];
+  irqstate_t flags;
+
+  flags    = spin_lock_irqsave_wo_note(&ni->ni_lock);
+  *notelen = noteram_size(ni, NULL);
+  spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+
+  return *notelen > 0 ? ni : NULL;
+#endif
 }
 
 /****************************************************************************
@@ -387,9 +570,19 @@ static ssize_t noteram_size(void)
 
 static int noteram_open(FAR struct file *filep)
 {
-  /* Reset the read index of the circular buffer */
+  FAR struct noteram_info_s *ni;
+  irqstate_t flags;
+  int i;
 
-  g_noteram_info.ni_read = g_noteram_info.ni_tail;
+  /* Reset the read index of the circular buffers */
+
+  for (i = 0; i < NOTERAM_NBUFFERS; i++)
+    {
+      ni          = &g_noteram_info[i];
+      flags       = spin_lock_irqsave_wo_note(&ni->ni_lock);
+      ni->ni_read = ni->ni_tail;
+      spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+    }
 
   return OK;
 }
@@ -401,21 +594,38 @@ static int noteram_open(FAR struct file *filep)
 static ssize_t noteram_read(FAR struct file *filep,
                             FAR char *buffer, size_t buflen)
 {
+  FAR struct noteram_info_s *ni;
   ssize_t notelen;
-  ssize_t retlen ;
+  ssize_t retlen;
   irqstate_t flags;
 
   DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
 
-  /* Then loop, adding as many notes as possible to the user buffer. */
+  /* Then loop, adding as many notes as possible to the user buffer, the
+   * oldest note first.
+   */
 
   retlen = 0;
-  flags = spin_lock_irqsave_wo_note(&g_noteram_lock);
-  do
+  while ((ni = noteram_oldest(&notelen)) != NULL)
     {
+      /* Will the next note fit?  There is a race here and even if the next
+       * note will fit, it may fail still when noteram_get() is called.
+       *
+       * If it won't fit, return what we have without trying to get the
+       * next note (which would cause it to be deleted).
+       */
+
+      if (retlen > 0 && notelen > buflen)
+        {
+          break;
+        }
+
       /* Get the next note (removing it from the buffer) */
 
-      notelen = noteram_get((FAR uint8_t *)buffer, buflen);
+      flags   = spin_lock_irqsave_wo_note(&ni->ni_lock);
+      notelen = noteram_get(ni, (FAR uint8_t *)buffer, buflen);
+      spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+
       if (notelen < 0)
         {
           /* We were unable to read the next note, probably because it will
@@ -434,24 +644,20 @@ static ssize_t noteram_read(FAR struct file *filep,
           break;
         }
 
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+      if (notelen > 0)
+        {
+          noteram_convert((FAR struct note_common_s *)buffer);
+        }
+#endif
+
       /* Update pointers from the note that was transferred */
 
       retlen += notelen;
       buffer += notelen;
       buflen -= notelen;
-
-      /* Will the next note fit?  There is a race here and even if the next
-       * note will fit, it may fail still when noteram_get() is called.
-       *
-       * It won't fit (or an error occurred).  Return what we have without
-       * trying to get the next note (which would cause it to be deleted).
-       */
-
-      notelen = noteram_size();
     }
-  while (notelen > 0 && notelen <= buflen);
 
-  spin_unlock_irqrestore_wo_note(&g_noteram_lock, flags);
   return retlen;
 }
 
@@ -461,8 +667,10 @@ static ssize_t noteram_read(FAR struct file *filep,
 
 static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct noteram_info_s *ni;
+  irqstate_t flags;
   int ret = -ENOSYS;
-  irqstate_t flags = spin_lock_irqsave_wo_note(&g_noteram_lock);
+  int i;
 
   /* Handle the ioctl commands */
 
@@ -474,7 +682,14 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
        */
 
       case NOTERAM_CLEAR:
-        noteram_buffer_clear();
+        for (i = 0; i < NOTERAM_NBUFFERS; i++)
+          {
+            ni    = &g_noteram_info[i];
+            flags = spin_lock_irqsave_wo_note(&ni->ni_lock);
+            noteram_buffer_clear(ni);
+            spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+          }
+
         ret = OK;
         break;
 
@@ -487,12 +702,19 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         if (arg == 0)
           {
             ret = -EINVAL;
+            break;
           }
-        else
+
+        *(unsigned int *)arg = g_noteram_overwrite;
+        for (i = 0; i < NOTERAM_NBUFFERS; i++)
           {
-            *(unsigned int *)arg = g_noteram_info.ni_overwrite;
-            ret = OK;
+            if (g_noteram_info[i].ni_overflow)
+              {
+                *(unsigned int *)arg = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+              }
           }
+
+        ret = OK;
         break;
 
       /* NOTERAM_SETMODE
@@ -504,12 +726,32 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         if (arg == 0)
           {
             ret = -EINVAL;
+            break;
           }
-        else
+
+        /* Setting the overflow mode stops the recording, setting another
+         * mode restarts it.
+         */
+
+        for (i = 0; i < NOTERAM_NBUFFERS; i++)
           {
-            g_noteram_info.ni_overwrite = *(unsigned int *)arg;
-            ret = OK;
+            ni    = &g_noteram_info[i];
+            flags = spin_lock_irqsave_wo_note(&ni->ni_lock);
+            if (*(unsigned int *)arg == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+              {
+                g_noteram_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+                ni->ni_overflow     = true;
+              }
+            else
+              {
+                g_noteram_overwrite = *(unsigned int *)arg;
+                ni->ni_overflow     = false;
+              }
+
+            spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
           }
+
+        ret = OK;
         break;
 
 #ifdef NOTERAM_GETTASKNAME
@@ -536,11 +778,36 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* NOTERAM_GETOVERRUN
+       *      - Get the number of unread notes lost by a CPU
+       *        Argument: A writable pointer to struct
+       *                  noteram_get_overrun_s
+       */
+
+      case NOTERAM_GETOVERRUN:
+        {
+          FAR struct noteram_get_overrun_s *param;
+
+          param = (FAR struct noteram_get_overrun_s *)arg;
+          if (param == NULL || param->cpu < 0 ||
+              param->cpu >= CONFIG_SMP_NCPUS)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Without per-CPU buffers all CPUs share the counter */
+
+          ni              = &g_noteram_info[param->cpu % NOTERAM_NBUFFERS];
+          param->overrun  = ni->ni_overrun;
+          ret             = OK;
+        }
+        break;
+
       default:
           break;
     }
 
-  spin_unlock_irqrestore_wo_note(&g_noteram_lock, flags);
   return ret;
 }
 
@@ -548,7 +815,9 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  * Name: noteram_add
  *
  * Description:
- *   Add the variable length note to the transport layer
+ *   Add the variable length note to the transport layer.  With
+ *   CONFIG_DRIVERS_NOTERAM_PERCPU the note is added to the buffer of the
+ *   current CPU.
  *
  * Input Parameters:
  *   note    - The note buffer
@@ -557,40 +826,47 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
 static void noteram_add(FAR struct note_driver_s *drv,
                         FAR const void *note, size_t notelen)
 {
+  FAR struct noteram_info_s *ni;
   FAR const char *buf = note;
   unsigned int head;
   unsigned int remain;
   unsigned int space;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_wo_note(&g_noteram_lock);
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  /* The CPU can't change while the interrupts are disabled */
 
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  flags = up_irq_save();
+  ni    = noteram_this();
+  spin_lock_wo_note(&ni->ni_lock);
+#else
+  ni    = noteram_this();
+  flags = spin_lock_irqsave_wo_note(&ni->ni_lock);
+#endif
+
+  if (ni->ni_overflow)
     {
-      spin_unlock_irqrestore_wo_note(&g_noteram_lock, flags);
-      return;
+      ni->ni_overrun++;
+      goto out;
     }
 
   DEBUGASSERT(note != NULL && notelen < CONFIG_DRIVERS_NOTERAM_BUFSIZE);
-  remain = CONFIG_DRIVERS_NOTERAM_BUFSIZE - noteram_length();
+  remain = CONFIG_DRIVERS_NOTERAM_BUFSIZE - noteram_length(ni);
 
   if (remain < notelen)
     {
-      if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+      if (g_noteram_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
         {
           /* Stop recording if not in overwrite mode */
 
-          g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_wo_note(&g_noteram_lock, flags);
-          return;
+          ni->ni_overflow = true;
+          ni->ni_overrun++;
+          goto out;
         }
 
       /* Remove the note at the tail index , make sure there is enough space
@@ -598,19 +874,26 @@ static void noteram_add(FAR struct note_driver_s *drv,
 
       do
         {
-          noteram_remove();
-          remain = CONFIG_DRIVERS_NOTERAM_BUFSIZE - noteram_length();
+          noteram_remove(ni);
+          remain = CONFIG_DRIVERS_NOTERAM_BUFSIZE - noteram_length(ni);
         }
       while (remain < notelen);
     }
 
-  head = g_noteram_info.ni_head;
+  head = ni->ni_head;
   space = CONFIG_DRIVERS_NOTERAM_BUFSIZE - head;
   space = space < notelen ? space : notelen;
-  memcpy(g_noteram_info.ni_buffer + head, note, space);
-  memcpy(g_noteram_info.ni_buffer, buf + space, notelen - space);
-  g_noteram_info.ni_head = noteram_next(head, notelen);
-  spin_unlock_irqrestore_wo_note(&g_noteram_lock, flags);
+  memcpy(ni->ni_buffer + head, note, space);
+  memcpy(ni->ni_buffer, buf + space, notelen - space);
+  ni->ni_head = noteram_next(head, notelen);
+
+out:
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  spin_unlock_wo_note(&ni->ni_lock);
+  up_irq_restore(flags);
+#else
+  spin_unlock_irqrestore_wo_note(&ni->ni_lock, flags);
+#endif
 }
 
 /****************************************************************************
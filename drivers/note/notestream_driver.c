@@ -0,0 +1,590 @@
+/****************************************************************************
+ * drivers/note/notestream_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/notestream_driver.h>
+
+#if defined(CONFIG_DRIVERS_NOTESTREAM_UDP)
+#  include <netinet/in.h>
+#  include <nuttx/net/net.h>
+#elif defined(CONFIG_DRIVERS_NOTESTREAM_RTT)
+#  include <nuttx/segger/rtt.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NOTESTREAM_BUFSIZE   CONFIG_DRIVERS_NOTESTREAM_BUFSIZE
+#define NOTESTREAM_CHUNKSIZE CONFIG_DRIVERS_NOTESTREAM_CHUNKSIZE
+#define NOTESTREAM_NTASKS    CONFIG_DRIVERS_NOTESTREAM_NTASKS
+
+/* The largest record: the type, the delta, the cpu, the pid, the priority,
+ * the length and a payload of at most 255 bytes.
+ */
+
+#define NOTESTREAM_RECORD_MAX (1 + 10 + 1 + 5 + 1 + 2 + UINT8_MAX)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notestream_info_s
+{
+  unsigned int ns_head;            /* Index where the next byte is added */
+  unsigned int ns_tail;            /* Index of the next byte to send */
+  unsigned long ns_lost;           /* Notes lost, not reported yet */
+  uint64_t ns_last;                /* Time stamp of the previous note */
+#if CONFIG_TASK_NAME_SIZE > 0
+  pid_t ns_names[NOTESTREAM_NTASKS]; /* Tasks whose name was sent, plus 1 */
+#endif
+  uint8_t ns_buffer[NOTESTREAM_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void notestream_add(FAR struct note_driver_s *drv,
+                           FAR const void *note, size_t notelen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_notestream_ops =
+{
+  notestream_add
+};
+
+static struct notestream_info_s g_notestream_info;
+static spinlock_t g_notestream_lock;
+
+/* The pid of the streaming thread, whose notes are not streamed */
+
+static pid_t g_notestream_pid = INVALID_PROCESS_ID;
+
+/* The chunk being sent by the streaming thread */
+
+static uint8_t g_notestream_chunk[NOTESTREAM_CHUNKSIZE];
+
+#if defined(CONFIG_DRIVERS_NOTESTREAM_UDP)
+static struct socket g_notestream_socket;
+#elif defined(CONFIG_DRIVERS_NOTESTREAM_RTT)
+static struct lib_rttoutstream_s g_notestream_rtt;
+#else
+static struct file g_notestream_file;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct note_driver_s g_notestream_driver =
+{
+  &g_notestream_ops,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notestream_getle
+ *
+ * Description:
+ *   Get an unsigned value stored in the little endian layout of the notes.
+ *
+ ****************************************************************************/
+
+static uint64_t notestream_getle(FAR const uint8_t *src, size_t len)
+{
+  uint64_t value = 0;
+
+  while (len-- > 0)
+    {
+      value = (value << 8) | src[len];
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: notestream_varint
+ *
+ * Description:
+ *   Encode a varint, return the number of bytes used.
+ *
+ ****************************************************************************/
+
+static size_t notestream_varint(FAR uint8_t *dst, uint64_t value)
+{
+  size_t len = 0;
+
+  while (value >= 0x80)
+    {
+      dst[len++] = (uint8_t)value | 0x80;
+      value    >>= 7;
+    }
+
+  dst[len++] = (uint8_t)value;
+  return len;
+}
+
+/****************************************************************************
+ * Name: notestream_space
+ *
+ * Description:
+ *   Return the free space of the stream buffer.
+ *
+ ****************************************************************************/
+
+static unsigned int notestream_space(FAR struct notestream_info_s *ns)
+{
+  unsigned int used = ns->ns_head - ns->ns_tail;
+
+  if (ns->ns_head < ns->ns_tail)
+    {
+      used += NOTESTREAM_BUFSIZE;
+    }
+
+  /* One byte is kept free to tell a full buffer from an empty one */
+
+  return NOTESTREAM_BUFSIZE - 1 - used;
+}
+
+/****************************************************************************
+ * Name: notestream_put
+ *
+ * Description:
+ *   Copy a record into the stream buffer.  The record must fit.
+ *
+ ****************************************************************************/
+
+static void notestream_put(FAR struct notestream_info_s *ns,
+                           FAR const uint8_t *src, size_t len)
+{
+  unsigned int head = ns->ns_head;
+  size_t space = NOTESTREAM_BUFSIZE - head;
+
+  space = space < len ? space : len;
+  memcpy(ns->ns_buffer + head, src, space);
+  memcpy(ns->ns_buffer, src + space, len - space);
+
+  head += len;
+  if (head >= NOTESTREAM_BUFSIZE)
+    {
+      head -= NOTESTREAM_BUFSIZE;
+    }
+
+  ns->ns_head = head;
+}
+
+/****************************************************************************
+ * Name: notestream_taskname
+ *
+ * Description:
+ *   Encode the name record of a task if its name was not sent yet, return
+ *   the size of the record.  A task is forgotten on NOTE_STOP, so that a
+ *   pid reused by another task is named again.
+ *
+ ****************************************************************************/
+
+#if CONFIG_TASK_NAME_SIZE > 0
+static size_t notestream_taskname(FAR struct notestream_info_s *ns,
+                                  FAR uint8_t *dst, pid_t pid, uint8_t type,
+                                  FAR const char *name)
+{
+  FAR pid_t *slot = &ns->ns_names[pid % NOTESTREAM_NTASKS];
+  FAR struct tcb_s *tcb;
+  size_t namelen;
+  size_t len;
+
+  if (type == NOTE_STOP)
+    {
+      if (*slot == pid + 1)
+        {
+          *slot = 0;
+        }
+
+      return 0;
+    }
+
+  if (*slot == pid + 1)
+    {
+      return 0;
+    }
+
+  if (name == NULL)
+    {
+      tcb = nxsched_get_tcb(pid);
+      if (tcb == NULL)
+        {
+          return 0;
+        }
+
+      name = tcb->name;
+    }
+
+  *slot   = pid + 1;
+  namelen = strnlen(name, CONFIG_TASK_NAME_SIZE);
+
+  len        = 0;
+  dst[len++] = NOTESTREAM_TASKNAME;
+  len       += notestream_varint(dst + len, pid);
+  dst[len++] = (uint8_t)namelen;
+  memcpy(dst + len, name, namelen);
+
+  return len + namelen;
+}
+#endif
+
+/****************************************************************************
+ * Name: notestream_add
+ *
+ * Description:
+ *   Encode the note into the stream buffer, the time stamp as the delta to
+ *   the previous note.  If the buffer is full the note is counted as lost.
+ *
+ * Input Parameters:
+ *   note    - The note buffer
+ *   notelen - The buffer length
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void notestream_add(FAR struct note_driver_s *drv,
+                           FAR const void *note, size_t notelen)
+{
+  FAR struct notestream_info_s *ns = &g_notestream_info;
+  FAR const struct note_common_s *cmn = note;
+  FAR const uint8_t *payload = (FAR const uint8_t *)(cmn + 1);
+  uint8_t record[NOTESTREAM_RECORD_MAX];
+#if CONFIG_TASK_NAME_SIZE > 0
+  uint8_t name[1 + 5 + 1 + CONFIG_TASK_NAME_SIZE];
+  size_t namelen;
+#endif
+  size_t paylen = notelen - sizeof(struct note_common_s);
+  irqstate_t flags;
+  uint64_t timestamp;
+  uint64_t sec;
+  uint64_t nsec;
+  int64_t delta;
+  size_t len;
+  pid_t pid;
+
+  DEBUGASSERT(notelen >= sizeof(struct note_common_s));
+
+  pid = (pid_t)notestream_getle(cmn->nc_pid, sizeof(cmn->nc_pid));
+  if (pid == g_notestream_pid)
+    {
+      /* Do not trace the streaming itself */
+
+      return;
+    }
+
+  sec  = notestream_getle(cmn->nc_systime_sec,
+                          sizeof(cmn->nc_systime_sec));
+  nsec = notestream_getle(cmn->nc_systime_nsec,
+                          sizeof(cmn->nc_systime_nsec));
+
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+  /* The notes carry the raw perf count, the host converts it with the
+   * frequency of the header.
+   */
+
+  timestamp = (sec << (4 * sizeof(long)) << (4 * sizeof(long))) | nsec;
+#else
+  timestamp = sec * NSEC_PER_SEC + nsec;
+#endif
+
+  if (cmn->nc_type == NOTE_START)
+    {
+      /* The name goes to the table */
+
+      paylen = 0;
+    }
+
+  flags = spin_lock_irqsave_wo_note(&g_notestream_lock);
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  namelen = notestream_taskname(ns, name, pid, cmn->nc_type,
+                                cmn->nc_type == NOTE_START ?
+                                (FAR const char *)payload : NULL);
+#endif
+
+  /* Report the notes lost before this one */
+
+  len = 0;
+  if (ns->ns_lost > 0)
+    {
+      record[len++] = NOTESTREAM_LOST;
+      len          += notestream_varint(record + len, ns->ns_lost);
+    }
+
+  delta = (int64_t)(timestamp - ns->ns_last);
+
+  record[len++] = cmn->nc_type;
+  len          += notestream_varint(record + len,
+                                    ((uint64_t)delta << 1) ^
+                                    (uint64_t)(delta >> 63));
+#ifdef CONFIG_SMP
+  record[len++] = cmn->nc_cpu;
+#else
+  record[len++] = 0;
+#endif
+  len          += notestream_varint(record + len, pid);
+  record[len++] = cmn->nc_priority;
+  len          += notestream_varint(record + len, paylen);
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  if (notestream_space(ns) < namelen + len + paylen)
+#else
+  if (notestream_space(ns) < len + paylen)
+#endif
+    {
+#if CONFIG_TASK_NAME_SIZE > 0
+      if (namelen > 0)
+        {
+          /* The name was not sent */
+
+          ns->ns_names[pid % NOTESTREAM_NTASKS] = 0;
+        }
+#endif
+
+      ns->ns_lost++;
+      spin_unlock_irqrestore_wo_note(&g_notestream_lock, flags);
+      return;
+    }
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  notestream_put(ns, name, namelen);
+#endif
+  notestream_put(ns, record, len);
+  notestream_put(ns, payload, paylen);
+
+  ns->ns_lost = 0;
+  ns->ns_last = timestamp;
+  spin_unlock_irqrestore_wo_note(&g_notestream_lock, flags);
+}
+
+/****************************************************************************
+ * Name: notestream_take
+ *
+ * Description:
+ *   Move the next bytes of the stream buffer to the chunk to send.
+ *
+ ****************************************************************************/
+
+static size_t notestream_take(FAR uint8_t *dst, size_t size)
+{
+  FAR struct notestream_info_s *ns = &g_notestream_info;
+  irqstate_t flags;
+  unsigned int tail;
+  size_t len;
+
+  flags = spin_lock_irqsave_wo_note(&g_notestream_lock);
+
+  tail  = ns->ns_tail;
+  len   = (ns->ns_head >= tail ? ns->ns_head : NOTESTREAM_BUFSIZE) - tail;
+  len   = len < size ? len : size;
+
+  memcpy(dst, ns->ns_buffer + tail, len);
+
+  tail += len;
+  if (tail >= NOTESTREAM_BUFSIZE)
+    {
+      tail = 0;
+    }
+
+  ns->ns_tail = tail;
+  spin_unlock_irqrestore_wo_note(&g_notestream_lock, flags);
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: notestream_open
+ *
+ * Description:
+ *   Open the transport of the stream.
+ *
+ ****************************************************************************/
+
+static int notestream_open(void)
+{
+#if defined(CONFIG_DRIVERS_NOTESTREAM_UDP)
+  return psock_socket(AF_INET, SOCK_DGRAM, 0, &g_notestream_socket);
+#elif defined(CONFIG_DRIVERS_NOTESTREAM_RTT)
+  lib_rttoutstream_open(&g_notestream_rtt,
+                        CONFIG_DRIVERS_NOTESTREAM_RTT_CHANNEL,
+                        CONFIG_DRIVERS_NOTESTREAM_RTT_BUFSIZE);
+  return OK;
+#else
+  return file_open(&g_notestream_file, CONFIG_DRIVERS_NOTESTREAM_PATH,
+                   O_WRONLY);
+#endif
+}
+
+/****************************************************************************
+ * Name: notestream_send
+ *
+ * Description:
+ *   Send a chunk of the stream over the transport.
+ *
+ ****************************************************************************/
+
+static ssize_t notestream_send(FAR const uint8_t *buf, size_t len)
+{
+#if defined(CONFIG_DRIVERS_NOTESTREAM_UDP)
+  struct sockaddr_in addr;
+
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = HTONS(CONFIG_DRIVERS_NOTESTREAM_UDP_PORT);
+  addr.sin_addr.s_addr = HTONL(CONFIG_DRIVERS_NOTESTREAM_UDP_IPADDR);
+
+  return psock_sendto(&g_notestream_socket, buf, len, 0,
+                      (FAR const struct sockaddr *)&addr, sizeof(addr));
+#elif defined(CONFIG_DRIVERS_NOTESTREAM_RTT)
+  return lib_stream_puts(&g_notestream_rtt, buf, len);
+#else
+  return file_write(&g_notestream_file, buf, len);
+#endif
+}
+
+/****************************************************************************
+ * Name: notestream_thread
+ *
+ * Description:
+ *   Send the header, then the stream buffer as it fills.  The buffer is
+ *   polled, since waking up the thread from the notes would generate more
+ *   notes.
+ *
+ ****************************************************************************/
+
+static int notestream_thread(int argc, FAR char *argv[])
+{
+  FAR uint8_t *header = g_notestream_chunk;
+  uint32_t freq = 0;
+  ssize_t ret;
+  size_t len;
+
+  ret = notestream_open();
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to open the note stream: %zd\n", ret);
+      return (int)ret;
+    }
+
+#ifdef CONFIG_DRIVERS_NOTERAM_RAWTIME
+  freq = up_perf_getfreq();
+#endif
+
+  memcpy(header, NOTESTREAM_MAGIC, 4);
+  header[4]  = NOTESTREAM_VERSION;
+  header[5]  = sizeof(uintptr_t);
+  header[6]  = sizeof(pid_t);
+  header[7]  = 0;
+  header[8]  = (uint8_t)freq;
+  header[9]  = (uint8_t)(freq >> 8);
+  header[10] = (uint8_t)(freq >> 16);
+  header[11] = (uint8_t)(freq >> 24);
+
+  notestream_send(header, NOTESTREAM_HEADER_SIZE);
+
+  for (; ; )
+    {
+      len = notestream_take(g_notestream_chunk, NOTESTREAM_CHUNKSIZE);
+      if (len == 0)
+        {
+          nxsig_usleep(CONFIG_DRIVERS_NOTESTREAM_INTERVAL * USEC_PER_MSEC);
+          continue;
+        }
+
+      /* A chunk that can't be sent is dropped, the host resynchronizes on
+       * the next start of the stream.
+       */
+
+      ret = notestream_send(g_notestream_chunk, len);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to send the note stream: %zd\n", ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notestream_register
+ *
+ * Description:
+ *   Start the thread streaming the notes to the configured transport.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notestream_register(void)
+{
+  int pid;
+
+  pid = kthread_create("notestream", CONFIG_DRIVERS_NOTESTREAM_PRIORITY,
+                       CONFIG_DRIVERS_NOTESTREAM_STACKSIZE,
+                       notestream_thread, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  g_notestream_pid = pid;
+  return OK;
+}
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -80,6 +81,408 @@ static pipe_ndx_t pipecommon_bufferused(FAR struct pipe_dev_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_rdspan
+ *
+ * Description:
+ *   Return the number of bytes that can be read from d_rdndx on without
+ *   wrapping around the end of the circular buffer.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_rdspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return dev->d_bufsize - dev->d_rdndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrspan
+ *
+ * Description:
+ *   Return the number of bytes that can be written from d_wrndx on without
+ *   wrapping around the end of the circular buffer.  One byte is always
+ *   left free to tell a full buffer from an empty one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_wrspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_rdndx > dev->d_wrndx)
+    {
+      return dev->d_rdndx - dev->d_wrndx - 1;
+    }
+  else
+    {
+      return dev->d_bufsize - dev->d_wrndx - (dev->d_rdndx == 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdadvance and pipecommon_wradvance
+ ****************************************************************************/
+
+static void pipecommon_rdadvance(FAR struct pipe_dev_s *dev, size_t nbytes)
+{
+  dev->d_rdndx += nbytes;
+  if (dev->d_rdndx >= dev->d_bufsize)
+    {
+      dev->d_rdndx = 0;
+    }
+}
+
+static void pipecommon_wradvance(FAR struct pipe_dev_s *dev, size_t nbytes)
+{
+  dev->d_wrndx += nbytes;
+  if (dev->d_wrndx >= dev->d_bufsize)
+    {
+      dev->d_wrndx = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the circular buffer, with one memcpy()
+ *   for each of its two contiguous regions.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR char *buffer, size_t len)
+{
+  size_t nread = 0;
+  size_t nbytes;
+
+  while (nread < len && (nbytes = pipecommon_rdspan(dev)) > 0)
+    {
+      nbytes = MIN(nbytes, len - nread);
+      memcpy(buffer + nread, &dev->d_buffer[dev->d_rdndx], nbytes);
+      pipecommon_rdadvance(dev, nbytes);
+      nread += nbytes;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Copy up to 'len' bytes into the circular buffer, with one memcpy() for
+ *   each of its two contiguous free regions.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const char *buffer, size_t len)
+{
+  size_t nwritten = 0;
+  size_t nbytes;
+
+  while (nwritten < len && (nbytes = pipecommon_wrspan(dev)) > 0)
+    {
+      nbytes = MIN(nbytes, len - nwritten);
+      memcpy(&dev->d_buffer[dev->d_wrndx], buffer + nwritten, nbytes);
+      pipecommon_wradvance(dev, nbytes);
+      nwritten += nbytes;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the poll/select waiters and the waiting writers after data has
+ *   been removed from the buffer.  This is batched: it happens only once
+ *   the buffer can accept more than d_polloutthrd bytes, or when it has
+ *   been drained.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  pipe_ndx_t nused = pipecommon_bufferused(dev);
+  int sval;
+
+  if (nused < (dev->d_bufsize - 1 - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+  else if (nused != 0)
+    {
+      return;
+    }
+
+  while (nxsem_get_value(&dev->d_wrsem, &sval) == 0 && sval <= 0)
+    {
+      nxsem_post(&dev->d_wrsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the waiting readers, and the poll/select waiters if the buffer
+ *   is full or holds more than d_pollinthrd bytes, after data has been
+ *   added to the buffer.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev, bool full)
+{
+  int sval;
+
+  if (full || pipecommon_bufferused(dev) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  while (nxsem_get_value(&dev->d_rdsem, &sval) == 0 && sval <= 0)
+    {
+      nxsem_post(&dev->d_rdsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the pipe.  Called with d_bflock held.
+ *
+ * Returned Value:
+ *   One if there is data, with d_bflock still held.  Zero at the end of
+ *   file, or a negated errno value; d_bflock has then been released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until there is room in the pipe.  Called with d_bflock held.
+ *
+ * Returned Value:
+ *   Zero (OK) if there is room, with d_bflock still held.  A negated errno
+ *   value otherwise; d_bflock has then been released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitspace(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (pipecommon_wrspan(dev) > 0)
+        {
+          return OK;
+        }
+
+      if (nonblock)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceout
+ *
+ * Description:
+ *   Write data from the circular buffer directly to another file, without
+ *   an intermediate buffer.  Called with d_bflock held; returns with it
+ *   released.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spliceout(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev,
+                                    FAR struct pipe_splice_s *splice)
+{
+  FAR struct file *outfile = splice->ps_file;
+  size_t total = 0;
+  size_t nbytes;
+  ssize_t ret;
+
+  ret = pipecommon_waitdata(dev, splice->ps_nonblock ||
+                                 (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  while (total < splice->ps_len && (nbytes = pipecommon_rdspan(dev)) > 0)
+    {
+      nbytes = MIN(nbytes, splice->ps_len - total);
+      if (splice->ps_offset != NULL)
+        {
+          ret = file_pwrite(outfile, &dev->d_buffer[dev->d_rdndx], nbytes,
+                            *splice->ps_offset);
+          if (ret > 0)
+            {
+              *splice->ps_offset += ret;
+            }
+        }
+      else
+        {
+          ret = file_write(outfile, &dev->d_buffer[dev->d_rdndx], nbytes);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipecommon_rdadvance(dev, ret);
+      total += ret;
+
+      if ((size_t)ret < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_readdone(dev);
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return total > 0 ? (ssize_t)total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicein
+ *
+ * Description:
+ *   Read data from another file directly into the circular buffer, without
+ *   an intermediate buffer.  Called with d_bflock held; returns with it
+ *   released.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splicein(FAR struct file *filep,
+                                   FAR struct pipe_dev_s *dev,
+                                   FAR struct pipe_splice_s *splice)
+{
+  FAR struct file *infile = splice->ps_file;
+  size_t total = 0;
+  size_t nbytes;
+  ssize_t ret;
+
+  ret = pipecommon_waitspace(dev, splice->ps_nonblock ||
+                                  (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (total < splice->ps_len && (nbytes = pipecommon_wrspan(dev)) > 0)
+    {
+      nbytes = MIN(nbytes, splice->ps_len - total);
+      if (splice->ps_offset != NULL)
+        {
+          ret = file_pread(infile, &dev->d_buffer[dev->d_wrndx], nbytes,
+                           *splice->ps_offset);
+          if (ret > 0)
+            {
+              *splice->ps_offset += ret;
+            }
+        }
+      else
+        {
+          ret = file_read(infile, &dev->d_buffer[dev->d_wrndx], nbytes);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipecommon_wradvance(dev, ret);
+      total += ret;
+
+      if ((size_t)ret < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_writedone(dev, false);
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return total > 0 ? (ssize_t)total : ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -429,11 +832,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-  FAR uint8_t           *start = (FAR uint8_t *)buffer;
-#endif
-  ssize_t                nread = 0;
-  int                    sval;
+  ssize_t                nread;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -457,75 +856,21 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  ret = pipecommon_waitdata(dev, (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret <= 0)
     {
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxmutex_unlock(&dev->d_bflock);
-          return 0;
-        }
-
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      nxmutex_unlock(&dev->d_bflock);
-      ret = nxsem_wait(&dev->d_rdsem);
-
-      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
-        {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
-
-          return ret;
-        }
+      return ret;
     }
 
   /* Then return whatever is available in the pipe (which is at least one
    * byte).
    */
 
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
-
-      nread++;
-    }
-
-  /* Notify all poll/select waiters that they can write to the
-   * FIFO when buffer can accept more than d_polloutthrd bytes.
-   */
-
-  if (pipecommon_bufferused(dev) < (dev->d_bufsize - 1 - dev->d_polloutthrd))
-    {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
-    }
-
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
-   */
-
-  while (nxsem_get_value(&dev->d_wrsem, &sval) == 0 && sval <= 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  nread = pipecommon_copyout(dev, buffer, len);
+  pipecommon_readdone(dev);
 
   nxmutex_unlock(&dev->d_bflock);
-  pipe_dumpbuffer("From PIPE:", start, nread);
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
   return nread;
 }
 
@@ -539,9 +884,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  size_t                 ncopied;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -583,7 +926,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
   for (; ; )
     {
       /* REVISIT:  "If all file descriptors referring to the read end of a
@@ -598,108 +940,61 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Calculate the write index AFTER the next byte is written */
+      /* Copy as much as fits into the circular buffer */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
+      ncopied   = pipecommon_copyin(dev, buffer + nwritten, len - nwritten);
+      nwritten += ncopied;
 
-      /* Would the next write overflow the circular buffer? */
+      /* Is the write complete? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if ((size_t)nwritten >= len)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
-
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO when buffer used exceeds poll threshold.
-               */
+          /* Yes.. Notify the readers and return the number of bytes
+           * written.
+           */
 
-              if (pipecommon_bufferused(dev) > dev->d_pollinthrd)
-                {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
-                }
+          pipecommon_writedone(dev, false);
+          nxmutex_unlock(&dev->d_bflock);
+          return len;
+        }
 
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
+      /* There is not enough room for the rest.  Notify the readers if
+       * anything was written in this pass.
+       */
 
-              while (nxsem_get_value(&dev->d_rdsem, &sval) == 0 && sval <= 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+      if (ncopied > 0)
+        {
+          pipecommon_writedone(dev, true);
+        }
 
-              /* Return the number of bytes written */
+      /* If O_NONBLOCK was set, then return partial bytes written or
+       * EGAIN.
+       */
 
-              nxmutex_unlock(&dev->d_bflock);
-              return len;
-            }
-        }
-      else
+      if (filep->f_oflags & O_NONBLOCK)
         {
-          /* There is not enough room for the next byte.  Was anything
-           * written in this pass?
-           */
-
-          if (last < nwritten)
+          if (nwritten == 0)
             {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO.
-               */
-
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
-
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
-
-              while (nxsem_get_value(&dev->d_rdsem, &sval) == 0 && sval <= 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+              nwritten = -EAGAIN;
             }
 
-          last = nwritten;
-
-          /* If O_NONBLOCK was set, then return partial bytes written or
-           * EGAIN.
-           */
-
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+          nxmutex_unlock(&dev->d_bflock);
+          return nwritten;
+        }
 
-              nxmutex_unlock(&dev->d_bflock);
-              return nwritten;
-            }
+      /* There is more to be written.. wait for data to be removed from
+       * the pipe
+       */
 
-          /* There is more to be written.. wait for data to be removed from
-           * the pipe
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          /* Either call nxsem_wait may fail because a signal was
+           * received or if the task was canceled.
            */
 
-          nxmutex_unlock(&dev->d_bflock);
-          ret = nxsem_wait(&dev->d_wrsem);
-          if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
-            {
-              /* Either call nxsem_wait may fail because a signal was
-               * received or if the task was canceled.
-               */
-
-              return nwritten == 0 ? (ssize_t)ret : nwritten;
-            }
+          return nwritten == 0 ? (ssize_t)ret : nwritten;
         }
     }
 }
@@ -848,6 +1143,39 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  /* Splicing may wait on the pipe and releases the lock itself */
+
+  if (cmd == PIPEIOC_SPLICE)
+    {
+      FAR struct pipe_splice_s *splice =
+        (FAR struct pipe_splice_s *)((uintptr_t)arg);
+
+      if (splice == NULL || splice->ps_file == NULL ||
+          splice->ps_file->f_inode == inode)
+        {
+          ret = -EINVAL;
+        }
+      else if (splice->ps_tofile && (filep->f_oflags & O_RDOK) == 0)
+        {
+          ret = -EBADF;
+        }
+      else if (!splice->ps_tofile && (filep->f_oflags & O_WROK) == 0)
+        {
+          ret = -EBADF;
+        }
+      else if (splice->ps_tofile)
+        {
+          return pipecommon_spliceout(filep, dev, splice);
+        }
+      else
+        {
+          return pipecommon_splicein(filep, dev, splice);
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      return ret;
+    }
+
   switch (cmd)
     {
       case PIPEIOC_POLICY:
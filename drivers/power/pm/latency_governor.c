@@ -0,0 +1,310 @@
+/****************************************************************************
+ * drivers/power/pm/latency_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+#include <nuttx/timers/hrtimer.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Weight of a new idle period in the average, as a power of two */
+
+#define LATENCY_GOVERNOR_SHIFT 3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pm_latency_domain_s
+{
+  struct wdog_s wdog;         /* Holds PM_NORMAL after activity */
+  bool idling;                /* In a low power state, not woken up yet */
+  clock_t enter;              /* When the idle period started */
+  uint32_t avgidle;           /* Average idle period, microseconds */
+};
+
+struct pm_latency_governor_s
+{
+  struct pm_latency_domain_s domain_states[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void latency_governor_statechanged(int domain,
+                                          enum pm_state_e newstate);
+static enum pm_state_e latency_governor_checkstate(int domain);
+static void latency_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_latency_governor_ops =
+{
+  NULL,                          /* initialize */
+  NULL,                          /* deinitialize */
+  latency_governor_statechanged, /* statechanged */
+  latency_governor_checkstate,   /* checkstate */
+  latency_governor_activity,     /* activity */
+  NULL                           /* priv */
+};
+
+static struct pm_latency_governor_s g_pm_latency_governor;
+
+/* Wake-up latency and shortest worthwhile stay of each state, in
+ * microseconds.  PM_NORMAL costs nothing.
+ */
+
+static const uint32_t g_exit_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_IDLE_EXITLATENCY,
+  CONFIG_PM_GOVERNOR_STANDBY_EXITLATENCY,
+  CONFIG_PM_GOVERNOR_SLEEP_EXITLATENCY
+};
+
+static const uint32_t g_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_SLEEP_RESIDENCY
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_governor_predict
+ *
+ * Description:
+ *   Predict how long the system is going to stay idle, in microseconds:
+ *   Not beyond the next timer, and not longer than the recent idle
+ *   periods, which end early on the interrupts no timer announces.
+ *
+ ****************************************************************************/
+
+static uint32_t
+latency_governor_predict(FAR struct pm_latency_domain_s *pdomstate)
+{
+  uint64_t predicted = UINT32_MAX;
+  sclock_t ticks;
+#ifdef CONFIG_HRTIMER
+  uint64_t nsec;
+#endif
+
+  ticks = wd_nextexpire();
+  if (ticks >= 0)
+    {
+      predicted = TICK2USEC((uint64_t)ticks);
+    }
+
+#ifdef CONFIG_HRTIMER
+  nsec = hrtimer_nextexpire();
+  if (nsec / NSEC_PER_USEC < predicted)
+    {
+      predicted = nsec / NSEC_PER_USEC;
+    }
+#endif
+
+  if (pdomstate->avgidle != 0 && pdomstate->avgidle < predicted)
+    {
+      predicted = pdomstate->avgidle;
+    }
+
+  return predicted < UINT32_MAX ? (uint32_t)predicted : UINT32_MAX;
+}
+
+/****************************************************************************
+ * Name: latency_governor_statechanged
+ ****************************************************************************/
+
+static void latency_governor_statechanged(int domain,
+                                          enum pm_state_e newstate)
+{
+  FAR struct pm_latency_domain_s *pdomstate;
+  clock_t now = clock_systime_ticks();
+  uint64_t idle;
+
+  pdomstate = &g_pm_latency_governor.domain_states[domain];
+
+  if (newstate > PM_NORMAL)
+    {
+      if (!pdomstate->idling)
+        {
+          pdomstate->idling = true;
+          pdomstate->enter  = now;
+        }
+    }
+  else if (pdomstate->idling)
+    {
+      /* PM_RESTORE after the wake-up, or PM_NORMAL:  Learn from the length
+       * of the idle period just ended.
+       */
+
+      pdomstate->idling = false;
+
+      idle = TICK2USEC((uint64_t)(now - pdomstate->enter));
+      if (idle > UINT32_MAX)
+        {
+          idle = UINT32_MAX;
+        }
+
+      if (pdomstate->avgidle == 0)
+        {
+          pdomstate->avgidle = idle;
+        }
+      else
+        {
+          pdomstate->avgidle += ((int64_t)idle - pdomstate->avgidle) /
+                                (1 << LATENCY_GOVERNOR_SHIFT);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: latency_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e latency_governor_checkstate(int domain)
+{
+  FAR struct pm_latency_domain_s *pdomstate;
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+  uint32_t predicted;
+  uint32_t latency;
+  int state;
+
+  pdomstate = &g_pm_latency_governor.domain_states[domain];
+  pdom = &g_pmglobals.domain[domain];
+  state = PM_NORMAL;
+
+  /* Find the lowest power-level which is not locked, as the greedy
+   * governor does.
+   */
+
+  flags = pm_domain_lock(domain);
+
+  if (!WDOG_ISACTIVE(&pdomstate->wdog))
+    {
+      while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+        {
+          state++;
+        }
+    }
+
+  pm_domain_unlock(domain, flags);
+
+  if (state == PM_NORMAL)
+    {
+      return PM_NORMAL;
+    }
+
+  /* Then back off to the deepest state that both wakes up in time and is
+   * worth entering for the predicted idle period.
+   */
+
+  latency   = pm_qos_latency();
+  predicted = latency_governor_predict(pdomstate);
+
+  while (state > PM_NORMAL &&
+         (g_exit_latency[state] > latency ||
+          g_residency[state] > predicted))
+    {
+      state--;
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: latency_governor_timer_cb
+ ****************************************************************************/
+
+static void latency_governor_timer_cb(wdparm_t arg)
+{
+  pm_auto_updatestate((int)arg);
+}
+
+/****************************************************************************
+ * Name: latency_governor_activity
+ ****************************************************************************/
+
+static void latency_governor_activity(int domain, int count)
+{
+  FAR struct pm_latency_domain_s *pdomstate;
+  irqstate_t flags;
+
+  pdomstate = &g_pm_latency_governor.domain_states[domain];
+  count = count ? count : 1;
+
+  flags = pm_domain_lock(domain);
+
+  if (TICK2SEC(wd_gettime(&pdomstate->wdog)) < count)
+    {
+      wd_start(&pdomstate->wdog, SEC2TICK(count),
+               latency_governor_timer_cb, (wdparm_t)domain);
+    }
+
+  pm_domain_unlock(domain, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void)
+{
+  return &g_latency_governor_ops;
+}
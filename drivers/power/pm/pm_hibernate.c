@@ -0,0 +1,410 @@
+/****************************************************************************
+ * drivers/power/pm/pm_hibernate.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <inttypes.h>
+#include <setjmp.h>
+#include <sched.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/power/hibernate.h>
+
+#ifdef CONFIG_PM_HIBERNATE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HIBERNATE_MAGIC 0x4e58484eu  /* "NHXN" */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The image starts with this header, alone in the first erase block, and
+ * goes on with the regions one after the other from 'dataoff'.  The CRC
+ * covers the header from 'key' on and the data.
+ */
+
+struct hibernate_header_s
+{
+  uint32_t magic;
+  uint32_t crc;
+  uint32_t key;
+  uint32_t nregions;
+  uint32_t dataoff;
+  uint32_t datasize;
+  struct hibernate_region_s regions[CONFIG_PM_HIBERNATE_NREGIONS];
+};
+
+/* The state of a save.  It is static since it must survive the return
+ * from a restored image, which also restores it.
+ */
+
+struct hibernate_s
+{
+  jmp_buf               resume;     /* The context hibernate_resume()
+                                     * returns to */
+  irqstate_t            flags;      /* Interrupt state before the save */
+  FAR struct mtd_dev_s *mtd;
+  struct mtd_geometry_s geo;
+  FAR uint8_t          *buffer;     /* One block being filled */
+  uint32_t              fill;       /* Bytes in buffer[] */
+  off_t                 block;      /* Block to write buffer[] to */
+  uint32_t              crc;        /* CRC of the bytes written so far */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct hibernate_s g_hibernate;
+static struct hibernate_header_s g_hibernate_header;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hibernate_write
+ *
+ * Description:
+ *   Append 'len' bytes to the image.  The whole blocks of 'src' are written
+ *   from where they are, the rest goes through buffer[].
+ *
+ ****************************************************************************/
+
+static int hibernate_write(FAR struct hibernate_s *priv,
+                           FAR const uint8_t *src, size_t len)
+{
+  uint32_t blocksize = priv->geo.blocksize;
+  size_t nblocks;
+  size_t n;
+  ssize_t ret;
+
+  priv->crc = crc32part(src, len, priv->crc);
+
+  while (len > 0)
+    {
+      if (priv->fill == 0 && len >= blocksize)
+        {
+          nblocks = len / blocksize;
+          ret = MTD_BWRITE(priv->mtd, priv->block, nblocks, src);
+          if (ret != (ssize_t)nblocks)
+            {
+              return ret < 0 ? ret : -EIO;
+            }
+
+          priv->block += nblocks;
+          src         += nblocks * blocksize;
+          len         -= nblocks * blocksize;
+          continue;
+        }
+
+      n = MIN(blocksize - priv->fill, len);
+      memcpy(priv->buffer + priv->fill, src, n);
+      priv->fill += n;
+      src        += n;
+      len        -= n;
+
+      if (priv->fill == blocksize)
+        {
+          ret = MTD_BWRITE(priv->mtd, priv->block, 1, priv->buffer);
+          if (ret != 1)
+            {
+              return ret < 0 ? ret : -EIO;
+            }
+
+          priv->block++;
+          priv->fill = 0;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hibernate_flush
+ *
+ * Description:
+ *   Write the last partial block, padded with the erased value.
+ *
+ ****************************************************************************/
+
+static int hibernate_flush(FAR struct hibernate_s *priv)
+{
+  ssize_t ret;
+
+  if (priv->fill == 0)
+    {
+      return OK;
+    }
+
+  memset(priv->buffer + priv->fill, 0xff, priv->geo.blocksize - priv->fill);
+  ret = MTD_BWRITE(priv->mtd, priv->block, 1, priv->buffer);
+  priv->fill = 0;
+  priv->block++;
+  return ret == 1 ? OK : ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: hibernate_image
+ *
+ * Description:
+ *   Erase the device and write the image.  Called with the interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static int hibernate_image(FAR struct hibernate_s *priv,
+                           FAR struct hibernate_header_s *hdr)
+{
+  uint32_t nerase;
+  uint32_t i;
+  int ret;
+
+  nerase = (hdr->dataoff + hdr->datasize + priv->geo.erasesize - 1) /
+           priv->geo.erasesize;
+  ret = MTD_ERASE(priv->mtd, 0, nerase);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The data first, so that an interrupted save leaves no header */
+
+  priv->block = hdr->dataoff / priv->geo.blocksize;
+  priv->fill  = 0;
+  priv->crc   = 0;
+
+  for (i = 0; i < hdr->nregions; i++)
+    {
+      ret = hibernate_write(priv, (FAR const uint8_t *)hdr->regions[i].start,
+                            hdr->regions[i].size);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = hibernate_flush(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Then the header, with the CRC of the data and of itself */
+
+  hdr->crc = crc32part((FAR const uint8_t *)&hdr->key,
+                       sizeof(*hdr) - offsetof(struct hibernate_header_s,
+                                               key), priv->crc);
+  hdr->magic  = HIBERNATE_MAGIC;
+  priv->block = 0;
+
+  ret = hibernate_write(priv, (FAR const uint8_t *)hdr, sizeof(*hdr));
+  if (ret >= 0)
+    {
+      ret = hibernate_flush(priv);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hibernate_save
+ *
+ * Description:
+ *   Save the given RAM regions to the MTD device, followed by a header
+ *   holding their CRC.  When hibernate_resume() later restores the image,
+ *   this function returns a second time, after board_hibernate_restore().
+ *
+ * Returned Value:
+ *   0 once the image is saved; 1 when returning from a restored image; a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hibernate_save(FAR struct mtd_dev_s *mtd,
+                   FAR const struct hibernate_region_s *regions,
+                   int nregions, uint32_t key)
+{
+  FAR struct hibernate_s *priv = &g_hibernate;
+  FAR struct hibernate_header_s *hdr = &g_hibernate_header;
+  uint64_t imagesize;
+  int ret;
+  int i;
+
+  if (nregions <= 0 || nregions > CONFIG_PM_HIBERNATE_NREGIONS)
+    {
+      return -EINVAL;
+    }
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY, (unsigned long)&priv->geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->geo.erasesize < sizeof(*hdr) ||
+      priv->geo.erasesize % priv->geo.blocksize != 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->key      = key;
+  hdr->nregions = nregions;
+  hdr->dataoff  = priv->geo.erasesize;
+
+  for (i = 0; i < nregions; i++)
+    {
+      hdr->regions[i] = regions[i];
+      hdr->datasize  += regions[i].size;
+    }
+
+  imagesize = (uint64_t)hdr->dataoff + hdr->datasize;
+  if (imagesize > (uint64_t)priv->geo.erasesize * priv->geo.neraseblocks)
+    {
+      ferr("ERROR: Image of %" PRIu64 " bytes does not fit\n", imagesize);
+      return -EFBIG;
+    }
+
+  priv->mtd    = mtd;
+  priv->buffer = kmm_malloc(priv->geo.blocksize);
+  if (priv->buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Nothing else may run until the image is written: the RAM written last
+   * must not have changed since the RAM written first.
+   */
+
+  priv->flags = up_irq_save();
+  sched_lock();
+
+  if (setjmp(priv->resume) != 0)
+    {
+      /* Back from hibernate_resume(), with the RAM as it was when it was
+       * saved, and so with the scheduler still locked.
+       */
+
+      board_hibernate_restore();
+      ret = 1;
+    }
+  else
+    {
+      ret = hibernate_image(priv, hdr);
+    }
+
+  sched_unlock();
+  up_irq_restore(priv->flags);
+
+  kmm_free(priv->buffer);
+  priv->buffer = NULL;
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to save the image: %d\n", ret);
+      hibernate_invalidate(mtd);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hibernate_invalidate
+ *
+ * Description:
+ *   Erase the header of the image, so that the next boot is a normal one.
+ *
+ ****************************************************************************/
+
+int hibernate_invalidate(FAR struct mtd_dev_s *mtd)
+{
+  return MTD_ERASE(mtd, 0, 1);
+}
+
+/****************************************************************************
+ * Name: hibernate_resume
+ *
+ * Description:
+ *   Check the image at 'image' and, if it is valid and was saved with
+ *   'key', copy it back into RAM and return into hibernate_save().
+ *   Otherwise return, and the boot goes on normally.
+ *
+ ****************************************************************************/
+
+void hibernate_resume(FAR const void *image, uint32_t key)
+{
+  FAR const struct hibernate_header_s *hdr = image;
+  FAR const uint8_t *data;
+  uint32_t crc = 0;
+  uint32_t i;
+
+  if (hdr->magic != HIBERNATE_MAGIC || hdr->key != key ||
+      hdr->nregions == 0 || hdr->nregions > CONFIG_PM_HIBERNATE_NREGIONS)
+    {
+      return;
+    }
+
+  data = (FAR const uint8_t *)image + hdr->dataoff;
+  crc  = crc32part(data, hdr->datasize, crc);
+  crc  = crc32part((FAR const uint8_t *)&hdr->key,
+                   sizeof(*hdr) - offsetof(struct hibernate_header_s, key),
+                   crc);
+  if (crc != hdr->crc)
+    {
+      return;
+    }
+
+  /* Only locals and the image are used from here on: the RAM is being
+   * replaced, g_hibernate included.
+   */
+
+  for (i = 0; i < hdr->nregions; i++)
+    {
+      memcpy((FAR void *)hdr->regions[i].start, data,
+             hdr->regions[i].size);
+      data += hdr->regions[i].size;
+    }
+
+  longjmp(g_hibernate.resume, 1);
+}
+
+#endif /* CONFIG_PM_HIBERNATE */
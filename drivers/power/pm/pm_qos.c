@@ -0,0 +1,140 @@
+/****************************************************************************
+ * drivers/power/pm/pm_qos.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+#if defined(CONFIG_PM)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The requests in force and the strictest of their latencies */
+
+static dq_queue_t g_pm_qos_requests;
+static uint32_t g_pm_qos_latency = PM_QOS_LATENCY_NONE;
+static spinlock_t g_pm_qos_lock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Recompute the strictest latency.  Called with g_pm_qos_lock held.
+ *
+ ****************************************************************************/
+
+static void pm_qos_update(void)
+{
+  FAR dq_entry_t *entry;
+  uint32_t latency = PM_QOS_LATENCY_NONE;
+
+  for (entry = dq_peek(&g_pm_qos_requests); entry; entry = dq_next(entry))
+    {
+      FAR struct pm_qos_request_s *req =
+        container_of(entry, struct pm_qos_request_s, node);
+
+      if (req->latency < latency)
+        {
+          latency = req->latency;
+        }
+    }
+
+  g_pm_qos_latency = latency;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add_request
+ ****************************************************************************/
+
+void pm_qos_add_request(FAR struct pm_qos_request_s *req, uint32_t latency)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pm_qos_lock);
+
+  req->latency = latency;
+  dq_addlast(&req->node, &g_pm_qos_requests);
+
+  if (latency < g_pm_qos_latency)
+    {
+      g_pm_qos_latency = latency;
+    }
+
+  spin_unlock_irqrestore(&g_pm_qos_lock, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_update_request
+ ****************************************************************************/
+
+void pm_qos_update_request(FAR struct pm_qos_request_s *req,
+                           uint32_t latency)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pm_qos_lock);
+  req->latency = latency;
+  pm_qos_update();
+  spin_unlock_irqrestore(&g_pm_qos_lock, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove_request
+ ****************************************************************************/
+
+void pm_qos_remove_request(FAR struct pm_qos_request_s *req)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pm_qos_lock);
+  dq_rem(&req->node, &g_pm_qos_requests);
+  pm_qos_update();
+  spin_unlock_irqrestore(&g_pm_qos_lock, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(void)
+{
+  return g_pm_qos_latency;
+}
+
+#endif /* CONFIG_PM */
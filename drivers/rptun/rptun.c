@@ -77,6 +77,10 @@ struct rptun_priv_s
 #ifdef CONFIG_RPTUN_PM
   bool                         stay;
 #endif
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+  pid_t                        batchtid; /* Thread handling the rx */
+  uint32_t                     notify;   /* Vrings to notify after it */
+#endif
 #ifdef CONFIG_RPTUN_PING
   struct rpmsg_endpoint        ping;
 #endif
@@ -222,9 +226,51 @@ static inline void rptun_pm_action(FAR struct rptun_priv_s *priv,
 #  define rptun_pm_action(priv, stay)
 #endif
 
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+/****************************************************************************
+ * Name: rptun_notify_flush
+ *
+ * Description:
+ *   Send the notifications held back while the received messages were
+ *   handled, one per vring.
+ *
+ ****************************************************************************/
+
+static void rptun_notify_flush(FAR struct rptun_priv_s *priv)
+{
+  FAR struct virtio_device *vdev = priv->rvdev.vdev;
+  unsigned int i;
+
+  if (vdev == NULL)
+    {
+      /* Stopped meanwhile */
+
+      priv->notify = 0;
+      return;
+    }
+
+  for (i = 0; priv->notify != 0 && i < vdev->vrings_num; i++)
+    {
+      if (priv->notify & (1u << i))
+        {
+          priv->notify &= ~(1u << i);
+          RPTUN_NOTIFY(priv->dev, vdev->vrings_info[i].notifyid);
+        }
+    }
+}
+
+#else
+#  define rptun_notify_flush(priv)
+#endif
+
 static void rptun_worker(FAR void *arg)
 {
   FAR struct rptun_priv_s *priv = arg;
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+  pid_t batchtid = priv->batchtid;
+
+  priv->batchtid = nxsched_gettid();
+#endif
 
   switch (priv->cmd)
     {
@@ -245,6 +291,11 @@ static void rptun_worker(FAR void *arg)
 
   priv->cmd = RPTUNIOC_NONE;
   remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+
+  rptun_notify_flush(priv);
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+  priv->batchtid = batchtid;
+#endif
 }
 
 #ifdef CONFIG_RPTUN_WORKQUEUE
@@ -400,6 +451,24 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
       rptun_pm_action(priv, true);
     }
 
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+  /* Hold the notification back until the received messages are handled */
+
+  if (rvdev->vdev && priv->batchtid == nxsched_gettid())
+    {
+      unsigned int i;
+
+      for (i = 0; i < rvdev->vdev->vrings_num && i < 32; i++)
+        {
+          if (rvdev->vdev->vrings_info[i].notifyid == id)
+            {
+              priv->notify |= 1u << i;
+              return 0;
+            }
+        }
+    }
+#endif
+
   RPTUN_NOTIFY(priv->dev, id);
   return 0;
 }
@@ -452,8 +521,9 @@ static int rptun_notify_wait(FAR struct remoteproc *rproc, uint32_t id)
       return -EAGAIN;
     }
 
-  /* Wait to wakeup */
+  /* Wait to wakeup, the remote may be waiting for what was held back */
 
+  rptun_notify_flush(priv);
   nxsem_wait(&priv->semtx);
   rptun_worker(priv);
 
@@ -684,13 +754,18 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
       return -ENOMEM;
     }
 
-  if (priv->pool[1].base)
+  if (RPTUN_IS_MASTER(priv->dev))
     {
+      /* The buffers are as large as the resource table says, which is
+       * what the shared memory was carved for; the remote uses the size
+       * of the buffers it is given.
+       */
+
       struct rpmsg_virtio_config config =
         {
-          RPMSG_BUFFER_SIZE,
-          RPMSG_BUFFER_SIZE,
-          true,
+          rsc->config.h2r_buf_size,
+          rsc->config.r2h_buf_size,
+          priv->pool[1].base != NULL,
         };
 
       ret = rpmsg_init_vdev_with_config(&priv->rvdev, vdev, rptun_ns_bind,
@@ -999,6 +1074,7 @@ int rpmsg_wait(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem)
           break;
         }
 
+      rptun_notify_flush(priv);
       nxsem_wait(&priv->semtx);
       rptun_worker(priv);
     }
@@ -1182,6 +1258,9 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
     }
 
   priv->dev = dev;
+#ifdef CONFIG_RPTUN_BATCH_NOTIFY
+  priv->batchtid = INVALID_PROCESS_ID;
+#endif
 
   remoteproc_init(&priv->rproc, &g_rptun_ops, priv);
   metal_list_init(&priv->bind);
@@ -38,6 +38,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/sensors/sensor.h>
 
 /****************************************************************************
@@ -50,6 +51,18 @@
 #define DEVNAME_FMT         "/dev/uorb/sensor_%s%s%d"
 #define DEVNAME_UNCAL       "_uncal"
 #define TIMING_BUF_ESIZE    (sizeof(unsigned long))
+#define MMAP_ALIGN(x)       (((x) + TIMING_BUF_ESIZE - 1) & \
+                             ~(TIMING_BUF_ESIZE - 1))
+
+/* Orders the update of the rings against the sequence read by subscribers
+ * on the other CPUs.  On a single CPU, the calls in between suffice.
+ */
+
+#ifdef CONFIG_SMP
+#  define SENSOR_DMB()      SP_DMB()
+#else
+#  define SENSOR_DMB()
+#endif
 
 /****************************************************************************
  * Private Types
@@ -97,6 +110,14 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *shm;         /* The memory holding both buffers */
+  size_t             shmsize;            /* The size of the memory */
+#endif
+#ifdef CONFIG_SENSORS_TAP
+  mutex_t            taplock;            /* Manages exclusive access to taps */
+  struct list_node   taplist;            /* List of taps */
+#endif
 };
 
 /****************************************************************************
@@ -113,6 +134,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -157,6 +182,7 @@ static const struct sensor_info_s g_sensor_info[] =
   {sizeof(struct sensor_gps_satellite),   "gps_satellite"},
   {sizeof(struct sensor_wake_gesture),    "wake_gesture"},
   {sizeof(struct sensor_cap),             "cap"},
+  {sizeof(struct sensor_orientation),     "orientation"},
 };
 
 static const struct file_operations g_sensor_fops =
@@ -167,7 +193,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -370,6 +400,44 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static bool sensor_is_ready(FAR struct sensor_upperhalf_s *upper,
+                            FAR struct sensor_user_s *user)
+{
+#ifdef CONFIG_SENSORS_BATCH_WAKEUP
+  unsigned long latency = user->state.latency;
+  size_t pending;
+#endif
+
+  if (!sensor_is_updated(upper, user))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_SENSORS_BATCH_WAKEUP
+  /* The generation counts in us only once an interval is set, the user
+   * batching the samples is woken up when they span its latency, or fill
+   * the buffer before the oldest is overwritten.
+   */
+
+  if (latency == 0 || latency == ULONG_MAX ||
+      upper->state.min_interval == ULONG_MAX)
+    {
+      return true;
+    }
+
+  pending = upper->timing.head / TIMING_BUF_ESIZE - user->bufferpos;
+  if (pending >= upper->timing.size / TIMING_BUF_ESIZE)
+    {
+      return true;
+    }
+
+  return upper->state.generation - user->state.generation +
+         (upper->state.min_interval >> 1) >= latency;
+#else
+  return true;
+#endif
+}
+
 static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
                             FAR struct sensor_user_s *user)
 {
@@ -394,6 +462,33 @@ static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static void sensor_set_generation(FAR struct sensor_upperhalf_s *upper,
+                                  FAR struct sensor_user_s *user,
+                                  unsigned long generation)
+{
+  size_t end = upper->timing.head / TIMING_BUF_ESIZE;
+  unsigned long tmp;
+
+  /* Skip the samples up to the generation the user has taken in place */
+
+  sensor_catch_up(upper, user);
+  while (user->bufferpos != end)
+    {
+      circbuf_peekat(&upper->timing, user->bufferpos * TIMING_BUF_ESIZE,
+                     &tmp, TIMING_BUF_ESIZE);
+      if ((long)(tmp - generation) > 0)
+        {
+          break;
+        }
+
+      user->bufferpos++;
+    }
+
+  user->state.generation = generation;
+}
+#endif
+
 static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
                                  FAR struct sensor_user_s *user,
                                  FAR char *buffer, size_t len)
@@ -484,6 +579,68 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *shm;
+  size_t data = MMAP_ALIGN(sizeof(struct sensor_mmap_s));
+  size_t timing = data + MMAP_ALIGN(lower->nbuffer * upper->state.esize);
+  size_t size = timing + lower->nbuffer * TIMING_BUF_ESIZE;
+
+  /* Both buffers live in one block behind the header, so that they can be
+   * mapped by subscribers as is.
+   */
+
+  shm = kmm_zalloc(size);
+  if (shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  shm->esize   = upper->state.esize;
+  shm->nbuffer = lower->nbuffer;
+  shm->data    = data;
+  shm->timing  = timing;
+
+  circbuf_init(&upper->buffer, (FAR char *)shm + data,
+               lower->nbuffer * upper->state.esize);
+  circbuf_init(&upper->timing, (FAR char *)shm + timing,
+               lower->nbuffer * TIMING_BUF_ESIZE);
+  upper->shm     = shm;
+  upper->shmsize = size;
+#else
+  int ret;
+
+  ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      return ret;
+    }
+#endif
+
+  return OK;
+}
+
+static void sensor_buffer_uninit(FAR struct sensor_upperhalf_s *upper)
+{
+  circbuf_uninit(&upper->buffer);
+  circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->shm);
+  upper->shm = NULL;
+#endif
+}
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset)
 {
@@ -832,6 +989,24 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+      case SNIOC_SET_GENERATION:
+        {
+          nxrmutex_lock(&upper->lock);
+          if (circbuf_is_init(&upper->buffer))
+            {
+              sensor_set_generation(upper, user, arg);
+            }
+          else
+            {
+              ret = -ENODATA;
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -851,6 +1026,46 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret = OK;
+
+  /* The fetch drivers have no buffer to share */
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+    }
+
+  if (ret >= 0)
+    {
+      if (map->offset >= 0 && map->offset < upper->shmsize &&
+          map->length && map->offset + map->length <= upper->shmsize)
+        {
+          map->vaddr = (FAR char *)upper->shm + map->offset;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -919,8 +1134,10 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
+#ifdef CONFIG_SENSORS_TAP
+  FAR struct sensor_tap_s *tap;
+#endif
   unsigned long envcount;
   int semcount;
   int ret;
@@ -936,29 +1153,32 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
+      ret = sensor_buffer_init(upper);
       if (ret < 0)
         {
-          circbuf_uninit(&upper->buffer);
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  upper->shm->sequence++;
+  SENSOR_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  upper->shm->head = upper->buffer.head;
+  upper->shm->generation = upper->state.generation;
+  SENSOR_DMB();
+  upper->shm->sequence++;
+#endif
+
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
-      if (sensor_is_updated(upper, user))
+      if (sensor_is_ready(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
           if (semcount < 1)
@@ -971,6 +1191,19 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     }
 
   nxrmutex_unlock(&upper->lock);
+
+#ifdef CONFIG_SENSORS_TAP
+  /* The taps may push into other sensors, so they run out of the lock */
+
+  nxmutex_lock(&upper->taplock);
+  list_for_every_entry(&upper->taplist, tap, struct sensor_tap_s, node)
+    {
+      tap->event(tap, data, bytes);
+    }
+
+  nxmutex_unlock(&upper->taplock);
+#endif
+
   return bytes;
 }
 
@@ -1096,6 +1329,10 @@ int sensor_custom_register(FAR struct sensor_lowerhalf_s *lower,
     }
 
   nxrmutex_init(&upper->lock);
+#ifdef CONFIG_SENSORS_TAP
+  nxmutex_init(&upper->taplock);
+  list_initialize(&upper->taplist);
+#endif
 
   /* Bind the lower half data structure member */
 
@@ -1140,6 +1377,9 @@ int sensor_custom_register(FAR struct sensor_lowerhalf_s *lower,
 
 drv_err:
   nxrmutex_destroy(&upper->lock);
+#ifdef CONFIG_SENSORS_TAP
+  nxmutex_destroy(&upper->taplock);
+#endif
 
   kmm_free(upper);
 
@@ -1203,11 +1443,67 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
 #endif
 
   nxrmutex_destroy(&upper->lock);
+#ifdef CONFIG_SENSORS_TAP
+  nxmutex_destroy(&upper->taplock);
+#endif
   if (circbuf_is_init(&upper->buffer))
     {
-      circbuf_uninit(&upper->buffer);
-      circbuf_uninit(&upper->timing);
+      sensor_buffer_uninit(upper);
     }
 
   kmm_free(upper);
 }
+
+#ifdef CONFIG_SENSORS_TAP
+/****************************************************************************
+ * Name: sensor_tap_attach
+ *
+ * Description:
+ *   Attach a tap to a sensor opened by kernel code.
+ *
+ ****************************************************************************/
+
+int sensor_tap_attach(FAR struct file *filep, FAR struct sensor_tap_s *tap)
+{
+  FAR struct sensor_upperhalf_s *upper;
+
+  DEBUGASSERT(filep != NULL && tap != NULL && tap->event != NULL);
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_sensor_fops)
+    {
+      return -ENOTTY;
+    }
+
+  upper = filep->f_inode->i_private;
+  nxmutex_lock(&upper->taplock);
+  list_add_tail(&upper->taplist, &tap->node);
+  nxmutex_unlock(&upper->taplock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_tap_detach
+ *
+ * Description:
+ *   Detach a tap attached by sensor_tap_attach().
+ *
+ ****************************************************************************/
+
+int sensor_tap_detach(FAR struct file *filep, FAR struct sensor_tap_s *tap)
+{
+  FAR struct sensor_upperhalf_s *upper;
+
+  DEBUGASSERT(filep != NULL && tap != NULL);
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_sensor_fops)
+    {
+      return -ENOTTY;
+    }
+
+  upper = filep->f_inode->i_private;
+  nxmutex_lock(&upper->taplock);
+  list_delete(&tap->node);
+  nxmutex_unlock(&upper->taplock);
+  return OK;
+}
+#endif
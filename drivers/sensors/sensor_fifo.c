@@ -0,0 +1,164 @@
+/****************************************************************************
+ * drivers/sensors/sensor_fifo.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sensors/sensor.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The weight of a new measure in the interval, as a shift */
+
+#define SENSOR_FIFO_SMOOTH  3
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void sensor_fifo_measure(FAR struct sensor_fifo_s *fifo,
+                                size_t nsamples, uint64_t timestamp)
+{
+  unsigned long measured;
+
+  if (fifo->timestamp == 0 || timestamp <= fifo->timestamp)
+    {
+      return;
+    }
+
+  /* The oscillator of the sensor drifts from the nominal rate, so follow
+   * the interval measured between the watermark interrupts.  Overflows or
+   * restarts of the fifo give a gap way off the nominal one, ignore it.
+   */
+
+  measured = (timestamp - fifo->timestamp) / nsamples;
+  if (fifo->interval == 0)
+    {
+      fifo->interval = measured;
+    }
+  else if (fifo->nominal == 0 ||
+           (measured > fifo->nominal / 2 && measured < fifo->nominal * 2))
+    {
+      fifo->interval += ((long)(measured - fifo->interval)) >>
+                        SENSOR_FIFO_SMOOTH;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fifo_watermark
+ *
+ * Description:
+ *   Compute the fifo watermark for a batch latency.
+ *
+ ****************************************************************************/
+
+unsigned long sensor_fifo_watermark(FAR struct sensor_fifo_s *fifo,
+                                    unsigned long depth,
+                                    unsigned long interval,
+                                    FAR unsigned long *latency)
+{
+  unsigned long watermark = 1;
+
+  DEBUGASSERT(fifo != NULL && latency != NULL);
+
+  if (interval != fifo->nominal)
+    {
+      fifo->nominal  = interval;
+      fifo->interval = interval;
+    }
+
+  fifo->depth = depth;
+  if (interval && depth > 1 && *latency >= interval)
+    {
+      watermark = *latency / interval;
+      if (watermark > depth)
+        {
+          watermark = depth;
+        }
+    }
+
+  *latency = watermark > 1 ? watermark * interval : 0;
+  return watermark;
+}
+
+/****************************************************************************
+ * Name: sensor_fifo_push
+ *
+ * Description:
+ *   Push a batch of samples read from the hardware fifo to the upper half
+ *   at once, with interpolated timestamps.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_fifo_push(FAR struct sensor_lowerhalf_s *lower,
+                         FAR struct sensor_fifo_s *fifo,
+                         FAR void *data, size_t esize, size_t nsamples,
+                         uint64_t timestamp)
+{
+  FAR uint8_t *sample = data;
+  unsigned long step;
+  uint64_t stamp;
+  size_t i;
+
+  DEBUGASSERT(lower != NULL && fifo != NULL);
+
+  if (nsamples == 0 || esize < sizeof(uint64_t) || lower->push_event == NULL)
+    {
+      return -EINVAL;
+    }
+
+  sensor_fifo_measure(fifo, nsamples, timestamp);
+
+  /* The newest sample is taken at the watermark, the older ones back by
+   * the interval each, but never before the previous batch.
+   */
+
+  step = fifo->interval;
+  if (fifo->timestamp != 0 && nsamples > 1 &&
+      timestamp - fifo->timestamp <= (uint64_t)step * (nsamples - 1))
+    {
+      step = (timestamp - fifo->timestamp) / nsamples;
+    }
+
+  stamp = timestamp - (uint64_t)step * (nsamples - 1);
+  for (i = 0; i < nsamples; i++)
+    {
+      memcpy(sample, &stamp, sizeof(stamp));
+      sample += esize;
+      stamp  += step;
+    }
+
+  fifo->timestamp = timestamp;
+  return lower->push_event(lower->priv, data, esize * nsamples);
+}
@@ -0,0 +1,545 @@
+/****************************************************************************
+ * drivers/sensors/sensor_fusion.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <fcntl.h>
+#include <math.h>
+#include <dsp.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sensors/sensor.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FUSION_BETA         (CONFIG_SENSORS_FUSION_BETA / 1000.0f)
+
+/* The gaps of gyroscope samples longer than this restart the integration */
+
+#define FUSION_MAX_DT       1.0f
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes a fusion sensor registered */
+
+struct sensor_fusion_s
+{
+  struct list_node          node;       /* Node in the fusion list */
+  struct sensor_lowerhalf_s lower;      /* The lowerhalf of orientation */
+  mutex_t                   lock;       /* Manages access to the state */
+
+  /* The raw topics and the taps attached to them */
+
+  struct file               accel;
+  struct file               gyro;
+  struct file               mag;
+  struct sensor_tap_s       accel_tap;
+  struct sensor_tap_s       gyro_tap;
+  struct sensor_tap_s       mag_tap;
+  bool                      has_mag;
+
+  /* The latest corrections and the filter state */
+
+  struct sensor_accel       last_accel;
+  struct sensor_mag         last_mag;
+  bool                      accel_valid;
+  bool                      mag_valid;
+  uint64_t                  timestamp;  /* The last gyroscope sample */
+  float                     q[4];       /* The quaternion w, x, y, z */
+
+  char                      path[1];    /* The path of orientation topic */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int sensor_fusion_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR struct file *filep,
+                                      FAR unsigned long *period_us);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_ops_s g_sensor_fusion_ops =
+{
+  .set_interval = sensor_fusion_set_interval,
+};
+
+static mutex_t g_sensor_fusion_lock = NXMUTEX_INITIALIZER;
+static struct list_node g_sensor_fusion_list =
+  LIST_INITIAL_VALUE(g_sensor_fusion_list);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static float sensor_fusion_invsqrt(float x)
+{
+  return 1.0f / sqrtf(x);
+}
+
+static void sensor_fusion_gradient(FAR float *s, float j0, float j1,
+                                   float j2, float j3, float f)
+{
+  s[0] += j0 * f;
+  s[1] += j1 * f;
+  s[2] += j2 * f;
+  s[3] += j3 * f;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_update
+ *
+ * Description:
+ *   One step of the Madgwick filter: integrate the rate of the gyroscope,
+ *   and descend along the gradient of the error between the gravity, and
+ *   the earth field if any, expected by the quaternion and those measured.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_update(FAR struct sensor_fusion_s *fusion,
+                                 FAR const struct sensor_gyro *gyro,
+                                 float dt)
+{
+  FAR float *q = fusion->q;
+  float qdot[4];
+  float s[4] =
+    {
+      0.0f, 0.0f, 0.0f, 0.0f
+    };
+
+  float norm;
+
+  qdot[0] = 0.5f * (-q[1] * gyro->x - q[2] * gyro->y - q[3] * gyro->z);
+  qdot[1] = 0.5f * (q[0] * gyro->x + q[2] * gyro->z - q[3] * gyro->y);
+  qdot[2] = 0.5f * (q[0] * gyro->y - q[1] * gyro->z + q[3] * gyro->x);
+  qdot[3] = 0.5f * (q[0] * gyro->z + q[1] * gyro->y - q[2] * gyro->x);
+
+  norm = fusion->last_accel.x * fusion->last_accel.x +
+         fusion->last_accel.y * fusion->last_accel.y +
+         fusion->last_accel.z * fusion->last_accel.z;
+  if (fusion->accel_valid && norm > 0.0f)
+    {
+      float ax;
+      float ay;
+      float az;
+
+      norm = sensor_fusion_invsqrt(norm);
+      ax = fusion->last_accel.x * norm;
+      ay = fusion->last_accel.y * norm;
+      az = fusion->last_accel.z * norm;
+
+      /* The gravity expected by the quaternion, minus the one measured */
+
+      sensor_fusion_gradient(s, -2.0f * q[2], 2.0f * q[3],
+                             -2.0f * q[0], 2.0f * q[1],
+                             2.0f * (q[1] * q[3] - q[0] * q[2]) - ax);
+      sensor_fusion_gradient(s, 2.0f * q[1], 2.0f * q[0],
+                             2.0f * q[3], 2.0f * q[2],
+                             2.0f * (q[0] * q[1] + q[2] * q[3]) - ay);
+      sensor_fusion_gradient(s, 0.0f, -4.0f * q[1], -4.0f * q[2], 0.0f,
+                             1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]) -
+                             az);
+
+      norm = fusion->last_mag.x * fusion->last_mag.x +
+             fusion->last_mag.y * fusion->last_mag.y +
+             fusion->last_mag.z * fusion->last_mag.z;
+      if (fusion->mag_valid && norm > 0.0f)
+        {
+          float mx;
+          float my;
+          float mz;
+          float hx;
+          float hy;
+          float bx;
+          float bz;
+
+          norm = sensor_fusion_invsqrt(norm);
+          mx = fusion->last_mag.x * norm;
+          my = fusion->last_mag.y * norm;
+          mz = fusion->last_mag.z * norm;
+
+          /* The earth field is the measure rotated into the earth frame,
+           * with its horizontal part moved onto axis X, bx and bz are
+           * twice its components.
+           */
+
+          hx = mx * (q[0] * q[0] + q[1] * q[1] - q[2] * q[2] -
+                     q[3] * q[3]) +
+               2.0f * my * (q[1] * q[2] - q[0] * q[3]) +
+               2.0f * mz * (q[0] * q[2] + q[1] * q[3]);
+          hy = 2.0f * mx * (q[0] * q[3] + q[1] * q[2]) +
+               my * (q[0] * q[0] - q[1] * q[1] + q[2] * q[2] -
+                     q[3] * q[3]) +
+               2.0f * mz * (q[2] * q[3] - q[0] * q[1]);
+          bx = 2.0f * vector2d_mag(hx, hy);
+          bz = 2.0f * (2.0f * mx * (q[1] * q[3] - q[0] * q[2]) +
+                       2.0f * my * (q[0] * q[1] + q[2] * q[3]) +
+                       mz * (q[0] * q[0] - q[1] * q[1] - q[2] * q[2] +
+                             q[3] * q[3]));
+
+          sensor_fusion_gradient(s, -bz * q[2], bz * q[3],
+                                 -2.0f * bx * q[2] - bz * q[0],
+                                 -2.0f * bx * q[3] + bz * q[1],
+                                 bx * (0.5f - q[2] * q[2] - q[3] * q[3]) +
+                                 bz * (q[1] * q[3] - q[0] * q[2]) - mx);
+          sensor_fusion_gradient(s, -bx * q[3] + bz * q[1],
+                                 bx * q[2] + bz * q[0],
+                                 bx * q[1] + bz * q[3],
+                                 -bx * q[0] + bz * q[2],
+                                 bx * (q[1] * q[2] - q[0] * q[3]) +
+                                 bz * (q[0] * q[1] + q[2] * q[3]) - my);
+          sensor_fusion_gradient(s, bx * q[2],
+                                 bx * q[3] - 2.0f * bz * q[1],
+                                 bx * q[0] - 2.0f * bz * q[2],
+                                 bx * q[1],
+                                 bx * (q[0] * q[2] + q[1] * q[3]) +
+                                 bz * (0.5f - q[1] * q[1] - q[2] * q[2]) -
+                                 mz);
+        }
+
+      norm = s[0] * s[0] + s[1] * s[1] + s[2] * s[2] + s[3] * s[3];
+      if (norm > 0.0f)
+        {
+          norm = sensor_fusion_invsqrt(norm);
+          qdot[0] -= FUSION_BETA * s[0] * norm;
+          qdot[1] -= FUSION_BETA * s[1] * norm;
+          qdot[2] -= FUSION_BETA * s[2] * norm;
+          qdot[3] -= FUSION_BETA * s[3] * norm;
+        }
+    }
+
+  q[0] += qdot[0] * dt;
+  q[1] += qdot[1] * dt;
+  q[2] += qdot[2] * dt;
+  q[3] += qdot[3] * dt;
+
+  norm = sensor_fusion_invsqrt(q[0] * q[0] + q[1] * q[1] +
+                               q[2] * q[2] + q[3] * q[3]);
+  q[0] *= norm;
+  q[1] *= norm;
+  q[2] *= norm;
+  q[3] *= norm;
+}
+
+static void sensor_fusion_publish(FAR struct sensor_fusion_s *fusion,
+                                  uint64_t timestamp)
+{
+  FAR const float *q = fusion->q;
+  struct sensor_orientation orient;
+  float sinp;
+
+  orient.timestamp = timestamp;
+  orient.w = q[0];
+  orient.x = q[1];
+  orient.y = q[2];
+  orient.z = q[3];
+
+  sinp = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+  f_saturate(&sinp, -1.0f, 1.0f);
+  orient.roll  = fast_atan2(2.0f * (q[0] * q[1] + q[2] * q[3]),
+                            1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+  orient.pitch = fast_atan2(sinp, sqrtf(1.0f - sinp * sinp));
+  orient.yaw   = fast_atan2(2.0f * (q[0] * q[3] + q[1] * q[2]),
+                            1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+
+  fusion->lower.push_event(fusion->lower.priv, &orient, sizeof(orient));
+}
+
+static void sensor_fusion_gyro_event(FAR struct sensor_tap_s *tap,
+                                     FAR const void *data, size_t bytes)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(tap, struct sensor_fusion_s, gyro_tap);
+  FAR const struct sensor_gyro *gyro = data;
+  size_t nums = bytes / sizeof(*gyro);
+
+  /* Each sample of the gyroscope steps the filter, at the source rate */
+
+  nxmutex_lock(&fusion->lock);
+  for (; nums > 0; nums--, gyro++)
+    {
+      float dt = (int64_t)(gyro->timestamp - fusion->timestamp) / 1e6f;
+
+      fusion->timestamp = gyro->timestamp;
+      if (dt <= 0.0f || dt > FUSION_MAX_DT)
+        {
+          continue;
+        }
+
+      sensor_fusion_update(fusion, gyro, dt);
+      sensor_fusion_publish(fusion, gyro->timestamp);
+    }
+
+  nxmutex_unlock(&fusion->lock);
+}
+
+static void sensor_fusion_accel_event(FAR struct sensor_tap_s *tap,
+                                      FAR const void *data, size_t bytes)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(tap, struct sensor_fusion_s, accel_tap);
+
+  /* Only the latest sample corrects the next steps */
+
+  nxmutex_lock(&fusion->lock);
+  memcpy(&fusion->last_accel, (FAR const char *)data + bytes -
+         sizeof(fusion->last_accel), sizeof(fusion->last_accel));
+  fusion->accel_valid = true;
+  nxmutex_unlock(&fusion->lock);
+}
+
+static void sensor_fusion_mag_event(FAR struct sensor_tap_s *tap,
+                                    FAR const void *data, size_t bytes)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(tap, struct sensor_fusion_s, mag_tap);
+
+  nxmutex_lock(&fusion->lock);
+  memcpy(&fusion->last_mag, (FAR const char *)data + bytes -
+         sizeof(fusion->last_mag), sizeof(fusion->last_mag));
+  fusion->mag_valid = true;
+  nxmutex_unlock(&fusion->lock);
+}
+
+static int sensor_fusion_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR struct file *filep,
+                                      FAR unsigned long *period_us)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(lower, struct sensor_fusion_s, lower);
+  int ret;
+
+  /* The orientation is published at the rate of the gyroscope, the
+   * corrections are subscribed at the same rate.
+   */
+
+  ret = file_ioctl(&fusion->gyro, SNIOC_SET_INTERVAL, *period_us);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  file_ioctl(&fusion->accel, SNIOC_SET_INTERVAL, *period_us);
+  if (fusion->has_mag)
+    {
+      file_ioctl(&fusion->mag, SNIOC_SET_INTERVAL, *period_us);
+    }
+
+  return OK;
+}
+
+static int sensor_fusion_open(FAR struct sensor_fusion_s *fusion,
+                              FAR struct file *filep,
+                              FAR struct sensor_tap_s *tap,
+                              FAR const char *path)
+{
+  int ret;
+
+  ret = file_open(filep, path, O_RDOK | O_NONBLOCK);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to open %s: %d\n", path, ret);
+      return ret;
+    }
+
+  ret = sensor_tap_attach(filep, tap);
+  if (ret < 0)
+    {
+      file_close(filep);
+    }
+
+  return ret;
+}
+
+static void sensor_fusion_close(FAR struct file *filep,
+                                FAR struct sensor_tap_s *tap)
+{
+  sensor_tap_detach(filep, tap);
+  file_close(filep);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fusion_register
+ *
+ * Description:
+ *   Register a fusion sensor publishing the orientation computed from the
+ *   raw topics.
+ *
+ * Input Parameters:
+ *   info - The paths of the orientation and raw topics.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fusion_register(FAR const struct sensor_fusion_reginfo_s *info)
+{
+  FAR struct sensor_fusion_s *fusion;
+  size_t size;
+  int ret;
+
+  if (info == NULL || info->path == NULL || info->accel == NULL ||
+      info->gyro == NULL)
+    {
+      return -EINVAL;
+    }
+
+  size = strlen(info->path);
+  fusion = kmm_zalloc(sizeof(*fusion) + size);
+  if (fusion == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  strlcpy(fusion->path, info->path, size + 1);
+  nxmutex_init(&fusion->lock);
+  fusion->q[0]            = 1.0f;
+  fusion->accel_tap.event = sensor_fusion_accel_event;
+  fusion->gyro_tap.event  = sensor_fusion_gyro_event;
+  fusion->mag_tap.event   = sensor_fusion_mag_event;
+  fusion->lower.type      = SENSOR_TYPE_ORIENTATION;
+  fusion->lower.nbuffer   = info->nbuffer;
+  fusion->lower.ops       = &g_sensor_fusion_ops;
+
+  ret = sensor_custom_register(&fusion->lower, fusion->path,
+                               sizeof(struct sensor_orientation));
+  if (ret < 0)
+    {
+      goto errout_with_fusion;
+    }
+
+  /* The corrections are attached first, so the filter can use them from the
+   * first step.
+   */
+
+  ret = sensor_fusion_open(fusion, &fusion->accel, &fusion->accel_tap,
+                           info->accel);
+  if (ret < 0)
+    {
+      goto errout_with_register;
+    }
+
+  if (info->mag != NULL)
+    {
+      ret = sensor_fusion_open(fusion, &fusion->mag, &fusion->mag_tap,
+                               info->mag);
+      if (ret < 0)
+        {
+          goto errout_with_accel;
+        }
+
+      fusion->has_mag = true;
+    }
+
+  ret = sensor_fusion_open(fusion, &fusion->gyro, &fusion->gyro_tap,
+                           info->gyro);
+  if (ret < 0)
+    {
+      goto errout_with_mag;
+    }
+
+  nxmutex_lock(&g_sensor_fusion_lock);
+  list_add_tail(&g_sensor_fusion_list, &fusion->node);
+  nxmutex_unlock(&g_sensor_fusion_lock);
+  return OK;
+
+errout_with_mag:
+  if (fusion->has_mag)
+    {
+      sensor_fusion_close(&fusion->mag, &fusion->mag_tap);
+    }
+
+errout_with_accel:
+  sensor_fusion_close(&fusion->accel, &fusion->accel_tap);
+errout_with_register:
+  sensor_custom_unregister(&fusion->lower, fusion->path);
+errout_with_fusion:
+  nxmutex_destroy(&fusion->lock);
+  kmm_free(fusion);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_unregister
+ *
+ * Description:
+ *   Unregister the fusion sensor publishing on the path.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such fusion sensor.
+ *
+ ****************************************************************************/
+
+int sensor_fusion_unregister(FAR const char *path)
+{
+  FAR struct sensor_fusion_s *fusion;
+
+  nxmutex_lock(&g_sensor_fusion_lock);
+  list_for_every_entry(&g_sensor_fusion_list, fusion,
+                       struct sensor_fusion_s, node)
+    {
+      if (strcmp(path, fusion->path) == 0)
+        {
+          list_delete(&fusion->node);
+          nxmutex_unlock(&g_sensor_fusion_lock);
+
+          /* No step runs once the taps are detached */
+
+          sensor_fusion_close(&fusion->gyro, &fusion->gyro_tap);
+          if (fusion->has_mag)
+            {
+              sensor_fusion_close(&fusion->mag, &fusion->mag_tap);
+            }
+
+          sensor_fusion_close(&fusion->accel, &fusion->accel_tap);
+          sensor_custom_unregister(&fusion->lower, fusion->path);
+          nxmutex_destroy(&fusion->lock);
+          kmm_free(fusion);
+          return OK;
+        }
+    }
+
+  nxmutex_unlock(&g_sensor_fusion_lock);
+  return -ENOENT;
+}
@@ -207,7 +207,22 @@ static int usensor_ioctl(FAR struct file *filep, int cmd,
 
       path = (FAR const char *)(uintptr_t)arg;
       ret = usensor_unregister(usensor, path);
+#ifdef CONFIG_SENSORS_FUSION
+      if (ret == -ENOENT)
+        {
+          ret = sensor_fusion_unregister(path);
+        }
+#endif
+    }
+#ifdef CONFIG_SENSORS_FUSION
+  else if (cmd == SNIOC_REGISTER_FUSION)
+    {
+      FAR const struct sensor_fusion_reginfo_s *info;
+
+      info = (FAR const struct sensor_fusion_reginfo_s *)(uintptr_t)arg;
+      ret = sensor_fusion_register(info);
     }
+#endif
 
   return ret;
 }
@@ -502,64 +502,78 @@ static ssize_t pty_write(FAR struct file *filep,
 
   if ((dev->pd_oflag & OPOST) != 0)
     {
-      /* We will transfer one byte at a time, making the appropriae
-       * translations.  Specifically not handled:
+      /* We will transfer the runs of characters needing no translation
+       * at once, and the translated line endings in between.  Specifically
+       * not handled:
        *
        *   OXTABS - primarily a full-screen terminal optimisation
        *   ONOEOT - Unix interoperability hack
        *   OLCUC  - Not specified by POSIX
        *   ONOCR  - low-speed interactive optimisation
+       *
+       * REVISIT: Should not block if the oflags include O_NONBLOCK.
+       * How would we ripple the O_NONBLOCK characteristic to the
+       * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
+       * TODO comment at the top of this file.
        */
 
       ntotal = 0;
-      for (i = 0; i < len; i++)
+      while (ntotal < (ssize_t)len)
         {
-          ch = *buffer++;
-
-          /* Mapping CR to NL? */
+          /* Find the next newline, or carriage return mapped to one */
 
-          if (ch == '\r' && (dev->pd_oflag & OCRNL) != 0)
+          for (i = ntotal; i < len; i++)
             {
-              ch = '\n';
+              ch = buffer[i];
+              if (ch == '\n' || (ch == '\r' && (dev->pd_oflag & OCRNL) != 0))
+                {
+                  break;
+                }
             }
 
-          /* Are we interested in newline processing? */
+          /* Transfer the characters before it.  This will block if the
+           * sink pipe is full.
+           */
 
-          if ((ch == '\n') && (dev->pd_oflag & (ONLCR | ONLRET)) != 0)
+          if (i > (size_t)ntotal)
             {
-              char cr = '\r';
-
-              /* Transfer the carriage return.  This will block if the
-               * sink pipe is full.
-               *
-               * REVISIT: Should not block if the oflags include O_NONBLOCK.
-               * How would we ripple the O_NONBLOCK characteristic to the
-               * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
-               * TODO comment at the top of this file.
-               *
-               * NOTE: The newline is not included in total number of bytes
-               * written.  Otherwise, we would return more than the
-               * requested number of bytes.
-               */
-
-              nwritten = file_write(&dev->pd_sink, &cr, 1);
+              nwritten = file_write(&dev->pd_sink, &buffer[ntotal],
+                                    i - ntotal);
               if (nwritten < 0)
                 {
                   ntotal = nwritten;
                   break;
                 }
+
+              ntotal += nwritten;
+              if (ntotal < (ssize_t)i)
+                {
+                  break;
+                }
+            }
+
+          if (i >= len)
+            {
+              break;
             }
 
-          /* Transfer the (possibly translated) character..  This will block
-           * if the sink pipe is full
+          /* Transfer the newline, preceded by a carriage return if we are
+           * interested in newline processing.
            *
-           * REVISIT: Should not block if the oflags include O_NONBLOCK.
-           * How would we ripple the O_NONBLOCK characteristic to the
-           * contained sink pipe?  file_fcntl()?  Or FIONSPACe?  See the
-           * TODO comment at the top of this file.
+           * NOTE: The carriage return is not included in total number of
+           * bytes written.  Otherwise, we would return more than the
+           * requested number of bytes.
            */
 
-          nwritten = file_write(&dev->pd_sink, &ch, 1);
+          if ((dev->pd_oflag & (ONLCR | ONLRET)) != 0)
+            {
+              nwritten = file_write(&dev->pd_sink, "\r\n", 2);
+            }
+          else
+            {
+              nwritten = file_write(&dev->pd_sink, "\n", 1);
+            }
+
           if (nwritten < 0)
             {
               ntotal = nwritten;
@@ -89,6 +89,8 @@
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch,
                                 bool oktoblock);
+static size_t  uart_putxmitblock(FAR uart_dev_t *dev,
+                                 FAR const char *buffer, size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev,
                                     FAR const char *buffer,
                                     size_t buflen);
@@ -297,6 +299,59 @@ static inline void uart_putc(FAR uart_dev_t *dev, int ch)
   uart_send(dev, ch);
 }
 
+/****************************************************************************
+ * Name: uart_putxmitblock
+ *
+ * Description:
+ *   Copy as many bytes as fit in the TX buffer at once, without blocking.
+ *
+ * Returned Value:
+ *   The number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t uart_putxmitblock(FAR uart_dev_t *dev,
+                                FAR const char *buffer, size_t buflen)
+{
+  int16_t head = dev->xmit.head;
+  int16_t tail = dev->xmit.tail;
+  size_t copied = 0;
+
+  while (copied < buflen)
+    {
+      size_t nbytes;
+
+      /* One byte is kept free to tell full from empty */
+
+      if (head >= tail)
+        {
+          nbytes = dev->xmit.size - head - (tail == 0);
+        }
+      else
+        {
+          nbytes = tail - head - 1;
+        }
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      nbytes = MIN(nbytes, buflen - copied);
+      memcpy(&dev->xmit.buffer[head], buffer + copied, nbytes);
+      copied += nbytes;
+
+      head += nbytes;
+      if (head >= dev->xmit.size)
+        {
+          head = 0;
+        }
+    }
+
+  dev->xmit.head = head;
+  return copied;
+}
+
 /****************************************************************************
  * Name: uart_irqwrite
  ****************************************************************************/
@@ -728,6 +783,10 @@ static int uart_close(FAR struct file *filep)
       uart_shutdown(dev);            /* Disable the UART */
     }
 
+#ifdef CONFIG_SERIAL_RXWATERMARK
+  wd_cancel(&dev->rxidle);
+#endif
+
   leave_critical_section(flags);
 
   /* Wake up read and poll functions */
@@ -813,7 +872,32 @@ static ssize_t uart_read(FAR struct file *filep,
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (rxbuf->head != tail &&
+          (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0 &&
+          (dev->tc_lflag & ECHO) == 0)
+        {
+          int16_t head = rxbuf->head;
+          size_t nbytes;
+
+          /* Without input processing, copy the bytes contiguous in the
+           * buffer at once.
+           */
+
+          nbytes = (head > tail ? head : rxbuf->size) - tail;
+          nbytes = MIN(nbytes, buflen - recvd);
+          memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+          buffer += nbytes;
+          recvd  += nbytes;
+
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
+
+          rxbuf->tail = tail;
+        }
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -1249,6 +1333,22 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      /* Without output post-processing, copy what fits at once, and go
+       * byte by byte below only to wait for space.
+       */
+
+      if ((dev->tc_oflag & OPOST) == 0)
+        {
+          size_t nbytes = uart_putxmitblock(dev, buffer, buflen);
+
+          buffer += nbytes;
+          buflen -= nbytes;
+          if (buflen == 0)
+            {
+              break;
+            }
+        }
+
       ch  = *buffer++;
       ret = OK;
 
@@ -1476,6 +1576,54 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
             break;
 
+#ifdef CONFIG_SERIAL_RXWATERMARK
+          case TIOCSRXWM:
+            {
+              FAR const struct serial_rxwm_s *rxwm =
+                (FAR const struct serial_rxwm_s *)(uintptr_t)arg;
+              irqstate_t flags;
+
+              if (rxwm == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              /* The watermark must be reachable in the RX buffer */
+
+              flags = enter_critical_section();
+              dev->rxwatermark = MIN(rxwm->watermark,
+                                     (size_t)dev->recv.size - 1);
+              dev->rxtimeout   = USEC2TICK(rxwm->timeout);
+              if (rxwm->timeout > 0 && dev->rxtimeout == 0)
+                {
+                  dev->rxtimeout = 1;
+                }
+
+              wd_cancel(&dev->rxidle);
+              leave_critical_section(flags);
+              ret = 0;
+            }
+            break;
+
+          case TIOCGRXWM:
+            {
+              FAR struct serial_rxwm_s *rxwm =
+                (FAR struct serial_rxwm_s *)(uintptr_t)arg;
+
+              if (rxwm == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              rxwm->watermark = dev->rxwatermark;
+              rxwm->timeout   = TICK2USEC(dev->rxtimeout);
+              ret = 0;
+            }
+            break;
+#endif
+
           case TCSBRK:
             {
               /* Non-standard Break specifies duration in milliseconds */
@@ -26,7 +26,9 @@
 
 #include <assert.h>
 #include <sys/types.h>
+#include <sys/param.h>
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
 #include <nuttx/signal.h>
 
@@ -80,6 +82,64 @@ static int uart_recvchars_check_special(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_rxidle_expiry
+ *
+ * Description:
+ *   No byte was received for the inter-byte timeout, wake up the readers
+ *   with the bytes buffered below the watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXWATERMARK
+static void uart_rxidle_expiry(wdparm_t arg)
+{
+  uart_datareceived((FAR uart_dev_t *)arg);
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_ready
+ *
+ * Description:
+ *   Check whether the readers are to be woken up with nbuffered bytes in
+ *   the RX circular buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+static bool uart_recvchars_ready(FAR uart_dev_t *dev, size_t nbuffered)
+{
+#ifdef CONFIG_SERIAL_TERMIOS
+  if (nbuffered < dev->minrecv)
+#else
+  if (nbuffered == 0)
+#endif
+    {
+      return false;
+    }
+
+#ifdef CONFIG_SERIAL_RXWATERMARK
+  /* Below the watermark, (re)start the inter-byte timeout instead */
+
+  if (nbuffered < dev->rxwatermark)
+    {
+      if (dev->rxtimeout > 0)
+        {
+          wd_start(&dev->rxidle, dev->rxtimeout, uart_rxidle_expiry,
+                   (wdparm_t)dev);
+        }
+
+      return false;
+    }
+
+  wd_cancel(&dev->rxidle);
+#endif
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -345,11 +405,93 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
       nbytes = rxbuf->size - rxbuf->tail + rxbuf->head;
     }
 
-#ifdef CONFIG_SERIAL_TERMIOS
-  if (nbytes >= dev->minrecv)
+  if (uart_recvchars_ready(dev, nbytes))
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_block
+ *
+ * Description:
+ *   Copy a block received by DMA into buffers of the lower half to the RX
+ *   circular buffer, and wake up the readers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+size_t uart_recvchars_block(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t nbytes)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t head = rxbuf->head;
+  size_t nbuffered;
+  size_t copied = 0;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo;
+#endif
+
+  if (head >= rxbuf->tail)
+    {
+      nbuffered = head - rxbuf->tail;
+    }
+  else
+    {
+      nbuffered = rxbuf->size - rxbuf->tail + head;
+    }
+
+  /* Drop what doesn't fit, one byte is kept free to tell full from empty */
+
+  nbytes = MIN(nbytes, rxbuf->size - nbuffered - 1);
+  while (copied < nbytes)
+    {
+      size_t chunk = MIN(nbytes - copied, (size_t)(rxbuf->size - head));
+
+      memcpy(&rxbuf->buffer[head], buffer + copied, chunk);
+      copied += chunk;
+      head    = (head + chunk) % rxbuf->size;
+    }
+
+  rxbuf->head = head;
+  nbuffered  += copied;
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  signo = uart_check_special(dev, buffer, copied);
+#endif
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  /* Let the lower half activate RX flow control above the watermark */
+
+  if (nbuffered >= (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK *
+                    rxbuf->size) / 100)
+    {
+      uart_rxflowcontrol(dev, nbuffered, true);
+    }
 #else
-  if (nbytes)
+  if (nbuffered + 1 >= rxbuf->size)
+    {
+      uart_rxflowcontrol(dev, rxbuf->size, true);
+    }
+#endif
 #endif
+
+  if (uart_recvchars_ready(dev, nbuffered))
     {
       uart_datareceived(dev);
     }
@@ -364,6 +506,8 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
       uart_reset_sem(dev);
     }
 #endif
+
+  return copied;
 }
 #endif
 
@@ -0,0 +1,381 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct spi_queue_s
+{
+  FAR struct spi_queue_s *flink;   /* Next queue in g_spi_queues */
+  FAR struct spi_dev_s *spi;       /* The bus served by this queue */
+  int       crefs;                 /* spi_queue_initialize() references */
+  mutex_t   lock;                  /* Protects pending */
+  sem_t     sem;                   /* Posted for each submitted request */
+  sem_t     exit;                  /* Posted by the exiting thread */
+  sq_queue_t pending;              /* Ordered by decreasing priority */
+  bool      stop;                  /* true: The thread shall exit */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_spi_queuelock = NXMUTEX_INITIALIZER;
+static FAR struct spi_queue_s *g_spi_queues;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_next
+ *
+ * Description:
+ *   Remove the request of the highest priority, if any.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_request_s *
+spi_queue_next(FAR struct spi_queue_s *queue)
+{
+  FAR struct spi_request_s *req;
+
+  nxmutex_lock(&queue->lock);
+  req = (FAR struct spi_request_s *)sq_remfirst(&queue->pending);
+  nxmutex_unlock(&queue->lock);
+  return req;
+}
+
+/****************************************************************************
+ * Name: spi_queue_thread
+ *
+ * Description:
+ *   Perform the queued sequences.  Up to CONFIG_SPI_QUEUE_BATCH of them run
+ *   back to back under one SPI_LOCK(), then the bus is released, so that
+ *   callers of spi_transfer() get their turn, and the callbacks are called.
+ *
+ ****************************************************************************/
+
+static int spi_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_queue_s *queue =
+    (FAR struct spi_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct spi_request_s *req;
+  sq_queue_t done;
+  int nbatch;
+
+  sq_init(&done);
+
+  while (nxsem_wait_uninterruptible(&queue->sem) == OK && !queue->stop)
+    {
+      req = spi_queue_next(queue);
+      if (req == NULL)
+        {
+          /* Already served by a previous batch */
+
+          continue;
+        }
+
+      SPI_LOCK(queue->spi, true);
+
+      for (nbatch = 0; req != NULL; )
+        {
+          req->result = spi_transfer_locked(queue->spi, req->seq);
+          sq_addlast(&req->node, &done);
+
+          if (++nbatch >= CONFIG_SPI_QUEUE_BATCH)
+            {
+              break;
+            }
+
+          req = spi_queue_next(queue);
+        }
+
+      SPI_LOCK(queue->spi, false);
+
+      while ((req = (FAR struct spi_request_s *)sq_remfirst(&done)) != NULL)
+        {
+          req->complete(req, req->result);
+        }
+    }
+
+  nxsem_post(&queue->exit);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Return the transfer queue of an SPI bus, starting its thread the first
+ *   time.  Every driver on the bus gets the same queue, which is released
+ *   by spi_queue_uninitialize().
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(spi != NULL);
+
+  nxmutex_lock(&g_spi_queuelock);
+
+  for (queue = g_spi_queues; queue != NULL; queue = queue->flink)
+    {
+      if (queue->spi == spi)
+        {
+          queue->crefs++;
+          goto out;
+        }
+    }
+
+  queue = kmm_zalloc(sizeof(struct spi_queue_s));
+  if (queue == NULL)
+    {
+      goto out;
+    }
+
+  queue->spi   = spi;
+  queue->crefs = 1;
+  nxmutex_init(&queue->lock);
+  nxsem_init(&queue->sem, 0, 0);
+  nxsem_init(&queue->exit, 0, 0);
+  sq_init(&queue->pending);
+
+  snprintf(arg1, sizeof(arg1), "%p", queue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("spi_queue", CONFIG_SPI_QUEUE_PRIORITY,
+                       CONFIG_SPI_QUEUE_STACKSIZE, spi_queue_thread, argv);
+  if (ret < 0)
+    {
+      spierr("ERROR: Failed to start the queue thread: %d\n", ret);
+      nxsem_destroy(&queue->exit);
+      nxsem_destroy(&queue->sem);
+      nxmutex_destroy(&queue->lock);
+      kmm_free(queue);
+      queue = NULL;
+      goto out;
+    }
+
+  queue->flink = g_spi_queues;
+  g_spi_queues = queue;
+
+out:
+  nxmutex_unlock(&g_spi_queuelock);
+  return queue;
+}
+
+/****************************************************************************
+ * Name: spi_queue_uninitialize
+ *
+ * Description:
+ *   Release a reference to the queue.  With the last one the thread stops
+ *   and the requests still queued complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *
+ ****************************************************************************/
+
+void spi_queue_uninitialize(FAR struct spi_queue_s *queue)
+{
+  FAR struct spi_queue_s **prev;
+  FAR struct spi_request_s *req;
+
+  DEBUGASSERT(queue != NULL && queue->crefs > 0);
+
+  nxmutex_lock(&g_spi_queuelock);
+  if (--queue->crefs > 0)
+    {
+      nxmutex_unlock(&g_spi_queuelock);
+      return;
+    }
+
+  prev = &g_spi_queues;
+  while (*prev != queue)
+    {
+      prev = &(*prev)->flink;
+    }
+
+  *prev = queue->flink;
+  nxmutex_unlock(&g_spi_queuelock);
+
+  /* Stop the thread once it is done with its current batch */
+
+  queue->stop = true;
+  nxsem_post(&queue->sem);
+  nxsem_wait_uninterruptible(&queue->exit);
+
+  while ((req = spi_queue_next(queue)) != NULL)
+    {
+      req->complete(req, -ECANCELED);
+    }
+
+  nxsem_destroy(&queue->exit);
+  nxsem_destroy(&queue->sem);
+  nxmutex_destroy(&queue->lock);
+  kmm_free(queue);
+}
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting for them.
+ *   Requests run in the order of their priority, first come first served
+ *   within one priority.  The request and its sequence must stay valid
+ *   until the complete callback is called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - Describes the sequence and its callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *node;
+
+  DEBUGASSERT(queue != NULL && req != NULL && req->seq != NULL &&
+              req->complete != NULL);
+
+  nxmutex_lock(&queue->lock);
+
+  /* Insert behind the requests of the same or a higher priority */
+
+  sq_for_every(&queue->pending, node)
+    {
+      if (((FAR struct spi_request_s *)node)->priority < req->priority)
+        {
+          break;
+        }
+
+      prev = node;
+    }
+
+  if (prev == NULL)
+    {
+      sq_addfirst(&req->node, &queue->pending);
+    }
+  else
+    {
+      sq_addafter(prev, &req->node, &queue->pending);
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return nxsem_post(&queue->sem);
+}
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not started yet.  Its complete callback is
+ *   not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request passed to spi_queue_submit()
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it has started or is
+ *   done.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *node;
+  int ret = -EBUSY;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  nxmutex_lock(&queue->lock);
+
+  sq_for_every(&queue->pending, node)
+    {
+      if (node == &req->node)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&queue->pending);
+            }
+          else
+            {
+              sq_remafter(prev, &queue->pending);
+            }
+
+          ret = OK;
+          break;
+        }
+
+      prev = node;
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_QUEUE */
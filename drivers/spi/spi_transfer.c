@@ -40,12 +40,11 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: spi_transfer
+ * Name: spi_transfer_locked
  *
  * Description:
- *   This is a helper function that can be used to encapsulate and manage
- *   a sequence of SPI transfers.  The SPI bus will be locked and the
- *   SPI device selected for the duration of the transfers.
+ *   Same as spi_transfer() on a bus that the caller already locked with
+ *   SPI_LOCK(), so that several sequences can be performed back to back.
  *
  * Input Parameters:
  *   spi - An instance of the SPI device to use for the transfer
@@ -56,7 +55,8 @@
  *
  ****************************************************************************/
 
-int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+int spi_transfer_locked(FAR struct spi_dev_s *spi,
+                        FAR struct spi_sequence_s *seq)
 {
   FAR struct spi_trans_s *trans;
   int ret = OK;
@@ -64,10 +64,6 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
 
   DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
 
-  /* Get exclusive access to the SPI bus */
-
-  SPI_LOCK(spi, true);
-
   /* Establish the fixed SPI attributes for all transfers in the sequence */
 
   SPI_SETFREQUENCY(spi, seq->frequency);
@@ -77,7 +73,6 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   if (ret < 0)
     {
       spierr("ERROR: SPI_SETDELAY failed: %d\n", ret);
-      SPI_LOCK(spi, false);
       return ret;
     }
 #endif
@@ -139,6 +134,36 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
     }
 
   SPI_SELECT(spi, seq->dev, false);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   This is a helper function that can be used to encapsulate and manage
+ *   a sequence of SPI transfers.  The SPI bus will be locked and the
+ *   SPI device selected for the duration of the transfers.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   seq - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
+
+  /* Get exclusive access to the SPI bus */
+
+  SPI_LOCK(spi, true);
+  ret = spi_transfer_locked(spi, seq);
   SPI_LOCK(spi, false);
   return ret;
 }
@@ -27,7 +27,12 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/streams.h>
 
 /****************************************************************************
  * Public Data
@@ -224,6 +229,102 @@ int syslog_add_intbuffer(int ch);
 int syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_timestamp
+ *
+ * Description:
+ *   Return the time stamp of a message, zero if the time is not available
+ *   yet.
+ *
+ ****************************************************************************/
+
+void syslog_timestamp(FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: syslog_prefix
+ *
+ * Description:
+ *   Output the configured prefix of a message: the time stamp, the CPU,
+ *   the thread, the priority...
+ *
+ * Input Parameters:
+ *   stream   - The stream to output to
+ *   priority - The priority of the message
+ *   ts       - The time stamp of the message, from syslog_timestamp()
+ *   cpu      - The CPU which logged the message
+ *   pid      - The thread which logged the message
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid);
+
+/****************************************************************************
+ * Name: syslog_suffix
+ *
+ * Description:
+ *   Terminate a message:  add the missing newline and reset the terminal
+ *   style.
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+int syslog_suffix(FAR struct lib_syslograwstream_s *stream);
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message with its raw arguments in the buffer of this CPU,
+ *   the syslog thread formats and outputs it later.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format of the message, which must remain valid
+ *   ap       - The arguments of the message, not consumed
+ *
+ * Returned Value:
+ *   Zero if the message was recorded; -ENOSPC if it was lost because the
+ *   buffer is full; -ENOSYS if the message cannot be deferred and must be
+ *   output by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Output the deferred messages in the context of the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the syslog thread.  The messages are output by their caller
+ *   until then.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
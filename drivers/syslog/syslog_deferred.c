@@ -0,0 +1,970 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The deferred messages are recorded as their format pointer followed by
+ * their raw arguments in a ring buffer per CPU.  The callers only disable
+ * the interrupts of their CPU to append a record, they never contend on a
+ * lock with the other CPUs, and the formatting and the output to the
+ * channels are left to a low priority thread.  The strings arguments are
+ * copied, the formats must remain valid until the message is output (as
+ * the string literals of the debug macros do).
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <sched.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/panic_notifier.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The records are aligned so their header can be accessed in place */
+
+#define SYSLOG_ALIGN         8
+#define SYSLOG_ALIGNUP(n)    (((n) + SYSLOG_ALIGN - 1) & ~(SYSLOG_ALIGN - 1))
+
+#define SYSLOG_BUFSIZE       (CONFIG_SYSLOG_DEFERRED_BUFSIZE & \
+                              ~(SYSLOG_ALIGN - 1))
+#define SYSLOG_MAXRECORD     SYSLOG_ALIGNUP(CONFIG_SYSLOG_DEFERRED_MAXRECORD)
+
+/* Orders the copy of a record against the update of the offsets read by
+ * the other CPUs.  On a single CPU, both sides disable the interrupts.
+ */
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_DMB()       SP_DMB()
+#else
+#  define SYSLOG_DMB()
+#endif
+
+/* The longest conversion specification supported, e.g. "%-+#012.34llx" */
+
+#define SYSLOG_MAXSPEC       24
+
+/* Output one conversion with its '*' width and precision arguments */
+
+#define syslog_replay(stream, conv, spec, stars, value) \
+  ((spec)->nstars == 0 ? lib_sprintf(stream, conv, value) : \
+   (spec)->nstars == 1 ? lib_sprintf(stream, conv, (stars)[0], value) : \
+   lib_sprintf(stream, conv, (stars)[0], (stars)[1], value))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The types of the arguments, as they are promoted when passed */
+
+enum syslog_arg_e
+{
+  SYSLOG_ARG_NONE = 0,        /* "%%" */
+  SYSLOG_ARG_INT,
+  SYSLOG_ARG_LONG,
+  SYSLOG_ARG_LLONG,
+  SYSLOG_ARG_INTMAX,
+  SYSLOG_ARG_SIZE,
+  SYSLOG_ARG_PTRDIFF,
+  SYSLOG_ARG_PTR,
+  SYSLOG_ARG_DOUBLE,
+  SYSLOG_ARG_LDOUBLE,
+  SYSLOG_ARG_STRING           /* Copied, NUL terminated */
+};
+
+/* A conversion specification of a format */
+
+struct syslog_spec_s
+{
+  uint8_t type;               /* See enum syslog_arg_e */
+  uint8_t len;                /* Length of the specification */
+  uint8_t nstars;             /* Number of '*' int arguments */
+  bool    precstar;           /* The precision is the last '*' argument */
+  int     precision;          /* The precision, -1 if none */
+};
+
+/* The header of a record, followed by the arguments.  A zero length marks
+ * the end of the used part of the buffer, the next record is at its start.
+ */
+
+struct syslog_record_s
+{
+  uint16_t len;               /* Length of the record with its arguments */
+  uint8_t priority;           /* Priority of the message */
+  pid_t pid;                  /* Thread which logged the message */
+  unsigned long stamp;        /* up_perf_gettime(), orders the CPUs */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;         /* Time stamp of the message */
+#endif
+  FAR const IPTR char *fmt;   /* Format of the message */
+};
+
+/* The records of one CPU.  Only the CPU appends records, with its
+ * interrupts disabled, and only the consumer holding g_syslog_lock
+ * removes them.
+ */
+
+struct syslog_ring_s
+{
+  volatile unsigned int head; /* Offset of the next record to append */
+  volatile unsigned int tail; /* Offset of the oldest record */
+  volatile unsigned long lost;
+  aligned_data(SYSLOG_ALIGN) uint8_t buffer[SYSLOG_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+
+/* Serializes the consumers:  the syslog thread and syslog_flush() */
+
+static spinlock_t g_syslog_lock;
+
+/* Wakes up the syslog thread, which sets g_syslog_waiting before waiting */
+
+static sem_t g_syslog_sem = SEM_INITIALIZER(0);
+static volatile bool g_syslog_waiting;
+
+/* The messages are output by their caller until the syslog thread runs,
+ * and after a kernel panic.
+ */
+
+static volatile bool g_syslog_running;
+static volatile bool g_syslog_panic;
+
+static struct notifier_block g_syslog_nb;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parse
+ *
+ * Description:
+ *   Parse the conversion specification starting at 'fmt', a '%'.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSYS if the conversion cannot be deferred.
+ *
+ ****************************************************************************/
+
+static int syslog_parse(FAR const char *fmt, FAR struct syslog_spec_s *spec)
+{
+  FAR const char *ptr = fmt + 1;
+  int lmod = 0;
+
+  spec->nstars    = 0;
+  spec->precstar  = false;
+  spec->precision = -1;
+
+  if (*ptr == '%')
+    {
+      spec->type = SYSLOG_ARG_NONE;
+      spec->len  = 2;
+      return OK;
+    }
+
+  /* Flags and width */
+
+  while (*ptr != '\0' && strchr("-+ #0'", *ptr) != NULL)
+    {
+      ptr++;
+    }
+
+  if (*ptr == '*')
+    {
+      spec->nstars++;
+      ptr++;
+    }
+  else
+    {
+      while (isdigit(*ptr))
+        {
+          ptr++;
+        }
+    }
+
+  /* Precision */
+
+  if (*ptr == '.')
+    {
+      ptr++;
+      if (*ptr == '*')
+        {
+          spec->nstars++;
+          spec->precstar = true;
+          ptr++;
+        }
+      else
+        {
+          spec->precision = 0;
+          while (isdigit(*ptr))
+            {
+              spec->precision = spec->precision * 10 + *ptr++ - '0';
+            }
+        }
+    }
+
+  /* Length modifier */
+
+  switch (*ptr)
+    {
+      case 'h':
+        ptr += ptr[1] == 'h' ? 2 : 1;
+        break;
+
+      case 'l':
+        lmod = ptr[1] == 'l' ? SYSLOG_ARG_LLONG : SYSLOG_ARG_LONG;
+        ptr += ptr[1] == 'l' ? 2 : 1;
+        break;
+
+      case 'j':
+        lmod = SYSLOG_ARG_INTMAX;
+        ptr++;
+        break;
+
+      case 'z':
+        lmod = SYSLOG_ARG_SIZE;
+        ptr++;
+        break;
+
+      case 't':
+        lmod = SYSLOG_ARG_PTRDIFF;
+        ptr++;
+        break;
+
+      case 'L':
+        lmod = SYSLOG_ARG_LDOUBLE;
+        ptr++;
+        break;
+    }
+
+  /* Conversion */
+
+  switch (*ptr++)
+    {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c':
+        if (lmod == SYSLOG_ARG_LDOUBLE)
+          {
+            return -ENOSYS;
+          }
+
+        spec->type = lmod != 0 ? lmod : SYSLOG_ARG_INT;
+        break;
+
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec->type = lmod == SYSLOG_ARG_LDOUBLE ?
+                     SYSLOG_ARG_LDOUBLE : SYSLOG_ARG_DOUBLE;
+        break;
+
+      case 's':
+        if (lmod != 0)
+          {
+            return -ENOSYS;
+          }
+
+        spec->type = SYSLOG_ARG_STRING;
+        break;
+
+      case 'p':
+
+        /* The extensions such as %pV dereference their argument */
+
+        if (lmod != 0 || isalpha(*ptr))
+          {
+            return -ENOSYS;
+          }
+
+        spec->type = SYSLOG_ARG_PTR;
+        break;
+
+      default:
+
+        /* %n, wide characters, end of the format... */
+
+        return -ENOSYS;
+    }
+
+  if (ptr - fmt >= SYSLOG_MAXSPEC)
+    {
+      return -ENOSYS;
+    }
+
+  spec->len = ptr - fmt;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_record
+ *
+ * Description:
+ *   Copy the arguments of a message after its header in 'record'.
+ *
+ * Returned Value:
+ *   The length of the record; -ENOSYS if the message cannot be deferred.
+ *
+ ****************************************************************************/
+
+static int syslog_record(FAR uint8_t *record, FAR const char *fmt,
+                         FAR va_list *ap)
+{
+  FAR uint8_t *args = record + sizeof(struct syslog_record_s);
+  FAR uint8_t *end = record + SYSLOG_MAXRECORD;
+  struct syslog_spec_s spec;
+  va_list va;
+  int stars[2];
+  int ret = OK;
+  int i;
+
+  va_copy(va, *ap);
+
+#define SYSLOG_PUSH(type) \
+  do \
+    { \
+      type value_ = va_arg(va, type); \
+      if (end - args < sizeof(type)) \
+        { \
+          ret = -ENOSYS; \
+          goto out; \
+        } \
+      memcpy(args, &value_, sizeof(type)); \
+      args += sizeof(type); \
+    } \
+  while (0)
+
+  while ((fmt = strchr(fmt, '%')) != NULL)
+    {
+      ret = syslog_parse(fmt, &spec);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      fmt += spec.len;
+
+      for (i = 0; i < spec.nstars; i++)
+        {
+          stars[i] = va_arg(va, int);
+          if (end - args < sizeof(int))
+            {
+              ret = -ENOSYS;
+              goto out;
+            }
+
+          memcpy(args, &stars[i], sizeof(int));
+          args += sizeof(int);
+        }
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            SYSLOG_PUSH(int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            SYSLOG_PUSH(long);
+            break;
+
+          case SYSLOG_ARG_LLONG:
+            SYSLOG_PUSH(long long);
+            break;
+
+          case SYSLOG_ARG_INTMAX:
+            SYSLOG_PUSH(intmax_t);
+            break;
+
+          case SYSLOG_ARG_SIZE:
+            SYSLOG_PUSH(size_t);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            SYSLOG_PUSH(ptrdiff_t);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            SYSLOG_PUSH(FAR void *);
+            break;
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            SYSLOG_PUSH(double);
+            break;
+
+          case SYSLOG_ARG_LDOUBLE:
+            SYSLOG_PUSH(long double);
+            break;
+#else
+          case SYSLOG_ARG_DOUBLE:
+          case SYSLOG_ARG_LDOUBLE:
+            ret = -ENOSYS;
+            goto out;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            {
+              FAR const char *str = va_arg(va, FAR const char *);
+              size_t maxlen = end - args;
+              size_t len;
+
+              if (str == NULL)
+                {
+                  str = "(null)";
+                }
+
+              if (spec.precstar && stars[spec.nstars - 1] >= 0)
+                {
+                  maxlen = MIN(maxlen, stars[spec.nstars - 1]);
+                }
+              else if (spec.precision >= 0)
+                {
+                  maxlen = MIN(maxlen, spec.precision);
+                }
+
+              len = strnlen(str, maxlen);
+              if (len >= end - args)
+                {
+                  ret = -ENOSYS;
+                  goto out;
+                }
+
+              memcpy(args, str, len);
+              args[len] = '\0';
+              args += len + 1;
+            }
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  ret = SYSLOG_ALIGNUP(args - record);
+
+#undef SYSLOG_PUSH
+
+out:
+  va_end(va);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_output
+ *
+ * Description:
+ *   Format and output a record of 'cpu'.
+ *
+ ****************************************************************************/
+
+static void syslog_output(FAR const struct syslog_record_s *record, int cpu)
+{
+  FAR const uint8_t *args = (FAR const uint8_t *)(record + 1);
+  FAR const char *fmt = (FAR const char *)record->fmt;
+  struct lib_syslograwstream_s stream;
+  struct syslog_spec_s spec;
+  char conv[SYSLOG_MAXSPEC];
+  struct timespec ts;
+  FAR const char *ptr;
+  int stars[2];
+  int i;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  ts = record->ts;
+#else
+  ts.tv_sec  = 0;
+  ts.tv_nsec = 0;
+#endif
+
+#define SYSLOG_POP(type) \
+  do \
+    { \
+      type value_; \
+      memcpy(&value_, args, sizeof(type)); \
+      args += sizeof(type); \
+      syslog_replay(&stream.public, conv, &spec, stars, value_); \
+    } \
+  while (0)
+
+  lib_syslograwstream_open(&stream);
+  syslog_prefix(&stream.public, record->priority, &ts, cpu, record->pid);
+
+  /* Replay the format, the record was checked when it was appended */
+
+  while (*fmt != '\0')
+    {
+      ptr = strchr(fmt, '%');
+      if (ptr == NULL)
+        {
+          lib_stream_puts(&stream.public, fmt, strlen(fmt));
+          break;
+        }
+
+      if (ptr > fmt)
+        {
+          lib_stream_puts(&stream.public, fmt, ptr - fmt);
+        }
+
+      syslog_parse(ptr, &spec);
+      fmt = ptr + spec.len;
+
+      if (spec.type == SYSLOG_ARG_NONE)
+        {
+          lib_stream_putc(&stream.public, '%');
+          continue;
+        }
+
+      memcpy(conv, ptr, spec.len);
+      conv[spec.len] = '\0';
+
+      for (i = 0; i < spec.nstars; i++)
+        {
+          memcpy(&stars[i], args, sizeof(int));
+          args += sizeof(int);
+        }
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            SYSLOG_POP(int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            SYSLOG_POP(long);
+            break;
+
+          case SYSLOG_ARG_LLONG:
+            SYSLOG_POP(long long);
+            break;
+
+          case SYSLOG_ARG_INTMAX:
+            SYSLOG_POP(intmax_t);
+            break;
+
+          case SYSLOG_ARG_SIZE:
+            SYSLOG_POP(size_t);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            SYSLOG_POP(ptrdiff_t);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            SYSLOG_POP(FAR void *);
+            break;
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            SYSLOG_POP(double);
+            break;
+
+          case SYSLOG_ARG_LDOUBLE:
+            SYSLOG_POP(long double);
+            break;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            syslog_replay(&stream.public, conv, &spec, stars,
+                          (FAR const char *)args);
+            args += strlen((FAR const char *)args) + 1;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+#undef SYSLOG_POP
+
+  syslog_suffix(&stream);
+  lib_syslograwstream_close(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_lost
+ *
+ * Description:
+ *   Report the messages lost by 'cpu' because its buffer was full.
+ *
+ ****************************************************************************/
+
+static void syslog_lost(int cpu, unsigned long lost)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+
+  syslog_timestamp(&ts);
+
+  lib_syslograwstream_open(&stream);
+  syslog_prefix(&stream.public, LOG_WARNING, &ts, cpu, 0);
+  lib_sprintf(&stream.public, "syslog: lost %lu messages\n", lost);
+  syslog_suffix(&stream);
+  lib_syslograwstream_close(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_pop
+ *
+ * Description:
+ *   Remove the oldest record of all CPUs and copy it to 'record'.
+ *
+ * Returned Value:
+ *   The CPU of the record; -ENOENT if there is no record.
+ *
+ ****************************************************************************/
+
+static int syslog_pop(FAR uint8_t *record, FAR unsigned long *lost)
+{
+  FAR struct syslog_record_s *oldest = NULL;
+  FAR struct syslog_record_s *hdr;
+  FAR struct syslog_ring_s *ring;
+  irqstate_t flags = 0;
+  unsigned int tail;
+  int ret = -ENOENT;
+  int cpu;
+
+  /* The other CPUs are stopped (maybe in the middle of a copy) after a
+   * panic, do not wait for their lock.
+   */
+
+  if (!g_syslog_panic)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_syslog_lock);
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ring = &g_syslog_ring[cpu];
+      tail = ring->tail;
+
+      if (tail == ring->head)
+        {
+          continue;
+        }
+
+      hdr = (FAR struct syslog_record_s *)&ring->buffer[tail];
+      if (hdr->len == 0)
+        {
+          /* The producer wrapped around */
+
+          ring->tail = tail = 0;
+          if (tail == ring->head)
+            {
+              continue;
+            }
+
+          hdr = (FAR struct syslog_record_s *)ring->buffer;
+        }
+
+      if (oldest == NULL || (long)(hdr->stamp - oldest->stamp) < 0)
+        {
+          oldest = hdr;
+          ret = cpu;
+        }
+    }
+
+  if (oldest != NULL)
+    {
+      ring = &g_syslog_ring[ret];
+
+      memcpy(record, oldest, oldest->len);
+      SYSLOG_DMB();
+
+      tail = ring->tail + oldest->len;
+      ring->tail = tail >= SYSLOG_BUFSIZE ? 0 : tail;
+
+      *lost = ring->lost;
+      ring->lost = 0;
+    }
+
+  if (!g_syslog_panic)
+    {
+      spin_unlock_irqrestore_wo_note(&g_syslog_lock, flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_drain
+ *
+ * Description:
+ *   Output all of the recorded messages.
+ *
+ ****************************************************************************/
+
+static void syslog_drain(void)
+{
+  aligned_data(SYSLOG_ALIGN) uint8_t record[SYSLOG_MAXRECORD];
+  unsigned long lost;
+  int cpu;
+
+  while ((cpu = syslog_pop(record, &lost)) >= 0)
+    {
+      if (lost > 0)
+        {
+          syslog_lost(cpu, lost);
+        }
+
+      syslog_output((FAR const struct syslog_record_s *)record, cpu);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_pending
+ ****************************************************************************/
+
+static bool syslog_pending(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_syslog_ring[cpu].tail != g_syslog_ring[cpu].head)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: syslog_thread
+ ****************************************************************************/
+
+static int syslog_thread(int argc, FAR char *argv[])
+{
+  g_syslog_running = true;
+
+  for (; ; )
+    {
+      syslog_drain();
+
+      g_syslog_waiting = true;
+      if (!syslog_pending())
+        {
+          nxsem_wait_uninterruptible(&g_syslog_sem);
+        }
+
+      g_syslog_waiting = false;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: syslog_notifier
+ ****************************************************************************/
+
+static int syslog_notifier(FAR struct notifier_block *nb,
+                           unsigned long action, FAR void *data)
+{
+  /* The crash dump is output by its caller, after the messages it
+   * follows.
+   */
+
+  if (action == PANIC_KERNEL)
+    {
+      g_syslog_panic = true;
+    }
+
+  syslog_drain();
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message with its raw arguments in the buffer of this CPU,
+ *   the syslog thread formats and outputs it later.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format of the message, which must remain valid
+ *   ap       - The arguments of the message, not consumed
+ *
+ * Returned Value:
+ *   Zero if the message was recorded; -ENOSPC if it was lost because the
+ *   buffer is full; -ENOSYS if the message cannot be deferred and must be
+ *   output by the caller.
+ *
+ ****************************************************************************/
+
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap)
+{
+  aligned_data(SYSLOG_ALIGN) uint8_t record[SYSLOG_MAXRECORD];
+  FAR struct syslog_record_s *hdr = (FAR struct syslog_record_s *)record;
+  FAR struct syslog_ring_s *ring;
+  irqstate_t flags;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int off;
+  int len;
+
+  if (!g_syslog_running || g_syslog_panic || !OSINIT_OS_READY())
+    {
+      return -ENOSYS;
+    }
+
+  /* Copy the arguments before disabling the interrupts */
+
+  len = syslog_record(record, (FAR const char *)fmt, ap);
+  if (len < 0)
+    {
+      return len;
+    }
+
+  hdr->len      = len;
+  hdr->priority = priority;
+  hdr->pid      = nxsched_gettid();
+  hdr->fmt      = fmt;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  syslog_timestamp(&hdr->ts);
+#endif
+
+  flags = up_irq_save();
+
+  ring = &g_syslog_ring[up_cpu_index()];
+  head = ring->head;
+  tail = ring->tail;
+
+  /* Keep one free byte between head and tail, head == tail is empty */
+
+  if (head >= tail && (SYSLOG_BUFSIZE - head > len ||
+                       (SYSLOG_BUFSIZE - head == len && tail != 0)))
+    {
+      off = head;
+    }
+  else if (head >= tail && tail > len)
+    {
+      /* Mark the end of the used part, continue at the start */
+
+      ((FAR struct syslog_record_s *)&ring->buffer[head])->len = 0;
+      off = 0;
+    }
+  else if (head < tail && tail - head > len)
+    {
+      off = head;
+    }
+  else
+    {
+      ring->lost++;
+      up_irq_restore(flags);
+      return -ENOSPC;
+    }
+
+  hdr->stamp = up_perf_gettime();
+  memcpy(&ring->buffer[off], record, len);
+  SYSLOG_DMB();
+
+  off += len;
+  ring->head = off >= SYSLOG_BUFSIZE ? 0 : off;
+
+  up_irq_restore(flags);
+
+  if (g_syslog_waiting)
+    {
+      g_syslog_waiting = false;
+      nxsem_post(&g_syslog_sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Output the deferred messages in the context of the caller.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  syslog_drain();
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the syslog thread.  The messages are output by their caller
+ *   until then.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int ret;
+
+  g_syslog_nb.notifier_call = syslog_notifier;
+  panic_notifier_chain_register(&g_syslog_nb);
+
+  ret = kthread_create("syslog", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       syslog_thread, NULL);
+  return ret < 0 ? ret : OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -66,6 +66,12 @@ int syslog_flush(void)
 {
   int i;
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Output the messages left to the syslog thread */
+
+  syslog_deferred_flush();
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
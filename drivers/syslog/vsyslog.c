@@ -24,18 +24,32 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 #include <errno.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/init.h>
+#include <nuttx/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
+    defined(CONFIG_SMP) || defined(CONFIG_SYSLOG_PROCESSID) || \
+    defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
+    (CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME))
+#  define SYSLOG_HAVE_PREFIX 1
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -62,55 +76,72 @@ static FAR const char * const g_priority_str[] =
   };
 #endif
 
+#ifdef CONFIG_SYSLOG_STATS
+static struct syslog_stats_s g_syslog_stats[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_stats_add
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Account the cost of one call of nx_vsyslog() to the statistics of
+ *   this CPU.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+#ifdef CONFIG_SYSLOG_STATS
+static void syslog_stats_add(unsigned long start, int ret, bool deferred)
 {
-  struct lib_syslograwstream_s stream;
-  int ret;
-#if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-  struct va_format vaf;
-  vaf.fmt = fmt;
-  vaf.va  = ap;
+  FAR struct syslog_stats_s *stats;
+  FAR struct syslog_cost_s *cost;
+  unsigned long cycles;
+  irqstate_t flags;
 
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
+  cycles = up_perf_gettime() - start;
 
-  lib_syslograwstream_open(&stream);
+  flags = up_irq_save();
+  stats = &g_syslog_stats[up_cpu_index()];
+  cost  = deferred ? &stats->deferred : &stats->sync;
 
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
+  cost->count++;
+  cost->total += cycles;
+  if (cycles > cost->max)
+    {
+      cost->max = cycles;
+    }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
+  if (ret == -ENOSPC)
+    {
+      stats->lost++;
+    }
 
+  up_irq_restore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_timestamp
+ *
+ * Description:
+ *   Return the time stamp of a message, zero if the time is not available
+ *   yet.
+ *
+ ****************************************************************************/
+
+void syslog_timestamp(FAR struct timespec *ts)
+{
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
    * available.
@@ -121,34 +152,68 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, ts);
 #  endif
+    }
+#endif
+}
 
-      /* Prepend the message with the current time, if available */
+/****************************************************************************
+ * Name: syslog_prefix
+ *
+ * Description:
+ *   Output the configured prefix of a message: the time stamp, the CPU,
+ *   the thread, the priority...
+ *
+ * Input Parameters:
+ *   stream   - The stream to output to
+ *   priority - The priority of the message
+ *   ts       - The time stamp of the message, from syslog_timestamp()
+ *   cpu      - The CPU which logged the message
+ *   pid      - The thread which logged the message
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
 
+int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid)
+{
+#ifdef SYSLOG_HAVE_PREFIX
+#  if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
+  FAR struct tcb_s *tcb = nxsched_get_tcb(pid);
+#  endif
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+
+  memset(&tm, 0, sizeof(tm));
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
+    {
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
+      localtime_r(&ts->tv_sec, &tm);
 #    else
-      gmtime_r(&ts.tv_sec, &tm);
+      gmtime_r(&ts->tv_sec, &tm);
 #    endif
-#  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
 #  endif
-#endif
 
-  ret = lib_sprintf(&stream.public,
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+
+  return lib_sprintf(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -199,27 +264,26 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
                     "%s: "
 #endif
-                    "%pV"
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                    , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                    , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                     , date_buf
 #    endif
 #  else
-                    , (uintmax_t)ts.tv_sec, ts.tv_nsec / NSEC_PER_USEC
+                    , (uintmax_t)ts->tv_sec, ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                    , up_cpu_index()
+                    , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                    , (int)nxsched_gettid()
+                    , (int)pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -245,25 +309,153 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
                     , tcb != NULL ? tcb->name : "(null)"
 #endif
+                    );
+#else
+  UNUSED(stream);
+  UNUSED(priority);
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+
+  return 0;
+#endif
+}
 
-  /* Generate the output */
+/****************************************************************************
+ * Name: syslog_suffix
+ *
+ * Description:
+ *   Terminate a message:  add the missing newline and reset the terminal
+ *   style.
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
 
-                    , &vaf);
+int syslog_suffix(FAR struct lib_syslograwstream_s *stream)
+{
+  int ret = 0;
 
-  if (stream.last_ch != '\n')
+  if (stream->last_ch != '\n')
     {
-      lib_stream_putc(&stream.public, '\n');
+      lib_stream_putc(&stream->public, '\n');
       ret++;
     }
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style back to normal. */
 
-  ret += lib_stream_puts(&stream.public, "\e[0m", sizeof("\e[0m"));
+  ret += lib_stream_puts(&stream->public, "\e[0m", sizeof("\e[0m"));
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+  struct va_format vaf;
+  int ret;
+#ifdef CONFIG_SYSLOG_STATS
+  unsigned long start = up_perf_gettime();
+#endif
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting to the syslog thread if possible */
+
+  ret = syslog_deferred(priority, fmt, ap);
+  if (ret != -ENOSYS)
+    {
+#  ifdef CONFIG_SYSLOG_STATS
+      syslog_stats_add(start, ret, true);
+#  endif
+      return ret;
+    }
 #endif
 
+  syslog_timestamp(&ts);
+
+  vaf.fmt = fmt;
+  vaf.va  = ap;
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  ret  = syslog_prefix(&stream.public, priority, &ts, up_cpu_index(),
+                       nxsched_gettid());
+  ret += lib_sprintf(&stream.public, "%pV", &vaf);
+  ret += syslog_suffix(&stream);
+
   /* Flush and destroy the syslog stream buffer */
 
   lib_syslograwstream_close(&stream);
+
+#ifdef CONFIG_SYSLOG_STATS
+  syslog_stats_add(start, ret, false);
+#endif
+
   return ret;
 }
+
+/****************************************************************************
+ * Name: syslog_stats
+ *
+ * Description:
+ *   Return the cost of the calls of nx_vsyslog() summed over all CPUs, and
+ *   optionally reset it.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *   reset - Start counting again from zero
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STATS
+void syslog_stats(FAR struct syslog_stats_s *stats, bool reset)
+{
+  FAR struct syslog_stats_s *cpu;
+  irqstate_t flags;
+  int i;
+
+  memset(stats, 0, sizeof(*stats));
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      cpu = &g_syslog_stats[i];
+
+      stats->sync.count     += cpu->sync.count;
+      stats->sync.total     += cpu->sync.total;
+      stats->sync.max        = MAX(stats->sync.max, cpu->sync.max);
+      stats->deferred.count += cpu->deferred.count;
+      stats->deferred.total += cpu->deferred.total;
+      stats->deferred.max    = MAX(stats->deferred.max, cpu->deferred.max);
+      stats->lost           += cpu->lost;
+
+      if (reset)
+        {
+          memset(cpu, 0, sizeof(*cpu));
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
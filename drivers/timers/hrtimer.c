@@ -0,0 +1,449 @@
+/****************************************************************************
+ * drivers/timers/hrtimer.c
+ *
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/tree.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/timers/hrtimer.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+RB_HEAD(hrtimer_tree_s, hrtimer_s);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR struct hrtimer_s *a, FAR struct hrtimer_s *b);
+static void hrtimer_reprogram(void);
+
+RB_PROTOTYPE_STATIC(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The active timers ordered by expiration time */
+
+static struct hrtimer_tree_s g_hrtimer_tree = RB_INITIALIZER(g_hrtimer_tree);
+
+/* The oneshot timer driving the expirations, or NULL while the system tick
+ * is used through g_hrtimer_wdog.
+ */
+
+static FAR struct oneshot_lowerhalf_s *g_hrtimer_lower;
+static struct wdog_s g_hrtimer_wdog;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+RB_GENERATE_STATIC(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Name: hrtimer_compare
+ *
+ * Description:
+ *   Order timers by expiration time.  Timers expiring at the same time are
+ *   ordered by address so that every node is unique in the tree.
+ *
+ ****************************************************************************/
+
+static int hrtimer_compare(FAR struct hrtimer_s *a, FAR struct hrtimer_s *b)
+{
+  if (a->expired != b->expired)
+    {
+      return a->expired < b->expired ? -1 : 1;
+    }
+
+  if (a != b)
+    {
+      return (uintptr_t)a < (uintptr_t)b ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_clock
+ *
+ * Description:
+ *   Read the hrtimer clock:  the oneshot timer once bound, the system time
+ *   before.
+ *
+ ****************************************************************************/
+
+static uint64_t hrtimer_clock(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+
+  if (lower != NULL)
+    {
+      ONESHOT_CURRENT(lower, &ts);
+    }
+  else
+    {
+      clock_systime_timespec(&ts);
+    }
+
+  return hrtimer_ts2nsec(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_expiry
+ *
+ * Description:
+ *   Run every timer that is due, then reprogram for the next one.
+ *
+ ****************************************************************************/
+
+static void hrtimer_expiry(void)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  hrtentry_t func;
+
+  flags = enter_critical_section();
+
+  while ((timer = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree)) != NULL &&
+         timer->expired <= hrtimer_clock(g_hrtimer_lower))
+    {
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, timer);
+
+      /* Mark the timer inactive first; the callback may restart it */
+
+      func        = timer->func;
+      timer->func = NULL;
+      func(timer->arg);
+    }
+
+  hrtimer_reprogram();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: hrtimer_oneshot_callback
+ ****************************************************************************/
+
+static void hrtimer_oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
+                                     FAR void *arg)
+{
+  hrtimer_expiry();
+}
+
+/****************************************************************************
+ * Name: hrtimer_wdog_callback
+ ****************************************************************************/
+
+static void hrtimer_wdog_callback(wdparm_t arg)
+{
+  hrtimer_expiry();
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the timer hardware (or the fallback watchdog) for the earliest
+ *   active timer.
+ *
+ * Assumptions:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(void)
+{
+  FAR struct oneshot_lowerhalf_s *lower = g_hrtimer_lower;
+  FAR struct hrtimer_s *first;
+  uint64_t now;
+  uint64_t delta;
+
+  first = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+  if (first == NULL)
+    {
+      if (lower != NULL)
+        {
+          ONESHOT_CANCEL(lower, NULL);
+        }
+      else
+        {
+          wd_cancel(&g_hrtimer_wdog);
+        }
+
+      return;
+    }
+
+  now   = hrtimer_clock(lower);
+  delta = first->expired > now ? first->expired - now : 0;
+
+  if (lower != NULL)
+    {
+      struct timespec maxts;
+      struct timespec ts;
+      uint64_t maxdelay;
+
+      /* Never ask for less than one microsecond:  some lower halves treat
+       * a zero delay as "no timeout".  Longer delays than the hardware
+       * supports just expire early and are reprogrammed.
+       */
+
+      ONESHOT_MAX_DELAY(lower, &maxts);
+      maxdelay = hrtimer_ts2nsec(&maxts);
+
+      if (delta < NSEC_PER_USEC)
+        {
+          delta = NSEC_PER_USEC;
+        }
+      else if (maxdelay > 0 && delta > maxdelay)
+        {
+          delta = maxdelay;
+        }
+
+      hrtimer_nsec2ts(delta, &ts);
+      ONESHOT_START(lower, hrtimer_oneshot_callback, NULL, &ts);
+    }
+  else
+    {
+      /* Round up to whole ticks; at least one so that time has passed */
+
+      sclock_t ticks = (delta + NSEC_PER_TICK - 1) / NSEC_PER_TICK;
+
+      wd_start(&g_hrtimer_wdog, ticks > 0 ? ticks : 1,
+               hrtimer_wdog_callback, 0);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_set_lowerhalf
+ *
+ * Description:
+ *   Bind the high resolution timers to a dedicated oneshot timer.  Timers
+ *   started before are moved to the new clock keeping their remaining
+ *   time.
+ *
+ ****************************************************************************/
+
+void hrtimer_set_lowerhalf(FAR struct oneshot_lowerhalf_s *lower)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  uint64_t before;
+  uint64_t after;
+
+  DEBUGASSERT(lower != NULL);
+
+  flags = enter_critical_section();
+
+  wd_cancel(&g_hrtimer_wdog);
+
+  /* Shifting every expiration by the same offset keeps the tree order */
+
+  before = hrtimer_clock(g_hrtimer_lower);
+  after  = hrtimer_clock(lower);
+
+  RB_FOREACH(timer, hrtimer_tree_s, &g_hrtimer_tree)
+    {
+      timer->expired = timer->expired > before ?
+                       timer->expired - before + after : after;
+    }
+
+  g_hrtimer_lower = lower;
+  hrtimer_reprogram();
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: hrtimer_now
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void)
+{
+  return hrtimer_clock(g_hrtimer_lower);
+}
+
+/****************************************************************************
+ * Name: hrtimer_start_abs
+ ****************************************************************************/
+
+int hrtimer_start_abs(FAR struct hrtimer_s *timer, uint64_t expired,
+                      hrtentry_t func, wdparm_t arg)
+{
+  FAR struct hrtimer_s *first;
+  irqstate_t flags;
+
+  if (timer == NULL || func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, timer);
+    }
+
+  first          = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+  timer->expired = expired;
+  timer->func    = func;
+  timer->arg     = arg;
+  RB_INSERT(hrtimer_tree_s, &g_hrtimer_tree, timer);
+
+  /* Only a new earliest timer needs the hardware to be reprogrammed */
+
+  if (first == NULL || hrtimer_compare(timer, first) < 0)
+    {
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer,
+                  FAR const struct timespec *delay,
+                  hrtentry_t func, wdparm_t arg)
+{
+  irqstate_t flags;
+  int ret;
+
+  if (delay == NULL || delay->tv_sec < 0 || delay->tv_nsec < 0 ||
+      delay->tv_nsec >= NSEC_PER_SEC)
+    {
+      return -EINVAL;
+    }
+
+  /* Read the clock within the critical section so that the delay is not
+   * shortened by an interruption.
+   */
+
+  flags = enter_critical_section();
+  ret   = hrtimer_start_abs(timer, hrtimer_now() + hrtimer_ts2nsec(delay),
+                            func, arg);
+  leave_critical_section(flags);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *first;
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  if (timer == NULL)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      first = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+      RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, timer);
+      timer->func = NULL;
+
+      if (timer == first)
+        {
+          hrtimer_reprogram();
+        }
+
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ ****************************************************************************/
+
+void hrtimer_gettime(FAR struct hrtimer_s *timer,
+                     FAR struct timespec *remaining)
+{
+  irqstate_t flags;
+  uint64_t delta = 0;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      now   = hrtimer_now();
+      delta = timer->expired > now ? timer->expired - now : 0;
+    }
+
+  leave_critical_section(flags);
+  hrtimer_nsec2ts(delta, remaining);
+}
+
+/****************************************************************************
+ * Name: hrtimer_nextexpire
+ ****************************************************************************/
+
+uint64_t hrtimer_nextexpire(void)
+{
+  FAR struct hrtimer_s *first;
+  irqstate_t flags;
+  uint64_t delta = UINT64_MAX;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  first = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+  if (first != NULL)
+    {
+      now   = hrtimer_now();
+      delta = first->expired > now ? first->expired - now : 0;
+    }
+
+  leave_critical_section(flags);
+  return delta;
+}
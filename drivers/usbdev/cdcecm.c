@@ -91,6 +91,27 @@
 
 #define CDCECM_TXTIMEOUT (60*CLK_TCK)
 
+/* The function is either an ECM or an NCM one */
+
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_SUBCLASS       CDC_SUBCLASS_NCM
+#  define CDCECM_DATASUBCLASS   CDC_SUBCLASS_NONE
+#  define CDCECM_DATAPROTO      CDC_DATA_PROTO_NCMNTB
+#else
+#  define CDCECM_SUBCLASS       CDC_SUBCLASS_ECM
+#  define CDCECM_DATASUBCLASS   CDC_SUBCLASS_ECM
+#  define CDCECM_DATAPROTO      CDC_PROTO_NONE
+#endif
+
+/* The datagrams and the NDP in the NTBs are aligned to four bytes.  The NDP
+ * of n datagrams is followed by a null entry.
+ */
+
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_NCM_ALIGN(n)   (((n) + 3) & ~3)
+#  define CDCECM_NCM_NDPSIZE(n) SIZEOF_NCM_NDP16((n) + 1)
+#endif
+
 /* This is a helper pointer for accessing the contents of Ethernet header */
 
 #define BUF ((FAR struct eth_hdr_s *)self->dev.d_buf)
@@ -115,8 +136,20 @@ struct cdcecm_driver_s
   FAR struct usbdev_ep_s      *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                      config;      /* Selected configuration number */
 
+#ifdef CONFIG_CDCECM_NCM
+  /* The NTB being built in wrreq.  Frames are copied straight from the
+   * network I/O buffers, so there is no packet buffer.
+   */
+
+  uint32_t                     ntbinsize;   /* Largest NTB to the host */
+  uint16_t                     txseq;       /* Sequence of the next NTB */
+  uint16_t                     txlen;       /* End of the last datagram */
+  uint16_t                     txndg;       /* Datagrams in the NTB */
+  struct cdc_ncm_dpe16_s       txdpe[CONFIG_CDCECM_NCM_MAXDGRAMS];
+#else
   uint16_t                     pktbuf[(CONFIG_NET_ETH_PKTSIZE +
                                        CONFIG_NET_GUARDSIZE + 1) / 2];
+#endif
 
   struct usbdev_req_s         *rdreq;       /* Single read request */
   bool                         rxpending;   /* Packet available in rdreq */
@@ -153,7 +186,13 @@ static int  cdcecm_txpoll(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
+#ifdef CONFIG_CDCECM_NCM
+static bool cdcecm_ncm_full(FAR struct cdcecm_driver_s *priv,
+                            uint16_t len);
+static int  cdcecm_ncm_flush(FAR struct cdcecm_driver_s *priv);
+#endif
 static void cdcecm_reply(struct cdcecm_driver_s *priv);
+static void cdcecm_input(FAR struct cdcecm_driver_s *priv);
 static void cdcecm_receive(FAR struct cdcecm_driver_s *priv);
 static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv);
 
@@ -244,7 +283,7 @@ static const struct usb_devdesc_s g_devdesc =
     MSBYTE(0x0200)
   },
   USB_CLASS_CDC,
-  CDC_SUBCLASS_ECM,
+  CDCECM_SUBCLASS,
   CDC_PROTO_NONE,
   CONFIG_CDCECM_EP0MAXPACKET,
   {
@@ -290,6 +329,51 @@ static const struct usb_devdesc_s g_devdesc =
 
 static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 {
+#ifdef CONFIG_CDCECM_NCM
+  uint16_t offset;
+  int ret;
+
+  /* Send the NTB being built first if the frame does not fit in it */
+
+  if (cdcecm_ncm_full(self, self->dev.d_len))
+    {
+      ret = cdcecm_ncm_flush(self);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* A new NTB needs the write request, and its header comes first */
+
+  if (self->txndg == 0)
+    {
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
+      self->txlen = SIZEOF_NCM_NTH16;
+    }
+
+  NETDEV_TXPACKETS(self->dev);
+
+  /* Append the frame: it is copied from the I/O buffers straight into
+   * the NTB and is sent when the NTB is full or the poll is over.
+   */
+
+  offset = CDCECM_NCM_ALIGN(self->txlen);
+  iob_copyout((FAR uint8_t *)self->wrreq->buf + offset, self->dev.d_iob,
+              self->dev.d_len, -NET_LL_HDRLEN(&self->dev));
+
+  self->txdpe[self->txndg].index[0] = LSBYTE(offset);
+  self->txdpe[self->txndg].index[1] = MSBYTE(offset);
+  self->txdpe[self->txndg].len[0]   = LSBYTE(self->dev.d_len);
+  self->txdpe[self->txndg].len[1]   = MSBYTE(self->dev.d_len);
+  self->txndg++;
+  self->txlen = offset + self->dev.d_len;
+
+  return OK;
+#else
   /* Wait until the USB device request for Ethernet frame transmissions
    * becomes available.
    */
@@ -307,8 +391,106 @@ static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
   memcpy(self->wrreq->buf, self->dev.d_buf, self->dev.d_len);
   self->wrreq->len = self->dev.d_len;
 
+  return EP_SUBMIT(self->epbulkin, self->wrreq);
+#endif
+}
+
+/****************************************************************************
+ * Name: cdcecm_ncm_full
+ *
+ * Description:
+ *   Check if a frame of the given size can't be added to the NTB being
+ *   built.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *   len  - The size of the frame
+ *
+ * Returned Value:
+ *   True if the NTB must be sent first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCECM_NCM
+static bool cdcecm_ncm_full(FAR struct cdcecm_driver_s *self, uint16_t len)
+{
+  if (self->txndg == 0)
+    {
+      return false;
+    }
+
+  return self->txndg >= CONFIG_CDCECM_NCM_MAXDGRAMS ||
+         CDCECM_NCM_ALIGN(CDCECM_NCM_ALIGN(self->txlen) + len) +
+         CDCECM_NCM_NDPSIZE(self->txndg + 1) > self->ntbinsize;
+}
+
+/****************************************************************************
+ * Name: cdcecm_ncm_flush
+ *
+ * Description:
+ *   Complete the NTB being built with its header and its NDP, and send it.
+ *   The NTB is terminated by a zero length packet only if it is shorter
+ *   than the size selected by the host.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcecm_ncm_flush(FAR struct cdcecm_driver_s *self)
+{
+  FAR uint8_t *ntb = self->wrreq->buf;
+  FAR struct cdc_ncm_nth16_s *nth = (FAR struct cdc_ncm_nth16_s *)ntb;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  uint16_t ndpoffset;
+  uint16_t ndplen;
+  uint16_t blklen;
+
+  if (self->txndg == 0)
+    {
+      return OK;
+    }
+
+  ndpoffset = CDCECM_NCM_ALIGN(self->txlen);
+  ndplen    = CDCECM_NCM_NDPSIZE(self->txndg);
+  blklen    = ndpoffset + ndplen;
+
+  ndp = (FAR struct cdc_ncm_ndp16_s *)(ntb + ndpoffset);
+  memcpy(ndp->sig, NCM_NDP16_NOCRC_SIGNATURE, 4);
+  ndp->len[0]  = LSBYTE(ndplen);
+  ndp->len[1]  = MSBYTE(ndplen);
+  ndp->next[0] = 0;
+  ndp->next[1] = 0;
+  memcpy(ndp->dpe, self->txdpe,
+         self->txndg * sizeof(struct cdc_ncm_dpe16_s));
+  memset(&ndp->dpe[self->txndg], 0, sizeof(struct cdc_ncm_dpe16_s));
+
+  memcpy(nth->sig, NCM_NTH16_SIGNATURE, 4);
+  nth->hdrlen[0]   = LSBYTE(SIZEOF_NCM_NTH16);
+  nth->hdrlen[1]   = MSBYTE(SIZEOF_NCM_NTH16);
+  nth->seq[0]      = LSBYTE(self->txseq);
+  nth->seq[1]      = MSBYTE(self->txseq);
+  nth->blklen[0]   = LSBYTE(blklen);
+  nth->blklen[1]   = MSBYTE(blklen);
+  nth->ndpindex[0] = LSBYTE(ndpoffset);
+  nth->ndpindex[1] = MSBYTE(ndpoffset);
+
+  self->txseq++;
+  self->txndg = 0;
+
+  self->wrreq->len   = blklen;
+  self->wrreq->flags = blklen < self->ntbinsize ?
+                       USBDEV_REQFLAGS_NULLPKT : 0;
+
   return EP_SUBMIT(self->epbulkin, self->wrreq);
 }
+#endif
 
 /****************************************************************************
  * Name: cdcecm_txpoll
@@ -347,7 +529,11 @@ static int cdcecm_txpoll(FAR struct net_driver_s *dev)
    * not, return a non-zero value to terminate the poll.
    */
 
+#ifdef CONFIG_CDCECM_NCM
+  return cdcecm_ncm_full(priv, CONFIG_NET_ETH_PKTSIZE);
+#else
   return 1;
+#endif
 }
 
 /****************************************************************************
@@ -384,10 +570,10 @@ static void cdcecm_reply(struct cdcecm_driver_s *priv)
 }
 
 /****************************************************************************
- * Name: cdcecm_receive
+ * Name: cdcecm_input
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Dispatch the received frame in self->dev to the network
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -400,21 +586,8 @@ static void cdcecm_reply(struct cdcecm_driver_s *priv)
  *
  ****************************************************************************/
 
-static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
+static void cdcecm_input(FAR struct cdcecm_driver_s *self)
 {
-  /* Check for errors and update statistics */
-
-  /* Check if the packet is a valid size for the network buffer
-   * configuration.
-   */
-
-  /* Copy the data data from the hardware to self->dev.d_buf.  Set
-   * amount of data in self->dev.d_len
-   */
-
-  memcpy(self->dev.d_buf, self->rdreq->buf, self->rdreq->xfrd);
-  self->dev.d_len = self->rdreq->xfrd;
-
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -479,6 +652,124 @@ static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
     }
 }
 
+/****************************************************************************
+ * Name: cdcecm_receive
+ *
+ * Description:
+ *   An interrupt was received indicating the availability of a new RX packet
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
+{
+#ifdef CONFIG_CDCECM_NCM
+  FAR const uint8_t *ntb = self->rdreq->buf;
+  FAR const struct cdc_ncm_nth16_s *nth;
+  FAR const struct cdc_ncm_ndp16_s *ndp;
+  FAR const struct cdc_ncm_dpe16_s *dpe;
+  uint16_t xfrd = self->rdreq->xfrd;
+  uint16_t ndpoffset;
+  uint16_t ndplen;
+  uint16_t offset;
+  uint16_t len;
+  int ndg;
+
+  nth = (FAR const struct cdc_ncm_nth16_s *)ntb;
+  if (xfrd < SIZEOF_NCM_NTH16 ||
+      memcmp(nth->sig, NCM_NTH16_SIGNATURE, 4) != 0)
+    {
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
+  /* Walk the NDPs of the NTB.  Each one must follow the previous one, so
+   * that a corrupted NTB can't make this loop forever.
+   */
+
+  for (ndpoffset = GETUINT16(nth->ndpindex); ndpoffset != 0;
+       ndpoffset = GETUINT16(ndp->next) > ndpoffset ?
+                   GETUINT16(ndp->next) : 0)
+    {
+      ndp = (FAR const struct cdc_ncm_ndp16_s *)(ntb + ndpoffset);
+      if ((ndpoffset & 3) != 0 ||
+          ndpoffset + SIZEOF_NCM_NDP16(0) > xfrd ||
+          memcmp(ndp->sig, NCM_NDP16_NOCRC_SIGNATURE, 4) != 0)
+        {
+          NETDEV_RXERRORS(&self->dev);
+          return;
+        }
+
+      ndplen = GETUINT16(ndp->len);
+      if (ndplen < SIZEOF_NCM_NDP16(0) || ndpoffset + ndplen > xfrd)
+        {
+          NETDEV_RXERRORS(&self->dev);
+          return;
+        }
+
+      ndg = (ndplen - SIZEOF_NCM_NDP16(0)) / sizeof(*dpe);
+      for (dpe = ndp->dpe; ndg-- > 0; dpe++)
+        {
+          offset = GETUINT16(dpe->index);
+          len    = GETUINT16(dpe->len);
+          if (offset == 0 || len == 0)
+            {
+              break;
+            }
+
+          if (offset + len > xfrd || len > CONFIG_NET_ETH_PKTSIZE)
+            {
+              NETDEV_RXERRORS(&self->dev);
+              continue;
+            }
+
+          /* Copy the datagram straight into the network I/O buffers */
+
+          if (netdev_iob_prepare(&self->dev, false, 0) != OK)
+            {
+              NETDEV_RXDROPPED(&self->dev);
+              return;
+            }
+
+          if (iob_trycopyin(self->dev.d_iob, ntb + offset, len,
+                            -NET_LL_HDRLEN(&self->dev), false) < 0)
+            {
+              NETDEV_RXDROPPED(&self->dev);
+              netdev_iob_release(&self->dev);
+              return;
+            }
+
+          self->dev.d_len = len;
+          cdcecm_input(self);
+          netdev_iob_release(&self->dev);
+        }
+    }
+#else
+  /* Check for errors and update statistics */
+
+  /* Check if the packet is a valid size for the network buffer
+   * configuration.
+   */
+
+  /* Copy the data data from the hardware to self->dev.d_buf.  Set
+   * amount of data in self->dev.d_len
+   */
+
+  memcpy(self->dev.d_buf, self->rdreq->buf, self->rdreq->xfrd);
+  self->dev.d_len = self->rdreq->xfrd;
+
+  cdcecm_input(self);
+#endif
+}
+
 /****************************************************************************
  * Name: cdcecm_txdone
  *
@@ -505,6 +796,10 @@ static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv)
   /* In any event, poll the network for new TX data */
 
   devif_poll(&priv->dev, cdcecm_txpoll);
+
+#ifdef CONFIG_CDCECM_NCM
+  cdcecm_ncm_flush(priv);
+#endif
 }
 
 /****************************************************************************
@@ -543,6 +838,12 @@ static void cdcecm_interrupt_work(FAR void *arg)
     {
       cdcecm_receive(self);
 
+#ifdef CONFIG_CDCECM_NCM
+      /* Send the replies gathered while the NTB was processed */
+
+      cdcecm_ncm_flush(self);
+#endif
+
       flags = enter_critical_section();
       self->rxpending = false;
       EP_SUBMIT(self->epbulkout, self->rdreq);
@@ -690,6 +991,10 @@ static void cdcecm_txavail_work(FAR void *arg)
   if (self->bifup)
     {
       devif_poll(&self->dev, cdcecm_txpoll);
+
+#ifdef CONFIG_CDCECM_NCM
+      cdcecm_ncm_flush(self);
+#endif
     }
 
   net_unlock();
@@ -1146,6 +1451,13 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 
   self->epbulkout->priv = self;
 
+#ifdef CONFIG_CDCECM_NCM
+  /* Start over with the largest NTBs until the host selects a size */
+
+  self->ntbinsize = CONFIG_CDCECM_NCM_NTBSIZE;
+  self->txndg     = 0;
+#endif
+
   /* Queue read requests in the bulk OUT endpoint */
 
   DEBUGASSERT(!self->rxpending);
@@ -1408,7 +1720,7 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       iaddesc->firstif   = devinfo->ifnobase;                   /* Number of first interface of the function */
       iaddesc->nifs      = devinfo->ninterfaces;                /* Number of interfaces associated with the function */
       iaddesc->classid   = USB_CLASS_CDC;                       /* Class code */
-      iaddesc->subclass  = CDC_SUBCLASS_ECM;                    /* Sub-class code */
+      iaddesc->subclass  = CDCECM_SUBCLASS;                     /* Sub-class code */
       iaddesc->protocol  = CDC_PROTO_NONE;                      /* Protocol code */
       iaddesc->ifunction = 0;                                   /* Index to string identifying the function */
 
@@ -1430,7 +1742,7 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 0;
       ifdesc->neps     = 1;
       ifdesc->classid  = USB_CLASS_CDC;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
+      ifdesc->subclass = CDCECM_SUBCLASS;
       ifdesc->protocol = CDC_PROTO_NONE;
       ifdesc->iif      = 0;
 
@@ -1495,6 +1807,25 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
 
   len += SIZEOF_ECM_FUNCDESC;
 
+#ifdef CONFIG_CDCECM_NCM
+  if (desc)
+    {
+      FAR struct cdc_ncm_funcdesc_s *ncmdesc;
+
+      ncmdesc = (FAR struct cdc_ncm_funcdesc_s *)desc;
+      ncmdesc->size       = SIZEOF_NCM_FUNCDESC;
+      ncmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ncmdesc->subtype    = CDC_DSUBTYPE_NCM;
+      ncmdesc->version[0] = LSBYTE(0x0100);
+      ncmdesc->version[1] = MSBYTE(0x0100);
+      ncmdesc->netcaps    = 0;
+
+      desc += SIZEOF_NCM_FUNCDESC;
+    }
+
+  len += SIZEOF_NCM_FUNCDESC;
+#endif
+
   if (desc)
     {
       FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
@@ -1518,8 +1849,8 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 0;
       ifdesc->neps     = 0;
       ifdesc->classid  = USB_CLASS_CDC_DATA;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
-      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->subclass = CDCECM_DATASUBCLASS;
+      ifdesc->protocol = CDCECM_DATAPROTO;
       ifdesc->iif      = 0;
 
       desc += USB_SIZEOF_IFDESC;
@@ -1538,8 +1869,8 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 1;
       ifdesc->neps     = 2;
       ifdesc->classid  = USB_CLASS_CDC_DATA;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
-      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->subclass = CDCECM_DATASUBCLASS;
+      ifdesc->protocol = CDCECM_DATAPROTO;
       ifdesc->iif      = 0;
 
       desc += USB_SIZEOF_IFDESC;
@@ -1577,6 +1908,37 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
   return len;
 }
 
+/****************************************************************************
+ * Name: cdcecm_ncm_ntbparms
+ *
+ * Description:
+ *   Construct the NTB parameter structure returned to GET_NTB_PARAMETERS
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCECM_NCM
+static int cdcecm_ncm_ntbparms(FAR uint8_t *buf)
+{
+  FAR struct cdc_ncm_ntbparms_s *parms = (FAR struct cdc_ncm_ntbparms_s *)buf;
+
+  memset(parms, 0, SIZEOF_NCM_NTBPARMS);
+
+  parms->len[0]          = LSBYTE(SIZEOF_NCM_NTBPARMS);
+  parms->len[1]          = MSBYTE(SIZEOF_NCM_NTBPARMS);
+  parms->formats[0]      = 1;                     /* NTB-16 only */
+  parms->insize[0]       = LSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->insize[1]       = MSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->indivisor[0]    = 4;
+  parms->inalign[0]      = 4;
+  parms->outsize[0]      = LSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->outsize[1]      = MSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->outdivisor[0]   = 4;
+  parms->outalign[0]     = 4;
+
+  return SIZEOF_NCM_NTBPARMS;
+}
+#endif
+
 /****************************************************************************
  * Name: cdcecm_getdescriptor
  *
@@ -1699,10 +2061,16 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
   self->epbulkin->priv  = self;
   self->epbulkout->priv = self;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is one full packet, or
+   * one full NTB.
+   */
 
+#ifdef CONFIG_CDCECM_NCM
+  self->rdreq = cdcecm_allocreq(self->epbulkout, CONFIG_CDCECM_NCM_NTBSIZE);
+#else
   self->rdreq = cdcecm_allocreq(self->epbulkout,
                   CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+#endif
   if (self->rdreq == NULL)
     {
       uerr("Out of memory\n");
@@ -1712,10 +2080,16 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 
   self->rdreq->callback = cdcecm_rdcomplete;
 
-  /* Pre-allocate a single write request.  Buffer size is one full packet. */
+  /* Pre-allocate a single write request.  Buffer size is one full packet,
+   * or one full NTB.
+   */
 
+#ifdef CONFIG_CDCECM_NCM
+  self->wrreq = cdcecm_allocreq(self->epbulkin, CONFIG_CDCECM_NCM_NTBSIZE);
+#else
   self->wrreq = cdcecm_allocreq(self->epbulkin,
                   CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+#endif
   if (self->wrreq == NULL)
     {
       uerr("Out of memory\n");
@@ -1897,6 +2271,63 @@ static int cdcecm_setup(FAR struct usbdevclass_driver_s *driver,
             ret = OK;
             break;
 
+#ifdef CONFIG_CDCECM_NCM
+          case NCM_GET_NTB_PARAMETERS:
+            ret = cdcecm_ncm_ntbparms(self->ctrlreq->buf);
+            break;
+
+          case NCM_GET_NTB_INPUT_SIZE:
+            {
+              FAR uint8_t *buf = self->ctrlreq->buf;
+
+              buf[0] = LSBYTE(self->ntbinsize);
+              buf[1] = MSBYTE(self->ntbinsize);
+              buf[2] = 0;
+              buf[3] = 0;
+              ret    = 4;
+            }
+            break;
+
+          case NCM_SET_NTB_INPUT_SIZE:
+
+            /* The host may ask for NTBs smaller than the ones offered by
+             * GET_NTB_PARAMETERS, but not below the NCM minimum.  NOTE:
+             * not all device controller drivers provide the EP0 OUT data
+             * with the setup command.  The largest size stays in use then.
+             */
+
+            ret = OK;
+            if (dataout != NULL && outlen >= 4)
+              {
+                if (GETUINT32(dataout) < 2048)
+                  {
+                    ret = -EINVAL;
+                  }
+                else
+                  {
+                    self->ntbinsize = MIN(GETUINT32(dataout),
+                                          CONFIG_CDCECM_NCM_NTBSIZE);
+                  }
+              }
+            break;
+
+          case NCM_GET_NTB_FORMAT:
+            {
+              FAR uint8_t *buf = self->ctrlreq->buf;
+
+              /* Only NTB-16 is supported */
+
+              buf[0] = 0;
+              buf[1] = 0;
+              ret    = 2;
+            }
+            break;
+
+          case NCM_SET_NTB_FORMAT:
+            ret = value == 0 ? OK : -EINVAL;
+            break;
+#endif
+
           default:
             uwarn("Unsupported class req: 0x%02hhx\n", ctrl->req);
             break;
@@ -1962,7 +2393,11 @@ static int cdcecm_classobject(int minor,
 
   /* Network device initialization */
 
+#ifdef CONFIG_CDCECM_NCM
+  self->dev.d_buf     = NULL;            /* Frames live in the I/O buffers */
+#else
   self->dev.d_buf     = (uint8_t *)self->pktbuf;
+#endif
   self->dev.d_ifup    = cdcecm_ifup;     /* I/F up (new IP address) callback */
   self->dev.d_ifdown  = cdcecm_ifdown;   /* I/F down callback */
   self->dev.d_txavail = cdcecm_txavail;  /* New TX data callback */
@@ -37,7 +37,11 @@
  ****************************************************************************/
 
 #define CDCECM_VERSIONNO         (0x0100)
-#define CDCECM_MXDESCLEN         (80)
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_MXDESCLEN       (96)
+#else
+#  define CDCECM_MXDESCLEN       (80)
+#endif
 #define CDCECM_MAXSTRLEN         (CDCECM_MXDESCLEN - 2)
 #define CDCECM_NCONFIGS          (1)
 #define CDCECM_NINTERFACES       (2)
@@ -422,6 +422,17 @@ struct usbmsc_dev_s
   uint32_t          residue;          /* Untransferred amount reported in the CSW */
   uint8_t          *iobuffer;         /* Buffer for data transfers */
 
+#ifdef CONFIG_USBMSC_TIMING
+  /* Timing of the current READ/WRITE data phase, in up_perf_gettime()
+   * units
+   */
+
+  unsigned long     tmstart;          /* Start of the data phase, 0 if none */
+  unsigned long     tmmark;           /* Start of the block driver access */
+  unsigned long     tmdisk;           /* Time spent in the block driver */
+  uint32_t          tmsectors;        /* Sectors transferred */
+#endif
+
   /* Write request list */
 
   struct sq_queue_s wrreqlist;        /* List of empty write request containers */
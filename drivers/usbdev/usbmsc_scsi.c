@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -93,6 +94,26 @@
 #  define USBMSC_STALL_RACEWAR 1
 #endif
 
+/* READ/WRITE timing */
+
+#ifdef CONFIG_USBMSC_TIMING
+#  define usbmsc_tmbegin(p) \
+     do { if ((p)->tmstart == 0) (p)->tmstart = up_perf_gettime(); } while (0)
+#  define usbmsc_tmdiskbegin(p) ((p)->tmmark = up_perf_gettime())
+#  define usbmsc_tmdiskend(p,n) \
+     do \
+       { \
+         (p)->tmdisk += up_perf_gettime() - (p)->tmmark; \
+         (p)->tmsectors += (n); \
+       } \
+     while (0)
+#else
+#  define usbmsc_tmbegin(p)
+#  define usbmsc_tmdiskbegin(p)
+#  define usbmsc_tmdiskend(p,n)
+#  define usbmsc_tmreport(p,o)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -168,6 +189,10 @@ static int    usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
+#ifdef CONFIG_USBMSC_TIMING
+static void   usbmsc_tmreport(FAR struct usbmsc_dev_s *priv,
+                              FAR const char *op);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -395,6 +420,36 @@ static int usbmsc_scsi_wait(FAR struct usbmsc_dev_s *priv)
   return ret >= 0 ? ret2 : ret;
 }
 
+/****************************************************************************
+ * Name: usbmsc_tmreport
+ *
+ * Description:
+ *   Report the timing of the READ/WRITE data phase that just ended and
+ *   reset it for the next command.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBMSC_TIMING
+static void usbmsc_tmreport(FAR struct usbmsc_dev_s *priv,
+                            FAR const char *op)
+{
+  struct timespec total;
+  struct timespec disk;
+
+  up_perf_convert(up_perf_gettime() - priv->tmstart, &total);
+  up_perf_convert(priv->tmdisk, &disk);
+
+  uinfo("%s: %" PRIu32 " sectors, total %ld us, block driver %ld us\n",
+        op, priv->tmsectors,
+        (long)(total.tv_sec * 1000000 + total.tv_nsec / 1000),
+        (long)(disk.tv_sec * 1000000 + disk.tv_nsec / 1000));
+
+  priv->tmstart   = 0;
+  priv->tmdisk    = 0;
+  priv->tmsectors = 0;
+}
+#endif
+
 /****************************************************************************
  * Name: usbmsc_cmdtestunitready
  *
@@ -2235,6 +2290,9 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+  uint32_t nsect;
+#endif
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2245,17 +2303,78 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
    * have available.
    */
 
+  usbmsc_tmbegin(priv);
+
   while (priv->u.xfrlen > 0 || priv->nsectbytes > 0)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+      /* Between sectors, read as many of them as fit straight into the next
+       * request and send it.  The read of the next group then overlaps
+       * the transfer of this one.
+       */
+
+      nsect = MIN(priv->u.xfrlen, CONFIG_USBMSC_BULKINREQLEN /
+                                  lun->sectorsize);
+      if (priv->nsectbytes <= 0 && priv->nreqbytes == 0 && nsect > 0)
+        {
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              return -ENOMEM;
+            }
+
+          req = privreq->req;
+
+          usbmsc_tmdiskbegin(priv);
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nsect);
+          usbmsc_tmdiskend(priv, nsect);
+          if (nread < 0)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                       -nread);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          flags = enter_critical_section();
+          sq_remfirst(&priv->wrreqlist);
+          leave_critical_section(flags);
+
+          req->len      = nsect * lun->sectorsize;
+          req->priv     = privreq;
+          req->callback = usbmsc_wrcomplete;
+          req->flags    = 0;
+
+          ret           = EP_SUBMIT(priv->epbulkin, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT),
+                       (uint16_t)-ret);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->residue  -= req->len;
+          priv->u.xfrlen -= nsect;
+          priv->sector   += nsect;
+          continue;
+        }
+#endif
+
       /* Is the I/O buffer empty? */
 
       if (priv->nsectbytes <= 0)
         {
           /* Yes.. read the next sector */
 
+          usbmsc_tmdiskbegin(priv);
           nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+          usbmsc_tmdiskend(priv, 1);
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
@@ -2354,6 +2473,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
   usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREADCMDFINISH),
            priv->u.xfrlen);
+  usbmsc_tmreport(priv, "READ");
   priv->thstate  = USBMSC_STATE_CMDFINISH;
   return OK;
 }
@@ -2401,6 +2521,8 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
    * read requests.
    */
 
+  usbmsc_tmbegin(priv);
+
   while (priv->u.xfrlen > 0)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDWRITE), priv->u.xfrlen);
@@ -2480,8 +2602,10 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
             {
               /* Yes.. Write next sectors */
 
+              usbmsc_tmdiskbegin(priv);
               nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer,
                                            priv->sector, nrbufs);
+              usbmsc_tmdiskend(priv, nrbufs);
               if (nwritten < 0)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
@@ -2501,8 +2625,10 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
             {
               /* Yes.. Write the next sector */
 
+              usbmsc_tmdiskbegin(priv);
               nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer,
                                            priv->sector, 1);
+              usbmsc_tmdiskend(priv, 1);
               if (nwritten < 0)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
@@ -2548,6 +2674,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 errout:
   usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDWRITECMDFINISH),
            priv->u.xfrlen);
+  usbmsc_tmreport(priv, "WRITE");
   priv->thstate  = USBMSC_STATE_CMDFINISH;
   return OK;
 }
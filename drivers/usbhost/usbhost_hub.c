@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -153,6 +154,13 @@ static inline int usbhost_hubdesc(FAR struct usbhost_class_s *hubclass);
 static inline int usbhost_hubpwr(FAR struct usbhost_hubpriv_s *priv,
                                  FAR struct usbhost_hubport_s *hport,
                                  bool on);
+static uint32_t usbhost_hub_debounce(FAR struct usbhost_class_s *hubclass,
+                                     uint32_t ports,
+                                     FAR uint32_t *connected);
+static void usbhost_hub_portconnect(FAR struct usbhost_class_s *hubclass,
+                                    int port);
+static void usbhost_hub_portdisconnect(FAR struct usbhost_hubpriv_s *priv,
+                                       int port);
 static void usbhost_hub_event(FAR void *arg);
 static void usbhost_disconnect_event(FAR void *arg);
 
@@ -662,6 +670,302 @@ static int usbhost_hubpwr(FAR struct usbhost_hubpriv_s *priv,
   return OK;
 }
 
+/****************************************************************************
+ * Name: usbhost_hub_debounce
+ *
+ * Description:
+ *   Wait until the connection state of each of the given ports has been
+ *   stable for 100 milliseconds, or give up after 1.5 seconds.  All of the
+ *   ports are polled at each step, so that devices plugged at the same
+ *   time, or present when the hub is powered, are debounced together.
+ *
+ * Input Parameters:
+ *   hubclass  - The hub class instance
+ *   ports     - Bit set of the port numbers to debounce
+ *   connected - Returns the bit set of the stable ports with a connection
+ *
+ * Returned Value:
+ *   The bit set of the ports that became stable.
+ *
+ ****************************************************************************/
+
+static uint32_t usbhost_hub_debounce(FAR struct usbhost_class_s *hubclass,
+                                     uint32_t ports,
+                                     FAR uint32_t *connected)
+{
+  FAR struct usbhost_hubpriv_s *priv;
+  FAR struct usbhost_hubport_s *hport;
+  FAR struct usb_ctrlreq_s *ctrlreq;
+  struct usb_portstatus_s portstatus;
+  uint16_t debouncestable[USBHUB_MAX_PORTS];
+  uint16_t debouncetime = 0;
+  uint16_t status;
+  uint16_t change;
+  uint32_t connection = 0;
+  uint32_t known = 0;
+  uint32_t stable = 0;
+  uint32_t bit;
+  int port;
+  int ret;
+
+  priv    = &((FAR struct usbhost_hubclass_s *)hubclass)->hubpriv;
+  ctrlreq = priv->ctrlreq;
+  hport   = hubclass->hport;
+
+  memset(debouncestable, 0, sizeof(debouncestable));
+
+  while (ports != 0 && debouncetime < 1500)
+    {
+      for (port = 1; port <= priv->nports; port++)
+        {
+          bit = 1 << port;
+          if ((ports & bit) == 0)
+            {
+              continue;
+            }
+
+          ctrlreq->type = USB_REQ_DIR_IN | USBHUB_REQ_TYPE_PORT;
+          ctrlreq->req  = USBHUB_REQ_GETSTATUS;
+          usbhost_putle16(ctrlreq->value, 0);
+          usbhost_putle16(ctrlreq->index, port);
+          usbhost_putle16(ctrlreq->len, USB_SIZEOF_PORTSTS);
+
+          ret = DRVR_CTRLIN(hport->drvr, hport->ep0, ctrlreq,
+                            (FAR uint8_t *)&portstatus);
+          if (ret < 0)
+            {
+              uerr("ERROR: Failed to get port %d status: %d\n", port, ret);
+              ports &= ~bit;
+              continue;
+            }
+
+          status = usbhost_getle16(portstatus.status);
+          change = usbhost_getle16(portstatus.change);
+
+          if ((change & USBHUB_PORT_STAT_CCONNECTION) == 0 &&
+              (known & bit) != 0 &&
+              ((status & USBHUB_PORT_STAT_CONNECTION) != 0) ==
+              ((connection & bit) != 0))
+            {
+              debouncestable[PORT_INDX(port)] += 25;
+              if (debouncestable[PORT_INDX(port)] >= 100)
+                {
+                  uinfo("Port %d debouncestable=%d\n",
+                        port, debouncestable[PORT_INDX(port)]);
+                  ports  &= ~bit;
+                  stable |= bit;
+                }
+            }
+          else
+            {
+              debouncestable[PORT_INDX(port)] = 0;
+              known |= bit;
+              if ((status & USBHUB_PORT_STAT_CONNECTION) != 0)
+                {
+                  connection |= bit;
+                }
+              else
+                {
+                  connection &= ~bit;
+                }
+            }
+
+          if ((change & USBHUB_PORT_STAT_CCONNECTION) != 0)
+            {
+              ctrlreq->type = USBHUB_REQ_TYPE_PORT;
+              ctrlreq->req  = USBHUB_REQ_CLEARFEATURE;
+              usbhost_putle16(ctrlreq->value, USBHUB_PORT_FEAT_CCONNECTION);
+              usbhost_putle16(ctrlreq->index, port);
+              usbhost_putle16(ctrlreq->len, 0);
+
+              DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
+            }
+        }
+
+      if (ports != 0)
+        {
+          debouncetime += 25;
+          nxsig_usleep(25 * 1000);
+        }
+    }
+
+  if (ports != 0)
+    {
+      uerr("ERROR: Failed to debounce ports %04" PRIx32 "\n", ports);
+    }
+
+  *connected = connection & stable;
+  return stable;
+}
+
+/****************************************************************************
+ * Name: usbhost_hub_portconnect
+ *
+ * Description:
+ *   Reset a hub port with a new connection, then activate it and report
+ *   the new device.
+ *
+ ****************************************************************************/
+
+static void usbhost_hub_portconnect(FAR struct usbhost_class_s *hubclass,
+                                    int port)
+{
+  FAR struct usbhost_hubpriv_s *priv;
+  FAR struct usbhost_hubport_s *hport;
+  FAR struct usbhost_hubport_s *connport;
+  FAR struct usb_ctrlreq_s *ctrlreq;
+  struct usb_portstatus_s portstatus;
+  uint16_t status;
+  uint16_t change;
+  int ret;
+
+  priv    = &((FAR struct usbhost_hubclass_s *)hubclass)->hubpriv;
+  ctrlreq = priv->ctrlreq;
+  hport   = hubclass->hport;
+
+  /* Device connected to a port on the hub */
+
+  uinfo("Connection on port %d\n", port);
+
+  ctrlreq->type = USBHUB_REQ_TYPE_PORT;
+  ctrlreq->req  = USBHUB_REQ_SETFEATURE;
+  usbhost_putle16(ctrlreq->value, USBHUB_PORT_FEAT_RESET);
+  usbhost_putle16(ctrlreq->index, port);
+  usbhost_putle16(ctrlreq->len, 0);
+
+  ret = DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
+  if (ret < 0)
+    {
+      uerr("ERROR: Failed to reset port %d: %d\n", port, ret);
+      return;
+    }
+
+  nxsig_usleep(100 * 1000);
+
+  ctrlreq->type = USB_REQ_DIR_IN | USBHUB_REQ_TYPE_PORT;
+  ctrlreq->req  = USBHUB_REQ_GETSTATUS;
+  usbhost_putle16(ctrlreq->value, 0);
+  usbhost_putle16(ctrlreq->index, port);
+  usbhost_putle16(ctrlreq->len, USB_SIZEOF_PORTSTS);
+
+  ret = DRVR_CTRLIN(hport->drvr, hport->ep0, ctrlreq,
+                    (FAR uint8_t *)&portstatus);
+  if (ret < 0)
+    {
+      uerr("ERROR: Failed to get port %d status: %d\n", port, ret);
+      return;
+    }
+
+  status = usbhost_getle16(portstatus.status);
+  change = usbhost_getle16(portstatus.change);
+
+  uinfo("port %d status %04x change %04x after reset\n",
+        port, status, change);
+
+  if ((status & USBHUB_PORT_STAT_RESET)  != 0 ||
+      (status & USBHUB_PORT_STAT_ENABLE) == 0)
+    {
+      uerr("ERROR: Failed to enable port %d\n", port);
+      return;
+    }
+
+  if ((change & USBHUB_PORT_STAT_CRESET) != 0)
+    {
+      ctrlreq->type = USBHUB_REQ_TYPE_PORT;
+      ctrlreq->req  = USBHUB_REQ_CLEARFEATURE;
+      usbhost_putle16(ctrlreq->value, USBHUB_PORT_FEAT_CRESET);
+      usbhost_putle16(ctrlreq->index, port);
+      usbhost_putle16(ctrlreq->len, 0);
+
+      DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
+    }
+
+  connport = &priv->hport[PORT_INDX(port)];
+  if ((status & USBHUB_PORT_STAT_HIGH_SPEED) != 0)
+    {
+      connport->speed = USB_SPEED_HIGH;
+    }
+  else if ((status & USBHUB_PORT_STAT_LOW_SPEED) != 0)
+    {
+      connport->speed = USB_SPEED_LOW;
+    }
+  else
+    {
+      connport->speed = USB_SPEED_FULL;
+    }
+
+  /* Activate the hub port by assigning it a control endpoint. */
+
+  ret = usbhost_hport_activate(connport);
+  if (ret < 0)
+    {
+      uerr("ERROR: usbhost_hport_activate failed: %d\n", ret);
+    }
+  else
+    {
+      /* Inform waiters that a new device has been connected */
+
+      ret = DRVR_CONNECT(connport->drvr, connport, true);
+      if (ret < 0)
+        {
+          uerr("ERROR: DRVR_CONNECT failed: %d\n", ret);
+          usbhost_hport_deactivate(connport);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: usbhost_hub_portdisconnect
+ *
+ * Description:
+ *   Release the resources of a hub port whose device was disconnected.
+ *
+ ****************************************************************************/
+
+static void usbhost_hub_portdisconnect(FAR struct usbhost_hubpriv_s *priv,
+                                       int port)
+{
+  FAR struct usbhost_hubport_s *connport;
+
+  /* Device disconnected from a port on the hub.  Release port resources. */
+
+  uinfo("Disconnection on port %d\n", port);
+
+  /* Free any devices classes connect on this hub port */
+
+  connport = &priv->hport[PORT_INDX(port)];
+  if (connport->devclass != NULL)
+    {
+      CLASS_DISCONNECTED(connport->devclass);
+
+      if (connport->devclass->connect == usbhost_connect)
+        {
+          /* For hubs, the usbhost_disconnect_event function (triggered by
+           * the CLASS_DISCONNECTED call above) will call
+           * usbhost_hport_deactivate for us. We prevent a crash when a hub
+           * is unplugged by skipping the second unnecessary
+           * usbhost_hport_deactivated call here.
+           */
+
+          connport->devclass = NULL;
+        }
+      else
+        {
+          connport->devclass = NULL;
+
+          /* Free any resources used by the hub port */
+
+          usbhost_hport_deactivate(connport);
+        }
+    }
+  else
+    {
+      /* Free any resources used by the hub port */
+
+      usbhost_hport_deactivate(connport);
+    }
+}
+
 /****************************************************************************
  * Name: usbhost_hub_event
  *
@@ -684,7 +988,6 @@ static void usbhost_hub_event(FAR void *arg)
 {
   FAR struct usbhost_class_s *hubclass;
   FAR struct usbhost_hubport_s *hport;
-  FAR struct usbhost_hubport_s *connport;
   FAR struct usbhost_hubpriv_s *priv;
   FAR struct usb_ctrlreq_s *ctrlreq;
   struct usb_portstatus_s portstatus;
@@ -693,6 +996,8 @@ static void usbhost_hub_event(FAR void *arg)
   uint16_t change;
   uint16_t mask;
   uint16_t feat;
+  uint32_t debounce = 0;
+  uint32_t connected = 0;
   uint8_t statuschange;
   int port;
   int ret;
@@ -787,226 +1092,46 @@ static void usbhost_hub_event(FAR void *arg)
 
       change = usbhost_getle16(portstatus.change);
 
-      /* Handle connect or disconnect, no power management */
+      /* Handle connect or disconnect, no power management.  The ports are
+       * debounced together below.
+       */
 
       if ((change & USBHUB_PORT_STAT_CCONNECTION) != 0)
         {
-          uint16_t debouncetime = 0;
-          uint16_t debouncestable = 0;
-          uint16_t connection = 0xffff;
-
           uinfo("Port %d status %04x change %04x\n", port, status, change);
+          debounce |= 1 << port;
+        }
+      else if (change)
+        {
+          uwarn("WARNING: status %04x change %04x not handled\n",
+                 status, change);
+        }
+    }
 
-          /* Debounce */
-
-          while (debouncetime < 1500)
-            {
-              ctrlreq->type = USB_REQ_DIR_IN | USBHUB_REQ_TYPE_PORT;
-              ctrlreq->req  = USBHUB_REQ_GETSTATUS;
-              usbhost_putle16(ctrlreq->value, 0);
-              usbhost_putle16(ctrlreq->index, port);
-              usbhost_putle16(ctrlreq->len, USB_SIZEOF_PORTSTS);
-
-              ret = DRVR_CTRLIN(hport->drvr, hport->ep0, ctrlreq,
-                                (FAR uint8_t *)&portstatus);
-              if (ret < 0)
-                {
-                  uerr("ERROR: Failed to get port %d status: %d\n",
-                        port, ret);
-                  break;
-                }
-
-              status = usbhost_getle16(portstatus.status);
-              change = usbhost_getle16(portstatus.change);
-
-              if ((change & USBHUB_PORT_STAT_CCONNECTION) == 0 &&
-                  (status & USBHUB_PORT_STAT_CONNECTION)  == connection)
-                {
-                  debouncestable += 25;
-                  if (debouncestable >= 100)
-                    {
-                      uinfo("Port %d debouncestable=%d\n",
-                             port, debouncestable);
-                      break;
-                    }
-                }
-              else
-                {
-                  debouncestable = 0;
-                  connection = status & USBHUB_PORT_STAT_CONNECTION;
-                }
-
-              if ((change & USBHUB_PORT_STAT_CCONNECTION) != 0)
-                {
-                  ctrlreq->type = USBHUB_REQ_TYPE_PORT;
-                  ctrlreq->req  = USBHUB_REQ_CLEARFEATURE;
-                  usbhost_putle16(ctrlreq->value,
-                                  USBHUB_PORT_FEAT_CCONNECTION);
-                  usbhost_putle16(ctrlreq->index, port);
-                  usbhost_putle16(ctrlreq->len, 0);
-
-                  DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
-                }
-
-              debouncetime += 25;
-              nxsig_usleep(25 * 1000);
-            }
-
-          if (ret < 0 || debouncetime >= 1500)
-            {
-              uerr("ERROR: Failed to debounce port %d: %d\n", port, ret);
-              continue;
-            }
-
-          if ((status & USBHUB_PORT_STAT_CONNECTION) != 0)
-            {
-              /* Device connected to a port on the hub */
-
-              uinfo("Connection on port %d\n", port);
-
-              ctrlreq->type = USBHUB_REQ_TYPE_PORT;
-              ctrlreq->req  = USBHUB_REQ_SETFEATURE;
-              usbhost_putle16(ctrlreq->value, USBHUB_PORT_FEAT_RESET);
-              usbhost_putle16(ctrlreq->index, port);
-              usbhost_putle16(ctrlreq->len, 0);
-
-              ret = DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
-              if (ret < 0)
-                {
-                  uerr("ERROR: Failed to reset port %d: %d\n", port, ret);
-                  continue;
-                }
-
-              nxsig_usleep(100 * 1000);
-
-              ctrlreq->type = USB_REQ_DIR_IN | USBHUB_REQ_TYPE_PORT;
-              ctrlreq->req  = USBHUB_REQ_GETSTATUS;
-              usbhost_putle16(ctrlreq->value, 0);
-              usbhost_putle16(ctrlreq->index, port);
-              usbhost_putle16(ctrlreq->len, USB_SIZEOF_PORTSTS);
-
-              ret = DRVR_CTRLIN(hport->drvr, hport->ep0, ctrlreq,
-                                (FAR uint8_t *)&portstatus);
-              if (ret < 0)
-                {
-                  uerr("ERROR: Failed to get port %d status: %d\n",
-                       port, ret);
-                  continue;
-                }
-
-              status = usbhost_getle16(portstatus.status);
-              change = usbhost_getle16(portstatus.change);
-
-              uinfo("port %d status %04x change %04x after reset\n",
-                    port, status, change);
-
-              if ((status & USBHUB_PORT_STAT_RESET)  == 0 &&
-                  (status & USBHUB_PORT_STAT_ENABLE) != 0)
-                {
-                  if ((change & USBHUB_PORT_STAT_CRESET) != 0)
-                    {
-                      ctrlreq->type = USBHUB_REQ_TYPE_PORT;
-                      ctrlreq->req  = USBHUB_REQ_CLEARFEATURE;
-                      usbhost_putle16(ctrlreq->value,
-                                      USBHUB_PORT_FEAT_CRESET);
-                      usbhost_putle16(ctrlreq->index, port);
-                      usbhost_putle16(ctrlreq->len, 0);
-
-                      DRVR_CTRLOUT(hport->drvr, hport->ep0, ctrlreq, NULL);
-                    }
-
-                  connport = &priv->hport[PORT_INDX(port)];
-                  if ((status & USBHUB_PORT_STAT_HIGH_SPEED) != 0)
-                    {
-                      connport->speed = USB_SPEED_HIGH;
-                    }
-                  else if ((status & USBHUB_PORT_STAT_LOW_SPEED) != 0)
-                    {
-                      connport->speed = USB_SPEED_LOW;
-                    }
-                  else
-                    {
-                      connport->speed = USB_SPEED_FULL;
-                    }
-
-                  /* Activate the hub port by assigning it a control
-                   * endpoint.
-                   */
-
-                  ret = usbhost_hport_activate(connport);
-                  if (ret < 0)
-                    {
-                      uerr("ERROR: usbhost_hport_activate failed: %d\n",
-                            ret);
-                    }
-                  else
-                    {
-                      /* Inform waiters that a new device has been
-                       * connected
-                       */
-
-                      ret = DRVR_CONNECT(connport->drvr, connport, true);
-                      if (ret < 0)
-                        {
-                          uerr("ERROR: DRVR_CONNECT failed: %d\n", ret);
-                          usbhost_hport_deactivate(connport);
-                        }
-                    }
-                }
-              else
-                {
-                  uerr("ERROR: Failed to enable port %d\n", port);
-                  continue;
-                }
-            }
-          else
-            {
-              /* Device disconnected from a port on the hub.  Release port
-               * resources.
-               */
-
-              uinfo("Disconnection on port %d\n", port);
+  /* Debounce all of the ports with a connection change at the same time,
+   * then handle them in turn.  The resets stay one at a time:  a device
+   * answers on the default address until it is enumerated.
+   */
 
-              /* Free any devices classes connect on this hub port */
+  if (debounce != 0)
+    {
+      debounce = usbhost_hub_debounce(hubclass, debounce, &connected);
+    }
 
-              connport = &priv->hport[PORT_INDX(port)];
-              if (connport->devclass != NULL)
-                {
-                  CLASS_DISCONNECTED(connport->devclass);
-
-                  if (connport->devclass->connect == usbhost_connect)
-                    {
-                      /* For hubs, the usbhost_disconnect_event function
-                       * (triggered by the CLASS_DISCONNECTED call above)
-                       * will call usbhost_hport_deactivate for us. We
-                       * prevent a crash when a hub is unplugged by skipping
-                       * the second unnecessary usbhost_hport_deactivated
-                       * call here.
-                       */
-
-                      connport->devclass = NULL;
-                    }
-                  else
-                    {
-                      connport->devclass = NULL;
-
-                      /* Free any resources used by the hub port */
-
-                      usbhost_hport_deactivate(connport);
-                    }
-                }
-              else
-                {
-                  /* Free any resources used by the hub port */
+  for (port = 1; port <= priv->nports; port++)
+    {
+      if ((debounce & (1 << port)) == 0)
+        {
+          continue;
+        }
 
-                  usbhost_hport_deactivate(connport);
-                }
-            }
+      if ((connected & (1 << port)) != 0)
+        {
+          usbhost_hub_portconnect(hubclass, port);
         }
-      else if (change)
+      else
         {
-          uwarn("WARNING: status %04x change %04x not handled\n",
-                 status, change);
+          usbhost_hub_portdisconnect(priv, port);
         }
     }
 
@@ -124,6 +124,10 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  sem_t                   asynchsem;    /* Bulk IN asynch transfer done */
+  ssize_t                 asynchresult; /* Result of that transfer */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -179,6 +183,16 @@ static inline int usbhost_testunitready(FAR struct usbhost_state_s *priv);
 static inline int usbhost_requestsense(FAR struct usbhost_state_s *priv);
 static inline int usbhost_readcapacity(FAR struct usbhost_state_s *priv);
 static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv);
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+static void usbhost_asynchcallback(FAR void *arg, ssize_t result);
+static ssize_t usbhost_asynchwait(FAR struct usbhost_state_s *priv,
+                                  FAR uint8_t *buffer, size_t buflen,
+                                  bool cancel);
+#endif
+static ssize_t usbhost_transfer(FAR struct usbhost_state_s *priv,
+                                FAR struct usbmsc_cbw_s *cbw,
+                                FAR uint8_t *buffer, size_t buflen,
+                                bool in);
 
 /* Worker thread actions */
 
@@ -864,6 +878,159 @@ static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv)
   return nbytes < 0 ? (int)nbytes : OK;
 }
 
+/****************************************************************************
+ * Name: usbhost_asynchcallback
+ *
+ * Description:
+ *   Called by the HCD when the asynchronous bulk IN transfer completes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+static void usbhost_asynchcallback(FAR void *arg, ssize_t result)
+{
+  FAR struct usbhost_state_s *priv = (FAR struct usbhost_state_s *)arg;
+
+  priv->asynchresult = result;
+  nxsem_post(&priv->asynchsem);
+}
+
+/****************************************************************************
+ * Name: usbhost_asynchwait
+ *
+ * Description:
+ *   Wait for the asynchronous bulk IN transfer, or cancel it.  Some host
+ *   controllers fail the transfer at once with -EAGAIN if the device NAKs
+ *   it:  it is then repeated synchronously.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_asynchwait(FAR struct usbhost_state_s *priv,
+                                  FAR uint8_t *buffer, size_t buflen,
+                                  bool cancel)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+
+  if (cancel)
+    {
+      DRVR_CANCEL(hport->drvr, priv->bulkin);
+    }
+
+  nxsem_wait_uninterruptible(&priv->asynchsem);
+
+  if (!cancel && priv->asynchresult == -EAGAIN)
+    {
+      return DRVR_TRANSFER(hport->drvr, priv->bulkin, buffer, buflen);
+    }
+
+  return priv->asynchresult;
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_transfer
+ *
+ * Description:
+ *   Send the CBW, transfer the data of the command and receive the CSW in
+ *   priv->tbuffer.  With CONFIG_USBHOST_MSC_ASYNCH, the bulk IN transfer
+ *   of the data (READ) or of the CSW (WRITE) is queued before the bulk OUT
+ *   transfer that precedes it, so that both are outstanding together.
+ *
+ * Input Parameters:
+ *   priv   - The USB mass storage class instance
+ *   cbw    - The command block
+ *   buffer - The data of the command
+ *   buflen - The size of the data
+ *   in     - True if the data is received from the device
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_transfer(FAR struct usbhost_state_s *priv,
+                                FAR struct usbmsc_cbw_s *cbw,
+                                FAR uint8_t *buffer, size_t buflen,
+                                bool in)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  ssize_t nbytes;
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  int ret;
+
+  if (in)
+    {
+      /* Receive the data while the CBW is sent */
+
+      ret = DRVR_ASYNCH(hport->drvr, priv->bulkin, buffer, buflen,
+                        usbhost_asynchcallback, priv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes < 0)
+        {
+          usbhost_asynchwait(priv, buffer, buflen, true);
+          return nbytes;
+        }
+
+      nbytes = usbhost_asynchwait(priv, buffer, buflen, false);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      return DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                           priv->tbuffer, USBMSC_CSW_SIZEOF);
+    }
+
+  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                         (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+  if (nbytes < 0)
+    {
+      return nbytes;
+    }
+
+  /* Wait for the CSW while the data is sent.  The CBW in priv->tbuffer is
+   * not needed anymore.
+   */
+
+  ret = DRVR_ASYNCH(hport->drvr, priv->bulkin, priv->tbuffer,
+                    USBMSC_CSW_SIZEOF, usbhost_asynchcallback, priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout, buffer, buflen);
+  if (nbytes < 0)
+    {
+      usbhost_asynchwait(priv, priv->tbuffer, USBMSC_CSW_SIZEOF, true);
+      return nbytes;
+    }
+
+  return usbhost_asynchwait(priv, priv->tbuffer, USBMSC_CSW_SIZEOF, false);
+#else
+  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                         (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+  if (nbytes >= 0)
+    {
+      nbytes = DRVR_TRANSFER(hport->drvr, in ? priv->bulkin : priv->bulkout,
+                             buffer, buflen);
+      if (nbytes >= 0)
+        {
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                 priv->tbuffer, USBMSC_CSW_SIZEOF);
+        }
+    }
+
+  return nbytes;
+#endif
+}
+
 /****************************************************************************
  * Name: usbhost_destroy
  *
@@ -919,6 +1086,9 @@ static void usbhost_destroy(FAR void *arg)
   /* Destroy the mutex */
 
   nxmutex_destroy(&priv->lock);
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  nxsem_destroy(&priv->asynchsem);
+#endif
 
   /* Disconnect the USB host device */
 
@@ -1701,6 +1871,9 @@ static FAR struct usbhost_class_s *
            */
 
           nxmutex_init(&priv->lock);
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+          nxsem_init(&priv->asynchsem, 0, 0);
+#endif
 
           /* NOTE: We do not yet know the geometry of the USB mass storage
            * device.
@@ -1983,7 +2156,6 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             blkcnt_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes = 0;
   int ret;
 
@@ -1991,7 +2163,6 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %" PRIuOFF " nsectors: %u "
         "sectorsize: %" PRIu16 "\n", startsector, nsectors, priv->blocksize);
@@ -2036,38 +2207,24 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
 
               nbytes = -ENODEV;
 
-              /* Construct and send the CBW */
+              /* Construct and send the CBW, receive the user data and the
+               * CSW.
+               */
 
               usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+              nbytes = usbhost_transfer(priv, cbw, buffer,
+                                        priv->blocksize * nsectors, true);
               if (nbytes >= 0)
                 {
-                  /* Receive the user data */
+                  FAR struct usbmsc_csw_s *csw;
 
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
+                  /* Check the CSW status */
+
+                  csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+                  if (csw->status != 0)
                     {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer,
-                                             USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n",
-                                   csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
+                      uerr("ERROR: CSW status error: %d\n", csw->status);
+                      nbytes = -ENODEV;
                     }
                 }
             }
@@ -2096,7 +2253,6 @@ static ssize_t usbhost_write(FAR struct inode *inode,
                              blkcnt_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes;
   int ret;
 
@@ -2106,7 +2262,6 @@ static ssize_t usbhost_write(FAR struct inode *inode,
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   /* Check if the mass storage device is still connected */
 
@@ -2142,37 +2297,24 @@ static ssize_t usbhost_write(FAR struct inode *inode,
 
           nbytes = -ENODEV;
 
-          /* Construct and send the CBW */
+          /* Construct and send the CBW, send the user data and receive the
+           * CSW.
+           */
 
           usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
-          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+          nbytes = usbhost_transfer(priv, cbw, (FAR uint8_t *)buffer,
+                                    priv->blocksize * nsectors, false);
           if (nbytes >= 0)
             {
-              /* Send the user data */
+              FAR struct usbmsc_csw_s *csw;
 
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)buffer,
-                                     priv->blocksize * nsectors);
-              if (nbytes >= 0)
-                {
-                  /* Receive the CSW */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
-                  if (nbytes >= 0)
-                    {
-                      FAR struct usbmsc_csw_s *csw;
+              /* Check the CSW status */
 
-                      /* Check the CSW status */
-
-                      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                      if (csw->status != 0)
-                        {
-                          uerr("ERROR: CSW status error: %d\n", csw->status);
-                          nbytes = -ENODEV;
-                        }
-                    }
+              csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+              if (csw->status != 0)
+                {
+                  uerr("ERROR: CSW status error: %d\n", csw->status);
+                  nbytes = -ENODEV;
                 }
             }
         }
@@ -41,6 +41,7 @@
 #include <nuttx/random.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 
@@ -52,20 +53,38 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifndef CONFIG_NET_USRSOCKDEV_NREQUESTS
+#  define CONFIG_NET_USRSOCKDEV_NREQUESTS 4
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+struct usrsockdev_req_s
+{
+  FAR const struct iovec *iov;      /* Pending request buffers */
+  int                     iovcnt;   /* Number of request buffers */
+};
+
 struct usrsockdev_s
 {
   mutex_t devlock; /* Lock for device node */
   uint8_t ocount;  /* The number of times the device has been opened */
+  sem_t   reqsem;  /* Free request slots */
   struct
   {
     FAR const struct iovec *iov;    /* Pending request buffers */
     int                     iovcnt; /* Number of request buffers */
     size_t                  pos;    /* Reader position on request buffer */
   } req;
+
+  /* The requests queued behind the one read by the daemon */
+
+  struct usrsockdev_req_s queue[CONFIG_NET_USRSOCKDEV_NREQUESTS];
+  uint8_t qhead;                    /* Index of the oldest queued request */
+  uint8_t qcount;                   /* Number of queued requests */
+
   FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
 };
 
@@ -110,7 +129,9 @@ static const struct file_operations g_usrsockdevops =
 
 static struct usrsockdev_s g_usrsockdev =
 {
-  NXMUTEX_INITIALIZER
+  NXMUTEX_INITIALIZER,
+  0,
+  SEM_INITIALIZER(CONFIG_NET_USRSOCKDEV_NREQUESTS + 1)
 };
 
 /****************************************************************************
@@ -133,6 +154,40 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_nextreq
+ *
+ * Description:
+ *   The daemon is done with the current request, move on to the next one
+ *   queued and release the slot.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_nextreq(FAR struct usrsockdev_s *dev)
+{
+  if (dev->qcount > 0)
+    {
+      FAR struct usrsockdev_req_s *next = &dev->queue[dev->qhead];
+
+      dev->req.iov    = next->iov;
+      dev->req.iovcnt = next->iovcnt;
+      dev->qhead      = (dev->qhead + 1) % CONFIG_NET_USRSOCKDEV_NREQUESTS;
+      dev->qcount--;
+
+      /* Notify daemon of the next request. */
+
+      poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+    }
+  else
+    {
+      dev->req.iov    = NULL;
+      dev->req.iovcnt = 0;
+    }
+
+  dev->req.pos = 0;
+  nxsem_post(&dev->reqsem);
+}
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -274,7 +329,7 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
-  bool req_done = false;
+  ssize_t total = 0;
   ssize_t ret = 0;
 
   if (len == 0)
@@ -299,16 +354,30 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
       return ret;
     }
 
-  ret = usrsock_response(buffer, len, &req_done);
-  if (req_done && dev->req.iov)
+  /* The daemon may write several responses and events at once */
+
+  while (len > 0)
     {
-      dev->req.iov = NULL;
-      dev->req.pos = 0;
-      dev->req.iovcnt = 0;
+      bool req_done = false;
+
+      ret = usrsock_response(buffer, len, &req_done);
+      if (req_done && dev->req.iov)
+        {
+          usrsockdev_nextreq(dev);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      buffer += ret;
+      len    -= ret;
+      total  += ret;
     }
 
   nxmutex_unlock(&dev->devlock);
-  return ret;
+  return total > 0 ? total : ret;
 }
 
 /****************************************************************************
@@ -386,9 +455,13 @@ static int usrsockdev_close(FAR struct file *filep)
   dev->ocount--;
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
-  dev->req.iov = NULL;
-  dev->req.iovcnt = 0;
-  dev->req.pos = 0;
+
+  /* Drop the pending requests, usrsock_abort() wakes up their threads */
+
+  while (dev->req.iov != NULL)
+    {
+      usrsockdev_nextreq(dev);
+    }
 
   nxmutex_unlock(&dev->devlock);
   usrsock_abort();
@@ -508,13 +581,24 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
   FAR struct usrsockdev_s *dev = &g_usrsockdev;
   int ret = 0;
 
+  /* Wait for a free request slot, requests of other connections may be
+   * still pending.
+   */
+
+  net_sem_wait_uninterruptible(&dev->reqsem);
+
   /* Set outstanding request for daemon to handle. */
 
   net_mutex_lock(&dev->devlock);
 
-  if (usrsockdev_is_opened(dev))
+  if (!usrsockdev_is_opened(dev))
+    {
+      ninfo("daemon abruptly closed /dev/usrsock.\n");
+      nxsem_post(&dev->reqsem);
+      ret = -ENETDOWN;
+    }
+  else if (dev->req.iov == NULL)
     {
-      DEBUGASSERT(dev->req.iov == NULL);
       dev->req.iov = iov;
       dev->req.pos = 0;
       dev->req.iovcnt = iovcnt;
@@ -525,8 +609,16 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
     }
   else
     {
-      ninfo("daemon abruptly closed /dev/usrsock.\n");
-      ret = -ENETDOWN;
+      FAR struct usrsockdev_req_s *last;
+
+      /* Queue it behind the request read by the daemon */
+
+      DEBUGASSERT(dev->qcount < CONFIG_NET_USRSOCKDEV_NREQUESTS);
+      last = &dev->queue[(dev->qhead + dev->qcount) %
+                         CONFIG_NET_USRSOCKDEV_NREQUESTS];
+      last->iov    = iov;
+      last->iovcnt = iovcnt;
+      dev->qcount++;
     }
 
   nxmutex_unlock(&dev->devlock);
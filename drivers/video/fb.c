@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -35,12 +36,14 @@
 #include <errno.h>
 #include <poll.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/dma/dma.h>
 
 /****************************************************************************
  * Pre-processor definitions
@@ -48,6 +51,16 @@
 
 #define FB_NO_OVERLAY -1
 
+/* Large reads and writes are copied by DMA, except in the kernel build
+ * where the user buffer is only a virtual address.
+ */
+
+#if defined(CONFIG_DMA_MEMCPY) && !defined(CONFIG_BUILD_KERNEL)
+#  define fb_memcpy dma_memcpy
+#else
+#  define fb_memcpy memcpy
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,6 +81,16 @@ struct fb_chardev_s
   struct wdog_s wdog;             /* VSync offset timer */
 #ifdef CONFIG_FB_OVERLAY
   int overlay;                    /* Overlay number */
+#endif
+#ifdef CONFIG_FB_PANQUEUE
+  struct fb_planeinfo_s panqueue[CONFIG_FB_PANQUEUE_SIZE];
+                                  /* Pans waiting for the vertical sync */
+  uint8_t panhead;                /* Index of the oldest pan */
+  uint8_t pancount;               /* Number of pans queued */
+  fb_coord_t yres;                /* Rows of a buffer in yres_virtual */
+  uint32_t panseq;                /* Number of pans queued so far */
+  uint32_t bufseq[CONFIG_FB_MAXBUFFERS];
+                                  /* panseq of the last pan of each buffer */
 #endif
   mutex_t lock;                  /* Mutual exclusion */
   int16_t crefs;                 /* Number of open references */
@@ -98,6 +121,10 @@ static int     fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
                        bool setup);
 static int     fb_get_panelinfo(FAR struct fb_chardev_s *fb,
                                 FAR struct fb_panelinfo_s *panelinfo);
+#ifdef CONFIG_FB_PANQUEUE
+static int     fb_add_paninfo(FAR struct fb_chardev_s *fb,
+                              FAR const struct fb_planeinfo_s *pinfo);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -249,7 +276,7 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* And transfer the data from the frame buffer */
 
-  memcpy(buffer, panelinfo.fbmem + start, size);
+  fb_memcpy(buffer, panelinfo.fbmem + start, size);
   filep->f_pos += size;
   return size;
 }
@@ -306,7 +333,7 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   /* And transfer the data into the frame buffer */
 
-  memcpy(panelinfo.fbmem + start, buffer, size);
+  fb_memcpy(panelinfo.fbmem + start, buffer, size);
   filep->f_pos += size;
   return size;
 }
@@ -660,13 +687,51 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           FAR struct fb_planeinfo_s *pinfo =
             (FAR struct fb_planeinfo_s *)((uintptr_t)arg);
 
+#ifdef CONFIG_FB_PANQUEUE
+          /* The driver takes the pan at its next vertical sync */
+
+          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL);
+          ret = fb_add_paninfo(fb, pinfo);
+          if (ret >= 0 && fb->vtable->pandisplay != NULL)
+            {
+              ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+            }
+#else
           DEBUGASSERT(pinfo != NULL && fb->vtable != NULL &&
                       fb->vtable->pandisplay != NULL);
           ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+#endif
           fb->pollready = false;
         }
         break;
 
+#ifdef CONFIG_FB_PANQUEUE
+      case FBIOGET_BUFFERAGE:
+        {
+          FAR struct fb_bufferage_s *bufage =
+            (FAR struct fb_bufferage_s *)((uintptr_t)arg);
+          uint32_t index;
+          irqstate_t flags;
+
+          DEBUGASSERT(bufage != NULL);
+          index = bufage->yoffset / fb->yres;
+
+          flags = enter_critical_section();
+          if (index < CONFIG_FB_MAXBUFFERS && fb->bufseq[index] != 0)
+            {
+              bufage->age = fb->panseq - fb->bufseq[index] + 1;
+            }
+          else
+            {
+              bufage->age = 0;
+            }
+
+          leave_critical_section(flags);
+          ret = OK;
+        }
+        break;
+#endif
+
       case FBIO_CLEARNOTIFY:
         {
           fb->pollready = false;
@@ -959,6 +1024,65 @@ static int fb_get_panelinfo(FAR struct fb_chardev_s *fb,
   return OK;
 }
 
+#ifdef CONFIG_FB_PANQUEUE
+/****************************************************************************
+ * Name: fb_add_paninfo
+ *
+ * Description:
+ *   Queue a pan for the driver to show at the next vertical sync, and
+ *   record it for the age of the buffer.
+ *
+ ****************************************************************************/
+
+static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
+                          FAR const struct fb_planeinfo_s *pinfo)
+{
+  struct fb_planeinfo_s plane;
+  uint32_t index;
+  irqstate_t flags;
+  int ret;
+
+  /* The buffer must lie in the virtual resolution of the plane */
+
+  DEBUGASSERT(fb->vtable->getplaneinfo != NULL);
+  memset(&plane, 0, sizeof(plane));
+
+  ret = fb->vtable->getplaneinfo(fb->vtable, fb->plane, &plane);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (pinfo->yoffset + fb->yres > MAX(plane.yres_virtual, fb->yres))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (fb->pancount >= CONFIG_FB_PANQUEUE_SIZE)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      fb->panqueue[(fb->panhead + fb->pancount) %
+                   CONFIG_FB_PANQUEUE_SIZE] = *pinfo;
+      fb->pancount++;
+
+      index = pinfo->yoffset / fb->yres;
+      fb->panseq++;
+      if (index < CONFIG_FB_MAXBUFFERS)
+        {
+          fb->bufseq[index] = fb->panseq;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: fb_do_pollnotify
  ****************************************************************************/
@@ -1014,6 +1138,122 @@ void fb_pollnotify(FAR struct fb_vtable_s *vtable)
     }
 }
 
+#ifdef CONFIG_FB_PANQUEUE
+/****************************************************************************
+ * Name: fb_paninfo_count
+ *
+ * Description:
+ *   Return the number of pans waiting for the driver.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+int fb_paninfo_count(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb;
+
+  DEBUGASSERT(vtable != NULL);
+
+  fb = vtable->priv;
+  return fb != NULL ? fb->pancount : 0;
+}
+
+/****************************************************************************
+ * Name: fb_peek_paninfo
+ *
+ * Description:
+ *   Get the oldest pan queued by FBIOPAN_DISPLAY, for the driver to show at
+ *   the vertical sync.  It stays queued until fb_remove_paninfo().  May be
+ *   called from the interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *   pinfo  - The location to return the plane info of the pan.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if there is no pan queued.
+ *
+ ****************************************************************************/
+
+int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
+                    FAR struct fb_planeinfo_s *pinfo)
+{
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+  int ret = -ENODATA;
+
+  DEBUGASSERT(vtable != NULL && pinfo != NULL);
+
+  fb = vtable->priv;
+  if (fb == NULL)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  if (fb->pancount > 0)
+    {
+      *pinfo = fb->panqueue[fb->panhead];
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fb_remove_paninfo
+ *
+ * Description:
+ *   Release the oldest pan once it is displayed, and notify the waiting
+ *   thread that the framebuffer can be written.  May be called from the
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if there is no pan queued.
+ *
+ ****************************************************************************/
+
+int fb_remove_paninfo(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+  int ret = -ENODATA;
+
+  DEBUGASSERT(vtable != NULL);
+
+  fb = vtable->priv;
+  if (fb == NULL)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  if (fb->pancount > 0)
+    {
+      fb->panhead = (fb->panhead + 1) % CONFIG_FB_PANQUEUE_SIZE;
+      fb->pancount--;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+
+  if (ret == OK)
+    {
+      fb_pollnotify(vtable);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: fb_register
  *
@@ -1097,6 +1337,9 @@ int fb_register(int display, int plane)
     }
 
   nplanes = vinfo.nplanes;
+#ifdef CONFIG_FB_PANQUEUE
+  fb->yres = vinfo.yres;
+#endif
   DEBUGASSERT(vinfo.nplanes > 0 && (unsigned)plane < vinfo.nplanes);
 
   /* Get panel info */
@@ -35,6 +35,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
 
 #include <nuttx/video/imgsensor.h>
 #include <nuttx/video/imgdata.h>
@@ -121,6 +122,9 @@ struct video_type_inf_s
   FAR uint8_t          *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
   FAR struct pollfd    *fds;
   uint32_t             seqnum;
+#ifdef CONFIG_VIDEO_EXPBUF
+  uint8_t              nexported;  /* bufheap buffers exported as fds */
+#endif
 };
 
 typedef struct video_type_inf_s video_type_inf_t;
@@ -136,6 +140,22 @@ struct video_mng_s
 
 typedef struct video_mng_s video_mng_t;
 
+#ifdef CONFIG_VIDEO_EXPBUF
+/* One MMAP buffer exported by VIDIOC_EXPBUF.  It holds the device open
+ * so that the buffer is not freed while the file descriptor is open.
+ */
+
+struct video_dmabuf_s
+{
+  FAR video_mng_t      *vmng;
+  FAR video_type_inf_t *type_inf;
+  FAR uint8_t          *addr;
+  size_t               len;
+};
+
+typedef struct video_dmabuf_s video_dmabuf_t;
+#endif
+
 struct video_scene_params_s
 {
   uint8_t mode;   /* enum v4l2_scene_mode */
@@ -205,6 +225,16 @@ static int video_mmap(FAR struct file *filep,
 static int video_poll(FAR struct file *filep, FAR struct pollfd *fds,
                       bool setup);
 
+#ifdef CONFIG_VIDEO_EXPBUF
+/* Methods of the exported buffers. */
+
+static int video_dmabuf_close(FAR struct file *filep);
+static ssize_t video_dmabuf_read(FAR struct file *filep,
+                                 FAR char *buffer, size_t buflen);
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map);
+#endif
+
 /* Common function */
 
 static FAR video_type_inf_t *
@@ -217,6 +247,7 @@ static void change_video_state(FAR video_mng_t    *vmng,
 static bool is_taking_still_picture(FAR video_mng_t *vmng);
 static bool is_bufsize_sufficient(FAR video_mng_t *vmng, uint32_t bufsize);
 static void cleanup_resources(FAR video_mng_t *vmng);
+static void video_release(FAR video_mng_t *vmng);
 static bool is_sem_waited(FAR sem_t *sem);
 static int save_scene_param(enum v4l2_scene_mode mode,
                             uint32_t id,
@@ -237,6 +268,10 @@ static int video_g_input(FAR int *num);
 static int video_enum_input(FAR struct v4l2_input *input);
 static int video_reqbufs(FAR struct video_mng_s *vmng,
                          FAR struct v4l2_requestbuffers *reqbufs);
+#ifdef CONFIG_VIDEO_EXPBUF
+static int video_expbuf(FAR struct video_mng_s *vmng,
+                        FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf);
 static int video_dqbuf(FAR struct video_mng_s *vmng,
@@ -298,6 +333,31 @@ static const struct file_operations g_video_fops =
   video_poll,               /* poll */
 };
 
+#ifdef CONFIG_VIDEO_EXPBUF
+static const struct file_operations g_video_dmabuf_fops =
+{
+  NULL,                     /* open */
+  video_dmabuf_close,       /* close */
+  video_dmabuf_read,        /* read */
+  NULL,                     /* write */
+  NULL,                     /* seek */
+  NULL,                     /* ioctl */
+  video_dmabuf_mmap,        /* mmap */
+};
+
+static struct inode g_video_dmabuf_inode =
+{
+  NULL,                     /* i_parent */
+  NULL,                     /* i_peer */
+  NULL,                     /* i_child */
+  1,                        /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER,   /* i_flags */
+  {
+    &g_video_dmabuf_fops    /* u */
+  }
+};
+#endif
+
 static bool g_video_initialized = false;
 
 static enum v4l2_scene_mode g_video_scene_mode = V4L2_SCENE_MODE_NONE;
@@ -1054,26 +1114,25 @@ static int video_open(FAR struct file *filep)
   return ret;
 }
 
-static int video_close(FAR struct file *filep)
+static void video_release(FAR video_mng_t *vmng)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR video_mng_t  *priv  = (FAR video_mng_t *)inode->i_private;
-
-  nxmutex_lock(&priv->lock_open_num);
-  if (priv->open_num == 0)
+  nxmutex_lock(&vmng->lock_open_num);
+  if (vmng->open_num > 0 && --vmng->open_num == 0)
     {
-      nxmutex_unlock(&priv->lock_open_num);
-      return OK;
-    }
-
-  if (--priv->open_num == 0)
-    {
-      cleanup_resources(priv);
+      cleanup_resources(vmng);
       IMGSENSOR_UNINIT(g_video_sensor);
       IMGDATA_UNINIT(g_video_data);
     }
 
-  nxmutex_unlock(&priv->lock_open_num);
+  nxmutex_unlock(&vmng->lock_open_num);
+}
+
+static int video_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR video_mng_t  *priv  = (FAR video_mng_t *)inode->i_private;
+
+  video_release(priv);
   return OK;
 }
 
@@ -1172,6 +1231,14 @@ static int video_reqbufs(FAR struct video_mng_s         *vmng,
 
       ret = -EPERM;
     }
+#ifdef CONFIG_VIDEO_EXPBUF
+  else if (type_inf->nexported > 0)
+    {
+      /* The buffers exported as file descriptors are still in use */
+
+      ret = -EBUSY;
+    }
+#endif
   else
     {
       if (reqbufs->count > V4L2_REQBUFS_COUNT_MAX)
@@ -1229,6 +1296,71 @@ static int video_querybuf(FAR struct video_mng_s *vmng,
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_EXPBUF
+static int video_expbuf(FAR struct video_mng_s *vmng,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR video_type_inf_t *type_inf;
+  FAR video_dmabuf_t   *dmabuf;
+  int ret;
+
+  if (vmng == NULL || expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf = kmm_zalloc(sizeof(video_dmabuf_t));
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dmabuf->vmng     = vmng;
+  dmabuf->type_inf = type_inf;
+  dmabuf->len      = get_bufsize(&type_inf->fmt[VIDEO_FMT_MAIN]);
+  dmabuf->addr     = type_inf->bufheap + dmabuf->len * expbuf->index;
+
+  /* The exported buffer counts as one more open of the device, so that
+   * the last close of the device does not free it.
+   */
+
+  nxmutex_lock(&vmng->lock_open_num);
+  if (vmng->open_num == UINT8_MAX || type_inf->nexported == UINT8_MAX)
+    {
+      nxmutex_unlock(&vmng->lock_open_num);
+      kmm_free(dmabuf);
+      return -EMFILE;
+    }
+
+  vmng->open_num++;
+  type_inf->nexported++;
+  nxmutex_unlock(&vmng->lock_open_num);
+
+  ret = file_allocate(&g_video_dmabuf_inode,
+                      O_RDWR | (expbuf->flags & O_CLOEXEC),
+                      0, dmabuf, 0, true);
+  if (ret < 0)
+    {
+      nxmutex_lock(&vmng->lock_open_num);
+      type_inf->nexported--;
+      nxmutex_unlock(&vmng->lock_open_num);
+      video_release(vmng);
+      kmm_free(dmabuf);
+      return ret;
+    }
+
+  expbuf->fd = ret;
+  return OK;
+}
+#endif
+
 static int video_qbuf(FAR struct video_mng_s *vmng,
                       FAR struct v4l2_buffer *buf)
 {
@@ -3028,6 +3160,13 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         break;
 
+#ifdef CONFIG_VIDEO_EXPBUF
+      case VIDIOC_EXPBUF:
+        ret = video_expbuf(priv, (FAR struct v4l2_exportbuffer *)arg);
+
+        break;
+#endif
+
       case VIDIOC_QBUF:
         ret = video_qbuf(priv, (FAR struct v4l2_buffer *)arg);
         break;
@@ -3395,6 +3534,57 @@ static int video_complete_capture(uint8_t err_code, uint32_t datasize,
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_EXPBUF
+static int video_dmabuf_close(FAR struct file *filep)
+{
+  FAR video_dmabuf_t *dmabuf = filep->f_priv;
+  FAR video_mng_t    *vmng   = dmabuf->vmng;
+
+  nxmutex_lock(&vmng->lock_open_num);
+  dmabuf->type_inf->nexported--;
+  nxmutex_unlock(&vmng->lock_open_num);
+
+  kmm_free(dmabuf);
+  video_release(vmng);
+  return OK;
+}
+
+static ssize_t video_dmabuf_read(FAR struct file *filep,
+                                 FAR char *buffer, size_t buflen)
+{
+  FAR video_dmabuf_t *dmabuf = filep->f_priv;
+
+  if (filep->f_pos < 0 || filep->f_pos >= dmabuf->len)
+    {
+      return 0;
+    }
+
+  if (buflen > dmabuf->len - filep->f_pos)
+    {
+      buflen = dmabuf->len - filep->f_pos;
+    }
+
+  memcpy(buffer, dmabuf->addr + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map)
+{
+  FAR video_dmabuf_t *dmabuf = filep->f_priv;
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > dmabuf->len)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = dmabuf->addr + map->offset;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -3425,6 +3615,31 @@ int video_uninitialize(void)
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_EXPBUF
+int video_dmabuf_import(int fd, FAR void **addr, FAR size_t *len)
+{
+  FAR struct file *filep;
+  FAR video_dmabuf_t *dmabuf;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode != &g_video_dmabuf_inode)
+    {
+      return -EBADF;
+    }
+
+  dmabuf = filep->f_priv;
+  *addr  = dmabuf->addr;
+  *len   = dmabuf->len;
+  return OK;
+}
+#endif
+
 int imgsensor_register(FAR struct imgsensor_s *sensor)
 {
   FAR struct imgsensor_s **new_addr;
@@ -516,6 +516,7 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
       return -ENOSYS;
     }
 
+  session->depth  = pixelfmt->depth;
   session->change = true;
   return OK;
 }
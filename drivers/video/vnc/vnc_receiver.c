@@ -469,6 +469,9 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -485,6 +488,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_ZRLE
+      else if (encoding == RFB_ENCODING_ZRLE)
+        {
+          session->zrle = true;
+        }
+#endif
     }
 
   session->change = true;
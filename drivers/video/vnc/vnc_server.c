@@ -124,6 +124,10 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->state   = VNCSERVER_INITIALIZED;
   session->nwhupd  = 0;
   session->change  = true;
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle    = false;
+  session->zstream = false;
+#endif
 
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
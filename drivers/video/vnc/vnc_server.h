@@ -205,8 +205,13 @@ struct vnc_session_s
   uint8_t display;             /* Display number (for debug) */
   volatile uint8_t colorfmt;   /* Remote color format (See include/nuttx/fb.h) */
   volatile uint8_t bpp;        /* Remote bits per pixel */
+  volatile uint8_t depth;      /* Remote color depth */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_ZRLE
+  volatile bool zrle;          /* True: Remote supports ZRLE encoding */
+  bool zstream;                /* True: The zlib stream header was sent */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -464,6 +469,31 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the update rectangle using the ZRLE encoding, one tile per
+ *  rectangle.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if the client does not support the ZRLE encoding.
+ *   Otherwise, the number of bytes sent is returned on success or a negated
+ *   errno value is returned on failure that indicates the nature of the
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
+#else
+#  define vnc_zrle(s,r) 0
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -297,6 +297,54 @@ errout:
   return rect;
 }
 
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Merge a rectangle into a queued update that it overlaps, if covering
+ *   both costs no more pixels than sending them separately.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be merged.
+ *
+ * Returned Value:
+ *   True if the rectangle was merged.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *rect)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  struct fb_area_s merged;
+  fb_coord_t x2;
+  fb_coord_t y2;
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL; curr = curr->flink)
+    {
+      merged.x = MIN(curr->rect.x, rect->x);
+      merged.y = MIN(curr->rect.y, rect->y);
+      x2       = MAX(curr->rect.x + curr->rect.w, rect->x + rect->w);
+      y2       = MAX(curr->rect.y + curr->rect.h, rect->y + rect->h);
+      merged.w = x2 - merged.x;
+      merged.h = y2 - merged.y;
+
+      if ((uint32_t)merged.w * merged.h <=
+          (uint32_t)curr->rect.w * curr->rect.h +
+          (uint32_t)rect->w * rect->h)
+        {
+          updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                  rect->x, rect->y, rect->w, rect->h);
+          curr->rect = merged;
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: vnc_add_queue
  *
@@ -395,9 +443,14 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
+      /* Attempt to use ZRLE encoding, then RRE encoding */
+
+      ret = vnc_zrle(session, &srcrect->rect);
+      if (ret == 0)
+        {
+          ret = vnc_rre(session, &srcrect->rect);
+        }
 
-      ret = vnc_rre(session, &srcrect->rect);
       if (ret == 0)
         {
           /* Perform the framebuffer update using the default RAW encoding */
@@ -647,6 +700,16 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Damage already queued that this update overlaps grows to
+               * cover it rather than the same pixels being sent twice.
+               */
+
+              if (vnc_merge_queue(session, &intersection))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
@@ -0,0 +1,477 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_zrle.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ZRLE_TILESIZE  64  /* ZRLE tiles are 64x64 pixels */
+#define ZRLE_MAXCOLORS 16  /* Largest palette of a packed palette tile */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one ZRLE encoded update.  There is no zlib in the OS, so
+ * the zlib stream is made of stored (uncompressed) deflate blocks, one per
+ * tile.  The bandwidth is saved by the solid and palette tiles.
+ */
+
+struct vnc_zrle_s
+{
+  FAR struct vnc_session_s *session;
+  size_t   nbytes;             /* Number of bytes in session->outbuf */
+  ssize_t  nsent;              /* Total sent, or a negated errno value */
+  uint8_t  colorfmt;           /* The remote color format */
+  uint8_t  cpixel;             /* The size of a CPIXEL in bytes */
+  bool     bigendian;          /* True: The remote expects big-endian */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle_flush
+ *
+ * Description:
+ *   Send the bytes accumulated in the output buffer.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_flush(FAR struct vnc_zrle_s *zrle)
+{
+  FAR const uint8_t *src = zrle->session->outbuf;
+  ssize_t nsent;
+
+  while (zrle->nsent >= 0 && zrle->nbytes > 0)
+    {
+      nsent = psock_send(&zrle->session->connect, src, zrle->nbytes, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send ZRLE FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          zrle->nsent = nsent;
+          break;
+        }
+
+      DEBUGASSERT(nsent <= zrle->nbytes);
+      src          += nsent;
+      zrle->nbytes -= nsent;
+      zrle->nsent  += nsent;
+    }
+
+  zrle->nbytes = 0;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putc
+ ****************************************************************************/
+
+static void vnc_zrle_putc(FAR struct vnc_zrle_s *zrle, uint8_t ch)
+{
+  zrle->session->outbuf[zrle->nbytes++] = ch;
+  if (zrle->nbytes >= VNCSERVER_UPDATE_BUFSIZE)
+    {
+      vnc_zrle_flush(zrle);
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putpixel
+ *
+ * Description:
+ *   Convert a local pixel to the remote color format and output it as a
+ *   CPIXEL.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_putpixel(FAR struct vnc_zrle_s *zrle,
+                              lfb_color_t color)
+{
+  uint32_t pixel;
+  int shift;
+  int i;
+
+  switch (zrle->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        pixel = vnc_convert_rgb8_222(color);
+        break;
+
+      case FB_FMT_RGB8_332:
+        pixel = vnc_convert_rgb8_332(color);
+        break;
+
+      case FB_FMT_RGB16_555:
+        pixel = vnc_convert_rgb16_555(color);
+        break;
+
+      case FB_FMT_RGB16_565:
+        pixel = vnc_convert_rgb16_565(color);
+        break;
+
+      default: /* FB_FMT_RGB32 */
+        pixel = vnc_convert_rgb32_888(color);
+        break;
+    }
+
+  /* A 3 byte CPIXEL holds the least significant bytes of the pixel */
+
+  for (i = 0; i < zrle->cpixel; i++)
+    {
+      shift = zrle->bigendian ? (zrle->cpixel - 1 - i) << 3 : i << 3;
+      vnc_zrle_putc(zrle, (uint8_t)(pixel >> shift));
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_index
+ *
+ * Description:
+ *   Return the index of a color in the palette, or ncolors if it is not
+ *   there.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_index(FAR const lfb_color_t *palette, int ncolors,
+                          lfb_color_t color)
+{
+  int i;
+
+  for (i = 0; i < ncolors; i++)
+    {
+      if (palette[i] == color)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_palette
+ *
+ * Description:
+ *   Collect the colors of a tile.
+ *
+ * Returned Value:
+ *   The number of colors, or ZRLE_MAXCOLORS + 1 if there are more.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_palette(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *tile,
+                            FAR lfb_color_t *palette)
+{
+  FAR const lfb_color_t *src;
+  fb_coord_t x;
+  fb_coord_t y;
+  int ncolors = 0;
+
+  for (y = tile->y; y < tile->y + tile->h; y++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * tile->x);
+
+      for (x = 0; x < tile->w; x++, src++)
+        {
+          if (vnc_zrle_index(palette, ncolors, *src) == ncolors)
+            {
+              if (ncolors == ZRLE_MAXCOLORS)
+                {
+                  return ZRLE_MAXCOLORS + 1;
+                }
+
+              palette[ncolors++] = *src;
+            }
+        }
+    }
+
+  return ncolors;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_tile
+ *
+ * Description:
+ *   Send one tile as a FrameBufferUpdate with one ZRLE rectangle.  The tile
+ *   is sent as a solid tile, a packed palette tile or raw pixels.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_tile(FAR struct vnc_zrle_s *zrle,
+                          FAR const struct fb_area_s *tile)
+{
+  FAR struct vnc_session_s *session = zrle->session;
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR const lfb_color_t *src;
+  lfb_color_t palette[ZRLE_MAXCOLORS];
+  unsigned int bits = 0;
+  unsigned int nbits;
+  uint32_t length;
+  uint8_t byte;
+  fb_coord_t x;
+  fb_coord_t y;
+  int ncolors;
+  int i;
+
+  /* Size the tile data: it is preceded by its length on the wire */
+
+  ncolors = vnc_zrle_palette(session, tile, palette);
+  if (ncolors == 1)
+    {
+      length = 1 + zrle->cpixel;
+    }
+  else if (ncolors <= ZRLE_MAXCOLORS)
+    {
+      bits   = ncolors <= 2 ? 1 : ncolors <= 4 ? 2 : 4;
+      length = 1 + ncolors * zrle->cpixel +
+               tile->h * ((tile->w * bits + 7) >> 3);
+    }
+  else
+    {
+      length = 1 + tile->w * tile->h * zrle->cpixel;
+    }
+
+  DEBUGASSERT(length <= UINT16_MAX);
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, tile->x);
+  rfb_putbe16(update->rect[0].ypos, tile->y);
+  rfb_putbe16(update->rect[0].width, tile->w);
+  rfb_putbe16(update->rect[0].height, tile->h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_ZRLE);
+
+  /* The zlib data: the zlib header at the start of the stream, then a
+   * stored deflate block holding the tile.
+   */
+
+  rfb_putbe32(update->rect[0].data,
+              length + 5 + (session->zstream ? 0 : 2));
+  zrle->nbytes = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0)) +
+                 4;
+
+  if (!session->zstream)
+    {
+      vnc_zrle_putc(zrle, 0x78);
+      vnc_zrle_putc(zrle, 0x01);
+      session->zstream = true;
+    }
+
+  vnc_zrle_putc(zrle, 0);
+  vnc_zrle_putc(zrle, (uint8_t)length);
+  vnc_zrle_putc(zrle, (uint8_t)(length >> 8));
+  vnc_zrle_putc(zrle, (uint8_t)~length);
+  vnc_zrle_putc(zrle, (uint8_t)(~length >> 8));
+
+  /* The tile.  The framebuffer may change under us: pixels that were not
+   * seen when sizing the tile take the first palette entry, and the change
+   * will be sent with the next update.
+   */
+
+  if (ncolors == 1)
+    {
+      vnc_zrle_putc(zrle, RFB_SUBENCODING_SOLID);
+      vnc_zrle_putpixel(zrle, palette[0]);
+    }
+  else if (ncolors <= ZRLE_MAXCOLORS)
+    {
+      vnc_zrle_putc(zrle, (uint8_t)ncolors);
+      for (i = 0; i < ncolors; i++)
+        {
+          vnc_zrle_putpixel(zrle, palette[i]);
+        }
+
+      for (y = tile->y; y < tile->y + tile->h; y++)
+        {
+          src = (FAR const lfb_color_t *)
+            (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * tile->x);
+
+          for (byte = 0, nbits = 0, x = 0; x < tile->w; x++, src++)
+            {
+              i = vnc_zrle_index(palette, ncolors, *src);
+              byte   = (byte << bits) | (i < ncolors ? i : 0);
+              nbits += bits;
+              if (nbits == 8)
+                {
+                  vnc_zrle_putc(zrle, byte);
+                  byte  = 0;
+                  nbits = 0;
+                }
+            }
+
+          if (nbits > 0)
+            {
+              vnc_zrle_putc(zrle, byte << (8 - nbits));
+            }
+        }
+    }
+  else
+    {
+      vnc_zrle_putc(zrle, RFB_SUBENCODING_RAW);
+      for (y = tile->y; y < tile->y + tile->h; y++)
+        {
+          src = (FAR const lfb_color_t *)
+            (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * tile->x);
+
+          for (x = 0; x < tile->w; x++, src++)
+            {
+              vnc_zrle_putpixel(zrle, *src);
+            }
+        }
+    }
+
+  vnc_zrle_flush(zrle);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the update rectangle using the ZRLE encoding, one tile per
+ *  rectangle.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if the client does not support the ZRLE encoding.
+ *   Otherwise, the number of bytes sent is returned on success or a negated
+ *   errno value is returned on failure that indicates the nature of the
+ *   failure.
+ *
+ ****************************************************************************/
+
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
+{
+  struct vnc_zrle_s zrle;
+  struct fb_area_s tile;
+
+  if (!session->zrle)
+    {
+      return 0;
+    }
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.  These can change at any time if a SetPixelFormat is
+   * received asynchronously.
+   */
+
+  zrle.session   = session;
+  zrle.nbytes    = 0;
+  zrle.nsent     = 0;
+  zrle.colorfmt  = session->colorfmt;
+  zrle.bigendian = session->bigendian;
+
+  switch (zrle.colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+      case FB_FMT_RGB8_332:
+        zrle.cpixel = 1;
+        break;
+
+      case FB_FMT_RGB16_555:
+      case FB_FMT_RGB16_565:
+        zrle.cpixel = 2;
+        break;
+
+      case FB_FMT_RGB32:
+        zrle.cpixel = session->depth <= 24 ? 3 : 4;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* Send the tiles left to right, top to bottom.  Stop if the color
+   * format changes, the client asked for a new update then.
+   */
+
+  for (tile.y = rect->y; tile.y < rect->y + rect->h; tile.y += tile.h)
+    {
+      tile.h = MIN(ZRLE_TILESIZE, rect->y + rect->h - tile.y);
+
+      for (tile.x = rect->x; tile.x < rect->x + rect->w; tile.x += tile.w)
+        {
+          tile.w = MIN(ZRLE_TILESIZE, rect->x + rect->w - tile.x);
+
+          if (zrle.colorfmt != session->colorfmt || !session->zrle)
+            {
+              return zrle.nsent > 0 ? zrle.nsent : 1;
+            }
+
+          vnc_zrle_tile(&zrle, &tile);
+          if (zrle.nsent < 0)
+            {
+              return zrle.nsent;
+            }
+        }
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->x, rect->y, rect->w, rect->h);
+  return zrle.nsent > 0 ? zrle.nsent : 1;
+}
+
+#endif /* CONFIG_VNCSERVER_ZRLE */
@@ -33,6 +33,7 @@
 
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/aio.h>
 
 #ifdef CONFIG_FS_AIO
 
@@ -58,12 +59,17 @@
  */
 
 struct file;
+struct aio_device_s;
 struct aio_container_s
 {
   dq_entry_t aioc_link;            /* Supports a doubly linked list */
+  dq_entry_t aioc_dlink;           /* Link in the queue of the device */
   FAR struct aiocb *aioc_aiocbp;   /* The contained AIO control block */
   FAR struct file *aioc_filep;     /* File structure to use with the I/O */
-  struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  FAR struct aio_device_s *aioc_dev; /* Device queue, NULL once started */
+  worker_t aioc_worker;            /* Performs the I/O */
+  struct work_s aioc_work;         /* Used to defer the completion */
+  struct aio_request_s aioc_req;   /* Transfer handed to the driver */
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -206,11 +212,13 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Queue the asynchronous I/O on the context of its device.  Requests to
+ *   one device are started in submission order; the contexts of different
+ *   devices run concurrently on the low priority work queue threads.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO container of the request
+ *   worker - The function that performs the I/O, called with aioc
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -220,6 +228,45 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a request that has not been started yet from the queue of its
+ *   device.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container of the request
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it was already
+ *   started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Offer a read or write to the driver through FIOC_AIOSTART.  Drivers
+ *   that can complete transfers asynchronously (e.g. by DMA) accept the
+ *   request and call aio_complete() later; the worker thread does not
+ *   block on the transfer then.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container of the request
+ *   opcode - LIO_READ or LIO_WRITE
+ *
+ * Returned Value:
+ *   Zero (OK) if the driver accepted the request.  A negated errno value
+ *   if the transfer has to be performed synchronously.
+ *
+ ****************************************************************************/
+
+int aio_start(FAR struct aio_container_s *aioc, int opcode);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * fs/aio/aio_complete.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/aio.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_complete_worker
+ *
+ * Description:
+ *   Finish a request completed by its driver:  free the container and
+ *   signal the client.
+ *
+ * Input Parameters:
+ *   arg - Worker argument.  In this case, a pointer to the AIO container.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void aio_complete_worker(FAR void *arg)
+{
+  FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
+  FAR struct aiocb *aiocbp;
+  pid_t pid;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  uint8_t prio;
+#endif
+
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+  pid    = aioc->aioc_pid;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  prio   = aioc->aioc_prio;
+#endif
+  aiocbp = aioc_decant(aioc);
+
+  /* Signal the client */
+
+  aio_signal(pid, aiocbp);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* Restore the low priority worker thread default priority */
+
+  lpwork_restorepriority(prio);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Offer a read or write to the driver through FIOC_AIOSTART.  Drivers
+ *   that can complete transfers asynchronously (e.g. by DMA) accept the
+ *   request and call aio_complete() later; the worker thread does not
+ *   block on the transfer then.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container of the request
+ *   opcode - LIO_READ or LIO_WRITE
+ *
+ * Returned Value:
+ *   Zero (OK) if the driver accepted the request.  A negated errno value
+ *   if the transfer has to be performed synchronously.
+ *
+ ****************************************************************************/
+
+int aio_start(FAR struct aio_container_s *aioc, int opcode)
+{
+  int ret;
+
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+
+  aioc->aioc_req.aiocbp = aioc->aioc_aiocbp;
+  aioc->aioc_req.opcode = opcode;
+
+  ret = file_ioctl(aioc->aioc_filep, FIOC_AIOSTART,
+                   (unsigned long)(uintptr_t)&aioc->aioc_req);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   Report the completion of a request accepted through FIOC_AIOSTART.
+ *   This function may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   req    - The request passed to FIOC_AIOSTART
+ *   result - The number of bytes transferred or a negated errno value
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_complete(FAR struct aio_request_s *req, ssize_t result)
+{
+  FAR struct aio_container_s *aioc =
+    container_of(req, struct aio_container_s, aioc_req);
+
+  DEBUGASSERT(req->aiocbp == aioc->aioc_aiocbp);
+
+  if (result < 0)
+    {
+      ferr("ERROR: asynchronous transfer failed: %zd\n", result);
+    }
+
+  req->aiocbp->aio_result = result;
+
+  /* Signalling the client may not be done from an interrupt handler */
+
+  DEBUGVERIFY(work_queue(LPWORK, &aioc->aioc_work, aio_complete_worker,
+                         aioc, 0));
+}
+
+#endif /* CONFIG_FS_AIO */
@@ -65,6 +65,7 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+  FAR struct file *filep;
   int ret;
 
   /* Get the information from the container, decant the AIO control block,
@@ -77,11 +78,12 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
+  filep  = aioc->aioc_filep;
   aiocbp = aioc_decant(aioc);
 
   /* Perform the fsync using aioc_filep */
 
-  ret = file_fsync(aioc->aioc_filep);
+  ret = file_fsync(filep);
   if (ret < 0)
     {
       ferr("ERROR: file_fsync failed: %d\n", ret);
@@ -30,25 +30,94 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/nuttx.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The I/O context of one device.  A context exists while requests are
+ * queued for its device; its work is scheduled exactly as long.
+ */
+
+struct aio_device_s
+{
+  dq_entry_t link;                 /* Link in g_aio_devices */
+  FAR struct inode *inode;         /* The device or file of the requests */
+  dq_queue_t queue;                /* Requests that were not started yet */
+  struct work_s work;              /* Starts the requests of the queue */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The contexts of all devices with queued requests, under aio_lock() */
+
+static dq_queue_t g_aio_devices;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_device_worker
+ *
+ * Description:
+ *   Start all queued requests of one device, one after the other.  All the
+ *   requests submitted while the context is busy are handled in this one
+ *   batch.  The context is freed once its queue is empty.
+ *
+ ****************************************************************************/
+
+static void aio_device_worker(FAR void *arg)
+{
+  FAR struct aio_device_s *dev = (FAR struct aio_device_s *)arg;
+  FAR struct aio_container_s *aioc;
+  FAR dq_entry_t *entry;
+
+  for (; ; )
+    {
+      aio_lock();
+      entry = dq_remfirst(&dev->queue);
+      if (entry == NULL)
+        {
+          dq_rem(&dev->link, &g_aio_devices);
+          aio_unlock();
+          kmm_free(dev);
+          return;
+        }
+
+      aioc = container_of(entry, struct aio_container_s, aioc_dlink);
+      aioc->aioc_dev = NULL;
+      aio_unlock();
+
+      aioc->aioc_worker(aioc);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Queue the asynchronous I/O on the context of its device.  Requests to
+ *   one device are started in submission order; the contexts of different
+ *   devices run concurrently on the low priority work queue threads.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO container of the request
+ *   worker - The function that performs the I/O, called with aioc
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -58,6 +127,8 @@
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
+  FAR struct inode *inode = aioc->aioc_filep->f_inode;
+  FAR struct aio_device_s *dev;
   int ret;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -72,27 +143,109 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   lpwork_boostpriority(aioc->aioc_prio);
 #endif
 
+  ret = aio_lock();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Find the context of the device or create it */
+
+  for (dev = (FAR struct aio_device_s *)g_aio_devices.head;
+       dev != NULL && dev->inode != inode;
+       dev = (FAR struct aio_device_s *)dev->link.flink);
+
+  aioc->aioc_worker = worker;
+  if (dev != NULL)
+    {
+      /* The work of the context is already scheduled or running */
+
+      aioc->aioc_dev = dev;
+      dq_addlast(&aioc->aioc_dlink, &dev->queue);
+      aio_unlock();
+      goto out;
+    }
+
+  dev = kmm_zalloc(sizeof(struct aio_device_s));
+  if (dev == NULL)
+    {
+      aio_unlock();
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  dev->inode     = inode;
+  aioc->aioc_dev = dev;
+  dq_addlast(&aioc->aioc_dlink, &dev->queue);
+
   /* Schedule the work on the low priority worker thread */
 
-  ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+  ret = work_queue(LPWORK, &dev->work, aio_device_worker, dev, 0);
   if (ret < 0)
     {
-      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
-      DEBUGASSERT(aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-      lpwork_restorepriority(aioc->aioc_prio);
-#endif
-      aiocbp->aio_result = ret;
-      set_errno(-ret);
-      ret = ERROR;
+      aioc->aioc_dev = NULL;
+      aio_unlock();
+      kmm_free(dev);
+      goto errout;
     }
 
+  dq_addlast(&dev->link, &g_aio_devices);
+  aio_unlock();
+
+out:
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Now the low-priority work queue might run at its new priority */
 
   sched_unlock();
 #endif
+  return OK;
+
+errout:
+  aioc->aioc_aiocbp->aio_result = ret;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  lpwork_restorepriority(aioc->aioc_prio);
+  sched_unlock();
+#endif
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a request that has not been started yet from the queue of its
+ *   device.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container of the request
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it was already
+ *   started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  int ret = -EBUSY;
+
+  aio_lock();
+  if (aioc->aioc_dev != NULL)
+    {
+      /* The context frees itself when it finds its queue empty */
+
+      dq_rem(&aioc->aioc_dlink, &aioc->aioc_dev->queue);
+      aioc->aioc_dev = NULL;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      lpwork_restorepriority(aioc->aioc_prio);
+#endif
+      ret = OK;
+    }
+
+  aio_unlock();
   return ret;
 }
 
@@ -65,18 +65,28 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+  FAR struct file *filep;
   ssize_t nread = 0;
 
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+
+  /* Let the driver complete the transfer asynchronously if it can */
+
+  if (aio_start(aioc, LIO_READ) >= 0)
+    {
+      return;
+    }
+
   /* Get the information from the container, decant the AIO control block,
    * and free the container before starting any I/O.  That will minimize
    * the delays by any other threads waiting for a pre-allocated container.
    */
 
-  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
+  filep  = aioc->aioc_filep;
   aiocbp = aioc_decant(aioc);
 
   /* Perform the file read using:
@@ -87,7 +97,7 @@ static void aio_read_worker(FAR void *arg)
    *   aio_offset   - File offset
    */
 
-  nread = file_pread(aioc->aioc_filep, (FAR void *)aiocbp->aio_buf,
+  nread = file_pread(filep, (FAR void *)aiocbp->aio_buf,
                      aiocbp->aio_nbytes, aiocbp->aio_offset);
 
   /* Set the result of the read operation. */
@@ -67,24 +67,36 @@ static void aio_write_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+  FAR struct file *filep;
   ssize_t nwritten = 0;
   int oflags;
 
+  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+
+  /* Call fcntl(F_GETFL) to get the file open mode. */
+
+  filep  = aioc->aioc_filep;
+  oflags = file_fcntl(filep, F_GETFL);
+
+  /* Let the driver complete a positioned write asynchronously if it can */
+
+  if (oflags >= 0 && (oflags & O_APPEND) == 0 &&
+      aio_start(aioc, LIO_WRITE) >= 0)
+    {
+      return;
+    }
+
   /* Get the information from the container, decant the AIO control block,
    * and free the container before starting any I/O.  That will minimize
    * the delays by any other threads waiting for a pre-allocated container.
    */
 
-  DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
   aiocbp = aioc_decant(aioc);
 
-  /* Call fcntl(F_GETFL) to get the file open mode. */
-
-  oflags = file_fcntl(aioc->aioc_filep, F_GETFL);
   if (oflags < 0)
     {
       ferr("ERROR: file_fcntl failed: %d\n", oflags);
@@ -106,13 +118,13 @@ static void aio_write_worker(FAR void *arg)
     {
       /* Append to the current file position */
 
-      nwritten = file_write(aioc->aioc_filep,
+      nwritten = file_write(filep,
                             (FAR const void *)aiocbp->aio_buf,
                             aiocbp->aio_nbytes);
     }
   else
     {
-      nwritten = file_pwrite(aioc->aioc_filep,
+      nwritten = file_pwrite(filep,
                              (FAR const void *)aiocbp->aio_buf,
                              aiocbp->aio_nbytes,
                              aiocbp->aio_offset);
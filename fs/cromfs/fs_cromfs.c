@@ -39,8 +39,11 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/cromfs.h>
 
 #include "cromfs.h"
 
@@ -67,10 +70,39 @@ struct cromfs_dir_s
 
 struct cromfs_file_s
 {
-  FAR const struct cromfs_node_s *ff_node;  /* The open file node */
-  uint32_t ff_offset;                       /* Cached block offset (zero means none) */
-  uint16_t ff_ulen;                         /* Length of decompressed data in cache */
-  FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+  FAR const struct cromfs_node_s *ff_node;   /* The open file node */
+  FAR const struct lzf_header_s *ff_blkhdr;  /* Block of the last read */
+  uint32_t ff_blkoffs;                       /* Its offset in the file */
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  off_t ff_nextpos;                          /* Where a sequential read goes */
+#endif
+};
+
+/* A decompressed block, shared by all of the open files of a mount */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;                        /* Block offset, zero if none */
+  uint32_t cc_stamp;                         /* Time of last use, for the LRU */
+  FAR uint8_t *cc_buffer;                    /* Decompressed data */
+};
+
+/* This structure represents a mounted CROMFS file system, the mountpoint
+ * private data.
+ */
+
+struct cromfs_mount_s
+{
+  FAR const struct cromfs_volume_s *cm_vol;  /* The image */
+  mutex_t cm_lock;                           /* Protects the cache */
+  uint32_t cm_stamp;                         /* Last cc_stamp given */
+  struct cromfs_cache_s cm_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+  struct cromfs_stats_s cm_stats;            /* Cache statistics */
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  struct work_s cm_work;                     /* Read-ahead work */
+  FAR const struct lzf_header_s *cm_rahdr;   /* Block to read ahead */
+  bool cm_rabusy;                            /* cm_work is queued */
+#endif
 };
 
 /* This is the form of the callback from cromfs_foreach_node(): */
@@ -131,6 +163,21 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                   FAR const char *relpath,
                   FAR struct cromfs_nodeinfo_s *info,
                   FAR uint32_t *offset);
+static FAR const struct lzf_header_s *
+                cromfs_next_block(FAR const struct lzf_header_s *hdr,
+                  FAR uint16_t *ulen, FAR uint16_t *clen);
+static FAR struct cromfs_cache_s *
+                cromfs_cache_find(FAR struct cromfs_mount_s *cm,
+                  uint32_t voloffs);
+static FAR struct cromfs_cache_s *
+                cromfs_cache_fill(FAR struct cromfs_mount_s *cm,
+                  FAR const uint8_t *src, uint16_t clen, uint16_t ulen,
+                  uint32_t voloffs);
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void     cromfs_readahead_worker(FAR void *arg);
+static void     cromfs_readahead(FAR struct cromfs_mount_s *cm,
+                  FAR const struct lzf_header_s *hdr);
+#endif
 
 /* Common file system methods */
 
@@ -718,6 +765,182 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_next_block
+ *
+ * Description:
+ *   Return the uncompressed and compressed sizes of a block, and the
+ *   address of the block that follows it.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_next_block(FAR const struct lzf_header_s *hdr, FAR uint16_t *ulen,
+                  FAR uint16_t *clen)
+{
+  uint32_t blksize;
+
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen   = (uint16_t)hdr0->lzf_len[0] << 8 |
+                (uint16_t)hdr0->lzf_len[1];
+      *clen   = *ulen;
+      blksize = (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen   = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+                (uint16_t)hdr1->lzf_ulen[1];
+      *clen   = (uint16_t)hdr1->lzf_clen[0] << 8 |
+                (uint16_t)hdr1->lzf_clen[1];
+      blksize = (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+
+  return (FAR const struct lzf_header_s *)
+         ((FAR const uint8_t *)hdr + blksize);
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_find
+ *
+ * Description:
+ *   Return the cache entry holding the block whose compressed data is at
+ *   offset voloffs in the image, or NULL.  Called with cm_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *
+cromfs_cache_find(FAR struct cromfs_mount_s *cm, uint32_t voloffs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct cromfs_cache_s *entry = &cm->cm_cache[i];
+
+      if (entry->cc_offset == voloffs)
+        {
+          entry->cc_stamp = ++cm->cm_stamp;
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_fill
+ *
+ * Description:
+ *   Decompress a block into the least recently used cache entry.  Called
+ *   with cm_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *
+cromfs_cache_fill(FAR struct cromfs_mount_s *cm, FAR const uint8_t *src,
+                  uint16_t clen, uint16_t ulen, uint32_t voloffs)
+{
+  FAR struct cromfs_cache_s *entry = &cm->cm_cache[0];
+  int i;
+
+  for (i = 1; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (cm->cm_cache[i].cc_stamp < entry->cc_stamp)
+        {
+          entry = &cm->cm_cache[i];
+        }
+    }
+
+  if (lzf_decompress(src, clen, entry->cc_buffer, cm->cm_vol->cv_bsize) !=
+      ulen)
+    {
+      entry->cc_offset = 0;
+      entry->cc_stamp  = 0;
+      return NULL;
+    }
+
+  entry->cc_offset = voloffs;
+  entry->cc_stamp  = ++cm->cm_stamp;
+  return entry;
+}
+
+/****************************************************************************
+ * Name: cromfs_readahead_worker
+ *
+ * Description:
+ *   Decompress the block queued by cromfs_readahead() into the cache, on
+ *   the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_readahead_worker(FAR void *arg)
+{
+  FAR struct cromfs_mount_s *cm = arg;
+  FAR const uint8_t *src;
+  uint32_t voloffs;
+  uint16_t ulen;
+  uint16_t clen;
+
+  nxmutex_lock(&cm->cm_lock);
+
+  cromfs_next_block(cm->cm_rahdr, &ulen, &clen);
+  src     = (FAR const uint8_t *)cm->cm_rahdr + LZF_TYPE1_HDR_SIZE;
+  voloffs = cromfs_addr2offset(cm->cm_vol, src);
+
+  /* A reader may have got to the block first */
+
+  if (cromfs_cache_find(cm, voloffs) == NULL &&
+      cromfs_cache_fill(cm, src, clen, ulen, voloffs) != NULL)
+    {
+      cm->cm_stats.cs_readaheads++;
+    }
+
+  cm->cm_rabusy = false;
+  nxmutex_unlock(&cm->cm_lock);
+}
+
+/****************************************************************************
+ * Name: cromfs_readahead
+ *
+ * Description:
+ *   Queue the decompression of a block into the cache if it is compressed
+ *   and not there yet.  Called with cm_lock held.
+ *
+ ****************************************************************************/
+
+static void cromfs_readahead(FAR struct cromfs_mount_s *cm,
+                             FAR const struct lzf_header_s *hdr)
+{
+  FAR const uint8_t *src;
+
+  if (cm->cm_rabusy || hdr->lzf_type != LZF_TYPE1_HDR)
+    {
+      return;
+    }
+
+  src = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  if (cromfs_cache_find(cm, cromfs_addr2offset(cm->cm_vol, src)) != NULL)
+    {
+      return;
+    }
+
+  cm->cm_rahdr  = hdr;
+  cm->cm_rabusy = true;
+  if (work_queue(LPWORK, &cm->cm_work, cromfs_readahead_worker, cm, 0) < 0)
+    {
+      cm->cm_rabusy = false;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -743,9 +966,8 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
    */
 
   inode = filep->f_inode;
-  fs    = inode->i_private;
-
-  DEBUGASSERT(fs != NULL);
+  DEBUGASSERT(inode->i_private != NULL);
+  fs    = ((FAR struct cromfs_mount_s *)inode->i_private)->cm_vol;
 
   /* CROMFS is read-only.  Any attempt to open with any kind of write
    * access is not permitted.
@@ -786,15 +1008,6 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      kmm_free(ff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   ff->ff_node = (FAR const struct cromfs_node_s *)
@@ -820,11 +1033,10 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
   kmm_free(ff);
 
   return OK;
@@ -838,19 +1050,23 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
                            size_t buflen)
 {
   FAR struct inode *inode;
+  FAR struct cromfs_mount_s *cm;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  FAR const struct lzf_header_s *currhdr;
+  FAR const struct lzf_header_s *nexthdr;
+  FAR struct cromfs_cache_s *entry;
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
   size_t remaining;
   uint32_t blkoffs;
+  uint32_t voloffs;
   uint16_t ulen;
   uint16_t clen;
   unsigned int copysize;
   unsigned int copyoffs;
+  int ret;
 
   finfo("Read %zu bytes from offset %jd\n", buflen, (intmax_t)filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -860,13 +1076,14 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
    */
 
   inode = filep->f_inode;
-  fs    = inode->i_private;
-  DEBUGASSERT(fs != NULL);
+  cm    = inode->i_private;
+  DEBUGASSERT(cm != NULL);
+  fs    = cm->cm_vol;
 
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -887,15 +1104,39 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
+  if (buflen == 0)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&cm->cm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Find the compressed block containing the current offset, f_pos.  The
+   * search starts from the block of the previous read unless the file
+   * position moved back before it.
+   */
 
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
   ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  clen      = 0;
+
+  if (ff->ff_blkhdr != NULL && fpos >= ff->ff_blkoffs)
+    {
+      nexthdr = ff->ff_blkhdr;
+      blkoffs = ff->ff_blkoffs;
+    }
+  else
+    {
+      nexthdr = (FAR const struct lzf_header_s *)
+                 cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+      blkoffs = 0;
+    }
 
   /* Look until we find the compressed block containing the start of the
    * requested data.
@@ -906,47 +1147,24 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       /* Search for the next block containing the fpos file offset.  This is
        * real search on the first time through but the remaining blocks
        * should be contiguous so that the logic should not loop.
-       *
        */
 
       do
         {
-          uint32_t blksize;
-
-          /* Go to the next block */
-
           currhdr  = nexthdr;
           blkoffs += ulen;
-
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+          nexthdr  = cromfs_next_block(currhdr, &ulen, &clen);
         }
       while (fpos >= (blkoffs + ulen));
 
-      /* Check if we need to decompress the next block into the user
-       * buffer.
-       */
+      copyoffs = fpos - blkoffs;
+      DEBUGASSERT(ulen > copyoffs);
+      copysize = ulen - copyoffs;
+
+      if (copysize > remaining)  /* Clip to the size really needed */
+        {
+          copysize = remaining;
+        }
 
       if (currhdr->lzf_type == LZF_TYPE0_HDR)
         {
@@ -954,15 +1172,6 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
            * user buffer.
            */
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
-
-          if (copysize > remaining)  /* Clip to the size really needed */
-            {
-              copysize = remaining;
-            }
-
           src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
           memcpy(dest, &src[copyoffs], copysize);
 
@@ -971,84 +1180,52 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
+          /* Get the offset in the CROMFS image of the compressed data and
+           * check if it is already decompressed in the cache.
            */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
-            {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
+          src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          voloffs = cromfs_addr2offset(fs, src);
+          entry   = cromfs_cache_find(cm, voloffs);
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
+          if (entry == NULL && copyoffs == 0 && copysize == ulen)
+            {
+              /* The whole block is wanted:  decompress it directly into the
+               * user buffer.
                */
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              cm->cm_stats.cs_misses++;
+              if (lzf_decompress(src, clen, dest, ulen) != ulen)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  ret = -EIO;
+                  break;
                 }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
             }
           else
             {
-              uint32_t voloffs;
+              /* No, we will need to go through the cache */
 
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
+              if (entry == NULL)
                 {
-                  copysize = remaining;
+                  cm->cm_stats.cs_misses++;
+                  entry = cromfs_cache_fill(cm, src, clen, ulen, voloffs);
+                  if (entry == NULL)
+                    {
+                      ret = -EIO;
+                      break;
+                    }
                 }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              else
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  cm->cm_stats.cs_hits++;
                 }
 
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
-                    "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
-                    copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+              memcpy(dest, &entry->cc_buffer[copyoffs], copysize);
             }
+
+          finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
+                " clen=%" PRIu16 " copyoffs=%u copysize=%u\n",
+                voloffs, blkoffs, ulen, clen, copyoffs, copysize);
         }
 
       /* Adjust pointers counts and offset */
@@ -1058,6 +1235,30 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+  /* Remember the last block for the next read */
+
+  ff->ff_blkhdr  = currhdr;
+  ff->ff_blkoffs = blkoffs;
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* Decompress the next block ahead of a sequential reader */
+
+  if (ret >= 0 && filep->f_pos == ff->ff_nextpos &&
+      blkoffs + ulen < ff->ff_node->cn_size)
+    {
+      cromfs_readahead(cm, nexthdr);
+    }
+
+  ff->ff_nextpos = fpos;
+#endif
+
+  nxmutex_unlock(&cm->cm_lock);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
@@ -1070,11 +1271,32 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct cromfs_mount_s *cm;
+  FAR struct cromfs_stats_s *stats;
+  int ret;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands yet supported */
+  if (cmd != FIOC_CROMFSSTATS)
+    {
+      return -ENOTTY;
+    }
+
+  stats = (FAR struct cromfs_stats_s *)((uintptr_t)arg);
+  if (stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+  cm  = filep->f_inode->i_private;
+  ret = nxmutex_lock(&cm->cm_lock);
+  if (ret >= 0)
+    {
+      *stats = cm->cm_stats;
+      nxmutex_unlock(&cm->cm_lock);
+    }
 
-  return -ENOTTY;
+  return ret;
 }
 
 /****************************************************************************
@@ -1087,7 +1309,6 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
-  FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
 
@@ -1095,15 +1316,10 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
               newp->f_priv == NULL && newp->f_inode != NULL);
 
-  /* Recover our private data from the struct file instance */
-
-  fs = (FAR struct cromfs_volume_s *)oldp->f_inode->i_private;
-  DEBUGASSERT(fs != NULL);
-
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1115,15 +1331,6 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      kmm_free(newff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   newff->ff_node = oldff->ff_node;
@@ -1146,7 +1353,8 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 {
   FAR struct inode *inode;
-  FAR struct cromfs_volume_s *fs;
+  FAR struct cromfs_mount_s *cm;
+  FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
   uint32_t fsize;
   uint32_t bsize;
@@ -1160,10 +1368,11 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
-  fs              = inode->i_private;
+  cm              = inode->i_private;
+  fs              = cm->cm_vol;
 
   /* Return the stat info */
 
@@ -1206,7 +1415,7 @@ static int cromfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Recover our private data from the inode instance */
 
-  fs = mountpt->i_private;
+  fs = ((FAR struct cromfs_mount_s *)mountpt->i_private)->cm_vol;
 
   /* Locate the node for this relative path */
 
@@ -1283,7 +1492,7 @@ static int cromfs_readdir(FAR struct inode *mountpt,
 
   /* Recover our private data from the inode instance */
 
-  fs = mountpt->i_private;
+  fs = ((FAR struct cromfs_mount_s *)mountpt->i_private)->cm_vol;
   cdir = (FAR struct cromfs_dir_s *)dir;
 
   /* Have we reached the end of the directory */
@@ -1417,14 +1626,37 @@ static int cromfs_rewinddir(FAR struct inode *mountpt,
 static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
                       void **handle)
 {
+  FAR struct cromfs_mount_s *cm;
+  FAR uint8_t *buffer;
+  int i;
+
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
 
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+  /* Allocate the mountpoint private data and the block cache with it */
+
+  cm = kmm_zalloc(sizeof(struct cromfs_mount_s) +
+                  CONFIG_FS_CROMFS_CACHE_NBLOCKS * g_cromfs_image.cv_bsize);
+  if (cm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cm->cm_vol = &g_cromfs_image;
+  nxmutex_init(&cm->cm_lock);
+
+  buffer = (FAR uint8_t *)(cm + 1);
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      cm->cm_cache[i].cc_buffer = buffer;
+      buffer += g_cromfs_image.cv_bsize;
+    }
+
   /* Return the new file system handle */
 
-  *handle = (FAR void *)&g_cromfs_image;
+  *handle = cm;
   return OK;
 }
 
@@ -1439,8 +1671,31 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                         unsigned int flags)
 {
+  FAR struct cromfs_mount_s *cm = handle;
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* The read-ahead work may have been started already */
+
+  nxmutex_lock(&cm->cm_lock);
+  if (cm->cm_rabusy)
+    {
+      if (work_cancel(LPWORK, &cm->cm_work) < 0)
+        {
+          nxmutex_unlock(&cm->cm_lock);
+          return -EBUSY;
+        }
+
+      cm->cm_rabusy = false;
+    }
+
+  nxmutex_unlock(&cm->cm_lock);
+#endif
+
+  nxmutex_destroy(&cm->cm_lock);
+  kmm_free(cm);
   return OK;
 }
 
@@ -1453,7 +1708,8 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
 static int cromfs_statfs(struct inode *mountpt, struct statfs *buf)
 {
-  FAR struct cromfs_volume_s *fs;
+  FAR struct cromfs_mount_s *cm;
+  FAR const struct cromfs_volume_s *fs;
 
   finfo("mountpt: %p buf: %p\n", mountpt, buf);
 
@@ -1463,7 +1719,8 @@ static int cromfs_statfs(struct inode *mountpt, struct statfs *buf)
 
   /* Recover our private data from the inode instance */
 
-  fs             = mountpt->i_private;
+  cm             = mountpt->i_private;
+  fs             = cm->cm_vol;
 
   /* Fill in the statfs info. */
 
@@ -1499,7 +1756,7 @@ static int cromfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Recover our private data from the inode instance */
 
-  fs = mountpt->i_private;
+  fs = ((FAR struct cromfs_mount_s *)mountpt->i_private)->cm_vol;
 
   /* Locate the node for this relative path */
 
@@ -182,6 +182,51 @@ int mtd_proxy(FAR const char *mtddev, int mountflags,
               FAR struct inode **ppinode);
 #endif
 
+/****************************************************************************
+ * Name: blockcache_read, blockcache_write
+ *
+ * Description:
+ *   Read or write sectors of a block driver through the shared sector
+ *   cache.  These are drop-in replacements of the read and write methods
+ *   of the driver: a filesystem opts in by calling them instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+ssize_t blockcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                        blkcnt_t start, unsigned int nsectors);
+ssize_t blockcache_write(FAR struct inode *inode,
+                         FAR const unsigned char *buffer,
+                         blkcnt_t start, unsigned int nsectors);
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write back the dirty sectors of a block driver, or of all the drivers
+ *   if 'inode' is NULL.
+ *
+ ****************************************************************************/
+
+int blockcache_flush(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: blockcache_invalidate
+ *
+ * Description:
+ *   Write back and drop the sectors cached for a block driver, before the
+ *   driver is closed.
+ *
+ ****************************************************************************/
+
+void blockcache_invalidate(FAR struct inode *inode);
+#else
+#  define blockcache_read(i, b, s, n)  (i)->u.i_bops->read(i, b, s, n)
+#  define blockcache_write(i, b, s, n) (i)->u.i_bops->write(i, b, s, n)
+#  define blockcache_flush(i)          (OK)
+#  define blockcache_invalidate(i)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,679 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "driver/driver.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLOCKCACHE_NBLOCKS    CONFIG_FS_BLOCKCACHE_NBLOCKS
+#define BLOCKCACHE_BLOCKSIZE  CONFIG_FS_BLOCKCACHE_BLOCKSIZE
+#define BLOCKCACHE_NBUCKETS   CONFIG_FS_BLOCKCACHE_NBUCKETS
+#define BLOCKCACHE_READAHEAD  CONFIG_FS_BLOCKCACHE_READAHEAD
+
+#if (BLOCKCACHE_NBUCKETS & (BLOCKCACHE_NBUCKETS - 1)) != 0
+#  error CONFIG_FS_BLOCKCACHE_NBUCKETS must be a power of two
+#endif
+
+/* The probation queue (A1) of the 2Q policy holds the sectors that were
+ * only used once, the main queue (Am) those used again.  A1 is limited to
+ * a quarter of the cache, so that a scan cannot flush the hot sectors.
+ */
+
+#define BLOCKCACHE_A1MAX      MAX(BLOCKCACHE_NBLOCKS / 4, 1)
+
+/* Requests of more sectors than this bypass the cache */
+
+#define BLOCKCACHE_MAXREQ     MAX(BLOCKCACHE_NBLOCKS / 2, 1)
+
+#define BLOCKCACHE_HASH(i, s) \
+  ((((uintptr_t)(i) >> 4) ^ (uintptr_t)(s)) & (BLOCKCACHE_NBUCKETS - 1))
+
+#define BLOCKCACHE_ENTRY(e) \
+  container_of(e, struct blockcache_entry_s, lru)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct blockcache_entry_s
+{
+  dq_entry_t                     lru;    /* Link in the free, A1 or Am queue */
+  FAR struct blockcache_entry_s *hnext;  /* Next entry of the hash bucket */
+  FAR struct inode              *inode;  /* Block driver; NULL if free */
+  blkcnt_t                       sector; /* The cached sector */
+  bool                           hot;    /* In Am rather than A1 */
+  bool                           dirty;  /* Not written back yet */
+  uint8_t                        data[BLOCKCACHE_BLOCKSIZE];
+};
+
+struct blockcache_s
+{
+  mutex_t                        lock;
+  dq_queue_t                     free;   /* Free entries */
+  dq_queue_t                     a1;     /* Sectors used once, on probation */
+  dq_queue_t                     am;     /* Sectors used again */
+  unsigned int                   na1;    /* Number of entries in A1 */
+  bool                           initialized;
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  struct work_s                  work;   /* Write back work */
+#endif
+  FAR struct blockcache_entry_s *hash[BLOCKCACHE_NBUCKETS];
+  struct blockcache_entry_s      entries[BLOCKCACHE_NBLOCKS];
+  uint8_t                        scratch[BLOCKCACHE_READAHEAD *
+                                         BLOCKCACHE_BLOCKSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct blockcache_s g_blockcache =
+{
+  NXMUTEX_INITIALIZER
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_initialize
+ ****************************************************************************/
+
+static void blockcache_initialize(FAR struct blockcache_s *bc)
+{
+  int i;
+
+  for (i = 0; i < BLOCKCACHE_NBLOCKS; i++)
+    {
+      dq_addlast(&bc->entries[i].lru, &bc->free);
+    }
+
+  bc->initialized = true;
+}
+
+/****************************************************************************
+ * Name: blockcache_geometry
+ *
+ * Description:
+ *   Get the geometry of the block driver and check whether its sectors fit
+ *   in the cache.
+ *
+ ****************************************************************************/
+
+static bool blockcache_geometry(FAR struct inode *inode,
+                                FAR struct geometry *geo)
+{
+  if (inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->geometry(inode, geo) < 0 ||
+      !geo->geo_available || geo->geo_sectorsize == 0 ||
+      geo->geo_sectorsize > BLOCKCACHE_BLOCKSIZE)
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: blockcache_find
+ ****************************************************************************/
+
+static FAR struct blockcache_entry_s *
+blockcache_find(FAR struct blockcache_s *bc, FAR struct inode *inode,
+                blkcnt_t sector)
+{
+  FAR struct blockcache_entry_s *entry;
+
+  entry = bc->hash[BLOCKCACHE_HASH(inode, sector)];
+  while (entry != NULL &&
+         (entry->inode != inode || entry->sector != sector))
+    {
+      entry = entry->hnext;
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: blockcache_touch
+ *
+ * Description:
+ *   Record a use of a cached sector: a sector used again moves to the head
+ *   of the main queue.
+ *
+ ****************************************************************************/
+
+static void blockcache_touch(FAR struct blockcache_s *bc,
+                             FAR struct blockcache_entry_s *entry)
+{
+  if (entry->hot)
+    {
+      dq_rem(&entry->lru, &bc->am);
+    }
+  else
+    {
+      dq_rem(&entry->lru, &bc->a1);
+      bc->na1--;
+      entry->hot = true;
+    }
+
+  dq_addfirst(&entry->lru, &bc->am);
+}
+
+/****************************************************************************
+ * Name: blockcache_writeentry
+ ****************************************************************************/
+
+static int blockcache_writeentry(FAR struct blockcache_entry_s *entry)
+{
+  FAR struct inode *inode = entry->inode;
+  ssize_t nwritten;
+
+  nwritten = inode->u.i_bops->write(inode, entry->data, entry->sector, 1);
+  if (nwritten != 1)
+    {
+      ferr("ERROR: Write back of sector %" PRIuOFF " failed: %zd\n",
+           (off_t)entry->sector, nwritten);
+      return nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  entry->dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_remove
+ *
+ * Description:
+ *   Remove an entry from its hash bucket and queue and put it on the free
+ *   queue.  A dirty entry must have been written back.
+ *
+ ****************************************************************************/
+
+static void blockcache_remove(FAR struct blockcache_s *bc,
+                              FAR struct blockcache_entry_s *entry)
+{
+  FAR struct blockcache_entry_s **pprev;
+
+  pprev = &bc->hash[BLOCKCACHE_HASH(entry->inode, entry->sector)];
+  while (*pprev != entry)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev = entry->hnext;
+
+  if (entry->hot)
+    {
+      dq_rem(&entry->lru, &bc->am);
+    }
+  else
+    {
+      dq_rem(&entry->lru, &bc->a1);
+      bc->na1--;
+    }
+
+  entry->inode = NULL;
+  entry->dirty = false;
+  dq_addlast(&entry->lru, &bc->free);
+}
+
+/****************************************************************************
+ * Name: blockcache_insert
+ *
+ * Description:
+ *   Cache a sector not cached yet, on probation.  The least recently used
+ *   sector of A1 is evicted if A1 is over its share or Am is empty, else
+ *   that of Am.  A dirty sector is written back before it is evicted.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_entry_s *
+blockcache_insert(FAR struct blockcache_s *bc, FAR struct inode *inode,
+                  blkcnt_t sector, FAR const uint8_t *data, size_t size)
+{
+  FAR struct blockcache_entry_s *entry;
+  FAR dq_entry_t *victim;
+  unsigned int hash;
+
+  victim = dq_peek(&bc->free);
+  if (victim != NULL)
+    {
+      dq_rem(victim, &bc->free);
+    }
+  else
+    {
+      victim = bc->na1 >= BLOCKCACHE_A1MAX || dq_empty(&bc->am) ?
+               dq_tail(&bc->a1) : dq_tail(&bc->am);
+
+      entry = BLOCKCACHE_ENTRY(victim);
+      if (entry->dirty && blockcache_writeentry(entry) < 0)
+        {
+          return NULL;
+        }
+
+      blockcache_remove(bc, entry);
+      dq_rem(victim, &bc->free);
+    }
+
+  entry         = BLOCKCACHE_ENTRY(victim);
+  entry->inode  = inode;
+  entry->sector = sector;
+  entry->hot    = false;
+  entry->dirty  = false;
+  memcpy(entry->data, data, size);
+
+  hash          = BLOCKCACHE_HASH(inode, sector);
+  entry->hnext  = bc->hash[hash];
+  bc->hash[hash] = entry;
+
+  dq_addfirst(&entry->lru, &bc->a1);
+  bc->na1++;
+  return entry;
+}
+
+/****************************************************************************
+ * Name: blockcache_readmiss
+ *
+ * Description:
+ *   Read the 'nsectors' sectors starting at 'sector', none of them cached,
+ *   into 'buffer' and cache them.  A short run is read with read-ahead into
+ *   the scratch buffer; the sectors read ahead are cached on probation.
+ *
+ ****************************************************************************/
+
+static ssize_t blockcache_readmiss(FAR struct blockcache_s *bc,
+                                   FAR struct inode *inode,
+                                   FAR const struct geometry *geo,
+                                   FAR unsigned char *buffer,
+                                   blkcnt_t sector, unsigned int nsectors)
+{
+  size_t size = geo->geo_sectorsize;
+  FAR uint8_t *data = buffer;
+  unsigned int nread = nsectors;
+  ssize_t ret;
+  unsigned int i;
+
+  if (nsectors < BLOCKCACHE_READAHEAD &&
+      sector + BLOCKCACHE_READAHEAD <= geo->geo_nsectors)
+    {
+      nread = BLOCKCACHE_READAHEAD;
+      data  = bc->scratch;
+    }
+
+  ret = inode->u.i_bops->read(inode, data, sector, nread);
+  if (ret < (ssize_t)nsectors)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  nread = ret;
+  for (i = 0; i < nread; i++)
+    {
+      /* A sector read ahead may already be cached, and dirty */
+
+      if ((i < nsectors || !blockcache_find(bc, inode, sector + i)) &&
+          !blockcache_insert(bc, inode, sector + i, data + i * size, size))
+        {
+          break;
+        }
+    }
+
+  if (data != buffer)
+    {
+      memcpy(buffer, data, nsectors * size);
+    }
+
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: blockcache_flushlocked
+ ****************************************************************************/
+
+static int blockcache_flushlocked(FAR struct blockcache_s *bc,
+                                  FAR struct inode *inode)
+{
+  int ret = OK;
+  int err;
+  int i;
+
+  for (i = 0; i < BLOCKCACHE_NBLOCKS; i++)
+    {
+      FAR struct blockcache_entry_s *entry = &bc->entries[i];
+
+      if (entry->inode != NULL && entry->dirty &&
+          (inode == NULL || entry->inode == inode))
+        {
+          err = blockcache_writeentry(entry);
+          if (err < 0 && ret == OK)
+            {
+              ret = err;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_worker
+ *
+ * Description:
+ *   Write back all dirty sectors, on the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+static void blockcache_worker(FAR void *arg)
+{
+  FAR struct blockcache_s *bc = arg;
+
+  nxmutex_lock(&bc->lock);
+  blockcache_flushlocked(bc, NULL);
+  nxmutex_unlock(&bc->lock);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_read
+ *
+ * Description:
+ *   Read sectors of a block driver through the shared sector cache.  The
+ *   cache is keyed by the driver inode and the sector, so that the sectors
+ *   stay cached across opens and mounts, whichever filesystem reads them.
+ *
+ *   A driver must be accessed either always or never through the cache:
+ *   the cache does not see the accesses made directly to the driver.
+ *
+ * Input Parameters:
+ *   inode    - The block driver
+ *   buffer   - The buffer to read into
+ *   start    - The first sector to read
+ *   nsectors - The number of sectors to read
+ *
+ * Returned Value:
+ *   The number of sectors read on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blockcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                        blkcnt_t start, unsigned int nsectors)
+{
+  FAR struct blockcache_s *bc = &g_blockcache;
+  FAR struct blockcache_entry_s *entry;
+  struct geometry geo;
+  unsigned int done = 0;
+  unsigned int nmiss;
+  ssize_t ret;
+
+  if (nsectors > BLOCKCACHE_MAXREQ || !blockcache_geometry(inode, &geo))
+    {
+      /* The sectors cached may be more recent than those on the device */
+
+      if (nsectors > BLOCKCACHE_MAXREQ)
+        {
+          blockcache_flush(inode);
+        }
+
+      return inode->u.i_bops->read(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&bc->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!bc->initialized)
+    {
+      blockcache_initialize(bc);
+    }
+
+  while (done < nsectors)
+    {
+      entry = blockcache_find(bc, inode, start + done);
+      if (entry != NULL)
+        {
+          blockcache_touch(bc, entry);
+          memcpy(buffer + done * geo.geo_sectorsize, entry->data,
+                 geo.geo_sectorsize);
+          done++;
+          continue;
+        }
+
+      /* Read the whole run of sectors not cached at once */
+
+      for (nmiss = 1; done + nmiss < nsectors &&
+           blockcache_find(bc, inode, start + done + nmiss) == NULL;
+           nmiss++);
+
+      ret = blockcache_readmiss(bc, inode, &geo,
+                                buffer + done * geo.geo_sectorsize,
+                                start + done, nmiss);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      done += nmiss;
+    }
+
+  nxmutex_unlock(&bc->lock);
+  return ret < 0 ? ret : nsectors;
+}
+
+/****************************************************************************
+ * Name: blockcache_write
+ *
+ * Description:
+ *   Write sectors of a block driver through the shared sector cache.  With
+ *   CONFIG_FS_BLOCKCACHE_WRITEBACK, the sectors are written back later on
+ *   the low priority work queue, or by blockcache_flush(); else they are
+ *   written through at once.
+ *
+ * Input Parameters:
+ *   inode    - The block driver
+ *   buffer   - The data to write
+ *   start    - The first sector to write
+ *   nsectors - The number of sectors to write
+ *
+ * Returned Value:
+ *   The number of sectors written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blockcache_write(FAR struct inode *inode,
+                         FAR const unsigned char *buffer,
+                         blkcnt_t start, unsigned int nsectors)
+{
+  FAR struct blockcache_s *bc = &g_blockcache;
+  FAR struct blockcache_entry_s *entry;
+  struct geometry geo;
+  bool through = true;
+  unsigned int i;
+  ssize_t ret;
+
+  if (!blockcache_geometry(inode, &geo))
+    {
+      return inode->u.i_bops->write(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&bc->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!bc->initialized)
+    {
+      blockcache_initialize(bc);
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  through = nsectors > BLOCKCACHE_MAXREQ;
+#endif
+
+  if (through)
+    {
+      ret = inode->u.i_bops->write(inode, buffer, start, nsectors);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  /* Update the sectors cached, and cache the others when writing back */
+
+  for (i = 0; i < nsectors; i++)
+    {
+      FAR const uint8_t *data = buffer + i * geo.geo_sectorsize;
+
+      entry = blockcache_find(bc, inode, start + i);
+      if (entry != NULL)
+        {
+          memcpy(entry->data, data, geo.geo_sectorsize);
+          blockcache_touch(bc, entry);
+        }
+      else if (!through)
+        {
+          entry = blockcache_insert(bc, inode, start + i, data,
+                                    geo.geo_sectorsize);
+          if (entry == NULL)
+            {
+              ret = -EIO;
+              goto out;
+            }
+        }
+
+      if (entry != NULL)
+        {
+          entry->dirty = !through;
+        }
+    }
+
+  ret = nsectors;
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  if (!through && work_available(&bc->work))
+    {
+      work_queue(LPWORK, &bc->work, blockcache_worker, bc,
+                 MSEC2TICK(CONFIG_FS_BLOCKCACHE_WRITEBACK_DELAY));
+    }
+#endif
+
+out:
+  nxmutex_unlock(&bc->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write back the dirty sectors of a block driver, or of all the drivers
+ *   if 'inode' is NULL.
+ *
+ * Returned Value:
+ *   Zero on success; the negated errno value of the first failed write on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int blockcache_flush(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *bc = &g_blockcache;
+  int ret;
+
+  ret = nxmutex_lock(&bc->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = blockcache_flushlocked(bc, inode);
+  nxmutex_unlock(&bc->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_invalidate
+ *
+ * Description:
+ *   Write back and drop the sectors cached for a block driver.  This must
+ *   be called before the driver is closed, since its inode may be freed.
+ *
+ ****************************************************************************/
+
+void blockcache_invalidate(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *bc = &g_blockcache;
+  int i;
+
+  nxmutex_lock(&bc->lock);
+
+  if (bc->initialized)
+    {
+      blockcache_flushlocked(bc, inode);
+
+      for (i = 0; i < BLOCKCACHE_NBLOCKS; i++)
+        {
+          if (bc->entries[i].inode == inode)
+            {
+              blockcache_remove(bc, &bc->entries[i]);
+            }
+        }
+    }
+
+  nxmutex_unlock(&bc->lock);
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
@@ -29,6 +29,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 
 /****************************************************************************
  * Public Functions
@@ -75,6 +76,10 @@ int close_blockdriver(FAR struct inode *inode)
       goto errout;
     }
 
+  /* Write back and drop the sectors cached for the driver */
+
+  blockcache_invalidate(inode);
+
   /* Close the block driver.  Not that no mutually exclusive access
    * to the driver is enforced here.  That must be done in the driver
    * if needed.
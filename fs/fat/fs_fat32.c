@@ -42,6 +42,7 @@
 #include <nuttx/fs/fat.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 #include "fs_fat32.h"
 
 /****************************************************************************
@@ -613,15 +614,18 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the contiguous sectors in this cluster
+           * and in the adjacent clusters that follow it in the chain.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, nsectors, false);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_lock;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
            */
@@ -654,9 +658,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_skipsectors(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -864,15 +867,20 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the contiguous sectors in this cluster
+           * and in the adjacent clusters that follow it.  The chain is
+           * extended as needed; new clusters are allocated next to the
+           * current one whenever possible.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, nsectors, true);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_lock;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
            * and invalidate the current cache content.
@@ -906,8 +914,7 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
+          fat_skipsectors(fs, ff, nsectors);
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
         }
@@ -1023,6 +1030,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#ifdef CONFIG_FAT_CHAINCACHE
+  uint32_t index;
+  uint32_t known;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1153,6 +1164,25 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#ifdef CONFIG_FAT_CHAINCACHE
+      /* Start from the closest known cluster at or before the one
+       * containing the requested position.
+       */
+
+      index = position / clustersize;
+      if (fat_chaincache_lookup(ff, &index, &known))
+        {
+          cluster       = known;
+          filep->f_pos  = (off_t)index * clustersize;
+          position     -= filep->f_pos;
+        }
+      else
+        {
+          fat_chaincache_add(ff, 0, cluster);
+        }
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1219,8 +1249,11 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
               goto errout_with_lock;
             }
 
-          /* Otherwise, update the position and continue looking */
+          /* Otherwise, remember the cluster, update the position and
+           * continue looking.
+           */
 
+          fat_chaincache_add(ff, filep->f_pos / clustersize + 1, cluster);
           filep->f_pos += clustersize;
           position     -= clustersize;
         }
@@ -1436,6 +1469,13 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  /* Write back the sectors held in the block cache */
+
+  if (ret >= 0)
+    {
+      ret = blockcache_flush(fs->fs_blkdriver);
+    }
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1543,6 +1583,11 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_CHAINCACHE
+  newff->ff_nruns            = oldff->ff_nruns;            /* Cached cluster runs */
+  memcpy(newff->ff_runs, oldff->ff_runs,
+         oldff->ff_nruns * sizeof(struct fat_run_s));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -2277,6 +2322,8 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       FAR struct inode *inode = fs->fs_blkdriver;
       if (inode)
         {
+          blockcache_invalidate(inode);
+
           if (inode->u.i_bops && inode->u.i_bops->close)
             {
               inode->u.i_bops->close(inode);
@@ -2302,6 +2349,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return OK;
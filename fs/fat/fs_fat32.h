@@ -887,8 +887,26 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* Bitmap of the clusters in use (may be NULL) */
+  uint32_t fs_freescanned;         /* Clusters below this one are in fs_freemap */
+  uint32_t fs_freenfree;           /* Number of free clusters below fs_freescanned */
+#endif
 };
 
+#ifdef CONFIG_FAT_CHAINCACHE
+/* This structure describes a run of contiguous clusters in the cluster
+ * chain of a file.
+ */
+
+struct fat_run_s
+{
+  uint32_t fr_index;               /* Index of the first cluster in the chain */
+  uint32_t fr_cluster;             /* Number of the first cluster */
+  uint32_t fr_length;              /* Number of clusters in the run */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -908,6 +926,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_CHAINCACHE
+  uint8_t  ff_nruns;               /* Number of valid entries in ff_runs[] */
+  struct fat_run_s ff_runs[CONFIG_FAT_CHAINCACHE_NRUNS]; /* Sorted by fr_index */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1050,6 +1072,28 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+EXTERN int    fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                                FAR struct fat_file_s *ff,
+                                unsigned int nsectors, bool extend);
+EXTERN void   fat_skipsectors(FAR struct fat_mountpt_s *fs,
+                              FAR struct fat_file_s *ff,
+                              unsigned int nsectors);
+
+/* Cluster chain cache of open files */
+
+#ifdef CONFIG_FAT_CHAINCACHE
+EXTERN bool   fat_chaincache_lookup(FAR struct fat_file_s *ff,
+                                    FAR uint32_t *index,
+                                    FAR uint32_t *cluster);
+EXTERN void   fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                                 uint32_t cluster);
+EXTERN void   fat_chaincache_invalidate(FAR struct fat_mountpt_s *fs,
+                                        uint32_t startcluster);
+#else
+#  define fat_chaincache_add(ff,i,c)
+#  define fat_chaincache_invalidate(fs,c)
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
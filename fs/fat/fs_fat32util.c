@@ -40,6 +40,7 @@
 #include <nuttx/fs/fat.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 #include "fs_fat32.h"
 
 /****************************************************************************
@@ -263,6 +264,167 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemap_update
+ *
+ * Description:
+ *   Record a new FAT entry of 'cluster' in the free cluster bitmap.
+ *   Clusters not yet scanned are ignored:  their entry will be read from
+ *   the FAT when the scan reaches them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_freemap_update(FAR struct fat_mountpt_s *fs,
+                               uint32_t cluster, bool used)
+{
+  FAR uint32_t *word;
+  uint32_t bit;
+
+  if (fs->fs_freemap == NULL || cluster < 2 ||
+      cluster >= fs->fs_freescanned)
+    {
+      return;
+    }
+
+  word = &fs->fs_freemap[cluster >> 5];
+  bit  = (uint32_t)1 << (cluster & 31);
+
+  if (used && (*word & bit) == 0)
+    {
+      *word |= bit;
+      fs->fs_freenfree--;
+    }
+  else if (!used && (*word & bit) != 0)
+    {
+      *word &= ~bit;
+      fs->fs_freenfree++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemap_nextfree
+ *
+ * Description:
+ *   Return the first cluster in the range [cluster, end) that may be free,
+ *   skipping over the clusters that the bitmap knows to be in use.
+ *   Clusters that were not scanned yet may always be free.  Returns 'end'
+ *   if there is no such cluster.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_freemap_nextfree(FAR struct fat_mountpt_s *fs,
+                                     uint32_t cluster, uint32_t end)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      while (cluster < end && cluster < fs->fs_freescanned)
+        {
+          uint32_t word = fs->fs_freemap[cluster >> 5];
+
+          if (word == UINT32_MAX)
+            {
+              /* Skip a whole word of used clusters */
+
+              cluster = (cluster | 31) + 1;
+            }
+          else if ((word & ((uint32_t)1 << (cluster & 31))) == 0)
+            {
+              break;
+            }
+          else
+            {
+              cluster++;
+            }
+        }
+    }
+
+  return cluster < end ? cluster : end;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemap_build
+ *
+ * Description:
+ *   Add the FAT entries of the next 'nsectors' FAT sectors to the free
+ *   cluster bitmap.  Once the whole FAT has been seen, the bitmap also
+ *   provides the number of free clusters.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int fat_freemap_build(FAR struct fat_mountpt_s *fs,
+                             uint32_t nsectors)
+{
+  uint32_t cluster;
+  uint32_t limit;
+  off_t next;
+
+  if (fs->fs_freemap == NULL)
+    {
+      return OK;
+    }
+
+  limit = fs->fs_nclusters;
+  if (nsectors < fs->fs_nfatsects)
+    {
+      unsigned int bits = fs->fs_type == FSTYPE_FAT12 ? 12 :
+                          fs->fs_type == FSTYPE_FAT16 ? 16 : 32;
+      uint32_t count = nsectors * ((fs->fs_hwsectorsize * 8) / bits);
+
+      if (limit - fs->fs_freescanned > count)
+        {
+          limit = fs->fs_freescanned + count;
+        }
+    }
+
+  for (cluster = fs->fs_freescanned; cluster < limit; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          /* Leave the rest of the scan for the next time */
+
+          fs->fs_freescanned = cluster;
+          return (int)next;
+        }
+
+      if (next == 0)
+        {
+          fs->fs_freenfree++;
+        }
+      else
+        {
+          fs->fs_freemap[cluster >> 5] |= (uint32_t)1 << (cluster & 31);
+        }
+    }
+
+  if (cluster > fs->fs_freescanned)
+    {
+      fs->fs_freescanned = cluster;
+    }
+
+  /* Is the bitmap complete?  Then it knows best how many clusters are
+   * free, whatever the FSINFO sector said.
+   */
+
+  if (fs->fs_freescanned >= fs->fs_nclusters &&
+      fs->fs_fsifreecount != fs->fs_freenfree)
+    {
+      fs->fs_fsifreecount = fs->fs_freenfree;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -619,13 +781,35 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
-  /* Enforce computation of free clusters if configured */
+#ifdef CONFIG_FAT_FREEMAP
+  /* Allocate the free cluster bitmap.  It is filled in a little at a time
+   * by fat_checkmount().  The volume is still usable without it.
+   */
+
+  fs->fs_freemap     = kmm_zalloc(((fs->fs_nclusters + 31) >> 5) *
+                                  sizeof(uint32_t));
+  fs->fs_freescanned = 2;
+  fs->fs_freenfree   = 0;
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+    }
+#endif
+
+  /* Enforce computation of free clusters if configured.  The free cluster
+   * bitmap replaces the stored count once it is complete anyway.
+   */
 
 #ifdef CONFIG_FAT_COMPUTE_FSINFO
-  ret = fat_computefreeclusters(fs);
-  if (ret != OK)
+#  ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap == NULL)
+#  endif
     {
-      goto errout_with_buffer;
+      ret = fat_computefreeclusters(fs);
+      if (ret != OK)
+        {
+          goto errout_with_buffer;
+        }
     }
 #endif
 
@@ -651,6 +835,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap != NULL)
+    {
+      kmm_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+#endif
+
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -691,6 +883,13 @@ int fat_checkmount(struct fat_mountpt_s *fs)
               if (errcode == OK && geo.geo_available &&
                   !geo.geo_mediachanged)
                 {
+#ifdef CONFIG_FAT_FREEMAP
+                  /* Take the opportunity to extend the free cluster
+                   * bitmap.  A failure is retried on the next access.
+                   */
+
+                  fat_freemap_build(fs, CONFIG_FAT_FREEMAP_BATCH);
+#endif
                   return OK;
                 }
             }
@@ -721,8 +920,8 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread = blockcache_read(inode, buffer,
+                                                 sector, nsectors);
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -755,7 +954,7 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+              blockcache_write(inode, buffer, sector, nsectors);
 
           if (nsectorswritten == nsectors)
             {
@@ -1089,6 +1288,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemap_update(fs, clusterno, nextcluster != 0);
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1166,6 +1369,9 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   off_t    startsector;
   uint32_t newcluster;
   uint32_t startcluster;
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t end;
+#endif
   int      ret;
 
   /* The special value 0 is used when the new chain should start */
@@ -1245,6 +1451,28 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
             }
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Skip over the clusters known to be in use without reading the
+       * FAT, stopping at the starting cluster after a wrap.
+       */
+
+      end = newcluster <= startcluster ? startcluster + 1 :
+                                          fs->fs_nclusters;
+      newcluster = fat_freemap_nextfree(fs, newcluster, end);
+      if (newcluster >= end)
+        {
+          if (end < fs->fs_nclusters)
+            {
+              return 0;
+            }
+
+          /* Wrap around on the next pass */
+
+          newcluster = fs->fs_nclusters - 1;
+          continue;
+        }
+#endif
+
       /* We have a candidate cluster.  Check if the cluster number is
        * mapped to a group of sectors.
        */
@@ -1312,6 +1540,222 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_contigsectors
+ *
+ * Description:
+ *   Return how many of the next 'nsectors' sectors of an open file,
+ *   starting with ff_currentsector, are contiguous on the media.  The
+ *   cluster chain is followed (or extended if 'extend' is true) for as
+ *   long as the next cluster is adjacent to the current one.  The file
+ *   position is not changed; see fat_skipsectors().
+ *
+ * Returned Value:
+ *   <0: error, otherwise the number of contiguous sectors.  This is never
+ *   less than the sectors remaining in the current cluster (or nsectors if
+ *   that is smaller).
+ *
+ ****************************************************************************/
+
+int fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                      FAR struct fat_file_s *ff, unsigned int nsectors,
+                      bool extend)
+{
+  uint32_t cluster = ff->ff_currentcluster;
+  unsigned int avail = ff->ff_sectorsincluster;
+  off_t next;
+
+  while (avail < nsectors)
+    {
+      if (extend)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      if (next < 0)
+        {
+          return (int)next;
+        }
+
+      /* Stop at the end of the chain or at the first discontinuity */
+
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      avail  += fs->fs_fatsecperclus;
+    }
+
+  return avail < nsectors ? avail : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_skipsectors
+ *
+ * Description:
+ *   Advance the current sector of an open file over 'nsectors' contiguous
+ *   sectors as reported by fat_contigsectors().
+ *
+ ****************************************************************************/
+
+void fat_skipsectors(FAR struct fat_mountpt_s *fs,
+                     FAR struct fat_file_s *ff, unsigned int nsectors)
+{
+  unsigned int remaining;
+  unsigned int nclusters;
+
+  if (nsectors <= ff->ff_sectorsincluster)
+    {
+      ff->ff_sectorsincluster -= nsectors;
+      ff->ff_currentsector    += nsectors;
+      return;
+    }
+
+  /* The transfer continued into the following, adjacent clusters */
+
+  remaining = nsectors - ff->ff_sectorsincluster;
+  nclusters = (remaining + fs->fs_fatsecperclus - 1) / fs->fs_fatsecperclus;
+
+  ff->ff_currentcluster   += nclusters;
+  ff->ff_currentsector    += nsectors;
+  ff->ff_sectorsincluster  = nclusters * fs->fs_fatsecperclus - remaining;
+}
+
+/****************************************************************************
+ * Name: fat_chaincache_lookup
+ *
+ * Description:
+ *   Find the cluster with the index '*index' in the cluster chain of an
+ *   open file.  If that part of the chain is not known, return the last
+ *   known cluster instead.  On return, '*index' and '*cluster' hold the
+ *   index and the number of the cluster found.
+ *
+ * Returned Value:
+ *   false if nothing is known about the chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_CHAINCACHE
+bool fat_chaincache_lookup(FAR struct fat_file_s *ff, FAR uint32_t *index,
+                           FAR uint32_t *cluster)
+{
+  FAR struct fat_run_s *run;
+  uint32_t target = *index;
+  int low;
+  int high;
+
+  if (ff->ff_nruns == 0)
+    {
+      return false;
+    }
+
+  /* The runs cover the chain from its start without gaps.  Positions past
+   * the last run continue from the last known cluster.
+   */
+
+  run = &ff->ff_runs[ff->ff_nruns - 1];
+  if (target >= run->fr_index + run->fr_length)
+    {
+      *index   = run->fr_index + run->fr_length - 1;
+      *cluster = run->fr_cluster + run->fr_length - 1;
+      return true;
+    }
+
+  /* Otherwise, binary search for the run holding the position */
+
+  low  = 0;
+  high = ff->ff_nruns - 1;
+  while (low < high)
+    {
+      int mid = (low + high + 1) / 2;
+
+      if (ff->ff_runs[mid].fr_index <= target)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid - 1;
+        }
+    }
+
+  run      = &ff->ff_runs[low];
+  *cluster = run->fr_cluster + (target - run->fr_index);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_chaincache_add
+ *
+ * Description:
+ *   Record that the cluster with the index 'index' in the cluster chain of
+ *   an open file is 'cluster'.  Only the cluster following the known part
+ *   of the chain is recorded:  it either extends the last run or starts a
+ *   new one while there is room.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_CHAINCACHE
+void fat_chaincache_add(FAR struct fat_file_s *ff, uint32_t index,
+                        uint32_t cluster)
+{
+  FAR struct fat_run_s *run;
+  uint32_t next = 0;
+
+  if (ff->ff_nruns > 0)
+    {
+      run  = &ff->ff_runs[ff->ff_nruns - 1];
+      next = run->fr_index + run->fr_length;
+
+      if (index == next && cluster == run->fr_cluster + run->fr_length)
+        {
+          run->fr_length++;
+          return;
+        }
+    }
+
+  if (index == next && ff->ff_nruns < CONFIG_FAT_CHAINCACHE_NRUNS)
+    {
+      run             = &ff->ff_runs[ff->ff_nruns++];
+      run->fr_index   = index;
+      run->fr_cluster = cluster;
+      run->fr_length  = 1;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_chaincache_invalidate
+ *
+ * Description:
+ *   Forget the cached cluster chain of every open file whose chain begins
+ *   with 'startcluster'.  Called when clusters are removed from the chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_CHAINCACHE
+void fat_chaincache_invalidate(FAR struct fat_mountpt_s *fs,
+                               uint32_t startcluster)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      if (ff->ff_startcluster == startcluster)
+        {
+          ff->ff_nruns = 0;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1457,6 +1901,7 @@ int fat_dirtruncate(struct fat_mountpt_s *fs, FAR uint8_t *direntry)
 
   /* Now remove the entire cluster chain comprising the file */
 
+  fat_chaincache_invalidate(fs, startcluster);
   savesector = fs->fs_currentsector;
   ret = fat_removechain(fs, startcluster);
   if (ret < 0)
@@ -1500,6 +1945,10 @@ int fat_dirshrink(struct fat_mountpt_s *fs, FAR uint8_t *direntry,
   lastcluster = ((uint32_t)DIR_GETFSTCLUSTHI(direntry) << 16) |
                  DIR_GETFSTCLUSTLO(direntry);
 
+  /* The tail of the chain is about to go away */
+
+  fat_chaincache_invalidate(fs, lastcluster);
+
   /* Set the file size to the new length.  */
 
   DIR_PUTFILESIZE(direntry, length);
@@ -2024,9 +2473,19 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 
 int fat_computefreeclusters(struct fat_mountpt_s *fs)
 {
+  uint32_t nfreeclusters = 0;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Finishing the free cluster bitmap provides the count */
+
+  if (fs->fs_freemap != NULL)
+    {
+      return fat_freemap_build(fs, UINT32_MAX);
+    }
+#endif
+
   /* We have to count the number of free clusters */
 
-  uint32_t nfreeclusters = 0;
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
@@ -36,6 +36,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_FDSAN
 #  include <android/fdsan.h>
@@ -47,17 +48,49 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each array of row pointers is preceded by one hidden slot.  Once the
+ * array has been replaced, the slot links it into list->fl_retired.
+ */
+
+#define FILES_BLOCK(files) ((FAR void **)(files) - 1)
+
+/* Orders the publication of the rows against the lock-free readers on the
+ * other CPUs.  On a single CPU, the writer locks the scheduler instead.
+ */
+
+#ifdef CONFIG_SMP
+#  define FILES_DMB()      SP_DMB()
+#else
+#  define FILES_DMB()
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
  * Name: files_extend
+ *
+ * Description:
+ *   Grow the file list to 'row' rows.  fs_getfilep() indexes the list
+ *   without taking fl_lock, so the array of row pointers is never resized
+ *   in place:  a new array is published and the old one is kept until the
+ *   list is released since a lock-free reader may still be using it.  The
+ *   rows themselves never move.
+ *
+ * Assumptions:
+ *   The caller holds fl_lock.
+ *
  ****************************************************************************/
 
 static int files_extend(FAR struct filelist *list, size_t row)
 {
   FAR struct file **tmp;
+  FAR void **block;
   int i;
 
   if (row <= list->fl_rows)
@@ -70,13 +103,19 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return -EMFILE;
     }
 
-  tmp = kmm_realloc(list->fl_files, sizeof(FAR struct file *) * row);
-  DEBUGASSERT(tmp);
-  if (tmp == NULL)
+  block = kmm_malloc(sizeof(FAR struct file *) * (row + 1));
+  DEBUGASSERT(block);
+  if (block == NULL)
     {
       return -ENFILE;
     }
 
+  tmp = (FAR struct file **)(block + 1);
+  if (list->fl_rows > 0)
+    {
+      memcpy(tmp, list->fl_files, sizeof(FAR struct file *) * list->fl_rows);
+    }
+
   i = list->fl_rows;
   do
     {
@@ -89,14 +128,28 @@ static int files_extend(FAR struct filelist *list, size_t row)
               kmm_free(tmp[i]);
             }
 
-          kmm_free(tmp);
+          kmm_free(block);
           return -ENFILE;
         }
     }
   while (++i < row);
 
+  /* Retire the old array */
+
+  if (list->fl_files != NULL)
+    {
+      *FILES_BLOCK(list->fl_files) = list->fl_retired;
+      list->fl_retired = FILES_BLOCK(list->fl_files);
+    }
+
+  /* Publish the new rows before the new row count, see fs_getfilep() */
+
+  sched_lock();
+  FILES_DMB();
   list->fl_files = tmp;
+  FILES_DMB();
   list->fl_rows = row;
+  sched_unlock();
 
   /* Note: If assertion occurs, the fl_rows has a overflow.
    * And there may be file descriptors leak in system.
@@ -185,7 +238,18 @@ void files_releaselist(FAR struct filelist *list)
       kmm_free(list->fl_files[i]);
     }
 
-  kmm_free(list->fl_files);
+  if (list->fl_files != NULL)
+    {
+      kmm_free(FILES_BLOCK(list->fl_files));
+    }
+
+  while (list->fl_retired != NULL)
+    {
+      FAR void **block = list->fl_retired;
+
+      list->fl_retired = *block;
+      kmm_free(block);
+    }
 
   /* Destroy the mutex */
 
@@ -403,7 +467,9 @@ out:
  *
  * Description:
  *   Given a file descriptor, return the corresponding instance of struct
- *   file.
+ *   file.  The lookup does not take fl_lock:  rows never move once they
+ *   are allocated and replaced arrays of row pointers stay valid until the
+ *   list is released, so only open, close and dup serialize on it.
  *
  * Input Parameters:
  *   fd    - The file descriptor
@@ -418,7 +484,8 @@ out:
 int fs_getfilep(int fd, FAR struct file **filep)
 {
   FAR struct filelist *list;
-  int ret;
+  FAR struct file **files;
+  int rows;
 
 #ifdef CONFIG_FDCHECK
   fd = fdcheck_restore(fd);
@@ -441,36 +508,34 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  if (fd < 0 || fd >= list->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
-    {
-      return -EBADF;
-    }
-
-  /* The descriptor is in a valid range to file descriptor... Get the
-   * thread-specific file list.
+  /* Read the row count before the array of rows.  files_extend()
+   * publishes them in the opposite order, so 'files' holds at least 'rows'
+   * rows.
    */
 
-  /* And return the file pointer from the list */
+  rows = *(FAR volatile uint8_t *)&list->fl_rows;
+  FILES_DMB();
+  files = *(FAR struct file ** FAR volatile *)&list->fl_files;
 
-  ret = nxmutex_lock(&list->fl_lock);
-  if (ret < 0)
+  if (fd < 0 || fd >= rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
     {
-      return ret;
+      return -EBADF;
     }
 
-  *filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
-                          [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  /* And return the file pointer from the list */
+
+  *filep = &files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
+                 [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
 
   /* if f_inode is NULL, fd was closed */
 
   if (!(*filep)->f_inode)
     {
       *filep = NULL;
-      ret = -EBADF;
+      return -EBADF;
     }
 
-  nxmutex_unlock(&list->fl_lock);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -25,27 +25,36 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-/****************************************************************************
- * Private Types
- ****************************************************************************/
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* The inode tree is protected by a reader-writer lock.  The writer holds
+ * g_inode_lock, which also makes the write lock recursive.  Readers are
+ * only counted; they wait on g_inode_lock only while a writer actually
+ * owns the tree.  A writer that finds readers inside waits on
+ * g_inode_wrsem until the last one leaves.  New readers are still
+ * admitted while a writer waits so that nested read locks can never
+ * deadlock against it.
+ */
+
 static rmutex_t g_inode_lock = NXRMUTEX_INITIALIZER;
+static sem_t g_inode_wrsem = NXSEM_INITIALIZER(0, SEM_PRIO_NONE);
+static subsys_lock_t g_inode_rdlock = SUBSYS_LOCK_INITIALIZER("inode");
+static int g_inode_readers;              /* Number of readers inside */
+static bool g_inode_writing;             /* A writer owns the tree */
+static bool g_inode_wrwait;              /* A writer waits for readers */
 
 /****************************************************************************
  * Public Functions
@@ -71,24 +80,182 @@ void inode_initialize(void)
  * Name: inode_lock
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Get exclusive access to the in-memory inode tree.  The lock is
+ *   recursive.
  *
  ****************************************************************************/
 
 int inode_lock(void)
 {
-  return nxrmutex_lock(&g_inode_lock);
+  irqstate_t flags;
+  int ret;
+
+  /* Nested write lock? */
+
+  if (nxrmutex_is_hold(&g_inode_lock))
+    {
+      return nxrmutex_lock(&g_inode_lock);
+    }
+
+  /* Exclude other writers, then wait until the readers have left */
+
+  ret = nxrmutex_lock(&g_inode_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      flags = subsys_lock(&g_inode_rdlock);
+      if (g_inode_readers == 0)
+        {
+          g_inode_writing = true;
+          subsys_unlock(&g_inode_rdlock, flags);
+          return OK;
+        }
+
+      g_inode_wrwait = true;
+      subsys_unlock(&g_inode_rdlock, flags);
+
+      nxsem_wait_uninterruptible(&g_inode_wrsem);
+    }
 }
 
 /****************************************************************************
  * Name: inode_unlock
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Relinquish exclusive access to the in-memory inode tree.
  *
  ****************************************************************************/
 
 void inode_unlock(void)
 {
+  irqstate_t flags;
+
+  DEBUGASSERT(nxrmutex_is_hold(&g_inode_lock));
+
+  if (g_inode_lock.count == 1)
+    {
+      flags = subsys_lock(&g_inode_rdlock);
+      g_inode_writing = false;
+      subsys_unlock(&g_inode_rdlock, flags);
+    }
+
+  DEBUGVERIFY(nxrmutex_unlock(&g_inode_lock));
+}
+
+/****************************************************************************
+ * Name: inode_rlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree.  Any number of readers
+ *   may search the tree concurrently.  Read locks may be nested, and may
+ *   be taken by the holder of the write lock, but a reader must never
+ *   take the write lock.
+ *
+ ****************************************************************************/
+
+int inode_rlock(void)
+{
+  irqstate_t flags;
+  int ret;
+
+  /* The writer already has the tree for itself */
+
+  if (nxrmutex_is_hold(&g_inode_lock))
+    {
+      return nxrmutex_lock(&g_inode_lock);
+    }
+
+  flags = subsys_lock(&g_inode_rdlock);
+  if (!g_inode_writing)
+    {
+      g_inode_readers++;
+      subsys_unlock(&g_inode_rdlock, flags);
+      return OK;
+    }
+
+  subsys_unlock(&g_inode_rdlock, flags);
+
+  /* A writer owns the tree.  Wait for it to finish by taking the write
+   * lock, and enter as a reader before releasing it again.
+   */
+
+  ret = nxrmutex_lock(&g_inode_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = subsys_lock(&g_inode_rdlock);
+  g_inode_readers++;
+  subsys_unlock(&g_inode_rdlock, flags);
+
   DEBUGVERIFY(nxrmutex_unlock(&g_inode_lock));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inode_runlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree.
+ *
+ ****************************************************************************/
+
+void inode_runlock(void)
+{
+  irqstate_t flags;
+  bool wake = false;
+
+  if (nxrmutex_is_hold(&g_inode_lock))
+    {
+      DEBUGVERIFY(nxrmutex_unlock(&g_inode_lock));
+      return;
+    }
+
+  flags = subsys_lock(&g_inode_rdlock);
+  DEBUGASSERT(g_inode_readers > 0);
+  if (--g_inode_readers == 0 && g_inode_wrwait)
+    {
+      g_inode_wrwait = false;
+      wake = true;
+    }
+
+  subsys_unlock(&g_inode_rdlock, flags);
+
+  if (wake)
+    {
+      nxsem_post(&g_inode_wrsem);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_addcrefs
+ *
+ * Description:
+ *   Add 'count' to the reference count of 'node' and return the new
+ *   count.  The count never drops below zero.  Readers must use this since
+ *   they may update the count concurrently.
+ *
+ ****************************************************************************/
+
+int inode_addcrefs(FAR struct inode *node, int count)
+{
+  irqstate_t flags;
+  int crefs;
+
+  flags = subsys_lock(&g_inode_rdlock);
+  crefs = node->i_crefs + count;
+  if (crefs < 0)
+    {
+      crefs = 0;
+    }
+
+  node->i_crefs = crefs;
+  subsys_unlock(&g_inode_rdlock, flags);
+
+  return crefs;
 }
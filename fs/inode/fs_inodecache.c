@@ -0,0 +1,268 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_INODE_CACHE_SIZE & (CONFIG_FS_INODE_CACHE_SIZE - 1)) != 0
+#  error CONFIG_FS_INODE_CACHE_SIZE must be a power of two
+#endif
+
+#define INODE_CACHE_MASK   (CONFIG_FS_INODE_CACHE_SIZE - 1)
+
+/* Marks an entry without a relative path */
+
+#define INODE_CACHE_NOREL  UINT8_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached search result.  Only the offsets of the residual path and of
+ * the relative path are kept; they are re-applied to the caller's copy of
+ * the (identical) path on a hit.
+ */
+
+struct inode_cache_s
+{
+  uint32_t gen;                                /* Tree generation */
+  uint32_t hash;                               /* Hash of path[] */
+  FAR struct inode *node;                      /* Inode found */
+  FAR struct inode *peer;                      /* Node to the "left" */
+  FAR struct inode *parent;                    /* Node "above" */
+  uint8_t pathoff;                             /* Offset of residual path */
+  uint8_t reloff;                              /* Offset of relpath */
+  char path[CONFIG_FS_INODE_CACHE_PATHLEN];    /* Absolute path */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+
+/* Entries are valid only if they carry the current generation.  Zero is
+ * never a valid generation so that the zeroed table starts out empty.
+ */
+
+static uint32_t g_inode_cache_gen = 1;
+static struct inode_cache_stats_s g_inode_cache_stats;
+
+/* Lookups run under the read lock of the inode tree, so concurrent
+ * readers serialize their accesses to the table with this leaf lock.
+ */
+
+static subsys_lock_t g_inode_cache_lock =
+  SUBSYS_LOCK_INITIALIZER("inodecache");
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of 'path' and its length in 'len'.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the absolute path desc->path in the path lookup cache.  On a
+ *   hit, the search descriptor is filled in exactly as _inode_search()
+ *   would have done.
+ *
+ * Returned Value:
+ *   Zero (OK) on a hit; -ENOENT if the path is not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, possibly only for reading
+ *
+ ****************************************************************************/
+
+int inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR const char *path = desc->path;
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  hash  = inode_cache_hash(path, &len);
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+
+  flags = subsys_lock(&g_inode_cache_lock);
+  if (entry->gen != g_inode_cache_gen || entry->hash != hash ||
+      len >= CONFIG_FS_INODE_CACHE_PATHLEN ||
+      memcmp(entry->path, path, len + 1) != 0)
+    {
+      g_inode_cache_stats.misses++;
+      subsys_unlock(&g_inode_cache_lock, flags);
+      return -ENOENT;
+    }
+
+  desc->path    = path + entry->pathoff;
+  desc->node    = entry->node;
+  desc->peer    = entry->peer;
+  desc->parent  = entry->parent;
+  desc->relpath = entry->reloff == INODE_CACHE_NOREL ?
+                  NULL : path + entry->reloff;
+
+  g_inode_cache_stats.hits++;
+  subsys_unlock(&g_inode_cache_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of a successful search of the absolute 'path'.
+ *   Results that went through a soft link are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, possibly only for reading
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return;
+    }
+
+  /* A soft link leaves the residual and relative paths pointing into the
+   * link target or into an allocated buffer rather than into 'path'.
+   */
+
+  if (desc->path < path || desc->path > path + len ||
+      (desc->relpath != NULL &&
+       (desc->relpath < path || desc->relpath > path + len)))
+    {
+      return;
+    }
+
+  entry          = &g_inode_cache[hash & INODE_CACHE_MASK];
+  flags          = subsys_lock(&g_inode_cache_lock);
+  entry->gen     = g_inode_cache_gen;
+  entry->hash    = hash;
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->pathoff = desc->path - path;
+  entry->reloff  = desc->relpath == NULL ?
+                   INODE_CACHE_NOREL : desc->relpath - path;
+  memcpy(entry->path, path, len + 1);
+  subsys_unlock(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all cached paths.  Must be called whenever the inode tree, or the
+ *   mountpoint or soft link state of one of its nodes, is changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock for writing
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+
+  /* Moving to a new generation invalidates all entries at once.  Clear
+   * the table on the (unlikely) wrap around so that no stale entry can
+   * match again.
+   */
+
+  flags = subsys_lock(&g_inode_cache_lock);
+  if (++g_inode_cache_gen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cache_gen = 1;
+    }
+
+  g_inode_cache_stats.invalidations++;
+  subsys_unlock(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_stats
+ *
+ * Description:
+ *   Return a snapshot of the path lookup cache statistics.
+ *
+ ****************************************************************************/
+
+void inode_cache_stats(FAR struct inode_cache_stats_s *stats)
+{
+  *stats = g_inode_cache_stats;
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -43,7 +43,8 @@
  *   associated with a path.  This is accomplished by calling inode_search().
  *   inode_find() is a simple wrapper around inode_search().  The primary
  *   difference between inode_find() and inode_search is that inode_find()
- *   will lock the inode tree and increment the reference count on the inode.
+ *   will lock the inode tree (for reading) and increment the reference
+ *   count on the inode.
  *
  ****************************************************************************/
 
@@ -55,7 +56,7 @@ int inode_find(FAR struct inode_search_s *desc)
    * references on the node.
    */
 
-  ret = inode_lock();
+  ret = inode_rlock();
   if (ret < 0)
     {
       return ret;
@@ -71,9 +72,9 @@ int inode_find(FAR struct inode_search_s *desc)
 
       /* Increment the reference count on the inode */
 
-      node->i_crefs++;
+      inode_addcrefs(node, 1);
     }
 
-  inode_unlock();
+  inode_runlock();
   return ret;
 }
@@ -47,6 +47,7 @@
 
 void inode_release(FAR struct inode *node)
 {
+  int crefs;
   int ret;
 
   if (node)
@@ -55,7 +56,7 @@ void inode_release(FAR struct inode *node)
 
       do
         {
-          ret = inode_lock();
+          ret = inode_rlock();
 
           /* This only possible error is due to cancellation of the thread.
            * We need to try again anyway in this case, otherwise the
@@ -66,30 +67,22 @@ void inode_release(FAR struct inode *node)
         }
       while (ret < 0);
 
-      if (node->i_crefs)
-        {
-          node->i_crefs--;
-        }
+      crefs = inode_addcrefs(node, -1);
+      inode_runlock();
 
       /* If the subtree was previously deleted and the reference
        * count has decrement to zero,  then delete the inode
        * now.
        */
 
-      if (node->i_crefs <= 0 && (node->i_flags & FSNODEFLAG_DELETED) != 0)
+      if (crefs <= 0 && (node->i_flags & FSNODEFLAG_DELETED) != 0)
         {
           /* If the inode has been properly unlinked, then the peer pointer
            * should be NULL.
            */
 
-          inode_unlock();
-
           DEBUGASSERT(node->i_peer == NULL);
           inode_free(node);
         }
-      else
-        {
-          inode_unlock();
-        }
     }
 }
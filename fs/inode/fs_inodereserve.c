@@ -125,6 +125,10 @@ static void inode_insert(FAR struct inode *node,
       node->i_parent  = parent;
       parent->i_child = node;
     }
+
+  /* The neighbours of the new node have changed */
+
+  inode_cache_invalidate();
 }
 
 /****************************************************************************
@@ -470,6 +470,9 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_CACHE
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -492,7 +495,22 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Try the path lookup cache before walking the tree */
+
+  path = desc->path;
+  ret  = inode_cache_lookup(desc);
+  if (ret < 0)
+    {
+      ret = _inode_search(desc);
+      if (ret >= 0)
+        {
+          inode_cache_insert(path, desc);
+        }
+    }
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
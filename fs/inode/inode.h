@@ -109,6 +109,17 @@ struct inode_search_s
   bool nofollow;             /* true: Don't follow terminal soft link */
 };
 
+/* Statistics of the path lookup cache */
+
+#ifdef CONFIG_FS_INODE_CACHE
+struct inode_cache_stats_s
+{
+  uint32_t hits;             /* Lookups satisfied from the cache */
+  uint32_t misses;           /* Lookups that had to walk the tree */
+  uint32_t invalidations;    /* Number of times the cache was flushed */
+};
+#endif
+
 /* Callback used by foreach_inode to traverse all inodes in the pseudo-
  * file system.
  */
@@ -151,7 +162,8 @@ void inode_initialize(void);
  * Name: inode_lock
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (tree_sem).
+ *   Get exclusive access to the in-memory inode tree.  Required to modify
+ *   the tree.  The lock is recursive.
  *
  ****************************************************************************/
 
@@ -161,12 +173,45 @@ int inode_lock(void);
  * Name: inode_unlock
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (tree_sem).
+ *   Relinquish exclusive access to the in-memory inode tree.
  *
  ****************************************************************************/
 
 void inode_unlock(void);
 
+/****************************************************************************
+ * Name: inode_rlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree.  Enough to search the
+ *   tree; reference counts must then be changed with inode_addcrefs().
+ *   Read locks may be nested, but a reader must never take the write lock.
+ *
+ ****************************************************************************/
+
+int inode_rlock(void);
+
+/****************************************************************************
+ * Name: inode_runlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree.
+ *
+ ****************************************************************************/
+
+void inode_runlock(void);
+
+/****************************************************************************
+ * Name: inode_addcrefs
+ *
+ * Description:
+ *   Add 'count' to the reference count of 'node' and return the new
+ *   count.  The count never drops below zero.
+ *
+ ****************************************************************************/
+
+int inode_addcrefs(FAR struct inode *node, int count);
+
 /****************************************************************************
  * Name: inode_checkflags
  *
@@ -203,6 +248,73 @@ int inode_checkflags(FAR struct inode *inode, int oflags);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the absolute path desc->path in the path lookup cache.  On a
+ *   hit, the search descriptor is filled in exactly as _inode_search()
+ *   would have done.
+ *
+ * Returned Value:
+ *   Zero (OK) on a hit; -ENOENT if the path is not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+int inode_cache_lookup(FAR struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of a successful search of the absolute 'path'.
+ *   Results that went through a soft link are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop all cached paths.  Must be called whenever the inode tree, or the
+ *   mountpoint or soft link state of one of its nodes, is changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_stats
+ *
+ * Description:
+ *   Return a snapshot of the path lookup cache statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_stats(FAR struct inode_cache_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -75,6 +75,13 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  FAR uint8_t          *rabuf;     /* Read-ahead buffer */
+  size_t                ranblocks; /* Size of rabuf in device blocks */
+  off_t                 rablock;   /* First device block in rabuf */
+  size_t                racount;   /* Valid device blocks in rabuf */
+  off_t                 ranext;    /* Device block after the last read */
+#endif
 };
 
 /****************************************************************************
@@ -902,28 +909,131 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
  *
  ****************************************************************************/
 
+static int littlefs_read_device(FAR struct littlefs_mountpt_s *fs,
+                                off_t block, size_t nblocks,
+                                FAR void *buffer)
+{
+  FAR struct inode *drv = fs->drv;
+  int ret;
+
+  if (INODE_IS_MTD(drv))
+    {
+      ret = MTD_BREAD(drv->u.i_mtd, block, nblocks, buffer);
+    }
+  else
+    {
+      ret = drv->u.i_bops->read(drv, buffer, block, nblocks);
+    }
+
+  return ret >= 0 ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_readahead
+ *
+ * Description:
+ *   Read device blocks through the read-ahead window.  A read that follows
+ *   the previous one reloads the window starting at the requested block,
+ *   so that the next sequential reads need no device request.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+static int littlefs_readahead(FAR struct littlefs_mountpt_s *fs,
+                              off_t block, size_t nblocks,
+                              FAR void *buffer)
+{
+  FAR struct mtd_geometry_s *geo = &fs->geo;
+  off_t end = block + nblocks;
+  off_t devblocks;
+  size_t count;
+  int ret;
+
+  /* Is the whole request in the window? */
+
+  if (fs->racount > 0 && block >= fs->rablock &&
+      end <= fs->rablock + fs->racount)
+    {
+      memcpy(buffer, fs->rabuf + (block - fs->rablock) * geo->blocksize,
+             nblocks * geo->blocksize);
+      fs->ranext = end;
+      return OK;
+    }
+
+  /* Random and large reads go straight to the device */
+
+  if (block != fs->ranext || nblocks >= fs->ranblocks)
+    {
+      fs->ranext = end;
+      return littlefs_read_device(fs, block, nblocks, buffer);
+    }
+
+  /* Sequential read: fill the window, but not beyond the device */
+
+  devblocks = (off_t)geo->neraseblocks * (geo->erasesize / geo->blocksize);
+  count     = fs->ranblocks;
+  if (block + count > devblocks)
+    {
+      count = devblocks - block;
+    }
+
+  fs->racount = 0;
+  ret = littlefs_read_device(fs, block, count, fs->rabuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fs->rablock = block;
+  fs->racount = count;
+  fs->ranext  = end;
+
+  memcpy(buffer, fs->rabuf, nblocks * geo->blocksize);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_readahead_invalidate
+ *
+ * Description:
+ *   Drop the read-ahead window if it overlaps device blocks that are being
+ *   changed.
+ *
+ ****************************************************************************/
+
+static void littlefs_readahead_invalidate(FAR struct littlefs_mountpt_s *fs,
+                                          off_t block, size_t nblocks)
+{
+  if (fs->racount > 0 && block < fs->rablock + (off_t)fs->racount &&
+      block + (off_t)nblocks > fs->rablock)
+    {
+      fs->racount = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ ****************************************************************************/
+
 static int littlefs_read_block(FAR const struct lfs_config *c,
                                lfs_block_t block, lfs_off_t off,
                                FAR void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
-  FAR struct inode *drv = fs->drv;
-  int ret;
 
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
-  if (INODE_IS_MTD(drv))
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  if (fs->rabuf != NULL)
     {
-      ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
-    }
-  else
-    {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
+      return littlefs_readahead(fs, block, size, buffer);
     }
+#endif
 
-  return ret >= 0 ? OK : ret;
+  return littlefs_read_device(fs, block, size, buffer);
 }
 
 /****************************************************************************
@@ -942,6 +1052,10 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  littlefs_readahead_invalidate(fs, block, size);
+#endif
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
@@ -970,6 +1084,12 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
       FAR struct mtd_geometry_s *geo = &fs->geo;
       size_t size = c->block_size / geo->erasesize;
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+      littlefs_readahead_invalidate(fs, block * c->block_size /
+                                    geo->blocksize,
+                                    c->block_size / geo->blocksize);
+#endif
+
       block = block * c->block_size / geo->erasesize;
       ret = MTD_ERASE(drv->u.i_mtd, block, size);
     }
@@ -1107,13 +1227,45 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.cache_size     = fs->geo.blocksize *
                            CONFIG_FS_LITTLEFS_CACHE_SIZE_FACTOR;
 
+#ifdef CONFIG_FS_LITTLEFS_CACHE_AUTO
+  /* Double the cache while it remains a factor of the block size, which
+   * keeps it a multiple of the read and program sizes too.
+   */
+
+  while (fs->cfg.cache_size * 2 <= CONFIG_FS_LITTLEFS_CACHE_MAX &&
+         fs->cfg.block_size % (fs->cfg.cache_size * 2) == 0)
+    {
+      fs->cfg.cache_size *= 2;
+    }
+#endif
+
 #if CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0
+#  ifdef CONFIG_FS_LITTLEFS_CACHE_AUTO
+  fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
+                                   fs->cfg.cache_size);
+#  else
   fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
                                    fs->cfg.read_size);
+#  endif
 #else
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  /* Allocate the read-ahead window */
+
+  fs->ranblocks = CONFIG_FS_LITTLEFS_READAHEAD / fs->geo.blocksize;
+  if (fs->ranblocks > 1)
+    {
+      fs->rabuf = kmm_malloc(fs->ranblocks * fs->geo.blocksize);
+      if (fs->rabuf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_fs;
+        }
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1158,6 +1310,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  kmm_free(fs->rabuf);
+#endif
   nxmutex_destroy(&fs->lock);
   kmm_free(fs);
 errout_with_block:
@@ -1217,6 +1372,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+      kmm_free(fs->rabuf);
+#endif
       nxmutex_destroy(&fs->lock);
       kmm_free(fs);
     }
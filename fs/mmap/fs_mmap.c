@@ -28,6 +28,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <debug.h>
@@ -66,7 +67,8 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
      prot,
      flags,
      { NULL }, /* priv.p */
-     NULL      /* munmap */
+     NULL,     /* munmap */
+     NULL      /* msync */
     };
 
   /* Since only a tiny subset of mmap() functionality, we have to verify many
@@ -179,6 +181,68 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
                     prot, flags, offset, true, mapped);
 }
 
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Return the address at which the file data is directly accessible in
+ *   memory, e.g. ROMFS on XIP media or TMPFS.  Unlike file_mmap(), this
+ *   never falls back to copying the file into allocated memory and no
+ *   mapping is registered, so nothing has to be unmapped.  The address
+ *   stays valid only as long as the file is neither truncated nor
+ *   extended.
+ *
+ * Input Parameters:
+ *   filep  - The file to access
+ *   offset - Offset of the region in the file
+ *   length - Length of the region
+ *   mapped - The location to return the address of the region
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTTY if the file data is not directly
+ *   accessible; another negated errno value on other failures.
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, off_t offset, size_t length,
+                     FAR void **mapped)
+{
+  struct mm_map_entry_s entry;
+  int ret;
+
+  /* Only the file systems map their data without registering a mapping
+   * that would have to be unmapped again.
+   */
+
+  if (filep == NULL || filep->f_inode == NULL ||
+      !INODE_IS_MOUNTPT(filep->f_inode) ||
+      filep->f_inode->u.i_mops->mmap == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  if (length == 0 || (filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(&entry, 0, sizeof(entry));
+  entry.length = length;
+  entry.offset = offset;
+  entry.prot   = PROT_READ;
+  entry.flags  = MAP_SHARED;
+
+  ret = filep->f_inode->u.i_mops->mmap(filep, &entry);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(entry.munmap == NULL);
+  *mapped = entry.vaddr;
+  return OK;
+}
+
 /****************************************************************************
  * Name: mmap
  *
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mm/map.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/sched.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_msync
+ *
+ * Description:
+ *   Equivalent to the standard msync() function except it does not set
+ *   the errno variable.
+ *
+ ****************************************************************************/
+
+int file_msync(FAR void *start, size_t length, int flags)
+{
+  FAR struct mm_map_entry_s *entry;
+  int ret;
+
+  if ((flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0 ||
+      (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_map_lock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  entry = mm_map_find(get_current_mm(), start, length);
+  if (entry == NULL)
+    {
+      ret = -ENOMEM;
+    }
+  else if (entry->msync != NULL)
+    {
+      ret = entry->msync(entry, start, length, flags);
+    }
+
+  mm_map_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   msync() writes the modifications of the mapped pages in the range
+ *   'start' to 'start' + 'length' back to the file mapped.  Mappings of
+ *   files accessed directly in memory have nothing to write back.
+ *
+ * Input Parameters:
+ *   start  - The start address of the range, within a mapping
+ *   length - The length of the range
+ *   flags  - MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE.  The data
+ *            is always written back synchronously.
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set: EINVAL
+ *   if 'flags' is invalid, ENOMEM if the range is not mapped.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *start, size_t length, int flags)
+{
+  int ret;
+
+  ret = file_msync(start, length, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
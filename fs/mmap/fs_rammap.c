@@ -28,9 +28,13 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/param.h>
 
+#include <nuttx/crc32.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
@@ -40,22 +44,140 @@
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
- * Public Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#define RAMMAP_PAGESIZE CONFIG_FS_RAMMAP_PAGESIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a mapping.  A writable shared mapping holds a reference to
+ * the backing file and a CRC of each page as last read from or written to
+ * the file, so that only the pages modified are written back.
+ */
+
+struct rammap_s
+{
+  struct file file;      /* The backing file, if written back */
+  bool        kernel;    /* Allocated with kmm_malloc rather than kumm */
+  bool        writeback; /* A writable shared mapping */
+  size_t      nvalid;    /* Bytes of the mapping backed by the file */
+  uint32_t    crc[1];    /* CRC of each page, if written back */
+};
+
+#define SIZEOF_RAMMAP_S(n) \
+  (sizeof(struct rammap_s) + ((n) - 1) * sizeof(uint32_t))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write back the pages of the mapping modified within the 'length' bytes
+ *   at 'offset' from its start.
+ *
+ ****************************************************************************/
+
+static int rammap_writeback(FAR struct mm_map_entry_s *entry,
+                            size_t offset, size_t length)
+{
+  FAR struct rammap_s *priv = entry->priv.p;
+  FAR uint8_t *vaddr = entry->vaddr;
+  size_t page = offset / RAMMAP_PAGESIZE;
+  size_t end = MIN(offset + length, priv->nvalid);
+  ssize_t nwritten;
+  uint32_t crc;
+  size_t pos;
+  size_t n;
+
+  if (!priv->writeback)
+    {
+      return OK;
+    }
+
+  for (pos = page * RAMMAP_PAGESIZE; pos < end;
+       pos += RAMMAP_PAGESIZE, page++)
+    {
+      n   = MIN(RAMMAP_PAGESIZE, priv->nvalid - pos);
+      crc = crc32(vaddr + pos, n);
+      if (crc == priv->crc[page])
+        {
+          continue;
+        }
+
+      nwritten = file_pwrite(&priv->file, vaddr + pos, n,
+                             entry->offset + pos);
+      if (nwritten != (ssize_t)n)
+        {
+          ferr("ERROR: Write back failed: offset=%zu ret=%zd\n",
+               (size_t)entry->offset + pos, nwritten);
+          return nwritten < 0 ? (int)nwritten : -EIO;
+        }
+
+      priv->crc[page] = crc;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rammap_free
+ ****************************************************************************/
+
+static void rammap_free(FAR struct mm_map_entry_s *entry)
+{
+  FAR struct rammap_s *priv = entry->priv.p;
+
+  if (priv->kernel)
+    {
+      kmm_free(entry->vaddr);
+    }
+  else
+    {
+      kumm_free(entry->vaddr);
+    }
+
+  if (priv->writeback)
+    {
+      file_close(&priv->file);
+    }
+
+  kmm_free(priv);
+}
+
+/****************************************************************************
+ * Name: msync_rammap
+ ****************************************************************************/
+
+static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
+                        size_t length, int flags)
+{
+  size_t offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+
+  /* The data is copied, so writes are always synchronous */
+
+  return rammap_writeback(entry, offset,
+                          MIN(length, entry->length - offset));
+}
+
+/****************************************************************************
+ * Name: unmap_rammap
+ ****************************************************************************/
+
 static int unmap_rammap(FAR struct task_group_s *group,
                         FAR struct mm_map_entry_s *entry,
                         FAR void *start,
                         size_t length)
 {
+  FAR struct rammap_s *priv = entry->priv.p;
   FAR void *newaddr;
   off_t offset;
-  bool kernel = entry->priv.i;
-  int ret = OK;
+  int ret;
 
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
@@ -77,20 +199,21 @@ static int unmap_rammap(FAR struct task_group_s *group,
 
   length = entry->length - offset;
 
+  /* Write back the modified pages before they go away */
+
+  ret = rammap_writeback(entry, offset, length);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Are we unmapping the entire region (offset == 0)? */
 
   if (length >= entry->length)
     {
       /* Free the region */
 
-      if (kernel)
-        {
-          kmm_free(entry->vaddr);
-        }
-      else
-        {
-          kumm_free(entry->vaddr);
-        }
+      rammap_free(entry);
 
       /* Then remove the mapping from the list */
 
@@ -103,18 +226,19 @@ static int unmap_rammap(FAR struct task_group_s *group,
 
   else
     {
-      if (kernel)
+      if (priv->kernel)
         {
-          newaddr = kmm_realloc(entry->vaddr, length);
+          newaddr = kmm_realloc(entry->vaddr, offset);
         }
       else
         {
-          newaddr = kumm_realloc(entry->vaddr, length);
+          newaddr = kumm_realloc(entry->vaddr, offset);
         }
 
       DEBUGASSERT(newaddr == entry->vaddr);
-      entry->vaddr = newaddr;
-      entry->length = length;
+      entry->vaddr  = newaddr;
+      entry->length = offset;
+      priv->nvalid  = MIN(priv->nvalid, offset);
     }
 
   return ret;
@@ -129,6 +253,8 @@ static int unmap_rammap(FAR struct task_group_s *group,
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   The pages of a writable shared mapping that were modified are written
+ *   back to the file on msync() and munmap().
  *
  * Input Parameters:
  *   filep   file descriptor of the backing file -- required.
@@ -152,11 +278,14 @@ static int unmap_rammap(FAR struct task_group_s *group,
 int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
            bool kernel)
 {
+  FAR struct rammap_s *priv;
   FAR uint8_t *rdbuffer;
+  size_t length = entry->length;
+  size_t npages;
+  size_t pos;
   ssize_t nread;
   off_t fpos;
   int ret;
-  size_t length = entry->length;
 
   /* There is a major design flaw that I have not yet thought of fix for:
    * The goal is to have a single region of memory that represents a single
@@ -171,12 +300,33 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
    * Not very useful!
    */
 
+  /* Allocate the state of the mapping, with a page CRC table if the
+   * changes are to be written back to the file.
+   */
+
+  npages = (length + RAMMAP_PAGESIZE - 1) / RAMMAP_PAGESIZE;
+  if ((entry->flags & MAP_SHARED) == 0 || (entry->prot & PROT_WRITE) == 0 ||
+      (filep->f_oflags & O_WROK) == 0)
+    {
+      npages = 0;
+    }
+
+  priv = kmm_zalloc(SIZEOF_RAMMAP_S(MAX(npages, 1)));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->kernel = kernel;
+  entry->priv.p = priv;
+
   /* Allocate a region of memory of the specified size */
 
   rdbuffer = kernel ? kmm_malloc(length) : kumm_malloc(length);
   if (!rdbuffer)
     {
       ferr("ERROR: Region allocation failed, length: %zu\n", length);
+      kmm_free(priv);
       return -ENOMEM;
     }
 
@@ -217,6 +367,8 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
               ret = nread;
               goto errout_with_region;
             }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -235,11 +387,33 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
   /* Zero any memory beyond the amount read from the file */
 
   memset(rdbuffer, 0, length);
+  priv->nvalid = entry->length - length;
+
+  /* Keep a reference to the file and the CRC of the pages read, to write
+   * back the pages modified on msync() and munmap().
+   */
+
+  if (npages > 0)
+    {
+      ret = file_dup2(filep, &priv->file);
+      if (ret < 0)
+        {
+          goto errout_with_region;
+        }
+
+      priv->writeback = true;
+      rdbuffer = entry->vaddr;
+      for (pos = 0; pos < priv->nvalid; pos += RAMMAP_PAGESIZE)
+        {
+          priv->crc[pos / RAMMAP_PAGESIZE] =
+            crc32(rdbuffer + pos, MIN(RAMMAP_PAGESIZE, priv->nvalid - pos));
+        }
+    }
 
   /* Add the buffer to the list of regions */
 
-  entry->priv.i = kernel;
   entry->munmap = unmap_rammap;
+  entry->msync  = msync_rammap;
 
   ret = mm_map_add(get_current_mm(), entry);
   if (ret < 0)
@@ -250,15 +424,7 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
   return OK;
 
 errout_with_region:
-  if (kernel)
-    {
-      kmm_free(entry->vaddr);
-    }
-  else
-    {
-      kumm_free(entry->vaddr);
-    }
-
+  rammap_free(entry);
   return ret;
 }
 
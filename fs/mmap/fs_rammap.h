@@ -30,8 +30,9 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Only writable shared mappings are written back, and only on msync() and
+ *   munmap().  The modified pages are found by comparing the CRC of each
+ *   page with that of the data last read or written.
  * - There are not access privileges.
  */
 
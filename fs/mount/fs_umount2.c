@@ -137,6 +137,10 @@ int nx_umount2(FAR const char *target, unsigned int flags)
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
 
+  /* Paths below the node no longer end at a mountpoint */
+
+  inode_cache_invalidate();
+
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   /* If the node has children, then do not delete it. */
 
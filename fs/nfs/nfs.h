@@ -125,6 +125,15 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#ifdef CONFIG_NFS_ATTRCACHE
+EXTERN FAR const struct nfs_fattr *
+            nfs_attrcache_find(FAR struct nfsmount *nmp,
+              FAR const char *relpath);
+EXTERN void nfs_attrcache_add(FAR struct nfsmount *nmp,
+              FAR const char *relpath,
+              FAR const struct nfs_fattr *attributes);
+EXTERN void nfs_attrcache_flush(FAR struct nfsmount *nmp);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
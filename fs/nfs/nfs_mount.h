@@ -49,6 +49,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
@@ -61,6 +62,19 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NFS_ATTRCACHE
+/* The attributes returned by stat() for a path, kept for
+ * CONFIG_NFS_ATTRCACHE_TIMEOUT seconds.
+ */
+
+struct nfs_attrcache_s
+{
+  FAR char                 *ac_path;          /* Relative path, or NULL */
+  clock_t                   ac_time;          /* Time of the LOOKUP */
+  struct nfs_fattr          ac_attr;          /* Attributes of the path */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -79,6 +93,10 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#ifdef CONFIG_NFS_ATTRCACHE
+  uint8_t                   nm_attrnext;      /* Next nm_attrcache to replace */
+  struct nfs_attrcache_s    nm_attrcache[CONFIG_NFS_ATTRCACHE_ENTRIES];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
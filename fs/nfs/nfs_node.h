@@ -70,6 +70,16 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t        *n_rabuf;      /* Read-ahead buffer of nm_rsize bytes */
+  off_t               n_raoffset;   /* File offset of its data */
+  uint16_t            n_ralen;      /* Number of bytes it holds */
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+  FAR uint8_t        *n_wbbuf;      /* Write-behind buffer of nm_wsize bytes */
+  off_t               n_wboffset;   /* File offset of its data */
+  uint16_t            n_wblen;      /* Number of bytes held back in it */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
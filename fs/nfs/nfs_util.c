@@ -36,6 +36,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -123,6 +125,29 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
   struct nfs_reply_header replyh;
   int error;
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Forget the attributes cached for stat() when anything is modified */
+
+  switch (procnum)
+    {
+      case NFSPROC_SETATTR:
+      case NFSPROC_WRITE:
+      case NFSPROC_CREATE:
+      case NFSPROC_MKDIR:
+      case NFSPROC_SYMLINK:
+      case NFSPROC_MKNOD:
+      case NFSPROC_REMOVE:
+      case NFSPROC_RMDIR:
+      case NFSPROC_RENAME:
+      case NFSPROC_LINK:
+        nfs_attrcache_flush(nmp);
+        break;
+
+      default:
+        break;
+    }
+#endif
+
   error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
                           request, reqlen, response, resplen);
   if (error != 0)
@@ -526,3 +551,113 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
 }
+
+#ifdef CONFIG_NFS_ATTRCACHE
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Return the attributes of a path cached by nfs_attrcache_add() less than
+ *   CONFIG_NFS_ATTRCACHE_TIMEOUT seconds ago, or NULL.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+FAR const struct nfs_fattr *nfs_attrcache_find(FAR struct nfsmount *nmp,
+                                               FAR const char *relpath)
+{
+  FAR struct nfs_attrcache_s *entry;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_ENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (entry->ac_path != NULL && strcmp(entry->ac_path, relpath) == 0)
+        {
+          if (now - entry->ac_time < SEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT))
+            {
+              return &entry->ac_attr;
+            }
+
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Cache the attributes of a path just looked up, replacing those of the
+ *   same path or else the oldest ones.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_add(FAR struct nfsmount *nmp, FAR const char *relpath,
+                       FAR const struct nfs_fattr *attributes)
+{
+  FAR struct nfs_attrcache_s *entry = NULL;
+  size_t len;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_ENTRIES; i++)
+    {
+      if (nmp->nm_attrcache[i].ac_path != NULL &&
+          strcmp(nmp->nm_attrcache[i].ac_path, relpath) == 0)
+        {
+          entry = &nmp->nm_attrcache[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      entry = &nmp->nm_attrcache[nmp->nm_attrnext];
+      nmp->nm_attrnext = (nmp->nm_attrnext + 1) %
+                         CONFIG_NFS_ATTRCACHE_ENTRIES;
+
+      len = strlen(relpath) + 1;
+      kmm_free(entry->ac_path);
+      entry->ac_path = kmm_malloc(len);
+      if (entry->ac_path == NULL)
+        {
+          return;
+        }
+
+      memcpy(entry->ac_path, relpath, len);
+    }
+
+  entry->ac_time = clock_systime_ticks();
+  entry->ac_attr = *attributes;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_flush
+ *
+ * Description:
+ *   Forget all of the cached attributes.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_ENTRIES; i++)
+    {
+      kmm_free(nmp->nm_attrcache[i].ac_path);
+      nmp->nm_attrcache[i].ac_path = NULL;
+    }
+}
+#endif
@@ -135,6 +135,16 @@ static int     nfs_filechstat(FAR struct nfsmount *nmp,
 static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR void *buffer, size_t buflen, FAR bool *eof);
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const void *buffer, size_t buflen,
+                   FAR int *committed);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_flush(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
 
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
@@ -143,6 +153,9 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fsinfo(FAR struct nfsmount *nmp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
@@ -201,7 +214,11 @@ const struct mountpt_operations g_nfs_operations =
   NULL,                         /* mmap */
   nfs_truncate,                 /* truncate */
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  nfs_sync,                     /* sync */
+#else
   NULL,                         /* sync */
+#endif
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
   nfs_fchstat,                  /* fchstat */
@@ -634,6 +651,319 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Perform one READ RPC of at most buflen bytes at the provided offset.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.  *eof is set if the end of the file was reached.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                           off_t offset, FAR void *buffer, size_t buflen,
+                           FAR bool *eof)
+{
+  ssize_t                    readsize;
+  ssize_t                    tmp;
+  size_t                     reqlen;
+  FAR uint32_t              *ptr;
+  int                        ret;
+
+  /* Make sure that the attempted read size does not exceed the RPC
+   * maximum
+   */
+
+  readsize = buflen;
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer
+   * size
+   */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %zu bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication */
+
+  *eof = *ptr++ != 0;
+
+  /* Then the length of the read data followed by the read data itself */
+
+  readsize = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  /* Copy the read data into the caller's buffer */
+
+  memcpy(buffer, ptr, readsize);
+  return readsize;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpc
+ *
+ * Description:
+ *   Perform one WRITE RPC of at most buflen bytes at the provided offset.
+ *   *committed is the commitment level asked for, and is updated to the
+ *   lowest level obtained.
+ *
+ * Returned Value:
+ *   The (positive) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t offset,
+                            FAR const void *buffer, size_t buflen,
+                            FAR int *committed)
+{
+  ssize_t              writesize;
+  ssize_t              bufsize;
+  size_t               reqlen;
+  FAR uint32_t        *ptr;
+  uint32_t             tmp;
+  int                  commit;
+  int                  ret;
+
+  /* Make sure that the attempted write size does not exceed the RPC
+   * maximum.
+   */
+
+  writesize = buflen;
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO
+   * buffer size.
+   */
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls message lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+              nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(*committed);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  /* Perform the write */
+
+  nfs_statistics(NFSPROC_WRITE);
+  ret = nfs_request(nmp, NFSPROC_WRITE,
+                    nmp->nm_iobuffer, reqlen,
+                    &nmp->nm_msgbuffer.write,
+                    sizeof(struct rpc_reply_write));
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > writesize)
+    {
+      return -EIO;
+    }
+
+  /* Determine the lowest commitment level obtained by any of the RPCs. */
+
+  commit = *ptr++;
+  if (*committed == NFSV3WRITE_FILESYNC)
+    {
+      *committed = commit;
+    }
+  else if (*committed == NFSV3WRITE_DATASYNC &&
+           commit == NFSV3WRITE_UNSTABLE)
+    {
+      *committed = commit;
+    }
+
+  return tmp;
+}
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+/****************************************************************************
+ * Name: nfs_flush
+ *
+ * Description:
+ *   Write the data held back by nfs_write() to the server.  The data is
+ *   dropped if it cannot be written.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the NFS mount structure
+ *
+ ****************************************************************************/
+
+static int nfs_flush(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  int committed = NFSV3WRITE_FILESYNC;
+  ssize_t ret = OK;
+  size_t offset;
+
+  for (offset = 0; offset < np->n_wblen; offset += ret)
+    {
+      ret = nfs_writerpc(nmp, np, np->n_wboffset + offset,
+                         np->n_wbbuf + offset, np->n_wblen - offset,
+                         &committed);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  np->n_wblen = 0;
+  return ret < 0 ? (int)ret : OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_open
  *
@@ -771,6 +1101,7 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+  int flushret = OK;
   int ret;
 
   /* Sanity checks */
@@ -792,6 +1123,12 @@ static int nfs_close(FAR struct file *filep)
       return ret;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Write the data held back, the file is closed even if this fails */
+
+  flushret = nfs_flush(nmp, np);
+#endif
+
   /* Decrement the reference count.  If the reference count would not
    * decrement to zero, then that is all we have to do.
    */
@@ -840,6 +1177,12 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#ifdef CONFIG_NFS_READAHEAD
+              kmm_free(np->n_rabuf);
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+              kmm_free(np->n_wbbuf);
+#endif
               kmm_free(np);
               ret = OK;
               break;
@@ -849,7 +1192,7 @@ static int nfs_close(FAR struct file *filep)
 
   filep->f_priv = NULL;
   nxmutex_unlock(&nmp->nm_lock);
-  return ret;
+  return ret < 0 ? ret : flushret;
 }
 
 /****************************************************************************
@@ -869,8 +1212,10 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+#ifdef CONFIG_NFS_READAHEAD
+  off_t                      raoffset;
+#endif
+  bool                       eof;
   int                        ret = 0;
 
   finfo("Read %zu bytes from offset %jd\n",
@@ -893,6 +1238,17 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
       return (ssize_t)ret;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* The data written must be read back from the server */
+
+  ret = nfs_flush(nmp, np);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return (ssize_t)ret;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
@@ -908,102 +1264,63 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
       readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+#ifdef CONFIG_NFS_READAHEAD
+      /* Copy what the read-ahead buffer holds at the current offset */
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      raoffset = filep->f_pos - np->n_raoffset;
+      if (np->n_ralen > 0 && filep->f_pos >= np->n_raoffset &&
+          raoffset < np->n_ralen)
         {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          if (readsize > np->n_ralen - raoffset)
+            {
+              readsize = np->n_ralen - raoffset;
+            }
 
-      /* Perform the read */
+          memcpy(buffer, np->n_rabuf + raoffset, readsize);
 
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
         }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
+      /* Read a whole rsize into the read-ahead buffer for a smaller read,
+       * so that the reads following it need no RPC.
        */
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (readsize < nmp->nm_rsize)
         {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
-
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
+          if (np->n_rabuf == NULL)
+            {
+              np->n_rabuf = kmm_malloc(nmp->nm_rsize);
+            }
 
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+          if (np->n_rabuf != NULL)
+            {
+              np->n_ralen = 0;
+              tmp = nfs_readrpc(nmp, np, filep->f_pos, np->n_rabuf,
+                                nmp->nm_rsize, &eof);
+              if (tmp <= 0)
+                {
+                  ret = tmp;
+                  break;
+                }
 
-      /* Copy the read data into the user buffer */
+              np->n_raoffset = filep->f_pos;
+              np->n_ralen    = tmp;
+              continue;
+            }
+        }
+#endif
 
-      memcpy(buffer, ptr, readsize);
+      readsize = nfs_readrpc(nmp, np, filep->f_pos, buffer, readsize, &eof);
+      if (readsize < 0)
+        {
+          ret = readsize;
+          break;
+        }
 
       /* Update the read state data */
 
@@ -1013,13 +1330,12 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || readsize == 0)
         {
           break;
         }
     }
 
-errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
   return bytesread > 0 ? bytesread : ret;
 }
@@ -1039,12 +1355,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct nfsmount *nmp;
   FAR struct nfsnode  *np;
   ssize_t              writesize;
-  ssize_t              bufsize;
   ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
   int                  committed = NFSV3WRITE_FILESYNC;
   int                  ret;
 
@@ -1076,142 +1387,135 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* The read-ahead data may be overwritten */
+
+  np->n_ralen = 0;
+#endif
+
   /* Now loop until we send the entire user buffer */
 
   for (byteswritten = 0; byteswritten < buflen; )
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
-
       writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
 
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Hold back the writes smaller than wsize, and those following them
+       * at the end of the data held back, until there is wsize to send.
        */
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      if (np->n_wblen > 0 &&
+          filep->f_pos != np->n_wboffset + np->n_wblen)
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          ret = nfs_flush(nmp, np);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
+      if (np->n_wblen > 0 || writesize < nmp->nm_wsize)
+        {
+          if (np->n_wbbuf == NULL)
+            {
+              np->n_wbbuf = kmm_malloc(nmp->nm_wsize);
+            }
 
-      /* Copy the count and stable values */
+          if (np->n_wbbuf != NULL)
+            {
+              if (writesize > nmp->nm_wsize - np->n_wblen)
+                {
+                  writesize = nmp->nm_wsize - np->n_wblen;
+                }
 
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+              if (np->n_wblen == 0)
+                {
+                  np->n_wboffset = filep->f_pos;
+                }
 
-      /* Copy a chunk of the user data into the I/O buffer */
+              memcpy(np->n_wbbuf + np->n_wblen, buffer, writesize);
+              np->n_wblen += writesize;
 
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+              if (np->n_wblen == nmp->nm_wsize)
+                {
+                  ret = nfs_flush(nmp, np);
+                  if (ret < 0)
+                    {
+                      goto errout_with_lock;
+                    }
+                }
 
-      /* Perform the write */
+              goto update;
+            }
+        }
+#endif
 
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
+      writesize = nfs_writerpc(nmp, np, filep->f_pos, buffer, writesize,
+                               &committed);
+      if (writesize < 0)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
+          ret = writesize;
           goto errout_with_lock;
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+#ifdef CONFIG_NFS_WRITEBEHIND
+update:
+#endif
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+      /* Update the write state data */
 
-      /* Check if normal file attributes follow */
+      filep->f_pos += writesize;
+      byteswritten += writesize;
+      buffer       += writesize;
 
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (filep->f_pos > np->n_size)
         {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          np->n_size = filep->f_pos;
         }
+    }
 
-      /* Get the count of bytes actually written */
+errout_with_lock:
+  nxmutex_unlock(&nmp->nm_lock);
+  return byteswritten > 0 ? byteswritten : ret;
+}
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Write the data held back by nfs_write() to the server.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode *np;
+  int ret;
 
-      writesize = tmp;
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+  /* Recover our private data from the struct file instance */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      /* Update the read state data */
+  DEBUGASSERT(nmp != NULL);
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret >= 0)
+    {
+      ret = nfs_flush(nmp, np);
+      nxmutex_unlock(&nmp->nm_lock);
     }
 
-errout_with_lock:
-  nxmutex_unlock(&nmp->nm_lock);
-  return byteswritten > 0 ? byteswritten : ret;
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: nfs_dup
@@ -1343,6 +1647,21 @@ static int nfs_fchstat(FAR const struct file *filep,
       return ret;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* A later flush would undo a change of the size or of the times */
+
+  ret = nfs_flush(nmp, np);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_NFS_READAHEAD
+  np->n_ralen = 0;
+#endif
+
   /* Change the file mode, owner, group and time. */
 
   ret = nfs_filechstat(nmp, np, buf, flags);
@@ -1381,6 +1700,21 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
     {
       struct stat buf;
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Write the data held back first, it may lie beyond the new size */
+
+      ret = nfs_flush(nmp, np);
+      if (ret < 0)
+        {
+          nxmutex_unlock(&nmp->nm_lock);
+          return ret;
+        }
+#endif
+
+#ifdef CONFIG_NFS_READAHEAD
+      np->n_ralen = 0;
+#endif
+
       /* Then perform the SETATTR RPC to set the new file size */
 
       buf.st_size = length;
@@ -2157,6 +2491,9 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  nfs_attrcache_flush(nmp);
+#endif
   nxmutex_destroy(&nmp->nm_lock);
   kmm_free(nmp->nm_rpcclnt);
   kmm_free(nmp);
@@ -2831,6 +3168,9 @@ static int nfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   FAR struct nfsmount *nmp;
   struct file_handle fhandle;
   struct nfs_fattr attributes;
+#ifdef CONFIG_NFS_ATTRCACHE
+  FAR const struct nfs_fattr *cached;
+#endif
   struct timespec ts;
   int ret;
 
@@ -2851,13 +3191,29 @@ static int nfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
-  /* Get the file handle attributes of the requested node */
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Use the attributes of a recent stat() of the same path */
 
-  ret = nfs_findnode(nmp, relpath, &fhandle, &attributes, NULL);
-  if (ret != OK)
+  cached = nfs_attrcache_find(nmp, relpath);
+  if (cached != NULL)
     {
-      ferr("ERROR: nfs_findnode failed: %d\n", ret);
-      goto errout_with_lock;
+      attributes = *cached;
+    }
+  else
+#endif
+    {
+      /* Get the file handle attributes of the requested node */
+
+      ret = nfs_findnode(nmp, relpath, &fhandle, &attributes, NULL);
+      if (ret != OK)
+        {
+          ferr("ERROR: nfs_findnode failed: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+#ifdef CONFIG_NFS_ATTRCACHE
+      nfs_attrcache_add(nmp, relpath, &attributes);
+#endif
     }
 
   /* Extract the file mode, file type, and file size. */
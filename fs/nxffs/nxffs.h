@@ -261,6 +261,18 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+#ifdef CONFIG_NXFFS_INDEX
+/* This structure describes one entry of the in-memory index of the valid
+ * inode headers.
+ */
+
+struct nxffs_index_s
+{
+  uint32_t                  hash;      /* CRC32 of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -279,6 +291,12 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_index_s *index;     /* Index of the valid inode headers */
+  int                       nindex;    /* Number of entries in the index */
+  int                       maxindex;  /* Number of entries allocated */
+  bool                      idxvalid;  /* False: Searches scan the FLASH */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -570,6 +588,31 @@ int nxffs_getc(FAR struct nxffs_volume_s *volume, uint16_t reserve);
 
 void nxffs_freeentry(FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_rdentry
+ *
+ * Description:
+ *   Read the inode entry at this offset.  The block holding the inode
+ *   header must be in the cache.
+ *
+ * Input Parameters:
+ *   volume - Describes the current volume.
+ *   offset - The byte offset from the beginning of FLASH where the inode
+ *     header is expected.
+ *   entry  - A memory location to return the expanded inode header
+ *     information.
+ *
+ * Returned Value:
+ *   Zero on success.  Otherwise, a negated errno value is returned
+ *   indicating the nature of the failure.
+ *
+ * Defined in nxffs_inode.c
+ *
+ ****************************************************************************/
+
+int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry);
+
 /****************************************************************************
  * Name: nxffs_nextentry
  *
@@ -1042,6 +1085,33 @@ int nxffs_rdblkhdr(FAR struct nxffs_volume_s *volume, off_t offset,
 
 int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
+/****************************************************************************
+ * Name: nxffs_index_reset, nxffs_index_add, nxffs_index_remove, and
+ *   nxffs_index_find
+ *
+ * Description:
+ *   Maintain and search the in-memory index of the valid inode headers, so
+ *   that nxffs_findinode() does not need to scan the FLASH.
+ *
+ *   nxffs_index_reset() empties the index; nxffs_limits() then adds every
+ *   inode that it finds.  nxffs_index_add() records a header written by
+ *   nxffs_wrinode() or by the packing logic.  nxffs_index_remove() forgets
+ *   a deleted header.  nxffs_index_find() finds an inode by name,
+ *   verifying each candidate header in FLASH.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume);
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, off_t hoffset);
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry);
+#endif
+
 /****************************************************************************
  * Name: nxffs_pack
  *
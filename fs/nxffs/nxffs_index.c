@@ -0,0 +1,277 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of entries added to the index each time that it is full */
+
+#define NXFFS_INDEX_INCR 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_hash
+ ****************************************************************************/
+
+static uint32_t nxffs_index_hash(FAR const char *name)
+{
+  return crc32((FAR const uint8_t *)name, strlen(name));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_reset
+ *
+ * Description:
+ *   Empty the index, before the media is scanned for the inodes that it
+ *   holds.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume)
+{
+  volume->nindex   = 0;
+  volume->idxvalid = true;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ *
+ * Description:
+ *   Record the FLASH offset of a valid inode header.  If there is no memory
+ *   to record it, the index is given up and nxffs_findinode() goes back to
+ *   scanning the media.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   name    - The name of the inode
+ *   hoffset - The FLASH offset to its header
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const char *name, off_t hoffset)
+{
+  FAR struct nxffs_index_s *index;
+  uint32_t hash;
+  int i;
+
+  if (!volume->idxvalid)
+    {
+      return;
+    }
+
+  /* A header written again at the same offset replaces the old one */
+
+  hash = nxffs_index_hash(name);
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          volume->index[i].hash = hash;
+          return;
+        }
+    }
+
+  if (volume->nindex >= volume->maxindex)
+    {
+      index = kmm_realloc(volume->index,
+                          (volume->maxindex + NXFFS_INDEX_INCR) *
+                          sizeof(struct nxffs_index_s));
+      if (index == NULL)
+        {
+          fwarn("WARNING: No memory for the inode index\n");
+          kmm_free(volume->index);
+          volume->index    = NULL;
+          volume->nindex   = 0;
+          volume->maxindex = 0;
+          volume->idxvalid = false;
+          return;
+        }
+
+      volume->index     = index;
+      volume->maxindex += NXFFS_INDEX_INCR;
+    }
+
+  volume->index[volume->nindex].hash    = hash;
+  volume->index[volume->nindex].hoffset = hoffset;
+  volume->nindex++;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ *
+ * Description:
+ *   Forget the inode header at a FLASH offset, because it was deleted or
+ *   because it is not there any more.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   hoffset - The FLASH offset to the inode header
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int i;
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          volume->nindex--;
+          memmove(&volume->index[i], &volume->index[i + 1],
+                  (volume->nindex - i) * sizeof(struct nxffs_index_s));
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Find the inode with the provided name using the index.  Each inode
+ *   header recorded with the hash of the name is read back from FLASH and
+ *   the first valid one with that very name is returned.  The headers that
+ *   turn out to be deleted or moved by the packing logic are removed from
+ *   the index on the way.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success. -ENOENT is returned if there is no such
+ *   inode.  Otherwise, a negated errno is returned that indicates the
+ *   nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash;
+  off_t hoffset;
+  int ret;
+  int i;
+
+  DEBUGASSERT(volume->idxvalid);
+
+  hash = nxffs_index_hash(name);
+  i    = 0;
+
+  while (i < volume->nindex)
+    {
+      if (volume->index[i].hash != hash)
+        {
+          i++;
+          continue;
+        }
+
+      /* Bring the block with the header into the cache.  Headers never
+       * span blocks.
+       */
+
+      hoffset = volume->index[i].hoffset;
+      nxffs_ioseek(volume, hoffset);
+      ret = nxffs_rdcache(volume, volume->ioblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (volume->iooffset + SIZEOF_NXFFS_INODE_HDR > volume->geo.blocksize)
+        {
+          ret = -ENOENT;
+        }
+      else
+        {
+          ret = nxffs_rdentry(volume, hoffset, entry);
+        }
+
+      if (ret == OK)
+        {
+          if (strcmp(name, entry->name) == 0)
+            {
+              return OK;
+            }
+
+          /* A collision, or another inode written at this offset by the
+           * packing logic.  Record it under its own name.
+           */
+
+          volume->index[i].hash = nxffs_index_hash(entry->name);
+          nxffs_freeentry(entry);
+          i++;
+          continue;
+        }
+      else if (ret != -ENOENT && ret != -EIO)
+        {
+          return ret;
+        }
+
+      /* There is no inode of this name at this offset any more */
+
+      finfo("Stale index entry at offset %jd\n", (intmax_t)hoffset);
+      nxffs_index_remove(volume, hoffset);
+    }
+
+  return -ENOENT;
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
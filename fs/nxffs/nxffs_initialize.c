@@ -301,6 +301,9 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ferr("ERROR: Failed to calculate file system limits: %d\n", -ret);
 
 errout_with_buffer:
+#ifdef CONFIG_NXFFS_INDEX
+  kmm_free(volume->index);
+#endif
   kmm_free(volume->pack);
 errout_with_cache:
   kmm_free(volume->cache);
@@ -357,6 +360,12 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Rebuild the inode index from the inodes found below */
+
+  nxffs_index_reset(volume);
+#endif
+
   /* Then find the first valid inode in or beyond the first valid block */
 
   offset = block * volume->geo.blocksize;
@@ -390,6 +399,10 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       volume->inoffset = entry.hoffset;
       finfo("First inode at offset %jd\n", (intmax_t)volume->inoffset);
 
+#ifdef CONFIG_NXFFS_INDEX
+      nxffs_index_add(volume, entry.name, entry.hoffset);
+#endif
+
       /* Discard this entry and set the next offset. */
 
       offset = nxffs_inodeend(volume, &entry);
@@ -402,6 +415,10 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
     {
       while (nxffs_nextentry(volume, offset, &entry) == OK)
         {
+#ifdef CONFIG_NXFFS_INDEX
+          nxffs_index_add(volume, entry.name, entry.hoffset);
+#endif
+
           /* Discard the entry and guess the next offset. */
 
           offset = nxffs_inodeend(volume, &entry);
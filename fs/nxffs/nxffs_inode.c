@@ -37,15 +37,15 @@
 #include "nxffs.h"
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
  * Name: nxffs_rdentry
  *
  * Description:
- *   Read the inode entry at this offset.  Called only from
- *   nxffs_nextentry().
+ *   Read the inode entry at this offset.  The block holding the inode
+ *   header must be in the cache.
  *
  * Input Parameters:
  *   volume - Describes the current volume.
@@ -60,8 +60,8 @@
  *
  ****************************************************************************/
 
-static int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
-                         FAR struct nxffs_entry_s *entry)
+int nxffs_rdentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                  FAR struct nxffs_entry_s *entry)
 {
   struct nxffs_inode_s inode;
   uint32_t ecrc;
@@ -184,10 +184,6 @@ errout:
   return ret;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: nxffs_freeentry
  *
@@ -369,6 +365,15 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Look only at the inode headers recorded in the index, if it is there */
+
+  if (volume->idxvalid)
+    {
+      return nxffs_index_find(volume, name, entry);
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -686,6 +686,13 @@ static int nxffs_wrinodehdr(FAR struct nxffs_volume_s *volume,
       inode->state = INODE_STATE_FILE;
       nxffs_wrle32(inode->crc, crc);
 
+#ifdef CONFIG_NXFFS_INDEX
+      /* The header will be in FLASH when the pack buffer is written */
+
+      nxffs_index_add(volume, pack->dest.entry.name,
+                      pack->dest.entry.hoffset);
+#endif
+
       /* If any open files reference this inode, then update the open file
        * state.
        */
@@ -279,6 +279,12 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* There are no inodes left */
+
+  nxffs_index_reset(volume);
+#endif
+
   /* Check for bad blocks */
 
   ret = nxffs_badblocks(volume);
@@ -52,17 +52,22 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_boot_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
+extern const struct procfs_operations g_inodecache_operations;
 extern const struct procfs_operations g_iobinfo_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
+extern const struct procfs_operations g_memprof_operations;
 extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_stats_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
@@ -96,6 +101,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#if defined(CONFIG_SCHED_BOOTPROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOT)
+  { "boot",         &g_boot_operations,     PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_CPUINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPUINFO)
   { "cpuinfo",      &g_cpuinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -112,6 +121,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_INODE_CACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+  { "fs/inodecache", &g_inodecache_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -137,6 +151,9 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
 #  endif
   { "meminfo",      &g_meminfo_operations,  PROCFS_FILE_TYPE   },
+#  ifdef CONFIG_MM_PROFILE
+  { "memprof",      &g_memprof_operations,  PROCFS_FILE_TYPE   },
+#  endif
 #endif
 
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
@@ -170,6 +187,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_STATS
+  { "stats",        &g_stats_operations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_DEBUG_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -181,6 +202,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_VERSION)
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#if defined(CONFIG_SCHED_WORKQUEUE_LATENCY) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
@@ -487,9 +513,21 @@ static ssize_t procfs_write(FAR struct file *filep, FAR const char *buffer,
 
 static int procfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct procfs_file_s *handler;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands supported */
+  /* Recover our private data from the struct file instance */
+
+  handler = (FAR struct procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(handler);
+
+  /* Call the handler's ioctl routine, if it has one */
+
+  if (handler->procfsentry->ops->ioctl != NULL)
+    {
+      return handler->procfsentry->ops->ioctl(filep, cmd, arg);
+    }
 
   return -ENOTTY;
 }
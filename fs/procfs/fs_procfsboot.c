@@ -0,0 +1,283 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsboot.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_BOOTPROFILE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOT_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct boot_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[BOOT_LINELEN];        /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     boot_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     boot_close(FAR struct file *filep);
+static ssize_t boot_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     boot_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     boot_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_boot_operations =
+{
+  boot_open,     /* open */
+  boot_close,    /* close */
+  boot_read,     /* read */
+  NULL,          /* write */
+  boot_dup,      /* dup */
+  NULL,          /* opendir */
+  NULL,          /* closedir */
+  NULL,          /* readdir */
+  NULL,          /* rewinddir */
+  boot_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_open
+ ****************************************************************************/
+
+static int boot_open(FAR struct file *filep, FAR const char *relpath,
+                     int oflags, mode_t mode)
+{
+  FAR struct boot_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct boot_file_s *)
+    kmm_zalloc(sizeof(struct boot_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boot_close
+ ****************************************************************************/
+
+static int boot_close(FAR struct file *filep)
+{
+  FAR struct boot_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct boot_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boot_read
+ ****************************************************************************/
+
+static ssize_t boot_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct boot_file_s *bootfile;
+  FAR const char *phase;
+  struct timespec end;
+  struct timespec len;
+  size_t totalsize;
+  size_t linesize;
+  unsigned int i;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  bootfile = (FAR struct boot_file_s *)filep->f_priv;
+  DEBUGASSERT(bootfile);
+
+  /* One line per phase: the time of its end since the first mark and its
+   * duration, in microseconds.
+   */
+
+  linesize  = procfs_snprintf(bootfile->line, BOOT_LINELEN,
+                              "%-20s%12s%12s\n", "phase", "end(us)",
+                              "len(us)");
+  totalsize = procfs_memcpy(bootfile->line, linesize, buffer, buflen,
+                            &offset);
+
+  for (i = 0; totalsize < buflen &&
+              nx_bootphase(i, &phase, &end, &len) >= 0; i++)
+    {
+      linesize   = procfs_snprintf(bootfile->line, BOOT_LINELEN,
+                                   "%-20s%12lu%12lu\n", phase,
+                                   (unsigned long)(end.tv_sec * 1000000 +
+                                                   end.tv_nsec / 1000),
+                                   (unsigned long)(len.tv_sec * 1000000 +
+                                                   len.tv_nsec / 1000));
+      totalsize += procfs_memcpy(bootfile->line, linesize,
+                                 buffer + totalsize, buflen - totalsize,
+                                 &offset);
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: boot_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int boot_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct boot_file_s *oldattr;
+  FAR struct boot_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct boot_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct boot_file_s *)
+    kmm_malloc(sizeof(struct boot_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct boot_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boot_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int boot_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "boot" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BOOTPROFILE && !CONFIG_FS_PROCFS_EXCLUDE_BOOT */
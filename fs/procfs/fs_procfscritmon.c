@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -40,6 +41,8 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -54,7 +57,12 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+#  define CRITMON_LINELEN (96 + 20 * CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH)
+#  define CRITMON_NTRACES CONFIG_SCHED_CRITMONITOR_TRACER_NENTRIES
+#else
+#  define CRITMON_LINELEN 64
+#endif
 
 /****************************************************************************
  * Private Types
@@ -67,8 +75,27 @@ struct critmon_file_s
   struct procfs_file_s  base;   /* Base open file structure */
   unsigned int linesize;        /* Number of valid characters in line[] */
   char line[CRITMON_LINELEN];   /* Pre-allocated buffer for formatted lines */
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  /* The longest sections, taken when the file is opened */
+
+  uint8_t ntraces[CRITMON_TRACE_NTYPES];
+  struct critmon_trace_s traces[CRITMON_TRACE_NTYPES][CRITMON_NTRACES];
+#endif
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+/* This structure carries the read state across subsys_lock_foreach() */
+
+struct critmon_lockread_s
+{
+  FAR struct critmon_file_s *attr;
+  FAR char *buffer;
+  size_t buflen;
+  size_t totalsize;
+  FAR off_t *offset;
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -122,6 +149,9 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
   FAR struct critmon_file_s *attr;
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  int type;
+#endif
 
   finfo("Open '%s'\n", relpath);
 
@@ -146,6 +176,16 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  /* Take and reset the longest sections, the output is read in chunks */
+
+  for (type = 0; type < CRITMON_TRACE_NTYPES; type++)
+    {
+      attr->ntraces[type] = critmon_trace_snapshot(type, attr->traces[type],
+                                                   CRITMON_NTRACES, true);
+    }
+#endif
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)attr;
@@ -248,6 +288,101 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_lock
+ *
+ * Description:
+ *   Generate one "name,maxhold,nacquired" line for a subsystem lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+static void critmon_read_lock(FAR subsys_lock_t *lock, FAR void *arg)
+{
+  FAR struct critmon_lockread_s *ctx = arg;
+  struct timespec maxtime;
+  size_t linesize;
+
+  if (ctx->totalsize >= ctx->buflen)
+    {
+      return;
+    }
+
+  if (lock->max > 0)
+    {
+      up_perf_convert(lock->max, &maxtime);
+    }
+  else
+    {
+      maxtime.tv_sec = 0;
+      maxtime.tv_nsec = 0;
+    }
+
+  /* Reset the maximum */
+
+  lock->max = 0;
+
+  linesize = procfs_snprintf(ctx->attr->line, CRITMON_LINELEN,
+                             "%s,%lu.%09lu,%" PRIu32 "\n",
+                             lock->name != NULL ? lock->name : "?",
+                             (unsigned long)maxtime.tv_sec,
+                             (unsigned long)maxtime.tv_nsec,
+                             lock->nacquired);
+  ctx->totalsize += procfs_memcpy(ctx->attr->line, linesize,
+                                  ctx->buffer + ctx->totalsize,
+                                  ctx->buflen - ctx->totalsize,
+                                  ctx->offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: critmon_read_trace
+ *
+ * Description:
+ *   Generate one "type,elapsed,pid,cpu,entry,exit[,backtrace...]" line for
+ *   one of the longest sections.  The exit is 0 if the thread was switched
+ *   out.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+static size_t critmon_read_trace(FAR struct critmon_file_s *attr,
+                                 FAR const struct critmon_trace_s *trace,
+                                 int type, FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset)
+{
+  struct timespec elapsed;
+  size_t linesize;
+  int i;
+
+  up_perf_convert(trace->elapsed, &elapsed);
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "%s,%lu.%09lu,%d,%d,%p,%p",
+                             type == CRITMON_TRACE_CSECTION ?
+                             "csection" : "preemption",
+                             (unsigned long)elapsed.tv_sec,
+                             (unsigned long)elapsed.tv_nsec,
+                             (int)trace->pid, trace->cpu,
+                             trace->entry, trace->exit);
+
+#if CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH > 0
+  for (i = 0; i < trace->depth; i++)
+    {
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  CRITMON_LINELEN - linesize,
+                                  ",%p", trace->backtrace[i]);
+    }
+#else
+  UNUSED(i);
+#endif
+
+  linesize += procfs_snprintf(attr->line + linesize,
+                              CRITMON_LINELEN - linesize, "\n");
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -259,6 +394,10 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
   int cpu;
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  int type;
+  int i;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -286,6 +425,37 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
       offset += nbytes;
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+  /* Then one line for each subsystem lock */
+
+  if ((size_t)ret < buflen)
+    {
+      struct critmon_lockread_s ctx;
+
+      ctx.attr      = attr;
+      ctx.buffer    = buffer;
+      ctx.buflen    = buflen;
+      ctx.totalsize = ret;
+      ctx.offset    = &offset;
+
+      subsys_lock_foreach(critmon_read_lock, &ctx);
+      ret = ctx.totalsize;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  /* Then one line for each of the longest sections */
+
+  for (type = 0; type < CRITMON_TRACE_NTYPES; type++)
+    {
+      for (i = 0; i < attr->ntraces[type] && (size_t)ret < buflen; i++)
+        {
+          ret += critmon_read_trace(attr, &attr->traces[type][i], type,
+                                    buffer + ret, buflen - ret, &offset);
+        }
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
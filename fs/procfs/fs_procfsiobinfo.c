@@ -178,6 +178,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct iobinfo_file_s *iobfile;
   FAR struct iob_stats_s stats;
+#if CONFIG_IOB_NOWNERS > 0
+  struct iob_ownerstats_s ostats;
+  int owner;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -218,6 +222,45 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_NOWNERS > 0
+  /* Then the accounting of every owner that has a quota or ever held an
+   * I/O buffer.
+   */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "owner", "nheld", "quota", "nmax",
+                               "ndenied");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (owner = 1; owner <= CONFIG_IOB_NOWNERS; owner++)
+    {
+      if (iob_getownerstats(owner, &ostats) < 0 ||
+          (ostats.quota == 0 && ostats.nmax == 0))
+        {
+          continue;
+        }
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10d%10d%10d%10d%10d\n",
+                                   owner, ostats.nheld, ostats.quota,
+                                   ostats.nmax, ostats.ndenied);
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -102,6 +102,12 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
                              size_t buflen);
 #endif
+#ifdef CONFIG_MM_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t memprof_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+#endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static int     meminfo_dup(FAR const struct file *oldp,
@@ -147,6 +153,22 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_PROFILE
+const struct procfs_operations g_memprof_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memprof_read,   /* read */
+  memprof_write,  /* write */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -589,6 +611,191 @@ dump:
 }
 #endif
 
+/****************************************************************************
+ * Name: memprof_copy
+ *
+ * Description:
+ *   Copy the line of 'linesize' characters formatted in procfile->line to
+ *   the user buffer and advance the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+static size_t memprof_copy(FAR struct meminfo_file_s *procfile,
+                           size_t linesize, FAR char **buffer,
+                           FAR size_t *buflen, FAR off_t *offset)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(procfile->line, linesize, *buffer, *buflen,
+                           offset);
+  *buffer += copysize;
+  *buflen -= copysize;
+  return copysize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memprof_read
+ *
+ * Description:
+ *   Show the free chunk size histogram and the fragmentation of each heap,
+ *   then the estimated allocations of each call site sampled by the heap
+ *   profiler.  The fragmentation is the part of the free memory that is
+ *   not in the largest free chunk.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+static ssize_t memprof_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  FAR struct meminfo_file_s *procfile;
+  struct mm_fraginfo_s frag;
+  struct mm_profsite_s site;
+  struct mm_profinfo_s info;
+  unsigned long fragment;
+  size_t linesize;
+  size_t totalsize;
+  unsigned int index;
+  off_t offset;
+  int i;
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  mm_profile_info(&info);
+  linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                              "rate %lu samples %lu dropped %lu\n",
+                              (unsigned long)info.rate,
+                              (unsigned long)info.nsamples,
+                              (unsigned long)info.ndropped);
+  totalsize = memprof_copy(procfile, linesize, &buffer, &buflen, &offset);
+
+  /* The free chunks of each heap */
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      mm_fraginfo(entry->heap, &frag);
+
+      fragment = 0;
+      if (frag.fordblks > 0)
+        {
+          fragment = 100 - (unsigned long)((uint64_t)frag.mxordblk * 100 /
+                                           frag.fordblks);
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%13s%11s%11s%7s\n", "", "free",
+                                   "largest", "frag");
+      totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%12s:%11lu%11lu%6lu%%\n", entry->name,
+                                   (unsigned long)frag.fordblks,
+                                   (unsigned long)frag.mxordblk, fragment);
+      totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%13s%11s%11s\n", "", "size", "nfree");
+      totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+
+      for (i = 0; i < MM_FRAG_NBINS; i++)
+        {
+          if (frag.nfree[i] > 0)
+            {
+              linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                           "%13s%11lu%11lu\n", "",
+                                           1ul << i,
+                                           (unsigned long)frag.nfree[i]);
+              totalsize += memprof_copy(procfile, linesize, &buffer,
+                                        &buflen, &offset);
+            }
+        }
+    }
+
+  /* Followed by the call sites */
+
+  linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                               "%10s%11s%11s  %s\n",
+                               "nallocs", "bytes", "live", "backtrace");
+  totalsize += memprof_copy(procfile, linesize, &buffer, &buflen, &offset);
+
+  for (index = 0; buflen > 0 && mm_profile_getsite(index, &site) >= 0;
+       index++)
+    {
+      if (site.nallocs == 0)
+        {
+          continue;
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%10lu%11lu%11lu ",
+                                   (unsigned long)site.nallocs,
+                                   (unsigned long)site.nbytes,
+                                   (unsigned long)site.nlive);
+      totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+
+      for (i = 0; i < CONFIG_MM_PROFILE_DEPTH && site.backtrace[i]; i++)
+        {
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       " %p", site.backtrace[i]);
+          totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                    &offset);
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN, "%s\n",
+                                   i == 0 ? " other" : "");
+      totalsize += memprof_copy(procfile, linesize, &buffer, &buflen,
+                                &offset);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: memprof_write
+ *
+ * Description:
+ *   "reset" forgets the samples, "rate <bytes>" sets the mean number of
+ *   bytes allocated between two samples, 0 to stop sampling.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+static ssize_t memprof_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "reset", 5) == 0)
+    {
+      mm_profile_reset();
+    }
+  else if (strncmp(buffer, "rate", 4) == 0)
+    {
+      mm_profile_setrate(strtoul(buffer + 4, NULL, 0));
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_dup
  *
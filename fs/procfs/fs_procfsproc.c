@@ -43,6 +43,11 @@
 #  include <time.h>
 #endif
 
+#ifdef CONFIG_SCHED_PERF_EVENTS
+#  include <inttypes.h>
+#  include <nuttx/perf.h>
+#endif
+
 #include <nuttx/irq.h>
 #include <nuttx/tls.h>
 #include <nuttx/sched.h>
@@ -90,6 +95,16 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  PROC_PERF,                          /* Hardware performance counters */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  PROC_IO,                            /* I/O counters */
+  PROC_SCHED,                         /* Context switch counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  PROC_CPUTIME,                       /* CPU time */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -154,7 +169,7 @@ struct proc_envinfo_s
 
 static FAR const char *g_policy[4] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -181,6 +196,24 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+static ssize_t proc_perf(FAR struct proc_file_s *procfile,
+                         FAR struct tcb_s *tcb, FAR char *buffer,
+                         size_t buflen, off_t offset);
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+static ssize_t proc_io(FAR struct proc_file_s *procfile,
+                       FAR struct tcb_s *tcb, FAR char *buffer,
+                       size_t buflen, off_t offset);
+static ssize_t proc_sched(FAR struct proc_file_s *procfile,
+                          FAR struct tcb_s *tcb, FAR char *buffer,
+                          size_t buflen, off_t offset);
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -292,6 +325,32 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_PERF_EVENTS
+static const struct proc_node_s g_perf =
+{
+  "perf",         "perf",    (uint8_t)PROC_PERF,         DTYPE_FILE        /* Hardware performance counters */
+};
+#endif
+
+#ifdef CONFIG_SCHED_RUSAGE
+static const struct proc_node_s g_io =
+{
+  "io",           "io",      (uint8_t)PROC_IO,           DTYPE_FILE        /* I/O counters */
+};
+
+static const struct proc_node_s g_sched =
+{
+  "sched",        "sched",   (uint8_t)PROC_SCHED,        DTYPE_FILE        /* Context switch counters */
+};
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_cputime =
+{
+  "stat",         "stat",    (uint8_t)PROC_CPUTIME,      DTYPE_FILE        /* CPU time */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -346,6 +405,16 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  &g_perf,         /* Hardware performance counters */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  &g_io,           /* I/O counters */
+  &g_sched,        /* Context switch counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cputime,      /* CPU time */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -375,6 +444,16 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  &g_perf,         /* Hardware performance counters */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  &g_io,           /* I/O counters */
+  &g_sched,        /* Context switch counters */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cputime,      /* CPU time */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -452,13 +531,19 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   PPID:       xxxxx              Parent thread ID
  *   Group:      xxxxx              Group ID
  *   CPU:        xxx                CPU (CONFIG_SMP only)
+ *   Migrations: nnn                Moves between CPUs
+ *                                  (CONFIG_SCHED_CACHE_AFFINITY only)
  *   State:      xxxxxxxx,xxxxxxxxx {Invalid, Waiting, Ready, Running,
  *                                   Inactive},
  *                                  {Unlock, Semaphore, Signal, MQ empty,
  *                                   MQ full}
  *   Flags:      xxx                N,P,X
  *   Priority:   nnn                Decimal, 0-255
- *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC}
+ *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC,
+ *                                   SCHED_DEADLINE}
+ *   DlMisses:   nnn                Missed deadlines (SCHED_DEADLINE only)
+ *   FPU:        xxx,nnn            {Used, Unused}, switches that skipped
+ *                                  the FPU save (lazy FPU only)
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
  *
  ****************************************************************************/
@@ -558,6 +643,23 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
     }
 #endif
 
+#ifdef CONFIG_SCHED_CACHE_AFFINITY
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 "\n", "Migrations:",
+                               tcb->nmigrations);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+#endif
+
   /* Show the thread state */
 
   nxsched_get_stateinfo(tcb, state, sizeof(state));
@@ -635,6 +737,48 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
       return totalsize;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Show the number of missed deadlines */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%" PRIu32 "\n", "DlMisses:",
+                                   tcb->deadline->nmisses);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* Show the FPU ownership and the number of skipped FPU saves */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%s,%" PRIu32 "\n", "FPU:",
+                               (tcb->flags & TCB_FLAG_FPU_USED) != 0 ?
+                               "Used" : "Unused", tcb->fpuskips);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+#endif
+
   /* Show the signal mask. Note: sigset_t is uint32_t on NuttX. */
 
   linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
@@ -872,6 +1016,135 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_perf
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+static ssize_t proc_perf(FAR struct proc_file_s *procfile,
+                         FAR struct tcb_s *tcb, FAR char *buffer,
+                         size_t buflen, off_t offset)
+{
+  uint64_t counts[PERF_EVENT_MAX];
+  FAR const char *name;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int ret;
+  int i;
+
+  ret = perf_event_snapshot(tcb->pid, counts);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Output one line per event counted by this architecture */
+
+  for (i = 0; i < PERF_EVENT_MAX; i++)
+    {
+      name = perf_event_name(i);
+      if (name == NULL)
+        {
+          continue;
+        }
+
+      linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                 "%-16s %" PRIu64 "\n", name, counts[i]);
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+    }
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_io
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUSAGE
+static ssize_t proc_io(FAR struct proc_file_s *procfile,
+                       FAR struct tcb_s *tcb, FAR char *buffer,
+                       size_t buflen, off_t offset)
+{
+  size_t linesize;
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "rchar: %" PRIu64 "\n"
+                             "wchar: %" PRIu64 "\n"
+                             "syscr: %" PRIu32 "\n"
+                             "syscw: %" PRIu32 "\n",
+                             tcb->rchar, tcb->wchar,
+                             tcb->syscr, tcb->syscw);
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+
+/****************************************************************************
+ * Name: proc_sched
+ ****************************************************************************/
+
+static ssize_t proc_sched(FAR struct proc_file_s *procfile,
+                          FAR struct tcb_s *tcb, FAR char *buffer,
+                          size_t buflen, off_t offset)
+{
+  size_t linesize;
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "nr_voluntary_switches: %" PRIu32 "\n"
+                             "nr_involuntary_switches: %" PRIu32 "\n",
+                             tcb->nvcsw, tcb->nivcsw);
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_cputime
+ *
+ * Description:
+ *   Show the CPU time of the thread in nanoseconds.  The IDLE thread of
+ *   each CPU also shows the time the CPU spent in interrupt handlers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  size_t linesize;
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "cputime: %" PRIu64 "\n",
+                             nxsched_get_cputime(tcb));
+
+  if (tcb->pid < CONFIG_SMP_NCPUS)
+    {
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  STATUS_LINELEN - linesize,
+                                  "irqtime: %" PRIu64 "\n",
+                                  nxsched_get_irqtime(tcb->pid));
+    }
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1035,7 +1308,7 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   buffer    += copysize;
   remaining -= copysize;
 
-#ifdef CONFIG_STACK_COLORATION
+#if defined(CONFIG_STACK_COLORATION) || defined(CONFIG_SCHED_STACK_WATERMARK)
   if (totalsize >= buflen)
     {
       return totalsize;
@@ -1043,8 +1316,16 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
 
   /* Show the stack size */
 
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+  /* The cached mark, refined without scanning the whole stack */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld\n",
+                               "StackUsed:",
+                               (long)nxsched_stack_watermark(tcb));
+#else
   linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld\n",
                                "StackUsed:", (long)up_check_tcbstack(tcb));
+#endif
   copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
                              &offset);
 
@@ -1587,6 +1868,25 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+    case PROC_PERF: /* Hardware performance counters */
+      ret = proc_perf(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+    case PROC_IO: /* I/O counters */
+      ret = proc_io(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+
+    case PROC_SCHED: /* Context switch counters */
+      ret = proc_sched(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+    case PROC_CPUTIME: /* CPU time */
+      ret = proc_cputime(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -0,0 +1,492 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsstats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <malloc.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/net/netstats.h>
+
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+#  include "irq/irq.h"
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_STATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for the threads created between counting and taking the snapshot */
+
+#define STATS_SPARE_TASKS 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct stats_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  size_t size;                      /* Size of the snapshot */
+  FAR struct procfs_stats_s *stats; /* The snapshot taken by open() */
+};
+
+/* This structure is passed to the callbacks filling in the records */
+
+struct stats_fill_s
+{
+  FAR struct procfs_stats_s *stats; /* The header to count the records in */
+  FAR uint8_t *record;              /* The next record */
+  uint32_t capacity;                /* Records allowed */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     stats_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode);
+static int     stats_close(FAR struct file *filep);
+static ssize_t stats_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static int     stats_dup(FAR const struct file *oldp,
+                         FAR struct file *newp);
+static int     stats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_stats_operations =
+{
+  stats_open,   /* open */
+  stats_close,  /* close */
+  stats_read,   /* read */
+  NULL,         /* write */
+  stats_dup,    /* dup */
+  NULL,         /* opendir */
+  NULL,         /* closedir */
+  NULL,         /* readdir */
+  NULL,         /* rewinddir */
+  stats_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stats_count_task
+ ****************************************************************************/
+
+static void stats_count_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  (*(FAR uint32_t *)arg)++;
+}
+
+/****************************************************************************
+ * Name: stats_fill_task
+ ****************************************************************************/
+
+static void stats_fill_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct stats_fill_s *fill = arg;
+  FAR struct procfs_stats_task_s *task;
+
+  if (fill->stats->ntasks >= fill->capacity)
+    {
+      return;
+    }
+
+  task = (FAR struct procfs_stats_task_s *)fill->record;
+  fill->record += sizeof(struct procfs_stats_task_s);
+  fill->stats->ntasks++;
+
+  task->pid       = tcb->pid;
+  task->priority  = tcb->sched_priority;
+  task->state     = tcb->task_state;
+  task->flags     = tcb->flags;
+  task->stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_SCHED_CPULOAD
+  task->loadticks = tcb->ticks;
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  task->nvcsw     = tcb->nvcsw;
+  task->nivcsw    = tcb->nivcsw;
+  task->rchar     = tcb->rchar;
+  task->wchar     = tcb->wchar;
+#endif
+#if CONFIG_TASK_NAME_SIZE > 0
+  strlcpy(task->name, tcb->name, sizeof(task->name));
+#endif
+}
+
+/****************************************************************************
+ * Name: stats_count_irq and stats_fill_irq
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+static int stats_count_irq(int irq, FAR struct irq_info_s *info,
+                           FAR void *arg)
+{
+  (*(FAR uint32_t *)arg)++;
+  return 0;
+}
+
+static int stats_fill_irq(int irq, FAR struct irq_info_s *info,
+                          FAR void *arg)
+{
+  FAR struct stats_fill_s *fill = arg;
+  FAR struct procfs_stats_irq_s *record;
+  struct timespec time;
+  irqstate_t flags;
+
+  if (fill->stats->nirqs >= fill->capacity)
+    {
+      return 1;
+    }
+
+  record = (FAR struct procfs_stats_irq_s *)fill->record;
+  fill->record += sizeof(struct procfs_stats_irq_s);
+  fill->stats->nirqs++;
+
+  /* Unlike /proc/irqs, leave the counts as they are */
+
+  flags = enter_critical_section();
+#ifdef CONFIG_HAVE_LONG_LONG
+  record->count = info->count;
+#else
+  record->count = ((uint64_t)info->mscount << 32) | info->lscount;
+#endif
+  up_perf_convert(info->time, &time);
+  leave_critical_section(flags);
+
+  record->irq  = irq;
+  record->time = time.tv_sec * USEC_PER_SEC + time.tv_nsec / NSEC_PER_USEC;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: stats_heap
+ ****************************************************************************/
+
+static void stats_heap(FAR struct procfs_stats_heap_s *heap,
+                       FAR const struct mallinfo *info)
+{
+  heap->total   = info->arena;
+  heap->used    = info->uordblks;
+  heap->avail   = info->fordblks;
+  heap->largest = info->mxordblk;
+  heap->nused   = info->aordblks;
+  heap->nfree   = info->ordblks;
+}
+
+/****************************************************************************
+ * Name: stats_snapshot
+ *
+ * Description:
+ *   Allocate and fill in the snapshot of all the statistics.
+ *
+ ****************************************************************************/
+
+static FAR struct procfs_stats_s *stats_snapshot(FAR size_t *size)
+{
+  FAR struct procfs_stats_s *stats;
+  struct stats_fill_s fill;
+  struct mallinfo info;
+  uint32_t ntasks = STATS_SPARE_TASKS;
+  uint32_t nirqs = 0;
+
+  /* Size the snapshot from the current number of threads and IRQs */
+
+  nxsched_foreach(stats_count_task, &ntasks);
+#ifdef CONFIG_SCHED_IRQMONITOR
+  irq_foreach(stats_count_irq, &nirqs);
+#endif
+
+  *size = sizeof(struct procfs_stats_s) +
+          ntasks * sizeof(struct procfs_stats_task_s) +
+          nirqs * sizeof(struct procfs_stats_irq_s);
+
+  stats = kmm_zalloc(*size);
+  if (stats == NULL)
+    {
+      return NULL;
+    }
+
+  stats->version  = PROCFS_STATS_VERSION;
+  stats->hdrsize  = sizeof(struct procfs_stats_s);
+  stats->tasksize = sizeof(struct procfs_stats_task_s);
+  stats->irqsize  = sizeof(struct procfs_stats_irq_s);
+  stats->uptime   = TICK2MSEC(clock_systime_ticks());
+
+  info = kmm_mallinfo();
+  stats_heap(&stats->kheap, &info);
+#ifdef CONFIG_MM_KERNEL_HEAP
+  info = kumm_mallinfo();
+  stats_heap(&stats->uheap, &info);
+#else
+  stats->uheap = stats->kheap;
+#endif
+
+#ifdef CONFIG_MM_IOB
+  stats->iobfree = iob_navail(false);
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  ifdef CONFIG_NET_IPv4
+  stats->ipv4[0] = g_netstats.ipv4.recv;
+  stats->ipv4[1] = g_netstats.ipv4.sent;
+  stats->ipv4[2] = g_netstats.ipv4.drop;
+#  endif
+#  ifdef CONFIG_NET_IPv6
+  stats->ipv6[0] = g_netstats.ipv6.recv;
+  stats->ipv6[1] = g_netstats.ipv6.sent;
+  stats->ipv6[2] = g_netstats.ipv6.drop;
+#  endif
+#  ifdef CONFIG_NET_TCP
+  stats->tcp[0]  = g_netstats.tcp.recv;
+  stats->tcp[1]  = g_netstats.tcp.sent;
+  stats->tcp[2]  = g_netstats.tcp.drop;
+#  endif
+#  ifdef CONFIG_NET_UDP
+  stats->udp[0]  = g_netstats.udp.recv;
+  stats->udp[1]  = g_netstats.udp.sent;
+  stats->udp[2]  = g_netstats.udp.drop;
+#  endif
+#endif
+
+  /* The task records, then the IRQ records */
+
+  fill.stats    = stats;
+  fill.record   = (FAR uint8_t *)(stats + 1);
+  fill.capacity = ntasks;
+  nxsched_foreach(stats_fill_task, &fill);
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+  fill.capacity = nirqs;
+  irq_foreach(stats_fill_irq, &fill);
+#endif
+
+  /* Leave out the unused records */
+
+  *size = fill.record - (FAR uint8_t *)stats;
+  return stats;
+}
+
+/****************************************************************************
+ * Name: stats_open
+ ****************************************************************************/
+
+static int stats_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct stats_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct stats_file_s *)
+    kmm_zalloc(sizeof(struct stats_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take the snapshot now, so that reads in pieces are consistent */
+
+  procfile->stats = stats_snapshot(&procfile->size);
+  if (procfile->stats == NULL)
+    {
+      ferr("ERROR: Failed to allocate the snapshot\n");
+      kmm_free(procfile);
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_close
+ ****************************************************************************/
+
+static int stats_close(FAR struct file *filep)
+{
+  FAR struct stats_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct stats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the snapshot and the file attributes structure */
+
+  kmm_free(procfile->stats);
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_read
+ ****************************************************************************/
+
+static ssize_t stats_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct stats_file_s *procfile;
+  size_t copysize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct stats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  copysize = procfs_memcpy((FAR const char *)procfile->stats,
+                           procfile->size, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: stats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int stats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct stats_file_s *oldattr;
+  FAR struct stats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct stats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container, with its own copy of the snapshot */
+
+  newattr = (FAR struct stats_file_s *)
+    kmm_malloc(sizeof(struct stats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  newattr->base  = oldattr->base;
+  newattr->size  = oldattr->size;
+  newattr->stats = kmm_malloc(oldattr->size);
+  if (newattr->stats == NULL)
+    {
+      kmm_free(newattr);
+      return -ENOMEM;
+    }
+
+  memcpy(newattr->stats, oldattr->stats, oldattr->size);
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int stats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "stats" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_STATS */
@@ -0,0 +1,347 @@
+/****************************************************************************
+ * fs/procfs/fs_procfswqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_WORKQUEUE_LATENCY) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WQUEUE_LINELEN 256
+
+/* The number of high priority queues */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define WQUEUE_HPNQUEUES CONFIG_SMP_NCPUS
+#else
+#  define WQUEUE_HPNQUEUES 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[WQUEUE_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     wqueue_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,   /* open */
+  wqueue_close,  /* close */
+  wqueue_read,   /* read */
+  NULL,           /* write */
+  wqueue_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  wqueue_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct wqueue_file_s *)
+    kmm_zalloc(sizeof(struct wqueue_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_line
+ *
+ * Description:
+ *   Copy the formatted line of 'linesize' bytes to the user buffer.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_line(FAR struct wqueue_file_s *wqfile,
+                          FAR char *buffer, size_t buflen,
+                          FAR off_t *offset, size_t linesize)
+{
+  return procfs_memcpy(wqfile->line, linesize, buffer, buflen, offset);
+}
+
+/****************************************************************************
+ * Name: wqueue_queue
+ *
+ * Description:
+ *   Generate one line for each of the 'nqueues' queues of 'qid'.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_queue(FAR struct wqueue_file_s *wqfile,
+                           FAR char *buffer, size_t buflen,
+                           FAR off_t *offset, FAR const char *name,
+                           int qid, int nqueues)
+{
+  struct work_latency_s lat;
+  size_t totalsize = 0;
+  size_t linesize;
+  int cpu;
+  int i;
+
+  for (cpu = 0; cpu < nqueues && totalsize < buflen; cpu++)
+    {
+      if (work_latency(qid, cpu, &lat, false) < 0)
+        {
+          continue;
+        }
+
+      linesize = procfs_snprintf(wqfile->line, WQUEUE_LINELEN,
+                                 "%-8s%4d%10" PRIu32 "%10" PRIu32 " ",
+                                 name, cpu, lat.nsamples, lat.max);
+
+      for (i = 0; i < WORK_LATENCY_NBUCKETS; i++)
+        {
+          linesize += procfs_snprintf(wqfile->line + linesize,
+                                      WQUEUE_LINELEN - linesize,
+                                      " %" PRIu32, lat.bucket[i]);
+        }
+
+      linesize  += procfs_snprintf(wqfile->line + linesize,
+                                   WQUEUE_LINELEN - linesize, "\n");
+      totalsize += wqueue_line(wqfile, buffer + totalsize,
+                               buflen - totalsize, offset, linesize);
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct wqueue_file_s *wqfile;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  wqfile = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(wqfile);
+
+  /* The first line is the headers.  Bucket n of the histogram counts the
+   * works that waited less than 2^n microseconds (and at least 2^(n-1)).
+   */
+
+  totalsize = wqueue_line(wqfile, buffer, buflen, &offset,
+                          procfs_snprintf(wqfile->line, WQUEUE_LINELEN,
+                                          "%-8s%4s%10s%10s  %s\n",
+                                          "queue", "cpu", "nsamples",
+                                          "max(us)", "<1us <2us <4us ..."));
+
+#ifdef CONFIG_SCHED_HPWORK
+  totalsize += wqueue_queue(wqfile, buffer + totalsize, buflen - totalsize,
+                            &offset, "hpwork", HPWORK, WQUEUE_HPNQUEUES);
+#endif
+#if defined(CONFIG_SCHED_LPWORK) && LPWORK != HPWORK
+  totalsize += wqueue_queue(wqfile, buffer + totalsize, buflen - totalsize,
+                            &offset, "lpwork", LPWORK, 1);
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct wqueue_file_s *)
+    kmm_malloc(sizeof(struct wqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_WORKQUEUE_LATENCY &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_WQUEUE */
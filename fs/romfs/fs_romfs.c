@@ -41,6 +41,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
+#include "driver/driver.h"
 #include "fs_romfs.h"
 
 /****************************************************************************
@@ -1183,6 +1184,11 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           FAR struct inode *inode = rm->rm_blkdriver;
           if (inode)
             {
+              if (INODE_IS_BLOCK(inode))
+                {
+                  blockcache_invalidate(inode);
+                }
+
               if (INODE_IS_BLOCK(inode) && inode->u.i_bops->close != NULL)
                 {
                   inode->u.i_bops->close(inode);
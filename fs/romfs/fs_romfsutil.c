@@ -39,6 +39,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 
+#include "driver/driver.h"
 #include "fs_romfs.h"
 
 /****************************************************************************
@@ -546,8 +547,7 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
         }
       else if (inode->u.i_bops->read)
         {
-          nsectorsread =
-            inode->u.i_bops->read(inode, buffer, sector, nsectors);
+          nsectorsread = blockcache_read(inode, buffer, sector, nsectors);
         }
 
       if (nsectorsread == (ssize_t)nsectors)
@@ -35,6 +35,7 @@
 #include <fcntl.h>
 #include <debug.h>
 #include <limits.h>
+#include <sys/param.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
@@ -69,6 +70,13 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+  FAR char                   *cache;   /* Read-ahead or write-behind data */
+  size_t                     cachelen; /* Bytes in the cache */
+  size_t                     cacheoff; /* Bytes of read-ahead consumed */
+  bool                       dirty;    /* The cache holds written data */
+  bool                       sequential; /* The last operation was a read */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -266,6 +274,155 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+/****************************************************************************
+ * Name: rpmsgfs_cache_flush
+ *
+ * Description:
+ *   Send the gathered writes to the server, or move the position of the
+ *   remote file back over the read-ahead not consumed, and empty the
+ *   cache.  Done before any operation that is not a read or a write.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_cache_flush(FAR struct rpmsgfs_mountpt_s *fs,
+                               FAR struct rpmsgfs_ofile_s *hf)
+{
+  ssize_t ret = OK;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, hf->cache,
+                                 hf->cachelen);
+      if (ret >= 0 && ret != hf->cachelen)
+        {
+          ret = -EIO;
+        }
+    }
+  else if (hf->cacheoff < hf->cachelen)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd,
+                                 -(off_t)(hf->cachelen - hf->cacheoff),
+                                 SEEK_CUR);
+    }
+
+  hf->cachelen   = 0;
+  hf->cacheoff   = 0;
+  hf->dirty      = false;
+  hf->sequential = false;
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_cache_alloc
+ ****************************************************************************/
+
+static bool rpmsgfs_cache_alloc(FAR struct rpmsgfs_ofile_s *hf)
+{
+  if (hf->cache == NULL)
+    {
+      hf->cache = kmm_malloc(CONFIG_FS_RPMSGFS_CACHE_SIZE);
+    }
+
+  return hf->cache != NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_cache_read
+ *
+ * Description:
+ *   Read from the read-ahead, fetching a new one for a small read that
+ *   follows another read.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_cache_read(FAR struct rpmsgfs_mountpt_s *fs,
+                                  FAR struct rpmsgfs_ofile_s *hf,
+                                  FAR char *buffer, size_t buflen)
+{
+  ssize_t ret;
+  size_t len;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_cache_flush(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (hf->cacheoff == hf->cachelen)
+    {
+      hf->cachelen = 0;
+      hf->cacheoff = 0;
+
+      if (!hf->sequential || buflen >= CONFIG_FS_RPMSGFS_CACHE_SIZE ||
+          !rpmsgfs_cache_alloc(hf))
+        {
+          hf->sequential = true;
+          return rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+        }
+
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->cache,
+                                CONFIG_FS_RPMSGFS_CACHE_SIZE);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+
+      hf->cachelen = ret;
+    }
+
+  len = MIN(buflen, hf->cachelen - hf->cacheoff);
+  memcpy(buffer, hf->cache + hf->cacheoff, len);
+  hf->cacheoff += len;
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_cache_write
+ *
+ * Description:
+ *   Gather a small write in the cache, sending the cache first if it has
+ *   no room left.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_cache_write(FAR struct rpmsgfs_mountpt_s *fs,
+                                   FAR struct rpmsgfs_ofile_s *hf,
+                                   FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  if (!hf->dirty ||
+      hf->cachelen + buflen > CONFIG_FS_RPMSGFS_CACHE_SIZE)
+    {
+      ret = rpmsgfs_cache_flush(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (buflen >= CONFIG_FS_RPMSGFS_CACHE_SIZE || !rpmsgfs_cache_alloc(hf))
+    {
+      return rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+    }
+
+  memcpy(hf->cache + hf->cachelen, buffer, buflen);
+  hf->cachelen += buflen;
+  hf->dirty     = true;
+
+  return buflen;
+}
+
+#else
+#  define rpmsgfs_cache_flush(fs, hf) OK
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -354,6 +511,13 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
   hf->fnext = fs->fs_head;
   hf->crefs = 1;
   hf->oflags = oflags;
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+  hf->cache      = NULL;
+  hf->cachelen   = 0;
+  hf->cacheoff   = 0;
+  hf->dirty      = false;
+  hf->sequential = false;
+#endif
   fs->fs_head = hf;
 
   ret = OK;
@@ -447,14 +611,20 @@ static int rpmsgfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Send what is left of the writes and close the host file */
 
+  ret = rpmsgfs_cache_flush(fs, hf);
   rpmsgfs_client_close(fs->handle, hf->fd);
 
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+  kmm_free(hf->cache);
+#endif
   kmm_free(hf);
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
 
 okout:
   nxmutex_unlock(&fs->fs_lock);
@@ -495,7 +665,11 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+  ret = rpmsgfs_cache_read(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -547,7 +721,11 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+#if CONFIG_FS_RPMSGFS_CACHE_SIZE > 0
+  ret = rpmsgfs_cache_write(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -591,7 +769,12 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+  ret = rpmsgfs_cache_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+    }
+
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -634,7 +817,12 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+  ret = rpmsgfs_cache_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+    }
+
   if (ret == 0 && (cmd == FIONBIO || cmd == FIOCLEX || cmd == FIONCLEX))
     {
       ret = -ENOTTY;
@@ -679,10 +867,11 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = rpmsgfs_cache_flush(fs, hf);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -753,9 +942,13 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
-  /* Call the host to perform the read */
+  /* Call the host to perform the read, which must see the writes */
 
-  ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+  ret = rpmsgfs_cache_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -801,7 +994,11 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
-  ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+  ret = rpmsgfs_cache_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -846,7 +1043,11 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  ret = rpmsgfs_cache_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
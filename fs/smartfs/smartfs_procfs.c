@@ -828,6 +828,7 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                          "Unused Sectors:    %" PRIu32 "\n"
                          "Block Erases:      %" PRIu32 "\n"
                          "Sectors Per Block: %d\nSector Utilization:%d%%\n"
+                         "Scan Time:         %" PRIu32 " ms\n"
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                          "Uneven Wear Count: %" PRIu32 "\n"
 #endif
@@ -837,7 +838,8 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                   procfs_data.formatsector, procfs_data.dirsector,
                   procfs_data.freesectors, procfs_data.releasesectors,
                   procfs_data.unusedsectors, procfs_data.blockerases,
-                  procfs_data.sectorsperblk, utilization
+                  procfs_data.sectorsperblk, utilization,
+                  procfs_data.scantime
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
 #endif
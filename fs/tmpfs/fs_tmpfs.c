@@ -26,6 +26,7 @@
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <fcntl.h>
@@ -36,6 +37,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/mempool.h>
 
 #include "fs_tmpfs.h"
 
@@ -49,10 +51,27 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#if (CONFIG_FS_TMPFS_CHUNKSIZE & (CONFIG_FS_TMPFS_CHUNKSIZE - 1)) != 0
+#  error CONFIG_FS_TMPFS_CHUNKSIZE must be a power of two
 #endif
 
+/* File data layout */
+
+#define TMPFS_CHUNKSIZE        CONFIG_FS_TMPFS_CHUNKSIZE
+#define TMPFS_CHUNKMASK        (TMPFS_CHUNKSIZE - 1)
+#define TMPFS_CHUNK(pos)       ((size_t)(pos) / TMPFS_CHUNKSIZE)
+#define TMPFS_CHUNKOFF(pos)    ((size_t)(pos) & TMPFS_CHUNKMASK)
+#define TMPFS_NCHUNKS(size)    TMPFS_CHUNK((size) + TMPFS_CHUNKMASK)
+
+/* Minimum number of entries of a chunk table */
+
+#define TMPFS_MINCHUNKS        8
+
+/* Minimum number of hash buckets of a directory */
+
+#define TMPFS_MINBUCKETS       8
+#define TMPFS_BUCKET(tdo, h)   ((h) & ((tdo)->tdo_nbuckets - 1))
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -89,6 +108,21 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
+static uint32_t tmpfs_name_hash(FAR const char *name, size_t len);
+static int  tmpfs_rehash_directory(FAR struct tmpfs_directory_s *tdo,
+              unsigned int nbuckets);
+static void tmpfs_delete_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_free_directory(FAR struct tmpfs_directory_s *tdo);
+static FAR void *tmpfs_chunkpool_alloc(FAR struct mempool_s *pool,
+              size_t size);
+static void tmpfs_chunkpool_free(FAR struct mempool_s *pool,
+              FAR void *addr);
+static int  tmpfs_chunk_table(FAR struct tmpfs_file_s *tfo,
+              size_t nchunks);
+static FAR uint8_t *tmpfs_chunk_alloc(FAR struct tmpfs_file_s *tfo,
+              size_t index, bool zero);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
@@ -203,6 +237,17 @@ const struct mountpt_operations g_tmpfs_operations =
   NULL              /* chstat */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* File data chunks of all TMPFS instances come from this pool.  It is set
+ * up by the first tmpfs_bind(), which runs with the inode tree locked.
+ */
+
+static struct mempool_s g_tmpfs_chunkpool;
+static bool g_tmpfs_chunkpool_ready;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -231,11 +276,15 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
       return ret;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* Grow geometrically, but by at least some additional amount, so that
+   * adding entries to a large directory rarely reallocates it.
    */
 
   objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  if (objsize < 2 * tdo->tdo_alloc)
+    {
+      objsize = 2 * tdo->tdo_alloc;
+    }
 
   /* Realloc the directory object */
 
@@ -256,61 +305,306 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_name_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of the first 'len' characters of 'name'.
+ *
+ ****************************************************************************/
+
+static uint32_t tmpfs_name_hash(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_rehash_directory
+ *
+ * Description:
+ *   Replace the hash buckets of the directory with 'nbuckets' new ones and
+ *   re-link all entries into them.
+ *
+ ****************************************************************************/
+
+static int tmpfs_rehash_directory(FAR struct tmpfs_directory_s *tdo,
+                                  unsigned int nbuckets)
+{
+  FAR uint16_t *buckets;
+  unsigned int i;
+
+  buckets = kmm_malloc(nbuckets * sizeof(*buckets));
+  if (buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nbuckets; i++)
+    {
+      buckets[i] = TMPFS_NODIRENT;
+    }
+
+  kmm_free(tdo->tdo_buckets);
+  tdo->tdo_buckets  = buckets;
+  tdo->tdo_nbuckets = nbuckets;
+
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[i];
+      FAR uint16_t *bucket = &buckets[TMPFS_BUCKET(tdo, tde->tde_hash)];
+
+      tde->tde_next = *bucket;
+      *bucket       = i;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_delete_dirent
+ *
+ * Description:
+ *   Free the name of the directory entry 'index' and remove the entry by
+ *   replacing it with the final directory entry.
+ *
+ ****************************************************************************/
+
+static void tmpfs_delete_dirent(FAR struct tmpfs_directory_s *tdo,
+                                unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  unsigned int last = tdo->tdo_nentries - 1;
+  FAR uint16_t *link;
+
+  /* Free the object name */
+
+  if (tde->tde_name != NULL)
+    {
+      kmm_free(tde->tde_name);
+    }
+
+  /* Unlink the entry from its hash chain */
+
+  link = &tdo->tdo_buckets[TMPFS_BUCKET(tdo, tde->tde_hash)];
+  while (*link != index)
+    {
+      link = &tdo->tdo_entry[*link].tde_next;
+    }
+
+  *link = tde->tde_next;
+
+  /* Move the final directory entry into the hole, redirecting the link
+   * that refers to it.
+   */
+
+  if (index != last)
+    {
+      link = &tdo->tdo_buckets[TMPFS_BUCKET(tdo,
+                                            tdo->tdo_entry[last].tde_hash)];
+      while (*link != last)
+        {
+          link = &tdo->tdo_entry[*link].tde_next;
+        }
+
+      *link = index;
+      *tde  = tdo->tdo_entry[last];
+    }
+
+  /* And decrement the count of directory entries */
+
+  tdo->tdo_nentries = last;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_directory
+ ****************************************************************************/
+
+static void tmpfs_free_directory(FAR struct tmpfs_directory_s *tdo)
+{
+  nxrmutex_destroy(&tdo->tdo_lock);
+  kmm_free(tdo->tdo_buckets);
+  kmm_free(tdo->tdo_entry);
+  kmm_free(tdo);
+}
+
+/****************************************************************************
+ * Name: tmpfs_chunkpool_alloc and tmpfs_chunkpool_free
+ ****************************************************************************/
+
+static FAR void *tmpfs_chunkpool_alloc(FAR struct mempool_s *pool,
+                                       size_t size)
+{
+  return kmm_malloc(size);
+}
+
+static void tmpfs_chunkpool_free(FAR struct mempool_s *pool,
+                                 FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+/****************************************************************************
+ * Name: tmpfs_chunk_table
+ *
+ * Description:
+ *   Make sure that the chunk table of the file has at least 'nchunks'
+ *   entries.  The table grows geometrically so that appending to a file
+ *   reallocates it only rarely; new entries are holes.
+ *
+ ****************************************************************************/
+
+static int tmpfs_chunk_table(FAR struct tmpfs_file_s *tfo, size_t nchunks)
+{
+  FAR uint8_t **newtable;
+  size_t newcount;
+
+  if (nchunks <= tfo->tfo_nchunks)
+    {
+      return OK;
+    }
+
+  newcount = tfo->tfo_nchunks < TMPFS_MINCHUNKS ?
+             TMPFS_MINCHUNKS : 2 * tfo->tfo_nchunks;
+  if (newcount < nchunks)
+    {
+      newcount = nchunks;
+    }
+
+  newtable = kmm_realloc(tfo->tfo_chunks, newcount * sizeof(*newtable));
+  if (newtable == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(&newtable[tfo->tfo_nchunks], 0,
+         (newcount - tfo->tfo_nchunks) * sizeof(*newtable));
+
+  tfo->tfo_chunks  = newtable;
+  tfo->tfo_nchunks = newcount;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_chunk_alloc
+ *
+ * Description:
+ *   Allocate the data chunk 'index' of the file, which must be a hole.
+ *   Bytes of a chunk beyond the end of the file are always kept zero, so
+ *   the chunk is cleared unless the caller overwrites all of it.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_chunk_alloc(FAR struct tmpfs_file_s *tfo,
+                                      size_t index, bool zero)
+{
+  FAR uint8_t *chunk;
+
+  DEBUGASSERT(index < tfo->tfo_nchunks && tfo->tfo_chunks[index] == NULL);
+
+  chunk = mempool_alloc(&g_tmpfs_chunkpool);
+  if (chunk != NULL)
+    {
+      if (zero)
+        {
+          memset(chunk, 0, TMPFS_CHUNKSIZE);
+        }
+
+      tfo->tfo_chunks[index] = chunk;
+      tfo->tfo_alloc += TMPFS_CHUNKSIZE;
+    }
+
+  return chunk;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_data
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+  size_t i;
+
+  for (i = 0; i < tfo->tfo_nchunks; i++)
+    {
+      if (tfo->tfo_chunks[i] != NULL)
+        {
+          mempool_free(&g_tmpfs_chunkpool, tfo->tfo_chunks[i]);
+        }
+    }
+
+  kmm_free(tfo->tfo_chunks);
+  tfo->tfo_chunks  = NULL;
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_alloc   = 0;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of the file.  Growing the file only extends the chunk
+ *   table, the new range reads as zeros until it is written.  Shrinking it
+ *   frees the chunks past the new end.
+ *
  ****************************************************************************/
 
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
+  size_t nchunks = TMPFS_NCHUNKS(newsize);
+  size_t i;
 
   /* Are we growing or shrinking the object? */
 
-  if (newsize <= tfo->tfo_alloc)
+  if (newsize >= tfo->tfo_size)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
-
-      if (newsize > 0)
+      int ret = tmpfs_chunk_table(tfo, nchunks);
+      if (ret < 0)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          return ret;
+        }
 
-          delta = tfo->tfo_alloc - newsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      tfo->tfo_size = newsize;
+      return OK;
+    }
 
-              tfo->tfo_size = newsize;
-              return OK;
-            }
+  /* Shrinking ... Release everything if the size is shrinking to zero */
+
+  if (newsize == 0)
+    {
+      tmpfs_free_data(tfo);
+      tfo->tfo_size = 0;
+      return OK;
+    }
+
+  for (i = nchunks; i < tfo->tfo_nchunks; i++)
+    {
+      if (tfo->tfo_chunks[i] != NULL)
+        {
+          mempool_free(&g_tmpfs_chunkpool, tfo->tfo_chunks[i]);
+          tfo->tfo_chunks[i] = NULL;
+          tfo->tfo_alloc -= TMPFS_CHUNKSIZE;
         }
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* Clear the tail of the new last chunk so that a later extension of
+   * the file reads back zeros there.
    */
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-
-  /* Realloc the file object */
-
-  newdata = kmm_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  if (TMPFS_CHUNKOFF(newsize) != 0 && tfo->tfo_chunks[nchunks - 1] != NULL)
     {
-      return -ENOMEM;
+      memset(tfo->tfo_chunks[nchunks - 1] + TMPFS_CHUNKOFF(newsize), 0,
+             TMPFS_CHUNKSIZE - TMPFS_CHUNKOFF(newsize));
     }
 
-  /* Return the new address of the reallocated file object */
-
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
+  tfo->tfo_size = newsize;
   return OK;
 }
 
@@ -350,7 +644,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
     }
 
@@ -370,7 +664,8 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name, size_t len)
 {
-  int i;
+  uint32_t hash;
+  unsigned int i;
 
   if (len == 0)
     {
@@ -386,17 +681,28 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
-  /* Search the list of directory entries for a match */
+  if (tdo->tdo_nbuckets == 0)
+    {
+      return -ENOENT;
+    }
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       (strncmp(tdo->tdo_entry[i].tde_name, name, len) != 0 ||
-       tdo->tdo_entry[i].tde_name[len] != 0);
-       i++);
+  /* Search the hash chain of the name for a match */
 
-  /* Return what we found, if anything */
+  hash = tmpfs_name_hash(name, len);
+  for (i = tdo->tdo_buckets[TMPFS_BUCKET(tdo, hash)];
+       i != TMPFS_NODIRENT; i = tdo->tdo_entry[i].tde_next)
+    {
+      FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[i];
+
+      if (tde->tde_hash == hash &&
+          strncmp(tde->tde_name, name, len) == 0 &&
+          tde->tde_name[len] == '\0')
+        {
+          return i;
+        }
+    }
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  return -ENOENT;
 }
 
 /****************************************************************************
@@ -407,7 +713,6 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
                                FAR const char *name)
 {
   int index;
-  int last;
 
   /* Search the list of directory entries for a match */
 
@@ -417,24 +722,7 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       return index;
     }
 
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      kmm_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  last = tdo->tdo_nentries - 1;
-  if (index != last)
-    {
-      tdo->tdo_entry[index] = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  tmpfs_delete_dirent(tdo, index);
   return OK;
 }
 
@@ -447,10 +735,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
                             FAR const char *name)
 {
   FAR struct tmpfs_dirent_s *tde;
+  FAR uint16_t *bucket;
   FAR char *newname;
   unsigned int nentries;
   size_t namelen;
   int index;
+  int ret;
 
   /* Copy the name string so that it will persist as long as the
    * directory entry.
@@ -471,6 +761,13 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
+  /* The largest index value marks the end of a hash chain */
+
+  if (tdo->tdo_nentries >= TMPFS_NODIRENT)
+    {
+      return -ENOSPC;
+    }
+
   newname = strndup(name, namelen);
   if (newname == NULL)
     {
@@ -481,6 +778,22 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
 
   nentries = tdo->tdo_nentries + 1;
 
+  /* Keep the hash chains short by doubling the number of buckets when
+   * there are more entries than buckets.
+   */
+
+  if (nentries > tdo->tdo_nbuckets)
+    {
+      ret = tmpfs_rehash_directory(tdo, tdo->tdo_nbuckets == 0 ?
+                                   TMPFS_MINBUCKETS :
+                                   2 * tdo->tdo_nbuckets);
+      if (ret < 0)
+        {
+          kmm_free(newname);
+          return ret;
+        }
+    }
+
   /* Reallocate the directory object (if necessary) */
 
   index = tmpfs_realloc_directory(tdo, nentries);
@@ -495,6 +808,13 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   tde             = &tdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_name_hash(newname, namelen);
+
+  /* And link it into its hash chain */
+
+  bucket          = &tdo->tdo_buckets[TMPFS_BUCKET(tdo, tde->tde_hash)];
+  tde->tde_next   = *bucket;
+  *bucket         = index;
 
   return OK;
 }
@@ -519,12 +839,13 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = 0;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
-  tfo->tfo_data  = NULL;
+  tfo->tfo_alloc   = 0;
+  tfo->tfo_type    = TMPFS_REGULAR;
+  tfo->tfo_refs    = 1;
+  tfo->tfo_flags   = 0;
+  tfo->tfo_size    = 0;
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_chunks  = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -671,7 +992,9 @@ static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
   tdo->tdo_type     = TMPFS_DIRECTORY;
   tdo->tdo_refs     = 0;
   tdo->tdo_nentries = 0;
+  tdo->tdo_nbuckets = 0;
   tdo->tdo_entry    = NULL;
+  tdo->tdo_buckets  = NULL;
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -1074,9 +1397,16 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
        */
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
-      tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s) +
+                           tmptfo->tfo_nchunks * sizeof(FAR uint8_t *);
       tmpbuf->tsf_files++;
+
+      /* Holes of a sparse file may make it larger than its chunks */
+
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1091,7 +1421,8 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
       avail  = tmptdo->tdo_alloc -
                SIZEOF_TMPFS_DIRECTORY(tmptdo->tdo_nentries);
 
-      tmpbuf->tsf_alloc += sizeof(struct tmpfs_directory_s);
+      tmpbuf->tsf_alloc += sizeof(struct tmpfs_directory_s) +
+                           tmptdo->tdo_nbuckets * sizeof(uint16_t);
       tmpbuf->tsf_avail += avail;
       tmpbuf->tsf_ffree += avail / sizeof(struct tmpfs_dirent_s);
     }
@@ -1106,34 +1437,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
-
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      kmm_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
 
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
+  /* Remove the directory entry */
 
-  if (index != last)
-    {
-      /* Move the directory entry */
-
-      *tde = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index].tde_object;
+  tmpfs_delete_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1151,12 +1461,13 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       tdo = (FAR struct tmpfs_directory_s *)to;
 
+      kmm_free(tdo->tdo_buckets);
       kmm_free(tdo->tdo_entry);
     }
 
@@ -1445,7 +1756,7 @@ static int tmpfs_close(FAR struct file *filep)
        */
 
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
       return OK;
     }
@@ -1467,6 +1778,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  off_t pos;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1491,24 +1803,47 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      endpos = startpos;
+      nread  = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the memory object to the user buffer, one chunk at a
+   * time.  Holes read as zeros.
+   */
 
-  if (tfo->tfo_data != NULL)
+  for (pos = startpos; pos < endpos; )
     {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
+      FAR const uint8_t *chunk = tfo->tfo_chunks[TMPFS_CHUNK(pos)];
+      size_t offset = TMPFS_CHUNKOFF(pos);
+      size_t len = TMPFS_CHUNKSIZE - offset;
+
+      if (len > endpos - pos)
+        {
+          len = endpos - pos;
+        }
+
+      if (chunk != NULL)
+        {
+          memcpy(buffer, chunk + offset, len);
+        }
+      else
+        {
+          memset(buffer, 0, len);
+        }
+
+      buffer += len;
+      pos    += len;
     }
 
+  filep->f_pos += nread;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1526,6 +1861,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  off_t pos;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1550,29 +1886,62 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  /* Extend the chunk table to handle the write past the end of the file.
+   * The data already written is never moved.
+   */
+
+  ret = tmpfs_chunk_table(tfo, TMPFS_NCHUNKS(endpos));
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Copy data from the user buffer to the memory object, allocating the
+   * chunks that are written for the first time.
+   */
+
+  for (pos = startpos; pos < endpos; )
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      FAR uint8_t *chunk = tfo->tfo_chunks[TMPFS_CHUNK(pos)];
+      size_t offset = TMPFS_CHUNKOFF(pos);
+      size_t len = TMPFS_CHUNKSIZE - offset;
 
-      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
-      if (ret < 0)
+      if (len > endpos - pos)
         {
-          goto errout_with_lock;
+          len = endpos - pos;
+        }
+
+      if (chunk == NULL)
+        {
+          chunk = tmpfs_chunk_alloc(tfo, TMPFS_CHUNK(pos),
+                                    len < TMPFS_CHUNKSIZE);
+          if (chunk == NULL)
+            {
+              break;
+            }
         }
+
+      memcpy(chunk + offset, buffer, len);
+      buffer += len;
+      pos    += len;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Report a short write if the memory ran out on the way */
 
-  if (tfo->tfo_data != NULL)
+  nwritten = pos - startpos;
+  if (nwritten == 0 && buflen > 0)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-      filep->f_pos += nwritten;
+      ret = -ENOMEM;
+      goto errout_with_lock;
     }
-  else
+
+  if (pos > tfo->tfo_size)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      tfo->tfo_size = pos;
     }
 
+  filep->f_pos += nwritten;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1646,7 +2015,9 @@ static off_t tmpfs_seek(FAR struct file *filep, off_t offset, int whence)
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
-  int ret = -EINVAL;
+  FAR uint8_t *chunk;
+  size_t index;
+  int ret;
 
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
@@ -1656,13 +2027,50 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
-  if (map->offset >= 0 && map->offset < tfo->tfo_size &&
-      map->length && map->offset + map->length <= tfo->tfo_size)
+  if (map->offset < 0 || map->length == 0)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
-      ret = OK;
+      return -EINVAL;
+    }
+
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (map->offset >= tfo->tfo_size ||
+      map->offset + map->length > tfo->tfo_size)
+    {
+      ret = -EINVAL;
+      goto out_with_lock;
+    }
+
+  /* Only a range inside of one chunk can be mapped in place.  Let the
+   * caller fall back to a copy of the data for anything larger.
+   */
+
+  index = TMPFS_CHUNK(map->offset);
+  if (index != TMPFS_CHUNK(map->offset + map->length - 1))
+    {
+      ret = -ENOTTY;
+      goto out_with_lock;
+    }
+
+  chunk = tfo->tfo_chunks[index];
+  if (chunk == NULL)
+    {
+      chunk = tmpfs_chunk_alloc(tfo, index, true);
+      if (chunk == NULL)
+        {
+          ret = -ENOMEM;
+          goto out_with_lock;
+        }
     }
 
+  map->vaddr = chunk + TMPFS_CHUNKOFF(map->offset);
+
+out_with_lock:
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1788,26 +2196,10 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
       /* The size is changing.. up or down.  Reallocate the file memory. */
 
       ret = tmpfs_realloc_file(tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
-       */
-
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2009,10 +2401,29 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 {
   FAR struct tmpfs_directory_s *tdo;
   FAR struct tmpfs_s *fs;
+  int ret;
 
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
 
+  /* Set up the pool of file data chunks on the first mount */
+
+  if (!g_tmpfs_chunkpool_ready)
+    {
+      g_tmpfs_chunkpool.blocksize  = TMPFS_CHUNKSIZE;
+      g_tmpfs_chunkpool.expandsize = CONFIG_FS_TMPFS_CHUNKPOOL_EXPAND;
+      g_tmpfs_chunkpool.alloc      = tmpfs_chunkpool_alloc;
+      g_tmpfs_chunkpool.free       = tmpfs_chunkpool_free;
+
+      ret = mempool_init(&g_tmpfs_chunkpool, "tmpfs");
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      g_tmpfs_chunkpool_ready = true;
+    }
+
   /* Create an instance of the tmpfs file system */
 
   fs = (FAR struct tmpfs_s *)kmm_zalloc(sizeof(struct tmpfs_s));
@@ -2075,9 +2486,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Now we can destroy the root file system and the file system itself. */
 
-  nxrmutex_destroy(&tdo->tdo_lock);
-  kmm_free(tdo->tdo_entry);
-  kmm_free(tdo);
+  tmpfs_free_directory(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
   kmm_free(fs);
@@ -2122,7 +2531,8 @@ static int tmpfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
 
   tmpbuf.tsf_alloc = sizeof(struct tmpfs_s) +
                      sizeof(struct tmpfs_directory_s) +
-                     tdo->tdo_alloc;
+                     tdo->tdo_alloc +
+                     tdo->tdo_nbuckets * sizeof(uint16_t);
   tmpbuf.tsf_avail = avail;
   tmpbuf.tsf_files = 0;
   tmpbuf.tsf_ffree = avail / sizeof(struct tmpfs_dirent_s);
@@ -2243,7 +2653,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
     }
 
@@ -2384,9 +2794,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Free the directory object */
 
-  nxrmutex_destroy(&tdo->tdo_lock);
-  kmm_free(tdo->tdo_entry);
-  kmm_free(tdo);
+  tmpfs_free_directory(tdo);
 
   /* Release the reference and lock on the parent directory */
 
@@ -36,6 +36,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Marks the end of a directory hash chain */
+
+#define TMPFS_NODIRENT    UINT16_MAX
+
 /* Bit definitions for file object flags */
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
@@ -68,6 +72,8 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the same hash bucket */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -96,7 +102,9 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+  uint16_t tdo_nbuckets; /* Number of hash buckets (power of two) */
   FAR struct tmpfs_dirent_s *tdo_entry;
+  FAR uint16_t *tdo_buckets; /* First entry of each hash chain */
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
@@ -115,15 +123,16 @@ struct tmpfs_file_s
 
   rmutex_t tfo_lock;
 
-  size_t   tfo_alloc;    /* Allocated size of the file object */
+  size_t   tfo_alloc;    /* Size of the allocated data chunks */
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
 
-  /* Remaining fields are unique to a directory object */
+  /* Remaining fields are unique to a file object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;   /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;    /* Valid file size */
+  size_t        tfo_nchunks; /* Number of entries in tfo_chunks[] */
+  FAR uint8_t **tfo_chunks;  /* File data chunks, NULL for a hole */
 };
 
 /* This structure represents one instance of a TMPFS file system */
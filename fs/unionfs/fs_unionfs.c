@@ -45,15 +45,56 @@
 #include <nuttx/fs/unionfs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_UNIONFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+#  if (CONFIG_FS_UNIONFS_LOOKUP_SIZE & (CONFIG_FS_UNIONFS_LOOKUP_SIZE - 1)) != 0
+#    error CONFIG_FS_UNIONFS_LOOKUP_SIZE must be a power of two
+#  endif
+
+#  define UNIONFS_LOOKUP_MASK  (CONFIG_FS_UNIONFS_LOOKUP_SIZE - 1)
+#endif
+
+/* Results of the lookup cache */
+
+#define UNIONFS_LOOKUP_MISS    0  /* Nothing known about the path */
+#define UNIONFS_LOOKUP_FS2     1  /* Only on file system 2 */
+#define UNIONFS_LOOKUP_NOENT   2  /* On neither file system */
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+#  define unionfs_lookup_find(ui, relpath, gen) \
+     (*(gen) = 0, UNIONFS_LOOKUP_MISS)
+#  define unionfs_lookup_insert(ui, relpath, where, gen)
+#  define unionfs_lookup_flush(ui)
+#endif
+
+/* Initial number of buckets of the names remembered by readdir() */
+
+#define UNIONFS_NAMES_NBUCKETS 16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One name returned by readdir() on file system 1 */
+
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+struct unionfs_name_s
+{
+  FAR struct unionfs_name_s *un_next;  /* Next name in the same bucket */
+  uint32_t un_hash;                    /* Hash of un_name[] */
+  char un_name[1];                     /* NUL terminated name */
+};
+#endif
+
 struct unionfs_dir_s
 {
   struct fs_dirent_s fu_base;          /* Vfs directory structure */
@@ -62,7 +103,25 @@ struct unionfs_dir_s
   bool fu_prefix[2];                   /* True: Fake directory in prefix */
   FAR char *fu_relpath;                /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2]; /* dirent struct used by contained file system */
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+  FAR struct unionfs_name_s **fu_names; /* Names seen on file system 1 */
+  unsigned int fu_nbuckets;            /* Number of buckets of fu_names */
+  unsigned int fu_nnames;              /* Number of names in fu_names */
+  bool fu_nameerr;                     /* True: Some name is missing */
+#endif
+};
+
+/* One cached result of looking up a path on the contained file systems */
+
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+struct unionfs_lookup_s
+{
+  uint32_t ul_gen;                   /* Generation of the union */
+  uint32_t ul_hash;                  /* Hash of ul_path[] */
+  uint8_t ul_where;                  /* UNIONFS_LOOKUP_FS2 or _NOENT */
+  char ul_path[CONFIG_FS_UNIONFS_LOOKUP_PATHLEN];
 };
+#endif
 
 /* This structure describes one contained file system mountpoint */
 
@@ -80,6 +139,11 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+  uint32_t ui_gen;                   /* Bumped on every change of names */
+  subsys_lock_t ui_lookuplock;       /* Protects ui_lookup[] */
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_LOOKUP_SIZE];
+#endif
 };
 
 /* This structure descries one opened file */
@@ -128,6 +192,24 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
+#if defined(CONFIG_FS_UNIONFS_LOOKUP_CACHE) || \
+    defined(CONFIG_FS_UNIONFS_READDIR_HASH)
+static uint32_t unionfs_hash(FAR const char *name, FAR size_t *len);
+#endif
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+static int     unionfs_lookup_find(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, FAR uint32_t *gen);
+static void    unionfs_lookup_insert(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int where, uint32_t gen);
+static void    unionfs_lookup_flush(FAR struct unionfs_inode_s *ui);
+#endif
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+static bool    unionfs_names_find(FAR struct unionfs_dir_s *udir,
+                 FAR const char *name);
+static void    unionfs_names_add(FAR struct unionfs_dir_s *udir,
+                 FAR const char *name);
+static void    unionfs_names_free(FAR struct unionfs_dir_s *udir);
+#endif
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -742,6 +824,275 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+/****************************************************************************
+ * Name: unionfs_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of 'name' and its length in 'len'.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_UNIONFS_LOOKUP_CACHE) || \
+    defined(CONFIG_FS_UNIONFS_READDIR_HASH)
+static uint32_t unionfs_hash(FAR const char *name, FAR size_t *len)
+{
+  FAR const char *ptr = name;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+    }
+
+  *len = ptr - name;
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_lookup_find
+ *
+ * Description:
+ *   Return what the lookup cache knows of 'relpath': UNIONFS_LOOKUP_FS2,
+ *   UNIONFS_LOOKUP_NOENT or UNIONFS_LOOKUP_MISS.  The current generation
+ *   is returned in 'gen', to be passed to unionfs_lookup_insert() with the
+ *   result of the real lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+static int unionfs_lookup_find(FAR struct unionfs_inode_s *ui,
+                               FAR const char *relpath, FAR uint32_t *gen)
+{
+  FAR struct unionfs_lookup_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  int where = UNIONFS_LOOKUP_MISS;
+
+  hash  = unionfs_hash(relpath, &len);
+  entry = &ui->ui_lookup[hash & UNIONFS_LOOKUP_MASK];
+
+  flags = subsys_lock(&ui->ui_lookuplock);
+  *gen  = ui->ui_gen;
+
+  if (entry->ul_gen == ui->ui_gen && entry->ul_hash == hash &&
+      len < CONFIG_FS_UNIONFS_LOOKUP_PATHLEN &&
+      memcmp(entry->ul_path, relpath, len + 1) == 0)
+    {
+      where = entry->ul_where;
+    }
+
+  subsys_unlock(&ui->ui_lookuplock, flags);
+  return where;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_insert
+ *
+ * Description:
+ *   Remember where 'relpath' was found, unless the names of the union
+ *   changed since unionfs_lookup_find() returned 'gen'.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_insert(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath, int where,
+                                  uint32_t gen)
+{
+  FAR struct unionfs_lookup_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  hash = unionfs_hash(relpath, &len);
+  if (len >= CONFIG_FS_UNIONFS_LOOKUP_PATHLEN)
+    {
+      return;
+    }
+
+  entry = &ui->ui_lookup[hash & UNIONFS_LOOKUP_MASK];
+
+  flags = subsys_lock(&ui->ui_lookuplock);
+  if (gen == ui->ui_gen)
+    {
+      entry->ul_gen   = gen;
+      entry->ul_hash  = hash;
+      entry->ul_where = where;
+      memcpy(entry->ul_path, relpath, len + 1);
+    }
+
+  subsys_unlock(&ui->ui_lookuplock, flags);
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_flush
+ *
+ * Description:
+ *   Forget everything cached, after the names on either file system may
+ *   have changed.  As the contained file systems are removed from the
+ *   pseudo file system, they can only change through the union.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_flush(FAR struct unionfs_inode_s *ui)
+{
+  irqstate_t flags;
+
+  flags = subsys_lock(&ui->ui_lookuplock);
+
+  /* Zero is never a valid generation, so that the zeroed table starts out
+   * empty.
+   */
+
+  if (++ui->ui_gen == 0)
+    {
+      ui->ui_gen = 1;
+    }
+
+  subsys_unlock(&ui->ui_lookuplock, flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_names_find
+ *
+ * Description:
+ *   Return true if readdir() returned 'name' on file system 1.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+static bool unionfs_names_find(FAR struct unionfs_dir_s *udir,
+                               FAR const char *name)
+{
+  FAR struct unionfs_name_s *un;
+  uint32_t hash;
+  size_t len;
+
+  if (udir->fu_names == NULL)
+    {
+      return false;
+    }
+
+  hash = unionfs_hash(name, &len);
+  for (un = udir->fu_names[hash & (udir->fu_nbuckets - 1)]; un != NULL;
+       un = un->un_next)
+    {
+      if (un->un_hash == hash && strcmp(un->un_name, name) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: unionfs_names_add
+ *
+ * Description:
+ *   Remember a name returned by readdir() on file system 1.  The table
+ *   doubles whenever it holds twice as many names as buckets.  If memory
+ *   runs out, fu_nameerr is set and the duplicates are found with stat()
+ *   again.
+ *
+ ****************************************************************************/
+
+static void unionfs_names_add(FAR struct unionfs_dir_s *udir,
+                              FAR const char *name)
+{
+  FAR struct unionfs_name_s **names;
+  FAR struct unionfs_name_s *un;
+  FAR struct unionfs_name_s *next;
+  unsigned int nbuckets;
+  unsigned int i;
+  uint32_t hash;
+  size_t len;
+
+  if (udir->fu_nameerr)
+    {
+      return;
+    }
+
+  if (udir->fu_names == NULL ||
+      udir->fu_nnames >= 2 * udir->fu_nbuckets)
+    {
+      nbuckets = udir->fu_names == NULL ? UNIONFS_NAMES_NBUCKETS :
+                                          2 * udir->fu_nbuckets;
+      names    = kmm_zalloc(nbuckets * sizeof(*names));
+      if (names == NULL && udir->fu_names == NULL)
+        {
+          udir->fu_nameerr = true;
+          return;
+        }
+      else if (names != NULL)
+        {
+          /* Move the names to the larger table */
+
+          for (i = 0; i < udir->fu_nbuckets; i++)
+            {
+              for (un = udir->fu_names[i]; un != NULL; un = next)
+                {
+                  next = un->un_next;
+                  un->un_next = names[un->un_hash & (nbuckets - 1)];
+                  names[un->un_hash & (nbuckets - 1)] = un;
+                }
+            }
+
+          kmm_free(udir->fu_names);
+          udir->fu_names    = names;
+          udir->fu_nbuckets = nbuckets;
+        }
+    }
+
+  hash = unionfs_hash(name, &len);
+  un   = kmm_malloc(sizeof(struct unionfs_name_s) + len);
+  if (un == NULL)
+    {
+      udir->fu_nameerr = true;
+      return;
+    }
+
+  un->un_hash = hash;
+  memcpy(un->un_name, name, len + 1);
+
+  un->un_next = udir->fu_names[hash & (udir->fu_nbuckets - 1)];
+  udir->fu_names[hash & (udir->fu_nbuckets - 1)] = un;
+  udir->fu_nnames++;
+}
+
+/****************************************************************************
+ * Name: unionfs_names_free
+ ****************************************************************************/
+
+static void unionfs_names_free(FAR struct unionfs_dir_s *udir)
+{
+  FAR struct unionfs_name_s *un;
+  FAR struct unionfs_name_s *next;
+  unsigned int i;
+
+  if (udir->fu_names != NULL)
+    {
+      for (i = 0; i < udir->fu_nbuckets; i++)
+        {
+          for (un = udir->fu_names[i]; un != NULL; un = next)
+            {
+              next = un->un_next;
+              kmm_free(un);
+            }
+        }
+
+      kmm_free(udir->fu_names);
+    }
+
+  udir->fu_names    = NULL;
+  udir->fu_nbuckets = 0;
+  udir->fu_nnames   = 0;
+  udir->fu_nameerr  = false;
+}
+#endif
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -849,6 +1200,9 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  uint32_t gen = 0;
+  int where = UNIONFS_LOOKUP_MISS;
+  int ret0;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -858,6 +1212,19 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Opening: ui_nopen=%d\n", ui->ui_nopen);
 
+  /* Unless the file may be created, the lookup cache may tell that there
+   * is nothing to open or nothing on file system 1.
+   */
+
+  if ((oflags & O_CREAT) == 0)
+    {
+      where = unionfs_lookup_find(ui, relpath, &gen);
+      if (where == UNIONFS_LOOKUP_NOENT)
+        {
+          return -ENOENT;
+        }
+    }
+
   /* Get exclusive access to the file system data structures */
 
   ret = nxmutex_lock(&ui->ui_lock);
@@ -882,11 +1249,17 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   DEBUGASSERT(um != NULL && um->um_node != NULL &&
               um->um_node->u.i_mops != NULL);
 
-  uf->uf_file.f_oflags = filep->f_oflags;
-  uf->uf_file.f_inode  = um->um_node;
+  ret0 = -ENOENT;
+  if (where != UNIONFS_LOOKUP_FS2)
+    {
+      uf->uf_file.f_oflags = filep->f_oflags;
+      uf->uf_file.f_inode  = um->um_node;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+      ret0 = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                             mode);
+    }
+
+  if (ret0 >= 0)
     {
       /* Successfully opened on file system 1 */
 
@@ -903,6 +1276,17 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 
       ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
                             mode);
+
+      /* Remember when file system 1 has nothing at this path */
+
+      if ((oflags & O_CREAT) == 0 && ret0 == -ENOENT &&
+          (ret >= 0 || ret == -ENOENT))
+        {
+          unionfs_lookup_insert(ui, relpath, ret >= 0 ?
+                                UNIONFS_LOOKUP_FS2 : UNIONFS_LOOKUP_NOENT,
+                                gen);
+        }
+
       if (ret < 0)
         {
           goto errout_with_lock;
@@ -924,6 +1308,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   ret = OK;
 
 errout_with_lock:
+  if ((oflags & O_CREAT) != 0)
+    {
+      unionfs_lookup_flush(ui);
+    }
+
   nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
@@ -1395,6 +1784,7 @@ static int unionfs_opendir(FAR struct inode *mountpt,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
   FAR struct unionfs_dir_s *udir;
+  uint32_t gen;
   int ret;
 
   finfo("relpath: \"%s\"\n", relpath ? relpath : "NULL");
@@ -1463,11 +1853,21 @@ static int unionfs_opendir(FAR struct inode *mountpt,
       udir->fu_prefix[1] = true;
     }
 
-  /* Check file system 1 last, possibly overwriting fu_ndx */
+  /* Check file system 1 last, possibly overwriting fu_ndx.  There is no
+   * need to if the lookup cache knows that it has nothing at this path.
+   */
 
   um = &ui->ui_fs[0];
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
-                           &udir->fu_lower[0]);
+  if (unionfs_lookup_find(ui, relpath, &gen) == UNIONFS_LOOKUP_FS2)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               &udir->fu_lower[0]);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 1 access info */
@@ -1583,13 +1983,17 @@ static int unionfs_closedir(FAR struct inode *mountpt,
         }
     }
 
-  /* Free any allocated path */
+  /* Free any allocated path and names */
 
   if (udir->fu_relpath != NULL)
     {
       kmm_free(udir->fu_relpath);
     }
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+  unionfs_names_free(udir);
+#endif
+
   kmm_free(udir);
 
   /* Decrement the count of open reference.  If that count would go to zero
@@ -1756,6 +2160,14 @@ static int unionfs_readdir(FAR struct inode *mountpt,
                    * in file system 1.
                    */
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+                  if (udir->fu_lower[0] != NULL && !udir->fu_nameerr)
+                    {
+                      return unionfs_names_find(udir, um->um_prefix) ?
+                             -ENOENT : OK;
+                    }
+#endif
+
                   relpath = unionfs_relpath(udir->fu_relpath, um->um_prefix);
                   if (relpath)
                     {
@@ -1829,6 +2241,23 @@ static int unionfs_readdir(FAR struct inode *mountpt,
            */
 
           duplicate = false;
+
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+          /* Remember the names on file system 1, or look up the names on
+           * file system 2 among them.
+           */
+
+          if (ret >= 0 && udir->fu_ndx == 0)
+            {
+              unionfs_names_add(udir, entry->d_name);
+            }
+          else if (ret >= 0 && udir->fu_lower[0] != NULL &&
+                   !udir->fu_nameerr)
+            {
+              duplicate = unionfs_names_find(udir, entry->d_name);
+            }
+          else
+#endif
           if (ret >= 0 && udir->fu_ndx == 1 && udir->fu_lower[0] != NULL)
             {
               /* Get the relative path to the same file on file system 1.
@@ -1902,6 +2331,12 @@ static int unionfs_rewinddir(struct inode *mountpt, struct fs_dirent_s *dir)
       udir->fu_ndx = 0;
     }
 
+#ifdef CONFIG_FS_UNIONFS_READDIR_HASH
+  /* The names of file system 1 will be read again */
+
+  unionfs_names_free(udir);
+#endif
+
   if (!udir->fu_prefix[udir->fu_ndx])
     {
       DEBUGASSERT(udir->fu_lower[udir->fu_ndx] != NULL);
@@ -2210,6 +2645,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_lookup_flush(ui);
   return ret;
 }
 
@@ -2258,6 +2694,7 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um  = &ui->ui_fs[1];
   ret2 = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
+  unionfs_lookup_flush(ui);
 
   /* We will say we were successful if we were able to create the
    * directory on either file system.  Perhaps one file system is
@@ -2303,6 +2740,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
       if (ret < 0)
         {
+          unionfs_lookup_flush(ui);
           return ret;
         }
     }
@@ -2326,6 +2764,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
     }
 
+  unionfs_lookup_flush(ui);
   return ret;
 }
 
@@ -2371,6 +2810,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
+          unionfs_lookup_flush(ui);
           return OK;
         }
     }
@@ -2392,6 +2832,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
                               um->um_prefix);
     }
 
+  unionfs_lookup_flush(ui);
   return ret;
 }
 
@@ -2404,7 +2845,10 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
-  int ret;
+  uint32_t gen;
+  int where;
+  int ret0 = -ENOENT;
+  int ret  = -ENOENT;
 
   finfo("relpath: %s\n", relpath);
 
@@ -2414,30 +2858,51 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = (FAR struct unionfs_inode_s *)mountpt->i_private;
 
+  /* Skip the file systems that an earlier lookup found nothing on */
+
+  where = unionfs_lookup_find(ui, relpath, &gen);
+
   /* stat this path on file system 1 */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  if (where == UNIONFS_LOOKUP_MISS)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um   = &ui->ui_fs[0];
+      ret0 = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret0 >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
 
-      return OK;
+          return OK;
+        }
     }
 
   /* stat failed on the file system 1.  Try again on file system 2. */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  if (where != UNIONFS_LOOKUP_NOENT)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
 
-      return OK;
+          if (where == UNIONFS_LOOKUP_MISS && ret0 == -ENOENT)
+            {
+              unionfs_lookup_insert(ui, relpath, UNIONFS_LOOKUP_FS2, gen);
+            }
+
+          return OK;
+        }
+
+      if (where == UNIONFS_LOOKUP_MISS && ret0 == -ENOENT &&
+          ret == -ENOENT)
+        {
+          unionfs_lookup_insert(ui, relpath, UNIONFS_LOOKUP_NOENT, gen);
+        }
     }
 
   /* Special case the unionfs root directory when both file systems are
@@ -2599,6 +3064,13 @@ static int unionfs_dobind(FAR const char *fspath1, FAR const char *prefix1,
 
   nxmutex_init(&ui->ui_lock);
 
+#ifdef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+  /* Generation 0 marks the entries never used */
+
+  ui->ui_gen = 1;
+  subsys_lock_initialize(&ui->ui_lookuplock, "unionfs");
+#endif
+
   /* Get the inodes associated with fspath1 and fspath2 */
 
   ret = unionfs_getmount(fspath1, &ui->ui_fs[0].um_node);
@@ -65,6 +65,12 @@ int file_close(FAR struct file *filep)
 
   if (inode)
     {
+#ifdef CONFIG_FS_POLLCACHE
+      /* Drop the registrations kept by poll() while the file is open */
+
+      poll_cache_close(filep);
+#endif
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
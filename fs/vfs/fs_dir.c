@@ -201,7 +201,7 @@ static off_t seek_pseudodir(FAR struct file *filep, off_t offset)
    * be a very unpredictable operation.
    */
 
-  inode_lock();
+  inode_rlock();
 
   for (; curr != NULL && pos != offset; pos++, curr = curr->i_peer);
 
@@ -216,10 +216,10 @@ static off_t seek_pseudodir(FAR struct file *filep, off_t offset)
     {
       /* Increment the reference count on this next node */
 
-      curr->i_crefs++;
+      inode_addcrefs(curr, 1);
     }
 
-  inode_unlock();
+  inode_runlock();
 
   if (prev != NULL)
     {
@@ -370,7 +370,7 @@ static int read_pseudodir(FAR struct fs_dirent_s *dir,
 
   /* Now get the inode to visit next time that readdir() is called */
 
-  inode_lock();
+  inode_rlock();
 
   prev       = pdir->next;
   pdir->next = prev->i_peer; /* The next node to visit */
@@ -379,10 +379,10 @@ static int read_pseudodir(FAR struct fs_dirent_s *dir,
     {
       /* Increment the reference count on this next node */
 
-      pdir->next->i_crefs++;
+      inode_addcrefs(pdir->next, 1);
     }
 
-  inode_unlock();
+  inode_runlock();
 
   if (prev != NULL)
     {
@@ -39,6 +39,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
@@ -46,9 +47,13 @@
  * Private Types
  ****************************************************************************/
 
+struct epoll_head_s;
+
 struct epoll_node_s
 {
-  struct list_node      node;
+  struct list_node      node;     /* Link in the setup/oneshot/free list */
+  struct list_node      rnode;    /* Link in the ready list */
+  FAR struct epoll_head_s *eph;   /* The epoll instance of the node */
   epoll_data_t          data;
   struct pollfd         pfd;
 };
@@ -61,13 +66,18 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  spinlock_t            rlock;    /* Protects the ready list, which is
+                                   * appended to from the poll notification
+                                   * of the drivers.
+                                   */
+  struct list_node      setup;    /* The setup list, store all the epoll
+                                   * nodes registered with their driver.
+                                   * The nodes stay registered across
+                                   * epoll_wait() calls.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      ready;    /* The ready list, store all the setup
+                                   * epoll nodes notified since they were
+                                   * last reported.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -94,9 +104,13 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
+static void epoll_default_cb(FAR struct pollfd *fds);
+static int epoll_setup(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
+static void epoll_teardown(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
+static int epoll_harvest(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents);
+static int epoll_do_wait(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents, int timeout);
 
 /****************************************************************************
  * Private Data
@@ -156,6 +170,21 @@ static FAR epoll_head_t *epoll_head_from_fd(int fd)
   return (FAR epoll_head_t *)filep->f_priv;
 }
 
+static FAR epoll_node_t *epoll_find(FAR struct list_node *list, int fd)
+{
+  FAR epoll_node_t *epn;
+
+  list_for_every_entry(list, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  return NULL;
+}
+
 static int epoll_do_open(FAR struct file *filep)
 {
   FAR epoll_head_t *eph = filep->f_priv;
@@ -201,6 +230,7 @@ static int epoll_do_close(FAR struct file *filep)
           kmm_free(epn);
         }
 
+      nxsem_destroy(&eph->sem);
       kmm_free(eph);
     }
 
@@ -237,7 +267,7 @@ static int epoll_do_create(int size, int flags)
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -260,11 +290,108 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
-static int epoll_setup(FAR epoll_head_t *eph)
+/****************************************************************************
+ * Name: epoll_default_cb
+ *
+ * Description:
+ *   The poll callback of the epoll nodes.  It is called from the poll
+ *   notification of the driver, possibly in interrupt context, and queues
+ *   the node on the ready list of its epoll instance.
+ *
+ ****************************************************************************/
+
+static void epoll_default_cb(FAR struct pollfd *fds)
+{
+  FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  int semcount = 0;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!list_in_list(&epn->rnode))
+    {
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_setup
+ *
+ * Description:
+ *   Register the node with the driver of its file descriptor.  The driver
+ *   reports the events that are already pending right away.
+ *
+ ****************************************************************************/
+
+static int epoll_setup(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  epn->eph         = eph;
+  epn->pfd.arg     = epn;
+  epn->pfd.cb      = epoll_default_cb;
+  epn->pfd.revents = 0;
+
+  return poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+}
+
+/****************************************************************************
+ * Name: epoll_teardown
+ *
+ * Description:
+ *   Unregister the node from its driver and drop it from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_teardown(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (list_in_list(&epn->rnode))
+    {
+      list_delete(&epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_harvest
+ *
+ * Description:
+ *   Report up to 'maxevents' nodes of the ready list.  The cost depends on
+ *   the number of ready nodes only, not on the number of monitored file
+ *   descriptors.
+ *
+ *   - EPOLLET nodes stay registered; the driver queues them again on the
+ *     next notification.
+ *   - EPOLLONESHOT nodes are unregistered until they are re-armed by
+ *     EPOLL_CTL_MOD.
+ *   - Level triggered nodes are registered again, so that the driver
+ *     queues them right away if the events are still pending.
+ *
+ ****************************************************************************/
+
+static int epoll_harvest(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents)
 {
-  FAR epoll_node_t *tepn;
+  struct list_node rearm = LIST_INITIAL_VALUE(rearm);
   FAR epoll_node_t *epn;
+  FAR epoll_node_t *tmp;
+  FAR struct list_node *node;
+  pollevent_t revents;
+  irqstate_t flags;
   int ret;
+  int i = 0;
 
   ret = nxmutex_lock(&eph->lock);
   if (ret < 0)
@@ -272,59 +399,152 @@ static int epoll_setup(FAR epoll_head_t *eph)
       return ret;
     }
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
+      flags = spin_lock_irqsave(&eph->rlock);
+      node = list_remove_head(&eph->ready);
+      if (node == NULL)
+        {
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          break;
+        }
 
+      epn              = container_of(node, epoll_node_t, rnode);
+      revents          = epn->pfd.revents;
       epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+      spin_unlock_irqrestore(&eph->rlock, flags);
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          epoll_teardown(eph, epn);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
+        }
+      else if ((epn->pfd.events & EPOLLET) == 0)
+        {
+          epoll_teardown(eph, epn);
+          list_delete(&epn->node);
+          list_add_tail(&rearm, &epn->node);
+        }
+    }
+
+  /* Re-register the level triggered nodes only now, so that a node that
+   * is still ready is not reported twice by this call.
+   */
+
+  list_for_every_entry_safe(&rearm, epn, tmp, epoll_node_t, node)
+    {
+      list_delete(&epn->node);
+      ret = epoll_setup(eph, epn);
       if (ret < 0)
         {
           ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
                epn->pfd.fd, epn->pfd.events, ret);
-          break;
-        }
 
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+          /* Park it like a oneshot node until EPOLL_CTL_MOD or DEL */
+
+          list_add_tail(&eph->oneshot, &epn->node);
+        }
+      else
+        {
+          list_add_tail(&eph->setup, &epn->node);
+        }
     }
 
   nxmutex_unlock(&eph->lock);
-  return ret;
+  return i;
 }
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+/****************************************************************************
+ * Name: epoll_do_wait
+ *
+ * Description:
+ *   Wait until the ready list is not empty or the timeout expires, then
+ *   report the ready nodes.
+ *
+ ****************************************************************************/
+
+static int epoll_do_wait(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents, int timeout)
 {
-  FAR epoll_node_t *tepn;
-  FAR epoll_node_t *epn;
-  int i = 0;
+  clock_t ticks = 0;
+  irqstate_t flags;
+  bool empty;
+  int ret;
 
-  nxmutex_lock(&eph->lock);
+  if (maxevents <= 0)
+    {
+      return -EINVAL;
+    }
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  if (timeout > 0)
     {
-      if (epn->pfd.revents != 0 && i < maxevents)
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+                (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+    }
+
+  for (; ; )
+    {
+      /* Consume stale wakeups first.  A notification that arrives after
+       * this point queues its node before posting the semaphore, so it
+       * cannot be lost.
+       */
+
+      while (nxsem_trywait(&eph->sem) == OK)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-          list_delete(&epn->node);
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+        }
+
+      flags = spin_lock_irqsave(&eph->rlock);
+      empty = list_is_empty(&eph->ready);
+      spin_unlock_irqrestore(&eph->rlock, flags);
+
+      if (empty && timeout != 0)
+        {
+          if (timeout > 0)
             {
-              list_add_tail(&eph->oneshot, &epn->node);
+              ret = nxsem_tickwait(&eph->sem, ticks);
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = OK;
+                }
             }
           else
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              ret = nxsem_wait(&eph->sem);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
             }
         }
-    }
 
-  nxmutex_unlock(&eph->lock);
-  return i;
+      ret = epoll_harvest(eph, evs, maxevents);
+
+      /* The queued events may all have been consumed already, wait again
+       * if there is no timeout to honor.
+       */
+
+      if (ret != 0 || timeout >= 0)
+        {
+          return ret;
+        }
+    }
 }
 
 /****************************************************************************
@@ -417,31 +637,11 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        if (epoll_find(&eph->setup, fd) != NULL ||
+            epoll_find(&eph->oneshot, fd) != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -470,14 +670,13 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           }
 
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
-        epn->data        = ev->data;
-        epn->pfd.events  = ev->events;
-        epn->pfd.fd      = fd;
-        epn->pfd.arg     = &eph->sem;
-        epn->pfd.cb      = poll_default_cb;
-        epn->pfd.revents = 0;
-
-        ret = poll_fdsetup(fd, &epn->pfd, true);
+        epn->data       = ev->data;
+        epn->pfd.events = ev->events;
+        epn->pfd.fd     = fd;
+
+        /* Register once, the node stays registered until it is deleted */
+
+        ret = epoll_setup(eph, epn);
         if (ret < 0)
           {
             list_add_tail(&eph->free, &epn->node);
@@ -489,111 +688,58 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(&eph->setup, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            epoll_teardown(eph, epn);
           }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        else
           {
-            if (epn->pfd.fd == fd)
+            epn = epoll_find(&eph->oneshot, fd);
+            if (epn == NULL)
               {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
+                ret = -ENOENT;
+                goto err;
               }
           }
 
+        list_delete(&epn->node);
+        list_add_tail(&eph->free, &epn->node);
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(&eph->setup, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != ev->events)
-                  {
-                    poll_fdsetup(fd, &epn->pfd, false);
-
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            epoll_teardown(eph, epn);
           }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        else
           {
-            if (epn->pfd.fd == fd)
+            epn = epoll_find(&eph->oneshot, fd);
+            if (epn == NULL)
               {
-                if (epn->pfd.events != ev->events)
-                  {
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
+                ret = -ENOENT;
+                goto err;
               }
           }
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        /* Re-register with the new events.  This also re-arms a disabled
+         * EPOLLONESHOT node.
+         */
+
+        list_delete(&epn->node);
+        epn->data       = ev->data;
+        epn->pfd.events = ev->events;
+
+        ret = epoll_setup(eph, epn);
+        if (ret < 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events;
-                epn->pfd.fd      = fd;
-                epn->pfd.revents = 0;
-
-                ret = poll_fdsetup(fd, &epn->pfd, true);
-                if (ret < 0)
-                  {
-                    goto err;
-                  }
-
-                list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
-                break;
-              }
+            list_add_tail(&eph->oneshot, &epn->node);
+            goto err;
           }
 
+        list_add_tail(&eph->setup, &epn->node);
         break;
 
       default:
@@ -601,7 +747,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   return OK;
 err:
@@ -628,55 +773,18 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
       return ERROR;
     }
 
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
   /* Wait the poll ready */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
-
-  if (timeout == 0)
-    {
-      ret = OK;
-    }
-  else if (timeout > 0)
-    {
-      clock_t ticks;
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
-                (USEC_PER_TICK - 1)) /
-              USEC_PER_TICK;
-#else
-      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
-              MSEC_PER_TICK;
-#endif
-
-      ret = nxsem_tickwait(&eph->sem, ticks);
-      if (ret == -ETIMEDOUT)
-        {
-          ret = OK;
-        }
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
+  ret = epoll_do_wait(eph, evs, maxevents, timeout);
   nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
   if (ret < 0)
     {
-      goto err;
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return epoll_teardown(eph, evs, maxevents);
-
-err:
-  set_errno(-ret);
-  return ERROR;
+  return ret;
 }
 
 /****************************************************************************
@@ -702,50 +810,14 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
       return ERROR;
     }
 
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
   /* Wait the poll ready */
 
-  if (timeout == 0)
-    {
-      ret = OK;
-    }
-  else if (timeout > 0)
-    {
-      clock_t ticks;
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
-                (USEC_PER_TICK - 1)) /
-              USEC_PER_TICK;
-#else
-      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
-              MSEC_PER_TICK;
-#endif
-
-      ret = nxsem_tickwait(&eph->sem, ticks);
-      if (ret == -ETIMEDOUT)
-        {
-          ret = OK;
-        }
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
+  ret = epoll_do_wait(eph, evs, maxevents, timeout);
   if (ret < 0)
     {
-      goto err;
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return epoll_teardown(eph, evs, maxevents);
-
-err:
-  set_errno(-ret);
-  return ERROR;
+  return ret;
 }
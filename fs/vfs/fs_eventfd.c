@@ -43,6 +43,7 @@
 typedef struct eventfd_waiter_sem_s
 {
   sem_t sem;
+  bool semaphore; /* A reader that takes one count (EFD_SEMAPHORE) */
   FAR struct eventfd_waiter_sem_s *next;
 } eventfd_waiter_sem_t;
 
@@ -85,6 +86,8 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
                                FAR eventfd_waiter_sem_t  *sem,
                                FAR eventfd_waiter_sem_t **slist);
 
+static void eventfd_wakeup_readers(FAR struct eventfd_priv_s *dev);
+
 static FAR struct eventfd_priv_s *eventfd_allocdev(void);
 static void eventfd_destroy(FAR struct eventfd_priv_s *dev);
 
@@ -216,10 +219,19 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
                                FAR eventfd_waiter_sem_t  *sem,
                                FAR eventfd_waiter_sem_t **slist)
 {
+  FAR eventfd_waiter_sem_t **tail;
   int ret;
 
-  sem->next = *slist;
-  *slist = sem;
+  /* Waiters are woken up in the order they came */
+
+  tail = slist;
+  while (*tail != NULL)
+    {
+      tail = &(*tail)->next;
+    }
+
+  sem->next = NULL;
+  *tail = sem;
 
   nxmutex_unlock(&dev->lock);
 
@@ -251,6 +263,8 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
                   cur_sem->next = sem->next;
                   break;
                 }
+
+              cur_sem = cur_sem->next;
             }
         }
 
@@ -261,6 +275,29 @@ static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
   return nxmutex_lock(&dev->lock);
 }
 
+/****************************************************************************
+ * Name: eventfd_wakeup_readers
+ *
+ * Description:
+ *   Wake up only as many of the blocked readers as the counter can
+ *   satisfy:  a reader in EFD_SEMAPHORE mode takes one count, any other
+ *   reader takes them all.
+ *
+ ****************************************************************************/
+
+static void eventfd_wakeup_readers(FAR struct eventfd_priv_s *dev)
+{
+  FAR eventfd_waiter_sem_t *cur_sem;
+  eventfd_t avail = dev->counter;
+
+  while (avail > 0 && (cur_sem = dev->rdsems) != NULL)
+    {
+      dev->rdsems = cur_sem->next;
+      avail = cur_sem->semaphore ? avail - 1 : 0;
+      nxsem_post(&cur_sem->sem);
+    }
+}
+
 static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
@@ -292,6 +329,7 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
         }
 
       nxsem_init(&sem.sem, 0, 0);
+      sem.semaphore = (filep->f_oflags & EFD_SEMAPHORE) != 0;
       do
         {
           ret = eventfd_blocking_io(dev, &sem, &dev->rdsems);
@@ -344,7 +382,6 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t len)
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
-  FAR eventfd_waiter_sem_t *cur_sem;
   eventfd_t new_counter;
   ssize_t ret;
 
@@ -376,6 +413,7 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
         }
 
       nxsem_init(&sem.sem, 0, 0);
+      sem.semaphore = false;
       do
         {
           ret = eventfd_blocking_io(dev, &sem, &dev->wrsems);
@@ -401,16 +439,9 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
   poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLIN);
 #endif
 
-  /* Notify all of the waiting readers */
-
-  cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
-    }
+  /* Wake up the waiting readers that the counter can satisfy */
 
-  dev->rdsems = NULL;
+  eventfd_wakeup_readers(dev);
 
   nxmutex_unlock(&dev->lock);
   return sizeof(eventfd_t);
@@ -35,11 +35,54 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 
 #include <arch/irq.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+
+/* One registration kept between calls to poll() */
+
+struct pollcache_entry_s
+{
+  struct pollfd fds;           /* What the file was set up with */
+  FAR struct file *filep;      /* The file set up, or NULL if none */
+};
+
+/* The registrations of the last call to poll() by a thread */
+
+struct pollcache_s
+{
+  struct list_node node;       /* Node in g_pollcache */
+  sem_t sem;                   /* Posted by the files set up */
+  bool busy;                   /* In use by a poll() in progress */
+  nfds_t nfds;                 /* Number of entries */
+  struct pollcache_entry_s entry[1];
+};
+
+#define SIZEOF_POLLCACHE_S(n) \
+  (sizeof(struct pollcache_s) + (n) * sizeof(struct pollcache_entry_s))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All the caches, so that close() can find the registrations of a file */
+
+static mutex_t g_pollcache_lock = NXMUTEX_INITIALIZER;
+static struct list_node g_pollcache = LIST_INITIAL_VALUE(g_pollcache);
+
+#endif /* CONFIG_FS_POLLCACHE */
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -160,6 +203,309 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds,
   return ret;
 }
 
+/****************************************************************************
+ * Name: poll_wait
+ *
+ * Description:
+ *   Wait for the semaphore posted by the poll callbacks, for at most
+ *   timeout milliseconds (forever if negative).
+ *
+ * Returned Value:
+ *   Zero (OK) on an event or a timeout; a negated errno value if the wait
+ *   was interrupted.
+ *
+ ****************************************************************************/
+
+static int poll_wait(FAR sem_t *sem, int timeout)
+{
+  int ret;
+
+  if (timeout == 0)
+    {
+      /* Poll returns immediately whether we have a poll event or not. */
+
+      ret = OK;
+    }
+  else if (timeout > 0)
+    {
+      clock_t ticks;
+
+      /* "Implementations may place limitations on the granularity of
+       * timeout intervals. If the requested timeout interval requires
+       * a finer granularity than the implementation supports, the
+       * actual timeout interval will be rounded up to the next
+       * supported value." -- opengroup.org
+       *
+       * Round timeout up to next full tick.
+       */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+
+      /* Either wait for either a poll event(s), for a signal to occur,
+       * or for the specified timeout to elapse with no event.
+       *
+       * NOTE: If a poll event is pending (i.e., the semaphore has
+       * already been incremented), nxsem_tickwait() will not wait, but
+       * will return immediately.
+       */
+
+      ret = nxsem_tickwait(sem, ticks);
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              /* Return zero (OK) in the event of a timeout */
+
+              ret = OK;
+            }
+
+          /* EINTR is the only other error expected in normal operation */
+        }
+    }
+  else
+    {
+      /* Wait for the poll event or signal with no timeout */
+
+      ret = nxsem_wait(sem);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_FS_POLLCACHE
+
+/****************************************************************************
+ * Name: poll_cache_disarm
+ *
+ * Description:
+ *   Tear down one kept registration.  Called with g_pollcache_lock held.
+ *
+ ****************************************************************************/
+
+static void poll_cache_disarm(FAR struct pollcache_entry_s *entry)
+{
+  if (entry->filep != NULL)
+    {
+      file_poll(entry->filep, &entry->fds, false);
+      entry->filep = NULL;
+    }
+
+  entry->fds.arg = NULL;
+  entry->fds.cb  = NULL;
+}
+
+/****************************************************************************
+ * Name: poll_cache_free
+ *
+ * Description:
+ *   Tear down all the registrations of a cache and free it.  Called with
+ *   g_pollcache_lock held.
+ *
+ ****************************************************************************/
+
+static void poll_cache_free(FAR struct pollcache_s *cache)
+{
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      poll_cache_disarm(&cache->entry[i]);
+    }
+
+  list_delete(&cache->node);
+  nxsem_destroy(&cache->sem);
+  kmm_free(cache);
+}
+
+/****************************************************************************
+ * Name: poll_cache_setup
+ *
+ * Description:
+ *   Bring the registrations kept by the calling thread in line with fds.
+ *   An entry is set up again only if its descriptor, file or events
+ *   changed, or if it reported an event since it was set up: the driver
+ *   only reports the readiness again on setup.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if the cache cannot be used and the
+ *   descriptors must be set up as without it; another negated errno value
+ *   if a descriptor could not be set up.
+ *
+ ****************************************************************************/
+
+static int poll_cache_setup(FAR struct pollfd *fds, nfds_t nfds,
+                            FAR struct pollcache_s **pcache)
+{
+  FAR struct tcb_s *rtcb = nxsched_self();
+  FAR struct pollcache_entry_s *entry;
+  FAR struct pollcache_s *cache;
+  FAR struct file *filep;
+  nfds_t i;
+  int ret;
+
+  ret = nxmutex_lock(&g_pollcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  cache = rtcb->pollcache;
+  if (cache != NULL && cache->busy)
+    {
+      /* poll() called again from a signal handler */
+
+      nxmutex_unlock(&g_pollcache_lock);
+      return -EBUSY;
+    }
+
+  if (cache != NULL && cache->nfds != nfds)
+    {
+      poll_cache_free(cache);
+      cache = NULL;
+      rtcb->pollcache = NULL;
+    }
+
+  if (cache == NULL)
+    {
+      cache = kmm_zalloc(SIZEOF_POLLCACHE_S(nfds));
+      if (cache == NULL)
+        {
+          nxmutex_unlock(&g_pollcache_lock);
+          return -EBUSY;
+        }
+
+      cache->nfds = nfds;
+      nxsem_init(&cache->sem, 0, 0);
+      list_add_tail(&g_pollcache, &cache->node);
+      rtcb->pollcache = cache;
+    }
+
+  /* Every entry that reported an event is set up again below, so only the
+   * events from now on need to be counted.
+   */
+
+  cache->busy = true;
+  nxsem_reset(&cache->sem, 0);
+
+  for (i = 0; i < nfds; i++)
+    {
+      entry = &cache->entry[i];
+      filep = NULL;
+
+      if (fds[i].fd >= 0)
+        {
+          ret = fs_getfilep(fds[i].fd, &filep);
+          if (ret < 0)
+            {
+              poll_cache_disarm(entry);
+              fds[i].revents |= POLLERR;
+              break;
+            }
+        }
+
+      if (filep != NULL && entry->filep == filep &&
+          entry->fds.fd == fds[i].fd && entry->fds.events == fds[i].events &&
+          entry->fds.revents == 0)
+        {
+          /* Still set up and nothing happened since */
+
+          continue;
+        }
+
+      poll_cache_disarm(entry);
+
+      entry->fds.fd      = fds[i].fd;
+      entry->fds.events  = fds[i].events;
+      entry->fds.revents = 0;
+      entry->fds.arg     = &cache->sem;
+      entry->fds.cb      = poll_default_cb;
+      entry->fds.priv    = NULL;
+
+      if (filep != NULL)
+        {
+          ret = file_poll(filep, &entry->fds, true);
+          if (ret < 0)
+            {
+              entry->fds.arg = NULL;
+              entry->fds.cb  = NULL;
+              fds[i].revents |= POLLERR;
+              break;
+            }
+
+          entry->filep = filep;
+        }
+    }
+
+  if (ret < 0)
+    {
+      cache->busy = false;
+    }
+
+  nxmutex_unlock(&g_pollcache_lock);
+  *pcache = cache;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   poll() through the registrations kept by the calling thread.  They are
+ *   left set up on return.
+ *
+ * Returned Value:
+ *   As poll_cache_setup(), or the result of the wait.
+ *
+ ****************************************************************************/
+
+static int poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout,
+                      FAR int *count)
+{
+  FAR struct pollcache_s *cache;
+  pollevent_t revents;
+  nfds_t i;
+  int ret;
+
+  ret = poll_cache_setup(fds, nfds, &cache);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = poll_wait(&cache->sem, timeout);
+
+  /* Report the events.  The lock keeps close() from tearing an entry down
+   * meanwhile.
+   */
+
+  nxmutex_lock(&g_pollcache_lock);
+
+  *count = 0;
+  for (i = 0; i < nfds; i++)
+    {
+      revents = fds[i].fd >= 0 ? cache->entry[i].fds.revents : 0;
+      fds[i].revents = revents;
+      if (revents != 0)
+        {
+          (*count)++;
+        }
+    }
+
+  cache->busy = false;
+  nxmutex_unlock(&g_pollcache_lock);
+  return ret;
+}
+
+#endif /* CONFIG_FS_POLLCACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -340,6 +686,58 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+#ifdef CONFIG_FS_POLLCACHE
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the registrations kept by poll() on a file being closed.
+ *
+ ****************************************************************************/
+
+void poll_cache_close(FAR struct file *filep)
+{
+  FAR struct pollcache_s *cache;
+  nfds_t i;
+
+  nxmutex_lock(&g_pollcache_lock);
+
+  list_for_every_entry(&g_pollcache, cache, struct pollcache_s, node)
+    {
+      for (i = 0; i < cache->nfds; i++)
+        {
+          if (cache->entry[i].filep == filep)
+            {
+              poll_cache_disarm(&cache->entry[i]);
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_pollcache_lock);
+}
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down and free the registrations kept by poll() for an exiting
+ *   thread.
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct pollcache_s *cache)
+{
+  if (cache != NULL)
+    {
+      nxmutex_lock(&g_pollcache_lock);
+      poll_cache_free(cache);
+      nxmutex_unlock(&g_pollcache_lock);
+    }
+}
+
+#endif /* CONFIG_FS_POLLCACHE */
+
 /****************************************************************************
  * Name: poll
  *
@@ -385,6 +783,16 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Reuse the registrations of the last call of this thread */
+
+  ret = poll_cache(fds, nfds, timeout, &count);
+  if (ret != -EBUSY)
+    {
+      goto out_with_cancelpt;
+    }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Allocate kernel memory for the fds */
 
@@ -410,62 +818,7 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   ret = poll_setup(kfds, nfds, &sem);
   if (ret >= 0)
     {
-      if (timeout == 0)
-        {
-          /* Poll returns immediately whether we have a poll event or not. */
-
-          ret = OK;
-        }
-      else if (timeout > 0)
-        {
-          clock_t ticks;
-
-          /* "Implementations may place limitations on the granularity of
-           * timeout intervals. If the requested timeout interval requires
-           * a finer granularity than the implementation supports, the
-           * actual timeout interval will be rounded up to the next
-           * supported value." -- opengroup.org
-           *
-           * Round timeout up to next full tick.
-           */
-
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-          ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
-                   (USEC_PER_TICK - 1)) /
-                  USEC_PER_TICK;
-#else
-          ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
-                  MSEC_PER_TICK;
-#endif
-
-          /* Either wait for either a poll event(s), for a signal to occur,
-           * or for the specified timeout to elapse with no event.
-           *
-           * NOTE: If a poll event is pending (i.e., the semaphore has
-           * already been incremented), nxsem_tickwait() will not wait, but
-           * will return immediately.
-           */
-
-          ret = nxsem_tickwait(&sem, ticks);
-          if (ret < 0)
-            {
-              if (ret == -ETIMEDOUT)
-                {
-                  /* Return zero (OK) in the event of a timeout */
-
-                  ret = OK;
-                }
-
-              /* EINTR is the only other error expected in normal operation */
-            }
-        }
-      else
-        {
-          /* Wait for the poll event or signal with no timeout */
-
-          ret = nxsem_wait(&sem);
-        }
+      ret = poll_wait(&sem, timeout);
 
       /* Teardown the poll operation and get the count of events.  Zero will
        * be returned in the case of a timeout.
@@ -497,7 +850,9 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   /* Free the temporary buffer */
 
   kmm_free(kfds);
+#endif
 
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FS_POLLCACHE)
 out_with_cancelpt:
 #endif
 
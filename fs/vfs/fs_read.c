@@ -32,6 +32,7 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
 
 #include "inode/inode.h"
 
@@ -94,6 +95,16 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
                                      (size_t)nbytes);
     }
 
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret >= 0 && !up_interrupt_context())
+    {
+      FAR struct tcb_s *rtcb = nxsched_self();
+
+      rtcb->syscr++;
+      rtcb->rchar += ret;
+    }
+#endif
+
   /* Return the number of bytes read (or possibly an error code) */
 
   return ret;
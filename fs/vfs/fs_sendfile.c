@@ -30,12 +30,73 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copydirect
+ *
+ * Description:
+ *   Write 'count' bytes at the current position of 'infile' directly from
+ *   memory if the file data is memory-backed (e.g. ROMFS on XIP media or
+ *   TMPFS).  The position of 'infile' is advanced as a read would do.
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value.  -ENOTTY
+ *   means that the file data is not directly accessible.
+ *
+ ****************************************************************************/
+
+static ssize_t copydirect(FAR struct file *outfile, FAR struct file *infile,
+                          size_t count)
+{
+  FAR const uint8_t *wrbuffer;
+  FAR void *mapped;
+  ssize_t nbyteswritten;
+  size_t ntransferred = 0;
+  off_t pos;
+  int ret;
+
+  pos = file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return -ENOTTY;
+    }
+
+  ret = file_mmap_direct(infile, pos, count, &mapped);
+  if (ret < 0)
+    {
+      return -ENOTTY;
+    }
+
+  wrbuffer = mapped;
+  while (ntransferred < count)
+    {
+      nbyteswritten = file_write(outfile, wrbuffer + ntransferred,
+                                 count - ntransferred);
+      if (nbyteswritten < 0)
+        {
+          /* EINTR only stops the copy once some data has been sent */
+
+          if (nbyteswritten != -EINTR || ntransferred == 0)
+            {
+              return nbyteswritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nbyteswritten;
+    }
+
+  pos = file_seek(infile, pos + ntransferred, SEEK_SET);
+  return pos < 0 ? pos : ntransferred;
+}
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         off_t *offset, size_t count)
 {
@@ -70,6 +131,15 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
         }
     }
 
+  /* Memory-backed input can be written out without the bounce buffer */
+
+  nbyteswritten = copydirect(outfile, infile, count);
+  if (nbyteswritten != -ENOTTY)
+    {
+      ntransferred = nbyteswritten;
+      goto out;
+    }
+
   /* Allocate an I/O buffer */
 
   iobuffer = kmm_malloc(CONFIG_SENDFILE_BUFSIZE);
@@ -197,6 +267,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 
   kmm_free(iobuffer);
 
+out:
+
   /* Return the current file position */
 
   if (offset)
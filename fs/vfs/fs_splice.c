@@ -0,0 +1,156 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+  ssize_t ret = -EINVAL;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  splice.ps_len      = len;
+  splice.ps_nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+
+  /* A pipe has no position, so only the other end may have an offset.
+   * Try the input as the pipe first, then the output.
+   */
+
+  if (inoff == NULL)
+    {
+      splice.ps_file   = outfile;
+      splice.ps_offset = outoff;
+      splice.ps_tofile = true;
+
+      ret = file_ioctl(infile, PIPEIOC_SPLICE, (unsigned long)&splice);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+    }
+
+  if (outoff == NULL)
+    {
+      splice.ps_file   = infile;
+      splice.ps_offset = inoff;
+      splice.ps_tofile = false;
+
+      ret = file_ioctl(outfile, PIPEIOC_SPLICE, (unsigned long)&splice);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+    }
+
+  /* Neither end is a pipe */
+
+  return ret == -ENOTTY ? -EINVAL : ret;
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between a pipe and another file descriptor without
+ *   copying it through user space: the data is copied once, between the
+ *   buffer of the pipe and the other file.
+ *
+ *   NOTE: This interface is not specified by POSIX.  It follows the Linux
+ *   splice interface.  SPLICE_F_MOVE, SPLICE_F_MORE and SPLICE_F_GIFT are
+ *   accepted and ignored.
+ *
+ * Input Parameters:
+ *   fdin   - The descriptor to read from
+ *   offin  - NULL if 'fdin' is a pipe.  Otherwise, if not NULL, the
+ *            position in 'fdin' to read from, updated on return, and the
+ *            file position of 'fdin' is not changed.
+ *   fdout  - The descriptor to write to
+ *   offout - As 'offin', for 'fdout'
+ *   len    - The maximum number of bytes to move
+ *   flags  - SPLICE_F_NONBLOCK to not block on the pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at the end of the input, or -1 with
+ *   errno set.  EINVAL means that neither descriptor is a pipe.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fdin, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fdout, &outfile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_splice(infile, offin, outfile, offout, len, flags);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -32,6 +32,7 @@
 #include <debug.h>
 
 #include <nuttx/wdog.h>
+#include <nuttx/timers/hrtimer.h>
 #include <nuttx/mutex.h>
 
 #include <sys/ioctl.h>
@@ -61,9 +62,15 @@ struct timerfd_priv_s
   mutex_t                   lock;    /* Enforces device exclusive access */
   FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
   int                       clock;   /* Clock to use as the timing base */
+#ifdef CONFIG_HRTIMER
+  uint64_t                  interval; /* If non-zero, the period (nsec)
+                                       * of repetitive timers */
+  struct hrtimer_s          hrtimer; /* The timer that provides the timing */
+#else
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -98,6 +105,12 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
 static void timerfd_timeout(wdparm_t arg);
+#ifdef CONFIG_HRTIMER
+static int timerfd_hrtimer_settime(FAR struct timerfd_priv_s *dev,
+                                   int flags,
+                                   FAR const struct itimerspec *new_value,
+                                   FAR struct itimerspec *old_value);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -153,7 +166,11 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
 
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   kmm_free(dev);
@@ -254,6 +271,8 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
                   cur_sem->next = sem->next;
                   break;
                 }
+
+              cur_sem = cur_sem->next;
             }
         }
     }
@@ -379,11 +398,83 @@ out:
 }
 #endif
 
+#ifdef CONFIG_HRTIMER
+/****************************************************************************
+ * Name: timerfd_hrtimer_settime
+ *
+ * Description:
+ *   The high resolution version of the core of timerfd_settime().  Times
+ *   are kept in nanoseconds so that no tick rounding takes place.
+ *
+ * Assumptions:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+static int timerfd_hrtimer_settime(FAR struct timerfd_priv_s *dev,
+                                   int flags,
+                                   FAR const struct itimerspec *new_value,
+                                   FAR struct itimerspec *old_value)
+{
+  uint64_t delay;
+
+  if (old_value)
+    {
+      hrtimer_gettime(&dev->hrtimer, &old_value->it_value);
+      hrtimer_nsec2ts(dev->interval, &old_value->it_interval);
+    }
+
+  /* Disarm the timer and clear expiration counter */
+
+  hrtimer_cancel(&dev->hrtimer);
+  dev->counter = 0;
+
+  /* If the it_value member of value is zero, the timer will not be
+   * re-armed
+   */
+
+  if (new_value->it_value.tv_sec <= 0 && new_value->it_value.tv_nsec <= 0)
+    {
+      return OK;
+    }
+
+  dev->interval = hrtimer_ts2nsec(&new_value->it_interval);
+  delay         = hrtimer_ts2nsec(&new_value->it_value);
+
+  /* An absolute time is relative to the clock of the timer, not to the
+   * hrtimer clock:  convert it to the time left from now.
+   */
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      struct timespec now;
+      uint64_t current;
+
+      clock_gettime(dev->clock, &now);
+      current = hrtimer_ts2nsec(&now);
+      delay   = delay > current ? delay - current : 0;
+    }
+
+  /* If the time is in the past or now, then set up the next interval
+   * instead (assuming a repetitive timer).
+   */
+
+  if (delay == 0)
+    {
+      delay = dev->interval;
+    }
+
+  return hrtimer_start_abs(&dev->hrtimer, hrtimer_now() + delay,
+                           timerfd_timeout, (wdparm_t)dev);
+}
+#endif
+
 static void timerfd_timeout(wdparm_t arg)
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
   FAR timerfd_waiter_sem_t *cur_sem;
   irqstate_t intflags;
+  timerfd_t counter;
 
   /* Disable interrupts to ensure that expiration counter is accessed
    * atomically
@@ -393,14 +484,48 @@ static void timerfd_timeout(wdparm_t arg)
 
   /* Increment timer expiration counter */
 
-  dev->counter++;
+  counter = dev->counter++;
 
   /* If this is a repetitive timer, then restart the watchdog */
 
+#ifdef CONFIG_HRTIMER
+  /* Restart from the previous expiration so that the period does not
+   * drift with the interrupt latency.  The periods that went by entirely
+   * since then are counted as overruns at once rather than expiring one
+   * by one.
+   */
+
+  if (dev->interval > 0)
+    {
+      uint64_t expired = dev->hrtimer.expired + dev->interval;
+      uint64_t now     = hrtimer_now();
+
+      if (now >= expired)
+        {
+          uint64_t missed = (now - expired) / dev->interval + 1;
+
+          dev->counter += missed;
+          expired      += missed * dev->interval;
+        }
+
+      hrtimer_start_abs(&dev->hrtimer, expired, timerfd_timeout, arg);
+    }
+#else
   if (dev->delay > 0)
     {
       wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
     }
+#endif
+
+  /* Nobody waits unless the counter was zero:  readers would have read it
+   * and poll() reported it when set up.
+   */
+
+  if (counter > 0)
+    {
+      leave_critical_section(intflags);
+      return;
+    }
 
 #ifdef CONFIG_TIMER_FD_POLL
   /* Notify all poll/select waiters */
@@ -485,7 +610,9 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
+#ifndef CONFIG_HRTIMER
   sclock_t delay;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -526,6 +653,16 @@ int timerfd_settime(int fd, int flags,
 
   intflags = enter_critical_section();
 
+#ifdef CONFIG_HRTIMER
+  ret = timerfd_hrtimer_settime(dev, flags, new_value, old_value);
+  leave_critical_section(intflags);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return OK;
+#else
   if (old_value)
     {
       /* Get the number of ticks before the underlying watchdog expires */
@@ -605,6 +742,7 @@ int timerfd_settime(int fd, int flags,
 
   leave_critical_section(intflags);
   return OK;
+#endif
 
 errout:
   set_errno(-ret);
@@ -615,7 +753,9 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
+#ifndef CONFIG_HRTIMER
   sclock_t ticks;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -644,6 +784,10 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_gettime(&dev->hrtimer, &curr_value->it_value);
+  hrtimer_nsec2ts(dev->interval, &curr_value->it_interval);
+#else
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(&dev->wdog);
@@ -652,6 +796,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   clock_ticks2time(ticks, &curr_value->it_value);
   clock_ticks2time(dev->delay, &curr_value->it_interval);
+#endif
   return OK;
 
 errout:
@@ -32,6 +32,7 @@
 #include <assert.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
 
 #include "inode/inode.h"
 
@@ -68,6 +69,7 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
                    size_t nbytes)
 {
   FAR struct inode *inode;
+  ssize_t ret;
 
   /* Was this file opened for write access? */
 
@@ -86,7 +88,19 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
 
   /* Yes, then let the driver perform the write */
 
-  return inode->u.i_ops->write(filep, buf, nbytes);
+  ret = inode->u.i_ops->write(filep, buf, nbytes);
+
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret >= 0 && !up_interrupt_context())
+    {
+      FAR struct tcb_s *rtcb = nxsched_self();
+
+      rtcb->syscw++;
+      rtcb->wchar += ret;
+    }
+#endif
+
+  return ret;
 }
 
 /****************************************************************************
@@ -572,6 +572,25 @@ void nxbe_fill(FAR struct nxbe_window_s *wnd,
                FAR const struct nxgl_rect_s *rect,
                nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
 
+/****************************************************************************
+ * Name: nxbe_fills
+ *
+ * Description:
+ *  Fill a batch of rectangles in the window, each with its own color
+ *
+ * Input Parameters:
+ *   wnd    - The window structure reference
+ *   fills  - The rectangles and their colors
+ *   nfills - The number of entries in fills
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_fills(FAR struct nxbe_window_s *wnd,
+                FAR const struct nx_fill_s *fills, unsigned int nfills);
+
 /****************************************************************************
  * Name: nxbe_filltrapezoid
  *
@@ -90,7 +90,8 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 
 static inline void nxbe_fill_dev(FAR struct nxbe_window_s *wnd,
                                  FAR const struct nxgl_rect_s *rect,
-                                 nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
+                                 const nxgl_mxpixel_t
+                                 color[CONFIG_NX_NPLANES])
 {
   struct nxbe_fill_s info;
   int i;
@@ -146,7 +147,8 @@ static inline void nxbe_fill_dev(FAR struct nxbe_window_s *wnd,
 #ifdef CONFIG_NX_RAMBACKED
 static inline void nxbe_fill_pwfb(FAR struct nxbe_window_s *wnd,
                                   FAR const struct nxgl_rect_s *rect,
-                                  nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
+                                  const nxgl_mxpixel_t
+                                  color[CONFIG_NX_NPLANES])
 {
   struct nxgl_rect_s relrect;
 
@@ -166,6 +168,125 @@ static inline void nxbe_fill_pwfb(FAR struct nxbe_window_s *wnd,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxbe_fill_clip
+ *
+ * Description:
+ *  Convert a rectangle in the window to device coordinates and clip it to
+ *  the window and to the background screen.
+ *
+ * Returned Value:
+ *   true if anything is left of the rectangle
+ *
+ ****************************************************************************/
+
+static bool nxbe_fill_clip(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nxgl_rect_s *rect,
+                           FAR struct nxgl_rect_s *remaining)
+{
+  /* Offset the rectangle by the window origin to convert it into a
+   * bounding box
+   */
+
+  nxgl_rectoffset(remaining, rect, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+
+  /* Clip to the bounding box to the limits of the window and of the
+   * background screen
+   */
+
+  nxgl_rectintersect(remaining, remaining, &wnd->bounds);
+  nxgl_rectintersect(remaining, remaining, &wnd->be->bkgd.bounds);
+
+  return !nxgl_nullrect(remaining);
+}
+
+/****************************************************************************
+ * Name: nxbe_fills_dev
+ *
+ * Description:
+ *  Fill a batch of rectangles in the window in device memory.  The clip is
+ *  computed once for the whole batch: if no window above overlaps its
+ *  bounding box, the rectangles are all drawn as they are.
+ *
+ * Input Parameters:
+ *   wnd    - The window structure reference
+ *   fills  - The rectangles and their colors
+ *   nfills - The number of entries in fills
+ *   bounds - The bounding box of the clipped rectangles
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void nxbe_fills_dev(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nx_fill_s *fills,
+                           unsigned int nfills,
+                           FAR struct nxgl_rect_s *bounds)
+{
+  FAR struct nxbe_window_s *currw;
+  FAR struct nxbe_plane_s *plane;
+  struct nxgl_rect_s remaining;
+  bool obscured = false;
+  unsigned int n;
+  int i;
+
+  for (currw = wnd->above; currw != NULL; currw = currw->above)
+    {
+      if (nxgl_rectoverlap(bounds, &currw->bounds))
+        {
+          obscured = true;
+          break;
+        }
+    }
+
+  if (obscured)
+    {
+      /* Clip each rectangle against the windows above */
+
+      for (n = 0; n < nfills; n++)
+        {
+          if (nxbe_fill_clip(wnd, &fills[n].rect, &remaining))
+            {
+              nxbe_fill_dev(wnd, &remaining, fills[n].color);
+            }
+        }
+
+      return;
+    }
+
+#if CONFIG_NX_NPLANES > 1
+  for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+  i = 0;
+#endif
+    {
+      plane = &wnd->be->plane[i];
+      DEBUGASSERT(plane->dev.fillrectangle != NULL);
+
+      for (n = 0; n < nfills; n++)
+        {
+          if (nxbe_fill_clip(wnd, &fills[n].rect, &remaining))
+            {
+              plane->dev.fillrectangle(&plane->pinfo, &remaining,
+                                       fills[n].color[i]);
+            }
+        }
+
+#ifdef CONFIG_NX_UPDATE
+      /* Notify external logic once of the whole updated region */
+
+      nxbe_notify_rectangle(plane->driver, bounds);
+#endif
+
+#ifdef CONFIG_NX_SWCURSOR
+      /* Backup and redraw the cursor once for the whole batch */
+
+      nxbe_cursor_backupdraw_dev(wnd->be, bounds, i);
+#endif
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -195,20 +316,7 @@ void nxbe_fill(FAR struct nxbe_window_s *wnd,
   DEBUGASSERT(wnd != NULL && rect != NULL && color != NULL);
   DEBUGASSERT(wnd->be != NULL && wnd->be->plane != NULL);
 
-  /* Offset the rectangle by the window origin to convert it into a
-   * bounding box
-   */
-
-  nxgl_rectoffset(&remaining, rect, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
-
-  /* Clip to the bounding box to the limits of the window and of the
-   * background screen
-   */
-
-  nxgl_rectintersect(&remaining, &remaining, &wnd->bounds);
-  nxgl_rectintersect(&remaining, &remaining, &wnd->be->bkgd.bounds);
-
-  if (!nxgl_nullrect(&remaining))
+  if (nxbe_fill_clip(wnd, rect, &remaining))
     {
 #ifdef CONFIG_NX_RAMBACKED
       /* If this window supports a pre-window frame buffer then shadow the
@@ -231,3 +339,78 @@ void nxbe_fill(FAR struct nxbe_window_s *wnd,
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxbe_fills
+ *
+ * Description:
+ *  Fill a batch of rectangles in the window, each with its own color
+ *
+ * Input Parameters:
+ *   wnd    - The window structure reference
+ *   fills  - The rectangles and their colors
+ *   nfills - The number of entries in fills
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_fills(FAR struct nxbe_window_s *wnd,
+                FAR const struct nx_fill_s *fills, unsigned int nfills)
+{
+  struct nxgl_rect_s remaining;
+  struct nxgl_rect_s bounds;
+  bool empty = true;
+  unsigned int n;
+
+  DEBUGASSERT(wnd != NULL && (fills != NULL || nfills == 0));
+  DEBUGASSERT(wnd->be != NULL && wnd->be->plane != NULL);
+
+  /* Get the bounding box of everything that is drawn */
+
+  for (n = 0; n < nfills; n++)
+    {
+      if (nxbe_fill_clip(wnd, &fills[n].rect, &remaining))
+        {
+          if (empty)
+            {
+              nxgl_rectcopy(&bounds, &remaining);
+              empty = false;
+            }
+          else
+            {
+              nxgl_rectunion(&bounds, &bounds, &remaining);
+            }
+        }
+    }
+
+  if (empty)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NX_RAMBACKED
+  /* If this window supports a pre-window frame buffer then shadow the
+   * fills in that framebuffer.
+   */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      for (n = 0; n < nfills; n++)
+        {
+          if (nxbe_fill_clip(wnd, &fills[n].rect, &remaining))
+            {
+              nxbe_fill_pwfb(wnd, &remaining, fills[n].color);
+            }
+        }
+    }
+#endif
+
+  /* Don't update hidden windows */
+
+  if (!NXBE_ISHIDDEN(wnd))
+    {
+      nxbe_fills_dev(wnd, fills, nfills, &bounds);
+    }
+}
@@ -40,6 +40,8 @@ struct nxbe_redraw_s
 {
   struct nxbe_clipops_s cops;
   FAR struct nxbe_window_s *wnd;
+  struct nxgl_rect_s bounds;       /* Union of the visible parts */
+  bool visible;                    /* True: bounds is valid */
 };
 
 /****************************************************************************
@@ -54,10 +56,22 @@ static void nxbe_clipredraw(FAR struct nxbe_clipops_s *cops,
                             FAR struct nxbe_plane_s *plane,
                             FAR const struct nxgl_rect_s *rect)
 {
-  FAR struct nxbe_window_s *wnd = ((struct nxbe_redraw_s *)cops)->wnd;
-  if (wnd)
+  FAR struct nxbe_redraw_s *info = (FAR struct nxbe_redraw_s *)cops;
+
+  /* The visible parts are merged into a single request, sent once the
+   * clipping is done:  the client draws are clipped by the server anyway,
+   * so redrawing the obscured parts in between costs less than one message
+   * and one client redraw per visible part.
+   */
+
+  if (info->visible)
+    {
+      nxgl_rectunion(&info->bounds, &info->bounds, rect);
+    }
+  else
     {
-      nxmu_redraw(wnd, rect);
+      nxgl_rectcopy(&info->bounds, rect);
+      info->visible = true;
     }
 }
 
@@ -97,6 +111,7 @@ void nxbe_redraw(FAR struct nxbe_state_s *be,
       info.cops.visible  = nxbe_clipredraw;
       info.cops.obscured = nxbe_clipnull;
       info.wnd           = wnd;
+      info.visible       = false;
 
 #if CONFIG_NX_NPLANES > 1
       for (i = 0; i < be->vinfo.nplanes; i++)
@@ -108,5 +123,12 @@ void nxbe_redraw(FAR struct nxbe_state_s *be,
       nxbe_clipper(wnd->above, &remaining, NX_CLIPORDER_DEFAULT,
                    &info.cops, &be->plane[0]);
 #endif
+
+      /* Then send one request for all planes and visible parts */
+
+      if (info.visible)
+        {
+          nxmu_redraw(wnd, &info.bounds);
+        }
     }
 }
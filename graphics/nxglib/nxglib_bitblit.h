@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -125,32 +126,30 @@
        } \
    }
 
-#elif NXGLIB_BITSPERPIXEL == 24
+#else
 
-#  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+/* Whole runs are copied and filled a word at a time:  the copies by the C
+ * library, which is optimized for the architecture, the fills by
+ * nxgl_memset*() below.  NXGL_MEMMOVE is the copy to use where the source
+ * and destination may overlap in the same row.
+ */
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), NXGL_SCALEX(width))
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove((dest), (src), NXGL_SCALEX(width))
+
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_MEMSET(dest,value,width) \
+       memset((dest), (value), (width))
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
+       NXGL_FUNCNAME(nxgl_memset, NXGLIB_BITSPERPIXEL)((dest), (value), \
+                                                      (width))
+#  endif
+#endif
+
+#if NXGLIB_BITSPERPIXEL == 24
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -169,28 +168,7 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
-
-#  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
-
-#  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+#elif NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -226,6 +204,128 @@ extern "C"
  * Public Functions Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxgl_memset*
+ *
+ * Description:
+ *   Fill a run of pixels with a color, a 32-bit word at a time once the
+ *   run is aligned.  A color made of a single repeated byte is filled with
+ *   memset().
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_memset16(FAR void *dest, uint16_t color,
+                                 size_t npixels)
+{
+  FAR uint16_t *dptr = (FAR uint16_t *)dest;
+  FAR uint32_t *wptr;
+  uint32_t wide;
+
+  if ((color & 0xff) == (color >> 8))
+    {
+      memset(dest, color & 0xff, npixels << 1);
+      return;
+    }
+
+  if (((uintptr_t)dptr & 3) != 0 && npixels > 0)
+    {
+      *dptr++ = color;
+      npixels--;
+    }
+
+  wptr = (FAR uint32_t *)dptr;
+  wide = (uint32_t)color << 16 | color;
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wptr++ = wide;
+    }
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wptr = color;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 24
+static inline void nxgl_memset24(FAR void *dest, uint32_t color,
+                                 size_t npixels)
+{
+  FAR uint8_t *dptr = (FAR uint8_t *)dest;
+  uint8_t pattern[12];
+  uint32_t wide[3];
+  int i;
+
+  if ((color & 0xff) == ((color >> 8) & 0xff) &&
+      (color & 0xff) == ((color >> 16) & 0xff))
+    {
+      memset(dest, color & 0xff, npixels * 3);
+      return;
+    }
+
+  /* Up to 3 pixels bring the run to a word boundary */
+
+  while (((uintptr_t)dptr & 3) != 0 && npixels > 0)
+    {
+      *dptr++ = color;
+      *dptr++ = color >> 8;
+      *dptr++ = color >> 16;
+      npixels--;
+    }
+
+  /* Then 4 pixels are 3 words */
+
+  if (npixels >= 4)
+    {
+      FAR uint32_t *wptr = (FAR uint32_t *)dptr;
+
+      for (i = 0; i < 12; i += 3)
+        {
+          pattern[i]     = color;
+          pattern[i + 1] = color >> 8;
+          pattern[i + 2] = color >> 16;
+        }
+
+      memcpy(wide, pattern, sizeof(wide));
+
+      for (; npixels >= 4; npixels -= 4)
+        {
+          *wptr++ = wide[0];
+          *wptr++ = wide[1];
+          *wptr++ = wide[2];
+        }
+
+      dptr = (FAR uint8_t *)wptr;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dptr++ = color;
+      *dptr++ = color >> 8;
+      *dptr++ = color >> 16;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 32
+static inline void nxgl_memset32(FAR void *dest, uint32_t color,
+                                 size_t npixels)
+{
+  FAR uint32_t *dptr = (FAR uint32_t *)dest;
+
+  if (color == (color & 0xff) * 0x01010101)
+    {
+      memset(dest, color & 0xff, npixels << 2);
+      return;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dptr++ = color;
+    }
+}
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
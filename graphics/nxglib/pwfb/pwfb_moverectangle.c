@@ -182,7 +182,7 @@ void NXGL_FUNCNAME(pwfb_moverectangle, NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           pwfb_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
           /* Point to the next source/dest row below the current one */
 
@@ -221,7 +221,7 @@ void NXGL_FUNCNAME(pwfb_moverectangle, NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           pwfb_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
@@ -482,6 +482,19 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
             }
             break;
 
+          case NX_SVRMSG_FILLS: /* Fill a batch of rectangles in the window */
+            {
+              FAR struct nxsvrmsg_fills_s *fillsmsg =
+                (FAR struct nxsvrmsg_fills_s *)buffer;
+              nxbe_fills(fillsmsg->wnd, fillsmsg->fills, fillsmsg->nfills);
+
+              if (fillsmsg->sem_done)
+                {
+                  nxsem_post(fillsmsg->sem_done);
+                }
+            }
+            break;
+
           case NX_SVRMSG_GETRECTANGLE: /* Get a rectangular region from the window */
             {
               FAR struct nxsvrmsg_getrectangle_s *getmsg =
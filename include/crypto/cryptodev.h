@@ -322,6 +322,17 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* ioctl parameter to run several operations with a single call.  They
+ * are run in order and the first failure stops the batch.
+ */
+
+struct crypt_mop
+{
+  FAR struct crypt_op *reqs; /* The operations */
+  unsigned count;            /* Number of operations */
+  unsigned done;             /* returns: # of operations completed */
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -342,6 +353,7 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCCRYPT               103
 #define CIOCKEY                 104
 #define CIOCASYMFEAT            105
+#define CIOCCRYPTM              106
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -75,6 +75,15 @@ struct enc_xform
   CODE void (*decrypt) (caddr_t, FAR uint8_t *);
   CODE int  (*setkey) (void *, FAR uint8_t *, int len);
   CODE void (*reinit) (caddr_t, FAR uint8_t *);
+
+  /* Optional: process a whole buffer of any length at once.  Only for the
+   * xforms with a reinit method, which keep their position themselves.
+   */
+
+  CODE void (*encrypt_multi) (caddr_t, FAR const uint8_t *, FAR uint8_t *,
+                              size_t);
+  CODE void (*decrypt_multi) (caddr_t, FAR const uint8_t *, FAR uint8_t *,
+                              size_t);
 };
 
 struct comp_algo
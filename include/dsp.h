@@ -52,6 +52,12 @@
 #  define CONFIG_LIBDSP_PRECISION 0
 #endif
 
+#ifndef CONFIG_LIBDSP_FOC_BATCH_MAX
+#  define CONFIG_LIBDSP_FOC_BATCH_MAX 8
+#endif
+
+#define FOC_BATCH_MAX CONFIG_LIBDSP_FOC_BATCH_MAX
+
 /* Phase rotation direction */
 
 #define DIR_NONE (0.0f)
@@ -374,6 +380,51 @@ struct foc_data_f32_s
   phase_angle_f32_t   angle; /* Phase angle */
 };
 
+/* The FOC current loops of up to FOC_BATCH_MAX motors, for
+ * foc_current_batch().  Element i of every array belongs to motor i.  The
+ * arrays are kept in the structure so that the compiler can tell that they
+ * do not overlap.  The PI controllers work as foc_init() and
+ * foc_vbase_update() set them up: output saturated to the dq voltage
+ * limit, anti-windup with KC = 0.99, no integral reset.
+ */
+
+struct foc_batch_f32_s
+{
+  /* Inputs */
+
+  float i_a[FOC_BATCH_MAX];            /* Phase A current */
+  float i_b[FOC_BATCH_MAX];            /* Phase B current */
+  float sin[FOC_BATCH_MAX];            /* Phase angle sine */
+  float cos[FOC_BATCH_MAX];            /* Phase angle cosine */
+  float id_ref[FOC_BATCH_MAX];         /* Requested d-axis current */
+  float iq_ref[FOC_BATCH_MAX];         /* Requested q-axis current */
+  float vd_comp[FOC_BATCH_MAX];        /* d-axis voltage compensation */
+  float vq_comp[FOC_BATCH_MAX];        /* q-axis voltage compensation */
+
+  /* Parameters */
+
+  float id_kp[FOC_BATCH_MAX];          /* d-axis PI gains */
+  float id_ki[FOC_BATCH_MAX];
+  float iq_kp[FOC_BATCH_MAX];          /* q-axis PI gains */
+  float iq_ki[FOC_BATCH_MAX];
+  float vdq_mag_max[FOC_BATCH_MAX];    /* Base voltage, and dq voltage limit */
+  float vab_mod_scale[FOC_BATCH_MAX];  /* One by the base voltage */
+
+  /* PI controller state, zeroed before the first cycle */
+
+  float id_int[FOC_BATCH_MAX];         /* d-axis integral part */
+  float id_aw[FOC_BATCH_MAX];          /* d-axis anti-windup term */
+  float iq_int[FOC_BATCH_MAX];         /* q-axis integral part */
+  float iq_aw[FOC_BATCH_MAX];          /* q-axis anti-windup term */
+
+  /* Outputs, as svm3() returns them */
+
+  float d_u[FOC_BATCH_MAX];            /* Duty cycle for phase U */
+  float d_v[FOC_BATCH_MAX];            /* Duty cycle for phase V */
+  float d_w[FOC_BATCH_MAX];            /* Duty cycle for phase W */
+  uint8_t sector[FOC_BATCH_MAX];       /* Space vector sector */
+};
+
 /* Motor physical parameters.
  * This data structure was designed to work with BLDC/PMSM motors,
  * but probably can be used to describe different types of motors.
@@ -537,6 +588,13 @@ void foc_current_control(FAR struct foc_data_f32_s *foc,
                          FAR dq_frame_f32_t *idq_ref,
                          FAR dq_frame_f32_t *vdq_comp,
                          FAR dq_frame_f32_t *v_dq_ref);
+void foc_current_step(FAR struct foc_data_f32_s *foc,
+                      FAR phase_angle_f32_t *angle,
+                      FAR abc_frame_f32_t *i_abc,
+                      FAR dq_frame_f32_t *idq_ref,
+                      FAR dq_frame_f32_t *vdq_comp,
+                      FAR struct svm3_state_f32_s *svm);
+void foc_current_batch(FAR struct foc_batch_f32_s *b, int n);
 void foc_vabmod_get(FAR struct foc_data_f32_s *foc,
                     FAR ab_frame_f32_t *v_ab_mod);
 void foc_vdq_mag_max_get(FAR struct foc_data_f32_s *foc, FAR float *max);
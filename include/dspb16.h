@@ -519,6 +519,12 @@ void foc_current_control_b16(FAR struct foc_data_b16_s *foc,
                              FAR dq_frame_b16_t *idq_ref,
                              FAR dq_frame_b16_t *vdq_comp,
                              FAR dq_frame_b16_t *v_dq_ref);
+void foc_current_step_b16(FAR struct foc_data_b16_s *foc,
+                          FAR phase_angle_b16_t *angle,
+                          FAR abc_frame_b16_t *i_abc,
+                          FAR dq_frame_b16_t *idq_ref,
+                          FAR dq_frame_b16_t *vdq_comp,
+                          FAR struct svm3_state_b16_s *svm);
 void foc_vabmod_get_b16(FAR struct foc_data_b16_s *foc,
                         FAR ab_frame_b16_t *v_ab_mod);
 void foc_vdq_mag_max_get_b16(FAR struct foc_data_b16_s *foc, FAR b16_t *max);
@@ -133,6 +133,13 @@
 #define DN_RENAME   4  /* A file was renamed */
 #define DN_ATTRIB   5  /* Attributes of a file were changed */
 
+/* splice() flags (linux) */
+
+#define SPLICE_F_MOVE       0x0001 /* Move pages instead of copying (hint) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data will be coming (hint) */
+#define SPLICE_F_GIFT       0x0008 /* Unused for splice() */
+
 /* Types of seals */
 
 #define F_SEAL_SEAL         0x0001 /* Prevent further seals from being set */
@@ -202,6 +209,11 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+/* Linux-like interfaces */
+
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
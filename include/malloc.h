@@ -57,6 +57,10 @@ struct mallinfo
                  * chunks handed out by malloc. */
   int fordblks; /* This is the total size of memory occupied
                  * by free (not in use) chunks. */
+  int reallocs; /* This is the number of reallocations of a chunk
+                 * of the heap. */
+  int rcopies;  /* This is the number of those reallocations that
+                 * had to copy the data. */
 };
 
 struct malltask
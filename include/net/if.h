@@ -171,7 +171,8 @@ struct can_ioctl_data_s
 };
 
 /* Structure passed to add or remove hardware-level CAN ID filters
- * SIOCxCANSTDFILTER / SIOCxCANEXTFILTER ioctl commands.
+ * SIOCxCANSTDFILTER / SIOCxCANEXTFILTER ioctl commands.  A filter is
+ * removed with the same structure it was added with.
  */
 
 struct can_ioctl_filter_s
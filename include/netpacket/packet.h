@@ -28,6 +28,31 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet-level socket options (see sys/socket.h) */
+
+#define PACKET_RX_RING     5  /* Set up a receive ring to mmap() (set only).
+                               * arg: struct tpacket_req */
+
+/* Values of tp_status in the frames of the receive ring */
+
+#define TP_STATUS_KERNEL   0         /* The frame is free for the kernel */
+#define TP_STATUS_USER     (1 << 0)  /* The frame holds a packet for user */
+#define TP_STATUS_LOSING   (1 << 2)  /* Packets were dropped before it */
+
+/* Each frame starts with a struct tpacket_hdr, followed by the struct
+ * sockaddr_ll of the packet.  The packet itself starts at tp_mac.
+ */
+
+#define TPACKET_ALIGNMENT  16
+#define TPACKET_ALIGN(x)   (((x) + TPACKET_ALIGNMENT - 1) & \
+                            ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN     (TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + \
+                            sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -43,4 +68,33 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* Layout of the receive ring set up with PACKET_RX_RING.  The ring is
+ * mapped as one piece, so the blocks only have to be a multiple of the
+ * frame size.
+ */
+
+struct tpacket_req
+{
+  unsigned int   tp_block_size;  /* Size of a block */
+  unsigned int   tp_block_nr;    /* Number of blocks */
+  unsigned int   tp_frame_size;  /* Size of a frame */
+  unsigned int   tp_frame_nr;    /* Total number of frames */
+};
+
+/* The header of a frame in the receive ring.  The frame belongs to the
+ * application from the time the kernel sets TP_STATUS_USER until the
+ * application sets TP_STATUS_KERNEL again.
+ */
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;      /* TP_STATUS_* */
+  unsigned int   tp_len;         /* Length of the packet */
+  unsigned int   tp_snaplen;     /* Length of the packet in the frame */
+  unsigned short tp_mac;         /* Offset of the packet in the frame */
+  unsigned short tp_net;         /* Offset of the network header */
+  unsigned int   tp_sec;         /* Receive time */
+  unsigned int   tp_usec;
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
@@ -59,6 +60,10 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#if defined(CONFIG_ADC_STREAM) && !defined(CONFIG_ADC_STREAM_BUFSIZE)
+#  define CONFIG_ADC_STREAM_BUFSIZE 4096
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -102,6 +107,23 @@ struct adc_callback_s
    */
 
   CODE int (*au_reset)(FAR struct adc_dev_s *dev);
+
+#ifdef CONFIG_ADC_STREAM
+  /* This method is called from the lower half in streaming mode each time
+   * the conversions fill one block of the stream buffer, usually from the
+   * half and complete interrupts of a cyclic DMA.  The block is rewritten
+   * when the lower half wraps around to it.
+   *
+   * Input Parameters:
+   *   dev  - The ADC device structure that was previously registered by
+   *          adc_register()
+   *   data - The start of the block in the stream buffer
+   *   len  - The size of the block in bytes
+   */
+
+  CODE void (*au_block)(FAR struct adc_dev_s *dev, FAR const void *data,
+                        size_t len);
+#endif
 };
 
 /* This describes on ADC message */
@@ -123,6 +145,23 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+#ifdef CONFIG_ADC_STREAM
+/* This describes a block of samples returned by ANIOC_STREAM_WAIT.  The
+ * samples are at sb_offset in the stream buffer mapped with mmap(), in the
+ * format of the lower half (e.g. the raw conversions of each channel of the
+ * sequence in turn).
+ */
+
+struct adc_stream_block_s
+{
+  uint32_t        sb_seqno;              /* Block number since the start */
+  uint32_t        sb_overrun;            /* Blocks lost since the start */
+  off_t           sb_offset;             /* Offset in the stream buffer */
+  size_t          sb_len;                /* Size of the block in bytes */
+  struct timespec sb_time;               /* When the block was complete */
+};
+#endif
+
 /* This structure defines all of the operations provided by the architecture
  * specific logic.  All fields must be provided with non-NULL function
  * pointers by the caller of adc_register().
@@ -166,6 +205,16 @@ struct adc_ops_s
 
   CODE int (*ao_ioctl)(FAR struct adc_dev_s *dev, int cmd,
                        unsigned long arg);
+
+#ifdef CONFIG_ADC_STREAM
+  /* Start converting continuously into the stream buffer, which is
+   * delivered in blocks with au_block(), or stop if buffer is NULL.  May
+   * be NULL if the lower half can't stream.
+   */
+
+  CODE int (*ao_stream)(FAR struct adc_dev_s *dev, FAR void *buffer,
+                        size_t size);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -193,6 +242,13 @@ struct adc_dev_s
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
   bool                        ad_isovr;      /* Flag to indicate an ADC overrun */
+#ifdef CONFIG_ADC_STREAM
+  FAR uint8_t                *ad_sbuffer;    /* NULL if not streaming */
+  uint32_t                    ad_shead;      /* Number of blocks complete */
+  uint32_t                    ad_stail;      /* Number of blocks returned */
+  uint32_t                    ad_soverrun;   /* Blocks lost to overruns */
+  struct adc_stream_block_s   ad_sblock;     /* The last complete block */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events.  The 'struct pollfd' reference for each open is also
@@ -63,9 +63,21 @@
                                                  * IN: None
                                                  * OUT: Number of samples
                                                  * waiting to be read */
+#define ANIOC_STREAM_START      _ANIOC(0x0007)  /* Start streaming samples
+                                                 * into the buffer of mmap()
+                                                 * IN: None
+                                                 * OUT: None */
+#define ANIOC_STREAM_STOP       _ANIOC(0x0008)  /* Stop streaming
+                                                 * IN: None
+                                                 * OUT: None */
+#define ANIOC_STREAM_WAIT       _ANIOC(0x0009)  /* Wait for the next block
+                                                 * of streamed samples
+                                                 * IN: None
+                                                 * OUT: struct
+                                                 * adc_stream_block_s */
 
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          6               /* Number of common commands */
+#define AN_NCMDS          9               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half driver to the lower-half driver via the ioctl()
@@ -432,6 +432,26 @@ void up_exit(int status) noreturn_function;
 
 void up_dump_register(FAR void *regs);
 
+#ifdef CONFIG_ARCH_HAVE_GETUSRPC
+
+/****************************************************************************
+ * Name: up_getusrpc
+ *
+ * Description:
+ *   Return the program counter saved in a register context.
+ *
+ * Input Parameters:
+ *   regs - The register context, NULL for the context interrupted by the
+ *          interrupt being processed
+ *
+ * Returned Value:
+ *   The program counter of the context.
+ *
+ ****************************************************************************/
+
+uintptr_t up_getusrpc(FAR void *regs);
+#endif
+
 #ifdef CONFIG_ARCH_HAVE_BACKTRACE
 
 /****************************************************************************
@@ -1858,7 +1878,8 @@ int up_timer_tick_start(clock_t ticks);
  * Name: up_getusrsp
  *
  * Input Parameters:
- *   regs - regs to get sp
+ *   regs - regs to get sp, NULL for the interrupted context where
+ *          CONFIG_ARCH_HAVE_GETUSRPC
  *
  * Returned Value:
  *   User stack pointer.
@@ -2375,6 +2396,27 @@ size_t up_check_intstack(void);
 #endif
 #endif
 
+/****************************************************************************
+ * Name: up_check_tcbstack_mark
+ *
+ * Description:
+ *   Refine a known stack use of a thread:  scan the coloring down from the
+ *   mark, until CONFIG_SCHED_STACK_WATERMARK_WINDOW bytes in a row were
+ *   never written.  Only the stack beyond the mark is read.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB of the thread
+ *   mark - The stack use known so far, in bytes
+ *
+ * Returned Value:
+ *   The stack use found, no less than mark.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_STACK_COLORATION) && defined(CONFIG_SCHED_STACK_WATERMARK)
+size_t up_check_tcbstack_mark(FAR struct tcb_s *tcb, size_t mark);
+#endif
+
 #if defined(CONFIG_ARCH_INTERRUPTSTACK) && CONFIG_ARCH_INTERRUPTSTACK > 3
 uintptr_t up_get_intstackbase(void);
 #endif
@@ -2662,6 +2704,25 @@ unsigned long up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(unsigned long elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_perf_event_*
+ *
+ * Description:
+ *   The hardware event counters behind the per-thread counts of
+ *   CONFIG_SCHED_PERF_EVENTS.  up_perf_event_supported() returns the set of
+ *   events counted, as a mask of PERF_EVENT_BIT(enum perf_event_e).
+ *   up_perf_event_read() returns the events counted on this CPU since its
+ *   previous call, in an array of PERF_EVENT_MAX values, zero for the
+ *   events not counted.  It is called with the interrupts disabled, at
+ *   each context switch.  The counters are started by up_perf_init().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+uint32_t up_perf_event_supported(void);
+void up_perf_event_read(FAR uint32_t *delta);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
@@ -92,6 +92,31 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSETUP - Allocate the ring of period buffers, for streaming
+ *                      without the message queue.  The ring can also be
+ *                      mapped with mmap().  Not permitted while started.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_s structure.  A count of
+ *                    zero periods frees the ring.
+ *
+ * AUDIOIOC_RINGCOMMIT - Hand the next periods of the ring over to the
+ *                       device: filled ones for output, empty ones for
+ *                       input.
+ *
+ *   ioctl argument:  The number of periods
+ *
+ * AUDIOIOC_RINGWAIT - Wait until the device has given at least one period
+ *                     back, unless the device was opened with O_NONBLOCK,
+ *                     and return the positions in the ring.
+ *
+ *   ioctl argument:  Pointer to the audio_ringpos_s structure
+ *
+ * AUDIOIOC_RINGRECOVER - Clear the count of xruns after the application
+ *                        has caught up.  Returns the number of periods
+ *                        that can be committed.
+ *
+ *   ioctl argument:  None
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -112,6 +137,10 @@
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
 #define AUDIOIOC_SETPARAMTER        _AUDIOIOC(18)
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(19)
+#define AUDIOIOC_RINGCOMMIT         _AUDIOIOC(20)
+#define AUDIOIOC_RINGWAIT           _AUDIOIOC(21)
+#define AUDIOIOC_RINGRECOVER        _AUDIOIOC(22)
 
 /* Audio Device Types *******************************************************/
 
@@ -493,6 +522,31 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure for the AUDIOIOC_RINGSETUP ioctl */
+
+struct audio_ring_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  apb_samp_t          periodbytes;        /* Number of bytes of a period */
+  uint16_t            nperiods;           /* Number of periods in the ring */
+  FAR uint8_t         *buffer;            /* Returned: the first period */
+};
+
+/* Structure for the AUDIOIOC_RINGWAIT ioctl.  The positions count the
+ * periods since AUDIOIOC_RINGSETUP; period n is at buffer +
+ * (n % nperiods) * periodbytes in the ring.
+ */
+
+struct audio_ringpos_s
+{
+  uint32_t            hwpos;              /* Periods given back */
+  uint32_t            applpos;            /* Periods committed */
+  uint32_t            hwbytes;            /* Bytes processed in period hwpos */
+  uint32_t            xruns;              /* Times the device ran dry */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mix.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIX_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_AUDIO_MIX
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mix_initialize
+ *
+ * Description:
+ *   Register nstreams audio devices, <name>0 to <name>N-1, that all play
+ *   through one output device.  Each device accepts 16-bit PCM, mono or
+ *   stereo, at any rate up to CONFIG_AUDIO_MIX_SAMPLERATE and has its own
+ *   volume.  The streams are resampled to the output rate and mixed into
+ *   16-bit stereo buffers for the output device.
+ *
+ * Input Parameters:
+ *   name     - The name of the devices, before the stream number
+ *   lower    - The output device.  It must not be registered by itself.
+ *   nstreams - The number of devices to register
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mix_initialize(FAR const char *name,
+                         FAR struct audio_lowerhalf_s *lower,
+                         int nstreams);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIX */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIX_H */
@@ -49,6 +49,10 @@
 
 /* Default configuration values */
 
+#ifndef CONFIG_AUDIO_PCM_PREBUFFER
+#  define CONFIG_AUDIO_PCM_PREBUFFER 0
+#endif
+
 /* WAVE Header Definitions **************************************************/
 
 /* All values are little 32-bit or 16-bit endian */
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * include/nuttx/benchmark/latency.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BENCHMARK_LATENCY_H
+#define __INCLUDE_NUTTX_BENCHMARK_LATENCY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+
+/* LATENCYIOC_GETPARAM - Return the parameters of the next run
+ *   Argument: A pointer to struct latency_param_s
+ *
+ * LATENCYIOC_SETPARAM - Set the parameters of the next run
+ *   Argument: A pointer to struct latency_param_s
+ */
+
+#define LATENCYIOC_GETPARAM  _BENCHIOC(0x01)
+#define LATENCYIOC_SETPARAM  _BENCHIOC(0x02)
+
+/* The background loads, see struct latency_param_s */
+
+#define LATENCY_LOAD_HEAP    (1 << 0)  /* kmm_malloc()/kmm_free() churn */
+#define LATENCY_LOAD_NET     (1 << 1)  /* UDP over the loopback device */
+#define LATENCY_LOAD_FILE    (1 << 2)  /* Writes and reads of a file */
+
+/* Reading /dev/latency from the start runs the benchmark, then returns the
+ * report as lines of text:
+ *
+ *   # interval <usec> loops <n> priority <n> load <mask>
+ *   # cpu <n> samples <n> min <nsec> avg <nsec> max <nsec> overruns <n>
+ *   #   wakeup <nsec>
+ *   <usec> <count cpu0> [<count cpu1> ...]
+ *   ...
+ *   # overflow <count cpu0> [<count cpu1> ...]
+ *
+ * Each histogram line counts the wakeups late by <usec> microseconds.
+ * "wakeup" is the worst time from the timer interrupt to the measuring
+ * thread running, a part of the latency.  So it can be run from the
+ * shell with the configured defaults:
+ *
+ *   cat /dev/latency
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct latency_param_s
+{
+  uint32_t interval;                   /* Period of the wakeups, in usec */
+  uint32_t loops;                      /* Wakeups measured per CPU */
+  uint32_t load;                       /* LATENCY_LOAD_* bits */
+  uint8_t  priority;                   /* Priority of the measuring threads */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: latency_register
+ *
+ * Description:
+ *   Register the scheduling latency benchmark as /dev/latency.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_LATENCY
+int latency_register(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_BENCHMARK_LATENCY_H */
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * include/nuttx/benchmark/microbench.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BENCHMARK_MICROBENCH_H
+#define __INCLUDE_NUTTX_BENCHMARK_MICROBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+
+/* MICROBENCHIOC_GETPARAM - Return the parameters of the next run
+ *   Argument: A pointer to struct microbench_param_s
+ *
+ * MICROBENCHIOC_SETPARAM - Set the parameters of the next run
+ *   Argument: A pointer to struct microbench_param_s
+ */
+
+#define MICROBENCHIOC_GETPARAM _BENCHIOC(0x03)
+#define MICROBENCHIOC_SETPARAM _BENCHIOC(0x04)
+
+/* Reading /dev/microbench from the start runs the benchmarks, then returns
+ * the report as lines of text:
+ *
+ *   # freq <hz> loops <n> priority <n> heap <manager>
+ *   <name> <samples> <min> <avg> <max>
+ *   ...
+ *
+ * The costs are in counts of up_perf_gettime() at <freq>, the CPU cycles
+ * where it is the cycle counter.  They include the cost of reading the
+ * counter, measured by the "null" line.  A benchmark that could not be
+ * set up is reported as "# <name> error <errno>".  The benchmarks run on
+ * the first CPU, in a thread at <priority>, with their helper threads.
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct microbench_param_s
+{
+  uint32_t loops;                      /* Samples per benchmark */
+  uint8_t  priority;                   /* Priority of the benchmark thread */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: microbench_register
+ *
+ * Description:
+ *   Register the kernel micro-benchmarks as /dev/microbench.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BENCHMARK_MICRO
+int microbench_register(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_BENCHMARK_MICROBENCH_H */
@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 #include <elf.h>
 
 #include <nuttx/arch.h>
@@ -103,6 +104,10 @@ struct elf_loadinfo_s
   Elf_Ehdr          ehdr;        /* Buffered ELF file header */
   FAR Elf_Shdr      *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
+#ifdef CONFIG_ELF_LOADSYMTAB
+  FAR Elf_Sym       *symtab;     /* Symbol table read while binding */
+  FAR char          *strtab;     /* Its string table */
+#endif
 
   /* Constructors and destructors */
 
@@ -126,6 +131,11 @@ struct elf_loadinfo_s
   FAR addrenv_t     *oldenv;     /* Saved address environment */
 #endif
 
+#ifdef CONFIG_ELF_CACHE
+  FAR const char    *filename;   /* Path of the file, for the image cache */
+  struct timespec    mtime;      /* Its modification time */
+#endif
+
   uint16_t           symtabidx;  /* Symbol table section index */
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
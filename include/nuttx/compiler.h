@@ -241,6 +241,10 @@
 
 #  define nosanitize_undefined __attribute__((no_sanitize("undefined")))
 
+/* The return address of the current function, or of its callers */
+
+#  define return_address(x) __builtin_return_address(x)
+
 /* The nostackprotect_function attribute disables stack protection in
  * sensitive functions, e.g., stack coloration routines.
  */
@@ -532,6 +536,7 @@
 #  define noinstrument_function
 #  define nosanitize_address
 #  define nosanitize_undefined
+#  define return_address(x) 0
 #  define nostackprotect_function
 
 #  define unused_code
@@ -674,6 +679,7 @@
 #  define noinstrument_function
 #  define nosanitize_address
 #  define nosanitize_undefined
+#  define return_address(x) 0
 #  define nostackprotect_function
 #  define unused_code
 #  define unused_data
@@ -784,6 +790,7 @@
 #  define noinstrument_function
 #  define nosanitize_address
 #  define nosanitize_undefined
+#  define return_address(x) 0
 #  define nostackprotect_function
 #  define unused_code
 #  define unused_data
@@ -873,6 +880,7 @@
 #  define noinstrument_function
 #  define nosanitize_address
 #  define nosanitize_undefined
+#  define return_address(x) 0
 #  define nostackprotect_function
 #  define unused_code
 #  define unused_data
@@ -937,6 +945,7 @@
 #  define noinstrument_function
 #  define nosanitize_address
 #  define nosanitize_undefined
+#  define return_address(x) 0
 #  define nostackprotect_function
 #  define unused_code
 #  define unused_data
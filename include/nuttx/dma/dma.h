@@ -315,4 +315,58 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA_MEMCPY
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ *
+ * Description:
+ *   Configure a channel for memory to memory transfers and hand it to
+ *   dma_memcpy(), usually at board bring-up.  The channel stays in use
+ *   until NULL is registered instead.
+ *
+ * Input Parameters:
+ *   chan - A channel from DMA_GET_CHAN(), or NULL
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the channel can't do memory
+ *   to memory transfers.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_chan_s *chan);
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Same as memcpy(), but copies of at least CONFIG_DMA_MEMCPY_THRESHOLD
+ *   bytes are made by the registered channel while the caller waits.  The
+ *   cache lines only partly covered by dst are copied by the CPU during
+ *   the transfer.  From interrupt handlers, the idle task, or while the
+ *   channel is busy the copy falls back to memcpy().
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len);
+
+#endif /* CONFIG_DMA_MEMCPY */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
@@ -0,0 +1,211 @@
+/****************************************************************************
+ * include/nuttx/dma/dma_map.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DMA_DMA_MAP_H
+#define __INCLUDE_NUTTX_DMA_DMA_MAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/cache.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Who accesses a buffer mapped with dma_map_single() */
+
+#define DMA_TO_DEVICE           1  /* The device only reads it */
+#define DMA_FROM_DEVICE         2  /* The device only writes it */
+#define DMA_BIDIRECTIONAL       3  /* The device reads and writes it */
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_map_single
+ *
+ * Description:
+ *   Hand a buffer in cacheable memory over to a device, before starting
+ *   the transfer.  The buffer must not be accessed by the CPU until it is
+ *   given back with dma_unmap_single(), and neither should the rest of the
+ *   cache lines it shares at either end.
+ *
+ * Input Parameters:
+ *   addr - The start of the buffer
+ *   size - Its size in bytes
+ *   dir  - DMA_TO_DEVICE, DMA_FROM_DEVICE or DMA_BIDIRECTIONAL
+ *
+ * Returned Value:
+ *   The address to program into the device.
+ *
+ ****************************************************************************/
+
+static inline uintptr_t dma_map_single(FAR const void *addr, size_t size,
+                                       int dir)
+{
+  uintptr_t start = (uintptr_t)addr;
+  uintptr_t end = start + size;
+  size_t linesize = up_get_dcache_linesize();
+  uintptr_t first;
+  uintptr_t last;
+
+  if (dir == DMA_TO_DEVICE)
+    {
+      /* The device must see what the CPU wrote */
+
+      up_clean_dcache(start, end);
+      return start;
+    }
+
+  if (linesize == 0)
+    {
+      return start;
+    }
+
+  /* No dirty line may be evicted over what the device writes.  The lines
+   * covered entirely by the buffer are discarded.  The lines at the ends
+   * are written back instead, as they may hold data of the CPU next to the
+   * buffer.  For a device that reads the buffer too, all are written back.
+   */
+
+  first = (start + linesize - 1) & ~(linesize - 1);
+  last  = end & ~(linesize - 1);
+
+  if (dir == DMA_BIDIRECTIONAL || first >= last)
+    {
+      up_flush_dcache(start, end);
+    }
+  else
+    {
+      if (start < first)
+        {
+          up_flush_dcache(start, first);
+        }
+
+      up_invalidate_dcache(first, last);
+
+      if (last < end)
+        {
+          up_flush_dcache(last, end);
+        }
+    }
+
+  return start;
+}
+
+/****************************************************************************
+ * Name: dma_unmap_single
+ *
+ * Description:
+ *   Give a buffer mapped with dma_map_single() back to the CPU, once the
+ *   transfer has completed.  Nothing is done for buffers the device only
+ *   read.  For the others, the lines the CPU may have fetched during the
+ *   transfer are discarded.
+ *
+ * Input Parameters:
+ *   handle - The address returned by dma_map_single()
+ *   size   - The size of the buffer in bytes
+ *   dir    - The direction it was mapped with
+ *
+ ****************************************************************************/
+
+static inline void dma_unmap_single(uintptr_t handle, size_t size, int dir)
+{
+  if (dir != DMA_TO_DEVICE)
+    {
+      up_invalidate_dcache(handle, handle + size);
+    }
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA_COHERENT
+
+/****************************************************************************
+ * Name: dma_coherent_initialize
+ *
+ * Description:
+ *   Give dma_alloc_coherent() a region of memory that the CPU does not
+ *   cache, usually at board bring-up once the region has been configured
+ *   in the MPU (for example with mpu_priv_noncache() on ARMv7-M).
+ *
+ * Input Parameters:
+ *   start - The start of the region
+ *   size  - Its size in bytes
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_coherent_initialize(FAR void *start, size_t size);
+
+/****************************************************************************
+ * Name: dma_alloc_coherent
+ *
+ * Description:
+ *   Allocate memory that the CPU and the devices can share without any
+ *   cache maintenance, such as descriptor rings.  The memory is aligned to
+ *   the data cache line.  Without a data cache, it comes from the kernel
+ *   heap.
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL.
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc_coherent(size_t size);
+
+/****************************************************************************
+ * Name: dma_free_coherent
+ *
+ * Description:
+ *   Free memory allocated with dma_alloc_coherent().
+ *
+ ****************************************************************************/
+
+void dma_free_coherent(FAR void *mem);
+
+#endif /* CONFIG_DMA_COHERENT */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_DMA_DMA_MAP_H */
@@ -29,6 +29,23 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Sector cache statistics returned by the BIOC_CACHESTATS ioctl of BCH
+ * character drivers.
+ */
+
+struct bch_cachestats_s
+{
+  uint32_t hits;           /* Accesses to a sector found in the cache */
+  uint32_t misses;         /* Accesses that had to read the media */
+  uint32_t readahead;      /* Sectors read ahead of a sequential access */
+  uint32_t writebacks;     /* Dirty sectors written back to the media */
+};
 
 /****************************************************************************
  * Public Function Prototypes
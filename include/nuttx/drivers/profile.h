@@ -0,0 +1,119 @@
+/****************************************************************************
+ * include/nuttx/drivers/profile.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_PROFILE_H
+#define __INCLUDE_NUTTX_DRIVERS_PROFILE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+
+/* PROFIOC_START - Start sampling
+ *   Argument: The sample interval in microseconds, zero for the default
+ *             interval CONFIG_DEV_PROFILE_INTERVAL
+ *
+ * PROFIOC_STOP - Stop sampling
+ *   Argument: Ignored
+ *
+ * PROFIOC_RESET - Discard the samples not read yet
+ *   Argument: Ignored
+ */
+
+#define PROFIOC_START       _PROFIOC(0x01)
+#define PROFIOC_STOP        _PROFIOC(0x02)
+#define PROFIOC_RESET       _PROFIOC(0x03)
+
+/* The samples are read from the device as lines of text:
+ *
+ *   <cpu> <pid> <pc> [<caller> ...]
+ *
+ * with the addresses in hexadecimal, innermost first.  The samples lost
+ * because the buffer of a CPU was full are reported by a comment line:
+ *
+ *   # <cpu> lost <count>
+ *
+ * Writing "1" to the device starts sampling at the default interval and
+ * writing "0" stops it, so it can be driven from the shell:
+ *
+ *   echo 1 > /dev/profile
+ *   ...
+ *   echo 0 > /dev/profile
+ *   cat /dev/profile
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PROFILE_TIMER
+struct timer_lowerhalf_s;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: profile_register
+ *
+ * Description:
+ *   Register the sampling profiler as /dev/profile.
+ *
+ * Input Parameters:
+ *   lower - The timer whose interrupt takes the samples, with
+ *           CONFIG_DEV_PROFILE_TIMER.  Otherwise the samples are taken by a
+ *           watchdog, from the interrupt of the system timer.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PROFILE
+#  ifdef CONFIG_DEV_PROFILE_TIMER
+int profile_register(FAR struct timer_lowerhalf_s *lower);
+#  else
+int profile_register(void);
+#  endif
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_DRIVERS_PROFILE_H */
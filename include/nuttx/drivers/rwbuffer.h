@@ -134,6 +134,21 @@ struct rwbuffer_s
   off_t         wrblockstart;    /* First block in write buffer */
 #endif
 
+#ifdef CONFIG_DRVR_WRADAPTIVE
+  clock_t       wrlast;          /* Time of the last write */
+  clock_t       wrgap;           /* Average gap between the writes of a burst */
+#endif
+
+  /* This is the state of the buffer being flushed in the background */
+
+#ifdef CONFIG_DRVR_WRDOUBLE
+  struct work_s flwork;          /* Work to flush the buffer */
+  sem_t         flsem;           /* Taken while a flush is in progress */
+  FAR uint8_t  *flbuffer;        /* Allocated second buffer */
+  uint16_t      flnblocks;       /* Number of blocks being flushed */
+  off_t         flblockstart;    /* First block being flushed */
+#endif
+
   /* This is the state of the read-ahead buffering */
 
 #ifdef CONFIG_DRVR_READAHEAD
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * include/nuttx/fs/aio.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_AIO_H
+#define __INCLUDE_NUTTX_FS_AIO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <aio.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_FS_AIO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An asynchronous transfer offered to a driver with the FIOC_AIOSTART
+ * ioctl command.  A driver that can complete the transfer without blocking
+ * the caller (e.g. by DMA) returns OK and later calls aio_complete() with
+ * the same structure, possibly from its interrupt handler.  Any other
+ * return value makes the AIO logic perform the transfer synchronously.
+ *
+ * The driver may be offered further requests before the previous ones
+ * complete and must queue them as needed.
+ */
+
+struct aio_request_s
+{
+  FAR struct aiocb *aiocbp; /* Buffer, length and offset of the transfer */
+  int opcode;               /* LIO_READ or LIO_WRITE */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   Report the completion of a request accepted through FIOC_AIOSTART.
+ *   This function may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   req    - The request passed to FIOC_AIOSTART
+ *   result - The number of bytes transferred or a negated errno value
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_complete(FAR struct aio_request_s *req, ssize_t result);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_AIO */
+#endif /* __INCLUDE_NUTTX_FS_AIO_H */
@@ -0,0 +1,49 @@
+/****************************************************************************
+ * include/nuttx/fs/cromfs.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_CROMFS_H
+#define __INCLUDE_NUTTX_FS_CROMFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+/* This is the structure returned by the FIOC_CROMFSSTATS IOCTL command,
+ * issued on any file opened in a CROMFS mount.
+ */
+
+struct cromfs_stats_s
+{
+  uint32_t cs_hits;        /* Reads served from the decompressed block cache */
+  uint32_t cs_misses;      /* Reads that had to decompress a block */
+  uint32_t cs_readaheads;  /* Blocks decompressed ahead of a reader */
+};
+
+#endif /* __INCLUDE_NUTTX_FS_CROMFS_H */
@@ -96,6 +96,8 @@
 #define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
 #define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
 #define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_NOLOCK (1 << 4) /* Locking done by the caller, see
+                                   * __fsetlocking() */
 
 /* Inode i_flags values:
  *
@@ -169,6 +171,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct pollcache_s;
 struct mtd_dev_s;
 struct tcb_s;
 
@@ -435,6 +438,19 @@ struct file
 #endif
 };
 
+/* The argument of the PIPEIOC_SPLICE ioctl: move data between the pipe and
+ * another file.
+ */
+
+struct pipe_splice_s
+{
+  FAR struct file  *ps_file;     /* The other end of the transfer */
+  FAR off_t        *ps_offset;   /* Position in ps_file, NULL: f_pos */
+  size_t            ps_len;      /* Maximum number of bytes to move */
+  bool              ps_tofile;   /* From the pipe to ps_file, else reverse */
+  bool              ps_nonblock; /* Do not wait on the pipe */
+};
+
 /* This defines a two layer array of files indexed by the file descriptor.
  * Each row of this array is fixed size: CONFIG_NFILE_DESCRIPTORS_PER_BLOCK.
  * You can get file instance in filelist by the follow methods:
@@ -447,6 +463,7 @@ struct filelist
   mutex_t           fl_lock;    /* Manage access to the file list */
   uint8_t           fl_rows;    /* The number of rows of fl_files array */
   FAR struct file **fl_files;   /* The pointer of two layer file descriptors array */
+  FAR void         *fl_retired; /* The replaced arrays of fl_files */
 };
 
 /* The following structure defines the list of files used for standard C I/O.
@@ -1295,6 +1312,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1360,6 +1392,19 @@ int file_truncate(FAR struct file *filep, off_t length);
 int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped);
 
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Return the address at which the region [offset, offset + length) of
+ *   the file is directly accessible in memory.  Returns -ENOTTY if the
+ *   file data is not memory-backed.  Nothing has to be unmapped.
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, off_t offset, size_t length,
+                     FAR void **mapped);
+
 /****************************************************************************
  * Name: file_mummap
  *
@@ -1371,6 +1416,17 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
 
 int file_munmap(FAR void *start, size_t length);
 
+/****************************************************************************
+ * Name: file_msync
+ *
+ * Description:
+ *   Equivalent to the standard msync() function except it does not set
+ *   the errno variable.
+ *
+ ****************************************************************************/
+
+int file_msync(FAR void *start, size_t length, int flags);
+
 /****************************************************************************
  * Name: file_ioctl
  *
@@ -1433,6 +1489,31 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+#ifdef CONFIG_FS_POLLCACHE
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Tear down the registrations kept by poll() on a file being closed.
+ *
+ ****************************************************************************/
+
+void poll_cache_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Tear down and free the registrations kept by poll() for an exiting
+ *   thread.
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct pollcache_s *cache);
+
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -95,6 +95,9 @@
 #define _VIDIOCBASE     (0x3700) /* Video device ioctl commands */
 #define _CELLIOCBASE    (0x3800) /* Cellular device ioctl commands */
 #define _MIPIDSIBASE    (0x3900) /* Mipidsi device ioctl commands */
+#define _PROFBASE       (0x3a00) /* Sampling profiler ioctl commands */
+#define _PROCFSBASE     (0x3b00) /* Procfs file ioctl commands */
+#define _BENCHBASE      (0x3c00) /* Benchmark ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -196,6 +199,17 @@
                                            */
 #endif
 
+#define FIOC_AIOSTART   _FIOC(0x0010)     /* IN:  Pointer to struct aio_request_s
+                                           *      describing the transfer
+                                           * OUT: None.  The driver calls
+                                           *      aio_complete() when done.
+                                           */
+#define FIOC_CROMFSSTATS _FIOC(0x0011)    /* IN:  Pointer to struct
+                                           *      cromfs_stats_s
+                                           * OUT: The block cache
+                                           *      statistics of the mount
+                                           */
+
 /* NuttX file system ioctl definitions **************************************/
 
 #define _DIOCVALID(c)   (_IOC_TYPE(c)==_DIOCBASE)
@@ -303,6 +317,14 @@
                                            *      to return sector size.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_CACHESTATS _BIOC(0x0010)     /* Used only by BCH to return the
+                                           * statistics of its sector cache.
+                                           * IN:  Pointer to writable instance
+                                           *      of struct bch_cachestats_s
+                                           *      in which to return the
+                                           *      statistics.
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -446,6 +468,13 @@
                                                *     threshold.
                                                * OUT: None */
 
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0004)  /* Move data between the pipe
+                                               * and another file.
+                                               * IN: Pointer to struct
+                                               *     pipe_splice_s.
+                                               * OUT: Number of bytes
+                                               *      moved as result */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -639,6 +668,27 @@
 #define _MIPIDSIIOCVALID(c)    (_IOC_TYPE(c)==_MIPIDSIBASE)
 #define _MIPIDSIIOC(nr)        _IOC(_MIPIDSIBASE,nr)
 
+/* Sampling profiler driver ioctl definitions *******************************/
+
+/* (see nuttx/include/nuttx/drivers/profile.h) */
+
+#define _PROFIOCVALID(c)  (_IOC_TYPE(c)==_PROFBASE)
+#define _PROFIOC(nr)      _IOC(_PROFBASE,nr)
+
+/* Procfs file ioctl definitions ********************************************/
+
+/* (see nuttx/include/nuttx/fs/procfs.h) */
+
+#define _PROCFSIOCVALID(c) (_IOC_TYPE(c)==_PROCFSBASE)
+#define _PROCFSIOC(nr)     _IOC(_PROCFSBASE,nr)
+
+/* Benchmark driver ioctl definitions ***************************************/
+
+/* (see nuttx/include/nuttx/benchmark/) */
+
+#define _BENCHIOCVALID(c) (_IOC_TYPE(c)==_BENCHBASE)
+#define _BENCHIOC(nr)     _IOC(_BENCHBASE,nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
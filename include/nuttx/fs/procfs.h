@@ -26,12 +26,30 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* IOCTL Commands ***********************************************************/
+
+/* PROCFSIOC_RESET - Reset the statistics reported by a procfs file that
+ *   accumulates them across reads
+ *   Argument: Ignored
+ */
+
+#define PROCFSIOC_RESET     _PROCFSIOC(0x01)
+
+/* The binary snapshot of /proc/stats */
+
+#define PROCFS_STATS_VERSION 1
+#define PROCFS_STATS_NAMELEN 16
+
 /* Data entry declaration prototypes ****************************************/
 
 /* Procfs operations are a subset of the mountpt_operations */
@@ -81,6 +99,10 @@ struct procfs_operations
   /* Operations on paths */
 
   int     (*stat)(FAR const char *relpath, FAR struct stat *buf);
+
+  /* Optional operations on open files */
+
+  int     (*ioctl)(FAR struct file *filep, int cmd, unsigned long arg);
 };
 
 /* Procfs handler prototypes ************************************************/
@@ -144,6 +166,64 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+/* /proc/stats returns all of the statistics below in a single read:  A
+ * struct procfs_stats_s, followed by ntasks struct procfs_stats_task_s and
+ * then nirqs struct procfs_stats_irq_s.  The sizes of the structures are
+ * in the header; a reader should step over the records by these sizes
+ * rather than by its own sizeof(), so that it keeps working when fields
+ * are added at their end.  Figures that are not configured read as zero.
+ */
+
+struct procfs_stats_heap_s
+{
+  uint32_t total;                /* Size of the heap */
+  uint32_t used;                 /* Bytes allocated */
+  uint32_t avail;                /* Bytes free */
+  uint32_t largest;              /* Largest free chunk */
+  uint32_t nused;                /* Number of allocated chunks */
+  uint32_t nfree;                /* Number of free chunks */
+};
+
+struct procfs_stats_s
+{
+  uint16_t version;              /* PROCFS_STATS_VERSION */
+  uint16_t hdrsize;              /* sizeof(struct procfs_stats_s) */
+  uint16_t tasksize;             /* sizeof(struct procfs_stats_task_s) */
+  uint16_t irqsize;              /* sizeof(struct procfs_stats_irq_s) */
+  uint32_t ntasks;               /* Number of task records */
+  uint32_t nirqs;                /* Number of IRQ records */
+  uint64_t uptime;               /* Milliseconds since boot */
+  struct procfs_stats_heap_s kheap;
+  struct procfs_stats_heap_s uheap;
+  uint32_t iobfree;              /* Free I/O buffers */
+  uint32_t ipv4[3];              /* IPv4 packets received, sent, dropped */
+  uint32_t ipv6[3];              /* IPv6 packets received, sent, dropped */
+  uint32_t tcp[3];               /* TCP segments received, sent, dropped */
+  uint32_t udp[3];               /* UDP datagrams received, sent, dropped */
+};
+
+struct procfs_stats_task_s
+{
+  int32_t  pid;                  /* Thread ID */
+  uint8_t  priority;             /* Current priority */
+  uint8_t  state;                /* enum tstate_e */
+  uint16_t flags;                /* TCB_FLAG_* */
+  uint32_t stacksize;            /* Size of the stack */
+  uint32_t loadticks;            /* CPU load ticks (SCHED_CPULOAD) */
+  uint32_t nvcsw;                /* Voluntary switches (SCHED_RUSAGE) */
+  uint32_t nivcsw;               /* Involuntary switches */
+  uint64_t rchar;                /* Bytes read */
+  uint64_t wchar;                /* Bytes written */
+  char     name[PROCFS_STATS_NAMELEN];
+};
+
+struct procfs_stats_irq_s
+{
+  uint32_t irq;                  /* IRQ number */
+  uint32_t time;                 /* Maximum execution time, microseconds */
+  uint64_t count;                /* Interrupts since the last reset */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -31,6 +31,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -234,6 +235,28 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_QUEUE
+/* This describes one transfer queued by i2c_transfer_async().  The
+ * complete callback runs on the thread of the queue once the transfer is
+ * done, so it may queue the next one right away.
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_complete_t)(FAR struct i2c_request_s *req,
+                                    int result);
+
+struct i2c_request_s
+{
+  sq_entry_t node;            /* Used by the queue */
+  FAR struct i2c_msg_s *msgv; /* Array of I2C messages for the transfer */
+  int msgc;                   /* Number of messages in the array */
+  i2c_complete_t complete;    /* Called when the transfer is done */
+  FAR void *arg;              /* For use by the complete callback */
+};
+
+struct i2c_queue_s;           /* Opaque, one per I2C bus */
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -347,6 +370,84 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Return the transfer queue of an I2C bus, starting its thread the first
+ *   time.  Every driver on the bus gets the same queue, which is released
+ *   by i2c_queue_uninitialize().  The thread performs the transfers with
+ *   I2C_TRANSFER(), so any lower half can be used.
+ *
+ * Input Parameters:
+ *   dev - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *dev);
+
+/****************************************************************************
+ * Name: i2c_queue_uninitialize
+ *
+ * Description:
+ *   Release a reference to the queue.  With the last one the thread stops
+ *   and the transfers still queued complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *
+ ****************************************************************************/
+
+void i2c_queue_uninitialize(FAR struct i2c_queue_s *queue);
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return without waiting for it.  Transfers
+ *   are performed in the order they are queued.  Back to back transfers
+ *   to the same address are combined into one I2C_TRANSFER(), and then
+ *   all of them complete with its result.  The request and its messages
+ *   must stay valid until the complete callback is called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - Describes the messages and the callback
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a transfer that has not started yet.  Its complete callback is
+ *   not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request passed to i2c_transfer_async()
+ *
+ * Returned Value:
+ *   0: the transfer was removed, -EBUSY: it has started or is done
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_queue_s *queue,
+                        FAR struct i2c_request_s *req);
+
+#endif /* CONFIG_I2C_QUEUE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
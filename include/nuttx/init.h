@@ -100,6 +100,30 @@ EXTERN uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void) noreturn_function;
 
+/* Functions contained in nx_bootprofile.c **********************************/
+
+/* Record the end of a boot phase and read the recorded phases back */
+
+#ifdef CONFIG_SCHED_BOOTPROFILE
+struct timespec;
+
+void nx_bootmark(FAR const char *phase);
+int nx_bootphase(unsigned int index, FAR const char **phase,
+                 FAR struct timespec *end, FAR struct timespec *len);
+#else
+#  define nx_bootmark(phase)
+#endif
+
+/* Functions contained in nx_asyncinit.c ************************************/
+
+/* Run initialization calls on their own threads and wait for them */
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+int nx_async_init(FAR const char *name, CODE int (*func)(FAR void *arg),
+                  FAR void *arg, FAR const char *after);
+int nx_async_wait(FAR const char *name);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -76,9 +76,13 @@
                                              * struct g_tscaldata_s
                                              */
 #define TSIOC_USESCALED      _TSIOC(0x0009) /* arg: bool, yes/no */
+#define TSIOC_SETWAKEUP      _TSIOC(0x000a) /* arg: int, number of move
+                                             * samples queued before the
+                                             * reader is woken up
+                                             */
 
 #define TSC_FIRST            0x0001          /* First common command */
-#define TSC_NCMDS            6               /* Six common commands */
+#define TSC_NCMDS            10              /* Ten common commands */
 
 /* User defined ioctl commands are also supported.  However, the
  * TSC driver must reserve a block of commands as follows in order
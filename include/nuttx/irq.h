@@ -48,6 +48,21 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* Returned by the top half of an interrupt attached with
+ * irq_attach_thread() to have its bottom half run in the thread.
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
+/* May be returned by the handlers of an IRQ shared with irqchain:
+ * IRQ_NONE tells the interrupt was not raised by the device of the
+ * handler, IRQ_HANDLED that it was served and the handlers attached after
+ * this one need not be called.
+ */
+
+#  define IRQ_NONE        2
+#  define IRQ_HANDLED     3
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -154,6 +169,22 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is dispatched to
+ *   the top half 'isr' and, each time it returns IRQ_WAKE_THREAD, to the
+ *   bottom half 'isrthread' in a kernel thread of its own, of priority
+ *   'priority' and pinned to 'cpu' unless it is -1.  A NULL 'isr' masks
+ *   the interrupt until the bottom half ran; a NULL 'isrthread' detaches
+ *   the interrupt and deletes the thread.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size, int cpu);
+
 /****************************************************************************
  * Name: enter_critical_section
  *
@@ -108,6 +108,22 @@ extern "C"
 
 #endif
 
+/* Allocate kernel memory from a region with the given MM_REGION_*
+ * attributes, such as fast memory for hot data, falling back to the kernel
+ * heap under pressure (see mm/mm_region).
+ */
+
+#ifdef CONFIG_MM_REGION
+FAR void *kmm_malloc_region(unsigned int flags, size_t size);
+FAR void *kmm_memalign_region(unsigned int flags, size_t alignment,
+                              size_t size);
+#else
+#  define kmm_malloc_region(f,s)      \
+     (((f) & MM_REGION_NOFALLBACK) ? NULL : kmm_malloc(s))
+#  define kmm_memalign_region(f,a,s)  \
+     (((f) & MM_REGION_NOFALLBACK) ? NULL : kmm_memalign(a,s))
+#endif
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 /****************************************************************************
  * Group memory management
@@ -0,0 +1,253 @@
+//***************************************************************************
+// include/nuttx/lib/memory_resource.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_LIB_MEMORY_RESOURCE_HXX
+#define __INCLUDE_NUTTX_LIB_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+
+#ifdef CONFIG_CXX_MEMORY_RESOURCE
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+struct mempool_multiple_s;
+
+namespace nuttx
+{
+  // The interface of std::pmr::memory_resource, which none of the C++
+  // libraries of the tree provide in full.  Memory is given back with its
+  // size, so that a resource needs no header in front of its blocks.
+
+  class memory_resource
+  {
+  public:
+    virtual ~memory_resource() = default;
+
+    FAR void *allocate(std::size_t bytes,
+                       std::size_t alignment = alignof(max_align_t))
+    {
+      return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(FAR void *p, std::size_t bytes,
+                    std::size_t alignment = alignof(max_align_t))
+    {
+      do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(const memory_resource &other) const noexcept
+    {
+      return do_is_equal(other);
+    }
+
+  private:
+    virtual FAR void *do_allocate(std::size_t bytes,
+                                  std::size_t alignment) = 0;
+    virtual void do_deallocate(FAR void *p, std::size_t bytes,
+                               std::size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource &other)
+      const noexcept = 0;
+  };
+
+  // Blocks up to maxblock bytes come from a multiple mempool of their own,
+  // in steps of two pointers, the larger ones from the upstream resource.
+  // The pools grow by expandsize bytes at a time and are only given back
+  // to the heap when the resource is destroyed.  It is thread safe if its
+  // upstream resource is.
+
+  class pool_resource : public memory_resource
+  {
+  public:
+    pool_resource(FAR const char *name, std::size_t maxblock = 64,
+                  std::size_t expandsize = 4096,
+                  FAR memory_resource *upstream = nullptr);
+    ~pool_resource();
+
+    pool_resource(const pool_resource &) = delete;
+    pool_resource &operator=(const pool_resource &) = delete;
+
+    FAR memory_resource *upstream_resource() const noexcept
+    {
+      return m_upstream;
+    }
+
+  private:
+    FAR void *do_allocate(std::size_t bytes, std::size_t alignment)
+      override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    FAR struct mempool_multiple_s *m_mpool;
+    FAR memory_resource           *m_upstream;
+    std::size_t                    m_maxblock;
+  };
+
+  // Memory is handed out of chunks taken from the upstream resource, or
+  // first of the buffer given, and is only reclaimed all at once by
+  // release() or the destructor.  Each chunk is twice the size of the
+  // previous one.  It is not thread safe.
+
+  class monotonic_resource : public memory_resource
+  {
+  public:
+    explicit monotonic_resource(std::size_t chunksize = 1024,
+                                FAR memory_resource *upstream = nullptr);
+    monotonic_resource(FAR void *buffer, std::size_t size,
+                       FAR memory_resource *upstream = nullptr);
+    ~monotonic_resource()
+    {
+      release();
+    }
+
+    monotonic_resource(const monotonic_resource &) = delete;
+    monotonic_resource &operator=(const monotonic_resource &) = delete;
+
+    void release();
+
+    FAR memory_resource *upstream_resource() const noexcept
+    {
+      return m_upstream;
+    }
+
+  private:
+    struct chunk_s;
+
+    FAR void *do_allocate(std::size_t bytes, std::size_t alignment)
+      override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    FAR memory_resource *m_upstream;
+    FAR struct chunk_s  *m_chunks;    // Chunks taken from upstream
+    FAR char            *m_initial;   // The buffer given, if any
+    std::size_t          m_initsize;
+    FAR char            *m_buffer;    // Remaining space of the last chunk
+    std::size_t          m_size;
+    std::size_t          m_chunksize; // Size of the next chunk
+  };
+
+  // A container allocator drawing from a memory resource, as
+  // std::pmr::polymorphic_allocator does:
+  //
+  //   nuttx::pool_resource pool("nodes");
+  //   std::list<int, nuttx::allocator<int>> list(&pool);
+
+  template <typename T>
+  class allocator
+  {
+  public:
+    typedef T              value_type;
+    typedef FAR T         *pointer;
+    typedef FAR const T   *const_pointer;
+    typedef T             &reference;
+    typedef const T       &const_reference;
+    typedef std::size_t    size_type;
+    typedef ptrdiff_t      difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+      typedef allocator<U> other;
+    };
+
+    allocator(FAR memory_resource *resource = nullptr) noexcept;
+
+    template <typename U>
+    allocator(const allocator<U> &other) noexcept
+      : m_resource(other.resource())
+    {
+    }
+
+    FAR T *allocate(std::size_t n)
+    {
+      return static_cast<FAR T *>(m_resource->allocate(n * sizeof(T),
+                                                       alignof(T)));
+    }
+
+    void deallocate(FAR T *p, std::size_t n)
+    {
+      m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    FAR memory_resource *resource() const noexcept
+    {
+      return m_resource;
+    }
+
+  private:
+    FAR memory_resource *m_resource;
+  };
+
+//***************************************************************************
+// Public Function Prototypes
+//***************************************************************************
+
+  // The resource on top of the C library heap, used as upstream resource
+  // when none is given
+
+  FAR memory_resource *heap_resource() noexcept;
+
+//***************************************************************************
+// Inline Functions
+//***************************************************************************
+
+  template <typename T>
+  inline allocator<T>::allocator(FAR memory_resource *resource) noexcept
+    : m_resource(resource != nullptr ? resource : heap_resource())
+  {
+  }
+
+  template <typename T, typename U>
+  inline bool operator==(const allocator<T> &a, const allocator<U> &b)
+    noexcept
+  {
+    return a.resource() == b.resource() ||
+           a.resource()->is_equal(*b.resource());
+  }
+
+  template <typename T, typename U>
+  inline bool operator!=(const allocator<T> &a, const allocator<U> &b)
+    noexcept
+  {
+    return !(a == b);
+  }
+}
+
+#endif // CONFIG_CXX_MEMORY_RESOURCE
+#endif // __INCLUDE_NUTTX_LIB_MEMORY_RESOURCE_HXX
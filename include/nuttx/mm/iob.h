@@ -76,6 +76,16 @@
 #  define CONFIG_IOB_ALIGNMENT      1
 #endif
 
+/* Per-CPU caches and owner accounting are disabled by default */
+
+#if !defined(CONFIG_IOB_PERCPU_CACHE)
+#  define CONFIG_IOB_PERCPU_CACHE   0
+#endif
+
+#if !defined(CONFIG_IOB_NOWNERS)
+#  define CONFIG_IOB_NOWNERS        0
+#endif
+
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
@@ -111,8 +121,17 @@ struct iob_s
 #else
   uint16_t io_len;      /* Length of the data in the entry */
   uint16_t io_offset;   /* Data begins at this offset */
+#endif
+#if CONFIG_IOB_NOWNERS > 0
+  uint8_t  io_owner;    /* Charged owner (1..CONFIG_IOB_NOWNERS), 0: none */
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
+#ifdef CONFIG_IOB_OFFLOAD
+  uint8_t  io_offload;  /* Offload requests of the packet */
+  uint8_t  io_csumoff;  /* Checksum field offset from io_csumstart */
+  uint16_t io_csumstart; /* Start of the checksummed data */
+  uint16_t io_gsosize;  /* Payload size of the offloaded segments */
+#endif
 
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
 };
@@ -152,6 +171,18 @@ struct iob_stats_s
   int nthrottle;
 };
 
+#if CONFIG_IOB_NOWNERS > 0
+/* The I/O buffer accounting of one owner */
+
+struct iob_ownerstats_s
+{
+  int nheld;    /* Number of I/O buffers currently charged to the owner */
+  int quota;    /* Maximum number of I/O buffers, 0: unlimited */
+  int nmax;     /* High water mark of nheld */
+  int ndenied;  /* Number of charges refused because of the quota */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -234,6 +265,64 @@ int iob_qentry_navail(void);
 
 FAR struct iob_s *iob_free(FAR struct iob_s *iob);
 
+#if CONFIG_IOB_NOWNERS > 0
+/****************************************************************************
+ * Name: iob_setquota
+ *
+ * Description:
+ *   Set the maximum number of I/O buffers that may be charged to an owner.
+ *   A quota of zero removes the limit.  Buffers that are already charged
+ *   are not affected.
+ *
+ * Input Parameters:
+ *   owner - The owner, 1..CONFIG_IOB_NOWNERS
+ *   quota - The new quota
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the owner is out of range.
+ *
+ ****************************************************************************/
+
+int iob_setquota(int owner, int quota);
+
+/****************************************************************************
+ * Name: iob_charge
+ *
+ * Description:
+ *   Charge every still uncharged I/O buffer of the chain starting at 'iob'
+ *   to an owner.  The charge is released automatically when the buffer is
+ *   freed.  Either all buffers are charged or none of them.
+ *
+ * Input Parameters:
+ *   iob   - The head of the I/O buffer chain
+ *   owner - The owner, 1..CONFIG_IOB_NOWNERS
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the owner is out of range or -ENOBUFS
+ *   if the charge would exceed the quota of the owner.
+ *
+ ****************************************************************************/
+
+int iob_charge(FAR struct iob_s *iob, int owner);
+
+/****************************************************************************
+ * Name: iob_getownerstats
+ *
+ * Description:
+ *   Return the I/O buffer accounting of one owner.
+ *
+ * Input Parameters:
+ *   owner - The owner, 1..CONFIG_IOB_NOWNERS
+ *   stats - The location to return the accounting
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the owner is out of range.
+ *
+ ****************************************************************************/
+
+int iob_getownerstats(int owner, FAR struct iob_ownerstats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_setup
  *
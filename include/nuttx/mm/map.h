@@ -67,6 +67,13 @@ struct mm_map_entry_s
                 FAR struct mm_map_entry_s *entry,
                 FAR void *start,
                 size_t length);
+
+  /* Mappings of files that are not backed by the file itself may implement
+   * the msync function to write their modifications back to the file.
+   */
+
+  int (*msync)(FAR struct mm_map_entry_s *entry, FAR void *start,
+               size_t length, int flags);
 };
 
 /* A structure for the task group */
@@ -46,6 +46,13 @@
 #  define MEMPOOL_REALBLOCKSIZE(pool) ((pool)->blocksize)
 #endif
 
+/* Per-CPU magazines in front of a single memory pool */
+
+#if defined(CONFIG_MM_MEMPOOL_MAGAZINE) && CONFIG_MM_MEMPOOL_MAGAZINE > 0 && \
+    CONFIG_MM_BACKTRACE < 0
+#  define MEMPOOL_HAVE_MAGAZINE
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -82,6 +89,18 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+/* A magazine caches free blocks of one pool for one CPU.  It is only
+ * accessed by its CPU with local interrupts disabled.
+ */
+
+struct mempool_magazine_s
+{
+  size_t    nblks;                            /* Number of cached blocks */
+  FAR void *blks[CONFIG_MM_MEMPOOL_MAGAZINE]; /* Cached blocks, hottest last */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -94,6 +113,9 @@ struct mempool_s
   size_t     interruptsize; /* The initialize size in interrupt mempool */
   size_t     expandsize;    /* The size of expand block every time for mempool */
   bool       wait;          /* The flag of need to wait when mempool is empty */
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  bool       percpu;        /* The flag of caching free blocks for every CPU */
+#endif
   FAR void  *priv;          /* This pointer is used to store the user's private data */
   mempool_alloc_t alloc;    /* The alloc function for mempool */
   mempool_free_t  free;     /* The free function for mempool */
@@ -110,6 +132,9 @@ struct mempool_s
   size_t     nalloc;    /* The number of used block in mempool */
 #endif
   spinlock_t lock;      /* The protect lock to mempool */
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  FAR struct mempool_magazine_s *magazines; /* One magazine for every CPU */
+#endif
   sem_t      waitsem;   /* The semaphore of waiter get free block */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
@@ -128,6 +153,29 @@ struct mempool_backtrace_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+/* Construct an object allocated from a cache */
+
+typedef CODE void (*mempool_ctor_t)(FAR void *obj);
+
+/* This structure describes a cache of objects of one type */
+
+struct mempool_cache_s
+{
+  struct mempool_s pool;        /* The pool of the objects */
+  FAR const char *name;         /* The name of the cache */
+  mempool_ctor_t ctor;          /* The constructor, NULL to zero objects */
+  size_t objsize;               /* The size of an object */
+  FAR struct mempool_cache_s *flink; /* The next cache */
+
+  /* Statistics, the objects in use and free are those of the pool */
+
+  size_t nfails;                /* Number of allocations failed */
+  size_t nreclaims;             /* Number of reclaims done for the cache */
+  size_t nreleased;             /* Bytes returned to the heap */
+};
+#endif
+
 struct mempoolinfo_s
 {
   unsigned long arena;    /* This is the total size of mempool */
@@ -202,6 +250,103 @@ FAR void *mempool_alloc(FAR struct mempool_s *pool);
 
 void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
 
+/****************************************************************************
+ * Name: mempool_allocbatch
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a memory pool, taking the pool lock
+ *   only once.  Unlike mempool_alloc(), this neither expands the pool, nor
+ *   waits, nor uses the interrupt blocks.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array receiving the allocated blocks.
+ *   nblks - The maximum number of blocks to allocate.
+ *
+ * Returned Value:
+ *   The number of blocks allocated.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE < 0
+size_t mempool_allocbatch(FAR struct mempool_s *pool, FAR void **blks,
+                          size_t nblks);
+#endif
+
+/****************************************************************************
+ * Name: mempool_freebatch
+ *
+ * Description:
+ *   Release nblks memory blocks to the pool, taking the pool lock only
+ *   once.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of blocks to release.
+ *   nblks - The number of blocks in blks.
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE < 0
+void mempool_freebatch(FAR struct mempool_s *pool, FAR void **blks,
+                       size_t nblks);
+#endif
+
+/****************************************************************************
+ * Name: mempool_alloc_bulk
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a memory pool.  The blocks are taken
+ *   from the magazine of the current CPU, then from the pool with a single
+ *   lock round trip, and the rest one by one with mempool_alloc().  Unlike
+ *   mempool_alloc(), this never waits for a block to be freed.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array receiving the allocated blocks.
+ *   nblks - The maximum number of blocks to allocate.
+ *
+ * Returned Value:
+ *   The number of blocks allocated.
+ *
+ ****************************************************************************/
+
+size_t mempool_alloc_bulk(FAR struct mempool_s *pool, FAR void **blks,
+                          size_t nblks);
+
+/****************************************************************************
+ * Name: mempool_free_bulk
+ *
+ * Description:
+ *   Release nblks memory blocks to the pool.  The blocks fill the magazine
+ *   of the current CPU, the rest goes to the pool with a single lock round
+ *   trip.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of blocks to release.
+ *   nblks - The number of blocks in blks.
+ ****************************************************************************/
+
+void mempool_free_bulk(FAR struct mempool_s *pool, FAR void **blks,
+                       size_t nblks);
+
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Return to the heap the blocks that the memory pool expanded with and
+ *   of which no block is in use.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mempool_shrink(FAR struct mempool_s *pool);
+
 /****************************************************************************
  * Name: mempool_info
  *
@@ -520,6 +665,85 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+
+/****************************************************************************
+ * Name: mempool_cache_init
+ *
+ * Description:
+ *   Initialize a cache of objects of 'objsize' bytes.  The objects are
+ *   aligned to CONFIG_MM_MEMPOOL_CACHE_ALIGN, so that two objects never
+ *   share a cache line.  The cache grows by 'nexpand' objects at a time
+ *   and gives the memory back on mempool_cache_reclaim().
+ *
+ * Input Parameters:
+ *   cache   - The cache to initialize.
+ *   name    - The name of the cache.
+ *   objsize - The size of an object.
+ *   nexpand - The number of objects to grow the cache by.
+ *   ctor    - Called on each object allocated; NULL to zero the objects.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int mempool_cache_init(FAR struct mempool_cache_s *cache,
+                       FAR const char *name, size_t objsize,
+                       size_t nexpand, mempool_ctor_t ctor);
+
+/****************************************************************************
+ * Name: mempool_cache_alloc
+ *
+ * Description:
+ *   Allocate a constructed object from a cache.  If the heap is exhausted,
+ *   the unused memory of all caches is reclaimed and the allocation tried
+ *   again.
+ *
+ * Returned Value:
+ *   The object on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_cache_alloc(FAR struct mempool_cache_s *cache);
+
+/****************************************************************************
+ * Name: mempool_cache_free
+ *
+ * Description:
+ *   Release an object to its cache.
+ *
+ ****************************************************************************/
+
+void mempool_cache_free(FAR struct mempool_cache_s *cache, FAR void *obj);
+
+/****************************************************************************
+ * Name: mempool_cache_reclaim
+ *
+ * Description:
+ *   Return the unused memory of all caches to the heap.
+ *
+ * Returned Value:
+ *   The number of bytes returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mempool_cache_reclaim(void);
+
+/****************************************************************************
+ * Name: mempool_cache_next
+ *
+ * Description:
+ *   Iterate over the caches: return the first cache if 'cache' is NULL,
+ *   else the cache following 'cache'.  Caches are never removed.
+ *
+ ****************************************************************************/
+
+FAR struct mempool_cache_s *
+mempool_cache_next(FAR struct mempool_cache_s *cache);
+
+#endif /* CONFIG_MM_MEMPOOL_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -101,12 +101,100 @@
 
 #define mm_memdump_s malltask
 
+/* Free chunks are counted in bins of power of two sizes, bin n holding the
+ * chunks of 2^n to 2^(n+1) - 1 bytes.
+ */
+
+#define MM_FRAG_NBINS (8 * sizeof(size_t))
+
+/* The attributes of a memory region, see mm_region_add(), and the flags of
+ * kmm_malloc_region(): the attributes required, and the placement policy.
+ */
+
+#define MM_REGION_FAST       (1 << 0)  /* Low latency, e.g. TCM */
+#define MM_REGION_DMA        (1 << 1)  /* Accessible by DMA */
+#define MM_REGION_ATTRMASK   (MM_REGION_FAST | MM_REGION_DMA)
+
+#define MM_REGION_NOFALLBACK (1 << 8)  /* Fail rather than use other memory */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct mm_heap_s; /* Forward reference */
 
+#ifdef CONFIG_MM_PROFILE
+/* The free chunks of a heap, see mm_fraginfo() */
+
+struct mm_fraginfo_s
+{
+  size_t nfree[MM_FRAG_NBINS];  /* Number of free chunks per size bin */
+  size_t fordblks;              /* Total size of the free chunks */
+  size_t mxordblk;              /* Size of the largest free chunk */
+};
+
+/* The allocations sampled from one call site, see mm_profile_getsite().
+ * The counts are estimates: each sample stands for the bytes allocated
+ * between two samples.
+ */
+
+struct mm_profsite_s
+{
+  FAR void *backtrace[CONFIG_MM_PROFILE_DEPTH]; /* The call site */
+  size_t nallocs;               /* Number of allocations */
+  size_t nbytes;                /* Bytes allocated */
+  size_t nlive;                 /* Bytes allocated and not freed yet */
+};
+
+struct mm_profinfo_s
+{
+  size_t rate;                  /* Mean bytes between samples, 0 if off */
+  size_t nsites;                /* Number of call sites recorded */
+  size_t nsamples;              /* Number of sampled chunks not freed */
+  size_t ndropped;              /* Samples lost: too many live samples */
+};
+#endif
+
+#ifdef CONFIG_MM_REGION
+/* The statistics of a memory region, see mm_region_info() */
+
+struct mm_regioninfo_s
+{
+  FAR const char *name;         /* The name of the region */
+  unsigned int attrs;           /* MM_REGION_* attributes */
+  struct mallinfo info;         /* The usage of the region */
+  size_t nallocs;               /* Allocations served */
+  size_t nfails;                /* Allocations that did not fit */
+  size_t nfallbacks;            /* Allocations of all regions served by the
+                                 * general heap */
+};
+#endif
+
+#ifdef CONFIG_MM_SHRINK
+/* A subsystem that can give memory back under memory pressure, see
+ * mm_register_shrinker().  shrink() frees about 'size' bytes if it can and
+ * returns the number of bytes actually freed.
+ */
+
+struct mm_shrinker_s
+{
+  FAR struct mm_shrinker_s *flink;
+  CODE size_t (*shrink)(FAR struct mm_shrinker_s *shrinker, size_t size);
+  FAR const char *name;         /* The name of the subsystem */
+  int priority;                 /* Lower priorities are asked first */
+};
+
+/* The memory pressure counters, read from /dev/mempressure */
+
+struct mm_pressure_s
+{
+  uint32_t nfails;              /* Allocation failures */
+  uint32_t nlow;                /* Free memory found below the watermark */
+  uint32_t nshrinks;            /* Rounds of the shrinkers */
+  size_t reclaimed;             /* Bytes freed by the shrinkers */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -318,6 +406,10 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap);
 struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
                                       FAR const struct malltask *task);
+#ifdef CONFIG_MM_PROFILE
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
+#endif
 
 /* Functions contained in kmm_mallinfo.c ************************************/
 
@@ -328,6 +420,51 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 #  endif
 #endif
 
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_PROFILE
+void mm_profile_alloc(FAR void *mem, size_t size);
+void mm_profile_free(FAR void *mem);
+void mm_profile_fragadd(FAR struct mm_fraginfo_s *info, size_t size);
+int  mm_profile_getsite(unsigned int index, FAR struct mm_profsite_s *site);
+void mm_profile_info(FAR struct mm_profinfo_s *info);
+void mm_profile_setrate(size_t rate);
+void mm_profile_reset(void);
+#else
+#  define mm_profile_alloc(mem, size)
+#  define mm_profile_free(mem)
+#endif
+
+/* Functions contained in mm_region.c ***************************************/
+
+#ifdef CONFIG_MM_REGION
+int mm_region_add(FAR const char *name, FAR void *start, size_t size,
+                  unsigned int attrs);
+FAR struct mm_heap_s *mm_region_heapof(FAR void *mem);
+int mm_region_info(int index, FAR struct mm_regioninfo_s *info);
+#endif
+
+/* Functions contained in mm_shrink.c ***************************************/
+
+#if defined(CONFIG_MM_SHRINK) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker);
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker);
+size_t mm_shrink(size_t size);
+void mm_pressure_info(FAR struct mm_pressure_s *info);
+#  if CONFIG_MM_SHRINK_WATERMARK > 0
+void mm_shrink_check(FAR struct mm_heap_s *heap);
+#  else
+#    define mm_shrink_check(heap)
+#  endif
+#  ifdef CONFIG_MM_PRESSURE_DEV
+int mm_pressure_register(void);
+#  endif
+#else
+#  define mm_shrink(size)       0
+#  define mm_shrink_check(heap)
+#endif
+
 /* Functions contained in mm_memdump.c **************************************/
 
 void mm_memdump(FAR struct mm_heap_s *heap,
@@ -0,0 +1,270 @@
+/****************************************************************************
+ * include/nuttx/mm/ringbuf.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_RINGBUF_H
+#define __INCLUDE_NUTTX_MM_RINGBUF_H
+
+/* A ring buffer that needs no locking, unlike circbuf which relies on its
+ * users for it:
+ *
+ * - One producer and one consumer may use it concurrently, from any CPU or
+ *   interrupt handler, with ringbuf_write()/ringbuf_read() or with the
+ *   reserve/commit pairs that give direct access to the buffer.
+ * - Several producers may use ringbuf_mp_write() concurrently with one
+ *   consumer.  The producers that finish copying their data wait for the
+ *   ones that reserved space before them, so they must not be able to
+ *   preempt each other on one CPU (e.g. a thread and an interrupt handler
+ *   of the same CPU must not both be producers).
+ *
+ * The indexes written by the producers and by the consumer live on
+ * different cache lines.  The consumer is sure to see the data a commit
+ * publishes, but with DMA the owner of the memory still has to clean or
+ * invalidate the data cache over the region it was given, as usual.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct ringbuf_s
+{
+  FAR uint8_t *base;     /* The pointer to buffer space */
+  size_t       size;     /* The size of buffer space, a power of two */
+  bool         external; /* The flag for external buffer */
+
+  /* Written by the producers.  The indexes never wrap:  they are masked
+   * with the size when the buffer is accessed.
+   */
+
+  size_t       reserve   /* End of the space reserved by the producers */
+               aligned_data(CONFIG_MM_RINGBUF_ALIGN);
+  size_t       head;     /* End of the committed data */
+
+  /* Written by the consumer */
+
+  size_t       tail      /* Start of the data not yet consumed */
+               aligned_data(CONFIG_MM_RINGBUF_ALIGN);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize a ring buffer.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   base  - A pointer to the ring buffer's internal buffer, e.g. a DMA
+ *           buffer.  If NULL, a buffer of the given size will be
+ *           allocated.
+ *   bytes - The size of the internal buffer, a power of two.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int ringbuf_init(FAR struct ringbuf_s *ring, FAR void *base, size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_uninit
+ *
+ * Description:
+ *   Free the ring buffer.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+void ringbuf_uninit(FAR struct ringbuf_s *ring);
+
+/****************************************************************************
+ * Name: ringbuf_used
+ *
+ * Description:
+ *   Return the committed bytes not yet consumed.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+size_t ringbuf_used(FAR struct ringbuf_s *ring);
+
+/****************************************************************************
+ * Name: ringbuf_space
+ *
+ * Description:
+ *   Return the bytes that can be written.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+size_t ringbuf_space(FAR struct ringbuf_s *ring);
+
+/****************************************************************************
+ * Name: ringbuf_write_reserve
+ *
+ * Description:
+ *   Give the single producer the contiguous free space at the head of the
+ *   buffer.  Nothing is visible to the consumer until
+ *   ringbuf_write_commit() is called.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   ptr   - The location to return the start of the space.
+ *   bytes - The most bytes wanted.
+ *
+ * Returned Value:
+ *   The bytes at ptr, at most 'bytes'; zero if the buffer is full.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_write_reserve(FAR struct ringbuf_s *ring, FAR void **ptr,
+                             size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_write_commit
+ *
+ * Description:
+ *   Publish the first 'bytes' of the space last reserved.
+ *
+ ****************************************************************************/
+
+void ringbuf_write_commit(FAR struct ringbuf_s *ring, size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_read_reserve
+ *
+ * Description:
+ *   Give the consumer the contiguous committed data at the tail of the
+ *   buffer.  It stays in the buffer until ringbuf_read_commit() is called.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   ptr   - The location to return the start of the data.
+ *   bytes - The most bytes wanted.
+ *
+ * Returned Value:
+ *   The bytes at ptr, at most 'bytes'; zero if the buffer is empty.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_read_reserve(FAR struct ringbuf_s *ring, FAR void **ptr,
+                            size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_read_commit
+ *
+ * Description:
+ *   Release the first 'bytes' of the data last reserved to the producers.
+ *
+ ****************************************************************************/
+
+void ringbuf_read_commit(FAR struct ringbuf_s *ring, size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_write
+ *
+ * Description:
+ *   Write as much data as fits, as the single producer.  The data is
+ *   published by one commit.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   src   - Address where to get the data.
+ *   bytes - Number of bytes to write.
+ *
+ * Returned Value:
+ *   The bytes written.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_write(FAR struct ringbuf_s *ring, FAR const void *src,
+                     size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_read
+ *
+ * Description:
+ *   Read and consume as much data as there is, up to 'bytes'.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   dst   - Address where to store the data.
+ *   bytes - Number of bytes to read.
+ *
+ * Returned Value:
+ *   The bytes read.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_read(FAR struct ringbuf_s *ring, FAR void *dst,
+                    size_t bytes);
+
+/****************************************************************************
+ * Name: ringbuf_mp_write
+ *
+ * Description:
+ *   Write all of the data or nothing, as one of several producers.  The
+ *   producers using this function must not use the single producer ones.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   src   - Address where to get the data.
+ *   bytes - Number of bytes to write.
+ *
+ * Returned Value:
+ *   'bytes' on success; -EAGAIN if there is not space for all of it.
+ *
+ ****************************************************************************/
+
+ssize_t ringbuf_mp_write(FAR struct ringbuf_s *ring, FAR const void *src,
+                         size_t bytes);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_RINGBUF_H */
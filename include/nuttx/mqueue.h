@@ -111,11 +111,15 @@ struct mqueue_inode_s
   struct list_node msglist;   /* Prioritized message list */
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
-#if CONFIG_MQ_MAXMSGSIZE < 256
+#if CONFIG_MQ_MAXMSGSIZE < 256 && !defined(CONFIG_MQ_MSGPOOL)
   uint8_t maxmsgsize;         /* Max size of message in message queue */
 #else
   uint16_t maxmsgsize;        /* Max size of message in message queue */
 #endif
+#ifdef CONFIG_MQ_MSGPOOL
+  FAR void *pool;             /* Messages of maxmsgsize, if it is large */
+  struct list_node msgpool;   /* Free messages of the pool */
+#endif
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
@@ -703,6 +707,92 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Name: file_mq_loan and nxmq_loan
+ *
+ * Description:
+ *   Lend the caller a message of the queue to be written in place.  It is
+ *   mq_msgsize bytes long.  The message is given back by sending it with
+ *   file_mq_send_loaned() or by releasing it with nxmq_release().
+ *
+ * Input Parameters:
+ *   mq/mqdes - Message queue descriptor
+ *   msg      - The location to return the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:
+ *
+ *   EPERM    Message queue opened not opened for writing.
+ *   ENOMEM   There is no message to lend.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **msg);
+int nxmq_loan(mqd_t mqdes, FAR void **msg);
+
+/****************************************************************************
+ * Name: file_mq_send_loaned and nxmq_send_loaned
+ *
+ * Description:
+ *   Queue a message lent by file_mq_loan() on the same queue, waiting like
+ *   file_mq_send() if the queue is full.  The message belongs to the queue
+ *   again on success; on failure it is still lent to the caller.
+ *
+ * Input Parameters:
+ *   mq/mqdes - Message queue descriptor
+ *   msg      - The lent message
+ *   msglen   - The length of the message in bytes
+ *   prio     - The priority of the message
+ *
+ * Returned Value:
+ *   As file_mq_send().
+ *
+ ****************************************************************************/
+
+int file_mq_send_loaned(FAR struct file *mq, FAR void *msg, size_t msglen,
+                        unsigned int prio);
+int nxmq_send_loaned(mqd_t mqdes, FAR void *msg, size_t msglen,
+                     unsigned int prio);
+
+/****************************************************************************
+ * Name: file_mq_receive_loaned and nxmq_receive_loaned
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages as file_mq_receive()
+ *   does, but lend it to the caller instead of copying it out.  The caller
+ *   gives it back with nxmq_release(), before the queue is closed.
+ *
+ * Input Parameters:
+ *   mq/mqdes - Message queue descriptor
+ *   msg      - The location to return the message
+ *   prio     - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success; a negated errno value as
+ *   file_mq_receive() on failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_receive_loaned(FAR struct file *mq, FAR void **msg,
+                               FAR unsigned int *prio);
+ssize_t nxmq_receive_loaned(mqd_t mqdes, FAR void **msg,
+                            FAR unsigned int *prio);
+
+/****************************************************************************
+ * Name: nxmq_release
+ *
+ * Description:
+ *   Give back a message lent by file_mq_loan() or file_mq_receive_loaned().
+ *
+ ****************************************************************************/
+
+void nxmq_release(FAR void *msg);
+
+#endif /* CONFIG_MQ_LOAN */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
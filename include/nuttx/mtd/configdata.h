@@ -56,6 +56,14 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the structure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_SETCONFIGS - Set or delete several Config Data Items at once
+ *
+ *   ioctl argument:  Pointer to a config_batch_s structure.  Items with a
+ *                    len of zero are deleted.  The fail-safe device appends
+ *                    the items that fit in one erase block together, with
+ *                    at most one garbage collection before them.  Only
+ *                    supported with CONFIG_MTD_CONFIG_FAIL_SAFE.
  */
 
 #define CFGDIOC_GETCONFIG    _CFGDIOC(1)
@@ -64,6 +72,7 @@
 #define CFGDIOC_FINDCONFIG   _CFGDIOC(4)
 #define CFGDIOC_FIRSTCONFIG  _CFGDIOC(5)
 #define CFGDIOC_NEXTCONFIG   _CFGDIOC(6)
+#define CFGDIOC_SETCONFIGS   _CFGDIOC(7)
 
 /****************************************************************************
  * Public Types
@@ -83,6 +92,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to set several config data items at once */
+
+struct config_batch_s
+{
+  FAR struct config_data_s *data; /* The items, written in order */
+  size_t      count;              /* Number of items */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -88,6 +88,11 @@
 #define MTD_ISBAD(d,b)     ((d)->isbad   ? (d)->isbad(d,b)      : (-ENOSYS))
 #define MTD_MARKBAD(d,b)   ((d)->markbad ? (d)->markbad(d,b)    : (-ENOSYS))
 
+/* FTL modes, see ftl_initialize_by_path_mode() */
+
+#define FTL_MODE_ERASE     0 /* Read-modify-erase-write of erase blocks */
+#define FTL_MODE_LOG       1 /* Log structured, page mapped */
+
 /* If any of the low-level device drivers declare they want sub-sector erase
  * support, then define MTD_SUBSECTOR_ERASE.
  */
@@ -287,6 +292,22 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 #endif
 
+/****************************************************************************
+ * Name: mtd_bgerase_initialize
+ *
+ * Description:
+ *   Create an initialized MTD device instance.  This MTD driver contains
+ *   another MTD driver and performs its erases in the background from the
+ *   low priority work queue, so that erase returns immediately.  The
+ *   blocks not erased yet read as erased, and they are erased before any
+ *   write to them.  BIOC_FLUSH waits for all the erases.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_BGERASE
+FAR struct mtd_dev_s *mtd_bgerase_initialize(FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
  * Name: ftl_initialize_by_path
  *
@@ -301,6 +322,25 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 
 int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd);
 
+/****************************************************************************
+ * Name: ftl_initialize_by_path_mode
+ *
+ * Description:
+ *   Same as ftl_initialize_by_path(), selecting how writes are mapped to
+ *   the FLASH:  FTL_MODE_ERASE rewrites the erase blocks in place, while
+ *   FTL_MODE_LOG (CONFIG_FTL_LOG) appends the sectors to a log with wear
+ *   leveling.
+ *
+ * Input Parameters:
+ *   path - The block device path.
+ *   mtd  - The MTD device that supports the FLASH interface.
+ *   mode - FTL_MODE_ERASE or FTL_MODE_LOG.
+ *
+ ****************************************************************************/
+
+int ftl_initialize_by_path_mode(FAR const char *path,
+                                FAR struct mtd_dev_s *mtd, int mode);
+
 /****************************************************************************
  * Name: ftl_initialize
  *
@@ -316,6 +356,17 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd);
 
 int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
 
+/****************************************************************************
+ * Name: ftl_initialize_mode
+ *
+ * Description:
+ *   Same as ftl_initialize(), selecting the FTL_MODE_* of the device like
+ *   ftl_initialize_by_path_mode().
+ *
+ ****************************************************************************/
+
+int ftl_initialize_mode(int minor, FAR struct mtd_dev_s *mtd, int mode);
+
 /****************************************************************************
  * Name: smart_initialize
  *
@@ -55,6 +55,8 @@
 
 #define COMMAND_READ_1                  0x00
 #define COMMAND_READ_2                  0x30
+#define COMMAND_READ_CACHE_SEQ          0x31
+#define COMMAND_READ_CACHE_END          0x3f
 #define COMMAND_COPYBACK_READ_1         0x00
 #define COMMAND_COPYBACK_READ_2         0x35
 #define COMMAND_COPYBACK_PROGRAM_1      0x85
@@ -65,6 +67,7 @@
 #define COMMAND_READID                  0x90
 #define COMMAND_WRITE_1                 0x80
 #define COMMAND_WRITE_2                 0x10
+#define COMMAND_WRITE_CACHE             0x15
 #define COMMAND_ERASE_1                 0x60
 #define COMMAND_ERASE_2                 0xd0
 #define COMMAND_STATUS                  0x70
@@ -225,6 +228,51 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages of one block, the pages after
+ *   the first being fetched in the cache while the previous one is
+ *   transferred.  ECC checking is performed by the lower half.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read, all within the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; -EUCLEAN if bit errors were corrected; a
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages of one block, the pages
+ *   before the last being programmed from the cache while the next one is
+ *   transferred.  ECC is calculated by the lower half.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write, all within the block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -261,6 +309,17 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  /* Optional, NULL if the lower half doesn't support them */
+
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers */
 
@@ -69,6 +69,7 @@ struct mtd_smart_procfs_data_s
   uint8_t             formatversion;    /* Version of the volume format */
   uint32_t            unusedsectors;    /* Number of unused sectors (free when erased) */
   uint32_t            blockerases;      /* Number block erase operations */
+  uint32_t            scantime;         /* Sector map build time, ms */
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR const uint8_t  *erasecounts;      /* Array of erase counts per erase block */
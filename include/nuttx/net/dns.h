@@ -177,6 +177,23 @@ begin_packed_struct struct dns_answer_s
   } u;
 } end_packed_struct;
 
+/* The maximum number of descriptors used by a name resolution in
+ * progress, see dns_resolve_pollfds().
+ */
+
+#ifdef CONFIG_NETDB_DNSCLIENT
+#  if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#    define DNS_RESOLVE_MAXFDS (2 * CONFIG_NETDB_DNSCLIENT_PARALLEL)
+#  else
+#    define DNS_RESOLVE_MAXFDS CONFIG_NETDB_DNSCLIENT_PARALLEL
+#  endif
+#endif
+
+/* A name resolution in progress, see dns_resolve_start() */
+
+struct dns_resolve_s;
+struct pollfd;
+
 /* The type of the callback from dns_foreach_nameserver() */
 
 typedef CODE int (*dns_callback_t)(FAR void *arg,
@@ -247,6 +264,92 @@ int dns_register_notify(dns_callback_t callback, FAR void *arg);
 
 int dns_unregister_notify(dns_callback_t callback, FAR void *arg);
 
+/****************************************************************************
+ * Name: dns_resolve_start
+ *
+ * Description:
+ *   Start to resolve 'hostname' without blocking, so that an event loop
+ *   can wait for the answer together with its other descriptors:
+ *
+ *   - dns_resolve_pollfds() returns the descriptors to poll() and the
+ *     timeout,
+ *   - dns_resolve_process() is called whenever poll() returns, also on a
+ *     timeout, until it returns something else than -EAGAIN,
+ *   - dns_resolve_finish() returns the addresses and frees the handle.  It
+ *     may be called at any time to cancel the resolution.
+ *
+ *   The A and AAAA queries are sent to several name servers at once, and
+ *   answers found in the DNS cache complete without any query.
+ *
+ * Input Parameters:
+ *   hostname - The hostname string to be resolved.
+ *   handle   - The location to return the handle of the resolution.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dns_resolve_start(FAR const char *hostname,
+                      FAR struct dns_resolve_s **handle);
+
+/****************************************************************************
+ * Name: dns_resolve_pollfds
+ *
+ * Description:
+ *   Return the descriptors to wait on for POLLIN, at most
+ *   DNS_RESOLVE_MAXFDS, and the time in milliseconds to wait at most.
+ *
+ * Returned Value:
+ *   The number of descriptors placed in 'fds', or -EINVAL if 'nfds' is too
+ *   small.
+ *
+ ****************************************************************************/
+
+int dns_resolve_pollfds(FAR struct dns_resolve_s *handle,
+                        FAR struct pollfd *fds, int nfds,
+                        FAR int *timeout);
+
+/****************************************************************************
+ * Name: dns_resolve_process
+ *
+ * Description:
+ *   Receive the answers to the queries, and start new queries if those
+ *   failed or timed out.
+ *
+ * Returned Value:
+ *   -EAGAIN while the resolution is in progress.  Otherwise zero (OK) if
+ *   the hostname was resolved, or a negated errno value: -ENOENT or
+ *   -EADDRNOTAVAIL if the hostname does not exist or has no address,
+ *   -ENODATA if the cache knows that already.
+ *
+ ****************************************************************************/
+
+int dns_resolve_process(FAR struct dns_resolve_s *handle);
+
+/****************************************************************************
+ * Name: dns_resolve_finish
+ *
+ * Description:
+ *   Return the result of the resolution and free the handle.  IPv6
+ *   addresses are returned before the IPv4 addresses.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by dns_resolve_start().
+ *   addr   - The location to return the addresses, or NULL.
+ *   naddr  - On entry, the count of addresses backing up the 'addr'
+ *     pointer.  On return, this location will hold the actual count of
+ *     the returned addresses.
+ *
+ * Returned Value:
+ *   As dns_resolve_process(), or -ECANCELED if the resolution was still in
+ *   progress.
+ *
+ ****************************************************************************/
+
+int dns_resolve_finish(FAR struct dns_resolve_s *handle,
+                       FAR struct sockaddr_storage *addr, FAR int *naddr);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
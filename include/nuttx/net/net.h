@@ -139,6 +139,7 @@ struct file;    /* Forward reference */
 struct stat;    /* Forward reference */
 struct socket;  /* Forward reference */
 struct pollfd;  /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -179,6 +180,10 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+#ifdef CONFIG_NET_RXRING
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -925,6 +930,26 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg and psock_recvmmsg
+ *
+ * Description:
+ *   Send or receive up to 'vlen' messages with one call, as sendmmsg() and
+ *   recvmmsg() but without being a cancellation point or modifying errno.
+ *   The network lock is taken only once for the batch on inet sockets.
+ *
+ * Returned Value:
+ *   The number of messages sent or received.  If none was, a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1426,6 +1451,49 @@ ssize_t psock_sendfile(FAR struct socket *psock, FAR struct file *infile,
                        FAR off_t *offset, size_t count);
 #endif
 
+/****************************************************************************
+ * Name: psock_recv_iob
+ *
+ * Description:
+ *   Receive data from a TCP socket without copying it.  The I/O buffers
+ *   holding up to 'len' bytes of received data are detached from the
+ *   connection and lent to the caller, who must give them back with
+ *   psock_release_iob() before closing the socket.
+ *
+ * Input Parameters:
+ *   psock - A TCP socket
+ *   iob   - Location to return the I/O buffer chain.  The data starts at
+ *           IOB_DATA() of the head and io_pktlen is its total length.
+ *   len   - Maximum number of bytes to return
+ *   flags - Zero or MSG_DONTWAIT
+ *
+ * Returned Value:
+ *   The number of bytes returned in 'iob', zero if the peer has closed the
+ *   connection, or a negated errno value as from recv().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RECV_ZEROCOPY
+struct iob_s; /* Forward reference */
+
+ssize_t psock_recv_iob(FAR struct socket *psock, FAR struct iob_s **iob,
+                       size_t len, int flags);
+
+/****************************************************************************
+ * Name: psock_release_iob
+ *
+ * Description:
+ *   Give back the I/O buffer chain lent by psock_recv_iob().
+ *
+ * Input Parameters:
+ *   psock - The TCP socket the buffers were received on
+ *   iob   - The I/O buffer chain returned by psock_recv_iob()
+ *
+ ****************************************************************************/
+
+void psock_release_iob(FAR struct socket *psock, FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: psock_socketpair
  *
@@ -52,6 +52,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <time.h>
 
 #include <nuttx/queue.h>
 
@@ -168,6 +169,36 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+/* Transmit offloads a device may advertise in d_features.  TSO requires
+ * the checksum offload of the same IP version and scatter-gather.
+ */
+
+#  define NETDEV_FEATURE_TXCSUM_IPv4 (1 << 0) /* TCP/UDP checksum over IPv4 */
+#  define NETDEV_FEATURE_TXCSUM_IPv6 (1 << 1) /* TCP/UDP checksum over IPv6 */
+#  define NETDEV_FEATURE_SG          (1 << 2) /* Gather DMA of IOB chains */
+#  define NETDEV_FEATURE_TSO         (1 << 3) /* TCP segmentation offload */
+
+/* Offload requests attached to an outgoing packet (io_offload).
+ *
+ * NETDEV_OFFLOAD_CSUM - The device completes the Internet checksum of the
+ *   data from io_csumstart to the end of the packet and stores it at
+ *   io_csumstart + io_csumoff.  The checksum field is seeded with the sum
+ *   of the pseudo header.
+ * NETDEV_OFFLOAD_TSO - The device splits the TCP payload into segments of
+ *   io_gsosize bytes, replicating and adjusting the IP and TCP headers.
+ *   The pseudo header sum then leaves out the length.
+ * NETDEV_OFFLOAD_CSUM_VALID - Set on a received packet whose upper layer
+ *   checksum has already been verified.
+ *
+ * Offsets are relative to the start of the IP header.
+ */
+
+#  define NETDEV_OFFLOAD_CSUM        (1 << 0)
+#  define NETDEV_OFFLOAD_TSO         (1 << 1)
+#  define NETDEV_OFFLOAD_CSUM_VALID  (1 << 2)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -271,6 +302,13 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Supported transmit offloads, see NETDEV_FEATURE_* */
+
+  uint32_t d_features;
+  uint16_t d_tsomax;            /* Maximum IP packet size with TSO */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -301,6 +339,17 @@ struct net_driver_s
   in_addr_t      d_netmask;     /* Network subnet mask */
 #endif
 
+#ifdef CONFIG_NET_ARP
+  /* The last ARP table hit on this device.  It is only valid while
+   * d_arpgen matches the generation of the ARP table.
+   */
+
+  uint32_t       d_arpgen;      /* ARP table generation of the hit */
+  in_addr_t      d_arpipaddr;   /* IPv4 address that was looked up */
+  clock_t        d_arptime;     /* Update time of the ARP table entry */
+  struct ether_addr d_arpethaddr; /* Its Ethernet MAC address */
+#endif
+
 #ifdef CONFIG_NET_IPv6
   net_ipv6addr_t d_ipv6addr;    /* Host IPv6 address assigned to the network interface */
   net_ipv6addr_t d_ipv6draddr;  /* Default router IPv6 address */
@@ -321,6 +370,33 @@ struct net_driver_s
 
   FAR struct iob_s *d_iob;
 
+#ifdef CONFIG_NETDEV_GRO
+  /* The received TCP segments coalesced so far by GRO */
+
+  FAR struct iob_s *d_gro;
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* The receive time of the packet in d_iob.  A driver that timestamps
+   * received packets in hardware sets it for every packet it passes to
+   * the network; otherwise it stays zero and the network takes the time
+   * itself.
+   */
+
+  struct timespec d_rxtime;
+#endif
+
+#if CONFIG_NET_CAN_HWFILTER_MAX > 0
+  /* The CAN_RAW filters of the sockets currently pushed down to the
+   * hardware of a CAN device with SIOCACANSTDFILTER / SIOCACANEXTFILTER.
+   * Bit n of d_canhwext is set if filter n is an extended ID filter.
+   */
+
+  uint8_t d_canhwnfilters;
+  uint32_t d_canhwext;
+  struct can_ioctl_filter_s d_canhwfilters[CONFIG_NET_CAN_HWFILTER_MAX];
+#endif
+
   /* Remember the outgoing fragments waiting to be sent */
 
 #ifdef CONFIG_NET_IPFRAG
@@ -938,6 +1014,126 @@ int netdev_lladdrsize(FAR struct net_driver_s *dev);
 int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
                        unsigned int timeout);
 
+/****************************************************************************
+ * Name: netdev_iob_charge
+ *
+ * Description:
+ *   Charge the received packet in dev->d_iob to the RX I/O buffer quota of
+ *   the device.  The charge is released when the buffers are freed, even
+ *   if they are queued elsewhere in the meantime.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOBUFS if the device exceeded its quota.  The
+ *   caller should then drop the packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_QUOTA
+int netdev_iob_charge(FAR struct net_driver_s *dev);
+#else
+#  define netdev_iob_charge(dev) 0
+#endif
+
+/****************************************************************************
+ * Name: netdev_offload_chksum
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   device if it supports the checksum offload for the IP version of the
+ *   packet.  The checksum field is then seeded with the pseudo header sum
+ *   and the packet is tagged with NETDEV_OFFLOAD_CSUM.  A TCP packet whose
+ *   payload is larger than 'gsosize' is additionally tagged for TSO.
+ *
+ * Input Parameters:
+ *   dev     - The network device holding the packet in d_iob
+ *   proto   - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen   - The size of the IP header, including IPv6 extension headers
+ *   csumoff - The offset of the checksum field in the upper layer header
+ *   gsosize - The segment payload size for TSO, zero if not segmentable
+ *
+ * Returned Value:
+ *   True if the device computes the checksum; false if the caller has to
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network and the IP header is complete.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+bool netdev_offload_chksum(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen, unsigned int csumoff,
+                           uint16_t gsosize);
+#else
+#  define netdev_offload_chksum(dev, proto, iplen, csumoff, gsosize) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_offload_tsosize
+ *
+ * Description:
+ *   Return the largest TCP payload that can be handed to the device in one
+ *   packet.  This is a multiple of 'mss' if the device supports TSO for
+ *   the IP version, else 'mss' itself.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   ipv6    - True for IPv6 packets
+ *   hdrlen  - The size of the IP and TCP headers
+ *   mss     - The maximum segment size of the connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+uint32_t netdev_offload_tsosize(FAR struct net_driver_s *dev, bool ipv6,
+                                unsigned int hdrlen, uint16_t mss);
+#else
+#  define netdev_offload_tsosize(dev, ipv6, hdrlen, mss) (mss)
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Try to coalesce the received IPv4 packet in d_iob with the TCP
+ *   segments held for the device (generic receive offload).
+ *
+ * Returned Value:
+ *   True if the packet was taken over; d_iob is then NULL.  False if the
+ *   packet was left in d_iob: the caller has to flush the held segments
+ *   with netdev_gro_flush() before it inputs the packet.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Move the TCP segments held for the device into d_iob as one IPv4
+ *   packet, to be input by the caller.
+ *
+ * Returned Value:
+ *   True if a packet was moved into d_iob; false if nothing was held.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_flush(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: netdev_iob_replace
  *
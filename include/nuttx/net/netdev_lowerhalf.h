@@ -67,6 +67,10 @@
 #define HAVE_ATOMIC
 #endif
 
+#ifndef CONFIG_NETDEV_MAX_QUEUES
+#  define CONFIG_NETDEV_MAX_QUEUES 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -85,6 +89,22 @@ enum netpkt_type_e
   NETPKT_TYPENUM
 };
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+/* The offload requests of a TX netpkt, see netpkt_get_offload().  Offsets
+ * are from the start of the netpkt data, i.e. including the link layer
+ * header.
+ */
+
+struct netpkt_offload_s
+{
+  uint8_t  flags;               /* NETDEV_OFFLOAD_* */
+  uint16_t csumstart;           /* Start of the checksummed data */
+  uint16_t csumoff;             /* Checksum field offset from csumstart */
+  uint16_t hdrlen;              /* Length of the headers of each segment */
+  uint16_t gsosize;             /* TCP payload size of each segment */
+};
+#endif
+
 /* This structure is the generic form of state structure used by lower half
  * netdev driver. This state structure is passed to the netdev driver when
  * the driver is initialized. Then, on subsequent callbacks into the lower
@@ -110,11 +130,22 @@ struct netdev_lowerhalf_s
   int quota[NETPKT_TYPENUM];
 #endif
 
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  /* Number of RX/TX queue pairs, 0 or 1 for a single queue device.  Set
+   * before netdev_lower_register().
+   */
+
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
    * Fields that lowerhalf should never touch (used by upper half):
    *   d_ifup, d_ifdown, d_txavail, d_addmac, d_rmmac, d_ioctl, d_private
+   *
+   * With CONFIG_NETDEV_OFFLOAD, lowerhalf advertises its offloads in
+   *   d_features (and d_tsomax for TSO) before netdev_lower_register().
    */
 
   struct net_driver_s netdev;
@@ -156,6 +187,29 @@ struct netdev_ops_s
   int (*ioctl)(FAR struct netdev_lowerhalf_s *dev, int cmd,
                unsigned long arg);
 #endif
+
+  /* rxintr - Optional, enable or disable the RX interrupt of a queue.
+   *          The interrupt is disabled when the queue is scheduled for
+   *          polling by netdev_lower_rxready[_queue]() (which may be
+   *          called from the interrupt handler) and enabled again once a
+   *          poll found the queue empty.  When enabling, the driver must
+   *          call netdev_lower_rxready[_queue]() if a packet arrived in
+   *          the meantime.
+   */
+
+  void (*rxintr)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                 bool enable);
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  /* transmit_queue/receive_queue - Same as transmit/receive, but on the
+   *   given queue.  Used instead of them if nqueues > 1.
+   */
+
+  int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                        FAR netpkt_t *pkt);
+  FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue);
+#endif
 };
 
 /****************************************************************************
@@ -258,6 +312,24 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/txdone_queue
+ *
+ * Description:
+ *   Same as netdev_lower_rxready/txdone, for one queue of a multi-queue
+ *   device.  The functions above act on queue 0.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -437,4 +509,43 @@ void netpkt_reset_reserved(FAR struct netdev_lowerhalf_s *dev,
 
 bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 
+/****************************************************************************
+ * Name: netpkt_flowhash
+ *
+ * Description:
+ *   Return a hash of the flow of a packet: the IP addresses, the protocol
+ *   and, for TCP and UDP, the ports.  The upper half selects the TX queue
+ *   with it; lower halves without hardware flow steering may use it to
+ *   distribute received packets over their queues.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+uint32_t netpkt_flowhash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+
+/****************************************************************************
+ * Name: netpkt_get_offload
+ *
+ * Description:
+ *   Get the offload requests of a TX netpkt.  Only offloads advertised in
+ *   d_features are ever requested.  Without NETDEV_OFFLOAD_CSUM the packet
+ *   is complete and can be sent as is.
+ *
+ * Input Parameters:
+ *   dev     - The lower half device driver structure
+ *   pkt     - The net packet
+ *   offload - Location to return the offload requests
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+void netpkt_get_offload(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt,
+                        FAR struct netpkt_offload_s *offload);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H */
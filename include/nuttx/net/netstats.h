@@ -80,6 +80,17 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Contention statistics of the network lock.  These are only updated
+ * while the lock is held.
+ */
+
+struct net_lock_stats_s
+{
+  uint32_t acquired;            /* Number of times the lock was taken */
+  uint32_t contended;           /* Number of times the caller had to wait */
+  uint32_t waitticks;           /* Total time spent waiting (clock ticks) */
+};
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -117,6 +128,8 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+  struct net_lock_stats_s lock; /* Network lock statistics */
 };
 
 /****************************************************************************
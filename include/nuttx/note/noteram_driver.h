@@ -50,6 +50,11 @@
  *                          noteram_get_taskname_s
  *                Result:   If -ESRCH, the corresponding task name doesn't
  *                          exist.
+ * NOTERAM_GETOVERRUN
+ *              - Get the number of unread notes lost by a CPU, because the
+ *                buffer was full
+ *                Argument: A writable pointer to struct
+ *                          noteram_get_overrun_s
  */
 
 #ifdef CONFIG_DRIVERS_NOTERAM
@@ -60,6 +65,7 @@
     CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE > 0
 #define NOTERAM_GETTASKNAME     _NOTERAMIOC(0x04)
 #endif
+#define NOTERAM_GETOVERRUN      _NOTERAMIOC(0x05)
 #endif
 
 /* Overwrite mode definitions */
@@ -84,6 +90,16 @@ struct noteram_get_taskname_s
 };
 #endif
 
+/* This is the type of the argument passed to the NOTERAM_GETOVERRUN ioctl */
+
+#ifdef CONFIG_DRIVERS_NOTERAM
+struct noteram_get_overrun_s
+{
+  int cpu;                     /* The CPU, set by the caller */
+  unsigned long overrun;       /* The number of notes lost */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * include/nuttx/note/notestream_driver.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTESTREAM_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTESTREAM_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The stream format.  All multi-byte values are little endian, a varint is
+ * the LEB128 encoding of an unsigned value, and a svarint is the varint of
+ * a zigzag encoded signed value.
+ *
+ * The stream starts with a header:
+ *
+ *   uint8_t  magic[4];   "NXTS"
+ *   uint8_t  version;    NOTESTREAM_VERSION
+ *   uint8_t  ptrsize;    sizeof(uintptr_t), for the payloads
+ *   uint8_t  pidsize;    sizeof(pid_t), for the payloads
+ *   uint8_t  reserved;
+ *   uint32_t freq;       The frequency of the time stamps, zero if they
+ *                        are in nanoseconds
+ *
+ * followed by records, each starting with its type.  The types below
+ * NOTESTREAM_LOST are the types of the notes (enum note_type_e):
+ *
+ *   uint8_t  type;
+ *   svarint  delta;      Time since the previous note
+ *   uint8_t  cpu;
+ *   varint   pid;
+ *   uint8_t  priority;
+ *   varint   length;
+ *   uint8_t  payload[length];  The note after its common part; the name
+ *                              is removed from NOTE_START
+ *
+ * The task names are sent once in a table, before the first note of the
+ * task:
+ *
+ *   uint8_t  type;       NOTESTREAM_TASKNAME
+ *   varint   pid;
+ *   uint8_t  length;
+ *   char     name[length];
+ *
+ * Notes that were lost because the stream buffer was full are reported by
+ * a NOTESTREAM_LOST record before the next note:
+ *
+ *   uint8_t  type;       NOTESTREAM_LOST
+ *   varint   count;
+ */
+
+#define NOTESTREAM_MAGIC       "NXTS"
+#define NOTESTREAM_VERSION     1
+#define NOTESTREAM_HEADER_SIZE 12
+
+#define NOTESTREAM_LOST        0xfe
+#define NOTESTREAM_TASKNAME    0xff
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTESTREAM
+extern struct note_driver_s g_notestream_driver;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
+
+/****************************************************************************
+ * Name: notestream_register
+ *
+ * Description:
+ *   Start the thread streaming the notes to the configured transport.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTESTREAM
+int notestream_register(void);
+#endif
+
+#endif /* defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT) */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_NOTE_NOTESTREAM_DRIVER_H */
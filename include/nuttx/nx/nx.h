@@ -81,6 +81,16 @@ typedef FAR void *NXHANDLE;
 
 typedef FAR void *NXWINDOW;
 
+/* Batched drawing ***********************************************************/
+
+/* One of the fills of a batch passed to nx_fills() */
+
+struct nx_fill_s
+{
+  struct nxgl_rect_s rect;                 /* The location to be filled */
+  nxgl_mxpixel_t color[CONFIG_NX_NPLANES]; /* The color to use in the fill */
+};
+
 /* NX server callbacks ******************************************************/
 
 /* Event callbacks */
@@ -789,6 +799,28 @@ int nx_setpixel(NXWINDOW hwnd, FAR const struct nxgl_point_s *pos,
 int nx_fill(NXWINDOW hwnd, FAR const struct nxgl_rect_s *rect,
             nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
 
+/****************************************************************************
+ * Name: nx_fills
+ *
+ * Description:
+ *  Fill a batch of rectangles in the window, each with its own color, in
+ *  the order given.  The whole batch is a single message to the server,
+ *  which clips it once where no window covers it.  Returns once the
+ *  server is done with the fills array.
+ *
+ * Input Parameters:
+ *   hwnd   - The window handle
+ *   fills  - The rectangles and their colors
+ *   nfills - The number of entries in fills
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_fills(NXWINDOW hwnd, FAR const struct nx_fill_s *fills,
+             unsigned int nfills);
+
 /****************************************************************************
  * Name: nx_getrectangle
  *
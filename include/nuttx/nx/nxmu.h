@@ -135,6 +135,7 @@ enum nxmsg_e
   NX_SVRMSG_SETVISIBILITY,    /* Show or hide a window */
   NX_SVRMSG_SETPIXEL,         /* Set a single pixel in the window with a color */
   NX_SVRMSG_FILL,             /* Fill a rectangle in the window with a color */
+  NX_SVRMSG_FILLS,            /* Fill a batch of rectangles in the window */
   NX_SVRMSG_GETRECTANGLE,     /* Get a rectangular region in the window */
   NX_SVRMSG_FILLTRAP,         /* Fill a trapezoidal region in the window with a color */
   NX_SVRMSG_MOVE,             /* Move a rectangular region within the window */
@@ -425,6 +426,17 @@ struct nxsvrmsg_fill_s
   nxgl_mxpixel_t color[CONFIG_NX_NPLANES]; /* Color to use in the fill */
 };
 
+/* Fill a batch of rectangles in the window, each with its color */
+
+struct nxsvrmsg_fills_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_FILLS */
+  FAR struct nxbe_window_s *wnd;   /* The window to fill  */
+  FAR const struct nx_fill_s *fills; /* The rectangles and colors */
+  unsigned int nfills;             /* The number of fills */
+  sem_t *sem_done;                 /* Semaphore to report when command is done. */
+};
+
 /* Get a rectangular region from the window */
 
 struct nxsvrmsg_getrectangle_s
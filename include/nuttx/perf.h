@@ -0,0 +1,153 @@
+/****************************************************************************
+ * include/nuttx/perf.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PERF_H
+#define __INCLUDE_NUTTX_PERF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERF_EVENT_BIT(e) (UINT32_C(1) << (e))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The hardware events counted per thread.  Each architecture counts the
+ * subset its counters provide, see up_perf_event_supported().
+ */
+
+enum perf_event_e
+{
+  PERF_EVENT_CYCLES = 0,       /* CPU cycles */
+  PERF_EVENT_INSTRUCTIONS,     /* Instructions executed */
+  PERF_EVENT_CACHE_REFS,       /* Level 1 data cache accesses */
+  PERF_EVENT_CACHE_MISSES,     /* Level 1 data cache refills */
+  PERF_EVENT_BRANCH_MISSES,    /* Mispredicted branches */
+  PERF_EVENT_STALLS,           /* Extra cycles of multi-cycle instructions */
+  PERF_EVENT_LSU,              /* Extra cycles of loads and stores */
+  PERF_EVENT_FOLDED,           /* Folded instructions */
+  PERF_EVENT_SLEEP,            /* Cycles sleeping */
+  PERF_EVENT_EXCEPTION,        /* Cycles of exception entry and return */
+  PERF_EVENT_MAX
+};
+
+/* A counter of one event of one thread, counting from perf_event_open() */
+
+struct perf_event_s
+{
+  pid_t pid;                   /* The thread counted */
+  uint8_t type;                /* See enum perf_event_e */
+  uint64_t base;               /* The count when the counter was opened */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: perf_event_open
+ *
+ * Description:
+ *   Start counting an event of a thread.  The counts of the thread are
+ *   saved when it is switched out, so they are not disturbed by the other
+ *   threads.
+ *
+ * Input Parameters:
+ *   event - The counter to initialize
+ *   type  - The event to count, see enum perf_event_e
+ *   pid   - The thread to count, zero for the calling thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure:  -EINVAL if the
+ *   event is not counted by this architecture, -ESRCH if there is no such
+ *   thread.
+ *
+ ****************************************************************************/
+
+int perf_event_open(FAR struct perf_event_s *event, int type, pid_t pid);
+
+/****************************************************************************
+ * Name: perf_event_read
+ *
+ * Description:
+ *   Return the number of events counted since perf_event_open() or
+ *   perf_event_reset().
+ *
+ ****************************************************************************/
+
+int perf_event_read(FAR struct perf_event_s *event, FAR uint64_t *value);
+
+/****************************************************************************
+ * Name: perf_event_reset
+ ****************************************************************************/
+
+int perf_event_reset(FAR struct perf_event_s *event);
+
+/****************************************************************************
+ * Name: perf_event_snapshot
+ *
+ * Description:
+ *   Return the counts of all events of a thread since it was created, in
+ *   an array of PERF_EVENT_MAX values.  The counts of a thread running on
+ *   another CPU are those of its last switch.
+ *
+ ****************************************************************************/
+
+int perf_event_snapshot(pid_t pid, FAR uint64_t *counts);
+
+/****************************************************************************
+ * Name: perf_event_name
+ *
+ * Description:
+ *   Return the name of an event, NULL if the event is not counted by this
+ *   architecture.
+ *
+ ****************************************************************************/
+
+FAR const char *perf_event_name(int type);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_PERF_EVENTS */
+#endif /* __INCLUDE_NUTTX_PERF_H */
@@ -0,0 +1,141 @@
+/****************************************************************************
+ * include/nuttx/power/hibernate.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_POWER_HIBERNATE_H
+#define __INCLUDE_NUTTX_POWER_HIBERNATE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_PM_HIBERNATE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A range of RAM saved in the image.  Together the regions must cover all
+ * the RAM in use: .data, .bss, the heaps, and the stacks outside of them.
+ */
+
+struct hibernate_region_s
+{
+  uintptr_t start;
+  size_t    size;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct mtd_dev_s;
+
+/****************************************************************************
+ * Name: hibernate_save
+ *
+ * Description:
+ *   Save the given RAM regions to the MTD device, followed by a header
+ *   holding their CRC.  The interrupts stay disabled during the whole save
+ *   so that the image is consistent: the MTD driver must work that way, as
+ *   the drivers of internal flash do.
+ *
+ *   When hibernate_resume() later restores the image, this function
+ *   returns a second time, after board_hibernate_restore().
+ *
+ * Input Parameters:
+ *   mtd      - The device holding the image, usually a partition
+ *   regions  - The RAM regions to save
+ *   nregions - Their number, at most CONFIG_PM_HIBERNATE_NREGIONS
+ *   key      - A value identifying the firmware, like a build id: an
+ *              image saved with another key is not restored
+ *
+ * Returned Value:
+ *   0 once the image is saved; 1 when returning from a restored image; a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hibernate_save(FAR struct mtd_dev_s *mtd,
+                   FAR const struct hibernate_region_s *regions,
+                   int nregions, uint32_t key);
+
+/****************************************************************************
+ * Name: hibernate_invalidate
+ *
+ * Description:
+ *   Erase the header of the image, so that the next boot is a normal one.
+ *
+ ****************************************************************************/
+
+int hibernate_invalidate(FAR struct mtd_dev_s *mtd);
+
+/****************************************************************************
+ * Name: hibernate_resume
+ *
+ * Description:
+ *   Check the image at 'image' and, if it is valid and was saved with
+ *   'key', copy it back into RAM and return into hibernate_save().
+ *   Otherwise return, and the boot goes on normally.
+ *
+ *   To be called by the board early in the reset sequence, before .data
+ *   and .bss are initialized, with the MTD memory mapped at 'image' and on
+ *   a stack outside of all the saved regions.
+ *
+ ****************************************************************************/
+
+void hibernate_resume(FAR const void *image, uint32_t key);
+
+/****************************************************************************
+ * Name: board_hibernate_restore
+ *
+ * Description:
+ *   Provided by the board: bring the clocks, the interrupt controller, the
+ *   system timer, and the peripherals back to the state they were in when
+ *   the image was saved.  Called with the interrupts disabled, before
+ *   hibernate_save() returns from a restored image.
+ *
+ *   The state of the driver of the image's MTD device was saved in the
+ *   middle of a write, with its lock held: it must be initialized again
+ *   here too.
+ *
+ ****************************************************************************/
+
+void board_hibernate_restore(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_PM_HIBERNATE */
+#endif /* __INCLUDE_NUTTX_POWER_HIBERNATE_H */
@@ -59,6 +59,7 @@
 #include <nuttx/wdog.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef CONFIG_PM
@@ -313,6 +314,16 @@ struct pm_wakelock_s
 #endif
 };
 
+/* A wake-up latency constraint, see pm_qos_add_request() */
+
+#define PM_QOS_LATENCY_NONE UINT32_MAX
+
+struct pm_qos_request_s
+{
+  struct dq_entry_s node;
+  uint32_t latency;               /* Microseconds */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -377,6 +388,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -785,6 +809,57 @@ enum pm_state_e pm_querystate(int domain);
 
 void pm_auto_updatestate(int domain);
 
+/****************************************************************************
+ * Name: pm_qos_add_request
+ *
+ * Description:
+ *   Ask that the system wakes up from the power states within 'latency'
+ *   microseconds, until the request is removed.  The strictest of all the
+ *   requests applies.  Only the latency governor takes them into account.
+ *
+ * Input Parameters:
+ *   req     - The request, owned by the caller until it is removed
+ *   latency - The longest wake-up latency allowed, in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_add_request(FAR struct pm_qos_request_s *req, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update_request
+ *
+ * Description:
+ *   Change the latency of a request added before.
+ *
+ ****************************************************************************/
+
+void pm_qos_update_request(FAR struct pm_qos_request_s *req,
+                           uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove_request
+ *
+ * Description:
+ *   Remove a request added before.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove_request(FAR struct pm_qos_request_s *req);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the strictest latency of the requests, in microseconds, or
+ *   PM_QOS_LATENCY_NONE if there is none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -822,6 +897,9 @@ void pm_auto_updatestate(int domain);
 #  define pm_changestate(domain,state)        (0)
 #  define pm_querystate(domain)               (0)
 #  define pm_auto_updatestate(domain)
+#  define pm_qos_add_request(req,latency)
+#  define pm_qos_update_request(req,latency)
+#  define pm_qos_remove_request(req)
 
 #endif /* CONFIG_PM */
 #endif /* __INCLUDE_NUTTX_POWER_PM_H */
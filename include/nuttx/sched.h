@@ -44,6 +44,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/map.h>
+#include <nuttx/perf.h>
 
 #include <arch/arch.h>
 
@@ -96,6 +97,8 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
+#define TCB_FLAG_FPU_USED          (1 << 7)                      /* Bit 7: Thread owns an FPU context */
 #define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 7: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 8: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 9: In a system call */
@@ -320,6 +323,30 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is allocated and hooked into the TCB when the
+ * SCHED_DEADLINE policy is assigned to a thread.  It holds the constant
+ * bandwidth server state of the thread.  All times are in system ticks.
+ */
+
+struct deadline_s
+{
+  struct wdog_s timer;              /* Budget enforcement timer              */
+  uint32_t  runtime;                /* Execution budget per period           */
+  uint32_t  deadline;               /* Relative deadline                     */
+  uint32_t  period;                 /* Reservation period                    */
+  uint32_t  bandwidth;              /* runtime / period (fixed point)        */
+  sclock_t  budget;                 /* Budget left in the current instance   */
+  clock_t   absdeadline;            /* Deadline of the current instance      */
+  clock_t   eventtime;              /* Time the thread was last resumed      */
+  uint32_t  nmisses;                /* Number of deadlines missed            */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -416,6 +443,10 @@ struct join_s;                      /* Forward reference
 struct binary_s;                    /* Forward reference                        */
                                     /* Defined in include/nuttx/binfmt/binfmt.h */
 #endif
+#ifdef CONFIG_SIG_FASTPATH
+struct sigq_s;                      /* Forward reference                        */
+                                    /* Defined in sched/signal/signal.h         */
+#endif
 
 struct task_group_s
 {
@@ -562,12 +593,19 @@ struct tcb_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t  boost_priority;               /* "Boosted" priority of the thread */
   uint8_t  base_priority;                /* "Normal" priority of the thread */
-  FAR struct semholder_s *holdsem;       /* List of held semaphores         */
+  dq_queue_t holdsem;                    /* List of held semaphores         */
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+  struct semholder_s holders[CONFIG_SEM_PREALLOCHOLDERS];
+                                         /* Holder slots of this thread     */
+#  endif
 #endif
 
 #ifdef CONFIG_SMP
   uint8_t  cpu;                          /* CPU index if running/assigned   */
   cpu_set_t affinity;                    /* Bit set of permitted CPUs       */
+#endif
+#ifdef CONFIG_SCHED_CACHE_AFFINITY
+  uint32_t nmigrations;                  /* Number of moves to another CPU  */
 #endif
   uint16_t flags;                        /* Misc. general status flags      */
   int16_t  lockcount;                    /* 0=preemptible (not-locked)      */
@@ -586,6 +624,9 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling state       */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -617,6 +658,9 @@ struct tcb_s
   sq_queue_t sigpendactionq;             /* List of pending signal actions  */
   sq_queue_t sigpostedq;                 /* List of posted signals          */
   siginfo_t  sigunbinfo;                 /* Signal info when task unblocked */
+#ifdef CONFIG_SIG_FASTPATH
+  FAR struct sigq_s *sigqcache;          /* Free pending signal action      */
+#endif
 
   /* Robust mutex support ***************************************************/
 
@@ -630,6 +674,12 @@ struct tcb_s
   uint32_t ticks;                        /* Number of ticks on this thread */
 #endif
 
+  /* CPU time accounting support ********************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+  uint64_t cputime;                      /* up_perf_gettime() counts run    */
+#endif
+
   /* Pre-emption monitor support ********************************************/
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -642,6 +692,46 @@ struct tcb_s
   unsigned long run_time;                /* Total time thread run           */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+  FAR void *premp_caller;                /* Caller of sched_lock()          */
+  FAR void *crit_caller;                 /* Caller of enter_critical_section */
+#endif
+
+  /* Hardware performance counters ******************************************/
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  uint64_t perf_count[PERF_EVENT_MAX];   /* Events counted while running    */
+#endif
+
+  /* Stack high-water mark **************************************************/
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+  size_t stack_watermark;                /* Deepest stack use seen, bytes   */
+#endif
+
+  /* Resource usage counters **********************************************/
+
+#ifdef CONFIG_SCHED_RUSAGE
+  uint64_t rchar;                        /* Bytes read through the VFS      */
+  uint64_t wchar;                        /* Bytes written through the VFS   */
+  uint32_t syscr;                        /* Number of file reads            */
+  uint32_t syscw;                        /* Number of file writes           */
+  uint32_t nvcsw;                        /* Switches away while blocking    */
+  uint32_t nivcsw;                       /* Switches away while runnable    */
+#endif
+
+  /* Lazy FPU context switch support ***************************************/
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  uint32_t fpuskips;                     /* Switches that skipped FPU save  */
+#endif
+
+  /* Registrations kept by poll() ******************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+  FAR struct pollcache_s *pollcache;     /* Of the last call to poll()      */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -745,6 +835,37 @@ begin_packed_struct struct tcbinfo_s
 
 typedef CODE void (*nxsched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
 
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+#  ifndef CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH
+#    define CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH 0
+#  endif
+
+/* The sections traced by the critical section monitor */
+
+enum critmon_trace_e
+{
+  CRITMON_TRACE_CSECTION = 0,            /* Within a critical section       */
+  CRITMON_TRACE_PREEMPTION,              /* With pre-emption disabled       */
+  CRITMON_TRACE_NTYPES
+};
+
+/* One of the longest sections of a type */
+
+struct critmon_trace_s
+{
+  unsigned long elapsed;                 /* Duration, up_perf_gettime()     */
+  pid_t pid;                             /* Thread holding the section      */
+  uint8_t cpu;                           /* CPU of the thread               */
+  uint8_t depth;                         /* Valid entries of backtrace[]    */
+  FAR void *entry;                       /* Caller which began the section  */
+  FAR void *exit;                        /* Caller which ended it, NULL if
+                                          * the thread was switched out     */
+#if CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH > 0
+  FAR void *backtrace[CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH]; /* At exit */
+#endif
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -842,6 +963,20 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid);
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a thread of type 'ttype': a struct
+ *   pthread_tcb_s for TCB_FLAG_TTYPE_PTHREAD, else a struct task_tcb_s.
+ *   The TCB is released with nxsched_release_tcb(), or, if it was never
+ *   initialized, with nxsched_free_tcb().
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype);
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
+
 /* File system helpers ******************************************************/
 
 /* These functions all extract lists from the group structure associated with
@@ -893,7 +1028,8 @@ FAR struct filelist *nxsched_get_files(void);
  *   task_create()
  *
  *   Unlike task_create():
- *     1. Allocate the TCB.  The pre-allocated TCB is passed in argv.
+ *     1. Allocate the TCB.  The pre-allocated TCB is passed in argv.  It
+ *        must have been allocated with nxsched_alloc_tcb().
  *     2. Allocate the stack.  The pre-allocated stack is passed in argv.
  *     3. Activate the task. This must be done by calling nxtask_activate().
  *
@@ -932,7 +1068,7 @@ int nxtask_init(FAR struct task_tcb_s *tcb, const char *name, int priority,
  *
  * Description:
  *   Undo all operations on a TCB performed by task_init() and release the
- *   TCB by calling kmm_free().  This is intended primarily to support
+ *   TCB by calling nxsched_free_tcb().  This is intended primarily to support
  *   error recovery operations after a successful call to task_init() such
  *   was when a subsequent call to task_activate fails.
  *
@@ -1200,6 +1336,44 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb);
 #  define nxsched_suspend_scheduler(tcb)
 #endif
 
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time used by a thread, including the time since it was
+ *   last charged if it is running now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   The CPU time in nanoseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+uint64_t nxsched_get_cputime(FAR struct tcb_s *tcb);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_get_irqtime
+ *
+ * Description:
+ *   Return the time a CPU spent in interrupt handlers.  This time is not
+ *   charged to any thread.
+ *
+ * Input Parameters:
+ *   cpu - The CPU
+ *
+ * Returned Value:
+ *   The time in nanoseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+uint64_t nxsched_get_irqtime(int cpu);
+#endif
+
 /****************************************************************************
  * Name: nxsched_get_param
  *
@@ -1572,6 +1746,67 @@ pid_t nxsched_getppid(void);
 
 size_t nxsched_collect_deadlock(FAR pid_t *pid, size_t count);
 
+/****************************************************************************
+ * Name: critmon_trace_snapshot
+ *
+ * Description:
+ *   Return the longest sections of a type since the last reset, longest
+ *   first.
+ *
+ * Input Parameters:
+ *   type    - The type of the sections, see enum critmon_trace_e
+ *   traces  - The location to return the sections
+ *   ntraces - The number of entries of traces[]
+ *   reset   - Forget the sections returned
+ *
+ * Returned Value:
+ *   The number of sections returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+int critmon_trace_snapshot(int type, FAR struct critmon_trace_s *traces,
+                           int ntraces, bool reset);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_stack_sample
+ *
+ * Description:
+ *   Account a stack pointer of a thread in its stack high-water mark.  It
+ *   is cheap enough for the context switches and the interrupt handlers.
+ *   A stack pointer outside of the stack of the thread is ignored.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *   sp  - A stack pointer of the thread
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+void nxsched_stack_sample(FAR struct tcb_s *tcb, uintptr_t sp);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_stack_watermark
+ *
+ * Description:
+ *   Return the deepest stack use of a thread known so far.  With the stack
+ *   coloration, the coloring is first scanned down from the last known
+ *   mark, instead of the whole unused stack.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   The stack high-water mark in bytes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+size_t nxsched_stack_watermark(FAR struct tcb_s *tcb);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
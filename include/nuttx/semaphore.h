@@ -40,12 +40,13 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, holder, hlist */
 
 #    define NXSEM_INITIALIZER(c, f) \
-       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL}
+       {(c), (f), SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER, \
+        {NULL, NULL}}
 #  else
-/* semcount, flags, waitlist, holder[2] */
+/* semcount, flags, waitlist, holder */
 
 #    define NXSEM_INITIALIZER(c, f) \
        {(c), (f), SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER}
@@ -330,6 +330,17 @@
  */
 
 #define SNIOC_UNREGISTER           _SNIOC(0x0090)
+
+/* Command:      SNIOC_REGISTER_FUSION
+ * Description:  Register a fusion sensor, which publishes the orientation
+ *               computed from raw topics.  It is unregistered by
+ *               SNIOC_UNREGISTER.
+ * Argument:     A pointer of structure sensor_fusion_reginfo_s.
+ * Note:         If register is failed, return errno, otherwise,
+ *               return OK.
+ */
+
+#define SNIOC_REGISTER_FUSION      _SNIOC(0x009C)
 #endif
 
 /* Command:      SNIOC_UPDATED
@@ -406,4 +417,13 @@
 
 #define SNIOC_ENABLE_FIFO             _SNIOC(0x009A)
 
+/* Command:      SNIOC_SET_GENERATION
+ * Description:  Tell the upper half the generation of the newest sample
+ *               the user has taken in place through mmap(), so poll() and
+ *               SNIOC_UPDATED are tracked as if the sample was read.
+ * Argument:     The generation of the sample (unsigned long).
+ */
+
+#define SNIOC_SET_GENERATION          _SNIOC(0x009B)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
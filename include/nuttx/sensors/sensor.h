@@ -33,6 +33,7 @@
 #include <time.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
 #include <nuttx/sensors/ioctl.h>
 #include <nuttx/clock.h>
 
@@ -290,9 +291,18 @@
 
 #define SENSOR_TYPE_CAP                             32
 
+/* Orientation
+ * The attitude of the device as a unit quaternion rotating the device frame
+ * into the earth frame, with the matching Euler angles in radians.  It is
+ * published by the fusion sensors from the raw accelerometer, gyroscope
+ * and magnetometer topics.
+ */
+
+#define SENSOR_TYPE_ORIENTATION                     33
+
 /* The total number of sensor */
 
-#define SENSOR_TYPE_COUNT                           33
+#define SENSOR_TYPE_COUNT                           34
 
 /* The additional sensor open flags */
 
@@ -595,6 +605,18 @@ struct sensor_cap           /* Type: Capacitance */
   int32_t rawdata[4];       /* in SI units pF */
 };
 
+struct sensor_orientation   /* Type: Orientation */
+{
+  uint64_t timestamp;       /* Units is microseconds */
+  float w;                  /* Quaternion scalar part */
+  float x;                  /* Quaternion axis X part */
+  float y;                  /* Quaternion axis Y part */
+  float z;                  /* Quaternion axis Z part */
+  float roll;               /* Rotation around axis X in rad */
+  float pitch;              /* Rotation around axis Y in rad */
+  float yaw;                /* Rotation around axis Z in rad */
+};
+
 /* The sensor lower half driver interface */
 
 struct sensor_lowerhalf_s;
@@ -995,6 +1017,66 @@ struct sensor_ustate_s
   unsigned long generation;    /* The recent generation of circular buffer */
 };
 
+#ifdef CONFIG_SENSORS_MMAP
+/* This structure is the head of the memory returned by mmap() on a sensor,
+ * followed by the ring of samples at offset "data" and the ring of their
+ * generations at offset "timing".  Both rings hold nbuffer entries and the
+ * sample n (counting from 0 since the buffer was created) is the entry
+ * n % nbuffer of each.  The entry stays valid while head / esize - n is
+ * less than nbuffer, and the advertiser makes sequence odd while it
+ * updates the rings, so a subscriber takes the newest sample in place by:
+ *
+ *   do
+ *     {
+ *       seq = shm->sequence;
+ *       n = shm->head / shm->esize - 1;
+ *       ... use data + (n % shm->nbuffer) * shm->esize ...
+ *     }
+ *   while ((seq & 1) || seq != shm->sequence);
+ *
+ * and then reports the generation it consumed by SNIOC_SET_GENERATION.
+ */
+
+struct sensor_mmap_s
+{
+  volatile unsigned long sequence;   /* Odd while the rings are updated */
+  volatile unsigned long head;       /* The bytes pushed into data ring */
+  volatile unsigned long generation; /* The generation of newest sample */
+  unsigned long esize;               /* The element size of data ring */
+  unsigned long nbuffer;             /* The number of entries each ring has */
+  unsigned long data;                /* The offset of the data ring */
+  unsigned long timing;              /* The offset of the generation ring */
+};
+#endif
+
+#ifdef CONFIG_SENSORS_FIFO
+/* This structure is kept by a lower half driver batching the samples in the
+ * hardware fifo, see sensor_fifo_watermark() and sensor_fifo_push().
+ */
+
+struct sensor_fifo_s
+{
+  uint64_t      timestamp;     /* The time of the last sample pushed, in us */
+  unsigned long interval;      /* The time between two samples, in us */
+  unsigned long nominal;       /* The interval set by set_interval(), in us */
+  unsigned long depth;         /* The samples the hardware fifo holds */
+};
+#endif
+
+#ifdef CONFIG_SENSORS_TAP
+/* This structure is attached by kernel code to a sensor it opened, its
+ * event() is called with each batch of samples pushed, after the samples
+ * were published and out of the lock of that sensor.
+ */
+
+struct sensor_tap_s
+{
+  struct list_node node;       /* Node of the taps list */
+  CODE void (*event)(FAR struct sensor_tap_s *tap, FAR const void *data,
+                     size_t bytes);
+};
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
@@ -1012,6 +1094,19 @@ struct sensor_reginfo_s
 };
 #endif
 
+/* This structure describes the register info for the fusion sensor */
+
+#ifdef CONFIG_SENSORS_FUSION
+struct sensor_fusion_reginfo_s
+{
+  FAR const char *path;        /* The path of orientation topic */
+  FAR const char *accel;       /* The path of accelerometer topic */
+  FAR const char *gyro;        /* The path of gyroscope topic */
+  FAR const char *mag;         /* The path of magnetometer topic, or NULL */
+  unsigned long   nbuffer;     /* The number of queue buffered elements */
+};
+#endif
+
 /* This structure describes the context custom ioctl for device */
 
 struct sensor_ioctl_s
@@ -1125,6 +1220,64 @@ void sensor_unregister(FAR struct sensor_lowerhalf_s *dev, int devno);
 void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *dev,
                               FAR const char *path);
 
+/****************************************************************************
+ * Name: sensor_fifo_watermark
+ *
+ * Description:
+ *   Compute the fifo watermark for a batch latency.  The lower half calls
+ *   this from its batch() operation with the interval in effect, programs
+ *   the returned number of samples as the watermark of the hardware fifo,
+ *   and then drains that many samples in one bus transfer on each
+ *   watermark interrupt.
+ *
+ * Input Parameters:
+ *   fifo     - The fifo state, zeroed before the first call.
+ *   depth    - The number of samples the hardware fifo holds.
+ *   interval - The sampling interval, in us.
+ *   latency  - The batch latency asked for, in us.  It is overwritten by
+ *              the latency achieved, zero when batching is off.
+ *
+ * Returned Value:
+ *   The number of samples per watermark interrupt, one when batching is
+ *   off.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_FIFO
+unsigned long sensor_fifo_watermark(FAR struct sensor_fifo_s *fifo,
+                                    unsigned long depth,
+                                    unsigned long interval,
+                                    FAR unsigned long *latency);
+
+/****************************************************************************
+ * Name: sensor_fifo_push
+ *
+ * Description:
+ *   Push a batch of samples read from the hardware fifo to the upper half
+ *   at once.  The timestamp of each sample, which must start its structure
+ *   as for all struct sensor_xxx, is interpolated back from the time of the
+ *   watermark interrupt by the interval measured between the interrupts.
+ *
+ * Input Parameters:
+ *   lower     - The lower half driver registered.
+ *   fifo      - The fifo state passed to sensor_fifo_watermark().
+ *   data      - The samples, the oldest first.
+ *   esize     - The size of one sample.
+ *   nsamples  - The number of samples.
+ *   timestamp - The time of the watermark interrupt, i.e. of the newest
+ *               sample, in us.
+ *
+ * Returned Value:
+ *   The bytes pushed on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_fifo_push(FAR struct sensor_lowerhalf_s *lower,
+                         FAR struct sensor_fifo_s *fifo,
+                         FAR void *data, size_t esize, size_t nsamples,
+                         uint64_t timestamp);
+#endif
+
 /****************************************************************************
  * Name: usensor_initialize
  *
@@ -1138,6 +1291,63 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *dev,
 int usensor_initialize(void);
 #endif
 
+/****************************************************************************
+ * Name: sensor_tap_attach/sensor_tap_detach
+ *
+ * Description:
+ *   Attach a tap to, or detach it from, a sensor opened by kernel code, so
+ *   that the pushed samples are processed at the source without being read
+ *   through the file.
+ *
+ * Input Parameters:
+ *   filep - The sensor opened by file_open().
+ *   tap   - The tap, which must persist until it is detached.
+ *
+ * Returned Value:
+ *   OK on success; -ENOTTY if the file isn't a sensor.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_TAP
+int sensor_tap_attach(FAR struct file *filep, FAR struct sensor_tap_s *tap);
+int sensor_tap_detach(FAR struct file *filep, FAR struct sensor_tap_s *tap);
+#endif
+
+/****************************************************************************
+ * Name: sensor_fusion_register
+ *
+ * Description:
+ *   Register a fusion sensor, which runs a Madgwick filter on each
+ *   gyroscope sample pushed, corrected by the latest accelerometer and
+ *   magnetometer samples, and publishes the result on an orientation
+ *   topic.  It is also reachable from /dev/usensor by
+ *   SNIOC_REGISTER_FUSION.
+ *
+ * Input Parameters:
+ *   info - The paths of the orientation and raw topics.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_FUSION
+int sensor_fusion_register(FAR const struct sensor_fusion_reginfo_s *info);
+
+/****************************************************************************
+ * Name: sensor_fusion_unregister
+ *
+ * Description:
+ *   Unregister the fusion sensor publishing on the path.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such fusion sensor.
+ *
+ ****************************************************************************/
+
+int sensor_fusion_unregister(FAR const char *path);
+#endif
+
 /****************************************************************************
  * Name: sensor_rpmsg_register
  *
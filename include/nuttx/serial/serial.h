@@ -35,6 +35,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
+#ifdef CONFIG_SERIAL_RXWATERMARK
+#  include <nuttx/wdog.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -309,6 +312,14 @@ struct uart_dev_s
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
 #endif
 
+#ifdef CONFIG_SERIAL_RXWATERMARK
+  /* RX watermark, see struct serial_rxwm_s */
+
+  size_t               rxwatermark;  /* Bytes buffered to wake up readers */
+  clock_t              rxtimeout;    /* Inter-byte timeout (ticks) */
+  struct wdog_s        rxidle;       /* Wakes up the readers on timeout */
+#endif
+
   /* Driver interface */
 
   FAR const struct uart_ops_s *ops;  /* Arch-specific operations */
@@ -487,6 +498,27 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_block
+ *
+ * Description:
+ *  Copy a block received by DMA into buffers of the lower half, such as a
+ *  half of a ping-pong or cyclic DMA buffer completed or cut short by an
+ *  idle line, to the RX circular buffer, and wake up the readers as
+ *  uart_recvchars_done().  The lower half may then restart the DMA in that
+ *  half at once.
+ *
+ * Returned Value:
+ *  The number of bytes copied, fewer than nbytes if the RX circular buffer
+ *  was full and the other bytes were dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+size_t uart_recvchars_block(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t nbytes);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
@@ -202,6 +202,11 @@
 
 #define TIOCSLINID      _TIOC(0x0037) /* Master send one LIN header with specified LIN identifier: uint8_t */
 
+/* RX watermark and inter-byte timeout of the DMA receive path */
+
+#define TIOCSRXWM       _TIOC(0x0038)  /* Set RX watermark: struct serial_rxwm_s */
+#define TIOCGRXWM       _TIOC(0x0039)  /* Get RX watermark: struct serial_rxwm_s */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -226,6 +231,18 @@ struct serial_rs485
   uint32_t delay_rts_after_send;   /* Delay after send (milliseconds) */
 };
 
+/* Structure used with TIOCSRXWM and TIOCGRXWM.  The readers are woken up
+ * once watermark bytes are buffered, or when no byte was received for
+ * timeout microseconds after the last one.  A watermark of zero or one
+ * wakes them up on every byte received.
+ */
+
+struct serial_rxwm_s
+{
+  size_t   watermark;              /* Bytes buffered to wake up readers */
+  uint32_t timeout;                /* Inter-byte timeout (microseconds) */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
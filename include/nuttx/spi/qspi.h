@@ -220,6 +220,30 @@
 
 #define QSPI_FREE(d,b) (d)->ops->free(d,b)
 
+/****************************************************************************
+ * Name: QSPI_MEMMAP
+ *
+ * Description:
+ *   Put the controller in memory mapped mode, where the CPU reads the
+ *   memory at the returned base address with the read command described
+ *   by meminfo (addr, buflen and buffer are not used).  With a NULL
+ *   meminfo, leave that mode so that commands and memory transfers can be
+ *   performed again.  The bus must be locked.  This method is optional.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command, or NULL
+ *   base    - The location to return the mapped address, or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, -ENOSYS if the controller doesn't support the
+ *   memory mapped mode, another negated errno value on other failures.
+ *
+ ****************************************************************************/
+
+#define QSPI_MEMMAP(d,m,b) \
+  ((d)->ops->memmap ? (d)->ops->memmap(d,m,b) : -ENOSYS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -277,6 +301,9 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+  CODE int       (*memmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo,
+                    FAR void **base);
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
@@ -32,6 +32,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -112,6 +113,44 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_QUEUE
+/* This describes one sequence queued by spi_queue_submit().  The complete
+ * callback runs on the thread of the queue once the sequence is done, with
+ * the bus released, so it may submit the next request or call
+ * spi_transfer() itself.
+ *
+ * Example usage:
+ *   static void mydone(FAR struct spi_request_s *req, int result)
+ *   {
+ *     ...
+ *   }
+ *
+ *   FAR struct spi_queue_s *queue = spi_queue_initialize(spi);
+ *   ...
+ *   myreq.seq      = &myseq;
+ *   myreq.priority = 100;
+ *   myreq.complete = mydone;
+ *   int ret = spi_queue_submit(queue, &myreq);
+ *   ...
+ */
+
+struct spi_request_s;
+typedef CODE void (*spi_complete_t)(FAR struct spi_request_s *req,
+                                    int result);
+
+struct spi_request_s
+{
+  sq_entry_t node;             /* Used by the queue */
+  FAR struct spi_sequence_s *seq; /* The transfers to perform */
+  uint8_t priority;            /* Higher priorities are served first */
+  spi_complete_t complete;     /* Called when the sequence is done */
+  FAR void *arg;               /* For use by the complete callback */
+  int result;                  /* Used by the queue */
+};
+
+struct spi_queue_s;            /* Opaque, one per SPI bus */
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -135,6 +174,102 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_locked
+ *
+ * Description:
+ *   Same as spi_transfer() on a bus that the caller already locked with
+ *   SPI_LOCK(), so that several sequences can be performed back to back.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   seq - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_locked(FAR struct spi_dev_s *spi,
+                        FAR struct spi_sequence_s *seq);
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Return the transfer queue of an SPI bus, starting its thread the first
+ *   time.  Every driver on the bus gets the same queue, which is released
+ *   by spi_queue_uninitialize().
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_queue_uninitialize
+ *
+ * Description:
+ *   Release a reference to the queue.  With the last one the thread stops
+ *   and the requests still queued complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *
+ ****************************************************************************/
+
+void spi_queue_uninitialize(FAR struct spi_queue_s *queue);
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting for them.
+ *   Requests run in the order of their priority, first come first served
+ *   within one priority.  The request and its sequence must stay valid
+ *   until the complete callback is called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - Describes the sequence and its callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not started yet.  Its complete callback is
+ *   not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request passed to spi_queue_submit()
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it has started or is
+ *   done.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+
+#endif /* CONFIG_SPI_QUEUE */
+
 /****************************************************************************
  * Name: spi_register
  *
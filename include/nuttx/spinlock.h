@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/irq.h>
@@ -446,4 +447,105 @@ void spin_unlock_irqrestore_wo_note(spinlock_t *lock, irqstate_t flags);
 #  define spin_unlock_irqrestore_wo_note(l, f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Subsystem Locks
+ *
+ * A subsystem lock protects the data of one subsystem (a work queue, an
+ * IOB cache, ...) in place of the global critical section.  It is a leaf
+ * lock:  it may be taken with or without enter_critical_section() held,
+ * but nothing that may enter the critical section, block or post a
+ * semaphore may be called while it is held.
+ *
+ * With CONFIG_SCHED_CRITMONITOR_SUBSYS, each lock records its longest hold
+ * time and the number of acquisitions, reported by /proc/critmon.
+ *
+ ****************************************************************************/
+
+typedef struct subsys_lock_s
+{
+  spinlock_t lock;                     /* The underlying spinlock */
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+  bool registered;                     /* Linked into the monitor list */
+  FAR const char *name;                /* Name shown in /proc/critmon */
+  FAR struct subsys_lock_s *flink;     /* Next monitored lock */
+  unsigned long start;                 /* Time the lock was taken */
+  unsigned long max;                   /* Longest hold time */
+  uint32_t nacquired;                  /* Number of acquisitions */
+#endif
+} subsys_lock_t;
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+#  define SUBSYS_LOCK_INITIALIZER(n) {0, false, (n), NULL, 0, 0, 0}
+#else
+#  define SUBSYS_LOCK_INITIALIZER(n) {0}
+#endif
+
+/****************************************************************************
+ * Name: subsys_lock_initialize
+ *
+ * Description:
+ *   Initialize a subsystem lock at run time.
+ *
+ * Input Parameters:
+ *   lock - The subsystem lock to initialize
+ *   name - The name of the lock in /proc/critmon
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+void subsys_lock_initialize(FAR subsys_lock_t *lock, FAR const char *name);
+#else
+#  define subsys_lock_initialize(l, n) \
+     do { (void)(n); spin_initialize(&(l)->lock, 0); } while (0)
+#endif
+
+/****************************************************************************
+ * Name: subsys_lock
+ *
+ * Description:
+ *   Disable local interrupts and take the subsystem lock.  Equivalent to
+ *   spin_lock_irqsave() on the underlying spinlock.
+ *
+ * Returned Value:
+ *   The interrupt state prior to the call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+irqstate_t subsys_lock(FAR subsys_lock_t *lock);
+#else
+#  define subsys_lock(l) spin_lock_irqsave(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: subsys_unlock
+ *
+ * Description:
+ *   Release the subsystem lock and restore the interrupt state returned
+ *   by subsys_lock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+void subsys_unlock(FAR subsys_lock_t *lock, irqstate_t flags);
+#else
+#  define subsys_unlock(l, f) spin_unlock_irqrestore(&(l)->lock, (f))
+#endif
+
+/****************************************************************************
+ * Name: subsys_lock_foreach
+ *
+ * Description:
+ *   Call 'handler' for each subsystem lock that has been taken at least
+ *   once.  Used by /proc/critmon.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+typedef CODE void (*subsys_lock_handler_t)(FAR subsys_lock_t *lock,
+                                           FAR void *arg);
+
+void subsys_lock_foreach(subsys_lock_handler_t handler, FAR void *arg);
+#endif
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
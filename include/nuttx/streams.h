@@ -274,6 +274,16 @@ struct lib_lzfoutstream_s
   char                        in[LZF_STREAM_BLOCKSIZE];
   char                        out[LZF_MAX_HDR_SIZE + LZF_STREAM_BLOCKSIZE];
 };
+
+struct lib_lzfinstream_s
+{
+  struct lib_instream_s       public;
+  FAR struct lib_instream_s  *backend;
+  int                         offset;   /* Next byte of out to return */
+  int                         size;     /* Bytes decompressed in out */
+  char                        in[LZF_MAX_HDR_SIZE + LZF_STREAM_BLOCKSIZE];
+  char                        out[LZF_STREAM_BLOCKSIZE];
+};
 #endif
 
 #ifndef CONFIG_DISABLE_MOUNTPOINT
@@ -569,6 +579,28 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
                       FAR struct lib_outstream_s *backend);
 #endif
 
+/****************************************************************************
+ * Name: lib_lzfinstream
+ *
+ * Description:
+ *  LZF decompressing pipeline stream, reading the blocks written by
+ *  lib_lzfoutstream() with the same CONFIG_STREAM_LZF_BLOG.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lzfinstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_LZF
+void lib_lzfinstream(FAR struct lib_lzfinstream_s *stream,
+                     FAR struct lib_instream_s *backend);
+#endif
+
 /****************************************************************************
  * Name: lib_blkoutstream_open
  *
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * include/nuttx/sysbatch.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SYSBATCH_H
+#define __INCLUDE_NUTTX_SYSBATCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of parameters of a queued system call */
+
+#define SYSBATCH_NPARMS 6
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* A system call queued by user space.  nbr is the SYS_ number of
+ * <sys/syscall.h>; priv is copied back to the completion unchanged.
+ */
+
+struct sysbatch_sqe_s
+{
+  uint32_t  nbr;
+  uintptr_t parm[SYSBATCH_NPARMS];
+  FAR void *priv;
+};
+
+/* The completion of a queued system call:  its return value and the errno
+ * value it left, or 0.
+ */
+
+struct sysbatch_cqe_s
+{
+  uintptr_t result;
+  int       errcode;
+  FAR void *priv;
+};
+
+/* The submission and completion rings, in user memory.  Both have
+ * nentries entries, a power of two, and free running indexes:  user space
+ * produces sq_tail and consumes cq_head, sysbatch() consumes sq_head and
+ * produces cq_tail.
+ */
+
+struct sysbatch_ring_s
+{
+  volatile uint32_t sq_head;
+  volatile uint32_t sq_tail;
+  volatile uint32_t cq_head;
+  volatile uint32_t cq_tail;
+  uint32_t nentries;
+  FAR struct sysbatch_sqe_s *sq;
+  FAR struct sysbatch_cqe_s *cq;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sysbatch
+ *
+ * Description:
+ *   Run the system calls queued in the submission ring, in order, with a
+ *   single trap, and queue their completions.  Only the calls that
+ *   neither change the control flow of the caller nor create or destroy
+ *   threads may be queued:  close, ioctl, lseek, poll, read, write, pread,
+ *   pwrite and, with networking, recv, recvfrom, send and sendto.  Other
+ *   numbers complete with ENOSYS.  sysbatch() stops when the submission
+ *   ring is empty or the completion ring is full.
+ *
+ * Input Parameters:
+ *   ring - The rings
+ *
+ * Returned Value:
+ *   The number of system calls run; -1 with errno set to EINVAL if the
+ *   ring is invalid.
+ *
+ ****************************************************************************/
+
+int sysbatch(FAR struct sysbatch_ring_s *ring);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LIB_SYSCALL_BATCH */
+#endif /* __INCLUDE_NUTTX_SYSBATCH_H */
@@ -32,6 +32,8 @@
 
 #include <sys/types.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -119,6 +121,26 @@ struct syslog_channel_s
   /* Implementation specific logic may follow */
 };
 
+#ifdef CONFIG_SYSLOG_STATS
+/* The cost of the calls of nx_vsyslog() in the caller, in the units of
+ * up_perf_gettime()
+ */
+
+struct syslog_cost_s
+{
+  unsigned long count;            /* Number of calls */
+  unsigned long max;              /* Most expensive call */
+  uint64_t      total;            /* Sum of all calls */
+};
+
+struct syslog_stats_s
+{
+  struct syslog_cost_s sync;      /* Messages formatted by the caller */
+  struct syslog_cost_s deferred;  /* Messages left to the syslog thread */
+  unsigned long        lost;      /* Deferred messages lost, buffer full */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -349,6 +371,23 @@ int syslog_flush(void);
 
 int nx_vsyslog(int priority, FAR const IPTR char *src, FAR va_list *ap);
 
+/****************************************************************************
+ * Name: syslog_stats
+ *
+ * Description:
+ *   Return the cost of the calls of nx_vsyslog() summed over all CPUs, and
+ *   optionally reset it.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *   reset - Start counting again from zero
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STATS
+void syslog_stats(FAR struct syslog_stats_s *stats, bool reset);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,209 @@
+/****************************************************************************
+ * include/nuttx/timers/hrtimer.h
+ *
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+#define __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/tree.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/timers/oneshot.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Check if a high resolution timer is running */
+
+#define HRTIMER_ISACTIVE(t) ((t)->func != NULL)
+
+/* Prepare a timer that is not zero-initialized (e.g. on the stack) */
+
+#define hrtimer_initialize(t) ((t)->func = NULL)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The callback invoked when a high resolution timer expires.  It runs in
+ * the context of the timer interrupt, within the critical section, like a
+ * watchdog callback.
+ */
+
+typedef CODE void (*hrtentry_t)(wdparm_t arg);
+
+/* One high resolution timer.  The expiration time is kept in nanoseconds
+ * of the hrtimer clock (see hrtimer_now()).
+ */
+
+struct hrtimer_s
+{
+  RB_ENTRY(hrtimer_s) node;      /* Node in the tree of active timers */
+  uint64_t            expired;   /* Absolute expiration time (nsec) */
+  hrtentry_t          func;      /* Callback; NULL when inactive */
+  wdparm_t            arg;       /* Callback argument */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Conversions between a timespec and the nanoseconds of the hrtimer API */
+
+static inline uint64_t hrtimer_ts2nsec(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + (uint64_t)ts->tv_nsec;
+}
+
+static inline void hrtimer_nsec2ts(uint64_t nsec, FAR struct timespec *ts)
+{
+  ts->tv_sec  = nsec / NSEC_PER_SEC;
+  ts->tv_nsec = nsec % NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Name: hrtimer_set_lowerhalf
+ *
+ * Description:
+ *   Bind the high resolution timers to a oneshot timer.  The oneshot timer
+ *   must be dedicated to this purpose; it cannot be the one given to
+ *   up_alarm_set_lowerhalf().  Until this is called the timers run on the
+ *   system tick through a watchdog, with tick resolution.
+ *
+ * Input Parameters:
+ *   lower - The oneshot timer lower half
+ *
+ ****************************************************************************/
+
+void hrtimer_set_lowerhalf(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current time of the hrtimer clock in nanoseconds.  It is
+ *   monotonic but has an unspecified origin.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a timer that expires after 'delay'.
+ *
+ * Input Parameters:
+ *   timer - The timer to start
+ *   delay - Time from now until the timer expires
+ *   func  - The function to call on expiration
+ *   arg   - The argument passed to func
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL on invalid arguments.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer,
+                  FAR const struct timespec *delay,
+                  hrtentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_start_abs
+ *
+ * Description:
+ *   Start (or restart) a timer that expires at 'expired' nanoseconds of
+ *   the hrtimer clock.  A time in the past expires at once.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_abs(FAR struct hrtimer_s *timer, uint64_t expired,
+                      hrtentry_t func, wdparm_t arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a timer.  Returns -EINVAL if it was not running.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining until the timer expires, or zero if it is
+ *   not running.
+ *
+ ****************************************************************************/
+
+void hrtimer_gettime(FAR struct hrtimer_s *timer,
+                     FAR struct timespec *remaining);
+
+/****************************************************************************
+ * Name: hrtimer_nextexpire
+ *
+ * Description:
+ *   Return the time in nanoseconds until the first running timer expires,
+ *   zero if it is already due, or UINT64_MAX if no timer is running.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_nextexpire(void);
+
+#else
+
+#  define hrtimer_set_lowerhalf(lower)
+
+#endif /* CONFIG_HRTIMER */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_TIMERS_HRTIMER_H */
@@ -57,7 +57,8 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x0d Reserved (future use) */
+                                     /* 0x08-0x0c Reserved (future use) */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
 #define CDC_SUBCLASS_MBIM       0x0e /* MBIM Control Model */
                                      /* 0x0f-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
@@ -84,8 +85,9 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NCMNTB   0x01 /* Network Transfer Block, NCM */
 #define CDC_DATA_PROTO_NTB      0x02 /* Network Transfer Block protocol */
+                                     /* 0x03-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
 #define CDC_DATA_PROTO_TRANSP   0x32 /* Transparent */
@@ -328,6 +330,29 @@
                                       */
 #define ECM_SPEED_CHANGE        ATM_SPEED_CHANGE
 
+/* [CDCNCM1.0] Table 6-2: Requests, Network Control Model */
+
+#define NCM_GET_NTB_PARAMETERS  0x80 /* Returns the NTB data structure sizes
+                                      * and alignments supported by the
+                                      * function. (Required)
+                                      */
+#define NCM_GET_NET_ADDRESS     0x81 /* Returns the current EUI-48 station
+                                      * address. (Optional)
+                                      */
+#define NCM_SET_NET_ADDRESS     0x82 /* Sets the EUI-48 station address.
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_FORMAT      0x83 /* Returns the NTB format in use,
+                                      * 0=NTB-16, 1=NTB-32. (Optional)
+                                      */
+#define NCM_SET_NTB_FORMAT      0x84 /* Selects the NTB format. (Optional) */
+#define NCM_GET_NTB_INPUT_SIZE  0x85 /* Returns the maximum size of the NTBs
+                                      * sent to the host. (Required)
+                                      */
+#define NCM_SET_NTB_INPUT_SIZE  0x86 /* Selects the maximum size of the NTBs
+                                      * sent to the host. (Required)
+                                      */
+
 /* Descriptors ***************************************************************/
 
 /* Table 25: bDescriptor SubType in Functional Descriptors */
@@ -352,6 +377,7 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
 #define CDC_DSUBTYPE_MBIM       0x1b /* MBIM Functional Descriptor */
                                      /* 0x11-0xff Reserved (future use) */
 
@@ -911,6 +937,26 @@ struct cdc_atm_funcdesc_s
 
 #define SIZEOF_ATM_FUNCDESC 12
 
+/* [CDCNCM1.0] Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;       /* bFunctionLength, Size of this descriptor */
+  uint8_t type;       /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;    /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release of the NCM specification */
+  uint8_t netcaps;    /* bmNetworkCapabilities, See NCMCAP_* */
+};
+
+#define SIZEOF_NCM_FUNCDESC 6
+
+#define NCMCAP_PACKET_FILTER       (1 << 0)  /* SetEthernetPacketFilter */
+#define NCMCAP_NET_ADDRESS         (1 << 1)  /* Get/SetNetAddress */
+#define NCMCAP_ENCAPSULATED        (1 << 2)  /* Encapsulated commands */
+#define NCMCAP_MAX_DATAGRAM        (1 << 3)  /* Get/SetMaxDatagramSize */
+#define NCMCAP_CRC_MODE            (1 << 4)  /* Get/SetCrcMode */
+#define NCMCAP_NTB_INPUT_8BYTE     (1 << 5)  /* 8 byte GetNtbInputSize */
+
 /* Descriptor Data Structures ************************************************/
 
 /* Table 50: Line Coding Structure */
@@ -967,6 +1013,61 @@ struct cdc_unitparm_s
 
 /* Table 61: Power Management Pattern Filter Structure */
 
+/* [CDCNCM1.0] Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparms_s
+{
+  uint8_t len[2];          /* wLength, Size of this structure (28) */
+  uint8_t formats[2];      /* bmNtbFormatsSupported, bit 0: NTB-16 */
+  uint8_t insize[4];       /* dwNtbInMaxSize, Largest NTB to the host */
+  uint8_t indivisor[2];    /* wNdpInDivisor, Datagram alignment modulus */
+  uint8_t inremainder[2];  /* wNdpInPayloadRemainder */
+  uint8_t inalign[2];      /* wNdpInAlignment, NDP alignment */
+  uint8_t reserved[2];
+  uint8_t outsize[4];      /* dwNtbOutMaxSize, Largest NTB from the host */
+  uint8_t outdivisor[2];   /* wNdpOutDivisor */
+  uint8_t outremainder[2]; /* wNdpOutPayloadRemainder */
+  uint8_t outalign[2];     /* wNdpOutAlignment */
+  uint8_t outmaxdgrams[2]; /* wNtbOutMaxDatagrams, 0=No limit */
+};
+
+#define SIZEOF_NCM_NTBPARMS 28
+
+/* [CDCNCM1.0] Table 3-1: 16-bit NCM Transfer Header (NTH16) */
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t sig[4];          /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];       /* wHeaderLength, Size of this header (12) */
+  uint8_t seq[2];          /* wSequence, Incremented for each NTB */
+  uint8_t blklen[2];       /* wBlockLength, Size of the whole NTB */
+  uint8_t ndpindex[2];     /* wNdpIndex, Offset of the first NDP */
+};
+
+#define SIZEOF_NCM_NTH16     12
+#define NCM_NTH16_SIGNATURE  "NCMH"
+
+/* [CDCNCM1.0] Table 3-3: 16-bit NCM Datagram Pointer Table (NDP16), followed
+ * by a zero terminated array of datagram index/length pairs.
+ */
+
+struct cdc_ncm_dpe16_s
+{
+  uint8_t index[2];        /* wDatagramIndex, Offset of the datagram */
+  uint8_t len[2];          /* wDatagramLength, Size of the datagram */
+};
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t sig[4];          /* dwSignature, NCM_NDP16_NOCRC_SIGNATURE */
+  uint8_t len[2];          /* wLength, Size of this NDP, multiple of 4 */
+  uint8_t next[2];         /* wNextNdpIndex, Offset of the next NDP or 0 */
+  struct cdc_ncm_dpe16_s dpe[1];
+};
+
+#define SIZEOF_NCM_NDP16(n)       (8 + 4 * (n))
+#define NCM_NDP16_NOCRC_SIGNATURE "NCM0"
+
 /* Notification Data Structures **********************************************/
 
 /* Table 72: ConnectionSpeedChange Data Structure */
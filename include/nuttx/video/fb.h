@@ -300,6 +300,12 @@
                                               /* Argument: writable struct
                                                *           fb_fix_screeninfo */
 
+#ifdef CONFIG_FB_PANQUEUE
+#  define FBIOGET_BUFFERAGE   _FBIOC(0x001b)  /* Get the age of a buffer
+                                               * Argument: read/write struct
+                                               *           fb_bufferage_s */
+#endif
+
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
 #define FB_TYPE_INTERLEAVED_PLANES   2      /* Interleaved planes */
@@ -518,6 +524,20 @@ struct fb_area_s
   fb_coord_t h;           /* Height of the area */
 };
 
+#ifdef CONFIG_FB_PANQUEUE
+/* This structure describes the age of a buffer: the number of frames since
+ * its content was queued by FBIOPAN_DISPLAY.  An age of 1 means that it
+ * holds the last frame queued, so that only the areas changed since have
+ * to be rendered again.  An age of 0 means that the content is unknown.
+ */
+
+struct fb_bufferage_s
+{
+  uint32_t yoffset;       /* The buffer, as passed to FBIOPAN_DISPLAY */
+  uint32_t age;           /* Returned age of its content */
+};
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
 /* This structure describes the transparency. */
 
@@ -775,7 +795,9 @@ struct fb_vtable_s
 #  endif
 #endif
 
-  /* Pan display for multiple buffers. */
+  /* Pan display for multiple buffers.  With CONFIG_FB_PANQUEUE, this
+   * only notifies the driver of a pan just queued, and may be NULL.
+   */
 
   int (*pandisplay)(FAR struct fb_vtable_s *vtable,
                     FAR struct fb_planeinfo_s *pinfo);
@@ -979,6 +1001,59 @@ void up_fbuninitialize(int display);
 
 void fb_pollnotify(FAR struct fb_vtable_s *vtable);
 
+#ifdef CONFIG_FB_PANQUEUE
+/****************************************************************************
+ * Name: fb_paninfo_count
+ *
+ * Description:
+ *   Return the number of pans waiting for the driver.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+int fb_paninfo_count(FAR struct fb_vtable_s *vtable);
+
+/****************************************************************************
+ * Name: fb_peek_paninfo
+ *
+ * Description:
+ *   Get the oldest pan queued by FBIOPAN_DISPLAY, for the driver to show at
+ *   the vertical sync.  It stays queued until fb_remove_paninfo().  May be
+ *   called from the interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *   pinfo  - The location to return the plane info of the pan.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if there is no pan queued.
+ *
+ ****************************************************************************/
+
+int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
+                    FAR struct fb_planeinfo_s *pinfo);
+
+/****************************************************************************
+ * Name: fb_remove_paninfo
+ *
+ * Description:
+ *   Release the oldest pan once it is displayed, and notify the waiting
+ *   thread that the framebuffer can be written.  May be called from the
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if there is no pan queued.
+ *
+ ****************************************************************************/
+
+int fb_remove_paninfo(FAR struct fb_vtable_s *vtable);
+#endif
+
 /****************************************************************************
  * Name: fb_register
  *
@@ -832,6 +832,23 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* Structure for VIDIOC_EXPBUF.
+ * The driver returns in fd a file descriptor that refers to the MMAP
+ * buffer of the given index.  The buffer can be read or mapped through it,
+ * or handed to another driver, and it stays allocated until the descriptor
+ * is closed.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t             type;      /* enum #v4l2_buf_type */
+  uint32_t             index;     /* Buffer id */
+  uint32_t             plane;     /* Not used, always 0 */
+  uint32_t             flags;     /* O_CLOEXEC is honored */
+  int32_t              fd;        /* Driver returns the file descriptor */
+  uint32_t             reserved[11];
+};
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
@@ -1240,6 +1257,22 @@ int video_initialize(FAR const char *devpath);
 
 int video_uninitialize(void);
 
+#ifdef CONFIG_VIDEO_EXPBUF
+/* Get the memory of a buffer exported by VIDIOC_EXPBUF, for drivers that
+ * consume the frames without copying them.  The memory stays valid as long
+ * as the file descriptor is open.
+ *
+ *  param [in] fd: file descriptor returned by VIDIOC_EXPBUF
+ *  param [out] addr: address of the buffer
+ *  param [out] len: length of the buffer
+ *
+ *  Return on success, 0 is returned. If fd is not an exported buffer,
+ *  -EBADF is returned.
+ */
+
+int video_dmabuf_import(int fd, FAR void **addr, FAR size_t *len);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
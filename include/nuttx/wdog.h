@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/list.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -69,13 +70,21 @@ typedef CODE void (*wdentry_t)(wdparm_t arg);
 
 struct wdog_s
 {
+#ifdef CONFIG_WDOG_WHEEL
+  struct list_node   node;       /* Timing wheel slot list */
+#else
   FAR struct wdog_s *next;       /* Support for singly linked lists. */
+#endif
   wdparm_t           arg;        /* Callback argument */
   wdentry_t          func;       /* Function to execute when delay expires */
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_WHEEL
+  clock_t            expired;    /* Absolute expiration time in ticks */
+#else
   sclock_t           lag;        /* Timer associated with the delay */
+#endif
 };
 
 /****************************************************************************
@@ -166,6 +175,21 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_nextexpire
+ *
+ * Description:
+ *   This function returns the time remaining before the first of the
+ *   active watchdog timers expires.
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires,
+ *   or -1 if no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextexpire(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
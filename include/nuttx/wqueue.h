@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/clock.h>
@@ -57,6 +58,8 @@
  *   priority worker thread.  Default: 224
  * CONFIG_SCHED_HPWORKSTACKSIZE - The stack size allocated for the worker
  *   thread.  Default: 2048.
+ * CONFIG_SCHED_HPWORK_PERCPU - Give each CPU its own high-priority queue
+ *   with CONFIG_SCHED_HPNTHREADS worker threads bound to that CPU.
  *
  * CONFIG_SCHED_LPWORK. If CONFIG_SCHED_LPWORK is selected then a lower-
  *   priority work queue will be created.  This lower priority work queue
@@ -254,7 +257,30 @@ struct work_s
   } u;
   worker_t  worker;         /* Work callback */
   FAR void *arg;            /* Callback argument */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  int8_t    qcpu;           /* CPU of the high-priority queue used */
+  bool      pinned;         /* The work may not run on another CPU */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  unsigned long qstamp;     /* up_perf_gettime() when the work was queued */
+#endif
+};
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+/* Queue-to-start latency histogram of one work queue.  bucket[0] counts
+ * latencies below 1 microsecond, bucket[n] latencies in [2^(n-1), 2^n)
+ * microseconds and the last bucket everything above.
+ */
+
+#define WORK_LATENCY_NBUCKETS 16
+
+struct work_latency_s
+{
+  uint32_t nsamples;                       /* Number of works started */
+  uint32_t max;                            /* Largest latency (usec) */
+  uint32_t bucket[WORK_LATENCY_NBUCKETS];  /* Latency histogram */
 };
+#endif
 
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
@@ -361,6 +387,38 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_affinity
+ *
+ * Description:
+ *   Same as work_queue() but the work is run on the high-priority queue of
+ *   the given CPU and is never taken by the workers of another CPU.  This
+ *   lets a driver process its bottom half on the CPU that took the
+ *   interrupt.  Without CONFIG_SCHED_HPWORK_PERCPU, or for LPWORK, the CPU
+ *   is ignored.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU to run the work on, or -1 for the calling CPU
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_affinity(int qid, FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, int cpu);
+#else
+#  define work_queue_affinity(qid, work, worker, arg, delay, cpu) \
+     work_queue(qid, work, worker, arg, delay)
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -402,6 +460,28 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 void work_foreach(int qid, work_foreach_t handler, FAR void *arg);
 
+/****************************************************************************
+ * Name: work_latency
+ *
+ * Description:
+ *   Return the queue-to-start latency histogram of a work queue.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID
+ *   cpu   - The CPU of a per-CPU high-priority queue, otherwise ignored
+ *   lat   - The location to return the histogram
+ *   reset - Clear the histogram after it has been read
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if there is no such queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+int work_latency(int qid, int cpu, FAR struct work_latency_s *lat,
+                 bool reset);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
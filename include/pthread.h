@@ -357,7 +357,11 @@ typedef struct pthread_barrierattr_s pthread_barrierattr_t;
 
 struct pthread_barrier_s
 {
+#ifdef CONFIG_FUTEX
+  volatile uint32_t state;  /* Futex word:  cycle and arrival count */
+#else
   sem_t        sem;
+#endif
   unsigned int count;
 };
 
@@ -383,11 +387,15 @@ typedef struct pthread_rwlockattr_s pthread_rwlockattr_t;
 
 struct pthread_rwlock_s
 {
+#ifdef CONFIG_FUTEX
+  volatile uint32_t state;  /* Futex word:  readers, writers and waiters */
+#else
   pthread_mutex_t lock;
   pthread_cond_t  cv;
   unsigned int num_readers;
   unsigned int num_writers;
   bool write_in_progress;
+#endif
 };
 
 #ifndef __PTHREAD_RWLOCK_T_DEFINED
@@ -395,9 +403,13 @@ typedef struct pthread_rwlock_s pthread_rwlock_t;
 #  define __PTHREAD_RWLOCK_T_DEFINED 1
 #endif
 
-#define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
-                                     PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+#ifdef CONFIG_FUTEX
+#  define PTHREAD_RWLOCK_INITIALIZER {0}
+#else
+#  define PTHREAD_RWLOCK_INITIALIZER {PTHREAD_MUTEX_INITIALIZER, \
+                                      PTHREAD_COND_INITIALIZER, \
+                                      0, 0, false}
+#endif
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 /* This (non-standard) structure represents a pthread spinlock */
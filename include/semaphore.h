@@ -45,6 +45,13 @@
 
 #define SEM_TYPE_MUTEX            4
 
+/* The count of the semaphore is only modified through the sem_* interfaces
+ * and may be taken/released without the critical section when uncontended
+ * (see CONFIG_SEM_FASTPATH).
+ */
+
+#define SEM_FASTPATH              8
+
 /* Value returned by sem_open() in the event of a failure. */
 
 #define SEM_FAILED                NULL
@@ -53,7 +60,12 @@
  * Public Type Declarations
  ****************************************************************************/
 
-/* This structure contains information about the holder of a semaphore */
+/* This structure contains information about the holder of a semaphore.
+ * The first holder of a semaphore uses the slot built into the semaphore;
+ * further holders of a counting semaphore use one of the slots built into
+ * their own TCB.  Both lists are doubly linked so that a holder is added
+ * and removed in constant time.
+ */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s; /* Forward reference */
@@ -61,30 +73,33 @@ struct sem_s;
 
 struct semholder_s
 {
+  dq_entry_t tlink;               /* List of task held semaphores (first)  */
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *flink;  /* List of semaphore's holder            */
+  dq_entry_t flink;               /* List of semaphore's extra holders     */
 #endif
-  FAR struct semholder_s *tlink;  /* List of task held semaphores          */
   FAR struct sem_s *sem;          /* Ths corresponding semaphore           */
   FAR struct tcb_s *htcb;         /* Ths corresponding TCB                 */
   int16_t counts;                 /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {{NULL, NULL}, {NULL, NULL}, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
-      (h)->flink  = NULL; \
-      (h)->tlink  = NULL; \
+      (h)->tlink.flink = NULL; \
+      (h)->tlink.blink = NULL; \
+      (h)->flink.flink = NULL; \
+      (h)->flink.blink = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
     } while (0)
 #else
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {{NULL, NULL}, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
-      (h)->tlink  = NULL; \
+      (h)->tlink.flink = NULL; \
+      (h)->tlink.blink = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
@@ -110,10 +125,9 @@ struct sem_s
   dq_queue_t waitlist;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
+  struct semholder_s holder;     /* Slot for the first holder */
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
-#  else
-  struct semholder_s holder;     /* Slot for old and new holder */
+  dq_queue_t hlist;              /* Holders beyond the first one */
 #  endif
 #endif
 };
@@ -124,12 +138,13 @@ typedef struct sem_s sem_t;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, holder, hlist */
 
 #    define SEM_INITIALIZER(c) \
-       {(c), 0, SEM_WAITLIST_INITIALIZER, NULL}
+       {(c), 0, SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER, \
+        {NULL, NULL}}
 #  else
-/* semcount, flags, waitlist, holder[2] */
+/* semcount, flags, waitlist, holder */
 
 #    define SEM_INITIALIZER(c) \
        {(c), 0, SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER}
@@ -219,6 +219,9 @@
 #ifdef CONFIG_SIG_EVTHREAD
 #  define SIGEV_THREAD  3 /* A notification function is called */
 #endif
+#ifdef CONFIG_SIG_FASTPATH
+#  define SIGEV_THREAD_ID 4 /* Notify the thread sigev_notify_thread_id */
+#endif
 
 /* Special values of sa_handler used by sigaction and sigset.  They are all
  * treated like NULL for now.  This is okay for SIG_DFL and SIG_IGN because
@@ -285,6 +288,9 @@ struct sigevent
   sigev_notify_function_t sigev_notify_function;      /* Notification function */
   FAR struct pthread_attr_s *sigev_notify_attributes; /* Notification attributes (not used) */
 #endif
+#ifdef CONFIG_SIG_FASTPATH
+  pid_t        sigev_notify_thread_id; /* Thread to notify (SIGEV_THREAD_ID) */
+#endif
 };
 
 /* The following types is used to pass parameters to/from signal handlers */
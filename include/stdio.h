@@ -179,6 +179,19 @@ void flockfile(FAR FILE *stream);
 int ftrylockfile(FAR FILE *stream);
 void funlockfile(FAR FILE *stream);
 
+/* Same as above, for a stream already locked with flockfile() */
+
+int    fgetc_unlocked(FAR FILE *stream);
+int    fputc_unlocked(int c, FAR FILE *stream);
+size_t fread_unlocked(FAR void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+int    getc_unlocked(FAR FILE *stream);
+int    getchar_unlocked(void);
+int    putc_unlocked(int c, FAR FILE *stream);
+int    putchar_unlocked(int c);
+
 /* Operations on the stdout stream, buffers, paths,
  * and the whole printf-family
  */
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * include/sys/futex.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_FUTEX_H
+#define __INCLUDE_SYS_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Futex operations */
+
+#define FUTEX_WAIT          0   /* Block while *uaddr == val */
+#define FUTEX_WAKE          1   /* Wake up at most val waiters on uaddr */
+
+/* The futex word is only shared between the threads of one task group.
+ * This is the only kind of futex supported by NuttX:  the flag is accepted
+ * for compatibility and otherwise ignored.
+ */
+
+#define FUTEX_PRIVATE_FLAG  128
+#define FUTEX_CMD_MASK      (~FUTEX_PRIVATE_FLAG)
+
+#define FUTEX_WAIT_PRIVATE  (FUTEX_WAIT | FUTEX_PRIVATE_FLAG)
+#define FUTEX_WAKE_PRIVATE  (FUTEX_WAKE | FUTEX_PRIVATE_FLAG)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Name: futex
+ *
+ * Description:
+ *   FUTEX_WAIT atomically checks that the 32-bit word at 'uaddr' still
+ *   contains 'val' and, if so, sleeps until it is woken up by FUTEX_WAKE
+ *   on the same address, a signal is received or the relative 'timeout'
+ *   (if not NULL) elapses.
+ *
+ *   FUTEX_WAKE wakes up at most 'val' threads waiting on 'uaddr'.
+ *   'timeout' is ignored.
+ *
+ * Returned Value:
+ *   FUTEX_WAIT returns zero when woken up;  FUTEX_WAKE returns the number
+ *   of threads woken up.  Otherwise -1 is returned with errno set to:
+ *
+ *   EAGAIN    - *uaddr did not contain 'val' at the time of the call.
+ *   ETIMEDOUT - The timeout elapsed before the thread was woken up.
+ *   EINTR     - The wait was interrupted by a signal.
+ *   EINVAL    - 'uaddr' is not aligned or the timeout is invalid.
+ *   ENOSYS    - The operation is not supported.
+ *
+ ****************************************************************************/
+
+int futex(FAR volatile uint32_t *uaddr, int op, uint32_t val,
+          FAR const struct timespec *timeout);
+
+#endif /* CONFIG_FUTEX */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_FUTEX_H */
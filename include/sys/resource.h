@@ -116,6 +116,8 @@ struct rusage
   struct timeval ru_utime;  /* User time used */
   struct timeval ru_stime;  /* System time used */
   long           ru_maxrss; /* maximum resident set size */
+  long           ru_nvcsw;  /* Voluntary context switches */
+  long           ru_nivcsw; /* Involuntary context switches */
 };
 
 /****************************************************************************
@@ -69,6 +69,10 @@ SYSCALL_LOOKUP(sethostname,                2)
   SYSCALL_LOOKUP(getgid,                   0)
 #endif
 
+#ifdef CONFIG_SCHED_RUSAGE
+  SYSCALL_LOOKUP(getrusage,                2)
+#endif
+
 /* Semaphores */
 
 SYSCALL_LOOKUP(nxsem_wait,                 1)
@@ -84,6 +88,12 @@ SYSCALL_LOOKUP(sem_wait,                   1)
   SYSCALL_LOOKUP(sem_setprotocol,          2)
 #endif
 
+/* Futexes */
+
+#ifdef CONFIG_FUTEX
+  SYSCALL_LOOKUP(futex,                    4)
+#endif
+
 /* Named semaphores */
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
@@ -259,6 +269,7 @@ SYSCALL_LOOKUP(utimens,                    2)
 SYSCALL_LOOKUP(lutimens,                   2)
 SYSCALL_LOOKUP(futimens,                   2)
 SYSCALL_LOOKUP(munmap,                     2)
+SYSCALL_LOOKUP(msync,                      3)
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
   SYSCALL_LOOKUP(link,                     2)
@@ -274,6 +285,10 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(nx_mkfifo,                3)
 #endif
 
+#ifdef CONFIG_PIPES
+  SYSCALL_LOOKUP(splice,                   6)
+#endif
+
 #ifdef CONFIG_FILE_STREAM
   SYSCALL_LOOKUP(fs_fdopen,                4)
 #endif
@@ -303,7 +318,9 @@ SYSCALL_LOOKUP(munmap,                     2)
 /* The following are defined if pthreads are enabled */
 
 #ifndef CONFIG_DISABLE_PTHREAD
+#ifndef CONFIG_FUTEX
   SYSCALL_LOOKUP(pthread_barrier_wait,     1)
+#endif
   SYSCALL_LOOKUP(pthread_cancel,           1)
   SYSCALL_LOOKUP(pthread_cond_broadcast,   1)
   SYSCALL_LOOKUP(pthread_cond_signal,      1)
@@ -370,9 +387,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -412,3 +431,9 @@ SYSCALL_LOOKUP(settimeofday,               2)
 /* ANSI C signal handling */
 
 SYSCALL_LOOKUP(signal,                     2)
+
+/* Batched system calls */
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+  SYSCALL_LOOKUP(sysbatch,                 1)
+#endif
@@ -100,6 +100,30 @@ int lib_getfullpath(int dirfd, FAR const char *path,
 
 int lib_mode2oflags(FAR const char *mode);
 
+/* Stream locking by the library itself:  it is skipped once the caller
+ * takes it over with __fsetlocking(FSETLOCKING_BYCALLER).
+ */
+
+#define lib_take_lock(s) \
+  do \
+    { \
+      if (((s)->fs_flags & __FS_FLAG_NOLOCK) == 0) \
+        { \
+          flockfile(s); \
+        } \
+    } \
+  while (0)
+
+#define lib_give_lock(s) \
+  do \
+    { \
+      if (((s)->fs_flags & __FS_FLAG_NOLOCK) == 0) \
+        { \
+          funlockfile(s); \
+        } \
+    } \
+  while (0)
+
 /* Defined in lib_libfwrite.c */
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
@@ -22,8 +22,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/random.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include <nuttx/fs/fs.h>
@@ -39,7 +42,8 @@
  *   Fill a buffer of arbitrary length with randomness. This uses
  *   either /dev/random (if GRND_RANDOM flag) or /dev/urandom device and
  *   is therefore susceptible to things like the attacker exhausting file
- *   descriptors on purpose.
+ *   descriptors on purpose.  If /dev/urandom is backed by the entropy
+ *   pool, the pool is read directly instead.
  *
  * Input Parameters:
  *   bytes  - Buffer for returned random bytes
@@ -65,6 +69,18 @@ ssize_t getrandom(FAR void *bytes, size_t nbytes, unsigned int flags)
   int fd;
   ssize_t ret;
 
+#ifdef CONFIG_DEV_URANDOM_RANDOM_POOL
+  /* This is what /dev/urandom would return, without opening, reading and
+   * closing it.
+   */
+
+  if ((flags & GRND_RANDOM) == 0)
+    {
+      arc4random_buf(bytes, nbytes);
+      return nbytes;
+    }
+#endif
+
   if ((flags & GRND_NONBLOCK) != 0)
     {
       oflags |= O_NONBLOCK;
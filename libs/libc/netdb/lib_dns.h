@@ -76,6 +76,10 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC 0
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -221,7 +225,8 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero to record that the
+ *     hostname does not resolve.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -267,8 +272,9 @@ void dns_clear_answer(void);
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -ENODATA meaning that the cache knows that the
+ *   hostname does not resolve.
  *
  ****************************************************************************/
 
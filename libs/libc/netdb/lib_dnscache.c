@@ -39,7 +39,10 @@
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  Entries
+ * are found through a hash of the name; the entries of one hash bucket are
+ * chained by index.  An entry without addresses records a name that is
+ * known not to resolve.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -47,30 +50,123 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t            ctime;      /* Creation time */
-#endif
+  time_t            expire;     /* Expiration time */
   char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+  uint8_t           next;       /* Next entry of the bucket + 1, or zero */
+  uint8_t           bucket;     /* Hash bucket of the entry */
   uint8_t           naddr;      /* How many addresses per name */
   union dns_addr_u  addr[CONFIG_NETDB_MAX_IPADDR];
-  uint32_t          ttl;
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
 /* This is the DNS resolver cache */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
 
+/* The first entry + 1 of each hash bucket, or zero */
+
+static uint8_t g_dns_hash[CONFIG_NETDB_DNSCLIENT_ENTRIES];
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_cache_hash
+ *
+ * Description:
+ *   Return the hash bucket of 'hostname'.  Only the part of the name that
+ *   is compared is hashed.
+ *
+ ****************************************************************************/
+
+static unsigned int dns_cache_hash(FAR const char *hostname)
+{
+  uint32_t hash = 5381;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0';
+       i++)
+    {
+      hash = hash * 33 + (uint8_t)hostname[i];
+    }
+
+  return hash % CONFIG_NETDB_DNSCLIENT_ENTRIES;
+}
+
+/****************************************************************************
+ * Name: dns_cache_now
+ *
+ * Description:
+ *   Return the current monotonic time in seconds.
+ *
+ ****************************************************************************/
+
+static time_t dns_cache_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_cache_lookup
+ *
+ * Description:
+ *   Return the index of the entry of 'hostname' in the hash bucket
+ *   'bucket', or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int dns_cache_lookup(FAR const char *hostname, unsigned int bucket)
+{
+  int ndx;
+
+  for (ndx = g_dns_hash[bucket] - 1; ndx >= 0;
+       ndx = g_dns_cache[ndx].next - 1)
+    {
+      /* Because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
+       * this has the possibility of aliasing two names and returning the
+       * wrong entry from the cache.
+       */
+
+      if (strncmp(hostname, g_dns_cache[ndx].name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          return ndx;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: dns_cache_remove
+ *
+ * Description:
+ *   Unlink the entry 'ndx' from its hash bucket and mark it free.
+ *
+ ****************************************************************************/
+
+static void dns_cache_remove(int ndx)
+{
+  FAR struct dns_cache_s *entry = &g_dns_cache[ndx];
+  FAR uint8_t *link = &g_dns_hash[entry->bucket];
+
+  while (*link != ndx + 1)
+    {
+      DEBUGASSERT(*link != 0);
+      link = &g_dns_cache[*link - 1].next;
+    }
+
+  *link          = entry->next;
+  entry->name[0] = '\0';
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -84,7 +180,8 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero to record that the
+ *     hostname does not resolve.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -97,62 +194,73 @@ void dns_save_answer(FAR const char *hostname,
                      uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  unsigned int bucket;
+  time_t now;
   int ndx;
+  int i;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
-
-  /* Get exclusive access to the DNS cache */
-
-  dns_lock();
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
 
-  /* Get the index to the new head of the list */
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  ttl = MIN(ttl, CONFIG_NETDB_DNSCLIENT_LIFESEC);
+#endif
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  if (ttl == 0 || hostname[0] == '\0')
     {
-      next = 0;
+      return;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  bucket = dns_cache_hash(hostname);
+  now    = dns_cache_now();
+
+  /* Get exclusive access to the DNS cache */
+
+  dns_lock();
+
+  /* Replace the entry of the same name, or else take a free entry, or
+   * else the entry that expires first.
    */
 
-  if (next == g_dns_tail)
+  ndx = dns_cache_lookup(hostname, bucket);
+  if (ndx < 0)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      ndx = 0;
+      for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
         {
-          tmp = 0;
-        }
+          entry = &g_dns_cache[i];
+          if (entry->name[0] == '\0' || entry->expire <= now)
+            {
+              ndx = i;
+              break;
+            }
 
-      g_dns_tail = tmp;
+          if (entry->expire < g_dns_cache[ndx].expire)
+            {
+              ndx = i;
+            }
+        }
     }
 
-  /* Save the answer in the cache */
-
   entry = &g_dns_cache[ndx];
+  if (entry->name[0] != '\0')
+    {
+      dns_cache_remove(ndx);
+    }
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  /* Save the answer in the cache */
 
   strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
-  entry->naddr = naddr;
-  entry->ttl = ttl;
+  entry->naddr  = naddr;
+  entry->expire = now + ttl;
 
-  /* Save the updated head index */
+  /* And link it into its hash bucket */
+
+  entry->bucket      = bucket;
+  entry->next        = g_dns_hash[bucket];
+  g_dns_hash[bucket] = ndx + 1;
 
-  g_dns_head = next;
   dns_unlock();
 }
 
@@ -169,14 +277,19 @@ void dns_save_answer(FAR const char *hostname,
 
 void dns_clear_answer(void)
 {
+  int i;
+
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Reset the circular of DNS cache */
+  /* Empty all hash buckets and entries */
 
-  g_dns_head = 0;
-  g_dns_tail = 0;
+  memset(g_dns_hash, 0, sizeof(g_dns_hash));
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
+    {
+      g_dns_cache[i].name[0] = '\0';
+    }
 
   dns_unlock();
 }
@@ -198,8 +311,9 @@ void dns_clear_answer(void)
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -ENODATA meaning that the cache knows that the
+ *   hostname does not resolve.
  *
  ****************************************************************************/
 
@@ -207,86 +321,44 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
+  int ret = -ENOENT;
+  time_t now;
   int ndx;
 
+  now = dns_cache_now();
+
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  ret = clock_gettime(CLOCK_MONOTONIC, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  ndx = dns_cache_lookup(hostname, dns_cache_hash(hostname));
+  if (ndx >= 0)
     {
       entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
-
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (entry->expire <= now)
         {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
+          /* This entry has expired, drop it */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 &&
-          (elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC || elapsed > entry->ttl))
+          dns_cache_remove(ndx);
+        }
+      else if (entry->naddr == 0)
         {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
+          /* The hostname is known not to resolve */
 
-          g_dns_tail = next;
+          ret = -ENODATA;
         }
       else
-#endif
         {
-          /* The entry has not expired, check for a name match. Because
-           * the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
+          /* We have a match.  Return the resolved host address, making
+           * sure that it will fit in the caller-provided buffer.
            */
 
-          if (strncmp(hostname, entry->name,
-                      CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
-
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_unlock();
-              return OK;
-            }
+          *naddr = MIN(*naddr, entry->naddr);
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          ret = OK;
         }
     }
 
-  ret = -ENOENT;
-
   dns_unlock();
   return ret;
 }
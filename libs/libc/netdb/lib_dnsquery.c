@@ -48,7 +48,9 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
+#include <poll.h>
 #include <time.h>
 #include <unistd.h>
 #include <errno.h>
@@ -57,6 +59,7 @@
 
 #include <arpa/inet.h>
 
+#include <nuttx/lib/lib.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/dns.h>
 
@@ -80,19 +83,20 @@
 #define SEND_BUFFER_SIZE (16 + CONFIG_NETDB_DNSCLIENT_NAMESIZE + 2)
 #define RECV_BUFFER_SIZE CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 
+/* The record types queried: AAAA first, so that IPv6 addresses are
+ * returned first.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NRECTYPES 2
+#else
+#  define DNS_NRECTYPES 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-struct dns_query_s
-{
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
-  uint32_t ttl;                   /* Time to Live, unit:s */
-};
-
 /* Query info to check response against. */
 
 struct dns_query_info_s
@@ -104,6 +108,40 @@ struct dns_query_info_s
                                                     * encoded format + NUL */
 };
 
+/* A name resolution in progress.  A round of queries is sent to up to
+ * CONFIG_NETDB_DNSCLIENT_PARALLEL name servers at once, one socket per
+ * name server and record type: the socket of fds[i] queries the record
+ * type i % DNS_NRECTYPES.  The first answer for a record type wins and the
+ * other queries of that type are abandoned.
+ */
+
+struct dns_resolve_s
+{
+  char hostname[CONFIG_NETDB_DNSCLIENT_NAMESIZE + 1];
+  int result;                     /* -EAGAIN while in progress */
+  int error;                      /* Explanation of the last failure */
+  int status[DNS_NRECTYPES];      /* >0 pending, 0 resolved, <0 no answer */
+  uint8_t naddr[DNS_NRECTYPES];   /* Addresses received per record type */
+  uint8_t ntotal;                 /* Addresses in addr[] when completed */
+  uint8_t nfds;                   /* Sockets of the current round */
+  uint8_t server;                 /* First name server of the round */
+  uint8_t retries;                /* Retries of the round */
+  uint32_t ttl;                   /* Smallest TTL of the answers */
+  uint32_t deadline;              /* End of the round in milliseconds */
+  struct pollfd fds[DNS_RESOLVE_MAXFDS];
+  struct dns_query_info_s qinfo[DNS_RESOLVE_MAXFDS];
+  union dns_addr_u addr[DNS_NRECTYPES * CONFIG_NETDB_MAX_IPADDR];
+};
+
+/* Arguments of dns_resolve_server() */
+
+struct dns_round_s
+{
+  FAR struct dns_resolve_s *req;
+  int skip;                       /* Name servers still to be skipped */
+  int nservers;                   /* Name servers queried */
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -327,7 +365,7 @@ static int dns_send_query(int sd, FAR const char *name,
 
 static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
                              FAR struct dns_query_info_s *qinfo,
-                             uint32_t *ttl)
+                             uint32_t *ttl, int flags)
 {
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
@@ -349,11 +387,15 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   /* Receive the response */
 
-  ret = recv(sd, buffer, RECV_BUFFER_SIZE, 0);
+  ret = recv(sd, buffer, RECV_BUFFER_SIZE, flags);
   if (ret < 0)
     {
       ret = -get_errno();
-      nerr("ERROR: recv failed: %d\n", ret);
+      if (ret != -EAGAIN)
+        {
+          nerr("ERROR: recv failed: %d\n", ret);
+        }
+
       return ret;
     }
 
@@ -380,6 +422,13 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
+        {
+          /* The name does not exist */
+
+          return -ENOENT;
+        }
+
       return -EPROTO;
     }
 
@@ -560,143 +609,550 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 }
 
 /****************************************************************************
- * Name: dns_query_callback
+ * Name: dns_resolve_rectype
+ *
+ * Description:
+ *   Return the record type queried by the sockets of index 'r'.
+ *
+ ****************************************************************************/
+
+static inline uint16_t dns_resolve_rectype(int r)
+{
+#ifdef CONFIG_NET_IPv6
+  if (r == 0)
+    {
+      return DNS_RECTYPE_AAAA;
+    }
+#endif
+
+  return DNS_RECTYPE_A;
+}
+
+/****************************************************************************
+ * Name: dns_resolve_now
+ *
+ * Description:
+ *   Return the current monotonic time in milliseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_resolve_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: dns_resolve_timeout
+ *
+ * Description:
+ *   Return the milliseconds left in the current round.
+ *
+ ****************************************************************************/
+
+static int dns_resolve_timeout(FAR struct dns_resolve_s *req)
+{
+  int32_t remain = req->deadline - dns_resolve_now();
+
+  return MAX(remain, 0);
+}
+
+/****************************************************************************
+ * Name: dns_resolve_close
+ *
+ * Description:
+ *   Close the sockets of the record type of index 'r', or all sockets if
+ *   'r' is negative.
+ *
+ ****************************************************************************/
+
+static void dns_resolve_close(FAR struct dns_resolve_s *req, int r)
+{
+  int i;
+
+  for (i = 0; i < req->nfds; i++)
+    {
+      if (req->fds[i].fd >= 0 && (r < 0 || i % DNS_NRECTYPES == r))
+        {
+          close(req->fds[i].fd);
+          req->fds[i].fd = -1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dns_resolve_server
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Send the pending queries to this DNS server, after the name servers of
+ *   the previous rounds have been skipped.
  *
  * Input Parameters:
- *   arg      - Query arguments
+ *   arg      - The round of queries
  *   addr     - DNS name server address
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   One (1) to stop the traversal once CONFIG_NETDB_DNSCLIENT_PARALLEL
+ *   name servers were queried; zero otherwise.
  *
  ****************************************************************************/
 
-static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
+static int dns_resolve_server(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
-  FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-  FAR struct dns_query_info_s qinfo;
-  int next = 0;
-  int retries;
+  FAR struct dns_round_s *round = (FAR struct dns_round_s *)arg;
+  FAR struct dns_resolve_s *req = round->req;
+  int base;
   int ret;
   int sd;
+  int r;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
-   */
+  if (round->skip > 0)
+    {
+      round->skip--;
+      return 0;
+    }
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  base = round->nservers * DNS_NRECTYPES;
+  for (r = 0; r < DNS_NRECTYPES; r++)
     {
-#ifdef CONFIG_NET_IPv6
-      /* Send the IPv6 query */
+      req->fds[base + r].fd      = -1;
+      req->fds[base + r].events  = POLLIN;
+      req->fds[base + r].revents = 0;
+
+      if (req->status[r] <= 0)
+        {
+          continue;
+        }
 
       sd = dns_bind(addr->sa_family);
       if (sd < 0)
         {
-          query->result = sd;
-          return 0;
+          req->error = sd;
+          continue;
         }
 
-      ret = dns_send_query(sd, query->hostname,
-                          (FAR union dns_addr_u *)addr,
-                           DNS_RECTYPE_AAAA, &qinfo);
+      ret = dns_send_query(sd, req->hostname, (FAR union dns_addr_u *)addr,
+                           dns_resolve_rectype(r), &req->qinfo[base + r]);
       if (ret < 0)
         {
-          nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-          query->result = ret;
+          nerr("ERROR: dns_send_query failed: %d\n", ret);
+          req->error = ret;
+          close(sd);
+          continue;
         }
-      else
+
+      req->fds[base + r].fd = sd;
+    }
+
+  round->nservers++;
+  return round->nservers >= CONFIG_NETDB_DNSCLIENT_PARALLEL ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: dns_resolve_round
+ *
+ * Description:
+ *   Send the pending queries to the next name servers, starting with the
+ *   name server of index req->server.
+ *
+ * Returned Value:
+ *   Zero (OK) if queries were sent; a negated errno value if there are no
+ *   more name servers.
+ *
+ ****************************************************************************/
+
+static int dns_resolve_round(FAR struct dns_resolve_s *req)
+{
+  struct dns_round_s round;
+  int ret;
+
+  round.req      = req;
+  round.skip     = req->server;
+  round.nservers = 0;
+
+  ret = dns_foreach_nameserver(dns_resolve_server, &round);
+  req->nfds     = round.nservers * DNS_NRECTYPES;
+  req->deadline = dns_resolve_now() +
+                  CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT * 1000;
+
+  if (round.nservers == 0)
+    {
+      if (ret < 0)
         {
-          /* Obtain the IPv6 response */
+          req->error = ret;
+        }
 
-          ret = dns_recv_response(sd, &query->addr[next],
-                                  *query->naddr - next, &qinfo, &query->ttl);
-          if (ret >= 0)
-            {
-              next += ret;
-            }
-          else
-            {
-              nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
-              query->result = ret;
-            }
+      return -ENOENT;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dns_resolve_complete
+ *
+ * Description:
+ *   Collect the addresses received and complete the resolution, saving the
+ *   answer in the DNS cache.
+ *
+ ****************************************************************************/
+
+static int dns_resolve_complete(FAR struct dns_resolve_s *req)
+{
+  bool negative = true;
+  int n = 0;
+  int r;
+
+  for (r = 0; r < DNS_NRECTYPES; r++)
+    {
+      if (req->status[r] == 0)
+        {
+          memmove(&req->addr[n], &req->addr[r * CONFIG_NETDB_MAX_IPADDR],
+                  req->naddr[r] * sizeof(union dns_addr_u));
+          n += req->naddr[r];
         }
 
-      close(sd);
+      negative &= req->status[r] < 0;
+    }
+
+  req->ntotal = n;
+  if (n > 0)
+    {
+      req->result = OK;
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Save the answer in the DNS cache */
+
+      dns_save_answer(req->hostname, req->addr, n, req->ttl);
+#endif
+    }
+  else if (negative)
+    {
+      /* The name servers answered that there is no such name or address */
+
+      req->result = req->status[0];
+#if CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC > 0
+      dns_save_answer(req->hostname, NULL, 0,
+                      CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC);
 #endif
+    }
+  else
+    {
+      req->result = req->error;
+    }
 
-#ifdef CONFIG_NET_IPv4
-      /* Send the IPv4 query */
+  return req->result;
+}
 
-      sd = dns_bind(addr->sa_family);
-      if (sd < 0)
+/****************************************************************************
+ * Name: dns_resolve_init
+ *
+ * Description:
+ *   Start the resolution of 'hostname' with the first round of queries.
+ *
+ ****************************************************************************/
+
+static void dns_resolve_init(FAR struct dns_resolve_s *req,
+                             FAR const char *hostname)
+{
+  int r;
+
+  memset(req, 0, sizeof(*req));
+  strlcpy(req->hostname, hostname, sizeof(req->hostname));
+
+  req->result = -EAGAIN;
+  req->error  = -EADDRNOTAVAIL;
+  req->ttl    = UINT32_MAX;
+
+  for (r = 0; r < DNS_NRECTYPES; r++)
+    {
+      req->status[r] = 1;
+    }
+
+  if (dns_resolve_round(req) < 0)
+    {
+      dns_resolve_complete(req);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dns_resolve_process
+ *
+ * Description:
+ *   Receive the answers to the queries, and start new queries if those
+ *   failed or timed out.
+ *
+ * Returned Value:
+ *   -EAGAIN while the resolution is in progress.  Otherwise zero (OK) if
+ *   the hostname was resolved, or a negated errno value.
+ *
+ ****************************************************************************/
+
+int dns_resolve_process(FAR struct dns_resolve_s *req)
+{
+  bool resolved = false;
+  bool pending = false;
+  uint32_t ttl;
+  int ret;
+  int i;
+  int r;
+
+  if (req->result != -EAGAIN)
+    {
+      return req->result;
+    }
+
+  for (i = 0; i < req->nfds; i++)
+    {
+      if (req->fds[i].fd < 0)
         {
-          query->result = sd;
-          return 0;
+          continue;
         }
 
-      ret = dns_send_query(sd, query->hostname,
-                           (FAR union dns_addr_u *)addr,
-                           DNS_RECTYPE_A, &qinfo);
-      if (ret < 0)
+      r   = i % DNS_NRECTYPES;
+      ret = dns_recv_response(req->fds[i].fd,
+                              &req->addr[r * CONFIG_NETDB_MAX_IPADDR],
+                              CONFIG_NETDB_MAX_IPADDR, &req->qinfo[i],
+                              &ttl, MSG_DONTWAIT);
+      if (ret == -EAGAIN)
         {
-          nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-          query->result = ret;
+          continue;
+        }
+
+      close(req->fds[i].fd);
+      req->fds[i].fd = -1;
+
+      if (ret > 0)
+        {
+          /* The first answer wins, the other name servers are not waited
+           * for.
+           */
+
+          req->status[r] = 0;
+          req->naddr[r]  = ret;
+          req->ttl       = MIN(req->ttl, ttl);
+          dns_resolve_close(req, r);
+        }
+      else if (ret == -ENOENT || ret == -EADDRNOTAVAIL)
+        {
+          /* No such name, or no address of this type */
+
+          req->status[r] = ret;
+          dns_resolve_close(req, r);
         }
       else
         {
-          /* Obtain the IPv4 response */
+          nerr("ERROR: dns_recv_response failed: %d\n", ret);
+          req->error = ret;
+        }
+    }
 
-          ret = dns_recv_response(sd, &query->addr[next],
-                                  *query->naddr - next, &qinfo, &query->ttl);
-          if (ret >= 0)
-            {
-              next += ret;
-            }
-          else
+  /* Give up on the name servers that did not answer in time */
+
+  if (dns_resolve_timeout(req) == 0)
+    {
+      for (i = 0; i < req->nfds; i++)
+        {
+          if (req->fds[i].fd >= 0)
             {
-              nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
-              query->result = ret;
+              req->error = -EAGAIN;
             }
         }
 
-      close(sd);
-#endif /* CONFIG_NET_IPv4 */
+      dns_resolve_close(req, -1);
+    }
+
+  for (i = 0; i < req->nfds; i++)
+    {
+      if (req->fds[i].fd >= 0)
+        {
+          return -EAGAIN;
+        }
+    }
+
+  /* The round is over.  Unless some address was found, query the record
+   * types still pending again: the same name servers if they timed out,
+   * otherwise the next ones.
+   */
+
+  for (r = 0; r < DNS_NRECTYPES; r++)
+    {
+      resolved |= req->status[r] == 0;
+      pending  |= req->status[r] > 0;
+    }
+
+  if (!resolved && pending)
+    {
+      if (req->error == -EAGAIN &&
+          ++req->retries < CONFIG_NETDB_DNSCLIENT_RETRIES)
+        {
+          ninfo("Retrying %s\n", req->hostname);
+        }
+      else
+        {
+          req->server += req->nfds / DNS_NRECTYPES;
+          req->retries = 0;
+        }
 
-      if (next > 0)
+      if (dns_resolve_round(req) >= 0)
         {
+          return -EAGAIN;
+        }
+    }
+
+  return dns_resolve_complete(req);
+}
+
+/****************************************************************************
+ * Name: dns_resolve_start
+ *
+ * Description:
+ *   Start to resolve 'hostname' without blocking.
+ *
+ * Input Parameters:
+ *   hostname - The hostname string to be resolved.
+ *   handle   - The location to return the handle of the resolution.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dns_resolve_start(FAR const char *hostname,
+                      FAR struct dns_resolve_s **handle)
+{
+  FAR struct dns_resolve_s *req;
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  int naddr;
+  int ret;
+#endif
+
+  req = lib_malloc(sizeof(*req));
+  if (req == NULL)
+    {
+      return -ENOMEM;
+    }
+
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-          /* Save the answer in the DNS cache */
+  /* Complete at once with the answer from the cache, if any */
 
-          dns_save_answer(query->hostname, query->addr, next, query->ttl);
+  memset(req, 0, sizeof(*req));
+  naddr = nitems(req->addr);
+  ret   = dns_find_answer(hostname, req->addr, &naddr);
+  if (ret != -ENOENT)
+    {
+      req->result = ret;
+      req->ntotal = ret < 0 ? 0 : naddr;
+      *handle     = req;
+      return OK;
+    }
 #endif
-          /* Return 1 to indicate to (1) stop the traversal, and (2)
-           * indicate that the address was found.
-           */
 
-          *query->naddr = next;
-          return 1;
-        }
-      else if (query->result != -EAGAIN)
+  dns_resolve_init(req, hostname);
+  *handle = req;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dns_resolve_pollfds
+ *
+ * Description:
+ *   Return the descriptors to wait on for POLLIN, and the time in
+ *   milliseconds to wait at most.
+ *
+ * Returned Value:
+ *   The number of descriptors placed in 'fds', or -EINVAL if 'nfds' is too
+ *   small.
+ *
+ ****************************************************************************/
+
+int dns_resolve_pollfds(FAR struct dns_resolve_s *req,
+                        FAR struct pollfd *fds, int nfds,
+                        FAR int *timeout)
+{
+  int n = 0;
+  int i;
+
+  *timeout = 0;
+  if (req->result != -EAGAIN)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < req->nfds; i++)
+    {
+      if (req->fds[i].fd >= 0)
         {
-          break;
+          if (n >= nfds)
+            {
+              return -EINVAL;
+            }
+
+          memset(&fds[n], 0, sizeof(fds[n]));
+          fds[n].fd     = req->fds[i].fd;
+          fds[n].events = POLLIN;
+          n++;
         }
     }
 
-  return 0;
+  if (n > 0)
+    {
+      *timeout = dns_resolve_timeout(req);
+    }
+
+  return n;
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: dns_resolve_finish
+ *
+ * Description:
+ *   Return the result of the resolution and free the handle.
+ *
+ * Input Parameters:
+ *   req   - The handle returned by dns_resolve_start().
+ *   addr  - The location to return the addresses, or NULL.
+ *   naddr - On entry, the count of addresses backing up the 'addr'
+ *     pointer.  On return, this location will hold the actual count of
+ *     the returned addresses.
+ *
+ * Returned Value:
+ *   As dns_resolve_process(), or -ECANCELED if the resolution was still in
+ *   progress.
+ *
  ****************************************************************************/
 
+int dns_resolve_finish(FAR struct dns_resolve_s *req,
+                       FAR struct sockaddr_storage *addr, FAR int *naddr)
+{
+  int ret = req->result;
+  int i;
+
+  if (ret == -EAGAIN)
+    {
+      dns_resolve_close(req, -1);
+      ret = -ECANCELED;
+    }
+  else if (ret == OK && addr != NULL)
+    {
+      *naddr = MIN(*naddr, req->ntotal);
+      for (i = 0; i < *naddr; i++)
+        {
+          memcpy(&addr[i], &req->addr[i], sizeof(union dns_addr_u));
+        }
+    }
+
+  lib_free(req);
+  return ret;
+}
+
 /****************************************************************************
  * Name: dns_query
  *
@@ -720,33 +1176,29 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
 int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
-  FAR struct dns_query_s query;
+  struct dns_resolve_s req;
   int ret;
 
-  /* Set up the query info structure */
-
-  query.result   = -EADDRNOTAVAIL;
-  query.hostname = hostname;
-  query.addr     = addr;
-  query.naddr    = naddr;
-
-  /* Perform the query. dns_foreach_nameserver() will return:
-   *
-   *  1 - The query was successful.
-   *  0 - Look up failed
-   * <0 - Some other failure (?, shouldn't happen)
+  /* Run the same resolution as dns_resolve_start(), waiting on its
+   * sockets here.
    */
 
-  ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  dns_resolve_init(&req, hostname);
+  while ((ret = dns_resolve_process(&req)) == -EAGAIN)
     {
-      /* The lookup was successful */
-
-      ret = OK;
+      ret = poll(req.fds, req.nfds, dns_resolve_timeout(&req));
+      if (ret < 0 && get_errno() != EINTR)
+        {
+          ret = -get_errno();
+          dns_resolve_close(&req, -1);
+          return ret;
+        }
     }
-  else if (ret == 0)
+
+  if (ret == OK)
     {
-      ret = query.result;
+      *naddr = MIN(*naddr, req.ntotal);
+      memcpy(addr, req.addr, *naddr * sizeof(*addr));
     }
 
   return ret;
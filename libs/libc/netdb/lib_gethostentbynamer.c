@@ -705,6 +705,10 @@ int gethostentbyname_r(FAR const char *name,
                        FAR struct hostent_s *host, FAR char *buf,
                        size_t buflen, FAR int *h_errnop, int flags)
 {
+#if defined(CONFIG_NETDB_DNSCLIENT) && CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  int ret;
+#endif
+
   DEBUGASSERT(name != NULL && host != NULL && buf != NULL);
 
   /* Make sure that the h_errno has a non-error code */
@@ -760,21 +764,27 @@ int gethostentbyname_r(FAR const char *name,
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
   /* Check if we already have this hostname mapping cached */
 
-  if (lib_find_answer(name, host, buf, buflen) >= 0)
+  ret = lib_find_answer(name, host, buf, buflen);
+  if (ret >= 0)
     {
       /* Found the address mapping in the cache */
 
       return OK;
     }
-#endif
 
-  /* Try to get the host address using the DNS name server */
+  /* A hostname cached as not resolving is not queried again */
 
-  if (lib_dns_lookup(name, host, buf, buflen) >= 0)
+  if (ret != -ENODATA)
+#endif
     {
-      /* Successful DNS lookup! */
+      /* Try to get the host address using the DNS name server */
 
-      return OK;
+      if (lib_dns_lookup(name, host, buf, buflen) >= 0)
+        {
+          /* Successful DNS lookup! */
+
+          return OK;
+        }
     }
 #endif /* CONFIG_NETDB_DNSCLIENT */
 
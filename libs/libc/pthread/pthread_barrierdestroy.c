@@ -29,6 +29,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_futex.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -61,13 +63,25 @@
 
 int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
 {
+#ifndef CONFIG_FUTEX
   int semcount;
+#endif
   int ret = OK;
 
   if (!barrier)
     {
       ret = EINVAL;
     }
+#ifdef CONFIG_FUTEX
+  else if ((barrier->state & BARRIER_ARRIVED_MASK) != 0)
+    {
+      ret = EBUSY;
+    }
+  else
+    {
+      barrier->count = 0;
+    }
+#else
   else
     {
       ret = sem_getvalue(&barrier->sem, &semcount);
@@ -84,6 +98,7 @@ int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
       sem_destroy(&barrier->sem);
       barrier->count = 0;
     }
+#endif
 
   return ret;
 }
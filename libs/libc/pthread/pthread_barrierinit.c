@@ -29,6 +29,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_futex.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,11 +83,23 @@ int pthread_barrier_init(FAR pthread_barrier_t *barrier,
     {
       ret = EINVAL;
     }
+#ifdef CONFIG_FUTEX
+  else if (count > BARRIER_ARRIVED_MASK)
+    {
+      ret = EINVAL;
+    }
+  else
+    {
+      barrier->state = 0;
+      barrier->count = count;
+    }
+#else
   else
     {
       sem_init(&barrier->sem, 0, 0);
       barrier->count = count;
     }
+#endif
 
   return ret;
 }
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/futex.h>
+#include <nuttx/clock.h>
+
+#include "pthread/pthread_futex.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_futex_wait
+ ****************************************************************************/
+
+int pthread_futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+                       clockid_t clockid, FAR const struct timespec *abstime)
+{
+  FAR const struct timespec *reltime = NULL;
+  struct timespec remaining;
+  struct timespec now;
+  int ret = OK;
+
+  if (abstime != NULL)
+    {
+      if (abstime->tv_nsec < 0 || abstime->tv_nsec >= NSEC_PER_SEC)
+        {
+          return EINVAL;
+        }
+
+      clock_gettime(clockid, &now);
+      clock_timespec_subtract(abstime, &now, &remaining);
+      reltime = &remaining;
+    }
+
+  /* EAGAIN (the word changed) and EINTR are just spurious wake-ups here */
+
+  if (futex(uaddr, FUTEX_WAIT_PRIVATE, val, reltime) < 0 &&
+      get_errno() == ETIMEDOUT)
+    {
+      ret = ETIMEDOUT;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pthread_futex_wake
+ ****************************************************************************/
+
+void pthread_futex_wake(FAR volatile uint32_t *uaddr)
+{
+  futex(uaddr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_block
+ ****************************************************************************/
+
+int pthread_rwlock_block(FAR pthread_rwlock_t *rw_lock, uint32_t busy,
+                         clockid_t clockid,
+                         FAR const struct timespec *abstime)
+{
+  uint32_t state = rw_lock->state;
+
+  /* Let the caller retry if the lock was released in the meantime */
+
+  if ((state & busy) == 0)
+    {
+      return OK;
+    }
+
+  /* Tell the thread releasing the lock that it has to call futex() */
+
+  if ((state & RWLOCK_WAITERS) == 0)
+    {
+      if (!__atomic_compare_exchange_n(&rw_lock->state, &state,
+                                       state | RWLOCK_WAITERS, false,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+          return OK;
+        }
+
+      state |= RWLOCK_WAITERS;
+    }
+
+  return pthread_futex_wait(&rw_lock->state, state, clockid, abstime);
+}
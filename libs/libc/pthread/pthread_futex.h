@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_futex.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_PTHREAD_PTHREAD_FUTEX_H
+#define __LIBS_LIBC_PTHREAD_PTHREAD_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of the futex word of a read/write lock:
+ *
+ *   bits  0-19  Number of readers holding the lock
+ *   bits 20-29  Number of writers waiting for the lock
+ *   bit     30  Threads may be blocked in futex() on this word
+ *   bit     31  The lock is held by a writer
+ *
+ * Any change of the lock state modifies the word, so a thread that
+ * decided to block never misses the event it is waiting for.
+ */
+
+#define RWLOCK_READER         0x00000001u
+#define RWLOCK_READERS_MASK   0x000fffffu
+#define RWLOCK_WRWAIT         0x00100000u
+#define RWLOCK_WRWAIT_MASK    0x3ff00000u
+#define RWLOCK_WAITERS        0x40000000u
+#define RWLOCK_WRITER         0x80000000u
+
+/* Layout of the futex word of a barrier:  the upper half counts the
+ * completed cycles and the lower half the threads that arrived in the
+ * current cycle.
+ */
+
+#define BARRIER_ARRIVED_MASK  0x0000ffffu
+#define BARRIER_CYCLE_SHIFT   16
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_futex_wait
+ *
+ * Description:
+ *   Block on the futex word while it contains 'val', until the absolute
+ *   time 'abstime' of 'clockid' if it is not NULL.  The caller must
+ *   re-evaluate the word on return:  wake-ups may be spurious.
+ *
+ * Returned Value:
+ *   Zero, ETIMEDOUT if the absolute time was reached or EINVAL if it is
+ *   not valid.
+ *
+ ****************************************************************************/
+
+int pthread_futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+                       clockid_t clockid, FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: pthread_futex_wake
+ *
+ * Description:
+ *   Wake up all threads blocked on the futex word.
+ *
+ ****************************************************************************/
+
+void pthread_futex_wake(FAR volatile uint32_t *uaddr);
+
+/****************************************************************************
+ * Name: pthread_rwlock_block
+ *
+ * Description:
+ *   Block the caller until the read/write lock changes state if any of
+ *   the 'busy' bits of the lock word is set, flagging the word as having
+ *   waiters first.  The caller must retry to take the lock on return.
+ *
+ * Returned Value:
+ *   Zero, ETIMEDOUT or EINVAL (invalid 'abstime').
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_block(FAR pthread_rwlock_t *rw_lock, uint32_t busy,
+                         clockid_t clockid,
+                         FAR const struct timespec *abstime);
+
+#endif /* CONFIG_FUTEX */
+#endif /* __LIBS_LIBC_PTHREAD_PTHREAD_FUTEX_H */
@@ -29,10 +29,68 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_futex.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_FUTEX
+int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
+                        FAR const pthread_rwlockattr_t *attr)
+{
+  if (attr != NULL)
+    {
+      return ENOSYS;
+    }
+
+  lock->state = 0;
+  return OK;
+}
+
+int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
+{
+  return lock->state != 0 ? EBUSY : OK;
+}
+
+int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state = rw_lock->state;
+  uint32_t newstate;
+
+  do
+    {
+      if ((state & RWLOCK_WRITER) != 0)
+        {
+          newstate = state & ~(RWLOCK_WRITER | RWLOCK_WAITERS);
+        }
+      else if ((state & RWLOCK_READERS_MASK) != 0)
+        {
+          /* Only the last reader has something to hand over */
+
+          newstate = state - RWLOCK_READER;
+          if ((newstate & RWLOCK_READERS_MASK) == 0)
+            {
+              newstate &= ~RWLOCK_WAITERS;
+            }
+        }
+      else
+        {
+          return EINVAL;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state, newstate,
+                                      false, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED));
+
+  if ((state & RWLOCK_WAITERS) != 0 && (newstate & RWLOCK_WAITERS) == 0)
+    {
+      pthread_futex_wake(&rw_lock->state);
+    }
+
+  return OK;
+}
+#else
 int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
                         FAR const pthread_rwlockattr_t *attr)
 {
@@ -109,3 +167,4 @@ int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
+#endif /* CONFIG_FUTEX */
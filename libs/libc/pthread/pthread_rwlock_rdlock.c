@@ -29,10 +29,38 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_futex.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_FUTEX
+static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state = rw_lock->state;
+
+  do
+    {
+      /* Waiting writers take precedence over new readers */
+
+      if ((state & (RWLOCK_WRITER | RWLOCK_WRWAIT_MASK)) != 0)
+        {
+          return EBUSY;
+        }
+
+      if ((state & RWLOCK_READERS_MASK) == RWLOCK_READERS_MASK)
+        {
+          return EAGAIN;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state,
+                                      state + RWLOCK_READER, false,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  return OK;
+}
+#else
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
 static void rdlock_cleanup(FAR void *arg)
 {
@@ -62,6 +90,7 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
   return err;
 }
+#endif /* CONFIG_FUTEX */
 
 /****************************************************************************
  * Public Functions
@@ -85,6 +114,9 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
 int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
+#ifdef CONFIG_FUTEX
+  return tryrdlock(rw_lock);
+#else
   int err = pthread_mutex_trylock(&rw_lock->lock);
 
   if (err != 0)
@@ -96,12 +128,29 @@ int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
+#endif
 }
 
 int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
+#ifdef CONFIG_FUTEX
+  int err;
+
+  while ((err = tryrdlock(rw_lock)) == EBUSY)
+    {
+      err = pthread_rwlock_block(rw_lock,
+                                 RWLOCK_WRITER | RWLOCK_WRWAIT_MASK,
+                                 clockid, ts);
+      if (err != 0)
+        {
+          break;
+        }
+    }
+
+  return err;
+#else
   int err = pthread_mutex_lock(&rw_lock->lock);
 
   if (err != 0)
@@ -136,6 +185,7 @@ int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
 
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
+#endif /* CONFIG_FUTEX */
 }
 
 int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
@@ -29,17 +29,65 @@
 #include <errno.h>
 #include <debug.h>
 
+#include "pthread/pthread_futex.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_FUTEX
+/* Take the lock if it is free, dropping 'wrwait' from the count of waiting
+ * writers in the same atomic update.
+ */
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock, uint32_t wrwait)
+{
+  uint32_t state = rw_lock->state;
+
+  do
+    {
+      if ((state & (RWLOCK_WRITER | RWLOCK_READERS_MASK)) != 0)
+        {
+          return EBUSY;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state,
+                                      (state - wrwait) | RWLOCK_WRITER,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED));
+
+  return OK;
+}
+
+/* Stop waiting for the lock.  Readers held off by this writer are blocked
+ * in futex() and have to re-evaluate the lock word.
+ */
+
+static void wrlock_giveup(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state = __atomic_sub_fetch(&rw_lock->state, RWLOCK_WRWAIT,
+                                      __ATOMIC_RELAXED);
+
+  if ((state & RWLOCK_WAITERS) != 0 &&
+      (__atomic_fetch_and(&rw_lock->state, ~RWLOCK_WAITERS,
+                          __ATOMIC_RELAXED) & RWLOCK_WAITERS) != 0)
+    {
+      pthread_futex_wake(&rw_lock->state);
+    }
+}
+#endif
+
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
 static void wrlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
+#ifdef CONFIG_FUTEX
+  wrlock_giveup(rw_lock);
+#else
   rw_lock->num_writers--;
   pthread_mutex_unlock(&rw_lock->lock);
+#endif
 }
 #endif
 
@@ -65,6 +113,9 @@ static void wrlock_cleanup(FAR void *arg)
 
 int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 {
+#ifdef CONFIG_FUTEX
+  return trywrlock(rw_lock, 0);
+#else
   int err = pthread_mutex_trylock(&rw_lock->lock);
 
   if (err != 0)
@@ -83,12 +134,62 @@ int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
+#endif
 }
 
 int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
+#ifdef CONFIG_FUTEX
+  uint32_t state;
+  int err;
+
+  err = trywrlock(rw_lock, 0);
+  if (err != EBUSY)
+    {
+      return err;
+    }
+
+  /* Register as a waiting writer so that no new readers get in */
+
+  state = rw_lock->state;
+  do
+    {
+      if ((state & RWLOCK_WRWAIT_MASK) == RWLOCK_WRWAIT_MASK)
+        {
+          return EAGAIN;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state,
+                                      state + RWLOCK_WRWAIT, false,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+#if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
+  pthread_cleanup_push(&wrlock_cleanup, rw_lock);
+#endif
+  while ((err = trywrlock(rw_lock, RWLOCK_WRWAIT)) == EBUSY)
+    {
+      err = pthread_rwlock_block(rw_lock,
+                                 RWLOCK_WRITER | RWLOCK_READERS_MASK,
+                                 clockid, ts);
+      if (err != 0)
+        {
+          break;
+        }
+    }
+
+#if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
+  pthread_cleanup_pop(0);
+#endif
+
+  if (err != 0)
+    {
+      wrlock_giveup(rw_lock);
+    }
+
+  return err;
+#else
   int err = pthread_mutex_lock(&rw_lock->lock);
 
   if (err != 0)
@@ -145,6 +246,7 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
 exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
+#endif /* CONFIG_FUTEX */
 }
 
 int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
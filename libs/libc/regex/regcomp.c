@@ -3653,6 +3653,66 @@ static reg_errcode_t tre_ast_to_tnfa(tre_ast_node_t *node,
   return errcode;
 }
 
+/* Find the ASCII characters every match starts with, for regexec() to
+ * search with strstr() before running the automaton.  This follows the
+ * TNFA from its only initial state, if that has no assertions, for as long
+ * as all the transitions out of the current state are on the same single
+ * character.
+ */
+
+static void tre_find_prefix(tre_tnfa_t *tnfa)
+{
+  tre_tnfa_transition_t *state;
+  tre_tnfa_transition_t *trans;
+  tre_cint_t            c;
+  int                   same;
+
+  tnfa->prefix_len = 0;
+  if (tnfa->initial[0].state == NULL || tnfa->initial[1].state != NULL ||
+      tnfa->initial[0].assertions)
+    {
+      return;
+    }
+
+  state = tnfa->initial[0].state;
+  while (tnfa->prefix_len < TRE_PREFIX_MAX && state->state != NULL)
+    {
+      c = state->code_min;
+      if (c == 0 || c >= 0x80)
+        {
+          break;
+        }
+
+      same = 1;
+      for (trans = state; trans->state != NULL; trans++)
+        {
+          if (trans->code_min != c || trans->code_max != c)
+            {
+              break;
+            }
+
+          same &= trans->state == state->state;
+        }
+
+      if (trans->state != NULL)
+        {
+          break;
+        }
+
+      /* Go on only if there is a single next state */
+
+      tnfa->prefix[tnfa->prefix_len++] = (char)c;
+      if (!same)
+        {
+          break;
+        }
+
+      state = state->state;
+    }
+
+  tnfa->prefix[tnfa->prefix_len] = '\0';
+}
+
 #define ERROR_EXIT(err)      \
   do                         \
     {                        \
@@ -3925,6 +3985,11 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
 
+  if (!(cflags & REG_ICASE))
+    {
+      tre_find_prefix(tnfa);
+    }
+
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
   xfree(counts);
@@ -1219,8 +1219,31 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
 {
   tre_tnfa_t    *tnfa = (void *)preg->TRE_REGEX_T_FIELD;
   reg_errcode_t status;
+  const char    *start = string;
   int           *tags = NULL;
   int           eo;
+  int           i;
+
+  /* Every match begins with the literal prefix, if there is one:  look for
+   * its first occurrence and run the matcher from there.
+   */
+
+  if (tnfa->prefix_len > 0)
+    {
+      if (tnfa->prefix_len == 1)
+        {
+          start = strchr(string, tnfa->prefix[0]);
+        }
+      else
+        {
+          start = strstr(string, tnfa->prefix);
+        }
+
+      if (start == NULL)
+        {
+          return REG_NOMATCH;
+        }
+    }
 
   if (tnfa->cflags & REG_NOSUB)
     {
@@ -1242,17 +1265,31 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
     {
       /* The regex has back references, use the backtracking matcher. */
 
-      status = tre_tnfa_run_backtrack(tnfa, string, tags, eflags, &eo);
+      status = tre_tnfa_run_backtrack(tnfa, start, tags, eflags, &eo);
     }
   else
     {
       /* Exact matching, no back references, use the parallel matcher. */
 
-      status = tre_tnfa_run_parallel(tnfa, string, tags, eflags, &eo);
+      status = tre_tnfa_run_parallel(tnfa, start, tags, eflags, &eo);
     }
 
   if (status == REG_OK)
     {
+      /* Make the offsets relative to string again */
+
+      if (start != string)
+        {
+          eo += start - string;
+          for (i = 0; tags != NULL && i < tnfa->num_tags; i++)
+            {
+              if (tags[i] >= 0)
+                {
+                  tags[i] += start - string;
+                }
+            }
+        }
+
       /* A match was found, so fill the submatch registers. */
 
       tre_fill_pmatch(nmatch, pmatch, tnfa->cflags, tnfa, tags, eo);
@@ -190,6 +190,10 @@ struct tre_submatch_data
 
 typedef struct tre_submatch_data tre_submatch_data_t;
 
+/* Longest literal prefix kept for the search before the matcher */
+
+#define TRE_PREFIX_MAX 15
+
 /* TNFA definition. */
 
 typedef struct tnfa tre_tnfa_t;
@@ -213,6 +217,8 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+  int prefix_len;
+  char prefix[TRE_PREFIX_MAX + 1];
 };
 
 /* from tre-mem.h: */
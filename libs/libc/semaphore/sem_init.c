@@ -79,10 +79,9 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
   sem->flags = 0;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-#  if CONFIG_SEM_PREALLOCHOLDERS > 0
-  sem->hhead = NULL;
-#  else
   INITIALIZE_SEMHOLDER(&sem->holder);
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+  dq_init(&sem->hlist);
 #  endif
 #endif
   return OK;
@@ -30,14 +30,29 @@
  ****************************************************************************/
 
 /****************************************************************************
- * fgetc
+ * Name: fgetc_unlocked
  ****************************************************************************/
 
-int fgetc(FAR FILE *stream)
+int fgetc_unlocked(FAR FILE *stream)
 {
   unsigned char ch;
   ssize_t ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Take the character straight from the buffer if there is one and
+   * nothing was pushed back with ungetc().
+   */
+
+  if (stream != NULL && stream->fs_bufpos < stream->fs_bufread
+#if CONFIG_NUNGET_CHARS > 0
+      && stream->fs_nungotten == 0
+#endif
+     )
+    {
+      return *stream->fs_bufpos++;
+    }
+#endif
+
   ret = lib_fread(&ch, 1, stream);
   if (ret > 0)
     {
@@ -48,3 +63,22 @@ int fgetc(FAR FILE *stream)
       return EOF;
     }
 }
+
+/****************************************************************************
+ * Name: fgetc
+ ****************************************************************************/
+
+int fgetc(FAR FILE *stream)
+{
+  int ret;
+
+  if (stream == NULL)
+    {
+      return fgetc_unlocked(stream);
+    }
+
+  lib_take_lock(stream);
+  ret = fgetc_unlocked(stream);
+  lib_give_lock(stream);
+  return ret;
+}
@@ -23,6 +23,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <fcntl.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -30,14 +32,29 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: fputc
+ * Name: fputc_unlocked
  ****************************************************************************/
 
-int fputc(int c, FAR FILE *stream)
+int fputc_unlocked(int c, FAR FILE *stream)
 {
   unsigned char buf = (unsigned char)c;
   int ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Store the character straight away if the buffer is already in write
+   * mode, won't get full and doesn't need a line flush.
+   */
+
+  if (stream != NULL && stream->fs_bufread == stream->fs_bufstart &&
+      stream->fs_bufpos + 1 < stream->fs_bufend &&
+      (stream->fs_oflags & O_WROK) != 0 &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = buf;
+      return c;
+    }
+#endif
+
   ret = lib_fwrite(&buf, 1, stream);
   if (ret > 0)
     {
@@ -59,3 +76,22 @@ int fputc(int c, FAR FILE *stream)
       return EOF;
     }
 }
+
+/****************************************************************************
+ * Name: fputc
+ ****************************************************************************/
+
+int fputc(int c, FAR FILE *stream)
+{
+  int ret;
+
+  if (stream == NULL)
+    {
+      return fputc_unlocked(c, stream);
+    }
+
+  lib_take_lock(stream);
+  ret = fputc_unlocked(c, stream);
+  lib_give_lock(stream);
+  return ret;
+}
@@ -55,3 +55,18 @@ size_t fread(FAR void *ptr, size_t size, size_t n_items, FAR FILE *stream)
 
   return items_read;
 }
+
+/****************************************************************************
+ * Name: fread_unlocked
+ *
+ * Description:
+ *   The stream is already locked by the caller, so the lock taken by fread()
+ *   is only a recursive one, or none after __fsetlocking().
+ *
+ ****************************************************************************/
+
+size_t fread_unlocked(FAR void *ptr, size_t size, size_t n_items,
+                      FAR FILE *stream)
+{
+  return fread(ptr, size, n_items, stream);
+}
@@ -56,3 +56,18 @@ size_t fwrite(FAR const void *ptr, size_t size, size_t n_items,
 
   return items_written;
 }
+
+/****************************************************************************
+ * Name: fwrite_unlocked
+ *
+ * Description:
+ *   The stream is already locked by the caller, so the lock taken by fwrite()
+ *   is only a recursive one, or none after __fsetlocking().
+ *
+ ****************************************************************************/
+
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+                       FAR FILE *stream)
+{
+  return fwrite(ptr, size, n_items, stream);
+}
@@ -207,6 +207,28 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Write the literal text up to the next conversion at once */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+          if (fmt != pnt)
+            {
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+                {
+                  stream_puts(pnt, fmt - pnt, stream);
+                }
+#else
+              stream_puts(pnt, fmt - pnt, stream);
+#endif
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -1152,10 +1174,7 @@ str_lpad:
                       if (symbol != NULL)
                         {
                           pnt = symbol->sym_name;
-                          while (*pnt != '\0')
-                            {
-                              stream_putc(*pnt++, stream);
-                            }
+                          stream_puts(pnt, strlen(pnt), stream);
 
                           if (c == 'S')
                             {
@@ -1218,6 +1237,32 @@ str_lpad:
           flags &= ~FL_NEGATIVE;
         }
 
+      /* The digits are in reverse order:  turn them around so that they can
+       * be written at once.
+       */
+
+      for (len = 0; len < c / 2; len++)
+        {
+          unsigned char tmp = buf[len];
+
+          buf[len] = buf[c - 1 - len];
+          buf[c - 1 - len] = tmp;
+        }
+
+      /* Plain %d, %u, %x... need neither padding nor prefixes */
+
+      if ((flags & (FL_PREC | FL_ALT | FL_PLUS | FL_SPACE)) == 0 &&
+          width <= c)
+        {
+          if ((flags & FL_NEGATIVE) != 0)
+            {
+              stream_putc('-', stream);
+            }
+
+          stream_puts(buf, c, stream);
+          continue;
+        }
+
       len = c;
 
       if ((flags & FL_PREC) != 0)
@@ -1235,7 +1280,7 @@ str_lpad:
 
       if ((flags & FL_ALT) != 0)
         {
-          if (buf[c - 1] == '0')
+          if (buf[0] == '0')
             {
               flags &= ~(FL_ALT | FL_ALTHEX | FL_ALTUPP);
             }
@@ -1304,10 +1349,7 @@ str_lpad:
           prec--;
         }
 
-      while (c)
-        {
-          stream_putc(buf[--c], stream);
-        }
+      stream_puts(buf, c, stream);
 
 tail:
 
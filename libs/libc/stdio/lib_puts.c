@@ -50,7 +50,7 @@ int puts(FAR const IPTR char *s)
 
   /* Write the string (the next two steps must be atomic) */
 
-  flockfile(stream);
+  lib_take_lock(stream);
 
   /* Write the string without its trailing '\0' */
 
@@ -80,7 +80,7 @@ int puts(FAR const IPTR char *s)
         }
     }
 
-  funlockfile(stdout);
+  lib_give_lock(stdout);
   return nput;
 #else
   size_t len = strlen(s);
@@ -46,8 +46,8 @@ void rewind(FAR FILE *stream)
       return;
     }
 
-  flockfile(stream);
+  lib_take_lock(stream);
   fseek(stream, 0L, SEEK_SET);
   stream->fs_flags &= ~__FS_FLAG_ERROR;
-  funlockfile(stream);
+  lib_give_lock(stream);
 }
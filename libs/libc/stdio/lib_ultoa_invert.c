@@ -39,6 +39,23 @@
 
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_digits_lower[] = "0123456789abcdef";
+static const char g_digits_upper[] = "0123456789ABCDEF";
+
+#ifndef CONFIG_DEFAULT_SMALL
+/* "00" to "99", to convert two decimal digits per division */
+
+static const char g_digit_pairs[200] =
+  "000102030405060708091011121314151617181920212223242526272829"
+  "303132333435363738394041424344454647484950515253545556575859"
+  "606162636465666768697071727374757677787980818283848586878889"
+  "90919293949596979899";
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,34 +66,64 @@ FAR char *__ultoa_invert(unsigned long long val, FAR char *str, int base)
 FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
-  int upper = 0;
+  FAR const char *digits = g_digits_lower;
+  int shift;
 
   if (base & XTOA_UPPER)
     {
-      upper = 1;
+      digits = g_digits_upper;
       base &= ~XTOA_UPPER;
     }
 
-  do
+  /* The power of two bases only need shifts and masks */
+
+  shift = base == 16 ? 4 : base == 8 ? 3 : base == 2 ? 1 : 0;
+  if (shift != 0)
     {
-      int v;
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val >>= shift;
+        }
+      while (val);
 
-      v   = val % base;
-      val = val / base;
+      return str;
+    }
 
-      if (v <= 9)
+#ifndef CONFIG_DEFAULT_SMALL
+  /* Decimal takes half the divisions with two digits at a time */
+
+  if (base == 10)
+    {
+      FAR const char *pair;
+
+      while (val >= 100)
+        {
+          pair   = &g_digit_pairs[2 * (val % 100)];
+          val   /= 100;
+          *str++ = pair[1];
+          *str++ = pair[0];
+        }
+
+      if (val >= 10)
         {
-          v += '0';
+          pair   = &g_digit_pairs[2 * val];
+          *str++ = pair[1];
+          *str++ = pair[0];
         }
       else
         {
-          if (upper)
-            v += 'A' - 10;
-          else
-            v += 'a' - 10;
+          *str++ = '0' + val;
         }
 
-      *str++ = v;
+      return str;
+    }
+#endif
+
+  do
+    {
+      *str++ = digits[val % base];
+      val   /= base;
     }
   while (val);
 
@@ -48,12 +48,34 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Partitions smaller than this are insertion sorted */
+
+#define QSORT_INSERTION_MAX   7
+
+/* Partitions found with no element out of place are assumed to be nearly
+ * sorted and insertion sorted, until more than this number of elements had
+ * to be moved.
+ */
+
+#define QSORT_PARTIAL_MAX     8
+
+/* swaptype values:  elements are swapped a long, an int or a byte at a
+ * time, depending on their size and alignment.
+ */
+
+#define QSORT_SWAP_LONG       0 /* An element is one long */
+#define QSORT_SWAP_LONGS      1 /* Several longs */
+#define QSORT_SWAP_INTS       2 /* Several ints */
+#define QSORT_SWAP_BYTES      3 /* Anything else */
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof (TYPE); \
@@ -66,12 +88,8 @@
     } while (--i > 0); \
   }
 
-#define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
-
 #define swap(a, b) \
-  if (swaptype == 0) \
+  if (swaptype == QSORT_SWAP_LONG) \
     { \
       long t = *(long *)(a); \
       *(long *)(a) = *(long *)(b); \
@@ -84,25 +102,36 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*qsort_compar_t)(FAR const void *, FAR const void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             qsort_compar_t compar);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype)
 {
-  if (swaptype <= 1)
+  if (swaptype <= QSORT_SWAP_LONGS)
     {
       swapcode(long, a, b, n)
     }
+  else if (swaptype == QSORT_SWAP_INTS)
+    {
+      swapcode(int, a, b, n)
+    }
   else
     {
       swapcode(char, a, b, n)
@@ -110,8 +139,7 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             qsort_compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -119,50 +147,137 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_swaptype
+ *
+ * Description:
+ *   Select how to swap elements.  All the partitions keep the alignment of
+ *   base, so this is done once per sort.
+ *
  ****************************************************************************/
 
+static int qsort_swaptype(FAR void *base, size_t width)
+{
+  if ((uintptr_t)base % sizeof(long) == 0 && width % sizeof(long) == 0)
+    {
+      return width == sizeof(long) ? QSORT_SWAP_LONG : QSORT_SWAP_LONGS;
+    }
+  else if ((uintptr_t)base % sizeof(int) == 0 && width % sizeof(int) == 0)
+    {
+      return QSORT_SWAP_INTS;
+    }
+
+  return QSORT_SWAP_BYTES;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_insertion
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
+ *   Insertion sort, giving up once more than 'limit' elements had to be
+ *   moved.
  *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ * Returned Value:
+ *   True if the elements are sorted.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static bool qsort_insertion(FAR char *base, size_t nel, size_t width,
+                            qsort_compar_t compar, int swaptype,
+                            size_t limit)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+  size_t moved = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      if (compar(pm - width, pm) <= 0)
+        {
+          continue;
+        }
+
+      if (moved++ >= limit)
+        {
+          return false;
+        }
+
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: qsort_siftdown
+ ****************************************************************************/
+
+static void qsort_siftdown(FAR char *base, size_t root, size_t nel,
+                           size_t width, qsort_compar_t compar,
+                           int swaptype)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          compar(base + child * width, base + (child + 1) * width) < 0)
+        {
+          child++;
+        }
+
+      if (compar(base + root * width, base + child * width) >= 0)
+        {
+          break;
+        }
+
+      swap(base + root * width, base + child * width);
+      root = child;
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_heapsort
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Used for the partitions still left after too many bad pivots, so that
+ *   no input takes more than O(n log(n)) comparisons.
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void qsort_heapsort(FAR char *base, size_t nel, size_t width,
+                           qsort_compar_t compar, int swaptype)
+{
+  size_t i;
+
+  for (i = nel / 2; i > 0; i--)
+    {
+      qsort_siftdown(base, i - 1, nel, width, compar, swaptype);
+    }
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      swap(base, base + i * width);
+      qsort_siftdown(base, 0, i, width, compar, swaptype);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_loop
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Bentley & McIlroy's three way partitioning quicksort.  It recurses on
+ *   the smaller partition and loops on the larger one, so the stack depth
+ *   is at most log2(nel), and falls back to a heapsort after 'depth' levels
+ *   of partitioning.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_loop(FAR char *base, size_t nel, size_t width,
+                       qsort_compar_t compar, int swaptype, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,126 +286,200 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
+  size_t nlo;
+  size_t nhi;
+  size_t d;
+  size_t r;
   int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
+  int cmp;
 
-  if (nel < 7)
+  for (; ; )
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nel < QSORT_INSERTION_MAX)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          qsort_insertion(base, nel, width, compar, swaptype, SIZE_MAX);
+          return;
         }
 
-      return;
-    }
-
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
-      pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      if (depth-- <= 0)
         {
-          d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          qsort_heapsort(base, nel, width, compar, swaptype);
+          return;
         }
 
-      pm = med3(pl, pm, pn, compar);
-    }
-
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      swap_cnt = 0;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      pm = base + (nel / 2) * width;
+      if (nel > 7)
         {
-          if (r == 0)
+          pl = base;
+          pn = base + (nel - 1) * width;
+          if (nel > 40)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              d  = (nel / 8) * width;
+              pl = med3(pl, pl + d, pl + 2 * d, compar);
+              pm = med3(pm - d, pm, pm + d, compar);
+              pn = med3(pn - 2 * d, pn - d, pn, compar);
             }
 
-          pb += width;
+          pm = med3(pl, pm, pn, compar);
         }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+      swap(base, pm);
+      pa = pb = base + width;
+
+      pc = pd = base + (nel - 1) * width;
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (cmp = compar(pb, base)) <= 0)
+            {
+              if (cmp == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
+            }
+
+          while (pb <= pc && (cmp = compar(pc, base)) >= 0)
+            {
+              if (cmp == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pc, pd);
+                  pd -= width;
+                }
+
+              pc -= width;
+            }
+
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
-          pc -= width;
+          swap(pb, pc);
+          swap_cnt = 1;
+          pb      += width;
+          pc      -= width;
         }
 
-      if (pb > pc)
+      pn = base + nel * width;
+      r  = MIN(pa - base, pb - pa);
+      vecswap(base, pb - r, r);
+
+      r  = MIN(pd - pc, pn - pd - width);
+      vecswap(pb, pn - r, r);
+
+      nlo = (pb - pa) / width;
+      nhi = (pd - pc) / width;
+
+      /* Nothing was out of place:  the input may be already sorted.  Try a
+       * bounded insertion sort of both partitions before going on.
+       */
+
+      if (swap_cnt == 0 &&
+          qsort_insertion(base, nlo, width, compar, swaptype,
+                          QSORT_PARTIAL_MAX) &&
+          qsort_insertion(pn - nhi * width, nhi, width, compar, swaptype,
+                          QSORT_PARTIAL_MAX))
         {
-          break;
+          return;
         }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
-
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+      if (nlo < nhi)
+        {
+          if (nlo > 1)
+            {
+              qsort_loop(base, nlo, width, compar, swaptype, depth);
+            }
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+          base = pn - nhi * width;
+          nel  = nhi;
+        }
+      else
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          if (nhi > 1)
             {
-              swap(pl, pl - width);
+              qsort_loop(pn - nhi * width, nhi, width, compar, swaptype,
+                         depth);
             }
+
+          nel = nlo;
         }
 
-      return;
+      if (nel <= 1)
+        {
+          return;
+        }
     }
+}
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   The depth limit with a heapsort fallback is from Musser's introsort
+ *   and the bounded insertion sort of already sorted partitions from
+ *   Peters' pattern-defeating quicksort.
+ *
+ ****************************************************************************/
 
-  if ((r = pb - pa) > width)
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth = 0;
+
+  if (nel < 2 || width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+  /* Allow 2 * log2(nel) levels of partitioning before the heapsort */
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  qsort_loop(base, nel, width, compar, qsort_swaptype(base, width), depth);
 }
@@ -108,6 +108,17 @@ static int lzfoutstream_puts(FAR struct lib_outstream_s *this,
   return len;
 }
 
+/****************************************************************************
+ * Name: lzfoutstream_putc
+ ****************************************************************************/
+
+static void lzfoutstream_putc(FAR struct lib_outstream_s *this, int ch)
+{
+  char tmp = ch;
+
+  lzfoutstream_puts(this, &tmp, 1);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -137,6 +148,7 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
     }
 
   memset(stream, 0, sizeof(*stream));
+  stream->public.putc  = lzfoutstream_putc;
   stream->public.puts  = lzfoutstream_puts;
   stream->public.flush = lzfoutstream_flush;
   stream->backend      = backend;
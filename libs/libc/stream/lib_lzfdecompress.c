@@ -0,0 +1,208 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lzfdecompress.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzfinstream_read
+ *
+ * Description:
+ *   Read exactly len bytes from the backend.
+ *
+ ****************************************************************************/
+
+static bool lzfinstream_read(FAR struct lib_lzfinstream_s *stream,
+                             FAR char *buf, int len)
+{
+  int ret;
+
+  while (len > 0)
+    {
+      ret = lib_stream_gets(stream->backend, buf, len);
+      if (ret <= 0)
+        {
+          return false;
+        }
+
+      buf += ret;
+      len -= ret;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: lzfinstream_fill
+ *
+ * Description:
+ *   Read and decompress the next block from the backend.
+ *
+ ****************************************************************************/
+
+static bool lzfinstream_fill(FAR struct lib_lzfinstream_s *stream)
+{
+  FAR struct lzf_type1_header_s *header =
+                                 (FAR struct lzf_type1_header_s *)stream->in;
+  FAR char *data = &stream->in[LZF_TYPE1_HDR_SIZE];
+  unsigned int ulen;
+  unsigned int clen;
+
+  stream->offset = 0;
+  stream->size   = 0;
+
+  if (!lzfinstream_read(stream, stream->in, LZF_TYPE0_HDR_SIZE) ||
+      header->lzf_magic[0] != 'Z' || header->lzf_magic[1] != 'V')
+    {
+      return false;
+    }
+
+  if (header->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR struct lzf_type0_header_s *header0 =
+                                 (FAR struct lzf_type0_header_s *)stream->in;
+
+      /* A block stored uncompressed */
+
+      ulen = ((unsigned int)header0->lzf_len[0] << 8) | header0->lzf_len[1];
+      if (ulen > LZF_STREAM_BLOCKSIZE ||
+          !lzfinstream_read(stream, stream->out, ulen))
+        {
+          return false;
+        }
+    }
+  else if (header->lzf_type == LZF_TYPE1_HDR)
+    {
+      if (!lzfinstream_read(stream, &stream->in[LZF_TYPE0_HDR_SIZE],
+                            LZF_TYPE1_HDR_SIZE - LZF_TYPE0_HDR_SIZE))
+        {
+          return false;
+        }
+
+      clen = ((unsigned int)header->lzf_clen[0] << 8) | header->lzf_clen[1];
+      ulen = ((unsigned int)header->lzf_ulen[0] << 8) | header->lzf_ulen[1];
+      if (clen > LZF_STREAM_BLOCKSIZE || ulen > LZF_STREAM_BLOCKSIZE ||
+          !lzfinstream_read(stream, data, clen) ||
+          lzf_decompress(data, clen, stream->out, ulen) != ulen)
+        {
+          return false;
+        }
+    }
+  else
+    {
+      return false;
+    }
+
+  stream->size = ulen;
+  return true;
+}
+
+/****************************************************************************
+ * Name: lzfinstream_gets
+ ****************************************************************************/
+
+static int lzfinstream_gets(FAR struct lib_instream_s *this,
+                            FAR void *buf, int len)
+{
+  FAR struct lib_lzfinstream_s *stream =
+                                 (FAR struct lib_lzfinstream_s *)this;
+  FAR char *ptr = buf;
+  int copyout;
+
+  while (len > 0)
+    {
+      if (stream->offset >= stream->size && !lzfinstream_fill(stream))
+        {
+          break;
+        }
+
+      copyout = stream->size - stream->offset;
+      if (copyout > len)
+        {
+          copyout = len;
+        }
+
+      memcpy(ptr, &stream->out[stream->offset], copyout);
+
+      ptr            += copyout;
+      stream->offset += copyout;
+      this->nget     += copyout;
+      len            -= copyout;
+    }
+
+  return ptr == buf ? EOF : ptr - (FAR char *)buf;
+}
+
+/****************************************************************************
+ * Name: lzfinstream_getc
+ ****************************************************************************/
+
+static int lzfinstream_getc(FAR struct lib_instream_s *this)
+{
+  unsigned char ch;
+
+  return lzfinstream_gets(this, &ch, 1) == 1 ? ch : EOF;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lzfinstream
+ *
+ * Description:
+ *  LZF decompressing pipeline stream, reading the blocks written by
+ *  lib_lzfoutstream() with the same CONFIG_STREAM_LZF_BLOG.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lzfinstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lzfinstream(FAR struct lib_lzfinstream_s *stream,
+                     FAR struct lib_instream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->public.getc = lzfinstream_getc;
+  stream->public.gets = lzfinstream_gets;
+  stream->backend     = backend;
+}
@@ -24,10 +24,19 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LIBC_WORD      uintptr_t
+#define LIBC_WORDSIZE  sizeof(LIBC_WORD)
+#define LIBC_WORDMASK  (LIBC_WORDSIZE - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -40,6 +49,52 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   FAR unsigned char *p1 = (FAR unsigned char *)s1;
   FAR unsigned char *p2 = (FAR unsigned char *)s2;
 
+#ifdef CONFIG_MEMCMP_OPTSPEED
+  /* Skip the equal words of buffers sharing the same alignment, then
+   * let the byte loop find the first difference within the word.
+   */
+
+  if (n >= 2 * LIBC_WORDSIZE &&
+      (((uintptr_t)p1 ^ (uintptr_t)p2) & LIBC_WORDMASK) == 0)
+    {
+      FAR const LIBC_WORD *w1;
+      FAR const LIBC_WORD *w2;
+
+      while (((uintptr_t)p1 & LIBC_WORDMASK) != 0)
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      w1 = (FAR const LIBC_WORD *)p1;
+      w2 = (FAR const LIBC_WORD *)p2;
+
+      while (n >= 4 * LIBC_WORDSIZE && w1[0] == w2[0] && w1[1] == w2[1] &&
+             w1[2] == w2[2] && w1[3] == w2[3])
+        {
+          w1 += 4;
+          w2 += 4;
+          n  -= 4 * LIBC_WORDSIZE;
+        }
+
+      while (n >= LIBC_WORDSIZE && *w1 == *w2)
+        {
+          w1++;
+          w2++;
+          n -= LIBC_WORDSIZE;
+        }
+
+      p1 = (FAR unsigned char *)w1;
+      p2 = (FAR unsigned char *)w2;
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
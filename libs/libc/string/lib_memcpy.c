@@ -24,10 +24,34 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The word used by the optimized copy and its size in bytes and bits */
+
+#define LIBC_WORD      uintptr_t
+#define LIBC_WORDSIZE  sizeof(LIBC_WORD)
+#define LIBC_WORDMASK  (LIBC_WORDSIZE - 1)
+#define LIBC_WORDBITS  (8 * LIBC_WORDSIZE)
+
+/* Merge the bytes of two consecutive aligned source words that make up one
+ * word of a source not aligned like the destination, 0 < shift < bits.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define LIBC_MERGE(lo, hi, shift) \
+     (((lo) << (shift)) | ((hi) >> (LIBC_WORDBITS - (shift))))
+#else
+#  define LIBC_MERGE(lo, hi, shift) \
+     (((lo) >> (shift)) | ((hi) << (LIBC_WORDBITS - (shift))))
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -43,6 +67,79 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+  /* This version copies a word at a time once the destination is aligned.
+   * Short copies are not worth the setup.
+   */
+
+  if (n >= 2 * LIBC_WORDSIZE)
+    {
+      FAR LIBC_WORD *wout;
+      FAR const LIBC_WORD *win;
+
+      /* Align the destination to a word boundary */
+
+      while (((uintptr_t)pout & LIBC_WORDMASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR LIBC_WORD *)pout;
+
+      if (((uintptr_t)pin & LIBC_WORDMASK) == 0)
+        {
+          /* The source is aligned too: copy four words per iteration */
+
+          win = (FAR const LIBC_WORD *)pin;
+          while (n >= 4 * LIBC_WORDSIZE)
+            {
+              wout[0] = win[0];
+              wout[1] = win[1];
+              wout[2] = win[2];
+              wout[3] = win[3];
+              wout   += 4;
+              win    += 4;
+              n      -= 4 * LIBC_WORDSIZE;
+            }
+
+          while (n >= LIBC_WORDSIZE)
+            {
+              *wout++ = *win++;
+              n      -= LIBC_WORDSIZE;
+            }
+
+          pin = (FAR unsigned char *)win;
+        }
+      else
+        {
+          /* Read the source by aligned words too and shift the bytes in
+           * place.  The aligned words read never extend past the word
+           * holding the last source byte.
+           */
+
+          unsigned int shift = 8 * ((uintptr_t)pin & LIBC_WORDMASK);
+          LIBC_WORD lo;
+          LIBC_WORD hi;
+
+          win = (FAR const LIBC_WORD *)((uintptr_t)pin & ~LIBC_WORDMASK);
+          lo  = *win++;
+
+          while (n >= LIBC_WORDSIZE)
+            {
+              hi      = *win++;
+              *wout++ = LIBC_MERGE(lo, hi, shift);
+              lo      = hi;
+              pin    += LIBC_WORDSIZE;
+              n      -= LIBC_WORDSIZE;
+            }
+        }
+
+      pout = (FAR unsigned char *)wout;
+    }
+#endif
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
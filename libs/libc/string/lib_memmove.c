@@ -24,10 +24,20 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LIBC_WORD      uintptr_t
+#define LIBC_WORDSIZE  sizeof(LIBC_WORD)
+#define LIBC_WORDMASK  (LIBC_WORDSIZE - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -39,12 +49,61 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR char *tmp;
   FAR char *s;
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+  bool words;
+
+  /* Words are moved only when both buffers share the same alignment, the
+   * case of most structure and buffer moves.  Moving a word at a time in
+   * the direction that reads each byte before it is overwritten is safe
+   * for any overlap.
+   */
+
+  words = count >= 2 * LIBC_WORDSIZE &&
+          (((uintptr_t)dest ^ (uintptr_t)src) & LIBC_WORDMASK) == 0;
+#endif
 
   if (dest <= src)
     {
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      if (words)
+        {
+          FAR LIBC_WORD *wtmp;
+          FAR const LIBC_WORD *ws;
+
+          while (((uintptr_t)tmp & LIBC_WORDMASK) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          wtmp = (FAR LIBC_WORD *)tmp;
+          ws   = (FAR const LIBC_WORD *)s;
+
+          while (count >= 4 * LIBC_WORDSIZE)
+            {
+              wtmp[0] = ws[0];
+              wtmp[1] = ws[1];
+              wtmp[2] = ws[2];
+              wtmp[3] = ws[3];
+              wtmp   += 4;
+              ws     += 4;
+              count  -= 4 * LIBC_WORDSIZE;
+            }
+
+          while (count >= LIBC_WORDSIZE)
+            {
+              *wtmp++ = *ws++;
+              count  -= LIBC_WORDSIZE;
+            }
+
+          tmp = (FAR char *)wtmp;
+          s   = (FAR char *)ws;
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -55,6 +114,43 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      if (words)
+        {
+          FAR LIBC_WORD *wtmp;
+          FAR const LIBC_WORD *ws;
+
+          while (((uintptr_t)tmp & LIBC_WORDMASK) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          wtmp = (FAR LIBC_WORD *)tmp;
+          ws   = (FAR const LIBC_WORD *)s;
+
+          while (count >= 4 * LIBC_WORDSIZE)
+            {
+              wtmp[-1] = ws[-1];
+              wtmp[-2] = ws[-2];
+              wtmp[-3] = ws[-3];
+              wtmp[-4] = ws[-4];
+              wtmp    -= 4;
+              ws      -= 4;
+              count   -= 4 * LIBC_WORDSIZE;
+            }
+
+          while (count >= LIBC_WORDSIZE)
+            {
+              *--wtmp = *--ws;
+              count  -= LIBC_WORDSIZE;
+            }
+
+          tmp = (FAR char *)wtmp;
+          s   = (FAR char *)ws;
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
@@ -97,6 +97,16 @@ FAR void *memset(FAR void *s, int c, size_t n)
 #ifndef CONFIG_MEMSET_64BIT
           /* Loop while there are at least 32-bits left to be written */
 
+          while (n >= 16)
+            {
+              ((FAR uint32_t *)addr)[0] = val32;
+              ((FAR uint32_t *)addr)[1] = val32;
+              ((FAR uint32_t *)addr)[2] = val32;
+              ((FAR uint32_t *)addr)[3] = val32;
+              addr += 16;
+              n    -= 16;
+            }
+
           while (n >= 4)
             {
               *(FAR uint32_t *)addr = val32;
@@ -121,6 +131,16 @@ FAR void *memset(FAR void *s, int c, size_t n)
 
               /* Loop while there are at least 64-bits left to be written */
 
+              while (n >= 32)
+                {
+                  ((FAR uint64_t *)addr)[0] = val64;
+                  ((FAR uint64_t *)addr)[1] = val64;
+                  ((FAR uint64_t *)addr)[2] = val64;
+                  ((FAR uint64_t *)addr)[3] = val64;
+                  addr += 32;
+                  n    -= 32;
+                }
+
               while (n >= 8)
                 {
                   *(FAR uint64_t *)addr = val64;
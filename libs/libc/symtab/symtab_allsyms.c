@@ -24,6 +24,8 @@
 
 #include <nuttx/allsyms.h>
 
+#include <string.h>
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -31,6 +33,95 @@
 extern const struct symtab_s g_allsyms[];
 extern const int             g_nallsyms;
 
+/* The indices into g_allsyms, in the order of the symbol names */
+
+extern const int             g_allsyms_byname[];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: allsyms_bsearchbyname
+ *
+ * Description:
+ *   Find the symbol with the matching name through g_allsyms_byname.  Of
+ *   the symbols sharing a name, the one with the lowest address is found.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+allsyms_bsearchbyname(FAR const char *name)
+{
+  int high = g_nallsyms - 1;
+  int low  = 0;
+  int mid;
+  int cmp;
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  /* Find the first index whose name is not less than 'name' */
+
+  while (low <= high)
+    {
+      mid = (low + high) >> 1;
+      cmp = strcmp(g_allsyms[g_allsyms_byname[mid]].sym_name, name);
+      if (cmp < 0)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid - 1;
+        }
+    }
+
+  if (low < g_nallsyms &&
+      strcmp(g_allsyms[g_allsyms_byname[low]].sym_name, name) == 0)
+    {
+      return &g_allsyms[g_allsyms_byname[low]];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: allsyms_bsearchbyvalue
+ *
+ * Description:
+ *   Find the symbol whose value is closest to, but not greater than, the
+ *   provided value.  g_allsyms is always sorted by value.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+allsyms_bsearchbyvalue(FAR void *value)
+{
+  int high = g_nallsyms - 1;
+  int low  = 0;
+  int mid;
+
+  while (low <= high)
+    {
+      mid = (low + high) >> 1;
+      if (g_allsyms[mid].sym_value <= value)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid - 1;
+        }
+    }
+
+  return high >= 0 ? &g_allsyms[high] : NULL;
+}
+
 /****************************************************************************
  * Name: allsyms_lookup
  *
@@ -51,11 +142,11 @@ allsyms_lookup(FAR const char *name, FAR void *value,
 
   if (name)
     {
-      symbol = symtab_findbyname(g_allsyms, name, g_nallsyms);
+      symbol = allsyms_bsearchbyname(name);
     }
   else if (value)
     {
-      symbol = symtab_findbyvalue(g_allsyms, value, g_nallsyms);
+      symbol = allsyms_bsearchbyvalue(value);
     }
 
   if (symbol && symbol != &g_allsyms[g_nallsyms - 1])
@@ -40,9 +40,9 @@
  *
  * Description:
  *   Find the symbol in the symbol table whose value closest (but not greater
- *   than), the provided value. This version assumes that table is not
- *   ordered with respect to symbol value and, hence, access time will be
- *   linear with respect to nsyms.
+ *   than), the provided value.  If CONFIG_SYMTAB_ORDEREDBYVALUE is selected,
+ *   the table must be sorted by value and a binary search is used.
+ *   Otherwise the access time will be linear with respect to nsyms.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -58,8 +58,8 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
   FAR const struct symtab_s *retval = NULL;
 #else
   int high = nsyms - 1;
-  int mid  = high >> 1;
   int low  = 0;
+  int mid;
 #endif
 
   if (symtab == NULL)
@@ -69,41 +69,23 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
     }
 
 #ifdef CONFIG_SYMTAB_ORDEREDBYVALUE
+  /* Find the last entry whose value is not greater than 'value' */
 
-  while (high >= low)
+  while (low <= high)
     {
       mid = (low + high) >> 1;
 
-      if (symtab[mid].sym_value == value)
+      if (symtab[mid].sym_value <= value)
         {
-          break;
+          low = mid + 1;
         }
-      else if (symtab[mid].sym_value > value)
+      else
         {
-          if (symtab[mid - 1].sym_value <= value)
-            {
-              mid -= 1;
-              break;
-            }
-          else
-            {
-              high = mid - 1;
-            }
-        }
-      else if (symtab[mid].sym_value < value)
-        {
-          if (symtab[mid + 1].sym_value >= value)
-            {
-              break;
-            }
-          else
-            {
-              low = mid + 1;
-            }
+          high = mid - 1;
         }
     }
 
-  return &symtab[mid];
+  return high >= 0 ? &symtab[high] : NULL;
 
 #else /* CONFIG_SYMTAB_ORDEREDBYVALUE */
 
@@ -414,6 +414,92 @@ void foc_current_control(FAR struct foc_data_f32_s *foc,
   vdq_ref->q = vdq_ref->q - vdq_comp->q;
 }
 
+/****************************************************************************
+ * Name: foc_current_step
+ *
+ * Description:
+ *   One cycle of the FOC current loop in a single call: the same as
+ *   foc_angle_update(), foc_iabc_update(), foc_current_control(),
+ *   foc_voltage_control() and svm3() on the modulation voltage, in this
+ *   order, with the transforms done in place.
+ *
+ * Input Parameters:
+ *   foc      - (in/out) pointer to the FOC data
+ *   angle    - (in) pointer to the phase angle data
+ *   i_abc    - (in) pointer to the ABC current frame
+ *   idq_ref  - (in) current dq reference frame
+ *   vdq_comp - (in) voltage dq compensation frame
+ *   svm      - (out) pointer to the SVM state data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_current_step(FAR struct foc_data_f32_s *foc,
+                      FAR phase_angle_f32_t *angle,
+                      FAR abc_frame_f32_t *i_abc,
+                      FAR dq_frame_f32_t *idq_ref,
+                      FAR dq_frame_f32_t *vdq_comp,
+                      FAR struct svm3_state_f32_s *svm)
+{
+  float sin;
+  float cos;
+
+  LIBDSP_DEBUGASSERT(foc != NULL);
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(i_abc != NULL);
+  LIBDSP_DEBUGASSERT(idq_ref != NULL);
+  LIBDSP_DEBUGASSERT(vdq_comp != NULL);
+  LIBDSP_DEBUGASSERT(svm != NULL);
+
+  sin = angle->sin;
+  cos = angle->cos;
+
+  foc->angle.angle = angle->angle;
+  foc->angle.sin   = sin;
+  foc->angle.cos   = cos;
+
+  foc->i_abc.a = i_abc->a;
+  foc->i_abc.b = i_abc->b;
+  foc->i_abc.c = i_abc->c;
+
+  /* Clarke and Park transforms (current abc -> alpha-beta -> dq) */
+
+  foc->i_ab.a = i_abc->a;
+  foc->i_ab.b = ONE_BY_SQRT3_F * i_abc->a + TWO_BY_SQRT3_F * i_abc->b;
+
+  foc->i_dq.d = cos * foc->i_ab.a + sin * foc->i_ab.b;
+  foc->i_dq.q = cos * foc->i_ab.b - sin * foc->i_ab.a;
+
+  /* Current controllers (current dq -> voltage dq) and compensation */
+
+  foc->i_dq_ref.d = idq_ref->d;
+  foc->i_dq_ref.q = idq_ref->q;
+
+  foc->i_dq_err.d = foc->i_dq_ref.d - foc->i_dq.d;
+  foc->i_dq_err.q = foc->i_dq_ref.q - foc->i_dq.q;
+
+  foc->v_dq.d = pi_controller(&foc->id_pid, foc->i_dq_err.d) - vdq_comp->d;
+  foc->v_dq.q = pi_controller(&foc->iq_pid, foc->i_dq_err.q) - vdq_comp->q;
+
+  /* Inverse Park transform (voltage dq -> voltage alpha-beta) */
+
+  foc->v_ab.a = cos * foc->v_dq.d - sin * foc->v_dq.q;
+  foc->v_ab.b = cos * foc->v_dq.q + sin * foc->v_dq.d;
+
+#ifdef CONFIG_LIBDSP_FOC_VABC
+  inv_clarke_transform(&foc->v_ab, &foc->v_abc);
+#endif
+
+  foc->v_ab_mod.a = foc->v_ab.a * foc->vab_mod_scale;
+  foc->v_ab_mod.b = foc->v_ab.b * foc->vab_mod_scale;
+
+  /* Space vector modulation of the normalized voltage */
+
+  svm3(svm, &foc->v_ab_mod);
+}
+
 /****************************************************************************
  * Name: foc_vabmod_get
  *
@@ -415,6 +415,96 @@ void foc_current_control_b16(FAR struct foc_data_b16_s *foc,
   vdq_ref->q = vdq_ref->q - vdq_comp->q;
 }
 
+/****************************************************************************
+ * Name: foc_current_step_b16
+ *
+ * Description:
+ *   One cycle of the FOC current loop in a single call: the same as
+ *   foc_angle_update_b16(), foc_iabc_update_b16(),
+ *   foc_current_control_b16(), foc_voltage_control_b16() and svm3_b16()
+ *   on the modulation voltage, in this order, with the transforms done in
+ *   place.
+ *
+ * Input Parameters:
+ *   foc      - (in/out) pointer to the FOC data
+ *   angle    - (in) pointer to the phase angle data
+ *   i_abc    - (in) pointer to the ABC current frame
+ *   idq_ref  - (in) current dq reference frame
+ *   vdq_comp - (in) voltage dq compensation frame
+ *   svm      - (out) pointer to the SVM state data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_current_step_b16(FAR struct foc_data_b16_s *foc,
+                          FAR phase_angle_b16_t *angle,
+                          FAR abc_frame_b16_t *i_abc,
+                          FAR dq_frame_b16_t *idq_ref,
+                          FAR dq_frame_b16_t *vdq_comp,
+                          FAR struct svm3_state_b16_s *svm)
+{
+  b16_t sin;
+  b16_t cos;
+
+  LIBDSP_DEBUGASSERT(foc != NULL);
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(i_abc != NULL);
+  LIBDSP_DEBUGASSERT(idq_ref != NULL);
+  LIBDSP_DEBUGASSERT(vdq_comp != NULL);
+  LIBDSP_DEBUGASSERT(svm != NULL);
+
+  sin = angle->sin;
+  cos = angle->cos;
+
+  foc->angle.angle = angle->angle;
+  foc->angle.sin   = sin;
+  foc->angle.cos   = cos;
+
+  foc->i_abc.a = i_abc->a;
+  foc->i_abc.b = i_abc->b;
+  foc->i_abc.c = i_abc->c;
+
+  /* Clarke and Park transforms (current abc -> alpha-beta -> dq) */
+
+  foc->i_ab.a = i_abc->a;
+  foc->i_ab.b = b16mulb16(ONE_BY_SQRT3_B16, i_abc->a) +
+                b16mulb16(TWO_BY_SQRT3_B16, i_abc->b);
+
+  foc->i_dq.d = b16mulb16(cos, foc->i_ab.a) + b16mulb16(sin, foc->i_ab.b);
+  foc->i_dq.q = b16mulb16(cos, foc->i_ab.b) - b16mulb16(sin, foc->i_ab.a);
+
+  /* Current controllers (current dq -> voltage dq) and compensation */
+
+  foc->i_dq_ref.d = idq_ref->d;
+  foc->i_dq_ref.q = idq_ref->q;
+
+  foc->i_dq_err.d = foc->i_dq_ref.d - foc->i_dq.d;
+  foc->i_dq_err.q = foc->i_dq_ref.q - foc->i_dq.q;
+
+  foc->v_dq.d = pi_controller_b16(&foc->id_pid, foc->i_dq_err.d) -
+                vdq_comp->d;
+  foc->v_dq.q = pi_controller_b16(&foc->iq_pid, foc->i_dq_err.q) -
+                vdq_comp->q;
+
+  /* Inverse Park transform (voltage dq -> voltage alpha-beta) */
+
+  foc->v_ab.a = b16mulb16(cos, foc->v_dq.d) - b16mulb16(sin, foc->v_dq.q);
+  foc->v_ab.b = b16mulb16(cos, foc->v_dq.q) + b16mulb16(sin, foc->v_dq.d);
+
+#ifdef CONFIG_LIBDSP_FOC_VABC
+  inv_clarke_transform_b16(&foc->v_ab, &foc->v_abc);
+#endif
+
+  foc->v_ab_mod.a = b16mulb16(foc->v_ab.a, foc->vab_mod_scale);
+  foc->v_ab_mod.b = b16mulb16(foc->v_ab.b, foc->vab_mod_scale);
+
+  /* Space vector modulation of the normalized voltage */
+
+  svm3_b16(svm, &foc->v_ab_mod);
+}
+
 /****************************************************************************
  * Name: foc_vabmod_get_b16
  *
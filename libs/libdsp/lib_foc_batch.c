@@ -0,0 +1,181 @@
+/****************************************************************************
+ * libs/libdsp/lib_foc_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Anti-windup gain, as set by foc_init() */
+
+#define FOC_BATCH_KC (0.99f)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SVM sector from the signs of the auxiliary i, j and k voltages, as
+ * svm3() finds it: bit 0 is set if i > 0, bit 1 if j > 0, bit 2 if k > 0.
+ * All three can not be positive at once, all three are zero for the null
+ * vector.
+ */
+
+static const uint8_t g_svm3_sector[8] =
+{
+  2, 6, 2, 1, 4, 5, 3, 0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_batch_pi
+ *
+ * Description:
+ *   The PI controller of pi_controller(), saturated to <-max, max> with
+ *   anti-windup protection, written without branches.
+ *
+ ****************************************************************************/
+
+static inline float foc_batch_pi(float err, float kp, float ki, float max,
+                                 FAR float *integral, FAR float *aw)
+{
+  float tmp;
+  float out;
+
+  *integral += ki * (err - *aw);
+  tmp = kp * err + *integral;
+
+  out = tmp > max ? max : tmp;
+  out = out < -max ? -max : out;
+
+  *aw = FOC_BATCH_KC * (tmp - out);
+  return out;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_current_batch
+ *
+ * Description:
+ *   One cycle of the FOC current loops of n motors.  For each motor this
+ *   gives the duty cycles and sector that foc_current_step() would, but
+ *   keeps nothing else than the state of the PI controllers.
+ *
+ *   The loop carries no dependency from one motor to the next and has no
+ *   branches, so that the compiler can vectorize it where the architecture
+ *   allows (Helium on Armv8.1-M, NEON elsewhere).  The space vector
+ *   modulation is done as the equivalent min-max injection: each duty
+ *   cycle is 0.5 plus the phase voltage minus the mean of the largest and
+ *   the smallest one, scaled by 1/sqrt(3).
+ *
+ * Input Parameters:
+ *   b - (in/out) pointer to the arrays of the motors
+ *   n - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_current_batch(FAR struct foc_batch_f32_s *b, int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(b != NULL);
+  LIBDSP_DEBUGASSERT(n >= 0 && n <= FOC_BATCH_MAX);
+
+  for (i = 0; i < n; i++)
+    {
+      float sin = b->sin[i];
+      float cos = b->cos[i];
+      float i_alpha;
+      float i_beta;
+      float v_alpha;
+      float v_beta;
+      float vd;
+      float vq;
+      float vu;
+      float vv;
+      float vw;
+      float hi;
+      float lo;
+      float off;
+
+      /* Clarke and Park transforms (current abc -> alpha-beta -> dq) */
+
+      i_alpha = b->i_a[i];
+      i_beta  = ONE_BY_SQRT3_F * b->i_a[i] + TWO_BY_SQRT3_F * b->i_b[i];
+
+      vd = cos * i_alpha + sin * i_beta;
+      vq = cos * i_beta - sin * i_alpha;
+
+      /* Current controllers (current dq -> voltage dq) and compensation */
+
+      vd = foc_batch_pi(b->id_ref[i] - vd, b->id_kp[i], b->id_ki[i],
+                        b->vdq_mag_max[i], &b->id_int[i], &b->id_aw[i]) -
+           b->vd_comp[i];
+      vq = foc_batch_pi(b->iq_ref[i] - vq, b->iq_kp[i], b->iq_ki[i],
+                        b->vdq_mag_max[i], &b->iq_int[i], &b->iq_aw[i]) -
+           b->vq_comp[i];
+
+      /* Inverse Park transform and normalization */
+
+      v_alpha = (cos * vd - sin * vq) * b->vab_mod_scale[i];
+      v_beta  = (cos * vq + sin * vd) * b->vab_mod_scale[i];
+
+      /* Phase voltages (inverse Clarke transform) and their offset */
+
+      vu = v_alpha;
+      vv = -0.5f * v_alpha + SQRT3_BY_TWO_F * v_beta;
+      vw = -vu - vv;
+
+      hi  = vu > vv ? vu : vv;
+      hi  = hi > vw ? hi : vw;
+      lo  = vu < vv ? vu : vv;
+      lo  = lo < vw ? lo : vw;
+      off = 0.5f * (hi + lo);
+
+      b->d_u[i] = 0.5f + ONE_BY_SQRT3_F * (vu - off);
+      b->d_v[i] = 0.5f + ONE_BY_SQRT3_F * (vv - off);
+      b->d_w[i] = 0.5f + ONE_BY_SQRT3_F * (vw - off);
+    }
+
+  /* The differences of the duty cycles are the auxiliary i, j, k frame
+   * of svm3().  This is a loop of its own, as the byte wide table lookup
+   * would keep the one above from being vectorized.
+   */
+
+  for (i = 0; i < n; i++)
+    {
+      b->sector[i] = g_svm3_sector[(b->d_u[i] > b->d_v[i]) |
+                                   ((b->d_v[i] > b->d_w[i]) << 1) |
+                                   ((b->d_w[i] > b->d_u[i]) << 2)];
+    }
+}
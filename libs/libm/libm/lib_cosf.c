@@ -31,11 +31,33 @@
 
 #include <math.h>
 
+#include "libm.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float cosf(float x)
 {
-  return sinf(x + M_PI_2_F);
+  float r;
+
+  if (isnan(x) || isinff(x))
+    {
+      return x - x;
+    }
+
+  switch (lib_rem_pio2f(x, &r))
+    {
+      case 0:
+        return lib_cosf_kernel(r);
+
+      case 1:
+        return -lib_sinf_kernel(r);
+
+      case 2:
+        return -lib_cosf_kernel(r);
+
+      default:
+        return lib_sinf_kernel(r);
+    }
 }
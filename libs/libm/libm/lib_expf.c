@@ -29,29 +29,19 @@
  * Included Files
  ****************************************************************************/
 
-#include <stdbool.h>
 #include <math.h>
 
-#include "libm.h"
-
 /****************************************************************************
- * Private Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
-static float _flt_inv_fact[] =
-{
-  1.0 / 1.0,                    /* 1/0! */
-  1.0 / 1.0,                    /* 1/1! */
-  1.0 / 2.0,                    /* 1/2! */
-  1.0 / 6.0,                    /* 1/3! */
-  1.0 / 24.0,                   /* 1/4! */
-  1.0 / 120.0,                  /* 1/5! */
-  1.0 / 720.0,                  /* 1/6! */
-  1.0 / 5040.0,                 /* 1/7! */
-  1.0 / 40320.0,                /* 1/8! */
-  1.0 / 362880.0,               /* 1/9! */
-  1.0 / 3628800.0,              /* 1/10! */
-};
+/* ln(2) in two parts, k * LN2_HI is exact for the k of the finite results */
+
+#define LN2_HI       0.693359375F
+#define LN2_LO       -2.12194440e-4F
+
+#define EXPF_MAX_X   88.72283905F
+#define EXPF_MIN_X   -103.972084F
 
 /****************************************************************************
  * Public Functions
@@ -59,54 +49,34 @@ static float _flt_inv_fact[] =
 
 float expf(float x)
 {
-  size_t int_part;
-  bool invert;
-  float value;
-  float x0;
-  size_t i;
+  float r;
+  float z;
+  int k;
 
-  if (x == 0)
+  if (isnan(x))
     {
-      return 1;
+      return x;
     }
-  else if (x < 0)
+  else if (x > EXPF_MAX_X)
     {
-      invert = true;
-      x = -x;
+      return INFINITY_F;
     }
-  else
+  else if (x < EXPF_MIN_X)
     {
-      invert = false;
+      return 0.0F;
     }
 
-  /* Extract integer component */
-
-  int_part = (size_t) x;
-
-  /* set x to fractional component */
-
-  x -= (float)int_part;
+  /* exp(x) = 2^k * exp(r), with |r| <= ln(2) / 2 */
 
-  /* Perform Taylor series approximation with eleven terms */
+  k = (int)(x * (float)M_LOG2E + (x < 0.0F ? -0.5F : 0.5F));
+  r = (x - k * LN2_HI) - k * LN2_LO;
 
-  value = 0.0F;
-  x0 = 1.0F;
-  for (i = 0; i < 10; i++)
-    {
-      value += x0 * _flt_inv_fact[i];
-      x0 *= x;
-    }
+  /* Cephes minimax polynomial, within about 1 ulp */
 
-  /* Multiply by exp of the integer component */
+  z = r * r;
+  z = (((((1.9875691500e-4F * r + 1.3981999507e-3F) * r +
+          8.3334519073e-3F) * r + 4.1665795894e-2F) * r +
+          1.6666665459e-1F) * r + 5.0000001201e-1F) * z + r + 1.0F;
 
-  value *= lib_expif(int_part);
-
-  if (invert)
-    {
-      return (1.0F / value);
-    }
-  else
-    {
-      return value;
-    }
+  return scalbnf(z, k);
 }
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libs/libm/libm/lib_libsincosf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 in three parts, with the low bits of the first two clear so that
+ * k * PIO2_1 and k * PIO2_2 are exact for the k of |x| < PIO2F_MAX
+ * (Cody & Waite).
+ */
+
+#define PIO2_1     1.5703125F
+#define PIO2_2     4.837512969970703125e-4F
+#define PIO2_3     7.54978995489188216e-8F
+
+#define PIO2F_MAX  8192.0F
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rem_pio2f
+ *
+ * Description:
+ *   Reduce x to r = x - k * pi/2, with |r| <= pi/4.
+ *
+ * Returned Value:
+ *   The quadrant k, modulo 4.
+ *
+ ****************************************************************************/
+
+int lib_rem_pio2f(float x, float *r)
+{
+  double y;
+  int k;
+
+  if (fabsf(x) < PIO2F_MAX)
+    {
+      k  = (int)(x * (float)M_2_PI + (x < 0.0F ? -0.5F : 0.5F));
+      *r = ((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+      return k & 3;
+    }
+
+  /* Too large for the exact products:  reduce in double precision, first
+   * to [-pi, pi].
+   */
+
+  y  = fmod((double)x, 2.0 * M_PI);
+  k  = (int)(y * M_2_PI + (y < 0.0 ? -0.5 : 0.5));
+  *r = (float)(y - k * M_PI_2);
+  return k & 3;
+}
+
+/****************************************************************************
+ * Name: lib_sinf_kernel
+ *
+ * Description:
+ *   sin(x) for |x| <= pi/4, within about 1 ulp (Cephes minimax
+ *   polynomial).
+ *
+ ****************************************************************************/
+
+float lib_sinf_kernel(float x)
+{
+  float z = x * x;
+
+  return ((-1.9515295891e-4F * z + 8.3321608736e-3F) * z -
+          1.6666654611e-1F) * z * x + x;
+}
+
+/****************************************************************************
+ * Name: lib_cosf_kernel
+ *
+ * Description:
+ *   cos(x) for |x| <= pi/4, within about 1 ulp (Cephes minimax
+ *   polynomial).
+ *
+ ****************************************************************************/
+
+float lib_cosf_kernel(float x)
+{
+  float z = x * x;
+
+  return ((2.443315711809948e-5F * z - 1.388731625493765e-3F) * z +
+          4.166664568298827e-2F) * z * z - 0.5F * z + 1.0F;
+}
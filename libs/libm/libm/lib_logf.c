@@ -30,21 +30,16 @@
  ****************************************************************************/
 
 #include <math.h>
-#include <float.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define FLT_MAX_EXP_X   88.0F
+/* ln(2) in two parts, e * LN2_HI is exact for every exponent e */
 
-/* To avoid looping forever in particular corner cases, every LOGF_MAX_ITER
- * the error criteria is relaxed by a factor LOGF_RELAX_MULTIPLIER.
- * todo: might need to adjust the double floating point version too.
- */
-
-#define LOGF_MAX_ITER         10
-#define LOGF_RELAX_MULTIPLIER 2.0F
+#define LN2_HI       0.693359375F
+#define LN2_LO       -2.12194440e-4F
 
 /****************************************************************************
  * Public Functions
@@ -56,59 +51,58 @@
 
 float logf(float x)
 {
-  float y;
-  float y_old;
-  float ey;
-  float epsilon;
-  float relax_factor;
-  int   iter;
-
-  y       = 0.0F;
-  y_old   = 1.0F;
-  epsilon = FLT_EPSILON;
+  union
+    {
+      float f;
+      uint32_t i;
+    } u;
 
-  iter         = 0;
-  relax_factor = 1.0F;
+  float z;
+  float y;
+  int e;
 
-  while (y > y_old + epsilon || y < y_old - epsilon)
+  if (isnan(x) || x == INFINITY_F)
+    {
+      return x;
+    }
+  else if (x < 0.0F)
+    {
+      return NAN_F;
+    }
+  else if (x == 0.0F)
     {
-      y_old = y;
-      ey    = expf(y);
-      y    -= (ey - x) / ey;
-
-      if (y > FLT_MAX_EXP_X)
-        {
-          y = FLT_MAX_EXP_X;
-        }
-
-      if (y < -FLT_MAX_EXP_X)
-        {
-          y = -FLT_MAX_EXP_X;
-        }
-
-      epsilon = (fabsf(y) > 1.0F) ? fabsf(y) * FLT_EPSILON : FLT_EPSILON;
-
-      if (++iter >= LOGF_MAX_ITER)
-        {
-          relax_factor *= LOGF_RELAX_MULTIPLIER;
-          iter = 0;
-        }
-
-      if (relax_factor > 1.0F)
-        {
-          epsilon *= relax_factor;
-        }
+      return -INFINITY_F;
     }
 
-  if (y == FLT_MAX_EXP_X)
+  /* Split x into m * 2^e, with m in [sqrt(2) / 2, sqrt(2)) */
+
+  e   = 0;
+  u.f = x;
+  if (u.i < 0x00800000)
     {
-      return INFINITY_F;
+      u.f *= 0x1p25F;
+      e    = -25;
     }
 
-  if (y == -FLT_MAX_EXP_X)
+  e    += (int)(u.i >> 23) - 126;
+  u.i   = (u.i & 0x007fffff) | 0x3f000000;
+  if (u.f < (float)M_SQRT1_2)
     {
-      return INFINITY_F;
+      e--;
+      u.f += u.f;
     }
 
-  return y;
+  /* log(1 + x) with a Cephes minimax polynomial, within about 1 ulp */
+
+  x = u.f - 1.0F;
+  z = x * x;
+  y = ((((((((7.0376836292e-2F * x - 1.1514610310e-1F) * x +
+             1.1676998740e-1F) * x - 1.2420140846e-1F) * x +
+             1.4249322787e-1F) * x - 1.6668057665e-1F) * x +
+             2.0000714765e-1F) * x - 2.4999993993e-1F) * x +
+             3.3333331174e-1F) * x * z;
+
+  y += e * LN2_LO;
+  y -= 0.5F * z;
+  return x + y + e * LN2_HI;
 }
@@ -27,12 +27,56 @@
 
 #include <math.h>
 
+#include "libm.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 void sincosf(float x, float *s, float *c)
 {
-  *s = sinf(x);
-  *c = cosf(x);
+  float sr;
+  float cr;
+  float r;
+
+  if (isnan(x) || isinff(x))
+    {
+      *s = *c = x - x;
+      return;
+    }
+
+  if (fabsf(x) < 0x1p-12F)
+    {
+      *s = x;
+      *c = 1.0F;
+      return;
+    }
+
+  /* One reduction for both */
+
+  switch (lib_rem_pio2f(x, &r))
+    {
+      case 0:
+        sr = lib_sinf_kernel(r);
+        cr = lib_cosf_kernel(r);
+        break;
+
+      case 1:
+        sr = lib_cosf_kernel(r);
+        cr = -lib_sinf_kernel(r);
+        break;
+
+      case 2:
+        sr = -lib_sinf_kernel(r);
+        cr = -lib_cosf_kernel(r);
+        break;
+
+      default:
+        sr = -lib_cosf_kernel(r);
+        cr = lib_sinf_kernel(r);
+        break;
+    }
+
+  *s = sr;
+  *c = cr;
 }
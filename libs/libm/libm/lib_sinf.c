@@ -29,22 +29,9 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
 #include <math.h>
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-static float _flt_inv_fact[] =
-{
-  1.0 / 1.0,                    /* 1 / 1! */
-  1.0 / 6.0,                    /* 1 / 3! */
-  1.0 / 120.0,                  /* 1 / 5! */
-  1.0 / 5040.0,                 /* 1 / 7! */
-  1.0 / 362880.0,               /* 1 / 9! */
-  1.0 / 39916800.0,             /* 1 / 11! */
-};
+#include "libm.h"
 
 /****************************************************************************
  * Public Functions
@@ -52,53 +39,32 @@ static float _flt_inv_fact[] =
 
 float sinf(float x)
 {
-  float x_squared;
-  float sin_x;
-  size_t i;
-
-  /* Move x to [-pi, pi) */
-
-  x = fmodf(x, 2 * M_PI_F);
-  if (x >= M_PI_F)
-    {
-      x -= 2 * M_PI_F;
-    }
+  float r;
 
-  if (x < -M_PI_F)
+  if (isnan(x) || isinff(x))
     {
-      x += 2 * M_PI_F;
+      return x - x;
     }
 
-  /* Move x to [-pi/2, pi/2) */
+  /* sin(x) rounds to x, keep the sign of -0 */
 
-  if (x >= M_PI_2_F)
+  if (fabsf(x) < 0x1p-12F)
     {
-      x = M_PI_F - x;
+      return x;
     }
 
-  if (x < -M_PI_2_F)
+  switch (lib_rem_pio2f(x, &r))
     {
-      x = -M_PI_F - x;
-    }
+      case 0:
+        return lib_sinf_kernel(r);
 
-  x_squared = x * x;
-  sin_x = 0.0F;
+      case 1:
+        return lib_cosf_kernel(r);
 
-  /* Perform Taylor series approximation for sin(x) with six terms */
+      case 2:
+        return -lib_sinf_kernel(r);
 
-  for (i = 0; i < 6; i++)
-    {
-      if (i % 2 == 0)
-        {
-          sin_x += x * _flt_inv_fact[i];
-        }
-      else
-        {
-          sin_x -= x * _flt_inv_fact[i];
-        }
-
-      x *= x_squared;
+      default:
+        return -lib_cosf_kernel(r);
     }
-
-  return sin_x;
 }
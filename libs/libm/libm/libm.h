@@ -62,6 +62,12 @@ double lib_expi(size_t n);
 
 float lib_sqrtapprox(float x);
 
+/* Defined in lib_libsincosf.c */
+
+int   lib_rem_pio2f(float x, float *r);
+float lib_sinf_kernel(float x);
+float lib_cosf_kernel(float x);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
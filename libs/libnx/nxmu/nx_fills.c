@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_fills.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxbe.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_fills
+ *
+ * Description:
+ *  Fill a batch of rectangles in the window, each with its own color, in
+ *  the order given.  The whole batch is a single message to the server,
+ *  which clips it once where no window covers it.  Returns once the
+ *  server is done with the fills array.
+ *
+ * Input Parameters:
+ *   hwnd   - The window handle
+ *   fills  - The rectangles and their colors
+ *   nfills - The number of entries in fills
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_fills(NXWINDOW hwnd, FAR const struct nx_fill_s *fills,
+             unsigned int nfills)
+{
+  FAR struct nxbe_window_s *wnd = (FAR struct nxbe_window_s *)hwnd;
+  struct nxsvrmsg_fills_s outmsg;
+  sem_t sem_done;
+  int ret;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!wnd || (!fills && nfills > 0))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  if (nfills == 0)
+    {
+      return OK;
+    }
+
+  /* Format the fills command */
+
+  outmsg.msgid  = NX_SVRMSG_FILLS;
+  outmsg.wnd    = wnd;
+  outmsg.fills  = fills;
+  outmsg.nfills = nfills;
+
+  /* Create a semaphore for tracking command completion */
+
+  outmsg.sem_done = &sem_done;
+
+  ret = _SEM_INIT(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: _SEM_INIT failed: %d\n", _SEM_ERRNO(ret));
+      return ret;
+    }
+
+  /* Forward the fills command to the server */
+
+  ret = nxmu_sendwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_fills_s));
+
+  /* Wait that the command is completed, so that caller can release the
+   * fills array.
+   */
+
+  if (ret == OK)
+    {
+      ret = _SEM_WAIT(&sem_done);
+    }
+
+  /* Destroy the semaphore and return. */
+
+  _SEM_DESTROY(&sem_done);
+
+  return ret;
+}
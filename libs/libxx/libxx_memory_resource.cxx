@@ -0,0 +1,332 @@
+//***************************************************************************
+// libs/libxx/libxx_memory_resource.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <debug.h>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/lib/memory_resource.hxx>
+
+#ifdef CONFIG_CXX_MEMORY_RESOURCE
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+namespace
+{
+  class heap_resource_s final : public nuttx::memory_resource
+  {
+  public:
+    // Constant initialized, so it is usable even where static
+    // constructors are not run
+
+    constexpr heap_resource_s() noexcept
+    {
+    }
+
+  private:
+    FAR void *do_allocate(std::size_t bytes, std::size_t alignment)
+      override
+    {
+      FAR void *alloc;
+
+      if (alignment <= alignof(max_align_t))
+        {
+          alloc = lib_malloc(bytes);
+        }
+      else
+        {
+          alloc = lib_memalign(alignment, bytes);
+        }
+
+#ifdef CONFIG_DEBUG_ERROR
+      if (alloc == nullptr)
+        {
+          _err("ERROR: Failed to allocate\n");
+        }
+#endif
+
+      DEBUGASSERT(alloc != nullptr);
+      return alloc;
+    }
+
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+      lib_free(p);
+    }
+
+    bool do_is_equal(const nuttx::memory_resource &other)
+      const noexcept override
+    {
+      return this == &other;
+    }
+  };
+}
+
+struct nuttx::monotonic_resource::chunk_s
+{
+  FAR struct chunk_s *next;
+  std::size_t         size;
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static heap_resource_s g_heap_resource;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The backing memory of the pools of a pool_resource, straight from the
+// heap since the mempool frees it without its size
+
+static FAR void *pool_memalign(FAR void *arg, size_t alignment, size_t size)
+{
+  return lib_memalign(alignment, size);
+}
+
+static size_t pool_malloc_size(FAR void *arg, FAR void *addr)
+{
+  return lib_malloc_size(addr);
+}
+
+static void pool_free(FAR void *arg, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+FAR nuttx::memory_resource *nuttx::heap_resource() noexcept
+{
+  return &g_heap_resource;
+}
+
+//***************************************************************************
+// Name: pool_resource
+//
+// Description:
+//   Create the pools of blocks up to maxblock bytes.  If that fails, all of
+//   the blocks come from the upstream resource.  expandsize must be a power
+//   of two.
+//
+//***************************************************************************
+
+nuttx::pool_resource::pool_resource(FAR const char *name,
+                                    std::size_t maxblock,
+                                    std::size_t expandsize,
+                                    FAR memory_resource *upstream)
+  : m_mpool(nullptr),
+    m_upstream(upstream != nullptr ? upstream : heap_resource()),
+    m_maxblock(0)
+{
+  const std::size_t step = 2 * sizeof(uintptr_t);
+  std::size_t npools = (maxblock + step - 1) / step;
+  FAR size_t *poolsize;
+  std::size_t i;
+
+  if (npools == 0)
+    {
+      return;
+    }
+
+  poolsize = static_cast<FAR size_t *>(lib_malloc(npools *
+                                                  sizeof(size_t)));
+  if (poolsize == nullptr)
+    {
+      return;
+    }
+
+  for (i = 0; i < npools; i++)
+    {
+      poolsize[i] = (i + 1) * step;
+    }
+
+  m_mpool = mempool_multiple_init(name, poolsize, npools,
+                                  pool_memalign, pool_malloc_size,
+                                  pool_free, nullptr, 0, expandsize,
+                                  expandsize);
+  lib_free(poolsize);
+
+  if (m_mpool == nullptr)
+    {
+      _err("ERROR: Failed to create the pools of %s\n", name);
+      return;
+    }
+
+  m_maxblock = npools * step;
+}
+
+nuttx::pool_resource::~pool_resource()
+{
+  if (m_mpool != nullptr)
+    {
+      mempool_multiple_deinit(m_mpool);
+    }
+}
+
+FAR void *nuttx::pool_resource::do_allocate(std::size_t bytes,
+                                            std::size_t alignment)
+{
+  FAR void *alloc;
+
+  if (m_mpool != nullptr && bytes <= m_maxblock)
+    {
+      alloc = mempool_multiple_memalign(m_mpool, alignment,
+                                        bytes > 0 ? bytes : 1);
+      if (alloc != nullptr)
+        {
+          return alloc;
+        }
+    }
+
+  // Too large for the pools, or too much aligned
+
+  return m_upstream->allocate(bytes, alignment);
+}
+
+void nuttx::pool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                         std::size_t alignment)
+{
+  if (m_mpool == nullptr || bytes > m_maxblock ||
+      mempool_multiple_free(m_mpool, p) < 0)
+    {
+      m_upstream->deallocate(p, bytes, alignment);
+    }
+}
+
+//***************************************************************************
+// Name: monotonic_resource
+//***************************************************************************
+
+nuttx::monotonic_resource::monotonic_resource(std::size_t chunksize,
+                                              FAR memory_resource *upstream)
+  : m_upstream(upstream != nullptr ? upstream : heap_resource()),
+    m_chunks(nullptr),
+    m_initial(nullptr),
+    m_initsize(0),
+    m_buffer(nullptr),
+    m_size(0),
+    m_chunksize(chunksize > 0 ? chunksize : 1024)
+{
+}
+
+nuttx::monotonic_resource::monotonic_resource(FAR void *buffer,
+                                              std::size_t size,
+                                              FAR memory_resource *upstream)
+  : m_upstream(upstream != nullptr ? upstream : heap_resource()),
+    m_chunks(nullptr),
+    m_initial(static_cast<FAR char *>(buffer)),
+    m_initsize(size),
+    m_buffer(static_cast<FAR char *>(buffer)),
+    m_size(size),
+    m_chunksize(size > 0 ? 2 * size : 1024)
+{
+}
+
+//***************************************************************************
+// Name: release
+//
+// Description:
+//   Give all of the chunks back to the upstream resource and start over
+//   from the buffer given, if any.
+//
+//***************************************************************************
+
+void nuttx::monotonic_resource::release()
+{
+  FAR struct chunk_s *chunk;
+
+  while ((chunk = m_chunks) != nullptr)
+    {
+      m_chunks = chunk->next;
+      m_upstream->deallocate(chunk, chunk->size);
+    }
+
+  m_buffer = m_initial;
+  m_size   = m_initsize;
+}
+
+FAR void *nuttx::monotonic_resource::do_allocate(std::size_t bytes,
+                                                 std::size_t alignment)
+{
+  FAR struct chunk_s *chunk;
+  std::size_t pad;
+  std::size_t size;
+  FAR char *alloc;
+
+  pad = -reinterpret_cast<uintptr_t>(m_buffer) & (alignment - 1);
+  if (m_buffer == nullptr || bytes > m_size || pad > m_size - bytes)
+    {
+      // Start a new chunk, large enough for the block however the chunk
+      // is aligned
+
+      if (bytes > SIZE_MAX / 2 || alignment > SIZE_MAX / 4)
+        {
+          return nullptr;
+        }
+
+      size = sizeof(struct chunk_s) + bytes + alignment;
+      if (size < m_chunksize)
+        {
+          size = m_chunksize;
+        }
+
+      chunk = static_cast<FAR struct chunk_s *>(m_upstream->allocate(size));
+      if (chunk == nullptr)
+        {
+          return nullptr;
+        }
+
+      chunk->next = m_chunks;
+      chunk->size = size;
+      m_chunks    = chunk;
+      m_buffer    = reinterpret_cast<FAR char *>(chunk + 1);
+      m_size      = size - sizeof(struct chunk_s);
+
+      if (m_chunksize <= SIZE_MAX / 2)
+        {
+          m_chunksize *= 2;
+        }
+
+      pad = -reinterpret_cast<uintptr_t>(m_buffer) & (alignment - 1);
+    }
+
+  alloc     = m_buffer + pad;
+  m_buffer += pad + bytes;
+  m_size   -= pad + bytes;
+  return alloc;
+}
+
+#endif // CONFIG_CXX_MEMORY_RESOURCE
@@ -0,0 +1,391 @@
+/****************************************************************************
+ * mm/circbuf/ringbuf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/ringbuf.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The consumer must see the data before the head that publishes it, and
+ * the producers must be done with the data before the tail that frees it.
+ */
+
+#define ringbuf_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ringbuf_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_copyin
+ *
+ * Description:
+ *   Copy data to the buffer from the index 'pos', wrapping around.
+ *
+ ****************************************************************************/
+
+static void ringbuf_copyin(FAR struct ringbuf_s *ring, size_t pos,
+                           FAR const void *src, size_t bytes)
+{
+  size_t off = pos & (ring->size - 1);
+  size_t len = MIN(bytes, ring->size - off);
+
+  memcpy(ring->base + off, src, len);
+  memcpy(ring->base, (FAR const uint8_t *)src + len, bytes - len);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize a ring buffer.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   base  - A pointer to the ring buffer's internal buffer, e.g. a DMA
+ *           buffer.  If NULL, a buffer of the given size will be
+ *           allocated.
+ *   bytes - The size of the internal buffer, a power of two.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int ringbuf_init(FAR struct ringbuf_s *ring, FAR void *base, size_t bytes)
+{
+  DEBUGASSERT(ring);
+
+  if (bytes == 0 || (bytes & (bytes - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(ring, 0, sizeof(*ring));
+  ring->external = !!base;
+
+  if (!base)
+    {
+      base = kmm_malloc(bytes);
+      if (!base)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  ring->base = base;
+  ring->size = bytes;
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_uninit
+ *
+ * Description:
+ *   Free the ring buffer.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+void ringbuf_uninit(FAR struct ringbuf_s *ring)
+{
+  DEBUGASSERT(ring);
+
+  if (!ring->external)
+    {
+      kmm_free(ring->base);
+    }
+
+  memset(ring, 0, sizeof(*ring));
+}
+
+/****************************************************************************
+ * Name: ringbuf_used
+ *
+ * Description:
+ *   Return the committed bytes not yet consumed.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+size_t ringbuf_used(FAR struct ringbuf_s *ring)
+{
+  DEBUGASSERT(ring);
+  return ringbuf_load(&ring->head) - ringbuf_load(&ring->tail);
+}
+
+/****************************************************************************
+ * Name: ringbuf_space
+ *
+ * Description:
+ *   Return the bytes that can be written.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ ****************************************************************************/
+
+size_t ringbuf_space(FAR struct ringbuf_s *ring)
+{
+  DEBUGASSERT(ring);
+  return ring->size - (ringbuf_load(&ring->reserve) -
+                       ringbuf_load(&ring->tail));
+}
+
+/****************************************************************************
+ * Name: ringbuf_write_reserve
+ *
+ * Description:
+ *   Give the single producer the contiguous free space at the head of the
+ *   buffer.  Nothing is visible to the consumer until
+ *   ringbuf_write_commit() is called.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   ptr   - The location to return the start of the space.
+ *   bytes - The most bytes wanted.
+ *
+ * Returned Value:
+ *   The bytes at ptr, at most 'bytes'; zero if the buffer is full.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_write_reserve(FAR struct ringbuf_s *ring, FAR void **ptr,
+                             size_t bytes)
+{
+  size_t space;
+  size_t off;
+
+  DEBUGASSERT(ring && ptr);
+
+  space = ring->size - (ring->head - ringbuf_load(&ring->tail));
+  off   = ring->head & (ring->size - 1);
+
+  *ptr  = ring->base + off;
+  return MIN(bytes, MIN(space, ring->size - off));
+}
+
+/****************************************************************************
+ * Name: ringbuf_write_commit
+ *
+ * Description:
+ *   Publish the first 'bytes' of the space last reserved.
+ *
+ ****************************************************************************/
+
+void ringbuf_write_commit(FAR struct ringbuf_s *ring, size_t bytes)
+{
+  size_t head = ring->head + bytes;
+
+  DEBUGASSERT(ring && head - ring->tail <= ring->size);
+
+  /* The single producer keeps the reservation in step for ringbuf_space() */
+
+  ring->reserve = head;
+  ringbuf_store(&ring->head, head);
+}
+
+/****************************************************************************
+ * Name: ringbuf_read_reserve
+ *
+ * Description:
+ *   Give the consumer the contiguous committed data at the tail of the
+ *   buffer.  It stays in the buffer until ringbuf_read_commit() is called.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   ptr   - The location to return the start of the data.
+ *   bytes - The most bytes wanted.
+ *
+ * Returned Value:
+ *   The bytes at ptr, at most 'bytes'; zero if the buffer is empty.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_read_reserve(FAR struct ringbuf_s *ring, FAR void **ptr,
+                            size_t bytes)
+{
+  size_t used;
+  size_t off;
+
+  DEBUGASSERT(ring && ptr);
+
+  used = ringbuf_load(&ring->head) - ring->tail;
+  off  = ring->tail & (ring->size - 1);
+
+  *ptr = ring->base + off;
+  return MIN(bytes, MIN(used, ring->size - off));
+}
+
+/****************************************************************************
+ * Name: ringbuf_read_commit
+ *
+ * Description:
+ *   Release the first 'bytes' of the data last reserved to the producers.
+ *
+ ****************************************************************************/
+
+void ringbuf_read_commit(FAR struct ringbuf_s *ring, size_t bytes)
+{
+  DEBUGASSERT(ring && bytes <= ring->head - ring->tail);
+  ringbuf_store(&ring->tail, ring->tail + bytes);
+}
+
+/****************************************************************************
+ * Name: ringbuf_write
+ *
+ * Description:
+ *   Write as much data as fits, as the single producer.  The data is
+ *   published by one commit.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   src   - Address where to get the data.
+ *   bytes - Number of bytes to write.
+ *
+ * Returned Value:
+ *   The bytes written.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_write(FAR struct ringbuf_s *ring, FAR const void *src,
+                     size_t bytes)
+{
+  size_t space;
+
+  DEBUGASSERT(ring && (src || !bytes));
+
+  space = ring->size - (ring->head - ringbuf_load(&ring->tail));
+  bytes = MIN(bytes, space);
+
+  ringbuf_copyin(ring, ring->head, src, bytes);
+  ringbuf_write_commit(ring, bytes);
+  return bytes;
+}
+
+/****************************************************************************
+ * Name: ringbuf_read
+ *
+ * Description:
+ *   Read and consume as much data as there is, up to 'bytes'.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   dst   - Address where to store the data.
+ *   bytes - Number of bytes to read.
+ *
+ * Returned Value:
+ *   The bytes read.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_read(FAR struct ringbuf_s *ring, FAR void *dst,
+                    size_t bytes)
+{
+  size_t used;
+  size_t off;
+  size_t len;
+
+  DEBUGASSERT(ring && (dst || !bytes));
+
+  used  = ringbuf_load(&ring->head) - ring->tail;
+  bytes = MIN(bytes, used);
+  off   = ring->tail & (ring->size - 1);
+  len   = MIN(bytes, ring->size - off);
+
+  memcpy(dst, ring->base + off, len);
+  memcpy((FAR uint8_t *)dst + len, ring->base, bytes - len);
+
+  ringbuf_read_commit(ring, bytes);
+  return bytes;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mp_write
+ *
+ * Description:
+ *   Write all of the data or nothing, as one of several producers.  The
+ *   producers using this function must not use the single producer ones.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring buffer to be used.
+ *   src   - Address where to get the data.
+ *   bytes - Number of bytes to write.
+ *
+ * Returned Value:
+ *   'bytes' on success; -EAGAIN if there is not space for all of it.
+ *
+ ****************************************************************************/
+
+ssize_t ringbuf_mp_write(FAR struct ringbuf_s *ring, FAR const void *src,
+                         size_t bytes)
+{
+  size_t start;
+
+  DEBUGASSERT(ring && (src || !bytes));
+
+  /* Reserve the space; another producer may take it first */
+
+  start = __atomic_load_n(&ring->reserve, __ATOMIC_RELAXED);
+  do
+    {
+      if (ring->size - (start - ringbuf_load(&ring->tail)) < bytes)
+        {
+          return -EAGAIN;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&ring->reserve, &start,
+                                      start + bytes, true,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  ringbuf_copyin(ring, start, src, bytes);
+
+  /* The data is published in the order the space was reserved:  wait for
+   * the producers ahead to publish theirs.
+   */
+
+  while (ringbuf_load(&ring->head) != start)
+    {
+      /* The producer ahead can only be running on another CPU */
+    }
+
+  ringbuf_store(&ring->head, start + bytes);
+  return bytes;
+}
@@ -31,6 +31,7 @@
 
 #include <nuttx/mm/iob.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_MM_IOB
 
@@ -48,6 +49,23 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* A small per-CPU stack of free I/O buffers.  The buffers in the cache are
+ * accounted as allocated in g_iob_sem and g_throttle_sem.
+ */
+
+struct iob_cache_s
+{
+  subsys_lock_t lock;           /* Protects the cache */
+  int16_t ncached;              /* Number of I/O buffers in the cache */
+  FAR struct iob_s *head;       /* Top of the stack */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -80,6 +98,15 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The per-CPU caches and the number of threads in iob_allocwait().  While
+ * any thread waits, freed buffers bypass the caches.
+ */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+extern volatile int16_t g_iob_nwaiting;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -143,5 +170,42 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers of all per-CPU caches to the global free list.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+void iob_cache_drain(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_ncached
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the per-CPU caches.  The value
+ *   is only a snapshot.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_ncached(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_uncharge
+ *
+ * Description:
+ *   Release the owner charge of an I/O buffer that is being freed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NOWNERS > 0
+void iob_uncharge(FAR struct iob_s *iob);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -38,6 +38,40 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU.  Such a buffer is already
+ *   accounted as allocated, so no global state is touched.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+static FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  irqstate_t cflags;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  cflags = subsys_lock(&cache->lock);
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->ncached--;
+    }
+
+  subsys_unlock(&cache->lock, cflags);
+  up_irq_restore(flags);
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -73,6 +107,9 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_OFFLOAD
+      iob->io_offload = 0;   /* No offload requests */
+#endif
     }
 
   leave_critical_section(flags);
@@ -111,6 +148,16 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
   flags = enter_critical_section();
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Announce the waiter before draining the per-CPU caches.  From now on
+   * iob_free() puts buffers on the global lists where this thread can see
+   * them, so no buffer can get stuck in a cache while we are waiting.
+   */
+
+  g_iob_nwaiting++;
+  iob_cache_drain();
+#endif
+
   /* Try to get an I/O buffer.  If successful, the semaphore count will be
    * decremented atomically.
    */
@@ -173,6 +220,10 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
         }
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  g_iob_nwaiting--;
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -248,6 +299,29 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   sem = (throttled ? &g_throttle_sem : &g_iob_sem);
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Unthrottled allocations are served from the per-CPU cache first.
+   * Throttled allocations have to be checked against the global counts so
+   * they always use the global free list.
+   */
+
+  if (!throttled)
+    {
+      iob = iob_cache_alloc();
+      if (iob != NULL)
+        {
+          iob->io_flink  = NULL;
+          iob->io_len    = 0;
+          iob->io_offset = 0;
+          iob->io_pktlen = 0;
+#ifdef CONFIG_IOB_OFFLOAD
+          iob->io_offload = 0;
+#endif
+          return iob;
+        }
+    }
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -302,6 +376,9 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_OFFLOAD
+          iob->io_offload = 0;   /* No offload requests */
+#endif
           return iob;
         }
     }
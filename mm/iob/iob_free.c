@@ -59,58 +59,49 @@
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_notify
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   Signal the IOB notifier every IOB_DIVIDER available I/O buffers.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
-{
-  FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
+static void iob_notify(void)
+{
   int16_t navail;
-#endif
 
-  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
-          iob, iob->io_pktlen, iob->io_len, next);
-
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
    */
 
-  if (next != NULL)
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
     {
-      /* Copy and decrement the total packet length, being careful to
-       * do nothing too crazy.
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
        */
 
-      if (iob->io_pktlen > iob->io_len)
-        {
-          /* Adjust packet length and move it to the next entry */
-
-          next->io_pktlen = iob->io_pktlen - iob->io_len;
-          DEBUGASSERT(next->io_pktlen >= next->io_len);
-        }
-      else
-        {
-          /* This can only happen if the free entry isn't first entry in the
-           * chain...
-           */
+      iob_notifier_signal();
+    }
+}
+#endif
 
-          next->io_pktlen = 0;
-        }
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the global free or committed list.
+ *
+ ****************************************************************************/
 
-      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
-              next, next->io_pktlen, next->io_len);
-    }
+static void iob_release(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
 
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
@@ -153,24 +144,183 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #endif
 
 #ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
+  iob_notify();
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Push one I/O buffer onto the cache of this CPU.  This fails if the
+ *   cache is full or if any thread is waiting for an I/O buffer: that
+ *   thread drained the caches before it started to wait and only looks at
+ *   the global lists.  g_iob_nwaiting is sampled under the cache lock which
+ *   the waiter also takes while draining, so either the waiter finds this
+ *   buffer in the cache or this function sees the waiter.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+static bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+  irqstate_t cflags;
+  bool cached = false;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  cflags = subsys_lock(&cache->lock);
+
+  if (g_iob_nwaiting == 0 && cache->ncached < CONFIG_IOB_PERCPU_CACHE)
+    {
+      iob->io_flink = cache->head;
+      cache->head   = iob;
+      cache->ncached++;
+      cached        = true;
+    }
+
+  subsys_unlock(&cache->lock, cflags);
+  up_irq_restore(flags);
+  return cached;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
+  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
+          iob, iob->io_pktlen, iob->io_len, next);
+
+  /* Copy the data that only exists in the head of a I/O buffer chain into
+   * the next entry.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (next != NULL)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
+      /* Copy and decrement the total packet length, being careful to
+       * do nothing too crazy.
        */
 
-      iob_notifier_signal();
+      if (iob->io_pktlen > iob->io_len)
+        {
+          /* Adjust packet length and move it to the next entry */
+
+          next->io_pktlen = iob->io_pktlen - iob->io_len;
+          DEBUGASSERT(next->io_pktlen >= next->io_len);
+        }
+      else
+        {
+          /* This can only happen if the free entry isn't first entry in the
+           * chain...
+           */
+
+          next->io_pktlen = 0;
+        }
+
+      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
+              next, next->io_pktlen, next->io_len);
+    }
+
+#if CONFIG_IOB_NOWNERS > 0
+  /* Release the quota charge of the owner, if any */
+
+  if (iob->io_owner != 0)
+    {
+      iob_uncharge(iob);
     }
 #endif
 
-  leave_critical_section(flags);
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the buffer on this CPU if possible */
+
+  if (iob_cache_free(iob))
+    {
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_notify();
+#endif
+      return next;
+    }
+#endif
+
+  iob_release(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
   return next;
 }
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers of all per-CPU caches to the global free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      flags = subsys_lock(&cache->lock);
+      iob   = cache->head;
+      cache->head    = NULL;
+      cache->ncached = 0;
+      subsys_unlock(&cache->lock, flags);
+
+      while (iob != NULL)
+        {
+          FAR struct iob_s *next = iob->io_flink;
+
+          iob_release(iob);
+          iob = next;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_ncached
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_ncached(void)
+{
+  int ncached = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ncached += g_iob_cache[cpu].ncached;
+    }
+
+  return ncached;
+}
+#endif
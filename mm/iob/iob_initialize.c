@@ -102,6 +102,16 @@ sem_t g_throttle_sem = SEM_INITIALIZER(CONFIG_IOB_NBUFFERS -
 sem_t g_qentry_sem = SEM_INITIALIZER(CONFIG_IOB_NCHAINS);
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The per-CPU caches of free I/O buffers (all initially empty) */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of threads waiting for an I/O buffer */
+
+volatile int16_t g_iob_nwaiting;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -155,4 +165,11 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      subsys_lock_initialize(&g_iob_cache[i].lock, "iobcache");
+    }
+#endif
 }
@@ -64,6 +64,15 @@ int iob_navail(bool throttled)
         }
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* The per-CPU caches serve unthrottled allocations only */
+
+      if (!throttled)
+        {
+          ret += iob_ncached();
+        }
+#endif
+
       if (ret < 0)
         {
           ret = 0;
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * mm/iob/iob_owner.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_NOWNERS > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct iob_owner_s
+{
+  int16_t nheld;                /* Number of charged I/O buffers */
+  int16_t quota;                /* Maximum of nheld, 0: unlimited */
+  int16_t nmax;                 /* High water mark of nheld */
+  uint32_t ndenied;             /* Number of refused charges */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_owner_s g_iob_owners[CONFIG_IOB_NOWNERS];
+static subsys_lock_t g_iob_ownerlock = SUBSYS_LOCK_INITIALIZER("iobowner");
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_setquota
+ *
+ * Description:
+ *   Set the maximum number of I/O buffers that may be charged to an owner.
+ *   A quota of zero removes the limit.
+ *
+ ****************************************************************************/
+
+int iob_setquota(int owner, int quota)
+{
+  irqstate_t flags;
+
+  if (owner < 1 || owner > CONFIG_IOB_NOWNERS || quota < 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = subsys_lock(&g_iob_ownerlock);
+  g_iob_owners[owner - 1].quota = quota > CONFIG_IOB_NBUFFERS ?
+                                  CONFIG_IOB_NBUFFERS : quota;
+  subsys_unlock(&g_iob_ownerlock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iob_charge
+ *
+ * Description:
+ *   Charge every still uncharged I/O buffer of the chain starting at 'iob'
+ *   to an owner.  Either all buffers are charged or none of them.
+ *
+ ****************************************************************************/
+
+int iob_charge(FAR struct iob_s *iob, int owner)
+{
+  FAR struct iob_owner_s *entry;
+  FAR struct iob_s *tmp;
+  irqstate_t flags;
+  int count = 0;
+
+  if (owner < 1 || owner > CONFIG_IOB_NOWNERS)
+    {
+      return -EINVAL;
+    }
+
+  entry = &g_iob_owners[owner - 1];
+
+  for (tmp = iob; tmp != NULL; tmp = tmp->io_flink)
+    {
+      if (tmp->io_owner == 0)
+        {
+          count++;
+        }
+    }
+
+  if (count == 0)
+    {
+      return OK;
+    }
+
+  flags = subsys_lock(&g_iob_ownerlock);
+
+  if (entry->quota > 0 && entry->nheld + count > entry->quota)
+    {
+      entry->ndenied++;
+      subsys_unlock(&g_iob_ownerlock, flags);
+      return -ENOBUFS;
+    }
+
+  entry->nheld += count;
+  if (entry->nheld > entry->nmax)
+    {
+      entry->nmax = entry->nheld;
+    }
+
+  subsys_unlock(&g_iob_ownerlock, flags);
+
+  for (tmp = iob; tmp != NULL; tmp = tmp->io_flink)
+    {
+      if (tmp->io_owner == 0)
+        {
+          tmp->io_owner = owner;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iob_uncharge
+ *
+ * Description:
+ *   Release the owner charge of an I/O buffer that is being freed.
+ *
+ ****************************************************************************/
+
+void iob_uncharge(FAR struct iob_s *iob)
+{
+  FAR struct iob_owner_s *entry;
+  irqstate_t flags;
+
+  DEBUGASSERT(iob->io_owner > 0 && iob->io_owner <= CONFIG_IOB_NOWNERS);
+  entry = &g_iob_owners[iob->io_owner - 1];
+
+  flags = subsys_lock(&g_iob_ownerlock);
+  DEBUGASSERT(entry->nheld > 0);
+  entry->nheld--;
+  subsys_unlock(&g_iob_ownerlock, flags);
+
+  iob->io_owner = 0;
+}
+
+/****************************************************************************
+ * Name: iob_getownerstats
+ *
+ * Description:
+ *   Return the I/O buffer accounting of one owner.
+ *
+ ****************************************************************************/
+
+int iob_getownerstats(int owner, FAR struct iob_ownerstats_s *stats)
+{
+  FAR struct iob_owner_s *entry;
+  irqstate_t flags;
+
+  if (owner < 1 || owner > CONFIG_IOB_NOWNERS)
+    {
+      return -EINVAL;
+    }
+
+  entry = &g_iob_owners[owner - 1];
+
+  flags = subsys_lock(&g_iob_ownerlock);
+  stats->nheld   = entry->nheld;
+  stats->quota   = entry->quota;
+  stats->nmax    = entry->nmax;
+  stats->ndenied = entry->ndenied;
+  subsys_unlock(&g_iob_ownerlock, flags);
+
+  return OK;
+}
+
+#endif /* CONFIG_IOB_NOWNERS > 0 */
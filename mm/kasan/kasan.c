@@ -28,6 +28,8 @@
 #include <debug.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
+#include <sys/param.h>
 
 #include "kasan.h"
 
@@ -35,23 +37,70 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define KASAN_BYTES_PER_WORD (sizeof(uintptr_t))
-#define KASAN_BITS_PER_WORD  (KASAN_BYTES_PER_WORD * 8)
-
-#define KASAN_FIRST_WORD_MASK(start) \
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
+/* One shadow byte describes a granule of 8 bytes: 0 if all of them are
+ * accessible, 1 to 7 if only that many leading bytes are, negative if none
+ * is.
+ */
+
+#  define KASAN_GRANULE_SHIFT   3
+#  define KASAN_GRANULE_SIZE    (1 << KASAN_GRANULE_SHIFT)
+#  define KASAN_GRANULE_MASK    (KASAN_GRANULE_SIZE - 1)
+#  define KASAN_POISON_VALUE    ((int8_t)0xff)
+
+#  define KASAN_SHADOW_SIZE(size) \
+  (((((size) + KASAN_GRANULE_MASK) >> KASAN_GRANULE_SHIFT) + \
+   sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+#else
+#  define KASAN_BYTES_PER_WORD (sizeof(uintptr_t))
+#  define KASAN_BITS_PER_WORD  (KASAN_BYTES_PER_WORD * 8)
+
+#  define KASAN_FIRST_WORD_MASK(start) \
   (UINTPTR_MAX << ((start) & (KASAN_BITS_PER_WORD - 1)))
-#define KASAN_LAST_WORD_MASK(end) \
+#  define KASAN_LAST_WORD_MASK(end) \
   (UINTPTR_MAX >> (-(end) & (KASAN_BITS_PER_WORD - 1)))
 
-#define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
+#  define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
 
-#define KASAN_SHADOW_SIZE(size) \
+#  define KASAN_SHADOW_SIZE(size) \
   (KASAN_BYTES_PER_WORD * ((size) / KASAN_SHADOW_SCALE / KASAN_BITS_PER_WORD))
+#endif
+
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
 #define KASAN_INIT_VALUE            0xDEADCAFE
 
+/* Define the compiler entry points of one access size.  The size is a
+ * constant, so that the checks of each size are specialized inline.
+ */
+
+#define DEFINE_ASAN_LOAD_STORE(size) \
+  void __asan_report_load##size##_noabort(FAR void *addr) \
+  { \
+    kasan_report(addr, size, false); \
+  } \
+  void __asan_report_store##size##_noabort(FAR void *addr) \
+  { \
+    kasan_report(addr, size, true); \
+  } \
+  void __asan_load##size##_noabort(FAR void *addr) \
+  { \
+    kasan_check(addr, size, false); \
+  } \
+  void __asan_store##size##_noabort(FAR void *addr) \
+  { \
+    kasan_check(addr, size, true); \
+  } \
+  void __asan_load##size(FAR void *addr) \
+  { \
+    kasan_check(addr, size, false); \
+  } \
+  void __asan_store##size(FAR void *addr) \
+  { \
+    kasan_check(addr, size, true); \
+  }
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,11 +125,10 @@ static uint32_t g_region_init;
  * Private Functions
  ****************************************************************************/
 
-static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                                          unsigned int *bit)
+static always_inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
   FAR struct kasan_region_s *region;
-  uintptr_t addr = (uintptr_t)ptr;
 
   if (g_region_init != KASAN_INIT_VALUE)
     {
@@ -91,11 +139,7 @@ static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
     {
       if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= region->end);
-          addr -= region->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &region->shadow[addr / KASAN_BITS_PER_WORD];
+          return region;
         }
     }
 
@@ -117,6 +161,149 @@ static void kasan_report(FAR const void *addr, size_t size, bool is_write)
   --recursion;
 }
 
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
+static always_inline_function FAR int8_t *
+kasan_mem_to_shadow(uintptr_t addr)
+{
+  FAR struct kasan_region_s *region = kasan_find_region(addr);
+
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  return (FAR int8_t *)region->shadow +
+         ((addr - region->begin) >> KASAN_GRANULE_SHIFT);
+}
+
+/* Check whether the bytes of a granule up to the one at 'last' are not all
+ * accessible, 'value' being the shadow of the granule.
+ */
+
+static always_inline_function bool kasan_granule_poisoned(int8_t value,
+                                                          uintptr_t last)
+{
+  return value != 0 && (int8_t)(last & KASAN_GRANULE_MASK) >= value;
+}
+
+static always_inline_function bool kasan_is_poisoned(FAR const void *addr,
+                                                     size_t size)
+{
+  uintptr_t begin = (uintptr_t)addr;
+  uintptr_t last = begin + size - 1;
+  FAR int8_t *p;
+  size_t n;
+
+  p = kasan_mem_to_shadow(begin);
+  if (p == NULL)
+    {
+      return false;
+    }
+
+  /* An access within one granule, the common case of an aligned access
+   * of 1, 2, 4 or 8 bytes, takes a single shadow byte.
+   */
+
+  n = (last >> KASAN_GRANULE_SHIFT) - (begin >> KASAN_GRANULE_SHIFT);
+  if (n == 0)
+    {
+      return kasan_granule_poisoned(*p, last);
+    }
+
+  DEBUGASSERT(last < kasan_find_region(begin)->end);
+
+  /* The granules before the last one must be entirely accessible */
+
+  for (; n > 0; n--)
+    {
+      if (*p++ != 0)
+        {
+          return true;
+        }
+    }
+
+  return kasan_granule_poisoned(*p, last);
+}
+
+static void kasan_set_poison(FAR const void *addr, size_t size,
+                             bool poisoned)
+{
+  uintptr_t begin = (uintptr_t)addr;
+  uintptr_t end = begin + size;
+  uintptr_t granule;
+  FAR int8_t *p;
+  int8_t head;
+  int8_t tail;
+  int flags;
+
+  if (size == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_lock);
+
+  p = kasan_mem_to_shadow(begin);
+  DEBUGASSERT(p != NULL);
+
+  /* Partial granules are shared with the neighbour objects, whose state
+   * is kept: a partial granule is never made less accessible than the
+   * neighbours need.  Unaligned objects may thus miss some errors, but
+   * never report false ones.
+   */
+
+  for (granule = begin & ~KASAN_GRANULE_MASK; granule < end;
+       granule += KASAN_GRANULE_SIZE, p++)
+    {
+      head = MAX(begin, granule) - granule;
+      tail = MIN(end, granule + KASAN_GRANULE_SIZE) - granule;
+
+      if (!poisoned)
+        {
+          if (tail == KASAN_GRANULE_SIZE)
+            {
+              *p = 0;
+            }
+          else if (*p != 0 && *p < tail)
+            {
+              *p = tail;
+            }
+        }
+      else if (tail == KASAN_GRANULE_SIZE)
+        {
+          if (head == 0)
+            {
+              *p = KASAN_POISON_VALUE;
+            }
+          else if (*p == 0 || *p > head)
+            {
+              *p = head;
+            }
+        }
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+}
+#else
+static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                                          unsigned int *bit)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
+
+  region = kasan_find_region(addr);
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
+}
+
 static bool kasan_is_poisoned(FAR const void *addr, size_t size)
 {
   FAR uintptr_t *p;
@@ -177,6 +364,16 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+#endif
+
+static always_inline_function void kasan_check(FAR const void *addr,
+                                               size_t size, bool is_write)
+{
+  if (kasan_is_poisoned(addr, size))
+    {
+      kasan_report(addr, size, is_write);
+    }
+}
 
 /****************************************************************************
  * Public Functions
@@ -211,7 +408,11 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   g_region_init = KASAN_INIT_VALUE;
   spin_unlock_irqrestore(&g_lock, flags);
 
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
+  memset(region->shadow, KASAN_POISON_VALUE, KASAN_SHADOW_SIZE(*size));
+#else
   kasan_poison(addr, *size);
+#endif
   *size -= KASAN_REGION_SIZE(*size);
 }
 
@@ -250,178 +451,28 @@ void __asan_report_store_n_noabort(FAR void *addr, size_t size)
   kasan_report(addr, size, true);
 }
 
-void __asan_report_load16_noabort(FAR void *addr)
-{
-  __asan_report_load_n_noabort(addr, 16);
-}
-
-void __asan_report_store16_noabort(FAR void *addr)
-{
-  __asan_report_store_n_noabort(addr, 16);
-}
-
-void __asan_report_load8_noabort(FAR void *addr)
-{
-  __asan_report_load_n_noabort(addr, 8);
-}
-
-void __asan_report_store8_noabort(FAR void *addr)
-{
-  __asan_report_store_n_noabort(addr, 8);
-}
-
-void __asan_report_load4_noabort(FAR void *addr)
-{
-  __asan_report_load_n_noabort(addr, 4);
-}
-
-void __asan_report_store4_noabort(FAR void *addr)
-{
-  __asan_report_store_n_noabort(addr, 4);
-}
-
-void __asan_report_load2_noabort(FAR void *addr)
-{
-  __asan_report_load_n_noabort(addr, 2);
-}
-
-void __asan_report_store2_noabort(FAR void *addr)
-{
-  __asan_report_store_n_noabort(addr, 2);
-}
-
-void __asan_report_load1_noabort(FAR void *addr)
-{
-  __asan_report_load_n_noabort(addr, 1);
-}
-
-void __asan_report_store1_noabort(FAR void *addr)
-{
-  __asan_report_store_n_noabort(addr, 1);
-}
-
 void __asan_loadN_noabort(FAR void *addr, size_t size)
 {
-  if (kasan_is_poisoned(addr, size))
-    {
-      kasan_report(addr, size, false);
-    }
-}
-
-void __asan_storeN_noabort(FAR void * addr, size_t size)
-{
-  if (kasan_is_poisoned(addr, size))
-    {
-      kasan_report(addr, size, true);
-    }
-}
-
-void __asan_load16_noabort(FAR void *addr)
-{
-  __asan_loadN_noabort(addr, 16);
-}
-
-void __asan_store16_noabort(FAR void *addr)
-{
-  __asan_storeN_noabort(addr, 16);
-}
-
-void __asan_load8_noabort(FAR void *addr)
-{
-  __asan_loadN_noabort(addr, 8);
-}
-
-void __asan_store8_noabort(FAR void *addr)
-{
-  __asan_storeN_noabort(addr, 8);
-}
-
-void __asan_load4_noabort(FAR void *addr)
-{
-  __asan_loadN_noabort(addr, 4);
-}
-
-void __asan_store4_noabort(FAR void *addr)
-{
-  __asan_storeN_noabort(addr, 4);
-}
-
-void __asan_load2_noabort(FAR void *addr)
-{
-  __asan_loadN_noabort(addr, 2);
-}
-
-void __asan_store2_noabort(FAR void *addr)
-{
-  __asan_storeN_noabort(addr, 2);
+  kasan_check(addr, size, false);
 }
 
-void __asan_load1_noabort(FAR void *addr)
+void __asan_storeN_noabort(FAR void *addr, size_t size)
 {
-  __asan_loadN_noabort(addr, 1);
-}
-
-void __asan_store1_noabort(FAR void *addr)
-{
-  __asan_storeN_noabort(addr, 1);
+  kasan_check(addr, size, true);
 }
 
 void __asan_loadN(FAR void *addr, size_t size)
 {
-  __asan_loadN_noabort(addr, size);
+  kasan_check(addr, size, false);
 }
 
 void __asan_storeN(FAR void *addr, size_t size)
 {
-  __asan_storeN_noabort(addr, size);
-}
-
-void __asan_load16(FAR void *addr)
-{
-  __asan_load16_noabort(addr);
+  kasan_check(addr, size, true);
 }
 
-void __asan_store16(FAR void *addr)
-{
-  __asan_store16_noabort(addr);
-}
-
-void __asan_load8(FAR void *addr)
-{
-  __asan_load8_noabort(addr);
-}
-
-void __asan_store8(FAR void *addr)
-{
-  __asan_store8_noabort(addr);
-}
-
-void __asan_load4(FAR void *addr)
-{
-  __asan_load4_noabort(addr);
-}
-
-void __asan_store4(FAR void *addr)
-{
-  __asan_store4_noabort(addr);
-}
-
-void __asan_load2(FAR void *addr)
-{
-  __asan_load2_noabort(addr);
-}
-
-void __asan_store2(FAR void *addr)
-{
-  __asan_store2_noabort(addr);
-}
-
-void __asan_load1(FAR void *addr)
-{
-  __asan_load1_noabort(addr);
-}
-
-void __asan_store1(FAR void *addr)
-{
-  __asan_store1_noabort(addr);
-}
+DEFINE_ASAN_LOAD_STORE(1)
+DEFINE_ASAN_LOAD_STORE(2)
+DEFINE_ASAN_LOAD_STORE(4)
+DEFINE_ASAN_LOAD_STORE(8)
+DEFINE_ASAN_LOAD_STORE(16)
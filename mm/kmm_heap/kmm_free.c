@@ -52,6 +52,16 @@
 
 void kmm_free(FAR void *mem)
 {
+#ifdef CONFIG_MM_REGION
+  FAR struct mm_heap_s *heap = mm_region_heapof(mem);
+
+  if (heap != NULL)
+    {
+      mm_free(heap, mem);
+      return;
+    }
+#endif
+
   DEBUGASSERT((mem == NULL) || kmm_heapmember(mem));
   mm_free(g_kmmheap, mem);
 }
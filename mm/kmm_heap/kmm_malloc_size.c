@@ -34,6 +34,15 @@
 
 size_t kmm_malloc_size(FAR void *mem)
 {
+#ifdef CONFIG_MM_REGION
+  FAR struct mm_heap_s *heap = mm_region_heapof(mem);
+
+  if (heap != NULL)
+    {
+      return mm_malloc_size(heap, mem);
+    }
+#endif
+
   return mm_malloc_size(g_kmmheap, mem);
 }
 
@@ -49,6 +49,15 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
+#ifdef CONFIG_MM_REGION
+  FAR struct mm_heap_s *heap = mm_region_heapof(oldmem);
+
+  if (heap != NULL)
+    {
+      return mm_realloc(heap, oldmem, newsize);
+    }
+#endif
+
   return mm_realloc(g_kmmheap, oldmem, newsize);
 }
 
@@ -26,6 +26,7 @@
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
 #include <nuttx/kmalloc.h>
@@ -43,6 +44,16 @@
 #undef  ALIGN_UP
 #define ALIGN_UP(x, a) (((x) + ((a) - 1)) & (~((a) - 1)))
 
+/* The per-CPU magazines need to disable local interrupts, which is only
+ * possible in the kernel.
+ */
+
+#if defined(MEMPOOL_HAVE_MAGAZINE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_MAGAZINE
+#  define MEMPOOL_MAGAZINE_BATCH ((CONFIG_MM_MEMPOOL_MAGAZINE + 1) / 2)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -108,6 +119,148 @@ static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
 }
 #endif
 
+#ifdef MEMPOOL_MAGAZINE
+static inline FAR struct mempool_magazine_s *
+mempool_magazine(FAR struct mempool_s *pool)
+{
+  return &pool->magazines[up_cpu_index()];
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_alloc
+ *
+ * Description:
+ *   Take a block from the magazine of the current CPU.  An empty magazine
+ *   is refilled with half a magazine of blocks from the shared queue.
+ *
+ * Returned Value:
+ *   The block, or NULL if the shared queue has no free block either.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_magazine_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blks[MEMPOOL_MAGAZINE_BATCH];
+  FAR void *blk = NULL;
+  irqstate_t flags;
+  size_t nblks;
+
+  flags = up_irq_save();
+  mag = mempool_magazine(pool);
+  if (mag->nblks > 0)
+    {
+      blk = mag->blks[--mag->nblks];
+    }
+
+  up_irq_restore(flags);
+
+  if (blk != NULL)
+    {
+      kasan_unpoison(blk, pool->blocksize);
+      return blk;
+    }
+
+  /* Refill from the shared queue with a single lock round trip */
+
+  nblks = mempool_allocbatch(pool, blks, MEMPOOL_MAGAZINE_BATCH);
+  if (nblks == 0)
+    {
+      return NULL;
+    }
+
+  blk = blks[--nblks];
+
+  /* We may have been moved to another CPU meanwhile; that just fills the
+   * magazine we are on now.
+   */
+
+  flags = up_irq_save();
+  mag = mempool_magazine(pool);
+  while (nblks > 0 && mag->nblks < CONFIG_MM_MEMPOOL_MAGAZINE)
+    {
+      FAR void *tmp = blks[--nblks];
+
+      kasan_poison(tmp, pool->blocksize);
+      mag->blks[mag->nblks++] = tmp;
+    }
+
+  up_irq_restore(flags);
+
+  if (nblks > 0)
+    {
+      mempool_freebatch(pool, blks, nblks);
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_free
+ *
+ * Description:
+ *   Put a block into the magazine of the current CPU.  When the magazine
+ *   is full, the coldest half of it goes back to the shared queue first.
+ *
+ ****************************************************************************/
+
+static void mempool_magazine_free(FAR struct mempool_s *pool,
+                                  FAR void *blk)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blks[MEMPOOL_MAGAZINE_BATCH];
+  irqstate_t flags;
+  size_t nblks = 0;
+
+  kasan_poison(blk, pool->blocksize);
+
+  flags = up_irq_save();
+  mag = mempool_magazine(pool);
+  if (mag->nblks >= CONFIG_MM_MEMPOOL_MAGAZINE)
+    {
+      nblks = MEMPOOL_MAGAZINE_BATCH;
+      memcpy(blks, mag->blks, nblks * sizeof(FAR void *));
+      memmove(mag->blks, &mag->blks[nblks],
+              (mag->nblks - nblks) * sizeof(FAR void *));
+      mag->nblks -= nblks;
+    }
+
+  mag->blks[mag->nblks++] = blk;
+  up_irq_restore(flags);
+
+  if (nblks > 0)
+    {
+      mempool_freebatch(pool, blks, nblks);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_count
+ *
+ * Description:
+ *   Return the number of blocks cached in the magazines of all CPUs.  The
+ *   magazines of the other CPUs are read without synchronization, so the
+ *   result is only a snapshot.
+ *
+ ****************************************************************************/
+
+static size_t mempool_magazine_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int i;
+
+  if (pool->magazines != NULL)
+    {
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          count += pool->magazines[i].nblks;
+        }
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -191,6 +344,27 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       nxsem_init(&pool->waitsem, 0, 0);
     }
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  /* The magazines are an optional cache: run without them if they can't
+   * be allocated.  Blocks cached per CPU could starve a waiter, so a pool
+   * that waits for free blocks has none.
+   */
+
+  pool->magazines = NULL;
+#  ifdef MEMPOOL_MAGAZINE
+  if (pool->percpu && !(pool->wait && pool->expandsize == 0))
+    {
+      size_t size = CONFIG_SMP_NCPUS * sizeof(struct mempool_magazine_s);
+
+      pool->magazines = pool->alloc(pool, size);
+      if (pool->magazines != NULL)
+        {
+          memset(pool->magazines, 0, size);
+        }
+    }
+#  endif
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   mempool_procfs_register(&pool->procfs, name);
 #  ifdef CONFIG_MM_BACKTRACE_DEFAULT
@@ -223,6 +397,19 @@ FAR void *mempool_alloc(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef MEMPOOL_MAGAZINE
+  /* Try the lockless magazine of this CPU first */
+
+  if (pool->magazines != NULL)
+    {
+      blk = mempool_magazine_alloc(pool);
+      if (blk != NULL)
+        {
+          return blk;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(&pool->queue);
@@ -297,12 +484,27 @@ out_with_lock:
 
 void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+#ifdef MEMPOOL_MAGAZINE
+  /* The interrupt blocks always go back to their own queue */
+
+  if (pool->magazines != NULL &&
+      (pool->interruptsize <= blocksize || (FAR char *)blk < pool->ibase ||
+       (FAR char *)blk >= pool->ibase + pool->interruptsize - blocksize))
+    {
+      mempool_magazine_free(pool, blk);
+      return;
+    }
+#endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+#if CONFIG_MM_BACKTRACE >= 0
   list_delete(&buf->node);
 #else
   pool->nalloc--;
@@ -339,6 +541,364 @@ void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
     }
 }
 
+/****************************************************************************
+ * Name: mempool_allocbatch
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a memory pool, taking the pool lock
+ *   only once.  Unlike mempool_alloc(), this neither expands the pool, nor
+ *   waits, nor uses the interrupt blocks.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array receiving the allocated blocks.
+ *   nblks - The maximum number of blocks to allocate.
+ *
+ * Returned Value:
+ *   The number of blocks allocated.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE < 0
+size_t mempool_allocbatch(FAR struct mempool_s *pool, FAR void **blks,
+                          size_t nblks)
+{
+  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  size_t i;
+
+  for (i = 0; i < nblks; i++)
+    {
+      blks[i] = mempool_remove_queue(&pool->queue);
+      if (blks[i] == NULL)
+        {
+          break;
+        }
+
+      kasan_unpoison(blks[i], pool->blocksize);
+    }
+
+  pool->nalloc += i;
+  spin_unlock_irqrestore(&pool->lock, flags);
+  return i;
+}
+#endif
+
+/****************************************************************************
+ * Name: mempool_freebatch
+ *
+ * Description:
+ *   Release nblks memory blocks to the pool, taking the pool lock only
+ *   once.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of blocks to release.
+ *   nblks - The number of blocks in blks.
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE < 0
+void mempool_freebatch(FAR struct mempool_s *pool, FAR void **blks,
+                       size_t nblks)
+{
+  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t i;
+
+  for (i = 0; i < nblks; i++)
+    {
+      FAR char *blk = blks[i];
+
+      if (pool->interruptsize > blocksize && blk >= pool->ibase &&
+          blk < pool->ibase + pool->interruptsize - blocksize)
+        {
+          sq_addfirst((FAR sq_entry_t *)blk, &pool->iqueue);
+        }
+      else
+        {
+          sq_addfirst((FAR sq_entry_t *)blk, &pool->queue);
+        }
+
+      kasan_poison(blk, pool->blocksize);
+    }
+
+  pool->nalloc -= nblks;
+  spin_unlock_irqrestore(&pool->lock, flags);
+  if (nblks > 0 && pool->wait && pool->expandsize == 0)
+    {
+      int semcount;
+
+      nxsem_get_value(&pool->waitsem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&pool->waitsem);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: mempool_alloc_bulk
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a memory pool.  The blocks are taken
+ *   from the magazine of the current CPU, then from the pool with a single
+ *   lock round trip, and the rest one by one with mempool_alloc().  Unlike
+ *   mempool_alloc(), this never waits for a block to be freed.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array receiving the allocated blocks.
+ *   nblks - The maximum number of blocks to allocate.
+ *
+ * Returned Value:
+ *   The number of blocks allocated.
+ *
+ ****************************************************************************/
+
+size_t mempool_alloc_bulk(FAR struct mempool_s *pool, FAR void **blks,
+                          size_t nblks)
+{
+  size_t count = 0;
+
+#ifdef MEMPOOL_MAGAZINE
+  if (pool->magazines != NULL)
+    {
+      FAR struct mempool_magazine_s *mag;
+      irqstate_t flags;
+
+      flags = up_irq_save();
+      mag = mempool_magazine(pool);
+      while (count < nblks && mag->nblks > 0)
+        {
+          blks[count] = mag->blks[--mag->nblks];
+          kasan_unpoison(blks[count++], pool->blocksize);
+        }
+
+      up_irq_restore(flags);
+    }
+#endif
+
+#if CONFIG_MM_BACKTRACE < 0
+  if (count < nblks)
+    {
+      count += mempool_allocbatch(pool, blks + count, nblks - count);
+    }
+#endif
+
+  /* Expand the pool or use the interrupt blocks for the rest, but never
+   * wait.
+   */
+
+  while (count < nblks && !(pool->wait && pool->expandsize == 0))
+    {
+      blks[count] = mempool_alloc(pool);
+      if (blks[count] == NULL)
+        {
+          break;
+        }
+
+      count++;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: mempool_free_bulk
+ *
+ * Description:
+ *   Release nblks memory blocks to the pool.  The blocks fill the magazine
+ *   of the current CPU, the rest goes to the pool with a single lock round
+ *   trip.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of blocks to release.
+ *   nblks - The number of blocks in blks.
+ ****************************************************************************/
+
+void mempool_free_bulk(FAR struct mempool_s *pool, FAR void **blks,
+                       size_t nblks)
+{
+#if CONFIG_MM_BACKTRACE < 0
+#  ifdef MEMPOOL_MAGAZINE
+  if (pool->magazines != NULL)
+    {
+      size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+      FAR struct mempool_magazine_s *mag;
+      irqstate_t flags;
+      size_t i;
+
+      /* Keep the normal blocks in the magazine while it has room; move the
+       * others to the front of the array for the shared queues.
+       */
+
+      flags = up_irq_save();
+      mag = mempool_magazine(pool);
+      for (i = nblks; i-- > 0; )
+        {
+          FAR char *blk = blks[i];
+
+          if (mag->nblks < CONFIG_MM_MEMPOOL_MAGAZINE &&
+              (pool->interruptsize <= blocksize || blk < pool->ibase ||
+               blk >= pool->ibase + pool->interruptsize - blocksize))
+            {
+              kasan_poison(blk, pool->blocksize);
+              mag->blks[mag->nblks++] = blk;
+              blks[i] = blks[--nblks];
+            }
+        }
+
+      up_irq_restore(flags);
+    }
+#  endif
+
+  mempool_freebatch(pool, blks, nblks);
+#else
+  while (nblks-- > 0)
+    {
+      mempool_free(pool, *blks++);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mempool_shrink
+ *
+ * Description:
+ *   Return to the heap the blocks that the memory pool expanded with and
+ *   of which no block is in use.  The initial and the interrupt blocks are
+ *   kept.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *
+ * Returned Value:
+ *   The number of bytes returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mempool_shrink(FAR struct mempool_s *pool)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  FAR sq_entry_t *blk;
+  FAR sq_entry_t *blkprev;
+  sq_queue_t release;
+  irqstate_t flags;
+  size_t nexpand;
+  size_t released = 0;
+  size_t size;
+  size_t nfree;
+
+  if (pool->expandsize < blocksize + sizeof(sq_entry_t))
+    {
+      return 0;
+    }
+
+  nexpand = (pool->expandsize - sizeof(sq_entry_t)) / blocksize;
+  size    = nexpand * blocksize + sizeof(sq_entry_t);
+  sq_init(&release);
+
+#ifdef MEMPOOL_MAGAZINE
+  /* Give back the blocks cached by this CPU, the magazines of the other
+   * CPUs can't be touched from here.
+   */
+
+  if (pool->magazines != NULL)
+    {
+      FAR struct mempool_magazine_s *mag;
+
+      flags = up_irq_save();
+      mag = mempool_magazine(pool);
+      mempool_freebatch(pool, mag->blks, mag->nblks);
+      mag->nblks = 0;
+      up_irq_restore(flags);
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
+
+  /* The initial block, if any, is the first one of equeue */
+
+  entry = pool->equeue.head;
+  if (entry != NULL && pool->initialsize >= blocksize + sizeof(sq_entry_t))
+    {
+      prev  = entry;
+      entry = entry->flink;
+    }
+
+  for (; entry != NULL; entry = next)
+    {
+      FAR char *base = (FAR char *)entry - nexpand * blocksize;
+
+      next = entry->flink;
+
+      /* Count the free blocks of this expansion */
+
+      nfree = 0;
+      sq_for_every(&pool->queue, blk)
+        {
+          if ((FAR char *)blk >= base && blk < entry)
+            {
+              nfree++;
+            }
+        }
+
+      if (nfree < nexpand)
+        {
+          prev = entry;
+          continue;
+        }
+
+      /* All are free: take them out of the free queue */
+
+      for (blkprev = NULL, blk = pool->queue.head; blk != NULL; )
+        {
+          if ((FAR char *)blk >= base && blk < entry)
+            {
+              blk = blk->flink;
+              if (blkprev == NULL)
+                {
+                  sq_remfirst(&pool->queue);
+                }
+              else
+                {
+                  sq_remafter(blkprev, &pool->queue);
+                }
+            }
+          else
+            {
+              blkprev = blk;
+              blk     = blk->flink;
+            }
+        }
+
+      if (prev == NULL)
+        {
+          sq_remfirst(&pool->equeue);
+        }
+      else
+        {
+          sq_remafter(prev, &pool->equeue);
+        }
+
+      sq_addlast(entry, &release);
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  while ((entry = sq_remfirst(&release)) != NULL)
+    {
+      pool->free(pool, (FAR char *)entry - nexpand * blocksize);
+      released += size;
+    }
+
+  return released;
+}
+
 /****************************************************************************
  * Name: mempool_info
  *
@@ -357,6 +917,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+#ifdef MEMPOOL_MAGAZINE
+  size_t nblks;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
@@ -367,6 +930,13 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->aordblks = list_length(&pool->alist);
 #else
   info->aordblks = pool->nalloc;
+#endif
+#ifdef MEMPOOL_MAGAZINE
+  /* The blocks cached by the CPUs are free */
+
+  nblks = mempool_magazine_count(pool);
+  info->aordblks -= nblks;
+  info->ordblks += nblks;
 #endif
   info->arena =
     mempool_queue_lenth(&pool->equeue) * sizeof(sq_entry_t) +
@@ -408,14 +978,23 @@ mempool_info_task(FAR struct mempool_s *pool,
       size_t count = mempool_queue_lenth(&pool->queue) +
                      mempool_queue_lenth(&pool->iqueue);
 
+#ifdef MEMPOOL_MAGAZINE
+      count += mempool_magazine_count(pool);
+#endif
+
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE < 0
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#ifdef MEMPOOL_MAGAZINE
+      count -= mempool_magazine_count(pool);
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #else
   else
@@ -531,6 +1110,20 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef MEMPOOL_MAGAZINE
+  if (pool->magazines != NULL)
+    {
+      int i;
+
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          mempool_freebatch(pool, pool->magazines[i].blks,
+                            pool->magazines[i].nblks);
+          pool->magazines[i].nblks = 0;
+        }
+    }
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
   if (!list_is_empty(&pool->alist))
 #else
@@ -572,6 +1165,14 @@ int mempool_deinit(FAR struct mempool_s *pool)
       pool->free(pool, pool->ibase);
     }
 
+#ifdef MEMPOOL_MAGAZINE
+  if (pool->magazines != NULL)
+    {
+      pool->free(pool, pool->magazines);
+      pool->magazines = NULL;
+    }
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_destroy(&pool->waitsem);
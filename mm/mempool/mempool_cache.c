@@ -0,0 +1,313 @@
+/****************************************************************************
+ * mm/mempool/mempool_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MEMPOOL_CACHE_ALIGN CONFIG_MM_MEMPOOL_CACHE_ALIGN
+
+#if (MEMPOOL_CACHE_ALIGN & (MEMPOOL_CACHE_ALIGN - 1)) != 0
+#  error CONFIG_MM_MEMPOOL_CACHE_ALIGN must be a power of two
+#endif
+
+#undef  ALIGN_UP
+#define ALIGN_UP(x, a) (((x) + ((a) - 1)) & (~((a) - 1)))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHRINK
+static size_t mempool_cache_shrink(FAR struct mm_shrinker_s *shrinker,
+                                   size_t size);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct mempool_cache_s *g_mempool_caches;
+static spinlock_t g_mempool_cache_lock;
+
+#ifdef CONFIG_MM_SHRINK
+/* The free objects of the caches are the cheapest memory to give back */
+
+static struct mm_shrinker_s g_mempool_cache_shrinker =
+{
+  NULL,                    /* flink */
+  mempool_cache_shrink,    /* shrink */
+  "mempool_cache",         /* name */
+  0                        /* priority */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_cache_expand
+ *
+ * Description:
+ *   Allocate an expansion of the pool of a cache, aligned like its objects.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_cache_expand(FAR struct mempool_s *pool,
+                                      size_t size)
+{
+  return kmm_memalign(MEMPOOL_CACHE_ALIGN, size);
+}
+
+/****************************************************************************
+ * Name: mempool_cache_release
+ ****************************************************************************/
+
+static void mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+/****************************************************************************
+ * Name: mempool_cache_shrink
+ *
+ * Description:
+ *   The shrinker of the caches, called under memory pressure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SHRINK
+static size_t mempool_cache_shrink(FAR struct mm_shrinker_s *shrinker,
+                                   size_t size)
+{
+  return mempool_cache_reclaim();
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_cache_init
+ *
+ * Description:
+ *   Initialize a cache of objects of 'objsize' bytes.  The objects are
+ *   aligned to CONFIG_MM_MEMPOOL_CACHE_ALIGN, so that two objects never
+ *   share a cache line.  The cache grows by 'nexpand' objects at a time
+ *   and gives the memory back on mempool_cache_reclaim().
+ *
+ * Input Parameters:
+ *   cache   - The cache to initialize.
+ *   name    - The name of the cache.
+ *   objsize - The size of an object.
+ *   nexpand - The number of objects to grow the cache by.
+ *   ctor    - Called on each object allocated; NULL to zero the objects.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int mempool_cache_init(FAR struct mempool_cache_s *cache,
+                       FAR const char *name, size_t objsize,
+                       size_t nexpand, mempool_ctor_t ctor)
+{
+  FAR struct mempool_s *pool = &cache->pool;
+  irqstate_t flags;
+  bool first;
+  int ret;
+
+  DEBUGASSERT(cache != NULL && objsize > 0 && nexpand > 0);
+
+  memset(cache, 0, sizeof(struct mempool_cache_s));
+
+  /* A free object holds the link of the free queue */
+
+  pool->blocksize  = ALIGN_UP(MAX(objsize, sizeof(sq_entry_t)),
+                              MEMPOOL_CACHE_ALIGN);
+#if CONFIG_MM_BACKTRACE >= 0
+  pool->blockalign = MEMPOOL_CACHE_ALIGN;
+#endif
+  pool->expandsize = nexpand * MEMPOOL_REALBLOCKSIZE(pool) +
+                     sizeof(sq_entry_t);
+  pool->priv       = cache;
+  pool->alloc      = mempool_cache_expand;
+  pool->free       = mempool_cache_release;
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  pool->percpu     = true;
+#endif
+
+  cache->name      = name;
+  cache->ctor      = ctor;
+  cache->objsize   = objsize;
+
+  ret = mempool_init(pool, name);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = spin_lock_irqsave(&g_mempool_cache_lock);
+  first            = g_mempool_caches == NULL;
+  cache->flink     = g_mempool_caches;
+  g_mempool_caches = cache;
+  spin_unlock_irqrestore(&g_mempool_cache_lock, flags);
+
+#ifdef CONFIG_MM_SHRINK
+  if (first)
+    {
+      mm_register_shrinker(&g_mempool_cache_shrinker);
+    }
+#endif
+
+  UNUSED(first);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_alloc
+ *
+ * Description:
+ *   Allocate a constructed object from a cache.  If the heap is exhausted,
+ *   the unused memory of all caches is reclaimed and the allocation tried
+ *   again.
+ *
+ *   The link of the free queue is kept in the free objects, so an object
+ *   is constructed each time it is allocated.
+ *
+ * Returned Value:
+ *   The object on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_cache_alloc(FAR struct mempool_cache_s *cache)
+{
+  irqstate_t flags;
+  FAR void *obj;
+
+  obj = mempool_alloc(&cache->pool);
+  if (obj == NULL && !up_interrupt_context() &&
+      mempool_cache_reclaim() > 0)
+    {
+      obj = mempool_alloc(&cache->pool);
+    }
+
+  if (obj == NULL)
+    {
+      flags = spin_lock_irqsave(&g_mempool_cache_lock);
+      cache->nfails++;
+      spin_unlock_irqrestore(&g_mempool_cache_lock, flags);
+      return NULL;
+    }
+
+  if (cache->ctor != NULL)
+    {
+      cache->ctor(obj);
+    }
+  else
+    {
+      memset(obj, 0, cache->objsize);
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_free
+ *
+ * Description:
+ *   Release an object to its cache.
+ *
+ ****************************************************************************/
+
+void mempool_cache_free(FAR struct mempool_cache_s *cache, FAR void *obj)
+{
+  if (obj != NULL)
+    {
+      mempool_free(&cache->pool, obj);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_cache_reclaim
+ *
+ * Description:
+ *   Return the unused memory of all caches to the heap.
+ *
+ * Returned Value:
+ *   The number of bytes returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mempool_cache_reclaim(void)
+{
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+  size_t released;
+  size_t total = 0;
+
+  for (cache = g_mempool_caches; cache != NULL; cache = cache->flink)
+    {
+      released = mempool_shrink(&cache->pool);
+      if (released > 0)
+        {
+          flags = spin_lock_irqsave(&g_mempool_cache_lock);
+          cache->nreclaims++;
+          cache->nreleased += released;
+          spin_unlock_irqrestore(&g_mempool_cache_lock, flags);
+          total += released;
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_next
+ *
+ * Description:
+ *   Iterate over the caches: return the first cache if 'cache' is NULL,
+ *   else the cache following 'cache'.  Caches are never removed.
+ *
+ ****************************************************************************/
+
+FAR struct mempool_cache_s *
+mempool_cache_next(FAR struct mempool_cache_s *cache)
+{
+  return cache == NULL ? g_mempool_caches : cache->flink;
+}
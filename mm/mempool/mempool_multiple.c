@@ -26,12 +26,15 @@
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/mempool.h>
 
 #include <assert.h>
 
+#include "kasan/kasan.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -41,6 +44,17 @@
 #undef  ALIGN_DOWN
 #define ALIGN_DOWN(x, a)      ((size_t)(x) & (~((a) - 1)))
 
+/* The per-CPU magazines need to disable local interrupts, which is only
+ * possible in the kernel.
+ */
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_MAGAZINE) && \
+    CONFIG_MM_HEAP_MEMPOOL_MAGAZINE > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_MAGAZINE       CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+#  define MEMPOOL_MAGAZINE_BATCH ((MEMPOOL_MAGAZINE + 1) / 2)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -52,6 +66,18 @@ struct mpool_dict_s
   size_t                size; /* Record expand memary size */
 };
 
+#ifdef MEMPOOL_MAGAZINE
+/* A magazine caches free blocks of one pool for one CPU.  It is only
+ * accessed by its CPU with local interrupts disabled.
+ */
+
+struct mpool_magazine_s
+{
+  size_t    nblks;                   /* The number of cached blocks */
+  FAR void *blks[MEMPOOL_MAGAZINE];  /* The cached blocks, hottest last */
+};
+#endif
+
 struct mpool_chunk_s
 {
   sq_entry_t entry;
@@ -99,6 +125,12 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef MEMPOOL_MAGAZINE
+  /* npools magazines for each CPU, indexed by cpu * npools + pool */
+
+  FAR struct mpool_magazine_s  *magazines;
+#endif
 };
 
 /****************************************************************************
@@ -285,6 +317,152 @@ static void mempool_multiple_free_callback(FAR struct mempool_s *pool,
                               (FAR char *)addr - mpool->minpoolsize);
 }
 
+#ifdef MEMPOOL_MAGAZINE
+static inline FAR struct mpool_magazine_s *
+mempool_multiple_magazine(FAR struct mempool_multiple_s *mpool,
+                          FAR struct mempool_s *pool)
+{
+  return &mpool->magazines[up_cpu_index() * mpool->npools +
+                           (pool - mpool->pools)];
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_magazine_alloc
+ *
+ * Description:
+ *   Take a block from the magazine of the current CPU.  An empty magazine
+ *   is refilled with half a magazine of blocks from the shared pool.
+ *
+ * Returned Value:
+ *   The block, or NULL if the pool has no free block at hand.
+ *
+ ****************************************************************************/
+
+static FAR void *
+mempool_multiple_magazine_alloc(FAR struct mempool_multiple_s *mpool,
+                                FAR struct mempool_s *pool)
+{
+  FAR struct mpool_magazine_s *mag;
+  FAR void *blks[MEMPOOL_MAGAZINE_BATCH];
+  FAR void *blk = NULL;
+  irqstate_t flags;
+  size_t nblks;
+
+  flags = up_irq_save();
+  mag = mempool_multiple_magazine(mpool, pool);
+  if (mag->nblks > 0)
+    {
+      blk = mag->blks[--mag->nblks];
+    }
+
+  up_irq_restore(flags);
+
+  if (blk != NULL)
+    {
+      kasan_unpoison(blk, pool->blocksize);
+      return blk;
+    }
+
+  /* Refill from the shared pool with a single lock round trip */
+
+  nblks = mempool_allocbatch(pool, blks, MEMPOOL_MAGAZINE_BATCH);
+  if (nblks == 0)
+    {
+      return NULL;
+    }
+
+  blk = blks[--nblks];
+
+  /* We may have been moved to another CPU meanwhile; that just fills the
+   * magazine we are on now.
+   */
+
+  flags = up_irq_save();
+  mag = mempool_multiple_magazine(mpool, pool);
+  while (nblks > 0 && mag->nblks < MEMPOOL_MAGAZINE)
+    {
+      FAR void *tmp = blks[--nblks];
+
+      kasan_poison(tmp, pool->blocksize);
+      mag->blks[mag->nblks++] = tmp;
+    }
+
+  up_irq_restore(flags);
+
+  /* Return whatever did not fit */
+
+  if (nblks > 0)
+    {
+      mempool_freebatch(pool, blks, nblks);
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_magazine_free
+ *
+ * Description:
+ *   Put a block into the magazine of the current CPU.  When the magazine
+ *   is full, the coldest half of it goes back to the shared pool first.
+ *
+ ****************************************************************************/
+
+static void
+mempool_multiple_magazine_free(FAR struct mempool_multiple_s *mpool,
+                               FAR struct mempool_s *pool, FAR void *blk)
+{
+  FAR struct mpool_magazine_s *mag;
+  FAR void *blks[MEMPOOL_MAGAZINE_BATCH];
+  irqstate_t flags;
+  size_t nblks = 0;
+
+  kasan_poison(blk, pool->blocksize);
+
+  flags = up_irq_save();
+  mag = mempool_multiple_magazine(mpool, pool);
+  if (mag->nblks >= MEMPOOL_MAGAZINE)
+    {
+      nblks = MEMPOOL_MAGAZINE_BATCH;
+      memcpy(blks, mag->blks, nblks * sizeof(FAR void *));
+      memmove(mag->blks, &mag->blks[nblks],
+              (mag->nblks - nblks) * sizeof(FAR void *));
+      mag->nblks -= nblks;
+    }
+
+  mag->blks[mag->nblks++] = blk;
+  up_irq_restore(flags);
+
+  if (nblks > 0)
+    {
+      mempool_freebatch(pool, blks, nblks);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_magazine_drain
+ *
+ * Description:
+ *   Return the blocks of all magazines to their pools.
+ *
+ ****************************************************************************/
+
+static void
+mempool_multiple_magazine_drain(FAR struct mempool_multiple_s *mpool)
+{
+  FAR struct mpool_magazine_s *mag;
+  size_t i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS * mpool->npools; i++)
+    {
+      mag = &mpool->magazines[i];
+      mempool_freebatch(&mpool->pools[i % mpool->npools], mag->blks,
+                        mag->nblks);
+      mag->nblks = 0;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_get_dict
  *
@@ -430,6 +608,20 @@ mempool_multiple_init(FAR const char *name,
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
 
+#ifdef MEMPOOL_MAGAZINE
+  mpool->magazines = mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
+                       CONFIG_SMP_NCPUS * npools *
+                       sizeof(struct mpool_magazine_s));
+  if (mpool->magazines == NULL)
+    {
+      mempool_multiple_free_chunk(mpool, pools);
+      goto err_with_mpool;
+    }
+
+  memset(mpool->magazines, 0,
+         CONFIG_SMP_NCPUS * npools * sizeof(struct mpool_magazine_s));
+#endif
+
   for (i = 0; i < npools; i++)
     {
       pools[i].blocksize = poolsize[i];
@@ -439,6 +631,9 @@ mempool_multiple_init(FAR const char *name,
       pools[i].priv = mpool;
       pools[i].alloc = mempool_multiple_alloc_callback;
       pools[i].free = mempool_multiple_free_callback;
+#ifdef MEMPOOL_HAVE_MAGAZINE
+      pools[i].percpu = false;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
       pools[i].blockalign = mpool->minpoolsize;
 #endif
@@ -488,6 +683,9 @@ err_with_pools:
       mempool_deinit(pools + i);
     }
 
+#ifdef MEMPOOL_MAGAZINE
+  mempool_multiple_free_chunk(mpool, mpool->magazines);
+#endif
   mempool_multiple_free_chunk(mpool, pools);
 err_with_mpool:
   free(arg, mpool);
@@ -517,6 +715,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 {
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
+  FAR void *blk;
 
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
@@ -524,10 +723,20 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
+#ifdef MEMPOOL_MAGAZINE
+  /* Try the lockless magazine of this CPU first */
+
+  blk = mempool_multiple_magazine_alloc(mpool, pool);
+  if (blk != NULL)
+    {
+      return blk;
+    }
+#endif
+
   end = mpool->pools + mpool->npools;
   do
     {
-      FAR void *blk = mempool_alloc(pool);
+      blk = mempool_alloc(pool);
 
       if (blk)
         {
@@ -613,7 +822,11 @@ int mempool_multiple_free(FAR struct mempool_multiple_s *mpool,
   blk = (FAR char *)blk - (((FAR char *)blk -
                            ((FAR char *)dict->addr + mpool->minpoolsize)) %
                            MEMPOOL_REALBLOCKSIZE(dict->pool));
+#ifdef MEMPOOL_MAGAZINE
+  mempool_multiple_magazine_free(mpool, dict->pool, blk);
+#else
   mempool_free(dict->pool, blk);
+#endif
   return 0;
 }
 
@@ -758,6 +971,19 @@ mempool_multiple_mallinfo(FAR struct mempool_multiple_s *mpool)
         }
     }
 
+#ifdef MEMPOOL_MAGAZINE
+  /* The pools count the blocks cached in magazines as used */
+
+  for (i = 0; i < CONFIG_SMP_NCPUS * mpool->npools; i++)
+    {
+      size_t nblks = mpool->magazines[i].nblks;
+
+      info.fordblks += nblks * mpool->pools[i % mpool->npools].blocksize;
+      info.ordblks  += nblks;
+      info.aordblks -= nblks;
+    }
+#endif
+
   info.uordblks += mpool->alloced - info.fordblks;
   return info;
 }
@@ -832,6 +1058,10 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
 
   DEBUGASSERT(mpool != NULL);
 
+#ifdef MEMPOOL_MAGAZINE
+  mempool_multiple_magazine_drain(mpool);
+#endif
+
   for (i = 0; i < mpool->npools; i++)
     {
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
@@ -850,6 +1080,9 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
     }
 
   mempool_multiple_free_chunk(mpool, mpool->dict);
+#ifdef MEMPOOL_MAGAZINE
+  mempool_multiple_free_chunk(mpool, mpool->magazines);
+#endif
   mempool_multiple_free_chunk(mpool, mpool->pools);
   nxmutex_destroy(&mpool->lock);
   mpool->free(mpool, mpool);
@@ -171,6 +171,46 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  /* The object caches follow the pools, with their reclaim statistics */
+
+  if (totalsize < buflen)
+    {
+      FAR struct mempool_cache_s *cache = NULL;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                                   "%13s%9s%9s%9s%9s%9s%11s\n", "",
+                                   "objsize", "nused", "nfree", "nfails",
+                                   "nreclaim", "released");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+
+      while ((cache = mempool_cache_next(cache)) != NULL &&
+             totalsize < buflen)
+        {
+          struct mempoolinfo_s minfo;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mempool_info(&cache->pool, &minfo);
+          linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                                       "%12s:%9zu%9lu%9lu%9zu%9zu%11zu\n",
+                                       cache->name, cache->objsize,
+                                       minfo.aordblks, minfo.ordblks,
+                                       cache->nfails, cache->nreclaims,
+                                       cache->nreleased);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   filep->f_pos += totalsize;
   return totalsize;
 }
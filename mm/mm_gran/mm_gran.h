@@ -39,10 +39,19 @@
 
 /* Sizes of things */
 
+/* The GAT is followed by a summary bitmap with one bit per GAT entry, set
+ * when all of the granules of the entry are allocated.
+ */
+
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_GATFULL(n) \
+  SIZEOF_GAT(SIZEOF_GAT(n))
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_GATFULL(n) - 1))
+
+#define GRAN_GATFULL(priv) (&(priv)->gat[SIZEOF_GAT((priv)->ngranules)])
 
 /* Debug */
 
@@ -66,6 +75,7 @@ struct gran_s
 {
   uint8_t    log2gran;  /* Log base 2 of the size of one granule */
   uint16_t   ngranules; /* The total number of (aligned) granules in the heap */
+  uint16_t   hint;      /* The GAT index to start the next search at */
 #ifdef CONFIG_GRAN_INTR
   irqstate_t irqstate;  /* For exclusive access to the GAT */
 #else
@@ -75,6 +85,34 @@ struct gran_s
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_update_full
+ *
+ * Description:
+ *   Update the summary bit of the GAT entry 'gatidx' after it changed.
+ *
+ ****************************************************************************/
+
+static inline void gran_update_full(FAR struct gran_s *priv,
+                                    unsigned int gatidx)
+{
+  FAR uint32_t *full = GRAN_GATFULL(priv);
+  uint32_t bit = (uint32_t)1 << (gatidx & 31);
+
+  if (priv->gat[gatidx] == 0xffffffff)
+    {
+      full[gatidx >> 5] |= bit;
+    }
+  else
+    {
+      full[gatidx >> 5] &= ~bit;
+    }
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
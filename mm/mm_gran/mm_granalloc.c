@@ -25,6 +25,8 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <strings.h>
+#include <sys/param.h>
 
 #include <nuttx/mm/gran.h>
 
@@ -32,6 +34,129 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_nonfull
+ *
+ * Description:
+ *   Return the index of the first GAT entry at or after 'gatidx' with a
+ *   free granule, using the summary bitmap to skip the full entries 32 at
+ *   a time; -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int gran_nonfull(FAR struct gran_s *priv, unsigned int gatidx)
+{
+  FAR uint32_t *full = GRAN_GATFULL(priv);
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  unsigned int fullidx = gatidx >> 5;
+  uint32_t bits;
+
+  if (gatidx >= ngat)
+    {
+      return -1;
+    }
+
+  bits = ~full[fullidx] & (0xffffffff << (gatidx & 31));
+  while (bits == 0)
+    {
+      if (++fullidx >= SIZEOF_GAT(ngat))
+        {
+          return -1;
+        }
+
+      bits = ~full[fullidx];
+    }
+
+  gatidx = (fullidx << 5) + ffs(bits) - 1;
+  return gatidx < ngat ? gatidx : -1;
+}
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Search for 'ngranules' free contiguous granules starting in the GAT
+ *   entries 'first' up to, but not including, 'last'.
+ *
+ * Returned Value:
+ *   The number of the first granule found; -1 if none was found.
+ *
+ ****************************************************************************/
+
+static int gran_search(FAR struct gran_s *priv, unsigned int first,
+                       unsigned int last, unsigned int ngranules)
+{
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  uint64_t     avail;
+  uint32_t     cand;
+  uint32_t     next;
+  unsigned int len;
+  int          granidx;
+  int          gatidx;
+  int          limit;
+
+  for (gatidx = gran_nonfull(priv, first);
+       gatidx >= 0 && gatidx < last;
+       gatidx = gran_nonfull(priv, gatidx + 1))
+    {
+      /* The last granule number that the allocation can start at, relative
+       * to this entry.
+       */
+
+      granidx = gatidx << 5;
+      limit   = priv->ngranules - granidx - ngranules;
+      if (limit < 0)
+        {
+          break;
+        }
+
+      if (ngranules == 1)
+        {
+          /* Fast path for a single granule, e.g. a page */
+
+          cand = ~priv->gat[gatidx];
+        }
+      else
+        {
+          /* Find the start bits of all runs of 'ngranules' free granules
+           * beginning in this entry, looking into the next entry for the
+           * runs that cross into it.  A bit remains set in 'avail' when
+           * the 'len' bits from it on are free; the run length is doubled
+           * at each step.
+           */
+
+          next  = gatidx + 1 < ngat ? priv->gat[gatidx + 1] : 0xffffffff;
+          avail = ~(((uint64_t)next << 32) | priv->gat[gatidx]);
+
+          for (len = 1; len < ngranules && avail != 0; )
+            {
+              unsigned int shift = MIN(len, ngranules - len);
+
+              avail &= avail >> shift;
+              len   += shift;
+            }
+
+          cand = (uint32_t)avail;
+        }
+
+      if (limit < 31)
+        {
+          cand &= 0xffffffff >> (31 - limit);
+        }
+
+      if (cand != 0)
+        {
+          return granidx + ffs(cand) - 1;
+        }
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -42,6 +167,10 @@
  * Description:
  *   Allocate memory from the granule heap.
  *
+ *   The search is next-fit: it starts at the GAT entry where the previous
+ *   allocation ended and wraps around.  The entries with no free granule
+ *   are skipped with the help of a summary bitmap.
+ *
  *   NOTE: The current implementation also restricts the maximum allocation
  *   size to 32 granules.  That restriction could be eliminated with some
  *   additional coding effort.
@@ -60,15 +189,10 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
   unsigned int ngranules;
+  unsigned int ngat;
   size_t       tmpmask;
   uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
+  int          granno;
   int          ret;
 
   DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
@@ -87,158 +211,32 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
-
-      /* Then create mask for that number of granules */
-
       DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
 
-      /* Now search the granule allocation table for that number
-       * of contiguous
-       */
+      /* Search from the hint to the end, then from the start to the hint */
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      ngat   = SIZEOF_GAT(priv->ngranules);
+      granno = gran_search(priv, priv->hint, ngat, ngranules);
+      if (granno < 0 && priv->hint > 0)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
-
-          if (curr == 0xffffffff)
-            {
-              continue;
-            }
-
-          /* Get the next entry from the GAT to support a 64 bit shift */
+          granno = gran_search(priv, 0, priv->hint, ngranules);
+        }
 
-          if (granidx + 32 < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
+      if (granno >= 0)
+        {
+          alloc = priv->heapstart + ((uintptr_t)granno << priv->log2gran);
+          gran_mark_allocated(priv, alloc, ngranules);
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
+          /* The next search starts where this allocation ended */
 
-          else
+          priv->hint = (granno + ngranules) >> 5;
+          if (priv->hint >= ngat)
             {
-              next = 0xffffffff;
+              priv->hint = 0;
             }
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          alloc = priv->heapstart + (granidx << priv->log2gran);
-
-          for (bitidx = 0;
-               bitidx < 32 &&
-               (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Check if we have the allocation at this
-               * bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          gran_leave_critical(priv);
+          return (FAR void *)alloc;
         }
 
       gran_leave_critical(priv);
@@ -115,6 +115,7 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
       DEBUGASSERT((priv->gat[gatidx + 1] & gatmask) == gatmask);
 
       priv->gat[gatidx + 1] &= ~gatmask;
+      gran_update_full(priv, gatidx + 1);
     }
 
   /* Handle the case where where all of the granules came from one entry */
@@ -130,6 +131,7 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
       priv->gat[gatidx] &= ~gatmask;
     }
 
+  gran_update_full(priv, gatidx);
   gran_leave_critical(priv);
 }
 
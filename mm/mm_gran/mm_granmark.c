@@ -94,6 +94,8 @@ FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
 
       priv->gat[gatidx] |= gatmask;
       priv->gat[gatidx + 1] |= gatmask2;
+      gran_update_full(priv, gatidx);
+      gran_update_full(priv, gatidx + 1);
     }
 
   /* Handle the case where where all of the granules come from one entry */
@@ -113,6 +115,7 @@ FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
       /* Mark bits in a single GAT entry */
 
       priv->gat[gatidx] |= gatmask;
+      gran_update_full(priv, gatidx);
     }
 
   return (FAR void *)alloc;
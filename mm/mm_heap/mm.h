@@ -244,6 +244,11 @@ struct mm_heap_s
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
 
+  /* The number of reallocations, and of those that copied the data */
+
+  size_t mm_reallocs;
+  size_t mm_rcopies;
+
   /* The is a multiple mempool of the heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
@@ -145,6 +145,8 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.arena = heap->mm_heapsize;
   info.arena += sizeof(struct mm_heap_s);
   info.uordblks += sizeof(struct mm_heap_s);
+  info.reallocs  = heap->mm_reallocs;
+  info.rcopies   = heap->mm_rcopies;
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
@@ -158,6 +160,34 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the size histogram of the free chunks of the heap.  The
+ *   mm_nodelist[] bins are chained into a single list, their heads have a
+ *   size of zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_freenode_s *node;
+
+  memset(info, 0, sizeof(struct mm_fraginfo_s));
+
+  DEBUGVERIFY(mm_lock(heap));
+  for (node = heap->mm_nodelist[0].flink; node != NULL; node = node->flink)
+    {
+      mm_profile_fragadd(info, SIZEOF_MM_NODE(node));
+    }
+
+  mm_unlock(heap);
+}
+#endif
+
 /****************************************************************************
  * Name: mm_mallinfo_task
  *
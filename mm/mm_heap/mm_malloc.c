@@ -122,6 +122,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
+  bool shrunk = false;
   int ndx;
 
   /* Free the delay list first */
@@ -132,6 +133,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   ret = mempool_multiple_alloc(heap->mm_mpool, size);
   if (ret != NULL)
     {
+      mm_profile_alloc(ret, size);
       return ret;
     }
 #endif
@@ -156,6 +158,8 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+retry:
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -255,9 +259,22 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
   mm_unlock(heap);
 
+  /* Ask the subsystems holding memory to give some back and try again */
+
+  if (ret == NULL && !shrunk)
+    {
+      shrunk = true;
+      if (mm_shrink(alignsize) > 0)
+        {
+          goto retry;
+        }
+    }
+
   if (ret)
     {
+      mm_shrink_check(heap);
       MM_ADD_BACKTRACE(heap, node);
+      mm_profile_alloc(ret, size);
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, 0xaa, alignsize - OVERHEAD_MM_ALLOCNODE);
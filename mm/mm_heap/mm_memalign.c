@@ -76,6 +76,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
   if (node != NULL)
     {
+      mm_profile_alloc((FAR void *)node, size);
       return node;
     }
 #endif
@@ -262,6 +263,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   mm_unlock(heap);
 
   MM_ADD_BACKTRACE(heap, node);
+  mm_profile_alloc((FAR void *)alignedchunk, size);
 
   kasan_unpoison((FAR void *)alignedchunk,
                  mm_malloc_size(heap, (FAR void *)alignedchunk));
@@ -35,6 +35,18 @@
 #include "mm_heap/mm.h"
 #include "kasan/kasan.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_REALLOC_GROWTH
+#  define CONFIG_MM_REALLOC_GROWTH 0
+#endif
+
+/* The slack added to a chunk of 'size' bytes that has to be moved */
+
+#define MM_REALLOC_SLACK(size) ((size) / 100 * CONFIG_MM_REALLOC_GROWTH)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -58,7 +70,10 @@
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
- *  and free the old buffer.
+ *  and free the old buffer.  With CONFIG_MM_REALLOC_GROWTH, the new buffer
+ *  is made larger than requested, so that a buffer growing again and again
+ *  is not copied each time.  A chunk is then not reduced in size by less
+ *  than this slack either.
  *
  ****************************************************************************/
 
@@ -85,6 +100,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
   if (newmem != NULL)
     {
+      mm_profile_free(oldmem);
+      mm_profile_alloc(newmem, size);
       return newmem;
     }
   else if (size <= CONFIG_MM_HEAP_MEMPOOL_THRESHOLD ||
@@ -131,16 +148,19 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   DEBUGASSERT(oldnode->size & MM_ALLOC_BIT);
   DEBUGASSERT(mm_heapmember(heap, oldmem));
 
+  heap->mm_reallocs++;
+
   /* Check if this is a request to reduce the size of the allocation. */
 
   oldsize = SIZEOF_MM_NODE(oldnode);
   if (newsize <= oldsize)
     {
       /* Handle the special case where we are not going to change the size
-       * of the allocation.
+       * of the allocation, or where the space given up is within the
+       * slack and kept for a later growth.
        */
 
-      if (newsize < oldsize)
+      if (oldsize - newsize > MM_REALLOC_SLACK(newsize))
         {
           mm_shrinkchunk(heap, oldnode, newsize);
           kasan_poison((FAR char *)oldnode + SIZEOF_MM_NODE(oldnode) +
@@ -296,6 +316,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
 
           newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
+          heap->mm_rcopies++;
 
           /* Now we want to return newnode */
 
@@ -366,15 +387,18 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - SIZEOF_MM_ALLOCNODE);
+      mm_profile_free(oldmem);
+      mm_profile_alloc(newmem, size);
 
       kasan_unpoison(newmem, mm_malloc_size(heap, newmem));
       if (newmem != oldmem)
         {
-          /* Now we have to move the user contents 'down' in memory.  memcpy
-           * should be safe for this.
+          /* Now we have to move the user contents 'down' in memory.  The
+           * two regions overlap if less than the old size was taken from
+           * the previous chunk.
            */
 
-          memcpy(newmem, oldmem, oldsize - OVERHEAD_MM_ALLOCNODE);
+          memmove(newmem, oldmem, oldsize - OVERHEAD_MM_ALLOCNODE);
         }
 
       return newmem;
@@ -386,12 +410,26 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   else
     {
-      /* Allocate a new block.  On failure, realloc must return NULL but
-       * leave the original memory in place.
+      size_t slack = MM_REALLOC_SLACK(size);
+
+      /* Allocate a new block, with the slack if possible.  On failure,
+       * realloc must return NULL but leave the original memory in place.
        */
 
+      heap->mm_rcopies++;
       mm_unlock(heap);
-      newmem = mm_malloc(heap, size);
+
+      newmem = NULL;
+      if (slack > 0 && size + slack > size)
+        {
+          newmem = mm_malloc(heap, size + slack);
+        }
+
+      if (newmem == NULL)
+        {
+          newmem = mm_malloc(heap, size);
+        }
+
       if (newmem)
         {
           memcpy(newmem, oldmem, oldsize - OVERHEAD_MM_ALLOCNODE);
@@ -0,0 +1,441 @@
+/****************************************************************************
+ * mm/mm_profile/mm_profile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/lib/xorshift128.h>
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_MM_PROFILE_NSAMPLES & (CONFIG_MM_PROFILE_NSAMPLES - 1)) != 0
+#  error CONFIG_MM_PROFILE_NSAMPLES must be a power of two
+#endif
+
+#define MM_PROFILE_MASK   (CONFIG_MM_PROFILE_NSAMPLES - 1)
+
+/* The frames of mm_profile_sample() and mm_profile_alloc() are not part of
+ * the call site.
+ */
+
+#define MM_PROFILE_SKIP   2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A sampled chunk that was not freed yet */
+
+struct mm_profsample_s
+{
+  FAR void *mem;                /* The chunk, NULL if the entry is unused */
+  size_t weight;                /* The bytes it stands for */
+  uint16_t site;                /* Index of its call site */
+};
+
+struct mm_profile_s
+{
+  size_t rate;                  /* Mean bytes between samples, 0 if off */
+  struct xorshift128_state_s prng;
+  spinlock_t lock;
+  ssize_t countdown[CONFIG_SMP_NCPUS]; /* Bytes until the next sample */
+  unsigned int nsites;          /* Call sites in use, not counting site 0 */
+  unsigned int nsamples;        /* Entries in use in samples[] */
+  size_t ndropped;
+
+  /* Site 0 collects the samples of the call sites that did not fit */
+
+  struct mm_profsite_s sites[CONFIG_MM_PROFILE_NSITES];
+  struct mm_profsample_s samples[CONFIG_MM_PROFILE_NSAMPLES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_profile_s g_mm_profile =
+{
+  CONFIG_MM_PROFILE_RATE,
+  XORSHIFT128_INITIALIZER
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_hash
+ ****************************************************************************/
+
+static inline unsigned int mm_profile_hash(FAR void *mem)
+{
+  uintptr_t addr = (uintptr_t)mem;
+
+  return ((addr >> 3) ^ (addr >> 11)) & MM_PROFILE_MASK;
+}
+
+/****************************************************************************
+ * Name: mm_profile_findsite
+ *
+ * Description:
+ *   Return the index of the call site 'backtrace', adding it if necessary.
+ *   Zero is returned if the table of call sites is full.
+ *
+ ****************************************************************************/
+
+static unsigned int mm_profile_findsite(FAR void **backtrace)
+{
+  FAR struct mm_profsite_s *site;
+  unsigned int i;
+
+  for (i = 1; i <= g_mm_profile.nsites; i++)
+    {
+      if (memcmp(g_mm_profile.sites[i].backtrace, backtrace,
+                 sizeof(site->backtrace)) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (i >= CONFIG_MM_PROFILE_NSITES)
+    {
+      return 0;
+    }
+
+  site = &g_mm_profile.sites[i];
+  memcpy(site->backtrace, backtrace, sizeof(site->backtrace));
+  g_mm_profile.nsites = i;
+  return i;
+}
+
+/****************************************************************************
+ * Name: mm_profile_remove
+ *
+ * Description:
+ *   Remove entry 'i' of the samples, moving back the following entries of
+ *   its probe sequence.
+ *
+ ****************************************************************************/
+
+static void mm_profile_remove(unsigned int i)
+{
+  FAR struct mm_profsample_s *samples = g_mm_profile.samples;
+  unsigned int j = i;
+  unsigned int k;
+
+  g_mm_profile.nsamples--;
+
+  for (; ; )
+    {
+      samples[i].mem = NULL;
+
+      /* Find an entry that may take the place of entry i */
+
+      do
+        {
+          j = (j + 1) & MM_PROFILE_MASK;
+          if (samples[j].mem == NULL)
+            {
+              return;
+            }
+
+          k = mm_profile_hash(samples[j].mem);
+        }
+      while (i <= j ? (i < k && k <= j) : (i < k || k <= j));
+
+      samples[i] = samples[j];
+      i = j;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_profile_sample
+ *
+ * Description:
+ *   Record the allocation of 'mem' and restart the countdown to the next
+ *   sample.
+ *
+ ****************************************************************************/
+
+static noinline_function void mm_profile_sample(FAR void *mem, size_t size,
+                                                FAR ssize_t *countdown)
+{
+  FAR void *backtrace[CONFIG_MM_PROFILE_DEPTH];
+  FAR struct mm_profsite_s *site;
+  irqstate_t flags;
+  unsigned int index;
+  unsigned int i;
+  size_t weight;
+  size_t rate;
+
+  /* Walking the stack is the expensive part, do it without the lock */
+
+  memset(backtrace, 0, sizeof(backtrace));
+  sched_backtrace(_SCHED_GETTID(), backtrace, CONFIG_MM_PROFILE_DEPTH,
+                  MM_PROFILE_SKIP);
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+
+  /* Sample at random intervals, so that a periodic allocation pattern is
+   * not missed or overcounted.
+   */
+
+  rate = g_mm_profile.rate;
+  if (rate == 0)
+    {
+      goto out;
+    }
+
+  *countdown = 1 + xorshift128(&g_mm_profile.prng) % (2 * rate);
+
+  if (g_mm_profile.nsamples >= CONFIG_MM_PROFILE_NSAMPLES)
+    {
+      g_mm_profile.ndropped++;
+      goto out;
+    }
+
+  /* An allocation of less than the rate bytes is sampled with a chance of
+   * about size / rate, it stands for rate bytes.
+   */
+
+  size   = MAX(size, 1);
+  weight = MAX(size, rate);
+  index  = mm_profile_findsite(backtrace);
+  site   = &g_mm_profile.sites[index];
+
+  site->nallocs += weight / size;
+  site->nbytes  += weight;
+  site->nlive   += weight;
+
+  for (i = mm_profile_hash(mem); g_mm_profile.samples[i].mem != NULL;
+       i = (i + 1) & MM_PROFILE_MASK);
+
+  g_mm_profile.samples[i].mem    = mem;
+  g_mm_profile.samples[i].weight = weight;
+  g_mm_profile.samples[i].site   = index;
+  g_mm_profile.nsamples++;
+
+out:
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Called by the heap for each allocation.  About one in
+ *   CONFIG_MM_PROFILE_RATE bytes allocated is sampled, so that the cost
+ *   of an allocation that is not sampled is a subtraction.
+ *
+ * Input Parameters:
+ *   mem  - The memory allocated
+ *   size - The size requested
+ *
+ ****************************************************************************/
+
+void mm_profile_alloc(FAR void *mem, size_t size)
+{
+  FAR ssize_t *countdown;
+
+  if (mem == NULL || g_mm_profile.rate == 0)
+    {
+      return;
+    }
+
+  /* The countdown of each CPU is only changed by that CPU.  An interrupt
+   * allocating memory meanwhile just moves the next sample a bit.
+   */
+
+  countdown   = &g_mm_profile.countdown[up_cpu_index()];
+  *countdown -= size;
+  if (*countdown <= 0)
+    {
+      mm_profile_sample(mem, size, countdown);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_profile_free
+ *
+ * Description:
+ *   Called by the heap before a chunk is freed, to forget the sample of the
+ *   chunk if it was sampled.
+ *
+ ****************************************************************************/
+
+void mm_profile_free(FAR void *mem)
+{
+  FAR struct mm_profsample_s *sample;
+  irqstate_t flags;
+  unsigned int i;
+
+  if (mem == NULL || g_mm_profile.nsamples == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+
+  for (i = mm_profile_hash(mem); g_mm_profile.samples[i].mem != NULL;
+       i = (i + 1) & MM_PROFILE_MASK)
+    {
+      sample = &g_mm_profile.samples[i];
+      if (sample->mem == mem)
+        {
+          g_mm_profile.sites[sample->site].nlive -= sample->weight;
+          mm_profile_remove(i);
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_fragadd
+ *
+ * Description:
+ *   Count a free chunk of 'size' bytes into 'info'.  Used by the heaps to
+ *   implement mm_fraginfo().
+ *
+ ****************************************************************************/
+
+void mm_profile_fragadd(FAR struct mm_fraginfo_s *info, size_t size)
+{
+  if (size > 0)
+    {
+      info->nfree[flsl((long)size) - 1]++;
+      info->fordblks += size;
+      info->mxordblk  = MAX(info->mxordblk, size);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_profile_getsite
+ *
+ * Description:
+ *   Return a copy of a call site.  Site 0 collects the allocations of the
+ *   call sites that did not fit into the table, it has no backtrace.
+ *
+ * Input Parameters:
+ *   index - The index of the call site, from 0 to the number of sites
+ *   site  - The location to return the call site
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if 'index' is past the last call site.
+ *
+ ****************************************************************************/
+
+int mm_profile_getsite(unsigned int index, FAR struct mm_profsite_s *site)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  if (index <= g_mm_profile.nsites)
+    {
+      *site = g_mm_profile.sites[index];
+      ret   = OK;
+    }
+
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_profile_info
+ ****************************************************************************/
+
+void mm_profile_info(FAR struct mm_profinfo_s *info)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  info->rate     = g_mm_profile.rate;
+  info->nsites   = g_mm_profile.nsites;
+  info->nsamples = g_mm_profile.nsamples;
+  info->ndropped = g_mm_profile.ndropped;
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_setrate
+ *
+ * Description:
+ *   Set the mean number of bytes allocated between two samples.  Zero
+ *   stops the sampling; the samples recorded so far are kept.
+ *
+ ****************************************************************************/
+
+void mm_profile_setrate(size_t rate)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  g_mm_profile.rate = rate;
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      g_mm_profile.countdown[cpu] = rate;
+    }
+
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_reset
+ *
+ * Description:
+ *   Forget all call sites and samples.
+ *
+ ****************************************************************************/
+
+void mm_profile_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  memset(g_mm_profile.sites, 0, sizeof(g_mm_profile.sites));
+  memset(g_mm_profile.samples, 0, sizeof(g_mm_profile.samples));
+  g_mm_profile.nsites   = 0;
+  g_mm_profile.nsamples = 0;
+  g_mm_profile.ndropped = 0;
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
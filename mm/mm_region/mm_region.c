@@ -0,0 +1,283 @@
+/****************************************************************************
+ * mm/mm_region/mm_region.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one tagged memory region, managed as a heap of its own */
+
+struct mm_region_s
+{
+  FAR const char *name;         /* The name of the region */
+  FAR struct mm_heap_s *heap;   /* The heap of the region */
+  unsigned int attrs;           /* MM_REGION_* attributes */
+  size_t nallocs;               /* Allocations served */
+  size_t nfails;                /* Allocations that did not fit */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The regions in order of preference.  Regions are only ever added, so
+ * g_mm_nregions is advanced once an entry is complete and the table can be
+ * read without a lock.
+ */
+
+static struct mm_region_s g_mm_regions[CONFIG_MM_REGION_NREGIONS];
+static volatile int g_mm_nregions;
+static size_t g_mm_nfallbacks;
+static spinlock_t g_mm_region_lock;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_region_add
+ *
+ * Description:
+ *   Add a memory region with the given attributes.  Unlike kmm_addregion(),
+ *   the region is not merged into the kernel heap: it becomes a heap of its
+ *   own, used by kmm_malloc_region() and kmm_memalign_region() for the
+ *   requests whose attributes it has.  The regions are preferred in the
+ *   order they are added, so the fastest memory should be added first.
+ *
+ *   The regions are added by the board or chip logic during the
+ *   initialization, one at a time.
+ *
+ * Input Parameters:
+ *   name  - The name of the region, as shown in /proc/meminfo
+ *   start - The start of the region
+ *   size  - The size of the region
+ *   attrs - MM_REGION_FAST, MM_REGION_DMA, ...
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mm_region_add(FAR const char *name, FAR void *start, size_t size,
+                  unsigned int attrs)
+{
+  FAR struct mm_region_s *region;
+
+  DEBUGASSERT(start != NULL && (attrs & ~MM_REGION_ATTRMASK) == 0);
+
+  if (g_mm_nregions >= CONFIG_MM_REGION_NREGIONS)
+    {
+      return -ENOSPC;
+    }
+
+  region = &g_mm_regions[g_mm_nregions];
+  region->heap = mm_initialize(name, start, size);
+  if (region->heap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  region->name  = name;
+  region->attrs = attrs;
+  g_mm_nregions++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kmm_memalign_region
+ *
+ * Description:
+ *   Allocate aligned memory from the first region that has all attributes
+ *   in 'flags'.  When all such regions are exhausted, or none was added,
+ *   the memory comes from the kernel heap, unless MM_REGION_NOFALLBACK is
+ *   given.
+ *
+ * Input Parameters:
+ *   flags     - The MM_REGION_* attributes required, and the policy flags
+ *   alignment - The alignment, 0 for the default alignment
+ *   size      - The size to allocate
+ *
+ * Returned Value:
+ *   The allocated memory, to be released with kmm_free(); NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_memalign_region(unsigned int flags, size_t alignment,
+                              size_t size)
+{
+  unsigned int attrs = flags & MM_REGION_ATTRMASK;
+  FAR struct mm_region_s *region;
+  FAR void *mem;
+  irqstate_t irqs;
+  int nregions = g_mm_nregions;
+  int i;
+
+  for (i = 0; i < nregions; i++)
+    {
+      region = &g_mm_regions[i];
+      if ((region->attrs & attrs) != attrs)
+        {
+          continue;
+        }
+
+      if (alignment != 0)
+        {
+          mem = mm_memalign(region->heap, alignment, size);
+        }
+      else
+        {
+          mem = mm_malloc(region->heap, size);
+        }
+
+      irqs = spin_lock_irqsave(&g_mm_region_lock);
+      if (mem != NULL)
+        {
+          region->nallocs++;
+        }
+      else
+        {
+          region->nfails++;
+        }
+
+      spin_unlock_irqrestore(&g_mm_region_lock, irqs);
+      if (mem != NULL)
+        {
+          return mem;
+        }
+    }
+
+  /* Fall back to the slower general purpose memory */
+
+  if ((flags & MM_REGION_NOFALLBACK) != 0)
+    {
+      return NULL;
+    }
+
+  if (alignment != 0)
+    {
+      mem = kmm_memalign(alignment, size);
+    }
+  else
+    {
+      mem = kmm_malloc(size);
+    }
+
+  if (mem != NULL && nregions > 0)
+    {
+      irqs = spin_lock_irqsave(&g_mm_region_lock);
+      g_mm_nfallbacks++;
+      spin_unlock_irqrestore(&g_mm_region_lock, irqs);
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: kmm_malloc_region
+ *
+ * Description:
+ *   kmm_memalign_region() with the default alignment.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_region(unsigned int flags, size_t size)
+{
+  return kmm_memalign_region(flags, 0, size);
+}
+
+/****************************************************************************
+ * Name: mm_region_heapof
+ *
+ * Description:
+ *   Return the heap of the region holding 'mem', NULL if 'mem' is not in a
+ *   region added with mm_region_add().  kmm_free(), kmm_realloc() and
+ *   kmm_malloc_size() use this to find the right heap.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_region_heapof(FAR void *mem)
+{
+  int nregions = g_mm_nregions;
+  int i;
+
+  if (mem != NULL)
+    {
+      for (i = 0; i < nregions; i++)
+        {
+          if (mm_heapmember(g_mm_regions[i].heap, mem))
+            {
+              return g_mm_regions[i].heap;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_region_info
+ *
+ * Description:
+ *   Return the statistics of a region.
+ *
+ * Input Parameters:
+ *   index - The index of the region, in the order the regions were added
+ *   info  - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if there is no region 'index'.
+ *
+ ****************************************************************************/
+
+int mm_region_info(int index, FAR struct mm_regioninfo_s *info)
+{
+  FAR struct mm_region_s *region;
+  irqstate_t flags;
+
+  if (index < 0 || index >= g_mm_nregions)
+    {
+      return -ENOENT;
+    }
+
+  region       = &g_mm_regions[index];
+  info->name   = region->name;
+  info->attrs  = region->attrs;
+  info->info   = mm_mallinfo(region->heap);
+
+  flags = spin_lock_irqsave(&g_mm_region_lock);
+  info->nallocs    = region->nallocs;
+  info->nfails     = region->nfails;
+  info->nfallbacks = g_mm_nfallbacks;
+  spin_unlock_irqrestore(&g_mm_region_lock, flags);
+  return OK;
+}
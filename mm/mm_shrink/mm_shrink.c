@@ -0,0 +1,436 @@
+/****************************************************************************
+ * mm/mm_shrink/mm_shrink.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <malloc.h>
+#include <poll.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/mm.h>
+
+/* The shrinkers are kernel objects: the user-space heap of the protected
+ * and kernel builds does not call them.
+ */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_SHRINK_WATERMARK > 0
+#  define MM_SHRINK_WATERMARK CONFIG_MM_SHRINK_WATERMARK
+#endif
+
+#ifndef CONFIG_MM_PRESSURE_NPOLLWAITERS
+#  define CONFIG_MM_PRESSURE_NPOLLWAITERS 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_shrink_s
+{
+  mutex_t lock;                           /* Protects the whole structure */
+  FAR struct mm_shrinker_s *list;         /* Shrinkers by priority */
+  struct mm_pressure_s info;              /* Pressure counters */
+  uint32_t event;                         /* Incremented on each event */
+#ifdef MM_SHRINK_WATERMARK
+  struct work_s work;                     /* Watermark check work */
+  FAR struct mm_heap_s *heap;             /* The heap to check */
+  unsigned int nsamples;                  /* Allocations since boot */
+#endif
+#ifdef CONFIG_MM_PRESSURE_DEV
+  FAR struct pollfd *fds[CONFIG_MM_PRESSURE_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE_DEV
+static int     mm_pressure_open(FAR struct file *filep);
+static ssize_t mm_pressure_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen);
+static int     mm_pressure_poll(FAR struct file *filep,
+                                FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_shrink_s g_mm_shrink =
+{
+  NXMUTEX_INITIALIZER
+};
+
+#ifdef CONFIG_MM_PRESSURE_DEV
+static const struct file_operations g_mm_pressure_fops =
+{
+  mm_pressure_open,  /* open */
+  NULL,              /* close */
+  mm_pressure_read,  /* read */
+  NULL,              /* write */
+  NULL,              /* seek */
+  NULL,              /* ioctl */
+  NULL,              /* mmap */
+  NULL,              /* truncate */
+  mm_pressure_poll   /* poll */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_shrink_locked
+ *
+ * Description:
+ *   Ask the shrinkers, in priority order, to free 'size' bytes, then wake
+ *   up the readers of /dev/mempressure.
+ *
+ ****************************************************************************/
+
+static size_t mm_shrink_locked(FAR struct mm_shrink_s *shrink, size_t size)
+{
+  FAR struct mm_shrinker_s *shrinker;
+  size_t freed = 0;
+
+  for (shrinker = shrink->list; shrinker != NULL && freed < size;
+       shrinker = shrinker->flink)
+    {
+      freed += shrinker->shrink(shrinker, size - freed);
+    }
+
+  shrink->info.nshrinks++;
+  shrink->info.reclaimed += freed;
+  shrink->event++;
+
+#ifdef CONFIG_MM_PRESSURE_DEV
+  poll_notify(shrink->fds, CONFIG_MM_PRESSURE_NPOLLWAITERS, POLLIN);
+#endif
+
+  return freed;
+}
+
+/****************************************************************************
+ * Name: mm_shrink_worker
+ *
+ * Description:
+ *   Check the free memory of the heap against the low watermark, on the
+ *   low priority work queue, and shrink back above it.
+ *
+ ****************************************************************************/
+
+#ifdef MM_SHRINK_WATERMARK
+static void mm_shrink_worker(FAR void *arg)
+{
+  FAR struct mm_shrink_s *shrink = arg;
+  struct mallinfo info;
+
+  info = mm_mallinfo(shrink->heap);
+  if (info.fordblks >= MM_SHRINK_WATERMARK)
+    {
+      return;
+    }
+
+  nxmutex_lock(&shrink->lock);
+  shrink->info.nlow++;
+  mm_shrink_locked(shrink, MM_SHRINK_WATERMARK - info.fordblks);
+  nxmutex_unlock(&shrink->lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_pressure_open
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE_DEV
+static int mm_pressure_open(FAR struct file *filep)
+{
+  /* Only the events after the open are reported */
+
+  filep->f_priv = (FAR void *)(uintptr_t)g_mm_shrink.event;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_pressure_read
+ *
+ * Description:
+ *   Return the pressure counters as a struct mm_pressure_s.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_pressure_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+  int ret;
+
+  if (buflen < sizeof(struct mm_pressure_s))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&shrink->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(buffer, &shrink->info, sizeof(struct mm_pressure_s));
+  filep->f_priv = (FAR void *)(uintptr_t)shrink->event;
+  nxmutex_unlock(&shrink->lock);
+  return sizeof(struct mm_pressure_s);
+}
+
+/****************************************************************************
+ * Name: mm_pressure_poll
+ *
+ * Description:
+ *   The device is readable once a pressure event happened since it was
+ *   opened or last read.
+ *
+ ****************************************************************************/
+
+static int mm_pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&shrink->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_MM_PRESSURE_NPOLLWAITERS; i++)
+        {
+          if (shrink->fds[i] == NULL)
+            {
+              shrink->fds[i] = fds;
+              fds->priv      = &shrink->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_MM_PRESSURE_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else if ((uintptr_t)filep->f_priv != shrink->event)
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&shrink->lock);
+  return ret;
+}
+#endif /* CONFIG_MM_PRESSURE_DEV */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_register_shrinker
+ *
+ * Description:
+ *   Register a subsystem that can give memory back under memory pressure.
+ *   On an allocation failure, or when the free memory falls below
+ *   CONFIG_MM_SHRINK_WATERMARK, the shrinkers are asked to free memory in
+ *   the order of their priority, lowest first, until enough is freed.
+ *
+ *   A shrinker is called from the allocation that failed.  It must not
+ *   block on a lock that may be held while allocating; it may use a
+ *   trylock and free nothing if the lock is busy.
+ *
+ * Input Parameters:
+ *   shrinker - The shrinker, with 'shrink', 'name' and 'priority' set.
+ *              It must stay valid until it is unregistered.
+ *
+ ****************************************************************************/
+
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+  FAR struct mm_shrinker_s **pprev;
+
+  DEBUGASSERT(shrinker != NULL && shrinker->shrink != NULL);
+
+  nxmutex_lock(&shrink->lock);
+
+  for (pprev = &shrink->list;
+       *pprev != NULL && (*pprev)->priority <= shrinker->priority;
+       pprev = &(*pprev)->flink);
+
+  shrinker->flink = *pprev;
+  *pprev          = shrinker;
+
+  nxmutex_unlock(&shrink->lock);
+}
+
+/****************************************************************************
+ * Name: mm_unregister_shrinker
+ ****************************************************************************/
+
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+  FAR struct mm_shrinker_s **pprev;
+
+  nxmutex_lock(&shrink->lock);
+
+  for (pprev = &shrink->list; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == shrinker)
+        {
+          *pprev = shrinker->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&shrink->lock);
+}
+
+/****************************************************************************
+ * Name: mm_shrink
+ *
+ * Description:
+ *   Called by the heap when an allocation of 'size' bytes failed, before
+ *   it tries again.  Nothing is done in interrupt context, nor from within
+ *   a shrinker.
+ *
+ * Returned Value:
+ *   The number of bytes freed by the shrinkers.
+ *
+ ****************************************************************************/
+
+size_t mm_shrink(size_t size)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+  size_t freed;
+
+  if (up_interrupt_context() || nxmutex_is_hold(&shrink->lock) ||
+      shrink->list == NULL)
+    {
+      return 0;
+    }
+
+  if (nxmutex_lock(&shrink->lock) < 0)
+    {
+      return 0;
+    }
+
+  shrink->info.nfails++;
+  freed = mm_shrink_locked(shrink, size);
+  nxmutex_unlock(&shrink->lock);
+  return freed;
+}
+
+/****************************************************************************
+ * Name: mm_shrink_check
+ *
+ * Description:
+ *   Called by the heap on an allocation.  Every CONFIG_MM_SHRINK_INTERVAL
+ *   allocations, the free memory is checked against the low watermark on
+ *   the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef MM_SHRINK_WATERMARK
+void mm_shrink_check(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+
+  if (++shrink->nsamples % CONFIG_MM_SHRINK_INTERVAL == 0 &&
+      work_available(&shrink->work))
+    {
+      shrink->heap = heap;
+      work_queue(LPWORK, &shrink->work, mm_shrink_worker, shrink, 0);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_pressure_info
+ *
+ * Description:
+ *   Return the memory pressure counters.
+ *
+ ****************************************************************************/
+
+void mm_pressure_info(FAR struct mm_pressure_s *info)
+{
+  FAR struct mm_shrink_s *shrink = &g_mm_shrink;
+
+  nxmutex_lock(&shrink->lock);
+  *info = shrink->info;
+  nxmutex_unlock(&shrink->lock);
+}
+
+/****************************************************************************
+ * Name: mm_pressure_register
+ *
+ * Description:
+ *   Register /dev/mempressure.  A read returns the struct mm_pressure_s
+ *   counters; poll() reports POLLIN once the shrinkers ran since the
+ *   device was opened or last read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE_DEV
+int mm_pressure_register(void)
+{
+  return register_driver("/dev/mempressure", &g_mm_pressure_fops, 0444,
+                         NULL);
+}
+#endif
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
@@ -54,6 +54,14 @@
 #  define MM_PTR_FMT_WIDTH 19
 #endif
 
+#ifndef CONFIG_MM_REALLOC_GROWTH
+#  define CONFIG_MM_REALLOC_GROWTH 0
+#endif
+
+/* The slack added to a growing reallocation of 'size' bytes */
+
+#define MM_REALLOC_SLACK(size) ((size) / 100 * CONFIG_MM_REALLOC_GROWTH)
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
 #  define MEMPOOL_NPOOLS (CONFIG_MM_HEAP_MEMPOOL_THRESHOLD / tlsf_align_size())
 #endif
@@ -90,6 +98,11 @@ struct mm_heap_s
 
   tlsf_t mm_tlsf; /* The tlfs context */
 
+  /* The number of reallocations, and of those that copied the data */
+
+  size_t mm_reallocs;
+  size_t mm_rcopies;
+
   /* The is a multiple mempool of the heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
@@ -273,6 +286,21 @@ static void mallinfo_handler(FAR void *ptr, size_t size, int used,
     }
 }
 
+/****************************************************************************
+ * Name: fraginfo_handler
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+static void fraginfo_handler(FAR void *ptr, size_t size, int used,
+                             FAR void *user)
+{
+  if (!used)
+    {
+      mm_profile_fragadd(user, size);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mallinfo_task_handler
  ****************************************************************************/
@@ -677,6 +705,8 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+  mm_profile_free(mem);
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
     {
@@ -881,6 +911,8 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 
   info.arena    = heap->mm_heapsize;
   info.uordblks = info.arena - info.fordblks;
+  info.reallocs = heap->mm_reallocs;
+  info.rcopies  = heap->mm_rcopies;
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
@@ -929,6 +961,38 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the size histogram of the free blocks of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  memset(info, 0, sizeof(struct mm_fraginfo_s));
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      DEBUGVERIFY(mm_lock(heap));
+      tlsf_walk_pool(heap->mm_heapstart[region], fraginfo_handler, info);
+      mm_unlock(heap);
+    }
+#undef region
+}
+#endif
+
 /****************************************************************************
  * Name: mm_memdump
  *
@@ -1033,6 +1097,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   ret = mempool_multiple_alloc(heap->mm_mpool, size);
   if (ret != NULL)
     {
+      mm_profile_alloc(ret, size);
       return ret;
     }
 #endif
@@ -1060,6 +1125,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
       memdump_backtrace(heap, buf);
 #endif
+      mm_profile_alloc(ret, size);
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
     }
 
@@ -1088,6 +1154,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   ret = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
   if (ret != NULL)
     {
+      mm_profile_alloc(ret, size);
       return ret;
     }
 #endif
@@ -1114,6 +1181,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
       memdump_backtrace(heap, buf);
 #endif
+      mm_profile_alloc(ret, size);
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
     }
 
@@ -1139,7 +1207,10 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
- *  and free the old buffer.
+ *  and free the old buffer.  With CONFIG_MM_REALLOC_GROWTH, a growing
+ *  reallocation is made larger than requested, so that a buffer growing
+ *  again and again is not copied each time.  A chunk is then not reduced
+ *  in size by less than this slack either.
  *
  ****************************************************************************/
 
@@ -1147,6 +1218,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                      size_t size)
 {
   FAR void *newmem;
+#ifndef CONFIG_MM_KASAN
+  size_t oldsize;
+  size_t slack;
+#endif
 
   /* If oldmem is NULL, then realloc is equivalent to malloc */
 
@@ -1168,6 +1243,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
   if (newmem != NULL)
     {
+      mm_profile_free(oldmem);
+      mm_profile_alloc(newmem, size);
       return newmem;
     }
   else if (size <= CONFIG_MM_HEAP_MEMPOOL_THRESHOLD ||
@@ -1184,6 +1261,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 #endif
 
 #ifdef CONFIG_MM_KASAN
+  DEBUGVERIFY(mm_lock(heap));
+  heap->mm_reallocs++;
+  heap->mm_rcopies++;
+  mm_unlock(heap);
+
   newmem = mm_malloc(heap, size);
   if (newmem)
     {
@@ -1203,13 +1285,54 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   /* Allocate from the tlsf pool */
 
   DEBUGVERIFY(mm_lock(heap));
+  heap->mm_reallocs++;
+
+  /* Keep the block if it shrinks by no more than the slack.  If it grows,
+   * ask for the slack too, and for the exact size if that fails.
+   */
+
+  oldsize = mm_malloc_size(heap, oldmem);
+  slack   = MM_REALLOC_SLACK(size);
+  if (size <= oldsize && oldsize - size <= slack)
+    {
+      mm_unlock(heap);
+      return oldmem;
+    }
+
+  newmem = NULL;
+  if (size > oldsize && slack > 0 && size + slack > size)
+    {
 #if CONFIG_MM_BACKTRACE >= 0
-  newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size +
-                        sizeof(struct memdump_backtrace_s));
+      newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size + slack +
+                            sizeof(struct memdump_backtrace_s));
 #else
-  newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size);
+      newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size + slack);
 #endif
+    }
+
+  if (newmem == NULL)
+    {
+#if CONFIG_MM_BACKTRACE >= 0
+      newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size +
+                            sizeof(struct memdump_backtrace_s));
+#else
+      newmem = tlsf_realloc(heap->mm_tlsf, oldmem, size);
+#endif
+    }
+
+  if (newmem != NULL)
+    {
+      /* Forget the sample of the old block before it can be reused */
+
+      mm_profile_free(oldmem);
+      if (newmem != oldmem)
+        {
+          heap->mm_rcopies++;
+        }
+    }
+
   mm_unlock(heap);
+  mm_profile_alloc(newmem, size);
 
 #if CONFIG_MM_BACKTRACE >= 0
   if (newmem)
@@ -46,5 +46,17 @@
 #undef free /* See mm/README.txt */
 void free(FAR void *mem)
 {
+#if defined(CONFIG_MM_REGION) && !defined(CONFIG_MM_KERNEL_HEAP)
+  /* Without a kernel heap, kmm_malloc_region() may fall back to here */
+
+  FAR struct mm_heap_s *heap = mm_region_heapof(mem);
+
+  if (heap != NULL)
+    {
+      mm_free(heap, mem);
+      return;
+    }
+#endif
+
   mm_free(USR_HEAP, mem);
 }
@@ -37,5 +37,14 @@
 #undef malloc_size /* See mm/README.txt */
 size_t malloc_size(FAR void *mem)
 {
+#if defined(CONFIG_MM_REGION) && !defined(CONFIG_MM_KERNEL_HEAP)
+  FAR struct mm_heap_s *heap = mm_region_heapof(mem);
+
+  if (heap != NULL)
+    {
+      return mm_malloc_size(heap, mem);
+    }
+#endif
+
   return mm_malloc_size(USR_HEAP, mem);
 }
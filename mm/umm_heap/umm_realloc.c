@@ -88,6 +88,15 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 
   return mem;
 #else
+#  if defined(CONFIG_MM_REGION) && !defined(CONFIG_MM_KERNEL_HEAP)
+  FAR struct mm_heap_s *heap = mm_region_heapof(oldmem);
+
+  if (heap != NULL)
+    {
+      return mm_realloc(heap, oldmem, size);
+    }
+#  endif
+
   return mm_realloc(USR_HEAP, oldmem, size);
 #endif
 }
@@ -47,6 +47,7 @@
 #ifdef CONFIG_NET
 
 #include <sys/ioctl.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -61,6 +62,7 @@
 #include <nuttx/net/ip.h>
 
 #include "netdev/netdev.h"
+#include "netlink/netlink.h"
 #include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
@@ -71,6 +73,19 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* The ARP table is set associative: an IP address hashes to one set,
+ * which is kept in most recently used order.
+ */
+
+#if CONFIG_NET_ARPTAB_SIZE < 4
+#  define ARP_NWAYS     CONFIG_NET_ARPTAB_SIZE
+#else
+#  define ARP_NWAYS     4
+#endif
+
+#define ARP_NSETS       (CONFIG_NET_ARPTAB_SIZE / ARP_NWAYS)
+#define ARP_NENTRIES    (ARP_NSETS * ARP_NWAYS)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,7 +102,14 @@ struct arp_table_info_s
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_entry_s g_arptable[ARP_NSETS][ARP_NWAYS];
+
+/* Incremented whenever a mapping changes or is removed so that the ARP
+ * table hits remembered by the devices become invalid.  Zero is never a
+ * valid generation.
+ */
+
+static uint32_t g_arpgen = 1;
 
 /****************************************************************************
  * Private Functions
@@ -140,31 +162,56 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_set
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the set of the ARP table that may hold this IP address.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s *arp_set(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
-    {
-      return e2;
-    }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+  uint32_t hash = (uint32_t)ipaddr * 2654435761u;
+
+  return g_arptable[(hash >> 16) % ARP_NSETS];
+}
+
+/****************************************************************************
+ * Name: arp_promote
+ *
+ * Description:
+ *   Move the entry 'i' of a set to the front as the most recently used one.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_promote(FAR struct arp_entry_s *set,
+                                           int i)
+{
+  struct arp_entry_s entry;
+
+  if (i > 0)
     {
-      return e1;
+      entry = set[i];
+      memmove(&set[1], &set[0], i * sizeof(struct arp_entry_s));
+      set[0] = entry;
     }
-  else
+
+  return &set[0];
+}
+
+/****************************************************************************
+ * Name: arp_invalidate
+ *
+ * Description:
+ *   Invalidate the ARP table hits remembered by the devices.
+ *
+ ****************************************************************************/
+
+static void arp_invalidate(void)
+{
+  if (++g_arpgen == 0)
     {
-      return e2;
+      g_arpgen = 1;
     }
 }
 
@@ -187,19 +234,20 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
+  FAR struct arp_entry_s *set = arp_set(ipaddr);
   FAR struct arp_entry_s *tabptr;
   int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < ARP_NWAYS; ++i)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &set[i];
       if (tabptr->at_dev == dev &&
           net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
           clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
-          return tabptr;
+          return arp_promote(set, i);
         }
     }
 
@@ -208,6 +256,31 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_fillreq
+ *
+ * Description:
+ *   Describe an ARP table entry as the SIOCGARP ioctl does.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_ROUTE
+static void arp_fillreq(FAR const struct arp_entry_s *tabptr,
+                        FAR struct arpreq *req)
+{
+  FAR struct sockaddr_in *outaddr;
+
+  outaddr = (FAR struct sockaddr_in *)&req->arp_pa;
+  outaddr->sin_family      = AF_INET;
+  outaddr->sin_port        = 0;
+  outaddr->sin_addr.s_addr = tabptr->at_ipaddr;
+  memcpy(req->arp_ha.sa_data, tabptr->at_ethaddr.ether_addr_octet,
+         sizeof(struct ether_addr));
+  strlcpy((FAR char *)req->arp_dev, tabptr->at_dev->d_ifname,
+          sizeof(req->arp_dev));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -236,45 +309,80 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *set = arp_set(ipaddr);
+  FAR struct arp_entry_s *tabptr;
+  clock_t now = clock_systime_ticks();
+  int victim = ARP_NWAYS - 1;
+  bool changed = true;
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Walk through the set of the IP address and try to find an entry to
+   * update. If none is found, the IP -> MAC address mapping replaces an
+   * unused or expired entry, or else the least recently used one.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < ARP_NWAYS; ++i)
     {
       /* Check if the source IP address of the incoming packet matches
        * the IP address in this ARP table entry.
        */
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      if (set[i].at_dev == dev &&
+          set[i].at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, set[i].at_ipaddr))
         {
           /* An old entry found, break. */
 
-          tabptr = &g_arptable[i];
           break;
         }
-      else
+      else if (set[i].at_ipaddr == 0 ||
+               now - set[i].at_time > ARP_MAXAGE_TICK)
         {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          victim = i;
         }
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
+   * information.  A changed mapping invalidates the hits remembered by
+   * the devices; a mere refresh does not.
    */
 
+  if (i == ARP_NWAYS)
+    {
+      i = victim;
+      arp_invalidate();
+    }
+  else if (memcmp(set[i].at_ethaddr.ether_addr_octet, ethaddr,
+                  ETHER_ADDR_LEN) != 0)
+    {
+      arp_invalidate();
+    }
+  else
+    {
+      changed = false;
+    }
+
+  tabptr = arp_promote(set, i);
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
-  tabptr->at_time = clock_systime_ticks();
+  tabptr->at_time = now;
+
+#ifdef CONFIG_NETLINK_ROUTE
+  /* Tell the listeners of new and changed mappings only */
+
+  if (changed)
+    {
+      struct arpreq req;
+
+      memset(&req, 0, sizeof(req));
+      arp_fillreq(tabptr, &req);
+      netlink_neigh_notify(&req, RTM_NEWNEIGH, AF_INET);
+    }
+#else
+  UNUSED(changed);
+#endif
+
   return OK;
 }
 
@@ -335,6 +443,22 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
   FAR struct arp_entry_s *tabptr;
   struct arp_table_info_s info;
 
+  /* Is it the address of the last hit on the device?  This skips the
+   * table lookup for the packets of a stream to the same next hop.
+   */
+
+  if (dev != NULL && dev->d_arpgen == g_arpgen &&
+      net_ipv4addr_cmp(ipaddr, dev->d_arpipaddr) &&
+      clock_systime_ticks() - dev->d_arptime <= ARP_MAXAGE_TICK)
+    {
+      if (ethaddr != NULL)
+        {
+          memcpy(ethaddr, &dev->d_arpethaddr, ETHER_ADDR_LEN);
+        }
+
+      return OK;
+    }
+
   /* Check if the IPv4 address is already in the ARP table. */
 
   tabptr = arp_lookup(ipaddr, dev);
@@ -349,6 +473,13 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
           memcpy(ethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
         }
 
+      /* And remember the hit on the device */
+
+      dev->d_arpgen     = g_arpgen;
+      dev->d_arpipaddr  = ipaddr;
+      dev->d_arptime    = tabptr->at_time;
+      memcpy(&dev->d_arpethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
+
       /* Return success in any case meaning that a valid Ethernet MAC
        * address mapping is available for the IP address.
        */
@@ -398,9 +529,18 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
+#ifdef CONFIG_NETLINK_ROUTE
+      struct arpreq req;
+
+      memset(&req, 0, sizeof(req));
+      arp_fillreq(tabptr, &req);
+      netlink_neigh_notify(&req, RTM_DELNEIGH, AF_INET);
+#endif
+
       /* Yes.. Set the IP address to zero to "delete" it */
 
       tabptr->at_ipaddr = 0;
+      arp_invalidate();
       return OK;
     }
 
@@ -423,15 +563,18 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
+  FAR struct arp_entry_s *tabptr = &g_arptable[0][0];
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < ARP_NENTRIES; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
+      if (dev == tabptr[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          memset(&tabptr[i], 0, sizeof(tabptr[i]));
         }
     }
+
+  arp_invalidate();
 }
 
 /****************************************************************************
@@ -459,7 +602,6 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
                           unsigned int nentries)
 {
   FAR struct arp_entry_s *tabptr;
-  FAR struct sockaddr_in *outaddr;
   clock_t now;
   unsigned int ncopied;
   int i;
@@ -467,23 +609,14 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
   for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
+       nentries > ncopied && i < ARP_NENTRIES;
        i++)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &g_arptable[0][0] + i;
       if (tabptr->at_ipaddr != 0 &&
           now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
-          outaddr = (FAR struct sockaddr_in *)&snapshot[ncopied].arp_pa;
-          outaddr->sin_family      = AF_INET;
-          outaddr->sin_port        = 0;
-          outaddr->sin_addr.s_addr = tabptr->at_ipaddr;
-          memcpy(snapshot[ncopied].arp_ha.sa_data,
-                 tabptr->at_ethaddr.ether_addr_octet,
-                 sizeof(struct ether_addr));
-          strlcpy((FAR char *)snapshot[ncopied].arp_dev,
-                  tabptr->at_dev->d_ifname,
-                  sizeof(snapshot[ncopied].arp_dev));
+          arp_fillreq(tabptr, &snapshot[ncopied]);
           ncopied++;
         }
     }
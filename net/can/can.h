@@ -38,6 +38,7 @@
 
 #include "devif/devif.h"
 #include "socket/socket.h"
+#include "utils/utils.h"
 
 #ifdef CONFIG_NET_CAN_NOTIFIER
 #  include <nuttx/wqueue.h>
@@ -70,6 +71,20 @@ struct can_poll_s
   FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
 };
 
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+/* A CAN_RAW filter in the filter hash table shared by all sockets */
+
+struct can_conn_s;
+
+struct can_filter_node_s
+{
+  FAR struct can_filter_node_s *next;  /* Next node of the bucket */
+  FAR struct can_conn_s *conn;         /* The socket, NULL if not hashed */
+  canid_t key;                         /* can_id & can_mask */
+  canid_t mask;                        /* can_mask */
+};
+#endif
+
 /* This "connection" structure describes the underlying state of the socket */
 
 struct can_conn_s
@@ -106,6 +121,16 @@ struct can_conn_s
 #  endif
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+#  if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  /* The filters in the shared hash table and the indices of the filters
+   * that are checked one by one.
+   */
+
+  struct can_filter_node_s fnodes[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  uint16_t fwild[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  uint16_t nfwild;
+  uint32_t fseq;                     /* Hashed filter matched frame fseq */
+#  endif
 #  ifdef CONFIG_NET_CAN_RAW_TX_DEADLINE
   int32_t tx_deadline;
 #  endif
@@ -113,6 +138,9 @@ struct can_conn_s
 #ifdef CONFIG_NET_TIMESTAMP
   int32_t timestamp; /* Socket timestamp enabled/disabled */
 #endif
+#ifdef CONFIG_NET_CAN_RXRING
+  struct net_rxring_s rxring; /* Receive ring, replaces the read-ahead */
+#endif
 };
 
 /****************************************************************************
@@ -225,6 +253,59 @@ uint16_t can_callback(FAR struct net_driver_s *dev,
 uint16_t can_datahandler(FAR struct net_driver_s *dev,
                          FAR struct can_conn_s *conn);
 
+/****************************************************************************
+ * Name: can_filter_lookup
+ *
+ * Description:
+ *   Look up the CAN identifier 'id' of a received frame in the filter hash
+ *   table, before can_recv_filter() is called for the sockets.
+ *
+ * Returned Value:
+ *   False if no socket can receive the frame; true otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+bool can_filter_lookup(canid_t id);
+#endif
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check the CAN identifier 'id' against the CAN_RAW filters of the
+ *   connection.  With the filter hash table, can_filter_lookup() must have
+ *   been called for the frame.
+ *
+ * Returned Value:
+ *   1 if the frame is to be received; 0 otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Update the filter hash table and the filters pushed down to the
+ *   hardware after the filters or the device of the connection changed,
+ *   or before the connection is freed ('remove' true).
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+void can_filter_update(FAR struct can_conn_s *conn, bool remove);
+#endif
+
 /****************************************************************************
  * Name: can_recvmsg
  *
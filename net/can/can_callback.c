@@ -26,7 +26,11 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
+#include <poll.h>
+
+#include <netpacket/packet.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
@@ -94,6 +98,45 @@ can_data_event(FAR struct net_driver_s *dev, FAR struct can_conn_s *conn,
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_rxring
+ *
+ * Description:
+ *   Write the frame into the receive ring of the connection and wake up a
+ *   poll() if the ring was empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_RXRING
+static void can_rxring(FAR struct net_driver_s *dev,
+                       FAR struct can_conn_s *conn)
+{
+  struct sockaddr_ll addr;
+
+#ifdef CONFIG_NET_CAN_CANFD
+  /* Do not pass frames with DLC > 8 to a legacy socket */
+
+  if (!conn->fd_frames && dev->d_len > sizeof(struct can_frame))
+    {
+      return;
+    }
+#endif
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family  = AF_CAN;
+  addr.sll_ifindex = dev->d_ifindex;
+
+  if (net_rxring_input(&conn->rxring, dev, &addr, 0) > 0 &&
+      conn->pollinfo[0].psock != NULL)
+    {
+      poll_notify(&conn->pollinfo[0].fds, 1, POLLIN);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -123,6 +166,15 @@ uint16_t can_callback(FAR struct net_driver_s *dev,
 
       if (net_trylock() == OK)
         {
+#ifdef CONFIG_NET_CAN_RXRING
+          if (conn->rxring.base != NULL)
+            {
+              can_rxring(dev, conn);
+              net_unlock();
+              return flags & ~CAN_NEWDATA;
+            }
+#endif
+
           flags = devif_conn_event(dev, flags, conn->sconn.list);
           net_unlock();
         }
@@ -144,7 +196,17 @@ uint16_t can_callback(FAR struct net_driver_s *dev,
               FAR struct timespec *ts = (FAR struct timespec *)&tv;
               int len;
 
-              clock_systime_timespec(ts);
+              /* Prefer the receive time of the hardware */
+
+              if (dev->d_rxtime.tv_sec != 0 || dev->d_rxtime.tv_nsec != 0)
+                {
+                  *ts = dev->d_rxtime;
+                }
+              else
+                {
+                  clock_systime_timespec(ts);
+                }
+
               tv.tv_usec = ts->tv_nsec / 1000;
 
               len = iob_trycopyin(dev->d_iob, (FAR uint8_t *)&tv,
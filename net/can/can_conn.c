@@ -158,6 +158,14 @@ FAR struct can_conn_s *can_alloc(void)
     }
 
   nxmutex_unlock(&g_free_lock);
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  if (conn != NULL)
+    {
+      can_filter_update(conn, false);
+    }
+#endif
+
   return conn;
 }
 
@@ -176,6 +184,10 @@ void can_free(FAR struct can_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  can_filter_update(conn, true);
+#endif
+
   nxmutex_lock(&g_free_lock);
 
   /* Remove the connection from the active list */
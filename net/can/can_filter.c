@@ -0,0 +1,583 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ * Handling incoming packet input
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/can.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ioctl.h>
+
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+#if defined(CONFIG_NET_CAN) && defined(CONFIG_NET_CANPROTO_OPTIONS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Filters with up to this number of different masks are hashed.  A frame
+ * is looked up once for every mask.
+ */
+
+#define CAN_FILTER_NMASKS   4
+
+/* CAN_FILTER_MASK of include/nuttx/can/can.h: match under a mask */
+
+#define CAN_HWFILTER_MASK   0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+struct can_filter_mask_s
+{
+  canid_t mask;
+  uint16_t nrefs;   /* Number of hashed filters with this mask */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+static FAR struct can_filter_node_s *
+g_can_fhash[CONFIG_NET_CAN_FILTER_NBUCKETS];
+static struct can_filter_mask_s g_can_fmasks[CAN_FILTER_NMASKS];
+
+/* The number of the current frame, and the number of connections with
+ * filters that are not hashed.
+ */
+
+static uint32_t g_can_fseq;
+static unsigned int g_can_nfwild;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check one CAN_RAW filter, as for struct can_filter in Linux.
+ *
+ ****************************************************************************/
+
+static inline bool can_filter_match(FAR const struct can_filter *filter,
+                                    canid_t id)
+{
+  if ((filter->can_id & CAN_INV_FILTER) != 0)
+    {
+      return (id & filter->can_mask) !=
+             (filter->can_id & ~CAN_INV_FILTER & filter->can_mask);
+    }
+
+  return (id & filter->can_mask) == (filter->can_id & filter->can_mask);
+}
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+/****************************************************************************
+ * Name: can_filter_hash
+ ****************************************************************************/
+
+static inline unsigned int can_filter_hash(canid_t key, canid_t mask)
+{
+  uint32_t hash = key ^ mask;
+
+  hash ^= hash >> 11;
+  hash ^= hash >> 17;
+  return hash % CONFIG_NET_CAN_FILTER_NBUCKETS;
+}
+
+/****************************************************************************
+ * Name: can_filter_getmask
+ *
+ * Description:
+ *   Take a reference on 'mask' in the set of hashed masks.
+ *
+ * Returned Value:
+ *   True if the filters with this mask can be hashed.
+ *
+ ****************************************************************************/
+
+static bool can_filter_getmask(canid_t mask)
+{
+  FAR struct can_filter_mask_s *slot = NULL;
+  int i;
+
+  for (i = 0; i < CAN_FILTER_NMASKS; i++)
+    {
+      if (g_can_fmasks[i].nrefs == 0)
+        {
+          if (slot == NULL)
+            {
+              slot = &g_can_fmasks[i];
+            }
+        }
+      else if (g_can_fmasks[i].mask == mask)
+        {
+          g_can_fmasks[i].nrefs++;
+          return true;
+        }
+    }
+
+  if (slot == NULL)
+    {
+      return false;
+    }
+
+  slot->mask  = mask;
+  slot->nrefs = 1;
+  return true;
+}
+
+/****************************************************************************
+ * Name: can_filter_putmask
+ ****************************************************************************/
+
+static void can_filter_putmask(canid_t mask)
+{
+  int i;
+
+  for (i = 0; i < CAN_FILTER_NMASKS; i++)
+    {
+      if (g_can_fmasks[i].nrefs > 0 && g_can_fmasks[i].mask == mask)
+        {
+          g_can_fmasks[i].nrefs--;
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: can_filter_unhash
+ *
+ * Description:
+ *   Remove all filters of the connection from the hash table.
+ *
+ ****************************************************************************/
+
+static void can_filter_unhash(FAR struct can_conn_s *conn)
+{
+  FAR struct can_filter_node_s **link;
+  FAR struct can_filter_node_s *node;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_CAN_RAW_FILTER_MAX; i++)
+    {
+      node = &conn->fnodes[i];
+      if (node->conn == NULL)
+        {
+          continue;
+        }
+
+      link = &g_can_fhash[can_filter_hash(node->key, node->mask)];
+      while (*link != node)
+        {
+          link = &(*link)->next;
+        }
+
+      *link      = node->next;
+      node->conn = NULL;
+      can_filter_putmask(node->mask);
+    }
+
+  if (conn->nfwild > 0)
+    {
+      conn->nfwild = 0;
+      g_can_nfwild--;
+    }
+}
+
+/****************************************************************************
+ * Name: can_filter_hash_conn
+ *
+ * Description:
+ *   Put the filters of the connection into the hash table.  Inverted
+ *   filters and filters with a mask that cannot be hashed any more are
+ *   remembered to be checked one by one.
+ *
+ ****************************************************************************/
+
+static void can_filter_hash_conn(FAR struct can_conn_s *conn)
+{
+  FAR struct can_filter_node_s **bucket;
+  FAR struct can_filter_node_s *node;
+  FAR struct can_filter *filter;
+  int i;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      filter = &conn->filters[i];
+      if ((filter->can_id & CAN_INV_FILTER) != 0 ||
+          !can_filter_getmask(filter->can_mask))
+        {
+          conn->fwild[conn->nfwild++] = i;
+          continue;
+        }
+
+      node       = &conn->fnodes[i];
+      node->conn = conn;
+      node->mask = filter->can_mask;
+      node->key  = filter->can_id & filter->can_mask;
+
+      bucket     = &g_can_fhash[can_filter_hash(node->key, node->mask)];
+      node->next = *bucket;
+      *bucket    = node;
+    }
+
+  if (conn->nfwild > 0)
+    {
+      g_can_nfwild++;
+    }
+}
+#endif /* CONFIG_NET_CAN_FILTER_NBUCKETS > 0 */
+
+#if CONFIG_NET_CAN_HWFILTER_MAX > 0
+/****************************************************************************
+ * Name: can_hwfilter_add
+ *
+ * Description:
+ *   Add the hardware filter for 'key'/'mask' to the set being built, if it
+ *   is not in it already.
+ *
+ * Returned Value:
+ *   False if the set is full.
+ *
+ ****************************************************************************/
+
+static bool can_hwfilter_add(FAR struct can_ioctl_filter_s *filters,
+                             FAR uint8_t *nfilters, FAR uint32_t *ext,
+                             bool isext, canid_t key, canid_t mask)
+{
+  canid_t idmask = isext ? CAN_EFF_MASK : CAN_SFF_MASK;
+  int i;
+
+  for (i = 0; i < *nfilters; i++)
+    {
+      if (filters[i].fid1 == (key & idmask) &&
+          filters[i].fid2 == (mask & idmask) &&
+          ((*ext >> i) & 1) == isext)
+        {
+          return true;
+        }
+    }
+
+  if (*nfilters >= CONFIG_NET_CAN_HWFILTER_MAX)
+    {
+      return false;
+    }
+
+  filters[i].fid1  = key & idmask;
+  filters[i].fid2  = mask & idmask;
+  filters[i].ftype = CAN_HWFILTER_MASK;
+  filters[i].fprio = 0;
+
+  if (isext)
+    {
+      *ext |= 1u << i;
+    }
+
+  (*nfilters)++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_ioctl
+ ****************************************************************************/
+
+static int can_hwfilter_ioctl(FAR struct net_driver_s *dev, bool add,
+                              bool isext,
+                              FAR struct can_ioctl_filter_s *filter)
+{
+  int cmd;
+
+  if (isext)
+    {
+      cmd = add ? SIOCACANEXTFILTER : SIOCDCANEXTFILTER;
+    }
+  else
+    {
+      cmd = add ? SIOCACANSTDFILTER : SIOCDCANSTDFILTER;
+    }
+
+  return dev->d_ioctl(dev, cmd, (unsigned long)(uintptr_t)filter);
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Compute the hardware filters that pass all frames the sockets of the
+ *   CAN device 'dev' may receive, and replace the filters of the hardware
+ *   if they changed.  The hardware filters nothing if a socket has a
+ *   filter that is not hashed or if there are too many filters.
+ *
+ ****************************************************************************/
+
+static int can_hwfilter_update(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  struct can_ioctl_filter_s filters[CONFIG_NET_CAN_HWFILTER_MAX];
+  FAR struct can_filter_node_s *node;
+  FAR struct can_conn_s *conn = NULL;
+  uint8_t nfilters = 0;
+  uint32_t ext = 0;
+  bool ok = true;
+  int ret;
+  int i;
+
+  if (dev->d_lltype != NET_LL_CAN || dev->d_ioctl == NULL)
+    {
+      return 0;
+    }
+
+  while (ok && (conn = can_nextconn(conn)) != NULL)
+    {
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
+
+      if (conn->nfwild > 0)
+        {
+          ok = false;
+          break;
+        }
+
+      for (i = 0; ok && i < conn->filter_count; i++)
+        {
+          node = &conn->fnodes[i];
+
+          /* A mask without CAN_EFF_FLAG matches both frame formats */
+
+          if ((node->mask & CAN_EFF_FLAG) == 0 ||
+              (node->key & CAN_EFF_FLAG) == 0)
+            {
+              ok = can_hwfilter_add(filters, &nfilters, &ext, false,
+                                    node->key, node->mask);
+            }
+
+          if (ok && ((node->mask & CAN_EFF_FLAG) == 0 ||
+                     (node->key & CAN_EFF_FLAG) != 0))
+            {
+              ok = can_hwfilter_add(filters, &nfilters, &ext, true,
+                                    node->key, node->mask);
+            }
+        }
+    }
+
+  if (!ok)
+    {
+      nfilters = 0;
+      ext      = 0;
+    }
+
+  if (nfilters == dev->d_canhwnfilters && ext == dev->d_canhwext &&
+      memcmp(filters, dev->d_canhwfilters,
+             nfilters * sizeof(struct can_ioctl_filter_s)) == 0)
+    {
+      return 0;
+    }
+
+  /* Replace the filters of the hardware */
+
+  for (i = 0; i < dev->d_canhwnfilters; i++)
+    {
+      can_hwfilter_ioctl(dev, false, (dev->d_canhwext >> i) & 1,
+                         &dev->d_canhwfilters[i]);
+    }
+
+  dev->d_canhwnfilters = 0;
+  dev->d_canhwext      = 0;
+
+  for (i = 0; i < nfilters; i++)
+    {
+      ret = can_hwfilter_ioctl(dev, true, (ext >> i) & 1, &filters[i]);
+      if (ret < 0)
+        {
+          /* Leave the hardware unfiltered */
+
+          nwarn("WARNING: Hardware filter not added: %d\n", ret);
+          while (--i >= 0)
+            {
+              can_hwfilter_ioctl(dev, false, (ext >> i) & 1, &filters[i]);
+            }
+
+          return 0;
+        }
+    }
+
+  memcpy(dev->d_canhwfilters, filters,
+         nfilters * sizeof(struct can_ioctl_filter_s));
+  dev->d_canhwnfilters = nfilters;
+  dev->d_canhwext      = ext;
+  return 0;
+}
+#endif /* CONFIG_NET_CAN_HWFILTER_MAX > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+/****************************************************************************
+ * Name: can_filter_lookup
+ *
+ * Description:
+ *   Look up the CAN identifier 'id' of a received frame in the filter hash
+ *   table and mark the connections that have a matching filter.
+ *
+ * Returned Value:
+ *   False if no socket can receive the frame; true otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool can_filter_lookup(canid_t id)
+{
+  FAR struct can_filter_node_s *node;
+  bool found = false;
+  canid_t key;
+  int i;
+
+  g_can_fseq++;
+
+  for (i = 0; i < CAN_FILTER_NMASKS; i++)
+    {
+      if (g_can_fmasks[i].nrefs == 0)
+        {
+          continue;
+        }
+
+      key  = id & g_can_fmasks[i].mask;
+      node = g_can_fhash[can_filter_hash(key, g_can_fmasks[i].mask)];
+      for (; node != NULL; node = node->next)
+        {
+          if (node->key == key && node->mask == g_can_fmasks[i].mask)
+            {
+              node->conn->fseq = g_can_fseq;
+              found = true;
+            }
+        }
+    }
+
+  return found || g_can_nfwild > 0;
+}
+
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Update the filter hash table and the filters pushed down to the
+ *   hardware after the filters or the device of the connection changed,
+ *   or before the connection is freed ('remove' true).
+ *
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn, bool remove)
+{
+  net_lock();
+
+  can_filter_unhash(conn);
+  if (!remove)
+    {
+      can_filter_hash_conn(conn);
+    }
+
+#if CONFIG_NET_CAN_HWFILTER_MAX > 0
+  /* The connection may have been bound to another device: update all */
+
+  if (remove)
+    {
+      conn->filter_count = 0;
+    }
+
+  netdev_foreach(can_hwfilter_update, NULL);
+#endif
+
+  net_unlock();
+}
+#endif /* CONFIG_NET_CAN_FILTER_NBUCKETS > 0 */
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check the CAN identifier 'id' against the CAN_RAW filters of the
+ *   connection.
+ *
+ * Returned Value:
+ *   1 if the frame is to be received; 0 otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
+{
+  int i;
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  if (conn->fseq == g_can_fseq)
+    {
+      return 1;
+    }
+
+  for (i = 0; i < conn->nfwild; i++)
+    {
+      if (can_filter_match(&conn->filters[conn->fwild[i]], id))
+        {
+          return 1;
+        }
+    }
+#else
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (can_filter_match(&conn->filters[i], id))
+        {
+          return 1;
+        }
+    }
+#endif
+
+  return 0;
+}
+
+#endif /* CONFIG_NET_CAN && CONFIG_NET_CANPROTO_OPTIONS */
@@ -156,12 +156,37 @@ static int can_in(struct net_driver_s *dev)
   FAR struct can_conn_s *conn = NULL;
   int ret = OK;
   uint16_t buflen = dev->d_len;
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+  canid_t id;
+
+  if (buflen < sizeof(canid_t))
+    {
+      return OK;
+    }
+
+  /* Apply the CAN_RAW filters before the frame is passed to a socket */
+
+  id = *(FAR canid_t *)dev->d_buf;
+
+#  if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  if (!can_filter_lookup(id))
+    {
+      /* No socket wants the frame */
+
+      return OK;
+    }
+#  endif
+#endif
 
   do
     {
       conn = can_nextconn(conn);
 
-      if (conn && (conn->dev == NULL || dev == conn->dev))
+      if (conn && (conn->dev == NULL || dev == conn->dev)
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+          && can_recv_filter(conn, id)
+#endif
+         )
         {
           uint16_t flags;
 
@@ -31,6 +31,7 @@
 #include <debug.h>
 
 #include <netpacket/can.h>
+#include <netpacket/packet.h>
 
 #include <nuttx/net/net.h>
 #include <nuttx/net/can.h>
@@ -108,6 +109,18 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
     }
 #endif
 
+#ifdef CONFIG_NET_CAN_RXRING
+  /* Set up or release the memory mapped receive ring */
+
+  if (level == SOL_PACKET && option == PACKET_RX_RING)
+    {
+      net_lock();
+      ret = net_rxring_setup(&conn->rxring, value, value_len);
+      net_unlock();
+      return ret;
+    }
+#endif
+
   if (level != SOL_CAN_RAW)
     {
       return -ENOPROTOOPT;
@@ -151,6 +164,10 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
 
             ret = OK;
           }
+
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+        can_filter_update(conn, false);
+#endif
         break;
 
       case CAN_RAW_ERR_FILTER:
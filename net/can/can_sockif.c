@@ -56,6 +56,10 @@ static int  can_bind(FAR struct socket *psock,
 static int  can_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
               bool setup);
 static int can_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_CAN_RXRING
+static int can_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -83,6 +87,12 @@ const struct sock_intf_s g_can_sockif =
   , can_getsockopt  /* si_getsockopt */
   , can_setsockopt  /* si_setsockopt */
 #endif
+#ifdef CONFIG_NET_CAN_RXRING
+#ifdef CONFIG_NET_SENDFILE
+  , NULL            /* si_sendfile */
+#endif
+  , can_mmap        /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -330,6 +340,12 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
+#if CONFIG_NET_CAN_FILTER_NBUCKETS > 0
+  /* The hardware filters of the devices depend on the binding */
+
+  can_filter_update(conn, false);
+#endif
+
   return OK;
 }
 
@@ -426,6 +442,15 @@ static int can_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
           eventset |= POLLRDNORM;
         }
 
+#ifdef CONFIG_NET_CAN_RXRING
+      if (net_rxring_ready(&conn->rxring))
+        {
+          /* The receive ring holds frames */
+
+          eventset |= POLLRDNORM;
+        }
+#endif
+
       if (psock_can_cansend(psock) >= 0)
         {
           /* A CAN frame may be sent without blocking. */
@@ -463,6 +488,36 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_mmap
+ *
+ * Description:
+ *   Map the receive ring set up with the PACKET_RX_RING socket option.
+ *
+ * Input Parameters:
+ *   psock   Socket instance
+ *   map     The mapping to be set up
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_RXRING
+static int can_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+  int ret;
+
+  net_lock();
+  ret = net_rxring_mmap(&conn->rxring, map);
+  net_unlock();
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: can_close
  *
@@ -499,6 +554,9 @@ static int can_close(FAR struct socket *psock)
       /* Free the connection structure */
 
       conn->crefs = 0;
+#ifdef CONFIG_NET_CAN_RXRING
+      net_rxring_free(&conn->rxring);
+#endif
       can_free(psock->s_conn);
 
       if (ret < 0)
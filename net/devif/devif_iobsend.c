@@ -57,6 +57,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifndef CONFIG_NET_IPFRAG
+  unsigned int maxlen;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -72,7 +75,18 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  maxlen = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Only TCP sends I/O buffer chains, which the device may segment */
+
+  if ((dev->d_features & NETDEV_FEATURE_TSO) != 0 && dev->d_tsomax > maxlen)
+    {
+      maxlen = dev->d_tsomax;
+    }
+#endif
+
+  if (len > maxlen - target_offset)
     {
       ret = -EMSGSIZE;
       goto errout;
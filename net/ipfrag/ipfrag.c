@@ -28,6 +28,7 @@
     defined(CONFIG_NET_IPFRAG)
 
 #include <sys/ioctl.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <debug.h>
@@ -95,6 +96,23 @@ do  \
 
 #define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
 
+/* The maximum I/O buffer occupied by the fragments of one datagram */
+
+#if CONFIG_NET_IPFRAG_FLOW_MAXIOB > 0
+#  define REASSEMBLY_FLOWMAXIOB        CONFIG_NET_IPFRAG_FLOW_MAXIOB
+#else
+#  define REASSEMBLY_FLOWMAXIOB        (REASSEMBLY_MAXOCCUPYIOB)
+#endif
+
+/* The hash table of the datagrams under reassembly */
+
+#define REASSEMBLY_HASHMASK            (CONFIG_NET_IPFRAG_HASHSIZE - 1)
+
+#if (CONFIG_NET_IPFRAG_HASHSIZE & REASSEMBLY_HASHMASK) != 0 || \
+    CONFIG_NET_IPFRAG_HASHSIZE > 256
+#  error CONFIG_NET_IPFRAG_HASHSIZE must be a power of two up to 256
+#endif
+
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
 #define LOOPBACK_IPFRAME_NOFRAGMENT    0
@@ -118,11 +136,11 @@ static struct work_s g_wkfragtimeout;
 
 static uint8_t       g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hash table of queues, each links the datagrams of all NICs whose
+ * identification hashes to the same bucket.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhash[CONFIG_NET_IPFRAG_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -134,7 +152,7 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time
  * at a time.
  */
 
@@ -148,15 +166,125 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
+static int ip_fragin_compare(FAR struct ip_fraglink_s *a,
+                             FAR struct ip_fraglink_s *b);
+
+RB_PROTOTYPE_STATIC(ip_fragtree_s, ip_fraglink_s, entry, ip_fragin_compare);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+RB_GENERATE_STATIC(ip_fragtree_s, ip_fraglink_s, entry, ip_fragin_compare);
+
+/****************************************************************************
+ * Name: ip_fragin_compare
+ *
+ * Description:
+ *   Order the fragments of a datagram by offset.
+ *
+ ****************************************************************************/
+
+static int ip_fragin_compare(FAR struct ip_fraglink_s *a,
+                             FAR struct ip_fraglink_s *b)
+{
+  if (a->fragoff != b->fragoff)
+    {
+      return a->fragoff < b->fragoff ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_getkey
+ *
+ * Description:
+ *   Get the addresses and protocol identifying the datagram of a fragment
+ *   from its IP header.
+ *
+ ****************************************************************************/
+
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key)
+{
+  FAR uint8_t *iphdr = IOB_DATA(fraglink->frag);
+
+  /* The destination address follows the source address in both headers */
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)iphdr;
+
+      key->proto   = ipv4->proto;
+      key->addrlen = 2 * sizeof(in_addr_t);
+      memcpy(key->addrs, ipv4->srcipaddr, key->addrlen);
+      return;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  key->proto   = 0;
+  key->addrlen = 2 * sizeof(net_ipv6addr_t);
+  memcpy(key->addrs, ((FAR struct ipv6_hdr_s *)iphdr)->srcipaddr,
+         key->addrlen);
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Return the hash bucket of the datagram identified by 'ipid' and 'key'.
+ *
+ ****************************************************************************/
+
+static uint8_t ip_fragin_hash(uint32_t ipid,
+                              FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = ipid ^ key->proto;
+  uint32_t word;
+  unsigned int i;
+
+  for (i = 0; i < key->addrlen; i += sizeof(word))
+    {
+      memcpy(&word, &key->addrs[i], sizeof(word));
+      hash = hash * 31 + word;
+    }
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & REASSEMBLY_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_freenode
+ *
+ * Description:
+ *   Free all fragments of a datagram, remove it from the queues and free
+ *   the node.
+ *
+ ****************************************************************************/
+
+static uint32_t ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
+{
+  FAR struct ip_fraglink_s *fraglink = node->frags;
+  uint32_t bufcnt;
+
+  while (fraglink != NULL)
+    {
+      fraglink = ip_fragin_freelink(fraglink);
+    }
+
+  bufcnt = ip_frag_remnode(node);
+  kmm_free(node);
+  return bufcnt;
+}
+
 /****************************************************************************
  * Name: ip_fragin_timerout_expiry
  *
@@ -267,22 +395,11 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
-
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          /* Remove node from single-list and free node memory */
+          /* Remove fragments of this node, remove node from the queues
+           * and free node memory
+           */
 
-          ip_frag_remnode(node);
-          kmm_free(node);
+          ip_fragin_freenode(node);
         }
       else
         {
@@ -359,51 +476,6 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
   return next;
 }
 
-/****************************************************************************
- * Name: ip_fragin_check
- *
- * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
- *
- * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
- *
- * Returned Value:
- *   None
- *
- ****************************************************************************/
-
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
-{
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
-
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
-    {
-      entry = fragsnode->frags;
-      while (entry != NULL)
-        {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
-
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
-
-          entry = entry->flink;
-        }
-    }
-}
-
 /****************************************************************************
  * Name: ip_fragin_cachemonitor
  *
@@ -446,22 +518,11 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 
           if (node != curnode)
             {
-              /* Remove fragments of this node */
-
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
-
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
+              /* Remove fragments of this node, remove node from the queues
+               * and free node memory
+               */
 
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
+              bufcnt = ip_fragin_freenode(node);
 
               cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
             }
@@ -527,7 +588,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   assert(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node, &g_assemblyhash[node->hash]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -539,8 +600,14 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form ordered by offset, that is a ip_fragsnode_s node, and indexed by
+ *   a tree of the same fragments.  The ip_fragsnode_s nodes are found
+ *   through a hash table of their identification.
+ *
+ *   A fragment that overlaps the fragments already received is not
+ *   enqueued.  Since RFC 5722 forbids overlapping IPv6 fragments, the whole
+ *   IPv6 datagram is dropped in this case.  A datagram whose fragments
+ *   exceed REASSEMBLY_FLOWMAXIOB I/O buffers is dropped as well.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -548,131 +615,138 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before the new node was enqueued, 0 if not, or
+ *   a negated errno value if the fragment was not enqueued: it overlaps
+ *   other fragments or exceeds the I/O buffer budget of the datagram.  The
+ *   caller keeps the fragment and 'curfraglink' in this case.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
+  FAR struct ip_fraglink_s  *prev = NULL;
+  FAR struct ip_fraglink_s  *next = NULL;
+  FAR struct ip_fraglink_s  *same = NULL;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
-  bool                       empty;
+  struct ip_fragkey_s        key;
+  uint32_t                   fragend;
+  uint32_t                   bufcnt;
+  uint8_t                    hash;
+  int                        empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
-   */
+  empty = sq_peek(&g_assemblyhead_time) == NULL;
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  /* Look for the datagram of this fragment in its hash bucket */
 
-  while (entry != NULL)
-    {
-      node = (struct ip_fragsnode_s *)entry;
+  ip_fragin_getkey(curfraglink, &key);
+  hash = ip_fragin_hash(curfraglink->ipid, &key);
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+  for (entry = sq_peek(&g_assemblyhash[hash]); entry != NULL;
+       entry = sq_next(entry))
+    {
+      node = (FAR struct ip_fragsnode_s *)entry;
+      if (node->dev == dev && node->ipid == curfraglink->ipid &&
+          node->key.proto == key.proto && node->key.addrlen == key.addrlen &&
+          memcmp(node->key.addrs, key.addrs, key.addrlen) == 0)
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
+  node    = (FAR struct ip_fragsnode_s *)entry;
+  fragend = curfraglink->fragoff + curfraglink->fraglen;
+  bufcnt  = IOBUF_CNT(curfraglink->frag);
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
+      /* Find the neighbours of the new fragment in the datagram */
 
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
+      next = RB_NFIND(ip_fragtree_s, &node->fragtree, curfraglink);
+      if (next != NULL && next->fragoff == curfraglink->fragoff)
+        {
+          /* Fragments with same offset value contain the same data, use
+           * the more recently arrived copy. Refer to RFC791, Section3.2,
+           * Page29.
+           */
 
-      fraglink = node->frags;
+          same = next;
+          next = RB_NEXT(ip_fragtree_s, &node->fragtree, same);
+          prev = RB_PREV(ip_fragtree_s, &node->fragtree, same);
+        }
+      else if (next != NULL)
+        {
+          prev = RB_PREV(ip_fragtree_s, &node->fragtree, next);
+        }
+      else
+        {
+          prev = RB_MAX(ip_fragtree_s, &node->fragtree);
+        }
 
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
+      /* The fragment must neither overlap its neighbours nor go beyond
+       * the end of the datagram, once that is known.
        */
 
-      while (fraglink != NULL)
+      if ((prev != NULL &&
+           prev->fragoff + prev->fraglen > curfraglink->fragoff) ||
+          (next != NULL && fragend > next->fragoff) ||
+          (!curfraglink->morefrags && next != NULL) ||
+          ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+           (fragend > node->totallen ||
+            (!curfraglink->morefrags && fragend != node->totallen))))
         {
-          /* The fragment list is ordered by fragment offset value */
+          nwarn("WARNING: Overlapping fragment of IP ID %" PRIu32 "\n",
+                curfraglink->ipid);
 
-          if (curfraglink->fragoff <= fraglink->fragoff)
+          if (!curfraglink->isipv4)
             {
-              break;
+              ip_fragin_freenode(node);
             }
 
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
+          return -EINVAL;
         }
 
-      if (fraglink == NULL)
+      if (node->bufcnt + bufcnt -
+          (same != NULL ? IOBUF_CNT(same->frag) : 0) >
+          REASSEMBLY_FLOWMAXIOB)
         {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
+          nwarn("WARNING: Datagram of IP ID %" PRIu32 " is too large\n",
+                curfraglink->ipid);
 
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          ip_fragin_freenode(node);
+          return -ENOMEM;
         }
-      else if (curfraglink->fragoff == fraglink->fragoff)
-        {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
 
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
-            {
-              node->frags = curfraglink;
-            }
-          else
-            {
-              lastlink->flink = curfraglink;
-            }
+      /* Replace and remove the old packet from the fragment list */
 
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
-        }
-      else
+      if (same != NULL)
         {
-          /* Insert into the fragment list */
-
-          if (lastlink == NULL)
+          RB_REMOVE(ip_fragtree_s, &node->fragtree, same);
+          if (prev == NULL)
             {
-              /* Insert before the first node */
-
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
+              node->frags = same->flink;
             }
           else
             {
-              /* Insert this node after lastlink */
-
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
+              prev->flink = same->flink;
             }
 
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          node->bufcnt  -= IOBUF_CNT(same->frag);
+          g_bufoccupy   -= IOBUF_CNT(same->frag);
+          node->datalen -= same->fraglen;
+          ip_fragin_freelink(same);
         }
     }
   else
     {
+      if (bufcnt > REASSEMBLY_FLOWMAXIOB)
+        {
+          return -ENOMEM;
+        }
+
       /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+       * hash table
        */
 
       node = kmm_malloc(sizeof(struct ip_fragsnode_s));
@@ -686,26 +760,18 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->flinkat    = NULL;
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
+      node->key        = key;
+      node->hash       = hash;
+      node->frags      = NULL;
       node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
+      node->bufcnt     = 0;
+      node->datalen    = 0;
+      node->totallen   = 0;
       node->verifyflag = 0;
       node->outgoframe = NULL;
+      RB_INIT(&node->fragtree);
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
-
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addlast((FAR sq_entry_t *)node, &g_assemblyhash[hash]);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -714,26 +780,55 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
     }
 
+  /* Insert into the fragment list after its predecessor and the tree */
+
+  if (prev == NULL)
+    {
+      curfraglink->flink = node->frags;
+      node->frags        = curfraglink;
+    }
+  else
+    {
+      curfraglink->flink = prev->flink;
+      prev->flink        = curfraglink;
+    }
+
+  RB_INSERT(ip_fragtree_s, &node->fragtree, curfraglink);
+
+  /* Remember I/O buffer count and the payload received */
+
+  node->bufcnt  += bufcnt;
+  g_bufoccupy   += bufcnt;
+  node->datalen += curfraglink->fraglen;
+
   if (curfraglink->fragoff == 0)
     {
       /* Have received the zero fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
     }
-  else if (!curfraglink->morefrags)
+
+  if (!curfraglink->morefrags)
     {
       /* Have received the tail fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      node->totallen    = fragend;
     }
 
-  /* For indexing convenience */
+  /* Since the fragments do not overlap, all of them have been received when
+   * their payload adds up to the length of the datagram.
+   */
 
-  curfraglink->fragsnode = node;
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      node->datalen == node->totallen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
 
-  /* Check receiving status */
+  /* For indexing convenience */
 
-  ip_fragin_check(node);
+  curfraglink->fragsnode = node;
 
   /* Buffer is take away, clear original pointers in NIC */
 
@@ -1114,29 +1209,19 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1166,16 +1251,18 @@ void ip_frag_remallfrags(void)
   FAR sq_entry_t *entry = NULL;
   FAR sq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1188,17 +1275,20 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* Because nodes managed by the queues are the same, the queues are
+       * simply reset after this loop ends
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
+  for (i = 0; i < CONFIG_NET_IPFRAG_HASHSIZE; i++)
+    {
+      sq_init(&g_assemblyhash[i]);
+    }
+
   sq_init(&g_assemblyhead_time);
   g_bufoccupy = 0;
 
@@ -1248,6 +1338,15 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The device segments TSO packets itself */
+
+  if ((dev->d_iob->io_offload & NETDEV_OFFLOAD_TSO) != 0)
+    {
+      return OK;
+    }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
   if (dev->d_lltype == NET_LL_IEEE802154 ||
       dev->d_lltype == NET_LL_PKTRADIO)
@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/tree.h>
 #include <stdint.h>
 #include <assert.h>
 
@@ -42,6 +43,18 @@
 
 #if defined(CONFIG_NET_IPFRAG)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of the largest address that identifies a datagram */
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFRAG_ADDRSIZE sizeof(net_ipv6addr_t)
+#else
+#  define IPFRAG_ADDRSIZE sizeof(in_addr_t)
+#endif
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
@@ -76,6 +89,10 @@ struct ip_fraglink_s
 
   FAR struct ip_fraglink_s  *flink;
 
+  /* Links all fragments with the same IP ID in a tree ordered by offset */
+
+  RB_ENTRY(ip_fraglink_s)    entry;
+
   FAR struct ip_fragsnode_s *fragsnode; /* Point to parent struct */
   FAR struct iob_s          *frag;      /* Point to fragment data */
   uint8_t                    isipv4;    /* IPv4 or IPv6 */
@@ -90,10 +107,24 @@ struct ip_fraglink_s
   uint32_t                   ipid;
 };
 
+RB_HEAD(ip_fragtree_s, ip_fraglink_s);
+
+/* Besides the IP ID, a datagram is identified by its source and destination
+ * address and, for IPv4, by its protocol (RFC 791).
+ */
+
+struct ip_fragkey_s
+{
+  uint8_t                    proto;     /* IPv4 protocol, zero for IPv6 */
+  uint8_t                    addrlen;   /* Size of both addresses */
+  uint8_t                    addrs[2 * IPFRAG_ADDRSIZE]; /* Source, dest */
+};
+
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain the single-linked list of ip_fragsnode_s
+   * of one hash bucket.  Must be the first field in the structure due to
+   * flink type casting.
    */
 
   FAR struct ip_fragsnode_s *flink;
@@ -114,6 +145,11 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* The rest of the identification of the datagram and its hash bucket */
+
+  struct ip_fragkey_s        key;
+  uint8_t                    hash;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -126,9 +162,19 @@ struct ip_fragsnode_s
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* The payload received so far, and the total payload length which is
+   * known once the tail fragment has been received.
+   */
+
+  uint32_t                   datalen;
+  uint32_t                   totallen;
+
+  /* Linked all fragments with the same IP ID, ordered by offset.  The tree
+   * indexes the same fragments.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  struct ip_fragtree_s       fragtree;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -147,7 +193,7 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time
  * at a time
  */
 
@@ -189,12 +235,15 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before the new node was enqueued, 0 if not, or
+ *   a negated errno value if the fragment was not enqueued: it overlaps
+ *   other fragments or exceeds the I/O buffer budget of the datagram.  The
+ *   caller keeps the fragment and 'curfraglink' in this case.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink);
 
 /****************************************************************************
  * Name: ipv4_fragin
@@ -207,7 +256,8 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
  *   dev    - The NIC device that the fragmented data comes from
  *
  * Returned Value:
- *   ENOMEM - No memory
+ *   ENOMEM - No memory, or the datagram exceeds its I/O buffer budget
+ *   EINVAL - The fragment overlaps other fragments of the datagram
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
@@ -225,7 +275,8 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev);
  *   dev    - The NIC device that the fragmented data comes from
  *
  * Returned Value:
- *   ENOMEM - No memory
+ *   ENOMEM - No memory, or the datagram exceeds its I/O buffer budget
+ *   EINVAL - The fragment overlaps other fragments of the datagram
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
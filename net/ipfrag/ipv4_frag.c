@@ -251,7 +251,8 @@ ipv4_fragout_buildipv4header(FAR struct ipv4_hdr_s *ref,
  *   dev    - The NIC device that the fragmented data comes from
  *
  * Returned Value:
- *   ENOMEM - No memory
+ *   ENOMEM - No memory, or the datagram exceeds its I/O buffer budget
+ *   EINVAL - The fragment overlaps other fragments of the datagram
  *   OK     - The input fragment is processed as expected
  *
  ****************************************************************************/
@@ -260,7 +261,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
-  bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -283,7 +284,15 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      /* The fragment is dropped, it is left in dev->d_iob */
+
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
 
@@ -319,7 +328,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
+  if (ret > 0)
     {
       /* Restart the work queue for fragment processing */
 
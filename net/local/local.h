@@ -102,6 +102,7 @@ enum local_state_s
  */
 
 struct devif_callback_s;       /* Forward reference */
+struct local_ring_s;           /* Forward reference */
 
 struct local_conn_s
 {
@@ -147,6 +148,13 @@ struct local_conn_s
   struct pollfd *lc_event_fds[LOCAL_NPOLLWAITERS];
   struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Ring buffers used instead of the FIFOs by connected peers */
+
+  FAR struct local_ring_s *lc_rxring;
+  FAR struct local_ring_s *lc_txring;
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -604,6 +612,64 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Create the two ring buffers connecting 'client' and 'server'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+int local_ring_alloc(FAR struct local_conn_s *client,
+                     FAR struct local_conn_s *server);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach the connection from its receive ring (SHUT_RD) and/or its send
+ *   ring (SHUT_WR).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+void local_ring_release(FAR struct local_conn_s *conn, int how);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_send and local_ring_recv
+ *
+ * Description:
+ *   Copy data into the send ring or out of the receive ring of a connected
+ *   peer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *iov, int iovcnt,
+                        bool nonblock);
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_pollevents and local_ring_ioctl
+ *
+ * Description:
+ *   Return the poll events of the rings, or their fill level for FIONREAD,
+ *   FIONWRITE and FIONSPACE.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+pollevent_t local_ring_pollevents(FAR struct local_conn_s *conn);
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     FAR int *arg);
+#endif
+
 /****************************************************************************
  * Name: local_event_pollnotify
  ****************************************************************************/
@@ -103,7 +103,9 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   FAR struct local_conn_s *client;
   FAR struct local_conn_s *conn;
   FAR dq_entry_t *waiter;
+#ifndef CONFIG_NET_LOCAL_RING
   bool nonblock = !!(flags & SOCK_NONBLOCK);
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -178,6 +180,16 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               strlcpy(conn->lc_path, client->lc_path, sizeof(conn->lc_path));
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_RING
+              /* Create the ring buffers shared with the client */
+
+              ret = local_ring_alloc(client, conn);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to allocate rings for %s: %d\n",
+                       conn->lc_path, ret);
+                }
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -188,8 +200,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                   nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                      conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_RING
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -208,12 +222,15 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                         conn->lc_path, ret);
                 }
             }
+#endif
 
           /* Do we have a connection?  Are the FIFOs opened? */
 
           if (ret == OK)
             {
+#ifndef CONFIG_NET_LOCAL_RING
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+#endif
 
               /* Return the address family */
 
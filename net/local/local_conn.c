@@ -178,6 +178,12 @@ void local_free(FAR struct local_conn_s *conn)
 
   net_unlock();
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Detach from the ring buffers of the connection */
+
+  local_ring_release(conn, SHUT_RDWR);
+#endif
+
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infile.f_inode != NULL)
@@ -91,6 +91,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -116,6 +117,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -152,6 +154,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
         }
     }
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -163,6 +166,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
 
   nxsem_post(&client->lc_donesem);
 
@@ -176,11 +180,13 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   return -EINPROGRESS;
 
 errout_with_outfd:
+#ifndef CONFIG_NET_LOCAL_RING
   file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
 
 errout_with_fifos:
   local_release_fifos(client);
+#endif
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
 }
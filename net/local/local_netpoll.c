@@ -85,6 +85,13 @@ static int local_event_pollsetup(FAR struct local_conn_s *conn,
           eventset |= POLLIN;
         }
 
+#ifdef CONFIG_NET_LOCAL_RING
+      if (conn->lc_state == LOCAL_STATE_CONNECTED)
+        {
+          eventset |= local_ring_pollevents(conn);
+        }
+#endif
+
       local_event_pollnotify(conn, eventset);
     }
   else
@@ -168,6 +175,21 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Connected peers are notified by the rings, so all of the states use
+   * the event slots.
+   */
+
+  if (conn->lc_state == LOCAL_STATE_LISTENING ||
+      conn->lc_state == LOCAL_STATE_CONNECTING ||
+      conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_event_pollsetup(conn, fds, true);
+    }
+
+  fds->priv = NULL;
+  goto pollerr;
+#else
   if ((conn->lc_state == LOCAL_STATE_LISTENING ||
        conn->lc_state == LOCAL_STATE_CONNECTING) &&
        conn->lc_type  == LOCAL_TYPE_PATHNAME)
@@ -282,6 +304,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
         ret = OK;
         break;
     }
+#endif /* CONFIG_NET_LOCAL_RING */
 #endif
 
   return ret;
@@ -322,6 +345,16 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The state may have changed since the setup */
+
+  if (fds->priv == NULL)
+    {
+      return OK;
+    }
+
+  return local_event_pollsetup(conn, fds, false);
+#else
   if ((conn->lc_state == LOCAL_STATE_LISTENING ||
        conn->lc_state == LOCAL_STATE_CONNECTING) &&
        conn->lc_type  == LOCAL_TYPE_PATHNAME)
@@ -386,6 +419,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       default:
         break;
     }
+#endif /* CONFIG_NET_LOCAL_RING */
 #endif
 
   return ret;
@@ -212,8 +212,12 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   /* Verify that this is a connected peer socket */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_state != LOCAL_STATE_CONNECTED)
+#else
   if (conn->lc_state != LOCAL_STATE_CONNECTED ||
       conn->lc_infile.f_inode == NULL)
+#endif
     {
       if (conn->lc_state == LOCAL_STATE_CONNECTING)
         {
@@ -226,11 +230,23 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   /* Read the packet */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  ret = local_ring_recv(conn, buf, len,
+                        _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                        (flags & MSG_DONTWAIT) != 0);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   ret = psock_fifo_read(psock, buf, &readlen, true);
   if (ret < 0)
     {
       return ret;
     }
+#endif
 
   /* Return the address family */
 
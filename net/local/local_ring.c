@@ -0,0 +1,501 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_LOCAL_RING_SIZE & (CONFIG_NET_LOCAL_RING_SIZE - 1)) != 0
+#  error CONFIG_NET_LOCAL_RING_SIZE must be a power of two
+#endif
+
+#define RING_SIZE  CONFIG_NET_LOCAL_RING_SIZE
+#define RING_MASK  (CONFIG_NET_LOCAL_RING_SIZE - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of a connection.  The indices run freely and are masked
+ * on access, so that head - tail is the number of bytes in the ring.  The
+ * ring is freed when both ends are detached and no thread waits on it.
+ */
+
+struct local_ring_s
+{
+  FAR struct local_conn_s *lr_reader; /* Receiving end, NULL once detached */
+  FAR struct local_conn_s *lr_writer; /* Sending end, NULL once detached */
+  sem_t    lr_rxsem;                  /* Wakes up waiting readers */
+  sem_t    lr_txsem;                  /* Wakes up waiting writers */
+  uint32_t lr_head;                   /* Write index */
+  uint32_t lr_tail;                   /* Read index */
+  uint8_t  lr_busy;                   /* Threads in send or receive */
+  uint8_t  lr_buffer[RING_SIZE];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_free
+ ****************************************************************************/
+
+static void local_ring_free(FAR struct local_ring_s *ring)
+{
+  nxsem_destroy(&ring->lr_rxsem);
+  nxsem_destroy(&ring->lr_txsem);
+  kmm_free(ring);
+}
+
+/****************************************************************************
+ * Name: local_ring_put
+ *
+ * Description:
+ *   Leave a ring entered by send or receive, and free it if it has been
+ *   detached from both ends meanwhile.
+ *
+ ****************************************************************************/
+
+static void local_ring_put(FAR struct local_ring_s *ring)
+{
+  if (--ring->lr_busy == 0 && ring->lr_reader == NULL &&
+      ring->lr_writer == NULL)
+    {
+      local_ring_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wake
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'.
+ *
+ ****************************************************************************/
+
+static void local_ring_wake(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0)
+    {
+      while (sval++ < 0)
+        {
+          nxsem_post(sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait for the peer to change the state of the ring, and map a timeout to
+ *   -EAGAIN.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, unsigned int timeout)
+{
+  int ret;
+
+  ret = net_sem_timedwait(sem, timeout);
+  return ret == -ETIMEDOUT ? -EAGAIN : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Create the two rings connecting 'client' and 'server'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings cannot be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *client,
+                     FAR struct local_conn_s *server)
+{
+  FAR struct local_ring_s *ring[2];
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      ring[i] = kmm_zalloc(sizeof(struct local_ring_s));
+      if (ring[i] == NULL)
+        {
+          if (i > 0)
+            {
+              local_ring_free(ring[0]);
+            }
+
+          return -ENOMEM;
+        }
+
+      nxsem_init(&ring[i]->lr_rxsem, 0, 0);
+      nxsem_init(&ring[i]->lr_txsem, 0, 0);
+    }
+
+  ring[0]->lr_writer = client;
+  ring[0]->lr_reader = server;
+  ring[1]->lr_writer = server;
+  ring[1]->lr_reader = client;
+
+  client->lc_txring  = ring[0];
+  server->lc_rxring  = ring[0];
+  server->lc_txring  = ring[1];
+  client->lc_rxring  = ring[1];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach the connection from its receive ring (SHUT_RD) and/or its send
+ *   ring (SHUT_WR).  The peer sees the end of the data or a broken pipe.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn, int how)
+{
+  FAR struct local_ring_s *ring;
+
+  net_lock();
+
+  ring = conn->lc_rxring;
+  if ((how & SHUT_RD) != 0 && ring != NULL)
+    {
+      conn->lc_rxring = NULL;
+      ring->lr_reader = NULL;
+
+      if (ring->lr_writer != NULL)
+        {
+          local_ring_wake(&ring->lr_txsem);
+          local_event_pollnotify(ring->lr_writer, POLLERR);
+        }
+      else if (ring->lr_busy == 0)
+        {
+          local_ring_free(ring);
+        }
+    }
+
+  ring = conn->lc_txring;
+  if ((how & SHUT_WR) != 0 && ring != NULL)
+    {
+      conn->lc_txring = NULL;
+      ring->lr_writer = NULL;
+
+      if (ring->lr_reader != NULL)
+        {
+          local_ring_wake(&ring->lr_rxsem);
+          local_event_pollnotify(ring->lr_reader, POLLIN | POLLHUP);
+        }
+      else if (ring->lr_busy == 0)
+        {
+          local_ring_free(ring);
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy the data described by 'iov' into the send ring of the connection.
+ *   The data of two regions of the ring is moved with one memcpy() each.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value if nothing was sent:
+ *   -EPIPE if the reader has gone, -EAGAIN if the ring is full and the
+ *   socket does not block or the send timeout expired.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *iov, int iovcnt,
+                        bool nonblock)
+{
+  FAR struct local_ring_s *ring;
+  FAR const uint8_t *src;
+  ssize_t total = 0;
+  size_t len;
+  uint32_t space;
+  uint32_t off;
+  uint32_t n;
+  int ret = OK;
+  int i;
+
+  net_lock();
+
+  ring = conn->lc_txring;
+  if (ring == NULL)
+    {
+      net_unlock();
+      return -EPIPE;
+    }
+
+  ring->lr_busy++;
+
+  for (i = 0; i < iovcnt && ret >= 0; i++)
+    {
+      src = iov[i].iov_base;
+      len = iov[i].iov_len;
+
+      while (len > 0)
+        {
+          if (ring->lr_reader == NULL)
+            {
+              ret = -EPIPE;
+              break;
+            }
+
+          space = RING_SIZE - (ring->lr_head - ring->lr_tail);
+          if (space == 0)
+            {
+              ret = nonblock ? -EAGAIN :
+                    local_ring_wait(&ring->lr_txsem,
+                                    _SO_TIMEOUT(conn->lc_conn.s_sndtimeo));
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          space = MIN(space, len);
+          off   = ring->lr_head & RING_MASK;
+          n     = MIN(space, RING_SIZE - off);
+
+          memcpy(&ring->lr_buffer[off], src, n);
+          memcpy(ring->lr_buffer, src + n, space - n);
+
+          ring->lr_head += space;
+          total         += space;
+          src           += space;
+          len           -= space;
+
+          local_ring_wake(&ring->lr_rxsem);
+          local_event_pollnotify(ring->lr_reader, POLLIN);
+        }
+    }
+
+  local_ring_put(ring);
+  net_unlock();
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the receive ring of the connection.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at the end of the data, or a negated
+ *   errno value: -EAGAIN if the ring is empty and the socket does not block
+ *   or the receive timeout expired.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, bool nonblock)
+{
+  FAR struct local_ring_s *ring;
+  FAR uint8_t *dest = buf;
+  uint32_t avail;
+  uint32_t off;
+  uint32_t n;
+  ssize_t ret;
+
+  net_lock();
+
+  ring = conn->lc_rxring;
+  if (ring == NULL)
+    {
+      net_unlock();
+      return 0;
+    }
+
+  ring->lr_busy++;
+
+  while ((avail = ring->lr_head - ring->lr_tail) == 0)
+    {
+      if (ring->lr_writer == NULL)
+        {
+          ret = 0;
+          goto out;
+        }
+
+      ret = nonblock ? -EAGAIN :
+            local_ring_wait(&ring->lr_rxsem,
+                            _SO_TIMEOUT(conn->lc_conn.s_rcvtimeo));
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  avail = MIN(avail, len);
+  off   = ring->lr_tail & RING_MASK;
+  n     = MIN(avail, RING_SIZE - off);
+
+  memcpy(dest, &ring->lr_buffer[off], n);
+  memcpy(dest + n, ring->lr_buffer, avail - n);
+
+  ring->lr_tail += avail;
+  ret = avail;
+
+  if (ring->lr_writer != NULL)
+    {
+      local_ring_wake(&ring->lr_txsem);
+      local_event_pollnotify(ring->lr_writer, POLLOUT);
+    }
+
+out:
+  local_ring_put(ring);
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollevents
+ *
+ * Description:
+ *   Return the poll events pending on the rings of the connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t local_ring_pollevents(FAR struct local_conn_s *conn)
+{
+  FAR struct local_ring_s *ring;
+  pollevent_t eventset = 0;
+
+  ring = conn->lc_rxring;
+  if (ring != NULL)
+    {
+      if (ring->lr_head != ring->lr_tail)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (ring->lr_writer == NULL)
+        {
+          eventset |= POLLIN | POLLHUP;
+        }
+    }
+
+  ring = conn->lc_txring;
+  if (ring != NULL)
+    {
+      if (ring->lr_reader == NULL)
+        {
+          eventset |= POLLERR;
+        }
+      else if (ring->lr_head - ring->lr_tail < RING_SIZE)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Handle FIONREAD, FIONWRITE and FIONSPACE on a connected socket.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTCONN if the ring of the direction is gone,
+ *   -ENOTTY for other commands.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     FAR int *arg)
+{
+  FAR struct local_ring_s *ring;
+  int ret = OK;
+
+  net_lock();
+
+  ring = cmd == FIONREAD ? conn->lc_rxring : conn->lc_txring;
+  if (cmd != FIONREAD && cmd != FIONWRITE && cmd != FIONSPACE)
+    {
+      ret = -ENOTTY;
+    }
+  else if (ring == NULL)
+    {
+      ret = -ENOTCONN;
+    }
+  else if (cmd == FIONSPACE)
+    {
+      *arg = RING_SIZE - (ring->lr_head - ring->lr_tail);
+    }
+  else
+    {
+      *arg = ring->lr_head - ring->lr_tail;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_RING */
@@ -182,8 +182,13 @@ static ssize_t local_send(FAR struct socket *psock,
            * opened the outgoing FIFO for write-only access.
            */
 
+#ifdef CONFIG_NET_LOCAL_RING
+          if (peer->lc_state != LOCAL_STATE_CONNECTED ||
+              peer->lc_txring == NULL)
+#else
           if (peer->lc_state != LOCAL_STATE_CONNECTED ||
               peer->lc_outfile.f_inode == NULL)
+#endif
             {
               if (peer->lc_state == LOCAL_STATE_CONNECTING)
                 {
@@ -204,7 +209,13 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
+#ifdef CONFIG_NET_LOCAL_RING
+          ret = local_ring_send(peer, buf, len,
+                                _SS_ISNONBLOCK(peer->lc_conn.s_flags) ||
+                                (flags & MSG_DONTWAIT) != 0);
+#else
           ret = local_send_packet(&peer->lc_outfile, buf, len, false);
+#endif
           nxmutex_unlock(&peer->lc_sendlock);
         }
         break;
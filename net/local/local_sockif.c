@@ -767,6 +767,13 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
           }
         break;
       case FIONREAD:
+#ifdef CONFIG_NET_LOCAL_RING
+        if (conn->lc_state == LOCAL_STATE_CONNECTED)
+          {
+            ret = local_ring_ioctl(conn, cmd, (FAR int *)(uintptr_t)arg);
+          }
+        else
+#endif
         if (conn->lc_infile.f_inode != NULL)
           {
             ret = file_ioctl(&conn->lc_infile, cmd, arg);
@@ -778,6 +785,13 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
         break;
       case FIONWRITE:
       case FIONSPACE:
+#ifdef CONFIG_NET_LOCAL_RING
+        if (conn->lc_state == LOCAL_STATE_CONNECTED)
+          {
+            ret = local_ring_ioctl(conn, cmd, (FAR int *)(uintptr_t)arg);
+          }
+        else
+#endif
         if (conn->lc_outfile.f_inode != NULL)
           {
             ret = file_ioctl(&conn->lc_outfile, cmd, arg);
@@ -814,7 +828,9 @@ static int local_socketpair(FAR struct socket *psocks[2])
 #if defined(CONFIG_NET_LOCAL_STREAM) || defined(CONFIG_NET_LOCAL_DGRAM)
   FAR struct local_conn_s *conns[2];
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifndef CONFIG_NET_LOCAL_RING
   bool nonblock;
+#endif
   int ret;
 #endif /* CONFIG_NET_LOCAL_STREAM */
   int i;
@@ -843,6 +859,16 @@ static int local_socketpair(FAR struct socket *psocks[2])
   conns[0]->lc_instance_id = conns[1]->lc_instance_id
                            = local_generate_instance_id();
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Create the ring buffers connecting the pair */
+
+  ret = local_ring_alloc(conns[0], conns[1]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0]);
@@ -884,14 +910,17 @@ static int local_socketpair(FAR struct socket *psocks[2])
     {
       goto errout;
     }
+#endif
 
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
   return OK;
 
+#ifndef CONFIG_NET_LOCAL_RING
 errout:
   local_release_fifos(conns[0]);
   return ret;
+#endif
 #endif /* CONFIG_NET_LOCAL_STREAM */
 #else
   return -EOPNOTSUPP;
@@ -930,6 +959,11 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_RING
+          local_ring_release(conn, how);
+#endif
+
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
@@ -56,6 +56,28 @@
 static DECLARE_HASHTABLE(g_table_inbound, CONFIG_NET_NAT_HASH_BITS);
 static DECLARE_HASHTABLE(g_table_outbound, CONFIG_NET_NAT_HASH_BITS);
 
+/* The entries of one protocol share the same idle timeout, so queueing
+ * them in the order of their last refresh keeps them sorted by expiration
+ * time:  The expired entries are always at the head.
+ */
+
+#ifdef CONFIG_NET_TCP
+static dq_queue_t g_expire_tcp;
+#endif
+#ifdef CONFIG_NET_UDP
+static dq_queue_t g_expire_udp;
+#endif
+#ifdef CONFIG_NET_ICMP
+static dq_queue_t g_expire_icmp;
+#endif
+
+/* The entries that were matched last.  Packets of a flow usually come in
+ * bursts, so these spare the hash and chain walk for most packets.
+ */
+
+static FAR struct ipv4_nat_entry *g_last_inbound;
+static FAR struct ipv4_nat_entry *g_last_outbound;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -92,6 +114,77 @@ static inline uint32_t ipv4_nat_outbound_key(in_addr_t local_ip,
          ((uint32_t)protocol << 8) ^ ((uint32_t)local_port << 16);
 }
 
+/****************************************************************************
+ * Name: ipv4_nat_expire_queue
+ *
+ * Description:
+ *   Return the expiry queue of the entries of 'protocol', or NULL if the
+ *   protocol has no idle timeout.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *ipv4_nat_expire_queue(uint8_t protocol)
+{
+  switch (protocol)
+    {
+#ifdef CONFIG_NET_TCP
+      case IP_PROTO_TCP:
+        return &g_expire_tcp;
+#endif
+
+#ifdef CONFIG_NET_UDP
+      case IP_PROTO_UDP:
+        return &g_expire_udp;
+#endif
+
+#ifdef CONFIG_NET_ICMP
+      case IP_PROTO_ICMP:
+        return &g_expire_icmp;
+#endif
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_inbound_match
+ *
+ * Description:
+ *   Check whether 'entry' is the inbound entry of the external ip:port.
+ *
+ ****************************************************************************/
+
+static inline bool ipv4_nat_inbound_match(FAR struct ipv4_nat_entry *entry,
+                                          uint8_t protocol,
+                                          in_addr_t external_ip,
+                                          uint16_t external_port,
+                                          bool skip_ip)
+{
+  return entry->protocol == protocol &&
+         (skip_ip || net_ipv4addr_cmp(entry->external_ip, external_ip)) &&
+         entry->external_port == external_port;
+}
+
+/****************************************************************************
+ * Name: ipv4_nat_outbound_match
+ *
+ * Description:
+ *   Check whether 'entry' is the outbound entry of the local ip:port.
+ *
+ ****************************************************************************/
+
+static inline bool ipv4_nat_outbound_match(FAR struct ipv4_nat_entry *entry,
+                                           FAR struct net_driver_s *dev,
+                                           uint8_t protocol,
+                                           in_addr_t local_ip,
+                                           uint16_t local_port)
+{
+  return entry->protocol == protocol &&
+         net_ipv4addr_cmp(entry->external_ip, dev->d_ipaddr) &&
+         net_ipv4addr_cmp(entry->local_ip, local_ip) &&
+         entry->local_port == local_port;
+}
+
 /****************************************************************************
  * Name: ipv4_nat_select_port_without_stack
  *
@@ -247,9 +340,15 @@ static uint16_t ipv4_nat_select_port(FAR struct net_driver_s *dev,
 
 static void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry)
 {
-  /* Note: May add logic here to move recent node to head side if each chain
-   * in hashtable is still too long (with long expire time).
-   */
+  FAR dq_queue_t *queue = ipv4_nat_expire_queue(entry->protocol);
+
+  /* The entry now expires last of its protocol */
+
+  if (queue != NULL)
+    {
+      dq_rem(&entry->expire_node, queue);
+      dq_addlast(&entry->expire_node, queue);
+    }
 
   switch (entry->protocol)
     {
@@ -308,6 +407,8 @@ ipv4_nat_entry_create(uint8_t protocol,
 {
   FAR struct ipv4_nat_entry *entry =
       (FAR struct ipv4_nat_entry *)kmm_malloc(sizeof(struct ipv4_nat_entry));
+  FAR dq_queue_t *queue;
+
   if (entry == NULL)
     {
       nwarn("WARNING: Failed to allocate IPv4 NAT entry\n");
@@ -320,6 +421,12 @@ ipv4_nat_entry_create(uint8_t protocol,
   entry->local_ip      = local_ip;
   entry->local_port    = local_port;
 
+  queue = ipv4_nat_expire_queue(protocol);
+  if (queue != NULL)
+    {
+      dq_addlast(&entry->expire_node, queue);
+    }
+
   ipv4_nat_entry_refresh(entry);
 
   hashtable_add(g_table_inbound, &entry->hash_inbound,
@@ -343,6 +450,8 @@ ipv4_nat_entry_create(uint8_t protocol,
 
 static void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
 {
+  FAR dq_queue_t *queue;
+
   ninfo("INFO: Removing NAT entry proto=%d, local=%x:%d, external=:%d\n",
         entry->protocol, entry->local_ip, entry->local_port,
         entry->external_port);
@@ -355,6 +464,22 @@ static void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
                    ipv4_nat_outbound_key(entry->local_ip, entry->local_port,
                                          entry->protocol));
 
+  queue = ipv4_nat_expire_queue(entry->protocol);
+  if (queue != NULL)
+    {
+      dq_rem(&entry->expire_node, queue);
+    }
+
+  if (g_last_inbound == entry)
+    {
+      g_last_inbound = NULL;
+    }
+
+  if (g_last_outbound == entry)
+    {
+      g_last_outbound = NULL;
+    }
+
   kmm_free(entry);
 }
 
@@ -362,49 +487,49 @@ static void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
  * Name: ipv4_nat_reclaim_entry
  *
  * Description:
- *   Try reclaim all expired NAT entries.
- *   Only works after every CONFIG_NET_NAT_ENTRY_RECLAIM_SEC (low frequency).
- *
- *   Although expired entries will be automatically reclaimed when matching
- *   inbound/outbound entries, there might be some situations that entries
- *   will be kept in memory, e.g. big hashtable with only a few connections.
+ *   Reclaim all expired NAT entries.  They are found at the heads of the
+ *   expiry queues, so this costs little more than a look at the oldest
+ *   entry of each protocol if none has expired.
  *
  * Assumptions:
  *   NAT is initialized.
  *
  ****************************************************************************/
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
 static void ipv4_nat_reclaim_entry(int32_t current_time)
 {
-  static int32_t next_reclaim_time = CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
-
-  if (next_reclaim_time - current_time <= 0)
-    {
-      FAR hash_node_t *p;
-      FAR hash_node_t *tmp;
-      int count = 0;
-      int i;
+  FAR dq_queue_t *queues[] =
+  {
+#ifdef CONFIG_NET_TCP
+    &g_expire_tcp,
+#endif
+#ifdef CONFIG_NET_UDP
+    &g_expire_udp,
+#endif
+#ifdef CONFIG_NET_ICMP
+    &g_expire_icmp,
+#endif
+    NULL
+  };
 
-      ninfo("INFO: Reclaiming all expired NAT entries.\n");
+  FAR struct ipv4_nat_entry *entry;
+  int i;
 
-      hashtable_for_every_safe(g_table_inbound, p, tmp, i)
+  for (i = 0; queues[i] != NULL; i++)
+    {
+      while (!dq_empty(queues[i]))
         {
-          FAR struct ipv4_nat_entry *entry =
-            container_of(p, struct ipv4_nat_entry, hash_inbound);
-
-          if (entry->expire_time - current_time <= 0)
+          entry = container_of(dq_peek(queues[i]), struct ipv4_nat_entry,
+                               expire_node);
+          if (entry->expire_time - current_time > 0)
             {
-              ipv4_nat_entry_delete(entry);
-              count++;
+              break;
             }
-        }
 
-      ninfo("INFO: %d expired NAT entries reclaimed.\n", count);
-      next_reclaim_time = current_time + CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
+          ipv4_nat_entry_delete(entry);
+        }
     }
 }
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -466,39 +591,29 @@ FAR struct ipv4_nat_entry *
 ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
                             uint16_t external_port, bool refresh)
 {
+  FAR struct ipv4_nat_entry *entry;
   FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
   bool skip_ip = net_ipv4addr_cmp(external_ip, INADDR_ANY);
-  int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-  ipv4_nat_reclaim_entry(current_time);
-#endif
+  ipv4_nat_reclaim_entry(TICK2SEC(clock_systime_ticks()));
 
-  hashtable_for_every_possible_safe(g_table_inbound, p, tmp,
-                  ipv4_nat_inbound_key(external_ip, external_port, protocol))
+  entry = g_last_inbound;
+  if (entry != NULL &&
+      ipv4_nat_inbound_match(entry, protocol, external_ip, external_port,
+                             skip_ip))
     {
-      FAR struct ipv4_nat_entry *entry =
-        container_of(p, struct ipv4_nat_entry, hash_inbound);
-
-      /* Remove expired entries. */
-
-      if (entry->expire_time - current_time <= 0)
-        {
-          ipv4_nat_entry_delete(entry);
-          continue;
-        }
+      goto found;
+    }
 
-      if (entry->protocol == protocol &&
-          (skip_ip || net_ipv4addr_cmp(entry->external_ip, external_ip)) &&
-          entry->external_port == external_port)
+  hashtable_for_every_possible(g_table_inbound, p,
+                  ipv4_nat_inbound_key(external_ip, external_port, protocol))
+    {
+      entry = container_of(p, struct ipv4_nat_entry, hash_inbound);
+      if (ipv4_nat_inbound_match(entry, protocol, external_ip, external_port,
+                                 skip_ip))
         {
-          if (refresh)
-            {
-              ipv4_nat_entry_refresh(entry);
-            }
-
-          return entry;
+          g_last_inbound = entry;
+          goto found;
         }
     }
 
@@ -510,6 +625,14 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
     }
 
   return NULL;
+
+found:
+  if (refresh)
+    {
+      ipv4_nat_entry_refresh(entry);
+    }
+
+  return entry;
 }
 
 /****************************************************************************
@@ -536,33 +659,27 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
                              in_addr_t local_ip, uint16_t local_port,
                              bool try_create)
 {
+  FAR struct ipv4_nat_entry *entry;
   FAR hash_node_t *p;
-  FAR hash_node_t *tmp;
-  int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-  ipv4_nat_reclaim_entry(current_time);
-#endif
+  ipv4_nat_reclaim_entry(TICK2SEC(clock_systime_ticks()));
 
-  hashtable_for_every_possible_safe(g_table_outbound, p, tmp,
-                      ipv4_nat_outbound_key(local_ip, local_port, protocol))
+  entry = g_last_outbound;
+  if (entry != NULL &&
+      ipv4_nat_outbound_match(entry, dev, protocol, local_ip, local_port))
     {
-      FAR struct ipv4_nat_entry *entry =
-        container_of(p, struct ipv4_nat_entry, hash_outbound);
-
-      /* Remove expired entries. */
-
-      if (entry->expire_time - current_time <= 0)
-        {
-          ipv4_nat_entry_delete(entry);
-          continue;
-        }
+      ipv4_nat_entry_refresh(entry);
+      return entry;
+    }
 
-      if (entry->protocol == protocol &&
-          net_ipv4addr_cmp(entry->external_ip, dev->d_ipaddr) &&
-          net_ipv4addr_cmp(entry->local_ip, local_ip) &&
-          entry->local_port == local_port)
+  hashtable_for_every_possible(g_table_outbound, p,
+                      ipv4_nat_outbound_key(local_ip, local_port, protocol))
+    {
+      entry = container_of(p, struct ipv4_nat_entry, hash_outbound);
+      if (ipv4_nat_outbound_match(entry, dev, protocol, local_ip,
+                                  local_port))
         {
+          g_last_outbound = entry;
           ipv4_nat_entry_refresh(entry);
           return entry;
         }
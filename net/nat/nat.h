@@ -33,6 +33,7 @@
 #include <netinet/in.h>
 
 #include <nuttx/hashtable.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 
@@ -46,6 +47,7 @@ struct ipv4_nat_entry
 {
   hash_node_t hash_inbound;
   hash_node_t hash_outbound;
+  dq_entry_t  expire_node;   /* Node in the expiry queue of its protocol */
 
   /*  Local Network                             External Network
    *                |----------------|
@@ -37,6 +37,23 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The Neighbor table is set associative: an IPv6 address hashes to one set
+ * of NEIGHBOR_NWAYS entries and the least recently used entry of the set
+ * is replaced.
+ */
+
+#if CONFIG_NET_IPv6_NCONF_ENTRIES < 4
+#  define NEIGHBOR_NWAYS    CONFIG_NET_IPv6_NCONF_ENTRIES
+#else
+#  define NEIGHBOR_NWAYS    4
+#endif
+
+#define NEIGHBOR_NSETS      (CONFIG_NET_IPv6_NCONF_ENTRIES / NEIGHBOR_NWAYS)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -53,6 +70,17 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_set
+ *
+ * Description:
+ *   Return the first of the NEIGHBOR_NWAYS entries of the Neighbor Table
+ *   that may hold the IPv6 address.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_set(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
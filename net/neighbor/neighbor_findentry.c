@@ -33,6 +33,27 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_set
+ *
+ * Description:
+ *   Return the first of the NEIGHBOR_NWAYS entries of the Neighbor Table
+ *   that may hold the IPv6 address.  The hash includes the low 64 bits,
+ *   which identify the neighbor on its link.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_set(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash;
+
+  hash = ((uint32_t)ipaddr[4] << 16 | ipaddr[5]) ^
+         ((uint32_t)ipaddr[6] << 16 | ipaddr[7]);
+  hash *= 2654435761u;
+
+  return &g_neighbors[((hash >> 16) % NEIGHBOR_NSETS) * NEIGHBOR_NWAYS];
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -51,11 +72,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+  FAR struct neighbor_entry_s *set = neighbor_set(ipaddr);
   int i;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (i = 0; i < NEIGHBOR_NWAYS; ++i)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &set[i];
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -0,0 +1,268 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GRO_IPHDR(iob)  ((FAR struct ipv4_hdr_s *)IOB_DATA(iob))
+#define GRO_TCPHDR(iob) ((FAR struct tcp_hdr_s *)(IOB_DATA(iob) + \
+                                                  IPv4_HDRLEN))
+#define GRO_TCPHDRLEN(tcp) (((tcp)->tcpoffset >> 4) << 2)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_iplen
+ *
+ * Description:
+ *   Return the total length from the IPv4 header.
+ *
+ ****************************************************************************/
+
+static inline uint16_t netdev_gro_iplen(FAR struct ipv4_hdr_s *ipv4)
+{
+  return ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+}
+
+/****************************************************************************
+ * Name: netdev_gro_candidate
+ *
+ * Description:
+ *   Check whether the IPv4 packet in d_iob is a TCP data segment for us
+ *   that may be coalesced.  The IP and TCP checksums of a candidate are
+ *   verified here, so that they need not be verified again on input.
+ *
+ * Returned Value:
+ *   The TCP payload length of a candidate; zero otherwise.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_gro_candidate(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct ipv4_hdr_s *ipv4 = GRO_IPHDR(iob);
+  FAR struct tcp_hdr_s *tcp = GRO_TCPHDR(iob);
+  uint16_t totlen;
+  uint16_t hdrlen;
+
+  /* The IP and TCP headers must be in the first buffer; IP options and
+   * fragments are left to the protocol layer.
+   */
+
+  if (iob->io_len < IPv4_HDRLEN + TCP_HDRLEN || ipv4->vhl != 0x45 ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr))
+    {
+      return 0;
+    }
+
+  totlen = netdev_gro_iplen(ipv4);
+  hdrlen = IPv4_HDRLEN + GRO_TCPHDRLEN(tcp);
+  if (totlen > dev->d_len || totlen <= hdrlen || hdrlen > iob->io_len ||
+      (tcp->flags & ~(TCP_ACK | TCP_PSH)) != 0 ||
+      (tcp->flags & TCP_ACK) == 0)
+    {
+      return 0;
+    }
+
+  /* Drop any link layer padding */
+
+  if (totlen < dev->d_len)
+    {
+      iob_update_pktlen(iob, totlen);
+      dev->d_len = totlen;
+    }
+
+  if (ipv4_chksum(ipv4) != 0xffff || tcp_ipv4_chksum(dev) != 0xffff)
+    {
+      return 0;
+    }
+
+  return totlen - hdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_match
+ *
+ * Description:
+ *   Check whether the segment 'iob' directly follows the segments held in
+ *   'held' within the same flow, and carries the same ACK and options.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_match(FAR struct iob_s *held, FAR struct iob_s *iob)
+{
+  FAR struct ipv4_hdr_s *hip = GRO_IPHDR(held);
+  FAR struct ipv4_hdr_s *ip = GRO_IPHDR(iob);
+  FAR struct tcp_hdr_s *htcp = GRO_TCPHDR(held);
+  FAR struct tcp_hdr_s *tcp = GRO_TCPHDR(iob);
+  uint16_t hdrlen = GRO_TCPHDRLEN(htcp);
+  uint32_t seqno;
+
+  if (memcmp(hip->srcipaddr, ip->srcipaddr, 2 * sizeof(in_addr_t)) != 0 ||
+      hip->tos != ip->tos || hip->ttl != ip->ttl ||
+      htcp->srcport != tcp->srcport || htcp->destport != tcp->destport ||
+      memcmp(htcp->ackno, tcp->ackno, 4) != 0 ||
+      (htcp->flags & TCP_PSH) != 0 || GRO_TCPHDRLEN(tcp) != hdrlen ||
+      memcmp(htcp->optdata, tcp->optdata, hdrlen - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  seqno = tcp_getsequence(htcp->seqno) + netdev_gro_iplen(hip) -
+          IPv4_HDRLEN - hdrlen;
+  return seqno == tcp_getsequence(tcp->seqno);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Try to coalesce the received IPv4 packet in d_iob with the TCP
+ *   segments held for the device.  A TCP data segment for us is either
+ *   appended to the held segments, if it is the next in-order segment of
+ *   the same flow, or held itself if nothing is held yet.
+ *
+ * Input Parameters:
+ *   dev - The device holding the received IPv4 packet in d_iob
+ *
+ * Returned Value:
+ *   True if the packet was taken over; d_iob is then NULL.  False if the
+ *   packet was left in d_iob: the caller has to flush the held segments
+ *   with netdev_gro_flush() before it inputs the packet.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+bool netdev_gro_receive(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *held = dev->d_gro;
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t payload;
+  uint16_t totlen;
+
+  payload = netdev_gro_candidate(dev);
+  if (payload == 0)
+    {
+      return false;
+    }
+
+  if (held == NULL)
+    {
+      iob->io_offload |= NETDEV_OFFLOAD_CSUM_VALID;
+      dev->d_gro = iob;
+      goto taken;
+    }
+
+  totlen = netdev_gro_iplen(GRO_IPHDR(held));
+  if (totlen + payload > CONFIG_NETDEV_GRO_MAXSIZE ||
+      !netdev_gro_match(held, iob))
+    {
+      return false;
+    }
+
+  /* Take over the window and PSH flag of the new segment and append its
+   * payload.
+   */
+
+  tcp  = GRO_TCPHDR(held);
+  memcpy(tcp->wnd, GRO_TCPHDR(iob)->wnd, sizeof(tcp->wnd));
+  tcp->flags |= GRO_TCPHDR(iob)->flags & TCP_PSH;
+
+  iob_concat(held, iob_trimhead(iob, dev->d_len - payload));
+
+  totlen        += payload;
+  ipv4           = GRO_IPHDR(held);
+  ipv4->len[0]   = totlen >> 8;
+  ipv4->len[1]   = totlen & 0xff;
+  ipv4->ipchksum = 0;
+  ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+taken:
+  dev->d_iob = NULL;
+  dev->d_len = 0;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Move the TCP segments held for the device into d_iob as one packet,
+ *   to be input by the caller.  The current d_iob must have been saved or
+ *   released.
+ *
+ * Returned Value:
+ *   True if a packet was moved into d_iob; false if nothing was held.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+bool netdev_gro_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *held = dev->d_gro;
+
+  if (held == NULL)
+    {
+      return false;
+    }
+
+  dev->d_gro = NULL;
+  dev->d_iob = held;
+  dev->d_len = held->io_pktlen;
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
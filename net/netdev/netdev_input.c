@@ -24,6 +24,8 @@
 
 #include <nuttx/config.h>
 
+#include <errno.h>
+
 #include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
@@ -81,7 +83,14 @@ int netdev_input(FAR struct net_driver_s *dev,
   /* Copy data to iob entry */
 
   ret = iob_trycopyin(dev->d_iob, buf, dev->d_len, -llhdrlen, false);
-  if (ret == dev->d_len)
+  if (ret == dev->d_len && netdev_iob_charge(dev) < 0)
+    {
+      /* The device exceeded its RX I/O buffer quota, drop the packet */
+
+      NETDEV_RXDROPPED(dev);
+      ret = -ENOBUFS;
+    }
+  else if (ret == dev->d_len)
     {
       /* Update device buffer to l2 start */
 
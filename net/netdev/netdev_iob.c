@@ -27,6 +27,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
 /****************************************************************************
@@ -84,6 +85,42 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
   return OK;
 }
 
+/****************************************************************************
+ * Name: netdev_iob_charge
+ *
+ * Description:
+ *   Charge the received packet in dev->d_iob to the RX I/O buffer quota of
+ *   the device.  Devices whose interface index has no owner slot are not
+ *   accounted.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOBUFS if the device exceeded its quota.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_QUOTA
+int netdev_iob_charge(FAR struct net_driver_s *dev)
+{
+  int ret;
+
+  if (dev->d_iob == NULL || dev->d_ifindex > CONFIG_IOB_NOWNERS)
+    {
+      return OK;
+    }
+
+  ret = iob_charge(dev->d_iob, dev->d_ifindex);
+  if (ret == -ENOBUFS)
+    {
+      nwarn("WARNING: RX IOB quota exceeded for dev %s!\n", dev->d_ifname);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_iob_replace
  *
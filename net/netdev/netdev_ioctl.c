@@ -149,6 +149,7 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   in_addr_t target;
   in_addr_t netmask;
   in_addr_t router;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -159,7 +160,20 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_gateway;
   router  = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_addroute_ipv4(target, netmask, router);
+  ret = net_addroute_ipv4(target, netmask, router);
+#ifdef CONFIG_NETLINK_ROUTE
+  if (ret >= 0)
+    {
+      struct net_route_ipv4_s route;
+
+      route.target  = target;
+      route.netmask = netmask;
+      route.router  = router;
+      netlink_ipv4route_notify(&route, RTM_NEWROUTE);
+    }
+#endif
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -181,6 +195,7 @@ static int ioctl_add_ipv6route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in6 *netmask;
   FAR struct sockaddr_in6 *gateway;
   net_ipv6addr_t router;
+  int ret;
 
   target  = (FAR struct sockaddr_in6 *)&rtentry->rt_dst;
   netmask = (FAR struct sockaddr_in6 *)&rtentry->rt_genmask;
@@ -190,8 +205,21 @@ static int ioctl_add_ipv6route(FAR struct rtentry *rtentry)
   gateway = (FAR struct sockaddr_in6 *)&rtentry->rt_gateway;
   net_ipv6addr_copy(router, gateway->sin6_addr.s6_addr16);
 
-  return net_addroute_ipv6(target->sin6_addr.s6_addr16,
-                           netmask->sin6_addr.s6_addr16, router);
+  ret = net_addroute_ipv6(target->sin6_addr.s6_addr16,
+                          netmask->sin6_addr.s6_addr16, router);
+#ifdef CONFIG_NETLINK_ROUTE
+  if (ret >= 0)
+    {
+      struct net_route_ipv6_s route;
+
+      net_ipv6addr_copy(route.target, target->sin6_addr.s6_addr16);
+      net_ipv6addr_copy(route.netmask, netmask->sin6_addr.s6_addr16);
+      net_ipv6addr_copy(route.router, router);
+      netlink_ipv6route_notify(&route, RTM_NEWROUTE);
+    }
+#endif
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv6ROUTE */
 
@@ -212,6 +240,7 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in *addr;
   in_addr_t target;
   in_addr_t netmask;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -219,7 +248,20 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_genmask;
   netmask = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_delroute_ipv4(target, netmask);
+  ret = net_delroute_ipv4(target, netmask);
+#ifdef CONFIG_NETLINK_ROUTE
+  if (ret >= 0)
+    {
+      struct net_route_ipv4_s route;
+
+      route.target  = target;
+      route.netmask = netmask;
+      route.router  = 0;
+      netlink_ipv4route_notify(&route, RTM_DELROUTE);
+    }
+#endif
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -239,12 +281,26 @@ static int ioctl_del_ipv6route(FAR struct rtentry *rtentry)
 {
   FAR struct sockaddr_in6 *target;
   FAR struct sockaddr_in6 *netmask;
+  int ret;
 
   target  = (FAR struct sockaddr_in6 *)&rtentry->rt_dst;
   netmask = (FAR struct sockaddr_in6 *)&rtentry->rt_genmask;
 
-  return net_delroute_ipv6(target->sin6_addr.s6_addr16,
-                           netmask->sin6_addr.s6_addr16);
+  ret = net_delroute_ipv6(target->sin6_addr.s6_addr16,
+                          netmask->sin6_addr.s6_addr16);
+#ifdef CONFIG_NETLINK_ROUTE
+  if (ret >= 0)
+    {
+      struct net_route_ipv6_s route;
+
+      net_ipv6addr_copy(route.target, target->sin6_addr.s6_addr16);
+      net_ipv6addr_copy(route.netmask, netmask->sin6_addr.s6_addr16);
+      memset(route.router, 0, sizeof(route.router));
+      netlink_ipv6route_notify(&route, RTM_DELROUTE);
+    }
+#endif
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv6ROUTE */
 
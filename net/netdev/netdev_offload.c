@@ -0,0 +1,205 @@
+/****************************************************************************
+ * net/netdev/netdev_offload.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_offload_chksum
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   device if it supports the checksum offload for the IP version of the
+ *   packet.  The checksum field is then seeded with the pseudo header sum
+ *   and the packet is tagged with NETDEV_OFFLOAD_CSUM.  A TCP packet whose
+ *   payload is larger than 'gsosize' is additionally tagged for TSO.
+ *
+ * Input Parameters:
+ *   dev     - The network device holding the packet in d_iob
+ *   proto   - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen   - The size of the IP header, including IPv6 extension headers
+ *   csumoff - The offset of the checksum field in the upper layer header
+ *   gsosize - The segment payload size for TSO, zero if not segmentable
+ *
+ * Returned Value:
+ *   True if the device computes the checksum; false if the caller has to
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network and the IP header is complete.
+ *
+ ****************************************************************************/
+
+bool netdev_offload_chksum(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen, unsigned int csumoff,
+                           uint16_t gsosize)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR const uint8_t *addr;
+  FAR uint16_t *field;
+  unsigned int addrlen;
+  uint32_t feature;
+  uint16_t upperlen;
+  uint16_t sum;
+
+  iob->io_offload = 0;
+
+  /* Look at the header itself: an IPv6 socket may send IPv4 packets to an
+   * IPv4-mapped address.
+   */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      feature  = NETDEV_FEATURE_TXCSUM_IPv6;
+      upperlen = ((uint16_t)ipv6->len[0] << 8) + ipv6->len[1] -
+                 (iplen - IPv6_HDRLEN);
+      addr     = (FAR const uint8_t *)ipv6->srcipaddr;
+      addrlen  = 2 * sizeof(net_ipv6addr_t);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      feature  = NETDEV_FEATURE_TXCSUM_IPv4;
+      upperlen = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1] - iplen;
+      addr     = (FAR const uint8_t *)ipv4->srcipaddr;
+      addrlen  = 2 * sizeof(in_addr_t);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  /* The headers have to be in the head of the chain, and a packet that is
+   * looped back to ourself never reaches the hardware.
+   */
+
+  if ((dev->d_features & feature) == 0 || csumoff > UINT8_MAX ||
+      iplen + csumoff + sizeof(uint16_t) > iob->io_len ||
+      devif_is_loopback(dev))
+    {
+      return false;
+    }
+
+  if (proto == IP_PROTO_TCP && gsosize > 0 &&
+      (dev->d_features & NETDEV_FEATURE_TSO) != 0)
+    {
+      FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+
+      if (upperlen - ((tcp->tcpoffset >> 4) << 2) > gsosize)
+        {
+          /* The device adds the length of each segment itself */
+
+          iob->io_offload = NETDEV_OFFLOAD_TSO;
+          iob->io_gsosize = gsosize;
+          upperlen        = 0;
+        }
+    }
+
+  /* Seed the checksum field with the (not complemented) pseudo header sum.
+   * The device adds the sum of the upper layer header and payload and
+   * stores the complement.
+   */
+
+  sum = upperlen + proto;
+  if (sum < proto)
+    {
+      sum++;
+    }
+
+  sum    = chksum(sum, addr, addrlen);
+  field  = IPBUF(iplen + csumoff);
+  *field = HTONS(sum);
+
+  iob->io_offload  |= NETDEV_OFFLOAD_CSUM;
+  iob->io_csumstart = iplen;
+  iob->io_csumoff   = csumoff;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_offload_tsosize
+ *
+ * Description:
+ *   Return the largest TCP payload that can be handed to the device in one
+ *   packet.  This is a multiple of 'mss' if the device supports TSO for
+ *   the IP version, else 'mss' itself.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   ipv6    - True for IPv6 packets
+ *   hdrlen  - The size of the IP and TCP headers
+ *   mss     - The maximum segment size of the connection
+ *
+ ****************************************************************************/
+
+uint32_t netdev_offload_tsosize(FAR struct net_driver_s *dev, bool ipv6,
+                                unsigned int hdrlen, uint16_t mss)
+{
+  uint32_t required = NETDEV_FEATURE_TSO | NETDEV_FEATURE_SG;
+  uint32_t maxlen;
+
+  required |= ipv6 ? NETDEV_FEATURE_TXCSUM_IPv6 : NETDEV_FEATURE_TXCSUM_IPv4;
+
+  /* The whole frame, link layer header included, has to fit into d_len */
+
+  maxlen = dev->d_tsomax;
+  if (maxlen > UINT16_MAX - NET_LL_HDRLEN(dev))
+    {
+      maxlen = UINT16_MAX - NET_LL_HDRLEN(dev);
+    }
+
+  if (mss == 0 || (dev->d_features & required) != required ||
+      maxlen < hdrlen + 2 * mss)
+    {
+      return mss;
+    }
+
+  maxlen -= hdrlen;
+  return maxlen - maxlen % mss;
+}
+
+#endif /* CONFIG_NETDEV_OFFLOAD */
@@ -33,6 +33,7 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
@@ -402,6 +403,12 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
         }
 
       dev->d_ifindex = (uint8_t)ifindex;
+
+#ifdef CONFIG_NETDEV_IOB_QUOTA
+      /* Interfaces beyond CONFIG_IOB_NOWNERS are not accounted */
+
+      iob_setquota(ifindex, CONFIG_NETDEV_IOB_QUOTA);
+#endif
 #endif
 
       /* Get the next available device number and assign a device name to
@@ -46,6 +46,16 @@
 #ifndef CONFIG_NETLINK_ROUTE
 #  define netlink_device_notify(dev)
 #  define netlink_device_notify_ipaddr(dev, type, domain)
+#  define netlink_neigh_notify(neigh, type, domain)
+#endif
+
+#if !defined(CONFIG_NETLINK_ROUTE) || !defined(CONFIG_NET_ROUTE)
+#  define netlink_ipv4route_notify(route, type)
+#  define netlink_ipv6route_notify(route, type)
+#endif
+
+#ifndef CONFIG_NETLINK_DUMP_BATCH
+#  define CONFIG_NETLINK_DUMP_BATCH 16
 #endif
 
 #ifdef CONFIG_NET_NETLINK
@@ -184,6 +194,11 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Generates the next responses of a dump, see netlink_dump_continue() */
+
+struct netlink_conn_s;
+typedef CODE int (*netlink_dump_t)(FAR struct netlink_conn_s *conn);
+
 /* This connection structure describes the underlying state of the socket. */
 
 struct netlink_conn_s
@@ -208,6 +223,13 @@ struct netlink_conn_s
   /* Queued response data */
 
   sq_queue_t resplist;               /* Singly linked list of responses */
+
+  /* Dump in progress, generated a batch at a time as it is received */
+
+  netlink_dump_t dump;               /* Generates the next batch, or NULL */
+  struct nlmsghdr dumphdr;           /* The header of the dump request */
+  uint8_t dumpfamily;                /* The family requested */
+  unsigned int dumpnext;             /* Index of the next entry to dump */
 };
 
 /**
@@ -468,6 +490,35 @@ netlink_get_response(FAR struct netlink_conn_s *conn);
 
 bool netlink_check_response(FAR struct netlink_conn_s *conn);
 
+/****************************************************************************
+ * Name: netlink_tryget_multi
+ *
+ * Description:
+ *   Return the response at the head of the pending response list if it is
+ *   a part of a multipart message, of at most maxlen bytes.
+ *
+ * Returned Value:
+ *   The next response, or NULL if there is none or it is something else.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_RECV_MULTI
+FAR struct netlink_response_s *
+netlink_tryget_multi(FAR struct netlink_conn_s *conn, size_t maxlen);
+#endif
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Generate the next batch of responses of the dump in progress, if all of
+ *   the previous ones have been received.  The dump function clears
+ *   conn->dump after adding the NLMSG_DONE terminator.
+ *
+ ****************************************************************************/
+
+void netlink_dump_continue(FAR struct netlink_conn_s *conn);
+
 /****************************************************************************
  * Name: netlink_route_sendto()
  *
@@ -504,6 +555,40 @@ void netlink_device_notify(FAR struct net_driver_s *dev);
 void netlink_device_notify_ipaddr(FAR struct net_driver_s *dev,
                                   int type, int domain);
 
+/****************************************************************************
+ * Name: netlink_ipv4route_notify() and netlink_ipv6route_notify()
+ *
+ * Description:
+ *   Broadcast the addition (RTM_NEWROUTE) or removal (RTM_DELROUTE) of a
+ *   route to the RTNLGRP_IPV4_ROUTE or RTNLGRP_IPV6_ROUTE group.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv4)
+struct net_route_ipv4_s;
+void netlink_ipv4route_notify(FAR const struct net_route_ipv4_s *route,
+                              int type);
+#endif
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv6)
+struct net_route_ipv6_s;
+void netlink_ipv6route_notify(FAR const struct net_route_ipv6_s *route,
+                              int type);
+#endif
+
+/****************************************************************************
+ * Name: netlink_neigh_notify()
+ *
+ * Description:
+ *   Broadcast a new or changed (RTM_NEWNEIGH) or a removed (RTM_DELNEIGH)
+ *   neighbor to the RTNLGRP_NEIGH group, in the format of the RTM_GETNEIGH
+ *   dumps: neigh is a struct arpreq for AF_INET and a struct
+ *   neighbor_entry_s for AF_INET6.
+ *
+ ****************************************************************************/
+
+void netlink_neigh_notify(FAR const void *neigh, int type, int domain);
+
 /****************************************************************************
  * Name: nla_next
  *
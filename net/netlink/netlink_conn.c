@@ -489,4 +489,73 @@ bool netlink_check_response(FAR struct netlink_conn_s *conn)
   return (sq_peek(&conn->resplist) != NULL);
 }
 
+/****************************************************************************
+ * Name: netlink_tryget_multi
+ *
+ * Description:
+ *   Return the response at the head of the pending response list if it is
+ *   a part of a multipart message, of at most maxlen bytes.
+ *
+ * Returned Value:
+ *   The next response, or NULL if there is none or it is something else.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_RECV_MULTI
+FAR struct netlink_response_s *
+netlink_tryget_multi(FAR struct netlink_conn_s *conn, size_t maxlen)
+{
+  FAR struct netlink_response_s *resp;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+  resp = (FAR struct netlink_response_s *)sq_peek(&conn->resplist);
+  if (resp != NULL && (resp->msg.nlmsg_flags & NLM_F_MULTI) != 0 &&
+      resp->msg.nlmsg_len <= maxlen)
+    {
+      sq_remfirst(&conn->resplist);
+    }
+  else
+    {
+      resp = NULL;
+    }
+
+  net_unlock();
+  return resp;
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Generate the next batch of responses of the dump in progress, if all of
+ *   the previous ones have been received.  The dump function clears
+ *   conn->dump after adding the NLMSG_DONE terminator.
+ *
+ ****************************************************************************/
+
+void netlink_dump_continue(FAR struct netlink_conn_s *conn)
+{
+  netlink_dump_t dump;
+  int ret;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+  dump = sq_empty(&conn->resplist) ? conn->dump : NULL;
+  net_unlock();
+
+  if (dump != NULL)
+    {
+      ret = dump(conn);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to continue the dump: %d\n", ret);
+          conn->dump = NULL;
+        }
+    }
+}
+
 #endif /* CONFIG_NET_NETLINK */
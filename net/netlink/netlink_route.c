@@ -184,6 +184,8 @@ struct nlroute_info_s
 {
   NETLINK_HANDLE handle;
   FAR const struct nlroute_sendto_request_s *req;
+  unsigned int skip;                /* Entries dumped by previous batches */
+  unsigned int count;               /* Entries dumped by this batch */
 };
 
 /****************************************************************************
@@ -309,7 +311,7 @@ netlink_get_device(FAR struct net_driver_s *dev,
 
   resp->hdr.nlmsg_len    = sizeof(struct getlink_recvfrom_response_s);
   resp->hdr.nlmsg_type   = up ? RTM_NEWLINK : RTM_DELLINK;
-  resp->hdr.nlmsg_flags  = req ? req->hdr.nlmsg_flags : 0;
+  resp->hdr.nlmsg_flags  = req ? req->hdr.nlmsg_flags | NLM_F_MULTI : 0;
   resp->hdr.nlmsg_seq    = req ? req->hdr.nlmsg_seq : 0;
   resp->hdr.nlmsg_pid    = req ? req->hdr.nlmsg_pid : 0;
 
@@ -450,7 +452,7 @@ netlink_get_terminator(FAR const struct nlroute_sendto_request_s *req)
   hdr              = &resp->msg;
   hdr->nlmsg_len   = sizeof(struct nlmsghdr);
   hdr->nlmsg_type  = NLMSG_DONE;
-  hdr->nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
+  hdr->nlmsg_flags = req ? req->hdr.nlmsg_flags | NLM_F_MULTI : 0;
   hdr->nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
   hdr->nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
 
@@ -482,6 +484,96 @@ static int netlink_add_terminator(NETLINK_HANDLE handle,
   return OK;
 }
 
+/****************************************************************************
+ * Name: netlink_dump_start
+ *
+ * Description:
+ *   Start a dump answering req, replacing any dump in progress, and
+ *   generate its first batch of responses.  The next ones are generated by
+ *   netlink_dump_continue() as they are received.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NETLINK_DISABLE_GETLINK) || \
+    !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
+static int netlink_dump_start(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req,
+                              netlink_dump_t dump)
+{
+  FAR struct netlink_conn_s *conn = handle;
+
+  conn->dumphdr    = req->hdr;
+  conn->dumpfamily = req->gen.rtgen_family;
+  conn->dumpnext   = 0;
+  conn->dump       = dump;
+
+  return dump(conn);
+}
+
+/****************************************************************************
+ * Name: netlink_dump_init
+ *
+ * Description:
+ *   Prepare the next batch of the dump in progress.
+ *
+ ****************************************************************************/
+
+static void netlink_dump_init(FAR struct netlink_conn_s *conn,
+                              FAR struct nlroute_sendto_request_s *req,
+                              FAR struct nlroute_info_s *info)
+{
+  req->hdr              = conn->dumphdr;
+  req->gen.rtgen_family = conn->dumpfamily;
+
+  info->handle          = conn;
+  info->req             = req;
+  info->skip            = conn->dumpnext;
+  info->count           = 0;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_full
+ *
+ * Description:
+ *   Count one more entry dumped, and return non-zero to stop the walk of
+ *   the table when the batch is complete.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_full(FAR struct nlroute_info_s *info)
+{
+  return ++info->count < CONFIG_NETLINK_DUMP_BATCH ? 0 : 1;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_end
+ *
+ * Description:
+ *   Finish the batch generated by the walk of the table that returned ret,
+ *   and terminate the dump if the table had no more entries.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_end(FAR struct netlink_conn_s *conn,
+                            FAR struct nlroute_info_s *info, int ret)
+{
+  if (ret < 0)
+    {
+      conn->dump = NULL;
+      return ret;
+    }
+
+  conn->dumpnext += info->count;
+  if (info->count < CONFIG_NETLINK_DUMP_BATCH)
+    {
+      conn->dump = NULL;
+      return netlink_add_terminator(conn, info->req);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: netlink_get_devlist
  *
@@ -497,6 +589,14 @@ static int netlink_device_callback(FAR struct net_driver_s *dev,
   FAR struct nlroute_info_s *info = arg;
   FAR struct netlink_response_s * resp;
 
+  /* Skip the devices of the previous batches */
+
+  if (info->skip > 0)
+    {
+      info->skip--;
+      return 0;
+    }
+
   resp = netlink_get_device(dev, info->req);
   if (resp == NULL)
     {
@@ -504,29 +604,30 @@ static int netlink_device_callback(FAR struct net_driver_s *dev,
     }
 
   netlink_add_response(info->handle, resp);
-  return OK;
+  return netlink_dump_full(info);
 }
 
-static int netlink_get_devlist(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_dump_devlist(FAR struct netlink_conn_s *conn)
 {
+  struct nlroute_sendto_request_s req;
   struct nlroute_info_s info;
   int ret;
 
-  /* Visit each device */
+  /* Visit the devices not dumped yet */
 
-  info.handle = handle;
-  info.req    = req;
+  netlink_dump_init(conn, &req, &info);
 
   net_lock();
   ret = netdev_foreach(netlink_device_callback, &info);
   net_unlock();
-  if (ret < 0)
-    {
-      return ret;
-    }
 
-  return netlink_add_terminator(handle, req);
+  return netlink_dump_end(conn, &info, ret);
+}
+
+static int netlink_get_devlist(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req)
+{
+  return netlink_dump_start(handle, req, netlink_dump_devlist);
 }
 #endif
 
@@ -697,23 +798,20 @@ static int netlink_get_nbtable(NETLINK_HANDLE handle,
 #endif
 
 /****************************************************************************
- * Name: netlink_ipv4_route
+ * Name: netlink_get_ipv4_route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Generate one IPv4 route response.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_ipv4_route(FAR struct net_route_ipv4_s *route,
-                              FAR void *arg)
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_ROUTE)
+static FAR struct netlink_response_s *
+netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
+                       FAR const struct nlroute_sendto_request_s *req)
 {
   FAR struct getroute_recvfrom_ipv4resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv4response_s *resp;
-  FAR struct nlroute_info_s *info;
-
-  DEBUGASSERT(route != NULL && arg != NULL);
-  info = (FAR struct nlroute_info_s *)arg;
 
   /* Allocate the response */
 
@@ -721,19 +819,20 @@ static int netlink_ipv4_route(FAR struct net_route_ipv4_s *route,
     kmm_zalloc(sizeof(struct getroute_recvfrom_ipv4resplist_s));
   if (alloc == NULL)
     {
-      return -ENOMEM;
+      nerr("ERROR: Failed to allocate response buffer.\n");
+      return NULL;
     }
 
   /* Format the response */
 
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv4response_s);
-  resp->hdr.nlmsg_type  = RTM_NEWROUTE;
-  resp->hdr.nlmsg_flags = info->req->hdr.nlmsg_flags;
-  resp->hdr.nlmsg_seq   = info->req->hdr.nlmsg_seq;
-  resp->hdr.nlmsg_pid   = info->req->hdr.nlmsg_pid;
+  resp->hdr.nlmsg_type  = type;
+  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags | NLM_F_MULTI : 0;
+  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
 
-  resp->rte.rtm_family   = info->req->gen.rtgen_family;
+  resp->rte.rtm_family   = req ? req->gen.rtgen_family : AF_INET;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
   resp->rte.rtm_protocol = RTPROT_STATIC;
   resp->rte.rtm_scope    = RT_SCOPE_SITE;
@@ -750,63 +849,95 @@ static int netlink_ipv4_route(FAR struct net_route_ipv4_s *route,
   resp->gateway.attr.rta_type = RTA_GATEWAY;
   resp->gateway.addr          = route->router;
 
-  /* Finally, add the response to the list of pending responses */
+  /* Finally, return the response */
 
-  netlink_add_response(info->handle, (FAR struct netlink_response_s *)alloc);
-  return OK;
+  return (FAR struct netlink_response_s *)alloc;
 }
 #endif
 
 /****************************************************************************
- * Name: netlink_get_ipv4route
+ * Name: netlink_ipv4_route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Add the response of one routing table entry to the dump.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_get_ipv4route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_ipv4_route(FAR struct net_route_ipv4_s *route,
+                              FAR void *arg)
 {
-  struct nlroute_info_s info;
-  int ret;
+  FAR struct netlink_response_s *resp;
+  FAR struct nlroute_info_s *info;
 
-  /* Visit each routing table entry */
+  DEBUGASSERT(route != NULL && arg != NULL);
+  info = (FAR struct nlroute_info_s *)arg;
 
-  info.handle = handle;
-  info.req    = req;
+  /* Skip the entries of the previous batches */
 
-  ret = net_foreachroute_ipv4(netlink_ipv4_route, &info);
-  if (ret < 0)
+  if (info->skip > 0)
     {
-      return ret;
+      info->skip--;
+      return 0;
     }
 
-  /* Terminate the routing table */
+  resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, info->req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
+    }
 
-  return netlink_add_terminator(handle, req);
+  /* Add the response to the list of pending responses */
+
+  netlink_add_response(info->handle, resp);
+  return netlink_dump_full(info);
 }
 #endif
 
 /****************************************************************************
- * Name: netlink_ipv6_route
+ * Name: netlink_get_ipv4route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Dump the IPv4 routing table.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_ipv6_route(FAR struct net_route_ipv6_s *route,
-                              FAR void *arg)
+#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
+static int netlink_dump_ipv4route(FAR struct netlink_conn_s *conn)
+{
+  struct nlroute_sendto_request_s req;
+  struct nlroute_info_s info;
+  int ret;
+
+  /* Visit the routing table entries not dumped yet */
+
+  netlink_dump_init(conn, &req, &info);
+  ret = net_foreachroute_ipv4(netlink_ipv4_route, &info);
+  return netlink_dump_end(conn, &info, ret);
+}
+
+static int netlink_get_ipv4route(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req)
+{
+  return netlink_dump_start(handle, req, netlink_dump_ipv4route);
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_get_ipv6_route
+ *
+ * Description:
+ *   Generate one IPv6 route response.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv6) && defined(CONFIG_NET_ROUTE)
+static FAR struct netlink_response_s *
+netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
+                       FAR const struct nlroute_sendto_request_s *req)
 {
   FAR struct getroute_recvfrom_ipv6resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv6response_s *resp;
-  FAR struct nlroute_info_s *info;
-
-  DEBUGASSERT(route != NULL && arg != NULL);
-  info = (FAR struct nlroute_info_s *)arg;
 
   /* Allocate the response */
 
@@ -814,19 +945,20 @@ static int netlink_ipv6_route(FAR struct net_route_ipv6_s *route,
     kmm_zalloc(sizeof(struct getroute_recvfrom_ipv6resplist_s));
   if (alloc == NULL)
     {
-      return -ENOMEM;
+      nerr("ERROR: Failed to allocate response buffer.\n");
+      return NULL;
     }
 
   /* Format the response */
 
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv6response_s);
-  resp->hdr.nlmsg_type  = RTM_NEWROUTE;
-  resp->hdr.nlmsg_flags = info->req->hdr.nlmsg_flags;
-  resp->hdr.nlmsg_seq   = info->req->hdr.nlmsg_seq;
-  resp->hdr.nlmsg_pid   = info->req->hdr.nlmsg_pid;
+  resp->hdr.nlmsg_type  = type;
+  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags | NLM_F_MULTI : 0;
+  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
 
-  resp->rte.rtm_family   = info->req->gen.rtgen_family;
+  resp->rte.rtm_family   = req ? req->gen.rtgen_family : AF_INET6;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
   resp->rte.rtm_protocol = RTPROT_STATIC;
   resp->rte.rtm_scope    = RT_SCOPE_SITE;
@@ -843,42 +975,77 @@ static int netlink_ipv6_route(FAR struct net_route_ipv6_s *route,
   resp->gateway.attr.rta_type = RTA_GATEWAY;
   net_ipv6addr_copy(resp->gateway.addr, route->router);
 
-  /* Finally, add the response to the list of pending responses */
+  /* Finally, return the response */
 
-  netlink_add_response(info->handle, (FAR struct netlink_response_s *)alloc);
-  return OK;
+  return (FAR struct netlink_response_s *)alloc;
 }
 #endif
 
 /****************************************************************************
- * Name: netlink_get_ip6vroute
+ * Name: netlink_ipv6_route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Add the response of one routing table entry to the dump.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_get_ip6vroute(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_ipv6_route(FAR struct net_route_ipv6_s *route,
+                              FAR void *arg)
 {
-  struct nlroute_info_s info;
-  int ret;
+  FAR struct netlink_response_s *resp;
+  FAR struct nlroute_info_s *info;
 
-  /* Visit each routing table entry */
+  DEBUGASSERT(route != NULL && arg != NULL);
+  info = (FAR struct nlroute_info_s *)arg;
 
-  info.handle = handle;
-  info.req    = req;
+  /* Skip the entries of the previous batches */
 
-  ret = net_foreachroute_ipv6(netlink_ipv6_route, &info);
-  if (ret < 0)
+  if (info->skip > 0)
     {
-      return ret;
+      info->skip--;
+      return 0;
+    }
+
+  resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, info->req);
+  if (resp == NULL)
+    {
+      return -ENOMEM;
     }
 
-  /* Terminate the routing table */
+  /* Add the response to the list of pending responses */
 
-  return netlink_add_terminator(handle, req);
+  netlink_add_response(info->handle, resp);
+  return netlink_dump_full(info);
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_get_ip6vroute
+ *
+ * Description:
+ *   Dump the IPv6 routing table.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
+static int netlink_dump_ipv6route(FAR struct netlink_conn_s *conn)
+{
+  struct nlroute_sendto_request_s req;
+  struct nlroute_info_s info;
+  int ret;
+
+  /* Visit the routing table entries not dumped yet */
+
+  netlink_dump_init(conn, &req, &info);
+  ret = net_foreachroute_ipv6(netlink_ipv6_route, &info);
+  return netlink_dump_end(conn, &info, ret);
+}
+
+static int netlink_get_ip6vroute(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req)
+{
+  return netlink_dump_start(handle, req, netlink_dump_ipv6route);
 }
 #endif
 
@@ -1392,4 +1559,120 @@ void netlink_device_notify_ipaddr(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: netlink_ipv4route_notify() and netlink_ipv6route_notify()
+ *
+ * Description:
+ *   Perform the route broadcast for the NETLINK_ROUTE protocol.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_ROUTE)
+void netlink_ipv4route_notify(FAR const struct net_route_ipv4_s *route,
+                              int type)
+{
+  FAR struct netlink_response_s *resp;
+
+  DEBUGASSERT(route != NULL);
+
+  resp = netlink_get_ipv4_route(route, type, NULL);
+  if (resp != NULL)
+    {
+      netlink_add_broadcast(RTNLGRP_IPV4_ROUTE, resp);
+
+      resp = netlink_get_terminator(NULL);
+      if (resp != NULL)
+        {
+          netlink_add_broadcast(RTNLGRP_IPV4_ROUTE, resp);
+        }
+    }
+}
+#endif
+
+#if defined(CONFIG_NET_IPv6) && defined(CONFIG_NET_ROUTE)
+void netlink_ipv6route_notify(FAR const struct net_route_ipv6_s *route,
+                              int type)
+{
+  FAR struct netlink_response_s *resp;
+
+  DEBUGASSERT(route != NULL);
+
+  resp = netlink_get_ipv6_route(route, type, NULL);
+  if (resp != NULL)
+    {
+      netlink_add_broadcast(RTNLGRP_IPV6_ROUTE, resp);
+
+      resp = netlink_get_terminator(NULL);
+      if (resp != NULL)
+        {
+          netlink_add_broadcast(RTNLGRP_IPV6_ROUTE, resp);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_neigh_notify()
+ *
+ * Description:
+ *   Perform the neighbor broadcast for the NETLINK_ROUTE protocol.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ARP) || defined(CONFIG_NET_IPv6)
+void netlink_neigh_notify(FAR const void *neigh, int type, int domain)
+{
+  FAR struct getneigh_recvfrom_rsplist_s *alloc;
+  FAR struct netlink_response_s *resp;
+  size_t size;
+
+  DEBUGASSERT(neigh != NULL);
+
+#ifdef CONFIG_NET_ARP
+  if (domain == AF_INET)
+    {
+      size = sizeof(struct arpreq);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (domain == AF_INET6)
+    {
+      size = sizeof(struct neighbor_entry_s);
+    }
+  else
+#endif
+    {
+      nwarn("netlink_neigh_notify unknown type %d domain %d\n",
+            type, domain);
+      return;
+    }
+
+  alloc = (FAR struct getneigh_recvfrom_rsplist_s *)
+    kmm_zalloc(SIZEOF_NLROUTE_RECVFROM_RSPLIST_S(size));
+  if (alloc == NULL)
+    {
+      nerr("ERROR: Failed to allocate response buffer.\n");
+      return;
+    }
+
+  /* One entry, as the RTM_GETNEIGH dump returns them */
+
+  alloc->payload.hdr.nlmsg_len  = SIZEOF_NLROUTE_RECVFROM_RESPONSE_S(size);
+  alloc->payload.hdr.nlmsg_type = type;
+  alloc->payload.msg.ndm_family = domain;
+  alloc->payload.attr.rta_len   = RTA_LENGTH(size);
+  memcpy(alloc->payload.data, neigh, size);
+
+  resp = (FAR struct netlink_response_s *)alloc;
+  netlink_add_broadcast(RTNLGRP_NEIGH, resp);
+
+  resp = netlink_get_terminator(NULL);
+  if (resp != NULL)
+    {
+      netlink_add_broadcast(RTNLGRP_NEIGH, resp);
+    }
+}
+#endif
+
 #endif /* CONFIG_NETLINK_ROUTE */
@@ -697,6 +697,10 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
         }
     }
 
+  /* Generate the next part of a dump once all of it is taken */
+
+  netlink_dump_continue(psock->s_conn);
+
   if (len > entry->msg.nlmsg_len)
     {
       len = entry->msg.nlmsg_len;
@@ -705,6 +709,37 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   /* Copy the payload to the user buffer */
 
   memcpy(buf, &entry->msg, len);
+
+#ifdef CONFIG_NETLINK_RECV_MULTI
+  /* Follow it with the next parts of the same multipart message, up to
+   * its NLMSG_DONE, as long as they fit.
+   */
+
+  if (len == entry->msg.nlmsg_len &&
+      (entry->msg.nlmsg_flags & NLM_F_MULTI) != 0)
+    {
+      size_t buflen = msg->msg_iov->iov_len;
+
+      while (entry->msg.nlmsg_type != NLMSG_DONE &&
+             NLMSG_ALIGN(len) < buflen)
+        {
+          kmm_free(entry);
+          entry = netlink_tryget_multi(psock->s_conn,
+                                       buflen - NLMSG_ALIGN(len));
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          netlink_dump_continue(psock->s_conn);
+
+          len = NLMSG_ALIGN(len);
+          memcpy((FAR char *)buf + len, &entry->msg, entry->msg.nlmsg_len);
+          len += entry->msg.nlmsg_len;
+        }
+    }
+#endif
+
   kmm_free(entry);
 
   if (from != NULL)
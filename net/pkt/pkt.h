@@ -31,6 +31,8 @@
 
 #include <nuttx/net/net.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_NET_PKT
 
 /****************************************************************************
@@ -69,11 +71,21 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+#ifdef CONFIG_NET_PKT_RXRING
+  /* The receive ring replaces the read-ahead buffering once it is set up */
+
+  struct net_rxring_s rxring;
+#endif
+
+  /* The following is a list of poll structures of threads waiting for
+   * socket events.
+   */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
 };
 
 /****************************************************************************
@@ -26,8 +26,12 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
+
+#include <netpacket/packet.h>
 
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -100,6 +104,42 @@ errout:
   return 0;
 }
 
+/****************************************************************************
+ * Name: pkt_rxring
+ *
+ * Description:
+ *   Write the packet into the receive ring of the connection and wake up
+ *   the application if the ring was empty.  A packet that does not fit
+ *   into the ring is dropped and reported with the next packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+static void pkt_rxring(FAR struct net_driver_s *dev,
+                       FAR struct pkt_conn_s *conn)
+{
+  struct sockaddr_ll addr;
+  int ret;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family   = AF_PACKET;
+  addr.sll_protocol = conn->proto;
+  addr.sll_ifindex  = dev->d_ifindex;
+  addr.sll_halen    = ETHER_ADDR_LEN;
+  memcpy(addr.sll_addr, ETHBUF->src, ETHER_ADDR_LEN);
+
+  ret = net_rxring_input(&conn->rxring, dev, &addr, NET_LL_HDRLEN(dev));
+  if (ret > 0)
+    {
+      poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, POLLIN);
+    }
+  else if (ret < 0)
+    {
+      nwarn("WARNING: Receive ring full, packet dropped\n");
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pkt_in
  *
@@ -139,6 +179,14 @@ static int pkt_in(FAR struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_RXRING
+      if (conn->rxring.base != NULL)
+        {
+          pkt_rxring(dev, conn);
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -165,6 +213,10 @@ static int pkt_in(FAR struct net_driver_s *dev)
               nwarn("WARNING: Packet not processed\n");
               ret = -EAGAIN;
             }
+          else
+            {
+              poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, POLLIN);
+            }
         }
     }
   else
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
 
 #include <netpacket/packet.h>
 
@@ -52,7 +53,15 @@ static sockcaps_t pkt_sockcaps(FAR struct socket *psock);
 static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        pkt_poll_local(FAR struct socket *psock,
+                    FAR struct pollfd *fds, bool setup);
 static int        pkt_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_PKT_RXRING
+static int        pkt_setsockopt(FAR struct socket *psock, int level,
+                    int option, FAR const void *value, socklen_t value_len);
+static int        pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -69,10 +78,21 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_poll_local,  /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
   pkt_close        /* si_close */
+#ifdef CONFIG_NET_PKT_RXRING
+  , NULL,          /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL,            /* si_shutdown */
+  NULL,            /* si_getsockopt */
+  pkt_setsockopt,  /* si_setsockopt */
+#ifdef CONFIG_NET_SENDFILE
+  NULL,            /* si_sendfile */
+#endif
+  pkt_mmap         /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -272,6 +292,143 @@ static int pkt_bind(FAR struct socket *psock,
     }
 }
 
+/****************************************************************************
+ * Name: pkt_poll_local
+ *
+ * Description:
+ *   Set up or tear down a poll on a packet socket.  A packet socket is
+ *   always writable, and readable when packets are buffered or the receive
+ *   ring holds packets.
+ *
+ * Input Parameters:
+ *   psock - An instance of the packet socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *   0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  pollevent_t eventset = POLLOUT;
+  int ret = OK;
+  int i;
+
+  net_lock();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+        {
+          /* Find an available slot */
+
+          if (conn->fds[i] == NULL)
+            {
+              /* Bind the poll structure and this slot */
+
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NET_PKT_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Immediately notify on any of the requested events */
+
+      if (!IOB_QEMPTY(&conn->readahead))
+        {
+          eventset |= POLLIN;
+        }
+
+#ifdef CONFIG_NET_PKT_RXRING
+      if (net_rxring_ready(&conn->rxring))
+        {
+          eventset |= POLLIN;
+        }
+#endif
+
+      poll_notify(&fds, 1, eventset);
+    }
+  else if (fds->priv != NULL)
+    {
+      for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+        {
+          if (fds == conn->fds[i])
+            {
+              conn->fds[i] = NULL;
+              fds->priv    = NULL;
+              break;
+            }
+        }
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set up or release the receive ring with the SOL_PACKET PACKET_RX_RING
+ *   option.  The value is a struct tpacket_req.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+static int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret;
+
+  if (level != SOL_PACKET || option != PACKET_RX_RING)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+  ret = net_rxring_setup(&conn->rxring, value, value_len);
+  net_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the receive ring of the socket.
+ *
+ ****************************************************************************/
+
+static int pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret;
+
+  net_lock();
+  ret = net_rxring_mmap(&conn->rxring, map);
+  net_unlock();
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pkt_close
  *
@@ -308,6 +465,9 @@ static int pkt_close(FAR struct socket *psock)
               /* Yes... free any read-ahead data */
 
               iob_free_queue(&conn->readahead);
+#ifdef CONFIG_NET_PKT_RXRING
+              net_rxring_free(&conn->rxring);
+#endif
 
               /* Then free the connection structure */
 
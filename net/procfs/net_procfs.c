@@ -112,6 +112,12 @@ static const struct netprocfs_entry_s g_net_entries[] =
       netprocfs_read_netstats
     }
   },
+  {
+    DTYPE_FILE, "lock",
+    {
+      netprocfs_read_lockstats
+    }
+  },
 #  ifdef CONFIG_NET_MLD
   {
     DTYPE_FILE, "mld",
@@ -121,6 +127,16 @@ static const struct netprocfs_entry_s g_net_entries[] =
   },
 #  endif
 #  if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
+#    ifdef CONFIG_NET_TCP_CONN_HASH
+  /* Entries are matched by prefix, so "tcphash" must precede "tcp" */
+
+  {
+    DTYPE_FILE, "tcphash",
+    {
+      netprocfs_read_tcphash
+    }
+  },
+#    endif
   {
     DTYPE_FILE, "tcp",
     {
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <debug.h>
@@ -460,5 +461,43 @@ ssize_t netprocfs_read_netstats(FAR struct netprocfs_file_s *priv,
 
 #endif /* CONFIG_NET_IPv4 || CONFIG_NET_IPv6 || CONFIG_NET_TCP || \
         * CONFIG_NET_UDP  || CONFIG_NET_ICMP || CONFIG_NET_ICMPv6 */
+
+/****************************************************************************
+ * Name: netprocfs_read_lockstats
+ *
+ * Description:
+ *   Read and format the contention statistics of the network lock.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_lockstats(FAR struct netprocfs_file_s *priv,
+                                 FAR char *buffer, size_t buflen)
+{
+  int len;
+
+  if (priv->offset != 0)
+    {
+      return 0;
+    }
+
+  len = snprintf(buffer, buflen,
+                 "Net lock   acquired  contended  waitticks\n"
+                 "         %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+                 g_netstats.lock.acquired, g_netstats.lock.contended,
+                 g_netstats.lock.waitticks);
+  priv->offset = 1;
+
+  return len;
+}
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
         * !CONFIG_FS_PROCFS_EXCLUDE_NET */
@@ -44,11 +44,13 @@
 #ifdef NET_TCP_HAVE_STACK
 
 #ifdef CONFIG_NET_IPv6
-#  define TCP_LINELEN 180
+#  define TCP_LINELEN 200
 #else
-#  define TCP_LINELEN 120
+#  define TCP_LINELEN 140
 #endif
 
+#define TCPHASH_LINELEN 24
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -120,7 +122,11 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       " %6" PRIu32
 #endif
-                      " %6u",
+                      " %6u"
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+                      " %8" PRIu32 " %8" PRIu32
+#endif
+                      ,
                       priv->offset++,
                       conn->tcpstateflags,
                       conn->sconn.s_flags,
@@ -131,7 +137,11 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       tcp_wrbuffer_inqueue_size(conn),
 #endif
-                      (conn->readahead) ? conn->readahead->io_pktlen : 0);
+                      (conn->readahead) ? conn->readahead->io_pktlen : 0
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+                      , conn->cwnd, conn->ssthresh
+#endif
+                      );
 
       len += snprintf(buffer + len, buflen - len,
                       " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
@@ -188,6 +198,9 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
                                           "txsz   "
 #endif
                                           "rxsz "
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+                                          "    cwnd ssthresh "
+#endif
                                           "%-*s "
                                           "%-*s\n"
                                           ,
@@ -215,4 +228,70 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
   return len;
 }
 
+/****************************************************************************
+ * Name: netprocfs_read_tcphash
+ *
+ * Description:
+ *   Read and format the occupancy of the TCP demultiplexing hash tables.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+ssize_t netprocfs_read_tcphash(FAR struct netprocfs_file_s *priv,
+                               FAR char *buffer, size_t buflen)
+{
+  int nlines = CONFIG_NET_TCP_CONN_HASHSIZE +
+               CONFIG_NET_TCP_LISTEN_HASHSIZE;
+  int len = 0;
+  int line;
+
+  net_lock();
+
+  if (priv->offset == 0)
+    {
+      len = snprintf(buffer, buflen, "TCP hash  bkt  len\n");
+      priv->offset = 1;
+    }
+
+  for (line = priv->offset - 1; line < nlines; line++)
+    {
+      if (buflen - len < TCPHASH_LINELEN)
+        {
+          break;
+        }
+
+      if (line < CONFIG_NET_TCP_CONN_HASHSIZE)
+        {
+          len += snprintf(buffer + len, buflen - len,
+                          "    conn   %3d %4u\n",
+                          line, tcp_conn_hashlen(line));
+        }
+      else
+        {
+          len += snprintf(buffer + len, buflen - len,
+                          "    listen %3d %4u\n",
+                          line - CONFIG_NET_TCP_CONN_HASHSIZE,
+                          tcp_listen_hashlen(line -
+                                             CONFIG_NET_TCP_CONN_HASHSIZE));
+        }
+
+      priv->offset++;
+    }
+
+  net_unlock();
+
+  return len;
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
 #endif /* NET_TCP_HAVE_STACK */
@@ -112,6 +112,7 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
+      net_rebuildtrie_ipv4();
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -168,6 +169,7 @@ static int net_match_ipv6(
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
+      net_rebuildtrie_ipv6();
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -34,6 +34,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/ramroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -224,7 +225,13 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#if defined(CONFIG_ROUTE_RAMROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+      ret = net_lpmroute_ipv4(target, net_ipv4_match, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+        }
     }
 
   /* Did we find a route? */
@@ -299,7 +306,13 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#if defined(CONFIG_ROUTE_RAMROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+      ret = net_lpmroute_ipv6(target, net_ipv6_match, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+        }
     }
 
   /* Did we find a route? */
@@ -0,0 +1,444 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_RAMROUTE_TRIE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path compressed binary trie.  A node covers the first
+ * 'plen' bits of 'key', which points to the address of any route below it.
+ * Nodes without a route only branch.  A trie of n routes has at most n - 1
+ * branch nodes.
+ */
+
+struct route_trie_s
+{
+  FAR struct route_trie_s *child[2]; /* Next bit clear / set */
+  FAR const uint8_t *key;            /* Address bytes, network order */
+  FAR void *route;                   /* The route of this prefix or NULL */
+  uint8_t plen;                      /* Prefix length in bits */
+};
+
+/* A trie and the pool of its nodes */
+
+struct route_trie_root_s
+{
+  FAR struct route_trie_s *root;
+  FAR struct route_trie_s *pool;
+  unsigned int nnodes;               /* Size of the pool */
+  unsigned int nused;                /* Nodes used from the pool */
+  bool invalid;                      /* A netmask is not a prefix */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static struct route_trie_s g_ipv4_trienodes[2 *
+                                           CONFIG_ROUTE_MAX_IPv4_RAMROUTES];
+static struct route_trie_root_s g_ipv4_trie =
+{
+  NULL, g_ipv4_trienodes, 2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES, 0, false
+};
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static struct route_trie_s g_ipv6_trienodes[2 *
+                                           CONFIG_ROUTE_MAX_IPv6_RAMROUTES];
+static struct route_trie_root_s g_ipv6_trie =
+{
+  NULL, g_ipv6_trienodes, 2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES, 0, false
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: route_trie_bit
+ *
+ * Description:
+ *   Return bit 'i' of the address 'key', counted from the most significant
+ *   bit of the first byte.
+ *
+ ****************************************************************************/
+
+static inline int route_trie_bit(FAR const uint8_t *key, unsigned int i)
+{
+  return (key[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: route_trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'nbits', that the addresses
+ *   'a' and 'b' have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int route_trie_common(FAR const uint8_t *a,
+                                      FAR const uint8_t *b,
+                                      unsigned int nbits)
+{
+  unsigned int i = 0;
+  uint8_t diff;
+
+  while (i < nbits)
+    {
+      diff = a[i >> 3] ^ b[i >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              i++;
+            }
+
+          return MIN(i, nbits);
+        }
+
+      i += 8;
+    }
+
+  return nbits;
+}
+
+/****************************************************************************
+ * Name: route_trie_prefixlen
+ *
+ * Description:
+ *   Return the length of the prefix selected by 'mask', or -EINVAL if the
+ *   mask is not contiguous.
+ *
+ ****************************************************************************/
+
+static int route_trie_prefixlen(FAR const uint8_t *mask,
+                                unsigned int nbytes)
+{
+  unsigned int plen = 0;
+  unsigned int i;
+
+  for (i = 0; i < nbytes && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < nbytes)
+    {
+      uint8_t byte = mask[i++];
+
+      while ((byte & 0x80) != 0)
+        {
+          byte <<= 1;
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < nbytes; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: route_trie_alloc
+ ****************************************************************************/
+
+static FAR struct route_trie_s *
+route_trie_alloc(FAR struct route_trie_root_s *trie, FAR const uint8_t *key,
+                 unsigned int plen, FAR void *route)
+{
+  FAR struct route_trie_s *node;
+
+  DEBUGASSERT(trie->nused < trie->nnodes);
+
+  node           = &trie->pool[trie->nused++];
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->key      = key;
+  node->route    = route;
+  node->plen     = plen;
+  return node;
+}
+
+/****************************************************************************
+ * Name: route_trie_insert
+ *
+ * Description:
+ *   Insert the route of the prefix 'key'/'plen'.  Of several routes with
+ *   the same prefix, the first one inserted is kept.
+ *
+ ****************************************************************************/
+
+static void route_trie_insert(FAR struct route_trie_root_s *trie,
+                              FAR const uint8_t *key, unsigned int plen,
+                              FAR void *route)
+{
+  FAR struct route_trie_s **link = &trie->root;
+  FAR struct route_trie_s *node;
+  FAR struct route_trie_s *leaf;
+  FAR struct route_trie_s *branch;
+  unsigned int common;
+
+  while ((node = *link) != NULL)
+    {
+      common = route_trie_common(key, node->key, MIN(plen, node->plen));
+      if (common < node->plen)
+        {
+          /* The new prefix leaves the path of this node */
+
+          leaf = route_trie_alloc(trie, key, plen, route);
+          if (common == plen)
+            {
+              /* The new prefix is a prefix of the node: insert above */
+
+              leaf->child[route_trie_bit(node->key, plen)] = node;
+              *link = leaf;
+            }
+          else
+            {
+              /* Branch where the two prefixes differ */
+
+              branch = route_trie_alloc(trie, key, common, NULL);
+              branch->child[route_trie_bit(key, common)]       = leaf;
+              branch->child[route_trie_bit(node->key, common)] = node;
+              *link = branch;
+            }
+
+          return;
+        }
+
+      if (plen == node->plen)
+        {
+          /* Same prefix.  This may be a branch node that gets a route. */
+
+          if (node->route == NULL)
+            {
+              node->route = route;
+              node->key   = key;
+            }
+
+          return;
+        }
+
+      link = &node->child[route_trie_bit(key, node->plen)];
+    }
+
+  *link = route_trie_alloc(trie, key, plen, route);
+}
+
+/****************************************************************************
+ * Name: route_trie_match
+ *
+ * Description:
+ *   Return the route of the longest prefix matching the address 'addr'.
+ *
+ ****************************************************************************/
+
+static FAR void *route_trie_match(FAR struct route_trie_root_s *trie,
+                                  FAR const uint8_t *addr,
+                                  unsigned int nbits)
+{
+  FAR struct route_trie_s *node = trie->root;
+  FAR void *route = NULL;
+
+  while (node != NULL &&
+         route_trie_common(addr, node->key, node->plen) == node->plen)
+    {
+      if (node->route != NULL)
+        {
+          route = node->route;
+        }
+
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->child[route_trie_bit(addr, node->plen)];
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rebuildtrie_ipv4 and net_rebuildtrie_ipv6
+ *
+ * Description:
+ *   Rebuild the longest prefix match trie from the in-memory routing table
+ *   after the table has been changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_rebuildtrie_ipv4(void)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  int plen;
+
+  g_ipv4_trie.root    = NULL;
+  g_ipv4_trie.nused   = 0;
+  g_ipv4_trie.invalid = false;
+
+  for (entry = g_ipv4_routes.head; entry != NULL; entry = entry->flink)
+    {
+      plen = route_trie_prefixlen((FAR const uint8_t *)&entry->entry.netmask,
+                                  sizeof(in_addr_t));
+      if (plen < 0)
+        {
+          nwarn("WARNING: Netmask is not a prefix, trie disabled\n");
+          g_ipv4_trie.invalid = true;
+          return;
+        }
+
+      route_trie_insert(&g_ipv4_trie,
+                        (FAR const uint8_t *)&entry->entry.target, plen,
+                        &entry->entry);
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_rebuildtrie_ipv6(void)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  int plen;
+
+  g_ipv6_trie.root    = NULL;
+  g_ipv6_trie.nused   = 0;
+  g_ipv6_trie.invalid = false;
+
+  for (entry = g_ipv6_routes.head; entry != NULL; entry = entry->flink)
+    {
+      plen = route_trie_prefixlen((FAR const uint8_t *)entry->entry.netmask,
+                                  sizeof(net_ipv6addr_t));
+      if (plen < 0)
+        {
+          nwarn("WARNING: Netmask is not a prefix, trie disabled\n");
+          g_ipv6_trie.invalid = true;
+          return;
+        }
+
+      route_trie_insert(&g_ipv6_trie,
+                        (FAR const uint8_t *)entry->entry.target, plen,
+                        &entry->entry);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the route of the longest prefix matching 'target' in the trie of
+ *   the in-memory routing table and pass it to 'handler'.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - The function to call with the route found
+ *   arg     - An arbitrary argument passed to 'handler'
+ *
+ * Returned Value:
+ *   The value returned by 'handler', zero if there is no route for
+ *   'target', or -ENOSYS if the trie cannot be used because a netmask of
+ *   the routing table does not describe a prefix.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg)
+{
+  FAR struct net_route_ipv4_s *route;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (!g_ipv4_trie.invalid)
+    {
+      route = route_trie_match(&g_ipv4_trie, (FAR const uint8_t *)&target,
+                               8 * sizeof(in_addr_t));
+      ret   = route != NULL ? handler(route, arg) : 0;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpmroute_ipv6(const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_s *route;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (!g_ipv6_trie.invalid)
+    {
+      route = route_trie_match(&g_ipv6_trie, (FAR const uint8_t *)target,
+                               8 * sizeof(net_ipv6addr_t));
+      ret   = route != NULL ? handler(route, arg) : 0;
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_RAMROUTE_TRIE */
@@ -216,5 +216,67 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_rebuildtrie_ipv4 and net_rebuildtrie_ipv6
+ *
+ * Description:
+ *   Rebuild the longest prefix match trie from the in-memory routing table
+ *   after the table has been changed.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_RAMROUTE_TRIE
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_rebuildtrie_ipv4(void);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_rebuildtrie_ipv6(void);
+#endif
+#else
+#  define net_rebuildtrie_ipv4()
+#  define net_rebuildtrie_ipv6()
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the route of the longest prefix matching 'target' in the trie of
+ *   the in-memory routing table and pass it to 'handler'.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - The function to call with the route found
+ *   arg     - An arbitrary argument passed to 'handler'
+ *
+ * Returned Value:
+ *   The value returned by 'handler', zero if there is no route for
+ *   'target', or -ENOSYS if the trie cannot be used because a netmask of
+ *   the routing table does not describe a prefix.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_RAMROUTE_TRIE
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpmroute_ipv6(const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg);
+#endif
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
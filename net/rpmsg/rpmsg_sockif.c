@@ -76,6 +76,15 @@ begin_packed_struct struct rpmsg_socket_data_s
   char                           data[0];
 } end_packed_struct;
 
+/* A received rpmsg buffer held until its data has been read */
+
+struct rpmsg_socket_hold_s
+{
+  FAR void                       *rxbuf;
+  FAR const uint8_t              *data;
+  uint32_t                       len;
+};
+
 struct rpmsg_socket_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -101,6 +110,14 @@ struct rpmsg_socket_conn_s
   uint32_t                       recvlen;
   FAR struct circbuf_s           recvbuf;
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+  /* The data of the held buffers precedes the data in recvbuf */
+
+  struct rpmsg_socket_hold_s     held[CONFIG_NET_RPMSG_RXHOLD];
+  uint8_t                        heldhead;
+  uint8_t                        heldcount;
+#endif
+
   FAR struct rpmsg_socket_conn_s *next;
 
   /* server listen-scoket listening: backlog > 0;
@@ -239,6 +256,104 @@ static void rpmsg_socket_free(FAR struct rpmsg_socket_conn_s *conn)
   kmm_free(conn);
 }
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+static bool rpmsg_socket_hold(FAR struct rpmsg_socket_conn_s *conn,
+                              FAR void *rxbuf, FAR const uint8_t *data,
+                              uint32_t len)
+{
+  FAR struct rpmsg_socket_hold_s *hold;
+
+  /* Keep the order of the data: nothing is held behind recvbuf */
+
+  if (conn->heldcount >= CONFIG_NET_RPMSG_RXHOLD ||
+      !circbuf_is_empty(&conn->recvbuf))
+    {
+      return false;
+    }
+
+  hold = &conn->held[(conn->heldhead + conn->heldcount) %
+                     CONFIG_NET_RPMSG_RXHOLD];
+  hold->rxbuf = rxbuf;
+  hold->data  = data;
+  hold->len   = len;
+  conn->heldcount++;
+
+  rpmsg_hold_rx_buffer(&conn->ept, rxbuf);
+  return true;
+}
+
+static ssize_t rpmsg_socket_read_held(FAR struct rpmsg_socket_conn_s *conn,
+                                      FAR void *buf, size_t len,
+                                      bool stream)
+{
+  FAR struct rpmsg_socket_hold_s *hold;
+  ssize_t ret = 0;
+
+  while (conn->heldcount > 0 && (size_t)ret < len)
+    {
+      hold = &conn->held[conn->heldhead];
+      if (stream)
+        {
+          uint32_t chunk = MIN(len - ret, hold->len);
+
+          memcpy((FAR uint8_t *)buf + ret, hold->data, chunk);
+          hold->data    += chunk;
+          hold->len     -= chunk;
+          conn->recvpos += chunk;
+          ret           += chunk;
+        }
+      else
+        {
+          /* One datagram per buffer, the rest of it is discarded */
+
+          ret = MIN(len, hold->len);
+          memcpy(buf, hold->data, ret);
+          conn->recvpos += hold->len + sizeof(uint32_t);
+          hold->len      = 0;
+        }
+
+      if (hold->len == 0)
+        {
+          rpmsg_release_rx_buffer(&conn->ept, hold->rxbuf);
+          conn->heldhead = (conn->heldhead + 1) % CONFIG_NET_RPMSG_RXHOLD;
+          conn->heldcount--;
+        }
+
+      if (!stream)
+        {
+          break;
+        }
+    }
+
+  return ret;
+}
+
+static uint32_t rpmsg_socket_held_len(FAR struct rpmsg_socket_conn_s *conn)
+{
+  uint32_t len = 0;
+  int i;
+
+  for (i = 0; i < conn->heldcount; i++)
+    {
+      len += conn->held[(conn->heldhead + i) %
+                        CONFIG_NET_RPMSG_RXHOLD].len;
+    }
+
+  return len;
+}
+
+static void rpmsg_socket_release_held(FAR struct rpmsg_socket_conn_s *conn)
+{
+  while (conn->heldcount > 0)
+    {
+      rpmsg_release_rx_buffer(&conn->ept,
+                              conn->held[conn->heldhead].rxbuf);
+      conn->heldhead = (conn->heldhead + 1) % CONFIG_NET_RPMSG_RXHOLD;
+      conn->heldcount--;
+    }
+}
+#endif
+
 static int rpmsg_socket_wakeup(FAR struct rpmsg_socket_conn_s *conn)
 {
   struct rpmsg_socket_data_s msg;
@@ -297,6 +412,9 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
     {
       FAR struct rpmsg_socket_data_s *msg = data;
       FAR uint8_t *buf = (FAR uint8_t *)msg->data;
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+      bool stream;
+#endif
 
       nxmutex_lock(&conn->sendlock);
 
@@ -315,6 +433,9 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
           len -= sizeof(*msg);
 
           DEBUGASSERT(len == msg->len || len == msg->len + sizeof(uint32_t));
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+          stream = len == msg->len;
+#endif
 
           nxmutex_lock(&conn->recvlock);
 
@@ -349,6 +470,22 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
             {
               ssize_t written;
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+              /* Hold the rpmsg buffer so that recv() copies the data only
+               * once.  A datagram is held without its length.
+               */
+
+              if (stream ?
+                  rpmsg_socket_hold(conn, data, buf, len) :
+                  rpmsg_socket_hold(conn, data, buf + sizeof(uint32_t),
+                                    msg->len))
+                {
+                  rpmsg_socket_poll_notify(conn, POLLIN);
+                  nxmutex_unlock(&conn->recvlock);
+                  return 0;
+                }
+#endif
+
               written = circbuf_write(&conn->recvbuf, buf, len);
               if (written != len)
                 {
@@ -385,6 +522,9 @@ static inline void rpmsg_socket_destroy_ept(
           conn->backlog = -1;
         }
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+      rpmsg_socket_release_held(conn);
+#endif
       rpmsg_destroy_ept(&conn->ept);
       rpmsg_socket_post(&conn->sendsem);
       rpmsg_socket_post(&conn->recvsem);
@@ -891,6 +1031,13 @@ static int rpmsg_socket_poll(FAR struct socket *psock,
                   eventset |= POLLIN;
                 }
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+              if (conn->heldcount > 0)
+                {
+                  eventset |= POLLIN;
+                }
+#endif
+
               nxmutex_unlock(&conn->recvlock);
             }
         }
@@ -1205,6 +1352,30 @@ static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
 
   nxmutex_lock(&conn->recvlock);
 
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+  ret = rpmsg_socket_read_held(conn, buf, len,
+                               psock->s_type == SOCK_STREAM);
+  if (ret > 0)
+    {
+      /* Continue with recvbuf only once all held data has been read */
+
+      if (psock->s_type == SOCK_STREAM && ret < len)
+        {
+          ssize_t nread;
+
+          nread = circbuf_read(&conn->recvbuf, (FAR uint8_t *)buf + ret,
+                               len - ret);
+          if (nread > 0)
+            {
+              conn->recvpos += nread;
+              ret           += nread;
+            }
+        }
+
+      goto out;
+    }
+#endif
+
   if (psock->s_type != SOCK_STREAM)
     {
       uint32_t datalen;
@@ -1332,6 +1503,9 @@ static int rpmsg_socket_ioctl(FAR struct socket *psock,
     {
       case FIONREAD:
         *(FAR int *)((uintptr_t)arg) = circbuf_used(&conn->recvbuf);
+#if CONFIG_NET_RPMSG_RXHOLD > 0
+        *(FAR int *)((uintptr_t)arg) += rpmsg_socket_held_len(conn);
+#endif
         break;
 
       case FIONSPACE:
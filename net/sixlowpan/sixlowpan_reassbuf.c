@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
@@ -44,6 +45,12 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Number of lists of active reassembly buffers, selected by a hash of the
+ * reassembly tag and the source address.  Must be a power of two.
+ */
+
+#define REASS_NHASH          8
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -55,9 +62,11 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the lists of active, allocated reassemby buffers, hashed by
+ * reassembly tag and source address.
+ */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_NHASH];
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -65,9 +74,33 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the list of active reassembly buffers that a reassembly with
+ *   this tag and source address would be in.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reassbuf_s **
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag ^ (reasstag >> 8);
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash ^= fragsrc->nv_addr[i];
+    }
+
+  return &g_active_reass[hash & (REASS_NHASH - 1)];
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -100,6 +133,36 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_expired
+ *
+ * Description:
+ *   Return true if the reassembly buffer is inactive or has timed out.
+ *
+ ****************************************************************************/
+
+static bool sixlowpan_reass_expired(FAR struct sixlowpan_reassbuf_s *reass)
+{
+  /* Inactive reassembly buffers are freed too.  This is done because the
+   * life the reassembly buffer is not cerain.
+   */
+
+  if (!reass->rb_active)
+    {
+      return true;
+    }
+
+  /* Get the elpased time of the reassembly */
+
+  if (clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+    {
+      nwarn("WARNING: Reassembly timed out\n");
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
@@ -121,35 +184,20 @@ static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
-  clock_t elapsed;
+  int i;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_NHASH; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
-          /* Get the elpased time of the reassembly */
-
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          /* Needed if 'reass' is freed */
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          next = reass->rb_flink;
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (sixlowpan_reass_expired(reass))
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
         }
@@ -175,12 +223,14 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -194,7 +244,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -279,6 +329,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -315,9 +366,12 @@ FAR struct sixlowpan_reassbuf_s *
 
   if (reass != NULL)
     {
-      /* Zero and tag the allocated reassembly buffer structure. */
+      /* Zero and tag the allocated reassembly buffer structure.  The packet
+       * buffer is filled in by the fragments and needs no zeroing.
+       */
 
-      memset(reass, 0, sizeof(struct sixlowpan_reassbuf_s));
+      memset(&reass->rb_pool, 0, sizeof(struct sixlowpan_reassbuf_s) -
+             offsetof(struct sixlowpan_reassbuf_s, rb_pool));
       memcpy(&reass->rb_fragsrc, fragsrc, sizeof(struct netdev_varaddr_s));
       reass->rb_pool     = pool;
       reass->rb_active   = true;
@@ -326,8 +380,9 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink   = *head;
+      *head             = reass;
     }
 
   return reass;
@@ -358,17 +413,14 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
-
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Search for the matching reassembly buffer in the list it hashes to.
+   * The other lists are left to be expired by sixlowpan_reass_allocate(),
+   * so that each fragment does not have to visit every buffer.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = *sixlowpan_reass_hash(reasstag, fragsrc);
+       reass != NULL;
+       reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -378,6 +430,16 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag.
+           */
+
+          if (sixlowpan_reass_expired(reass))
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -28,6 +28,7 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -119,6 +120,108 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' messages from a socket.  This is
+ *   an internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that it is not a cancellation point, does not modify the errno
+ *   variable and accepts the internal socket structure as an input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags, possibly with MSG_WAITFORONE
+ *   timeout   Stop after the first message received after this time, may
+ *             be NULL
+ *
+ * Returned Value:
+ *   The number of messages received; the length of each is returned in
+ *   its msg_len.  If no message was received, a negated errno value as
+ *   from psock_recvmsg().
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  clock_t deadline = 0;
+  unsigned int count;
+  sclock_t ticks;
+  ssize_t ret = OK;
+  bool locked;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      clock_time2ticks(timeout, &ticks);
+      deadline = clock_systime_ticks() + ticks;
+    }
+
+  /* Inet and CAN sockets only block in net_sem_timedwait(), which breaks
+   * the network lock, so their messages are all received under one lock.
+   */
+
+  locked = psock->s_domain == PF_INET || psock->s_domain == PF_INET6 ||
+           psock->s_domain == PF_CAN;
+  if (locked)
+    {
+      net_lock();
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+
+      /* Stop at the end of a stream or after the timeout */
+
+      if ((ret == 0 && psock->s_type == SOCK_STREAM) ||
+          (timeout != NULL &&
+           (sclock_t)(clock_systime_ticks() - deadline) >= 0))
+        {
+          count++;
+          break;
+        }
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  return count > 0 ? count : ret;
+}
+
 /****************************************************************************
  * Function: recvmsg
  *
@@ -192,4 +295,56 @@ ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
   return ret;
 }
 
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives multiple messages from a socket with one call.
+ *   With MSG_WAITFORONE, only the first message is waited for.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to receive
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  Stop after the first message received after this time, may
+ *            be NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set as by recvmsg().
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
 #endif /* CONFIG_NET */
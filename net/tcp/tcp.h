@@ -74,6 +74,9 @@
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_RACK
+#  define TCP_WBXMITTIME(wrb)        ((wrb)->wb_xmittime)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -92,6 +95,22 @@
 #  endif
 #endif
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* Hash tables used to demultiplex incoming segments */
+
+#  if (CONFIG_NET_TCP_CONN_HASHSIZE & (CONFIG_NET_TCP_CONN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONN_HASHSIZE must be a power of two
+#  endif
+
+#  if (CONFIG_NET_TCP_LISTEN_HASHSIZE & \
+       (CONFIG_NET_TCP_LISTEN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_LISTEN_HASHSIZE must be a power of two
+#  endif
+
+#  define TCP_LISTEN_HASH(port) \
+     (((port) ^ ((port) >> 8)) & (CONFIG_NET_TCP_LISTEN_HASHSIZE - 1))
+#endif
+
 /* 32-bit modular arithmetics for tcp sequence numbers */
 
 #define TCP_SEQ_LT(a, b)	((int32_t)((a) - (b)) < 0)
@@ -114,6 +133,14 @@
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
 
+/* The congestion control algorithm of new connections */
+
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+#  define TCP_CC_DEFAULT      (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT      (&g_tcp_cc_newreno)
+#endif
+
 #endif
 
 /* The Max Range count of TCP Selective ACKs */
@@ -175,6 +202,45 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The common logic in tcp_cc.c performs
+ * the slow start and the fast retransmit/fast recovery (RFC 5681, RFC 6582)
+ * and leaves the window growth in congestion avoidance and the window
+ * reduction after a loss to the algorithm.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* Name used with the TCP_CONGESTION option */
+
+  /* Reset the private state of the algorithm.  May be NULL. */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd in congestion avoidance after 'acked' new bytes were ACKed */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Return the new ssthresh on a loss, from fast retransmit or timeout */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of the CUBIC algorithm (RFC 8312) */
+
+struct tcp_cubic_s
+{
+  bool     epoch_valid;   /* A congestion avoidance epoch was started */
+  clock_t  epoch;         /* Start time of the epoch */
+  uint32_t k;             /* Time to reach origin (units: ms) */
+  uint32_t origin;        /* cwnd at the plateau of the cubic function */
+  uint32_t w_max;         /* cwnd before the last reduction */
+  uint32_t w_est;         /* Estimated window of a standard TCP */
+};
+#endif
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -227,6 +293,7 @@ struct tcp_conn_s
   uint8_t  tcpstateflags; /* TCP state and flags */
   struct   work_s work;   /* TCP timer handle */
   bool     timeout;       /* Trigger from timer expiry */
+  uint32_t tmrarmed;      /* Delay the timer was armed with (half-seconds) */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
                            * segment sent */
@@ -251,6 +318,11 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* Congestion control algorithm */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic;              /* State of CUBIC */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -280,6 +352,19 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_SOLINGER
   sclock_t ltimeout;      /* Linger timeout expiration */
 #endif
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  /* Demultiplexing hash chains:
+   *
+   *   hash_next   - The next active connection in the same bucket of the
+   *                 connection hash table.
+   *   listen_next - The next listening connection in the same bucket of
+   *                 the listener hash table.
+   */
+
+  FAR struct tcp_conn_s *hash_next;
+  FAR struct tcp_conn_s *listen_next;
+#endif
+
   /* If the TCP socket is bound to a local address, then this is
    * a reference to the device that routes traffic on the corresponding
    * network.
@@ -409,6 +494,9 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  clock_t    wb_xmittime;  /* Time of the last (re)transmission */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -444,6 +532,15 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The available congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -521,6 +618,22 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_conn_hashlen
+ *
+ * Description:
+ *   Return the number of active connections linked into one bucket of the
+ *   connection hash table.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+unsigned int tcp_conn_hashlen(unsigned int bucket);
+#endif
+
 /****************************************************************************
  * Name: tcp_local_ipv4_device
  *
@@ -1055,6 +1168,22 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_listen_hashlen
+ *
+ * Description:
+ *   Return the number of listening connections linked into one bucket of
+ *   the listener hash table.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+unsigned int tcp_listen_hashlen(unsigned int bucket);
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -2314,6 +2443,44 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, e.g. "newreno" or "cubic"
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
 #endif
 
 #ifdef __cplusplus
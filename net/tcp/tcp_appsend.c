@@ -142,6 +142,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
            */
 
           conn->rx_unackseg = 1;
+          tcp_update_timer(conn);
           return;
         }
     }
@@ -23,6 +23,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <errno.h>
+#include <string.h>
 #include <debug.h>
 
 #include "tcp/tcp.h"
@@ -73,10 +75,78 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked);
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",              /* name */
+  NULL,                   /* init */
+  tcp_newreno_cong_avoid, /* cong_avoid */
+  tcp_newreno_ssthresh    /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All available congestion control algorithms */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algos[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_newreno_cong_avoid
+ *
+ * Description:
+ *   cong avoid (RFC 5681):
+ *   Grow cwnd linearly by approximately maxseg per RTT using
+ *   maxseg^2 / cwnd per ACK as the increment.
+ *   If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+ *   avoid capping cwnd.
+ *
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked)
+{
+  uint32_t increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  UNUSED(acked);
+  CC_CWND_INC(conn->cwnd, increase);
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -116,6 +186,11 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -139,15 +214,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm reduce ssthresh and
+   * enter to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -283,19 +357,95 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
-
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+              /* cong avoid: up to the algorithm */
 
-              CC_CWND_INC(conn->cwnd, increase);
+              conn->cc_ops->cong_avoid(conn, acked);
               conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
               ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
             }
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, e.g. "newreno" or "cubic"
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_algos); i++)
+    {
+      if (strcmp(g_tcp_cc_algos[i]->name, name) == 0)
+        {
+          break;
+        }
+    }
+
+  if (i == nitems(g_tcp_cc_algos))
+    {
+      return -ENOENT;
+    }
+
+  /* The windows are kept, only the state of the algorithm starts over */
+
+  conn->cc_ops = g_tcp_cc_algos[i];
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+
+  return OK;
+}
@@ -0,0 +1,234 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ * The CUBIC congestion control algorithm (RFC 8312)
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* W_cubic(t) = C * (t - K)^3 + W_max with C = 0.4 segments / s^3.  With t
+ * in milliseconds and the window in 1/16 segments, this takes the constant
+ * 10^9 / 16 / 0.4.
+ */
+
+#define CUBIC_SCALE     156250000
+
+/* Limit |t - K| so that its cube fits into 64 bits (about 17 minutes) */
+
+#define CUBIC_MAXTIME   (1 << 20)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  tcp_cubic_init,         /* init */
+  tcp_cubic_cong_avoid,   /* cong_avoid */
+  tcp_cubic_ssthresh      /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cubic_root
+ *
+ * Description:
+ *   Return the integer cube root of 'x'.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ *
+ * Description:
+ *   Forget the last congestion event.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cubic, 0, sizeof(conn->cubic));
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards the cubic function of the time since the start of
+ *   the congestion avoidance epoch, or towards the window a standard TCP
+ *   would have if that is larger (the TCP-friendly region).
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  clock_t now = clock_systime_ticks();
+  uint32_t increase;
+  int64_t target;
+  int64_t t;
+
+  if (!cubic->epoch_valid)
+    {
+      cubic->epoch_valid = true;
+      cubic->epoch       = now;
+      cubic->w_est       = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          /* K = cubic_root(W_max * (1 - beta) / C) */
+
+          cubic->k      = tcp_cubic_root((uint64_t)(cubic->w_max -
+                                                    conn->cwnd) * 16 /
+                                         conn->mss * CUBIC_SCALE);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* Look at W_cubic(t + RTT), the RTT from the retransmission timer
+   * estimation.
+   */
+
+  t = (int64_t)TICK2MSEC(now - cubic->epoch) +
+      (conn->sa >> 3) * (MSEC_PER_SEC / HSEC_PER_SEC) - cubic->k;
+  t = MIN(MAX(t, -CUBIC_MAXTIME), CUBIC_MAXTIME);
+
+  target = cubic->origin + t * t * t / CUBIC_SCALE * conn->mss / 16;
+
+  /* W_est grows by alpha = 3 * (1 - beta) / (1 + beta) = 9 / 17 segments
+   * per RTT.
+   */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * 9 / 17 / conn->cwnd;
+  target = MAX(target, (int64_t)cubic->w_est);
+
+  if (target > conn->cwnd)
+    {
+      /* (target - cwnd) / cwnd segments per segment ACKed, at most
+       * doubling per RTT like slow start.
+       */
+
+      increase = MIN((uint64_t)(target - conn->cwnd) * acked / conn->cwnd,
+                     acked);
+    }
+  else
+    {
+      /* Grow very slowly around the plateau */
+
+      increase = (uint64_t)acked * conn->mss / (100 * (uint64_t)conn->cwnd);
+    }
+
+  increase = MAX(increase, 1);
+  if (conn->cwnd + increase >= conn->cwnd)
+    {
+      conn->cwnd += increase;
+    }
+  else
+    {
+      conn->cwnd = UINT32_MAX;
+    }
+
+  ninfo("cubic cwnd %" PRIu32 " target %" PRId64 "\n", conn->cwnd, target);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss and reduce it by beta = 0.7.  With the
+ *   fast convergence, a flow whose window is lower than at the previous
+ *   loss releases bandwidth by lowering W_max even further.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd * 17 / 20;
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  cubic->epoch_valid = false;
+  return MAX((uint64_t)conn->cwnd * 7 / 10, 2 * conn->mss);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
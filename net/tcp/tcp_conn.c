@@ -88,10 +88,144 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The active connections hashed by local port, remote port and remote
+ * address.  The local address is not part of the key because connections
+ * bound to INADDR_ANY must match any destination address.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Select the connection hash bucket for the given ports (in network byte
+ *   order) and the remote address folded to 32 bits.
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_hash(uint16_t lport, uint16_t rport,
+                                    uint32_t raddr)
+{
+  uint32_t hash = raddr ^ (((uint32_t)lport << 16) | rport);
+
+  /* Multiplicative hashing spreads the entropy into the upper bits, fold
+   * them back into the bucket index.
+   */
+
+  hash *= 0x9e3779b1;
+  return (hash ^ (hash >> 16)) & (CONFIG_NET_TCP_CONN_HASHSIZE - 1);
+}
+
+#ifdef CONFIG_NET_IPv6
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold an IPv6 address into 32 bits for hashing.
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return (((uint32_t)addr[0] << 16) | addr[1]) ^
+         (((uint32_t)addr[2] << 16) | addr[3]) ^
+         (((uint32_t)addr[4] << 16) | addr[5]) ^
+         (((uint32_t)addr[6] << 16) | addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_conn
+ *
+ * Description:
+ *   Select the connection hash bucket of an active connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_hash_conn(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport,
+                      tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: tcp_hash_insert
+ *
+ * Description:
+ *   Link a connection that has just been added to the active list into the
+ *   connection hash table.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_insert(FAR struct tcp_conn_s *conn)
+{
+  unsigned int bucket = tcp_hash_conn(conn);
+
+  conn->hash_next        = g_tcp_connhash[bucket];
+  g_tcp_connhash[bucket] = conn;
+}
+
+/****************************************************************************
+ * Name: tcp_hash_remove
+ *
+ * Description:
+ *   Unlink a connection that is being removed from the active list from
+ *   the connection hash table.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_connhash[tcp_hash_conn(conn)];
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link = conn->hash_next;
+          break;
+        }
+
+      link = &(*link)->hash_next;
+    }
+
+  conn->hash_next = NULL;
+}
+#else
+#  define tcp_hash_insert(conn)
+#  define tcp_hash_remove(conn)
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -186,9 +320,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_connhash[tcp_hash(tcp->destport, tcp->srcport,
+                                       srcipaddr)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -225,7 +364,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hash_next;
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -253,9 +396,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_connhash[tcp_hash(tcp->destport, tcp->srcport,
+                                       tcp_ipv6_fold(ip->srcipaddr))];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -292,7 +440,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hash_next;
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -747,6 +899,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
 #endif
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops        = TCP_CC_DEFAULT;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -874,6 +1029,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_remove(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -999,6 +1155,35 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_conn_hashlen
+ *
+ * Description:
+ *   Return the number of active connections linked into one bucket of the
+ *   connection hash table.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+unsigned int tcp_conn_hashlen(unsigned int bucket)
+{
+  FAR struct tcp_conn_s *conn;
+  unsigned int count = 0;
+
+  DEBUGASSERT(bucket < CONFIG_NET_TCP_CONN_HASHSIZE);
+
+  for (conn = g_tcp_connhash[bucket]; conn != NULL; conn = conn->hash_next)
+    {
+      count++;
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -1159,6 +1344,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
       /* Initialize the variables of congestion control */
 
+      conn->cc_ops = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1183,6 +1369,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_insert(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1491,6 +1678,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_hash_insert(conn);
   ret = OK;
 
 errout_with_lock:
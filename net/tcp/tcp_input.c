@@ -66,6 +66,15 @@
 
 #define IPDATA(hl) (*(FAR uint8_t *)IPBUF(hl))
 
+/* GRO verifies the checksum of each segment it coalesces */
+
+#ifdef CONFIG_NETDEV_GRO
+#  define TCP_CSUM_VALID(dev) \
+     (((dev)->d_iob->io_offload & NETDEV_OFFLOAD_CSUM_VALID) != 0)
+#else
+#  define TCP_CSUM_VALID(dev) false
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -688,7 +697,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!TCP_CSUM_VALID(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -700,6 +709,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       goto drop;
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  /* The buffer may be reused for the reply */
+
+  dev->d_iob->io_offload &= ~NETDEV_OFFLOAD_CSUM_VALID;
+#endif
+
   /* Demultiplex this segment. First check any active connections. */
 
   conn = tcp_active(dev, tcp);
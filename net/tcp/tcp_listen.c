@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -63,6 +64,13 @@
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The listening connections hashed by local port */
+
+static FAR struct tcp_conn_s *
+  g_tcp_listenhash[CONFIG_NET_TCP_LISTEN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -87,6 +95,18 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine each connection structure in the bucket of this port */
+
+  for (conn = g_tcp_listenhash[TCP_LISTEN_HASH(portno)];
+       conn != NULL;
+       conn = conn->listen_next)
+    {
+      /* Does the connection have the same local port number? */
+
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -98,6 +118,7 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (conn && conn->lport == portno && conn->domain == domain)
 #else
@@ -166,6 +187,18 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
     {
       if (tcp_listenports[ndx] == conn)
         {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+          FAR struct tcp_conn_s **link =
+            &g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+
+          while (*link != conn)
+            {
+              link = &(*link)->listen_next;
+            }
+
+          *link = conn->listen_next;
+          conn->listen_next = NULL;
+#endif
           tcp_listenports[ndx] = NULL;
           ret = OK;
           break;
@@ -229,6 +262,11 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               /* Yes.. we found it */
 
               tcp_listenports[ndx] = conn;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+              conn->listen_next =
+                g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+              g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)] = conn;
+#endif
               ret = OK;
               break;
             }
@@ -263,6 +301,36 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_listen_hashlen
+ *
+ * Description:
+ *   Return the number of listening connections linked into one bucket of
+ *   the listener hash table.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+unsigned int tcp_listen_hashlen(unsigned int bucket)
+{
+  FAR struct tcp_conn_s *conn;
+  unsigned int count = 0;
+
+  DEBUGASSERT(bucket < CONFIG_NET_TCP_LISTEN_HASHSIZE);
+
+  for (conn = g_tcp_listenhash[bucket]; conn != NULL;
+       conn = conn->listen_next)
+    {
+      count++;
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
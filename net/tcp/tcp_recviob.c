@@ -0,0 +1,376 @@
+/****************************************************************************
+ * net/tcp/tcp_recviob.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "inet/inet.h"
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP_RECV_ZEROCOPY) && defined(NET_TCP_HAVE_STACK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_recviob_s
+{
+  FAR struct tcp_conn_s       *ri_conn;  /* The connection waited for */
+  FAR struct devif_callback_s *ri_cb;    /* Reference to callback instance */
+  sem_t                        ri_sem;   /* Signals new data or disconnect */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the receiver on new data or on a loss of connection.  The new
+ *   data is not consumed here, so the stack queues it in the read-ahead
+ *   buffer where the receiver picks it up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct tcp_recviob_s *pstate = pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL && (flags & (TCP_NEWDATA | TCP_DISCONN_EVENTS)) != 0)
+    {
+      FAR struct tcp_conn_s *conn = pstate->ri_conn;
+
+      if ((flags & TCP_DISCONN_EVENTS) != 0 &&
+          _SS_ISCONNECTED(conn->sconn.s_flags))
+        {
+          /* Handle loss-of-connection event */
+
+          tcp_lost_connection(conn, pstate->ri_cb, flags);
+        }
+
+      /* Don't allow any further call backs and wake up the receiver */
+
+      pstate->ri_cb->flags = 0;
+      pstate->ri_cb->priv  = NULL;
+      pstate->ri_cb->event = NULL;
+
+      nxsem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: tcp_recviob_wait
+ *
+ * Description:
+ *   Wait until new data arrives on the connection or it is lost.
+ *
+ * Returned Value:
+ *   Zero (OK) on an event; a negated errno value on a timeout, on a signal
+ *   or if no callback is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int tcp_recviob_wait(FAR struct tcp_conn_s *conn)
+{
+  struct tcp_recviob_s state;
+  int ret;
+
+  memset(&state, 0, sizeof(state));
+  nxsem_init(&state.ri_sem, 0, 0);
+  state.ri_conn = conn;
+
+  state.ri_cb = tcp_callback_alloc(conn);
+  if (state.ri_cb == NULL)
+    {
+      nxsem_destroy(&state.ri_sem);
+      return -EBUSY;
+    }
+
+  state.ri_cb->flags = TCP_NEWDATA | TCP_DISCONN_EVENTS;
+  state.ri_cb->priv  = &state;
+  state.ri_cb->event = tcp_recviob_eventhandler;
+
+  ret = net_sem_timedwait(&state.ri_sem,
+                          _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+  if (ret == -ETIMEDOUT)
+    {
+      ret = -EAGAIN;
+    }
+
+  tcp_callback_free(conn, state.ri_cb);
+  nxsem_destroy(&state.ri_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_recviob_take
+ *
+ * Description:
+ *   Detach up to 'len' bytes from the head of the read-ahead buffer.  The
+ *   chain is split between two buffers; only if even the first buffer is
+ *   larger than 'len' is its head copied into a new buffer.
+ *
+ * Returned Value:
+ *   The detached I/O buffer chain, or NULL if no buffer is available for
+ *   the copy.
+ *
+ * Assumptions:
+ *   The network is locked and the read-ahead buffer is not empty.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *tcp_recviob_take(FAR struct tcp_conn_s *conn,
+                                          size_t len)
+{
+  FAR struct iob_s *iob = conn->readahead;
+  FAR struct iob_s *prev = NULL;
+  FAR struct iob_s *next = iob;
+  unsigned int total = 0;
+
+  if (iob->io_pktlen <= len)
+    {
+      conn->readahead = NULL;
+      return iob;
+    }
+
+  while (total + next->io_len <= len)
+    {
+      total += next->io_len;
+      prev   = next;
+      next   = next->io_flink;
+    }
+
+  if (prev == NULL)
+    {
+      FAR struct iob_s *copy = iob_tryalloc(false);
+
+      if (copy == NULL)
+        {
+          return NULL;
+        }
+
+      if (iob_trycopyin(copy, IOB_DATA(iob), len, 0, false) != len)
+        {
+          iob_free_chain(copy);
+          return NULL;
+        }
+
+      conn->readahead = iob_trimhead(iob, len);
+      return copy;
+    }
+
+  /* Split the chain in front of the first buffer that does not fit */
+
+  next->io_pktlen = iob->io_pktlen - total;
+  iob->io_pktlen  = total;
+  prev->io_flink  = NULL;
+  conn->readahead = next;
+  return iob;
+}
+
+/****************************************************************************
+ * Name: tcp_recviob_conn
+ *
+ * Description:
+ *   Return the TCP connection of a socket, if it is an inet stream socket.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *tcp_recviob_conn(FAR struct socket *psock)
+{
+  if (psock == NULL || psock->s_conn == NULL ||
+      psock->s_type != SOCK_STREAM ||
+      (psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+      psock->s_sockif != inet_sockif(psock->s_domain, psock->s_type,
+                                     psock->s_proto))
+    {
+      return NULL;
+    }
+
+  return psock->s_conn;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recv_iob
+ *
+ * Description:
+ *   Receive data from a TCP socket without copying it: the I/O buffers
+ *   holding up to 'len' bytes of the received data are detached from the
+ *   connection and lent to the caller, who must give them back with
+ *   psock_release_iob().
+ *
+ * Input Parameters:
+ *   psock - A TCP socket
+ *   iob   - Location to return the I/O buffer chain.  The data starts at
+ *           IOB_DATA() of the head and io_pktlen is its total length.
+ *   len   - Maximum number of bytes to return
+ *   flags - Zero or MSG_DONTWAIT
+ *
+ * Returned Value:
+ *   The number of bytes returned in 'iob', zero if the peer has closed the
+ *   connection, or a negated errno value as from recv().
+ *
+ ****************************************************************************/
+
+ssize_t psock_recv_iob(FAR struct socket *psock, FAR struct iob_s **iob,
+                       size_t len, int flags)
+{
+  FAR struct tcp_conn_s *conn;
+  ssize_t ret;
+
+  if (iob == NULL || len == 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((flags & ~MSG_DONTWAIT) != 0)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn = tcp_recviob_conn(psock);
+  if (conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  *iob = NULL;
+  net_lock();
+
+  /* There may be read-ahead data even after the socket has been
+   * disconnected.
+   */
+
+  while (conn->readahead == NULL)
+    {
+      if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+        {
+          ret = _SS_ISCLOSED(conn->sconn.s_flags) ? 0 : -ENOTCONN;
+          goto errout;
+        }
+
+      if (_SS_ISNONBLOCK(conn->sconn.s_flags) ||
+          (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      ret = tcp_recviob_wait(conn);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  *iob = tcp_recviob_take(conn, len);
+  if (*iob == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = (*iob)->io_pktlen;
+
+  if (tcp_should_send_recvwindow(conn))
+    {
+      netdev_txnotify_dev(conn->dev);
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_release_iob
+ *
+ * Description:
+ *   Give back the I/O buffers lent by psock_recv_iob().  The receive window
+ *   of the connection, which shrinks while buffers are lent, is advertised
+ *   again if needed.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket the buffers were received on
+ *   iob   - The I/O buffer chain returned by psock_recv_iob()
+ *
+ ****************************************************************************/
+
+void psock_release_iob(FAR struct socket *psock, FAR struct iob_s *iob)
+{
+  FAR struct tcp_conn_s *conn;
+
+  if (iob != NULL)
+    {
+      iob_free_chain(iob);
+    }
+
+  conn = tcp_recviob_conn(psock);
+  if (conn != NULL)
+    {
+      net_lock();
+      if (tcp_should_send_recvwindow(conn))
+        {
+          netdev_txnotify_dev(conn->dev);
+        }
+
+      net_unlock();
+    }
+}
+
+#endif /* CONFIG_NET_TCP_RECV_ZEROCOPY && NET_TCP_HAVE_STACK */
@@ -46,6 +46,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -184,10 +185,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         IP_PROTO_TCP, dev->d_ipv6addr, conn->u.ipv6.raddr,
                         conn->sconn.ttl, conn->sconn.s_tclass);
 
-      /* Calculate TCP checksum. */
+      /* Calculate TCP checksum, unless the device does it. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_offload_chksum(dev, IP_PROTO_TCP, IPv6_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum),
+                                 conn->mss))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
 #endif
@@ -204,10 +211,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         &dev->d_ipaddr, &conn->u.ipv4.raddr,
                         conn->sconn.ttl, conn->sconn.s_tos, NULL);
 
-      /* Calculate TCP checksum. */
+      /* Calculate TCP checksum, unless the device does it. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_offload_chksum(dev, IP_PROTO_TCP, IPv4_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum),
+                                 conn->mss))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
 #endif
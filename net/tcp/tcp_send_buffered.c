@@ -114,12 +114,25 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
 {
   FAR sq_entry_t *entry = (FAR sq_entry_t *)wrb;
   FAR sq_entry_t *insert = NULL;
-
   FAR sq_entry_t *itr;
+
+  /* Segments are normally queued in the order they are sent, so look at
+   * the tail first.
+   */
+
+  itr = sq_tail(q);
+  if (itr == NULL ||
+      TCP_SEQ_LT(TCP_WBSEQNO((FAR struct tcp_wrbuffer_s *)itr),
+                 TCP_WBSEQNO(wrb)))
+    {
+      sq_addlast(entry, q);
+      return;
+    }
+
   for (itr = sq_peek(q); itr; itr = sq_next(itr))
     {
       FAR struct tcp_wrbuffer_s *wrb0 = (FAR struct tcp_wrbuffer_s *)itr;
-      if (TCP_WBSEQNO(wrb0) < TCP_WBSEQNO(wrb))
+      if (TCP_SEQ_LT(TCP_WBSEQNO(wrb0), TCP_WBSEQNO(wrb)))
         {
           insert = itr;
         }
@@ -405,6 +418,39 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_send_segsize
+ *
+ * Description:
+ *   Return the largest amount of new data to send in one packet.  This is
+ *   the MSS, or a multiple of it if the device segments TCP packets itself.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_segsize(FAR struct net_driver_s *dev,
+                                 FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_OFFLOAD
+  bool ipv6;
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  ipv6 = conn->domain != PF_INET;
+#elif defined(CONFIG_NET_IPv6)
+  ipv6 = true;
+#else
+  ipv6 = false;
+#endif
+
+  if (dev != NULL)
+    {
+      return netdev_offload_tsosize(dev, ipv6, tcpip_hdrsize(conn),
+                                    conn->mss);
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -501,9 +547,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%04x\n", ackno, flags);
 
-      /* Look at every write buffer in the unacked_q.  The unacked_q
+      /* Look at the write buffers in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
-       * have not yet been ACKed.
+       * have not yet been ACKed, in the order of their sequence numbers:
+       * the walk stops at the first buffer that is not ACKed.
        */
 
       for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
@@ -626,6 +673,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
                     }
                 }
+
+              break;
+            }
+          else
+            {
+              /* Neither this nor any of the following buffers is ACKed */
+
+              break;
             }
         }
 
@@ -750,6 +805,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMITTIME(wrb) = clock_systime_ticks();
+#endif
+
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
@@ -783,12 +842,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
       FAR sq_entry_t *next;
-      uint32_t right;
+#ifdef CONFIG_NET_TCP_RACK
+      bool delivered = false;
+      clock_t rackxmit = 0;
+      clock_t reownd;
+#endif
       int i;
 
       /* Dump s-ack edge */
 
-      for (i = 0, right = 0; i < nsacks; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
@@ -796,29 +859,85 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
         }
 
-      for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+#ifdef CONFIG_NET_TCP_RACK
+      /* Find the most recently sent segment that has been delivered */
+
+      for (entry = sq_peek(&conn->unacked_q), i = 0; entry;
+           entry = sq_next(entry))
+        {
+          wrb = (FAR struct tcp_wrbuffer_s *)entry;
+
+          while (i < nsacks &&
+                 TCP_SEQ_GTE(TCP_WBSEQNO(wrb), ofosegs[i].right))
+            {
+              i++;
+            }
+
+          if (i == nsacks)
+            {
+              break;
+            }
+
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
+              TCP_SEQ_LTE(TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
+                          ofosegs[i].right) &&
+              (!delivered ||
+               (sclock_t)(TCP_WBXMITTIME(wrb) - rackxmit) > 0))
+            {
+              delivered = true;
+              rackxmit  = TCP_WBXMITTIME(wrb);
+            }
+        }
+
+      /* Allow for a reordering of a quarter of the smoothed RTT */
+
+      reownd = HSEC2TICK(conn->sa >> 3) / 4;
+#endif
+
+      /* Both the unacked_q and the s-ack edges are sorted: walk them
+       * together up to the highest s-ack edge.
+       */
+
+      for (entry = sq_peek(&conn->unacked_q), i = 0; entry; entry = next)
         {
           wrb  = (FAR struct tcp_wrbuffer_s *)entry;
           next = sq_next(entry);
 
-          for (i = 0, right = 0; i < nsacks; i++)
+          while (i < nsacks &&
+                 TCP_SEQ_GTE(TCP_WBSEQNO(wrb), ofosegs[i].right))
             {
-              /* Wrb seqno out of s-ack edge ? do retransmit ! */
+              i++;
+            }
 
-              if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
-                  TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
+          if (i == nsacks)
+            {
+              break;
+            }
+
+          /* Wrb seqno out of s-ack edge ? do retransmit ! */
+
+          if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left))
+            {
+#ifdef CONFIG_NET_TCP_RACK
+              /* Not lost yet if nothing sent after it has been delivered,
+               * e.g. it has been retransmitted already.
+               */
+
+              if (delivered &&
+                  (sclock_t)(rackxmit - TCP_WBXMITTIME(wrb)) <
+                  (sclock_t)reownd)
                 {
-                  ninfo("TCP REXMIT "
-                        "[%" PRIu32 " : %" PRIu32 " : %d]\n",
-                        TCP_WBSEQNO(wrb),
-                        TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
-                        TCP_WBPKTLEN(wrb));
-                  sq_rem(entry, &conn->unacked_q);
-                  retransmit_segment(conn, (FAR void *)entry);
-                  break;
+                  continue;
                 }
+#endif
 
-              right = ofosegs[i].right;
+              ninfo("TCP REXMIT "
+                    "[%" PRIu32 " : %" PRIu32 " : %d]\n",
+                    TCP_WBSEQNO(wrb),
+                    TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
+                    TCP_WBPKTLEN(wrb));
+              sq_rem(entry, &conn->unacked_q);
+              retransmit_segment(conn, (FAR void *)entry);
             }
         }
 
@@ -1006,12 +1125,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t segsize;
           int ret;
 
-          sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          /* New data may go out in packets larger than the MSS if the
+           * device supports TSO.  Retransmissions always use the MSS.
+           */
+
+          segsize = tcp_send_segsize(dev, conn);
+          sndlen  = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
+          if (sndlen > segsize)
             {
-              sndlen = conn->mss;
+              sndlen = segsize;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1057,6 +1182,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMITTIME(wrb) = clock_systime_ticks();
+#endif
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
            * the amount of data sent. This will be needed in sequence
@@ -1135,12 +1264,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 {
   const uint32_t mss = conn->mss;
+  const uint32_t segsize = tcp_send_segsize(conn->dev, conn);
   uint32_t size;
 
   /* a few segments should be fine */
 
   size = 4 * mss;
 
+  /* but at least one packet for a device doing TSO */
+
+  if (size < segsize)
+    {
+      size = segsize;
+    }
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1478,7 +1615,31 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+          if (off == 0)
+            {
+              /* A newly allocated write buffer is not visible to the rest
+               * of the stack yet.  Copy into it without holding the
+               * network lock so that large sends do not stall the input
+               * processing and the polling of all other connections.
+               */
+
+              net_unlock();
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+              net_lock();
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: No longer connected\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+            }
+          else
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
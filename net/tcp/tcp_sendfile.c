@@ -71,6 +71,7 @@ struct sendfile_s
   FAR struct tcp_conn_s *snd_conn;         /* Connection associated with the socket */
   FAR struct devif_callback_s *snd_cb;     /* Reference to callback instance */
   FAR struct file   *snd_file;             /* File structure of the input file */
+  FAR const uint8_t *snd_fdata;            /* Memory-backed file data or NULL */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -94,6 +95,36 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_xmit
+ *
+ * Description:
+ *   Set up the device buffer with 'sndlen' bytes starting 'sent' bytes
+ *   into the transfer.  Memory-backed file data is copied into the packet
+ *   directly; otherwise the data is read from the file.  Retransmissions
+ *   take the same path, so they need no extra copy of the data either.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int sendfile_xmit(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         uint32_t sndlen, uint32_t sent)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+  if (pstate->snd_fdata != NULL)
+    {
+      return devif_send(dev, pstate->snd_fdata + sent, sndlen,
+                        tcpip_hdrsize(conn));
+    }
+
+  return devif_file_send(dev, pstate->snd_file, sndlen,
+                         pstate->snd_foffset + sent, tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -267,9 +298,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_xmit(dev, pstate, sndlen, pstate->snd_acked);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -338,9 +367,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_xmit(dev, pstate, sndlen, pstate->snd_sent);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -416,6 +443,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
+  FAR void *fdata;
   off_t startpos;
   int ret;
 
@@ -471,6 +499,16 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+  /* Memory-backed file data (e.g. ROMFS on XIP media or TMPFS) is put into
+   * the packets without going through the file system on every segment.
+   */
+
+  if (file_mmap_direct(infile, offset ? *offset : startpos, count,
+                       &fdata) < 0)
+    {
+      fdata = NULL;
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -487,6 +525,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+  state.snd_fdata   = fdata;                       /* Or its data in memory */
 
   /* Allocate resources to receive a callback */
 
@@ -546,6 +585,15 @@ errout_locked:
 #endif
   net_unlock();
 
+  /* Leave the file position where reading the sent data would have left
+   * it.
+   */
+
+  if (fdata != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+
   /* Return the current file position */
 
   if (offset)
@@ -26,6 +26,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -259,6 +260,27 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          char name[TCP_CA_NAME_MAX];
+          size_t len = strnlen(value, value_len);
+
+          if (len == 0 || len >= sizeof(name))
+            {
+              return -EINVAL;
+            }
+
+          memcpy(name, value, len);
+          name[len] = '\0';
+
+          net_lock();
+          ret = tcp_cc_select(conn, name);
+          net_unlock();
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -70,9 +70,9 @@
 /* Per RFC 1122:  "... an ACK should not be excessively delayed; in
  * particular, the delay MUST be less than 0.5 seconds ..."
  *
- * NOTE:  We only have 0.5 timing resolution here so the delay will be
- * between 0.5 and 1.0 seconds, and may be delayed further, depending on the
- * polling rate of the the driver (often 1 second).
+ * NOTE:  We only have 0.5 timing resolution here.  The timer of the
+ * connection is armed for the delayed ACK when it is deferred, so the delay
+ * is 0.5 seconds and does not depend on the polling rate of the driver.
  */
 
 #define ACK_DELAY (1)
@@ -114,9 +114,70 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Wake up in time to send a deferred ACK that was not piggybacked */
+
+  if (conn->rx_unackseg > 0)
+    {
+      int delay = conn->rx_acktimer < ACK_DELAY ?
+                  ACK_DELAY - conn->rx_acktimer : 1;
+
+      if (timeout == 0 || timeout > delay)
+        {
+          timeout = delay;
+        }
+    }
+#endif
+
   return timeout;
 }
 
+/****************************************************************************
+ * Name: tcp_timer_delayack
+ *
+ * Description:
+ *   Advance the delayed ACK timer by 'hsec' and send the deferred ACK if
+ *   it has expired.
+ *
+ * Returned Value:
+ *   True if the ACK is sent.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+static bool tcp_timer_delayack(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn, int hsec)
+{
+  if (conn->rx_unackseg == 0)
+    {
+      return false;
+    }
+
+  /* Increment the ACK delay. */
+
+  conn->rx_acktimer += hsec;
+
+  /* Per RFC 1122:  "...an ACK should not be excessively delayed; in
+   * particular, the delay must be less than 0.5 seconds..."
+   */
+
+  if (conn->rx_acktimer < ACK_DELAY)
+    {
+      return false;
+    }
+
+  /* Reset the delayed ACK state and send the ACK packet. */
+
+  conn->rx_unackseg = 0;
+  conn->rx_acktimer = 0;
+  tcp_synack(dev, conn, TCP_ACK);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_timer_expiry
  *
@@ -142,15 +203,37 @@ static void tcp_timer_expiry(FAR void *arg)
 
   net_lock();
 
+#if CONFIG_NET_TCP_ALLOC_CONNS == 1
+  /* tcp_free() may have released the memory of the connection while this
+   * work was waiting for the network lock, so it cannot be looked at before
+   * it is found in the active list.
+   */
+
   while ((conn = tcp_nextconn(conn)) != NULL)
     {
       if (conn == arg)
         {
-          conn->timeout = true;
-          netdev_txnotify_dev(conn->dev);
           break;
         }
     }
+#else
+  /* Connections are never given back to the heap, so it is sufficient to
+   * check that the connection is still in use.
+   */
+
+  conn = arg;
+  if (conn->tcpstateflags == TCP_CLOSED ||
+      conn->tcpstateflags == TCP_ALLOCATED)
+    {
+      conn = NULL;
+    }
+#endif
+
+  if (conn != NULL)
+    {
+      conn->timeout = true;
+      netdev_txnotify_dev(conn->dev);
+    }
 
   net_unlock();
 }
@@ -205,12 +288,14 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
+          conn->tmrarmed = timeout;
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
     }
   else
     {
+      conn->tmrarmed = 0;
       work_cancel(LPWORK, &conn->work);
     }
 }
@@ -315,14 +400,17 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 {
-  int hsec = tcp_get_timeout(conn);
+  int hsec = conn->tmrarmed;
   uint16_t result;
   uint8_t hdrlen;
 
   /* NOTE: It is important to decrease conn->timer at "hsec" pace,
    * not faster. Excessive (false) decrements of conn->timer are not allowed
    * here. Otherwise, it breaks TCP timings and leads to TCP spurious
-   * retransmissions and other issues due to premature timeouts.
+   * retransmissions and other issues due to premature timeouts.  So "hsec"
+   * is the delay that the expired timer was armed with, not the current
+   * timeout, which may have changed since (e.g. a deferred ACK has been
+   * piggybacked meanwhile).
    */
 
   DEBUGASSERT(dev != NULL && conn != NULL && dev == conn->dev);
@@ -427,6 +515,15 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
               /* Will not yet decrement to zero */
 
               conn->timer -= hsec;
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+              /* The timer may have expired for a deferred ACK */
+
+              if (tcp_timer_delayack(dev, conn, hsec))
+                {
+                  goto done;
+                }
+#endif
             }
           else
             {
@@ -569,22 +666,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
+                    /* Re-enter slow start */
 
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
-
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -684,28 +768,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
            * delayed acknowledgment?
            */
 
-          if (conn->rx_unackseg > 0)
+          if (tcp_timer_delayack(dev, conn, hsec))
             {
-              /* Increment the ACK delay. */
-
-              conn->rx_acktimer += hsec;
-
-              /* Per RFC 1122:  "...an ACK should not be excessively
-               * delayed; in particular, the delay must be less than
-               * 0.5 seconds..."
-               */
-
-              if (conn->rx_acktimer >= ACK_DELAY)
-                {
-                  /* Reset the delayed ACK state and send the ACK
-                   * packet.
-                   */
-
-                  conn->rx_unackseg = 0;
-                  conn->rx_acktimer = 0;
-                  tcp_synack(dev, conn, TCP_ACK);
-                  goto done;
-                }
+              goto done;
             }
 #endif
 
@@ -117,6 +117,12 @@ struct udp_conn_s
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  /* The next bound connection in the same port hash bucket */
+
+  FAR struct udp_conn_s *hash_next;
+#endif
+
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
 #endif
@@ -261,6 +267,18 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Bind the connection to a local port number (in network byte order) or
+ *   unbind it if the port number is zero.  This keeps the port hash table
+ *   in sync and must be used instead of assigning conn->lport directly.
+ *
+ ****************************************************************************/
+
+void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -70,6 +70,41 @@
 #include "socket/socket.h"
 #include "udp/udp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Iterate over the connections that may be bound to a local port:  the
+ * port hash bucket if hashing is enabled, else the whole active list.
+ */
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+#  if (CONFIG_NET_UDP_CONN_HASHSIZE & (CONFIG_NET_UDP_CONN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_UDP_CONN_HASHSIZE must be a power of two
+#  endif
+
+#  define UDP_PORT_HASH(p) \
+     (((p) ^ ((p) >> 8)) & (CONFIG_NET_UDP_CONN_HASHSIZE - 1))
+#  define UDP_BUCKET_HEAD(p)   (g_udp_porthash[UDP_PORT_HASH(p)])
+#  define UDP_BUCKET_NEXT(c)   ((c)->hash_next)
+#else
+#  define UDP_BUCKET_HEAD(p) \
+     ((FAR struct udp_conn_s *)g_active_udp_connections.head)
+#  define UDP_BUCKET_NEXT(c) \
+     ((FAR struct udp_conn_s *)(c)->sconn.node.flink)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+/* Test if a connection accepts the datagram in the packet buffer */
+
+typedef CODE bool (*udp_match_t)(FAR struct udp_conn_s *conn,
+                                 FAR void *iphdr, FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -89,6 +124,12 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The connections bound to a local port, hashed by that port */
+
+static FAR struct udp_conn_s *g_udp_porthash[CONFIG_NET_UDP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -105,6 +146,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: Likewise, if both sockets have this.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -115,14 +157,18 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
                                             uint16_t portno, sockopt_t opt)
 {
-  FAR struct udp_conn_s *conn = NULL;
+  FAR struct udp_conn_s *conn;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure that may use this port. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  for (conn = UDP_BUCKET_HEAD(portno); conn != NULL;
+       conn = UDP_BUCKET_NEXT(conn))
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -135,6 +181,16 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         }
 #endif
 
+      /* Nor if both sockets want to share the port with SO_REUSEPORT */
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+      if (skip_reuseport &&
+          _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -174,11 +230,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 }
 
 /****************************************************************************
- * Name: udp_ipv4_active
+ * Name: udp_ipv4_match
  *
  * Description:
- *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   Check if the connection is the appropriate connection to be used with
+ *   the provided IPv4 and UDP headers.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -186,137 +242,319 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+static bool udp_ipv4_match(FAR struct udp_conn_s *conn, FAR void *iphdr,
+                           FAR struct udp_hdr_s *udp)
 {
 #ifdef CONFIG_NET_BROADCAST
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
-  FAR struct ipv4_hdr_s *ip = IPv4BUF;
-  FAR struct udp_conn_s *conn;
+  FAR struct ipv4_hdr_s *ip = iphdr;
+
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * 1. The destination address is verified against the bound address
+   *    of the connection.
+   *
+   *   - The local port number is checked against the destination port
+   *     number in the received packet.
+   *   - If multiple network interfaces are supported, then the local
+   *     IP address is available and we will insist that the
+   *     destination IP matches the bound address (or the destination
+   *     IP address is a broadcast address). If a socket is bound to
+   *     INADDRY_ANY (laddr), then it should receive all packets
+   *     directed to the port.
+   *
+   * 2. If this is a connection mode UDP socket, then the source address
+   *    is verified against the connected remote address.
+   *
+   *   - The remote port number is checked if the connection is bound
+   *     to a remote port.
+   *   - Finally, if the connection is bound to a remote IP address,
+   *     the source IP address of the packet is checked. Broadcast
+   *     addresses are also accepted.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   *
+   * To send and receive multicast packets, the application should:
+   *
+   *   - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
+   *     or to a specific <multicast-address>
+   *   - setsockopt to SO_BROADCAST (for all-nodes address)
+   *
+   * For connection-less UDP sockets:
+   *
+   *   - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
+   *   - call recvfrom.
+   *
+   * For connection-mode UDP sockets:
+   *
+   *   - call connect() to connect the UDP socket to a specific remote
+   *     address, then
+   *   - Call send() with no address address information
+   *   - call recv() (from address information should not be needed)
+   *
+   * REVISIT: SO_BROADCAST flag is currently ignored.
+   */
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
-    {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * 1. The destination address is verified against the bound address
-       *    of the connection.
-       *
-       *   - The local port number is checked against the destination port
-       *     number in the received packet.
-       *   - If multiple network interfaces are supported, then the local
-       *     IP address is available and we will insist that the
-       *     destination IP matches the bound address (or the destination
-       *     IP address is a broadcast address). If a socket is bound to
-       *     INADDRY_ANY (laddr), then it should receive all packets
-       *     directed to the port.
-       *
-       * 2. If this is a connection mode UDP socket, then the source address
-       *    is verified against the connected remote address.
-       *
-       *   - The remote port number is checked if the connection is bound
-       *     to a remote port.
-       *   - Finally, if the connection is bound to a remote IP address,
-       *     the source IP address of the packet is checked. Broadcast
-       *     addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       *
-       * To send and receive multicast packets, the application should:
-       *
-       *   - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
-       *     or to a specific <multicast-address>
-       *   - setsockopt to SO_BROADCAST (for all-nodes address)
-       *
-       * For connection-less UDP sockets:
-       *
-       *   - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
-       *   - call recvfrom.
-       *
-       * For connection-mode UDP sockets:
-       *
-       *   - call connect() to connect the UDP socket to a specific remote
-       *     address, then
-       *   - Call send() with no address address information
-       *   - call recv() (from address information should not be needed)
-       *
-       * REVISIT: SO_BROADCAST flag is currently ignored.
+  /* Check that there is a local port number and this matches
+   * the port number in the destination address.
+   */
+
+  if (conn->lport != 0 && udp->destport == conn->lport &&
+
+      /* Local port accepts any address on this port or there
+       * is an exact match in destipaddr and the bound local
+       * address.  This catches the receipt of a broadcast when
+       * the socket is bound to INADDR_ANY.
        */
 
-      /* Check that there is a local port number and this matches
-       * the port number in the destination address.
+      (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+       net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)))
+    {
+      /* Check if the socket is connection mode.  In this case, only
+       * packets with source addresses from the connected remote peer
+       * will be accepted.
        */
 
-      if (conn->lport != 0 && udp->destport == conn->lport &&
+      if (_UDP_ISCONNECTMODE(conn->flags))
+        {
+          /* Check if the UDP connection is either (1) accepting packets
+           * from any port or (2) the packet srcport matches the local
+           * bound port number.
+           */
+
+          if ((conn->rport == 0 || udp->srcport == conn->rport) &&
 
-          /* Local port accepts any address on this port or there
-           * is an exact match in destipaddr and the bound local
-           * address.  This catches the receipt of a broadcast when
-           * the socket is bound to INADDR_ANY.
+          /* If (1) not connected to a remote address, or (2) a
+           * broadcast destipaddr was received, or (3) there is an
+           * exact match between the srcipaddr and the bound remote IP
+           * address, then accept the packet.
            */
 
-          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
-           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)))
+              (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
+#ifdef CONFIG_NET_BROADCAST
+               net_ipv4addr_hdrcmp(ip->destipaddr, &bcast) ||
+#endif
+               net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
+            {
+              /* Matching connection found */
+
+              return true;
+            }
+        }
+      else
         {
-          /* Check if the socket is connection mode.  In this case, only
-           * packets with source addresses from the connected remote peer
-           * will be accepted.
+          /* This UDP socket is not connected.  We need to match only
+           * the destination address with the bound socket address.
            */
 
-          if (_UDP_ISCONNECTMODE(conn->flags))
-            {
-              /* Check if the UDP connection is either (1) accepting packets
-               * from any port or (2) the packet srcport matches the local
-               * bound port number.
-               */
+          return true;
+        }
+    }
 
-              if ((conn->rport == 0 || udp->srcport == conn->rport) &&
+  return false;
+}
+#endif /* CONFIG_NET_IPv4 */
 
-              /* If (1) not connected to a remote address, or (2) a
-               * broadcast destipaddr was received, or (3) there is an
-               * exact match between the srcipaddr and the bound remote IP
-               * address, then accept the packet.
-               */
+/****************************************************************************
+ * Name: udp_ipv6_match
+ *
+ * Description:
+ *   Check if the connection is the appropriate connection to be used with
+ *   the provided IPv6 and UDP headers.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static bool udp_ipv6_match(FAR struct udp_conn_s *conn, FAR void *iphdr,
+                           FAR struct udp_hdr_s *udp)
+{
+  FAR struct ipv6_hdr_s *ip = iphdr;
+
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * 1. The destination address is verified against the bound address
+   *    of the connection.
+   *
+   *    - The local port number is checked against the destination port
+   *      number in the received packet.
+   *    - If multiple network interfaces are supported, then the local
+   *      IP address is available and we will insist that the
+   *      destination IP matches the bound address. If a socket is bound
+   *      to INADDR6_ANY (laddr), then it should receive all packets
+   *      directed to the port. REVISIT: Should also depend on
+   *      SO_BROADCAST.
+   *
+   * 2. If this is a connection mode UDP socket, then the source address
+   *    is verified against the connected remote address.
+   *
+   *    - The remote port number is checked if the connection is bound
+   *      to a remote port.
+   *    - Finally, if the connection is bound to a remote IP address,
+   *      the source IP address of the packet is checked.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   *
+   * To send and receive multicast packets, the application should:
+   *
+   *   - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
+   *     or to a specific <multicast-address>
+   *   - setsockopt to SO_BROADCAST (for all-nodes address)
+   *
+   * For connection-less UDP sockets:
+   *
+   *   - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
+   *   - call recvfrom.
+   *
+   * For connection-mode UDP sockets:
+   *
+   *   - call connect() to connect the UDP socket to a specific remote
+   *     address, then
+   *   - Call send() with no address address information
+   *   - call recv() (from address information should not be needed)
+   *
+   * REVISIT: SO_BROADCAST flag is currently ignored.
+   */
+
+  /* Check that there is a local port number and this matches
+   * the port number in the destination address.
+   */
+
+  if ((conn->lport != 0 && udp->destport == conn->lport &&
 
-                  (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
+      /* Check if the local port accepts any address on this port or
+       * that there is an exact match between the destipaddr and the
+       * bound local address.  This catches the case of the all nodes
+       * multicast when the socket is bound to the IPv6 unspecified
+       * address.
+       */
+
+      (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+       net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr))))
+    {
+      /* Check if the socket is connection mode.  In this case, only
+       * packets with source addresses from the connected remote peer
+       * will be accepted.
+       */
+
+      if (_UDP_ISCONNECTMODE(conn->flags))
+        {
+          /* Check if the UDP connection is either (1) accepting packets
+           * from any port or (2) the packet srcport matches the local
+           * bound port number.
+           */
+
+          if ((conn->rport == 0 || udp->srcport == conn->rport) &&
+
+          /* If (1) not connected to a remote address, or (2) a all-
+           * nodes multicast destipaddr was received, or (3) there is an
+           * exact match between the srcipaddr and the bound remote IP
+           * address, then accept the packet.
+           */
+
+              (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_unspecaddr) ||
 #ifdef CONFIG_NET_BROADCAST
-                   net_ipv4addr_hdrcmp(ip->destipaddr, &bcast) ||
+               net_ipv6addr_hdrcmp(ip->destipaddr, g_ipv6_allnodes) ||
 #endif
-                   net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
-                {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
-                   */
-
-                  break;
-                }
-            }
-          else
+               net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
             {
-              /* This UDP socket is not connected.  We need to match only
-               * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
-               */
+              /* Matching connection found */
 
-              break;
+              return true;
             }
         }
+      else
+        {
+          /* This UDP socket is not connected.  We need to match only
+           * the destination address with the bound socket address.
+           */
 
-      /* Look at the next active connection */
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+/****************************************************************************
+ * Name: udp_flowhash
+ *
+ * Description:
+ *   Hash the source address (folded to 32 bits) and the ports of a datagram
+ *   so that all datagrams of one flow select the same SO_REUSEPORT socket.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_flowhash(uint32_t srcaddr, FAR struct udp_hdr_s *udp)
+{
+  uint32_t hash = srcaddr ^
+                  (((uint32_t)udp->srcport << 16) | udp->destport);
+
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 16);
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   'conn' is the first connection that matched the datagram and has
+ *   SO_REUSEPORT set.  Select one of all the SO_REUSEPORT connections that
+ *   match the datagram using the flow hash.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct udp_conn_s *conn, udp_match_t match,
+                       FAR void *iphdr, FAR struct udp_hdr_s *udp,
+                       uint32_t hash)
+{
+  FAR struct udp_conn_s *tmp;
+  uint32_t count = 0;
+
+  /* Count the members of the group.  Only connections after the first
+   * match can be members.
+   */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+  for (tmp = conn; tmp != NULL; tmp = UDP_BUCKET_NEXT(tmp))
+    {
+      if (_SO_GETOPT(tmp->sconn.s_options, SO_REUSEPORT) &&
+          match(tmp, iphdr, udp))
+        {
+          count++;
+        }
     }
 
-  return conn;
+  /* And pick one of them */
+
+  count = hash % count;
+  for (tmp = conn; tmp != NULL; tmp = UDP_BUCKET_NEXT(tmp))
+    {
+      if (_SO_GETOPT(tmp->sconn.s_options, SO_REUSEPORT) &&
+          match(tmp, iphdr, udp) && count-- == 0)
+        {
+          break;
+        }
+    }
+
+  return tmp;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_UDP_REUSEPORT */
 
 /****************************************************************************
- * Name: udp_ipv6_active
+ * Name: udp_ipv4_active
  *
  * Description:
  *   Find a connection structure that is the appropriate connection to be
@@ -327,128 +565,76 @@ static inline FAR struct udp_conn_s *
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
 static inline FAR struct udp_conn_s *
-  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
 {
-  FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn != NULL)
+  conn = UDP_BUCKET_HEAD(udp->destport);
+  while (conn != NULL && !udp_ipv4_match(conn, ip, udp))
     {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * 1. The destination address is verified against the bound address
-       *    of the connection.
-       *
-       *    - The local port number is checked against the destination port
-       *      number in the received packet.
-       *    - If multiple network interfaces are supported, then the local
-       *      IP address is available and we will insist that the
-       *      destination IP matches the bound address. If a socket is bound
-       *      to INADDR6_ANY (laddr), then it should receive all packets
-       *      directed to the port. REVISIT: Should also depend on
-       *      SO_BROADCAST.
-       *
-       * 2. If this is a connection mode UDP socket, then the source address
-       *    is verified against the connected remote address.
-       *
-       *    - The remote port number is checked if the connection is bound
-       *      to a remote port.
-       *    - Finally, if the connection is bound to a remote IP address,
-       *      the source IP address of the packet is checked.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       *
-       * To send and receive multicast packets, the application should:
-       *
-       *   - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
-       *     or to a specific <multicast-address>
-       *   - setsockopt to SO_BROADCAST (for all-nodes address)
-       *
-       * For connection-less UDP sockets:
-       *
-       *   - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
-       *   - call recvfrom.
-       *
-       * For connection-mode UDP sockets:
-       *
-       *   - call connect() to connect the UDP socket to a specific remote
-       *     address, then
-       *   - Call send() with no address address information
-       *   - call recv() (from address information should not be needed)
-       *
-       * REVISIT: SO_BROADCAST flag is currently ignored.
-       */
+      /* Look at the next active connection */
 
-      /* Check that there is a local port number and this matches
-       * the port number in the destination address.
-       */
+      conn = UDP_BUCKET_NEXT(conn);
+    }
 
-      if ((conn->lport != 0 && udp->destport == conn->lport &&
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  /* Spread the flows over all sockets sharing the port */
 
-          /* Check if the local port accepts any address on this port or
-           * that there is an exact match between the destipaddr and the
-           * bound local address.  This catches the case of the all nodes
-           * multicast when the socket is bound to the IPv6 unspecified
-           * address.
-           */
+  if (conn != NULL && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      conn = udp_reuseport_select(conn, udp_ipv4_match, ip, udp,
+               udp_flowhash(net_ip4addr_conv32(ip->srcipaddr), udp));
+    }
+#endif
 
-          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
-           net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr))))
-        {
-          /* Check if the socket is connection mode.  In this case, only
-           * packets with source addresses from the connected remote peer
-           * will be accepted.
-           */
+  return conn;
+}
+#endif /* CONFIG_NET_IPv4 */
 
-          if (_UDP_ISCONNECTMODE(conn->flags))
-            {
-              /* Check if the UDP connection is either (1) accepting packets
-               * from any port or (2) the packet srcport matches the local
-               * bound port number.
-               */
+/****************************************************************************
+ * Name: udp_ipv6_active
+ *
+ * Description:
+ *   Find a connection structure that is the appropriate connection to be
+ *   used within the provided UDP header
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
 
-              if ((conn->rport == 0 || udp->srcport == conn->rport) &&
+#ifdef CONFIG_NET_IPv6
+static inline FAR struct udp_conn_s *
+  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+{
+  FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct udp_conn_s *conn;
 
-              /* If (1) not connected to a remote address, or (2) a all-
-               * nodes multicast destipaddr was received, or (3) there is an
-               * exact match between the srcipaddr and the bound remote IP
-               * address, then accept the packet.
-               */
+  conn = UDP_BUCKET_HEAD(udp->destport);
+  while (conn != NULL && !udp_ipv6_match(conn, ip, udp))
+    {
+      /* Look at the next active connection */
 
-                  (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_unspecaddr) ||
-#ifdef CONFIG_NET_BROADCAST
-                   net_ipv6addr_hdrcmp(ip->destipaddr, g_ipv6_allnodes) ||
-#endif
-                   net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
-                {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
-                   */
-
-                  break;
-                }
-            }
-          else
-            {
-              /* This UDP socket is not connected.  We need to match only
-               * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
-               */
+      conn = UDP_BUCKET_NEXT(conn);
+    }
 
-              break;
-            }
-        }
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  /* Spread the flows over all sockets sharing the port */
 
-      /* Look at the next active connection */
+  if (conn != NULL && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      FAR uint16_t *src = ip->srcipaddr;
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_reuseport_select(conn, udp_ipv6_match, ip, udp,
+               udp_flowhash((((uint32_t)src[0] << 16) | src[1]) ^
+                            (((uint32_t)src[2] << 16) | src[3]) ^
+                            (((uint32_t)src[4] << 16) | src[5]) ^
+                            (((uint32_t)src[6] << 16) | src[7]), udp));
     }
+#endif
 
   return conn;
 }
@@ -684,8 +870,13 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  /* Unbind the port first, this takes the network lock which must not be
+   * acquired while holding g_free_lock.
+   */
+
+  udp_set_lport(conn, 0);
+
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
@@ -790,6 +981,62 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Bind the connection to a local port number (in network byte order) or
+ *   unbind it if the port number is zero.  This keeps the port hash table
+ *   in sync and must be used instead of assigning conn->lport directly.
+ *
+ ****************************************************************************/
+
+void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR struct udp_conn_s **link;
+
+  net_lock();
+
+  /* Remove the connection from the bucket of its old port */
+
+  if (conn->lport != 0)
+    {
+      for (link = &UDP_BUCKET_HEAD(conn->lport); *link != NULL;
+           link = &(*link)->hash_next)
+        {
+          if (*link == conn)
+            {
+              *link = conn->hash_next;
+              break;
+            }
+        }
+    }
+
+  /* Append it to the bucket of the new port.  Appending preserves the
+   * order in which the sockets were bound, lookups return the oldest match
+   * just like the active list does.
+   */
+
+  conn->lport     = portno;
+  conn->hash_next = NULL;
+
+  if (portno != 0)
+    {
+      for (link = &UDP_BUCKET_HEAD(portno); *link != NULL;
+           link = &(*link)->hash_next)
+        {
+        }
+
+      *link = conn;
+    }
+
+  net_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -865,7 +1112,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_set_lport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       ret         = OK;
     }
   else
@@ -894,7 +1141,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_set_lport(conn, portno);
           ret         = OK;
         }
       else
@@ -947,7 +1194,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_set_lport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
+#include <stddef.h>
 #include <string.h>
 #include <debug.h>
 #include <assert.h>
@@ -177,7 +178,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       iob_update_pktlen(dev->d_iob, dev->d_len);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum, unless the device does it. */
 
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
@@ -186,7 +187,12 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
            ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
 #endif
         {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
+          if (!netdev_offload_chksum(dev, IP_PROTO_UDP, IPv4_HDRLEN,
+                                     offsetof(struct udp_hdr_s, udpchksum),
+                                     0))
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -195,7 +201,12 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       else
 #endif
         {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
+          if (!netdev_offload_chksum(dev, IP_PROTO_UDP, IPv6_HDRLEN,
+                                     offsetof(struct udp_hdr_s, udpchksum),
+                                     0))
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv6 */
 
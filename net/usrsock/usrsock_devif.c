@@ -36,7 +36,7 @@
 #include <debug.h>
 
 #include <nuttx/random.h>
-#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
@@ -47,15 +47,22 @@
  * Private Types
  ****************************************************************************/
 
+/* A request waiting for its acknowledgment.  Requests of different
+ * connections are outstanding at the same time, each connection has at
+ * most one (see usrsock_setup_request_callback()).
+ */
+
+struct usrsock_ack_s
+{
+  sq_entry_t node;            /* Link in the list of outstanding requests */
+  sem_t      acksem;          /* Request acknowledgment notification */
+  uint32_t   ackxid;          /* Exchange id for which waiting ack */
+};
+
 struct usrsock_req_s
 {
-  mutex_t  lock;              /* Request mutex (only one outstanding
-                               * request) */
-  sem_t    acksem;            /* Request acknowledgment notification */
-  uint32_t newxid;            /* New transcation Id */
-  uint32_t ackxid;            /* Exchange id for which waiting ack */
-  uint16_t nbusy;             /* Number of requests blocked from different
-                               * threads */
+  uint32_t   newxid;          /* New transcation Id */
+  sq_queue_t acks;            /* Requests waiting for acknowledgment */
 
   /* Connection instance to receive data buffers. */
 
@@ -73,11 +80,11 @@ struct usrsock_req_s
 
 static struct usrsock_req_s g_usrsock_req =
 {
-  NXMUTEX_INITIALIZER,
-  SEM_INITIALIZER(0),
-  0,
-  0,
   0,
+  {
+    NULL,
+    NULL
+  },
   NULL
 };
 
@@ -188,6 +195,47 @@ out:
   return total;
 }
 
+/****************************************************************************
+ * Name: usrsock_ack_request
+ *
+ * Description:
+ *   Wake up the thread waiting for the acknowledgment of request 'xid'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool usrsock_ack_request(FAR struct usrsock_req_s *req, uint32_t xid)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *entry;
+
+  for (entry = sq_peek(&req->acks); entry != NULL; entry = sq_next(entry))
+    {
+      FAR struct usrsock_ack_s *ack = (FAR struct usrsock_ack_s *)entry;
+
+      if (ack->ackxid == xid)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&req->acks);
+            }
+          else
+            {
+              sq_remafter(prev, &req->acks);
+            }
+
+          nxsem_post(&ack->acksem);
+          return true;
+        }
+
+      prev = entry;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: usrsock_handle_event
  ****************************************************************************/
@@ -482,19 +530,13 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
       goto unlock_out;
     }
 
-  if (req->ackxid == hdr->xid)
-    {
-      req->ackxid = 0;
-      if (req_done)
-        {
-          *req_done = true;
-        }
-
-      /* Signal that request was received and read by daemon and
-       * acknowledgment response was received.
-       */
+  /* Signal that request was received and read by daemon and
+   * acknowledgment response was received.
+   */
 
-      nxsem_post(&req->acksem);
+  if (usrsock_ack_request(req, hdr->xid) && req_done)
+    {
+      *req_done = true;
     }
 
   conn->resp.events = hdr->head.events | USRSOCK_EVENT_REQ_COMPLETE;
@@ -534,6 +576,10 @@ static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
 
 /****************************************************************************
  * Name: usrsock_response() - handle usrsock request's ack/response
+ *
+ *   Only one message is handled per call, the number of bytes consumed is
+ *   returned.
+ *
  ****************************************************************************/
 
 ssize_t usrsock_response(FAR const char *buffer, size_t len,
@@ -633,6 +679,14 @@ ssize_t usrsock_iovec_put(FAR struct iovec *iov, int iovcnt, size_t pos,
 
 /****************************************************************************
  * Name: usrsock_do_request() - finish usrsock's request
+ *
+ *   The request buffers 'iov' are owned by the caller, so this waits until
+ *   the daemon has acknowledged the request.  Other connections may issue
+ *   their requests meanwhile: the requests are pipelined to the daemon.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
 int usrsock_do_request(FAR struct usrsock_conn_s *conn,
@@ -640,15 +694,13 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsock_request_common_s *req_head = NULL;
   FAR struct usrsock_req_s *req = &g_usrsock_req;
+  struct usrsock_ack_s ack;
   int ret;
 
   /* Get exchange id. */
 
   req_head = iov[0].iov_base;
 
-  /* Set outstanding request for daemon to handle. */
-
-  net_mutex_lock(&req->lock);
   if (++req->newxid == 0)
     {
       ++req->newxid;
@@ -661,25 +713,26 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
-  req->ackxid = req_head->xid;
+  /* Wait ack for request, the ack may arrive before usrsock_request()
+   * returns.
+   */
+
+  nxsem_init(&ack.acksem, 0, 0);
+  ack.ackxid = req_head->xid;
+  sq_addlast(&ack.node, &req->acks);
 
   ret = usrsock_request(iov, iovcnt);
   if (ret >= 0)
     {
-      /* Wait ack for request. */
-
-      ++req->nbusy; /* net_lock held. */
-      net_sem_wait_uninterruptible(&req->acksem);
-      --req->nbusy; /* net_lock held. */
+      net_sem_wait_uninterruptible(&ack.acksem);
     }
   else
     {
       nerr("error: usrsock request failed with %d\n", ret);
+      usrsock_ack_request(req, ack.ackxid);
     }
 
-  /* Free request line for next command. */
-
-  nxmutex_unlock(&req->lock);
+  nxsem_destroy(&ack.acksem);
   return ret;
 }
 
@@ -691,7 +744,7 @@ void usrsock_abort(void)
 {
   FAR struct usrsock_req_s *req = &g_usrsock_req;
   FAR struct usrsock_conn_s *conn = NULL;
-  int ret;
+  FAR struct usrsock_ack_s *ack;
 
   net_lock();
 
@@ -705,36 +758,15 @@ void usrsock_abort(void)
       usrsock_event(conn);
     }
 
-  do
-    {
-      /* Give other threads short time window to complete recently completed
-       * requests.
-       */
+  /* Wake-up pending requests. */
 
-      ret = net_mutex_timedlock(&req->lock, 10);
-      if (ret < 0)
-        {
-          if (ret != -ETIMEDOUT && ret != -EINTR)
-            {
-              ninfo("net_sem_timedwait errno: %d\n", ret);
-              DEBUGASSERT(false);
-            }
-        }
-      else
-        {
-          nxmutex_unlock(&req->lock);
-        }
-
-      /* Wake-up pending requests. */
-
-      if (req->nbusy == 0)
-        {
-          break;
-        }
-
-      nxsem_post(&req->acksem);
+  while ((ack = (FAR struct usrsock_ack_s *)sq_remfirst(&req->acks)) !=
+         NULL)
+    {
+      nxsem_post(&ack->acksem);
     }
-  while (true);
+
+  req->datain_conn = NULL;
 
   net_unlock();
 }
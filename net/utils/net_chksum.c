@@ -25,8 +25,140 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/endian.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The generic checksum sums whole machine words */
+
+#define CHKSUM_WORDSIZE  sizeof(uintptr_t)
+#define CHKSUM_WORDMASK  (CHKSUM_WORDSIZE - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_add
+ *
+ * Description:
+ *   Add two 16-bit values in one's complement arithmetic.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_add(uint16_t sum, uint16_t val)
+{
+  sum += val;
+  return sum < val ? sum + 1 : sum;
+}
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Return the one's complement sum of the data taken as 16-bit words in
+ *   the native byte order, folded to 16 bits.  The one's complement sum
+ *   does not depend on the byte order (RFC 1071), so a machine word at a
+ *   time can be accumulated with an end around carry.
+ *
+ * Assumptions:
+ *   'data' is 16-bit aligned.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t chksum_native(FAR const uint8_t *data, size_t len)
+{
+  FAR const uintptr_t *word;
+  uintptr_t acc = 0;
+  uint32_t sum;
+
+  /* Sum up 16-bit words until 'data' is word aligned */
+
+  while (((uintptr_t)data & CHKSUM_WORDMASK) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* The main loop, four words per iteration */
+
+  word = (FAR const uintptr_t *)data;
+  while (len >= 4 * CHKSUM_WORDSIZE)
+    {
+      acc += word[0];
+      acc += acc < word[0];
+      acc += word[1];
+      acc += acc < word[1];
+      acc += word[2];
+      acc += acc < word[2];
+      acc += word[3];
+      acc += acc < word[3];
+
+      word += 4;
+      len  -= 4 * CHKSUM_WORDSIZE;
+    }
+
+  while (len >= CHKSUM_WORDSIZE)
+    {
+      acc += *word;
+      acc += acc < *word;
+
+      word++;
+      len -= CHKSUM_WORDSIZE;
+    }
+
+  /* The remaining 16-bit words and the last odd byte, which is the first
+   * byte of a zero padded word.
+   */
+
+  data = (FAR const uint8_t *)word;
+  while (len >= 2)
+    {
+      uint16_t val = *(FAR const uint16_t *)data;
+
+      acc  += val;
+      acc  += acc < val;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      uint16_t val = (uint16_t)data[0] << 8;
+#else
+      uint16_t val = data[0];
+#endif
+
+      acc += val;
+      acc += acc < val;
+    }
+
+  /* Fold the accumulator to 16 bits */
+
+#if UINTPTR_MAX > UINT32_MAX
+  acc = (acc & UINT32_MAX) + (acc >> 32);
+  acc = (acc & UINT32_MAX) + (acc >> 32);
+#endif
+
+  sum = acc;
+#if UINTPTR_MAX > UINT16_MAX
+  sum = (sum & UINT16_MAX) + (sum >> 16);
+  sum = (sum & UINT16_MAX) + (sum >> 16);
+#endif
+
+  return sum;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -53,40 +185,36 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
+  uint16_t native;
 
-  while (dataptr < last_byte)
+  if (len == 0)
     {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      return sum;
     }
 
-  if (dataptr == last_byte)
+  if (((uintptr_t)data & 1) != 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      /* The first byte is the high byte of a word in network order.  The
+       * rest of the data is aligned, but has its bytes summed up in the
+       * opposite lanes.
+       */
+
+#ifdef CONFIG_ENDIAN_BIG
+      native = chksum_add((uint16_t)data[0] << 8,
+                          __swap_uint16(chksum_native(data + 1, len - 1)));
+#else
+      native = chksum_add(data[0],
+                          __swap_uint16(chksum_native(data + 1, len - 1)));
+#endif
+    }
+  else
+    {
+      native = chksum_native(data, len);
     }
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_add(sum, NTOHS(native));
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -111,6 +239,8 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 #ifdef CONFIG_MM_IOB
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 {
+  bool odd = false;
+
   /* Skip to the I/O buffer containing the data offset */
 
   while (iob != NULL && offset > iob->io_len)
@@ -125,8 +255,18 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 
   while (iob != NULL)
     {
-      sum = chksum(sum, iob->io_data + iob->io_offset + offset,
-                   iob->io_len - offset);
+      uint16_t len = iob->io_len - offset;
+      uint16_t part;
+
+      part = chksum(0, iob->io_data + iob->io_offset + offset, len);
+
+      /* After an odd number of bytes, the data of this buffer starts in
+       * the low byte of a word.
+       */
+
+      sum = chksum_add(sum, odd ? __swap_uint16(part) : part);
+      odd ^= (len & 1) != 0;
+
       iob = iob->io_flink;
       offset = 0;
     }
@@ -37,6 +37,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "utils/utils.h"
 
@@ -139,7 +140,32 @@ _net_timedwait(sem_t *sem, bool interruptible, unsigned int timeout)
 
 int net_lock(void)
 {
+#ifdef CONFIG_NET_STATISTICS
+  clock_t start;
+  int ret;
+
+  /* Count the acquisitions that had to wait for another holder */
+
+  ret = nxrmutex_trylock(&g_netlock);
+  if (ret >= 0)
+    {
+      g_netstats.lock.acquired++;
+      return ret;
+    }
+
+  start = clock_systime_ticks();
+  ret   = nxrmutex_lock(&g_netlock);
+  if (ret >= 0)
+    {
+      g_netstats.lock.acquired++;
+      g_netstats.lock.contended++;
+      g_netstats.lock.waitticks += clock_systime_ticks() - start;
+    }
+
+  return ret;
+#else
   return nxrmutex_lock(&g_netlock);
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,336 @@
+/****************************************************************************
+ * net/utils/net_rxring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_RXRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offsets in a frame of the ring */
+
+#define RXRING_ADDROFF   TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+#define RXRING_MACOFF    TPACKET_ALIGN(TPACKET_HDRLEN)
+
+/* Orders the content of a frame before its status for an application
+ * polling the ring on another CPU.
+ */
+
+#ifdef CONFIG_SMP
+#  define RXRING_DMB()     SP_DMB()
+#else
+#  define RXRING_DMB()
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rxring_frame
+ *
+ * Description:
+ *   Return the header of the frame 'ndx'.  The status of a frame is
+ *   changed by the application at any time.
+ *
+ ****************************************************************************/
+
+static inline FAR volatile struct tpacket_hdr *
+net_rxring_frame(FAR struct net_rxring_s *ring, uint32_t ndx)
+{
+  return (FAR volatile struct tpacket_hdr *)
+         (ring->base + ndx * ring->frame_size);
+}
+
+/****************************************************************************
+ * Name: net_rxring_prev
+ *
+ * Description:
+ *   Return the index of the frame written last.
+ *
+ ****************************************************************************/
+
+static inline uint32_t net_rxring_prev(FAR struct net_rxring_s *ring)
+{
+  return ring->head == 0 ? ring->frame_nr - 1 : ring->head - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rxring_setup
+ *
+ * Description:
+ *   Set up the receive ring described by the struct tpacket_req in
+ *   'value', as requested with the PACKET_RX_RING socket option.  A request
+ *   for zero frames releases the ring.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY is
+ *   returned if a ring is set up already.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_rxring_setup(FAR struct net_rxring_s *ring, FAR const void *value,
+                     socklen_t value_len)
+{
+  FAR const struct tpacket_req *req = value;
+  FAR uint8_t *base;
+
+  if (value == NULL || value_len < sizeof(struct tpacket_req))
+    {
+      return -EINVAL;
+    }
+
+  if (req->tp_frame_nr == 0)
+    {
+      net_rxring_free(ring);
+      return OK;
+    }
+
+  if (ring->base != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (req->tp_frame_size <= RXRING_MACOFF ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_block_size == 0 ||
+      req->tp_block_size % req->tp_frame_size != 0 ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size ||
+      req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                          req->tp_block_nr)
+    {
+      return -EINVAL;
+    }
+
+  /* All frames start with TP_STATUS_KERNEL */
+
+  base = kmm_zalloc((size_t)req->tp_block_size * req->tp_block_nr);
+  if (base == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->base       = base;
+  ring->size       = (size_t)req->tp_block_size * req->tp_block_nr;
+  ring->frame_size = req->tp_frame_size;
+  ring->frame_nr   = req->tp_frame_nr;
+  ring->head       = 0;
+  ring->losing     = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: net_rxring_free
+ *
+ * Description:
+ *   Release the receive ring, if any.  Mappings of the ring must not be
+ *   used any more.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void net_rxring_free(FAR struct net_rxring_s *ring)
+{
+  if (ring->base != NULL)
+    {
+      kmm_free(ring->base);
+      ring->base = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: net_rxring_input
+ *
+ * Description:
+ *   Write the packet received by 'dev' into the next frame of the ring.
+ *   The packet starts at d_buf with the link layer header, which is
+ *   followed by the rest of the packet in d_iob.  The packet is truncated
+ *   to the size of the frame.
+ *
+ * Input Parameters:
+ *   ring   - The receive ring
+ *   dev    - The device holding the received packet
+ *   addr   - The address to store along with the packet
+ *   netoff - The offset of the network header in the packet
+ *
+ * Returned Value:
+ *   One (1) if the application has to be woken up, because it had
+ *   consumed all frames before.  Zero if it has not, so that packets that
+ *   arrive in a batch cause only one wakeup.  -ENOBUFS if the packet was
+ *   dropped because the application still owns the frame.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_rxring_input(FAR struct net_rxring_s *ring,
+                     FAR struct net_driver_s *dev,
+                     FAR const struct sockaddr_ll *addr, uint16_t netoff)
+{
+  FAR volatile struct tpacket_hdr *hdr;
+  FAR uint8_t *frame;
+  struct timespec ts;
+  unsigned int llhdrlen;
+  unsigned int snaplen;
+  bool wakeup;
+
+  hdr = net_rxring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* The ring is full, tell about the loss with the next packet */
+
+      ring->losing = true;
+      return -ENOBUFS;
+    }
+
+  wakeup = ring->frame_nr == 1 ||
+           net_rxring_frame(ring, net_rxring_prev(ring))->tp_status ==
+           TP_STATUS_KERNEL;
+
+  /* Copy the packet */
+
+  frame    = (FAR uint8_t *)hdr;
+  llhdrlen = MIN(NET_LL_HDRLEN(dev), dev->d_len);
+  snaplen  = MIN(dev->d_len, ring->frame_size - RXRING_MACOFF);
+
+  memcpy(frame + RXRING_MACOFF, dev->d_buf, MIN(llhdrlen, snaplen));
+  if (snaplen > llhdrlen)
+    {
+      iob_copyout(frame + RXRING_MACOFF + llhdrlen, dev->d_iob,
+                  snaplen - llhdrlen, 0);
+    }
+
+  memcpy(frame + RXRING_ADDROFF, addr, sizeof(struct sockaddr_ll));
+
+#ifdef CONFIG_NET_TIMESTAMP
+  if (dev->d_rxtime.tv_sec != 0 || dev->d_rxtime.tv_nsec != 0)
+    {
+      ts = dev->d_rxtime;
+    }
+  else
+#endif
+    {
+      clock_systime_timespec(&ts);
+    }
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = RXRING_MACOFF;
+  hdr->tp_net     = RXRING_MACOFF + netoff;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  /* Hand the frame over only once its content is complete */
+
+  RXRING_DMB();
+  hdr->tp_status = ring->losing ? TP_STATUS_USER | TP_STATUS_LOSING :
+                                  TP_STATUS_USER;
+  ring->losing   = false;
+
+  if (++ring->head >= ring->frame_nr)
+    {
+      ring->head = 0;
+    }
+
+  return wakeup ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: net_rxring_ready
+ *
+ * Description:
+ *   Return true if the application did not consume the frame written last.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool net_rxring_ready(FAR struct net_rxring_s *ring)
+{
+  return ring->base != NULL &&
+         net_rxring_frame(ring, net_rxring_prev(ring))->tp_status !=
+         TP_STATUS_KERNEL;
+}
+
+/****************************************************************************
+ * Name: net_rxring_mmap
+ *
+ * Description:
+ *   Map the receive ring to the application.  The ring memory is
+ *   returned directly, so that the application sees the frames as the
+ *   network writes them.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if there is no ring or the mapping is out
+ *   of the ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_rxring_mmap(FAR struct net_rxring_s *ring,
+                    FAR struct mm_map_entry_s *map)
+{
+  if (ring->base == NULL || map->offset < 0 ||
+      map->offset >= ring->size || map->length > ring->size - map->offset)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = ring->base + map->offset;
+  return OK;
+}
+
+#endif /* CONFIG_NET_RXRING */
@@ -43,6 +43,23 @@ enum tv2ds_remainder_e
   TV2DS_CEIL       /* Force to next larger full decisecond */
 };
 
+#ifdef CONFIG_NET_RXRING
+/* A receive ring of frames shared with the application through mmap(), as
+ * set up with the PACKET_RX_RING socket option.  Each frame starts with a
+ * struct tpacket_hdr whose tp_status tells who owns the frame.
+ */
+
+struct net_rxring_s
+{
+  FAR uint8_t *base;        /* The ring memory, NULL if no ring */
+  size_t size;              /* Size of the ring memory */
+  uint32_t frame_size;      /* Size of one frame */
+  uint32_t frame_nr;        /* Number of frames */
+  uint32_t head;            /* The next frame to be written */
+  bool losing;              /* Packets were dropped since the last frame */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -61,6 +78,8 @@ extern "C"
 
 struct net_driver_s;      /* Forward reference */
 struct timeval;           /* Forward reference */
+struct sockaddr_ll;       /* Forward reference */
+struct mm_map_entry_s;    /* Forward reference */
 
 /****************************************************************************
  * Name: net_breaklock
@@ -339,6 +358,31 @@ uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 FAR void *cmsg_append(FAR struct msghdr *msg, int level, int type,
                       FAR void *value, int value_len);
 
+/****************************************************************************
+ * Name: net_rxring_setup, net_rxring_free, net_rxring_input,
+ *       net_rxring_ready and net_rxring_mmap
+ *
+ * Description:
+ *   Manage the memory mapped receive ring of a socket.  See
+ *   net/utils/net_rxring.c.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RXRING
+int net_rxring_setup(FAR struct net_rxring_s *ring, FAR const void *value,
+                     socklen_t value_len);
+void net_rxring_free(FAR struct net_rxring_s *ring);
+int net_rxring_input(FAR struct net_rxring_s *ring,
+                     FAR struct net_driver_s *dev,
+                     FAR const struct sockaddr_ll *addr, uint16_t netoff);
+bool net_rxring_ready(FAR struct net_rxring_s *ring);
+int net_rxring_mmap(FAR struct net_rxring_s *ring,
+                    FAR struct mm_map_entry_s *map);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -29,6 +29,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+
 #include "clock/clock.h"
 
 /****************************************************************************
@@ -69,6 +71,18 @@ int clock_getres(clockid_t clock_id, struct timespec *res)
         sinfo("Returning res=(%d,%d)\n", (int)res->tv_sec,
                                          (int)res->tv_nsec);
         break;
+
+#ifdef CONFIG_SCHED_CPUTIME
+      case CLOCK_PROCESS_CPUTIME_ID:
+      case CLOCK_THREAD_CPUTIME_ID:
+
+        /* The period of the up_perf_gettime() counter, rounded up */
+
+        res->tv_sec  = 0;
+        res->tv_nsec = (NSEC_PER_SEC + up_perf_getfreq() - 1) /
+                       up_perf_getfreq();
+        break;
+#endif
     }
 
   return ret;
@@ -37,6 +37,73 @@
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 #  include "clock/clock_timekeeping.h"
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+#  include "sched/sched.h"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+struct clock_cputime_s
+{
+  FAR struct task_group_s *group;
+  uint64_t cputime;
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_cputime_handler
+ *
+ * Description:
+ *   Add the CPU time of a thread of the group to the total.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static void clock_cputime_handler(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct clock_cputime_s *info = arg;
+
+  if (tcb->group == info->group)
+    {
+      info->cputime += nxsched_get_cputime(tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: clock_cputime
+ *
+ * Description:
+ *   Return the CPU time of the calling thread or of its task group.  The
+ *   time of the threads of the group that exited is not accounted.
+ *
+ ****************************************************************************/
+
+static void clock_cputime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  struct clock_cputime_s info;
+
+  if (clock_id == CLOCK_THREAD_CPUTIME_ID)
+    {
+      info.cputime = nxsched_get_cputime(this_task());
+    }
+  else
+    {
+      info.group   = this_task()->group;
+      info.cputime = 0;
+      nxsched_foreach(clock_cputime_handler, &info);
+    }
+
+  tp->tv_sec  = info.cputime / NSEC_PER_SEC;
+  tp->tv_nsec = info.cputime % NSEC_PER_SEC;
+}
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -131,6 +198,19 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
         }
 #endif /* CONFIG_CLOCK_TIMEKEEPING */
     }
+
+#ifdef CONFIG_SCHED_CPUTIME
+  /* CLOCK_THREAD_CPUTIME_ID and CLOCK_PROCESS_CPUTIME_ID - The CPU time
+   * used by the calling thread or by all of the threads of its process.
+   */
+
+  else if (clock_id == CLOCK_THREAD_CPUTIME_ID ||
+           clock_id == CLOCK_PROCESS_CPUTIME_ID)
+    {
+      clock_cputime(clock_id, tp);
+    }
+#endif
+
   else
     {
       ret = -EINVAL;
@@ -27,6 +27,7 @@
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 
 #include <sys/time.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <time.h>
 #include <errno.h>
@@ -52,38 +53,83 @@ static uint64_t        g_clock_last_counter;
 static uint64_t        g_clock_mask;
 static long            g_clock_adjust;
 
+/* Sequence count of g_clock_wall_time and g_clock_last_counter:  odd while
+ * they are being updated.  The updates are serialized by the critical
+ * section, the readers take none and retry if the count changed under
+ * them.
+ */
+
+static atomic_uint     g_clock_seq;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: clock_write_begin and clock_write_end
+ *
+ * Description:
+ *   Bracket an update of the time base, within the critical section.
+ *
+ ****************************************************************************/
+
+static inline void clock_write_begin(void)
+{
+  atomic_store_explicit(&g_clock_seq,
+                        atomic_load_explicit(&g_clock_seq,
+                                             memory_order_relaxed) + 1,
+                        memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+static inline void clock_write_end(void)
+{
+  atomic_store_explicit(&g_clock_seq,
+                        atomic_load_explicit(&g_clock_seq,
+                                             memory_order_relaxed) + 1,
+                        memory_order_release);
+}
+
 /****************************************************************************
  * Name: clock_get_current_time
  ****************************************************************************/
 
-static int clock_get_current_time(FAR struct timespec *ts,
-                                  FAR struct timespec *base)
+static int clock_get_current_time(FAR struct timespec *ts)
 {
-  irqstate_t flags;
+  struct timespec base;
   uint64_t counter;
   uint64_t offset;
+  uint64_t last;
   uint64_t nsec;
+  unsigned int seq;
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  /* Sample the counter together with the base it is relative to */
 
-  ret = up_timer_gettick(&counter);
-  if (ret < 0)
+  do
     {
-      goto errout_in_critical_section;
+      seq  = atomic_load_explicit(&g_clock_seq, memory_order_acquire);
+      base = g_clock_wall_time;
+      last = g_clock_last_counter;
+
+      ret = up_timer_gettick(&counter);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      atomic_thread_fence(memory_order_acquire);
     }
+  while ((seq & 1) != 0 ||
+         seq != atomic_load_explicit(&g_clock_seq, memory_order_relaxed));
 
-  offset = (counter - g_clock_last_counter) & g_clock_mask;
+  offset = (counter - last) & g_clock_mask;
   nsec   = offset * NSEC_PER_TICK;
   sec    = nsec   / NSEC_PER_SEC;
   nsec  -= sec    * NSEC_PER_SEC;
 
-  nsec  += base->tv_nsec;
+  nsec  += base.tv_nsec;
   if (nsec >= NSEC_PER_SEC)
     {
       nsec -= NSEC_PER_SEC;
@@ -91,10 +137,8 @@ static int clock_get_current_time(FAR struct timespec *ts,
     }
 
   ts->tv_nsec = nsec;
-  ts->tv_sec = base->tv_sec + sec;
+  ts->tv_sec = base.tv_sec + sec;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
   return ret;
 }
 
@@ -108,7 +152,7 @@ errout_in_critical_section:
 
 int clock_timekeeping_get_wall_time(FAR struct timespec *ts)
 {
-  return clock_get_current_time(ts, &g_clock_wall_time);
+  return clock_get_current_time(ts);
 }
 
 /****************************************************************************
@@ -129,11 +173,15 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
       goto errout_in_critical_section;
     }
 
+  clock_write_begin();
+
   memcpy(&g_clock_wall_time, ts, sizeof(struct timespec));
 
   g_clock_adjust       = 0;
   g_clock_last_counter = counter;
 
+  clock_write_end();
+
 errout_in_critical_section:
   leave_critical_section(flags);
   return ret;
@@ -263,11 +311,15 @@ void clock_update_wall_time(void)
         }
     }
 
+  clock_write_begin();
+
   g_clock_wall_time.tv_sec += sec;
   g_clock_wall_time.tv_nsec = (long)nsec;
 
   g_clock_last_counter = counter;
 
+  clock_write_end();
+
 errout_in_critical_section:
   leave_critical_section(flags);
 }
@@ -280,6 +332,8 @@ void clock_inittimekeeping(FAR const struct timespec *tp)
 {
   up_timer_getmask(&g_clock_mask);
 
+  clock_write_begin();
+
   if (tp)
     {
       memcpy(&g_clock_wall_time, tp, sizeof(struct timespec));
@@ -290,6 +344,8 @@ void clock_inittimekeeping(FAR const struct timespec *tp)
     }
 
   up_timer_gettick(&g_clock_last_counter);
+
+  clock_write_end();
 }
 
 #endif /* CONFIG_CLOCK_TIMEKEEPING */
@@ -0,0 +1,290 @@
+/****************************************************************************
+ * sched/futex/futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <sys/futex.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FUTEX_HASH_SIZE      (1 << CONFIG_FUTEX_HASH_BITS)
+
+/* Multiplicative hash of the word address (the low two bits are always
+ * zero for an aligned futex word).
+ */
+
+#define FUTEX_HASH(a)        ((((uint32_t)(uintptr_t)(a) >> 2) * \
+                               0x9e3779b1u) >> (32 - CONFIG_FUTEX_HASH_BITS))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One of these lives on the stack of each thread waiting on a futex */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                      /* Link in the hash bucket */
+  FAR volatile uint32_t *uaddr;         /* Futex word, NULL once woken */
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct task_group_s *group;       /* Address environment of uaddr */
+#endif
+  sem_t sem;                            /* Wait semaphore */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Waiting threads hashed by futex address.  Protected by the critical
+ * section.
+ */
+
+static dq_queue_t g_futex_hash[FUTEX_HASH_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_match
+ *
+ * Description:
+ *   Return true if the waiter is blocked on 'uaddr' of the address
+ *   environment of the calling thread.
+ *
+ ****************************************************************************/
+
+static inline bool futex_match(FAR struct futex_waiter_s *waiter,
+                               FAR volatile uint32_t *uaddr)
+{
+#ifdef CONFIG_ARCH_ADDRENV
+  if (waiter->group != this_task()->group)
+    {
+      return false;
+    }
+#endif
+
+  return waiter->uaddr == uaddr;
+}
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Block the calling thread on 'uaddr' as long as it contains 'val'.
+ *
+ ****************************************************************************/
+
+static int futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+                      FAR const struct timespec *timeout)
+{
+  struct futex_waiter_s waiter;
+  sclock_t ticks = 0;
+  irqstate_t flags;
+  int ret;
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      clock_time2ticks(timeout, &ticks);
+    }
+
+  waiter.uaddr = uaddr;
+#ifdef CONFIG_ARCH_ADDRENV
+  waiter.group = this_task()->group;
+#endif
+  nxsem_init(&waiter.sem, 0, 0);
+
+  /* The value check and the enqueue must be atomic with respect to
+   * futex_wake():  a waker that changes the word first and then wakes up
+   * the waiters can never be missed.
+   */
+
+  flags = enter_critical_section();
+
+  if (*uaddr != val)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+  if (timeout != NULL && ticks <= 0)
+    {
+      ret = -ETIMEDOUT;
+      goto out;
+    }
+
+  dq_addlast(&waiter.node, &g_futex_hash[FUTEX_HASH(uaddr)]);
+
+  if (timeout != NULL)
+    {
+      ret = nxsem_tickwait(&waiter.sem, ticks);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  /* A waker removes the waiter from the bucket before posting.  If it is
+   * still queued the wait was ended by a timeout or a signal.
+   */
+
+  if (waiter.uaddr != NULL)
+    {
+      dq_rem(&waiter.node, &g_futex_hash[FUTEX_HASH(uaddr)]);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+out:
+  leave_critical_section(flags);
+  nxsem_destroy(&waiter.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up at most 'count' threads blocked on 'uaddr'.
+ *
+ ****************************************************************************/
+
+static int futex_wake(FAR volatile uint32_t *uaddr, uint32_t count)
+{
+  FAR dq_queue_t *bucket = &g_futex_hash[FUTEX_HASH(uaddr)];
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  irqstate_t flags;
+  int nwoken = 0;
+
+  flags = enter_critical_section();
+
+  for (node = dq_peek(bucket); node != NULL; node = next)
+    {
+      if ((uint32_t)nwoken >= count)
+        {
+          break;
+        }
+
+      next   = dq_next(node);
+      waiter = container_of(node, struct futex_waiter_s, node);
+
+      if (futex_match(waiter, uaddr))
+        {
+          dq_rem(node, bucket);
+          waiter->uaddr = NULL;
+          nxsem_post(&waiter->sem);
+          nwoken++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex
+ *
+ * Description:
+ *   Wait on or wake up a 32-bit user space word.  Only the contended paths
+ *   of the user space synchronization objects need to enter the kernel;
+ *   the uncontended paths are handled with atomic operations on the word.
+ *
+ * Input Parameters:
+ *   uaddr   - Address of the aligned futex word
+ *   op      - FUTEX_WAIT or FUTEX_WAKE, optionally with FUTEX_PRIVATE_FLAG
+ *   val     - Expected value (FUTEX_WAIT) or number of waiters to wake up
+ *             (FUTEX_WAKE)
+ *   timeout - Relative timeout of FUTEX_WAIT or NULL to wait forever
+ *
+ * Returned Value:
+ *   See include/sys/futex.h
+ *
+ ****************************************************************************/
+
+int futex(FAR volatile uint32_t *uaddr, int op, uint32_t val,
+          FAR const struct timespec *timeout)
+{
+  int ret;
+
+  if (uaddr == NULL || ((uintptr_t)uaddr & 3) != 0)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      switch (op & FUTEX_CMD_MASK)
+        {
+          case FUTEX_WAIT:
+            ret = futex_wait(uaddr, val, timeout);
+            break;
+
+          case FUTEX_WAKE:
+            ret = futex_wake(uaddr, val);
+            break;
+
+          default:
+            ret = -ENOSYS;
+            break;
+        }
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_FUTEX */
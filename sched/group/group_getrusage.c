@@ -0,0 +1,112 @@
+/****************************************************************************
+ * sched/group/group_getrusage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/resource.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sched/sched.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct group_rusage_s
+{
+  FAR struct task_group_s *group;
+  FAR struct rusage *usage;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: group_rusage_handler
+ *
+ * Description:
+ *   Add the counters of a thread of the group to the totals.
+ *
+ ****************************************************************************/
+
+static void group_rusage_handler(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct group_rusage_s *info = arg;
+
+  if (tcb->group == info->group)
+    {
+      info->usage->ru_nvcsw  += tcb->nvcsw;
+      info->usage->ru_nivcsw += tcb->nivcsw;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getrusage
+ *
+ * Description:
+ *   The getrusage() function shall provide measures of the resources used
+ *   by the current process or its terminated and waited-for child processes.
+ *
+ *   With RUSAGE_SELF, the context switch counts are the sums over the
+ *   threads of the calling task group that are still alive.  The resources
+ *   of the children are not accounted and read as zero.
+ *
+ * Input Parameters:
+ *   who     - RUSAGE_SELF or RUSAGE_CHILDREN
+ *   r_usage - The location to return the measures
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) with errno set to EINVAL if who or
+ *   r_usage are invalid.
+ *
+ ****************************************************************************/
+
+int getrusage(int who, FAR struct rusage *r_usage)
+{
+  struct group_rusage_s info;
+
+  if (r_usage == NULL || (who != RUSAGE_SELF && who != RUSAGE_CHILDREN))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  memset(r_usage, 0, sizeof(*r_usage));
+
+  if (who == RUSAGE_SELF)
+    {
+      info.group = this_task()->group;
+      info.usage = r_usage;
+
+      nxsched_foreach(group_rusage_handler, &info);
+    }
+
+  return OK;
+}
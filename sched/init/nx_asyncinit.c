@@ -0,0 +1,280 @@
+/****************************************************************************
+ * sched/init/nx_asyncinit.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/init.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nx_asyncinit_s
+{
+  FAR const char *name;             /* Name of the call, NULL if free */
+  FAR const char *after;            /* The call it must wait for, or NULL */
+  CODE int      (*func)(FAR void *arg);
+  FAR void       *arg;
+  int             result;           /* What func() returned */
+  sem_t           done;             /* Posted once func() returned */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nx_asyncinit_s g_asyncinit[CONFIG_SCHED_ASYNCINIT_NCALLS];
+static mutex_t g_asyncinit_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_async_find
+ ****************************************************************************/
+
+static FAR struct nx_asyncinit_s *nx_async_find(FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_ASYNCINIT_NCALLS; i++)
+    {
+      if (g_asyncinit[i].name != NULL &&
+          strcmp(g_asyncinit[i].name, name) == 0)
+        {
+          return &g_asyncinit[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nx_async_waitfor
+ *
+ * Description:
+ *   Wait for one call and return its result.  The semaphore is posted
+ *   again for the other waiters.
+ *
+ ****************************************************************************/
+
+static int nx_async_waitfor(FAR struct nx_asyncinit_s *call)
+{
+  nxsem_wait_uninterruptible(&call->done);
+  nxsem_post(&call->done);
+  return call->result;
+}
+
+/****************************************************************************
+ * Name: nx_async_thread
+ ****************************************************************************/
+
+static int nx_async_thread(int argc, FAR char **argv)
+{
+  FAR struct nx_asyncinit_s *call = (FAR struct nx_asyncinit_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 0));
+  int ret;
+
+  if (call->after != NULL)
+    {
+      ret = nx_async_wait(call->after);
+      if (ret < 0)
+        {
+          serr("ERROR: %s: %s failed: %d\n", call->name, call->after, ret);
+        }
+    }
+
+  ret = call->func(call->arg);
+  if (ret < 0)
+    {
+      serr("ERROR: %s failed: %d\n", call->name, ret);
+    }
+
+  call->result = ret;
+  nx_bootmark(call->name);
+  nxsem_post(&call->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_async_init
+ *
+ * Description:
+ *   Run an initialization call on its own kernel thread, so that calls that
+ *   wait for hardware (mounting an SD card, probing sensors, negotiating a
+ *   PHY link...) overlap instead of adding up.  If 'after' names another
+ *   call, this one starts once that one returned, even if it failed.  The
+ *   application is started only once all the calls registered before
+ *   board_late_initialize() returned.
+ *
+ * Input Parameters:
+ *   name  - Unique name of the call, also that of its thread and boot
+ *           profile mark.  Only the pointer is kept.
+ *   func  - The initialization function
+ *   arg   - Its argument
+ *   after - The name of a call registered earlier to wait for, or NULL
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the call can't be started.
+ *
+ ****************************************************************************/
+
+int nx_async_init(FAR const char *name, CODE int (*func)(FAR void *arg),
+                  FAR void *arg, FAR const char *after)
+{
+  FAR struct nx_asyncinit_s *call = NULL;
+  FAR char *argv[2];
+  char args[32];
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&g_asyncinit_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (nx_async_find(name) != NULL ||
+      (after != NULL && nx_async_find(after) == NULL))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_ASYNCINIT_NCALLS; i++)
+    {
+      if (g_asyncinit[i].name == NULL)
+        {
+          call = &g_asyncinit[i];
+          break;
+        }
+    }
+
+  if (call == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  call->name   = name;
+  call->after  = after;
+  call->func   = func;
+  call->arg    = arg;
+  call->result = 0;
+  nxsem_init(&call->done, 0, 0);
+
+  snprintf(args, sizeof(args), "0x%" PRIxPTR, (uintptr_t)call);
+  argv[0] = args;
+  argv[1] = NULL;
+
+  ret = kthread_create(name, CONFIG_SCHED_ASYNCINIT_PRIORITY,
+                       CONFIG_SCHED_ASYNCINIT_STACKSIZE,
+                       nx_async_thread, argv);
+  if (ret < 0)
+    {
+      nxsem_destroy(&call->done);
+      call->name = NULL;
+      goto errout;
+    }
+
+  ret = OK;
+
+errout:
+  nxmutex_unlock(&g_asyncinit_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_async_wait
+ *
+ * Description:
+ *   Wait until an initialization call started by nx_async_init() returned.
+ *
+ * Input Parameters:
+ *   name - The name of the call, or NULL for all the calls registered so
+ *          far
+ *
+ * Returned Value:
+ *   What the call returned, or the first error of all the calls; -ENOENT
+ *   if there is no call of that name.
+ *
+ ****************************************************************************/
+
+int nx_async_wait(FAR const char *name)
+{
+  FAR struct nx_asyncinit_s *call;
+  int result = OK;
+  int ret;
+  int i;
+
+  if (name != NULL)
+    {
+      nxmutex_lock(&g_asyncinit_lock);
+      call = nx_async_find(name);
+      nxmutex_unlock(&g_asyncinit_lock);
+
+      return call != NULL ? nx_async_waitfor(call) : -ENOENT;
+    }
+
+  /* The entries in use are never freed, so they can be waited for once
+   * the lock is released.
+   */
+
+  for (i = 0; i < CONFIG_SCHED_ASYNCINIT_NCALLS; i++)
+    {
+      nxmutex_lock(&g_asyncinit_lock);
+      call = g_asyncinit[i].name != NULL ? &g_asyncinit[i] : NULL;
+      nxmutex_unlock(&g_asyncinit_lock);
+
+      if (call != NULL)
+        {
+          ret = nx_async_waitfor(call);
+          if (ret < 0 && result == OK)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  return result;
+}
+
+#endif /* CONFIG_SCHED_ASYNCINIT */
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * sched/init/nx_bootprofile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_SCHED_BOOTPROFILE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nx_bootmark_s
+{
+  FAR const char *phase;  /* Name of the phase that ended */
+  unsigned long   time;   /* up_perf_gettime() at its end */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nx_bootmark_s g_bootmarks[CONFIG_SCHED_BOOTPROFILE_NPHASES];
+static unsigned int g_nbootmarks;
+static spinlock_t g_bootlock;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootmark
+ *
+ * Description:
+ *   Record the end of a boot phase.  The marks past
+ *   CONFIG_SCHED_BOOTPROFILE_NPHASES are dropped.  May be called from any
+ *   context.
+ *
+ * Input Parameters:
+ *   phase - Name of the phase.  Only the pointer is kept.
+ *
+ ****************************************************************************/
+
+void nx_bootmark(FAR const char *phase)
+{
+  unsigned long time = up_perf_gettime();
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_bootlock);
+
+  if (g_nbootmarks < CONFIG_SCHED_BOOTPROFILE_NPHASES)
+    {
+      g_bootmarks[g_nbootmarks].phase = phase;
+      g_bootmarks[g_nbootmarks].time  = time;
+      g_nbootmarks++;
+    }
+
+  spin_unlock_irqrestore(&g_bootlock, flags);
+}
+
+/****************************************************************************
+ * Name: nx_bootphase
+ *
+ * Description:
+ *   Return a recorded boot phase, in the order of nx_bootmark() calls.
+ *
+ * Input Parameters:
+ *   index - Index of the phase, from 0
+ *   phase - Location to return its name
+ *   end   - Location to return the time of its end, since the first mark
+ *   len   - Location to return the time since the previous mark
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT past the last phase.
+ *
+ ****************************************************************************/
+
+int nx_bootphase(unsigned int index, FAR const char **phase,
+                 FAR struct timespec *end, FAR struct timespec *len)
+{
+  if (index >= g_nbootmarks)
+    {
+      return -ENOENT;
+    }
+
+  *phase = g_bootmarks[index].phase;
+  up_perf_convert(g_bootmarks[index].time - g_bootmarks[0].time, end);
+  up_perf_convert(g_bootmarks[index].time -
+                  g_bootmarks[index > 0 ? index - 1 : 0].time, len);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_BOOTPROFILE */
@@ -245,6 +245,14 @@ static inline void nx_start_application(void)
    */
 
   board_late_initialize();
+  nx_bootmark("board_late");
+
+#  ifdef CONFIG_SCHED_ASYNCINIT
+  /* The application may rely on anything the board initialized */
+
+  nx_async_wait(NULL);
+  nx_bootmark("async_init");
+#  endif
 #endif
 
   posix_spawnattr_init(&attr);
@@ -298,6 +306,7 @@ static inline void nx_start_application(void)
                    CONFIG_INIT_SYMTAB, CONFIG_INIT_NEXPORTS, NULL, &attr);
 #endif
   posix_spawnattr_destroy(&attr);
+  nx_bootmark("init");
   DEBUGASSERT(ret > 0);
 }
 
@@ -56,6 +56,7 @@
 #include "group/group.h"
 #include "init/init.h"
 #include "tls/tls.h"
+#include "wdog/wdog.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -320,6 +321,7 @@ void nx_start(void)
   /* Boot up is complete */
 
   g_nx_initstate = OSINIT_BOOT;
+  nx_bootmark("boot");
 
   /* Initialize RTOS Data ***************************************************/
 
@@ -417,6 +419,7 @@ void nx_start(void)
       tasklist = TLIST_HEAD(&g_idletcb[i].cmn);
 #endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[i], tasklist);
+      nxsched_rtr_index(&g_idletcb[i].cmn);
 
       /* Mark the idle task as the running task */
 
@@ -435,6 +438,10 @@ void nx_start(void)
 
   nxsem_initialize();
 
+  /* Initialize the watchdog timer queue */
+
+  wd_initialize();
+
 #if defined(MM_KERNEL_USRHEAP_INIT) || defined(CONFIG_MM_KERNEL_HEAP) || \
     defined(CONFIG_MM_PGALLOC)
   /* Initialize the memory manager */
@@ -552,6 +559,11 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  nx_bootmark("memory");
+
+  /* Initialize the TCB caches */
+
+  nxsched_tcb_initialize();
 
   /* Initialize tasking data structures */
 
@@ -616,11 +628,15 @@ void nx_start(void)
    * that are different for each  processor and hardware platform.
    */
 
+  nx_bootmark("os");
+
   up_initialize();
+  nx_bootmark("up_initialize");
 
   /* Initialize common drivers */
 
   drivers_initialize();
+  nx_bootmark("drivers");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -629,6 +645,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  nx_bootmark("board_early");
 #endif
 
   /* Hardware resources are now available */
@@ -680,6 +697,7 @@ void nx_start(void)
   /* The OS is fully initialized and we are beginning multi-tasking */
 
   g_nx_initstate = OSINIT_OSREADY;
+  nx_bootmark("osready");
 
   /* Create initial tasks and bring-up the system */
 
@@ -44,6 +44,18 @@
 #  error CONFIG_ARCH_NUSER_INTERRUPTS is not defined
 #endif
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define IRQ_HIST_NBUCKETS CONFIG_SCHED_IRQMONITOR_HISTOGRAM_NBUCKETS
+
+/* The entry latency is measured when the architecture timestamps the
+ * vector entry in g_irq_entrytime[].
+ */
+
+#  ifdef CONFIG_ARCH_HAVE_IRQ_ENTRYTIME
+#    define IRQ_HIST_LATENCY 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -67,6 +79,18 @@ struct irq_info_s
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  /* Bucket n counts the times of n significant bits.  These are kept until
+   * they are reset, unlike the counts above which are reset when read.
+   */
+
+  uint32_t dmax;     /* Maximum execution time */
+  uint32_t dhist[IRQ_HIST_NBUCKETS];
+#ifdef IRQ_HIST_LATENCY
+  uint32_t lmax;     /* Maximum latency from the vector entry */
+  uint32_t lhist[IRQ_HIST_NBUCKETS];
+#endif
+#endif
 #endif
 };
 
@@ -105,6 +129,14 @@ extern struct irq_info_s g_irqvector[NR_IRQS];
 extern const irq_mapped_t g_irqmap[NR_IRQS];
 #endif
 
+#ifdef IRQ_HIST_LATENCY
+/* The up_perf_gettime() value taken by the architecture on the entry of
+ * the interrupt vector of each CPU.
+ */
+
+extern volatile unsigned long g_irq_entrytime[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SMP
 /* This is the spinlock that enforces critical sections when interrupts are
  * disabled.
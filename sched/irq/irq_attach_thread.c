@@ -0,0 +1,267 @@
+/****************************************************************************
+ * sched/irq/irq_attach_thread.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+#if NR_IRQS > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of an interrupt attached with irq_attach_thread() */
+
+struct irq_thread_s
+{
+  xcpt_t    isr;        /* Top half, in the interrupt context */
+  xcpt_t    isrthread;  /* Bottom half, in the thread */
+  FAR void *arg;        /* Argument of both halves */
+  sem_t     sem;        /* Posted by the top half to wake up the thread */
+  pid_t     pid;        /* The thread */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct irq_thread_s *g_irq_thread[NR_IRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_default
+ *
+ * Description:
+ *   The top half used when the driver provides none:  keep a level
+ *   triggered interrupt from firing again until the bottom half ran.
+ *
+ ****************************************************************************/
+
+static int irq_thread_default(int irq, FAR void *context, FAR void *arg)
+{
+#if !defined(CONFIG_ARCH_NOINTC) && !defined(CONFIG_ARCH_VECNOTIRQ)
+  up_disable_irq(irq);
+#endif
+  return IRQ_WAKE_THREAD;
+}
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   Run the top half and wake up the thread if it asks to.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = arg;
+  int ret;
+
+  ret = info->isr(irq, context, info->arg);
+  if (ret == IRQ_WAKE_THREAD)
+    {
+      nxsem_post(&info->sem);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   Run the bottom half each time the top half wakes the thread up.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info;
+  int irq;
+
+  irq  = atoi(argv[1]);
+  info = (FAR struct irq_thread_s *)(uintptr_t)strtoul(argv[2], NULL, 0);
+
+  for (; ; )
+    {
+      if (nxsem_wait_uninterruptible(&info->sem) < 0)
+        {
+          continue;
+        }
+
+      info->isrthread(irq, NULL, info->arg);
+
+#if !defined(CONFIG_ARCH_NOINTC) && !defined(CONFIG_ARCH_VECNOTIRQ)
+      if (info->isr == irq_thread_default)
+        {
+          up_enable_irq(irq);
+        }
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is handled in two
+ *   halves:  'isr' runs in the interrupt context and returns
+ *   IRQ_WAKE_THREAD to have 'isrthread' run in a kernel thread of its
+ *   own.  The bottom halves of different interrupts thus run at the
+ *   priorities chosen for them instead of behind each other on a shared
+ *   work queue.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half, or NULL to just mask the interrupt until
+ *                the bottom half ran
+ *   isrthread  - The bottom half, called with a NULL context, or NULL to
+ *                detach the interrupt and delete its thread
+ *   arg        - The argument of both halves
+ *   priority   - The priority of the thread
+ *   stack_size - The stack size of the thread
+ *   cpu        - The CPU to run the thread on, or -1 for any
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size, int cpu)
+{
+  FAR struct irq_thread_s *info;
+  FAR char *argv[3];
+  char name[16];
+  char arg1[16];
+  char arg2[32];
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  /* Detach any previous handler and delete its thread */
+
+  info = g_irq_thread[irq];
+  if (info != NULL)
+    {
+      irq_detach(irq);
+      kthread_delete(info->pid);
+      nxsem_destroy(&info->sem);
+      kmm_free(info);
+      g_irq_thread[irq] = NULL;
+    }
+
+  if (isrthread == NULL)
+    {
+      return irq_detach(irq);
+    }
+
+  info = kmm_zalloc(sizeof(struct irq_thread_s));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  info->isr       = isr != NULL ? isr : irq_thread_default;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  nxsem_init(&info->sem, 0, 0);
+
+  snprintf(name, sizeof(name), "isr%d", irq);
+  snprintf(arg1, sizeof(arg1), "%d", irq);
+  snprintf(arg2, sizeof(arg2), "0x%" PRIxPTR, (uintptr_t)info);
+  argv[0] = arg1;
+  argv[1] = arg2;
+  argv[2] = NULL;
+
+  ret = kthread_create(name, priority, stack_size, irq_thread_main, argv);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  info->pid = ret;
+
+#ifdef CONFIG_SMP
+  if (cpu >= 0)
+    {
+      cpu_set_t cpuset;
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      ret = nxsched_set_affinity(info->pid, sizeof(cpuset), &cpuset);
+      if (ret < 0)
+        {
+          kthread_delete(info->pid);
+          goto errout;
+        }
+    }
+#else
+  UNUSED(cpu);
+#endif
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  if (ret < 0)
+    {
+      kthread_delete(info->pid);
+      goto errout;
+    }
+
+  g_irq_thread[irq] = info;
+  return OK;
+
+errout:
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return ret;
+}
+
+#endif /* NR_IRQS > 0 */
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <string.h>
 
 #include "irq/irq.h"
 
@@ -32,14 +33,23 @@
  * Private Types
  ****************************************************************************/
 
-struct irqchain_s
+struct irqchain_handler_s
 {
-  FAR struct irqchain_s *next;
-
   xcpt_t handler;    /* Address of the interrupt handler */
   FAR void *arg;     /* The argument provided to the interrupt handler. */
 };
 
+/* The handlers sharing an IRQ are kept in an array, so the dispatch walks
+ * contiguous memory instead of a linked list.
+ */
+
+struct irqchain_s
+{
+  FAR struct irqchain_s *flink;  /* Link in the free list */
+  uint8_t nhandlers;             /* Number of handlers in use */
+  struct irqchain_handler_s handlers[CONFIG_IRQCHAIN_NHANDLERS];
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -62,39 +72,33 @@ static sq_queue_t g_irqchainfreelist;
 
 static void irqchain_detach_all(int ndx)
 {
-  FAR struct irqchain_s *curr;
-  FAR struct irqchain_s *prev;
+  FAR struct irqchain_s *chain = g_irqvector[ndx].arg;
 
   g_irqvector[ndx].handler = irq_unexpected_isr;
+  g_irqvector[ndx].arg     = NULL;
 
-  curr = g_irqvector[ndx].arg;
-  while (curr != NULL)
-    {
-      prev = curr;
-      curr = curr->next;
-      sq_addlast((FAR struct sq_entry_s *)prev, &g_irqchainfreelist);
-    }
+  sq_addlast((FAR struct sq_entry_s *)chain, &g_irqchainfreelist);
 }
 
+/* Call the handlers in the order they were attached.  A handler that
+ * returns IRQ_HANDLED claims the interrupt and the rest are skipped; any
+ * other value, including IRQ_NONE for "not mine", goes on to the next.
+ */
+
 static int irqchain_dispatch(int irq, FAR void *context, FAR void *arg)
 {
-  FAR struct irqchain_s *curr;
-  FAR struct irqchain_s *prev;
-  int ndx;
-  int ret = 0;
+  FAR struct irqchain_s *chain = arg;
+  FAR const struct irqchain_handler_s *curr = chain->handlers;
+  FAR const struct irqchain_handler_s *end = curr + chain->nhandlers;
+  int ret = OK;
 
-#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
-  ndx = g_irqmap[irq];
-#else
-  ndx = irq;
-#endif
-
-  curr = g_irqvector[ndx].arg;
-  while (curr != NULL)
+  for (; curr < end; curr++)
     {
-      prev = curr;
-      curr = curr->next;
-      ret |= prev->handler(irq, context, prev->arg);
+      ret = curr->handler(irq, context, curr->arg);
+      if (ret == IRQ_HANDLED)
+        {
+          break;
+        }
     }
 
   return ret;
@@ -142,46 +146,35 @@ bool is_irqchain(int ndx, xcpt_t isr)
 
 int irqchain_attach(int ndx, xcpt_t isr, FAR void *arg)
 {
-  FAR struct irqchain_s *node;
-  FAR struct irqchain_s *curr;
+  FAR struct irqchain_s *chain;
 
   if (isr != irq_unexpected_isr)
     {
       if (g_irqvector[ndx].handler != irqchain_dispatch)
         {
-          if (sq_count(&g_irqchainfreelist) < 2)
+          chain = (FAR struct irqchain_s *)sq_remfirst(&g_irqchainfreelist);
+          if (chain == NULL)
             {
               return -ENOMEM;
             }
 
-          node = (FAR struct irqchain_s *)sq_remfirst(&g_irqchainfreelist);
-          DEBUGASSERT(node != NULL);
-
-          node->handler = g_irqvector[ndx].handler;
-          node->arg     = g_irqvector[ndx].arg;
-          node->next    = NULL;
+          chain->handlers[0].handler = g_irqvector[ndx].handler;
+          chain->handlers[0].arg     = g_irqvector[ndx].arg;
+          chain->nhandlers           = 1;
 
           g_irqvector[ndx].handler = irqchain_dispatch;
-          g_irqvector[ndx].arg     = node;
+          g_irqvector[ndx].arg     = chain;
         }
 
-      node = (FAR struct irqchain_s *)sq_remfirst(&g_irqchainfreelist);
-      if (node == NULL)
+      chain = g_irqvector[ndx].arg;
+      if (chain->nhandlers >= CONFIG_IRQCHAIN_NHANDLERS)
         {
           return -ENOMEM;
         }
 
-      node->handler = isr;
-      node->arg     = arg;
-      node->next    = NULL;
-
-      curr = g_irqvector[ndx].arg;
-      while (curr->next != NULL)
-        {
-          curr = curr->next;
-        }
-
-      curr->next = node;
+      chain->handlers[chain->nhandlers].handler = isr;
+      chain->handlers[chain->nhandlers].arg     = arg;
+      chain->nhandlers++;
     }
   else
     {
@@ -194,15 +187,14 @@ int irqchain_attach(int ndx, xcpt_t isr, FAR void *arg)
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg)
 {
 #if NR_IRQS > 0
-  FAR struct irqchain_s *prev;
-  FAR struct irqchain_s *curr;
-  FAR struct irqchain_s *first;
+  FAR struct irqchain_s *chain;
   int ret = -EINVAL;
 
   if ((unsigned)irq < NR_IRQS)
     {
       irqstate_t flags;
       int ndx;
+      int i;
 
 #ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
       /* Is there a mapping for this IRQ number? */
@@ -222,35 +214,24 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg)
 
       if (g_irqvector[ndx].handler == irqchain_dispatch)
         {
-          first = g_irqvector[ndx].arg;
-          for (prev = NULL, curr = first;
-               curr != NULL;
-               prev = curr, curr = curr->next)
+          chain = g_irqvector[ndx].arg;
+          for (i = 0; i < chain->nhandlers; i++)
             {
-              if (curr->handler == isr && curr->arg == arg)
+              if (chain->handlers[i].handler == isr &&
+                  chain->handlers[i].arg == arg)
                 {
-                  if (curr == first)
-                    {
-                      g_irqvector[ndx].arg = curr->next;
-                    }
-                  else if (curr->next == NULL)
-                    {
-                      prev->next = NULL;
-                    }
-                  else
-                    {
-                      prev->next = curr->next;
-                    }
+                  chain->nhandlers--;
+                  memmove(&chain->handlers[i], &chain->handlers[i + 1],
+                          (chain->nhandlers - i) *
+                          sizeof(struct irqchain_handler_s));
 
-                  sq_addlast((FAR struct sq_entry_s *)curr,
-                             &g_irqchainfreelist);
+                  /* A single handler left is attached directly */
 
-                  first = g_irqvector[ndx].arg;
-                  if (first->next == NULL)
+                  if (chain->nhandlers == 1)
                     {
-                      g_irqvector[ndx].handler = first->handler;
-                      g_irqvector[ndx].arg     = first->arg;
-                      sq_addlast((FAR struct sq_entry_s *)first,
+                      g_irqvector[ndx].handler = chain->handlers[0].handler;
+                      g_irqvector[ndx].arg     = chain->handlers[0].arg;
+                      sq_addlast((FAR struct sq_entry_s *)chain,
                                  &g_irqchainfreelist);
                     }
 
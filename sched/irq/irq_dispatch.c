@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <strings.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/mm/mm.h>
@@ -76,6 +77,32 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ 0
 #endif
 
+/* HIST_LATENCY - Record the latency from the vector entry to the handler
+ * HIST_DURATION - Record the execution time of the handler
+ */
+
+#ifdef IRQ_HIST_LATENCY
+#  define HIST_LATENCY(ndx, start) \
+     do \
+       { \
+         if (ndx < NUSER_IRQS) \
+           { \
+             irq_histogram(g_irqvector[ndx].lhist, &g_irqvector[ndx].lmax, \
+                           (start) - g_irq_entrytime[this_cpu()]); \
+           } \
+       } \
+     while (0)
+#else
+#  define HIST_LATENCY(ndx, start)
+#endif
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define HIST_DURATION(ndx, elapsed) \
+     irq_histogram(g_irqvector[ndx].dhist, &g_irqvector[ndx].dmax, elapsed)
+#else
+#  define HIST_DURATION(ndx, elapsed)
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      do \
@@ -83,6 +110,7 @@
          unsigned long start; \
          unsigned long elapsed; \
          start = up_perf_gettime(); \
+         HIST_LATENCY(ndx, start); \
          vector(irq, context, arg); \
          elapsed = up_perf_gettime() - start; \
          if (ndx < NUSER_IRQS) \
@@ -92,6 +120,7 @@
                { \
                  g_irqvector[ndx].time = elapsed; \
                } \
+             HIST_DURATION(ndx, elapsed); \
            } \
          if (CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ > 0 && \
              elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ) \
@@ -106,6 +135,45 @@
      vector(irq, context, arg)
 #endif /* CONFIG_SCHED_IRQMONITOR */
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef IRQ_HIST_LATENCY
+volatile unsigned long g_irq_entrytime[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_histogram
+ *
+ * Description:
+ *   Count a time in its log2 bucket and track the maximum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static inline void irq_histogram(FAR uint32_t *hist, FAR uint32_t *max,
+                                 unsigned long value)
+{
+  int bucket = flsl((long)value);
+
+  if (bucket >= IRQ_HIST_NBUCKETS)
+    {
+      bucket = IRQ_HIST_NBUCKETS - 1;
+    }
+
+  hist[bucket]++;
+  if (value > *max)
+    {
+      *max = value;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -164,11 +232,21 @@ void irq_dispatch(int irq, FAR void *context)
   sched_note_irqhandler(irq, vector, true);
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* The time spent in the handler is not charged to the thread */
+
+  nxsched_enter_irqtime();
+#endif
+
   /* Then dispatch to the interrupt handler */
 
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
 
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_leave_irqtime();
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
   /* Notify that we are leaving from the interrupt handler */
 
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <stdio.h>
 #include <fcntl.h>
@@ -53,20 +54,36 @@
  *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
  *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
  *
+ * With CONFIG_SCHED_IRQMONITOR_HISTOGRAM, the percentiles and the maximum
+ * of the execution time and of the entry latency follow in microseconds:
+ *
+ *   ...   P50   P99   MAX  LP50  LP99  LMAX
+ *   ... DDDDD DDDDD DDDDD DDDDD DDDDD DDDDD
+ *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu"
+
+#ifdef IRQ_HIST_LATENCY
+#  define HIST_HDR_FMT "   P50   P99   MAX  LP50  LP99  LMAX"
+#elif defined(CONFIG_SCHED_IRQMONITOR_HISTOGRAM)
+#  define HIST_HDR_FMT "   P50   P99   MAX"
+#else
+#  define HIST_HDR_FMT ""
+#endif
+
+#define HIST_FMT " %5lu %5lu %5lu"
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN 100
 
 /****************************************************************************
  * Private Types
@@ -92,6 +109,10 @@ struct irq_file_s
 
 static int     irq_callback(int irq, FAR struct irq_info_s *info,
                  FAR void *arg);
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static int     irq_reset(int irq, FAR struct irq_info_s *info,
+                 FAR void *arg);
+#endif
 
 /* File system methods */
 
@@ -103,6 +124,10 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 static int     irq_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static int     irq_ioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -127,13 +152,81 @@ const struct procfs_operations g_irq_operations =
   NULL,           /* readdir */
   NULL,           /* rewinddir */
 
-  irq_stat        /* stat */
+  irq_stat,       /* stat */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  irq_ioctl       /* ioctl */
+#else
+  NULL            /* ioctl */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_usec
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static unsigned long irq_usec(unsigned long elapsed)
+{
+  struct timespec ts;
+
+  up_perf_convert(elapsed, &ts);
+  return ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: irq_percentile
+ *
+ * Description:
+ *   Return the upper bound of the bucket of a percentile of a histogram,
+ *   in units of up_perf_gettime().
+ *
+ ****************************************************************************/
+
+static unsigned long irq_percentile(FAR const uint32_t *hist, uint32_t max,
+                                    unsigned int pct)
+{
+  uint64_t total = 0;
+  uint64_t sum = 0;
+  int i;
+
+  for (i = 0; i < IRQ_HIST_NBUCKETS; i++)
+    {
+      total += hist[i];
+    }
+
+  /* Bucket i holds the times below 2^i, the last one all the others */
+
+  for (i = 0; i < IRQ_HIST_NBUCKETS - 1; i++)
+    {
+      sum += hist[i];
+      if (sum * 100 >= total * pct)
+        {
+          return MIN((1ul << i) - 1, max);
+        }
+    }
+
+  return max;
+}
+
+/****************************************************************************
+ * Name: irq_histfmt
+ ****************************************************************************/
+
+static size_t irq_histfmt(FAR char *line, size_t len,
+                          FAR const uint32_t *hist, uint32_t max)
+{
+  return snprintf(line, len, HIST_FMT,
+                  irq_usec(irq_percentile(hist, max, 50)),
+                  irq_usec(irq_percentile(hist, max, 99)),
+                  irq_usec(max));
+}
+#endif
+
 /****************************************************************************
  * Name: irq_callback
  ****************************************************************************/
@@ -245,6 +338,17 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       count, intpart, fracpart,
                       (unsigned long)delta.tv_nsec / 1000);
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  linesize += irq_histfmt(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                          copy.dhist, copy.dmax);
+#ifdef IRQ_HIST_LATENCY
+  linesize += irq_histfmt(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                          copy.lhist, copy.lmax);
+#endif
+#endif
+
+  irqfile->line[linesize++] = '\n';
+
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
 
@@ -348,7 +452,8 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line to output is the header */
 
-  linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
+  linesize = snprintf(irqfile->line, IRQ_LINELEN,
+                      HDR_FMT HIST_HDR_FMT "\n");
 
   copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                            irqfile->remaining, &irqfile->offset);
@@ -408,6 +513,49 @@ static int irq_dup(FAR const struct file *oldp, FAR struct file *newp)
   return OK;
 }
 
+/****************************************************************************
+ * Name: irq_reset
+ *
+ * Description:
+ *   irq_foreach() callback resetting the histograms of an IRQ.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static int irq_reset(int irq, FAR struct irq_info_s *info, FAR void *arg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  info->dmax = 0;
+  memset(info->dhist, 0, sizeof(info->dhist));
+#ifdef IRQ_HIST_LATENCY
+  info->lmax = 0;
+  memset(info->lhist, 0, sizeof(info->lhist));
+#endif
+  leave_critical_section(flags);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: irq_ioctl
+ ****************************************************************************/
+
+static int irq_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  switch (cmd)
+    {
+      case PROCFSIOC_RESET:
+        irq_foreach(irq_reset, NULL);
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: irq_stat
  *
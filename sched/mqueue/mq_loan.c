@@ -0,0 +1,287 @@
+/****************************************************************************
+ * sched/mqueue/mq_loan.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <mqueue.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_mq_loan
+ *
+ * Description:
+ *   Lend the caller a message of the queue to be written in place.  It is
+ *   mq_msgsize bytes long.  The message is given back by sending it with
+ *   file_mq_send_loaned() or by releasing it with nxmq_release().
+ *
+ * Input Parameters:
+ *   mq  - Message queue descriptor
+ *   msg - The location to return the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:
+ *
+ *   EPERM    Message queue opened not opened for writing.
+ *   ENOMEM   There is no message to lend.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **msg)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_verify_send(mq, (FAR const char *)msg, 0, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  msgq = mq->f_inode->i_private;
+
+  flags = enter_critical_section();
+  mqmsg = nxmq_alloc_msg(msgq);
+  leave_critical_section(flags);
+
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *msg = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_loan
+ *
+ * Description:
+ *   Same as file_mq_loan(), for a message queue descriptor.
+ *
+ ****************************************************************************/
+
+int nxmq_loan(mqd_t mqdes, FAR void **msg)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return file_mq_loan(filep, msg);
+}
+
+/****************************************************************************
+ * Name: file_mq_send_loaned
+ *
+ * Description:
+ *   Queue a message lent by file_mq_loan() on the same queue, waiting like
+ *   file_mq_send() if the queue is full.  The message belongs to the queue
+ *   again on success; on failure it is still lent to the caller.
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor
+ *   msg    - The lent message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   As file_mq_send().
+ *
+ ****************************************************************************/
+
+int file_mq_send_loaned(FAR struct file *mq, FAR void *msg, size_t msglen,
+                        unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_verify_send(mq, msg, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  msgq  = mq->f_inode->i_private;
+  mqmsg = container_of(msg, struct mqueue_msg_s, mail);
+
+#ifdef CONFIG_MQ_MSGPOOL
+  /* A message of the pool of another queue may be too small */
+
+  if (mqmsg->type == MQ_ALLOC_POOL && mqmsg->msgq != msgq)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  flags = enter_critical_section();
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(msgq, mq->f_oflags);
+    }
+
+  if (ret == OK)
+    {
+      ret = nxmq_do_send(msgq, mqmsg, msg, msglen, prio);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_send_loaned
+ *
+ * Description:
+ *   Same as file_mq_send_loaned(), for a message queue descriptor.
+ *
+ ****************************************************************************/
+
+int nxmq_send_loaned(mqd_t mqdes, FAR void *msg, size_t msglen,
+                     unsigned int prio)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return file_mq_send_loaned(filep, msg, msglen, prio);
+}
+
+/****************************************************************************
+ * Name: file_mq_receive_loaned
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages as file_mq_receive()
+ *   does, but lend it to the caller instead of copying it out.  The caller
+ *   gives it back with nxmq_release(), before the queue is closed.
+ *
+ * Input Parameters:
+ *   mq   - Message queue descriptor
+ *   msg  - The location to return the message
+ *   prio - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success; a negated errno value as
+ *   file_mq_receive() on failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_receive_loaned(FAR struct file *mq, FAR void **msg,
+                               FAR unsigned int *prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* No buffer is too small for a message received in place */
+
+  ret = nxmq_verify_receive(mq, (FAR char *)msg, SIZE_MAX);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  msgq = mq->f_inode->i_private;
+
+  flags = enter_critical_section();
+
+  ret = nxmq_wait_receive(msgq, mq->f_oflags, &mqmsg);
+  if (ret == OK)
+    {
+      *msg = mqmsg->mail;
+      ret  = nxmq_do_receive(msgq, mqmsg, NULL, prio);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_loaned
+ *
+ * Description:
+ *   Same as file_mq_receive_loaned(), for a message queue descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_loaned(mqd_t mqdes, FAR void **msg,
+                            FAR unsigned int *prio)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return file_mq_receive_loaned(filep, msg, prio);
+}
+
+/****************************************************************************
+ * Name: nxmq_release
+ *
+ * Description:
+ *   Give back a message lent by file_mq_loan() or file_mq_receive_loaned().
+ *
+ ****************************************************************************/
+
+void nxmq_release(FAR void *msg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  nxmq_free_msg(container_of(msg, struct mqueue_msg_s, mail));
+  leave_critical_section(flags);
+}
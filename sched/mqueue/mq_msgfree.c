@@ -80,6 +80,15 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
       list_add_tail(&g_msgfreeirq, &mqmsg->node);
     }
 
+#ifdef CONFIG_MQ_MSGPOOL
+  /* If this is a message of the pool of a queue, put it back there */
+
+  else if (mqmsg->type == MQ_ALLOC_POOL)
+    {
+      list_add_tail(&mqmsg->msgq->msgpool, &mqmsg->node);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate messages because they will not
    * received them.
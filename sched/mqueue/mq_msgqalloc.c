@@ -57,6 +57,9 @@
  *
  *   EINVAL    attr is NULL or either attr->mq_mqssize or attr->mq_maxmsg
  *             have an invalid value
+ *
+ *   With CONFIG_MQ_MSGPOOL, a queue of messages larger than those of the
+ *   common free list gets its own pool of attr->mq_maxmsg messages.
  *   ENOSPC    There is insufficient space for the creation of the new
  *             message queue
  *
@@ -66,13 +69,23 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_MSGPOOL
+  FAR struct mqueue_msg_s *mqmsg;
+  size_t size;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
    */
 
+#ifdef CONFIG_MQ_MSGPOOL
+  DEBUGASSERT((!attr || attr->mq_msgsize <= UINT16_MAX) && pmsgq);
+  if ((attr && attr->mq_msgsize > UINT16_MAX) || !pmsgq)
+#else
   DEBUGASSERT((!attr || attr->mq_msgsize <= MQ_MAX_BYTES) && pmsgq);
   if ((attr && attr->mq_msgsize > MQ_MAX_BYTES) || !pmsgq)
+#endif
     {
       return -EINVAL;
     }
@@ -98,6 +111,32 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
           msgq->maxmsgsize = MQ_MAX_BYTES;
         }
 
+#ifdef CONFIG_MQ_MSGPOOL
+      list_initialize(&msgq->msgpool);
+      if (msgq->maxmsgsize > MQ_MAX_BYTES)
+        {
+          /* The messages of the common free list are too small */
+
+          size       = MQ_MSG_SIZE(msgq->maxmsgsize);
+          msgq->pool = kmm_malloc(size * msgq->maxmsgs);
+          if (msgq->pool == NULL)
+            {
+              kmm_free(msgq);
+              return -ENOSPC;
+            }
+
+          for (i = 0; i < msgq->maxmsgs; i++)
+            {
+              mqmsg = (FAR struct mqueue_msg_s *)
+                ((FAR uint8_t *)msgq->pool + i * size);
+
+              mqmsg->type = MQ_ALLOC_POOL;
+              mqmsg->msgq = msgq;
+              list_add_tail(&msgq->msgpool, &mqmsg->node);
+            }
+        }
+#endif
+
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
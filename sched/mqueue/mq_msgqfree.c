@@ -66,7 +66,12 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       nxmq_free_msg(entry);
     }
 
-  /* Then deallocate the message queue itself */
+  /* Then deallocate the message queue itself, with the pool of its
+   * messages.  Lent messages must have been released by now.
+   */
 
+#ifdef CONFIG_MQ_MSGPOOL
+  kmm_free(msgq->pool);
+#endif
   kmm_free(msgq);
 }
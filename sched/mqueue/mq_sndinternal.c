@@ -113,7 +113,8 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
  *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   list, or from the pool of the queue if its messages are larger than
+ *   those of g_msgfree.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -126,7 +127,7 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue the message is for
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -134,13 +135,27 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct list_node *mqmsg;
+  size_t size = sizeof(struct mqueue_msg_s);
 
-  /* Try to get the message from the generally available free list. */
+#ifdef CONFIG_MQ_MSGPOOL
+  if (msgq->pool != NULL)
+    {
+      /* A queue of large messages has its own pool */
+
+      mqmsg = list_remove_head(&msgq->msgpool);
+      size  = MQ_MSG_SIZE(msgq->maxmsgsize);
+    }
+  else
+#endif
+    {
+      /* Try to get the message from the generally available free list. */
+
+      mqmsg = list_remove_head(&g_msgfree);
+    }
 
-  mqmsg = list_remove_head(&g_msgfree);
   if (mqmsg == NULL)
     {
       /* If we were called from an interrupt handler, then try to get the
@@ -150,9 +165,14 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
 
       if (up_interrupt_context())
         {
-          /* Try the free list reserved for interrupt handlers */
+          /* Try the free list reserved for interrupt handlers.  It only
+           * holds messages of the common size.
+           */
 
-          mqmsg = list_remove_head(&g_msgfreeirq);
+          if (size == sizeof(struct mqueue_msg_s))
+            {
+              mqmsg = list_remove_head(&g_msgfreeirq);
+            }
         }
 
       /* We were not called from an interrupt handler. */
@@ -163,8 +183,7 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
            * allocate one.
            */
 
-          mqmsg = (FAR struct list_node *)
-            kmm_malloc((sizeof (struct mqueue_msg_s)));
+          mqmsg = (FAR struct list_node *)kmm_malloc(size);
 
           /* Check if we allocated the message */
 
@@ -334,9 +353,14 @@ int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message, unless it was written there
+   * in place.
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue
    * Search the message list to find the location to insert the new
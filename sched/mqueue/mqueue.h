@@ -29,6 +29,7 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -47,6 +48,12 @@
 #define MQ_MAX_MSGS    16
 #define MQ_PRIO_MAX    _POSIX_MQ_PRIO_MAX
 
+/* The size of a message structure holding n bytes */
+
+#define MQ_MSG_SIZE(n) \
+  ((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & \
+   ~(sizeof(uintptr_t) - 1))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -55,7 +62,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_POOL        /* From the pool of its queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -65,12 +73,15 @@ struct mqueue_msg_s
   struct list_node node;   /* Link node to message */
   uint8_t type;            /* (Used to manage allocations) */
   uint8_t priority;        /* Priority of message */
-#if MQ_MAX_BYTES < 256
+#if MQ_MAX_BYTES < 256 && !defined(CONFIG_MQ_MSGPOOL)
   uint8_t msglen;          /* Message data length */
 #else
   uint16_t msglen;         /* Message data length */
 #endif
-  char mail[MQ_MAX_BYTES]; /* Message data */
+#ifdef CONFIG_MQ_MSGPOOL
+  FAR struct mqueue_inode_s *msgq; /* The queue of a pool message */
+#endif
+  char mail[MQ_MAX_BYTES]; /* Message data, maxmsgsize of a pool message */
 };
 
 /****************************************************************************
@@ -134,7 +145,7 @@ int nxmq_verify_send(FAR struct file *mq, FAR const char *msg,
 #else
 #  define nxmq_verify_send(mq, msg, msglen, prio) OK
 #endif
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags);
 int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
                  FAR struct mqueue_msg_s *mqmsg,
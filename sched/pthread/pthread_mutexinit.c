@@ -113,15 +113,20 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
           ret = -ret;
         }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-      /* Initialize the semaphore protocol */
+      /* Initialize the semaphore protocol.  The count of the underlying
+       * semaphore is only changed by the pthread mutex logic, so it may use
+       * the semaphore fast path when priority inheritance is not selected.
+       */
 
-      status = nxsem_set_protocol(&mutex->sem, proto);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      status = nxsem_set_protocol(&mutex->sem, proto | SEM_FASTPATH);
+#else
+      status = nxsem_set_protocol(&mutex->sem, SEM_FASTPATH);
+#endif
       if (status < 0)
         {
           ret = -status;
         }
-#endif
 
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
       /* Initial internal fields of the mutex */
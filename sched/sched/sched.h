@@ -324,6 +324,21 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Priority index of the g_readytorun list.  nxsched_rtr_index() must be
+ * called after a TCB was linked into g_readytorun and
+ * nxsched_rtr_unindex() before it is unlinked or its sched_priority is
+ * changed in place.
+ */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+FAR struct tcb_s *nxsched_rtr_next(uint8_t sched_priority);
+void nxsched_rtr_index(FAR struct tcb_s *tcb);
+void nxsched_rtr_unindex(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_rtr_index(tcb)
+#  define nxsched_rtr_unindex(tcb)
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -339,10 +354,16 @@ int  nxsched_reprioritize(FAR struct tcb_s *tcb, int sched_priority);
 unsigned int nxsched_cancel_timer(void);
 void nxsched_resume_timer(void);
 void nxsched_reassess_timer(void);
+#  if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+void nxsched_switch_timer(FAR struct tcb_s *tcb);
+#  else
+#    define nxsched_switch_timer(tcb)
+#  endif
 #else
 #  define nxsched_cancel_timer() (0)
 #  define nxsched_resume_timer()
 #  define nxsched_reassess_timer()
+#  define nxsched_switch_timer(tcb)
 #endif
 
 /* Scheduler policy support */
@@ -364,16 +385,65 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+bool nxsched_deadline_earlier(FAR struct tcb_s *tcb1,
+                              FAR struct tcb_s *tcb2);
+#else
+#  define nxsched_deadline_earlier(tcb1, tcb2) false
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+void nxsched_tcb_initialize(void);
+#else
+#  define nxsched_tcb_initialize()
+#endif
+
+#ifdef CONFIG_SCHED_STACKCACHE
+int  nxsched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                          uint8_t ttype);
+void nxsched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype);
+#else
+#  define nxsched_create_stack(tcb, size, ttype) \
+     up_create_stack(tcb, size, ttype)
+#  define nxsched_release_stack(tcb, ttype) up_release_stack(tcb, ttype)
+#endif
+
 #ifdef CONFIG_SMP
 FAR struct tcb_s *this_task(void);
 
 int  nxsched_select_cpu(cpu_set_t affinity);
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
+#  ifdef CONFIG_SCHED_CACHE_AFFINITY
+int  nxsched_select_task_cpu(FAR struct tcb_s *tcb);
+
+/* Record the CPU a TCB is assigned to, counting moves between CPUs */
+
+#    define nxsched_set_cpu(t, c) \
+  do \
+    { \
+      if ((t)->cpu != (c)) \
+        { \
+          (t)->nmigrations++; \
+        } \
+      (t)->cpu = (c); \
+    } \
+  while (0)
+#  else
+#    define nxsched_select_task_cpu(t) nxsched_select_cpu((t)->affinity)
+#    define nxsched_set_cpu(t, c)      ((t)->cpu = (c))
+#  endif
+
 #  define nxsched_islocked_global() spin_islocked(&g_cpu_schedlock)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
@@ -387,7 +457,7 @@ int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
 /* CPU load measurement support */
 
-#  ifdef CONFIG_SCHED_CPULOAD
+#  if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_SWITCH)
 void nxsched_process_cpuload_ticks(uint32_t ticks);
 #  else
 #    define nxsched_process_cpuload_ticks(ticks)
@@ -396,15 +466,36 @@ void nxsched_process_cpuload_ticks(uint32_t ticks);
 #  define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+void nxsched_suspend_cpuload(FAR struct tcb_s *tcb);
+#endif
+
+/* CPU time accounting */
+
+#ifdef CONFIG_SCHED_CPUTIME
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb);
+void nxsched_enter_irqtime(void);
+void nxsched_leave_irqtime(void);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state);
-void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state);
+void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                                FAR void *caller);
+void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller);
 void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+/* Per-thread hardware performance counters */
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+void nxsched_resume_perf(FAR struct tcb_s *tcb);
+void nxsched_suspend_perf(FAR struct tcb_s *tcb);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -77,9 +77,38 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
    * Each is list is maintained in descending sched_priority order.
    */
 
-  for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  if (list == &g_readytorun)
+    {
+      /* The priority index gives the location without a search */
+
+      next = nxsched_rtr_next(sched_priority);
+    }
+  else
+#endif
+    {
+      for (next = (FAR struct tcb_s *)list->head;
+           (next && sched_priority <= next->sched_priority);
+           next = next->flink);
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE threads are kept in EDF order ahead of the other
+   * threads of the same priority.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      for (prev = next != NULL ? next->blink :
+                  (FAR struct tcb_s *)list->tail;
+           prev != NULL && prev->sched_priority == sched_priority &&
+           nxsched_deadline_earlier(tcb, prev);
+           prev = prev->blink)
+        {
+          next = prev;
+        }
+    }
+#endif
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -137,5 +166,12 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
         }
     }
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  if (list == &g_readytorun)
+    {
+      nxsched_rtr_index(tcb);
+    }
+#endif
+
   return ret;
 }
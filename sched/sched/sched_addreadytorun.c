@@ -76,7 +76,10 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 &&
+      (rtcb->sched_priority < btcb->sched_priority ||
+       (rtcb->sched_priority == btcb->sched_priority &&
+        nxsched_deadline_earlier(btcb, rtcb))))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -173,7 +176,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = nxsched_select_cpu(btcb->affinity);
+      cpu = nxsched_select_task_cpu(btcb);
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -284,7 +287,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
 
-          btcb->cpu        = cpu;
+          nxsched_set_cpu(btcb, cpu);
           btcb->task_state = TSTATE_TASK_RUNNING;
 
           /* Adjust global pre-emption controls.  If the lockcount is
@@ -364,7 +367,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_ASSIGNED);
 
-          btcb->cpu        = cpu;
+          nxsched_set_cpu(btcb, cpu);
           btcb->task_state = TSTATE_TASK_ASSIGNED;
         }
 
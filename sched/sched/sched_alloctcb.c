@@ -0,0 +1,134 @@
+/****************************************************************************
+ * sched/sched/sched_alloctcb.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+/* The caches of task and kernel thread TCBs and of pthread TCBs */
+
+static struct mempool_cache_s g_task_tcbcache;
+#ifndef CONFIG_DISABLE_PTHREAD
+static struct mempool_cache_s g_pthread_tcbcache;
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+static inline FAR struct mempool_cache_s *nxsched_tcbcache(uint8_t ttype)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      return &g_pthread_tcbcache;
+    }
+#endif
+
+  return &g_task_tcbcache;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_tcb_initialize
+ *
+ * Description:
+ *   Initialize the TCB caches.  Called once by nx_start() when the memory
+ *   manager is available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+void nxsched_tcb_initialize(void)
+{
+  mempool_cache_init(&g_task_tcbcache, "task_tcb",
+                     sizeof(struct task_tcb_s),
+                     CONFIG_MM_MEMPOOL_CACHE_NEXPAND, NULL);
+#ifndef CONFIG_DISABLE_PTHREAD
+  mempool_cache_init(&g_pthread_tcbcache, "pthread_tcb",
+                     sizeof(struct pthread_tcb_s),
+                     CONFIG_MM_MEMPOOL_CACHE_NEXPAND, NULL);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a thread of type 'ttype': a struct
+ *   pthread_tcb_s for TCB_FLAG_TTYPE_PTHREAD, else a struct task_tcb_s.
+ *
+ * Returned Value:
+ *   The TCB on success; NULL if memory is insufficient.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype)
+{
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  return mempool_cache_alloc(nxsched_tcbcache(ttype));
+#else
+#ifndef CONFIG_DISABLE_PTHREAD
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      return kmm_zalloc(sizeof(struct pthread_tcb_s));
+    }
+#endif
+
+  return kmm_zalloc(sizeof(struct task_tcb_s));
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Free a TCB allocated by nxsched_alloc_tcb() for the same 'ttype'.
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  mempool_cache_free(nxsched_tcbcache(ttype), tcb);
+#else
+  kmm_free(tcb);
+#endif
+}
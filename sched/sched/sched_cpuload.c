@@ -24,9 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
@@ -42,7 +44,9 @@
  * of the sampling in ticks per second for the selected timer.
  */
 
-#ifdef CONFIG_SCHED_CPULOAD_EXTCLK
+#if defined(CONFIG_SCHED_CPULOAD_SWITCH)
+#  define CPULOAD_TICKSPERSEC up_perf_getfreq()
+#elif defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 #  ifndef CONFIG_SCHED_CPULOAD_TICKSPERSEC
 #    error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #  endif
@@ -56,10 +60,22 @@
  * will be incremented multiple times per tick.
  */
 
-#define CPULOAD_TIMECONSTANT \
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+/* The free-running counter may be fast enough for the time constant not to
+ * fit in 32 bits.  Keep it below half of the range so that one more charge
+ * (clamped to the time constant as well) cannot overflow the total.
+ */
+
+#  define CPULOAD_TIMECONSTANT \
+     ((uint32_t)MIN((uint64_t)CONFIG_SMP_NCPUS * \
+                    CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
+                    CPULOAD_TICKSPERSEC, UINT32_MAX / 2))
+#else
+#  define CPULOAD_TIMECONSTANT \
      (CONFIG_SMP_NCPUS * \
       CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
       CPULOAD_TICKSPERSEC)
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,6 +96,14 @@
 
 volatile uint32_t g_cpuload_total;
 
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+/* The value of the free-running counter when the time of each CPU was last
+ * charged to the thread running on it.
+ */
+
+static unsigned long g_cpuload_stamp[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -103,6 +127,7 @@ volatile uint32_t g_cpuload_total;
  *
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_CPULOAD_SWITCH
 static inline void nxsched_cpu_process_cpuload(int cpu, uint32_t ticks)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -117,11 +142,120 @@ static inline void nxsched_cpu_process_cpuload(int cpu, uint32_t ticks)
 
   g_cpuload_total += ticks;
 }
+#endif
+
+/****************************************************************************
+ * Name: nxsched_cpuload_decay
+ *
+ * Description:
+ *   If the accumulated tick value exceed a time constant, then shift the
+ *   accumulators and recalculate the total.
+ *
+ * Assumptions/Limitations:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_decay(void)
+{
+  int i;
+
+  if (g_cpuload_total > CPULOAD_TIMECONSTANT)
+    {
+      uint32_t total = 0;
+
+      /* Divide the tick count for every task by two and recalculate the
+       * total.
+       */
+
+      for (i = 0; i < g_npidhash; i++)
+        {
+          if (g_pidhash[i])
+            {
+              g_pidhash[i]->ticks >>= 1;
+              total += g_pidhash[i]->ticks;
+            }
+        }
+
+      /* Save the new total. */
+
+      g_cpuload_total = total;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cpu_charge_cpuload
+ *
+ * Description:
+ *   Charge the time elapsed since the last charge of a CPU to the thread
+ *   that ran on it during that time.
+ *
+ * Input Parameters:
+ *   cpu - The CPU to charge
+ *   tcb - The thread that ran on that CPU since the last charge
+ *
+ * Assumptions/Limitations:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+static void nxsched_cpu_charge_cpuload(int cpu, FAR struct tcb_s *tcb)
+{
+  unsigned long now = up_perf_gettime();
+  unsigned long elapsed = now - g_cpuload_stamp[cpu];
+
+  g_cpuload_stamp[cpu] = now;
+
+  /* Anything longer than the time constant would be halved away anyway */
+
+  if (elapsed > CPULOAD_TIMECONSTANT)
+    {
+      elapsed = CPULOAD_TIMECONSTANT;
+    }
+
+  tcb->ticks      += elapsed;
+  g_cpuload_total += elapsed;
+  nxsched_cpuload_decay();
+}
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_suspend_cpuload
+ *
+ * Description:
+ *   Called on every context switch when CONFIG_SCHED_CPULOAD_SWITCH is
+ *   selected:  the time since the previous switch on this CPU is charged
+ *   exactly to the thread being switched out.  No periodic sampling is
+ *   needed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being switched out
+ *
+ * Assumptions/Limitations:
+ *   Called from nxsched_suspend_scheduler() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+void nxsched_suspend_cpuload(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  /* The outgoing thread may no longer be current_task() here, so it is
+   * charged explicitly.
+   */
+
+  flags = enter_critical_section();
+  nxsched_cpu_charge_cpuload(this_cpu(), tcb);
+  leave_critical_section(flags);
+}
+#else
+
 /****************************************************************************
  * Name: nxsched_process_cpuload_ticks
  *
@@ -157,34 +291,10 @@ void nxsched_process_cpuload_ticks(uint32_t ticks)
       nxsched_cpu_process_cpuload(i, ticks);
     }
 
-  /* If the accumulated tick value exceed a time constant, then shift the
-   * accumulators and recalculate the total.
-   */
-
-  if (g_cpuload_total > CPULOAD_TIMECONSTANT)
-    {
-      uint32_t total = 0;
-
-      /* Divide the tick count for every task by two and recalculate the
-       * total.
-       */
-
-      for (i = 0; i < g_npidhash; i++)
-        {
-          if (g_pidhash[i])
-            {
-              g_pidhash[i]->ticks >>= 1;
-              total += g_pidhash[i]->ticks;
-            }
-        }
-
-      /* Save the new total. */
-
-      g_cpuload_total = total;
-    }
-
+  nxsched_cpuload_decay();
   leave_critical_section(flags);
 }
+#endif /* CONFIG_SCHED_CPULOAD_SWITCH */
 
 /****************************************************************************
  * Name:  clock_cpuload
@@ -220,6 +330,16 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
    */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+  /* The load is computed lazily:  bring the running threads up to date */
+
+  for (hash_index = 0; hash_index < CONFIG_SMP_NCPUS; hash_index++)
+    {
+      nxsched_cpu_charge_cpuload(hash_index, current_task(hash_index));
+    }
+#endif
+
   hash_index = PIDHASH(pid);
 
   /* Make sure that the entry is valid (TCB field is not NULL) and matches
@@ -105,4 +105,42 @@ int nxsched_select_cpu(cpu_set_t affinity)
   return cpu;
 }
 
+/****************************************************************************
+ * Name:  nxsched_select_task_cpu
+ *
+ * Description:
+ *   Select the CPU for a task that becomes ready-to-run.  This is the CPU
+ *   selected by nxsched_select_cpu() unless the CPU that the task ran on
+ *   last is an equally good candidate:  Then that CPU is preferred since
+ *   its cache probably still holds the working set of the task.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task to be placed.
+ *
+ * Returned Value:
+ *   Index of the selected CPU
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CACHE_AFFINITY
+int nxsched_select_task_cpu(FAR struct tcb_s *tcb)
+{
+  int cpu  = nxsched_select_cpu(tcb->affinity);
+  int last = tcb->cpu;
+
+  if (last != cpu && last < CONFIG_SMP_NCPUS &&
+      (tcb->affinity & (1 << last)) != 0 &&
+      current_task(last)->sched_priority <=
+      current_task(cpu)->sched_priority)
+    {
+      cpu = last;
+    }
+
+  return cpu;
+}
+#endif
+
 #endif /* CONFIG_SMP */
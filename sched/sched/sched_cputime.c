@@ -0,0 +1,222 @@
+/****************************************************************************
+ * sched/sched/sched_cputime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Per CPU:  the time up to which the CPU has been charged, the time spent
+ * in interrupt handlers and the nesting level of the handlers.
+ */
+
+static unsigned long g_cputime_stamp[CONFIG_SMP_NCPUS];
+static uint64_t g_cputime_irq[CONFIG_SMP_NCPUS];
+static uint8_t g_cputime_irqnest[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cputime_charge
+ *
+ * Description:
+ *   Return the up_perf_gettime() counts elapsed since the last charge of
+ *   the calling CPU, and start the next one.
+ *
+ ****************************************************************************/
+
+static inline unsigned long nxsched_cputime_charge(int cpu)
+{
+  unsigned long now = up_perf_gettime();
+  unsigned long elapsed = now - g_cputime_stamp[cpu];
+
+  g_cputime_stamp[cpu] = now;
+  return elapsed;
+}
+
+/****************************************************************************
+ * Name: nxsched_cputime_ns
+ *
+ * Description:
+ *   Convert up_perf_gettime() counts to nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t nxsched_cputime_ns(uint64_t count)
+{
+  uint64_t freq = up_perf_getfreq();
+
+  return count / freq * NSEC_PER_SEC +
+         count % freq * NSEC_PER_SEC / freq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_suspend_cputime
+ *
+ * Description:
+ *   Charge the time since the last charge of this CPU to the thread being
+ *   switched out.  Nothing is charged for a switch from an interrupt
+ *   handler:  the thread was charged on the entry of the handler and the
+ *   rest of the time belongs to the handler.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being switched out
+ *
+ * Assumptions/Limitations:
+ *   Called from nxsched_suspend_scheduler() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+
+  if (g_cputime_irqnest[cpu] == 0)
+    {
+      tcb->cputime += nxsched_cputime_charge(cpu);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_enter_irqtime
+ *
+ * Description:
+ *   Called by irq_dispatch() before the handler runs:  charge the
+ *   interrupted thread, the time from now on belongs to the interrupt.
+ *
+ ****************************************************************************/
+
+void nxsched_enter_irqtime(void)
+{
+  int cpu = this_cpu();
+
+  if (g_cputime_irqnest[cpu]++ == 0)
+    {
+      this_task()->cputime += nxsched_cputime_charge(cpu);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_leave_irqtime
+ *
+ * Description:
+ *   Called by irq_dispatch() after the handler ran:  charge the interrupt,
+ *   the time from now on belongs to the thread at the head of the
+ *   ready-to-run list.
+ *
+ ****************************************************************************/
+
+void nxsched_leave_irqtime(void)
+{
+  int cpu = this_cpu();
+
+  if (--g_cputime_irqnest[cpu] == 0)
+    {
+      g_cputime_irq[cpu] += nxsched_cputime_charge(cpu);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time used by a thread, including the time since it was
+ *   last charged if it is running now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   The CPU time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t nxsched_get_cputime(FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_SMP
+  int cpu = tcb->cpu;
+#else
+  int cpu = 0;
+#endif
+  irqstate_t flags;
+  uint64_t count;
+
+  flags = enter_critical_section();
+
+  count = tcb->cputime;
+  if (tcb->task_state == TSTATE_TASK_RUNNING &&
+      g_cputime_irqnest[cpu] == 0)
+    {
+      count += up_perf_gettime() - g_cputime_stamp[cpu];
+    }
+
+  leave_critical_section(flags);
+  return nxsched_cputime_ns(count);
+}
+
+/****************************************************************************
+ * Name: nxsched_get_irqtime
+ *
+ * Description:
+ *   Return the time a CPU spent in interrupt handlers.  This time is not
+ *   charged to any thread.
+ *
+ * Input Parameters:
+ *   cpu - The CPU
+ *
+ * Returned Value:
+ *   The time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t nxsched_get_irqtime(int cpu)
+{
+  irqstate_t flags;
+  uint64_t count;
+
+  flags = enter_critical_section();
+  count = g_cputime_irq[cpu];
+  leave_critical_section(flags);
+
+  return nxsched_cputime_ns(count);
+}
+
+#endif /* CONFIG_SCHED_CPUTIME */
@@ -24,11 +24,16 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sched.h>
+#include <string.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+
 #include "sched/sched.h"
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -49,6 +54,10 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD 0
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS
+#  define CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS 0
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION > 0
 #  define CHECK_PREEMPTION(pid, elapsed) \
      do \
@@ -97,6 +106,30 @@
 #  define CHECK_THREAD(pid, elapsed)
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS > 0
+#  define CHECK_SUBSYS(name, elapsed) \
+     do \
+       { \
+         if (elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_SUBSYS) \
+           { \
+             serr("Lock %s held too long %lu\n", name, elapsed); \
+           } \
+       } \
+     while (0)
+#else
+#  define CHECK_SUBSYS(name, elapsed)
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+#  define TRACE_NENTRIES CONFIG_SCHED_CRITMONITOR_TRACER_NENTRIES
+#  define TRACE_SECTION(type, tcb, elapsed, entry, exit) \
+     nxsched_critmon_trace(type, tcb, elapsed, entry, exit)
+#  define TRACE_CALLER(field, caller) ((field) = (caller))
+#else
+#  define TRACE_SECTION(type, tcb, elapsed, entry, exit)
+#  define TRACE_CALLER(field, caller)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -106,6 +139,25 @@
 static unsigned long g_premp_start[CONFIG_SMP_NCPUS];
 static unsigned long g_crit_start[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+/* The list of subsystem locks taken so far.  Locks are only ever added at
+ * the head, so the list may be walked without holding g_subsys_reglock.
+ */
+
+static FAR subsys_lock_t *volatile g_subsys_locks;
+#ifdef CONFIG_SMP
+static spinlock_t g_subsys_reglock;
+#endif
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+/* The longest sections of each type, longest first */
+
+static struct critmon_trace_s
+g_critmon_traces[CRITMON_TRACE_NTYPES][TRACE_NENTRIES];
+static spinlock_t g_critmon_tracelock;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +167,85 @@ static unsigned long g_crit_start[CONFIG_SMP_NCPUS];
 unsigned long g_premp_max[CONFIG_SMP_NCPUS];
 unsigned long g_crit_max[CONFIG_SMP_NCPUS];
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_critmon_trace
+ *
+ * Description:
+ *   Keep a section if it is one of the longest of its type.  The backtrace
+ *   is only taken for those, at the end of the section.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+static void nxsched_critmon_trace(int type, FAR struct tcb_s *tcb,
+                                  unsigned long elapsed, FAR void *entry,
+                                  FAR void *exit)
+{
+  FAR struct critmon_trace_s *table = g_critmon_traces[type];
+#if CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH > 0
+  FAR void *backtrace[CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH];
+  int depth = 0;
+#endif
+  irqstate_t flags;
+  int i;
+
+  /* Most sections are shorter than the shortest one kept */
+
+  if (tcb->pid == 0 || elapsed <= table[TRACE_NENTRIES - 1].elapsed)
+    {
+      return;
+    }
+
+#if CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH > 0
+  /* Skip this function and the monitor hook */
+
+  if (exit != NULL)
+    {
+      depth = up_backtrace(NULL, backtrace, nitems(backtrace), 2);
+    }
+#endif
+
+  flags = spin_lock_irqsave_wo_note(&g_critmon_tracelock);
+
+  /* Another CPU may have filled the table meanwhile */
+
+  if (elapsed <= table[TRACE_NENTRIES - 1].elapsed)
+    {
+      spin_unlock_irqrestore_wo_note(&g_critmon_tracelock, flags);
+      return;
+    }
+
+  /* Move the shorter sections down, the shortest one is dropped */
+
+  for (i = TRACE_NENTRIES - 1; i > 0 && table[i - 1].elapsed < elapsed; i--)
+    {
+      table[i] = table[i - 1];
+    }
+
+  table[i].elapsed = elapsed;
+  table[i].pid     = tcb->pid;
+  table[i].cpu     = this_cpu();
+  table[i].entry   = entry;
+  table[i].exit    = exit;
+#if CONFIG_SCHED_CRITMONITOR_TRACER_DEPTH > 0
+  table[i].depth   = MAX(depth, 0);
+  memcpy(table[i].backtrace, backtrace,
+         table[i].depth * sizeof(FAR void *));
+#else
+  table[i].depth   = 0;
+#endif
+
+  spin_unlock_irqrestore_wo_note(&g_critmon_tracelock, flags);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -131,7 +262,8 @@ unsigned long g_crit_max[CONFIG_SMP_NCPUS];
  *
  ****************************************************************************/
 
-void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
+void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                                FAR void *caller)
 {
   int cpu = this_cpu();
 
@@ -143,6 +275,7 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
 
       tcb->premp_start   = up_perf_gettime();
       g_premp_start[cpu] = tcb->premp_start;
+      TRACE_CALLER(tcb->premp_caller, caller);
     }
   else
     {
@@ -157,6 +290,9 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
           CHECK_PREEMPTION(tcb->pid, elapsed);
         }
 
+      TRACE_SECTION(CRITMON_TRACE_PREEMPTION, tcb, elapsed,
+                    tcb->premp_caller, caller);
+
       /* Check for the global max elapsed time */
 
       elapsed = now - g_premp_start[cpu];
@@ -179,7 +315,8 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
  *
  ****************************************************************************/
 
-void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
+void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller)
 {
   int cpu = this_cpu();
 
@@ -191,6 +328,7 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
 
       tcb->crit_start   = up_perf_gettime();
       g_crit_start[cpu] = tcb->crit_start;
+      TRACE_CALLER(tcb->crit_caller, caller);
     }
   else
     {
@@ -205,6 +343,9 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
           CHECK_CSECTION(tcb->pid, elapsed);
         }
 
+      TRACE_SECTION(CRITMON_TRACE_CSECTION, tcb, elapsed,
+                    tcb->crit_caller, caller);
+
       /* Check for the global max elapsed time */
 
       elapsed = now - g_crit_start[cpu];
@@ -316,6 +457,9 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
           tcb->premp_max = elapsed;
           CHECK_PREEMPTION(tcb->pid, elapsed);
         }
+
+      TRACE_SECTION(CRITMON_TRACE_PREEMPTION, tcb, elapsed,
+                    tcb->premp_caller, NULL);
     }
 
   /* Is this task in a critical section? */
@@ -330,7 +474,155 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
           tcb->crit_max = elapsed;
           CHECK_CSECTION(tcb->pid, elapsed);
         }
+
+      TRACE_SECTION(CRITMON_TRACE_CSECTION, tcb, elapsed,
+                    tcb->crit_caller, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: subsys_lock_initialize
+ *
+ * Description:
+ *   Initialize a subsystem lock at run time.  Monitored locks are never
+ *   unlinked from the monitor list so they must not be freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+void subsys_lock_initialize(FAR subsys_lock_t *lock, FAR const char *name)
+{
+  DEBUGASSERT(!lock->registered);
+
+  spin_initialize(&lock->lock, 0);
+  lock->name      = name;
+  lock->flink     = NULL;
+  lock->start     = 0;
+  lock->max       = 0;
+  lock->nacquired = 0;
+}
+
+/****************************************************************************
+ * Name: subsys_lock
+ *
+ * Description:
+ *   Take a subsystem lock and start timing the hold.  The lock is linked
+ *   into the monitor list when it is taken for the first time.
+ *
+ ****************************************************************************/
+
+irqstate_t subsys_lock(FAR subsys_lock_t *lock)
+{
+  irqstate_t flags = spin_lock_irqsave(&lock->lock);
+
+  if (!lock->registered)
+    {
+#ifdef CONFIG_SMP
+      spin_lock(&g_subsys_reglock);
+#endif
+      lock->flink      = g_subsys_locks;
+      g_subsys_locks   = lock;
+      lock->registered = true;
+#ifdef CONFIG_SMP
+      spin_unlock(&g_subsys_reglock);
+#endif
+    }
+
+  lock->nacquired++;
+  lock->start = up_perf_gettime();
+  return flags;
+}
+
+/****************************************************************************
+ * Name: subsys_unlock
+ *
+ * Description:
+ *   Account for the hold time and release a subsystem lock.
+ *
+ ****************************************************************************/
+
+void subsys_unlock(FAR subsys_lock_t *lock, irqstate_t flags)
+{
+  unsigned long elapsed = up_perf_gettime() - lock->start;
+
+  if (elapsed > lock->max)
+    {
+      lock->max = elapsed;
+      CHECK_SUBSYS(lock->name, elapsed);
+    }
+
+  spin_unlock_irqrestore(&lock->lock, flags);
+}
+
+/****************************************************************************
+ * Name: subsys_lock_foreach
+ *
+ * Description:
+ *   Call 'handler' for each subsystem lock that has been taken at least
+ *   once.
+ *
+ ****************************************************************************/
+
+void subsys_lock_foreach(subsys_lock_handler_t handler, FAR void *arg)
+{
+  FAR subsys_lock_t *lock;
+
+  for (lock = g_subsys_locks; lock != NULL; lock = lock->flink)
+    {
+      handler(lock, arg);
+    }
+}
+#endif /* CONFIG_SCHED_CRITMONITOR_SUBSYS */
+
+/****************************************************************************
+ * Name: critmon_trace_snapshot
+ *
+ * Description:
+ *   Return the longest sections of a type since the last reset, longest
+ *   first.
+ *
+ * Input Parameters:
+ *   type    - The type of the sections, see enum critmon_trace_e
+ *   traces  - The location to return the sections
+ *   ntraces - The number of entries of traces[]
+ *   reset   - Forget the sections returned
+ *
+ * Returned Value:
+ *   The number of sections returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_TRACER
+int critmon_trace_snapshot(int type, FAR struct critmon_trace_s *traces,
+                           int ntraces, bool reset)
+{
+  FAR struct critmon_trace_s *table;
+  irqstate_t flags;
+  int n;
+
+  DEBUGASSERT(type >= 0 && type < CRITMON_TRACE_NTYPES);
+
+  table = g_critmon_traces[type];
+  flags = spin_lock_irqsave_wo_note(&g_critmon_tracelock);
+
+  for (n = 0; n < MIN(ntraces, TRACE_NENTRIES); n++)
+    {
+      if (table[n].elapsed == 0)
+        {
+          break;
+        }
+
+      traces[n] = table[n];
+    }
+
+  if (reset)
+    {
+      memset(table, 0, sizeof(g_critmon_traces[type]));
     }
+
+  spin_unlock_irqrestore_wo_note(&g_critmon_tracelock, flags);
+  return n;
 }
+#endif
 
 #endif
@@ -0,0 +1,405 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths (runtime / period) are kept as fixed point fractions */
+
+#define DEADLINE_BW_SHIFT   20
+#define DEADLINE_BW_ONE     (UINT32_C(1) << DEADLINE_BW_SHIFT)
+#define DEADLINE_BW_LIMIT   (DEADLINE_BW_ONE / 100 * CONFIG_SCHED_DEADLINE_BW)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all SCHED_DEADLINE threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_charge
+ *
+ * Description:
+ *   Charge the time the thread ran since it was last resumed against the
+ *   budget of the current instance.
+ *
+ ****************************************************************************/
+
+static void deadline_charge(FAR struct deadline_s *dl, clock_t now)
+{
+  dl->budget   -= (sclock_t)(now - dl->eventtime);
+  dl->eventtime = now;
+}
+
+/****************************************************************************
+ * Name: deadline_budget_start
+ *
+ * Description:
+ *   Arm the budget timer of a running thread for the rest of its budget.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_start(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  wd_start(&dl->timer, dl->budget > 0 ? dl->budget : 1,
+           deadline_budget_expire, (wdparm_t)tcb);
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   The running thread used up the budget of its instance.  Following the
+ *   constant bandwidth server rules the budget is recharged and the
+ *   deadline postponed by one period;  the thread is then re-sorted in the
+ *   ready-to-run list and may be preempted by a thread with an earlier
+ *   deadline.
+ *
+ * Input Parameters:
+ *   Standard watchdog parameters
+ *
+ * Assumptions:
+ *   Called from the watchdog timer handler with interrupts disabled while
+ *   the thread is running.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *dl;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  deadline_charge(dl, clock_systime_ticks());
+  while (dl->budget <= 0)
+    {
+      dl->absdeadline += dl->period;
+      dl->budget      += dl->runtime;
+    }
+
+  deadline_budget_start(tcb);
+
+  /* Re-sort the thread.  Setting the same priority re-inserts it in EDF
+   * order and switches to an earlier deadline thread if there is one.
+   */
+
+  nxsched_set_priority(tcb, tcb->sched_priority);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Validate the SCHED_DEADLINE parameters, perform the admission control
+ *   and start a new instance for the thread.  This is called when the
+ *   SCHED_DEADLINE policy is established via sched_setscheduler() or when
+ *   its parameters are changed via sched_setparam().
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The runtime, deadline and period of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL - The parameters are not consistent:  runtime <= deadline <=
+ *            period is required.
+ *   EBUSY  - Admitting the thread would exceed the SCHED_DEADLINE
+ *            bandwidth limit (CONFIG_SCHED_DEADLINE_BW).
+ *   ENOMEM - The deadline data structure could not be allocated.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t runtime;
+  sclock_t deadline;
+  sclock_t period;
+  uint32_t oldbw = 0;
+  uint32_t bw;
+  clock_t now;
+
+  /* Convert timespec values to system clock ticks */
+
+  clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  clock_time2ticks(&param->sched_dl_period, &period);
+
+  /* A zero period defaults to the relative deadline */
+
+  if (period == 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime < 1 || deadline < runtime || period < deadline)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control:  the total bandwidth may not exceed the limit */
+
+  bw = ((uint64_t)runtime << DEADLINE_BW_SHIFT) / period;
+  if (dl != NULL)
+    {
+      oldbw = dl->bandwidth;
+    }
+
+  if (g_deadline_bw - oldbw + bw > DEADLINE_BW_LIMIT)
+    {
+      return -EBUSY;
+    }
+
+  if (dl == NULL)
+    {
+      dl = (FAR struct deadline_s *)kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->timer);
+    }
+
+  g_deadline_bw   = g_deadline_bw - oldbw + bw;
+  dl->bandwidth   = bw;
+  dl->runtime     = runtime;
+  dl->deadline    = deadline;
+  dl->period      = period;
+
+  /* Start the first instance now */
+
+  now             = clock_systime_ticks();
+  dl->absdeadline = now + deadline;
+  dl->budget      = runtime;
+  dl->eventtime   = now;
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      deadline_budget_start(tcb);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Terminate SCHED_DEADLINE scheduling of the thread and release its
+ *   bandwidth and resources.  Called when the thread changes to another
+ *   policy or exits.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Always returns zero (OK).
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  wd_cancel(&dl->timer);
+  g_deadline_bw -= dl->bandwidth;
+
+  tcb->deadline = NULL;
+  kmm_free(dl);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Apply the CBS wake-up rule to a SCHED_DEADLINE thread that leaves the
+ *   blocked state:  if the rest of its budget cannot be consumed before
+ *   the current deadline without exceeding the reserved bandwidth, a new
+ *   instance with a fresh budget and deadline is started.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being unblocked
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  clock_t now = clock_systime_ticks();
+  sclock_t left = (sclock_t)(dl->absdeadline - now);
+
+  /* budget / left > runtime / deadline */
+
+  if (left <= 0 || dl->budget <= 0 ||
+      (uint64_t)dl->budget * dl->deadline > (uint64_t)left * dl->runtime)
+    {
+      dl->absdeadline = now + dl->deadline;
+      dl->budget      = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Start timing the budget of a SCHED_DEADLINE thread that is switched in.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread about to run
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  tcb->deadline->eventtime = clock_systime_ticks();
+  deadline_budget_start(tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Stop timing the budget of a SCHED_DEADLINE thread that is switched
+ *   out.  A thread that blocks after its current deadline has passed is
+ *   accounted as having missed that deadline.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being suspended
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  clock_t now = clock_systime_ticks();
+
+  wd_cancel(&dl->timer);
+  deadline_charge(dl, now);
+
+  if (tcb->task_state >= FIRST_BLOCKED_STATE &&
+      (sclock_t)(now - dl->absdeadline) > 0)
+    {
+      dl->nmisses++;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_deadline_earlier
+ *
+ * Description:
+ *   Decide the order of two threads of the same priority:  a
+ *   SCHED_DEADLINE thread goes before any thread of another policy and
+ *   before a SCHED_DEADLINE thread with a later absolute deadline.
+ *
+ * Input Parameters:
+ *   tcb1 - The TCB being inserted
+ *   tcb2 - The TCB it is compared with
+ *
+ * Returned Value:
+ *   true if tcb1 has to be scheduled before tcb2.
+ *
+ ****************************************************************************/
+
+bool nxsched_deadline_earlier(FAR struct tcb_s *tcb1,
+                              FAR struct tcb_s *tcb2)
+{
+  if ((tcb1->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE)
+    {
+      return false;
+    }
+
+  if ((tcb2->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE)
+    {
+      return true;
+    }
+
+  return (sclock_t)(tcb1->deadline->absdeadline -
+                    tcb2->deadline->absdeadline) < 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
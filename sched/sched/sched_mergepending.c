@@ -105,7 +105,9 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && (ptcb->sched_priority < rtcb->sched_priority ||
+                         (ptcb->sched_priority == rtcb->sched_priority &&
+                          !nxsched_deadline_earlier(ptcb, rtcb))));
                rtcb = rtcb->flink)
             {
             }
@@ -144,6 +146,8 @@ bool nxsched_merge_pending(void)
               ptcb->task_state  = TSTATE_TASK_READYTORUN;
             }
 
+          nxsched_rtr_index(ptcb);
+
           /* Set up for the next time through */
 
           rtcb = ptcb;
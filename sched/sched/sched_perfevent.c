@@ -0,0 +1,282 @@
+/****************************************************************************
+ * sched/sched/sched_perfevent.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/perf.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PERF_EVENTS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_perf_event_names[PERF_EVENT_MAX] =
+{
+  "cycles",
+  "instructions",
+  "cache-references",
+  "cache-misses",
+  "branch-misses",
+  "stalled-cycles",
+  "lsu-cycles",
+  "folded",
+  "sleep-cycles",
+  "exception-cycles"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_charge_perf
+ *
+ * Description:
+ *   Charge the events counted on this CPU since the previous switch to
+ *   'tcb', or drop them if 'tcb' is NULL.
+ *
+ * Assumptions:
+ *   Called with the interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void nxsched_charge_perf(FAR struct tcb_s *tcb)
+{
+  uint32_t delta[PERF_EVENT_MAX];
+  int i;
+
+  up_perf_event_read(delta);
+
+  if (tcb != NULL)
+    {
+      for (i = 0; i < PERF_EVENT_MAX; i++)
+        {
+          tcb->perf_count[i] += delta[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: perf_event_count
+ *
+ * Description:
+ *   Return the count of an event of a thread, including the events of the
+ *   calling thread since it was switched in.
+ *
+ ****************************************************************************/
+
+static int perf_event_count(pid_t pid, int type, FAR uint64_t *value)
+{
+  uint64_t counts[PERF_EVENT_MAX];
+  int ret;
+
+  ret = perf_event_snapshot(pid, counts);
+  if (ret >= 0)
+    {
+      *value = counts[type];
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_resume_perf
+ *
+ * Description:
+ *   Called when a thread is switched in.  The events counted during the
+ *   switch are not charged to any thread.
+ *
+ ****************************************************************************/
+
+void nxsched_resume_perf(FAR struct tcb_s *tcb)
+{
+  nxsched_charge_perf(NULL);
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_perf
+ *
+ * Description:
+ *   Called when a thread is switched out, charge it the events counted
+ *   since it was switched in.
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_perf(FAR struct tcb_s *tcb)
+{
+  nxsched_charge_perf(tcb);
+}
+
+/****************************************************************************
+ * Name: perf_event_snapshot
+ *
+ * Description:
+ *   Return the counts of all events of a thread since it was created, in
+ *   an array of PERF_EVENT_MAX values.  The counts of a thread running on
+ *   another CPU are those of its last switch.
+ *
+ * Input Parameters:
+ *   pid    - The thread
+ *   counts - The location to return the counts
+ *
+ * Returned Value:
+ *   Zero on success; -ESRCH if there is no such thread.
+ *
+ ****************************************************************************/
+
+int perf_event_snapshot(pid_t pid, FAR uint64_t *counts)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  DEBUGASSERT(counts != NULL);
+
+  flags = enter_critical_section();
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  /* Bring the counts of the calling thread up to date */
+
+  if (tcb == this_task())
+    {
+      nxsched_charge_perf(tcb);
+    }
+
+  memcpy(counts, tcb->perf_count, sizeof(tcb->perf_count));
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_event_open
+ *
+ * Description:
+ *   Start counting an event of a thread.  The counts of the thread are
+ *   saved when it is switched out, so they are not disturbed by the other
+ *   threads.
+ *
+ * Input Parameters:
+ *   event - The counter to initialize
+ *   type  - The event to count, see enum perf_event_e
+ *   pid   - The thread to count, zero for the calling thread
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure:  -EINVAL if the
+ *   event is not counted by this architecture, -ESRCH if there is no such
+ *   thread.
+ *
+ ****************************************************************************/
+
+int perf_event_open(FAR struct perf_event_s *event, int type, pid_t pid)
+{
+  DEBUGASSERT(event != NULL);
+
+  if (perf_event_name(type) == NULL)
+    {
+      return -EINVAL;
+    }
+
+  event->pid  = pid == 0 ? nxsched_gettid() : pid;
+  event->type = type;
+
+  return perf_event_count(event->pid, type, &event->base);
+}
+
+/****************************************************************************
+ * Name: perf_event_read
+ *
+ * Description:
+ *   Return the number of events counted since perf_event_open() or
+ *   perf_event_reset().
+ *
+ ****************************************************************************/
+
+int perf_event_read(FAR struct perf_event_s *event, FAR uint64_t *value)
+{
+  int ret;
+
+  DEBUGASSERT(event != NULL && value != NULL);
+
+  ret = perf_event_count(event->pid, event->type, value);
+  if (ret >= 0)
+    {
+      *value -= event->base;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: perf_event_reset
+ ****************************************************************************/
+
+int perf_event_reset(FAR struct perf_event_s *event)
+{
+  DEBUGASSERT(event != NULL);
+
+  return perf_event_count(event->pid, event->type, &event->base);
+}
+
+/****************************************************************************
+ * Name: perf_event_name
+ *
+ * Description:
+ *   Return the name of an event, NULL if the event is not counted by this
+ *   architecture.
+ *
+ ****************************************************************************/
+
+FAR const char *perf_event_name(int type)
+{
+  if (type < 0 || type >= PERF_EVENT_MAX ||
+      (up_perf_event_supported() & PERF_EVENT_BIT(type)) == 0)
+    {
+      return NULL;
+    }
+
+  return g_perf_event_names[type];
+}
+
+#endif /* CONFIG_SCHED_PERF_EVENTS */
@@ -126,7 +126,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->stack_alloc_ptr)
         {
-          up_release_stack(tcb, ttype);
+          nxsched_release_stack(tcb, ttype);
         }
 
 #ifdef CONFIG_PIC
@@ -163,7 +163,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb, ttype);
     }
 
   return ret;
@@ -77,4 +77,13 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread may need a new instance before it is made ready */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+#endif
 }
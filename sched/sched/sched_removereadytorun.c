@@ -91,6 +91,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
    * is always the g_readytorun list.
    */
 
+  nxsched_rtr_unindex(rtcb);
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
   /* Since the TCB is not in any list, it is now invalid */
@@ -228,7 +229,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
           dq_rem((FAR dq_entry_t *)rtrtcb, &g_readytorun);
           dq_addfirst((FAR dq_entry_t *)rtrtcb, tasklist);
 
-          rtrtcb->cpu = cpu;
+          nxsched_set_cpu(rtrtcb, cpu);
           nxttcb = rtrtcb;
         }
 
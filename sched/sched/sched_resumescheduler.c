@@ -26,6 +26,7 @@
 
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
@@ -66,11 +67,35 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Start timing the budget of the current instance */
+
+      nxsched_resume_deadline(tcb);
+    }
+#endif
+
+  /* In tickless mode, time the slice of the task being switched in */
+
+  nxsched_switch_timer(tcb);
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  nxsched_resume_perf(tcb);
+#endif
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+  /* The deepest point is often reached where the thread blocked */
+
+  if (tcb->xcp.regs != NULL)
+    {
+      nxsched_stack_sample(tcb, up_getusrsp(tcb->xcp.regs));
+    }
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <strings.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIORITIES   (SCHED_PRIORITY_MAX + 1)
+#define RTR_WORDBITS      (8 * sizeof(unsigned long))
+#define RTR_NWORDS        ((RTR_NPRIORITIES + RTR_WORDBITS - 1) / RTR_WORDBITS)
+
+#define RTR_WORD(p)       ((p) / RTR_WORDBITS)
+#define RTR_BIT(p)        (1ul << ((p) % RTR_WORDBITS))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The g_readytorun list is kept sorted by descending priority with tasks
+ * of equal priority in FIFO order, so it is a sequence of per-priority
+ * segments.  g_rtrhead[] holds the first TCB of each segment and
+ * g_rtrbitmap[] has a bit set for every priority that has a segment.
+ */
+
+static FAR struct tcb_s *g_rtrhead[RTR_NPRIORITIES];
+static unsigned long g_rtrbitmap[RTR_NWORDS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_next
+ *
+ * Description:
+ *   Return the TCB in the g_readytorun list in front of which a task with
+ *   the given priority has to be inserted:  The first TCB of the highest
+ *   priority that is lower than sched_priority.
+ *
+ * Input Parameters:
+ *   sched_priority - The priority of the TCB to be inserted
+ *
+ * Returned Value:
+ *   The TCB to insert before or NULL if the TCB goes at the end of the
+ *   list.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_rtr_next(uint8_t sched_priority)
+{
+  int word = RTR_WORD(sched_priority);
+  unsigned long mask;
+
+  mask = g_rtrbitmap[word] & (RTR_BIT(sched_priority) - 1);
+  while (mask == 0)
+    {
+      if (word == 0)
+        {
+          return NULL;
+        }
+
+      mask = g_rtrbitmap[--word];
+    }
+
+  return g_rtrhead[word * RTR_WORDBITS + flsl(mask) - 1];
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_index
+ *
+ * Description:
+ *   Update the index after the TCB was linked into the g_readytorun list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that was added to the list
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_index(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev = tcb->blink;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  DEBUGASSERT(prev == NULL || prev->sched_priority >= sched_priority);
+
+  /* The TCB starts a new segment unless it follows a TCB of the same
+   * priority.
+   */
+
+  if (prev == NULL || prev->sched_priority != sched_priority)
+    {
+      g_rtrhead[sched_priority] = tcb;
+      g_rtrbitmap[RTR_WORD(sched_priority)] |= RTR_BIT(sched_priority);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_unindex
+ *
+ * Description:
+ *   Update the index before the TCB is unlinked from the g_readytorun list
+ *   or its priority is changed.  This does nothing if the TCB is not in
+ *   g_readytorun.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that is about to be removed from the list
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_unindex(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  /* Only the first TCB of a segment is referenced by the index */
+
+  if (g_rtrhead[sched_priority] == tcb)
+    {
+      next = tcb->flink;
+      if (next != NULL && next->sched_priority == sched_priority)
+        {
+          g_rtrhead[sched_priority] = next;
+        }
+      else
+        {
+          g_rtrhead[sched_priority] = NULL;
+          g_rtrbitmap[RTR_WORD(sched_priority)] &= ~RTR_BIT(sched_priority);
+        }
+    }
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_BITMAP */
@@ -71,6 +71,7 @@
  *          current scheduling policy.
  *   EPERM  The calling task does not have appropriate privileges.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  The SCHED_DEADLINE bandwidth limit would be exceeded.
  *
  ****************************************************************************/
 
@@ -203,6 +204,25 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  This starts a new
+   * instance with the new runtime and deadline.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags = enter_critical_section();
+
+      ret = nxsched_start_deadline(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
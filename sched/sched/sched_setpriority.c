@@ -167,7 +167,9 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
+          nxsched_rtr_unindex(tcb);
           tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtr_index(tcb);
         }
       else
         {
@@ -186,7 +188,9 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
+      nxsched_rtr_unindex(tcb);
       tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtr_index(tcb);
     }
 }
 
@@ -223,7 +227,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = nxsched_select_cpu(tcb->affinity);
+      cpu = nxsched_select_task_cpu(tcb);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -254,7 +258,9 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
    * task is (strictly) greater than the current running task
    */
 
-  if (sched_priority > rtcb->sched_priority)
+  if (sched_priority > rtcb->sched_priority ||
+      (sched_priority == rtcb->sched_priority &&
+       nxsched_deadline_earlier(tcb, rtcb)))
     {
       /* A context switch will occur. */
 
@@ -72,6 +72,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  The SCHED_DEADLINE bandwidth limit would be exceeded.
  *
  ****************************************************************************/
 
@@ -91,6 +92,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -129,6 +133,17 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release the bandwidth of a thread leaving SCHED_DEADLINE */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      policy != SCHED_DEADLINE)
+    {
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -264,6 +279,31 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Admit the thread and start its first instance.  A thread that
+           * already used SCHED_DEADLINE keeps its old parameters on
+           * failure.
+           */
+
+          ret = nxsched_start_deadline(tcb, param);
+          if (tcb->deadline != NULL)
+            {
+              tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+              tcb->timeslice = 0;
+#endif
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
@@ -274,7 +314,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -308,6 +348,7 @@ errout_with_irq:
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  The SCHED_DEADLINE bandwidth limit would be exceeded.
  *
  ****************************************************************************/
 
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * sched/sched/sched_stackcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_STACKCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxsched_stack_s
+{
+  FAR void *stack;  /* A stack from up_create_stack(), or NULL */
+  size_t    size;   /* Its size as reported by the heap */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The stacks of exited tasks and pthreads.  The pointers are kept here
+ * rather than linked through the stacks themselves because the stack of an
+ * exiting thread is still in use when it is released.
+ */
+
+static struct nxsched_stack_s g_stackcache[CONFIG_SCHED_STACKCACHE_COUNT];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_create_stack
+ *
+ * Description:
+ *   Same as up_create_stack(), but task and pthread stacks are taken from
+ *   the stacks of exited threads if one is at least stack_size and at most
+ *   1/8 larger.
+ *
+ ****************************************************************************/
+
+int nxsched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                         uint8_t ttype)
+{
+  FAR void *stack = NULL;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  if (ttype != TCB_FLAG_TTYPE_KERNEL && tcb->stack_alloc_ptr == NULL)
+    {
+      /* The critical section also keeps another CPU from taking the stack
+       * of a thread still exiting on this one.
+       */
+
+      flags = enter_critical_section();
+
+      for (i = 0; i < CONFIG_SCHED_STACKCACHE_COUNT; i++)
+        {
+          FAR struct nxsched_stack_s *entry = &g_stackcache[i];
+
+          if (entry->stack != NULL && entry->size >= stack_size &&
+              entry->size - stack_size <= stack_size / 8)
+            {
+              stack        = entry->stack;
+              entry->stack = NULL;
+              break;
+            }
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if (stack == NULL)
+    {
+      return up_create_stack(tcb, stack_size, ttype);
+    }
+
+  ret = up_use_stack(tcb, stack, stack_size);
+  if (ret < 0)
+    {
+      kumm_free(stack);
+      return up_create_stack(tcb, stack_size, ttype);
+    }
+
+  /* It is still a stack to be freed by up_release_stack() */
+
+  tcb->flags |= TCB_FLAG_FREE_STACK;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_release_stack
+ *
+ * Description:
+ *   Same as up_release_stack(), but the stacks allocated for tasks and
+ *   pthreads are kept for nxsched_create_stack() while there is room.
+ *
+ ****************************************************************************/
+
+void nxsched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  irqstate_t flags;
+  int i;
+
+  if (ttype != TCB_FLAG_TTYPE_KERNEL && tcb->stack_alloc_ptr != NULL &&
+      (tcb->flags & TCB_FLAG_FREE_STACK) != 0)
+    {
+      flags = enter_critical_section();
+
+      for (i = 0; i < CONFIG_SCHED_STACKCACHE_COUNT; i++)
+        {
+          FAR struct nxsched_stack_s *entry = &g_stackcache[i];
+
+          if (entry->stack == NULL)
+            {
+              entry->stack = tcb->stack_alloc_ptr;
+              entry->size  = kumm_malloc_size(tcb->stack_alloc_ptr);
+
+              /* Leave nothing for up_release_stack() to free */
+
+              tcb->flags &= ~TCB_FLAG_FREE_STACK;
+              break;
+            }
+        }
+
+      leave_critical_section(flags);
+    }
+
+  up_release_stack(tcb, ttype);
+}
+
+#endif /* CONFIG_SCHED_STACKCACHE */
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * sched/sched/sched_stackmark.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_STACK_WATERMARK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_stack_sample
+ *
+ * Description:
+ *   Account a stack pointer of a thread in its stack high-water mark.  It
+ *   is cheap enough for the context switches and the interrupt handlers.
+ *   A stack pointer outside of the stack of the thread is ignored.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *   sp  - A stack pointer of the thread
+ *
+ ****************************************************************************/
+
+void nxsched_stack_sample(FAR struct tcb_s *tcb, uintptr_t sp)
+{
+  uintptr_t base = (uintptr_t)tcb->stack_base_ptr;
+  uintptr_t top  = base + tcb->adj_stack_size;
+
+  /* A racing update may keep the lesser of two samples, the next deeper
+   * sample or scan recovers it.
+   */
+
+  if (sp >= base && sp < top && top - sp > tcb->stack_watermark)
+    {
+      tcb->stack_watermark = top - sp;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_stack_watermark
+ *
+ * Description:
+ *   Return the deepest stack use of a thread known so far.  With the stack
+ *   coloration, the coloring is first scanned down from the last known
+ *   mark, instead of the whole unused stack.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   The stack high-water mark in bytes.
+ *
+ ****************************************************************************/
+
+size_t nxsched_stack_watermark(FAR struct tcb_s *tcb)
+{
+  if (tcb == this_task())
+    {
+      nxsched_stack_sample(tcb, up_getsp());
+    }
+
+#ifdef CONFIG_STACK_COLORATION
+  tcb->stack_watermark = up_check_tcbstack_mark(tcb, tcb->stack_watermark);
+#endif
+
+  return tcb->stack_watermark;
+}
+
+#endif /* CONFIG_SCHED_STACK_WATERMARK */
@@ -68,11 +68,42 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Charge the budget of deadline threads */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_suspend_deadline(tcb);
+    }
+#endif
+
   /* Indicate that the task has been suspended */
 
+#ifdef CONFIG_SCHED_CPULOAD_SWITCH
+  nxsched_suspend_cpuload(tcb);
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_suspend_cputime(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_PERF_EVENTS
+  nxsched_suspend_perf(tcb);
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  /* A thread still ready to run was preempted, any other one blocked */
+
+  if (tcb->task_state >= TSTATE_TASK_PENDING &&
+      tcb->task_state < FIRST_BLOCKED_STATE)
+    {
+      tcb->nivcsw++;
+    }
+  else
+    {
+      tcb->nvcsw++;
+    }
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
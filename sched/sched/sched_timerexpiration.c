@@ -45,31 +45,6 @@
 
 #ifdef CONFIG_SCHED_TICKLESS
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-/* In the original design, it was planned that nxsched_reassess_timer() be
- * called whenever there was a change at the head of the ready-to-run
- * list.  That call was intended to establish a new time-slice or to
- * stop an old time-slice timer.  However, it turns out that that
- * solution is too fragile:  The system is too vulnerable at the time
- * that the ready-to-run list is modified in order to muck with timers.
- *
- * The kludge/work-around is simple to keep the timer running all of the
- * time with an interval of no more than the timeslice interval.  If we
- * do this, then there is really no need to do anything when on context
- * switches.
- */
-
-#define KEEP_ALIVE_HACK 1
-
-#if CONFIG_RR_INTERVAL > 0
-#  define KEEP_ALIVE_TICKS MSEC2TICK(CONFIG_RR_INTERVAL)
-#else
-#  define KEEP_ALIVE_TICKS MSEC2TICK(80)
-#endif
-
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -132,6 +107,15 @@ static unsigned int g_timer_interval;
 static clock_t g_sched_time;
 #endif
 
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+/* True while nxsched_timer_process() runs.  Context switches made by the
+ * timer processing itself need no reassessment:  the next interval is
+ * computed for the new running tasks on the way out.
+ */
+
+static bool g_timer_processing;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -270,16 +254,11 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
       return nxsched_process_scheduler(0, true);
     }
 
-  /* Returning zero means that there is no interesting event to be timed */
-
-#ifdef KEEP_ALIVE_HACK
-  if (ret == 0)
-    {
-      /* Apply the keep alive hack */
-
-      return KEEP_ALIVE_TICKS;
-    }
-#endif
+  /* Returning zero means that there is no interesting event to be timed.
+   * A task that needs time slicing arms the timer again when it is
+   * switched in (see nxsched_switch_timer()), so no periodic keep-alive
+   * is needed.
+   */
 
   return ret;
 }
@@ -415,6 +394,10 @@ static unsigned int nxsched_timer_process(unsigned int ticks,
   unsigned int rettime = 0;
   unsigned int tmp;
 
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  g_timer_processing = true;
+#endif
+
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   /* Process wall time */
 
@@ -444,10 +427,16 @@ static unsigned int nxsched_timer_process(unsigned int ticks,
   tmp = nxsched_process_scheduler(ticks, noswitches);
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  if (tmp > 0 && tmp < rettime)
+  /* Program a single timer for whichever comes first:  the next watchdog
+   * or the end of the time slice.
+   */
+
+  if (tmp > 0 && (rettime == 0 || tmp < rettime))
     {
       rettime = tmp;
     }
+
+  g_timer_processing = false;
 #endif
 
   return rettime;
@@ -730,6 +719,39 @@ void nxsched_resume_timer(void)
   nxsched_timer_start(nexttime);
 }
 
+/****************************************************************************
+ * Name:  nxsched_switch_timer
+ *
+ * Description:
+ *   Called when a task is switched in.  If the task is subject to time
+ *   slicing (round-robin or sporadic), the end of its slice is merged with
+ *   the next watchdog deadline and the timer is programmed once for the
+ *   earlier of the two.  Tasks without time slicing leave the timer alone.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task being switched in
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from nxsched_resume_scheduler() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+void nxsched_switch_timer(FAR struct tcb_s *tcb)
+{
+  uint16_t policy = tcb->flags & TCB_FLAG_POLICY_MASK;
+
+  if ((policy == TCB_FLAG_SCHED_RR || policy == TCB_FLAG_SCHED_SPORADIC) &&
+      !g_timer_processing)
+    {
+      nxsched_reassess_timer();
+    }
+}
+#endif
+
 /****************************************************************************
  * Name:  nxsched_reassess_timer
  *
@@ -743,18 +765,9 @@ void nxsched_resume_timer(void)
  *   - When pre-emption is re-enabled.  A previous time slice may have
  *     expired while pre-emption was enabled and now needs to be executed.
  *
- *   In the original design, it was also planned that
- *   nxsched_reassess_timer() be called whenever there was a change at the
- *   head of the ready-to-run list.  That call was intended to establish a
- *   new time-slice for the newly activated task or to stop the timer if
- *   time-slicing is no longer needed.  However, it turns out that that
- *   solution is too fragile:  The system is too vulnerable at the time
- *   that the ready-to-run list is modified in order to muck with timers.
- *
- *   The kludge/work-around is simple to keep the timer running all of the
- *   time with an interval of no more than the timeslice interval.  If we
- *   do this, then there is really no need to do anything on context
- *   switches.
+ *   It is not called while the ready-to-run list is being modified:  the
+ *   time slice of a newly activated task is established later, when the
+ *   task is actually switched in (see nxsched_switch_timer()).
  *
  * Input Parameters:
  *   None
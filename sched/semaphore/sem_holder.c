@@ -52,49 +52,49 @@ typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
                                FAR sem_t *sem, FAR void *arg);
 
 /****************************************************************************
- * Private Data
+ * Private Functions
  ****************************************************************************/
 
-/* Preallocated holder structures */
-
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
-static FAR struct semholder_s *g_freeholders;
-#endif
-
 /****************************************************************************
  * Name: nxsem_allocholder
+ *
+ * Description:
+ *   Take a free holder slot:  the one built into the semaphore if it is
+ *   free (always the case for mutexes), otherwise one of the slots built
+ *   into the TCB of the new holder.  No global pool is involved, so the
+ *   semaphores held by one thread cannot exhaust the holders of others.
+ *
  ****************************************************************************/
 
 static inline FAR struct semholder_s *
 nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
-  FAR struct semholder_s *pholder;
-
-  /* Check if the "built-in" holder is being used.  We have this built-in
-   * holder to optimize for the simplest case where semaphores are only
-   * used to implement mutexes.
-   */
-
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
-    {
-      /* Remove the holder from the free list and
-       * put it into the semaphore's holder list
-       */
+  FAR struct semholder_s *pholder = NULL;
 
-      g_freeholders  = pholder->flink;
-      pholder->flink = sem->hhead;
-      sem->hhead     = pholder;
-    }
-#else
   if (sem->holder.htcb == NULL)
     {
       pholder = &sem->holder;
     }
-#endif
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
   else
+    {
+      int i;
+
+      for (i = 0; i < CONFIG_SEM_PREALLOCHOLDERS; i++)
+        {
+          if (htcb->holders[i].htcb == NULL)
+            {
+              /* Put it into the semaphore's list of extra holders */
+
+              pholder = &htcb->holders[i];
+              dq_addlast(&pholder->flink, &sem->hlist);
+              break;
+            }
+        }
+    }
+#endif
+
+  if (pholder == NULL)
     {
       serr("ERROR: Insufficient pre-allocated holders\n");
       PANIC();
@@ -106,50 +106,41 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 
   /* Put it into the task's list */
 
-  pholder->tlink  = htcb->holdsem;
-  htcb->holdsem   = pholder;
-
+  dq_addlast(&pholder->tlink, &htcb->holdsem);
   return pholder;
 }
 
 /****************************************************************************
  * Name: nxsem_findholder
  *
- * NOTE: htcb may be used only as a look-up key.  It certain cases, the task
- * may have exited and htcb may refer to a stale memory.  It must not be
- * dereferenced.
+ * Description:
+ *   Look up the holder of the semaphore for htcb.  The search is bounded
+ *   by the number of slots of one TCB, whatever the number of holders of
+ *   the semaphore.
  *
  ****************************************************************************/
 
 static FAR struct semholder_s *
 nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
-  FAR struct semholder_s *pholder;
-
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Try to find the holder in the list of holders associated with this
-   * semaphore
-   */
+  int i;
+#endif
 
-  for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+  if (sem->holder.htcb == htcb)
     {
-      if (pholder->htcb == htcb)
-        {
-          /* Got it! */
+      /* Got it! */
 
-          return pholder;
-        }
+      return &sem->holder;
     }
-#else
-  /* We have one hard-allocated holder structures in sem_t */
 
-  pholder = &sem->holder;
-
-  if (pholder->htcb == htcb)
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  for (i = 0; i < CONFIG_SEM_PREALLOCHOLDERS; i++)
     {
-      /* Got it! */
-
-      return pholder;
+      if (htcb->holders[i].sem == sem)
+        {
+          return &htcb->holders[i];
+        }
     }
 #endif
 
@@ -181,47 +172,22 @@ nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
-  FAR struct semholder_s * FAR *curr;
-
   /* Remove the holder from the task's list */
 
-  for (curr = &pholder->htcb->holdsem;
-       *curr != NULL;
-       curr = &(*curr)->tlink)
-    {
-      if (*curr == pholder)
-        {
-          *curr = pholder->tlink;
-          break;
-        }
-    }
-
-  /* Release the holder and counts */
-
-  pholder->tlink  = NULL;
-  pholder->sem    = NULL;
-  pholder->htcb   = NULL;
-  pholder->counts = 0;
+  dq_rem(&pholder->tlink, &pholder->htcb->holdsem);
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   /* Remove the holder from the semaphore's list */
 
-  for (curr = &sem->hhead;
-       *curr != NULL;
-       curr = &(*curr)->flink)
+  if (pholder != &sem->holder)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->flink;
-          break;
-        }
+      dq_rem(&pholder->flink, &sem->hlist);
     }
+#endif
 
-  /* And put it in the free list */
+  /* Release the holder and counts */
 
-  pholder->flink = g_freeholders;
-  g_freeholders  = pholder;
-#endif
+  INITIALIZE_SEMHOLDER(pholder);
 }
 
 /****************************************************************************
@@ -255,31 +221,31 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 {
   FAR struct semholder_s *pholder;
   int ret = 0;
-
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *next;
-
-  for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
-    {
-      /* In case this holder gets deleted */
-
-      next = pholder->flink;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+#endif
 
-      DEBUGASSERT(pholder->htcb != NULL);
+  /* The built-in holder slot of sem_t may be free */
 
+  pholder = &sem->holder;
+  if (pholder->htcb != NULL)
+    {
       /* Call the handler */
 
       ret = handler(pholder, sem, arg);
     }
-#else
-  /* We have one hard-allocated holder structures in sem_t */
 
-  pholder = &sem->holder;
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  for (node = dq_peek(&sem->hlist); node != NULL && ret == 0; node = next)
+    {
+      /* In case this holder gets deleted */
 
-  /* The hard-allocated containers may hold a NULL holder */
+      next    = dq_next(node);
+      pholder = container_of(node, struct semholder_s, flink);
+
+      DEBUGASSERT(pholder->htcb != NULL);
 
-  if (pholder->htcb != NULL)
-    {
       /* Call the handler */
 
       ret = handler(pholder, sem, arg);
@@ -364,14 +330,8 @@ static int nxsem_verifyholder(FAR struct semholder_s *pholder,
 static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
                             FAR void *arg)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  _info("  %08x: %08x %08x %08x %08x %04x\n",
-        pholder, pholder->flink,
-#else
-  _info("  %08x: %08x %08x %08x %04x\n",
-        pholder,
-#endif
-        pholder->tlink, pholder->sem, pholder->htcb, pholder->counts);
+  _info("  %p: %p %p %04x\n",
+        pholder, pholder->sem, pholder->htcb, pholder->counts);
   return 0;
 }
 #endif
@@ -398,15 +358,17 @@ static void nxsem_restore_priority(FAR struct tcb_s *htcb)
 
   if (htcb->sched_priority != hpriority)
     {
-      FAR struct semholder_s *pholder;
+      FAR dq_entry_t *node;
 
       /* Try to find the highest priority across all the threads that are
-       * waiting for any semaphore held by htcb.
+       * waiting for any semaphore held by htcb.  The wait lists are kept
+       * in priority order, so only their heads need to be looked at.
        */
 
-      for (pholder = htcb->holdsem; pholder != NULL;
-           pholder = pholder->tlink)
+      for (node = dq_peek(&htcb->holdsem); node != NULL;
+           node = dq_next(node))
         {
+          FAR struct semholder_s *pholder = (FAR struct semholder_s *)node;
           FAR struct tcb_s *stcb;
 
           stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(pholder->sem));
@@ -470,69 +432,12 @@ static int nxsem_restoreholderprio_others(FAR struct semholder_s *pholder,
   return 0;
 }
 
-/****************************************************************************
- * Name: nxsem_restoreholderprio_self
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int nxsem_restoreholderprio_self(FAR struct semholder_s *pholder,
-                                        FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-
-  if (pholder->htcb == rtcb)
-    {
-      /* The running task has given up a count on the semaphore */
-
-      nxsem_restoreholderprio(pholder, sem, arg);
-      return 1;
-    }
-
-  return 0;
-}
-
 #endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: nxsem_initialize_holders
- *
- * Description:
- *   Called from nxsem_initialize() to set up semaphore holder information.
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *
- ****************************************************************************/
-
-void nxsem_initialize_holders(void)
-{
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  int i;
-
-  /* Put all of the pre-allocated holder structures into the free list */
-
-  g_freeholders = g_holderalloc;
-  for (i = 0; i < (CONFIG_SEM_PREALLOCHOLDERS - 1); i++)
-    {
-      g_holderalloc[i].flink = &g_holderalloc[i + 1];
-    }
-
-  g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS - 1].flink = NULL;
-#endif
-}
-
 /****************************************************************************
  * Name: nxsem_destroyholder
  *
@@ -569,20 +474,15 @@ void nxsem_destroyholder(FAR sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead != NULL)
-    {
-      /* There may be an issue if there are multiple holders of
-       * the semaphore.
-       */
-
-      DEBUGASSERT(sem->hhead->flink == NULL);
-    }
+  /* There may be an issue if there are multiple holders of the semaphore */
 
+  DEBUGASSERT(dq_empty(&sem->hlist) ||
+              (sem->holder.htcb == NULL &&
+               dq_peek(&sem->hlist) == dq_tail(&sem->hlist)));
 #else
   /* There may be an issue if there are multiple holders of the semaphore. */
 
   DEBUGASSERT(sem->holder.htcb == NULL);
-
 #endif
 
   nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
@@ -723,19 +623,17 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-      for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+      pholder = nxsem_findholder(sem, rtcb);
+      if (pholder != NULL)
         {
           DEBUGASSERT(pholder->counts > 0);
 
-          if (pholder->htcb == rtcb)
-            {
-              /* Decrement the counts on this holder -- the holder will be
-               * freed later in nxsem_restore_baseprio.
-               */
+          /* Decrement the counts on this holder -- the holder will be
+           * freed later in nxsem_restore_baseprio.
+           */
 
-              pholder->counts--;
-              return;
-            }
+          pholder->counts--;
+          return;
         }
 
       /* The current task is not a holder */
@@ -812,11 +710,17 @@ void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
        * except for the running thread.
        */
 
+      FAR struct semholder_s *pholder;
+
       nxsem_foreachholder(sem, nxsem_restoreholderprio_others, stcb);
 
       /* Now, find an reprioritize only the ready to run task */
 
-      nxsem_foreachholder(sem, nxsem_restoreholderprio_self, stcb);
+      pholder = nxsem_findholder(sem, this_task());
+      if (pholder != NULL)
+        {
+          nxsem_restoreholderprio(pholder, sem, stcb);
+        }
 #else
       /* New owner is already the highest priority since the wait queue
        * is priority-based, no need to adjust its priority, only restore
@@ -920,12 +824,18 @@ void sem_enumholders(FAR sem_t *sem)
 int nxsem_nfreeholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *pholder;
-  int n;
+  FAR struct tcb_s *rtcb = this_task();
+  int n = 0;
+  int i;
+
+  /* The holder slots are per thread:  count those of the caller */
 
-  for (pholder = g_freeholders, n = 0; pholder; pholder = pholder->flink)
+  for (i = 0; i < CONFIG_SEM_PREALLOCHOLDERS; i++)
     {
-      n++;
+      if (rtcb->holders[i].htcb == NULL)
+        {
+          n++;
+        }
     }
 
   return n;
@@ -955,7 +865,8 @@ void nxsem_release_all(FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
-  while ((pholder = htcb->holdsem) != NULL)
+  while ((pholder = (FAR struct semholder_s *)dq_peek(&htcb->holdsem)) !=
+         NULL)
     {
       FAR sem_t *sem = pholder->sem;
 
@@ -965,7 +876,7 @@ void nxsem_release_all(FAR struct tcb_s *htcb)
        * that was taken by sem_wait() or sem_post().
        */
 
-      sem->semcount++;
+      nxsem_count_inc(sem);
     }
 }
 
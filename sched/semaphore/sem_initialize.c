@@ -54,9 +54,9 @@
 
 void nxsem_initialize(void)
 {
-  /* Initialize holder structures needed to support priority inheritance */
-
-  nxsem_initialize_holders();
+  /* Nothing to do:  the holder structures needed to support priority
+   * inheritance are built into the semaphores and the TCBs.
+   */
 }
 
 #endif /* CONFIG_PRIORITY_INHERITANCE */
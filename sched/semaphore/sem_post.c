@@ -78,6 +78,17 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+  /* Release the count without entering the critical section if there is
+   * nobody waiting to be woken up.
+   */
+
+#ifdef CONFIG_SEM_FASTPATH
+  if (NXSEM_FASTPATH(sem) && nxsem_post_fast(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -85,11 +96,9 @@ int nxsem_post(FAR sem_t *sem)
 
   flags = enter_critical_section();
 
-  sem_count = sem->semcount;
-
   /* Check the maximum allowable value */
 
-  if (sem_count >= SEM_VALUE_MAX)
+  if (sem->semcount >= SEM_VALUE_MAX)
     {
       leave_critical_section(flags);
       return -EOVERFLOW;
@@ -113,8 +122,7 @@ int nxsem_post(FAR sem_t *sem)
    */
 
   nxsem_release_holder(sem);
-  sem_count++;
-  sem->semcount = sem_count;
+  sem_count = nxsem_count_inc(sem) + 1;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Don't let any unblocked tasks run until we complete any priority
@@ -75,6 +75,17 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* Semaphores on the fast path need no critical section:  either a count
+   * is taken with a compare-and-swap or the semaphore is not available.
+   */
+
+#ifdef CONFIG_SEM_FASTPATH
+  if (NXSEM_FASTPATH(sem))
+    {
+      return nxsem_wait_fast(sem) ? OK : -EAGAIN;
+    }
+#endif
+
   /* The following operations must be performed with interrupts disabled
    * because sem_post() may be called from an interrupt handler.
    */
@@ -80,6 +80,17 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* Try to take an uncontended count without entering the critical
+   * section.  There are no holders to track on the fast path.
+   */
+
+#ifdef CONFIG_SEM_FASTPATH
+  if (NXSEM_FASTPATH(sem) && nxsem_wait_fast(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -89,13 +100,14 @@ int nxsem_wait(FAR sem_t *sem)
 
   /* Make sure we were supplied with a valid semaphore. */
 
-  /* Check if the lock is available */
+  /* Take a count.  If the lock was available, the task owns the
+   * semaphore now.
+   */
 
-  if (sem->semcount > 0)
+  if (nxsem_count_dec(sem) > 0)
     {
       /* It is, let the task take the semaphore. */
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
@@ -117,10 +129,6 @@ int nxsem_wait(FAR sem_t *sem)
 
       DEBUGASSERT(rtcb->waitobj == NULL);
 
-      /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-      sem->semcount--;
-
       /* Save the waited on semaphore in the TCB */
 
       rtcb->waitobj = sem;
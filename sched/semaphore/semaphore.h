@@ -32,6 +32,97 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The lock-free fast path updates semcount without entering the critical
+ * section.  Every read-modify-write of the count in the slow paths must
+ * then be atomic as well, so that a concurrent fast path update on another
+ * CPU (or from an interrupt handler) is never lost.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define NXSEM_FASTPATH(s) \
+     (((s)->flags & (SEM_TYPE_MUTEX | SEM_FASTPATH)) != 0 && \
+      ((s)->flags & SEM_PRIO_MASK) == SEM_PRIO_NONE)
+#  define nxsem_count_dec(s) \
+     __atomic_fetch_sub(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#  define nxsem_count_inc(s) \
+     __atomic_fetch_add(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#else
+#  define NXSEM_FASTPATH(s)  false
+#  define nxsem_count_dec(s) ((s)->semcount--)
+#  define nxsem_count_inc(s) ((s)->semcount++)
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+
+/****************************************************************************
+ * Name: nxsem_wait_fast
+ *
+ * Description:
+ *   Take one count from the semaphore with a compare-and-swap if a count is
+ *   available.  Nothing is done if the semaphore would have to block.
+ *
+ * Returned Value:
+ *   true if a count was taken;  false if the slow path must be used.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_wait_fast(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_post_fast
+ *
+ * Description:
+ *   Release one count to the semaphore with a compare-and-swap if there are
+ *   no waiters to wake up.
+ *
+ * Returned Value:
+ *   true if the count was released;  false if the slow path must be used.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_post_fast(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      false, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_SEM_FASTPATH */
 
 /****************************************************************************
  * Public Function Prototypes
@@ -70,7 +161,6 @@ void nxsem_recover(FAR struct tcb_s *tcb);
  */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-void nxsem_initialize_holders(void);
 void nxsem_destroyholder(FAR sem_t *sem);
 void nxsem_add_holder(FAR sem_t *sem);
 void nxsem_add_holder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem);
@@ -80,7 +170,6 @@ void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_release_all(FAR struct tcb_s *stcb);
 #else
-#  define nxsem_initialize_holders()
 #  define nxsem_destroyholder(sem)
 #  define nxsem_add_holder(sem)
 #  define nxsem_add_holder_tcb(htcb,sem)
@@ -59,6 +59,16 @@ void nxsig_cleanup(FAR struct tcb_s *stcb)
       nxsig_release_pendingsigaction(sigq);
     }
 
+#ifdef CONFIG_SIG_FASTPATH
+  /* And the one kept for the next signal */
+
+  if (stcb->sigqcache != NULL)
+    {
+      nxsig_release_pendingsigaction(stcb->sigqcache);
+      stcb->sigqcache = NULL;
+    }
+#endif
+
   /* Misc. signal-related clean-up */
 
   sigfillset(&stcb->sigprocmask);
@@ -79,12 +79,46 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
-      /* Allocate a new element for the signal queue. NOTE:
-       * nxsig_alloc_pendingsigaction will force a system crash if it is
-       * unable to allocate memory for the signal data.
+#ifdef CONFIG_SIG_FASTPATH
+      flags = enter_critical_section();
+
+      /* A standard signal not sent by sigqueue() need not be queued: if
+       * it is pending already only its siginfo is updated.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      if (info->si_signo < SIGRTMIN && info->si_code != SI_QUEUE)
+        {
+          for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head;
+               sigq != NULL;
+               sigq = sigq->flink)
+            {
+              if (sigq->info.si_signo == info->si_signo)
+                {
+                  memcpy(&sigq->info, info, sizeof(siginfo_t));
+                  leave_critical_section(flags);
+                  sched_unlock();
+                  return OK;
+                }
+            }
+        }
+
+      /* Use the structure kept by the thread if it has one */
+
+      sigq            = stcb->sigqcache;
+      stcb->sigqcache = NULL;
+      leave_critical_section(flags);
+
+      if (sigq == NULL)
+#endif
+        {
+          /* Allocate a new element for the signal queue. NOTE:
+           * nxsig_alloc_pendingsigaction will force a system crash if it
+           * is unable to allocate memory for the signal data.
+           */
+
+          sigq = nxsig_alloc_pendingsigaction();
+        }
+
       if (!sigq)
         {
           ret = -ENOMEM;
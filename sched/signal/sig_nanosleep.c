@@ -33,6 +33,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/timers/hrtimer.h>
 
 #include "clock/clock.h"
 
@@ -92,7 +93,11 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
                     FAR struct timespec *rmtp)
 {
   irqstate_t flags;
+#ifdef CONFIG_HRTIMER
+  uint64_t starttime;
+#else
   clock_t starttick;
+#endif
   sigset_t set;
   int ret;
 
@@ -109,7 +114,11 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
    */
 
   flags     = enter_critical_section();
+#ifdef CONFIG_HRTIMER
+  starttime = hrtimer_now();
+#else
   starttick = clock_systime_ticks();
+#endif
 
   /* Set up for the sleep.  Using the empty set means that we are not
    * waiting for any particular signal.  However, any unmasked signal can
@@ -141,6 +150,17 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
 
   if (rmtp)
     {
+#ifdef CONFIG_HRTIMER
+      uint64_t requested;
+      uint64_t elapsed;
+
+      /* The high resolution clock gives the remaining time directly */
+
+      requested = hrtimer_ts2nsec(rqtp);
+      elapsed   = hrtimer_now() - starttime;
+
+      hrtimer_nsec2ts(elapsed < requested ? requested - elapsed : 0, rmtp);
+#else
       clock_t elapsed;
       clock_t remaining;
       sclock_t ticks;
@@ -175,6 +195,7 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
         }
 
       clock_ticks2time((sclock_t)remaining, rmtp);
+#endif
     }
 
   leave_critical_section(flags);
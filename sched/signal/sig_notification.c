@@ -28,6 +28,7 @@
 #include <string.h>
 #include <signal.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/signal.h>
@@ -108,7 +109,11 @@ int nxsig_notification(pid_t pid, FAR struct sigevent *event,
 
   /* Notify client via a signal? */
 
-  if (event->sigev_notify == SIGEV_SIGNAL)
+  if (event->sigev_notify == SIGEV_SIGNAL
+#ifdef CONFIG_SIG_FASTPATH
+      || event->sigev_notify == SIGEV_THREAD_ID
+#endif
+     )
     {
 #ifdef CONFIG_SCHED_HAVE_PARENT
       FAR struct tcb_s *rtcb = this_task();
@@ -133,6 +138,23 @@ int nxsig_notification(pid_t pid, FAR struct sigevent *event,
 
       memcpy(&info.si_value, &event->sigev_value, sizeof(union sigval));
 
+#ifdef CONFIG_SIG_FASTPATH
+      /* Send the signal straight to the thread asked for */
+
+      if (event->sigev_notify == SIGEV_THREAD_ID)
+        {
+          FAR struct tcb_s *stcb;
+
+          stcb = nxsched_get_tcb(event->sigev_notify_thread_id);
+          if (stcb == NULL)
+            {
+              return -ESRCH;
+            }
+
+          return nxsig_tcbdispatch(stcb, &info);
+        }
+#endif
+
       /* Send the signal */
 
       return nxsig_dispatch(pid, &info);
@@ -40,6 +40,7 @@
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/queue.h>
+#include <nuttx/timers/hrtimer.h>
 
 #include "sched/sched.h"
 #include "signal/signal.h"
@@ -243,6 +244,9 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
   FAR sigpendq_t *sigpend;
   irqstate_t flags;
   sclock_t waitticks;
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waittimer;
+#endif
   bool switch_needed;
   int ret;
 
@@ -320,7 +324,13 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
            * time in nanoseconds.
            */
 
-#ifdef CONFIG_SYSTEM_TIME64
+#if defined(CONFIG_HRTIMER)
+          /* The high resolution timer takes the timespec as is; only
+           * tell a zero timeout (poll) from a real one.
+           */
+
+          waitticks = timeout->tv_sec > 0 || timeout->tv_nsec > 0;
+#elif defined(CONFIG_SYSTEM_TIME64)
           waitticks = ((uint64_t)timeout->tv_sec * NSEC_PER_SEC +
                       (uint64_t)timeout->tv_nsec + NSEC_PER_TICK - 1) /
                       NSEC_PER_TICK;
@@ -341,8 +351,14 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               /* Start the watchdog */
 
+#ifdef CONFIG_HRTIMER
+              hrtimer_initialize(&waittimer);
+              hrtimer_start(&waittimer, timeout,
+                            nxsig_timeout, (uintptr_t)rtcb);
+#else
               wd_start(&rtcb->waitdog, waitticks,
                        nxsig_timeout, (uintptr_t)rtcb);
+#endif
 
               /* Now wait for either the signal or the watchdog, but
                * first, make sure this is not the idle task,
@@ -369,7 +385,11 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               /* We no longer need the watchdog */
 
+#ifdef CONFIG_HRTIMER
+              hrtimer_cancel(&waittimer);
+#else
               wd_cancel(&rtcb->waitdog);
+#endif
             }
           else
             {
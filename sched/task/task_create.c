@@ -81,7 +81,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)nxsched_alloc_tcb(ttype);
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -98,7 +98,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
                     entry, argv, envp);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb((FAR struct tcb_s *)tcb, ttype);
       return ret;
     }
 
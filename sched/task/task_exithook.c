@@ -447,6 +447,13 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   nxtask_recover(tcb);
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Release the registrations kept by the last poll() of the thread */
+
+  poll_cache_release(tcb->pollcache);
+  tcb->pollcache = NULL;
+#endif
+
   /* NOTE: signal handling needs to be done in a criticl section */
 
 #ifdef CONFIG_SMP
@@ -139,6 +139,7 @@ static int nxtask_restart(pid_t pid)
   tasklist = TLIST_HEAD(&tcb->cmn);
 #endif
 
+  nxsched_rtr_unindex(&tcb->cmn);
   dq_rem((FAR dq_entry_t *)tcb, tasklist);
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
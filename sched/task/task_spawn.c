@@ -88,7 +88,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)nxsched_alloc_tcb(TCB_FLAG_TTYPE_TASK);
   if (tcb == NULL)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -105,7 +105,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
                     entry, argv, envp);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb((FAR struct tcb_s *)tcb, TCB_FLAG_TTYPE_TASK);
       return ret;
     }
 
@@ -159,7 +159,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
  *     - POSIX_SPAWN_SETSCHEDULER: Set the new tasks scheduler priority to
  *       the sched_policy value.
  *
- *     NOTE: POSIX_SPAWN_SETSIGMASK is handled in nxtask_spawn_proxy().
+ *     - POSIX_SPAWN_SETSIGMASK: Set the new task's signal mask.
  *
  *   argv - argv[] is the argument list for the new task.  argv[] is an
  *     array of pointers to null-terminated strings. The list is terminated
@@ -332,11 +332,6 @@ int task_spawn(FAR const char *name, main_t entry,
   sinfo("name=%s entry=%p file_actions=%p attr=%p argv=%p\n",
         name, entry, file_actions, attr, argv);
 
-  if (attr != NULL)
-    {
-      spawn_proxyattrs(attr);
-    }
-
   ret = nxtask_spawn_exec(&pid, name, entry,
                           file_actions != NULL ? *file_actions : NULL,
                           attr, argv, envp);
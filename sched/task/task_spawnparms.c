@@ -31,7 +31,7 @@
 #include <errno.h>
 
 #include <nuttx/mutex.h>
-#include <nuttx/signal.h>
+#include <nuttx/sched.h>
 #include <nuttx/spawn.h>
 #include <nuttx/fs/fs.h>
 
@@ -144,6 +144,20 @@ int spawn_execattrs(pid_t pid, FAR const posix_spawnattr_t *attr)
 
   DEBUGASSERT(attr);
 
+  /* The child starts with the signal mask of its parent: replace it before
+   * the child gets to run.
+   */
+
+  if ((attr->flags & POSIX_SPAWN_SETSIGMASK) != 0)
+    {
+      FAR struct tcb_s *tcb = nxsched_get_tcb(pid);
+
+      if (tcb != NULL)
+        {
+          tcb->sigprocmask = attr->sigmask;
+        }
+    }
+
   /* Now set the attributes.  Note that we ignore all of the return values
    * here because we have already successfully started the task.  If we
    * return an error value, then we would also have to stop the task.
@@ -227,29 +241,6 @@ int spawn_execattrs(pid_t pid, FAR const posix_spawnattr_t *attr)
   return OK;
 }
 
-/****************************************************************************
- * Name: spawn_proxyattrs
- *
- * Description:
- *   Set attributes of the proxy task before it has started the new child
- *   task.
- *
- * Input Parameters:
- *
- *   attr - The attributes to use
- *
- ****************************************************************************/
-
-void spawn_proxyattrs(FAR const posix_spawnattr_t *attr)
-{
-  /* Check if we need to change the signal mask */
-
-  if (attr != NULL && (attr->flags & POSIX_SPAWN_SETSIGMASK) != 0)
-    {
-      nxsig_procmask(SIG_SETMASK, &attr->sigmask, NULL);
-    }
-}
-
 /****************************************************************************
  * Name: spawn_file_actions
  *
@@ -134,7 +134,7 @@ FAR struct task_tcb_s *nxtask_setup_vfork(start_t retaddr)
 
   /* Allocate a TCB for the child task. */
 
-  child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  child = (FAR struct task_tcb_s *)nxsched_alloc_tcb(ttype);
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -171,7 +171,7 @@ FAR struct task_tcb_s *nxtask_setup_vfork(start_t retaddr)
   stack_size = (uintptr_t)ptcb->stack_base_ptr -
                (uintptr_t)ptcb->stack_alloc_ptr + ptcb->adj_stack_size;
 
-  ret = up_create_stack(&child->cmn, stack_size, ttype);
+  ret = nxsched_create_stack(&child->cmn, stack_size, ttype);
   if (ret < OK)
     {
       goto errout_with_tcb;
@@ -33,6 +33,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
+#include <nuttx/timers/hrtimer.h>
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 
@@ -56,8 +57,13 @@ struct posix_timer_s
   uint8_t          pt_flags;       /* See PT_FLAGS_* definitions */
   uint8_t          pt_crefs;       /* Reference count */
   pid_t            pt_owner;       /* Creator of timer */
+#ifdef CONFIG_HRTIMER
+  uint64_t         pt_interval;    /* If non-zero, the period (nsec) of repetitive timers */
+  struct hrtimer_s pt_hrtimer;     /* The timer that provides the timing */
+#else
   int              pt_delay;       /* If non-zero, used to reset repetitive timers */
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
+#endif
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
 };
@@ -179,7 +179,11 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_clock = clockid;
   ret->pt_crefs = 1;
   ret->pt_owner = nxsched_getpid();
+#ifdef CONFIG_HRTIMER
+  ret->pt_interval = 0;
+#else
   ret->pt_delay = 0;
+#endif
 
   /* Was a struct sigevent provided? */
 
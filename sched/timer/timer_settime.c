@@ -96,10 +96,23 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
 {
   /* If this is a repetitive timer, then restart the watchdog */
 
+#ifdef CONFIG_HRTIMER
+  /* Restart from the previous expiration so that the period does not
+   * drift with the interrupt latency.
+   */
+
+  if (timer->pt_interval)
+    {
+      hrtimer_start_abs(&timer->pt_hrtimer,
+                        timer->pt_hrtimer.expired + timer->pt_interval,
+                        timer_timeout, itimer);
+    }
+#else
   if (timer->pt_delay)
     {
       wd_start(&timer->pt_wdog, timer->pt_delay, timer_timeout, itimer);
     }
+#endif
 }
 
 /****************************************************************************
@@ -223,7 +236,11 @@ int timer_settime(timer_t timerid, int flags,
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
   irqstate_t intflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t hrdelay;
+#else
   sclock_t delay;
+#endif
   int ret = OK;
 
   /* Some sanity checks */
@@ -236,6 +253,10 @@ int timer_settime(timer_t timerid, int flags,
 
   if (ovalue)
     {
+#ifdef CONFIG_HRTIMER
+      hrtimer_gettime(&timer->pt_hrtimer, &ovalue->it_value);
+      hrtimer_nsec2ts(timer->pt_interval, &ovalue->it_interval);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&timer->pt_wdog);
@@ -244,13 +265,18 @@ int timer_settime(timer_t timerid, int flags,
 
       clock_ticks2time(delay, &ovalue->it_value);
       clock_ticks2time(timer->pt_delay, &ovalue->it_interval);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timer_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#else
   wd_cancel(&timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -265,6 +291,33 @@ int timer_settime(timer_t timerid, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Keep the times in nanoseconds; an absolute time is relative to the
+   * clock of the timer, so convert it to the time left from now.
+   */
+
+  timer->pt_interval = hrtimer_ts2nsec(&value->it_interval);
+  hrdelay            = hrtimer_ts2nsec(&value->it_value);
+
+  intflags = enter_critical_section();
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      struct timespec now;
+      uint64_t current;
+
+      clock_gettime(timer->pt_clock, &now);
+      current = hrtimer_ts2nsec(&now);
+      hrdelay = hrdelay > current ? hrdelay - current : 0;
+    }
+
+  /* If the specified time has already passed, the function shall succeed
+   * and the expiration notification shall be made.
+   */
+
+  ret = hrtimer_start_abs(&timer->pt_hrtimer, hrtimer_now() + hrdelay,
+                          timer_timeout, (wdparm_t)timer);
+#else
   /* Setup up any repetitive timer */
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
@@ -326,6 +379,7 @@ int timer_settime(timer_t timerid, int flags,
     }
 
 errout:
+#endif
   leave_critical_section(intflags);
 
   if (ret < 0)
@@ -57,8 +57,10 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -74,6 +76,16 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* Unlink the watchdog from its timing wheel slot (or from the list
+       * of expired watchdogs being run by wd_timer()).  The interval timer
+       * is not reassessed:  if this was the next watchdog to expire, the
+       * wheel will just report the following one on that timer event.
+       */
+
+      list_delete(&wdog->node);
+      g_wdwheel.nactive--;
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -123,6 +135,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
           nxsched_reassess_timer();
         }
+#endif /* CONFIG_WDOG_WHEEL */
 
       /* Mark the watchdog inactive */
 
@@ -59,6 +59,15 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
   flags = enter_critical_section();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* The expiration time is kept as an absolute watchdog time */
+
+      sclock_t delay = (sclock_t)(wdog->expired - g_wdwheel.now) -
+                       wd_elapse();
+
+      leave_critical_section(flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -78,8 +87,57 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
               return delay;
             }
         }
+#endif
     }
 
   leave_critical_section(flags);
   return 0;
 }
+
+/****************************************************************************
+ * Name: wd_nextexpire
+ *
+ * Description:
+ *   This function returns the time remaining before the first of the
+ *   active watchdog timers expires.
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   With CONFIG_WDOG_WHEEL it may be earlier, when a slot of the wheel
+ *   needs to be cascaded first.  -1 if no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextexpire(void)
+{
+  irqstate_t flags;
+  sclock_t delay = -1;
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_WDOG_WHEEL
+  if (g_wdwheel.nactive > 0)
+    {
+      clock_t next = wd_wheel_nextevent();
+
+      if (next != WDOG_WHEEL_NOEVENT)
+        {
+          delay = (sclock_t)(g_wdwheel.base + next - g_wdwheel.now) -
+                  wd_elapse();
+          delay = delay > 0 ? delay : 0;
+        }
+    }
+#else
+  /* The list is ordered: the lag of its head is the delay of the next */
+
+  if (g_wdactivelist.head != NULL)
+    {
+      delay = ((FAR struct wdog_s *)g_wdactivelist.head)->lag -
+              wd_elapse();
+      delay = delay > 0 ? delay : 0;
+    }
+#endif
+
+  leave_critical_section(flags);
+  return delay;
+}
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/list.h>
 #include <nuttx/queue.h>
 
 #include "wdog/wdog.h"
@@ -32,12 +33,18 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_WHEEL
+/* The timing wheel that holds all active watchdogs */
+
+struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -50,3 +57,33 @@ clock_t g_wdtickbase;
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer queue.  Called once during OS start-up.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_initialize(void)
+{
+  int level;
+  int index;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < WDOG_WHEEL_SIZE; index++)
+        {
+          list_initialize(&g_wdwheel.slot[level][index]);
+        }
+    }
+
+  /* Nothing has been processed yet:  the first tick seen by wd_timer() is
+   * the next one for the wheel.
+   */
+
+  g_wdwheel.base = 1;
+}
+#endif
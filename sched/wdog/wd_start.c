@@ -87,6 +87,38 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_WHEEL
+static inline void wd_expiration(void)
+{
+  struct list_node expired = LIST_INITIAL_VALUE(expired);
+  FAR struct list_node *node;
+  FAR struct wdog_s *wdog;
+  wdentry_t func;
+
+  /* Detach all watchdogs that are due up to the current time in one batch.
+   * A callback may cancel a watchdog that is still on the expired list;
+   * wd_cancel() then simply unlinks it from there.
+   */
+
+  wd_wheel_advance(&expired);
+
+  while ((node = list_remove_head(&expired)) != NULL)
+    {
+      wdog = container_of(node, struct wdog_s, node);
+      g_wdwheel.nactive--;
+
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, wdog->arg);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -123,6 +155,7 @@ static inline void wd_expiration(void)
       CALL_FUNC(func, wdog->arg);
     }
 }
+#endif /* CONFIG_WDOG_WHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -167,10 +200,12 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   sclock_t now;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -232,6 +267,21 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   nxsched_cancel_timer();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Hash the watchdog into the timing wheel by its expiration time */
+
+  if (g_wdwheel.nactive++ == 0)
+    {
+#ifdef CONFIG_SCHED_TICKLESS
+      /* Update clock tickbase */
+
+      g_wdtickbase = clock_systime_ticks();
+#endif
+    }
+
+  wdog->expired = g_wdwheel.now + delay;
+  wd_wheel_insert(wdog);
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -325,6 +375,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   /* Put the lag into the watchdog structure and mark it as active. */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_WHEEL */
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Resume the interval timer that will generate the next interval event.
@@ -365,8 +416,55 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_WHEEL
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks, bool noswitches)
+{
+  clock_t next;
+
+  /* Account for the elapsed time.  If context switches are not possible
+   * now, the expired watchdogs are left in the wheel and are run on the
+   * next call.
+   */
+
+  g_wdwheel.now += ticks;
+  g_wdtickbase  += ticks;
+
+  if (!noswitches)
+    {
+      wd_expiration();
+    }
+
+  /* Return the delay for the next watchdog to expire */
+
+  if (g_wdwheel.nactive == 0)
+    {
+      return 0;
+    }
+
+  next = wd_wheel_nextevent();
+  if (next == WDOG_WHEEL_NOEVENT)
+    {
+      return 0;
+    }
+
+  next += g_wdwheel.base;
+  return (sclock_t)(next - g_wdwheel.now) > 0 ?
+         (unsigned int)(next - g_wdwheel.now) : 1;
+}
+
+#else
+void wd_timer(void)
+{
+  /* Advance the wheel by one tick and run the watchdogs that expire */
+
+  g_wdwheel.now++;
+  wd_expiration();
+}
+#endif /* CONFIG_SCHED_TICKLESS */
+
+#elif defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks, bool noswitches)
 {
   FAR struct wdog_s *wdog;
   unsigned int ret;
@@ -427,4 +525,4 @@ void wd_timer(void)
       wd_expiration();
     }
 }
-#endif /* CONFIG_SCHED_TICKLESS */
+#endif /* CONFIG_WDOG_WHEEL */
@@ -0,0 +1,317 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of ticks covered by one slot of a level and by a whole level */
+
+#define WDOG_SLOT_SHIFT(l)     ((l) * WDOG_WHEEL_BITS)
+#define WDOG_LEVEL_RANGE(l)    ((clock_t)1 << WDOG_SLOT_SHIFT((l) + 1))
+
+/* The largest delay that can be placed in the wheel without parking */
+
+#define WDOG_WHEEL_RANGE       WDOG_LEVEL_RANGE(WDOG_WHEEL_LEVELS - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_splice
+ *
+ * Description:
+ *   Move all entries of the list 'from' to the tail of the list 'to',
+ *   leaving 'from' empty.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_splice(FAR struct list_node *from,
+                                   FAR struct list_node *to)
+{
+  if (!list_is_empty(from))
+    {
+      from->next->prev = to->prev;
+      to->prev->next   = from->next;
+      from->prev->next = to;
+      to->prev         = from->prev;
+      list_initialize(from);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_firstslot
+ *
+ * Description:
+ *   Find the first slot at or after 'index' (wrapping around) whose bitmap
+ *   bit is set on the given level.  Stale bits of empty slots are cleared
+ *   on the way.
+ *
+ * Returned Value:
+ *   The distance from 'index' to that slot, or WDOG_WHEEL_SIZE if the level
+ *   is empty.
+ *
+ ****************************************************************************/
+
+static unsigned int wd_wheel_firstslot(int level, unsigned int index)
+{
+  FAR uint32_t *bitmap = &g_wdwheel.bitmap[level];
+
+  while (*bitmap != 0)
+    {
+      uint32_t rotated = index == 0 ? *bitmap :
+                         (*bitmap >> index) |
+                         (*bitmap << (WDOG_WHEEL_SIZE - index));
+      unsigned int dist = ffs(rotated) - 1;
+      unsigned int slot = (index + dist) & WDOG_WHEEL_MASK;
+
+      if (!list_is_empty(&g_wdwheel.slot[level][slot]))
+        {
+          return dist;
+        }
+
+      *bitmap &= ~((uint32_t)1 << slot);
+    }
+
+  return WDOG_WHEEL_SIZE;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert all watchdogs of the current slot of 'level' relative to the
+ *   current wheel base so that they move down to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level)
+{
+  unsigned int index = (g_wdwheel.base >> WDOG_SLOT_SHIFT(level)) &
+                       WDOG_WHEEL_MASK;
+  struct list_node pending = LIST_INITIAL_VALUE(pending);
+  FAR struct list_node *node;
+
+  wd_wheel_splice(&g_wdwheel.slot[level][index], &pending);
+  g_wdwheel.bitmap[level] &= ~((uint32_t)1 << index);
+
+  while ((node = list_remove_head(&pending)) != NULL)
+    {
+      wd_wheel_insert(container_of(node, struct wdog_s, node));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Link a watchdog into the timing wheel slot selected by its expiration
+ *   time (wdog->expired) relative to the wheel base.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t expired = wdog->expired;
+  clock_t delta = expired - g_wdwheel.base;
+  unsigned int index;
+  int level;
+
+  /* A watchdog that is already due goes into the slot of the base so that
+   * it expires on the next tick processed.
+   */
+
+  if ((sclock_t)delta < 0)
+    {
+      expired = g_wdwheel.base;
+      delta   = 0;
+    }
+
+  /* Park delays beyond the range of the wheel on the last level.  They
+   * will be re-cascaded with their real expiration time.
+   */
+
+  else if (delta >= WDOG_WHEEL_RANGE)
+    {
+      expired = g_wdwheel.base + WDOG_WHEEL_RANGE - 1;
+      delta   = WDOG_WHEEL_RANGE - 1;
+    }
+
+  level = 0;
+  while (delta >= WDOG_LEVEL_RANGE(level))
+    {
+      level++;
+    }
+
+  index = (expired >> WDOG_SLOT_SHIFT(level)) & WDOG_WHEEL_MASK;
+  list_add_tail(&g_wdwheel.slot[level][index], &wdog->node);
+  g_wdwheel.bitmap[level] |= (uint32_t)1 << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks from the wheel base to the next tick that
+ *   needs processing:  either a watchdog expiration or the cascade of a
+ *   higher level slot.  The result never exceeds the real expiration time
+ *   of any active watchdog.
+ *
+ * Returned Value:
+ *   The offset from g_wdwheel.base or WDOG_WHEEL_NOEVENT if the wheel is
+ *   empty.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_nextevent(void)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t next = WDOG_WHEEL_NOEVENT;
+  unsigned int dist;
+  int level;
+
+  /* The slots of the first level hold exactly one tick each */
+
+  dist = wd_wheel_firstslot(0, base & WDOG_WHEEL_MASK);
+  if (dist < WDOG_WHEEL_SIZE)
+    {
+      next = dist;
+    }
+
+  /* A slot of the higher levels must be processed when the base reaches
+   * the start of the span of that slot.
+   */
+
+  for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      unsigned int shift = WDOG_SLOT_SHIFT(level);
+      unsigned int index = (base >> shift) & WDOG_WHEEL_MASK;
+      unsigned int start = 0;
+      clock_t cascade;
+
+      /* The current slot was already cascaded unless the base is exactly
+       * at its start.  Whatever it holds now comes around again only after
+       * a full revolution of this level, so start searching at the next
+       * slot.
+       */
+
+      if ((base & (((clock_t)1 << shift) - 1)) != 0)
+        {
+          start = 1;
+        }
+
+      dist = wd_wheel_firstslot(level, (index + start) & WDOG_WHEEL_MASK);
+      if (dist == WDOG_WHEEL_SIZE)
+        {
+          continue;
+        }
+
+      cascade = (((base >> shift) + dist + start) << shift) - base;
+      if (cascade < next)
+        {
+          next = cascade;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel base up to g_wdwheel.now, cascading higher levels as
+ *   needed and moving every expired watchdog onto the 'expired' list.  The
+ *   watchdogs stay active until the caller runs them.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(FAR struct list_node *expired)
+{
+  while ((sclock_t)(g_wdwheel.now - g_wdwheel.base) >= 0)
+    {
+      clock_t next = wd_wheel_nextevent();
+      unsigned int index;
+      int level;
+
+      /* Skip over ticks on which nothing happens */
+
+      if (next == WDOG_WHEEL_NOEVENT ||
+          next > g_wdwheel.now - g_wdwheel.base)
+        {
+          g_wdwheel.base = g_wdwheel.now + 1;
+          break;
+        }
+
+      g_wdwheel.base += next;
+
+      /* Cascade every level whose slot boundary is crossed by this tick */
+
+      for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+        {
+          if ((g_wdwheel.base &
+               (((clock_t)1 << WDOG_SLOT_SHIFT(level)) - 1)) != 0)
+            {
+              break;
+            }
+
+          wd_wheel_cascade(level);
+        }
+
+      /* Everything in the current slot of the first level expires now */
+
+      index = g_wdwheel.base & WDOG_WHEEL_MASK;
+      wd_wheel_splice(&g_wdwheel.slot[0][index], expired);
+      g_wdwheel.bitmap[0] &= ~((uint32_t)1 << index);
+      g_wdwheel.base++;
+    }
+}
+
+#endif /* CONFIG_WDOG_WHEEL */
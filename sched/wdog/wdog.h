@@ -56,6 +56,44 @@
 #  define wd_elapse() (0)
 #endif
 
+/* Timing wheel geometry.  Each level has WDOG_WHEEL_SIZE slots and each
+ * slot of level N spans WDOG_WHEEL_SIZE^N ticks.
+ */
+
+#ifdef CONFIG_WDOG_WHEEL
+#  define WDOG_WHEEL_BITS      5
+#  define WDOG_WHEEL_SIZE      (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK      (WDOG_WHEEL_SIZE - 1)
+#  define WDOG_WHEEL_LEVELS    CONFIG_WDOG_WHEEL_LEVELS
+
+/* Returned by wd_wheel_nextevent() when there is nothing in the wheel */
+
+#  define WDOG_WHEEL_NOEVENT   ((clock_t)-1)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+struct wd_wheel_s
+{
+  clock_t      base;     /* Next tick to be processed by the wheel */
+  clock_t      now;      /* Watchdog time: all ticks seen by wd_timer() */
+  unsigned int nactive;  /* Number of active watchdogs */
+
+  /* Slots that may be non-empty.  A bit is set when a watchdog is linked
+   * into a slot and cleared lazily when the slot is found empty.
+   */
+
+  uint32_t bitmap[WDOG_WHEEL_LEVELS];
+
+  /* The watchdog lists of each slot on each level */
+
+  struct list_node slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SIZE];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -68,12 +106,18 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+/* The timing wheel that holds all active watchdogs */
+
+extern struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -87,6 +131,73 @@ extern clock_t g_wdtickbase;
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer queue.  Called once during OS start-up.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_initialize(void);
+#else
+#  define wd_initialize()
+#endif
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Link a watchdog into the timing wheel slot selected by its expiration
+ *   time (wdog->expired) relative to the wheel base.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks from the wheel base to the next tick that
+ *   needs processing:  either a watchdog expiration or the cascade of a
+ *   higher level slot.  The result never exceeds the real expiration time
+ *   of any active watchdog.
+ *
+ * Returned Value:
+ *   The offset from g_wdwheel.base or WDOG_WHEEL_NOEVENT if the wheel is
+ *   empty.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_nextevent(void);
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel base up to g_wdwheel.now, cascading higher levels as
+ *   needed and moving every expired watchdog onto the 'expired' list.  The
+ *   watchdogs stay active until the caller runs them.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(FAR struct list_node *expired);
+
+#endif /* CONFIG_WDOG_WHEEL */
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -70,28 +70,38 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
   DEBUGASSERT(work != NULL);
 
   /* Cancelling the work is simply a matter of removing the work structure
-   * from the work queue.  This must be done with interrupts disabled because
-   * new work is typically added to the work queue from interrupt handlers.
+   * from the timer or the work queue.  The critical section keeps the
+   * watchdog from expiring meanwhile; the queue itself is protected by the
+   * lock of the work queue, shared with the worker threads.
    */
 
   flags = enter_critical_section();
-  if (work->worker != NULL)
+  if (WDOG_ISACTIVE(&work->u.timer))
     {
-      /* Remove the entry from the work queue and make sure that it is
-       * marked as available (i.e., the worker field is nullified).
+      /* Still waiting for its delay.  Stop the timer and make sure that it
+       * is marked as available (i.e., the worker field is nullified).
        */
 
-      if (WDOG_ISACTIVE(&work->u.timer))
-        {
-          wd_cancel(&work->u.timer);
-        }
-      else
+      wd_cancel(&work->u.timer);
+      work->worker = NULL;
+      ret = OK;
+    }
+  else
+    {
+      irqstate_t qflags = subsys_lock(&wqueue->lock);
+
+      /* A worker thread clears work->worker under the same lock when it
+       * dequeues the work, so a non-NULL worker means still queued.
+       */
+
+      if (work->worker != NULL)
         {
           dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          work->worker = NULL;
+          ret = OK;
         }
 
-      work->worker = NULL;
-      ret = OK;
+      subsys_unlock(&wqueue->lock, qflags);
     }
 
   leave_critical_section(flags);
@@ -130,7 +140,7 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel high priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+      return work_qcancel(hpwork_of(work), work);
     }
   else
 #endif
@@ -143,7 +143,7 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
 
   if (wtcb->sched_priority != wtcb->base_priority)
     {
-      FAR struct semholder_s *pholder;
+      FAR dq_entry_t *node;
       uint8_t wpriority;
 
       /* We attempt to restore task priority to its base priority.  If there
@@ -157,9 +157,10 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
        * waiting for any semaphore held by wtcb.
        */
 
-      for (pholder = wtcb->holdsem; pholder != NULL;
-           pholder = pholder->tlink)
+      for (node = dq_peek(&wtcb->holdsem); node != NULL;
+           node = dq_next(node))
         {
+          FAR struct semholder_s *pholder = (FAR struct semholder_s *)node;
           FAR struct tcb_s *stcb;
 
           stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(pholder->sem));
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -33,100 +34,184 @@
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/semaphore.h>
 
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
-  do \
-    { \
-      int sem_count; \
-      dq_addlast((FAR dq_entry_t *)(work), &(wqueue).q); \
-      nxsem_get_value(&(wqueue).sem, &sem_count); \
-      if (sem_count < 0) /* There are threads waiting for sem. */ \
-        { \
-          nxsem_post(&(wqueue).sem); \
-        } \
-    } \
-  while (0)
+/****************************************************************************
+ * Name: queue_work
+ *
+ * Description:
+ *   Append the work to the queue and wake up one waiting worker thread, if
+ *   any.  The semaphore is posted after the queue lock is released since
+ *   nxsem_post() may enter the critical section.
+ *
+ * Returned Value:
+ *   True if a worker thread of this queue was woken up.
+ *
+ ****************************************************************************/
+
+static bool queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg)
+{
+  irqstate_t flags;
+  bool wake = false;
+
+  flags = subsys_lock(&wqueue->lock);
+
+  if (worker != NULL)
+    {
+      work->worker = worker;
+      work->arg    = arg;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  work->qstamp = up_perf_gettime();
+#endif
+
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (wqueue->nwaiting > 0)
+    {
+      wqueue->nwaiting--;
+      wake = true;
+    }
+
+  subsys_unlock(&wqueue->lock, flags);
+
+  if (wake)
+    {
+      nxsem_post(&wqueue->sem);
+    }
+
+  return wake;
+}
 
 /****************************************************************************
- * Private Functions
+ * Name: hpwork_kick
+ *
+ * Description:
+ *   All workers of the high priority queue 'busy' are running.  Wake up an
+ *   idle worker of another CPU so that it steals the work just queued.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+static void hpwork_kick(int busy)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+  bool wake;
+  int i;
+
+  for (i = 1; i < HPWORK_NQUEUES; i++)
+    {
+      wqueue = (FAR struct kwork_wqueue_s *)
+               &g_hpwork[(busy + i) % HPWORK_NQUEUES];
+
+      /* Unlocked peek to skip queues without idle workers cheaply */
+
+      if (wqueue->nwaiting == 0)
+        {
+          continue;
+        }
+
+      wake  = false;
+      flags = subsys_lock(&wqueue->lock);
+      if (wqueue->nwaiting > 0)
+        {
+          wqueue->nwaiting--;
+          wake = true;
+        }
+
+      subsys_unlock(&wqueue->lock, flags);
+
+      if (wake)
+        {
+          nxsem_post(&wqueue->sem);
+          break;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
- * Name: hp_work_timer_expiry
+ * Name: hp_queue_work
+ *
+ * Description:
+ *   Queue work on the high priority queue selected by work->qcpu.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
+static void hp_queue_work(FAR struct work_s *work, worker_t worker,
+                          FAR void *arg)
+{
+  if (!queue_work(hpwork_of(work), work, worker, arg))
+    {
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+      if (!work->pinned)
+        {
+          hpwork_kick(work->qcpu);
+        }
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: hp_work_timer_expiry
+ *
+ * Assumptions:
+ *   Called from wd_timer() within the critical section.
+ *
+ ****************************************************************************/
+
 static void hp_work_timer_expiry(wdparm_t arg)
 {
-  irqstate_t flags = enter_critical_section();
-  queue_work(g_hpwork, arg);
-  leave_critical_section(flags);
+  hp_queue_work((FAR struct work_s *)arg, NULL, NULL);
 }
 #endif
 
 /****************************************************************************
  * Name: lp_work_timer_expiry
+ *
+ * Assumptions:
+ *   Called from wd_timer() within the critical section.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_LPWORK
 static void lp_work_timer_expiry(wdparm_t arg)
 {
-  irqstate_t flags = enter_critical_section();
-  queue_work(g_lpwork, arg);
-  leave_critical_section(flags);
+  queue_work((FAR struct kwork_wqueue_s *)&g_lpwork,
+             (FAR struct work_s *)arg, NULL, NULL);
 }
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: work_queue
+ * Name: work_qqueue
  *
  * Description:
- *   Queue kernel-mode work to be performed at a later time.  All queued
- *   work will be performed on the worker thread of execution (not the
- *   caller's).
- *
- *   The work structure is allocated and must be initialized to all zero by
- *   the caller.  Otherwise, the work structure is completely managed by the
- *   work queue logic.  The caller should never modify the contents of the
- *   work queue structure directly.  If work_queue() is called before the
- *   previous work has been performed and removed from the queue, then any
- *   pending work will be canceled and lost.
- *
- * Input Parameters:
- *   qid    - The work queue ID (index)
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will be
- *            invoked on the worker thread of execution.
- *   arg    - The argument that will be passed to the worker callback when
- *            int is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
- *
- * Returned Value:
- *   Zero on success, a negated errno on failure
+ *   Common logic of work_queue() and work_queue_affinity().  'cpu' is
+ *   the CPU whose high priority queue is used, or -1 for the calling CPU.
  *
  ****************************************************************************/
 
-int work_queue(int qid, FAR struct work_s *work, worker_t worker,
-               FAR void *arg, clock_t delay)
+static int work_qqueue(int qid, FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t delay, int cpu)
 {
   irqstate_t flags;
   int ret = OK;
 
-  /* Interrupts are disabled so that this logic can be called from with
-   * task logic or from interrupt handling logic.
+  /* The critical section serializes work_queue() and work_cancel() with
+   * the watchdog timer.  The queue itself is protected by the lock of the
+   * work queue so that the worker threads never need the critical section.
    */
 
   flags = enter_critical_section();
@@ -138,24 +223,35 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
       work_cancel(qid, work);
     }
 
-  /* Initialize the work structure. */
-
-  work->worker = worker;           /* Work callback. non-NULL means queued */
-  work->arg = arg;                 /* Callback argument */
-
-  /* Queue the new work */
+  /* Queue the new work.  A non-NULL work->worker means queued; it is set
+   * under the queue lock for immediate work since the worker threads read
+   * it under that lock only.
+   */
 
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
+      /* Select the queue of the CPU.  We cannot migrate while in the
+       * critical section.
+       */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      work->pinned = cpu >= 0;
+      work->qcpu   = cpu >= 0 ? cpu : up_cpu_index();
+#else
+      UNUSED(cpu);
+#endif
+
       /* Queue high priority work */
 
       if (!delay)
         {
-          queue_work(g_hpwork, work);
+          hp_queue_work(work, worker, arg);
         }
       else
         {
+          work->worker = worker;
+          work->arg    = arg;
           wd_start(&work->u.timer, delay, hp_work_timer_expiry,
                    (wdparm_t)work);
         }
@@ -169,10 +265,13 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
       if (!delay)
         {
-          queue_work(g_lpwork, work);
+          queue_work((FAR struct kwork_wqueue_s *)&g_lpwork, work,
+                     worker, arg);
         }
       else
         {
+          work->worker = worker;
+          work->arg    = arg;
           wd_start(&work->u.timer, delay, lp_work_timer_expiry,
                    (wdparm_t)work);
         }
@@ -188,4 +287,93 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue
+ *
+ * Description:
+ *   Queue kernel-mode work to be performed at a later time.  All queued
+ *   work will be performed on the worker thread of execution (not the
+ *   caller's).
+ *
+ *   The work structure is allocated and must be initialized to all zero by
+ *   the caller.  Otherwise, the work structure is completely managed by the
+ *   work queue logic.  The caller should never modify the contents of the
+ *   work queue structure directly.  If work_queue() is called before the
+ *   previous work has been performed and removed from the queue, then any
+ *   pending work will be canceled and lost.
+ *
+ *   With CONFIG_SCHED_HPWORK_PERCPU, high priority work goes to the queue
+ *   of the calling CPU but may be stolen by an idle worker of another CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue(int qid, FAR struct work_s *work, worker_t worker,
+               FAR void *arg, clock_t delay)
+{
+  return work_qqueue(qid, work, worker, arg, delay, -1);
+}
+
+/****************************************************************************
+ * Name: work_queue_affinity
+ *
+ * Description:
+ *   Same as work_queue() but the work is run on the high-priority queue of
+ *   the given CPU and is never taken by the workers of another CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU to run the work on, or -1 for the calling CPU
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_affinity(int qid, FAR struct work_s *work, worker_t worker,
+                        FAR void *arg, clock_t delay, int cpu)
+{
+  if (cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  /* -1 pins the work to the calling CPU, which is only known inside the
+   * critical section.
+   */
+
+  if (cpu < 0)
+    {
+      irqstate_t flags = enter_critical_section();
+      int ret = work_qqueue(qid, work, worker, arg, delay, up_cpu_index());
+      leave_critical_section(flags);
+      return ret;
+    }
+
+  return work_qqueue(qid, work, worker, arg, delay, cpu);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
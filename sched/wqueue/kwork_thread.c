@@ -29,10 +29,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <strings.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
@@ -75,13 +78,23 @@
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_HPWORK)
-/* The state of the kernel mode, high priority work queue(s). */
+/* The state of the kernel mode, high priority work queue(s).  The per-CPU
+ * queues rely on zero initialization which is equivalent to the
+ * initializers below; work may be queued before the threads are started.
+ */
 
-struct hp_wqueue_s g_hpwork =
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
+#else
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES] =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
+  {
+    {NULL, NULL},
+    SEM_INITIALIZER(0),
+    SUBSYS_LOCK_INITIALIZER(HPWORKNAME),
+  }
 };
+#endif
 
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -92,6 +105,7 @@ struct lp_wqueue_s g_lpwork =
 {
   {NULL, NULL},
   SEM_INITIALIZER(0),
+  SUBSYS_LOCK_INITIALIZER(LPWORKNAME),
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
@@ -100,6 +114,133 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_latency_record
+ *
+ * Description:
+ *   Account the time the work spent in the queue before it was started.
+ *
+ * Assumptions:
+ *   Called with the queue lock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+static void work_latency_record(FAR struct kwork_wqueue_s *wqueue,
+                                unsigned long qstamp)
+{
+  FAR struct work_latency_s *lat = &wqueue->latency;
+  uint64_t usec;
+  uint32_t elapsed;
+  int bucket;
+
+  usec    = (uint64_t)(up_perf_gettime() - qstamp) * USEC_PER_SEC /
+            up_perf_getfreq();
+  elapsed = usec > UINT32_MAX ? UINT32_MAX : (uint32_t)usec;
+
+  bucket  = fls(elapsed);
+  if (bucket >= WORK_LATENCY_NBUCKETS)
+    {
+      bucket = WORK_LATENCY_NBUCKETS - 1;
+    }
+
+  lat->bucket[bucket]++;
+  lat->nsamples++;
+  if (elapsed > lat->max)
+    {
+      lat->max = elapsed;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Take the work at the head of the queue.  When stealing, work pinned to
+ *   the CPU of that queue is left alone.
+ *
+ * Returned Value:
+ *   True if a work was taken; its callback and argument are returned in
+ *   'worker' and 'arg'.
+ *
+ ****************************************************************************/
+
+static bool work_dequeue(FAR struct kwork_wqueue_s *wqueue, bool steal,
+                         FAR worker_t *worker, FAR void **arg)
+{
+  FAR struct work_s *work;
+  irqstate_t flags;
+
+  flags = subsys_lock(&wqueue->lock);
+
+  work = (FAR struct work_s *)dq_peek(&wqueue->q);
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (work != NULL && steal && work->pinned)
+    {
+      work = NULL;
+    }
+#else
+  UNUSED(steal);
+#endif
+
+  if (work != NULL)
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+
+      /* Extract the work description from the entry (in case the work
+       * instance will be re-used after it has been de-queued), then mark
+       * the work as no longer being queued.
+       */
+
+      *worker      = work->worker;
+      *arg         = work->arg;
+      work->worker = NULL;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+      work_latency_record(wqueue, work->qstamp);
+#endif
+    }
+
+  subsys_unlock(&wqueue->lock, flags);
+  return work != NULL;
+}
+
+/****************************************************************************
+ * Name: work_steal
+ *
+ * Description:
+ *   Our own high priority queue is empty.  Take unpinned work from the
+ *   queue of another CPU whose workers are all busy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+static bool work_steal(FAR struct kwork_wqueue_s *self,
+                       FAR worker_t *worker, FAR void **arg)
+{
+  FAR struct kwork_wqueue_s *victim;
+  int index = (FAR struct hp_wqueue_s *)self - g_hpwork;
+  int i;
+
+  for (i = 1; i < HPWORK_NQUEUES; i++)
+    {
+      victim = (FAR struct kwork_wqueue_s *)
+               &g_hpwork[(index + i) % HPWORK_NQUEUES];
+
+      /* Unlocked peek to skip empty queues cheaply */
+
+      if (dq_peek(&victim->q) != NULL &&
+          work_dequeue(victim, true, worker, arg))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -125,67 +266,68 @@ struct lp_wqueue_s g_lpwork =
 static int work_thread(int argc, FAR char *argv[])
 {
   FAR struct kwork_wqueue_s *wqueue;
-  FAR struct work_s *work;
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+  bool thief;
+#endif
 
   wqueue = (FAR struct kwork_wqueue_s *)
            ((uintptr_t)strtoul(argv[1], NULL, 0));
 
-  flags = enter_critical_section();
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+  /* Only the per-CPU high priority workers steal from each other */
+
+  thief = (uintptr_t)wqueue >= (uintptr_t)&g_hpwork[0] &&
+          (uintptr_t)wqueue <= (uintptr_t)&g_hpwork[HPWORK_NQUEUES - 1];
+#endif
 
   /* Loop forever */
 
   for (; ; )
     {
-      /* And check each entry in the work queue.  Since we have disabled
-       * interrupts we know:  (1) we will not be suspended unless we do
-       * so ourselves, and (2) there will be no changes to the work queue
+      /* The work queue is protected by its own lock rather than by the
+       * global critical section, so queuing work on another CPU does not
+       * contend with us while we dequeue.
        */
 
-      /* Remove the ready-to-execute work from the list */
-
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      if (work_dequeue(wqueue, false, &worker, &arg)
+#ifdef CONFIG_SCHED_HPWORK_STEAL
+          || (thief && work_steal(wqueue, &worker, &arg))
+#endif
+         )
         {
-          if (work->worker == NULL)
-            {
-              continue;
-            }
-
-          /* Extract the work description from the entry (in case the work
-           * instance will be re-used after it has been de-queued).
+          /* Do the work.  We don't have any idea how long this will
+           * take!
            */
 
-          worker = work->worker;
-
-          /* Extract the work argument (before re-enabling interrupts) */
-
-          arg = work->arg;
-
-          /* Mark the work as no longer being queued */
+          if (worker != NULL)
+            {
+              CALL_WORKER(worker, arg);
+            }
 
-          work->worker = NULL;
+          continue;
+        }
 
-          /* Do the work.  Re-enable interrupts while the work is being
-           * performed... we don't have any idea how long this will take!
-           */
+      /* Nothing to do.  Announce that we are about to wait so that the
+       * next work queued posts the semaphore.  A post that lands before we
+       * actually wait simply leaves the count positive.
+       */
 
-          leave_critical_section(flags);
-          CALL_WORKER(worker, arg);
-          flags = enter_critical_section();
+      flags = subsys_lock(&wqueue->lock);
+      if (dq_peek(&wqueue->q) != NULL)
+        {
+          subsys_unlock(&wqueue->lock, flags);
+          continue;
         }
 
-      /* Then process queued work.  work_process will not return until: (1)
-       * there is no further work in the work queue, and (2) semaphore is
-       * posted.
-       */
+      wqueue->nwaiting++;
+      subsys_unlock(&wqueue->lock, flags);
 
       nxsem_wait_uninterruptible(&wqueue->sem);
     }
 
-  leave_critical_section(flags);
-
   return OK; /* To keep some compilers happy */
 }
 
@@ -202,6 +344,7 @@ static int work_thread(int argc, FAR char *argv[])
  *   stack_size - size (in bytes) of the stack needed
  *   nthread    - Number of work thread should be created
  *   wqueue     - Work queue instance
+ *   cpu        - The CPU to bind the threads to, or -1
  *
  * Returned Value:
  *   A negated errno value is returned on failure.
@@ -210,7 +353,7 @@ static int work_thread(int argc, FAR char *argv[])
 
 static int work_thread_create(FAR const char *name, int priority,
                               int stack_size, int nthread,
-                              FAR struct kwork_wqueue_s *wqueue)
+                              FAR struct kwork_wqueue_s *wqueue, int cpu)
 {
   FAR char *argv[2];
   char args[32];
@@ -241,6 +384,19 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid  = pid;
+
+#ifdef CONFIG_SMP
+      if (cpu >= 0)
+        {
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(cpu, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+        }
+#else
+      UNUSED(cpu);
+#endif
     }
 
   sched_unlock();
@@ -277,8 +433,18 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      wqueue  = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      nthread = CONFIG_SCHED_HPNTHREADS;
+      int i;
+
+      for (i = 0; i < HPWORK_NQUEUES; i++)
+        {
+          wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[i];
+          for (wndx = 0; wndx < CONFIG_SCHED_HPNTHREADS; wndx++)
+            {
+              handler(wqueue->worker[wndx].pid, arg);
+            }
+        }
+
+      return;
     }
   else
 #endif
@@ -317,14 +483,42 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
 #if defined(CONFIG_SCHED_HPWORK)
 int work_start_highpri(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  int cpu;
+  int ret;
+#endif
+
   /* Start the high-priority, kernel mode worker thread(s) */
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  /* One queue per CPU, each served by threads bound to that CPU */
+
+  for (cpu = 0; cpu < HPWORK_NQUEUES; cpu++)
+    {
+#ifdef CONFIG_SCHED_CRITMONITOR_SUBSYS
+      g_hpwork[cpu].lock.name = HPWORKNAME;
+#endif
+
+      ret = work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                               CONFIG_SCHED_HPWORKSTACKSIZE,
+                               CONFIG_SCHED_HPNTHREADS,
+                               (FAR struct kwork_wqueue_s *)&g_hpwork[cpu],
+                               cpu);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+#else
   return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
                             CONFIG_SCHED_HPWORKSTACKSIZE,
                             CONFIG_SCHED_HPNTHREADS,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+                            (FAR struct kwork_wqueue_s *)&g_hpwork[0], -1);
+#endif
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -352,8 +546,71 @@ int work_start_lowpri(void)
   return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
                             CONFIG_SCHED_LPWORKSTACKSIZE,
                             CONFIG_SCHED_LPNTHREADS,
-                            (FAR struct kwork_wqueue_s *)&g_lpwork);
+                            (FAR struct kwork_wqueue_s *)&g_lpwork, -1);
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Name: work_latency
+ *
+ * Description:
+ *   Return the queue-to-start latency histogram of a work queue.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID
+ *   cpu   - The CPU of a per-CPU high-priority queue, otherwise ignored
+ *   lat   - The location to return the histogram
+ *   reset - Clear the histogram after it has been read
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if there is no such queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+int work_latency(int qid, int cpu, FAR struct work_latency_s *lat,
+                 bool reset)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      if (cpu < 0 || cpu >= HPWORK_NQUEUES)
+        {
+          return -EINVAL;
+        }
+#else
+      cpu = 0;
+#endif
+
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork[cpu];
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
+
+  flags = subsys_lock(&wqueue->lock);
+  memcpy(lat, &wqueue->latency, sizeof(struct work_latency_s));
+  if (reset)
+    {
+      memset(&wqueue->latency, 0, sizeof(struct work_latency_s));
+    }
+
+  subsys_unlock(&wqueue->lock, flags);
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -32,6 +32,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -44,6 +45,14 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of high priority work queues: one per CPU or a shared one */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define HPWORK_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define HPWORK_NQUEUES 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -61,6 +70,11 @@ struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  subsys_lock_t     lock;      /* Protects q, nwaiting and work->worker */
+  int16_t           nwaiting;  /* Worker threads waiting on sem */
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct work_latency_s latency; /* Queue-to-start latency histogram */
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -73,6 +87,11 @@ struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  subsys_lock_t     lock;      /* Protects q, nwaiting and work->worker */
+  int16_t           nwaiting;  /* Worker threads waiting on sem */
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct work_latency_s latency; /* Queue-to-start latency histogram */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -89,6 +108,11 @@ struct lp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  subsys_lock_t     lock;      /* Protects q, nwaiting and work->worker */
+  int16_t           nwaiting;  /* Worker threads waiting on sem */
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct work_latency_s latency; /* Queue-to-start latency histogram */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -101,9 +125,18 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
+
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
+
+/* The high priority queue that holds (or last held) a work */
 
-extern struct hp_wqueue_s g_hpwork;
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+#    define hpwork_of(work) \
+       ((FAR struct kwork_wqueue_s *)&g_hpwork[(work)->qcpu])
+#  else
+#    define hpwork_of(work) ((FAR struct kwork_wqueue_s *)&g_hpwork[0])
+#  endif
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
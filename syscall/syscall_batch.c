@@ -0,0 +1,203 @@
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <syscall.h>
+#include <errno.h>
+
+#include <nuttx/sysbatch.h>
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE uintptr_t (*sysbatch_stub1_t)(int nbr, uintptr_t parm1);
+typedef CODE uintptr_t (*sysbatch_stub3_t)(int nbr, uintptr_t parm1,
+                                           uintptr_t parm2,
+                                           uintptr_t parm3);
+typedef CODE uintptr_t (*sysbatch_stub4_t)(int nbr, uintptr_t parm1,
+                                           uintptr_t parm2,
+                                           uintptr_t parm3,
+                                           uintptr_t parm4);
+typedef CODE uintptr_t (*sysbatch_stub6_t)(int nbr, uintptr_t parm1,
+                                           uintptr_t parm2,
+                                           uintptr_t parm3,
+                                           uintptr_t parm4,
+                                           uintptr_t parm5,
+                                           uintptr_t parm6);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of parameters of each stub, from the same table as
+ * g_stublookup[].
+ */
+
+static const uint8_t g_sysbatch_nparms[SYS_nsyscalls] =
+{
+#  define SYSCALL_LOOKUP1(f,n) n
+#  define SYSCALL_LOOKUP(f,n)  , n
+#  include <sys/syscall_lookup.h>
+#  undef SYSCALL_LOOKUP1
+#  undef SYSCALL_LOOKUP
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sysbatch_allowed
+ *
+ * Description:
+ *   Return true if the system call may be queued.
+ *
+ ****************************************************************************/
+
+static bool sysbatch_allowed(unsigned int nbr)
+{
+  switch (nbr)
+    {
+      case SYS_close:
+      case SYS_ioctl:
+      case SYS_lseek:
+      case SYS_poll:
+      case SYS_read:
+      case SYS_write:
+      case SYS_pread:
+      case SYS_pwrite:
+#ifdef CONFIG_NET
+      case SYS_recv:
+      case SYS_recvfrom:
+      case SYS_send:
+      case SYS_sendto:
+#endif
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/****************************************************************************
+ * Name: sysbatch_call
+ *
+ * Description:
+ *   Call the stub of a queued system call, as the SVC handler would.
+ *
+ ****************************************************************************/
+
+static uintptr_t sysbatch_call(FAR const struct sysbatch_sqe_s *sqe)
+{
+  unsigned int ndx = sqe->nbr - CONFIG_SYS_RESERVED;
+  uintptr_t stub = g_stublookup[ndx];
+  FAR const uintptr_t *parm = sqe->parm;
+
+  switch (g_sysbatch_nparms[ndx])
+    {
+      case 1:
+        return ((sysbatch_stub1_t)stub)(ndx, parm[0]);
+
+      case 3:
+        return ((sysbatch_stub3_t)stub)(ndx, parm[0], parm[1], parm[2]);
+
+      case 4:
+        return ((sysbatch_stub4_t)stub)(ndx, parm[0], parm[1], parm[2],
+                                        parm[3]);
+
+      case 6:
+        return ((sysbatch_stub6_t)stub)(ndx, parm[0], parm[1], parm[2],
+                                        parm[3], parm[4], parm[5]);
+
+      default:
+        set_errno(ENOSYS);
+        return (uintptr_t)ERROR;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sysbatch
+ *
+ * Description:
+ *   Run the system calls queued in the submission ring, in order, and
+ *   queue their completions.
+ *
+ ****************************************************************************/
+
+int sysbatch(FAR struct sysbatch_ring_s *ring)
+{
+  FAR const struct sysbatch_sqe_s *sqe;
+  FAR struct sysbatch_cqe_s *cqe;
+  uint32_t mask;
+  int count = 0;
+
+  if (ring == NULL || ring->sq == NULL || ring->cq == NULL ||
+      ring->nentries == 0 || (ring->nentries & (ring->nentries - 1)) != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  mask = ring->nentries - 1;
+
+  while (ring->sq_head != ring->sq_tail &&
+         ring->cq_tail - ring->cq_head < ring->nentries)
+    {
+      sqe = &ring->sq[ring->sq_head & mask];
+      cqe = &ring->cq[ring->cq_tail & mask];
+
+      set_errno(0);
+      if (sqe->nbr >= CONFIG_SYS_RESERVED && sqe->nbr < SYS_maxsyscall &&
+          sysbatch_allowed(sqe->nbr))
+        {
+          cqe->result = sysbatch_call(sqe);
+        }
+      else
+        {
+          set_errno(ENOSYS);
+          cqe->result = (uintptr_t)ERROR;
+        }
+
+      cqe->errcode = get_errno();
+      cqe->priv    = sqe->priv;
+
+      ring->sq_head++;
+      ring->cq_tail++;
+      count++;
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_BATCH */
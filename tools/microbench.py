@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/microbench.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+
+# Compare the reports of /dev/microbench (drivers/benchmark/microbench.c)
+# read on two configurations, e.g. the default heap against TLSF:
+#
+#   nsh> cat /dev/microbench       (capture the console into default.txt)
+#
+#   tools/microbench.py default.txt tlsf.txt
+#
+# The costs are converted to nanoseconds with the frequency of each report,
+# and the cost of the measure itself, the "null" line, is subtracted.
+
+import argparse
+import re
+import sys
+
+HEADER_RE = re.compile(r"^\s*#\s*freq\s+(\d+)")
+RESULT_RE = re.compile(r"^\s*(\w+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s*$")
+
+FIELDS = {"min": 0, "avg": 1, "max": 2}
+
+
+def parse_report(path):
+    freq = None
+    results = {}
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            match = HEADER_RE.match(line)
+            if match:
+                freq = int(match.group(1))
+                continue
+            match = RESULT_RE.match(line)
+            if match:
+                results[match.group(1)] = [int(match.group(i)) for i in (3, 4, 5)]
+
+    if not freq:
+        sys.exit("%s: no '# freq' header, not a /dev/microbench report" % path)
+
+    # Subtract the cost of reading the counter, in nanoseconds
+
+    null = results.pop("null", [0, 0, 0])
+    return {
+        name: [max(v - n, 0) * 1e9 / freq for v, n in zip(values, null)]
+        for name, values in results.items()
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare two reports of /dev/microbench"
+    )
+    parser.add_argument("base", help="the report of the reference configuration")
+    parser.add_argument("new", help="the report of the configuration compared")
+    parser.add_argument(
+        "-f",
+        "--field",
+        choices=FIELDS.keys(),
+        default="min",
+        help="the cost compared, min by default",
+    )
+    args = parser.parse_args()
+
+    base = parse_report(args.base)
+    new = parse_report(args.new)
+    field = FIELDS[args.field]
+
+    print("%-24s %12s %12s %8s" % ("benchmark", "base (ns)", "new (ns)", "change"))
+    for name in base:
+        if name not in new:
+            continue
+        old = base[name][field]
+        cur = new[name][field]
+        change = "%+7.1f%%" % (100.0 * (cur - old) / old) if old else "-"
+        print("%-24s %12.1f %12.1f %8s" % (name, old, cur, change))
+
+
+if __name__ == "__main__":
+    main()
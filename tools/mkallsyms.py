@@ -77,6 +77,25 @@ class SymbolTables(object):
             )
         self.emitline('  { "Unknown", (FAR %s void *)0xffffffff }\n};' % (noconst))
 
+        # The indices into g_allsyms in the order of the names, so that
+        # allsyms_findbyname() can use a binary search
+
+        names = ["Unknown"] + [symbol[1] for symbol in self.symbol_list]
+        names.append("Unknown")
+        byname = sorted(
+            range(len(names)), key=lambda idx: (names[idx].encode(), idx)
+        )
+
+        self.emitline(
+            "\nextern const int g_allsyms_byname[%d + 2];\n" % len(self.symbol_list)
+        )
+        self.emitline(
+            "const int g_allsyms_byname[%d + 2] =\n{" % len(self.symbol_list)
+        )
+        for idx in byname:
+            self.emitline("  %d," % idx)
+        self.emitline("};")
+
     def get_symtable(self):
         symbol_tables = [
             (idx, s)
@@ -58,11 +58,19 @@ echo "{"
 
 echo "  { \"Unknown\", (FAR ${CONST} void *)0x00000000 },"
 
+syms=
 if [ -f "${1}" ];then
-  ${nm} -n ${1} | grep -E " [T|t] "  | uniq | \
+  syms=`${nm} -n ${1} | grep -E " [T|t] "  | uniq | \
   while read addr type name
   do
-    echo "  { \"$(${filt} $name | sed -e "s/(.*)$//")\", (FAR ${CONST} void *)0x$addr },"
+    echo "0x$addr $(${filt} $name | sed -e "s/(.*)$//")"
+  done`
+fi
+
+if [ -n "${syms}" ];then
+  echo "${syms}" | while read addr name
+  do
+    echo "  { \"${name}\", (FAR ${CONST} void *)${addr} },"
   done
 fi
 
@@ -71,3 +79,23 @@ fi
 echo "  { \"Unknown\", (FAR ${CONST} void *)0xffffffff },"
 
 echo "};"
+
+# Add the indices into g_allsyms in the order of the names, so that
+# allsyms_findbyname() can use a binary search
+
+echo ""
+echo "const int g_allsyms_byname[${count} + 2] ="
+echo "{"
+
+(
+  echo "0 Unknown"
+  if [ -n "${syms}" ];then
+    echo "${syms}" | awk '{ idx = NR; sub(/^[^ ]* /, ""); print idx, $0 }'
+  fi
+  echo "$((count + 1)) Unknown"
+) | sort -s -k2 | while read idx name
+do
+  echo "  ${idx},"
+done
+
+echo "};"
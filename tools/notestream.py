@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/notestream.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+# Convert the binary stream of drivers/note/notestream_driver.c into the
+# JSON trace event format, which Perfetto (ui.perfetto.dev) and
+# chrome://tracing open.  The format of the stream is described in
+# include/nuttx/note/notestream_driver.h.
+#
+# Capture the stream with e.g.:
+#
+#   cat /dev/ttyACM0 > trace.bin              (CDC-ACM)
+#   nc -u -l 7777 > trace.bin                 (UDP)
+#
+# then:
+#
+#   tools/notestream.py trace.bin -o trace.json
+
+import argparse
+import json
+import sys
+
+NOTESTREAM_MAGIC = b"NXTS"
+NOTESTREAM_VERSION = 1
+NOTESTREAM_HEADER_SIZE = 12
+NOTESTREAM_LOST = 0xFE
+NOTESTREAM_TASKNAME = 0xFF
+
+NOTE_START = 0
+NOTE_STOP = 1
+NOTE_SUSPEND = 2
+NOTE_RESUME = 3
+NOTE_CPU_START = 4
+NOTE_CPU_STARTED = 5
+NOTE_CPU_PAUSE = 6
+NOTE_CPU_PAUSED = 7
+NOTE_CPU_RESUME = 8
+NOTE_CPU_RESUMED = 9
+NOTE_PREEMPT_LOCK = 10
+NOTE_PREEMPT_UNLOCK = 11
+NOTE_CSECTION_ENTER = 12
+NOTE_CSECTION_LEAVE = 13
+NOTE_SPINLOCK_LOCK = 14
+NOTE_SPINLOCK_LOCKED = 15
+NOTE_SPINLOCK_UNLOCK = 16
+NOTE_SPINLOCK_ABORT = 17
+NOTE_SYSCALL_ENTER = 18
+NOTE_SYSCALL_LEAVE = 19
+NOTE_IRQ_ENTER = 20
+NOTE_IRQ_LEAVE = 21
+NOTE_DUMP_STRING = 22
+NOTE_DUMP_BINARY = 23
+
+NOTE_NAMES = {
+    NOTE_START: "start",
+    NOTE_STOP: "stop",
+    NOTE_CPU_START: "cpu_start",
+    NOTE_CPU_STARTED: "cpu_started",
+    NOTE_CPU_PAUSE: "cpu_pause",
+    NOTE_CPU_PAUSED: "cpu_paused",
+    NOTE_CPU_RESUME: "cpu_resume",
+    NOTE_CPU_RESUMED: "cpu_resumed",
+    NOTE_PREEMPT_LOCK: "preempt_lock",
+    NOTE_PREEMPT_UNLOCK: "preempt_unlock",
+    NOTE_CSECTION_ENTER: "csection_enter",
+    NOTE_CSECTION_LEAVE: "csection_leave",
+    NOTE_SPINLOCK_LOCK: "spinlock_lock",
+    NOTE_SPINLOCK_LOCKED: "spinlock_locked",
+    NOTE_SPINLOCK_UNLOCK: "spinlock_unlock",
+    NOTE_SPINLOCK_ABORT: "spinlock_abort",
+    NOTE_DUMP_BINARY: "dump",
+}
+
+# The process ids of the tracks in the trace event format
+
+PID_CPUS = 0
+PID_IRQS = 1
+PID_TASKS = 2
+
+
+class StreamError(Exception):
+    pass
+
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def u8(self):
+        if self.pos >= len(self.data):
+            raise StreamError("truncated stream")
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def bytes(self, n):
+        if self.pos + n > len(self.data):
+            raise StreamError("truncated stream")
+        value = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return value
+
+    def le(self, n):
+        return int.from_bytes(self.bytes(n), "little")
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.u8()
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def svarint(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+
+class Converter(object):
+    def __init__(self):
+        self.events = []
+        self.names = {}
+        self.running = {}
+        self.time = 0
+        self.freq = 0
+        self.ptrsize = 4
+        self.lost = 0
+
+    def name(self, pid):
+        return "%s (%d)" % (self.names.get(pid, "<noname>"), pid)
+
+    def ts(self):
+        # The trace event format is in microseconds
+
+        if self.freq:
+            return self.time * 1000000.0 / self.freq
+        return self.time / 1000.0
+
+    def emit(self, ph, name, pid, tid, **kwargs):
+        event = {"name": name, "ph": ph, "ts": self.ts(), "pid": pid, "tid": tid}
+        event.update(kwargs)
+        self.events.append(event)
+
+    def header(self, reader):
+        if reader.bytes(4) != NOTESTREAM_MAGIC:
+            raise StreamError("not a note stream")
+        version = reader.u8()
+        if version != NOTESTREAM_VERSION:
+            raise StreamError("unsupported version %d" % version)
+        self.ptrsize = reader.u8()
+        reader.u8()  # pidsize, the pids are varints
+        reader.u8()
+        self.freq = reader.le(4)
+
+    def switch_out(self, cpu):
+        if cpu in self.running:
+            self.emit("E", self.name(self.running.pop(cpu)), PID_CPUS, cpu)
+
+    def note(self, ntype, cpu, pid, priority, payload):
+        if ntype == NOTE_RESUME:
+            self.switch_out(cpu)
+            self.running[cpu] = pid
+            self.emit("B", self.name(pid), PID_CPUS, cpu, args={"priority": priority})
+        elif ntype == NOTE_SUSPEND:
+            if self.running.get(cpu) == pid:
+                self.switch_out(cpu)
+        elif ntype == NOTE_IRQ_ENTER:
+            self.emit("B", "irq %d" % payload[0], PID_IRQS, cpu)
+        elif ntype == NOTE_IRQ_LEAVE:
+            self.emit("E", "irq %d" % payload[0], PID_IRQS, cpu)
+        elif ntype == NOTE_SYSCALL_ENTER:
+            self.emit("B", "syscall %d" % payload[0], PID_TASKS, pid)
+        elif ntype == NOTE_SYSCALL_LEAVE:
+            self.emit("E", "syscall %d" % payload[0], PID_TASKS, pid)
+        elif ntype == NOTE_DUMP_STRING:
+            text = payload[self.ptrsize :].split(b"\0")[0].decode(errors="replace")
+            fields = text.split("|")
+            if len(fields) >= 3 and fields[0] in ("B", "E"):
+                self.emit(fields[0], fields[2], PID_TASKS, int(fields[1]))
+            elif text in ("B", "E"):
+                self.emit(text, "", PID_TASKS, pid)
+            else:
+                self.emit("i", text, PID_TASKS, pid, s="t")
+        else:
+            name = NOTE_NAMES.get(ntype, "note %d" % ntype)
+            self.emit("i", name, PID_TASKS, pid, s="t")
+
+    def convert(self, data):
+        reader = Reader(data)
+        self.header(reader)
+
+        while not reader.eof():
+            rtype = reader.u8()
+            if rtype == NOTESTREAM_TASKNAME:
+                pid = reader.varint()
+                self.names[pid] = reader.bytes(reader.u8()).decode(errors="replace")
+                self.events.append(
+                    {
+                        "name": "thread_name",
+                        "ph": "M",
+                        "pid": PID_TASKS,
+                        "tid": pid,
+                        "args": {"name": self.name(pid)},
+                    }
+                )
+            elif rtype == NOTESTREAM_LOST:
+                count = reader.varint()
+                self.lost += count
+                self.emit("i", "lost %d notes" % count, PID_CPUS, 0, s="g")
+            else:
+                self.time += reader.svarint()
+                cpu = reader.u8()
+                pid = reader.varint()
+                priority = reader.u8()
+                payload = reader.bytes(reader.varint())
+                self.note(rtype, cpu, pid, priority, payload)
+
+        for pid, name in ((PID_CPUS, "CPUs"), (PID_IRQS, "IRQs"), (PID_TASKS, "Tasks")):
+            self.events.append(
+                {"name": "process_name", "ph": "M", "pid": pid, "args": {"name": name}}
+            )
+
+        return {"traceEvents": self.events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert a NuttX note stream to the trace event format"
+    )
+    parser.add_argument("input", help="the captured binary note stream")
+    parser.add_argument(
+        "-o", "--output", help="the JSON trace to write, stdout by default"
+    )
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    converter = Converter()
+    try:
+        trace = converter.convert(data)
+    except StreamError as e:
+        # Keep what was converted, a capture may end in the middle of a record
+
+        print("warning: %s" % e, file=sys.stderr)
+        trace = {"traceEvents": converter.events, "displayTimeUnit": "ns"}
+
+    if converter.lost:
+        print("warning: %d notes were lost" % converter.lost, file=sys.stderr)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/profile.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+# Symbolize the samples of /dev/profile (drivers/misc/profile.c) against
+# the nuttx ELF or the linker map nuttx.map, and print them as the folded
+# stacks read by flamegraph.pl (https://github.com/brendangregg/FlameGraph)
+# and speedscope:
+#
+#   nsh> echo 1 > /dev/profile
+#   nsh> ...
+#   nsh> echo 0 > /dev/profile
+#   nsh> cat /dev/profile          (capture the console into samples.txt)
+#
+#   tools/profile.py nuttx samples.txt | flamegraph.pl > profile.svg
+#   tools/profile.py --top 20 nuttx.map samples.txt
+
+import argparse
+import bisect
+import re
+import sys
+from collections import Counter
+
+try:
+    import cxxfilt
+except ModuleNotFoundError:
+    cxxfilt = None
+
+SAMPLE_RE = re.compile(r"^\s*(\d+)\s+(\d+)((?:\s+0x[0-9a-fA-F]+)+)\s*$")
+LOST_RE = re.compile(r"^\s*#\s*(\d+)\s+lost\s+(\d+)")
+MAP_SYMBOL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$")
+MAP_SECTION_RE = re.compile(r"^\s*(\.\S+)")
+
+
+def demangle(name):
+    if cxxfilt is None:
+        return name
+    try:
+        return re.sub(r"\(.*$", "", cxxfilt.demangle(name))
+    except cxxfilt.InvalidName:
+        return name
+
+
+class Symbols(object):
+    def __init__(self):
+        self.addrs = []
+        self.names = []
+        self.cache = {}
+
+    def load_elf(self, path):
+        try:
+            from elftools.elf.elffile import ELFFile
+            from elftools.elf.sections import SymbolTableSection
+        except ModuleNotFoundError:
+            sys.exit("Please install pyelftools: pip install pyelftools")
+
+        symbols = []
+        with open(path, "rb") as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for symbol in section.iter_symbols():
+                    if symbol["st_info"]["type"] != "STT_FUNC":
+                        continue
+                    if symbol["st_shndx"] == "SHN_UNDEF":
+                        continue
+                    symbols.append((symbol["st_value"] & ~0x01, symbol.name))
+
+        self.set(symbols)
+
+    def load_map(self, path):
+        # The symbols of the linker map are listed under their input
+        # section, keep those of the text sections
+
+        symbols = []
+        text = False
+        with open(path, "r", errors="replace") as f:
+            for line in f:
+                match = MAP_SECTION_RE.match(line)
+                if match:
+                    text = match.group(1).startswith(".text")
+                    continue
+                match = MAP_SYMBOL_RE.match(line)
+                if match and text:
+                    symbols.append((int(match.group(1), 16), match.group(2)))
+
+        self.set(symbols)
+
+    def set(self, symbols):
+        symbols.sort()
+        self.addrs = [addr for addr, name in symbols]
+        self.names = [demangle(name) for addr, name in symbols]
+
+    def lookup(self, addr):
+        name = self.cache.get(addr)
+        if name is None:
+            index = bisect.bisect_right(self.addrs, addr) - 1
+            if index < 0:
+                name = "0x%x" % addr
+            else:
+                name = self.names[index]
+            self.cache[addr] = name
+        return name
+
+
+def parse_samples(lines):
+    samples = []
+    lost = 0
+    for line in lines:
+        match = SAMPLE_RE.match(line)
+        if match:
+            addrs = [int(addr, 16) for addr in match.group(3).split()]
+            samples.append((int(match.group(1)), int(match.group(2)), addrs))
+            continue
+        match = LOST_RE.match(line)
+        if match:
+            lost += int(match.group(2))
+    return samples, lost
+
+
+def symbolize(symbols, addrs):
+    # The callers are return addresses, look up the call instruction
+    # before them
+
+    frames = [symbols.lookup(addrs[0] & ~0x01)]
+    for addr in addrs[1:]:
+        frames.append(symbols.lookup((addr & ~0x01) - 1))
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Symbolize the samples of /dev/profile into folded stacks"
+    )
+    parser.add_argument("symbols", help="the nuttx ELF file, or nuttx.map")
+    parser.add_argument(
+        "samples", nargs="?", help="the samples read from /dev/profile, stdin"
+    )
+    parser.add_argument(
+        "-p", "--pid", action="store_true", help="root the stacks at their thread"
+    )
+    parser.add_argument(
+        "-c", "--cpu", action="store_true", help="root the stacks at their CPU"
+    )
+    parser.add_argument(
+        "-t",
+        "--top",
+        type=int,
+        metavar="N",
+        help="print the N functions sampled the most instead",
+    )
+    args = parser.parse_args()
+
+    symbols = Symbols()
+    if args.symbols.endswith(".map"):
+        symbols.load_map(args.symbols)
+    else:
+        symbols.load_elf(args.symbols)
+
+    if args.samples:
+        with open(args.samples, "r", errors="replace") as f:
+            samples, lost = parse_samples(f)
+    else:
+        samples, lost = parse_samples(sys.stdin)
+
+    if lost:
+        print("warning: %d samples were lost" % lost, file=sys.stderr)
+
+    if args.top:
+        counts = Counter(symbols.lookup(addrs[0] & ~0x01) for _, _, addrs in samples)
+        total = max(len(samples), 1)
+        for name, count in counts.most_common(args.top):
+            print("%6.2f%% %8d  %s" % (100.0 * count / total, count, name))
+        return
+
+    stacks = Counter()
+    for cpu, pid, addrs in samples:
+        frames = symbolize(symbols, addrs)
+        frames.reverse()
+        if args.pid:
+            frames.insert(0, "pid %d" % pid)
+        if args.cpu:
+            frames.insert(0, "cpu %d" % cpu)
+        stacks[";".join(frames)] += 1
+
+    for stack, count in sorted(stacks.items()):
+        print("%s %d" % (stack, count))
+
+
+if __name__ == "__main__":
+    main()
@@ -48,6 +48,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <sys/param.h>
+
+#include <nuttx/irq.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/wireless/bluetooth/bt_hci.h>
@@ -127,6 +130,7 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
   FAR struct bt_conn_s *conn;
   FAR struct bt_buf_s *buf;
   struct mq_attr attr;
+  irqstate_t flags;
   int ret;
 
   /* Get the connection instance */
@@ -139,6 +143,16 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
 
   while (conn->state == BT_CONN_CONNECTED)
     {
+#if CONFIG_BLUETOOTH_CONN_MAXPKTS > 0
+      /* Wait until this connection may have one more packet outstanding */
+
+      ret = nxsem_wait_uninterruptible(&conn->pkts_sem);
+      if (ret < 0 || conn->state != BT_CONN_CONNECTED)
+        {
+          break;
+        }
+#endif
+
       /* Wait until the controller can accept ACL packets */
 
       wlinfo("calling nxsem_wait_uninterruptible()\n");
@@ -171,6 +185,12 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
           break;
         }
 
+      /* Count it before the controller can report it as completed */
+
+      flags = enter_critical_section();
+      conn->pending++;
+      leave_critical_section(flags);
+
       wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
       bt_send(g_btdev.btdev, buf);
       bt_buf_release(buf);
@@ -440,7 +460,7 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
       buf = bt_l2cap_create_pdu(conn);
 
       len = remaining;
-      if (len < g_btdev.le_mtu)
+      if (len > g_btdev.le_mtu)
         {
           len = g_btdev.le_mtu;
         }
@@ -468,6 +488,47 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
     }
 }
 
+/****************************************************************************
+ * Name: bt_conn_complete
+ *
+ * Description:
+ *   Give back the controller buffers of ACL packets of a connection that
+ *   the controller is done with.
+ *
+ * Input Parameters:
+ *   conn  - The registered connection
+ *   count - The number of packets completed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void bt_conn_complete(FAR struct bt_conn_s *conn, uint16_t count)
+{
+  irqstate_t flags;
+  uint16_t mine;
+
+  flags = enter_critical_section();
+  mine  = MIN(count, conn->pending);
+  conn->pending -= mine;
+  leave_critical_section(flags);
+
+  while (count-- > 0)
+    {
+      nxsem_post(&g_btdev.le_pkts_sem);
+    }
+
+#if CONFIG_BLUETOOTH_CONN_MAXPKTS > 0
+  while (mine-- > 0)
+    {
+      nxsem_post(&conn->pkts_sem);
+    }
+#else
+  UNUSED(mine);
+#endif
+}
+
 /****************************************************************************
  * Name: bt_conn_add
  *
@@ -508,6 +569,9 @@ FAR struct bt_conn_s *bt_conn_add(FAR const bt_addr_le_t *peer,
   bt_atomic_set(&conn->ref, 1);
   conn->role = role;
   bt_addr_le_copy(&conn->dst, peer);
+#if CONFIG_BLUETOOTH_CONN_MAXPKTS > 0
+  nxsem_init(&conn->pkts_sem, 0, CONFIG_BLUETOOTH_CONN_MAXPKTS);
+#endif
 
   return conn;
 }
@@ -604,8 +668,17 @@ void bt_conn_set_state(FAR struct bt_conn_s *conn,
           {
             bt_queue_send(&conn->tx_queue, bt_buf_alloc(BT_DUMMY, NULL, 0),
                           BT_NORMAL_PRIO);
+#if CONFIG_BLUETOOTH_CONN_MAXPKTS > 0
+            nxsem_post(&conn->pkts_sem);
+#endif
           }
 
+        /* The controller drops the packets of a connection that is gone
+         * without reporting them as completed:  take the buffers back.
+         */
+
+        bt_conn_complete(conn, conn->pending);
+
         /* Release the reference we took for the very first state
          * transition.
          */
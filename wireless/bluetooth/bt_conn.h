@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
 
 #include "bt_atomic.h"
 
@@ -91,6 +92,13 @@ struct bt_conn_s
 
   struct file tx_queue;
 
+  /* ACL packets given to the controller and not reported as completed */
+
+  uint8_t pending;
+#if CONFIG_BLUETOOTH_CONN_MAXPKTS > 0
+  sem_t pkts_sem;
+#endif
+
   FAR struct bt_keys_s *keys;
 
   /* Fixed channel contexts */
@@ -148,6 +156,24 @@ void bt_conn_receive(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf,
 
 void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf);
 
+/****************************************************************************
+ * Name: bt_conn_complete
+ *
+ * Description:
+ *   Give back the controller buffers of ACL packets of a connection that
+ *   the controller is done with.
+ *
+ * Input Parameters:
+ *   conn  - The registered connection
+ *   count - The number of packets completed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void bt_conn_complete(FAR struct bt_conn_s *conn, uint16_t count);
+
 /****************************************************************************
  * Name: bt_conn_add
  *
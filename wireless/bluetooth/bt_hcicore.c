@@ -428,6 +428,7 @@ static void hci_num_completed_packets(FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_evt_num_completed_packets_s *evt = (FAR void *)buf->data;
   uint16_t num_handles = BT_LE162HOST(evt->num_handles);
+  FAR struct bt_conn_s *conn;
   uint16_t i;
 
   wlinfo("num_handles %u\n", num_handles);
@@ -441,7 +442,14 @@ static void hci_num_completed_packets(FAR struct bt_buf_s *buf)
       count  = BT_LE162HOST(evt->h[i].count);
 
       wlinfo("handle %u count %u\n", handle, count);
-      UNUSED(handle);
+
+      conn = bt_conn_lookup_handle(handle);
+      if (conn != NULL)
+        {
+          bt_conn_complete(conn, count);
+          bt_conn_release(conn);
+          continue;
+        }
 
       while (count--)
         {
@@ -135,7 +135,9 @@ static void mac802154_resetqueues(FAR struct ieee802154_privmac_s *priv)
  * Notes:
  *   If any of the semaphore waits inside this function get interrupted, the
  *   function will release the MAC layer.  If this function returns -EINTR,
- *   the calling code should NOT release the MAC semaphore.
+ *   the calling code should NOT release the MAC semaphore.  If no primitive
+ *   is left for the confirmation, -ENOMEM is returned with the MAC still
+ *   locked.
  *
  ****************************************************************************/
 
@@ -204,6 +206,15 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
    */
 
   primitive = ieee802154_primitive_allocate();
+  if (primitive == NULL)
+    {
+      /* Give the descriptor back, the MAC is still locked */
+
+      sq_addlast((FAR sq_entry_t *)*txdesc, &priv->txdesc_queue);
+      nxsem_post(&priv->txdesc_sem);
+      *txdesc = NULL;
+      return -ENOMEM;
+    }
 
   (*txdesc)->purgetime = 0;
   (*txdesc)->retrycount = priv->maxretries;
@@ -369,14 +380,20 @@ static void mac802154_notify_worker(FAR void *arg)
     (FAR struct ieee802154_privmac_s *)arg;
   FAR struct mac802154_maccb_s *cb;
   FAR struct ieee802154_primitive_s *primitive;
+  sq_queue_t primitives;
   int ret;
 
+  /* Take all of the primitives queued so far at once.  The ones queued
+   * meanwhile schedule this work again.
+   */
+
   nxmutex_lock(&priv->lock);
-  primitive =
-    (FAR struct ieee802154_primitive_s *)sq_remfirst(&priv->primitive_queue);
+  primitives = priv->primitive_queue;
+  sq_init(&priv->primitive_queue);
   nxmutex_unlock(&priv->lock);
 
-  while (primitive != NULL)
+  while ((primitive = (FAR struct ieee802154_primitive_s *)
+                        sq_remfirst(&primitives)) != NULL)
     {
       /* Data indications are a special case since the frame can only be
        * passed to one place. The return value of the notify call is used to
@@ -441,13 +458,6 @@ static void mac802154_notify_worker(FAR void *arg)
                 }
             }
         }
-
-      /* Get the next primitive then loop */
-
-      nxmutex_lock(&priv->lock);
-      primitive = (FAR struct ieee802154_primitive_s *)
-                    sq_remfirst(&priv->primitive_queue);
-      nxmutex_unlock(&priv->lock);
     }
 }
 
@@ -1057,34 +1067,39 @@ static void mac802154_rxframe_worker(FAR void *arg)
   FAR struct ieee802154_data_ind_s *ind;
   FAR struct iob_s *iob;
   FAR uint16_t *frame_ctrl;
+  sq_queue_t frames;
   bool panid_comp;
   uint8_t ftype;
 
+  sq_init(&frames);
+
   while (1)
     {
-      /* Get exclusive access to the driver structure.  We don't care about
-       * any signals so if we see one, just go back to trying to get access
-       * again.
-       */
+      if (sq_empty(&frames))
+        {
+          /* Take all of the frames received so far at once, so that a burst
+           * of frames costs a single lock of the MAC.  We don't care about
+           * any signals so if we see one, just go back to trying to get
+           * access again.
+           */
 
-      nxmutex_lock(&priv->lock);
+          nxmutex_lock(&priv->lock);
+          frames = priv->dataind_queue;
+          sq_init(&priv->dataind_queue);
+          nxmutex_unlock(&priv->lock);
+
+          if (sq_empty(&frames))
+            {
+              return;
+            }
+        }
 
       /* Pop the data indication from the head of the frame list for
        * processing.   Note: dataind_queue contains ieee802154_primitive_s
        * which is safe to cast directly to a data indication.
        */
 
-      ind = (FAR struct ieee802154_data_ind_s *)
-              sq_remfirst(&priv->dataind_queue);
-
-      /* Once we pop off the indication, we needn't to keep the mac locked */
-
-      nxmutex_unlock(&priv->lock);
-
-      if (ind == NULL)
-        {
-          return;
-        }
+      ind = (FAR struct ieee802154_data_ind_s *)sq_remfirst(&frames);
 
       /* Get a local copy of the frame to make it easier to access */
 